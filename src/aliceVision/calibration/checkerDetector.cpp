@@ -7,6 +7,7 @@
 #include "checkerDetector.hpp"
 
 #include <aliceVision/system/Logger.hpp>
+#include <aliceVision/alicevision_omp.hpp>
 
 #include <OpenImageIO/imagebufalgo.h>
 
@@ -33,14 +34,30 @@ bool CheckerDetector::process(const image::Image<image::RGBColor>& source, bool
 
     const Vec2 center(grayscale.Width() / 2, grayscale.Height() / 2);
 
-    const double scales[] = {1.0, 0.75, 0.5, 0.25};
+    const std::vector<double> scales = {1.0, 0.75, 0.5, 0.25};
+
+    // Normalized image pyramid, its first level is used for the corners fitting
+    std::vector<image::Image<float>> pyramid;
+    computePyramid(pyramid, grayscale, scales);
+
+    // Extract the corners of all the levels in parallel
+    const int nbLevels = static_cast<int>(scales.size());
+    std::vector<std::vector<Vec2>> levelsCorners(nbLevels);
+    std::vector<char> levelsValid(nbLevels, 0);
+
+#pragma omp parallel for schedule(dynamic)
+    for (int level = 0; level < nbLevels; ++level)
+    {
+        levelsValid[level] = processLevel(levelsCorners[level], pyramid[level], scales[level]);
+    }
 
     std::vector<IntermediateCorner> allCorners;
-    for (double scale : scales)
+    for (int level = 0; level < nbLevels; ++level)
     {
-        ALICEVISION_LOG_INFO("[CheckerDetector] extracting corners at scale " << scale);
-        std::vector<Vec2> corners;
-        if (!processLevel(corners, grayscale, scale))
+        const double scale = scales[level];
+        ALICEVISION_LOG_INFO("[CheckerDetector] extracted corners at scale " << scale);
+        const std::vector<Vec2>& corners = levelsCorners[level];
+        if (!levelsValid[level])
         {
             ALICEVISION_LOG_DEBUG("[CheckerDetector] detection failed");
             return false;
@@ -50,7 +67,7 @@ bool CheckerDetector::process(const image::Image<image::RGBColor>& source, bool
 
         // Merge with previous level corners
         const double distMerge = 5.0;
-        for (Vec2 c : corners)
+        for (const Vec2& c : corners)
         {
             bool keep = true;
 
@@ -74,9 +91,8 @@ bool CheckerDetector::process(const image::Image<image::RGBColor>& source, bool
 
     ALICEVISION_LOG_DEBUG("[CheckerDetector] kept " << allCorners.size() << " corners positions after merge between levels");
 
-    // Normalize image between 0 and 1
-    image::Image<float> normalized;
-    normalizeImage(normalized, grayscale);
+    // Image normalized between 0 and 1
+    const image::Image<float>& normalized = pyramid.front();
 
     std::vector<CheckerBoardCorner> fittedCorners;
     fitCorners(fittedCorners, allCorners, normalized);
@@ -147,37 +163,53 @@ bool CheckerDetector::process(const image::Image<image::RGBColor>& source, bool
     return true;
 }
 
-bool CheckerDetector::processLevel(std::vector<Vec2>& corners, const image::Image<float>& input, double scale) const
+void CheckerDetector::computePyramid(std::vector<image::Image<float>>& pyramid, const image::Image<float>& input, const std::vector<double>& scales) const
 {
-    // Get resized size
     const unsigned int w = input.Width();
     const unsigned int h = input.Height();
-    const unsigned int nw = static_cast<unsigned int>(floor(static_cast<float>(w) * scale));
-    const unsigned int nh = static_cast<unsigned int>(floor(static_cast<float>(h) * scale));
-
-    // Resize image
-    image::Image<float> toUpdate = input;
-    image::Image<float> rescaled(nw, nh);
-    const oiio::ImageSpec imageSpecResized(nw, nh, 1, oiio::TypeDesc::FLOAT);
-    const oiio::ImageSpec imageSpecOrigin(w, h, 1, oiio::TypeDesc::FLOAT);
-    const oiio::ImageBuf inBuf(imageSpecOrigin, toUpdate.data());
-    oiio::ImageBuf outBuf(imageSpecResized, rescaled.data());
-    oiio::ImageBufAlgo::resize(outBuf, inBuf);
-
-    // Normalize image between 0 and 1
-    image::Image<float> normalized;
-    normalizeImage(normalized, rescaled);
+    const int nbLevels = static_cast<int>(scales.size());
+
+    pyramid.resize(nbLevels);
+
+#pragma omp parallel for schedule(dynamic)
+    for (int level = 0; level < nbLevels; ++level)
+    {
+        const double scale = scales[level];
+        if (scale == 1.0)
+        {
+            normalizeImage(pyramid[level], input);
+            continue;
+        }
+
+        // Get resized size
+        const unsigned int nw = static_cast<unsigned int>(floor(static_cast<float>(w) * scale));
+        const unsigned int nh = static_cast<unsigned int>(floor(static_cast<float>(h) * scale));
+
+        // Resize image, the input buffer is only read
+        image::Image<float> rescaled(nw, nh);
+        const oiio::ImageSpec imageSpecResized(nw, nh, 1, oiio::TypeDesc::FLOAT);
+        const oiio::ImageSpec imageSpecOrigin(w, h, 1, oiio::TypeDesc::FLOAT);
+        const oiio::ImageBuf inBuf(imageSpecOrigin, const_cast<float*>(input.data()));
+        oiio::ImageBuf outBuf(imageSpecResized, rescaled.data());
+        oiio::ImageBufAlgo::resize(outBuf, inBuf);
+
+        // Normalize image between 0 and 1
+        normalizeImage(pyramid[level], rescaled);
+    }
+}
 
+bool CheckerDetector::processLevel(std::vector<Vec2>& corners, const image::Image<float>& input, double scale) const
+{
     image::Image<float> hessian;
-    computeHessianResponse(hessian, normalized);
+    computeHessianResponse(hessian, input);
 
     std::vector<Vec2> rawCorners;
     extractCorners(rawCorners, hessian);
 
     std::vector<Vec2> refinedCorners;
-    refineCorners(refinedCorners, rawCorners, normalized);
+    refineCorners(refinedCorners, rawCorners, input);
 
-    pruneCorners(corners, refinedCorners, normalized);
+    pruneCorners(corners, refinedCorners, input);
 
     for (Vec2& v : corners)
     {
@@ -250,6 +282,7 @@ void CheckerDetector::normalizeImage(image::Image<float>& output, const image::I
     getMinMax(min, max, input);
 
     output.resize(input.Width(), input.Height());
+#pragma omp parallel for
     for (int y = 0; y < output.Height(); ++y)
     {
         for (int x = 0; x < output.Width(); ++x)
@@ -264,23 +297,24 @@ void CheckerDetector::computeHessianResponse(image::Image<float>& output, const
     image::Image<float> smoothed;
     image::ImageGaussianFilter(input, 1.5, smoothed, 2);
 
-    // First order derivatives
-    image::Image<float> gx, gy;
-    ImageXDerivative(smoothed, gx, true);
-    ImageYDerivative(smoothed, gy, true);
+    const int w = smoothed.Width();
+    const int h = smoothed.Height();
 
-    // Second order derivatives
-    image::Image<float> gxx, gxy, gyy;
-    ImageXDerivative(gx, gxx, true);
-    ImageXDerivative(gy, gxy, true);
-    ImageYDerivative(gy, gyy, true);
+    // Second order derivatives as the composition of two central differences, in a single pass.
+    // The 2 pixels border is left to 0, the corners extraction ignores it.
+    output.resize(w, h, true, 0.0f);
 
-    output.resize(input.Width(), input.Height());
-    for (int y = 0; y < input.Height(); ++y)
+#pragma omp parallel for
+    for (int y = 2; y < h - 2; ++y)
     {
-        for (int x = 0; x < input.Width(); ++x)
+        for (int x = 2; x < w - 2; ++x)
         {
-            output(y, x) = std::abs(gxx(y, x) * gyy(y, x) - 2.0 * gxy(y, x));
+            const float s = smoothed(y, x);
+            const float gxx = 0.25f * (smoothed(y, x + 2) - 2.0f * s + smoothed(y, x - 2));
+            const float gyy = 0.25f * (smoothed(y + 2, x) - 2.0f * s + smoothed(y - 2, x));
+            const float gxy = 0.25f * (smoothed(y + 1, x + 1) - smoothed(y - 1, x + 1) - smoothed(y + 1, x - 1) + smoothed(y - 1, x - 1));
+
+            output(y, x) = std::abs(gxx * gyy - 2.0f * gxy);
         }
     }
 }
@@ -293,37 +327,46 @@ void CheckerDetector::extractCorners(std::vector<Vec2>& rawCorners, const image:
     const float threshold = max * 0.1f;
     const int radius = 7;
 
-    // Find peaks (local maxima) of the Hessian response
-    image::Image<float> output(hessianResponse.Width(), hessianResponse.Height(), true, 0.0f);
-    for (int i = radius; i < hessianResponse.Height() - radius; ++i)
+    // Find peaks (local maxima) of the Hessian response, row by row in parallel
+    const int height = hessianResponse.Height();
+    std::vector<std::vector<Vec2>> rowsCorners(std::max(0, height));
+
+#pragma omp parallel for schedule(dynamic, 16)
+    for (int i = radius; i < height - radius; ++i)
     {
         for (int j = radius; j < hessianResponse.Width() - radius; ++j)
         {
-            bool isMaximal = true;
             const float val = hessianResponse(i, j);
 
+            // Peak must be higher than a global threshold
+            if (!(val > threshold))
+                continue;
+
             // Compare value to neighborhood
-            for (int k = -radius; k <= radius; ++k)
+            bool isMaximal = true;
+            for (int k = -radius; k <= radius && isMaximal; ++k)
             {
                 for (int l = -radius; l <= radius; ++l)
                 {
                     if (hessianResponse(i + k, j + l) > val)
                     {
                         isMaximal = false;
+                        break;
                     }
                 }
             }
 
-            if (!isMaximal)
-                continue;
-
-            // Peak must be higher than a global threshold
-            if (val > threshold)
+            if (isMaximal)
             {
-                rawCorners.emplace_back(j, i);
+                rowsCorners[i].emplace_back(j, i);
             }
         }
     }
+
+    for (const std::vector<Vec2>& rowCorners : rowsCorners)
+    {
+        rawCorners.insert(rawCorners.end(), rowCorners.begin(), rowCorners.end());
+    }
 }
 
 void CheckerDetector::getMinMax(float& min, float& max, const image::Image<float>& input) const
@@ -1031,76 +1074,101 @@ void CheckerDetector::buildCheckerboards(std::vector<CheckerBoard>& boards,
                                          const std::vector<CheckerBoardCorner>& refinedCorners,
                                          const image::Image<float>& input) const
 {
-    double minE = std::numeric_limits<double>::max();
+    const IndexT nbCorners = static_cast<IndexT>(refinedCorners.size());
+    // The growth of a board does not depend on the used corners: a batch of seeds is grown speculatively in parallel
+    const std::size_t seedsBatchSize = 2 * static_cast<std::size_t>(omp_get_max_threads());
 
     std::vector<bool> used(refinedCorners.size(), false);
-    for (IndexT cid = 0; cid < refinedCorners.size(); ++cid)
+    IndexT nextSeed = 0;
+    while (nextSeed < nbCorners)
     {
-        const CheckerBoardCorner& seed = refinedCorners[cid];
-        if (used[cid])
-            continue;
+        // Next unused seeds
+        std::vector<IndexT> seeds;
+        for (; nextSeed < nbCorners && seeds.size() < seedsBatchSize; ++nextSeed)
+        {
+            if (!used[nextSeed])
+                seeds.push_back(nextSeed);
+        }
+
+        const int nbSeeds = static_cast<int>(seeds.size());
+        std::vector<CheckerBoard> seedBoards(nbSeeds);
+        std::vector<CheckerBoard> grownBoards(nbSeeds);
+        std::vector<char> hasSeedBoard(nbSeeds, 0);
 
-        // Check if corner can be used as seed
-        CheckerBoard board;
-        if (!getSeedCheckerboard(board, cid, refinedCorners))
+#pragma omp parallel for schedule(dynamic)
+        for (int s = 0; s < nbSeeds; ++s)
         {
-            continue;
+            // Check if corner can be used as seed
+            if (!getSeedCheckerboard(seedBoards[s], seeds[s], refinedCorners))
+                continue;
+            hasSeedBoard[s] = 1;
+
+            // Extend board as much as possible
+            grownBoards[s] = seedBoards[s];
+            while (growIteration(grownBoards[s], refinedCorners)) {}
         }
 
-        // Check if board contains already used corners
-        bool valid = true;
-        for (int i = 0; i < board.rows(); ++i)
+        // Accept the boards in the seeds order, as a sequential growth would do
+        for (int s = 0; s < nbSeeds; ++s)
         {
-            for (int j = 0; j < board.cols(); ++j)
+            if (!hasSeedBoard[s] || used[seeds[s]])
+                continue;
+
+            // Check if board contains already used corners
+            const CheckerBoard& seedBoard = seedBoards[s];
+            bool valid = true;
+            for (int i = 0; i < seedBoard.rows(); ++i)
             {
-                if (used[board(i, j)])
+                for (int j = 0; j < seedBoard.cols(); ++j)
                 {
-                    valid = false;
+                    if (used[seedBoard(i, j)])
+                    {
+                        valid = false;
+                    }
                 }
             }
-        }
 
-        if (!valid)
-            continue;
+            if (!valid)
+                continue;
 
-        // Extend board as much as possible
-        while (growIteration(board, refinedCorners)) {}
+            const CheckerBoard& board = grownBoards[s];
 
-        // Check that board has more than 10 corners
-        int count = 0;
-        for (int i = 0; i < board.rows(); ++i)
-        {
-            for (int j = 0; j < board.cols(); ++j)
+            // Check that board has more than 10 corners
+            int count = 0;
+            for (int i = 0; i < board.rows(); ++i)
             {
-                if (board(i, j) == UndefinedIndexT)
-                    continue;
-                count++;
+                for (int j = 0; j < board.cols(); ++j)
+                {
+                    if (board(i, j) == UndefinedIndexT)
+                        continue;
+                    count++;
+                }
             }
-        }
 
-        if (count < 10)
-            continue;
+            if (count < 10)
+                continue;
 
-        // Update used corners
-        for (int i = 0; i < board.rows(); ++i)
-        {
-            for (int j = 0; j < board.cols(); ++j)
+            // Update used corners
+            for (int i = 0; i < board.rows(); ++i)
             {
-                if (board(i, j) == UndefinedIndexT)
-                    continue;
+                for (int j = 0; j < board.cols(); ++j)
+                {
+                    if (board(i, j) == UndefinedIndexT)
+                        continue;
 
-                const IndexT id = board(i, j);
-                used[id] = true;
+                    const IndexT id = board(i, j);
+                    used[id] = true;
+                }
             }
-        }
 
-        // Threshold on energy value
-        if (computeEnergy(board, refinedCorners) / static_cast<double>(count) > -0.8)
-        {
-            continue;
-        }
+            // Threshold on energy value
+            if (computeEnergy(board, refinedCorners) / static_cast<double>(count) > -0.8)
+            {
+                continue;
+            }
 
-        boards.push_back(board);
+            boards.push_back(board);
+        }
     }
 }
 
@@ -145,19 +145,30 @@ class CheckerDetector
      * @brief Extract corners positions from the image at the given scale.
      *
      * Algorithm steps:
-     * 1. apply scale and normalize the input image
-     * 2. compute Hessian response of the image
-     * 3. extract corners positions using the Hessian response
-     * 4. refine the corners positions using the image
-     * 5. prune corners
-     *
-     * @param[out] corners Container for extracted corners.
-     * @param[in] input Input grayscale image.
-     * @param[in] scale Scale applied to the image before the extraction.
+     * 1. compute Hessian response of the image
+     * 2. extract corners positions using the Hessian response
+     * 3. refine the corners positions using the image
+     * 4. prune corners
+     *
+     * @param[out] corners Container for extracted corners, in the coordinates of the full resolution image.
+     * @param[in] input Normalized grayscale image of the pyramid level.
+     * @param[in] scale Scale of the pyramid level.
      * @return False if a problem occured during extraction, otherwise true.
      */
     bool processLevel(std::vector<Vec2>& corners, const image::Image<float>& input, double scale) const;
 
+    /**
+     * @brief Compute the image pyramid shared by the corners extraction and the corners fitting.
+     *
+     * The levels are computed in parallel from the full resolution image and normalized,
+     * a level of scale 1 is the normalized input image.
+     *
+     * @param[out] pyramid Normalized grayscale image of each level.
+     * @param[in] input Input grayscale image.
+     * @param[in] scales Scale of each level.
+     */
+    void computePyramid(std::vector<image::Image<float>>& pyramid, const image::Image<float>& input, const std::vector<double>& scales) const;
+
     /**
      * @brief Retrieve min and max pixel values of a grayscale image.
      *
@@ -245,6 +256,9 @@ class CheckerDetector
      * 2. while it is possible, perform a grow step on the board: find corners that can be connected to the board and include them
      * 3. compute the board's energy and reject it if it is above a certain threshold
      *
+     * The boards of a batch of seeds are grown in parallel, then accepted in the seeds order,
+     * so the result is the same as growing the seeds one after the other.
+     *
      * @param[out] boards Container for the built checkerboards.
      * @param[in] refinedCorners Corners with directions information.
      * @param[in] input Input grayscale image.
@@ -6,6 +6,7 @@
 
 #include "distortionEstimation.hpp"
 
+#include <aliceVision/alicevision_omp.hpp>
 #include <aliceVision/system/Logger.hpp>
 
 #include <ceres/ceres.h>
@@ -108,18 +109,60 @@ class CostLine : public ceres::CostFunction
     Vec2 _pt;
 };
 
+namespace {
+
+/**
+ * @brief Lock the distortion parameters of a step.
+ * @note The parameter block is made constant if all the parameters are locked,
+ *       ceres does not accept a subset manifold with all the parameters constant.
+ */
+void setLockedDistortions(ceres::Problem& problem, double* ptrUndistortionParameters, const std::vector<bool>& lockDistortions)
+{
+    std::vector<int> constantDistortions;
+    for (int idParamDistortion = 0; idParamDistortion < lockDistortions.size(); ++idParamDistortion)
+    {
+        if (lockDistortions[idParamDistortion])
+        {
+            constantDistortions.push_back(idParamDistortion);
+        }
+    }
+
+    if (constantDistortions.size() == lockDistortions.size())
+    {
+        problem.SetParameterBlockConstant(ptrUndistortionParameters);
+        return;
+    }
+
+    // At least one parameter is not locked
+    problem.SetParameterBlockVariable(ptrUndistortionParameters);
+    problem.SetManifold(ptrUndistortionParameters,
+                        constantDistortions.empty() ? nullptr : new ceres::SubsetManifold(lockDistortions.size(), constantDistortions));
+}
+
+}  // namespace
+
 bool estimate(std::shared_ptr<camera::Undistortion> undistortionToEstimate,
               Statistics& statistics,
               std::vector<LineWithPoints>& lines,
               bool lockCenter,
               const std::vector<bool>& lockDistortions)
+{
+    return estimate(undistortionToEstimate, statistics, lines, lockCenter, std::vector<std::vector<bool>>{lockDistortions});
+}
+
+bool estimate(std::shared_ptr<camera::Undistortion> undistortionToEstimate,
+              Statistics& statistics,
+              std::vector<LineWithPoints>& lines,
+              bool lockCenter,
+              const std::vector<std::vector<bool>>& lockSteps,
+              int nbThreads)
 {
     if (!undistortionToEstimate)
     {
         return false;
     }
 
-    if (lines.empty())
+    if (lines.empty() || lockSteps.empty())
     {
         return false;
     }
@@ -131,11 +174,14 @@ bool estimate(std::shared_ptr<camera::Undistortion> undistortionToEstimate,
     Vec2 undistortionOffset = undistortionToEstimate->getOffset();
     const std::size_t countUndistortionParams = undistortionParameters.size();
 
-    if (lockDistortions.size() != countUndistortionParams)
+    for (const std::vector<bool>& lockDistortions : lockSteps)
     {
-        ALICEVISION_LOG_ERROR("Invalid number of distortion parameters (lockDistortions=" << lockDistortions.size() << ", countDistortionParams="
-                                                                                          << countUndistortionParams << ").");
-        return false;
+        if (lockDistortions.size() != countUndistortionParams)
+        {
+            ALICEVISION_LOG_ERROR("Invalid number of distortion parameters (lockDistortions=" << lockDistortions.size() << ", countDistortionParams="
+                                                                                              << countUndistortionParams << ").");
+            return false;
+        }
     }
 
     double* ptrUndistortionParameters = &undistortionParameters[0];
@@ -151,40 +197,6 @@ bool estimate(std::shared_ptr<camera::Undistortion> undistortionToEstimate,
     // Add distortion parameter
     problem.AddParameterBlock(ptrUndistortionParameters, countUndistortionParams);
 
-    // Check if all distortions are locked
-    bool allLocked = true;
-    for (bool lock : lockDistortions)
-    {
-        if (!lock)
-        {
-            allLocked = false;
-        }
-    }
-
-    if (allLocked)
-    {
-        problem.SetParameterBlockConstant(ptrUndistortionParameters);
-    }
-    else
-    {
-        // At least one parameter is not locked
-
-        std::vector<int> constantDistortions;
-        for (int idParamDistortion = 0; idParamDistortion < lockDistortions.size(); ++idParamDistortion)
-        {
-            if (lockDistortions[idParamDistortion])
-            {
-                constantDistortions.push_back(idParamDistortion);
-            }
-        }
-
-        if (!constantDistortions.empty())
-        {
-            ceres::SubsetManifold* subsetManifold = new ceres::SubsetManifold(countUndistortionParams, constantDistortions);
-            problem.SetManifold(ptrUndistortionParameters, subsetManifold);
-        }
-    }
-
     for (auto& l : lines)
     {
         problem.AddParameterBlock(&l.angle, 1);
@@ -192,7 +204,8 @@ bool estimate(std::shared_ptr<camera::Undistortion> undistortionToEstimate,
 
         for (Vec2 pt : l.points)
         {
-            ceres::CostFunction* costFunction = new CostLine(undistortionToEstimate, pt);
+            // each cost function has its own copy of the undistortion, the residuals are evaluated concurrently
+            ceres::CostFunction* costFunction = new CostLine(std::shared_ptr<camera::Undistortion>(undistortionToEstimate->clone()), pt);
             problem.AddResidualBlock(costFunction, lossFunction, &l.angle, &l.dist, center, ptrUndistortionParameters);
         }
     }
@@ -201,16 +214,22 @@ bool estimate(std::shared_ptr<camera::Undistortion> undistortionToEstimate,
     options.use_inner_iterations = true;
     options.max_num_iterations = 100;
     options.logging_type = ceres::SILENT;
+    options.num_threads = (nbThreads > 0) ? nbThreads : omp_get_max_threads();
 
-    ceres::Solver::Summary summary;
-    ceres::Solve(options, &problem, &summary);
+    for (std::size_t idStep = 0; idStep < lockSteps.size(); ++idStep)
+    {
+        setLockedDistortions(problem, ptrUndistortionParameters, lockSteps[idStep]);
 
-    ALICEVISION_LOG_TRACE(summary.FullReport());
+        ceres::Solver::Summary summary;
+        ceres::Solve(options, &problem, &summary);
 
-    if (!summary.IsSolutionUsable())
-    {
-        ALICEVISION_LOG_ERROR("Lens calibration estimation failed.");
-        return false;
+        ALICEVISION_LOG_TRACE(summary.FullReport());
+
+        if (!summary.IsSolutionUsable())
+        {
+            ALICEVISION_LOG_ERROR("Lens calibration estimation failed at step " << idStep << ".");
+            return false;
+        }
     }
 
     undistortionToEstimate->setOffset(undistortionOffset);
@@ -60,5 +60,27 @@ bool estimate(std::shared_ptr<camera::Undistortion> undistortionToEstimate,
               bool lockCenter,
               const std::vector<bool>& lockDistortions);
 
+/**
+ * @brief Estimate the undistortion parameters of a camera using a set of line aligned points,
+ *        in several steps locking different sets of distortion parameters.
+ *
+ * The optimization problem is built once, each step only changes the locked parameters
+ * and starts from the parameters (distortion and lines) estimated by the previous step.
+ *
+ * @param[out] undistortionToEstimate Undistortion object with the parameters to estimate, its parameters are the initial guess.
+ * @param[out] statistics Statistics on the estimation error after the last step.
+ * @param[in] lines Set of line aligned points used to estimate distortion.
+ * @param[in] lockCenter Lock the distortion offset during optimization.
+ * @param[in] lockSteps For each step, the distortion parameters to lock during optimization.
+ * @param[in] nbThreads Number of threads of the solver (0 to use all the available threads).
+ * @return False if one of the steps failed, otherwise true.
+ */
+bool estimate(std::shared_ptr<camera::Undistortion> undistortionToEstimate,
+              Statistics& statistics,
+              std::vector<LineWithPoints>& lines,
+              bool lockCenter,
+              const std::vector<std::vector<bool>>& lockSteps,
+              int nbThreads = 0);
+
 }  // namespace calibration
 }  // namespace aliceVision
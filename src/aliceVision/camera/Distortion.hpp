@@ -57,6 +57,24 @@ class Distortion
     /// Remove distortion (return p' such that disto(p') = p)
     virtual Vec2 removeDistortion(const Vec2& p) const { return p; }
 
+    /// Add distortion to a batch of points (in place allowed), same as addDistortion for each point
+    virtual void addDistortionBatch(const Vec2* pts, Vec2* out, std::size_t nbPoints) const
+    {
+        for (std::size_t i = 0; i < nbPoints; ++i)
+        {
+            out[i] = addDistortion(pts[i]);
+        }
+    }
+
+    /// Remove distortion from a batch of points (in place allowed), same as removeDistortion for each point
+    virtual void removeDistortionBatch(const Vec2* pts, Vec2* out, std::size_t nbPoints) const
+    {
+        for (std::size_t i = 0; i < nbPoints; ++i)
+        {
+            out[i] = removeDistortion(pts[i]);
+        }
+    }
+
     virtual double getUndistortedRadius(double r) const { return r; }
 
     virtual Eigen::Matrix2d getDerivativeAddDistoWrtPt(const Vec2& p) const { return Eigen::Matrix2d::Identity(); }
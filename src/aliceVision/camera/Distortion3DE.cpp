@@ -672,5 +672,53 @@ Vec2 Distortion3DEClassicLD::removeDistortion(const Vec2& p) const
     return undistorted_value;
 }
 
+void Distortion3DERadial4::addDistortionBatch(const Vec2* pts, Vec2* out, std::size_t nbPoints) const
+{
+    for (std::size_t i = 0; i < nbPoints; ++i)
+    {
+        out[i] = Distortion3DERadial4::addDistortion(pts[i]);
+    }
+}
+
+void Distortion3DERadial4::removeDistortionBatch(const Vec2* pts, Vec2* out, std::size_t nbPoints) const
+{
+    for (std::size_t i = 0; i < nbPoints; ++i)
+    {
+        out[i] = Distortion3DERadial4::removeDistortion(pts[i]);
+    }
+}
+
+void Distortion3DEAnamorphic4::addDistortionBatch(const Vec2* pts, Vec2* out, std::size_t nbPoints) const
+{
+    for (std::size_t i = 0; i < nbPoints; ++i)
+    {
+        out[i] = Distortion3DEAnamorphic4::addDistortion(pts[i]);
+    }
+}
+
+void Distortion3DEAnamorphic4::removeDistortionBatch(const Vec2* pts, Vec2* out, std::size_t nbPoints) const
+{
+    for (std::size_t i = 0; i < nbPoints; ++i)
+    {
+        out[i] = Distortion3DEAnamorphic4::removeDistortion(pts[i]);
+    }
+}
+
+void Distortion3DEClassicLD::addDistortionBatch(const Vec2* pts, Vec2* out, std::size_t nbPoints) const
+{
+    for (std::size_t i = 0; i < nbPoints; ++i)
+    {
+        out[i] = Distortion3DEClassicLD::addDistortion(pts[i]);
+    }
+}
+
+void Distortion3DEClassicLD::removeDistortionBatch(const Vec2* pts, Vec2* out, std::size_t nbPoints) const
+{
+    for (std::size_t i = 0; i < nbPoints; ++i)
+    {
+        out[i] = Distortion3DEClassicLD::removeDistortion(pts[i]);
+    }
+}
+
 }  // namespace camera
 }  // namespace aliceVision
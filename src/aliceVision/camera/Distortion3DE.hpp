@@ -39,6 +39,9 @@ class Distortion3DERadial4 : public Distortion
     /// Add distortion to the point p (assume p is in the camera frame [normalized coordinates])
     Vec2 addDistortion(const Vec2& p) const override;
 
+    /// Add distortion to a batch of points, without a virtual call per point (in place allowed)
+    void addDistortionBatch(const Vec2* pts, Vec2* out, std::size_t nbPoints) const override;
+
     Eigen::Matrix2d getDerivativeAddDistoWrtPt(const Vec2& p) const override;
 
     Eigen::MatrixXd getDerivativeAddDistoWrtDisto(const Vec2& p) const override;
@@ -46,6 +49,9 @@ class Distortion3DERadial4 : public Distortion
     /// Remove distortion (return p' such that disto(p') = p)
     Vec2 removeDistortion(const Vec2& p) const override;
 
+    /// Remove distortion from a batch of points, without a virtual call per point (in place allowed)
+    void removeDistortionBatch(const Vec2* pts, Vec2* out, std::size_t nbPoints) const override;
+
     Eigen::Matrix2d getDerivativeRemoveDistoWrtPt(const Vec2& p) const override
     {
         ALICEVISION_THROW_ERROR("Invalid class for getDerivativeRemoveDistoWrtPt");
@@ -101,6 +107,9 @@ class Distortion3DEAnamorphic4 : public Distortion
     /// Add distortion to the point p (assume p is in the camera frame [normalized coordinates])
     Vec2 addDistortion(const Vec2& p) const override;
 
+    /// Add distortion to a batch of points, without a virtual call per point (in place allowed)
+    void addDistortionBatch(const Vec2* pts, Vec2* out, std::size_t nbPoints) const override;
+
     Eigen::Matrix2d getDerivativeAddDistoWrtPt(const Vec2& p) const override;
 
     Eigen::MatrixXd getDerivativeAddDistoWrtDisto(const Vec2& p) const override;
@@ -108,6 +117,9 @@ class Distortion3DEAnamorphic4 : public Distortion
     /// Remove distortion (return p' such that disto(p') = p)
     Vec2 removeDistortion(const Vec2& p) const override;
 
+    /// Remove distortion from a batch of points, without a virtual call per point (in place allowed)
+    void removeDistortionBatch(const Vec2* pts, Vec2* out, std::size_t nbPoints) const override;
+
     Eigen::Matrix2d getDerivativeRemoveDistoWrtPt(const Vec2& p) const override
     {
         ALICEVISION_THROW_ERROR("Invalid class for getDerivativeRemoveDistoWrtPt");
@@ -150,6 +162,9 @@ class Distortion3DEClassicLD : public Distortion
     /// Add distortion to the point p (assume p is in the camera frame [normalized coordinates])
     Vec2 addDistortion(const Vec2& p) const override;
 
+    /// Add distortion to a batch of points, without a virtual call per point (in place allowed)
+    void addDistortionBatch(const Vec2* pts, Vec2* out, std::size_t nbPoints) const override;
+
     Eigen::Matrix2d getDerivativeAddDistoWrtPt(const Vec2& p) const override;
 
     Eigen::MatrixXd getDerivativeAddDistoWrtDisto(const Vec2& p) const override;
@@ -157,6 +172,9 @@ class Distortion3DEClassicLD : public Distortion
     /// Remove distortion (return p' such that disto(p') = p)
     Vec2 removeDistortion(const Vec2& p) const override;
 
+    /// Remove distortion from a batch of points, without a virtual call per point (in place allowed)
+    void removeDistortionBatch(const Vec2* pts, Vec2* out, std::size_t nbPoints) const override;
+
     Eigen::Matrix2d getDerivativeRemoveDistoWrtPt(const Vec2& p) const override
     {
         ALICEVISION_THROW_ERROR("Invalid class for getDerivativeRemoveDistoWrtPt");
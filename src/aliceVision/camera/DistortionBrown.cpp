@@ -40,5 +40,21 @@ Vec2 DistortionBrown::removeDistortion(const Vec2& p) const
     return p_u;
 }
 
+void DistortionBrown::addDistortionBatch(const Vec2* pts, Vec2* out, std::size_t nbPoints) const
+{
+    for (std::size_t i = 0; i < nbPoints; ++i)
+    {
+        out[i] = DistortionBrown::addDistortion(pts[i]);
+    }
+}
+
+void DistortionBrown::removeDistortionBatch(const Vec2* pts, Vec2* out, std::size_t nbPoints) const
+{
+    for (std::size_t i = 0; i < nbPoints; ++i)
+    {
+        out[i] = DistortionBrown::removeDistortion(pts[i]);
+    }
+}
+
 }  // namespace camera
 }  // namespace aliceVision
@@ -200,5 +200,21 @@ Eigen::MatrixXd DistortionFisheye::getDerivativeRemoveDistoWrtDisto(const Vec2&
     return ret;
 }
 
+void DistortionFisheye::addDistortionBatch(const Vec2* pts, Vec2* out, std::size_t nbPoints) const
+{
+    for (std::size_t i = 0; i < nbPoints; ++i)
+    {
+        out[i] = DistortionFisheye::addDistortion(pts[i]);
+    }
+}
+
+void DistortionFisheye::removeDistortionBatch(const Vec2* pts, Vec2* out, std::size_t nbPoints) const
+{
+    for (std::size_t i = 0; i < nbPoints; ++i)
+    {
+        out[i] = DistortionFisheye::removeDistortion(pts[i]);
+    }
+}
+
 }  // namespace camera
 }  // namespace aliceVision
@@ -26,6 +26,9 @@ class DistortionFisheye : public Distortion
     /// Add distortion to the point p (assume p is in the camera frame [normalized coordinates])
     Vec2 addDistortion(const Vec2& p) const override;
 
+    /// Add distortion to a batch of points, without a virtual call per point (in place allowed)
+    void addDistortionBatch(const Vec2* pts, Vec2* out, std::size_t nbPoints) const override;
+
     Eigen::Matrix2d getDerivativeAddDistoWrtPt(const Vec2& p) const override;
 
     Eigen::MatrixXd getDerivativeAddDistoWrtDisto(const Vec2& p) const override;
@@ -33,6 +36,9 @@ class DistortionFisheye : public Distortion
     /// Remove distortion (return p' such that disto(p') = p)
     Vec2 removeDistortion(const Vec2& p) const override;
 
+    /// Remove distortion from a batch of points, without a virtual call per point (in place allowed)
+    void removeDistortionBatch(const Vec2* pts, Vec2* out, std::size_t nbPoints) const override;
+
     Eigen::Matrix2d getDerivativeRemoveDistoWrtPt(const Vec2& p) const override;
 
     Eigen::MatrixXd getDerivativeRemoveDistoWrtDisto(const Vec2& p) const override;
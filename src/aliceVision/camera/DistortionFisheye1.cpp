@@ -25,5 +25,21 @@ Vec2 DistortionFisheye1::removeDistortion(const Vec2& p) const
     return p * coef;
 }
 
+void DistortionFisheye1::addDistortionBatch(const Vec2* pts, Vec2* out, std::size_t nbPoints) const
+{
+    for (std::size_t i = 0; i < nbPoints; ++i)
+    {
+        out[i] = DistortionFisheye1::addDistortion(pts[i]);
+    }
+}
+
+void DistortionFisheye1::removeDistortionBatch(const Vec2* pts, Vec2* out, std::size_t nbPoints) const
+{
+    for (std::size_t i = 0; i < nbPoints; ++i)
+    {
+        out[i] = DistortionFisheye1::removeDistortion(pts[i]);
+    }
+}
+
 }  // namespace camera
 }  // namespace aliceVision
@@ -0,0 +1,198 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "DistortionGrid.hpp"
+
+#include <aliceVision/camera/IntrinsicBase.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <map>
+#include <mutex>
+#include <tuple>
+
+namespace aliceVision {
+namespace camera {
+
+namespace {
+
+/// maximum number of grids kept by DistortionGrid::getShared
+constexpr std::size_t maxNbSharedGrids = 64;
+
+}  // namespace
+
+DistortionGrid::DistortionGrid(const Mapping& mapping,
+                               const Vec2& domainMin,
+                               const Vec2& domainMax,
+                               double maxError,
+                               double initialStep,
+                               double minStep)
+  : _mapping(mapping),
+    _domainMin(domainMin),
+    _domainMax(domainMax)
+{
+    double step = std::max(initialStep, minStep);
+    std::size_t nbFailingCells = sample(step, maxError);
+
+    // refine while more than 1% of the cells exceed the error bound
+    while (nbFailingCells * 100 > _validCells.size() && step * 0.5 >= minStep)
+    {
+        step *= 0.5;
+        nbFailingCells = sample(step, maxError);
+    }
+}
+
+std::size_t DistortionGrid::sample(double step, double maxError)
+{
+    _step = step;
+    _nbCellsX = std::max(1, static_cast<int>(std::ceil((_domainMax.x() - _domainMin.x()) / step)));
+    _nbCellsY = std::max(1, static_cast<int>(std::ceil((_domainMax.y() - _domainMin.y()) / step)));
+
+    const int nbNodesX = _nbCellsX + 1;
+    _nodes.resize(static_cast<std::size_t>(nbNodesX) * (_nbCellsY + 1));
+    for (int y = 0; y <= _nbCellsY; ++y)
+    {
+        for (int x = 0; x <= _nbCellsX; ++x)
+        {
+            _nodes[y * nbNodesX + x] = _mapping(_domainMin + Vec2(x, y) * step);
+        }
+    }
+
+    // error check points in cell coordinates
+    const std::array<Vec2, 5> checkPoints = {Vec2(0.5, 0.5), Vec2(0.5, 0.0), Vec2(0.0, 0.5), Vec2(1.0, 0.5), Vec2(0.5, 1.0)};
+
+    std::size_t nbFailingCells = 0;
+    _validCells.assign(static_cast<std::size_t>(_nbCellsX) * _nbCellsY, 0);
+    for (int y = 0; y < _nbCellsY; ++y)
+    {
+        for (int x = 0; x < _nbCellsX; ++x)
+        {
+            const Vec2& n00 = _nodes[y * nbNodesX + x];
+            const Vec2& n10 = _nodes[y * nbNodesX + x + 1];
+            const Vec2& n01 = _nodes[(y + 1) * nbNodesX + x];
+            const Vec2& n11 = _nodes[(y + 1) * nbNodesX + x + 1];
+
+            if (!n00.allFinite() || !n10.allFinite() || !n01.allFinite() || !n11.allFinite())
+            {
+                // undefined mapping, always evaluated exactly
+                continue;
+            }
+
+            bool valid = true;
+            for (const Vec2& c : checkPoints)
+            {
+                const Vec2 interpolated = (1.0 - c.y()) * ((1.0 - c.x()) * n00 + c.x() * n10) + c.y() * ((1.0 - c.x()) * n01 + c.x() * n11);
+                const Vec2 exact = _mapping(_domainMin + (Vec2(x, y) + c) * step);
+                if (!exact.allFinite() || (interpolated - exact).norm() > maxError)
+                {
+                    valid = false;
+                    break;
+                }
+            }
+
+            if (valid)
+            {
+                _validCells[y * _nbCellsX + x] = 1;
+            }
+            else
+            {
+                ++nbFailingCells;
+            }
+        }
+    }
+
+    return nbFailingCells;
+}
+
+Vec2 DistortionGrid::operator()(const Vec2& p) const
+{
+    const double gx = (p.x() - _domainMin.x()) / _step;
+    const double gy = (p.y() - _domainMin.y()) / _step;
+
+    if (!(gx >= 0.0 && gy >= 0.0 && gx <= _nbCellsX && gy <= _nbCellsY))
+    {
+        return _mapping(p);
+    }
+
+    const int x = std::min(static_cast<int>(gx), _nbCellsX - 1);
+    const int y = std::min(static_cast<int>(gy), _nbCellsY - 1);
+
+    if (!_validCells[y * _nbCellsX + x])
+    {
+        return _mapping(p);
+    }
+
+    const double fx = gx - x;
+    const double fy = gy - y;
+    const int nbNodesX = _nbCellsX + 1;
+
+    const Vec2& n00 = _nodes[y * nbNodesX + x];
+    const Vec2& n10 = _nodes[y * nbNodesX + x + 1];
+    const Vec2& n01 = _nodes[(y + 1) * nbNodesX + x];
+    const Vec2& n11 = _nodes[(y + 1) * nbNodesX + x + 1];
+
+    return (1.0 - fy) * ((1.0 - fx) * n00 + fx * n10) + fy * ((1.0 - fx) * n01 + fx * n11);
+}
+
+double DistortionGrid::getExactCellsRatio() const
+{
+    if (_validCells.empty())
+    {
+        return 1.0;
+    }
+
+    const std::size_t nbValidCells = std::count(_validCells.begin(), _validCells.end(), 1);
+    return 1.0 - static_cast<double>(nbValidCells) / static_cast<double>(_validCells.size());
+}
+
+std::shared_ptr<const DistortionGrid> DistortionGrid::getShared(const IntrinsicBase& intrinsic, EDirection direction, double maxError)
+{
+    using Key = std::tuple<std::size_t, EDirection, double>;
+
+    static std::mutex cacheMutex;
+    static std::map<Key, std::shared_ptr<const DistortionGrid>> cache;
+
+    const Key key(intrinsic.hashValue(), direction, maxError);
+
+    std::lock_guard<std::mutex> lock(cacheMutex);
+
+    const auto it = cache.find(key);
+    if (it != cache.end())
+    {
+        return it->second;
+    }
+
+    if (cache.size() >= maxNbSharedGrids)
+    {
+        cache.clear();
+    }
+
+    // the grid keeps its own copy of the intrinsic
+    const std::shared_ptr<const IntrinsicBase> intrinsicCopy(intrinsic.clone());
+
+    Mapping mapping;
+    if (direction == EDirection::DISTORT)
+    {
+        mapping = [intrinsicCopy](const Vec2& p) { return intrinsicCopy->get_d_pixel(p); };
+    }
+    else
+    {
+        mapping = [intrinsicCopy](const Vec2& p) { return intrinsicCopy->get_ud_pixel(p); };
+    }
+
+    // cover the image with a margin for the principal point corrections
+    const Vec2 size(intrinsic.w(), intrinsic.h());
+    const Vec2 margin = 0.1 * size;
+
+    std::shared_ptr<const DistortionGrid> grid = std::make_shared<DistortionGrid>(mapping, -margin, size + margin, maxError);
+    cache.emplace(key, grid);
+
+    return grid;
+}
+
+}  // namespace camera
+}  // namespace aliceVision
@@ -0,0 +1,105 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <aliceVision/numeric/numeric.hpp>
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace aliceVision {
+namespace camera {
+
+class IntrinsicBase;
+
+/**
+ * @brief Lookup grid of a smooth pixel-to-pixel mapping (distortion, undistortion, reprojection).
+ *
+ * The mapping is sampled on a regular grid and interpolated bilinearly.
+ * The interpolation error is measured at the cells centers and edges midpoints and the grid step is halved
+ * while more than 1% of the cells exceed the requested bound. The cells that still exceed it, the cells with
+ * a non-finite node and the points outside of the grid are evaluated with the exact mapping.
+ */
+class DistortionGrid
+{
+  public:
+    using Mapping = std::function<Vec2(const Vec2&)>;
+
+    enum class EDirection
+    {
+        /// undistorted pixel to distorted pixel (IntrinsicBase::get_d_pixel)
+        DISTORT,
+        /// distorted pixel to undistorted pixel (IntrinsicBase::get_ud_pixel)
+        UNDISTORT
+    };
+
+    /**
+     * @brief Build the lookup grid of a mapping
+     * @param[in] mapping The exact mapping, it should return a non-finite value where it is not defined
+     * @param[in] domainMin The lower corner of the domain covered by the grid
+     * @param[in] domainMax The upper corner of the domain covered by the grid
+     * @param[in] maxError The maximum interpolation error in pixels
+     * @param[in] initialStep The initial grid step in pixels
+     * @param[in] minStep The minimum grid step in pixels
+     */
+    DistortionGrid(const Mapping& mapping,
+                   const Vec2& domainMin,
+                   const Vec2& domainMax,
+                   double maxError = 0.01,
+                   double initialStep = 16.0,
+                   double minStep = 4.0);
+
+    /**
+     * @brief Evaluate the mapping
+     * @param[in] p The input pixel
+     * @return the interpolated value, or the exact one outside of the valid cells
+     */
+    Vec2 operator()(const Vec2& p) const;
+
+    /**
+     * @brief Get the grid step in pixels
+     */
+    double getStep() const { return _step; }
+
+    /**
+     * @brief Get the ratio of the cells evaluated with the exact mapping
+     */
+    double getExactCellsRatio() const;
+
+    /**
+     * @brief Get a lookup grid of the distortion of an intrinsic over its image domain, shared between callers.
+     *        The grids are cached by intrinsic hash value, so that a grid is built once per intrinsic.
+     * @param[in] intrinsic The camera intrinsic, cloned by the grid
+     * @param[in] direction Distortion or undistortion
+     * @param[in] maxError The maximum interpolation error in pixels
+     * @return the shared lookup grid
+     */
+    static std::shared_ptr<const DistortionGrid> getShared(const IntrinsicBase& intrinsic, EDirection direction, double maxError = 0.01);
+
+  private:
+    /**
+     * @brief Sample the nodes of the grid at the given step
+     * @return the number of cells exceeding the error bound
+     */
+    std::size_t sample(double step, double maxError);
+
+    Mapping _mapping;
+    Vec2 _domainMin;
+    Vec2 _domainMax;
+
+    double _step = 0.0;
+    int _nbCellsX = 0;
+    int _nbCellsY = 0;
+    /// nodes values, row major ((_nbCellsX + 1) * (_nbCellsY + 1))
+    std::vector<Vec2> _nodes;
+    /// cells interpolated from the nodes, row major (_nbCellsX * _nbCellsY)
+    std::vector<unsigned char> _validCells;
+};
+
+}  // namespace camera
+}  // namespace aliceVision
@@ -450,5 +450,53 @@ double DistortionRadialK3PT::getUndistortedRadius(double r) const
     return std::sqrt(radial_distortion::bisection_Radius_Solve(_distortionParams, r * r, distoFunctor));
 }
 
+void DistortionRadialK1::addDistortionBatch(const Vec2* pts, Vec2* out, std::size_t nbPoints) const
+{
+    for (std::size_t i = 0; i < nbPoints; ++i)
+    {
+        out[i] = DistortionRadialK1::addDistortion(pts[i]);
+    }
+}
+
+void DistortionRadialK1::removeDistortionBatch(const Vec2* pts, Vec2* out, std::size_t nbPoints) const
+{
+    for (std::size_t i = 0; i < nbPoints; ++i)
+    {
+        out[i] = DistortionRadialK1::removeDistortion(pts[i]);
+    }
+}
+
+void DistortionRadialK3::addDistortionBatch(const Vec2* pts, Vec2* out, std::size_t nbPoints) const
+{
+    for (std::size_t i = 0; i < nbPoints; ++i)
+    {
+        out[i] = DistortionRadialK3::addDistortion(pts[i]);
+    }
+}
+
+void DistortionRadialK3::removeDistortionBatch(const Vec2* pts, Vec2* out, std::size_t nbPoints) const
+{
+    for (std::size_t i = 0; i < nbPoints; ++i)
+    {
+        out[i] = DistortionRadialK3::removeDistortion(pts[i]);
+    }
+}
+
+void DistortionRadialK3PT::addDistortionBatch(const Vec2* pts, Vec2* out, std::size_t nbPoints) const
+{
+    for (std::size_t i = 0; i < nbPoints; ++i)
+    {
+        out[i] = DistortionRadialK3PT::addDistortion(pts[i]);
+    }
+}
+
+void DistortionRadialK3PT::removeDistortionBatch(const Vec2* pts, Vec2* out, std::size_t nbPoints) const
+{
+    for (std::size_t i = 0; i < nbPoints; ++i)
+    {
+        out[i] = DistortionRadialK3PT::removeDistortion(pts[i]);
+    }
+}
+
 }  // namespace camera
 }  // namespace aliceVision
@@ -73,6 +73,9 @@ class DistortionRadialK1 : public Distortion
     /// Add distortion to the point p (assume p is in the camera frame [normalized coordinates])
     Vec2 addDistortion(const Vec2& p) const override;
 
+    /// Add distortion to a batch of points, without a virtual call per point (in place allowed)
+    void addDistortionBatch(const Vec2* pts, Vec2* out, std::size_t nbPoints) const override;
+
     Eigen::Matrix2d getDerivativeAddDistoWrtPt(const Vec2& p) const override;
 
     Eigen::MatrixXd getDerivativeAddDistoWrtDisto(const Vec2& p) const override;
@@ -80,6 +83,9 @@ class DistortionRadialK1 : public Distortion
     /// Remove distortion (return p' such that disto(p') = p)
     Vec2 removeDistortion(const Vec2& p) const override;
 
+    /// Remove distortion from a batch of points, without a virtual call per point (in place allowed)
+    void removeDistortionBatch(const Vec2* pts, Vec2* out, std::size_t nbPoints) const override;
+
     Eigen::Matrix2d getDerivativeRemoveDistoWrtPt(const Vec2& p) const override;
 
     Eigen::MatrixXd getDerivativeRemoveDistoWrtDisto(const Vec2& p) const override;
@@ -120,6 +126,9 @@ class DistortionRadialK3 : public Distortion
     /// Add distortion to the point p (assume p is in the camera frame [normalized coordinates])
     Vec2 addDistortion(const Vec2& p) const override;
 
+    /// Add distortion to a batch of points, without a virtual call per point (in place allowed)
+    void addDistortionBatch(const Vec2* pts, Vec2* out, std::size_t nbPoints) const override;
+
     Eigen::Matrix2d getDerivativeAddDistoWrtPt(const Vec2& p) const override;
 
     Eigen::MatrixXd getDerivativeAddDistoWrtDisto(const Vec2& p) const override;
@@ -127,6 +136,9 @@ class DistortionRadialK3 : public Distortion
     /// Remove distortion (return p' such that disto(p') = p)
     Vec2 removeDistortion(const Vec2& p) const override;
 
+    /// Remove distortion from a batch of points, without a virtual call per point (in place allowed)
+    void removeDistortionBatch(const Vec2* pts, Vec2* out, std::size_t nbPoints) const override;
+
     Eigen::Matrix2d getDerivativeRemoveDistoWrtPt(const Vec2& p) const override;
 
     Eigen::MatrixXd getDerivativeRemoveDistoWrtDisto(const Vec2& p) const override;
@@ -153,6 +165,9 @@ class DistortionRadialK3PT : public Distortion
     /// Add distortion to the point p (assume p is in the camera frame [normalized coordinates])
     Vec2 addDistortion(const Vec2& p) const override;
 
+    /// Add distortion to a batch of points, without a virtual call per point (in place allowed)
+    void addDistortionBatch(const Vec2* pts, Vec2* out, std::size_t nbPoints) const override;
+
     Eigen::Matrix2d getDerivativeAddDistoWrtPt(const Vec2& p) const override;
 
     Eigen::MatrixXd getDerivativeAddDistoWrtDisto(const Vec2& p) const override;
@@ -164,6 +179,9 @@ class DistortionRadialK3PT : public Distortion
     /// Remove distortion (return p' such that disto(p') = p)
     Vec2 removeDistortion(const Vec2& p) const override;
 
+    /// Remove distortion from a batch of points, without a virtual call per point (in place allowed)
+    void removeDistortionBatch(const Vec2* pts, Vec2* out, std::size_t nbPoints) const override;
+
     double getUndistortedRadius(double r) const override;
 
     /// Functor to solve Square(disto(radius(p'))) = r^2
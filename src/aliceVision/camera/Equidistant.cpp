@@ -38,6 +38,66 @@ Vec2 Equidistant::project(const Eigen::Matrix4d& pose, const Vec4& pt, bool appl
     return pt_ima;
 }
 
+void Equidistant::projectBatch(const Eigen::Matrix4d& pose, const Vec3* pts3D, Vec2* pts2D, std::size_t nbPoints, bool applyDistortion) const
+{
+    const double rsensor = std::min(sensorWidth(), sensorHeight());
+    const double rscale = sensorWidth() / std::max(w(), h());
+    const double fmm = _scale(0) * rscale;
+    const double fov = rsensor / fmm;
+
+    const Mat3 R = pose.block<3, 3>(0, 0);
+    const Vec3 t = pose.block<3, 1>(0, 3);
+
+    for (std::size_t i = 0; i < nbPoints; ++i)
+    {
+        const Vec3 X = R * pts3D[i] + t;
+
+        // radius = focal * angle_Z, along the radial direction
+        const double len2d = std::sqrt(X(0) * X(0) + X(1) * X(1));
+        const double angle_Z = std::atan2(len2d, X(2));
+        const double radius = angle_Z / (0.5 * fov);
+
+        if (len2d > 0.0)
+        {
+            pts2D[i] = Vec2(X(0), X(1)) * (radius / len2d);
+        }
+        else
+        {
+            pts2D[i] = Vec2(radius, 0.0);
+        }
+    }
+
+    if (applyDistortion)
+    {
+        addDistortionBatch(pts2D, nbPoints);
+    }
+
+    const Vec2 pp = getPrincipalPoint();
+    for (std::size_t i = 0; i < nbPoints; ++i)
+    {
+        pts2D[i] = _circleRadius * pts2D[i] + pp;
+    }
+}
+
+void Equidistant::unprojectBatch(const Vec2* pts2D, Vec3* rays, std::size_t nbPoints, bool applyUndistortion) const
+{
+    std::vector<Vec2> ptsCam(nbPoints);
+    for (std::size_t i = 0; i < nbPoints; ++i)
+    {
+        ptsCam[i] = Equidistant::ima2cam(pts2D[i]);
+    }
+
+    if (applyUndistortion)
+    {
+        removeDistortionBatch(ptsCam.data(), nbPoints);
+    }
+
+    for (std::size_t i = 0; i < nbPoints; ++i)
+    {
+        rays[i] = Equidistant::toUnitSphere(ptsCam[i]);
+    }
+}
+
 Eigen::Matrix<double, 2, 9> Equidistant::getDerivativeProjectWrtRotation(const Eigen::Matrix4d& pose, const Vec4& pt)
 {
     Eigen::Matrix4d T = pose;
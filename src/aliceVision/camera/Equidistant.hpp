@@ -67,6 +67,15 @@ class Equidistant : public IntrinsicScaleOffsetDisto
 
     Vec2 project(const Eigen::Matrix4d& pose, const Vec4& pt, bool applyDistortion = true) const override;
 
+    void projectBatch(const Eigen::Matrix4d& pose, const Vec3* pts3D, Vec2* pts2D, std::size_t nbPoints, bool applyDistortion = true) const override;
+
+    void projectBatch(const geometry::Pose3& pose, const Vec3* pts3D, Vec2* pts2D, std::size_t nbPoints, bool applyDistortion = true) const
+    {
+        projectBatch(pose.getHomogeneous(), pts3D, pts2D, nbPoints, applyDistortion);
+    }
+
+    void unprojectBatch(const Vec2* pts2D, Vec3* rays, std::size_t nbPoints, bool applyUndistortion = true) const override;
+
     Vec2 project(const geometry::Pose3& pose, const Vec4& pt3D, bool applyDistortion = true) const
     {
         return project(pose.getHomogeneous(), pt3D, applyDistortion);
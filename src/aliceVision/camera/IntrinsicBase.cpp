@@ -27,6 +27,23 @@ Vec3 IntrinsicBase::backproject(const Vec2& pt2D, bool applyUndistortion, const
     return output;
 }
 
+void IntrinsicBase::projectBatch(const Eigen::Matrix4d& pose, const Vec3* pts3D, Vec2* pts2D, std::size_t nbPoints, bool applyDistortion) const
+{
+    for (std::size_t i = 0; i < nbPoints; ++i)
+    {
+        pts2D[i] = project(pose, pts3D[i].homogeneous(), applyDistortion);
+    }
+}
+
+void IntrinsicBase::unprojectBatch(const Vec2* pts2D, Vec3* rays, std::size_t nbPoints, bool applyUndistortion) const
+{
+    for (std::size_t i = 0; i < nbPoints; ++i)
+    {
+        const Vec2 pt2D_cam = ima2cam(pts2D[i]);
+        rays[i] = toUnitSphere(applyUndistortion ? removeDistortion(pt2D_cam) : pt2D_cam);
+    }
+}
+
 Vec4 IntrinsicBase::getCartesianfromSphericalCoordinates(const Vec3& pt)
 {
     Vec4 rpt;
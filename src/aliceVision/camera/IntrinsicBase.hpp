@@ -106,6 +106,40 @@ class IntrinsicBase
      */
     virtual Vec2 project(const Eigen::Matrix4d& pose, const Vec4& pt3D, bool applyDistortion = true) const = 0;
 
+    /**
+     * @brief Projection of a batch of 3D points into the camera plane, same as project() for each point
+     * @param[in] pose The pose
+     * @param[in] pts3D The 3d points
+     * @param[out] pts2D The 2d projections in the camera plane
+     * @param[in] nbPoints The number of points
+     * @param[in] applyDistortion If true apply distrortion if any
+     */
+    void projectBatch(const geometry::Pose3& pose, const Vec3* pts3D, Vec2* pts2D, std::size_t nbPoints, bool applyDistortion = true) const
+    {
+        projectBatch(pose.getHomogeneous(), pts3D, pts2D, nbPoints, applyDistortion);
+    }
+
+    /**
+     * @brief Projection of a batch of 3D points into the camera plane, same as project() for each point
+     *        The camera models override it with a single virtual call for the whole batch.
+     * @param[in] pose The pose
+     * @param[in] pts3D The 3d points
+     * @param[out] pts2D The 2d projections in the camera plane
+     * @param[in] nbPoints The number of points
+     * @param[in] applyDistortion If true apply distrortion if any
+     */
+    virtual void projectBatch(const Eigen::Matrix4d& pose, const Vec3* pts3D, Vec2* pts2D, std::size_t nbPoints, bool applyDistortion = true) const;
+
+    /**
+     * @brief Back-projection of a batch of 2D points to bearing vectors in the camera frame,
+     *        same as toUnitSphere(removeDistortion(ima2cam(pt2D))) for each point
+     * @param[in] pts2D The 2d points
+     * @param[out] rays The bearing vectors in the camera frame
+     * @param[in] nbPoints The number of points
+     * @param[in] applyUndistortion If true remove distortion if any
+     */
+    virtual void unprojectBatch(const Vec2* pts2D, Vec3* rays, std::size_t nbPoints, bool applyUndistortion = true) const;
+
     /**
      * @brief Back-projection of a 2D point at a specific depth into a 3D point
      * @param[in] pt2D The 2d point
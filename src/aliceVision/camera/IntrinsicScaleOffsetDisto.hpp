@@ -103,6 +103,48 @@ class IntrinsicScaleOffsetDisto : public IntrinsicScaleOffset
         return p;
     }
 
+    /**
+     * @brief Add distortion to a batch of points in the camera plane, in place.
+     *        Same as addDistortion for each point, with a single virtual call to the distortion model.
+     * @param[in,out] pts Points in the camera plane.
+     * @param[in] nbPoints Number of points.
+     */
+    void addDistortionBatch(Vec2* pts, std::size_t nbPoints) const
+    {
+        if (_pDistortion)
+        {
+            _pDistortion->addDistortionBatch(pts, pts, nbPoints);
+        }
+        else if (_pUndistortion)
+        {
+            for (std::size_t i = 0; i < nbPoints; ++i)
+            {
+                pts[i] = IntrinsicScaleOffsetDisto::addDistortion(pts[i]);
+            }
+        }
+    }
+
+    /**
+     * @brief Remove distortion from a batch of points in the camera plane, in place.
+     *        Same as removeDistortion for each point, with a single virtual call to the distortion model.
+     * @param[in,out] pts Points in the camera plane.
+     * @param[in] nbPoints Number of points.
+     */
+    void removeDistortionBatch(Vec2* pts, std::size_t nbPoints) const
+    {
+        if (_pUndistortion)
+        {
+            for (std::size_t i = 0; i < nbPoints; ++i)
+            {
+                pts[i] = IntrinsicScaleOffsetDisto::removeDistortion(pts[i]);
+            }
+        }
+        else if (_pDistortion)
+        {
+            _pDistortion->removeDistortionBatch(pts, pts, nbPoints);
+        }
+    }
+
     /// Return the un-distorted pixel (with removed distortion)
     Vec2 get_ud_pixel(const Vec2& p) const override;
 
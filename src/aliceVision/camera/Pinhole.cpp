@@ -46,6 +46,46 @@ Vec2 Pinhole::project(const Eigen::Matrix4d& pose, const Vec4& pt, bool applyDis
     return impt;
 }
 
+void Pinhole::projectBatch(const Eigen::Matrix4d& pose, const Vec3* pts3D, Vec2* pts2D, std::size_t nbPoints, bool applyDistortion) const
+{
+    const Mat3 R = pose.block<3, 3>(0, 0);
+    const Vec3 t = pose.block<3, 1>(0, 3);
+
+    for (std::size_t i = 0; i < nbPoints; ++i)
+    {
+        const Vec3 X = R * pts3D[i] + t;  // apply pose
+        pts2D[i] = X.head<2>() / X(2);
+    }
+
+    // as in project(), the distortion is always applied
+    addDistortionBatch(pts2D, nbPoints);
+
+    const Vec2 pp = getPrincipalPoint();
+    for (std::size_t i = 0; i < nbPoints; ++i)
+    {
+        pts2D[i] = pts2D[i].cwiseProduct(_scale) + pp;
+    }
+}
+
+void Pinhole::unprojectBatch(const Vec2* pts2D, Vec3* rays, std::size_t nbPoints, bool applyUndistortion) const
+{
+    std::vector<Vec2> ptsCam(nbPoints);
+    for (std::size_t i = 0; i < nbPoints; ++i)
+    {
+        ptsCam[i] = Pinhole::ima2cam(pts2D[i]);
+    }
+
+    if (applyUndistortion)
+    {
+        removeDistortionBatch(ptsCam.data(), nbPoints);
+    }
+
+    for (std::size_t i = 0; i < nbPoints; ++i)
+    {
+        rays[i] = ptsCam[i].homogeneous().normalized();
+    }
+}
+
 Eigen::Matrix<double, 2, 9> Pinhole::getDerivativeProjectWrtRotation(const Eigen::Matrix4d& pose, const Vec4& pt)
 {
     const Vec4 X = pose * pt;  // apply pose
@@ -70,6 +70,15 @@ class Pinhole : public IntrinsicScaleOffsetDisto
 
     Vec2 project(const Eigen::Matrix4d& pose, const Vec4& pt, bool applyDistortion = true) const override;
 
+    void projectBatch(const Eigen::Matrix4d& pose, const Vec3* pts3D, Vec2* pts2D, std::size_t nbPoints, bool applyDistortion = true) const override;
+
+    void projectBatch(const geometry::Pose3& pose, const Vec3* pts3D, Vec2* pts2D, std::size_t nbPoints, bool applyDistortion = true) const
+    {
+        projectBatch(pose.getHomogeneous(), pts3D, pts2D, nbPoints, applyDistortion);
+    }
+
+    void unprojectBatch(const Vec2* pts2D, Vec3* rays, std::size_t nbPoints, bool applyUndistortion = true) const override;
+
     Eigen::Matrix<double, 2, 9> getDerivativeProjectWrtRotation(const Eigen::Matrix4d& pose, const Vec4& pt);
 
     Eigen::Matrix<double, 2, 16> getDerivativeProjectWrtPose(const Eigen::Matrix4d& pose, const Vec4& pt) const override;
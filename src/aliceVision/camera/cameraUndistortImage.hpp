@@ -12,6 +12,7 @@
 #include <aliceVision/image/Image.hpp>
 #include <aliceVision/image/Sampler.hpp>
 #include <aliceVision/camera/cameraCommon.hpp>
+#include <aliceVision/camera/DistortionGrid.hpp>
 #include <aliceVision/camera/IntrinsicBase.hpp>
 #include <aliceVision/camera/IntrinsicScaleOffsetDisto.hpp>
 #include <aliceVision/camera/Pinhole.hpp>
@@ -57,6 +58,15 @@ void UndistortImage(const image::Image<T>& imageIn,
     image_ud.resize(widthRoi, heightRoi, true, fillcolor);
     const image::Sampler2d<image::SamplerLinear> sampler;
 
+    // lookup grid of the distortion over the ROI, the undistortion inverse is iterative
+    const DistortionGrid distortionGrid(
+      [&](const Vec2& undisto_pix) {
+          return intrinsicSource->cam2ima(intrinsicSource->addDistortion(
+            intrinsicOutput->ima2cam((undistortionOutput) ? undistortionOutput->inverse(undisto_pix) : undisto_pix)));
+      },
+      Vec2(xOffset, yOffset),
+      Vec2(xOffset + widthRoi - 1, yOffset + heightRoi - 1));
+
 #pragma omp parallel for
     for (int y = 0; y < heightRoi; ++y)
     {
@@ -65,8 +75,7 @@ void UndistortImage(const image::Image<T>& imageIn,
             const Vec2 undisto_pix(x + xOffset, y + yOffset);
 
             // compute coordinates with distortion
-            const Vec2 disto_pix = intrinsicSource->cam2ima(intrinsicSource->addDistortion(
-              intrinsicOutput->ima2cam((undistortionOutput) ? undistortionOutput->inverse(undisto_pix) : undisto_pix)));
+            const Vec2 disto_pix = distortionGrid(undisto_pix);
 
             // pick pixel if it is in the image domain
             if (imageIn.Contains(disto_pix(1), disto_pix(0)))
@@ -120,6 +129,9 @@ void UndistortImage(const image::Image<T>& imageIn,
     image_ud.resize(widthRoi, heightRoi, true, fillcolor);
     const image::Sampler2d<image::SamplerLinear> sampler;
 
+    // lookup grid of the distortion, shared by the images of the same intrinsic
+    const std::shared_ptr<const DistortionGrid> distortionGrid = DistortionGrid::getShared(*intrinsicPtr, DistortionGrid::EDirection::DISTORT);
+
 #pragma omp parallel for
     for (int y = 0; y < heightRoi; ++y)
     {
@@ -127,7 +139,7 @@ void UndistortImage(const image::Image<T>& imageIn,
         {
             const Vec2 undisto_pix(x + xOffset, y + yOffset);
             // compute coordinates with distortion
-            const Vec2 disto_pix = intrinsicPtr->get_d_pixel(undisto_pix + ppCorrection);
+            const Vec2 disto_pix = (*distortionGrid)(undisto_pix + ppCorrection);
 
             // pick pixel if it is in the image domain
             if (imageIn.Contains(disto_pix(1), disto_pix(0)))
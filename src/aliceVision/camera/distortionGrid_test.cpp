@@ -0,0 +1,85 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <aliceVision/camera/DistortionFisheye.hpp>
+#include <aliceVision/camera/DistortionGrid.hpp>
+#include <aliceVision/camera/Pinhole.hpp>
+
+#define BOOST_TEST_MODULE distortionGrid
+
+#include <boost/test/unit_test.hpp>
+#include <boost/test/tools/floating_point_comparison.hpp>
+#include <aliceVision/unitTest.hpp>
+
+#include <limits>
+
+using namespace aliceVision;
+using namespace aliceVision::camera;
+
+//-----------------
+// Test summary:
+//-----------------
+// - Create a PinholeFisheye
+// - Build the shared distortion and undistortion grids
+// - Assert that the grids are close to the exact mappings on random points of the image domain
+// - Assert that the same grid is shared for the same intrinsic
+//-----------------
+BOOST_AUTO_TEST_CASE(distortionGrid_fisheye)
+{
+    makeRandomOperationsReproducible();
+
+    std::shared_ptr<Distortion> distortion = std::make_shared<DistortionFisheye>(-0.054, 0.014, 0.006, 0.011);
+    const Pinhole cam(1000, 800, 1000, 1000, 5, -3, distortion);
+
+    const double maxError = 0.01;
+    const std::shared_ptr<const DistortionGrid> distortGrid = DistortionGrid::getShared(cam, DistortionGrid::EDirection::DISTORT, maxError);
+    const std::shared_ptr<const DistortionGrid> undistortGrid = DistortionGrid::getShared(cam, DistortionGrid::EDirection::UNDISTORT, maxError);
+
+    BOOST_CHECK_LT(distortGrid->getExactCellsRatio(), 0.01);
+    BOOST_CHECK_LT(undistortGrid->getExactCellsRatio(), 0.01);
+
+    for (int i = 0; i < 10000; ++i)
+    {
+        const Vec2 pt = (Vec2::Random() + Vec2::Ones()).cwiseProduct(Vec2(500, 400));
+
+        EXPECT_MATRIX_NEAR(cam.get_d_pixel(pt), (*distortGrid)(pt), 2.0 * maxError);
+        EXPECT_MATRIX_NEAR(cam.get_ud_pixel(pt), (*undistortGrid)(pt), 2.0 * maxError);
+    }
+
+    // same intrinsic, same grid
+    const Pinhole camCopy(cam);
+    BOOST_CHECK(DistortionGrid::getShared(camCopy, DistortionGrid::EDirection::DISTORT, maxError) == distortGrid);
+}
+
+//-----------------
+// Test summary:
+//-----------------
+// - Build a grid of a mapping undefined on a part of the domain
+// - Assert that the undefined part and the points outside of the grid are evaluated exactly
+//-----------------
+BOOST_AUTO_TEST_CASE(distortionGrid_undefined)
+{
+    const DistortionGrid::Mapping mapping = [](const Vec2& p) {
+        if (p.x() < 100.0)
+        {
+            return Vec2(Vec2::Constant(std::numeric_limits<double>::quiet_NaN()));
+        }
+        return Vec2(std::sqrt(p.x()), p.y() * p.y() * 1e-3);
+    };
+
+    const DistortionGrid grid(mapping, Vec2(0, 0), Vec2(300, 200));
+
+    BOOST_CHECK(!grid(Vec2(50.0, 10.0)).allFinite());
+
+    for (const Vec2& pt : {Vec2(100.5, 10.0), Vec2(150.3, 199.7), Vec2(299.9, 0.1), Vec2(400.0, 300.0), Vec2(-10.0, 50.0)})
+    {
+        BOOST_CHECK(grid(pt).allFinite() == mapping(pt).allFinite());
+        if (mapping(pt).allFinite())
+        {
+            EXPECT_MATRIX_NEAR(mapping(pt), grid(pt), 0.02);
+        }
+    }
+}
@@ -0,0 +1,95 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <aliceVision/camera/Distortion3DE.hpp>
+#include <aliceVision/camera/DistortionBrown.hpp>
+#include <aliceVision/camera/DistortionFisheye.hpp>
+#include <aliceVision/camera/DistortionFisheye1.hpp>
+#include <aliceVision/camera/DistortionRadial.hpp>
+#include <aliceVision/camera/Equidistant.hpp>
+#include <aliceVision/camera/Pinhole.hpp>
+
+#define BOOST_TEST_MODULE projectBatch
+
+#include <boost/test/unit_test.hpp>
+#include <boost/test/tools/floating_point_comparison.hpp>
+#include <aliceVision/unitTest.hpp>
+
+using namespace aliceVision;
+using namespace aliceVision::camera;
+
+namespace {
+
+/**
+ * @brief Check that the batch projection and back-projection give the same results as the per point functions
+ */
+void checkBatch(const IntrinsicBase& cam, const geometry::Pose3& pose)
+{
+    const std::size_t nbPoints = 500;
+    const double epsilon = 1e-9;
+
+    // random points in front of the camera
+    std::vector<Vec3> pts3D(nbPoints);
+    for (Vec3& pt : pts3D)
+    {
+        pt = pose.inverse()(Vec3(0.5 * Vec2::Random().x(), 0.5 * Vec2::Random().y(), 1.0 + std::abs(Vec2::Random().x())));
+    }
+
+    std::vector<Vec2> pts2D(nbPoints);
+    for (bool applyDistortion : {true, false})
+    {
+        cam.projectBatch(pose, pts3D.data(), pts2D.data(), nbPoints, applyDistortion);
+        for (std::size_t i = 0; i < nbPoints; ++i)
+        {
+            EXPECT_MATRIX_NEAR(cam.project(pose, pts3D[i].homogeneous(), applyDistortion), pts2D[i], epsilon);
+        }
+    }
+
+    std::vector<Vec3> rays(nbPoints);
+    for (bool applyUndistortion : {true, false})
+    {
+        cam.unprojectBatch(pts2D.data(), rays.data(), nbPoints, applyUndistortion);
+        for (std::size_t i = 0; i < nbPoints; ++i)
+        {
+            const Vec2 ptCam = cam.ima2cam(pts2D[i]);
+            EXPECT_MATRIX_NEAR(cam.toUnitSphere(applyUndistortion ? cam.removeDistortion(ptCam) : ptCam), rays[i], epsilon);
+        }
+    }
+}
+
+}  // namespace
+
+//-----------------
+// Test summary:
+//-----------------
+// - Create Pinhole and Equidistant cameras with all the distortion models
+// - Assert that projectBatch and unprojectBatch match project and the per point back-projection
+//-----------------
+BOOST_AUTO_TEST_CASE(camera_projectBatch)
+{
+    makeRandomOperationsReproducible();
+
+    std::vector<std::shared_ptr<Distortion>> distortions;
+    distortions.push_back(nullptr);
+    distortions.push_back(std::make_shared<DistortionBrown>(-0.25349, 0.11868, -0.00028, 0.00005, 0.0000001));
+    distortions.push_back(std::make_shared<DistortionFisheye>(-0.054, 0.014, 0.006, 0.011));
+    distortions.push_back(std::make_shared<DistortionFisheye1>(0.02));
+    distortions.push_back(std::make_shared<DistortionRadialK1>(0.02));
+    distortions.push_back(std::make_shared<DistortionRadialK3>(-0.18, 0.18, -0.02));
+    distortions.push_back(std::make_shared<DistortionRadialK3PT>(-0.18, 0.18, -0.02));
+    distortions.push_back(std::make_shared<Distortion3DERadial4>(0.01, -0.02, 0.001, 0.002, 0.0, 0.0));
+
+    for (const std::shared_ptr<Distortion>& distortion : distortions)
+    {
+        const geometry::Pose3 pose(geometry::randomPose());
+
+        const Pinhole pinhole(1000, 800, 900, 950, 5, -3, distortion);
+        checkBatch(pinhole, pose);
+
+        const Equidistant equidistant(1000, 800, 800.0, 2.0, -1.0, 0.0, distortion);
+        checkBatch(equidistant, pose);
+    }
+}
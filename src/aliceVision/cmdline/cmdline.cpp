@@ -1,6 +1,8 @@
 #include "cmdline.hpp"
 
 #include <aliceVision/system/cpu.hpp>
+#include <aliceVision/system/MemoryBudget.hpp>
+#include <aliceVision/system/TaskScheduler.hpp>
 #include <aliceVision/alicevision_omp.hpp>
 
 namespace aliceVision {
@@ -60,6 +62,8 @@ bool CmdLine::execute(int argc, char** argv)
 
     _hContext.setUserMaxMemoryAvailable(uma);
     _hContext.setUserMaxCoresAvailable(uca);
+    system::TaskScheduler::get().setNbThreads(_hContext.getMaxThreads());
+    system::MemoryBudget::get().setCapacity(_hContext.getMaxMemory());
     _hContext.displayHardware();
 
     return true;
@@ -11,6 +11,7 @@
 #include <aliceVision/utils/Histogram.hpp>
 
 #include <string>
+#include <vector>
 
 namespace aliceVision {
 namespace colorHarmonization {
@@ -60,6 +61,32 @@ class CommonDataByPair
         }
     }
 
+    /**
+     * Compute the histograms of all the channels for the color's masked data, in a single pass over the image
+     *
+     * \param[in] mask Binary image to determine acceptable zones
+     * \param[in] image Image with RGB or LAB type
+     * \param[out] histos Histogram of each channel (0 = red; 1 = green; 2 = blue), already initialized.
+     *
+     */
+    template<typename ImageType>
+    static void computeHistos(std::vector<utils::Histogram<double>>& histos,
+                              const image::Image<unsigned char>& mask,
+                              const image::Image<ImageType>& image)
+    {
+        for (int j = 0; j < mask.Height(); ++j)
+        {
+            for (int i = 0; i < mask.Width(); ++i)
+            {
+                if ((int)mask(j, i) != 0)
+                {
+                    for (std::size_t channelIndex = 0; channelIndex < histos.size(); ++channelIndex)
+                        histos[channelIndex].Add(image(j, i)(channelIndex));
+                }
+            }
+        }
+    }
+
     const std::string& getLeftImage() const { return _sLeftImage; }
     const std::string& getRightImage() const { return _sRightImage; }
 
@@ -17,15 +17,20 @@ namespace colorHarmonization {
 class CommonDataByPair_vldSegment : public CommonDataByPair
 {
   public:
+    /**
+     * @param[in] scaleCache the pyramids of scale images shared by the pairs, the pyramids are built for this pair only if null
+     */
     CommonDataByPair_vldSegment(const std::string& sLeftImage,
                                 const std::string& sRightImage,
                                 const matching::IndMatches& matchesPerDesc,
                                 const std::vector<feature::PointFeature>& featsL,
-                                const std::vector<feature::PointFeature>& featsR)
+                                const std::vector<feature::PointFeature>& featsR,
+                                ImageScaleCache* scaleCache = nullptr)
       : CommonDataByPair(sLeftImage, sRightImage),
         _matches(matchesPerDesc),
         _featsL(featsL),
-        _featsR(featsR)
+        _featsR(featsR),
+        _scaleCache(scaleCache)
     {}
 
     virtual ~CommonDataByPair_vldSegment() {}
@@ -40,12 +45,22 @@ class CommonDataByPair_vldSegment : public CommonDataByPair
      */
     virtual bool computeMask(image::Image<unsigned char>& maskLeft, image::Image<unsigned char>& maskRight)
     {
-        image::Image<unsigned char> imageL, imageR;
-        image::readImage(_sLeftImage, imageL, image::EImageColorSpace::LINEAR);
-        image::readImage(_sRightImage, imageR, image::EImageColorSpace::LINEAR);
+        // the pyramids of scale images are built once and reused by the successive KVLD calls
+        std::shared_ptr<const ImageScale> scaleA, scaleB;
+        if (_scaleCache)
+        {
+            scaleA = _scaleCache->get(_sLeftImage);
+            scaleB = _scaleCache->get(_sRightImage);
+        }
+        else
+        {
+            image::Image<unsigned char> imageL, imageR;
+            image::readImage(_sLeftImage, imageL, image::EImageColorSpace::LINEAR);
+            image::readImage(_sRightImage, imageR, image::EImageColorSpace::LINEAR);
 
-        image::Image<float> imgA(imageL.GetMat().cast<float>());
-        image::Image<float> imgB(imageR.GetMat().cast<float>());
+            scaleA = std::make_shared<const ImageScale>(image::Image<float>(imageL.GetMat().cast<float>()));
+            scaleB = std::make_shared<const ImageScale>(image::Image<float>(imageR.GetMat().cast<float>()));
+        }
 
         std::vector<Pair> matchesFiltered, matchesPair;
 
@@ -68,7 +83,7 @@ class CommonDataByPair_vldSegment : public CommonDataByPair
         KvldParameters kvldparameters;  // initial parameters of KVLD
         // kvldparameters.K = 5;
         while (it_num < 5 &&
-               kvldparameters.inlierRate > KVLD(imgA, imgB, _featsL, _featsR, matchesPair, matchesFiltered, vec_score, E, valid, kvldparameters))
+               kvldparameters.inlierRate > KVLD(*scaleA, *scaleB, _featsL, _featsR, matchesPair, matchesFiltered, vec_score, E, valid, kvldparameters))
         {
             kvldparameters.inlierRate /= 2;
             ALICEVISION_LOG_DEBUG("low inlier rate, re-select matches with new rate=" << kvldparameters.inlierRate);
@@ -95,6 +110,8 @@ class CommonDataByPair_vldSegment : public CommonDataByPair
     const std::vector<feature::PointFeature>& _featsR;
     // Left and Right corresponding index (putatives matches)
     matching::IndMatches _matches;
+    // Pyramids of scale images shared by the pairs, may be null
+    ImageScaleCache* _scaleCache;
 };
 
 }  // namespace colorHarmonization
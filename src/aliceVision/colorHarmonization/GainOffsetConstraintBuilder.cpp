@@ -7,6 +7,8 @@
 
 #include "GainOffsetConstraintBuilder.hpp"
 
+#include <vector>
+
 namespace aliceVision {
 namespace lInfinity {
 
@@ -33,6 +35,10 @@ void Encode_histo_relation(const size_t nImage,
 
     A.resize(Nconstraint, NVar);
 
+    // Each constraint row has 5 non zero coefficients, the matrix is filled at once from them
+    std::vector<Eigen::Triplet<double>> coefficients;
+    coefficients.reserve(Nconstraint * 5);
+
     C.resize(Nconstraint, 1);
     C.fill(0.0);
     vec_sign.resize(Nconstraint);
@@ -68,10 +74,7 @@ void Encode_histo_relation(const size_t nImage,
 
     for (size_t i = 0; i < Nrelative; ++i)
     {
-        std::vector<relativeColorHistogramEdge>::const_iterator iter = vec_relativeHistograms.begin();
-        std::advance(iter, i);
-
-        const relativeColorHistogramEdge& edge = *iter;
+        const relativeColorHistogramEdge& edge = vec_relativeHistograms[i];
 
         //-- compute the two cumulated and normalized histogram
 
@@ -119,33 +122,35 @@ void Encode_histo_relation(const size_t nImage,
 
         for (size_t k = 0; k < vec_pourcentilePositionI.size(); ++k)
         {
-            A.coeffRef(rowPos, GVAR(edge.I)) = vec_pourcentilePositionI[k];
-            A.coeffRef(rowPos, OFFSETVAR(edge.I)) = 1.0;
+            coefficients.emplace_back(rowPos, GVAR(edge.I), vec_pourcentilePositionI[k]);
+            coefficients.emplace_back(rowPos, OFFSETVAR(edge.I), 1.0);
 
-            A.coeffRef(rowPos, GVAR(edge.J)) = -vec_pourcentilePositionJ[k];
-            A.coeffRef(rowPos, OFFSETVAR(edge.J)) = -1.0;
+            coefficients.emplace_back(rowPos, GVAR(edge.J), -vec_pourcentilePositionJ[k]);
+            coefficients.emplace_back(rowPos, OFFSETVAR(edge.J), -1.0);
 
             // - gamma (side change)
-            A.coeffRef(rowPos, GAMMAVAR) = -1;
+            coefficients.emplace_back(rowPos, GAMMAVAR, -1.0);
             // <= gamma
             vec_sign[rowPos] = linearProgramming::LPConstraints::LP_LESS_OR_EQUAL;
             C(rowPos) = 0;
             ++rowPos;
 
-            A.coeffRef(rowPos, GVAR(edge.I)) = vec_pourcentilePositionI[k];
-            A.coeffRef(rowPos, OFFSETVAR(edge.I)) = 1.0;
+            coefficients.emplace_back(rowPos, GVAR(edge.I), vec_pourcentilePositionI[k]);
+            coefficients.emplace_back(rowPos, OFFSETVAR(edge.I), 1.0);
 
-            A.coeffRef(rowPos, GVAR(edge.J)) = -vec_pourcentilePositionJ[k];
-            A.coeffRef(rowPos, OFFSETVAR(edge.J)) = -1.0;
+            coefficients.emplace_back(rowPos, GVAR(edge.J), -vec_pourcentilePositionJ[k]);
+            coefficients.emplace_back(rowPos, OFFSETVAR(edge.J), -1.0);
 
             // + gamma (side change)
-            A.coeffRef(rowPos, GAMMAVAR) = 1;
+            coefficients.emplace_back(rowPos, GAMMAVAR, 1.0);
             // >= - gamma
             vec_sign[rowPos] = linearProgramming::LPConstraints::LP_GREATER_OR_EQUAL;
             C(rowPos) = 0;
             ++rowPos;
         }
     }
+
+    A.setFromTriplets(coefficients.begin(), coefficients.end());
 #undef GVAR
 #undef OFFSETVAR
 #undef GAMMAVAR
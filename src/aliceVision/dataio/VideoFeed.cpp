@@ -8,6 +8,7 @@
 
 #include <aliceVision/system/Logger.hpp>
 #include <aliceVision/image/convertion.hpp>
+#include <aliceVision/image/convertionOpenCV.hpp>
 #include <aliceVision/image/io.hpp>
 
 #include <opencv2/core.hpp>
@@ -15,12 +16,62 @@
 #include <opencv2/core/eigen.hpp>
 #include <opencv2/videoio.hpp>
 
+#include <boost/algorithm/string/case_conv.hpp>
+
+#include <cstdlib>
 #include <iostream>
 #include <exception>
+#include <map>
+
+// the hardware accelerated decoding is available since OpenCV 4.5.2
+#if CV_VERSION_MAJOR > 4 || (CV_VERSION_MAJOR == 4 && (CV_VERSION_MINOR > 5 || (CV_VERSION_MINOR == 5 && CV_VERSION_REVISION >= 2)))
+    #define ALICEVISION_VIDEOFEED_HW_ACCELERATION
+#endif
 
 namespace aliceVision {
 namespace dataio {
 
+namespace {
+
+/**
+ * @brief Open a video with the hardware accelerated decoding set in the environment variable
+ *        ALICEVISION_VIDEO_HW_ACCELERATION (none, any, vaapi, d3d11 or mfx).
+ *        The decoding falls back to the software decoding if the acceleration is not available.
+ * @param[in,out] videoCapture the video capture to open
+ * @param[in] source the video file or the device id
+ * @return true if the video is opened
+ */
+template<typename SourceT>
+bool openVideoCapture(cv::VideoCapture& videoCapture, const SourceT& source)
+{
+#ifdef ALICEVISION_VIDEOFEED_HW_ACCELERATION
+    const char* envAcceleration = std::getenv("ALICEVISION_VIDEO_HW_ACCELERATION");
+    if (envAcceleration != nullptr)
+    {
+        static const std::map<std::string, int> accelerations = {{"none", cv::VIDEO_ACCELERATION_NONE},
+                                                                 {"any", cv::VIDEO_ACCELERATION_ANY},
+                                                                 {"vaapi", cv::VIDEO_ACCELERATION_VAAPI},
+                                                                 {"d3d11", cv::VIDEO_ACCELERATION_D3D11},
+                                                                 {"mfx", cv::VIDEO_ACCELERATION_MFX}};
+
+        const std::string acceleration = boost::to_lower_copy(std::string(envAcceleration));
+        const auto it = accelerations.find(acceleration);
+        if (it == accelerations.end())
+        {
+            ALICEVISION_LOG_WARNING("Unknown video hardware acceleration '" << acceleration << "', the software decoding is used.");
+        }
+        else if (videoCapture.open(source, cv::CAP_ANY, {cv::CAP_PROP_HW_ACCELERATION, it->second}))
+        {
+            ALICEVISION_LOG_DEBUG("Video hardware acceleration: " << videoCapture.get(cv::CAP_PROP_HW_ACCELERATION));
+            return true;
+        }
+    }
+#endif
+    return videoCapture.open(source);
+}
+
+}  // namespace
+
 class VideoFeed::FeederImpl
 {
   public:
@@ -62,7 +113,7 @@ VideoFeed::FeederImpl::FeederImpl(const std::string& videoPath, const std::strin
     _videoPath(videoPath)
 {
     // load the video
-    _videoCapture.open(videoPath);
+    openVideoCapture(_videoCapture, videoPath);
     if (!_videoCapture.isOpened())
     {
         ALICEVISION_LOG_WARNING("Unable to open the video : " << videoPath);
@@ -86,7 +137,7 @@ VideoFeed::FeederImpl::FeederImpl(int videoDevice, const std::string& calibPath)
     _videoPath(std::to_string(videoDevice))
 {
     // load the video
-    _videoCapture.open(videoDevice);
+    openVideoCapture(_videoCapture, videoDevice);
     if (!_videoCapture.isOpened())
     {
         ALICEVISION_LOG_WARNING("Unable to open the video : " << _videoPath);
@@ -118,21 +169,10 @@ bool VideoFeed::FeederImpl::readImage(image::Image<image::RGBColor>& imageRGB,
 
     if (frame.channels() == 3)
     {
-        cv::Mat color;
-        resize(frame, color, cv::Size(frame.cols, frame.rows));
-
+        // convert the frame directly into the output image pixels
+        imageRGB.resize(frame.cols, frame.rows, false);
+        cv::Mat color = image::imageViewToCvMat(image::ImageView<image::RGBColor>(imageRGB), CV_8UC3);
         cv::cvtColor(frame, color, cv::COLOR_BGR2RGB);
-        imageRGB.resize(color.cols, color.rows);
-
-        unsigned char* pixelPtr = (unsigned char*)color.data;
-        for (int i = 0; i < color.rows; i++)
-        {
-            for (int j = 0; j < color.cols; j++)
-            {
-                const size_t index = i * color.cols * 3 + j * 3;
-                imageRGB(i, j) = image::RGBColor(pixelPtr[index], pixelPtr[index + 1], pixelPtr[index + 2]);
-            }
-        }
     }
     else
     {
@@ -174,11 +214,10 @@ bool VideoFeed::FeederImpl::readImage(image::Image<unsigned char>& imageGray,
 
     if (frame.channels() == 3)
     {
-        // convert to gray
-        cv::Mat grey;
+        // convert to gray, directly into the output image pixels
+        imageGray.resize(frame.cols, frame.rows, false);
+        cv::Mat grey = image::imageViewToCvMat(image::ImageView<unsigned char>(imageGray), CV_8UC1);
         cv::cvtColor(frame, grey, cv::COLOR_BGR2GRAY);
-        imageGray.resize(grey.cols, grey.rows);
-        cv::cv2eigen(grey, imageGray);
         //      ALICEVISION_LOG_DEBUG(grey.channels() << " " << grey.rows << " " << grey.cols);
         //      ALICEVISION_LOG_DEBUG(imageGray.Depth() << " " << imageGray.Height() << " " << imageGray.Width());
     }
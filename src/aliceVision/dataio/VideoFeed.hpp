@@ -21,6 +21,8 @@ class VideoFeed : public IFeed
 
     /**
      * @brief Set up an image feed from a video
+     * The hardware accelerated decoding can be enabled with the environment variable
+     * ALICEVISION_VIDEO_HW_ACCELERATION (none, any, vaapi, d3d11 or mfx).
      *
      * @param[in] videoPath The video source.
      * @param[in] calibPath The source for the camera intrinsics.
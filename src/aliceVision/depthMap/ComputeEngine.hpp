@@ -0,0 +1,62 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2023 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+namespace aliceVision {
+namespace depthMap {
+
+/**
+ * @brief Depth map estimation compute engine.
+ */
+enum class EComputeEngine
+{
+    AUTO = 0,  //< CUDA if built with CUDA and a CUDA-enabled GPU is available, CPU otherwise
+    CUDA,      //< CUDA implementation, multi-GPUs
+    CPU        //< CPU implementation, multi-threaded
+};
+
+inline std::string EComputeEngine_enumToString(EComputeEngine computeEngine)
+{
+    switch (computeEngine)
+    {
+        case EComputeEngine::AUTO:
+            return "auto";
+        case EComputeEngine::CUDA:
+            return "cuda";
+        case EComputeEngine::CPU:
+            return "cpu";
+    }
+    throw std::out_of_range("Invalid compute engine enum");
+}
+
+inline EComputeEngine EComputeEngine_stringToEnum(const std::string& computeEngine)
+{
+    if (computeEngine == "auto")
+        return EComputeEngine::AUTO;
+    if (computeEngine == "cuda")
+        return EComputeEngine::CUDA;
+    if (computeEngine == "cpu")
+        return EComputeEngine::CPU;
+    throw std::out_of_range("Invalid compute engine: " + computeEngine);
+}
+
+inline std::ostream& operator<<(std::ostream& os, EComputeEngine e) { return os << EComputeEngine_enumToString(e); }
+
+inline std::istream& operator>>(std::istream& in, EComputeEngine& computeEngine)
+{
+    std::string token;
+    in >> token;
+    computeEngine = EComputeEngine_stringToEnum(token);
+    return in;
+}
+
+}  // namespace depthMap
+}  // namespace aliceVision
@@ -19,11 +19,19 @@
 #include <aliceVision/depthMap/cuda/host/utils.hpp>
 #include <aliceVision/depthMap/cuda/host/patchPattern.hpp>
 #include <aliceVision/depthMap/cuda/host/DeviceCache.hpp>
+#include <aliceVision/depthMap/cuda/host/DeviceImagePrefetcher.hpp>
+#include <aliceVision/depthMap/cuda/host/DeviceProfiler.hpp>
 #include <aliceVision/depthMap/cuda/host/DeviceStreamManager.hpp>
+#include <aliceVision/depthMap/cuda/host/MemoryPool.hpp>
 #include <aliceVision/depthMap/cuda/planeSweeping/deviceDepthSimilarityMap.hpp>
+#include <aliceVision/gpu/gpu.hpp>
 
 #include <boost/filesystem.hpp>
 
+#include <algorithm>
+#include <set>
+#include <utility>
+
 namespace fs = boost::filesystem;
 
 namespace aliceVision {
@@ -118,7 +126,17 @@ int DepthMapEstimator::getNbSimultaneousTiles() const
     {
         double availableMB, usedMB, totalMB;
         getDeviceMemoryInfo(availableMB, usedMB, totalMB);
-        deviceMemoryMB = availableMB * 0.8;  // available memory margin
+
+        // available memory margin, from the measured allocatable memory of the device if profiled
+        double memoryMargin = 0.8;
+        gpu::GpuProfile gpuProfile;
+        if (gpu::getCurrentGpuProfileCUDA(gpuProfile) && gpuProfile.allocatableMemoryRatio > 0.0)
+        {
+            // keep some memory for the allocations outside of the tiles computation
+            memoryMargin = std::clamp(gpuProfile.allocatableMemoryRatio - 0.05, 0.5, 0.95);
+            ALICEVISION_LOG_INFO("GPU profile of '" << gpuProfile.name << "': available memory margin " << memoryMargin);
+        }
+        deviceMemoryMB = availableMB * memoryMargin;
     }
 
     // number of full R camera computation that can be done simultaneously
@@ -226,6 +244,12 @@ void DepthMapEstimator::getTilesList(const std::vector<int>& cams, std::vector<T
 }
 
 void DepthMapEstimator::compute(int cudaDeviceId, const std::vector<int>& cams)
+{
+    CamerasQueue camsQueue(cams);
+    computeFromQueue(cudaDeviceId, camsQueue);
+}
+
+void DepthMapEstimator::computeFromQueue(int cudaDeviceId, CamerasQueue& camsQueue)
 {
     // set the device to use for GPU executions
     // the CUDA runtime API is thread-safe, it maintains per-thread state about the current device
@@ -235,13 +259,16 @@ void DepthMapEstimator::compute(int cudaDeviceId, const std::vector<int>& cams)
     // note: maybe move it as class member in order to share it across multiple GPUs
     mvsUtils::ImagesCache<image::Image<image::RGBAfColor>> ic(_mp, image::EImageColorSpace::LINEAR);
 
-    // build tile list order by R camera
-    std::vector<Tile> tiles;
-    getTilesList(cams, tiles);
+    const int nbTilesPerCamera = static_cast<int>(_tileRoiList.size());
 
     // get maximum number of simultaneous tiles
+    // it depends on the memory of the current device
     // for now, we use one CUDA stream per tile (SGM + Refine)
-    const int nbStreams = std::min(getNbSimultaneousTiles(), static_cast<int>(tiles.size()));
+    const int nbStreams = std::min(getNbSimultaneousTiles(), static_cast<int>(camsQueue.remaining()) * nbTilesPerCamera);
+
+    if (nbStreams < 1)
+        return;  // no camera left to compute
+
     DeviceStreamManager deviceStreamManager(nbStreams);
 
     // constants
@@ -254,8 +281,6 @@ void DepthMapEstimator::compute(int cudaDeviceId, const std::vector<int>& cams)
       (_depthMapParams.useRefine && !hasRcSameDownscale) ? (1 + _depthMapParams.maxTCams) : 0;  // number of Refine camera parameters per R camera
 
     // build device cache
-    const int nbTilesPerCamera = static_cast<int>(_tileRoiList.size());
-
     int nbRcPerBatch = divideRoundUp(nbStreams, nbTilesPerCamera);  // number of R cameras in the same batch
     if (nbRcPerBatch * (nbCameraParamsPerSgm + nbCameraParamsPerRefine) > ALICEVISION_DEVICE_MAX_CONSTANT_CAMERA_PARAM_SETS)
     {
@@ -267,7 +292,6 @@ void DepthMapEstimator::compute(int cudaDeviceId, const std::vector<int>& cams)
 
     const int nbCamerasParamsPerBatch =
       nbRcPerBatch * (nbCameraParamsPerSgm + nbCameraParamsPerRefine);                 // number of camera parameters in the same batch
-    const int nbTilesPerBatch = nbRcPerBatch * nbTilesPerCamera;                       // number of tiles in the same batch
     const int nbMipmapImagesPerBatch = nbRcPerBatch * (1 + _depthMapParams.maxTCams);  // number of camera mipmap image in the same batch
 
     DeviceCache& deviceCache = DeviceCache::getInstance();
@@ -323,32 +347,81 @@ void DepthMapEstimator::compute(int cudaDeviceId, const std::vector<int>& cams)
     // log device memory information
     logDeviceMemoryInfo();
 
-    // compute number of batches
-    const int nbBatches = divideRoundUp(static_cast<int>(tiles.size()), nbTilesPerBatch);
     const int minMipmapDownscale = std::min(_refineParams.scale, _sgmParams.scale);
     const int maxMipmapDownscale = std::max(_refineParams.scale, _sgmParams.scale) * std::pow(2, 6);  // we add 6 downscale levels
 
-    // compute each batch of R cameras
-    for (int b = 0; b < nbBatches; ++b)
+    // background loading of the next batch images in pinned host memory
+    // the prefetched images of a batch are limited by the host images cache budget
+    const double imageCostMB = (_mp.getMaxImageWidth() * _mp.getMaxImageHeight() * sizeof(CudaRGBA)) / (1024.0 * 1024.0);
+    const int nbMaxPrefetchedImages =
+      std::min(nbMipmapImagesPerBatch, static_cast<int>(_mp.userParams.get<int>("images_cache.maxmbCPU", 5000) / imageCostMB));
+    DeviceImagePrefetcher imagePrefetcher(_mp, cudaDeviceId, nbMaxPrefetchedImages, image::EImageColorSpace::LINEAR);
+
+    // add a mipmap image to the device cache, from the prefetched images if possible
+    const auto addMipmapImage = [&](int camId) {
+        if (const auto img_hmh = imagePrefetcher.get(camId))
+            deviceCache.addMipmapImage(camId, minMipmapDownscale, maxMipmapDownscale, *img_hmh, _mp);
+        else
+            deviceCache.addMipmapImage(camId, minMipmapDownscale, maxMipmapDownscale, ic, _mp);
+    };
+
+    // device throughput statistics
+    const system::Timer deviceTimer;
+    std::vector<int> computedCams;
+    int nbComputedTiles = 0;
+
+    // pop and compute each batch of R cameras
+    // the batch size depends on the memory of the current device
+    std::vector<int> batchCams;
+    std::vector<Tile> tiles;
+
+    camsQueue.pop(nbRcPerBatch, batchCams);
+    getTilesList(batchCams, tiles);
+
+    while (!batchCams.empty())
     {
-        // find first/last tile to compute
-        const int firstTileIndex = b * nbTilesPerBatch;
-        const int lastTileIndex = std::min((b + 1) * nbTilesPerBatch, static_cast<int>(tiles.size()));
+        const system::Timer batchTimer;
 
-        // load tile R and corresponding T cameras in device cache
-        for (int i = firstTileIndex; i < lastTileIndex; ++i)
+        // mipmap images used by the current batch then by the next one
+        // they are kept in device cache as long as possible, the next batch T cameras are not loaded again
         {
-            const Tile& tile = tiles.at(i);
+            std::vector<int> upcomingMipmapCams;
+            for (const Tile& tile : tiles)
+            {
+                upcomingMipmapCams.push_back(tile.rc);
+                upcomingMipmapCams.insert(upcomingMipmapCams.end(), tile.sgmTCams.begin(), tile.sgmTCams.end());
+                if (_depthMapParams.useRefine)
+                    upcomingMipmapCams.insert(upcomingMipmapCams.end(), tile.refineTCams.begin(), tile.refineTCams.end());
+            }
+
+            std::vector<int> upcomingBatchCams;
+            camsQueue.peek(nbRcPerBatch, upcomingBatchCams);
 
+            for (const int rc : upcomingBatchCams)
+            {
+                const StaticVector<int> tCams = getTCams(rc);
+                upcomingMipmapCams.push_back(rc);
+                upcomingMipmapCams.insert(upcomingMipmapCams.end(), tCams.begin(), tCams.end());
+            }
+
+            deviceCache.setUpcomingMipmapImages(upcomingMipmapCams);
+        }
+
+        // load tile R and corresponding T cameras in device cache
+        std::set<int> batchMipmapCams;
+        for (const Tile& tile : tiles)
+        {
             // add Sgm R camera to Device cache
-            deviceCache.addMipmapImage(tile.rc, minMipmapDownscale, maxMipmapDownscale, ic, _mp);
+            addMipmapImage(tile.rc);
             deviceCache.addCameraParams(tile.rc, _sgmParams.scale, _mp);
+            batchMipmapCams.insert(tile.rc);
 
             // add Sgm T cameras to Device cache
             for (const int tc : tile.sgmTCams)
             {
-                deviceCache.addMipmapImage(tc, minMipmapDownscale, maxMipmapDownscale, ic, _mp);
+                addMipmapImage(tc);
                 deviceCache.addCameraParams(tc, _sgmParams.scale, _mp);
+                batchMipmapCams.insert(tc);
             }
 
             if (_depthMapParams.useRefine)
@@ -359,8 +432,9 @@ void DepthMapEstimator::compute(int cudaDeviceId, const std::vector<int>& cams)
                 // add Refine T cameras to Device cache
                 for (const int tc : tile.refineTCams)
                 {
-                    deviceCache.addMipmapImage(tc, minMipmapDownscale, maxMipmapDownscale, ic, _mp);
+                    addMipmapImage(tc);
                     deviceCache.addCameraParams(tc, _refineParams.scale, _mp);
+                    batchMipmapCams.insert(tc);
                 }
             }
 
@@ -372,15 +446,54 @@ void DepthMapEstimator::compute(int cudaDeviceId, const std::vector<int>& cams)
             }
         }
 
+        // pop the next batch of R cameras and prefetch its images not already in the device cache
+        // while the current batch tiles are computed
+        std::vector<int> nextBatchCams;
+        std::vector<Tile> nextTiles;
+        if (camsQueue.pop(nbRcPerBatch, nextBatchCams))
+        {
+            getTilesList(nextBatchCams, nextTiles);
+
+            std::vector<int> camsToPrefetch;
+            std::set<int> camsToPrefetchSet;
+            const auto addCamToPrefetch = [&](int camId) {
+                if (batchMipmapCams.count(camId) == 0 && camsToPrefetchSet.insert(camId).second)
+                    camsToPrefetch.push_back(camId);
+            };
+
+            for (const Tile& tile : nextTiles)
+            {
+                addCamToPrefetch(tile.rc);
+                for (const int tc : tile.sgmTCams)
+                    addCamToPrefetch(tc);
+                if (_depthMapParams.useRefine)
+                    for (const int tc : tile.refineTCams)
+                        addCamToPrefetch(tc);
+            }
+
+            imagePrefetcher.prefetch(camsToPrefetch);
+        }
+        else
+        {
+            imagePrefetcher.clear();
+        }
+
         // wait for camera loading in device cache
         cudaDeviceSynchronize();
 
+        // intermediate results tiles are merged in memory and written in a single file per R camera
+        if (nbTilesPerCamera > 1)
+        {
+            for (const int c : batchCams)
+                mvsUtils::beginMapTilesMerging(c);
+        }
+
         // compute each batch tile
-        for (int i = firstTileIndex; i < lastTileIndex; ++i)
+        for (int i = 0; i < tiles.size(); ++i)
         {
             Tile& tile = tiles.at(i);
-            const int batchCamIndex = tile.rc % nbRcPerBatch;
-            const int streamIndex = tile.id % nbStreams;
+            const int batchCamIndex = i / nbTilesPerCamera;  // tiles are ordered by R camera
+            const int streamIndex = i % nbStreams;
 
             // do not compute empty ROI
             // some images in the dataset may be smaller than others
@@ -438,11 +551,13 @@ void DepthMapEstimator::compute(int cudaDeviceId, const std::vector<int>& cams)
                 refine.refineRc(tile, sgm.getDeviceDepthThicknessMap(), sgm.getDeviceNormalMap());
 
                 // copy Refine depth/similarity map from device to host
+                const DeviceStageRange stageRange(tile.rc, EDeviceStage::DOWNLOAD, deviceStreamManager.getStream(streamIndex));
                 tileDepthSimMap_hmh.copyFrom(refine.getDeviceDepthSimMap(), deviceStreamManager.getStream(streamIndex));
             }
             else
             {
                 // copy Sgm depth/similarity map from device to host
+                const DeviceStageRange stageRange(tile.rc, EDeviceStage::DOWNLOAD, deviceStreamManager.getStream(streamIndex));
                 tileDepthSimMap_hmh.copyFrom(sgm.getDeviceDepthSimMap(), deviceStreamManager.getStream(streamIndex));
             }
         }
@@ -450,62 +565,58 @@ void DepthMapEstimator::compute(int cudaDeviceId, const std::vector<int>& cams)
         // wait for tiles batch computation
         cudaDeviceSynchronize();
 
-        // find first and last tile R camera
-        const int firstRc = tiles.at(firstTileIndex).rc;
-        int lastRc = tiles.at(lastTileIndex - 1).rc;
-
-        // check if last tile depth map is finished
-        if (lastTileIndex < tiles.size() && (tiles.at(lastTileIndex).rc == lastRc))
-            --lastRc;
+        // accumulate the batch GPU stage timings
+        DeviceProfiler::getInstance().synchronize();
 
         // write depth/sim map result
-        for (int c = firstRc; c <= lastRc; ++c)
+        for (int batchCamIndex = 0; batchCamIndex < batchCams.size(); ++batchCamIndex)
         {
-            const int batchCamIndex = c % nbRcPerBatch;
+            const int c = batchCams.at(batchCamIndex);
 
-            if (_depthMapParams.useRefine)
-                writeDepthSimMapFromTileList(
-                  c, _mp, _tileParams, _tileRoiList, depthSimMapTilePerCam.at(batchCamIndex), _refineParams.scale, _refineParams.stepXY);
+            const int scale = (_depthMapParams.useRefine) ? _refineParams.scale : _sgmParams.scale;
+            const int stepXY = (_depthMapParams.useRefine) ? _refineParams.stepXY : _sgmParams.stepXY;
+
+            if (_depthSimMapsStore != nullptr)
+            {
+                // keep the depth/sim map in host memory for the filtering
+                image::Image<float> depthMap;
+                image::Image<float> simMap;
+                getDepthSimMapFromTileList(c, _mp, _tileParams, _tileRoiList, depthSimMapTilePerCam.at(batchCamIndex), scale, stepXY, depthMap, simMap);
+                _depthSimMapsStore->add(c, std::move(depthMap), std::move(simMap));
+            }
             else
-                writeDepthSimMapFromTileList(
-                  c, _mp, _tileParams, _tileRoiList, depthSimMapTilePerCam.at(batchCamIndex), _sgmParams.scale, _sgmParams.stepXY);
+            {
+                writeDepthSimMapFromTileList(c, _mp, _tileParams, _tileRoiList, depthSimMapTilePerCam.at(batchCamIndex), scale, stepXY);
+            }
+
+            if (nbTilesPerCamera > 1)
+                mvsUtils::endMapTilesMerging(c, _mp);
 
             if (_depthMapParams.exportTilePattern)
                 exportDepthSimMapTilePatternObj(c, _mp, _tileRoiList, depthMinMaxTilePerCam.at(batchCamIndex));
         }
-    }
 
-    // merge intermediate results tiles if needed and desired
-    if (tiles.size() > cams.size())
-    {
-        // merge tiles if needed and desired
-        for (int rc : cams)
-        {
-            if (_sgmParams.exportIntermediateDepthSimMaps)
-            {
-                mergeDepthSimMapTiles(rc, _mp, _sgmParams.scale, _sgmParams.stepXY, "sgm");
-            }
+        computedCams.insert(computedCams.end(), batchCams.begin(), batchCams.end());
+        nbComputedTiles += static_cast<int>(tiles.size());
 
-            if (_sgmParams.exportIntermediateNormalMaps)
-            {
-                mergeNormalMapTiles(rc, _mp, _sgmParams.scale, _sgmParams.stepXY, "sgm");
-            }
+        ALICEVISION_LOG_DEBUG("CUDA device " << cudaDeviceId << ": batch of " << batchCams.size() << " R camera(s) computed in "
+                                             << batchTimer.elapsed() << " s (" << camsQueue.remaining() << " camera(s) left in the queue).");
 
-            if (_depthMapParams.useRefine)
-            {
-                if (_refineParams.exportIntermediateDepthSimMaps)
-                {
-                    mergeDepthPixSizeMapTiles(rc, _mp, _refineParams.scale, _refineParams.stepXY, "sgmUpscaled");
-                    mergeDepthSimMapTiles(rc, _mp, _refineParams.scale, _refineParams.stepXY, "refinedFused");
-                }
+        // next batch
+        batchCams.swap(nextBatchCams);
+        tiles.swap(nextTiles);
+    }
 
-                if (_refineParams.exportIntermediateNormalMaps)
-                {
-                    mergeNormalMapTiles(rc, _mp, _refineParams.scale, _refineParams.stepXY, "refinedFused");
-                    mergeNormalMapTiles(rc, _mp, _refineParams.scale, _refineParams.stepXY);
-                }
-            }
-        }
+    imagePrefetcher.clear();
+
+    // log device throughput
+    {
+        const double elapsedSeconds = deviceTimer.elapsed();
+        ALICEVISION_LOG_INFO("CUDA device " << cudaDeviceId << " throughput:" << std::endl
+                                            << "\t- # computed R cameras: " << computedCams.size() << std::endl
+                                            << "\t- # computed tiles: " << nbComputedTiles << std::endl
+                                            << "\t- elapsed time: " << elapsedSeconds << " s" << std::endl
+                                            << "\t- tiles per second: " << ((elapsedSeconds > 0.0) ? nbComputedTiles / elapsedSeconds : 0.0));
     }
 
     // some objects countains CUDA objects
@@ -513,6 +624,12 @@ void DepthMapEstimator::compute(int cudaDeviceId, const std::vector<int>& cams)
     DeviceCache::getInstance().clear();
     sgmPerStream.clear();
     refinePerStream.clear();
+    depthSimMapTilePerCam.clear();
+
+    // log memory pool statistics and release the idle pinned host and device memory blocks
+    MemoryPool& memoryPool = MemoryPool::getInstance();
+    memoryPool.logStats();
+    memoryPool.release();
 }
 
 }  // namespace depthMap
@@ -11,6 +11,7 @@
 #include <aliceVision/depthMap/DepthMapParams.hpp>
 #include <aliceVision/depthMap/SgmParams.hpp>
 #include <aliceVision/depthMap/RefineParams.hpp>
+#include <aliceVision/depthMap/DepthSimMapsStore.hpp>
 #include <aliceVision/depthMap/computeOnMultiGPUs.hpp>
 #include <aliceVision/depthMap/Tile.hpp>
 
@@ -57,6 +58,27 @@ class DepthMapEstimator : public IGPUJob
      */
     void compute(int cudaDeviceId, const std::vector<int>& cams) override;
 
+    /**
+     * @brief Compute depth/similarity maps of the cameras popped from a queue shared with other devices.
+     * @note The number of cameras popped at once depends on the memory of the given device.
+     * @param[in] cudaDeviceId the CUDA device id
+     * @param[in,out] camsQueue the shared queue of cameras
+     */
+    void computeFromQueue(int cudaDeviceId, CamerasQueue& camsQueue) override;
+
+    /**
+     * @brief Keep the computed depth/similarity maps in the given store instead of writing them on disk.
+     * @param[in] depthSimMapsStore the depth/similarity maps store, nullptr to write the maps on disk
+     */
+    void setDepthSimMapsStore(DepthSimMapsStore* depthSimMapsStore) { _depthSimMapsStore = depthSimMapsStore; }
+
+    /**
+     * @brief Get the T cameras of the given R camera.
+     * @param[in] rc the R camera index
+     * @return the T camera indexes
+     */
+    StaticVector<int> getTCams(int rc) const { return _mp.findNearestCamsFromLandmarks(rc, _depthMapParams.maxTCams); }
+
   private:
     // private methods
 
@@ -82,6 +104,7 @@ class DepthMapEstimator : public IGPUJob
     const SgmParams& _sgmParams;              //< parameters of Sgm process
     const RefineParams& _refineParams;        //< parameters of Refine process
     std::vector<ROI> _tileRoiList;            //< depth maps region-of-interest list
+    DepthSimMapsStore* _depthSimMapsStore = nullptr;  //< store of the computed depth/similarity maps (optional)
 };
 
 }  // namespace depthMap
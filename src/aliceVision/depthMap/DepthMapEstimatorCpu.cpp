@@ -0,0 +1,451 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2023 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "DepthMapEstimatorCpu.hpp"
+
+#include <aliceVision/alicevision_omp.hpp>
+#include <aliceVision/system/Logger.hpp>
+#include <aliceVision/system/Timer.hpp>
+#include <aliceVision/numeric/numeric.hpp>
+#include <aliceVision/mvsUtils/ImagesCache.hpp>
+#include <aliceVision/mvsUtils/mapIO.hpp>
+#include <aliceVision/depthMap/cpu/CpuCameraParams.hpp>
+#include <aliceVision/depthMap/cpu/cpuDepthSimilarityMap.hpp>
+#include <aliceVision/depthMap/cpu/cpuSimilarityVolume.hpp>
+
+#include <algorithm>
+#include <map>
+#include <utility>
+
+namespace aliceVision {
+namespace depthMap {
+
+DepthMapEstimatorCpu::DepthMapEstimatorCpu(const mvsUtils::MultiViewParams& mp,
+                                           const mvsUtils::TileParams& tileParams,
+                                           const DepthMapParams& depthMapParams,
+                                           const SgmParams& sgmParams,
+                                           const RefineParams& refineParams)
+  : _mp(mp),
+    _tileParams(tileParams),
+    _depthMapParams(depthMapParams),
+    _sgmParams(sgmParams),
+    _refineParams(refineParams)
+{
+    // compute maximum downscale (scaleStep)
+    const int maxDownscale = std::max(_sgmParams.scale * _sgmParams.stepXY, _refineParams.scale * _refineParams.stepXY);
+
+    // compute tile ROI list
+    getTileRoiList(_tileParams, _mp.getMaxImageWidth(), _mp.getMaxImageHeight(), maxDownscale, _tileRoiList);
+
+    // log tiling information and ROI list
+    logTileRoiList(_tileParams, _mp.getMaxImageWidth(), _mp.getMaxImageHeight(), maxDownscale, _tileRoiList);
+
+    // log SGM downscale & stepXY
+    ALICEVISION_LOG_INFO("SGM parameters:" << std::endl << "\t- scale: " << _sgmParams.scale << std::endl << "\t- stepXY: " << _sgmParams.stepXY);
+
+    // log Refine downscale & stepXY
+    ALICEVISION_LOG_INFO("Refine parameters:" << std::endl
+                                              << "\t- scale: " << _refineParams.scale << std::endl
+                                              << "\t- stepXY: " << _refineParams.stepXY);
+
+    // log features of the CUDA engine not available on CPU
+    if (_sgmParams.useCustomPatchPattern || _refineParams.useCustomPatchPattern)
+        ALICEVISION_LOG_WARNING("CPU depth map engine: custom patch pattern is not supported, use full square patch.");
+
+    if (_sgmParams.useConsistentScale || _refineParams.useConsistentScale)
+        ALICEVISION_LOG_WARNING("CPU depth map engine: consistent scale is not supported, use image level scale.");
+
+    if (_refineParams.useColorOptimization && _refineParams.optimizationNbIterations > 0)
+        ALICEVISION_LOG_WARNING("CPU depth map engine: color optimization is not supported, skipped.");
+
+    if (_sgmParams.exportIntermediateDepthSimMaps || _sgmParams.exportIntermediateNormalMaps || _sgmParams.exportIntermediateVolumes ||
+        _sgmParams.exportIntermediateCrossVolumes || _sgmParams.exportIntermediateTopographicCutVolumes ||
+        _sgmParams.exportIntermediateVolume9pCsv || _depthMapParams.exportTilePattern)
+        ALICEVISION_LOG_WARNING("CPU depth map engine: intermediate results export is not supported, skipped.");
+
+    ALICEVISION_LOG_INFO("CPU depth map engine: " << omp_get_max_threads() << " thread(s).");
+}
+
+void DepthMapEstimatorCpu::getTilesList(int rc, std::vector<Tile>& tiles) const
+{
+    const int nbTilesPerCamera = _tileRoiList.size();
+
+    // tiles list should be empty
+    assert(tiles.empty());
+
+    // reserve memory
+    tiles.reserve(nbTilesPerCamera);
+
+    // get R camera Tcs list
+    const std::vector<int> tCams = _mp.findNearestCamsFromLandmarks(rc, _depthMapParams.maxTCams).getDataWritable();
+
+    // get R camera ROI
+    const ROI rcImageRoi(Range(0, _mp.getWidth(rc)), Range(0, _mp.getHeight(rc)));
+
+    for (int i = 0; i < nbTilesPerCamera; ++i)
+    {
+        Tile t;
+
+        t.id = i;
+        t.nbTiles = nbTilesPerCamera;
+        t.rc = rc;
+        t.roi = intersect(_tileRoiList.at(i), rcImageRoi);
+
+        if (t.roi.isEmpty())
+        {
+            // do nothing, this ROI cannot intersect the R camera ROI.
+        }
+        else if (_depthMapParams.chooseTCamsPerTile)
+        {
+            // find nearest T cameras per tile
+            t.sgmTCams = _mp.findTileNearestCams(rc, _sgmParams.maxTCamsPerTile, tCams, t.roi);
+
+            if (_depthMapParams.useRefine)
+                t.refineTCams = _mp.findTileNearestCams(rc, _refineParams.maxTCamsPerTile, tCams, t.roi);
+        }
+        else
+        {
+            // use previously selected T cameras from the entire image
+            t.sgmTCams = tCams;
+            t.refineTCams = tCams;
+        }
+
+        tiles.push_back(t);
+    }
+}
+
+void DepthMapEstimatorCpu::computeSgm(const Tile& tile,
+                                      const SgmDepthList& tileDepthList,
+                                      const LabImageGetter& getLabImage,
+                                      CpuMap<CpuFloat2>& out_depthThicknessMap,
+                                      CpuMap<CpuFloat2>* out_depthSimMap) const
+{
+    const IndexT viewId = _mp.getViewId(tile.rc);
+
+    ALICEVISION_LOG_INFO(tile << "SGM depth/thickness map of view id: " << viewId << ", rc: " << tile.rc << " (" << (tile.rc + 1) << " / "
+                              << _mp.ncams << ").");
+
+    // check SGM depth list and T cameras
+    if (tile.sgmTCams.empty() || tileDepthList.getDepths().empty())
+        ALICEVISION_THROW_ERROR(tile << "Cannot compute Semi-Global Matching, no depths or no T cameras (viewId: " << viewId << ").");
+
+    // downscale the region of interest
+    const ROI downscaledRoi = downscaleROI(tile.roi, _sgmParams.scale * _sgmParams.stepXY);
+
+    const std::vector<float>& depths = tileDepthList.getDepths();
+    const int roiWidth = int(downscaledRoi.width());
+    const int roiHeight = int(downscaledRoi.height());
+    const int nbDepths = int(depths.size());
+
+    // initialize the two similarity volumes at 255
+    CpuVolume<TSimCpu> volumeBestSim;
+    CpuVolume<TSimCpu> volumeSecBestSim;
+    volumeBestSim.resize(roiWidth, roiHeight, nbDepths);
+    volumeSecBestSim.resize(roiWidth, roiHeight, nbDepths);
+    volumeBestSim.fill(TSimCpu(255));
+    volumeSecBestSim.fill(TSimCpu(255));
+
+    // get R camera parameters and image
+    CpuCameraParams rcCamParams;
+    fillCpuCameraParams(rcCamParams, tile.rc, _sgmParams.scale, _mp);
+    const CpuLabImage& rcImage = getLabImage(tile.rc, _sgmParams.scale);
+
+    // compute similarity volume per Rc Tc
+    ALICEVISION_LOG_INFO(tile << "SGM Compute similarity volume.");
+
+    for (std::size_t tci = 0; tci < tile.sgmTCams.size(); ++tci)
+    {
+        const int tc = tile.sgmTCams.at(tci);
+
+        const int firstDepth = tileDepthList.getDepthsTcLimits()[tci].x;
+        const int lastDepth = firstDepth + tileDepthList.getDepthsTcLimits()[tci].y;
+        const Range tcDepthRange(firstDepth, lastDepth);
+
+        // get T camera parameters and image
+        CpuCameraParams tcCamParams;
+        fillCpuCameraParams(tcCamParams, tc, _sgmParams.scale, _mp);
+        const CpuLabImage& tcImage = getLabImage(tc, _sgmParams.scale);
+
+        ALICEVISION_LOG_DEBUG(tile << "Compute similarity volume:" << std::endl
+                                   << "\t- rc: " << tile.rc << std::endl
+                                   << "\t- tc: " << tc << " (" << (tci + 1) << "/" << tile.sgmTCams.size() << ")" << std::endl
+                                   << "\t- tc first depth: " << firstDepth << std::endl
+                                   << "\t- tc last depth: " << lastDepth << std::endl
+                                   << "\t- tile range x: [" << downscaledRoi.x.begin << " - " << downscaledRoi.x.end << "]" << std::endl
+                                   << "\t- tile range y: [" << downscaledRoi.y.begin << " - " << downscaledRoi.y.end << "]" << std::endl);
+
+        cpu_volumeComputeSimilarity(
+          volumeBestSim, volumeSecBestSim, depths, rcCamParams, tcCamParams, rcImage, tcImage, _sgmParams, tcDepthRange, downscaledRoi);
+    }
+
+    // update second best uninitialized similarity volume values with first best similarity volume values
+    if (_sgmParams.updateUninitializedSim)  // should always be true, false for debug purposes
+        cpu_volumeUpdateUninitializedSimilarity(volumeBestSim, volumeSecBestSim);
+
+    // optimize similarity volume
+    if (_sgmParams.doSgmOptimizeVolume)
+    {
+        ALICEVISION_LOG_INFO(tile << "SGM Optimizing volume (filtering axes: " << _sgmParams.filteringAxes << ").");
+
+        // reuse best sim to put optimized similarity
+        cpu_volumeOptimize(volumeBestSim, volumeSecBestSim, rcImage, _sgmParams, nbDepths, downscaledRoi);
+    }
+    else
+    {
+        std::swap(volumeBestSim, volumeSecBestSim);
+    }
+
+    // retrieve best depth
+    ALICEVISION_LOG_INFO(tile << "SGM Retrieve best depth in volume.");
+
+    // R camera parameters at scale 1 are required for SGM retrieve best depth
+    CpuCameraParams rcCamParamsScale1;
+    fillCpuCameraParams(rcCamParamsScale1, tile.rc, 1, _mp);
+
+    out_depthThicknessMap.resize(roiWidth, roiHeight);
+
+    if (out_depthSimMap != nullptr)
+        out_depthSimMap->resize(roiWidth, roiHeight);
+
+    cpu_volumeRetrieveBestDepth(
+      out_depthThicknessMap, out_depthSimMap, depths, volumeBestSim, rcCamParamsScale1, _sgmParams, Range(0, nbDepths), downscaledRoi);
+
+    ALICEVISION_LOG_INFO(tile << "SGM depth/thickness map done.");
+}
+
+void DepthMapEstimatorCpu::computeRefine(const Tile& tile,
+                                         const CpuMap<CpuFloat2>& in_sgmDepthThicknessMap,
+                                         const LabImageGetter& getLabImage,
+                                         CpuMap<CpuFloat2>& out_depthSimMap) const
+{
+    const IndexT viewId = _mp.getViewId(tile.rc);
+
+    ALICEVISION_LOG_INFO(tile << "Refine depth/sim map of view id: " << viewId << ", rc: " << tile.rc << " (" << (tile.rc + 1) << " / " << _mp.ncams
+                              << ").");
+
+    // downscale the region of interest
+    const ROI downscaledRoi = downscaleROI(tile.roi, _refineParams.scale * _refineParams.stepXY);
+
+    const int roiWidth = int(downscaledRoi.width());
+    const int roiHeight = int(downscaledRoi.height());
+
+    // get R camera parameters and image
+    CpuCameraParams rcCamParams;
+    fillCpuCameraParams(rcCamParams, tile.rc, _refineParams.scale, _mp);
+    const CpuLabImage& rcImage = getLabImage(tile.rc, _refineParams.scale);
+
+    // compute upscaled SGM depth/pixSize map
+    // - upscale SGM depth/thickness map
+    // - filter masked pixels (alpha)
+    // - compute pixSize from SGM thickness
+    CpuMap<CpuFloat2> sgmDepthPixSizeMap(roiWidth, roiHeight);
+    cpu_computeSgmUpscaledDepthPixSizeMap(sgmDepthPixSizeMap, in_sgmDepthThicknessMap, rcImage, _refineParams, downscaledRoi);
+
+    out_depthSimMap.resize(roiWidth, roiHeight);
+
+    if (!_refineParams.useRefineFuse)
+    {
+        ALICEVISION_LOG_INFO(tile << "Refine and fuse depth/sim map volume disabled.");
+
+        for (int y = 0; y < roiHeight; ++y)
+            for (int x = 0; x < roiWidth; ++x)
+                out_depthSimMap(x, y) = {sgmDepthPixSizeMap(x, y).x, 1.0f};
+        return;
+    }
+
+    ALICEVISION_LOG_INFO(tile << "Refine and fuse depth/sim map volume.");
+
+    // initialize the similarity volume at 0
+    // each tc filtered and inverted similarity value will be summed in this volume
+    const int nbDepths = 2 * _refineParams.halfNbDepths + 1;
+    CpuVolume<TSimRefineCpu> volumeRefineSim;
+    volumeRefineSim.resize(roiWidth, roiHeight, nbDepths);
+    volumeRefineSim.fill(TSimRefineCpu(0.f));
+
+    // compute for each RcTc each similarity value for each depth to refine
+    // sum the inverted / filtered similarity value, best value is the HIGHEST
+    for (std::size_t tci = 0; tci < tile.refineTCams.size(); ++tci)
+    {
+        const int tc = tile.refineTCams.at(tci);
+
+        // get T camera parameters and image
+        CpuCameraParams tcCamParams;
+        fillCpuCameraParams(tcCamParams, tc, _refineParams.scale, _mp);
+        const CpuLabImage& tcImage = getLabImage(tc, _refineParams.scale);
+
+        ALICEVISION_LOG_DEBUG(tile << "Refine similarity volume:" << std::endl
+                                   << "\t- rc: " << tile.rc << std::endl
+                                   << "\t- tc: " << tc << " (" << (tci + 1) << "/" << tile.refineTCams.size() << ")" << std::endl
+                                   << "\t- tile range x: [" << downscaledRoi.x.begin << " - " << downscaledRoi.x.end << "]" << std::endl
+                                   << "\t- tile range y: [" << downscaledRoi.y.begin << " - " << downscaledRoi.y.end << "]" << std::endl);
+
+        cpu_volumeRefineSimilarity(
+          volumeRefineSim, sgmDepthPixSizeMap, rcCamParams, tcCamParams, rcImage, tcImage, _refineParams, Range(0, nbDepths), downscaledRoi);
+    }
+
+    // retrieve the best depth/sim in the volume
+    // compute sub-pixel sample using a sliding gaussian
+    cpu_volumeRefineBestDepth(out_depthSimMap, sgmDepthPixSizeMap, volumeRefineSim, _refineParams, downscaledRoi);
+
+    ALICEVISION_LOG_INFO(tile << "Refine depth/sim map done.");
+}
+
+void DepthMapEstimatorCpu::compute(const std::vector<int>& cams)
+{
+    // initialize RAM image cache
+    mvsUtils::ImagesCache<image::Image<image::RGBAfColor>> ic(_mp, image::EImageColorSpace::LINEAR);
+
+    // final depth/similarity map scale and step
+    const int scale = (_depthMapParams.useRefine) ? _refineParams.scale : _sgmParams.scale;
+    const int step = (_depthMapParams.useRefine) ? _refineParams.stepXY : _sgmParams.stepXY;
+    const int scaleStep = scale * step;
+
+    const system::Timer timer;
+    int nbComputedTiles = 0;
+
+    for (const int rc : cams)
+    {
+        // CIELAB images of the R camera and its T cameras, per downscale
+        // built on demand and released after the R camera computation
+        std::map<std::pair<int, int>, CpuLabImage> labImages;
+
+        const LabImageGetter getLabImage = [&](int camId, int downscale) -> const CpuLabImage& {
+            const auto key = std::make_pair(camId, downscale);
+            auto it = labImages.find(key);
+
+            if (it == labImages.end())
+            {
+                const auto img = ic.getImg_sync(camId);
+                it = labImages.emplace(key, CpuLabImage()).first;
+                it->second.build(*img, downscale);
+            }
+            return it->second;
+        };
+
+        // allocate full-size depth/similarity maps
+        // maps should be initialize, additive process
+        const int width = divideRoundUp(_mp.getWidth(rc), scaleStep);
+        const int height = divideRoundUp(_mp.getHeight(rc), scaleStep);
+
+        image::Image<float> depthMap(width, height, true, 0.0f);
+        image::Image<float> simMap(width, height, true, 0.0f);
+
+        std::vector<Tile> tiles;
+        getTilesList(rc, tiles);
+
+        // read the R camera and T cameras images ahead of the tiles computation
+        {
+            std::vector<int> camIds = {rc};
+            for (const Tile& tile : tiles)
+            {
+                for (const std::vector<int>* tCams : {&tile.sgmTCams, &tile.refineTCams})
+                {
+                    for (int tc : *tCams)
+                    {
+                        if (std::find(camIds.begin(), camIds.end(), tc) == camIds.end())
+                            camIds.push_back(tc);
+                    }
+                }
+            }
+            ic.prefetch(camIds);
+        }
+
+        for (Tile& tile : tiles)
+        {
+            // do not compute empty ROI
+            // some images in the dataset may be smaller than others
+            if (tile.roi.isEmpty())
+                continue;
+
+            const ROI downscaledRoi = downscaleROI(tile.roi, scaleStep);
+
+            // tile result depth/similarity map, invalid by default
+            CpuMap<CpuFloat2> tileDepthSimMap(int(downscaledRoi.width()), int(downscaledRoi.height()));
+            tileDepthSimMap.fill({-1.f, 1.f});
+
+            // check T cameras
+            if (!tile.sgmTCams.empty() && !(_depthMapParams.useRefine && tile.refineTCams.empty()))
+            {
+                // build tile SGM depth list
+                SgmDepthList sgmDepthList(_mp, _sgmParams, tile);
+
+                // compute the R camera depth list
+                sgmDepthList.computeListRc();
+
+                // check number of depths
+                if (!sgmDepthList.getDepths().empty())
+                {
+                    // remove T cameras with no depth found.
+                    sgmDepthList.removeTcWithNoDepth(tile);
+
+                    // log debug camera / depth information
+                    sgmDepthList.logRcTcDepthInformation();
+
+                    // check if starting and stopping depth are valid
+                    sgmDepthList.checkStartingAndStoppingDepth();
+
+                    // compute Semi-Global Matching
+                    CpuMap<CpuFloat2> sgmDepthThicknessMap;
+
+                    if (_depthMapParams.useRefine)
+                    {
+                        computeSgm(tile, sgmDepthList, getLabImage, sgmDepthThicknessMap, nullptr);
+
+                        // smooth SGM thickness map
+                        // in order to be a proper Refine input parameter
+                        ALICEVISION_LOG_INFO(tile << "SGM Smooth thickness map.");
+                        cpu_depthThicknessSmoothThickness(
+                          sgmDepthThicknessMap, _sgmParams, _refineParams, downscaleROI(tile.roi, _sgmParams.scale * _sgmParams.stepXY));
+
+                        // compute Refine
+                        computeRefine(tile, sgmDepthThicknessMap, getLabImage, tileDepthSimMap);
+                    }
+                    else
+                    {
+                        computeSgm(tile, sgmDepthList, getLabImage, sgmDepthThicknessMap, &tileDepthSimMap);
+                    }
+                }
+            }
+
+            // copy tile depth/sim map
+            image::Image<float> tileDepthMap(tileDepthSimMap.width(), tileDepthSimMap.height());
+            image::Image<float> tileSimMap(tileDepthSimMap.width(), tileDepthSimMap.height());
+
+            for (int y = 0; y < tileDepthSimMap.height(); ++y)
+            {
+                for (int x = 0; x < tileDepthSimMap.width(); ++x)
+                {
+                    tileDepthMap(y, x) = tileDepthSimMap(x, y).x;
+                    tileSimMap(y, x) = tileDepthSimMap(x, y).y;
+                }
+            }
+
+            // add tile maps to the full-size maps with weighting
+            mvsUtils::addTileMapWeighted(rc, _mp, _tileParams, tile.roi, scaleStep, tileDepthMap, depthMap);
+            mvsUtils::addTileMapWeighted(rc, _mp, _tileParams, tile.roi, scaleStep, tileSimMap, simMap);
+
+            ++nbComputedTiles;
+        }
+
+        // write fullsize maps on disk
+        mvsUtils::writeMap(rc, _mp, mvsUtils::EFileType::depthMap, depthMap, scale, step);
+        mvsUtils::writeMap(rc, _mp, mvsUtils::EFileType::simMap, simMap, scale, step);
+    }
+
+    // log throughput
+    {
+        const double elapsedSeconds = timer.elapsed();
+        ALICEVISION_LOG_INFO("CPU depth map engine throughput:" << std::endl
+                                                               << "\t- # computed R cameras: " << cams.size() << std::endl
+                                                               << "\t- # computed tiles: " << nbComputedTiles << std::endl
+                                                               << "\t- elapsed time: " << elapsedSeconds << " s" << std::endl
+                                                               << "\t- tiles per second: "
+                                                               << ((elapsedSeconds > 0.0) ? nbComputedTiles / elapsedSeconds : 0.0));
+    }
+}
+
+}  // namespace depthMap
+}  // namespace aliceVision
@@ -0,0 +1,113 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2023 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <aliceVision/mvsUtils/MultiViewParams.hpp>
+#include <aliceVision/mvsUtils/TileParams.hpp>
+#include <aliceVision/depthMap/DepthMapParams.hpp>
+#include <aliceVision/depthMap/SgmParams.hpp>
+#include <aliceVision/depthMap/RefineParams.hpp>
+#include <aliceVision/depthMap/SgmDepthList.hpp>
+#include <aliceVision/depthMap/Tile.hpp>
+#include <aliceVision/depthMap/cpu/CpuBuffer.hpp>
+#include <aliceVision/depthMap/cpu/CpuLabImage.hpp>
+
+#include <functional>
+#include <vector>
+
+namespace aliceVision {
+namespace depthMap {
+
+/**
+ * @class Depth Map Estimator CPU
+ * @brief Wrap depth maps estimation computation on CPU.
+ * @note Same SGM + Refine workflow as the DepthMapEstimator, without any CUDA dependency.
+ *       Each tile computation is multi-threaded with OpenMP.
+ */
+class DepthMapEstimatorCpu
+{
+  public:
+    /**
+     * @brief Depth Map Estimator CPU constructor.
+     * @param[in] mp the multi-view parameters
+     * @param[in] tileParams tile workflow parameters
+     * @param[in] depthMapParams the depth map estimation parameters
+     * @param[in] sgmParams the Semi Global Matching parameters
+     * @param[in] refineParams the Refine parameters
+     */
+    DepthMapEstimatorCpu(const mvsUtils::MultiViewParams& mp,
+                         const mvsUtils::TileParams& tileParams,
+                         const DepthMapParams& depthMapParams,
+                         const SgmParams& sgmParams,
+                         const RefineParams& refineParams);
+
+    // no copy constructor
+    DepthMapEstimatorCpu(DepthMapEstimatorCpu const&) = delete;
+
+    // no copy operator
+    void operator=(DepthMapEstimatorCpu const&) = delete;
+
+    // destructor
+    ~DepthMapEstimatorCpu() = default;
+
+    /**
+     * @brief Compute depth/similarity maps of the given cameras.
+     * @param[in] cams the list of cameras
+     */
+    void compute(const std::vector<int>& cams);
+
+  private:
+    /// get the CIELAB image of the given camera at the given downscale
+    using LabImageGetter = std::function<const CpuLabImage&(int camId, int downscale)>;
+
+    // private methods
+
+    /**
+     * @brief Build tile list from the given R camera.
+     * @param[in] rc the R camera index
+     * @param[in,out] tiles the output tiles list
+     */
+    void getTilesList(int rc, std::vector<Tile>& tiles) const;
+
+    /**
+     * @brief Compute the Semi-Global Matching depth/thickness map of the given tile.
+     * @param[in] tile the given tile
+     * @param[in] tileDepthList the tile SGM depth list
+     * @param[in] getLabImage the CIELAB image getter
+     * @param[out] out_depthThicknessMap the output SGM depth/thickness map
+     * @param[out] out_depthSimMap the output SGM depth/similarity map or nullptr
+     */
+    void computeSgm(const Tile& tile,
+                    const SgmDepthList& tileDepthList,
+                    const LabImageGetter& getLabImage,
+                    CpuMap<CpuFloat2>& out_depthThicknessMap,
+                    CpuMap<CpuFloat2>* out_depthSimMap) const;
+
+    /**
+     * @brief Refine the SGM depth/thickness map of the given tile.
+     * @param[in] tile the given tile
+     * @param[in] in_sgmDepthThicknessMap the input SGM depth/thickness map
+     * @param[in] getLabImage the CIELAB image getter
+     * @param[out] out_depthSimMap the output refined depth/similarity map
+     */
+    void computeRefine(const Tile& tile,
+                       const CpuMap<CpuFloat2>& in_sgmDepthThicknessMap,
+                       const LabImageGetter& getLabImage,
+                       CpuMap<CpuFloat2>& out_depthSimMap) const;
+
+    // private members
+
+    const mvsUtils::MultiViewParams& _mp;     //< multi-view parameters
+    const mvsUtils::TileParams& _tileParams;  //< tiling parameters
+    const DepthMapParams& _depthMapParams;    //< depth map estimation parameters
+    const SgmParams& _sgmParams;              //< parameters of Sgm process
+    const RefineParams& _refineParams;        //< parameters of Refine process
+    std::vector<ROI> _tileRoiList;            //< depth maps region-of-interest list
+};
+
+}  // namespace depthMap
+}  // namespace aliceVision
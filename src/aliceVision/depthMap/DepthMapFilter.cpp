@@ -0,0 +1,368 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "DepthMapFilter.hpp"
+
+#include <aliceVision/system/Logger.hpp>
+#include <aliceVision/system/Timer.hpp>
+#include <aliceVision/numeric/numeric.hpp>
+#include <aliceVision/image/io.hpp>
+#include <aliceVision/mvsUtils/fileIO.hpp>
+#include <aliceVision/mvsUtils/mapIO.hpp>
+#include <aliceVision/depthMap/depthMapUtils.hpp>
+#include <aliceVision/depthMap/cuda/host/utils.hpp>
+#include <aliceVision/depthMap/cuda/host/memory.hpp>
+#include <aliceVision/depthMap/cuda/host/DeviceCache.hpp>
+#include <aliceVision/depthMap/cuda/host/MemoryPool.hpp>
+#include <aliceVision/depthMap/cuda/planeSweeping/deviceDepthSimilarityMap.hpp>
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <set>
+#include <sstream>
+
+namespace aliceVision {
+namespace depthMap {
+
+namespace {
+
+/**
+ * @brief Depth map of a T camera kept in device memory between R cameras
+ */
+struct ResidentDepthMap
+{
+    std::unique_ptr<CudaDeviceMemoryPitched<float, 2>> depthMap_dmp;
+    std::unique_ptr<CudaTexture<float, false, false>> depthMapTex;  // neighbor interpolation, without normalized coordinates
+};
+
+}  // namespace
+
+DepthMapFilter::DepthMapFilter(const mvsUtils::MultiViewParams& mp, const DepthMapFilterParams& filterParams)
+  : _mp(mp),
+    _filterParams(filterParams)
+{}
+
+void DepthMapFilter::setDepthSimMapsStore(DepthSimMapsStore* depthSimMapsStore, int scale, int step)
+{
+    _depthSimMapsStore = depthSimMapsStore;
+    _scale = scale;
+    _step = step;
+}
+
+int DepthMapFilter::getNbTCamsMax() const
+{
+    // the R camera and all its T cameras parameters are in device constant memory at the same time
+    return std::min(_filterParams.nNearestCams, ALICEVISION_DEVICE_MAX_CONSTANT_CAMERA_PARAM_SETS - 1);
+}
+
+StaticVector<int> DepthMapFilter::getTCams(int rc) const { return _mp.findNearestCamsFromLandmarks(rc, getNbTCamsMax()); }
+
+void DepthMapFilter::compute(int cudaDeviceId, const std::vector<int>& cams)
+{
+    // set the device to use for GPU executions
+    // the CUDA runtime API is thread-safe, it maintains per-thread state about the current device
+    setCudaDeviceId(cudaDeviceId);
+
+    const int nbTCamsMax = getNbTCamsMax();
+
+    if (nbTCamsMax < _filterParams.nNearestCams)
+        ALICEVISION_LOG_WARNING("Depth map filtering on GPU is limited to " << nbTCamsMax << " nearest cameras.");
+
+    // input depth maps downscale factor, relative to the multi-view parameters
+    const int scaleStep = _scale * _step;
+
+    // nearby R cameras share most of their T cameras, the T depth maps are kept in device memory between R cameras
+    const std::size_t maxResidentDepthMaps = std::size_t(2 * nbTCamsMax);
+
+    DeviceCache& deviceCache = DeviceCache::getInstance();
+    deviceCache.build(0, nbTCamsMax + 1);  // 0 mipmap image, R camera and T cameras parameters
+
+    std::map<int, ResidentDepthMap> residentDepthMaps;
+
+    for (const int rc : cams)
+    {
+        const system::Timer timer;
+
+        ALICEVISION_LOG_INFO("Filter depth map (rc: " << rc << ")");
+
+        image::Image<float> depthMap;
+        image::Image<float> simMap;
+
+        if (_depthSimMapsStore != nullptr)
+        {
+            // get depth/sim maps from host memory
+            const std::shared_ptr<const DepthSimMap> depthSimMap = _depthSimMapsStore->get(rc);
+
+            if (depthSimMap == nullptr)
+                throw std::runtime_error("DepthMapFilter: no depth map in memory for camera: " + std::to_string(_mp.getViewId(rc)));
+
+            depthMap = depthSimMap->depthMap;
+            simMap = depthSimMap->simMap;
+        }
+        else
+        {
+            // read depth/sim maps from depthMapEstimation folder
+            mvsUtils::readMap(rc, _mp, mvsUtils::EFileType::depthMap, depthMap);
+            mvsUtils::readMap(rc, _mp, mvsUtils::EFileType::simMap, simMap);
+        }
+
+        const int width = divideRoundUp(_mp.getWidth(rc), scaleStep);
+        const int height = divideRoundUp(_mp.getHeight(rc), scaleStep);
+
+        if ((depthMap.size() != width * height) || (simMap.size() != width * height))
+        {
+            std::stringstream s;
+            s << "DepthMapFilter: bad image dimension for camera: " << _mp.getViewId(rc) << "\n";
+            s << "depthMap size: " << depthMap.size() << ", simMap size: " << simMap.size() << ", width: " << width << ", height: " << height;
+            throw std::runtime_error(s.str());
+        }
+
+        const StaticVector<int> tcams = getTCams(rc);
+
+        // release the resident depth maps not used by this R camera if there are too many
+        if (residentDepthMaps.size() + tcams.size() > maxResidentDepthMaps)
+        {
+            for (auto it = residentDepthMaps.begin(); it != residentDepthMaps.end();)
+            {
+                if (tcams.indexOf(it->first) < 0)
+                    it = residentDepthMaps.erase(it);
+                else
+                    ++it;
+            }
+        }
+
+        // add R camera and T cameras parameters to the device cache (device constant memory)
+        // we are working at input depth map resolution
+        deviceCache.addCameraParams(rc, scaleStep, _mp);
+        for (const int tc : tcams)
+            deviceCache.addCameraParams(tc, scaleStep, _mp);
+
+        std::vector<DeviceFilterTCam> tcamsList;
+        tcamsList.reserve(tcams.size());
+
+        for (const int tc : tcams)
+        {
+            ResidentDepthMap& residentDepthMap = residentDepthMaps[tc];
+
+            // upload the T depth map if it is not already in device memory
+            if (residentDepthMap.depthMap_dmp == nullptr)
+            {
+                image::Image<float> tcDepthMapFromFile;
+                std::shared_ptr<const DepthSimMap> tcDepthSimMap;
+
+                if (_depthSimMapsStore != nullptr)
+                    tcDepthSimMap = _depthSimMapsStore->get(tc);
+                else
+                    mvsUtils::readMap(tc, _mp, mvsUtils::EFileType::depthMap, tcDepthMapFromFile);
+
+                const image::Image<float>& tcDepthMap = (tcDepthSimMap != nullptr) ? tcDepthSimMap->depthMap : tcDepthMapFromFile;
+
+                if (tcDepthMap.Width() <= 0 || tcDepthMap.Height() <= 0)
+                {
+                    residentDepthMaps.erase(tc);
+                    continue;
+                }
+
+                const CudaSize<2> tcDepthMapDim(size_t(tcDepthMap.Width()), size_t(tcDepthMap.Height()));
+                CudaHostMemoryHeap<float, 2> tcDepthMap_hmh(tcDepthMapDim);
+
+                for (size_t x = 0; x < tcDepthMapDim.x(); ++x)
+                    for (size_t y = 0; y < tcDepthMapDim.y(); ++y)
+                        tcDepthMap_hmh(x, y) = tcDepthMap(int(y), int(x));
+
+                residentDepthMap.depthMap_dmp = std::make_unique<CudaDeviceMemoryPitched<float, 2>>(tcDepthMapDim);
+                residentDepthMap.depthMap_dmp->copyFrom(tcDepthMap_hmh);
+                residentDepthMap.depthMapTex = std::make_unique<CudaTexture<float, false, false>>(*residentDepthMap.depthMap_dmp);
+            }
+
+            DeviceFilterTCam tcam;
+            tcam.depthMapTex = residentDepthMap.depthMapTex->textureObj;
+            tcam.deviceCameraParamsId = deviceCache.requestCameraParamsId(tc, scaleStep, _mp);
+            tcam.width = int(residentDepthMap.depthMap_dmp->getSize().x());
+            tcam.height = int(residentDepthMap.depthMap_dmp->getSize().y());
+            tcamsList.push_back(tcam);
+        }
+
+        // get R camera parameters id in device constant memory array
+        const int rcDeviceCameraParamsId = deviceCache.requestCameraParamsId(rc, scaleStep, _mp);
+
+        // copy input depth/sim map into device memory
+        const CudaSize<2> depthSimMapDim(size_t(width), size_t(height));
+        CudaHostMemoryHeap<float2, 2> depthSimMap_hmh(depthSimMapDim);
+
+        for (int x = 0; x < width; ++x)
+            for (int y = 0; y < height; ++y)
+                depthSimMap_hmh(size_t(x), size_t(y)) = make_float2(depthMap(y, x), simMap(y, x));
+
+        CudaDeviceMemoryPitched<float2, 2> in_depthSimMap_dmp(depthSimMapDim);
+        in_depthSimMap_dmp.copyFrom(depthSimMap_hmh);
+
+        // allocate output buffers in device memory
+        CudaDeviceMemoryPitched<float2, 2> out_depthSimMap_dmp(depthSimMapDim);
+        CudaDeviceMemoryPitched<unsigned char, 2> out_nbConsistentCamsMap_dmp(depthSimMapDim);
+
+        if (tcamsList.empty())
+        {
+            ALICEVISION_LOG_WARNING("No T camera depth map for camera: " << _mp.getViewId(rc));
+        }
+
+        // copy T cameras into device memory
+        // note: keep at least one element to avoid an empty allocation
+        CudaDeviceMemory<DeviceFilterTCam> tcams_dmem(std::max<size_t>(tcamsList.size(), 1));
+        if (!tcamsList.empty())
+            tcams_dmem.copyFrom(tcamsList.data(), tcamsList.size());
+
+        // filter the depth/sim map, the votes of all the T cameras are done in a single kernel
+        cuda_depthSimMapFilterConsistency(out_depthSimMap_dmp,
+                                          out_nbConsistentCamsMap_dmp,
+                                          in_depthSimMap_dmp,
+                                          tcams_dmem,
+                                          int(tcamsList.size()),
+                                          rcDeviceCameraParamsId,
+                                          _filterParams,
+                                          0 /*stream*/);
+
+        // compute the normal map from the filtered depth map in device memory
+        if (_computeNormalMaps)
+        {
+            CudaDeviceMemoryPitched<float3, 2> normalMap_dmp(depthSimMapDim);
+
+            // the R camera parameters are at input depth map resolution, no additional step
+            cuda_depthSimMapComputeNormal(normalMap_dmp, out_depthSimMap_dmp, rcDeviceCameraParamsId, 1 /*step*/, ROI(0, width, 0, height), 0 /*stream*/);
+
+            // default tile parameters, no tiles
+            const mvsUtils::TileParams tileParams;
+            const ROI roi(0, _mp.getWidth(rc), 0, _mp.getHeight(rc));
+
+            writeNormalMapFiltered(rc, _mp, tileParams, roi, normalMap_dmp, _scale, _step);
+        }
+
+        // copy the filtered depth/sim map and the number of consistent cameras back to host memory
+        CudaHostMemoryHeap<unsigned char, 2> nbConsistentCamsMap_hmh(depthSimMapDim);
+        depthSimMap_hmh.copyFrom(out_depthSimMap_dmp);
+        nbConsistentCamsMap_hmh.copyFrom(out_nbConsistentCamsMap_dmp);
+
+        image::Image<unsigned char> numOfModalsMap(width, height);
+
+        for (int x = 0; x < width; ++x)
+        {
+            for (int y = 0; y < height; ++y)
+            {
+                const float2& depthSim = depthSimMap_hmh(size_t(x), size_t(y));
+                depthMap(y, x) = depthSim.x;
+                simMap(y, x) = depthSim.y;
+                numOfModalsMap(y, x) = nbConsistentCamsMap_hmh(size_t(x), size_t(y));
+            }
+        }
+
+        image::writeImageWithFloat(
+          getFileNameFromIndex(_mp, rc, mvsUtils::EFileType::nmodMap),
+          numOfModalsMap,
+          image::ImageWriteOptions().toColorSpace(image::EImageColorSpace::LINEAR).storageDataType(image::EStorageDataType::Float));
+
+        mvsUtils::writeMap(rc, _mp, mvsUtils::EFileType::depthMapFiltered, depthMap, _scale, _step);
+        mvsUtils::writeMap(rc, _mp, mvsUtils::EFileType::simMapFiltered, simMap, _scale, _step);
+
+        ALICEVISION_LOG_INFO("Filter depth map (rc: " << rc << ") done in: " << timer.elapsedMs() << " ms.");
+    }
+
+    // device cache countains CUDA objects
+    // this objects should be destroyed before the end of the program (i.e. the end of the CUDA context)
+    DeviceCache::getInstance().clear();
+    residentDepthMaps.clear();
+
+    // release the idle pinned host and device memory blocks
+    MemoryPool::getInstance().release();
+}
+
+void estimateAndFilterOnMultiGPUs(const std::vector<int>& cams,
+                                  DepthMapEstimator& depthMapEstimator,
+                                  DepthMapFilter& depthMapFilter,
+                                  DepthSimMapsStore& depthSimMapsStore,
+                                  int nbCamsPerBatch,
+                                  int nbGPUsToUse)
+{
+    const std::set<int> camsSet(cams.begin(), cams.end());
+
+    // T cameras of each camera, restricted to the given cameras
+    std::map<int, std::vector<int>> tcamsPerCam;
+
+    // number of cameras that still need the depth map of each camera to be filtered
+    std::map<int, int> nbDependentCams;
+
+    for (const int rc : cams)
+    {
+        std::vector<int>& tcams = tcamsPerCam[rc];
+        for (const int tc : depthMapFilter.getTCams(rc))
+        {
+            if (camsSet.count(tc))
+            {
+                tcams.push_back(tc);
+                ++nbDependentCams[tc];
+            }
+        }
+        ++nbDependentCams[rc];
+    }
+
+    // visibility-coherent order: breadth-first traversal of the T cameras graph,
+    // the T cameras of a camera are estimated close to it and its depth map is released early
+    std::vector<int> orderedCams;
+    getNeighbourCoherentOrder(cams, tcamsPerCam, orderedCams);
+
+    const std::size_t batchSize = std::size_t(std::max(1, nbCamsPerBatch));
+
+    std::set<int> estimatedCams;
+    std::vector<int> camsToFilter;
+
+    for (std::size_t batchStart = 0; batchStart < orderedCams.size(); batchStart += batchSize)
+    {
+        const std::size_t batchEnd = std::min(orderedCams.size(), batchStart + batchSize);
+        const std::vector<int> batchCams(orderedCams.begin() + batchStart, orderedCams.begin() + batchEnd);
+
+        // estimate the depth maps of the batch, kept in host memory
+        computeOnMultiGPUs(batchCams, depthMapEstimator, nbGPUsToUse);
+
+        estimatedCams.insert(batchCams.begin(), batchCams.end());
+        camsToFilter.insert(camsToFilter.end(), batchCams.begin(), batchCams.end());
+
+        // filter the cameras whose T cameras depth maps are all estimated
+        std::vector<int> readyCams;
+        std::vector<int> pendingCams;
+
+        for (const int rc : camsToFilter)
+        {
+            const std::vector<int>& tcams = tcamsPerCam.at(rc);
+            const bool isReady = std::all_of(tcams.begin(), tcams.end(), [&](int tc) { return estimatedCams.count(tc) > 0; });
+            (isReady ? readyCams : pendingCams).push_back(rc);
+        }
+
+        camsToFilter.swap(pendingCams);
+
+        if (!readyCams.empty())
+            computeOnMultiGPUs(readyCams, depthMapFilter, nbGPUsToUse);
+
+        // release the depth maps that are no longer needed
+        for (const int rc : readyCams)
+        {
+            if (--nbDependentCams.at(rc) == 0)
+                depthSimMapsStore.release(rc);
+
+            for (const int tc : tcamsPerCam.at(rc))
+            {
+                if (--nbDependentCams.at(tc) == 0)
+                    depthSimMapsStore.release(tc);
+            }
+        }
+
+        ALICEVISION_LOG_INFO("Estimated depth maps: " << estimatedCams.size() << "/" << cams.size() << ", filtered depth maps: "
+                                                      << (estimatedCams.size() - camsToFilter.size()) << "/" << cams.size()
+                                                      << ", depth maps in memory: " << depthSimMapsStore.size() << ".");
+    }
+}
+
+}  // namespace depthMap
+}  // namespace aliceVision
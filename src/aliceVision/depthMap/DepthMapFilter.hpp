@@ -0,0 +1,118 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <aliceVision/mvsData/StaticVector.hpp>
+#include <aliceVision/mvsUtils/MultiViewParams.hpp>
+#include <aliceVision/depthMap/DepthMapEstimator.hpp>
+#include <aliceVision/depthMap/DepthMapFilterParams.hpp>
+#include <aliceVision/depthMap/DepthSimMapsStore.hpp>
+#include <aliceVision/depthMap/computeOnMultiGPUs.hpp>
+
+#include <vector>
+
+namespace aliceVision {
+namespace depthMap {
+
+/**
+ * @brief Depth Map Filter
+ * @brief Filter the depth maps by their consistency with the depth maps of the nearest cameras on the GPU.
+ *        GPU version of fuseCut::Fuser filterGroups and filterDepthMaps.
+ * @note Allows muli-GPUs computation (interface IGPUJob)
+ */
+class DepthMapFilter : public IGPUJob
+{
+  public:
+    /**
+     * @brief Depth Map Filter constructor.
+     * @param[in] mp the multi-view parameters
+     * @param[in] filterParams the depth map filter parameters
+     */
+    DepthMapFilter(const mvsUtils::MultiViewParams& mp, const DepthMapFilterParams& filterParams);
+
+    // no copy constructor
+    DepthMapFilter(DepthMapFilter const&) = delete;
+
+    // no copy operator
+    void operator=(DepthMapFilter const&) = delete;
+
+    // destructor
+    ~DepthMapFilter() = default;
+
+    /**
+     * @brief Filter the depth maps of the given cameras.
+     * @param[in] cudaDeviceId the CUDA device id
+     * @param[in] cams the list of cameras
+     */
+    void compute(int cudaDeviceId, const std::vector<int>& cams) override;
+
+    /**
+     * @brief Take the depth/similarity maps from the given store instead of reading them from disk.
+     * @note The filtered maps are written with the given downscale factors, the maps of the store
+     *       are expected at the resolution of the multi-view parameters downscaled by scale x step.
+     * @param[in] depthSimMapsStore the depth/similarity maps store, nullptr to read the maps from disk
+     * @param[in] scale the depth/similarity maps downscale factor
+     * @param[in] step the depth/similarity maps step factor
+     */
+    void setDepthSimMapsStore(DepthSimMapsStore* depthSimMapsStore, int scale, int step);
+
+    /**
+     * @brief Compute and write the normal maps of the filtered depth maps.
+     * @note The normal maps are computed from the filtered depth maps still in device memory,
+     *       the filtered depth maps are not read back from disk.
+     * @param[in] computeNormalMaps enable normal maps computation
+     */
+    void setComputeNormalMaps(bool computeNormalMaps) { _computeNormalMaps = computeNormalMaps; }
+
+    /**
+     * @brief Get the T cameras used to filter the depth map of the given camera.
+     * @param[in] rc the R camera index
+     * @return the T camera list
+     */
+    StaticVector<int> getTCams(int rc) const;
+
+  private:
+    // private methods
+
+    /**
+     * @return the maximum number of T cameras, limited by the device constant memory
+     */
+    int getNbTCamsMax() const;
+
+    // private members
+
+    const mvsUtils::MultiViewParams& _mp;        //< multi-view parameters
+    const DepthMapFilterParams& _filterParams;  //< depth map filter parameters
+    DepthSimMapsStore* _depthSimMapsStore = nullptr;  //< store of the input depth/similarity maps (optional)
+    int _scale = 1;                                   //< input depth/similarity maps downscale factor
+    int _step = 1;                                    //< input depth/similarity maps step factor
+    bool _computeNormalMaps = false;                  //< compute the normal maps of the filtered depth maps
+};
+
+/**
+ * @brief Estimate and filter the depth maps of the given cameras on multiple GPUs without writing the
+ *        unfiltered depth maps on disk.
+ * @note Cameras are estimated by batches in a visibility-coherent order. A camera is filtered as soon as
+ *       the depth maps of its T cameras have been estimated, a depth map is released from host memory
+ *       once all the cameras using it have been filtered. Only the filtered depth maps are written.
+ * @note The depth map estimator and the depth map filter should share the given store.
+ * @param[in] cams the given list of cameras
+ * @param[in,out] depthMapEstimator the depth map estimator
+ * @param[in,out] depthMapFilter the depth map filter
+ * @param[in,out] depthSimMapsStore the depth/similarity maps store
+ * @param[in] nbCamsPerBatch the number of cameras estimated between two filtering steps
+ * @param[in] nbGPUsToUse the number of GPUs to use
+ */
+void estimateAndFilterOnMultiGPUs(const std::vector<int>& cams,
+                                  DepthMapEstimator& depthMapEstimator,
+                                  DepthMapFilter& depthMapFilter,
+                                  DepthSimMapsStore& depthSimMapsStore,
+                                  int nbCamsPerBatch,
+                                  int nbGPUsToUse);
+
+}  // namespace depthMap
+}  // namespace aliceVision
@@ -0,0 +1,28 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+namespace aliceVision {
+namespace depthMap {
+
+/**
+ * @brief Depth Map Filter Parameters
+ */
+struct DepthMapFilterParams
+{
+    // user parameters
+
+    float pixToleranceFactor = 2.0f;
+    int pixSizeBall = 0;
+    int pixSizeBallWithLowSimilarity = 0;
+    int nNearestCams = 10;
+    int minNumOfConsistentCams = 3;
+    int minNumOfConsistentCamsWithLowSimilarity = 4;
+};
+
+}  // namespace depthMap
+}  // namespace aliceVision
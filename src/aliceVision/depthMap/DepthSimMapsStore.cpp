@@ -0,0 +1,50 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "DepthSimMapsStore.hpp"
+
+#include <utility>
+
+namespace aliceVision {
+namespace depthMap {
+
+void DepthSimMapsStore::add(int rc, image::Image<float>&& depthMap, image::Image<float>&& simMap)
+{
+    auto depthSimMap = std::make_shared<DepthSimMap>();
+    depthSimMap->depthMap = std::move(depthMap);
+    depthSimMap->simMap = std::move(simMap);
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    _depthSimMaps[rc] = std::move(depthSimMap);
+}
+
+std::shared_ptr<const DepthSimMap> DepthSimMapsStore::get(int rc) const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    const auto it = _depthSimMaps.find(rc);
+    return (it != _depthSimMaps.end()) ? it->second : nullptr;
+}
+
+void DepthSimMapsStore::release(int rc)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _depthSimMaps.erase(rc);
+}
+
+bool DepthSimMapsStore::contains(int rc) const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _depthSimMaps.count(rc) > 0;
+}
+
+std::size_t DepthSimMapsStore::size() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _depthSimMaps.size();
+}
+
+}  // namespace depthMap
+}  // namespace aliceVision
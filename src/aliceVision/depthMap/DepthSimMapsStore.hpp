@@ -0,0 +1,74 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <aliceVision/image/Image.hpp>
+
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <mutex>
+
+namespace aliceVision {
+namespace depthMap {
+
+/**
+ * @brief Depth/similarity map of a camera kept in host memory
+ */
+struct DepthSimMap
+{
+    image::Image<float> depthMap;
+    image::Image<float> simMap;
+};
+
+/**
+ * @class Depth/Similarity Maps Store
+ * @brief Thread-safe store of depth/similarity maps in host memory, indexed by camera.
+ *        Allows to filter the estimated depth maps without writing them on disk.
+ */
+class DepthSimMapsStore
+{
+  public:
+    /**
+     * @brief Add the depth/similarity map of the given camera, replace the previous one if any.
+     * @param[in] rc the related R camera index
+     * @param[in] depthMap the depth map
+     * @param[in] simMap the similarity map
+     */
+    void add(int rc, image::Image<float>&& depthMap, image::Image<float>&& simMap);
+
+    /**
+     * @brief Get the depth/similarity map of the given camera.
+     * @note The map stays valid after it has been released from the store.
+     * @param[in] rc the related R camera index
+     * @return the depth/similarity map or nullptr if it is not in the store
+     */
+    std::shared_ptr<const DepthSimMap> get(int rc) const;
+
+    /**
+     * @brief Remove the depth/similarity map of the given camera from the store.
+     * @param[in] rc the related R camera index
+     */
+    void release(int rc);
+
+    /**
+     * @return true if the store contains the depth/similarity map of the given camera
+     */
+    bool contains(int rc) const;
+
+    /**
+     * @return the number of depth/similarity maps in the store
+     */
+    std::size_t size() const;
+
+  private:
+    std::map<int, std::shared_ptr<const DepthSimMap>> _depthSimMaps;
+    mutable std::mutex _mutex;
+};
+
+}  // namespace depthMap
+}  // namespace aliceVision
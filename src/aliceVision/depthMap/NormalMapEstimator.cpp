@@ -12,11 +12,16 @@
 #include <aliceVision/mvsUtils/mapIO.hpp>
 #include <aliceVision/depthMap/depthMapUtils.hpp>
 #include <aliceVision/depthMap/cuda/host/utils.hpp>
+#include <aliceVision/depthMap/cuda/host/memory.hpp>
 #include <aliceVision/depthMap/cuda/host/DeviceCache.hpp>
+#include <aliceVision/depthMap/cuda/host/MemoryPool.hpp>
 #include <aliceVision/depthMap/cuda/planeSweeping/deviceDepthSimilarityMap.hpp>
 
 #include <boost/filesystem.hpp>
 
+#include <future>
+#include <memory>
+
 namespace fs = boost::filesystem;
 
 namespace aliceVision {
@@ -35,67 +40,98 @@ void NormalMapEstimator::compute(int cudaDeviceId, const std::vector<int>& cams)
     DeviceCache& deviceCache = DeviceCache::getInstance();
     deviceCache.build(0, 1);  // 0 mipmap image, 1 camera parameters
 
+    // skip the cameras with an existing normal map
+    std::vector<int> camsToCompute;
+    camsToCompute.reserve(cams.size());
     for (const int rc : cams)
     {
-        const std::string normalMapFilepath = getFileNameFromIndex(_mp, rc, mvsUtils::EFileType::normalMapFiltered);
+        if (!fs::exists(getFileNameFromIndex(_mp, rc, mvsUtils::EFileType::normalMapFiltered)))
+            camsToCompute.push_back(rc);
+    }
 
-        if (!fs::exists(normalMapFilepath))
-        {
-            const system::Timer timer;
+    const auto readDepthMap = [this](int rc) {
+        image::Image<float> depthMap;
+        mvsUtils::readMap(rc, _mp, mvsUtils::EFileType::depthMapFiltered, depthMap);
+        return depthMap;
+    };
+
+    // the depth map of the next camera is read while the normal map of the current camera is computed
+    std::future<image::Image<float>> nextDepthMap;
+    if (!camsToCompute.empty())
+        nextDepthMap = std::async(std::launch::async, readDepthMap, camsToCompute.front());
+
+    // host and device buffers, reused by the consecutive cameras with the same depth map size
+    // note: we don't need similarity for normal map computation
+    //       we use depth/sim map in order to avoid code duplication
+    std::unique_ptr<CudaHostMemoryHeap<float2, 2>> depthSimMap_hmh;
+    std::unique_ptr<CudaDeviceMemoryPitched<float2, 2>> depthSimMap_dmp;
+    std::unique_ptr<CudaDeviceMemoryPitched<float3, 2>> normalMap_dmp;
+
+    for (std::size_t i = 0; i < camsToCompute.size(); ++i)
+    {
+        const int rc = camsToCompute[i];
+        const system::Timer timer;
 
-            ALICEVISION_LOG_INFO("Compute normal map (rc: " << rc << ")");
+        ALICEVISION_LOG_INFO("Compute normal map (rc: " << rc << ")");
 
-            // add R camera parameters to the device cache (device constant memory)
-            // no aditional downscale applied, we are working at input depth map resolution
-            deviceCache.addCameraParams(rc, 1 /*downscale*/, _mp);
+        // get input depth map
+        const image::Image<float> in_depthMap = nextDepthMap.get();
 
-            // get R camera parameters id in device constant memory array
-            const int rcDeviceCameraParamsId = deviceCache.requestCameraParamsId(rc, 1 /*downscale*/, _mp);
+        if (i + 1 < camsToCompute.size())
+            nextDepthMap = std::async(std::launch::async, readDepthMap, camsToCompute[i + 1]);
 
-            // read input depth map
-            image::Image<float> in_depthMap;
-            mvsUtils::readMap(rc, _mp, mvsUtils::EFileType::depthMapFiltered, in_depthMap);
+        // add R camera parameters to the device cache (device constant memory)
+        // no aditional downscale applied, we are working at input depth map resolution
+        deviceCache.addCameraParams(rc, 1 /*downscale*/, _mp);
 
-            // get input depth map width / height
-            const int width = in_depthMap.Width();
-            const int height = in_depthMap.Height();
+        // get R camera parameters id in device constant memory array
+        const int rcDeviceCameraParamsId = deviceCache.requestCameraParamsId(rc, 1 /*downscale*/, _mp);
 
-            // default tile parameters, no tiles
-            const mvsUtils::TileParams tileParams;
+        // get input depth map width / height
+        const int width = in_depthMap.Width();
+        const int height = in_depthMap.Height();
+        const CudaSize<2> depthMapDim(size_t(width), size_t(height));
 
-            // fullsize roi
-            const ROI roi(0, _mp.getWidth(rc), 0, _mp.getHeight(rc));
+        // default tile parameters, no tiles
+        const mvsUtils::TileParams tileParams;
 
-            // copy input depth map into depth/sim map in device memory
-            // note: we don't need similarity for normal map computation
-            //       we use depth/sim map in order to avoid code duplication
-            CudaDeviceMemoryPitched<float2, 2> in_depthSimMap_dmp({size_t(width), size_t(height)});
-            {
-                CudaHostMemoryHeap<float2, 2> in_depthSimMap_hmh(in_depthSimMap_dmp.getSize());
+        // fullsize roi
+        const ROI roi(0, _mp.getWidth(rc), 0, _mp.getHeight(rc));
 
-                for (int x = 0; x < width; ++x)
-                    for (int y = 0; y < height; ++y)
-                        in_depthSimMap_hmh(size_t(x), size_t(y)) = make_float2(in_depthMap(y, x), 1.f);
+        if (depthSimMap_dmp == nullptr || depthSimMap_dmp->getSize() != depthMapDim)
+        {
+            depthSimMap_hmh = std::make_unique<CudaHostMemoryHeap<float2, 2>>(depthMapDim);
+            depthSimMap_dmp = std::make_unique<CudaDeviceMemoryPitched<float2, 2>>(depthMapDim);
+            normalMap_dmp = std::make_unique<CudaDeviceMemoryPitched<float3, 2>>(depthMapDim);
+        }
 
-                in_depthSimMap_dmp.copyFrom(in_depthSimMap_hmh);
-            }
+        // copy input depth map into depth/sim map in device memory
+        for (int y = 0; y < height; ++y)
+            for (int x = 0; x < width; ++x)
+                (*depthSimMap_hmh)(size_t(x), size_t(y)) = make_float2(in_depthMap(y, x), 1.f);
 
-            // allocate normal map buffer in device memory
-            CudaDeviceMemoryPitched<float3, 2> out_normalMap_dmp(in_depthSimMap_dmp.getSize());
+        depthSimMap_dmp->copyFrom(*depthSimMap_hmh);
 
-            // compute normal map
-            cuda_depthSimMapComputeNormal(out_normalMap_dmp, in_depthSimMap_dmp, rcDeviceCameraParamsId, 1 /*step*/, roi, 0 /*stream*/);
+        // compute normal map
+        cuda_depthSimMapComputeNormal(*normalMap_dmp, *depthSimMap_dmp, rcDeviceCameraParamsId, 1 /*step*/, roi, 0 /*stream*/);
 
-            // write output normal map
-            writeNormalMapFiltered(rc, _mp, tileParams, roi, out_normalMap_dmp);
+        // write output normal map
+        writeNormalMapFiltered(rc, _mp, tileParams, roi, *normalMap_dmp);
 
-            ALICEVISION_LOG_INFO("Compute normal map (rc: " << rc << ") done in: " << timer.elapsedMs() << " ms.");
-        }
+        ALICEVISION_LOG_INFO("Compute normal map (rc: " << rc << ") done in: " << timer.elapsedMs() << " ms.");
     }
 
+    // release the buffers before the memory pool
+    depthSimMap_hmh.reset();
+    depthSimMap_dmp.reset();
+    normalMap_dmp.reset();
+
     // device cache countains CUDA objects
     // this objects should be destroyed before the end of the program (i.e. the end of the CUDA context)
     DeviceCache::getInstance().clear();
+
+    // release the idle pinned host and device memory blocks
+    MemoryPool::getInstance().release();
 }
 
 }  // namespace depthMap
@@ -14,6 +14,7 @@
 #include <aliceVision/depthMap/depthMapUtils.hpp>
 #include <aliceVision/depthMap/volumeIO.hpp>
 #include <aliceVision/depthMap/cuda/host/DeviceCache.hpp>
+#include <aliceVision/depthMap/cuda/host/DeviceProfiler.hpp>
 #include <aliceVision/depthMap/cuda/planeSweeping/deviceDepthSimilarityMap.hpp>
 #include <aliceVision/depthMap/cuda/planeSweeping/deviceSimilarityVolume.hpp>
 
@@ -106,6 +107,8 @@ void Refine::refineRc(const Tile& tile,
     // compute upscaled SGM depth/pixSize map
     // compute upscaled SGM normal map
     {
+        const DeviceStageRange stageRange(tile.rc, EDeviceStage::REFINE, _stream);
+
         // downscale the region of interest
         const ROI downscaledRoi = downscaleROI(tile.roi, _refineParams.scale * _refineParams.stepXY);
 
@@ -179,6 +182,8 @@ void Refine::refineAndFuseDepthSimMap(const Tile& tile)
 {
     ALICEVISION_LOG_INFO(tile << "Refine and fuse depth/sim map volume.");
 
+    const DeviceStageRange stageRange(tile.rc, EDeviceStage::REFINE, _stream);
+
     // downscale the region of interest
     const ROI downscaledRoi = downscaleROI(tile.roi, _refineParams.scale * _refineParams.stepXY);
 
@@ -198,39 +203,43 @@ void Refine::refineAndFuseDepthSimMap(const Tile& tile)
     // get R device mipmap image from cache
     const DeviceMipmapImage& rcDeviceMipmapImage = deviceCache.requestMipmapImage(tile.rc, _mp);
 
-    // compute for each RcTc each similarity value for each depth to refine
-    // sum the inverted / filtered similarity value, best value is the HIGHEST
+    // get T device camera parameters ids and mipmap images from cache
+    std::vector<int> tcDeviceCameraParamsIds;
+    std::vector<const DeviceMipmapImage*> tcDeviceMipmapImages;
+
+    tcDeviceCameraParamsIds.reserve(tile.refineTCams.size());
+    tcDeviceMipmapImages.reserve(tile.refineTCams.size());
+
     for (std::size_t tci = 0; tci < tile.refineTCams.size(); ++tci)
     {
         const int tc = tile.refineTCams.at(tci);
 
-        // get T device camera parameters id from cache
-        const int tcDeviceCameraParamsId = deviceCache.requestCameraParamsId(tc, _refineParams.scale, _mp);
-
-        // get T device mipmap image from cache
-        const DeviceMipmapImage& tcDeviceMipmapImage = deviceCache.requestMipmapImage(tc, _mp);
+        tcDeviceCameraParamsIds.push_back(deviceCache.requestCameraParamsId(tc, _refineParams.scale, _mp));
+        tcDeviceMipmapImages.push_back(&deviceCache.requestMipmapImage(tc, _mp));
 
         ALICEVISION_LOG_DEBUG(tile << "Refine similarity volume:" << std::endl
                                    << "\t- rc: " << tile.rc << std::endl
                                    << "\t- tc: " << tc << " (" << (tci + 1) << "/" << tile.refineTCams.size() << ")" << std::endl
                                    << "\t- rc camera parameters id: " << rcDeviceCameraParamsId << std::endl
-                                   << "\t- tc camera parameters id: " << tcDeviceCameraParamsId << std::endl
+                                   << "\t- tc camera parameters id: " << tcDeviceCameraParamsIds.back() << std::endl
                                    << "\t- tile range x: [" << downscaledRoi.x.begin << " - " << downscaledRoi.x.end << "]" << std::endl
                                    << "\t- tile range y: [" << downscaledRoi.y.begin << " - " << downscaledRoi.y.end << "]" << std::endl);
-
-        cuda_volumeRefineSimilarity(_volumeRefineSim_dmp,
-                                    _sgmDepthPixSizeMap_dmp,
-                                    (_refineParams.useSgmNormalMap) ? &_sgmNormalMap_dmp : nullptr,
-                                    rcDeviceCameraParamsId,
-                                    tcDeviceCameraParamsId,
-                                    rcDeviceMipmapImage,
-                                    tcDeviceMipmapImage,
-                                    _refineParams,
-                                    depthRange,
-                                    downscaledRoi,
-                                    _stream);
     }
 
+    // compute for all RcTc each similarity value for each depth to refine
+    // sum the inverted / filtered similarity value, best value is the HIGHEST
+    cuda_volumeRefineSimilarity(_volumeRefineSim_dmp,
+                                _sgmDepthPixSizeMap_dmp,
+                                (_refineParams.useSgmNormalMap) ? &_sgmNormalMap_dmp : nullptr,
+                                rcDeviceCameraParamsId,
+                                tcDeviceCameraParamsIds,
+                                rcDeviceMipmapImage,
+                                tcDeviceMipmapImages,
+                                _refineParams,
+                                depthRange,
+                                downscaledRoi,
+                                _stream);
+
     // export intermediate volume information (if requested by user)
     exportVolumeInformation(tile, "afterRefine");
 
@@ -245,6 +254,8 @@ void Refine::optimizeDepthSimMap(const Tile& tile)
 {
     ALICEVISION_LOG_INFO(tile << "Color optimize depth/sim map.");
 
+    const DeviceStageRange stageRange(tile.rc, EDeviceStage::REFINE_OPTIMIZE, _stream);
+
     // downscale the region of interest
     const ROI downscaledRoi = downscaleROI(tile.roi, _refineParams.scale * _refineParams.stepXY);
 
@@ -283,7 +294,10 @@ void Refine::computeAndWriteNormalMap(const Tile& tile, const CudaDeviceMemoryPi
     ALICEVISION_LOG_INFO(tile << "Refine compute normal map of view id: " << _mp.getViewId(tile.rc) << ", rc: " << tile.rc << " (" << (tile.rc + 1)
                               << " / " << _mp.ncams << ").");
 
-    cuda_depthSimMapComputeNormal(_normalMap_dmp, in_depthSimMap_dmp, rcDeviceCameraParamsId, _refineParams.stepXY, downscaledRoi, _stream);
+    {
+        const DeviceStageRange stageRange(tile.rc, EDeviceStage::NORMAL_MAP, _stream);
+        cuda_depthSimMapComputeNormal(_normalMap_dmp, in_depthSimMap_dmp, rcDeviceCameraParamsId, _refineParams.stepXY, downscaledRoi, _stream);
+    }
 
     writeNormalMap(tile.rc, _mp, _tileParams, tile.roi, _normalMap_dmp, _refineParams.scale, _refineParams.stepXY, name);
 }
@@ -12,6 +12,7 @@
 #include <aliceVision/depthMap/volumeIO.hpp>
 #include <aliceVision/depthMap/cuda/host/utils.hpp>
 #include <aliceVision/depthMap/cuda/host/DeviceCache.hpp>
+#include <aliceVision/depthMap/cuda/host/DeviceProfiler.hpp>
 #include <aliceVision/depthMap/cuda/planeSweeping/deviceDepthSimilarityMap.hpp>
 #include <aliceVision/depthMap/cuda/planeSweeping/deviceSimilarityVolume.hpp>
 
@@ -61,6 +62,10 @@ Sgm::Sgm(const mvsUtils::MultiViewParams& mp,
     if (_computeNormalMap)
         _normalMap_dmp.allocate(mapDim);
 
+    // allocate per-pixel depth index range map in device memory
+    if (_sgmParams.useCoarseToFine)
+        _depthIndexRangeMap_dmp.allocate(mapDim);
+
     // allocate similarity volumes in device memory
     {
         const CudaSize<3> volDim(maxTileWidth, maxTileHeight, _sgmParams.maxDepths);
@@ -88,6 +93,7 @@ double Sgm::getDeviceMemoryConsumption() const
     bytes += _depthThicknessMap_dmp.getBytesPadded();
     bytes += _depthSimMap_dmp.getBytesPadded();
     bytes += _normalMap_dmp.getBytesPadded();
+    bytes += _depthIndexRangeMap_dmp.getBytesPadded();
     bytes += _volumeBestSim_dmp.getBytesPadded();
     bytes += _volumeSecBestSim_dmp.getBytesPadded();
     bytes += _volumeSliceAccA_dmp.getBytesPadded();
@@ -105,6 +111,7 @@ double Sgm::getDeviceMemoryConsumptionUnpadded() const
     bytes += _depthThicknessMap_dmp.getBytesUnpadded();
     bytes += _depthSimMap_dmp.getBytesUnpadded();
     bytes += _normalMap_dmp.getBytesUnpadded();
+    bytes += _depthIndexRangeMap_dmp.getBytesUnpadded();
     bytes += _volumeBestSim_dmp.getBytesUnpadded();
     bytes += _volumeSecBestSim_dmp.getBytesUnpadded();
     bytes += _volumeSliceAccA_dmp.getBytesUnpadded();
@@ -132,8 +139,12 @@ void Sgm::sgmRc(const Tile& tile, const SgmDepthList& tileDepthList)
     // copy rc depth data in device memory
     _depths_dmp.copyFrom(_depths_hmh, _stream);
 
+    // coarse-to-fine: compute the per-pixel depth index range to sweep from a coarse SGM
+    if (_sgmParams.useCoarseToFine)
+        computeDepthIndexRangeMap(tile, tileDepthList);
+
     // compute best sim and second best sim volumes
-    computeSimilarityVolumes(tile, tileDepthList);
+    computeSimilarityVolumes(tile, tileDepthList, _sgmParams, _sgmParams.useCoarseToFine ? &_depthIndexRangeMap_dmp : nullptr);
 
     // export intermediate volume information (if requested by user)
     exportVolumeInformation(tile, tileDepthList, _volumeSecBestSim_dmp, "beforeFiltering");
@@ -143,7 +154,7 @@ void Sgm::sgmRc(const Tile& tile, const SgmDepthList& tileDepthList)
     // it must equals to true in normal case
     if (_sgmParams.doSgmOptimizeVolume)
     {
-        optimizeSimilarityVolume(tile, tileDepthList);
+        optimizeSimilarityVolume(tile, tileDepthList, _sgmParams);
     }
     else
     {
@@ -175,7 +186,10 @@ void Sgm::sgmRc(const Tile& tile, const SgmDepthList& tileDepthList)
 
         ALICEVISION_LOG_INFO(tile << "SGM compute normal map of view id: " << viewId << ", rc: " << tile.rc << " (" << (tile.rc + 1) << " / "
                                   << _mp.ncams << ").");
-        cuda_depthSimMapComputeNormal(_normalMap_dmp, _depthSimMap_dmp, rcDeviceCameraParamsId, _sgmParams.stepXY, downscaledRoi, _stream);
+        {
+            const DeviceStageRange stageRange(tile.rc, EDeviceStage::NORMAL_MAP, _stream);
+            cuda_depthSimMapComputeNormal(_normalMap_dmp, _depthSimMap_dmp, rcDeviceCameraParamsId, _sgmParams.stepXY, downscaledRoi, _stream);
+        }
 
         // export intermediate normal map (if requested by user)
         if (_sgmParams.exportIntermediateNormalMaps)
@@ -200,12 +214,17 @@ void Sgm::smoothThicknessMap(const Tile& tile, const RefineParams& refineParams)
     ALICEVISION_LOG_INFO(tile << "SGM Smooth thickness map done.");
 }
 
-void Sgm::computeSimilarityVolumes(const Tile& tile, const SgmDepthList& tileDepthList)
+void Sgm::computeSimilarityVolumes(const Tile& tile,
+                                   const SgmDepthList& tileDepthList,
+                                   const SgmParams& sgmParams,
+                                   const CudaDeviceMemoryPitched<int2, 2>* in_depthIndexRangeMap_dmpPtr)
 {
     ALICEVISION_LOG_INFO(tile << "SGM Compute similarity volume.");
 
+    const DeviceStageRange stageRange(tile.rc, EDeviceStage::SGM_SIMILARITY, _stream);
+
     // downscale the region of interest
-    const ROI downscaledRoi = downscaleROI(tile.roi, _sgmParams.scale * _sgmParams.stepXY);
+    const ROI downscaledRoi = downscaleROI(tile.roi, sgmParams.scale * sgmParams.stepXY);
 
     // initialize the two similarity volumes at 255
     cuda_volumeInitialize(_volumeBestSim_dmp, 255.f, _stream);
@@ -249,11 +268,12 @@ void Sgm::computeSimilarityVolumes(const Tile& tile, const SgmDepthList& tileDep
         cuda_volumeComputeSimilarity(_volumeBestSim_dmp,
                                      _volumeSecBestSim_dmp,
                                      _depths_dmp,
+                                     in_depthIndexRangeMap_dmpPtr,
                                      rcDeviceCameraParamsId,
                                      tcDeviceCameraParamsId,
                                      rcDeviceMipmapImage,
                                      tcDeviceMipmapImage,
-                                     _sgmParams,
+                                     sgmParams,
                                      tcDepthRange,
                                      downscaledRoi,
                                      _stream);
@@ -272,12 +292,14 @@ void Sgm::computeSimilarityVolumes(const Tile& tile, const SgmDepthList& tileDep
     ALICEVISION_LOG_INFO(tile << "SGM Compute similarity volume done.");
 }
 
-void Sgm::optimizeSimilarityVolume(const Tile& tile, const SgmDepthList& tileDepthList)
+void Sgm::optimizeSimilarityVolume(const Tile& tile, const SgmDepthList& tileDepthList, const SgmParams& sgmParams)
 {
-    ALICEVISION_LOG_INFO(tile << "SGM Optimizing volume (filtering axes: " << _sgmParams.filteringAxes << ").");
+    ALICEVISION_LOG_INFO(tile << "SGM Optimizing volume (filtering axes: " << sgmParams.filteringAxes << ").");
+
+    const DeviceStageRange stageRange(tile.rc, EDeviceStage::SGM_AGGREGATION, _stream);
 
     // downscale the region of interest
-    const ROI downscaledRoi = downscaleROI(tile.roi, _sgmParams.scale * _sgmParams.stepXY);
+    const ROI downscaledRoi = downscaleROI(tile.roi, sgmParams.scale * sgmParams.stepXY);
 
     // get R device mipmap image from cache
     DeviceCache& deviceCache = DeviceCache::getInstance();
@@ -289,7 +311,7 @@ void Sgm::optimizeSimilarityVolume(const Tile& tile, const SgmDepthList& tileDep
                         _volumeAxisAcc_dmp,     // axis accumulation buffer pre-allocate
                         _volumeSecBestSim_dmp,  // input volume
                         rcDeviceMipmapImage,
-                        _sgmParams,
+                        sgmParams,
                         tileDepthList.getDepths().size(),
                         downscaledRoi,
                         _stream);
@@ -297,10 +319,47 @@ void Sgm::optimizeSimilarityVolume(const Tile& tile, const SgmDepthList& tileDep
     ALICEVISION_LOG_INFO(tile << "SGM Optimizing volume done.");
 }
 
+void Sgm::computeDepthIndexRangeMap(const Tile& tile, const SgmDepthList& tileDepthList)
+{
+    ALICEVISION_LOG_INFO(tile << "SGM Compute coarse depth index range map.");
+
+    // coarse SGM parameters, only the sampling step of the patches changes
+    SgmParams coarseSgmParams(_sgmParams);
+    coarseSgmParams.stepXY *= _sgmParams.coarseToFineFactor;
+
+    // coarse similarity volumes are computed and optimized in the first part of the volume buffers
+    computeSimilarityVolumes(tile, tileDepthList, coarseSgmParams, nullptr);
+
+    if (_sgmParams.doSgmOptimizeVolume)
+        optimizeSimilarityVolume(tile, tileDepthList, coarseSgmParams);
+    else
+        _volumeBestSim_dmp.copyFrom(_volumeSecBestSim_dmp, _stream);
+
+    // downscale the regions of interest
+    const ROI downscaledRoi = downscaleROI(tile.roi, _sgmParams.scale * _sgmParams.stepXY);
+    const ROI coarseDownscaledRoi = downscaleROI(tile.roi, coarseSgmParams.scale * coarseSgmParams.stepXY);
+
+    // get depth range
+    const Range depthRange(0, tileDepthList.getDepths().size());
+
+    cuda_volumeComputeDepthIndexRange(_depthIndexRangeMap_dmp,
+                                      _volumeBestSim_dmp,
+                                      _sgmParams.coarseToFineFactor,
+                                      _sgmParams.coarseToFineBandHalfSize,
+                                      depthRange,
+                                      coarseDownscaledRoi,
+                                      downscaledRoi,
+                                      _stream);
+
+    ALICEVISION_LOG_INFO(tile << "SGM Compute coarse depth index range map done.");
+}
+
 void Sgm::retrieveBestDepth(const Tile& tile, const SgmDepthList& tileDepthList)
 {
     ALICEVISION_LOG_INFO(tile << "SGM Retrieve best depth in volume.");
 
+    const DeviceStageRange stageRange(tile.rc, EDeviceStage::SGM_RETRIEVE_DEPTH, _stream);
+
     // downscale the region of interest
     const ROI downscaledRoi = downscaleROI(tile.roi, _sgmParams.scale * _sgmParams.stepXY);
 
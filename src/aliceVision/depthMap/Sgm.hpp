@@ -94,8 +94,13 @@ class Sgm
      * @brief Compute for each RcTc the best / second best similarity volumes.
      * @param[in] tile The given tile for SGM computation
      * @param[in] tileDepthList the tile SGM depth list
+     * @param[in] sgmParams the Semi Global Matching parameters of the computation (stepXY may be coarser)
+     * @param[in] in_depthIndexRangeMap_dmpPtr the per-pixel depth index range to compute (or nullptr)
      */
-    void computeSimilarityVolumes(const Tile& tile, const SgmDepthList& tileDepthList);
+    void computeSimilarityVolumes(const Tile& tile,
+                                  const SgmDepthList& tileDepthList,
+                                  const SgmParams& sgmParams,
+                                  const CudaDeviceMemoryPitched<int2, 2>* in_depthIndexRangeMap_dmpPtr);
 
     /**
      * @brief Optimize the given similarity volume.
@@ -103,8 +108,18 @@ class Sgm
      *        So it downweights local minimums that are not supported by their neighborhood.
      * @param[in] tile The given tile for SGM computation
      * @param[in] tileDepthList the tile SGM depth list
+     * @param[in] sgmParams the Semi Global Matching parameters of the computation (stepXY may be coarser)
      */
-    void optimizeSimilarityVolume(const Tile& tile, const SgmDepthList& tileDepthList);
+    void optimizeSimilarityVolume(const Tile& tile, const SgmDepthList& tileDepthList, const SgmParams& sgmParams);
+
+    /**
+     * @brief Compute the per-pixel depth index range to sweep from a coarse Semi-Global Matching.
+     * @note  The coarse similarity volume is computed and optimized with a coarser stepXY,
+     *        then each pixel only sweeps a band of depths around the best coarse depths of its neighbourhood.
+     * @param[in] tile The given tile for SGM computation
+     * @param[in] tileDepthList the tile SGM depth list
+     */
+    void computeDepthIndexRangeMap(const Tile& tile, const SgmDepthList& tileDepthList);
 
     /**
      * @brief Retrieve the best depths in the given similarity volume.
@@ -141,6 +156,7 @@ class Sgm
     CudaDeviceMemoryPitched<float2, 2> _depthThicknessMap_dmp;  //< rc result depth thickness map
     CudaDeviceMemoryPitched<float2, 2> _depthSimMap_dmp;        //< rc result depth/sim map
     CudaDeviceMemoryPitched<float3, 2> _normalMap_dmp;          //< rc normal map
+    CudaDeviceMemoryPitched<int2, 2> _depthIndexRangeMap_dmp;   //< rc per-pixel depth index range to sweep (coarse-to-fine)
     CudaDeviceMemoryPitched<TSim, 3> _volumeBestSim_dmp;        //< rc best similarity volume
     CudaDeviceMemoryPitched<TSim, 3> _volumeSecBestSim_dmp;     //< rc second best similarity volume
     CudaDeviceMemoryPitched<TSimAcc, 2> _volumeSliceAccA_dmp;   //< for optimization: volume accumulation slice A
@@ -137,21 +137,34 @@ void SgmDepthList::computeListRc()
     // build the list of "best" depths for rc, from all tc cameras depths
     computeRcDepthList(firstDepth, lastDepth, (_sgmParams.stepZ > 0.0f ? _sgmParams.stepZ : 1.0f), depthsPerTc);
 
+    // maximum number of depths of the R camera
+    // in adaptive mode, it depends on the depth range and the R camera pixel size, the similarity volume size is an upper bound
+    int maxDepths = _sgmParams.maxDepths;
+
+    if (_sgmParams.adaptiveDepths && !_depths.empty())
+    {
+        maxDepths = computeAdaptiveNbDepths(firstDepth, lastDepth, (maxDepths > 0) ? maxDepths : std::numeric_limits<int>::max());
+
+        ALICEVISION_LOG_DEBUG(_tile << "Adaptive number of depths for R camera:" << std::endl
+                                    << "\t- nb depths: " << _depths.size() << std::endl
+                                    << "\t- adaptive max depths: " << maxDepths);
+    }
+
     // filter out depths if computeDepths gave too many values
-    if (_sgmParams.maxDepths > 0 && _depths.size() > _sgmParams.maxDepths)
+    if (maxDepths > 0 && _depths.size() > maxDepths)
     {
-        const float scaleFactor = float(_depths.size()) / float(_sgmParams.maxDepths);
+        const float scaleFactor = float(_depths.size()) / float(maxDepths);
 
         ALICEVISION_LOG_DEBUG(_tile << "Too many values in R camera depth list, filter out with scale factor:" << std::endl
                                     << "\t- nb depths: " << _depths.size() << std::endl
-                                    << "\t- max depths: " << _sgmParams.maxDepths << std::endl
+                                    << "\t- max depths: " << maxDepths << std::endl
                                     << "\t- scale factor to apply: " << scaleFactor);
 
         computeRcDepthList(firstDepth, lastDepth, scaleFactor, depthsPerTc);
 
         // ensure depth list size is not greater than maxDepths
-        if (_depths.size() > _sgmParams.maxDepths)
-            _depths.resize(_sgmParams.maxDepths);  // reduce to depth list first maxDepths elements
+        if (_depths.size() > maxDepths)
+            _depths.resize(maxDepths);  // reduce to depth list first maxDepths elements
     }
 
     ALICEVISION_LOG_DEBUG(_tile << "Final depth range for R camera:" << std::endl
@@ -544,6 +557,35 @@ void SgmDepthList::computeRcTcDepths(int tc, float midDepth, std::vector<float>&
         ALICEVISION_LOG_DEBUG(_tile << "Depth to use range [" << out_depths.front() << "-" << out_depths.back() << "]" << std::endl);
 }
 
+int SgmDepthList::computeAdaptiveNbDepths(float firstDepth, float lastDepth, int maxNbDepths) const
+{
+    // depth map resolution
+    const float d = float(_sgmParams.scale) * float(_sgmParams.stepXY);
+
+    OrientedPoint rcplane;
+    rcplane.p = _mp.CArr[_tile.rc];
+    rcplane.n = _mp.iRArr[_tile.rc] * Point3d(0.0, 0.0, 1.0);
+    rcplane.n = rcplane.n.normalize();
+
+    // at least 2 depths to define the range
+    int nbDepths = 1;
+    float depth = firstDepth;
+
+    while ((depth < lastDepth) && (nbDepths < maxNbDepths))
+    {
+        const Point3d p = rcplane.p + rcplane.n * depth;
+        const float pixSize = _mp.getCamPixelSize(p, _tile.rc, d);
+
+        if (pixSize <= 0.0f)
+            break;
+
+        depth += pixSize;
+        ++nbDepths;
+    }
+
+    return std::max(2, nbDepths);
+}
+
 void SgmDepthList::computePixelSizeDepths(float minObsDepth, float midObsDepth, float maxObsDepth, std::vector<float>& out_depths) const
 {
     assert(out_depths.empty());
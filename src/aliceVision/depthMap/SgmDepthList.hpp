@@ -91,6 +91,17 @@ class SgmDepthList
      */
     void computeRcTcDepths(int tc, float midObsDepth, std::vector<float>& out_depths) const;
 
+    /**
+     * @brief Compute the number of depths needed to sample the given depth range at the R camera pixel size.
+     * @note The depth step is the R camera pixel size at the depth map resolution (scale * stepXY),
+     *       finer steps cannot be resolved in the output depth map.
+     * @param[in] firstDepth The first depth of the range
+     * @param[in] lastDepth The last depth of the range
+     * @param[in] maxNbDepths The maximum number of depths
+     * @return the number of depths, at most maxNbDepths
+     */
+    int computeAdaptiveNbDepths(float firstDepth, float lastDepth, int maxNbDepths) const;
+
     /**
      * @brief Compute a depth list from R camera pixel size.
      * @param[in] minObsDepth The min depth observation
@@ -34,6 +34,9 @@ struct SgmParams
     std::string filteringAxes = "YX";
     bool useSfmSeeds = true;
     bool depthListPerTile = false;
+    bool adaptiveDepths = false;
+    bool useCoarseToFine = false;
+    int coarseToFineBandHalfSize = 32;
     bool useConsistentScale = false;
     bool useCustomPatchPattern = false;
 
@@ -53,6 +56,7 @@ struct SgmParams
     const float prematchingMaxDepthScale = 1.5f;
     const double seedsRangePercentile = 0.999;
     const bool doSgmOptimizeVolume = true;
+    const int coarseToFineFactor = 2;
 };
 
 }  // namespace depthMap
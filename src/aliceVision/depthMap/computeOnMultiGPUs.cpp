@@ -9,9 +9,45 @@
 #include <aliceVision/alicevision_omp.hpp>
 #include <aliceVision/depthMap/cuda/host/utils.hpp>
 
+#include <algorithm>
+#include <deque>
+#include <set>
+
 namespace aliceVision {
 namespace depthMap {
 
+bool CamerasQueue::pop(int nbCams, std::vector<int>& cams)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    cams.clear();
+    const std::size_t last = std::min(_cams.size(), _next + static_cast<std::size_t>(std::max(1, nbCams)));
+    cams.assign(_cams.begin() + _next, _cams.begin() + last);
+    _next = last;
+    return !cams.empty();
+}
+
+void CamerasQueue::peek(int nbCams, std::vector<int>& cams) const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    const std::size_t last = std::min(_cams.size(), _next + static_cast<std::size_t>(std::max(0, nbCams)));
+    cams.assign(_cams.begin() + _next, _cams.begin() + last);
+}
+
+std::size_t CamerasQueue::remaining() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _cams.size() - _next;
+}
+
+void IGPUJob::computeFromQueue(int cudaDeviceId, CamerasQueue& camsQueue)
+{
+    std::vector<int> cams;
+    while (camsQueue.pop(1, cams))
+        compute(cudaDeviceId, cams);
+}
+
 void computeOnMultiGPUs(const std::vector<int>& cams, IGPUJob& gpujob, int nbGPUsToUse)
 {
     const int nbGPUDevices = listCudaDevices();
@@ -36,6 +72,9 @@ void computeOnMultiGPUs(const std::vector<int>& cams, IGPUJob& gpujob, int nbGPU
     }
     else
     {
+        // shared queue of cameras: each device pops cameras as soon as it is ready to compute them
+        CamerasQueue camsQueue(cams);
+
         // backup max threads to keep potentially previously set value
         int previous_count_threads = omp_get_max_threads();
         omp_set_num_threads(nbThreads);  // create as many CPU threads as there are CUDA devices
@@ -46,25 +85,43 @@ void computeOnMultiGPUs(const std::vector<int>& cams, IGPUJob& gpujob, int nbGPU
 
             ALICEVISION_LOG_INFO("CPU thread " << cpuThreadId << " (of " << nbThreads << ") uses CUDA device: " << cudaDeviceId);
 
-            const int nbCamsPerThread = (cams.size() / nbThreads);
-            const int rcFrom = cudaDeviceId * nbCamsPerThread;
-            int rcTo = (cudaDeviceId + 1) * nbCamsPerThread;
-            if (cudaDeviceId == nbThreads - 1)
-            {
-                rcTo = cams.size();
-            }
+            gpujob.computeFromQueue(cudaDeviceId, camsQueue);
+        }
+        omp_set_num_threads(previous_count_threads);
+    }
+}
+
+void getNeighbourCoherentOrder(const std::vector<int>& cams, const std::map<int, std::vector<int>>& neighbourCamsPerCam, std::vector<int>& orderedCams)
+{
+    const std::set<int> camsSet(cams.begin(), cams.end());
 
-            std::vector<int> subcams;
-            subcams.reserve(cams.size());
+    orderedCams.clear();
+    orderedCams.reserve(cams.size());
 
-            for (int rc = rcFrom; rc < rcTo; ++rc)
+    std::set<int> visited;
+    for (const int startCam : cams)
+    {
+        if (!visited.insert(startCam).second)
+            continue;
+
+        std::deque<int> camsToVisit(1, startCam);
+        while (!camsToVisit.empty())
+        {
+            const int c = camsToVisit.front();
+            camsToVisit.pop_front();
+            orderedCams.push_back(c);
+
+            const auto it = neighbourCamsPerCam.find(c);
+            if (it == neighbourCamsPerCam.end())
+                continue;
+
+            // only the given cameras are ordered
+            for (const int nc : it->second)
             {
-                subcams.push_back(cams[rc]);
+                if (camsSet.count(nc) && visited.insert(nc).second)
+                    camsToVisit.push_back(nc);
             }
-
-            gpujob.compute(cudaDeviceId, subcams);
         }
-        omp_set_num_threads(previous_count_threads);
     }
 }
 
@@ -8,9 +8,52 @@
 
 #include <aliceVision/mvsUtils/MultiViewParams.hpp>
 
+#include <map>
+#include <mutex>
+#include <vector>
+
 namespace aliceVision {
 namespace depthMap {
 
+/**
+ * @class CamerasQueue
+ * @brief Thread-safe queue of cameras shared by all the GPUs.
+ *        Each device pops the next cameras when it is ready to compute them,
+ *        so faster devices (or devices with more memory) process more cameras.
+ */
+class CamerasQueue
+{
+  public:
+    explicit CamerasQueue(const std::vector<int>& cams)
+      : _cams(cams)
+    {}
+
+    /**
+     * @brief Pop the next cameras of the queue.
+     * @param[in] nbCams the maximum number of cameras to pop
+     * @param[out] cams the popped cameras (replaced)
+     * @return false if the queue is empty
+     */
+    bool pop(int nbCams, std::vector<int>& cams);
+
+    /**
+     * @brief Get the next cameras of the queue without popping them.
+     * @param[in] nbCams the maximum number of cameras to get
+     * @param[out] cams the next cameras (replaced)
+     */
+    void peek(int nbCams, std::vector<int>& cams) const;
+
+    /**
+     * @brief Get the number of cameras remaining in the queue.
+     */
+    std::size_t remaining() const;
+
+  private:
+    const std::vector<int> _cams;
+    std::size_t _next = 0;
+    mutable std::mutex _mutex;
+};
+
 /**
  * @class IGPUJob
  * @brief Interface for multi-GPUs computation.
@@ -24,15 +67,33 @@ class IGPUJob
      * @param[in] cams the list of cameras
      */
     virtual void compute(int cudaDeviceId, const std::vector<int>& cams) = 0;
+
+    /**
+     * @brief Perform computation from cameras popped from a queue shared with other devices.
+     * @note The default implementation computes the cameras one by one.
+     * @param[in] cudaDeviceId the CUDA device id
+     * @param[in,out] camsQueue the shared queue of cameras
+     */
+    virtual void computeFromQueue(int cudaDeviceId, CamerasQueue& camsQueue);
 };
 
 /**
  * @brief Perform computation from the given cameras on multiple GPUs.
+ * @note Cameras are dynamically distributed to the GPUs through a shared queue.
  * @param[in] cams the given list of cameras
  * @param[in,out] gpujob the object that wrap computation (should use IGPUJob interface)
  * @param[in] nbGPUsToUse the number of GPUs to use
  */
 void computeOnMultiGPUs(const std::vector<int>& cams, IGPUJob& gpujob, int nbGPUsToUse);
 
+/**
+ * @brief Order the given cameras with a breadth-first traversal of their neighbour cameras graph,
+ *        so that consecutive cameras share most of their neighbour cameras.
+ * @param[in] cams the given list of cameras
+ * @param[in] neighbourCamsPerCam the neighbour cameras of each given camera
+ * @param[out] orderedCams the given cameras in the traversal order (replaced)
+ */
+void getNeighbourCoherentOrder(const std::vector<int>& cams, const std::map<int, std::vector<int>>& neighbourCamsPerCam, std::vector<int>& orderedCams);
+
 }  // namespace depthMap
 }  // namespace aliceVision
@@ -0,0 +1,110 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2023 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+namespace aliceVision {
+namespace depthMap {
+
+// similarity volume types of the CPU engine
+// same as the CUDA engine default types (see cuda/planeSweeping/similarity.hpp)
+using TSimCpu = unsigned char;
+using TSimAccCpu = unsigned short;
+using TSimRefineCpu = float;
+
+// minimum alpha values of the R and T pixels, range (0, 255)
+// same as the CUDA engine (see cuda/device/color.cuh)
+constexpr float CPU_DEPTHMAP_RC_MIN_ALPHA = 255.f * 0.9f;
+constexpr float CPU_DEPTHMAP_TC_MIN_ALPHA = 255.f * 0.4f;
+
+/**
+ * @struct CpuFloat2
+ * @brief Pair of float values (e.g. depth/similarity, depth/thickness, depth/pixSize).
+ */
+struct CpuFloat2
+{
+    float x = 0.f;
+    float y = 0.f;
+};
+
+/**
+ * @class CpuMap
+ * @brief Host 2d buffer, row-major.
+ */
+template<typename T>
+class CpuMap
+{
+  public:
+    CpuMap() = default;
+    CpuMap(int width, int height) { resize(width, height); }
+
+    void resize(int width, int height)
+    {
+        _width = width;
+        _height = height;
+        _data.resize(static_cast<std::size_t>(width) * height);
+    }
+
+    void fill(const T& value) { std::fill(_data.begin(), _data.end(), value); }
+
+    inline int width() const { return _width; }
+    inline int height() const { return _height; }
+
+    inline T& operator()(int x, int y) { return _data[static_cast<std::size_t>(y) * _width + x]; }
+    inline const T& operator()(int x, int y) const { return _data[static_cast<std::size_t>(y) * _width + x]; }
+
+  private:
+    int _width = 0;
+    int _height = 0;
+    std::vector<T> _data;
+};
+
+/**
+ * @class CpuVolume
+ * @brief Host 3d buffer.
+ * @note Depths are the fastest varying dimension: the values of a pixel for all depths are contiguous,
+ *       so the per-pixel loops over depths (aggregation, best depth) are vectorized by the compiler.
+ */
+template<typename T>
+class CpuVolume
+{
+  public:
+    CpuVolume() = default;
+
+    void resize(int dimX, int dimY, int dimZ)
+    {
+        _dimX = dimX;
+        _dimY = dimY;
+        _dimZ = dimZ;
+        _data.resize(static_cast<std::size_t>(dimX) * dimY * dimZ);
+    }
+
+    void fill(const T& value) { std::fill(_data.begin(), _data.end(), value); }
+
+    inline int dimX() const { return _dimX; }
+    inline int dimY() const { return _dimY; }
+    inline int dimZ() const { return _dimZ; }
+
+    /// pointer to the values of the given pixel for all depths
+    inline T* column(int x, int y) { return _data.data() + (static_cast<std::size_t>(y) * _dimX + x) * _dimZ; }
+    inline const T* column(int x, int y) const { return _data.data() + (static_cast<std::size_t>(y) * _dimX + x) * _dimZ; }
+
+    inline T& operator()(int x, int y, int z) { return column(x, y)[z]; }
+    inline const T& operator()(int x, int y, int z) const { return column(x, y)[z]; }
+
+  private:
+    int _dimX = 0;
+    int _dimY = 0;
+    int _dimZ = 0;
+    std::vector<T> _data;
+};
+
+}  // namespace depthMap
+}  // namespace aliceVision
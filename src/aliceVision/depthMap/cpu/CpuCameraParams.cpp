@@ -0,0 +1,35 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2023 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "CpuCameraParams.hpp"
+
+namespace aliceVision {
+namespace depthMap {
+
+void fillCpuCameraParams(CpuCameraParams& out_cameraParams, int camId, int downscale, const mvsUtils::MultiViewParams& mp)
+{
+    Matrix3x3 scaleM;
+    scaleM.m11 = 1.0 / double(downscale);
+    scaleM.m12 = 0.0;
+    scaleM.m13 = 0.0;
+    scaleM.m21 = 0.0;
+    scaleM.m22 = 1.0 / double(downscale);
+    scaleM.m23 = 0.0;
+    scaleM.m31 = 0.0;
+    scaleM.m32 = 0.0;
+    scaleM.m33 = 1.0;
+
+    const Matrix3x3 K = scaleM * mp.KArr[camId];
+    const Matrix3x3 iK = K.inverse();
+
+    out_cameraParams.P = K * (mp.RArr[camId] | (Point3d(0.0, 0.0, 0.0) - mp.RArr[camId] * mp.CArr[camId]));
+    out_cameraParams.iP = mp.iRArr[camId] * iK;
+    out_cameraParams.C = mp.CArr[camId];
+    out_cameraParams.ZVect = (mp.iRArr[camId] * Point3d(0.0, 0.0, 1.0)).normalize();
+}
+
+}  // namespace depthMap
+}  // namespace aliceVision
@@ -0,0 +1,100 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2023 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <aliceVision/mvsData/geometry.hpp>
+#include <aliceVision/mvsData/Matrix3x3.hpp>
+#include <aliceVision/mvsData/Matrix3x4.hpp>
+#include <aliceVision/mvsData/Point2d.hpp>
+#include <aliceVision/mvsData/Point3d.hpp>
+#include <aliceVision/mvsUtils/MultiViewParams.hpp>
+
+namespace aliceVision {
+namespace depthMap {
+
+/**
+ * @struct CpuCameraParams
+ * @brief Camera parameters at a given downscale for the CPU depth map engine.
+ * @note Host counterpart of the DeviceCameraParams used by the CUDA kernels.
+ */
+struct CpuCameraParams
+{
+    Matrix3x4 P;    //< projection matrix at the given downscale
+    Matrix3x3 iP;   //< inverse of the projection matrix rotation part (iR * iK)
+    Point3d C;      //< camera center
+    Point3d ZVect;  //< camera optical axis
+};
+
+/**
+ * @brief Fill the CPU camera parameters of the given camera at the given downscale.
+ * @param[out] out_cameraParams the output camera parameters
+ * @param[in] camId the camera index
+ * @param[in] downscale the camera downscale factor
+ * @param[in] mp the multi-view parameters
+ */
+void fillCpuCameraParams(CpuCameraParams& out_cameraParams, int camId, int downscale, const mvsUtils::MultiViewParams& mp);
+
+/**
+ * @brief Project a 3d point with the given camera parameters.
+ */
+inline Point2d project3DPoint(const CpuCameraParams& camParams, const Point3d& p)
+{
+    const Point3d pp = camParams.P * p;
+    return Point2d(pp.x / pp.z, pp.y / pp.z);
+}
+
+/**
+ * @brief Get the 3d point of the given pixel on the given fronto-parallel plane depth.
+ */
+inline Point3d get3DPointForPixelAndFrontoParellePlaneRC(const CpuCameraParams& camParams, const Point2d& pix, float fpPlaneDepth)
+{
+    const Point3d planep = camParams.C + camParams.ZVect * fpPlaneDepth;
+    const Point3d v = (camParams.iP * pix).normalize();
+    return linePlaneIntersect(camParams.C, v, planep, camParams.ZVect);
+}
+
+/**
+ * @brief Get the 3d point of the given pixel at the given depth.
+ */
+inline Point3d get3DPointForPixelAndDepthFromRC(const CpuCameraParams& camParams, const Point2d& pix, float depth)
+{
+    const Point3d rpv = (camParams.iP * pix).normalize();
+    return camParams.C + rpv * depth;
+}
+
+/**
+ * @brief Convert a fronto-parallel plane depth to the depth of the given pixel.
+ */
+inline float depthPlaneToDepth(const CpuCameraParams& camParams, float fpPlaneDepth, const Point2d& pix)
+{
+    const Point3d planep = camParams.C + camParams.ZVect * fpPlaneDepth;
+    const Point3d v = (camParams.iP * pix).normalize();
+    const Point3d p = linePlaneIntersect(camParams.C, v, planep, camParams.ZVect);
+    return static_cast<float>((camParams.C - p).size());
+}
+
+/**
+ * @brief Compute the size of a pixel of the given camera at the given 3d point.
+ */
+inline float computePixSize(const CpuCameraParams& camParams, const Point3d& p)
+{
+    const Point2d rp = project3DPoint(camParams, p);
+    const Point3d refvect = (camParams.iP * Point2d(rp.x + 1.0, rp.y)).normalize();
+    return static_cast<float>(pointLineDistance3D(p, camParams.C, refvect));
+}
+
+/**
+ * @brief Move a 3d point along the camera ray by the given camera pixel size.
+ */
+inline void move3DPointByRcPixSize(Point3d& p, const CpuCameraParams& camParams, float rcPixSize)
+{
+    const Point3d rpv = (p - camParams.C).normalize();
+    p = p + rpv * rcPixSize;
+}
+
+}  // namespace depthMap
+}  // namespace aliceVision
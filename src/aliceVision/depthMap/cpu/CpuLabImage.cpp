@@ -0,0 +1,87 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2023 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "CpuLabImage.hpp"
+
+#include <aliceVision/alicevision_omp.hpp>
+#include <aliceVision/numeric/numeric.hpp>
+
+namespace aliceVision {
+namespace depthMap {
+
+namespace {
+
+/**
+ * @brief Linear RGB (0..1) to CIELAB (0..255)
+ * @note Same conversion as the CUDA rgb2lab kernel (whitepoint D65).
+ */
+inline CpuLabColor rgb2lab(float r, float g, float b, float alpha)
+{
+    // linear RGB to XYZ
+    const float x = 0.4124564f * r + 0.3575761f * g + 0.1804375f * b;
+    const float y = 0.2126729f * r + 0.7151522f * g + 0.0721750f * b;
+    const float z = 0.0193339f * r + 0.1191920f * g + 0.9503041f * b;
+
+    // XYZ to CIELAB
+    const auto f = [](float v) { return (v > 216.0f / 24389.0f) ? std::cbrt(v) : (24389.0f / 27.0f * v + 16.0f) / 116.0f; };
+
+    const float fx = f(x / 0.95047f);
+    const float fy = f(y);
+    const float fz = f(z / 1.08883f);
+
+    // convert values to fit into 0..255 (could be out-of-range)
+    CpuLabColor out;
+    out.l = (116.0f * fy - 16.0f) * 2.55f;
+    out.a = (500.0f * (fx - fy)) * 2.55f;
+    out.b = (200.0f * (fy - fz)) * 2.55f;
+    out.alpha = alpha * 255.0f;
+    return out;
+}
+
+}  // namespace
+
+void CpuLabImage::build(const image::Image<image::RGBAfColor>& in_img, int downscale)
+{
+    _downscale = std::max(1, downscale);
+    _width = divideRoundUp(in_img.Width(), _downscale);
+    _height = divideRoundUp(in_img.Height(), _downscale);
+    _data.resize(static_cast<std::size_t>(_width) * _height);
+
+    const int inWidth = in_img.Width();
+    const int inHeight = in_img.Height();
+
+#pragma omp parallel for
+    for (int y = 0; y < _height; ++y)
+    {
+        for (int x = 0; x < _width; ++x)
+        {
+            // box filter over the full-size pixels of the downscaled pixel
+            const int beginX = x * _downscale;
+            const int beginY = y * _downscale;
+            const int endX = std::min(beginX + _downscale, inWidth);
+            const int endY = std::min(beginY + _downscale, inHeight);
+
+            float r = 0.f, g = 0.f, b = 0.f, a = 0.f;
+            for (int iy = beginY; iy < endY; ++iy)
+            {
+                for (int ix = beginX; ix < endX; ++ix)
+                {
+                    const image::RGBAfColor& c = in_img(iy, ix);
+                    r += c.r();
+                    g += c.g();
+                    b += c.b();
+                    a += c.a();
+                }
+            }
+
+            const float invCount = 1.f / float((endX - beginX) * (endY - beginY));
+            _data[static_cast<std::size_t>(y) * _width + x] = rgb2lab(r * invCount, g * invCount, b * invCount, a * invCount);
+        }
+    }
+}
+
+}  // namespace depthMap
+}  // namespace aliceVision
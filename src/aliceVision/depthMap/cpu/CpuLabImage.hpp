@@ -0,0 +1,113 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2023 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <aliceVision/image/Image.hpp>
+#include <aliceVision/image/pixelTypes.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace aliceVision {
+namespace depthMap {
+
+/**
+ * @struct CpuLabColor
+ * @brief CIELAB color and alpha, in range (0, 255) like the device textures.
+ */
+struct CpuLabColor
+{
+    float l = 0.f;
+    float a = 0.f;
+    float b = 0.f;
+    float alpha = 0.f;
+};
+
+/**
+ * @class CpuLabImage
+ * @brief Downscaled CIELAB image for the CPU depth map engine.
+ * @note Host counterpart of a single level of the DeviceMipmapImage.
+ */
+class CpuLabImage
+{
+  public:
+    CpuLabImage() = default;
+
+    /**
+     * @brief Build the CIELAB image from the given linear RGBA image at the given downscale.
+     * @note The image is downscaled with a box filter then converted to CIELAB.
+     * @param[in] in_img the input full-size linear RGBA image in range (0, 1)
+     * @param[in] downscale the downscale factor
+     */
+    void build(const image::Image<image::RGBAfColor>& in_img, int downscale);
+
+    inline int width() const { return _width; }
+    inline int height() const { return _height; }
+    inline int downscale() const { return _downscale; }
+
+    /**
+     * @brief Get the color at the given pixel coordinates (clamped to the image borders).
+     */
+    inline const CpuLabColor& at(int x, int y) const
+    {
+        x = std::min(std::max(x, 0), _width - 1);
+        y = std::min(std::max(y, 0), _height - 1);
+        return _data[static_cast<std::size_t>(y) * _width + x];
+    }
+
+    /**
+     * @brief Bilinear sampling at the given pixel coordinates (pixel centers are integer coordinates).
+     * @note Same behavior as a linear filtering / clamp addressing texture.
+     */
+    inline CpuLabColor sample(float x, float y) const
+    {
+        const float fx = std::floor(x);
+        const float fy = std::floor(y);
+        const int x0 = static_cast<int>(fx);
+        const int y0 = static_cast<int>(fy);
+        const float dx = x - fx;
+        const float dy = y - fy;
+
+        const CpuLabColor& c00 = at(x0, y0);
+        const CpuLabColor& c10 = at(x0 + 1, y0);
+        const CpuLabColor& c01 = at(x0, y0 + 1);
+        const CpuLabColor& c11 = at(x0 + 1, y0 + 1);
+
+        const float w00 = (1.f - dx) * (1.f - dy);
+        const float w10 = dx * (1.f - dy);
+        const float w01 = (1.f - dx) * dy;
+        const float w11 = dx * dy;
+
+        CpuLabColor out;
+        out.l = w00 * c00.l + w10 * c10.l + w01 * c01.l + w11 * c11.l;
+        out.a = w00 * c00.a + w10 * c10.a + w01 * c01.a + w11 * c11.a;
+        out.b = w00 * c00.b + w10 * c10.b + w01 * c01.b + w11 * c11.b;
+        out.alpha = w00 * c00.alpha + w10 * c10.alpha + w01 * c01.alpha + w11 * c11.alpha;
+        return out;
+    }
+
+  private:
+    int _width = 0;
+    int _height = 0;
+    int _downscale = 1;
+    std::vector<CpuLabColor> _data;
+};
+
+/**
+ * @brief Euclidean distance between two CIELAB colors (alpha is ignored).
+ */
+inline float labColorDistance(const CpuLabColor& c1, const CpuLabColor& c2)
+{
+    const float dl = c1.l - c2.l;
+    const float da = c1.a - c2.a;
+    const float db = c1.b - c2.b;
+    return std::sqrt(dl * dl + da * da + db * db);
+}
+
+}  // namespace depthMap
+}  // namespace aliceVision
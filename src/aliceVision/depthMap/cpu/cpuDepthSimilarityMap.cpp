@@ -0,0 +1,201 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2023 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "cpuDepthSimilarityMap.hpp"
+
+#include <aliceVision/alicevision_omp.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace aliceVision {
+namespace depthMap {
+
+void cpu_depthThicknessSmoothThickness(CpuMap<CpuFloat2>& inout_depthThicknessMap_cpu,
+                                       const SgmParams& sgmParams,
+                                       const RefineParams& refineParams,
+                                       const ROI& roi)
+{
+    const int sgmScaleStep = sgmParams.scale * sgmParams.stepXY;
+    const int refineScaleStep = refineParams.scale * refineParams.stepXY;
+
+    // min/max number of Refine samples in SGM thickness area
+    const float minNbRefineSamples = 2.f;
+    const float maxNbRefineSamples = std::max(sgmScaleStep / float(refineScaleStep), minNbRefineSamples);
+
+    // min/max SGM thickness inflate factor
+    const float minThicknessInflate = refineParams.halfNbDepths / maxNbRefineSamples;
+    const float maxThicknessInflate = refineParams.halfNbDepths / minNbRefineSamples;
+
+    const int roiWidth = int(roi.width());
+    const int roiHeight = int(roi.height());
+
+    // the GPU kernel reads the input thicknesses while writing the output ones,
+    // only the depths are read from the neighbors so the in-place update is safe
+#pragma omp parallel for
+    for (int roiY = 0; roiY < roiHeight; ++roiY)
+    {
+        for (int roiX = 0; roiX < roiWidth; ++roiX)
+        {
+            // corresponding output depth/thickness (depth unchanged)
+            CpuFloat2& inout_depthThickness = inout_depthThicknessMap_cpu(roiX, roiY);
+
+            // depth invalid or masked
+            if (inout_depthThickness.x <= 0.0f)
+                continue;
+
+            const float minThickness = minThicknessInflate * inout_depthThickness.y;
+            const float maxThickness = maxThicknessInflate * inout_depthThickness.y;
+
+            // compute average depth distance to the center pixel
+            float sumCenterDepthDist = 0.f;
+            int nbValidPatchPixels = 0;
+
+            // patch 3x3
+            for (int yp = -1; yp <= 1; ++yp)
+            {
+                for (int xp = -1; xp <= 1; ++xp)
+                {
+                    // compute patch coordinates
+                    const int roiXp = roiX + xp;
+                    const int roiYp = roiY + yp;
+
+                    if ((xp == 0 && yp == 0) ||                  // avoid pixel center
+                        roiXp < 0 || roiXp >= roiWidth ||        // avoid pixel outside the ROI
+                        roiYp < 0 || roiYp >= roiHeight)         // avoid pixel outside the ROI
+                    {
+                        continue;
+                    }
+
+                    // corresponding patch depth
+                    const float patchDepth = inout_depthThicknessMap_cpu(roiXp, roiYp).x;
+
+                    // patch depth valid
+                    if (patchDepth > 0.0f)
+                    {
+                        const float depthDistance = std::abs(inout_depthThickness.x - patchDepth);
+                        sumCenterDepthDist += std::max(minThickness, std::min(maxThickness, depthDistance));  // clamp (minThickness, maxThickness)
+                        ++nbValidPatchPixels;
+                    }
+                }
+            }
+
+            // we require at least 3 valid patch pixels (over 8)
+            if (nbValidPatchPixels < 3)
+                continue;
+
+            // write output smooth thickness
+            inout_depthThickness.y = sumCenterDepthDist / nbValidPatchPixels;
+        }
+    }
+}
+
+void cpu_computeSgmUpscaledDepthPixSizeMap(CpuMap<CpuFloat2>& out_upscaledDepthPixSizeMap_cpu,
+                                           const CpuMap<CpuFloat2>& in_sgmDepthThicknessMap_cpu,
+                                           const CpuLabImage& rcImage,
+                                           const RefineParams& refineParams,
+                                           const ROI& roi)
+{
+    // compute upscale ratio
+    const float ratio = float(in_sgmDepthThicknessMap_cpu.width()) / float(out_upscaledDepthPixSizeMap_cpu.width());
+
+    const int roiWidth = int(roi.width());
+    const int roiHeight = int(roi.height());
+    const int inMaxX = in_sgmDepthThicknessMap_cpu.width() - 1;
+    const int inMaxY = in_sgmDepthThicknessMap_cpu.height() - 1;
+    const float halfNbDepths = float(refineParams.halfNbDepths);
+
+#pragma omp parallel for
+    for (int roiY = 0; roiY < roiHeight; ++roiY)
+    {
+        for (int roiX = 0; roiX < roiWidth; ++roiX)
+        {
+            // corresponding image coordinates
+            const int x = (roi.x.begin + roiX) * refineParams.stepXY;
+            const int y = (roi.y.begin + roiY) * refineParams.stepXY;
+
+            // corresponding output upscaled depth/pixSize map
+            CpuFloat2& out_depthPixSize = out_upscaledDepthPixSizeMap_cpu(roiX, roiY);
+
+            // filter masked pixels with alpha
+            if (rcImage.at(x, y).alpha < CPU_DEPTHMAP_RC_MIN_ALPHA)
+            {
+                out_depthPixSize = {-2.f, 0.f};
+                continue;
+            }
+
+            const float oy = (float(roiY) - 0.5f) * ratio;
+            const float ox = (float(roiX) - 0.5f) * ratio;
+
+            // find corresponding depth/thickness
+            CpuFloat2 out_depthThickness;
+
+            if (refineParams.interpolateMiddleDepth)
+            {
+                // find adjacent pixels
+                const int xp = std::max(0, std::min(int(std::floor(ox)), inMaxX - 1));
+                const int yp = std::max(0, std::min(int(std::floor(oy)), inMaxY - 1));
+
+                const CpuFloat2& lu = in_sgmDepthThicknessMap_cpu(xp, yp);
+                const CpuFloat2& ru = in_sgmDepthThicknessMap_cpu(std::min(xp + 1, inMaxX), yp);
+                const CpuFloat2& rd = in_sgmDepthThicknessMap_cpu(std::min(xp + 1, inMaxX), std::min(yp + 1, inMaxY));
+                const CpuFloat2& ld = in_sgmDepthThicknessMap_cpu(xp, std::min(yp + 1, inMaxY));
+
+                if (lu.x <= 0.0f || ru.x <= 0.0f || rd.x <= 0.0f || ld.x <= 0.0f)
+                {
+                    // at least one corner depth is invalid
+                    // average the other corners to get a proper depth/thickness
+                    CpuFloat2 sumDepthThickness;
+                    int count = 0;
+
+                    for (const CpuFloat2* corner : {&lu, &ru, &rd, &ld})
+                    {
+                        if (corner->x > 0.0f)
+                        {
+                            sumDepthThickness.x += corner->x;
+                            sumDepthThickness.y += corner->y;
+                            ++count;
+                        }
+                    }
+
+                    if (count == 0)
+                    {
+                        // invalid depth
+                        out_depthPixSize = {-1.0f, 1.0f};
+                        continue;
+                    }
+
+                    out_depthThickness = {sumDepthThickness.x / float(count), sumDepthThickness.y / float(count)};
+                }
+                else
+                {
+                    // bilinear interpolation
+                    const float ui = std::max(0.f, ox - float(xp));
+                    const float vi = std::max(0.f, oy - float(yp));
+                    const float ux = lu.x + (ru.x - lu.x) * ui;
+                    const float uy = lu.y + (ru.y - lu.y) * ui;
+                    const float dx = ld.x + (rd.x - ld.x) * ui;
+                    const float dy = ld.y + (rd.y - ld.y) * ui;
+                    out_depthThickness = {ux + (dx - ux) * vi, uy + (dy - uy) * vi};
+                }
+            }
+            else
+            {
+                // nearest neighbor, no interpolation
+                const int xp = std::max(0, std::min(int(std::floor(ox + 0.5f)), inMaxX));
+                const int yp = std::max(0, std::min(int(std::floor(oy + 0.5f)), inMaxY));
+
+                out_depthThickness = in_sgmDepthThicknessMap_cpu(xp, yp);
+            }
+
+            // write output depth/pixSize, pixSize computed from depth thickness
+            out_depthPixSize = {out_depthThickness.x, out_depthThickness.y / halfNbDepths};
+        }
+    }
+}
+
+}  // namespace depthMap
+}  // namespace aliceVision
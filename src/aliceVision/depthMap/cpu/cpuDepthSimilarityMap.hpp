@@ -0,0 +1,47 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2023 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <aliceVision/mvsData/ROI.hpp>
+#include <aliceVision/depthMap/SgmParams.hpp>
+#include <aliceVision/depthMap/RefineParams.hpp>
+#include <aliceVision/depthMap/cpu/CpuBuffer.hpp>
+#include <aliceVision/depthMap/cpu/CpuLabImage.hpp>
+
+namespace aliceVision {
+namespace depthMap {
+
+/**
+ * @brief Smooth the thickness of the given depth/thickness map with the adjacent pixels.
+ * @note CPU implementation of cuda_depthThicknessSmoothThickness.
+ * @param[in,out] inout_depthThicknessMap_cpu the depth/thickness map
+ * @param[in] sgmParams the Semi Global Matching parameters
+ * @param[in] refineParams the Refine parameters
+ * @param[in] roi the 2d region of interest, downscaled by the SGM scale x stepXY
+ */
+void cpu_depthThicknessSmoothThickness(CpuMap<CpuFloat2>& inout_depthThicknessMap_cpu,
+                                       const SgmParams& sgmParams,
+                                       const RefineParams& refineParams,
+                                       const ROI& roi);
+
+/**
+ * @brief Upscale the given SGM depth/thickness map, filter masked pixels and compute pixSize from thickness.
+ * @note CPU implementation of cuda_computeSgmUpscaledDepthPixSizeMap.
+ * @param[out] out_upscaledDepthPixSizeMap_cpu the output upscaled depth/pixSize map
+ * @param[in] in_sgmDepthThicknessMap_cpu the input SGM depth/thickness map
+ * @param[in] rcImage the R camera CIELAB image at Refine scale
+ * @param[in] refineParams the Refine parameters
+ * @param[in] roi the 2d region of interest, downscaled by the Refine scale x stepXY
+ */
+void cpu_computeSgmUpscaledDepthPixSizeMap(CpuMap<CpuFloat2>& out_upscaledDepthPixSizeMap_cpu,
+                                           const CpuMap<CpuFloat2>& in_sgmDepthThicknessMap_cpu,
+                                           const CpuLabImage& rcImage,
+                                           const RefineParams& refineParams,
+                                           const ROI& roi);
+
+}  // namespace depthMap
+}  // namespace aliceVision
@@ -0,0 +1,619 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2023 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "cpuSimilarityVolume.hpp"
+
+#include <aliceVision/alicevision_omp.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace aliceVision {
+namespace depthMap {
+
+namespace {
+
+constexpr float invalidSimilarity = std::numeric_limits<float>::infinity();
+
+/**
+ * @struct CpuPatch
+ * @brief Oriented patch around a 3d point (see cuda/device/Patch.cuh).
+ */
+struct CpuPatch
+{
+    Point3d p;  //< 3d point
+    Point3d n;  //< normal
+    Point3d x;  //< x axis
+    Point3d y;  //< y axis
+    double d;   //< pixel size
+};
+
+/**
+ * @struct CpuSimStat
+ * @brief Weighted Normalized Cross-Correlation accumulator (see cuda/device/SimStat.cuh).
+ */
+struct CpuSimStat
+{
+    float xsum = 0.f;
+    float ysum = 0.f;
+    float xxsum = 0.f;
+    float yysum = 0.f;
+    float xysum = 0.f;
+    float wsum = 0.f;
+
+    inline void update(float gx, float gy, float w)
+    {
+        wsum += w;
+        xsum += w * gx;
+        ysum += w * gy;
+        xxsum += w * gx * gx;
+        yysum += w * gy * gy;
+        xysum += w * gx * gy;
+    }
+
+    /**
+     * @brief Compute Normalized Cross-Correlation.
+     * @return similarity value in range (-1, 0) or 1 if infinity
+     */
+    inline float computeWSim() const
+    {
+        const float varX = (xxsum - xsum * xsum / wsum) / wsum;
+        const float varY = (yysum - ysum * ysum / wsum) / wsum;
+        const float varXY = (xysum - xsum * ysum / wsum) / wsum;
+        const float rawSim = varXY / std::sqrt(varX * varY);
+        return std::isfinite(rawSim) ? -rawSim : 1.0f;
+    }
+};
+
+inline float sigmoid(float zeroVal, float endVal, float sigwidth, float sigMid, float xval)
+{
+    return zeroVal + (endVal - zeroVal) * (1.0f / (1.0f + std::exp(10.0f * ((xval - sigMid) / sigwidth))));
+}
+
+/**
+ * @brief Adaptive support-weight (Yoon & Kweon) of a patch pixel.
+ */
+inline float costYKfromLab(int dx, int dy, const CpuLabColor& c1, const CpuLabColor& c2, float invGammaC, float invGammaP)
+{
+    const float deltaC = labColorDistance(c1, c2) * invGammaC;
+    const float deltaP = std::sqrt(float(dx * dx + dy * dy)) * invGammaP;
+    return std::exp(-(deltaC + deltaP));
+}
+
+/**
+ * @brief Compute the patch coordinate system, x and n on the epipolar plane.
+ */
+inline void computeRotCSEpip(CpuPatch& patch, const CpuCameraParams& rcCamParams, const CpuCameraParams& tcCamParams)
+{
+    const Point3d v1 = (rcCamParams.C - patch.p).normalize();
+    const Point3d v2 = (tcCamParams.C - patch.p).normalize();
+
+    patch.y = cross(v1, v2).normalize();
+    patch.n = ((v1 + v2) / 2.0).normalize();
+    patch.x = cross(patch.y, patch.n).normalize();
+}
+
+/**
+ * @brief Compute Normalized Cross-Correlation of a full square patch at given half-width.
+ * @note CPU implementation of compNCCby3DptsYK (see cuda/device/Patch.cuh).
+ * @tparam TInvertAndFilter invert and filter output similarity value
+ * @return similarity value in range (-1.f, 0.f) or (0.f, 1.f) if TInvertAndFilter enabled
+ *         or invalidSimilarity for invalid/masked patch
+ */
+template<bool TInvertAndFilter>
+float compNCCby3DptsYK(const CpuCameraParams& rcCamParams,
+                       const CpuCameraParams& tcCamParams,
+                       const CpuLabImage& rcImage,
+                       const CpuLabImage& tcImage,
+                       int wsh,
+                       float invGammaC,
+                       float invGammaP,
+                       const CpuPatch& patch)
+{
+    // get R and T image 2d coordinates from patch center 3d point
+    const Point2d rp = project3DPoint(rcCamParams, patch.p);
+    const Point2d tp = project3DPoint(tcCamParams, patch.p);
+
+    // image 2d coordinates margin
+    const double dd = wsh + 2.0;
+
+    // check R and T image 2d coordinates
+    if ((rp.x < dd) || (rp.x > double(rcImage.width() - 1) - dd) || (tp.x < dd) || (tp.x > double(tcImage.width() - 1) - dd) ||
+        (rp.y < dd) || (rp.y > double(rcImage.height() - 1) - dd) || (tp.y < dd) || (tp.y > double(tcImage.height() - 1) - dd))
+    {
+        return invalidSimilarity;  // uninitialized
+    }
+
+    // compute patch center color (CIELAB)
+    const CpuLabColor rcCenterColor = rcImage.sample(float(rp.x), float(rp.y));
+    const CpuLabColor tcCenterColor = tcImage.sample(float(tp.x), float(tp.y));
+
+    // check the alpha values of the patch pixel center of the R and T cameras
+    if (rcCenterColor.alpha < CPU_DEPTHMAP_RC_MIN_ALPHA || tcCenterColor.alpha < CPU_DEPTHMAP_TC_MIN_ALPHA)
+        return invalidSimilarity;  // masked
+
+    CpuSimStat sst;
+
+    // compute patch (wsh*2+1)x(wsh*2+1)
+    for (int yp = -wsh; yp <= wsh; ++yp)
+    {
+        for (int xp = -wsh; xp <= wsh; ++xp)
+        {
+            // get 3d point
+            const Point3d p = patch.p + patch.x * (patch.d * double(xp)) + patch.y * (patch.d * double(yp));
+
+            // get R and T image color (CIELAB) from 3d point
+            const Point2d rpc = project3DPoint(rcCamParams, p);
+            const Point2d tpc = project3DPoint(tcCamParams, p);
+            const CpuLabColor rcPatchCoordColor = rcImage.sample(float(rpc.x), float(rpc.y));
+            const CpuLabColor tcPatchCoordColor = tcImage.sample(float(tpc.x), float(tpc.y));
+
+            // weighting based on color difference and distance to the center pixel of the patch
+            const float w = costYKfromLab(xp, yp, rcCenterColor, rcPatchCoordColor, invGammaC, invGammaP) *
+                            costYKfromLab(xp, yp, tcCenterColor, tcPatchCoordColor, invGammaC, invGammaP);
+
+            sst.update(rcPatchCoordColor.l, tcPatchCoordColor.l, w);
+        }
+    }
+
+    if (TInvertAndFilter)
+    {
+        // invert and filter similarity
+        // best similarity value was -1, worst was 0
+        // best similarity value is 1, worst is still 0
+        return sigmoid(0.0f, 1.0f, 0.7f, -0.7f, sst.computeWSim());
+    }
+
+    return sst.computeWSim();
+}
+
+/**
+ * @brief Aggregate the similarity volume along one path direction.
+ * @note CPU implementation of cuda_volumeAggregatePath: each line of the volume is an independent path.
+ * @param[in,out] inout_volAgr_cpu the aggregated similarity volume (running average over the paths)
+ * @param[in] in_volSim_cpu the input similarity volume
+ * @param[in] rcImage the R camera CIELAB image at SGM scale
+ * @param[in] sgmParams the Semi Global Matching parameters
+ * @param[in] volDimZ the number of depths to aggregate
+ * @param[in] alongX the path goes along the X axis (otherwise along the Y axis)
+ * @param[in] invDir the path goes in the decreasing coordinates direction
+ * @param[in] filteringIndex the index of the path (for the running average)
+ * @param[in] roi the 2d region of interest, downscaled by the SGM scale x stepXY
+ */
+void volumeAggregatePath(CpuVolume<TSimCpu>& inout_volAgr_cpu,
+                         const CpuVolume<TSimCpu>& in_volSim_cpu,
+                         const CpuLabImage& rcImage,
+                         const SgmParams& sgmParams,
+                         int volDimZ,
+                         bool alongX,
+                         bool invDir,
+                         int filteringIndex,
+                         const ROI& roi)
+{
+    const int nbLines = alongX ? in_volSim_cpu.dimY() : in_volSim_cpu.dimX();
+    const int lineLength = alongX ? in_volSim_cpu.dimX() : in_volSim_cpu.dimY();
+    const int stepXY = sgmParams.stepXY;
+    const float P1 = float(sgmParams.p1);
+    const float _P2 = float(sgmParams.p2Weighting);
+    const float invFilteringCount = 1.f / float(filteringIndex + 1);
+
+#pragma omp parallel
+    {
+        std::vector<TSimAccCpu> pathCostsPrev(volDimZ);  // path costs of the previous path position
+        std::vector<TSimAccCpu> pathCosts(volDimZ);      // path costs of the current path position
+
+#pragma omp for schedule(dynamic, 16)
+        for (int line = 0; line < nbLines; ++line)
+        {
+            // volume coordinates of the i-th position of the path
+            const auto pathVoxel = [&](int i, int& vx, int& vy) {
+                const int p = invDir ? (lineLength - 1 - i) : i;
+                vx = alongX ? p : line;
+                vy = alongX ? line : p;
+            };
+
+            int vx, vy;
+            pathVoxel(0, vx, vy);
+
+            // first path position: path costs are the similarity values
+            {
+                const TSimCpu* simColumn = in_volSim_cpu.column(vx, vy);
+                TSimCpu* agrColumn = inout_volAgr_cpu.column(vx, vy);
+
+                for (int z = 0; z < volDimZ; ++z)
+                {
+                    pathCostsPrev[z] = TSimAccCpu(simColumn[z]);
+                    agrColumn[z] = TSimCpu(255);
+                }
+            }
+
+            for (int i = 1; i < lineLength; ++i)
+            {
+                const int prevX = vx;
+                const int prevY = vy;
+                pathVoxel(i, vx, vy);
+
+                // best path cost of the previous path position
+                TSimAccCpu bestCostM1 = pathCostsPrev[0];
+                for (int z = 1; z < volDimZ; ++z)
+                    bestCostM1 = std::min(bestCostM1, pathCostsPrev[z]);
+
+                // P2 penalty, weighted by the R image color difference along the path
+                float P2 = 0.f;
+                if (_P2 < 0.f)
+                {
+                    // _P2 convention: use negative value to skip the use of deltaC.
+                    P2 = std::abs(_P2);
+                }
+                else
+                {
+                    const CpuLabColor& gcr0 = rcImage.at((roi.x.begin + vx) * stepXY, (roi.y.begin + vy) * stepXY);
+                    const CpuLabColor& gcr1 = rcImage.at((roi.x.begin + prevX) * stepXY, (roi.y.begin + prevY) * stepXY);
+                    const float deltaC = labColorDistance(gcr0, gcr1);
+
+                    // best values found from tests: i = 80, a = 255, w = 80, P2 = 100
+                    P2 = sigmoid(80.f, 255.f, 80.f, _P2, deltaC);
+                }
+
+                const TSimCpu* simColumn = in_volSim_cpu.column(vx, vy);
+                TSimCpu* agrColumn = inout_volAgr_cpu.column(vx, vy);
+                const float fBestCostM1 = float(bestCostM1);
+
+                // first and last depths are not aggregated
+                pathCosts[0] = TSimAccCpu(255);
+                pathCosts[volDimZ - 1] = TSimAccCpu(255);
+                agrColumn[0] = TSimCpu((float(agrColumn[0]) * float(filteringIndex) + 255.f) * invFilteringCount);
+                agrColumn[volDimZ - 1] = TSimCpu((float(agrColumn[volDimZ - 1]) * float(filteringIndex) + 255.f) * invFilteringCount);
+
+#pragma omp simd
+                for (int z = 1; z < volDimZ - 1; ++z)
+                {
+                    const float minCost = std::min(std::min(float(pathCostsPrev[z]), float(pathCostsPrev[z - 1]) + P1),
+                                                   std::min(float(pathCostsPrev[z + 1]) + P1, fBestCostM1 + P2));
+
+                    const float pathCost = float(simColumn[z]) + minCost - fBestCostM1;
+
+                    // path cost is lower than 255 + P2, clamp to the TSimAccCpu range for huge user P2
+                    pathCosts[z] = TSimAccCpu(std::min(65535.0f, pathCost));
+
+                    // aggregate into the final output (running average over the paths)
+                    const float clampedPathCost = std::min(255.0f, std::max(0.0f, pathCost));
+                    agrColumn[z] = TSimCpu((float(agrColumn[z]) * float(filteringIndex) + clampedPathCost) * invFilteringCount);
+                }
+
+                std::swap(pathCostsPrev, pathCosts);
+            }
+        }
+    }
+}
+
+}  // namespace
+
+void cpu_volumeComputeSimilarity(CpuVolume<TSimCpu>& inout_volBestSim_cpu,
+                                 CpuVolume<TSimCpu>& inout_volSecBestSim_cpu,
+                                 const std::vector<float>& in_depths,
+                                 const CpuCameraParams& rcCamParams,
+                                 const CpuCameraParams& tcCamParams,
+                                 const CpuLabImage& rcImage,
+                                 const CpuLabImage& tcImage,
+                                 const SgmParams& sgmParams,
+                                 const Range& depthRange,
+                                 const ROI& roi)
+{
+    const int roiWidth = int(roi.width());
+    const int roiHeight = int(roi.height());
+    const float invGammaC = 1.f / float(sgmParams.gammaC);
+    const float invGammaP = 1.f / float(sgmParams.gammaP);
+
+    // we do not need positive and filtered similarity values
+    constexpr bool invertAndFilter = false;
+
+#pragma omp parallel for schedule(dynamic)
+    for (int vy = 0; vy < roiHeight; ++vy)
+    {
+        for (int vx = 0; vx < roiWidth; ++vx)
+        {
+            // corresponding image coordinates
+            const Point2d pix(double(roi.x.begin + vx) * sgmParams.stepXY, double(roi.y.begin + vy) * sgmParams.stepXY);
+
+            TSimCpu* bestSimColumn = inout_volBestSim_cpu.column(vx, vy);
+            TSimCpu* secBestSimColumn = inout_volSecBestSim_cpu.column(vx, vy);
+
+            for (int vz = int(depthRange.begin); vz < int(depthRange.end); ++vz)
+            {
+                // compute patch
+                CpuPatch patch;
+                patch.p = get3DPointForPixelAndFrontoParellePlaneRC(rcCamParams, pix, in_depths[vz]);
+                patch.d = computePixSize(rcCamParams, patch.p);
+                computeRotCSEpip(patch, rcCamParams, tcCamParams);
+
+                float fsim = compNCCby3DptsYK<invertAndFilter>(
+                  rcCamParams, tcCamParams, rcImage, tcImage, sgmParams.wsh, invGammaC, invGammaP, patch);
+
+                if (fsim == invalidSimilarity)
+                {
+                    fsim = 255.0f;  // 255 is the invalid similarity value
+                }
+                else
+                {
+                    // remap similarity value from (-1, 1) to (0, 254)
+                    // 255 is reserved for the similarity initialization, i.e. undefined values
+                    fsim = std::min(1.0f, std::max(0.0f, (fsim + 1.0f) * 0.5f)) * 254.0f;
+                }
+
+                if (fsim < bestSimColumn[vz])
+                {
+                    secBestSimColumn[vz] = bestSimColumn[vz];
+                    bestSimColumn[vz] = TSimCpu(fsim);
+                }
+                else if (fsim < secBestSimColumn[vz])
+                {
+                    secBestSimColumn[vz] = TSimCpu(fsim);
+                }
+            }
+        }
+    }
+}
+
+void cpu_volumeUpdateUninitializedSimilarity(const CpuVolume<TSimCpu>& in_volBestSim_cpu, CpuVolume<TSimCpu>& inout_volSecBestSim_cpu)
+{
+    const int dimX = in_volBestSim_cpu.dimX();
+    const int dimY = in_volBestSim_cpu.dimY();
+    const int dimZ = in_volBestSim_cpu.dimZ();
+
+#pragma omp parallel for
+    for (int vy = 0; vy < dimY; ++vy)
+    {
+        for (int vx = 0; vx < dimX; ++vx)
+        {
+            const TSimCpu* bestSimColumn = in_volBestSim_cpu.column(vx, vy);
+            TSimCpu* secBestSimColumn = inout_volSecBestSim_cpu.column(vx, vy);
+
+#pragma omp simd
+            for (int vz = 0; vz < dimZ; ++vz)
+            {
+                // invalid or uninitialized similarity value
+                if (secBestSimColumn[vz] >= 255)
+                    secBestSimColumn[vz] = bestSimColumn[vz];
+            }
+        }
+    }
+}
+
+void cpu_volumeOptimize(CpuVolume<TSimCpu>& out_volSimFiltered_cpu,
+                        const CpuVolume<TSimCpu>& in_volSim_cpu,
+                        const CpuLabImage& rcImage,
+                        const SgmParams& sgmParams,
+                        int lastDepthIndex,
+                        const ROI& roi)
+{
+    const int volDimZ = std::min(lastDepthIndex, in_volSim_cpu.dimZ());
+
+    if (volDimZ < 1)
+        return;
+
+    int filteringIndex = 0;
+
+    for (const char axis : sgmParams.filteringAxes)
+    {
+        if (axis != 'X' && axis != 'Y')
+            continue;
+
+        const bool alongX = (axis == 'X');
+
+        volumeAggregatePath(out_volSimFiltered_cpu, in_volSim_cpu, rcImage, sgmParams, volDimZ, alongX, false, filteringIndex++, roi);
+        volumeAggregatePath(out_volSimFiltered_cpu, in_volSim_cpu, rcImage, sgmParams, volDimZ, alongX, true, filteringIndex++, roi);
+    }
+}
+
+void cpu_volumeRetrieveBestDepth(CpuMap<CpuFloat2>& out_sgmDepthThicknessMap_cpu,
+                                 CpuMap<CpuFloat2>* out_sgmDepthSimMap_cpu,
+                                 const std::vector<float>& in_depths,
+                                 const CpuVolume<TSimCpu>& in_volSim_cpu,
+                                 const CpuCameraParams& rcCamParams,
+                                 const SgmParams& sgmParams,
+                                 const Range& depthRange,
+                                 const ROI& roi)
+{
+    const int roiWidth = int(roi.width());
+    const int roiHeight = int(roi.height());
+    const int volDimZ = in_volSim_cpu.dimZ();
+    const int scaleStep = sgmParams.scale * sgmParams.stepXY;
+    const float thicknessMultFactor = 1.f + float(sgmParams.depthThicknessInflate);
+    const float maxSimilarity = float(sgmParams.maxSimilarity) * 254.f;  // convert from (0, 1) to (0, 254)
+
+#pragma omp parallel for
+    for (int vy = 0; vy < roiHeight; ++vy)
+    {
+        for (int vx = 0; vx < roiWidth; ++vx)
+        {
+            // corresponding image coordinates
+            const Point2d pix(double((roi.x.begin + vx) * scaleStep), double((roi.y.begin + vy) * scaleStep));
+
+            CpuFloat2& out_bestDepthThickness = out_sgmDepthThicknessMap_cpu(vx, vy);
+            CpuFloat2* out_bestDepthSimPtr = (out_sgmDepthSimMap_cpu == nullptr) ? nullptr : &(*out_sgmDepthSimMap_cpu)(vx, vy);
+
+            // find the best depth plane index for the current pixel
+            // - best possible similarity value is 0
+            // - worst possible similarity value is 254
+            // - invalid similarity value is 255
+            const TSimCpu* simColumn = in_volSim_cpu.column(vx, vy);
+            float bestSim = 255.f;
+            int bestZIdx = -1;
+
+            for (int vz = int(depthRange.begin); vz < int(depthRange.end); ++vz)
+            {
+                const float simAtZ = float(simColumn[vz]);
+
+                if (simAtZ < bestSim)
+                {
+                    bestSim = simAtZ;
+                    bestZIdx = vz;
+                }
+            }
+
+            // filtering out invalid values and values with a too bad score
+            if ((bestZIdx == -1) || (bestSim > maxSimilarity))
+            {
+                out_bestDepthThickness = {-1.f, -1.f};  // invalid depth / thickness
+
+                if (out_bestDepthSimPtr != nullptr)
+                    *out_bestDepthSimPtr = {-1.f, 1.f};  // invalid depth, worst similarity value
+                continue;
+            }
+
+            // find best depth plane previous and next indexes
+            const int bestZIdx_m1 = std::max(0, bestZIdx - 1);
+            const int bestZIdx_p1 = std::min(volDimZ - 1, bestZIdx + 1);
+
+            const float bestDepth = depthPlaneToDepth(rcCamParams, in_depths[bestZIdx], pix);
+            const float bestDepth_m1 = depthPlaneToDepth(rcCamParams, in_depths[bestZIdx_m1], pix);
+            const float bestDepth_p1 = depthPlaneToDepth(rcCamParams, in_depths[bestZIdx_p1], pix);
+
+            const float out_bestSim = (bestSim / 255.0f) * 2.0f - 1.0f;  // convert from (0, 255) to (-1, +1)
+
+            // thickness is the maximum distance between output best depth and previous or next depth
+            const float out_bestDepthThickness_y = std::max(bestDepth_p1 - bestDepth, bestDepth - bestDepth_m1) * thicknessMultFactor;
+
+            out_bestDepthThickness = {bestDepth, out_bestDepthThickness_y};
+
+            if (out_bestDepthSimPtr != nullptr)
+                *out_bestDepthSimPtr = {bestDepth, out_bestSim};
+        }
+    }
+}
+
+void cpu_volumeRefineSimilarity(CpuVolume<TSimRefineCpu>& inout_volSim_cpu,
+                                const CpuMap<CpuFloat2>& in_sgmDepthPixSizeMap_cpu,
+                                const CpuCameraParams& rcCamParams,
+                                const CpuCameraParams& tcCamParams,
+                                const CpuLabImage& rcImage,
+                                const CpuLabImage& tcImage,
+                                const RefineParams& refineParams,
+                                const Range& depthRange,
+                                const ROI& roi)
+{
+    const int roiWidth = int(roi.width());
+    const int roiHeight = int(roi.height());
+    const int volDimZ = inout_volSim_cpu.dimZ();
+    const float invGammaC = 1.f / float(refineParams.gammaC);
+    const float invGammaP = 1.f / float(refineParams.gammaP);
+
+    // we need positive and filtered similarity values
+    constexpr bool invertAndFilter = true;
+
+#pragma omp parallel for schedule(dynamic)
+    for (int vy = 0; vy < roiHeight; ++vy)
+    {
+        for (int vx = 0; vx < roiWidth; ++vx)
+        {
+            // corresponding input sgm depth/pixSize (middle depth)
+            const CpuFloat2& in_sgmDepthPixSize = in_sgmDepthPixSizeMap_cpu(vx, vy);
+
+            // sgm depth (middle depth) invalid or masked
+            if (in_sgmDepthPixSize.x <= 0.0f)
+                continue;
+
+            // corresponding image coordinates
+            const Point2d pix(double(roi.x.begin + vx) * refineParams.stepXY, double(roi.y.begin + vy) * refineParams.stepXY);
+
+            TSimRefineCpu* simColumn = inout_volSim_cpu.column(vx, vy);
+
+            for (int vz = int(depthRange.begin); vz < int(depthRange.end); ++vz)
+            {
+                // initialize rc 3d point at sgm depth (middle depth)
+                Point3d p = get3DPointForPixelAndDepthFromRC(rcCamParams, pix, in_sgmDepthPixSize.x);
+
+                // move rc 3d point by relative depth index offset * sgm pixSize
+                const int relativeDepthIndexOffset = vz - ((volDimZ - 1) / 2);
+                if (relativeDepthIndexOffset != 0)
+                    move3DPointByRcPixSize(p, rcCamParams, relativeDepthIndexOffset * in_sgmDepthPixSize.y);
+
+                // compute patch
+                CpuPatch patch;
+                patch.p = p;
+                patch.d = computePixSize(rcCamParams, p);
+                computeRotCSEpip(patch, rcCamParams, tcCamParams);
+
+                const float fsimInvertedFiltered = compNCCby3DptsYK<invertAndFilter>(
+                  rcCamParams, tcCamParams, rcImage, tcImage, refineParams.wsh, invGammaC, invGammaP, patch);
+
+                if (fsimInvertedFiltered == invalidSimilarity)
+                    continue;
+
+                simColumn[vz] += TSimRefineCpu(fsimInvertedFiltered);
+            }
+        }
+    }
+}
+
+void cpu_volumeRefineBestDepth(CpuMap<CpuFloat2>& out_refineDepthSimMap_cpu,
+                               const CpuMap<CpuFloat2>& in_sgmDepthPixSizeMap_cpu,
+                               const CpuVolume<TSimRefineCpu>& in_volSim_cpu,
+                               const RefineParams& refineParams,
+                               const ROI& roi)
+{
+    const int roiWidth = int(roi.width());
+    const int roiHeight = int(roi.height());
+    const int volDimZ = in_volSim_cpu.dimZ();
+    const int samplesPerPixSize = refineParams.nbSubsamples;
+    const int halfNbSamples = refineParams.nbSubsamples * refineParams.halfNbDepths;
+    const int halfNbDepths = refineParams.halfNbDepths;
+    const float twoTimesSigmaPowerTwo = float(2.0 * refineParams.sigma * refineParams.sigma);
+
+#pragma omp parallel for
+    for (int vy = 0; vy < roiHeight; ++vy)
+    {
+        for (int vx = 0; vx < roiWidth; ++vx)
+        {
+            const CpuFloat2& in_sgmDepthPixSize = in_sgmDepthPixSizeMap_cpu(vx, vy);
+            CpuFloat2& out_bestDepthSim = out_refineDepthSimMap_cpu(vx, vy);
+
+            // sgm depth (middle depth) invalid or masked
+            if (in_sgmDepthPixSize.x <= 0.0f)
+            {
+                out_bestDepthSim = {in_sgmDepthPixSize.x, 1.0f};  // -1 (invalid) or -2 (masked)
+                continue;
+            }
+
+            const TSimRefineCpu* simColumn = in_volSim_cpu.column(vx, vy);
+
+            // find best z sample per pixel with a sliding gaussian window
+            float bestSampleSim = 0.f;      // all sample sim <= 0.f
+            int bestSampleOffsetIndex = 0;  // default is middle depth (SGM)
+
+            for (int sample = -halfNbSamples; sample <= halfNbSamples; ++sample)
+            {
+                float sampleSim = 0.f;
+
+#pragma omp simd reduction(+ : sampleSim)
+                for (int vz = 0; vz < volDimZ; ++vz)
+                {
+                    const int zs = (vz - halfNbDepths) * samplesPerPixSize;  // relative sample offset
+                    const float simSum = -float(simColumn[vz]);               // best value is the LOWEST
+
+                    sampleSim += simSum * std::exp(-float((zs - sample) * (zs - sample)) / twoTimesSigmaPowerTwo);
+                }
+
+                if (sampleSim < bestSampleSim)
+                {
+                    bestSampleOffsetIndex = sample;
+                    bestSampleSim = sampleSim;
+                }
+            }
+
+            // compute best depth: input sgm depth (middle depth) + sample size offset from z center
+            const float sampleSize = in_sgmDepthPixSize.y / samplesPerPixSize;
+            const float bestDepth = in_sgmDepthPixSize.x + bestSampleOffsetIndex * sampleSize;
+
+            out_bestDepthSim = {bestDepth, bestSampleSim};
+        }
+    }
+}
+
+}  // namespace depthMap
+}  // namespace aliceVision
@@ -0,0 +1,132 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2023 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <aliceVision/mvsData/ROI.hpp>
+#include <aliceVision/depthMap/SgmParams.hpp>
+#include <aliceVision/depthMap/RefineParams.hpp>
+#include <aliceVision/depthMap/cpu/CpuBuffer.hpp>
+#include <aliceVision/depthMap/cpu/CpuCameraParams.hpp>
+#include <aliceVision/depthMap/cpu/CpuLabImage.hpp>
+
+#include <vector>
+
+namespace aliceVision {
+namespace depthMap {
+
+/**
+ * @brief Compute the best / second best similarity volumes for the given RcTc.
+ * @note CPU implementation of cuda_volumeComputeSimilarity.
+ * @param[in,out] inout_volBestSim_cpu the best similarity volume
+ * @param[in,out] inout_volSecBestSim_cpu the second best similarity volume
+ * @param[in] in_depths the R camera depth list
+ * @param[in] rcCamParams the R camera parameters at SGM scale
+ * @param[in] tcCamParams the T camera parameters at SGM scale
+ * @param[in] rcImage the R camera CIELAB image at SGM scale
+ * @param[in] tcImage the T camera CIELAB image at SGM scale
+ * @param[in] sgmParams the Semi Global Matching parameters
+ * @param[in] depthRange the volume depth range to compute
+ * @param[in] roi the 2d region of interest, downscaled by the SGM scale x stepXY
+ */
+void cpu_volumeComputeSimilarity(CpuVolume<TSimCpu>& inout_volBestSim_cpu,
+                                 CpuVolume<TSimCpu>& inout_volSecBestSim_cpu,
+                                 const std::vector<float>& in_depths,
+                                 const CpuCameraParams& rcCamParams,
+                                 const CpuCameraParams& tcCamParams,
+                                 const CpuLabImage& rcImage,
+                                 const CpuLabImage& tcImage,
+                                 const SgmParams& sgmParams,
+                                 const Range& depthRange,
+                                 const ROI& roi);
+
+/**
+ * @brief Update second best uninitialized similarity volume values with first best similarity volume values.
+ * @note CPU implementation of cuda_volumeUpdateUninitializedSimilarity.
+ * @param[in] in_volBestSim_cpu the best similarity volume
+ * @param[in,out] inout_volSecBestSim_cpu the second best similarity volume
+ */
+void cpu_volumeUpdateUninitializedSimilarity(const CpuVolume<TSimCpu>& in_volBestSim_cpu, CpuVolume<TSimCpu>& inout_volSecBestSim_cpu);
+
+/**
+ * @brief Filter an input similarity volume with the Semi Global Matching path aggregation.
+ * @note CPU implementation of cuda_volumeOptimize.
+ *       Each filtering axis is aggregated in both directions, paths of the same direction are computed in parallel.
+ * @param[out] out_volSimFiltered_cpu the output similarity volume
+ * @param[in] in_volSim_cpu the input similarity volume
+ * @param[in] rcImage the R camera CIELAB image at SGM scale
+ * @param[in] sgmParams the Semi Global Matching parameters
+ * @param[in] lastDepthIndex the R camera last depth index
+ * @param[in] roi the 2d region of interest, downscaled by the SGM scale x stepXY
+ */
+void cpu_volumeOptimize(CpuVolume<TSimCpu>& out_volSimFiltered_cpu,
+                        const CpuVolume<TSimCpu>& in_volSim_cpu,
+                        const CpuLabImage& rcImage,
+                        const SgmParams& sgmParams,
+                        int lastDepthIndex,
+                        const ROI& roi);
+
+/**
+ * @brief Retrieve the best depth/thickness (and optionally depth/sim) in the given similarity volume.
+ * @note CPU implementation of cuda_volumeRetrieveBestDepth.
+ * @param[out] out_sgmDepthThicknessMap_cpu the output depth/thickness map
+ * @param[out] out_sgmDepthSimMap_cpu the output depth/similarity map or nullptr
+ * @param[in] in_depths the R camera depth list
+ * @param[in] in_volSim_cpu the input similarity volume
+ * @param[in] rcCamParams the R camera parameters at scale 1
+ * @param[in] sgmParams the Semi Global Matching parameters
+ * @param[in] depthRange the volume depth range
+ * @param[in] roi the 2d region of interest, downscaled by the SGM scale x stepXY
+ */
+void cpu_volumeRetrieveBestDepth(CpuMap<CpuFloat2>& out_sgmDepthThicknessMap_cpu,
+                                 CpuMap<CpuFloat2>* out_sgmDepthSimMap_cpu,
+                                 const std::vector<float>& in_depths,
+                                 const CpuVolume<TSimCpu>& in_volSim_cpu,
+                                 const CpuCameraParams& rcCamParams,
+                                 const SgmParams& sgmParams,
+                                 const Range& depthRange,
+                                 const ROI& roi);
+
+/**
+ * @brief Add the inverted and filtered RcTc similarity values around the SGM depths to the refine volume.
+ * @note CPU implementation of cuda_volumeRefineSimilarity.
+ * @param[in,out] inout_volSim_cpu the refine similarity volume (sum of the inverted similarities, best value is the highest)
+ * @param[in] in_sgmDepthPixSizeMap_cpu the upscaled SGM depth/pixSize map
+ * @param[in] rcCamParams the R camera parameters at Refine scale
+ * @param[in] tcCamParams the T camera parameters at Refine scale
+ * @param[in] rcImage the R camera CIELAB image at Refine scale
+ * @param[in] tcImage the T camera CIELAB image at Refine scale
+ * @param[in] refineParams the Refine parameters
+ * @param[in] depthRange the volume depth range to compute
+ * @param[in] roi the 2d region of interest, downscaled by the Refine scale x stepXY
+ */
+void cpu_volumeRefineSimilarity(CpuVolume<TSimRefineCpu>& inout_volSim_cpu,
+                                const CpuMap<CpuFloat2>& in_sgmDepthPixSizeMap_cpu,
+                                const CpuCameraParams& rcCamParams,
+                                const CpuCameraParams& tcCamParams,
+                                const CpuLabImage& rcImage,
+                                const CpuLabImage& tcImage,
+                                const RefineParams& refineParams,
+                                const Range& depthRange,
+                                const ROI& roi);
+
+/**
+ * @brief Retrieve the best depth/sim in the refine volume with a sliding gaussian over the depth sub-samples.
+ * @note CPU implementation of cuda_volumeRefineBestDepth.
+ * @param[out] out_refineDepthSimMap_cpu the output refined depth/similarity map
+ * @param[in] in_sgmDepthPixSizeMap_cpu the upscaled SGM depth/pixSize map
+ * @param[in] in_volSim_cpu the refine similarity volume
+ * @param[in] refineParams the Refine parameters
+ * @param[in] roi the 2d region of interest, downscaled by the Refine scale x stepXY
+ */
+void cpu_volumeRefineBestDepth(CpuMap<CpuFloat2>& out_refineDepthSimMap_cpu,
+                               const CpuMap<CpuFloat2>& in_sgmDepthPixSizeMap_cpu,
+                               const CpuVolume<TSimRefineCpu>& in_volSim_cpu,
+                               const RefineParams& refineParams,
+                               const ROI& roi);
+
+}  // namespace depthMap
+}  // namespace aliceVision
@@ -441,6 +441,8 @@ __device__ static float compNCCbyH(const DeviceCameraParams& rcDeviceCamParams,
  * @brief Compute Normalized Cross-Correlation of a full square patch at given half-width.
  *
  * @tparam TInvertAndFilter invert and filter output similarity value
+ * @tparam TWsh the compile-time half-width of the patch, the patch loops are fully unrolled
+ *              0 to use the runtime wsh parameter
  *
  * @param[in] rcDeviceCameraParamsId the R camera parameters in device constant memory array
  * @param[in] tcDeviceCameraParamsId the T camera parameters in device constant memory array
@@ -451,7 +453,7 @@ __device__ static float compNCCbyH(const DeviceCameraParams& rcDeviceCamParams,
  * @param[in] tcLevelWidth the T camera image width at given mipmapLevel
  * @param[in] tcLevelHeight the T camera image height at given mipmapLevel
  * @param[in] mipmapLevel the workflow current mipmap level (e.g. SGM=1.f, Refine=0.f)
- * @param[in] wsh the half-width of the patch
+ * @param[in] wsh the half-width of the patch, ignored if TWsh > 0
  * @param[in] invGammaC the inverted strength of grouping by color similarity
  * @param[in] invGammaP the inverted strength of grouping by proximity
  * @param[in] useConsistentScale enable consistent scale patch comparison
@@ -463,7 +465,7 @@ __device__ static float compNCCbyH(const DeviceCameraParams& rcDeviceCamParams,
  *          -> infinite similarity value: 1
  *          -> invalid/uninitialized/masked similarity: CUDART_INF_F
  */
-template<bool TInvertAndFilter>
+template<bool TInvertAndFilter, int TWsh = 0>
 __device__ inline float compNCCby3DptsYK(const DeviceCameraParams& rcDeviceCamParams,
                                          const DeviceCameraParams& tcDeviceCamParams,
                                          const cudaTextureObject_t rcMipmapImage_tex,
@@ -479,12 +481,15 @@ __device__ inline float compNCCby3DptsYK(const DeviceCameraParams& rcDeviceCamPa
                                          const bool useConsistentScale,
                                          const Patch& patch)
 {
+    // patch half-width, known at compile time for the specialized kernels
+    const int patchWsh = (TWsh > 0) ? TWsh : wsh;
+
     // get R and T image 2d coordinates from patch center 3d point
     const float2 rp = project3DPoint(rcDeviceCamParams.P, patch.p);
     const float2 tp = project3DPoint(tcDeviceCamParams.P, patch.p);
 
     // image 2d coordinates margin
-    const float dd = wsh + 2.0f; // TODO: FACA
+    const float dd = patchWsh + 2.0f; // TODO: FACA
 
     // check R and T image 2d coordinates
     if((rp.x < dd) || (rp.x > float(rcLevelWidth  - 1) - dd) ||
@@ -525,13 +530,20 @@ __device__ inline float compNCCby3DptsYK(const DeviceCameraParams& rcDeviceCamPa
         return CUDART_INF_F; // masked
     }
 
+    // patch axes scaled by the pixel size, kept in registers for the whole patch
+    const float3 patchStepX = patch.x * patch.d;
+    const float3 patchStepY = patch.y * patch.d;
+
     // compute patch (wsh*2+1)x(wsh*2+1)
-    for(int yp = -wsh; yp <= wsh; ++yp)
+    // note: the loops are fully unrolled when the half-width is known at compile time
+#pragma unroll
+    for(int yp = -patchWsh; yp <= patchWsh; ++yp)
     {
-        for(int xp = -wsh; xp <= wsh; ++xp)
+#pragma unroll
+        for(int xp = -patchWsh; xp <= patchWsh; ++xp)
         {
             // get 3d point
-            const float3 p = patch.p + patch.x * float(patch.d * float(xp)) + patch.y * float(patch.d * float(yp));
+            const float3 p = patch.p + patchStepX * float(xp) + patchStepY * float(yp);
 
             // get R and T image 2d coordinates from 3d point
             const float2 rpc = project3DPoint(rcDeviceCamParams.P, p);
@@ -8,6 +8,7 @@
 
 #include <aliceVision/system/Logger.hpp>
 #include <aliceVision/depthMap/cuda/host/utils.hpp>
+#include <aliceVision/depthMap/cuda/host/DeviceProfiler.hpp>
 #include <aliceVision/depthMap/cuda/device/DeviceCameraParams.hpp>
 #include <aliceVision/depthMap/cuda/imageProcessing/deviceGaussianFilter.hpp>
 
@@ -219,6 +220,41 @@ DeviceCache::SingleDeviceCache& DeviceCache::getCurrentDeviceCache()
     return *(it->second);
 }
 
+void copyImageToHostBuffer(const image::Image<image::RGBAfColor>& img, CudaHostMemoryHeap<CudaRGBA, 2>& img_hmh)
+{
+    // allocate the full size host-sided image buffer
+    const CudaSize<2> imgSize(img.Width(), img.Height());
+    if (img_hmh.getBuffer() == nullptr || img_hmh.getSize() != imgSize)
+    {
+        img_hmh.deallocate();
+        img_hmh.allocate(imgSize);
+    }
+
+    // copy image to CUDA host-side image buffer
+#pragma omp parallel for
+    for (int y = 0; y < imgSize.y(); ++y)
+    {
+        for (int x = 0; x < imgSize.x(); ++x)
+        {
+            const image::RGBAfColor& floatRGBA = img(y, x);
+            CudaRGBA& cudaRGBA = img_hmh(x, y);
+
+#ifdef ALICEVISION_DEPTHMAP_TEXTURE_USE_HALF
+            // explicit float to half conversion
+            cudaRGBA.x = __float2half(floatRGBA.r() * 255.0f);
+            cudaRGBA.y = __float2half(floatRGBA.g() * 255.0f);
+            cudaRGBA.z = __float2half(floatRGBA.b() * 255.0f);
+            cudaRGBA.w = __float2half(floatRGBA.a() * 255.0f);
+#else
+            cudaRGBA.x = floatRGBA.r() * 255.0f;
+            cudaRGBA.y = floatRGBA.g() * 255.0f;
+            cudaRGBA.z = floatRGBA.b() * 255.0f;
+            cudaRGBA.w = floatRGBA.a() * 255.0f;
+#endif
+        }
+    }
+}
+
 void DeviceCache::addMipmapImage(int camId,
                                  int minDownscale,
                                  int maxDownscale,
@@ -248,38 +284,55 @@ void DeviceCache::addMipmapImage(int camId,
     // get image buffer
     mvsUtils::ImagesCache<image::Image<image::RGBAfColor>>::ImgSharedPtr img = imageCache.getImg_sync(camId);
 
-    // allocate the full size host-sided image buffer
-    CudaSize<2> imgSize(img->Width(), img->Height());
-    CudaHostMemoryHeap<CudaRGBA, 2> img_hmh(imgSize);
-
     // copy image from imageCache to CUDA host-side image buffer
-#pragma omp parallel for
-    for (int y = 0; y < imgSize.y(); ++y)
-    {
-        for (int x = 0; x < imgSize.x(); ++x)
-        {
-            const image::RGBAfColor& floatRGBA = (*img)(y, x);
-            CudaRGBA& cudaRGBA = img_hmh(x, y);
+    CudaHostMemoryHeap<CudaRGBA, 2> img_hmh;
+    copyImageToHostBuffer(*img, img_hmh);
 
-#ifdef ALICEVISION_DEPTHMAP_TEXTURE_USE_HALF
-            // explicit float to half conversion
-            cudaRGBA.x = __float2half(floatRGBA.r() * 255.0f);
-            cudaRGBA.y = __float2half(floatRGBA.g() * 255.0f);
-            cudaRGBA.z = __float2half(floatRGBA.b() * 255.0f);
-            cudaRGBA.w = __float2half(floatRGBA.a() * 255.0f);
-#else
-            cudaRGBA.x = floatRGBA.r() * 255.0f;
-            cudaRGBA.y = floatRGBA.g() * 255.0f;
-            cudaRGBA.z = floatRGBA.b() * 255.0f;
-            cudaRGBA.w = floatRGBA.a() * 255.0f;
-#endif
-        }
+    const DeviceStageRange stageRange(camId, EDeviceStage::UPLOAD, 0 /*stream*/);
+
+    DeviceMipmapImage& deviceMipmapImage = *(currentDeviceCache.mipmaps.at(deviceMipmapId));
+    deviceMipmapImage.fill(img_hmh, minDownscale, maxDownscale);
+}
+
+void DeviceCache::addMipmapImage(int camId,
+                                 int minDownscale,
+                                 int maxDownscale,
+                                 const CudaHostMemoryHeap<CudaRGBA, 2>& img_hmh,
+                                 const mvsUtils::MultiViewParams& mp)
+{
+    // get current device cache
+    SingleDeviceCache& currentDeviceCache = getCurrentDeviceCache();
+
+    // get view id for logs
+    const IndexT viewId = mp.getViewId(camId);
+
+    // find out with the LRU (Least Recently Used) strategy if the mipmap image is already in the cache
+    int deviceMipmapId;
+    const bool newInsertion = currentDeviceCache.mipmapCache.insert(camId, &deviceMipmapId);
+
+    // check if the camera is already in cache
+    if (!newInsertion)
+    {
+        ALICEVISION_LOG_TRACE("Add mipmap image on device cache: already on cache (id: " << camId << ", view id: " << viewId << ").");
+        return;  // nothing to do
     }
 
+    ALICEVISION_LOG_TRACE("Add prefetched mipmap image on device cache (id: " << camId << ", view id: " << viewId << ").");
+
+    const DeviceStageRange stageRange(camId, EDeviceStage::UPLOAD, 0 /*stream*/);
+
     DeviceMipmapImage& deviceMipmapImage = *(currentDeviceCache.mipmaps.at(deviceMipmapId));
     deviceMipmapImage.fill(img_hmh, minDownscale, maxDownscale);
 }
 
+void DeviceCache::setUpcomingMipmapImages(const std::vector<int>& camIds)
+{
+    // get current device cache
+    SingleDeviceCache& currentDeviceCache = getCurrentDeviceCache();
+
+    currentDeviceCache.mipmapCache.setUpcoming(camIds);
+}
+
 void DeviceCache::addCameraParams(int camId, int downscale, const mvsUtils::MultiViewParams& mp)
 {
     // get current device cache
@@ -17,6 +17,13 @@
 namespace aliceVision {
 namespace depthMap {
 
+/**
+ * @brief Convert an image into the host-sided input buffer of a device mipmap image.
+ * @param[in] img the input image (linear RGBA in [0, 1])
+ * @param[out] img_hmh the output image buffer in CUDA host memory (allocated if needed)
+ */
+void copyImageToHostBuffer(const image::Image<image::RGBAfColor>& img, CudaHostMemoryHeap<CudaRGBA, 2>& img_hmh);
+
 /**
  * @class Device cache
  * @brief This singleton allows to access the current gpu cache.
@@ -62,6 +69,23 @@ class DeviceCache
                         mvsUtils::ImagesCache<image::Image<image::RGBAfColor>>& imageCache,
                         const mvsUtils::MultiViewParams& mp);
 
+    /**
+     * @brief Add a mipmap image in current gpu device cache from an already loaded host-sided image buffer.
+     * @param[in] camId the camera index in the ImagesCache / MultiViewParams
+     * @param[in] minDownscale the min downscale factor
+     * @param[in] maxDownscale the max downscale factor
+     * @param[in] img_hmh the input image buffer in CUDA host memory
+     * @param[in] mp the multi-view parameters
+     */
+    void addMipmapImage(int camId, int minDownscale, int maxDownscale, const CudaHostMemoryHeap<CudaRGBA, 2>& img_hmh, const mvsUtils::MultiViewParams& mp);
+
+    /**
+     * @brief Set the cameras whose mipmap images will be used next in current gpu device cache.
+     * @note Their mipmap images are replaced last, the latest needed first.
+     * @param[in] camIds the camera indexes in the MultiViewParams, in their order of use
+     */
+    void setUpcomingMipmapImages(const std::vector<int>& camIds);
+
     /**
      * @brief Add a camera parameters structure in current gpu device cache.
      * @param[in] camId the camera index in the ImagesCache / MultiViewParams
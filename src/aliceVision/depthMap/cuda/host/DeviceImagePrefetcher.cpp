@@ -0,0 +1,97 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2023 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "DeviceImagePrefetcher.hpp"
+
+#include <aliceVision/system/Logger.hpp>
+#include <aliceVision/mvsUtils/fileIO.hpp>
+#include <aliceVision/depthMap/cuda/host/utils.hpp>
+#include <aliceVision/depthMap/cuda/host/DeviceCache.hpp>
+
+#include <algorithm>
+
+namespace aliceVision {
+namespace depthMap {
+
+DeviceImagePrefetcher::DeviceImagePrefetcher(const mvsUtils::MultiViewParams& mp,
+                                             int cudaDeviceId,
+                                             int maxImages,
+                                             image::EImageColorSpace colorspace,
+                                             mvsUtils::ECorrectEV correctEV)
+  : _mp(mp),
+    _cudaDeviceId(cudaDeviceId),
+    _maxImages(maxImages),
+    _colorspace(colorspace),
+    _correctEV(correctEV)
+{}
+
+DeviceImagePrefetcher::~DeviceImagePrefetcher()
+{
+    try
+    {
+        clear();
+    }
+    catch (const std::exception& e)
+    {
+        ALICEVISION_LOG_WARNING("Device image prefetcher: " << e.what());
+    }
+}
+
+void DeviceImagePrefetcher::wait()
+{
+    if (_loading.valid())
+        _loading.get();
+}
+
+void DeviceImagePrefetcher::clear()
+{
+    wait();
+    std::lock_guard<std::mutex> lock(_mutex);
+    _images.clear();
+}
+
+void DeviceImagePrefetcher::prefetch(const std::vector<int>& camIds)
+{
+    clear();
+
+    std::vector<int> camIdsToLoad(camIds.begin(), camIds.begin() + std::min(camIds.size(), static_cast<std::size_t>(std::max(0, _maxImages))));
+
+    if (camIdsToLoad.empty())
+        return;
+
+    _loading = std::async(std::launch::async, [this, camIdsToLoad]() {
+        // pinned host memory is allocated for the device context
+        setCudaDeviceId(_cudaDeviceId);
+
+        image::Image<image::RGBAfColor> img;
+
+        for (const int camId : camIdsToLoad)
+        {
+            mvsUtils::loadImage(_mp.getImagePath(camId), _mp, camId, img, _colorspace, _correctEV);
+
+            auto img_hmh = std::make_shared<CudaHostMemoryHeap<CudaRGBA, 2>>();
+            copyImageToHostBuffer(img, *img_hmh);
+
+            std::lock_guard<std::mutex> lock(_mutex);
+            _images.emplace(camId, img_hmh);
+        }
+
+        ALICEVISION_LOG_DEBUG("Device image prefetcher: " << camIdsToLoad.size() << " image(s) loaded (cuda device id: " << _cudaDeviceId << ").");
+    });
+}
+
+std::shared_ptr<const CudaHostMemoryHeap<CudaRGBA, 2>> DeviceImagePrefetcher::get(int camId)
+{
+    wait();
+    std::lock_guard<std::mutex> lock(_mutex);
+    const auto it = _images.find(camId);
+    if (it == _images.end())
+        return nullptr;
+    return it->second;
+}
+
+}  // namespace depthMap
+}  // namespace aliceVision
@@ -0,0 +1,91 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2023 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <aliceVision/mvsUtils/MultiViewParams.hpp>
+#include <aliceVision/mvsUtils/ImagesCache.hpp>
+#include <aliceVision/depthMap/cuda/host/memory.hpp>
+
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace aliceVision {
+namespace depthMap {
+
+/**
+ * @class Device image prefetcher
+ * @brief Load the images of the next cameras on a background thread,
+ *        directly into pinned host buffers ready to be uploaded in the device cache.
+ * @note Images are decoded while the gpu computes the current tiles,
+ *       this allows to remove image decoding from the critical path.
+ */
+class DeviceImagePrefetcher
+{
+  public:
+    /**
+     * @brief DeviceImagePrefetcher constructor.
+     * @param[in] mp the multi-view parameters
+     * @param[in] cudaDeviceId the CUDA device id used by the background thread
+     * @param[in] maxImages the maximum number of prefetched images kept in host memory
+     * @param[in] colorspace the image colorspace
+     * @param[in] correctEV the image exposure correction
+     */
+    DeviceImagePrefetcher(const mvsUtils::MultiViewParams& mp,
+                          int cudaDeviceId,
+                          int maxImages,
+                          image::EImageColorSpace colorspace,
+                          mvsUtils::ECorrectEV correctEV = mvsUtils::ECorrectEV::NO_CORRECTION);
+
+    // destructor, wait for the background loading
+    ~DeviceImagePrefetcher();
+
+    // this class handles unique data, no copy constructor
+    DeviceImagePrefetcher(DeviceImagePrefetcher const&) = delete;
+
+    // this class handles unique data, no copy operator
+    void operator=(DeviceImagePrefetcher const&) = delete;
+
+    /**
+     * @brief Start loading the given cameras on the background thread.
+     * @note Previously prefetched images are released.
+     * @param[in] camIds the cameras to prefetch (only the first maxImages are prefetched)
+     */
+    void prefetch(const std::vector<int>& camIds);
+
+    /**
+     * @brief Get the prefetched host-sided image buffer of the given camera.
+     * @note Wait for the current background loading.
+     * @param[in] camId the camera index in the MultiViewParams
+     * @return the image buffer or nullptr if the camera has not been prefetched
+     */
+    std::shared_ptr<const CudaHostMemoryHeap<CudaRGBA, 2>> get(int camId);
+
+    /**
+     * @brief Wait for the background loading and release all the prefetched images.
+     */
+    void clear();
+
+  private:
+    /// wait for the current background loading (rethrow its exception if any)
+    void wait();
+
+    const mvsUtils::MultiViewParams& _mp;
+    const int _cudaDeviceId;
+    const int _maxImages;
+    const image::EImageColorSpace _colorspace;
+    const mvsUtils::ECorrectEV _correctEV;
+
+    std::future<void> _loading;
+    std::mutex _mutex;
+    std::map<int, std::shared_ptr<CudaHostMemoryHeap<CudaRGBA, 2>>> _images;  // <camId, imageBuffer>
+};
+
+}  // namespace depthMap
+}  // namespace aliceVision
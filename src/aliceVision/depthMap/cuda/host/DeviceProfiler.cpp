@@ -0,0 +1,205 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "DeviceProfiler.hpp"
+
+#include <aliceVision/system/Logger.hpp>
+#include <aliceVision/system/nvtx.hpp>
+
+#include <boost/property_tree/ptree.hpp>
+#include <boost/property_tree/json_parser.hpp>
+
+#include <stdexcept>
+
+namespace aliceVision {
+namespace depthMap {
+
+namespace bpt = boost::property_tree;
+
+namespace {
+
+/// stage names, in the EDeviceStage order
+const char* deviceStageNames[nbDeviceStages] = {
+  "upload", "sgmSimilarity", "sgmAggregation", "sgmRetrieveDepth", "refine", "refineOptimize", "normalMap", "download"};
+
+}  // namespace
+
+std::string EDeviceStage_enumToString(EDeviceStage stage)
+{
+    const int stageIndex = static_cast<int>(stage);
+    if (stageIndex < 0 || stageIndex >= nbDeviceStages)
+        throw std::out_of_range("Invalid device stage enum");
+    return deviceStageNames[stageIndex];
+}
+
+void DeviceProfiler::addStageEvents(int camId, EDeviceStage stage, cudaEvent_t startEvent, cudaEvent_t stopEvent)
+{
+    int cudaDeviceId = 0;
+    cudaGetDevice(&cudaDeviceId);
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    _pendingStages.push_back({cudaDeviceId, camId, stage, startEvent, stopEvent});
+}
+
+void DeviceProfiler::synchronize()
+{
+    int cudaDeviceId = 0;
+    cudaGetDevice(&cudaDeviceId);
+
+    // take the pending stages of the current device
+    std::vector<PendingStage> deviceStages;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        auto it = _pendingStages.begin();
+        while (it != _pendingStages.end())
+        {
+            if (it->cudaDeviceId == cudaDeviceId)
+            {
+                deviceStages.push_back(*it);
+                it = _pendingStages.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+    }
+
+    if (deviceStages.empty())
+        return;
+
+    // wait for the events without blocking the other devices
+    std::vector<float> elapsedMsPerStage(deviceStages.size(), 0.f);
+    for (std::size_t i = 0; i < deviceStages.size(); ++i)
+    {
+        const PendingStage& pendingStage = deviceStages.at(i);
+
+        if (cudaEventSynchronize(pendingStage.stopEvent) != cudaSuccess ||
+            cudaEventElapsedTime(&elapsedMsPerStage.at(i), pendingStage.startEvent, pendingStage.stopEvent) != cudaSuccess)
+        {
+            ALICEVISION_LOG_WARNING("DeviceProfiler: cannot get the elapsed time of the stage " << EDeviceStage_enumToString(pendingStage.stage)
+                                                                                                << " (rc: " << pendingStage.camId << ").");
+            cudaGetLastError();  // reset the error
+            elapsedMsPerStage.at(i) = -1.f;
+        }
+
+        cudaEventDestroy(pendingStage.startEvent);
+        cudaEventDestroy(pendingStage.stopEvent);
+    }
+
+    // accumulate the elapsed time per camera
+    std::lock_guard<std::mutex> lock(_mutex);
+    for (std::size_t i = 0; i < deviceStages.size(); ++i)
+    {
+        if (elapsedMsPerStage.at(i) < 0.f)
+            continue;
+
+        const PendingStage& pendingStage = deviceStages.at(i);
+        StageTiming& timing = _timingsPerCam[pendingStage.camId].at(static_cast<int>(pendingStage.stage));
+        timing.elapsedMs += elapsedMsPerStage.at(i);
+        timing.count++;
+    }
+}
+
+bool DeviceProfiler::writeReport(const std::string& filepath, const mvsUtils::MultiViewParams& mp) const
+{
+    bpt::ptree fileTree;
+    bpt::ptree camerasTree;
+    std::array<StageTiming, nbDeviceStages> totalTimings;
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        for (const auto& camPair : _timingsPerCam)
+        {
+            bpt::ptree cameraTree;
+            cameraTree.put("viewId", mp.getViewId(camPair.first));
+            cameraTree.put("rc", camPair.first);
+
+            for (int s = 0; s < nbDeviceStages; ++s)
+            {
+                const StageTiming& timing = camPair.second.at(s);
+                if (timing.count == 0)
+                    continue;
+
+                cameraTree.put(std::string("stages.") + deviceStageNames[s] + ".elapsedMs", timing.elapsedMs);
+                cameraTree.put(std::string("stages.") + deviceStageNames[s] + ".count", timing.count);
+
+                totalTimings.at(s).elapsedMs += timing.elapsedMs;
+                totalTimings.at(s).count += timing.count;
+            }
+
+            camerasTree.push_back(std::make_pair("", cameraTree));
+        }
+    }
+
+    for (int s = 0; s < nbDeviceStages; ++s)
+    {
+        fileTree.put(std::string("total.") + deviceStageNames[s] + ".elapsedMs", totalTimings.at(s).elapsedMs);
+        fileTree.put(std::string("total.") + deviceStageNames[s] + ".count", totalTimings.at(s).count);
+    }
+
+    fileTree.add_child("cameras", camerasTree);
+
+    try
+    {
+        bpt::write_json(filepath, fileTree);
+    }
+    catch (const std::exception& e)
+    {
+        ALICEVISION_LOG_ERROR("Cannot write the GPU timing report: " << filepath << std::endl << e.what());
+        return false;
+    }
+
+    ALICEVISION_LOG_INFO("GPU timing report written: " << filepath);
+    return true;
+}
+
+DeviceStageRange::DeviceStageRange(int camId, EDeviceStage stage, cudaStream_t stream)
+  : _camId(camId),
+    _stage(stage),
+    _stream(stream)
+{
+    nvtxPush(deviceStageNames[static_cast<int>(_stage)]);
+
+    if (!DeviceProfiler::getInstance().isEnabled())
+        return;
+
+    if (cudaEventCreate(&_startEvent) != cudaSuccess || cudaEventRecord(_startEvent, _stream) != cudaSuccess)
+    {
+        ALICEVISION_LOG_WARNING("DeviceStageRange: cannot record the start event of the stage " << EDeviceStage_enumToString(_stage) << ".");
+        cudaGetLastError();  // reset the error
+        if (_startEvent != nullptr)
+            cudaEventDestroy(_startEvent);
+        _startEvent = nullptr;
+    }
+}
+
+DeviceStageRange::~DeviceStageRange()
+{
+    if (_startEvent != nullptr)
+    {
+        cudaEvent_t stopEvent = nullptr;
+
+        if (cudaEventCreate(&stopEvent) == cudaSuccess && cudaEventRecord(stopEvent, _stream) == cudaSuccess)
+        {
+            DeviceProfiler::getInstance().addStageEvents(_camId, _stage, _startEvent, stopEvent);
+        }
+        else
+        {
+            cudaGetLastError();  // reset the error
+            cudaEventDestroy(_startEvent);
+            if (stopEvent != nullptr)
+                cudaEventDestroy(stopEvent);
+        }
+    }
+
+    nvtxPop(deviceStageNames[static_cast<int>(_stage)]);
+}
+
+}  // namespace depthMap
+}  // namespace aliceVision
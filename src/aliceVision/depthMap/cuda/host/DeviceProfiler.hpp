@@ -0,0 +1,158 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <aliceVision/mvsUtils/MultiViewParams.hpp>
+
+#include <cuda_runtime.h>
+
+#include <array>
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace aliceVision {
+namespace depthMap {
+
+/**
+ * @brief Depth map GPU computation stages.
+ */
+enum class EDeviceStage
+{
+    UPLOAD = 0,
+    SGM_SIMILARITY,
+    SGM_AGGREGATION,
+    SGM_RETRIEVE_DEPTH,
+    REFINE,
+    REFINE_OPTIMIZE,
+    NORMAL_MAP,
+    DOWNLOAD
+};
+
+/// number of depth map GPU computation stages
+constexpr int nbDeviceStages = 8;
+
+/**
+ * @brief Convert an EDeviceStage enum to its corresponding string.
+ * @param[in] stage the given EDeviceStage enum
+ * @return string
+ */
+std::string EDeviceStage_enumToString(EDeviceStage stage);
+
+/**
+ * @class Device profiler
+ * @brief This singleton accumulates the GPU time of each stage per R camera.
+ *
+ * The GPU time of a stage is measured with two CUDA events recorded in its stream.
+ * Streams run concurrently, so the time of a stage includes the time shared with the other streams.
+ */
+class DeviceProfiler
+{
+  public:
+    static DeviceProfiler& getInstance()
+    {
+        static DeviceProfiler instance;
+        return instance;
+    }
+
+    // Singleton, no copy constructor
+    DeviceProfiler(DeviceProfiler const&) = delete;
+
+    // Singleton, no copy operator
+    void operator=(DeviceProfiler const&) = delete;
+
+    /**
+     * @brief Enable or disable the GPU timers (NVTX ranges are not affected).
+     */
+    void setEnabled(bool enabled) { _enabled = enabled; }
+
+    /**
+     * @return true if the GPU timers are enabled
+     */
+    bool isEnabled() const { return _enabled; }
+
+    /**
+     * @brief Add the recorded events of a stage, they are resolved by synchronize().
+     * @param[in] camId the camera index in the MultiViewParams
+     * @param[in] stage the stage
+     * @param[in] startEvent the event recorded at the start of the stage
+     * @param[in] stopEvent the event recorded at the end of the stage
+     */
+    void addStageEvents(int camId, EDeviceStage stage, cudaEvent_t startEvent, cudaEvent_t stopEvent);
+
+    /**
+     * @brief Wait for the pending events of the current device and accumulate their elapsed time.
+     */
+    void synchronize();
+
+    /**
+     * @brief Write the GPU time per stage and per camera in a JSON file.
+     * @param[in] filepath the output JSON file path
+     * @param[in] mp the multi-view parameters
+     * @return false if the file cannot be written
+     */
+    bool writeReport(const std::string& filepath, const mvsUtils::MultiViewParams& mp) const;
+
+  private:
+    DeviceProfiler() = default;
+
+    struct PendingStage
+    {
+        int cudaDeviceId;
+        int camId;
+        EDeviceStage stage;
+        cudaEvent_t startEvent;
+        cudaEvent_t stopEvent;
+    };
+
+    struct StageTiming
+    {
+        double elapsedMs = 0.0;
+        int count = 0;
+    };
+
+    std::vector<PendingStage> _pendingStages;
+    std::map<int, std::array<StageTiming, nbDeviceStages>> _timingsPerCam;
+    std::atomic<bool> _enabled{false};
+    mutable std::mutex _mutex;
+};
+
+/**
+ * @class Device stage range
+ * @brief Scoped NVTX range of a stage, also timed with CUDA events if the DeviceProfiler is enabled.
+ */
+class DeviceStageRange
+{
+  public:
+    /**
+     * @brief DeviceStageRange constructor.
+     * @param[in] camId the camera index in the MultiViewParams
+     * @param[in] stage the stage
+     * @param[in] stream the CUDA stream of the stage
+     */
+    DeviceStageRange(int camId, EDeviceStage stage, cudaStream_t stream);
+
+    // no copy constructor
+    DeviceStageRange(DeviceStageRange const&) = delete;
+
+    // no copy operator
+    void operator=(DeviceStageRange const&) = delete;
+
+    // destructor
+    ~DeviceStageRange();
+
+  private:
+    const int _camId;
+    const EDeviceStage _stage;
+    cudaStream_t _stream;
+    cudaEvent_t _startEvent = nullptr;
+};
+
+}  // namespace depthMap
+}  // namespace aliceVision
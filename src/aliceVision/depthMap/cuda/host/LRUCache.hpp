@@ -10,6 +10,7 @@
 #include <list>
 #include <iostream>
 #include <iterator>
+#include <algorithm>
 
 namespace aliceVision {
 namespace depthMap {
@@ -63,7 +64,9 @@ class LRUCache
      * If the value replaces an entry of the index set, the function
      *    returns true, position contains the value's index and
      *    oldVal contains the value that was removed from the index set.
-     * The replacement strategy is LRU.
+     * The replacement strategy is LRU, unless upcoming values are given:
+     *    the least recently used value that is not upcoming is replaced first,
+     *    otherwise the value whose next use is the latest is replaced.
      */
     inline bool insert(const T& val, int& position, T& oldVal)
     {
@@ -97,8 +100,9 @@ class LRUCache
         }
         else
         {
-            oldVal = _cache.front();
-            _cache.pop_front();
+            typename std::list<T>::iterator c_it = findReplaced();
+            oldVal = *c_it;
+            _cache.erase(c_it);
             _cache.push_back(val);
 
             o_it = std::find(_owner.begin(), _owner.end(), oldVal);
@@ -116,10 +120,16 @@ class LRUCache
 
     inline bool insert(const T& val, int* position, T* oldVal) { return insert(val, *position, *oldVal); }
 
+    /* Set the values that will be used next, in their order of use.
+     * They are kept in the set as long as possible.
+     */
+    inline void setUpcoming(const std::vector<T>& upcoming) { _upcoming = upcoming; }
+
     inline void clear()
     {
         _cache.clear();
         _owner.assign(_max_size, -1);
+        _upcoming.clear();
     }
 
     inline std::ostream& dump(std::ostream& ostr)
@@ -130,8 +140,34 @@ class LRUCache
     }
 
   private:
+    /* Find the cached value to replace, from the least recently used.
+     */
+    inline typename std::list<T>::iterator findReplaced()
+    {
+        typename std::list<T>::iterator replaced = _cache.begin();
+        long replacedNextUse = -1;
+
+        for (typename std::list<T>::iterator c_it = _cache.begin(); c_it != _cache.end(); ++c_it)
+        {
+            typename std::vector<T>::iterator u_it = std::find(_upcoming.begin(), _upcoming.end(), *c_it);
+
+            // not upcoming, least recently used
+            if (u_it == _upcoming.end())
+                return c_it;
+
+            const long nextUse = (u_it - _upcoming.begin());
+            if (nextUse > replacedNextUse)
+            {
+                replaced = c_it;
+                replacedNextUse = nextUse;
+            }
+        }
+        return replaced;
+    }
+
     std::list<T> _cache;
     std::vector<T> _owner;
+    std::vector<T> _upcoming;
     int _max_size;
 };
 
@@ -0,0 +1,276 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "MemoryPool.hpp"
+
+#include <aliceVision/system/Logger.hpp>
+
+#include <algorithm>
+
+namespace aliceVision {
+namespace depthMap {
+
+namespace {
+
+/// smallest block size class in bytes
+const std::size_t minBlockBytes = 512;
+
+/// number of size classes between two powers of two, the rounding overhead is below 1 / nbSubClasses
+const std::size_t nbSubClasses = 8;
+
+/// minimum pitch alignment in bytes of the pitched device allocations, as cudaMallocPitch
+const std::size_t minPitchAlignment = 256;
+
+double toMB(std::size_t bytes) { return double(bytes) / (1024.0 * 1024.0); }
+
+}  // namespace
+
+MemoryPool::~MemoryPool()
+{
+    // the CUDA runtime may already be unloaded at the end of the program, errors are ignored
+    releaseIdleBlocks(_pinnedHostHeap, false);
+
+    for (auto& heapPair : _deviceHeapPerId)
+        releaseIdleBlocks(heapPair.second, true);
+}
+
+std::size_t MemoryPool::getSizeClass(std::size_t bytes)
+{
+    if (bytes <= minBlockBytes)
+        return minBlockBytes;
+
+    std::size_t highestPowerOfTwo = minBlockBytes;
+    while (highestPowerOfTwo <= bytes / 2)
+        highestPowerOfTwo *= 2;
+
+    const std::size_t step = highestPowerOfTwo / nbSubClasses;
+    return ((bytes + step - 1) / step) * step;
+}
+
+std::size_t MemoryPool::getDevicePitch(std::size_t rowBytes)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    int cudaDeviceId = 0;
+    cudaGetDevice(&cudaDeviceId);
+
+    auto it = _pitchAlignmentPerId.find(cudaDeviceId);
+    if (it == _pitchAlignmentPerId.end())
+    {
+        int texturePitchAlignment = 0;
+        if (cudaDeviceGetAttribute(&texturePitchAlignment, cudaDevAttrTexturePitchAlignment, cudaDeviceId) != cudaSuccess)
+            cudaGetLastError();  // reset the error, use the minimum alignment
+
+        const std::size_t pitchAlignment = std::max(minPitchAlignment, std::size_t(std::max(texturePitchAlignment, 0)));
+        it = _pitchAlignmentPerId.emplace(cudaDeviceId, pitchAlignment).first;
+    }
+
+    const std::size_t pitchAlignment = it->second;
+    return ((rowBytes + pitchAlignment - 1) / pitchAlignment) * pitchAlignment;
+}
+
+cudaError_t MemoryPool::allocatePinnedHost(void** ptr, std::size_t bytes)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    const std::size_t blockBytes = getSizeClass(bytes);
+
+    *ptr = popIdleBlock(_pinnedHostHeap, blockBytes, bytes);
+    if (*ptr != nullptr)
+        return cudaSuccess;
+
+    cudaError_t err = cudaMallocHost(ptr, blockBytes);
+    if (err != cudaSuccess && _pinnedHostHeap.stats.cachedBytes > 0)
+    {
+        // not enough memory, release the idle blocks and retry
+        cudaGetLastError();
+        releaseIdleBlocks(_pinnedHostHeap, false);
+        err = cudaMallocHost(ptr, blockBytes);
+    }
+
+    if (err != cudaSuccess)
+    {
+        *ptr = nullptr;
+        return err;
+    }
+
+    pushUsedBlock(_pinnedHostHeap, *ptr, blockBytes, bytes);
+    return cudaSuccess;
+}
+
+cudaError_t MemoryPool::deallocatePinnedHost(void* ptr)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    auto it = _pinnedHostHeap.usedBlocks.find(ptr);
+    if (it == _pinnedHostHeap.usedBlocks.end())
+        return cudaFreeHost(ptr);  // not allocated by the pool
+
+    const std::size_t blockBytes = getSizeClass(it->second);
+    _pinnedHostHeap.usedBlocks.erase(it);
+    _pinnedHostHeap.stats.usedBytes -= blockBytes;
+    _pinnedHostHeap.stats.cachedBytes += blockBytes;
+    _pinnedHostHeap.idleBlocks[blockBytes].push_back(ptr);
+    return cudaSuccess;
+}
+
+cudaError_t MemoryPool::allocateDevice(void** ptr, std::size_t bytes)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    int cudaDeviceId = 0;
+    cudaGetDevice(&cudaDeviceId);
+
+    Heap& heap = _deviceHeapPerId[cudaDeviceId];
+    const std::size_t blockBytes = getSizeClass(bytes);
+
+    *ptr = popIdleBlock(heap, blockBytes, bytes);
+    if (*ptr != nullptr)
+        return cudaSuccess;
+
+    cudaError_t err = cudaMalloc(ptr, blockBytes);
+    if (err != cudaSuccess && heap.stats.cachedBytes > 0)
+    {
+        // not enough memory, release the idle blocks and retry
+        cudaGetLastError();
+        releaseIdleBlocks(heap, true);
+        err = cudaMalloc(ptr, blockBytes);
+    }
+
+    if (err != cudaSuccess)
+    {
+        *ptr = nullptr;
+        return err;
+    }
+
+    pushUsedBlock(heap, *ptr, blockBytes, bytes);
+    return cudaSuccess;
+}
+
+cudaError_t MemoryPool::deallocateDevice(void* ptr)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    for (auto& heapPair : _deviceHeapPerId)
+    {
+        Heap& heap = heapPair.second;
+
+        auto it = heap.usedBlocks.find(ptr);
+        if (it == heap.usedBlocks.end())
+            continue;
+
+        const std::size_t blockBytes = getSizeClass(it->second);
+        heap.usedBlocks.erase(it);
+        heap.stats.usedBytes -= blockBytes;
+        heap.stats.cachedBytes += blockBytes;
+        heap.idleBlocks[blockBytes].push_back(ptr);
+        return cudaSuccess;
+    }
+
+    return cudaFree(ptr);  // not allocated by the pool
+}
+
+void MemoryPool::release()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    int cudaDeviceId = 0;
+    cudaGetDevice(&cudaDeviceId);
+
+    if (releaseIdleBlocks(_pinnedHostHeap, false) != cudaSuccess)
+        ALICEVISION_LOG_WARNING("MemoryPool: cannot release the idle pinned host memory blocks.");
+
+    auto it = _deviceHeapPerId.find(cudaDeviceId);
+    if (it != _deviceHeapPerId.end() && releaseIdleBlocks(it->second, true) != cudaSuccess)
+        ALICEVISION_LOG_WARNING("MemoryPool: cannot release the idle memory blocks of device " << cudaDeviceId << ".");
+}
+
+MemoryPoolStats MemoryPool::getPinnedHostStats() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _pinnedHostHeap.stats;
+}
+
+MemoryPoolStats MemoryPool::getDeviceStats() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    int cudaDeviceId = 0;
+    cudaGetDevice(&cudaDeviceId);
+
+    const auto it = _deviceHeapPerId.find(cudaDeviceId);
+    return (it != _deviceHeapPerId.end()) ? it->second.stats : MemoryPoolStats();
+}
+
+void MemoryPool::logStats() const
+{
+    int cudaDeviceId = 0;
+    cudaGetDevice(&cudaDeviceId);
+
+    const MemoryPoolStats hostStats = getPinnedHostStats();
+    const MemoryPoolStats deviceStats = getDeviceStats();
+
+    ALICEVISION_LOG_INFO("Memory pool (device id: " << cudaDeviceId << "):" << std::endl
+                                                    << "\t- device allocations: " << deviceStats.nbAllocations << " (" << deviceStats.nbReuses
+                                                    << " reused)" << std::endl
+                                                    << "\t- device peak: " << toMB(deviceStats.peakUsedBytes) << " MB" << std::endl
+                                                    << "\t- device cached: " << toMB(deviceStats.cachedBytes) << " MB" << std::endl
+                                                    << "\t- device fragmentation: " << deviceStats.getFragmentation() * 100.0 << " %" << std::endl
+                                                    << "\t- pinned host allocations: " << hostStats.nbAllocations << " (" << hostStats.nbReuses
+                                                    << " reused)" << std::endl
+                                                    << "\t- pinned host peak: " << toMB(hostStats.peakUsedBytes) << " MB" << std::endl
+                                                    << "\t- pinned host cached: " << toMB(hostStats.cachedBytes) << " MB" << std::endl
+                                                    << "\t- pinned host fragmentation: " << hostStats.getFragmentation() * 100.0 << " %");
+}
+
+void* MemoryPool::popIdleBlock(Heap& heap, std::size_t blockBytes, std::size_t bytes)
+{
+    auto it = heap.idleBlocks.find(blockBytes);
+    if (it == heap.idleBlocks.end() || it->second.empty())
+        return nullptr;
+
+    void* ptr = it->second.back();
+    it->second.pop_back();
+
+    heap.stats.cachedBytes -= blockBytes;
+    heap.stats.nbReuses++;
+    pushUsedBlock(heap, ptr, blockBytes, bytes);
+    return ptr;
+}
+
+void MemoryPool::pushUsedBlock(Heap& heap, void* ptr, std::size_t blockBytes, std::size_t bytes)
+{
+    heap.usedBlocks[ptr] = bytes;
+
+    MemoryPoolStats& stats = heap.stats;
+    stats.nbAllocations++;
+    stats.usedBytes += blockBytes;
+    stats.peakUsedBytes = std::max(stats.peakUsedBytes, stats.usedBytes);
+    stats.totalRequestedBytes += bytes;
+    stats.totalBlockBytes += blockBytes;
+}
+
+cudaError_t MemoryPool::releaseIdleBlocks(Heap& heap, bool isDevice)
+{
+    cudaError_t result = cudaSuccess;
+
+    for (auto& classPair : heap.idleBlocks)
+    {
+        for (void* ptr : classPair.second)
+        {
+            const cudaError_t err = isDevice ? cudaFree(ptr) : cudaFreeHost(ptr);
+            if (err != cudaSuccess)
+                result = err;
+        }
+    }
+
+    heap.idleBlocks.clear();
+    heap.stats.cachedBytes = 0;
+    return result;
+}
+
+}  // namespace depthMap
+}  // namespace aliceVision
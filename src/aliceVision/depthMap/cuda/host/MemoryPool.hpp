@@ -0,0 +1,162 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <cuda_runtime.h>
+
+#include <cstddef>
+#include <map>
+#include <mutex>
+#include <vector>
+
+namespace aliceVision {
+namespace depthMap {
+
+/**
+ * @struct Memory pool statistics
+ * @brief Allocation statistics of the pinned host memory or of the memory of one device.
+ */
+struct MemoryPoolStats
+{
+    /// number of allocation requests
+    std::size_t nbAllocations = 0;
+    /// number of allocation requests served by an idle block
+    std::size_t nbReuses = 0;
+    /// bytes of the blocks currently in use
+    std::size_t usedBytes = 0;
+    /// peak bytes of the blocks in use
+    std::size_t peakUsedBytes = 0;
+    /// bytes of the idle blocks kept for reuse
+    std::size_t cachedBytes = 0;
+    /// total bytes requested by all the allocations
+    std::size_t totalRequestedBytes = 0;
+    /// total bytes of the blocks of all the allocations
+    std::size_t totalBlockBytes = 0;
+
+    /**
+     * @brief Get the fragmentation, i.e. the ratio of the block bytes lost in the size class rounding.
+     * @return fragmentation in [0, 1]
+     */
+    double getFragmentation() const
+    {
+        return (totalBlockBytes > 0) ? double(totalBlockBytes - totalRequestedBytes) / double(totalBlockBytes) : 0.0;
+    }
+};
+
+/**
+ * @class Memory pool
+ * @brief This singleton keeps the freed pinned host and device memory blocks for reuse.
+ *
+ * The blocks are sorted in size classes, the freed blocks are reused by the next allocations
+ * of the same size class (i.e. across tiles and R cameras) instead of being released.
+ * Device blocks are kept per CUDA device, the device used is the current device of the calling thread.
+ */
+class MemoryPool
+{
+  public:
+    static MemoryPool& getInstance()
+    {
+        static MemoryPool instance;
+        return instance;
+    }
+
+    // Singleton, no copy constructor
+    MemoryPool(MemoryPool const&) = delete;
+
+    // Singleton, no copy operator
+    void operator=(MemoryPool const&) = delete;
+
+    /**
+     * @brief Get the size class of an allocation.
+     * @param[in] bytes the requested number of bytes
+     * @return the number of bytes of the block
+     */
+    static std::size_t getSizeClass(std::size_t bytes);
+
+    /**
+     * @brief Get the pitch of a pitched device allocation on the current device.
+     * @param[in] rowBytes the unpadded number of bytes in a row
+     * @return the padded number of bytes in a row
+     */
+    std::size_t getDevicePitch(std::size_t rowBytes);
+
+    /**
+     * @brief Allocate a pinned host memory block.
+     * @param[out] ptr the block pointer
+     * @param[in] bytes the requested number of bytes
+     * @return cudaSuccess or the cudaMallocHost error
+     */
+    cudaError_t allocatePinnedHost(void** ptr, std::size_t bytes);
+
+    /**
+     * @brief Give back a pinned host memory block to the pool.
+     * @param[in] ptr the block pointer
+     * @return cudaSuccess or the cudaFreeHost error
+     */
+    cudaError_t deallocatePinnedHost(void* ptr);
+
+    /**
+     * @brief Allocate a memory block on the current device.
+     * @param[out] ptr the block pointer
+     * @param[in] bytes the requested number of bytes
+     * @return cudaSuccess or the cudaMalloc error
+     */
+    cudaError_t allocateDevice(void** ptr, std::size_t bytes);
+
+    /**
+     * @brief Give back a device memory block to the pool.
+     * @param[in] ptr the block pointer
+     * @return cudaSuccess or the cudaFree error
+     */
+    cudaError_t deallocateDevice(void* ptr);
+
+    /**
+     * @brief Release the idle pinned host blocks and the idle blocks of the current device.
+     */
+    void release();
+
+    /**
+     * @brief Get the pinned host memory statistics.
+     */
+    MemoryPoolStats getPinnedHostStats() const;
+
+    /**
+     * @brief Get the current device memory statistics.
+     */
+    MemoryPoolStats getDeviceStats() const;
+
+    /**
+     * @brief Log the pinned host and the current device memory statistics.
+     */
+    void logStats() const;
+
+  private:
+    MemoryPool() = default;
+    ~MemoryPool();
+
+    struct Heap
+    {
+        /// idle blocks per size class
+        std::map<std::size_t, std::vector<void*>> idleBlocks;
+        /// requested bytes per block in use
+        std::map<void*, std::size_t> usedBlocks;
+        /// allocation statistics
+        MemoryPoolStats stats;
+    };
+
+    void* popIdleBlock(Heap& heap, std::size_t blockBytes, std::size_t bytes);
+    void pushUsedBlock(Heap& heap, void* ptr, std::size_t blockBytes, std::size_t bytes);
+    cudaError_t releaseIdleBlocks(Heap& heap, bool isDevice);
+
+    Heap _pinnedHostHeap;
+    std::map<int, Heap> _deviceHeapPerId;
+    std::map<int, std::size_t> _pitchAlignmentPerId;
+    mutable std::mutex _mutex;
+};
+
+}  // namespace depthMap
+}  // namespace aliceVision
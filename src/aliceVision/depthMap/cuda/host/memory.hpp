@@ -16,6 +16,7 @@
 #endif
 
 #include <aliceVision/depthMap/cuda/host/utils.hpp>
+#include <aliceVision/depthMap/cuda/host/MemoryPool.hpp>
 #include <aliceVision/system/Logger.hpp>
 
 #include <cuda_runtime.h>
@@ -390,7 +391,8 @@ class CudaHostMemoryHeap : public CudaMemorySizeBase<Type, Dim>
     {
         this->setSize(size, true);
 
-        cudaError_t err = cudaMallocHost(&buffer, this->getBytesUnpadded());
+        // reuse a pinned host memory block of the same size class if possible
+        cudaError_t err = MemoryPool::getInstance().allocatePinnedHost((void**)&buffer, this->getBytesUnpadded());
 
         THROW_ON_CUDA_ERROR(err, "Could not allocate pinned host memory in " << __FILE__ << ":" << __LINE__ << ", " << cudaGetErrorString(err));
     }
@@ -399,7 +401,7 @@ class CudaHostMemoryHeap : public CudaMemorySizeBase<Type, Dim>
     {
         if (buffer == nullptr)
             return;
-        cudaFreeHost(buffer);
+        MemoryPool::getInstance().deallocatePinnedHost(buffer);
         buffer = nullptr;
     }
 };
@@ -477,9 +479,14 @@ class CudaDeviceMemoryPitched : public CudaMemorySizeBase<Type, Dim>
     {
         this->setSize(size, false);
 
+        // the pitch is computed as cudaMallocPitch / cudaMalloc3D would do,
+        // in order to reuse a device memory block of the same size class if possible
+        MemoryPool& memoryPool = MemoryPool::getInstance();
+        this->setPitch(memoryPool.getDevicePitch(this->getUnpaddedBytesInRow()));
+
         if (Dim == 2)
         {
-            cudaError_t err = cudaMallocPitch<Type>(&buffer, &this->getPitchRef(), this->getUnpaddedBytesInRow(), this->getUnitsInDim(1));
+            cudaError_t err = memoryPool.allocateDevice((void**)&buffer, this->getBytesPadded());
             if (err != cudaSuccess)
             {
                 int devid;
@@ -493,12 +500,7 @@ class CudaDeviceMemoryPitched : public CudaMemorySizeBase<Type, Dim>
         }
         else if (Dim == 3)
         {
-            cudaExtent extent;
-            extent.width = this->getUnpaddedBytesInRow();
-            extent.height = this->getUnitsInDim(1);
-            extent.depth = this->getUnitsInDim(2);
-            cudaPitchedPtr pitchDevPtr;
-            cudaError_t err = cudaMalloc3D(&pitchDevPtr, extent);
+            cudaError_t err = memoryPool.allocateDevice((void**)&buffer, this->getBytesPadded());
             if (err != cudaSuccess)
             {
                 int devid;
@@ -514,11 +516,8 @@ class CudaDeviceMemoryPitched : public CudaMemorySizeBase<Type, Dim>
                 throw std::runtime_error(ss.str());
             }
 
-            buffer = (Type*)pitchDevPtr.ptr;
-            this->setPitch(pitchDevPtr.pitch);
-
             ALICEVISION_LOG_DEBUG("GPU 3D allocation: " << this->getUnitsInDim(0) << "x" << this->getUnitsInDim(1) << "x" << this->getUnitsInDim(2)
-                                                        << ", type size=" << sizeof(Type) << ", pitch=" << pitchDevPtr.pitch);
+                                                        << ", type size=" << sizeof(Type) << ", pitch=" << this->getPitch());
             ALICEVISION_LOG_DEBUG("                 : "
                                   << this->getBytesUnpadded() << ", padded=" << this->getBytesPadded()
                                   << ", wasted=" << this->getBytesPadded() - this->getBytesUnpadded() << ", wasted ratio="
@@ -535,7 +534,7 @@ class CudaDeviceMemoryPitched : public CudaMemorySizeBase<Type, Dim>
         if (buffer == nullptr)
             return;
 
-        cudaError_t err = cudaFree(buffer);
+        cudaError_t err = MemoryPool::getInstance().deallocateDevice(buffer);
         if (err != cudaSuccess)
         {
             std::stringstream ss;
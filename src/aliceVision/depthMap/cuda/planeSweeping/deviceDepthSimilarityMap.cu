@@ -262,5 +262,43 @@ __host__ void cuda_depthSimMapOptimizeGradientDescent(CudaDeviceMemoryPitched<fl
     CHECK_CUDA_ERROR();
 }
 
+__host__ void cuda_depthSimMapFilterConsistency(CudaDeviceMemoryPitched<float2, 2>& out_depthSimMap_dmp,
+                                                CudaDeviceMemoryPitched<unsigned char, 2>& out_nbConsistentCamsMap_dmp,
+                                                const CudaDeviceMemoryPitched<float2, 2>& in_depthSimMap_dmp,
+                                                const CudaDeviceMemory<DeviceFilterTCam>& in_tcams_dmem,
+                                                const int nbTCams,
+                                                const int rcDeviceCameraParamsId,
+                                                const DepthMapFilterParams& filterParams,
+                                                cudaStream_t stream)
+{
+    const CudaSize<2>& depthSimMapDim = in_depthSimMap_dmp.getSize();
+
+    // kernel launch parameters
+    const dim3 block(16, 16, 1);
+    const dim3 grid(divUp(depthSimMapDim.x(), block.x), divUp(depthSimMapDim.y(), block.y), 1);
+
+    // kernel execution
+    depthSimMapFilterConsistency_kernel<<<grid, block, 0, stream>>>(
+        out_depthSimMap_dmp.getBuffer(),
+        out_depthSimMap_dmp.getPitch(),
+        out_nbConsistentCamsMap_dmp.getBuffer(),
+        out_nbConsistentCamsMap_dmp.getPitch(),
+        in_depthSimMap_dmp.getBuffer(),
+        in_depthSimMap_dmp.getPitch(),
+        in_tcams_dmem.getBuffer(),
+        nbTCams,
+        rcDeviceCameraParamsId,
+        int(depthSimMapDim.x()),
+        int(depthSimMapDim.y()),
+        filterParams.pixToleranceFactor,
+        filterParams.pixSizeBall,
+        filterParams.pixSizeBallWithLowSimilarity,
+        filterParams.minNumOfConsistentCams,
+        filterParams.minNumOfConsistentCamsWithLowSimilarity);
+
+    // check cuda last error
+    CHECK_CUDA_ERROR();
+}
+
 } // namespace depthMap
 } // namespace aliceVision
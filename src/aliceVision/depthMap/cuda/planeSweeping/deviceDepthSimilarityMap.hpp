@@ -9,12 +9,25 @@
 #include <aliceVision/mvsData/ROI.hpp>
 #include <aliceVision/depthMap/SgmParams.hpp>
 #include <aliceVision/depthMap/RefineParams.hpp>
+#include <aliceVision/depthMap/DepthMapFilterParams.hpp>
 #include <aliceVision/depthMap/cuda/host/memory.hpp>
 #include <aliceVision/depthMap/cuda/host/DeviceMipmapImage.hpp>
 
 namespace aliceVision {
 namespace depthMap {
 
+/**
+ * @struct DeviceFilterTCam
+ * @brief T camera used by the depth map consistency filter, its depth map is resident in device memory.
+ */
+struct DeviceFilterTCam
+{
+    cudaTextureObject_t depthMapTex;  //< T camera depth map texture (nearest neighbor, unnormalized coordinates)
+    int deviceCameraParamsId;         //< T camera parameters id for array in device constant memory
+    int width;                        //< T camera depth map width
+    int height;                       //< T camera depth map height
+};
+
 /**
  * @brief Copy depth and default from input depth/sim map to another depth/sim map.
  * @param[out] out_depthSimMap_dmp the output depth/sim map
@@ -111,5 +124,27 @@ extern void cuda_depthSimMapOptimizeGradientDescent(CudaDeviceMemoryPitched<floa
                                                     const ROI& roi,
                                                     cudaStream_t stream);
 
+/**
+ * @brief Filter a depth/sim map by its consistency with the depth maps of the T cameras.
+ *        For each R pixel, a T camera is consistent if a T pixel around the projection of the R point
+ *        is back-projected near the R pixel at the same depth, up to the pixel size tolerance.
+ * @param[out] out_depthSimMap_dmp the output filtered depth/sim map
+ * @param[out] out_nbConsistentCamsMap_dmp the output number of consistent T cameras per pixel
+ * @param[in] in_depthSimMap_dmp the input depth/sim map
+ * @param[in] in_tcams_dmem the T cameras in device memory
+ * @param[in] nbTCams the number of T cameras
+ * @param[in] rcDeviceCameraParamsId the R camera parameters id for array in device constant memory
+ * @param[in] filterParams the depth map filter parameters
+ * @param[in] stream the stream for gpu execution
+ */
+extern void cuda_depthSimMapFilterConsistency(CudaDeviceMemoryPitched<float2, 2>& out_depthSimMap_dmp,
+                                              CudaDeviceMemoryPitched<unsigned char, 2>& out_nbConsistentCamsMap_dmp,
+                                              const CudaDeviceMemoryPitched<float2, 2>& in_depthSimMap_dmp,
+                                              const CudaDeviceMemory<DeviceFilterTCam>& in_tcams_dmem,
+                                              const int nbTCams,
+                                              const int rcDeviceCameraParamsId,
+                                              const DepthMapFilterParams& filterParams,
+                                              cudaStream_t stream);
+
 }  // namespace depthMap
 }  // namespace aliceVision
@@ -12,6 +12,7 @@
 #include <aliceVision/depthMap/cuda/device/Patch.cuh>
 #include <aliceVision/depthMap/cuda/device/eig33.cuh>
 #include <aliceVision/depthMap/cuda/device/DeviceCameraParams.hpp>
+#include <aliceVision/depthMap/cuda/planeSweeping/deviceDepthSimilarityMap.hpp>
 
 // compute per pixel pixSize instead of using Sgm depth thickness
 //#define ALICEVISION_DEPTHMAP_COMPUTE_PIXSIZEMAP
@@ -607,5 +608,158 @@ __global__ void optimize_depthSimMap_kernel(float2* out_optimizeDepthSimMap_d, i
     *out_optDepthSimPtr = out_optDepthSim;
 }
 
+/**
+ * @brief Get the size in 3d space of one pixel offset along the epipolar line in the T camera,
+ *        averaged with the size of one pixel in the R camera, as in MultiViewParams::getCamPixelSizePlaneSweepAlpha.
+ * @param[in] rcDeviceCamParams the R camera parameters
+ * @param[in] tcDeviceCamParams the T camera parameters
+ * @param[in] p the 3d point
+ * @return the pixel size at the 3d point
+ */
+__device__ float getRcTcPixSize(const DeviceCameraParams& rcDeviceCamParams, const DeviceCameraParams& tcDeviceCamParams, const float3& p)
+{
+    const float rcPixSize = computePixSize(rcDeviceCamParams, p);
+
+    float2 rpix;
+    float2 tpix;
+    float2 tpixFar;
+    getPixelFor3DPoint(rpix, rcDeviceCamParams, p);
+    getPixelFor3DPoint(tpix, tcDeviceCamParams, p);
+    getPixelFor3DPoint(tpixFar, tcDeviceCamParams, rcDeviceCamParams.C + (p - rcDeviceCamParams.C) * 2.0f);
+
+    // epipolar direction in the T camera, towards the far points of the R ray
+    const float2 epipolarVect = tpixFar - tpix;
+    const float epipolarLength = size(epipolarVect);
+
+    if(epipolarLength < 1e-6f)
+        return rcPixSize;
+
+    const float3 p1 = triangulateMatchRef(rcDeviceCamParams, tcDeviceCamParams, rpix, tpix + epipolarVect / epipolarLength);
+    const float rcTcPixSize = size(p - p1);
+
+    // fallback to the R pixel size if the triangulation fails
+    if(!isfinite(rcTcPixSize))
+        return rcPixSize;
+
+    return (rcTcPixSize + rcPixSize) * 0.5f;
+}
+
+__global__ void depthSimMapFilterConsistency_kernel(float2* out_depthSimMap_d, int out_depthSimMap_p,
+                                                    unsigned char* out_nbConsistentCamsMap_d, int out_nbConsistentCamsMap_p,
+                                                    const float2* in_depthSimMap_d, int in_depthSimMap_p,
+                                                    const DeviceFilterTCam* in_tcams_d,
+                                                    const int nbTCams,
+                                                    const int rcDeviceCameraParamsId,
+                                                    const int width,
+                                                    const int height,
+                                                    const float pixToleranceFactor,
+                                                    const int pixSizeBall,
+                                                    const int pixSizeBallWithLowSimilarity,
+                                                    const int minNbConsistentCams,
+                                                    const int minNbConsistentCamsWithLowSimilarity)
+{
+    const int x = blockIdx.x * blockDim.x + threadIdx.x;
+    const int y = blockIdx.y * blockDim.y + threadIdx.y;
+
+    if(x >= width || y >= height)
+        return;
+
+    // R camera parameters
+    const DeviceCameraParams& rcDeviceCamParams = constantCameraParametersArray_d[rcDeviceCameraParamsId];
+
+    const float2 in_depthSim = *get2DBufferAt(in_depthSimMap_d, in_depthSimMap_p, x, y);
+    float2 out_depthSim = in_depthSim;
+    int nbConsistentCams = 0;
+
+    if(in_depthSim.x > 0.0f)
+    {
+        const float3 p = get3DPointForPixelAndDepthFromRC(rcDeviceCamParams, make_float2(float(x), float(y)), in_depthSim.x);
+
+        // T pixels around the projection of the R point that can be back-projected in the R pixel ball
+        const int searchRadius = max(pixSizeBall, pixSizeBallWithLowSimilarity) + 1;
+
+        for(int c = 0; c < nbTCams; ++c)
+        {
+            const DeviceFilterTCam& tcam = in_tcams_d[c];
+            const DeviceCameraParams& tcDeviceCamParams = constantCameraParametersArray_d[tcam.deviceCameraParamsId];
+
+            float2 tpix;
+            getPixelFor3DPoint(tpix, tcDeviceCamParams, p);
+
+            const int tx0 = int(floorf(tpix.x + 0.5f));
+            const int ty0 = int(floorf(tpix.y + 0.5f));
+
+            // the R point is behind or outside the T camera
+            if(tx0 < -searchRadius || ty0 < -searchRadius || tx0 >= tcam.width + searchRadius || ty0 >= tcam.height + searchRadius)
+                continue;
+
+            bool consistent = false;
+
+            for(int ty = max(0, ty0 - searchRadius); ty <= min(tcam.height - 1, ty0 + searchRadius) && !consistent; ++ty)
+            {
+                for(int tx = max(0, tx0 - searchRadius); tx <= min(tcam.width - 1, tx0 + searchRadius) && !consistent; ++tx)
+                {
+                    // note: we do not use 0.5f offset because the depth texture use nearest neighbor interpolation
+                    const float tDepth = tex2D<float>(tcam.depthMapTex, float(tx), float(ty));
+
+                    if(tDepth <= 0.0f)
+                        continue;
+
+                    const float3 tp = get3DPointForPixelAndDepthFromRC(tcDeviceCamParams, make_float2(float(tx), float(ty)), tDepth);
+
+                    float2 rpix;
+                    getPixelFor3DPoint(rpix, rcDeviceCamParams, tp);
+
+                    const int rx = int(floorf(rpix.x + 0.5f));
+                    const int ry = int(floorf(rpix.y + 0.5f));
+
+                    if(rx < 0 || ry < 0 || rx >= width || ry >= height)
+                        continue;
+
+                    // the ball size depends on the similarity of the R pixel where the T point is projected
+                    const float rSim = get2DBufferAt(in_depthSimMap_d, in_depthSimMap_p, rx, ry)->y;
+                    const int pixBall = (rSim >= 1.0f) ? pixSizeBallWithLowSimilarity : pixSizeBall;
+
+                    if(abs(rx - x) > pixBall || abs(ry - y) > pixBall)
+                        continue;
+
+                    const float pixSize = pixToleranceFactor * getRcTcPixSize(rcDeviceCamParams, tcDeviceCamParams, tp);
+
+                    if(fabsf(size(tp - rcDeviceCamParams.C) - in_depthSim.x) < pixSize)
+                        consistent = true;
+                }
+            }
+
+            if(consistent)
+                ++nbConsistentCams;
+        }
+    }
+
+    // if the point is part of a mask (alpha) skip
+    if(in_depthSim.x > -2.0f)
+    {
+        // if the R point is consistent in enough T cameras and is weakly supported, make it strongly supported
+        if((nbConsistentCams >= minNbConsistentCamsWithLowSimilarity - 1) && (out_depthSim.y >= 1.0f))
+        {
+            out_depthSim.y = out_depthSim.y - 2.0f;
+        }
+
+        // if it is consistent in only one T camera and is weakly supported, remove it
+        if((nbConsistentCams <= 1) && (out_depthSim.y >= 1.0f))
+        {
+            out_depthSim = make_float2(-1.0f, 1.0f);
+        }
+
+        // if it is not consistent in the minimal number of T cameras and is strongly supported, remove it
+        if((nbConsistentCams < minNbConsistentCams - 1) && (out_depthSim.y < 1.0f))
+        {
+            out_depthSim = make_float2(-1.0f, 1.0f);
+        }
+    }
+
+    *get2DBufferAt(out_depthSimMap_d, out_depthSimMap_p, x, y) = out_depthSim;
+    *get2DBufferAt(out_nbConsistentCamsMap_d, out_nbConsistentCamsMap_p, x, y) = (unsigned char)(min(nbConsistentCams, 255));
+}
+
 } // namespace depthMap
 } // namespace aliceVision
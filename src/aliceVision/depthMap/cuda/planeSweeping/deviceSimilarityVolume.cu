@@ -9,6 +9,7 @@
 
 #include <aliceVision/depthMap/cuda/host/divUp.hpp>
 
+#include <algorithm>
 #include <map>
 
 namespace aliceVision {
@@ -54,6 +55,57 @@ __host__ dim3 getMaxPotentialBlockSize(T kernelFuction)
     return defaultBlock;
 }
 
+/**
+ * @brief Get the compute similarity kernel to use for the given patch parameters.
+ *        Common patch half-widths without custom patch pattern use a kernel specialized at compile time
+ *        (fully unrolled patch loops), other settings use the generic kernel.
+ *
+ * @param[in] wsh the patch half-width
+ * @param[in] useCustomPatchPattern enable user custom patch pattern for similarity volume computation
+ *
+ * @return kernel function to launch
+ */
+__host__ auto getComputeSimilarityKernel(int wsh, bool useCustomPatchPattern) -> decltype(&volume_computeSimilarity_kernel<0>)
+{
+    if(!useCustomPatchPattern)
+    {
+        switch(wsh)
+        {
+            case 2: return &volume_computeSimilarity_kernel<2>;
+            case 3: return &volume_computeSimilarity_kernel<3>;
+            case 4: return &volume_computeSimilarity_kernel<4>; // SGM default
+            case 5: return &volume_computeSimilarity_kernel<5>;
+            default: break;
+        }
+    }
+    return &volume_computeSimilarity_kernel<0>; // generic kernel
+}
+
+/**
+ * @brief Get the refine similarity kernel to use for the given patch parameters.
+ * @see getComputeSimilarityKernel
+ *
+ * @param[in] wsh the patch half-width
+ * @param[in] useCustomPatchPattern enable user custom patch pattern for similarity volume computation
+ *
+ * @return kernel function to launch
+ */
+__host__ auto getRefineSimilarityKernel(int wsh, bool useCustomPatchPattern) -> decltype(&volume_refineSimilarity_kernel<0>)
+{
+    if(!useCustomPatchPattern)
+    {
+        switch(wsh)
+        {
+            case 2: return &volume_refineSimilarity_kernel<2>;
+            case 3: return &volume_refineSimilarity_kernel<3>; // Refine default
+            case 4: return &volume_refineSimilarity_kernel<4>;
+            case 5: return &volume_refineSimilarity_kernel<5>;
+            default: break;
+        }
+    }
+    return &volume_refineSimilarity_kernel<0>; // generic kernel
+}
+
 __host__ void cuda_volumeInitialize(CudaDeviceMemoryPitched<TSim, 3>& inout_volume_dmp, TSim value, cudaStream_t stream)
 {
     // get input/output volume dimensions
@@ -155,6 +207,7 @@ __host__ void cuda_volumeUpdateUninitializedSimilarity(const CudaDeviceMemoryPit
 __host__ void cuda_volumeComputeSimilarity(CudaDeviceMemoryPitched<TSim, 3>& out_volBestSim_dmp,
                                            CudaDeviceMemoryPitched<TSim, 3>& out_volSecBestSim_dmp,
                                            const CudaDeviceMemoryPitched<float, 2>& in_depths_dmp,
+                                           const CudaDeviceMemoryPitched<int2, 2>* in_depthIndexRangeMap_dmpPtr,
                                            const int rcDeviceCameraParamsId,
                                            const int tcDeviceCameraParamsId,
                                            const DeviceMipmapImage& rcDeviceMipmapImage,
@@ -169,12 +222,15 @@ __host__ void cuda_volumeComputeSimilarity(CudaDeviceMemoryPitched<TSim, 3>& out
     const CudaSize<2> rcLevelDim = rcDeviceMipmapImage.getDimensions(sgmParams.scale);
     const CudaSize<2> tcLevelDim = tcDeviceMipmapImage.getDimensions(sgmParams.scale);
 
+    // kernel specialized for the patch half-width if possible
+    const auto kernel = getComputeSimilarityKernel(sgmParams.wsh, sgmParams.useCustomPatchPattern);
+
     // kernel launch parameters
-    const dim3 block = getMaxPotentialBlockSize(volume_computeSimilarity_kernel);
+    const dim3 block = getMaxPotentialBlockSize(kernel);
     const dim3 grid(divUp(roi.width(), block.x), divUp(roi.height(), block.y), depthRange.size());
 
     // kernel execution
-    volume_computeSimilarity_kernel<<<grid, block, 0, stream>>>(
+    kernel<<<grid, block, 0, stream>>>(
         out_volBestSim_dmp.getBuffer(),
         out_volBestSim_dmp.getBytesPaddedUpToDim(1),
         out_volBestSim_dmp.getBytesPaddedUpToDim(0),
@@ -183,6 +239,8 @@ __host__ void cuda_volumeComputeSimilarity(CudaDeviceMemoryPitched<TSim, 3>& out
         out_volSecBestSim_dmp.getBytesPaddedUpToDim(0),
         in_depths_dmp.getBuffer(),
         in_depths_dmp.getBytesPaddedUpToDim(0),
+        (in_depthIndexRangeMap_dmpPtr == nullptr) ? nullptr : in_depthIndexRangeMap_dmpPtr->getBuffer(),
+        (in_depthIndexRangeMap_dmpPtr == nullptr) ? 0 : in_depthIndexRangeMap_dmpPtr->getBytesPaddedUpToDim(0),
         rcDeviceCameraParamsId,
         tcDeviceCameraParamsId,
         rcDeviceMipmapImage.getTextureObject(),
@@ -205,57 +263,105 @@ __host__ void cuda_volumeComputeSimilarity(CudaDeviceMemoryPitched<TSim, 3>& out
     CHECK_CUDA_ERROR();
 }
 
+__host__ void cuda_volumeComputeDepthIndexRange(CudaDeviceMemoryPitched<int2, 2>& out_depthIndexRangeMap_dmp,
+                                                const CudaDeviceMemoryPitched<TSim, 3>& in_coarseVolSim_dmp,
+                                                const int coarseFactor,
+                                                const int bandHalfSize,
+                                                const Range& depthRange,
+                                                const ROI& coarseRoi,
+                                                const ROI& roi,
+                                                cudaStream_t stream)
+{
+    // kernel launch parameters
+    const dim3 block = getMaxPotentialBlockSize(volume_computeDepthIndexRange_kernel);
+    const dim3 grid(divUp(roi.width(), block.x), divUp(roi.height(), block.y), 1);
+
+    // kernel execution
+    volume_computeDepthIndexRange_kernel<<<grid, block, 0, stream>>>(
+        out_depthIndexRangeMap_dmp.getBuffer(),
+        out_depthIndexRangeMap_dmp.getBytesPaddedUpToDim(0),
+        in_coarseVolSim_dmp.getBuffer(),
+        in_coarseVolSim_dmp.getBytesPaddedUpToDim(1),
+        in_coarseVolSim_dmp.getBytesPaddedUpToDim(0),
+        coarseFactor,
+        bandHalfSize,
+        depthRange,
+        coarseRoi,
+        roi);
+
+    // check cuda last error
+    CHECK_CUDA_ERROR();
+}
+
 extern void cuda_volumeRefineSimilarity(CudaDeviceMemoryPitched<TSimRefine, 3>& inout_volSim_dmp, 
                                         const CudaDeviceMemoryPitched<float2, 2>& in_sgmDepthPixSizeMap_dmp,
                                         const CudaDeviceMemoryPitched<float3, 2>* in_sgmNormalMap_dmpPtr,
                                         const int rcDeviceCameraParamsId,
-                                        const int tcDeviceCameraParamsId,
+                                        const std::vector<int>& tcDeviceCameraParamsIds,
                                         const DeviceMipmapImage& rcDeviceMipmapImage,
-                                        const DeviceMipmapImage& tcDeviceMipmapImage,
+                                        const std::vector<const DeviceMipmapImage*>& tcDeviceMipmapImages,
                                         const RefineParams& refineParams, 
                                         const Range& depthRange,
                                         const ROI& roi,
                                         cudaStream_t stream)
 {
-    // get mipmap images level and dimensions
+    // get R mipmap image level and dimensions
     const float rcMipmapLevel = rcDeviceMipmapImage.getLevel(refineParams.scale);
     const CudaSize<2> rcLevelDim = rcDeviceMipmapImage.getDimensions(refineParams.scale);
-    const CudaSize<2> tcLevelDim = tcDeviceMipmapImage.getDimensions(refineParams.scale);
+
+    // kernel specialized for the patch half-width if possible
+    const auto kernel = getRefineSimilarityKernel(refineParams.wsh, refineParams.useCustomPatchPattern);
 
     // kernel launch parameters
-    const dim3 block = getMaxPotentialBlockSize(volume_refineSimilarity_kernel);
+    const dim3 block = getMaxPotentialBlockSize(kernel);
     const dim3 grid(divUp(roi.width(), block.x), divUp(roi.height(), block.y), depthRange.size());
 
-    // kernel execution
-    volume_refineSimilarity_kernel<<<grid, block, 0, stream>>>(
-        inout_volSim_dmp.getBuffer(),
-        inout_volSim_dmp.getBytesPaddedUpToDim(1),
-        inout_volSim_dmp.getBytesPaddedUpToDim(0),
-        in_sgmDepthPixSizeMap_dmp.getBuffer(),
-        in_sgmDepthPixSizeMap_dmp.getBytesPaddedUpToDim(0),
-        (in_sgmNormalMap_dmpPtr == nullptr) ? nullptr : in_sgmNormalMap_dmpPtr->getBuffer(),
-        (in_sgmNormalMap_dmpPtr == nullptr) ? 0 : in_sgmNormalMap_dmpPtr->getBytesPaddedUpToDim(0),
-        rcDeviceCameraParamsId,
-        tcDeviceCameraParamsId,
-        rcDeviceMipmapImage.getTextureObject(),
-        tcDeviceMipmapImage.getTextureObject(),
-        (unsigned int)(rcLevelDim.x()),
-        (unsigned int)(rcLevelDim.y()),
-        (unsigned int)(tcLevelDim.x()),
-        (unsigned int)(tcLevelDim.y()),
-        rcMipmapLevel,
-        int(inout_volSim_dmp.getSize().z()), 
-        refineParams.stepXY,
-        refineParams.wsh, 
-        (1.f / float(refineParams.gammaC)), // inverted gammaC
-        (1.f / float(refineParams.gammaP)), // inverted gammaP
-        refineParams.useConsistentScale,
-        refineParams.useCustomPatchPattern,
-        depthRange,
-        roi);
+    // T cameras are processed by batches of maximum size in a single kernel launch
+    for(std::size_t firstTc = 0; firstTc < tcDeviceCameraParamsIds.size(); firstTc += DeviceRefineTCams::maxTCams)
+    {
+        DeviceRefineTCams tcams;
+        tcams.nbTCams = int(std::min(tcDeviceCameraParamsIds.size() - firstTc, std::size_t(DeviceRefineTCams::maxTCams)));
+
+        for(int i = 0; i < tcams.nbTCams; ++i)
+        {
+            // get T mipmap image dimensions
+            const DeviceMipmapImage& tcDeviceMipmapImage = *(tcDeviceMipmapImages.at(firstTc + i));
+            const CudaSize<2> tcLevelDim = tcDeviceMipmapImage.getDimensions(refineParams.scale);
+
+            tcams.deviceCameraParamsIds[i] = tcDeviceCameraParamsIds.at(firstTc + i);
+            tcams.mipmapImages_tex[i] = tcDeviceMipmapImage.getTextureObject();
+            tcams.levelWidths[i] = (unsigned int)(tcLevelDim.x());
+            tcams.levelHeights[i] = (unsigned int)(tcLevelDim.y());
+        }
+
+        // kernel execution
+        kernel<<<grid, block, 0, stream>>>(
+            inout_volSim_dmp.getBuffer(),
+            inout_volSim_dmp.getBytesPaddedUpToDim(1),
+            inout_volSim_dmp.getBytesPaddedUpToDim(0),
+            in_sgmDepthPixSizeMap_dmp.getBuffer(),
+            in_sgmDepthPixSizeMap_dmp.getBytesPaddedUpToDim(0),
+            (in_sgmNormalMap_dmpPtr == nullptr) ? nullptr : in_sgmNormalMap_dmpPtr->getBuffer(),
+            (in_sgmNormalMap_dmpPtr == nullptr) ? 0 : in_sgmNormalMap_dmpPtr->getBytesPaddedUpToDim(0),
+            rcDeviceCameraParamsId,
+            tcams,
+            rcDeviceMipmapImage.getTextureObject(),
+            (unsigned int)(rcLevelDim.x()),
+            (unsigned int)(rcLevelDim.y()),
+            rcMipmapLevel,
+            int(inout_volSim_dmp.getSize().z()), 
+            refineParams.stepXY,
+            refineParams.wsh, 
+            (1.f / float(refineParams.gammaC)), // inverted gammaC
+            (1.f / float(refineParams.gammaP)), // inverted gammaP
+            refineParams.useConsistentScale,
+            refineParams.useCustomPatchPattern,
+            depthRange,
+            roi);
 
-    // check cuda last error
-    CHECK_CUDA_ERROR();
+        // check cuda last error
+        CHECK_CUDA_ERROR();
+    }
 }
 
 
@@ -286,6 +392,49 @@ __host__ void cuda_volumeAggregatePath(CudaDeviceMemoryPitched<TSim, 3>& out_vol
     const int3 axisT_ = make_int3(axisT[0], axisT[1], axisT[2]);
     const int ySign = (invY ? -1 : 1);
 
+    // aggregate the whole path in a single kernel launch, one warp per line,
+    // if the path costs of the previous and current slices of each line fit in shared memory
+    {
+        const int nbLinesPerBlock = 4;
+        const size_t sharedMemSize = nbLinesPerBlock * 2 * volDimZ * sizeof(TSimAcc);
+
+        int deviceId = 0;
+        int maxSharedMemPerBlock = 0;
+        CHECK_CUDA_RETURN_ERROR(cudaGetDevice(&deviceId));
+        CHECK_CUDA_RETURN_ERROR(cudaDeviceGetAttribute(&maxSharedMemPerBlock, cudaDevAttrMaxSharedMemoryPerBlock, deviceId));
+
+        if(sharedMemSize <= size_t(maxSharedMemPerBlock))
+        {
+            const dim3 blockLines(32, nbLinesPerBlock, 1); // warp size, lines per block
+            const dim3 gridLines(divUp(volDimX, blockLines.y), 1, 1);
+
+            volume_aggregatePathInLines_kernel<<<gridLines, blockLines, sharedMemSize, stream>>>(
+                rcDeviceMipmapImage.getTextureObject(),
+                (unsigned int)(rcLevelDim.x()),
+                (unsigned int)(rcLevelDim.y()),
+                rcMipmapLevel,
+                in_volSim_dmp.getBuffer(),
+                in_volSim_dmp.getBytesPaddedUpToDim(1),
+                in_volSim_dmp.getBytesPaddedUpToDim(0),
+                out_volAgr_dmp.getBuffer(),
+                out_volAgr_dmp.getBytesPaddedUpToDim(1),
+                out_volAgr_dmp.getBytesPaddedUpToDim(0),
+                volDim_, axisT_,
+                sgmParams.stepXY,
+                sgmParams.p1,
+                sgmParams.p2Weighting,
+                invY,
+                filteringIndex,
+                roi);
+
+            // check cuda last error
+            CHECK_CUDA_ERROR();
+            return;
+        }
+    }
+
+    // otherwise, aggregate slice by slice
+
     // setup block and grid
     const int blockSize = 8;
     const dim3 blockVolXZ(blockSize, blockSize, 1);
@@ -13,6 +13,8 @@
 #include <aliceVision/depthMap/cuda/host/DeviceMipmapImage.hpp>
 #include <aliceVision/depthMap/cuda/planeSweeping/similarity.hpp>
 
+#include <vector>
+
 namespace aliceVision {
 namespace depthMap {
 
@@ -57,6 +59,7 @@ extern void cuda_volumeUpdateUninitializedSimilarity(const CudaDeviceMemoryPitch
  * @param[out] out_volBestSim_dmp the best similarity volume in device memory
  * @param[out] out_volSecBestSim_dmp the second best similarity volume in device memory
  * @param[in] in_depths_dmp the R camera depth list in device memory
+ * @param[in] in_depthIndexRangeMap_dmpPtr the per-pixel depth index range to compute in device memory (or nullptr)
  * @param[in] rcDeviceCameraParamsId the R camera parameters id for array in device constant memory
  * @param[in] tcDeviceCameraParamsId the T camera parameters id for array in device constant memory
  * @param[in] rcDeviceMipmapImage the R mipmap image in device memory container
@@ -69,6 +72,7 @@ extern void cuda_volumeUpdateUninitializedSimilarity(const CudaDeviceMemoryPitch
 extern void cuda_volumeComputeSimilarity(CudaDeviceMemoryPitched<TSim, 3>& out_volBestSim_dmp,
                                          CudaDeviceMemoryPitched<TSim, 3>& out_volSecBestSim_dmp,
                                          const CudaDeviceMemoryPitched<float, 2>& in_depths_dmp,
+                                         const CudaDeviceMemoryPitched<int2, 2>* in_depthIndexRangeMap_dmpPtr,
                                          const int rcDeviceCameraParamsId,
                                          const int tcDeviceCameraParamsId,
                                          const DeviceMipmapImage& rcDeviceMipmapImage,
@@ -79,14 +83,37 @@ extern void cuda_volumeComputeSimilarity(CudaDeviceMemoryPitched<TSim, 3>& out_v
                                          cudaStream_t stream);
 
 /**
- * @brief Refine the best similarity volume for the given RC / TC.
+ * @brief Compute the per-pixel depth index range to compute from a coarse optimized similarity volume.
+ * @note The range of a pixel encloses the best depth indexes of its 3x3 coarse neighbourhood, inflated by the given band.
+ * @param[out] out_depthIndexRangeMap_dmp the output per-pixel depth index range map in device memory
+ * @param[in] in_coarseVolSim_dmp the coarse optimized similarity volume in device memory
+ * @param[in] coarseFactor the downscale factor between the region of interest and the coarse region of interest
+ * @param[in] bandHalfSize the number of depth indexes added on each side of the range
+ * @param[in] depthRange the volume depth range
+ * @param[in] coarseRoi the coarse 2d region of interest
+ * @param[in] roi the 2d region of interest
+ * @param[in] stream the stream for gpu execution
+ */
+extern void cuda_volumeComputeDepthIndexRange(CudaDeviceMemoryPitched<int2, 2>& out_depthIndexRangeMap_dmp,
+                                              const CudaDeviceMemoryPitched<TSim, 3>& in_coarseVolSim_dmp,
+                                              const int coarseFactor,
+                                              const int bandHalfSize,
+                                              const Range& depthRange,
+                                              const ROI& coarseRoi,
+                                              const ROI& roi,
+                                              cudaStream_t stream);
+
+/**
+ * @brief Refine the best similarity volume for the given RC and all the given TCs.
+ * @note The TCs similarity values are summed in the kernel, the TCs are processed in a single kernel launch
+ *       (several launches only if there are more TCs than the kernel parameter can hold).
  * @param[out] inout_volSim_dmp the similarity volume in device memory
  * @param[in] in_sgmDepthPixSizeMap_dmp the SGM upscaled depth/pixSize map (useful to get middle depth) in device memory
  * @param[in] in_sgmNormalMap_dmpPtr (or nullptr) the SGM upscaled normal map in device memory
  * @param[in] rcDeviceCameraParamsId the R camera parameters id for array in device constant memory
- * @param[in] tcDeviceCameraParamsId the T camera parameters id for array in device constant memory
+ * @param[in] tcDeviceCameraParamsIds the T cameras parameters id for array in device constant memory
  * @param[in] rcDeviceMipmapImage the R mipmap image in device memory container
- * @param[in] tcDeviceMipmapImage the T mipmap image in device memory container
+ * @param[in] tcDeviceMipmapImages the T mipmap images in device memory container, in the same order as tcDeviceCameraParamsIds
  * @param[in] refineParams the Refine parameters
  * @param[in] depthRange the volume depth range to compute
  * @param[in] roi the 2d region of interest
@@ -96,9 +123,9 @@ extern void cuda_volumeRefineSimilarity(CudaDeviceMemoryPitched<TSimRefine, 3>&
                                         const CudaDeviceMemoryPitched<float2, 2>& in_sgmDepthPixSizeMap_dmp,
                                         const CudaDeviceMemoryPitched<float3, 2>* in_sgmNormalMap_dmpPtr,
                                         const int rcDeviceCameraParamsId,
-                                        const int tcDeviceCameraParamsId,
+                                        const std::vector<int>& tcDeviceCameraParamsIds,
                                         const DeviceMipmapImage& rcDeviceMipmapImage,
-                                        const DeviceMipmapImage& tcDeviceMipmapImage,
+                                        const std::vector<const DeviceMipmapImage*>& tcDeviceMipmapImages,
                                         const RefineParams& refineParams,
                                         const Range& depthRange,
                                         const ROI& roi,
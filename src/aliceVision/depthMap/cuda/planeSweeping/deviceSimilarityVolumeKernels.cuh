@@ -106,9 +106,15 @@ __global__ void volume_updateUninitialized_kernel(TSim* inout_volume2nd_d, int i
     }
 }
 
+/**
+ * @brief Compute the similarity volume of the R camera and a T camera.
+ * @tparam TWsh the compile-time patch half-width (no custom patch pattern), 0 for the generic kernel
+ */
+template<int TWsh>
 __global__ void volume_computeSimilarity_kernel(TSim* out_volume1st_d, int out_volume1st_s, int out_volume1st_p,
                                                 TSim* out_volume2nd_d, int out_volume2nd_s, int out_volume2nd_p,
                                                 const float* in_depths_d, const int in_depths_p,
+                                                const int2* in_depthIndexRangeMap_d, const int in_depthIndexRangeMap_p,
                                                 const int rcDeviceCameraParamsId,
                                                 const int tcDeviceCameraParamsId,
                                                 const cudaTextureObject_t rcMipmapImage_tex,
@@ -143,6 +149,15 @@ __global__ void volume_computeSimilarity_kernel(TSim* out_volume1st_d, int out_v
     const unsigned int vy = roiY;
     const unsigned int vz = depthRange.begin + roiZ;
 
+    // only compute the depth index range of the pixel (coarse-to-fine), other similarity values are left uninitialized
+    if(in_depthIndexRangeMap_d != nullptr)
+    {
+        const int2 depthIndexRange = *get2DBufferAt(in_depthIndexRangeMap_d, in_depthIndexRangeMap_p, size_t(vx), size_t(vy));
+
+        if(int(vz) < depthIndexRange.x || int(vz) >= depthIndexRange.y)
+            return;
+    }
+
     // corresponding image coordinates
     const float x = float(roi.x.begin + vx) * float(stepXY);
     const float y = float(roi.y.begin + vy) * float(stepXY);
@@ -160,7 +175,8 @@ __global__ void volume_computeSimilarity_kernel(TSim* out_volume1st_d, int out_v
     float fsim = CUDART_INF_F;
 
     // compute patch similarity
-    if(useCustomPatchPattern)
+    // note: the specialized kernels are only used without custom patch pattern
+    if(TWsh == 0 && useCustomPatchPattern)
     {
         fsim = compNCCby3DptsYK_customPatchPattern<invertAndFilter>(rcDeviceCamParams,
                                                                     tcDeviceCamParams,
@@ -178,20 +194,20 @@ __global__ void volume_computeSimilarity_kernel(TSim* out_volume1st_d, int out_v
     }
     else
     {
-        fsim = compNCCby3DptsYK<invertAndFilter>(rcDeviceCamParams,
-                                                 tcDeviceCamParams,
-                                                 rcMipmapImage_tex,
-                                                 tcMipmapImage_tex,
-                                                 rcSgmLevelWidth,
-                                                 rcSgmLevelHeight,
-                                                 tcSgmLevelWidth,
-                                                 tcSgmLevelHeight,
-                                                 rcMipmapLevel,
-                                                 wsh,
-                                                 invGammaC,
-                                                 invGammaP,
-                                                 useConsistentScale,
-                                                 patch);
+        fsim = compNCCby3DptsYK<invertAndFilter, TWsh>(rcDeviceCamParams,
+                                                       tcDeviceCamParams,
+                                                       rcMipmapImage_tex,
+                                                       tcMipmapImage_tex,
+                                                       rcSgmLevelWidth,
+                                                       rcSgmLevelHeight,
+                                                       tcSgmLevelWidth,
+                                                       tcSgmLevelHeight,
+                                                       rcMipmapLevel,
+                                                       wsh,
+                                                       invGammaC,
+                                                       invGammaP,
+                                                       useConsistentScale,
+                                                       patch);
     }
 
     if(fsim == CUDART_INF_F) // invalid similarity
@@ -232,17 +248,94 @@ __global__ void volume_computeSimilarity_kernel(TSim* out_volume1st_d, int out_v
     }
 }
 
+__global__ void volume_computeDepthIndexRange_kernel(int2* out_depthIndexRangeMap_d, int out_depthIndexRangeMap_p,
+                                                     const TSim* in_coarseVolSim_d, int in_coarseVolSim_s, int in_coarseVolSim_p,
+                                                     const int coarseFactor,
+                                                     const int bandHalfSize,
+                                                     const Range depthRange,
+                                                     const ROI coarseRoi,
+                                                     const ROI roi)
+{
+    const unsigned int roiX = blockIdx.x * blockDim.x + threadIdx.x;
+    const unsigned int roiY = blockIdx.y * blockDim.y + threadIdx.y;
+
+    if(roiX >= roi.width() || roiY >= roi.height())
+        return;
+
+    // corresponding coarse volume coordinates
+    const int cx = min(max(int((roi.x.begin + roiX) / coarseFactor) - int(coarseRoi.x.begin), 0), int(coarseRoi.width()) - 1);
+    const int cy = min(max(int((roi.y.begin + roiY) / coarseFactor) - int(coarseRoi.y.begin), 0), int(coarseRoi.height()) - 1);
+
+    int minBestZ = int(depthRange.end);
+    int maxBestZ = int(depthRange.begin) - 1;
+
+    // best depth indexes of the 3x3 coarse neighbourhood
+    for(int ny = max(cy - 1, 0); ny <= min(cy + 1, int(coarseRoi.height()) - 1); ++ny)
+    {
+        for(int nx = max(cx - 1, 0); nx <= min(cx + 1, int(coarseRoi.width()) - 1); ++nx)
+        {
+            TSim bestSim = TSim(255.0f);
+            int bestZ = -1;
+
+            for(int vz = int(depthRange.begin); vz < int(depthRange.end); ++vz)
+            {
+                const TSim sim = *get3DBufferAt(in_coarseVolSim_d, in_coarseVolSim_s, in_coarseVolSim_p, size_t(nx), size_t(ny), size_t(vz));
+
+                if(sim < bestSim)
+                {
+                    bestSim = sim;
+                    bestZ = vz;
+                }
+            }
+
+            if(bestZ < 0) // no valid similarity
+                continue;
+
+            minBestZ = min(minBestZ, bestZ);
+            maxBestZ = max(maxBestZ, bestZ);
+        }
+    }
+
+    int2& depthIndexRange = *get2DBufferAt(out_depthIndexRangeMap_d, out_depthIndexRangeMap_p, size_t(roiX), size_t(roiY));
+
+    if(minBestZ > maxBestZ) // no valid coarse similarity, compute all the depths
+    {
+        depthIndexRange = make_int2(int(depthRange.begin), int(depthRange.end));
+    }
+    else
+    {
+        depthIndexRange = make_int2(max(minBestZ - bandHalfSize, int(depthRange.begin)), min(maxBestZ + bandHalfSize + 1, int(depthRange.end)));
+    }
+}
+
+/*
+ * @struct DeviceRefineTCams
+ * @brief T cameras of a refine similarity kernel launch, passed by value as kernel parameter.
+ */
+struct DeviceRefineTCams
+{
+    static constexpr int maxTCams = 16;  //< maximum number of T cameras per kernel launch
+
+    int nbTCams = 0;
+    int deviceCameraParamsIds[maxTCams];
+    cudaTextureObject_t mipmapImages_tex[maxTCams];
+    unsigned int levelWidths[maxTCams];
+    unsigned int levelHeights[maxTCams];
+};
+
+/**
+ * @brief Add the refine similarity of the given T cameras to the refine volume.
+ * @tparam TWsh the compile-time patch half-width (no custom patch pattern), 0 for the generic kernel
+ */
+template<int TWsh>
 __global__ void volume_refineSimilarity_kernel(TSimRefine* inout_volSim_d, int inout_volSim_s, int inout_volSim_p,
                                                const float2* in_sgmDepthPixSizeMap_d, const int in_sgmDepthPixSizeMap_p,
                                                const float3* in_sgmNormalMap_d, const int in_sgmNormalMap_p,
                                                const int rcDeviceCameraParamsId,
-                                               const int tcDeviceCameraParamsId,
+                                               const DeviceRefineTCams tcams,
                                                const cudaTextureObject_t rcMipmapImage_tex,
-                                               const cudaTextureObject_t tcMipmapImage_tex,
                                                const unsigned int rcRefineLevelWidth,
                                                const unsigned int rcRefineLevelHeight,
-                                               const unsigned int tcRefineLevelWidth,
-                                               const unsigned int tcRefineLevelHeight,
                                                const float rcMipmapLevel,
                                                const int volDimZ,
                                                const int stepXY,
@@ -261,9 +354,8 @@ __global__ void volume_refineSimilarity_kernel(TSimRefine* inout_volSim_d, int i
     if(roiX >= roi.width() || roiY >= roi.height()) // no need to check roiZ
         return;
 
-    // R and T camera parameters
+    // R camera parameters
     const DeviceCameraParams& rcDeviceCamParams = constantCameraParametersArray_d[rcDeviceCameraParamsId];
-    const DeviceCameraParams& tcDeviceCamParams = constantCameraParametersArray_d[tcDeviceCameraParamsId];
 
     // corresponding volume and depth/sim map coordinates
     const unsigned int vx = roiX;
@@ -295,86 +387,103 @@ __global__ void volume_refineSimilarity_kernel(TSimRefine* inout_volSim_d, int i
         move3DPointByRcPixSize(p, rcDeviceCamParams, pixSizeOffset);
     }
 
-    // compute patch
-    Patch patch;
-    patch.p = p;
-    patch.d = computePixSize(rcDeviceCamParams, p);
+    // patch position and size do not depend on the T camera
+    const float pd = computePixSize(rcDeviceCamParams, p);
 
-    // computeRotCSEpip
-    {
-      // vector from the reference camera to the 3d point
-      float3 v1 = rcDeviceCamParams.C - patch.p;
-      // vector from the target camera to the 3d point
-      float3 v2 = tcDeviceCamParams.C - patch.p;
-      normalize(v1);
-      normalize(v2);
+    // we need positive and filtered similarity values
+    constexpr bool invertAndFilter = true;
 
-      // y has to be ortogonal to the epipolar plane
-      // n has to be on the epipolar plane
-      // x has to be on the epipolar plane
+    // sum of the T cameras similarity values, added once in the volume
+    float fsimInvertedFilteredSum = 0.0f;
+    bool hasValidSimilarity = false;
 
-      patch.y = cross(v1, v2);
-      normalize(patch.y);
+    for(int tci = 0; tci < tcams.nbTCams; ++tci)
+    {
+        // T camera parameters
+        const DeviceCameraParams& tcDeviceCamParams = constantCameraParametersArray_d[tcams.deviceCameraParamsIds[tci]];
 
-      if(in_sgmNormalMap_d != nullptr) // initialize patch normal from input normal map
-      {
-        patch.n = *get2DBufferAt(in_sgmNormalMap_d, in_sgmNormalMap_p, vx, vy);
-      }
-      else // initialize patch normal from v1 & v2
-      {
-        patch.n = (v1 + v2) / 2.0f;
-        normalize(patch.n);
-      }
+        // compute patch
+        Patch patch;
+        patch.p = p;
+        patch.d = pd;
 
-      patch.x = cross(patch.y, patch.n);
-      normalize(patch.x);
-    }
+        // computeRotCSEpip
+        {
+          // vector from the reference camera to the 3d point
+          float3 v1 = rcDeviceCamParams.C - patch.p;
+          // vector from the target camera to the 3d point
+          float3 v2 = tcDeviceCamParams.C - patch.p;
+          normalize(v1);
+          normalize(v2);
+
+          // y has to be ortogonal to the epipolar plane
+          // n has to be on the epipolar plane
+          // x has to be on the epipolar plane
+
+          patch.y = cross(v1, v2);
+          normalize(patch.y);
+
+          if(in_sgmNormalMap_d != nullptr) // initialize patch normal from input normal map
+          {
+            patch.n = *get2DBufferAt(in_sgmNormalMap_d, in_sgmNormalMap_p, vx, vy);
+          }
+          else // initialize patch normal from v1 & v2
+          {
+            patch.n = (v1 + v2) / 2.0f;
+            normalize(patch.n);
+          }
+
+          patch.x = cross(patch.y, patch.n);
+          normalize(patch.x);
+        }
 
-    // we need positive and filtered similarity values
-    constexpr bool invertAndFilter = true;
+        float fsimInvertedFiltered = CUDART_INF_F;
 
-    float fsimInvertedFiltered = CUDART_INF_F;
+        // compute similarity
+        // note: the specialized kernels are only used without custom patch pattern
+        if(TWsh == 0 && useCustomPatchPattern)
+        {
+            fsimInvertedFiltered = compNCCby3DptsYK_customPatchPattern<invertAndFilter>(rcDeviceCamParams,
+                                                                                        tcDeviceCamParams,
+                                                                                        rcMipmapImage_tex,
+                                                                                        tcams.mipmapImages_tex[tci],
+                                                                                        rcRefineLevelWidth,
+                                                                                        rcRefineLevelHeight,
+                                                                                        tcams.levelWidths[tci],
+                                                                                        tcams.levelHeights[tci],
+                                                                                        rcMipmapLevel,
+                                                                                        invGammaC,
+                                                                                        invGammaP,
+                                                                                        useConsistentScale,
+                                                                                        patch);
+        }
+        else
+        {
+            fsimInvertedFiltered = compNCCby3DptsYK<invertAndFilter, TWsh>(rcDeviceCamParams,
+                                                                           tcDeviceCamParams,
+                                                                           rcMipmapImage_tex,
+                                                                           tcams.mipmapImages_tex[tci],
+                                                                           rcRefineLevelWidth,
+                                                                           rcRefineLevelHeight,
+                                                                           tcams.levelWidths[tci],
+                                                                           tcams.levelHeights[tci],
+                                                                           rcMipmapLevel,
+                                                                           wsh,
+                                                                           invGammaC,
+                                                                           invGammaP,
+                                                                           useConsistentScale,
+                                                                           patch);
+        }
 
-    // compute similarity
-    if(useCustomPatchPattern)
-    {
-        fsimInvertedFiltered = compNCCby3DptsYK_customPatchPattern<invertAndFilter>(rcDeviceCamParams,
-                                                                                    tcDeviceCamParams,
-                                                                                    rcMipmapImage_tex,
-                                                                                    tcMipmapImage_tex,
-                                                                                    rcRefineLevelWidth,
-                                                                                    rcRefineLevelHeight,
-                                                                                    tcRefineLevelWidth,
-                                                                                    tcRefineLevelHeight,
-                                                                                    rcMipmapLevel,
-                                                                                    invGammaC,
-                                                                                    invGammaP,
-                                                                                    useConsistentScale,
-                                                                                    patch);
-    }
-    else
-    {
-        fsimInvertedFiltered = compNCCby3DptsYK<invertAndFilter>(rcDeviceCamParams,
-                                                                 tcDeviceCamParams,
-                                                                 rcMipmapImage_tex,
-                                                                 tcMipmapImage_tex,
-                                                                 rcRefineLevelWidth,
-                                                                 rcRefineLevelHeight,
-                                                                 tcRefineLevelWidth,
-                                                                 tcRefineLevelHeight,
-                                                                 rcMipmapLevel,
-                                                                 wsh,
-                                                                 invGammaC,
-                                                                 invGammaP,
-                                                                 useConsistentScale,
-                                                                 patch);
+        if(fsimInvertedFiltered == CUDART_INF_F) // invalid similarity
+            continue; // do nothing
+
+        fsimInvertedFilteredSum += fsimInvertedFiltered;
+        hasValidSimilarity = true;
     }
 
-    if(fsimInvertedFiltered == CUDART_INF_F) // invalid similarity
-    {
-        // do nothing
+    if(!hasValidSimilarity)
         return;
-    }
 
     // get output similarity pointer
     TSimRefine* outSimPtr = get3DBufferAt(inout_volSim_d, inout_volSim_s, inout_volSim_p, vx, vy, vz);
@@ -382,11 +491,11 @@ __global__ void volume_refineSimilarity_kernel(TSimRefine* inout_volSim_d, int i
     // add the output similarity value
 #ifdef TSIM_REFINE_USE_HALF
     // note: using built-in half addition can give bad results on some gpus
-    //*outSimPtr = __hadd(*outSimPtr, TSimRefine(fsimInvertedFiltered));
-    //*outSimPtr = __hadd(*outSimPtr, __float2half(fsimInvertedFiltered));
-    *outSimPtr = __float2half(__half2float(*outSimPtr) + fsimInvertedFiltered); // perform the addition in float
+    //*outSimPtr = __hadd(*outSimPtr, TSimRefine(fsimInvertedFilteredSum));
+    //*outSimPtr = __hadd(*outSimPtr, __float2half(fsimInvertedFilteredSum));
+    *outSimPtr = __float2half(__half2float(*outSimPtr) + fsimInvertedFilteredSum); // perform the addition in float
 #else
-    *outSimPtr += TSimRefine(fsimInvertedFiltered);
+    *outSimPtr += TSimRefine(fsimInvertedFilteredSum);
 #endif
 }
 
@@ -649,6 +758,48 @@ __global__ void volume_computeBestZInSlice_kernel(TSimAcc* xzSlice_d, int xzSlic
     ySliceBestInColCst_d[x] = bestCst;
 }
 
+/**
+ * @brief Compute the SGM penalty of the depth jumps between the current and the previous pixels of the path.
+ * @note The penalty does not depend on the depth.
+ */
+__device__ float volume_computeSgmP2(const cudaTextureObject_t rcMipmapImage_tex,
+                                     const unsigned int rcSgmLevelWidth,
+                                     const unsigned int rcSgmLevelHeight,
+                                     const float rcMipmapLevel,
+                                     const int3& v,
+                                     const int3& axisT,
+                                     const float step,
+                                     const float _P2,
+                                     const int ySign,
+                                     const ROI& roi)
+{
+    if(_P2 < 0)
+    {
+      // _P2 convention: use negative value to skip the use of deltaC.
+      return std::abs(_P2);
+    }
+
+    // find texture offset
+    const int beginX = (axisT.x == 0) ? roi.x.begin : roi.y.begin;
+    const int beginY = (axisT.x == 0) ? roi.y.begin : roi.x.begin;
+
+    const int imX0 = (beginX + v.x) * step; // current
+    const int imY0 = (beginY + v.y) * step;
+
+    const int imX1 = imX0 - ySign * step * (axisT.y == 0); // M1
+    const int imY1 = imY0 - ySign * step * (axisT.y == 1);
+
+    const float4 gcr0 = tex2DLod<float4>(rcMipmapImage_tex, (float(imX0) + 0.5f) / float(rcSgmLevelWidth), (float(imY0) + 0.5f) / float(rcSgmLevelHeight), rcMipmapLevel);
+    const float4 gcr1 = tex2DLod<float4>(rcMipmapImage_tex, (float(imX1) + 0.5f) / float(rcSgmLevelWidth), (float(imY1) + 0.5f) / float(rcSgmLevelHeight), rcMipmapLevel);
+    const float deltaC = euclideanDist3(gcr0, gcr1);
+
+    // sigmoid f(x) = i + (a - i) * (1 / ( 1 + e^(10 * (x - P2) / w)))
+    // see: https://www.desmos.com/calculator/1qvampwbyx
+    // best values found from tests: i = 80, a = 255, w = 80, P2 = 100
+    // historical values: i = 15, a = 255, w = 80, P2 = 20
+    return sigmoid(80.f, 255.f, 80.f, _P2, deltaC);
+}
+
 /**
  * @param[inout] xySliceForZ input similarity plane
  * @param[in] xySliceForZM1
@@ -684,40 +835,12 @@ __global__ void volume_agregateCostVolumeAtXinSlices_kernel(const cudaTextureObj
     if (x >= (&volDim.x)[axisT.x] || z >= volDim.z)
         return;
 
-    // find texture offset
-    const int beginX = (axisT.x == 0) ? roi.x.begin : roi.y.begin;
-    const int beginY = (axisT.x == 0) ? roi.y.begin : roi.x.begin;
-
     TSimAcc* sim_xz = get2DBufferAt(xzSliceForY_d, xzSliceForY_p, x, z);
     float pathCost = 255.0f;
 
     if((z >= 1) && (z < volDim.z - 1))
     {
-        float P2 = 0;
-
-        if(_P2 < 0)
-        {
-          // _P2 convention: use negative value to skip the use of deltaC.
-          P2 = std::abs(_P2);
-        }
-        else
-        {
-          const int imX0 = (beginX + v.x) * step; // current
-          const int imY0 = (beginY + v.y) * step;
-
-          const int imX1 = imX0 - ySign * step * (axisT.y == 0); // M1
-          const int imY1 = imY0 - ySign * step * (axisT.y == 1);
-
-          const float4 gcr0 = tex2DLod<float4>(rcMipmapImage_tex, (float(imX0) + 0.5f) / float(rcSgmLevelWidth), (float(imY0) + 0.5f) / float(rcSgmLevelHeight), rcMipmapLevel);
-          const float4 gcr1 = tex2DLod<float4>(rcMipmapImage_tex, (float(imX1) + 0.5f) / float(rcSgmLevelWidth), (float(imY1) + 0.5f) / float(rcSgmLevelHeight), rcMipmapLevel);
-          const float deltaC = euclideanDist3(gcr0, gcr1);
-
-          // sigmoid f(x) = i + (a - i) * (1 / ( 1 + e^(10 * (x - P2) / w)))
-          // see: https://www.desmos.com/calculator/1qvampwbyx
-          // best values found from tests: i = 80, a = 255, w = 80, P2 = 100
-          // historical values: i = 15, a = 255, w = 80, P2 = 20
-          P2 = sigmoid(80.f, 255.f, 80.f, _P2, deltaC);
-        }
+        const float P2 = volume_computeSgmP2(rcMipmapImage_tex, rcSgmLevelWidth, rcSgmLevelHeight, rcMipmapLevel, v, axisT, step, _P2, ySign, roi);
 
         const TSimAcc bestCostInColM1 = bestSimInYm1_d[x];
         const TSimAcc pathCostMDM1 = *get2DBufferAt(xzSliceForYm1_d, xzSliceForYm1_p, x, z - 1); // M1: minus 1 over depths
@@ -729,11 +852,15 @@ __global__ void volume_agregateCostVolumeAtXinSlices_kernel(const cudaTextureObj
         pathCost = (*sim_xz) + minCost - bestCostInColM1;
     }
 
+#ifdef TSIM_USE_FLOAT
     // fill the current slice with the new similarity score
     *sim_xz = TSimAcc(pathCost);
+#else
+    // fill the current slice with the new similarity score
+    // path cost is lower than 255 + P2, clamp to the TSimAcc = unsigned short range for huge user P2
+    *sim_xz = TSimAcc(fminf(65535.0f, pathCost));
 
-#ifndef TSIM_USE_FLOAT
-    // clamp if TSim = uchar (TSimAcc = unsigned int)
+    // clamp if TSim = uchar (TSimAcc = unsigned short)
     pathCost = fminf(255.0f, fmaxf(0.0f, pathCost));
 #endif
 
@@ -743,5 +870,121 @@ __global__ void volume_agregateCostVolumeAtXinSlices_kernel(const cudaTextureObj
     *volume_xyz = TSim(val);
 }
 
+/**
+ * @brief Aggregate the similarity volume along a whole SGM path, one warp per line of the volume.
+ * @note Same traversal and results as the slice by slice volume_agregateCostVolumeAtXinSlices_kernel,
+ *       without a kernel launch per slice: the path costs of the previous slice are kept in shared memory
+ *       (2 buffers of volDim.z path costs per line) and their minimum is reduced with warp shuffles.
+ * @note blockDim.x should be the warp size, blockDim.y is the number of lines per block.
+ * @param[in] volSim_d the input similarity volume
+ * @param[inout] volAgr_d the aggregated similarity volume
+ * @param[in] invY traverse the path in reverse order
+ * @param[in] filteringIndex the number of already aggregated paths
+ */
+__global__ void volume_aggregatePathInLines_kernel(const cudaTextureObject_t rcMipmapImage_tex,
+                                                   const unsigned int rcSgmLevelWidth,
+                                                   const unsigned int rcSgmLevelHeight,
+                                                   const float rcMipmapLevel,
+                                                   const TSim* volSim_d, const int volSim_s, const int volSim_p,
+                                                   TSim* volAgr_d, const int volAgr_s, const int volAgr_p,
+                                                   const int3 volDim,
+                                                   const int3 axisT,
+                                                   const float step,
+                                                   const float P1,
+                                                   const float _P2,
+                                                   const bool invY,
+                                                   const int filteringIndex,
+                                                   const ROI roi)
+{
+    extern __shared__ TSimAcc pathCostsPerLine[];
+
+    const int lane = threadIdx.x;
+    const int x = blockIdx.x * blockDim.y + threadIdx.y;
+
+    const int volDimX = (&volDim.x)[axisT.x];
+    const int volDimY = (&volDim.x)[axisT.y];
+    const int volDimZ = volDim.z;
+
+    // the whole warp exits, the warp shuffles below are done by all its threads
+    if(x >= volDimX)
+        return;
+
+    TSimAcc* pathCostsYm1 = pathCostsPerLine + threadIdx.y * 2 * volDimZ; // previous slice path costs
+    TSimAcc* pathCostsY   = pathCostsYm1 + volDimZ;                       // current slice path costs
+
+    const int ySign = (invY ? -1 : 1);
+
+    int3 v;
+    (&v.x)[axisT.x] = x;
+
+    // the first slice (at Y=0) is the initial path cost, its aggregated similarity is set to 255
+    (&v.x)[axisT.y] = 0;
+
+    for(int z = lane; z < volDimZ; z += blockDim.x)
+    {
+        (&v.x)[axisT.z] = z;
+        pathCostsYm1[z] = TSimAcc(*get3DBufferAt(volSim_d, volSim_s, volSim_p, v));
+        *get3DBufferAt(volAgr_d, volAgr_s, volAgr_p, v) = TSim(255);
+    }
+
+    __syncwarp();
+
+    for(int iy = 1; iy < volDimY; ++iy)
+    {
+        (&v.x)[axisT.y] = invY ? volDimY - 1 - iy : iy;
+
+        // best path cost of the previous slice: per thread, then warp reduction
+        float bestCostInColM1 = float(pathCostsYm1[0]);
+
+        for(int z = lane; z < volDimZ; z += blockDim.x)
+            bestCostInColM1 = fminf(bestCostInColM1, float(pathCostsYm1[z]));
+
+        for(int offset = warpSize / 2; offset > 0; offset /= 2)
+            bestCostInColM1 = fminf(bestCostInColM1, __shfl_xor_sync(0xffffffff, bestCostInColM1, offset));
+
+        const float P2 = volume_computeSgmP2(rcMipmapImage_tex, rcSgmLevelWidth, rcSgmLevelHeight, rcMipmapLevel, v, axisT, step, _P2, ySign, roi);
+
+        for(int z = lane; z < volDimZ; z += blockDim.x)
+        {
+            (&v.x)[axisT.z] = z;
+
+            const TSimAcc sim = TSimAcc(*get3DBufferAt(volSim_d, volSim_s, volSim_p, v));
+            float pathCost = 255.0f;
+
+            if((z >= 1) && (z < volDimZ - 1))
+            {
+                const TSimAcc pathCostMDM1 = pathCostsYm1[z - 1]; // M1: minus 1 over depths
+                const TSimAcc pathCostMD   = pathCostsYm1[z];
+                const TSimAcc pathCostMDP1 = pathCostsYm1[z + 1]; // P1: plus 1 over depths
+                const float minCost = multi_fminf(pathCostMD, pathCostMDM1 + P1, pathCostMDP1 + P1, bestCostInColM1 + P2);
+
+                pathCost = sim + minCost - bestCostInColM1;
+            }
+
+#ifdef TSIM_USE_FLOAT
+            pathCostsY[z] = TSimAcc(pathCost);
+#else
+            // path cost is lower than 255 + P2, clamp to the TSimAcc = unsigned short range for huge user P2
+            pathCostsY[z] = TSimAcc(fminf(65535.0f, pathCost));
+
+            // clamp if TSim = uchar (TSimAcc = unsigned short)
+            pathCost = fminf(255.0f, fmaxf(0.0f, pathCost));
+#endif
+
+            // aggregate into the final output
+            TSim* volume_xyz = get3DBufferAt(volAgr_d, volAgr_s, volAgr_p, v);
+            const float val = (float(*volume_xyz) * float(filteringIndex) + pathCost) / float(filteringIndex + 1);
+            *volume_xyz = TSim(val);
+        }
+
+        // all the path costs of the slice are written before being read as the previous slice
+        __syncwarp();
+
+        TSimAcc* pathCostsTmp = pathCostsYm1;
+        pathCostsYm1 = pathCostsY;
+        pathCostsY = pathCostsTmp;
+    }
+}
+
 } // namespace depthMap
 } // namespace aliceVision
@@ -27,7 +27,9 @@ using TSim = float;
 using TSimAcc = float;
 #else
 using TSim = unsigned char;
-using TSimAcc = unsigned int;  // TSimAcc is the similarity accumulation type
+// SGM path costs are bounded by 255 + P2 (see volume_agregateCostVolumeAtXinSlices_kernel),
+// 16 bits are enough and halve the accumulation slices bandwidth.
+using TSimAcc = unsigned short;  // TSimAcc is the similarity accumulation type
 #endif
 
 #ifdef TSIM_REFINE_USE_HALF
@@ -239,27 +239,24 @@ void writeDepthSimMap(int rc,
     writeFloat2Map(rc, mp, tileParams, roi, in_depthSimMap_dmp, fileTypeX, fileTypeY, scale, step, name);
 }
 
-void writeDepthSimMapFromTileList(int rc,
-                                  const mvsUtils::MultiViewParams& mp,
-                                  const mvsUtils::TileParams& tileParams,
-                                  const std::vector<ROI>& tileRoiList,
-                                  const std::vector<CudaHostMemoryHeap<float2, 2>>& in_depthSimMapTiles_hmh,
-                                  int scale,
-                                  int step,
-                                  const std::string& name)
+void getDepthSimMapFromTileList(int rc,
+                                const mvsUtils::MultiViewParams& mp,
+                                const mvsUtils::TileParams& tileParams,
+                                const std::vector<ROI>& tileRoiList,
+                                const std::vector<CudaHostMemoryHeap<float2, 2>>& in_depthSimMapTiles_hmh,
+                                int scale,
+                                int step,
+                                image::Image<float>& out_depthMap,
+                                image::Image<float>& out_simMap)
 {
-    ALICEVISION_LOG_TRACE("Merge and write depth/similarity map tiles (rc: " << rc << ", view id: " << mp.getViewId(rc) << ").");
-
-    const std::string customSuffix = (name.empty()) ? "" : "_" + name;
-
     const ROI imageRoi(Range(0, mp.getWidth(rc)), Range(0, mp.getHeight(rc)));
 
     const int scaleStep = scale * step;
     const int width = divideRoundUp(mp.getWidth(rc), scaleStep);
     const int height = divideRoundUp(mp.getHeight(rc), scaleStep);
 
-    image::Image<float> depthMap(width, height, true, 0.0f);  // map should be initialize, additive process
-    image::Image<float> simMap(width, height, true, 0.0f);    // map should be initialize, additive process
+    out_depthMap = image::Image<float>(width, height, true, 0.0f);  // map should be initialize, additive process
+    out_simMap = image::Image<float>(width, height, true, 0.0f);    // map should be initialize, additive process
 
     for (size_t i = 0; i < tileRoiList.size(); ++i)
     {
@@ -275,9 +272,28 @@ void writeDepthSimMapFromTileList(int rc,
         copyFloat2Map(tileDepthMap, tileSimMap, in_depthSimMapTiles_hmh.at(i), roi, scaleStep);
 
         // add tile maps to the full-size maps with weighting
-        mvsUtils::addTileMapWeighted(rc, mp, tileParams, roi, scaleStep, tileDepthMap, depthMap);
-        mvsUtils::addTileMapWeighted(rc, mp, tileParams, roi, scaleStep, tileSimMap, simMap);
+        mvsUtils::addTileMapWeighted(rc, mp, tileParams, roi, scaleStep, tileDepthMap, out_depthMap);
+        mvsUtils::addTileMapWeighted(rc, mp, tileParams, roi, scaleStep, tileSimMap, out_simMap);
     }
+}
+
+void writeDepthSimMapFromTileList(int rc,
+                                  const mvsUtils::MultiViewParams& mp,
+                                  const mvsUtils::TileParams& tileParams,
+                                  const std::vector<ROI>& tileRoiList,
+                                  const std::vector<CudaHostMemoryHeap<float2, 2>>& in_depthSimMapTiles_hmh,
+                                  int scale,
+                                  int step,
+                                  const std::string& name)
+{
+    ALICEVISION_LOG_TRACE("Merge and write depth/similarity map tiles (rc: " << rc << ", view id: " << mp.getViewId(rc) << ").");
+
+    const std::string customSuffix = (name.empty()) ? "" : "_" + name;
+
+    image::Image<float> depthMap;
+    image::Image<float> simMap;
+
+    getDepthSimMapFromTileList(rc, mp, tileParams, tileRoiList, in_depthSimMapTiles_hmh, scale, step, depthMap, simMap);
 
     // write fullsize maps on disk
     mvsUtils::writeMap(rc, mp, mvsUtils::EFileType::depthMap, depthMap, scale, step, customSuffix);  // write the merged depth map
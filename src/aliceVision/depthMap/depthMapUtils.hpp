@@ -127,6 +127,28 @@ void writeDepthSimMap(int rc,
                       int step,
                       const std::string& name = "");
 
+/**
+ * @brief Merge a depth/similarity map from a tile list in host memory.
+ * @param[in] rc the related R camera index
+ * @param[in] mp the multi-view parameters
+ * @param[in] tileParams tile workflow parameters
+ * @param[in] tileRoiList the 2d region of interest of each tile
+ * @param[in] in_depthSimMapTiles_hmh the depth/similarity map tile list in host memory
+ * @param[in] scale the depth/similarity map downscale factor
+ * @param[in] step the depth/similarity map step factor
+ * @param[out] out_depthMap the merged depth map
+ * @param[out] out_simMap the merged similarity map
+ */
+void getDepthSimMapFromTileList(int rc,
+                                const mvsUtils::MultiViewParams& mp,
+                                const mvsUtils::TileParams& tileParams,
+                                const std::vector<ROI>& tileRoiList,
+                                const std::vector<CudaHostMemoryHeap<float2, 2>>& in_depthSimMapTiles_hmh,
+                                int scale,
+                                int step,
+                                image::Image<float>& out_depthMap,
+                                image::Image<float>& out_simMap);
+
 /**
  * @brief Write a depth/similarity map on disk from a tile list in host memory.
  * @param[in] rc the related R camera index
@@ -9,6 +9,9 @@
 
 #include <aliceVision/numeric/numeric.hpp>
 
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
 #include <iostream>
 #include <iterator>
 #include <fstream>
@@ -282,22 +285,19 @@ inline void loadDescsFromBinFile(const std::string& sfileNameDescs, std::vector<
 }
 
 /// Write descriptors to file (in binary mode)
-template<typename DescriptorsT>
-inline void saveDescsToBinFile(const std::string& sfileNameDescs, DescriptorsT& vec_desc)
+template<typename DescriptorT>
+inline void saveDescsToBinFile(const std::string& sfileNameDescs, const DescriptorT* descs, std::size_t cardDesc)
 {
-    typedef typename DescriptorsT::value_type VALUE;
-
     std::ofstream file(sfileNameDescs, std::ios::out | std::ios::binary);
 
     if (!file.is_open())
         throw std::runtime_error("Can't save descriptor binary file, can't open '" + sfileNameDescs + "' !");
 
     // Write the number of descriptor
-    const std::size_t cardDesc = vec_desc.size();
     file.write((const char*)&cardDesc, sizeof(std::size_t));
-    for (typename DescriptorsT::const_iterator iter = vec_desc.begin(); iter != vec_desc.end(); ++iter)
+    for (std::size_t i = 0; i < cardDesc; ++i)
     {
-        file.write((const char*)(*iter).getData(), VALUE::static_size * sizeof(typename VALUE::bin_type));
+        file.write((const char*)descs[i].getData(), DescriptorT::static_size * sizeof(typename DescriptorT::bin_type));
     }
 
     if (!file.good())
@@ -306,5 +306,82 @@ inline void saveDescsToBinFile(const std::string& sfileNameDescs, DescriptorsT&
     file.close();
 }
 
+/// Write descriptors to file (in binary mode)
+template<typename DescriptorsT>
+inline void saveDescsToBinFile(const std::string& sfileNameDescs, DescriptorsT& vec_desc)
+{
+    saveDescsToBinFile(sfileNameDescs, vec_desc.data(), vec_desc.size());
+}
+
+/**
+ * @brief Read-only memory mapping of a binary descriptors file (.desc).
+ *
+ * Descriptors are used in place (zero-copy): pages are loaded on demand,
+ * shared between processes reading the same file and can be evicted by the OS.
+ * The descriptors stored in the file must have the \p DescriptorT type.
+ */
+template<typename DescriptorT>
+class MappedDescsBinFile
+{
+  public:
+    static_assert(sizeof(DescriptorT) == DescriptorT::static_size * sizeof(typename DescriptorT::bin_type),
+                  "Descriptor type must be stored as a packed array of bins to be memory mapped.");
+
+    /**
+     * @brief Map the given binary descriptors file.
+     * @param[in] sfileNameDescs The file name (usually .desc)
+     */
+    explicit MappedDescsBinFile(const std::string& sfileNameDescs)
+    {
+        std::ifstream fileIn(sfileNameDescs, std::ios::in | std::ios::binary | std::ios::ate);
+
+        if (!fileIn.is_open())
+            throw std::runtime_error("Can't map descriptor binary file, can't open '" + sfileNameDescs + "' !");
+
+        const std::size_t fileSize = static_cast<std::size_t>(fileIn.tellg());
+        fileIn.seekg(0);
+
+        // Read the number of descriptor in the file
+        std::size_t cardDesc = 0;
+        fileIn.read((char*)&cardDesc, sizeof(std::size_t));
+        fileIn.close();
+
+        if (fileSize < sizeof(std::size_t) || (fileSize - sizeof(std::size_t)) / sizeof(DescriptorT) < cardDesc)
+            throw std::runtime_error("Can't map descriptor binary file, '" + sfileNameDescs + "' is incorrect !");
+
+        if (cardDesc == 0)
+            return;
+
+        try
+        {
+            _file = boost::interprocess::file_mapping(sfileNameDescs.c_str(), boost::interprocess::read_only);
+            _region = boost::interprocess::mapped_region(
+              _file, boost::interprocess::read_only, 0, sizeof(std::size_t) + cardDesc * sizeof(DescriptorT));
+        }
+        catch (const boost::interprocess::interprocess_exception& e)
+        {
+            throw std::runtime_error("Can't map descriptor binary file '" + sfileNameDescs + "' : " + e.what());
+        }
+
+        _data = reinterpret_cast<const DescriptorT*>(static_cast<const char*>(_region.get_address()) + sizeof(std::size_t));
+        _size = cardDesc;
+    }
+
+    MappedDescsBinFile(const MappedDescsBinFile&) = delete;
+    MappedDescsBinFile& operator=(const MappedDescsBinFile&) = delete;
+
+    /// Pointer to the first mapped descriptor
+    const DescriptorT* data() const { return _data; }
+
+    /// Number of mapped descriptors
+    std::size_t size() const { return _size; }
+
+  private:
+    boost::interprocess::file_mapping _file;
+    boost::interprocess::mapped_region _region;
+    const DescriptorT* _data = nullptr;
+    std::size_t _size = 0;
+};
+
 }  // namespace feature
 }  // namespace aliceVision
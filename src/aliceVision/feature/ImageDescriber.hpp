@@ -242,6 +242,23 @@ class ImageDescriber
         return false;
     }
 
+    /**
+     * @brief Detect regions on a batch of float images and compute their attributes (description)
+     * @note The default implementation describes the images one after the other,
+     *       image describers with an asynchronous implementation can keep all the images in flight.
+     * @param[in] images The images
+     * @param[out] regions The detected regions and attributes of each image
+     * @return True if detection succeed for all images.
+     */
+    virtual bool describeBatch(const std::vector<const image::Image<float>*>& images, std::vector<std::unique_ptr<Regions>>& regions)
+    {
+        regions.resize(images.size());
+        bool success = true;
+        for (std::size_t i = 0; i < images.size(); ++i)
+            success &= describe(*images.at(i), regions.at(i));
+        return success;
+    }
+
     /**
      * @brief Allocate Regions type depending of the ImageDescriber
      * @param[in,out] regions
@@ -52,10 +52,10 @@ class KeypointSet
     }
 
     /// Export in two separate files the feats and their corresponding descriptors
-    ///  descriptor in binary to save place
+    ///  feats and descriptors in binary to save place
     void saveToBinFile(const std::string& sfileNameFeats, const std::string& sfileNameDescs) const
     {
-        saveFeatsToFile(sfileNameFeats, _feats);
+        saveFeatsToBinFile(sfileNameFeats, _feats);
         saveDescsToBinFile(sfileNameDescs, _descs);
     }
 
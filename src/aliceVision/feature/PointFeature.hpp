@@ -8,6 +8,8 @@
 #pragma once
 
 #include "aliceVision/numeric/numeric.hpp"
+#include <cstdint>
+#include <cstring>
 #include <iostream>
 #include <iterator>
 #include <fstream>
@@ -85,10 +87,120 @@ inline std::istream& operator>>(std::istream& in, PointFeature& obj)
     return in >> obj._coords(0) >> obj._coords(1) >> obj._scale >> obj._orientation;
 }
 
-/// Read feats from file
+/**
+ * @brief Header of the binary features file (.feat).
+ *
+ * The header is followed by \p count features stored as packed (x, y, scale, orientation) floats.
+ * The payload has a fixed layout so it can be memory mapped and used without any parsing.
+ */
+struct FeatsBinFileHeader
+{
+    static constexpr char magicValue[8] = {'A', 'V', 'F', 'E', 'A', 'T', 'B', '\0'};
+    static constexpr std::uint32_t currentVersion = 1;
+    static constexpr std::uint32_t floatsPerFeature = 4;
+
+    char magic[8];
+    std::uint32_t version = currentVersion;
+    std::uint32_t featureSize = floatsPerFeature * sizeof(float);  // In bytes.
+    std::uint64_t count = 0;
+
+    FeatsBinFileHeader() { std::memcpy(magic, magicValue, sizeof(magic)); }
+
+    bool hasValidMagic() const { return std::memcmp(magic, magicValue, sizeof(magic)) == 0; }
+};
+
+static_assert(sizeof(FeatsBinFileHeader) == 24, "The binary features file header must be packed.");
+
+/**
+ * @brief Check if a features file uses the binary format.
+ * @param[in] sfileNameFeats The file name (usually .feat)
+ * @return true if the file starts with the binary features magic string
+ */
+inline bool isFeatsBinFile(const std::string& sfileNameFeats)
+{
+    std::ifstream fileIn(sfileNameFeats, std::ios::in | std::ios::binary);
+    char magic[sizeof(FeatsBinFileHeader::magicValue)];
+    if (!fileIn.read(magic, sizeof(magic)))
+        return false;
+    return std::memcmp(magic, FeatsBinFileHeader::magicValue, sizeof(magic)) == 0;
+}
+
+/// Read feats from binary file
+template<typename FeaturesT>
+inline void loadFeatsFromBinFile(const std::string& sfileNameFeats, FeaturesT& vec_feat)
+{
+    typedef typename FeaturesT::value_type VALUE;
+
+    vec_feat.clear();
+
+    std::ifstream fileIn(sfileNameFeats, std::ios::in | std::ios::binary);
+
+    if (!fileIn.is_open())
+        throw std::runtime_error("Can't load features binary file, can't open '" + sfileNameFeats + "' !");
+
+    FeatsBinFileHeader header;
+    fileIn.read((char*)&header, sizeof(FeatsBinFileHeader));
+
+    if (!fileIn || !header.hasValidMagic())
+        throw std::runtime_error("Can't load features binary file, '" + sfileNameFeats + "' has an invalid header !");
+    if (header.version > FeatsBinFileHeader::currentVersion || header.featureSize != FeatsBinFileHeader::floatsPerFeature * sizeof(float))
+        throw std::runtime_error("Can't load features binary file, '" + sfileNameFeats + "' uses an unsupported version (" +
+                                 std::to_string(header.version) + ") !");
+
+    // read the whole payload at once
+    std::vector<float> buffer(header.count * FeatsBinFileHeader::floatsPerFeature);
+    fileIn.read((char*)buffer.data(), buffer.size() * sizeof(float));
+
+    if (!fileIn)
+        throw std::runtime_error("Can't load features binary file, '" + sfileNameFeats + "' is incorrect !");
+
+    vec_feat.reserve(header.count);
+    for (std::size_t i = 0; i < buffer.size(); i += FeatsBinFileHeader::floatsPerFeature)
+        vec_feat.push_back(VALUE(buffer[i], buffer[i + 1], buffer[i + 2], buffer[i + 3]));
+
+    fileIn.close();
+}
+
+/// Write feats to binary file
+template<typename FeaturesT>
+inline void saveFeatsToBinFile(const std::string& sfileNameFeats, const FeaturesT& vec_feat)
+{
+    std::ofstream file(sfileNameFeats, std::ios::out | std::ios::binary);
+
+    if (!file.is_open())
+        throw std::runtime_error("Can't save features binary file, can't open '" + sfileNameFeats + "' !");
+
+    FeatsBinFileHeader header;
+    header.count = vec_feat.size();
+    file.write((const char*)&header, sizeof(FeatsBinFileHeader));
+
+    std::vector<float> buffer;
+    buffer.reserve(vec_feat.size() * FeatsBinFileHeader::floatsPerFeature);
+    for (typename FeaturesT::const_iterator iter = vec_feat.begin(); iter != vec_feat.end(); ++iter)
+    {
+        buffer.push_back(iter->x());
+        buffer.push_back(iter->y());
+        buffer.push_back(iter->scale());
+        buffer.push_back(iter->orientation());
+    }
+    file.write((const char*)buffer.data(), buffer.size() * sizeof(float));
+
+    if (!file.good())
+        throw std::runtime_error("Can't save features binary file, '" + sfileNameFeats + "' is incorrect !");
+
+    file.close();
+}
+
+/// Read feats from file (binary or text format)
 template<typename FeaturesT>
 inline void loadFeatsFromFile(const std::string& sfileNameFeats, FeaturesT& vec_feat)
 {
+    if (isFeatsBinFile(sfileNameFeats))
+    {
+        loadFeatsFromBinFile(sfileNameFeats, vec_feat);
+        return;
+    }
+
     vec_feat.clear();
 
     std::ifstream fileIn(sfileNameFeats);
@@ -104,7 +216,7 @@ inline void loadFeatsFromFile(const std::string& sfileNameFeats, FeaturesT& vec_
     fileIn.close();
 }
 
-/// Write feats to file
+/// Write feats to file (text format)
 template<typename FeaturesT>
 inline void saveFeatsToFile(const std::string& sfileNameFeats, FeaturesT& vec_feat)
 {
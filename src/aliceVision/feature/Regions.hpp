@@ -71,6 +71,15 @@ class Regions
 
     virtual void Load(const std::string& sfileNameFeats, const std::string& sfileNameDescs) = 0;
 
+    /**
+     * @brief Read from files the regions and memory map their corresponding descriptors.
+     *        Descriptors are used in place and loaded on demand by the OS.
+     */
+    virtual void LoadMapped(const std::string& sfileNameFeats, const std::string& sfileNameDescs) = 0;
+
+    /// Return true if the descriptors are memory mapped from a file
+    virtual bool IsMapped() const = 0;
+
     virtual void Save(const std::string& sfileNameFeats, const std::string& sfileNameDescs) const = 0;
 
     virtual void SaveDesc(const std::string& sfileNameDescs) const = 0;
@@ -152,6 +161,22 @@ class FeatDescRegions : public Regions
 
   protected:
     std::vector<DescriptorT> _vec_descs;  // region descriptions
+    std::shared_ptr<const MappedDescsBinFile<DescriptorT>> _mappedDescs;  // memory mapped region descriptions (optional)
+
+    /// Pointer to the first descriptor, either in memory or memory mapped
+    inline const DescriptorT* descriptorsData() const { return _mappedDescs ? _mappedDescs->data() : _vec_descs.data(); }
+
+    /// Number of descriptors, either in memory or memory mapped
+    inline std::size_t descriptorsCount() const { return _mappedDescs ? _mappedDescs->size() : _vec_descs.size(); }
+
+    /// Copy the memory mapped descriptors in memory and release the mapping
+    void unmapDescriptors()
+    {
+        if (!_mappedDescs)
+            return;
+        _vec_descs.assign(_mappedDescs->data(), _mappedDescs->data() + _mappedDescs->size());
+        _mappedDescs.reset();
+    }
 
   public:
     std::string Type_id() const override { return typeid(T).name(); }
@@ -163,47 +188,80 @@ class FeatDescRegions : public Regions
     Regions* EmptyClone() const override { return new This(); }
 
     /// Read from files the regions and their corresponding descriptors.
+    /// Features files can be either in the binary or in the legacy text format.
     void Load(const std::string& sfileNameFeats, const std::string& sfileNameDescs) override
     {
+        _mappedDescs.reset();
         loadFeatsFromFile(sfileNameFeats, this->_vec_feats);
         loadDescsFromBinFile(sfileNameDescs, _vec_descs);
     }
 
-    /// Export in two separate files the regions and their corresponding descriptors.
+    /// Read from files the regions and memory map their corresponding descriptors.
+    void LoadMapped(const std::string& sfileNameFeats, const std::string& sfileNameDescs) override
+    {
+        loadFeatsFromFile(sfileNameFeats, this->_vec_feats);
+        _vec_descs.clear();
+        _mappedDescs = std::make_shared<const MappedDescsBinFile<DescriptorT>>(sfileNameDescs);
+    }
+
+    bool IsMapped() const override { return _mappedDescs != nullptr; }
+
+    /// Export in two separate binary files the regions and their corresponding descriptors.
     void Save(const std::string& sfileNameFeats, const std::string& sfileNameDescs) const override
     {
-        saveFeatsToFile(sfileNameFeats, this->_vec_feats);
-        saveDescsToBinFile(sfileNameDescs, _vec_descs);
+        saveFeatsToBinFile(sfileNameFeats, this->_vec_feats);
+        saveDescsToBinFile(sfileNameDescs, descriptorsData(), descriptorsCount());
     }
 
-    void SaveDesc(const std::string& sfileNameDescs) const override { saveDescsToBinFile(sfileNameDescs, _vec_descs); }
+    void SaveDesc(const std::string& sfileNameDescs) const override { saveDescsToBinFile(sfileNameDescs, descriptorsData(), descriptorsCount()); }
 
-    /// Mutable and non-mutable DescriptorT getters.
-    inline std::vector<DescriptorT>& Descriptors() { return _vec_descs; }
-    inline const std::vector<DescriptorT>& Descriptors() const { return _vec_descs; }
+    /**
+     * @brief Mutable and non-mutable DescriptorT getters.
+     * @note The mutable getter copies memory mapped descriptors in memory.
+     * @warning The non-mutable getter is empty for memory mapped regions (use DescriptorRawData).
+     */
+    inline std::vector<DescriptorT>& Descriptors()
+    {
+        unmapDescriptors();
+        return _vec_descs;
+    }
+    inline const std::vector<DescriptorT>& Descriptors() const
+    {
+        assert(!_mappedDescs);
+        return _vec_descs;
+    }
 
-    inline const void* blindDescriptors() const override { return &_vec_descs; }
+    inline const void* blindDescriptors() const override
+    {
+        assert(!_mappedDescs);
+        return &_vec_descs;
+    }
 
-    inline const void* DescriptorRawData() const override { return &_vec_descs[0]; }
+    inline const void* DescriptorRawData() const override { return descriptorsData(); }
 
-    inline void clearDescriptors() override { _vec_descs.clear(); }
+    inline void clearDescriptors() override
+    {
+        _vec_descs.clear();
+        _mappedDescs.reset();
+    }
 
     inline void swap(This& other)
     {
         this->_vec_feats.swap(other._vec_feats);
         _vec_descs.swap(other._vec_descs);
+        _mappedDescs.swap(other._mappedDescs);
     }
 
     // Return the distance between two descriptors
     double SquaredDescriptorDistance(std::size_t i, const Regions* genericRegions, std::size_t j) const override
     {
-        assert(i < this->_vec_descs.size());
+        assert(i < this->descriptorsCount());
         assert(genericRegions);
         assert(j < genericRegions->RegionCount());
 
         const This* regionsT = dynamic_cast<const This*>(genericRegions);
         static typename SquaredMetric<T, regionType>::Metric metric;
-        return metric(this->_vec_descs[i].getData(), regionsT->_vec_descs[j].getData(), DescriptorT::static_size);
+        return metric(this->descriptorsData()[i].getData(), regionsT->descriptorsData()[j].getData(), DescriptorT::static_size);
     }
 
     /**
@@ -213,9 +271,9 @@ class FeatDescRegions : public Regions
      */
     void CopyRegion(std::size_t i, Regions* outRegionContainer) const override
     {
-        assert(i < this->_vec_feats.size() && i < this->_vec_descs.size());
+        assert(i < this->_vec_feats.size() && i < this->descriptorsCount());
         static_cast<This*>(outRegionContainer)->_vec_feats.push_back(this->_vec_feats[i]);
-        static_cast<This*>(outRegionContainer)->_vec_descs.push_back(this->_vec_descs[i]);
+        static_cast<This*>(outRegionContainer)->Descriptors().push_back(this->descriptorsData()[i]);
     }
 
     /**
@@ -240,7 +298,7 @@ class FeatDescRegions : public Regions
         {
             const FeatureInImage& feat = featuresInImage[i];
             regionsPtr->Features().push_back(this->_vec_feats[feat._featureIndex]);
-            regionsPtr->Descriptors().push_back(this->_vec_descs[feat._featureIndex]);
+            regionsPtr->Descriptors().push_back(this->descriptorsData()[feat._featureIndex]);
 
             // This assert should be valid in theory, but in the context of CameraLocalization
             // we can have the same 2D feature associated to different 3D points (2 in practice).
@@ -72,6 +72,51 @@ BOOST_AUTO_TEST_CASE(featureIO_ASCII)
     }
 }
 
+BOOST_AUTO_TEST_CASE(featureIO_BINARY)
+{
+    Feats_T vec_feats;
+    for (int i = 0; i < CARD; ++i)
+    {
+        vec_feats.push_back(Feature_T(i, i * 2, i * 3, i * 4));
+    }
+
+    // Save them to a file
+    BOOST_CHECK_NO_THROW(saveFeatsToBinFile("tempFeatsBin.feat", vec_feats));
+    BOOST_CHECK(isFeatsBinFile("tempFeatsBin.feat"));
+
+    // Read the saved data and compare to input (to check write/read IO)
+    Feats_T vec_feats_read;
+    BOOST_CHECK_NO_THROW(loadFeatsFromBinFile("tempFeatsBin.feat", vec_feats_read));
+    BOOST_CHECK_EQUAL(CARD, vec_feats_read.size());
+
+    for (int i = 0; i < CARD; ++i)
+        BOOST_CHECK_EQUAL(vec_feats[i], vec_feats_read[i]);
+
+    // The generic loader must detect the binary format
+    Feats_T vec_feats_generic;
+    BOOST_CHECK_NO_THROW(loadFeatsFromFile("tempFeatsBin.feat", vec_feats_generic));
+    BOOST_CHECK_EQUAL(CARD, vec_feats_generic.size());
+
+    for (int i = 0; i < CARD; ++i)
+        BOOST_CHECK_EQUAL(vec_feats[i], vec_feats_generic[i]);
+}
+
+BOOST_AUTO_TEST_CASE(featureIO_ASCII_COMPATIBILITY)
+{
+    Feats_T vec_feats;
+    for (int i = 0; i < CARD; ++i)
+    {
+        vec_feats.push_back(Feature_T(i, i * 2, i * 3, i * 4));
+    }
+
+    BOOST_CHECK_NO_THROW(saveFeatsToFile("tempFeatsText.feat", vec_feats));
+    BOOST_CHECK(!isFeatsBinFile("tempFeatsText.feat"));
+
+    // A text file is not a valid binary file
+    Feats_T vec_feats_read;
+    BOOST_CHECK_THROW(loadFeatsFromBinFile("tempFeatsText.feat", vec_feats_read), std::exception);
+}
+
 //--
 //-- Descriptors interface test
 //--
@@ -129,3 +174,69 @@ BOOST_AUTO_TEST_CASE(descriptorIO_BINARY)
             BOOST_CHECK_EQUAL(vec_descs[i][j], vec_descs_read[i][j]);
     }
 }
+
+// Test memory mapping of binary descriptors
+BOOST_AUTO_TEST_CASE(descriptorIO_MAPPED)
+{
+    // Create an input series of descriptor
+    Descs_T vec_descs;
+    for (int i = 0; i < CARD; ++i)
+    {
+        Desc_T desc;
+        for (int j = 0; j < DESC_LENGTH; ++j)
+            desc[j] = i * DESC_LENGTH + j;
+        vec_descs.push_back(desc);
+    }
+
+    BOOST_CHECK_NO_THROW(saveDescsToBinFile("tempDescsMapped.desc", vec_descs));
+
+    const MappedDescsBinFile<Desc_T> mappedDescs("tempDescsMapped.desc");
+    BOOST_CHECK_EQUAL(CARD, mappedDescs.size());
+
+    for (int i = 0; i < CARD; ++i)
+    {
+        for (int j = 0; j < DESC_LENGTH; ++j)
+            BOOST_CHECK_EQUAL(vec_descs[i][j], mappedDescs.data()[i][j]);
+    }
+
+    BOOST_CHECK_THROW(MappedDescsBinFile<Desc_T>("x.desc"), std::exception);
+}
+
+// Test memory mapped regions against regions loaded in memory
+BOOST_AUTO_TEST_CASE(regionsIO_MAPPED)
+{
+    typedef ScalarRegions<float, DESC_LENGTH> Regions_T;
+
+    Regions_T regions;
+    for (int i = 0; i < CARD; ++i)
+    {
+        regions.Features().push_back(Feature_T(i, i * 2, i * 3, i * 4));
+        Desc_T desc;
+        for (int j = 0; j < DESC_LENGTH; ++j)
+            desc[j] = i * DESC_LENGTH + j;
+        regions.Descriptors().push_back(desc);
+    }
+
+    BOOST_CHECK_NO_THROW(regions.Save("tempRegions.feat", "tempRegions.desc"));
+
+    Regions_T loadedRegions;
+    Regions_T mappedRegions;
+    BOOST_CHECK_NO_THROW(loadedRegions.Load("tempRegions.feat", "tempRegions.desc"));
+    BOOST_CHECK_NO_THROW(mappedRegions.LoadMapped("tempRegions.feat", "tempRegions.desc"));
+
+    BOOST_CHECK(!loadedRegions.IsMapped());
+    BOOST_CHECK(mappedRegions.IsMapped());
+    BOOST_CHECK_EQUAL(CARD, mappedRegions.RegionCount());
+
+    for (int i = 0; i < CARD; ++i)
+    {
+        BOOST_CHECK_EQUAL(loadedRegions.Features()[i], mappedRegions.Features()[i]);
+        for (int j = 0; j < CARD; ++j)
+            BOOST_CHECK_EQUAL(loadedRegions.SquaredDescriptorDistance(i, &mappedRegions, j),
+                              mappedRegions.SquaredDescriptorDistance(i, &loadedRegions, j));
+    }
+
+    // Mutable access copies the descriptors in memory
+    BOOST_CHECK_EQUAL(CARD, mappedRegions.Descriptors().size());
+    BOOST_CHECK(!mappedRegions.IsMapped());
+}
@@ -8,16 +8,12 @@
 #pragma once
 
 #include "Hamming.hpp"
+#include "metricKernels.hpp"
 
 #include <aliceVision/numeric/Accumulator.hpp>
-#include <aliceVision/config.hpp>
-
-#if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_SSE)
-    #include <aliceVision/system/Logger.hpp>
-    #include <xmmintrin.h>
-#endif
 
 #include <cstddef>
+#include <type_traits>
 
 namespace aliceVision {
 namespace feature {
@@ -79,52 +75,21 @@ struct L2_Vectorized
     }
 };
 
-#if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_SSE)
-
-namespace optim_ss2 {
-
-/// Union to switch between SSE and float array
-union sseRegisterHelper
-{
-    __m128 m;
-    float f[4];
-};
+namespace detail {
 
-// Euclidean distance (SSE method) (squared result)
-inline float l2_sse(const float* b1, const float* b2, int size)
+/// true if the iterators point to contiguous values of type T, so the raw distance kernels can be used
+template<typename T, typename Iterator1, typename Iterator2>
+constexpr bool isRawPointerOf()
 {
-    float* b1Pt = (float*)b1;
-    float* b2Pt = (float*)b2;
-    if (size % 4 == 0)
-    {
-        __m128 srcA, srcB, temp, cumSum;
-        float zeros[4] = {0.f, 0.f, 0.f, 0.f};
-        cumSum = _mm_load_ps(zeros);
-        for (int i = 0; i < size; i += 4)
-        {
-            srcA = _mm_load_ps(b1Pt + i);
-            srcB = _mm_load_ps(b2Pt + i);
-            //-- Subtract
-            temp = _mm_sub_ps(srcA, srcB);
-            //-- Multiply
-            temp = _mm_mul_ps(temp, temp);
-            //-- sum
-            cumSum = _mm_add_ps(cumSum, temp);
-        }
-        sseRegisterHelper res;
-        res.m = cumSum;
-        return (res.f[0] + res.f[1] + res.f[2] + res.f[3]);
-    }
-    else
-    {
-        ALICEVISION_LOG_WARNING("/!\\ size is not modulus 4, distance cannot be performed in SSE");
-        return 0.0f;
-    }
+    return std::is_pointer<Iterator1>::value && std::is_pointer<Iterator2>::value &&
+           std::is_same<typename std::remove_cv<typename std::remove_pointer<Iterator1>::type>::type, T>::value &&
+           std::is_same<typename std::remove_cv<typename std::remove_pointer<Iterator2>::type>::type, T>::value;
 }
-}  // namespace optim_ss2
 
-// Template specification to run SSE L2 squared distance
-//  on float vector
+}  // namespace detail
+
+// Template specialization to run the L2 squared distance kernel
+// of the running CPU on float vectors
 template<>
 struct L2_Vectorized<float>
 {
@@ -134,11 +99,30 @@ struct L2_Vectorized<float>
     template<typename Iterator1, typename Iterator2>
     inline ResultType operator()(Iterator1 a, Iterator2 b, size_t size) const
     {
-        return optim_ss2::l2_sse(a, b, size);
+        if constexpr (detail::isRawPointerOf<float, Iterator1, Iterator2>())
+            return l2SquaredDistance(a, b, size);
+        else
+            return L2_Simple<float>()(a, b, size);
     }
 };
 
-#endif  // ALICEVISION_HAVE_SSE
+// Template specialization to run the L2 squared distance kernel
+// of the running CPU on unsigned char vectors
+template<>
+struct L2_Vectorized<unsigned char>
+{
+    typedef unsigned char ElementType;
+    typedef Accumulator<unsigned char>::Type ResultType;
+
+    template<typename Iterator1, typename Iterator2>
+    inline ResultType operator()(Iterator1 a, Iterator2 b, size_t size) const
+    {
+        if constexpr (detail::isRawPointerOf<unsigned char, Iterator1, Iterator2>())
+            return static_cast<ResultType>(l2SquaredDistance(a, b, size));
+        else
+            return L2_Simple<unsigned char>()(a, b, size);
+    }
+};
 
 }  // namespace feature
 }  // namespace aliceVision
@@ -0,0 +1,328 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2023 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "metricKernels.hpp"
+
+#include <aliceVision/system/cpu.hpp>
+#include <aliceVision/system/Logger.hpp>
+
+#include <cstdint>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64)
+    #define ALICEVISION_METRIC_KERNELS_X86
+    #include <immintrin.h>
+    #if defined(__GNUC__) || defined(__clang__)
+        // compile the kernel for the given extensions, whatever the architecture flags of the build
+        #define ALICEVISION_TARGET(extensions) __attribute__((target(extensions)))
+    #else
+        // MSVC allows the intrinsics of all extensions without specific flags
+        #define ALICEVISION_TARGET(extensions)
+    #endif
+#elif defined(__aarch64__)
+    #define ALICEVISION_METRIC_KERNELS_NEON
+    #include <arm_neon.h>
+#endif
+
+namespace aliceVision {
+namespace feature {
+
+namespace {
+
+// https://graphics.stanford.edu/~seander/bithacks.html#CountBitsSetTable
+inline unsigned int popCount64(std::uint64_t n)
+{
+    n -= ((n >> 1) & 0x5555555555555555ULL);
+    n = (n & 0x3333333333333333ULL) + ((n >> 2) & 0x3333333333333333ULL);
+    return static_cast<unsigned int>((((n + (n >> 4)) & 0x0f0f0f0f0f0f0f0fULL) * 0x0101010101010101ULL) >> 56);
+}
+
+inline std::uint64_t load64(const unsigned char* p)
+{
+    std::uint64_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+float l2FloatScalar(const float* a, const float* b, std::size_t size)
+{
+    float d0 = 0.f, d1 = 0.f, d2 = 0.f, d3 = 0.f;
+    std::size_t i = 0;
+    for (; i + 4 <= size; i += 4)
+    {
+        const float e0 = a[i] - b[i];
+        const float e1 = a[i + 1] - b[i + 1];
+        const float e2 = a[i + 2] - b[i + 2];
+        const float e3 = a[i + 3] - b[i + 3];
+        d0 += e0 * e0;
+        d1 += e1 * e1;
+        d2 += e2 * e2;
+        d3 += e3 * e3;
+    }
+    for (; i < size; ++i)
+    {
+        const float e = a[i] - b[i];
+        d0 += e * e;
+    }
+    return (d0 + d1) + (d2 + d3);
+}
+
+int l2UCharScalar(const unsigned char* a, const unsigned char* b, std::size_t size)
+{
+    int result = 0;
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        const int e = int(a[i]) - int(b[i]);
+        result += e * e;
+    }
+    return result;
+}
+
+unsigned int hammingScalar(const unsigned char* a, const unsigned char* b, std::size_t nbBytes)
+{
+    unsigned int result = 0;
+    std::size_t i = 0;
+    for (; i + 8 <= nbBytes; i += 8)
+        result += popCount64(load64(a + i) ^ load64(b + i));
+    for (; i < nbBytes; ++i)
+        result += popCount64(std::uint64_t(a[i] ^ b[i]));
+    return result;
+}
+
+#ifdef ALICEVISION_METRIC_KERNELS_X86
+
+ALICEVISION_TARGET("avx2,fma") float l2FloatAvx2(const float* a, const float* b, std::size_t size)
+{
+    __m256 sum0 = _mm256_setzero_ps();
+    __m256 sum1 = _mm256_setzero_ps();
+    std::size_t i = 0;
+    for (; i + 16 <= size; i += 16)
+    {
+        const __m256 d0 = _mm256_sub_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i));
+        const __m256 d1 = _mm256_sub_ps(_mm256_loadu_ps(a + i + 8), _mm256_loadu_ps(b + i + 8));
+        sum0 = _mm256_fmadd_ps(d0, d0, sum0);
+        sum1 = _mm256_fmadd_ps(d1, d1, sum1);
+    }
+    for (; i + 8 <= size; i += 8)
+    {
+        const __m256 d = _mm256_sub_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i));
+        sum0 = _mm256_fmadd_ps(d, d, sum0);
+    }
+    sum0 = _mm256_add_ps(sum0, sum1);
+    __m128 s = _mm_add_ps(_mm256_castps256_ps128(sum0), _mm256_extractf128_ps(sum0, 1));
+    s = _mm_add_ps(s, _mm_movehl_ps(s, s));
+    s = _mm_add_ss(s, _mm_shuffle_ps(s, s, 1));
+    float result = _mm_cvtss_f32(s);
+    for (; i < size; ++i)
+    {
+        const float e = a[i] - b[i];
+        result += e * e;
+    }
+    return result;
+}
+
+ALICEVISION_TARGET("avx2") int l2UCharAvx2(const unsigned char* a, const unsigned char* b, std::size_t size)
+{
+    // widen to 16 bits, the sum of 2 squared differences fits in each 32 bits lane
+    __m256i sum = _mm256_setzero_si256();
+    std::size_t i = 0;
+    for (; i + 16 <= size; i += 16)
+    {
+        const __m256i va = _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i)));
+        const __m256i vb = _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i)));
+        const __m256i d = _mm256_sub_epi16(va, vb);
+        sum = _mm256_add_epi32(sum, _mm256_madd_epi16(d, d));
+    }
+    __m128i s = _mm_add_epi32(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1));
+    s = _mm_add_epi32(s, _mm_shuffle_epi32(s, _MM_SHUFFLE(1, 0, 3, 2)));
+    s = _mm_add_epi32(s, _mm_shuffle_epi32(s, _MM_SHUFFLE(2, 3, 0, 1)));
+    int result = _mm_cvtsi128_si32(s);
+    for (; i < size; ++i)
+    {
+        const int e = int(a[i]) - int(b[i]);
+        result += e * e;
+    }
+    return result;
+}
+
+ALICEVISION_TARGET("avx512f") float l2FloatAvx512(const float* a, const float* b, std::size_t size)
+{
+    __m512 sum0 = _mm512_setzero_ps();
+    __m512 sum1 = _mm512_setzero_ps();
+    std::size_t i = 0;
+    for (; i + 32 <= size; i += 32)
+    {
+        const __m512 d0 = _mm512_sub_ps(_mm512_loadu_ps(a + i), _mm512_loadu_ps(b + i));
+        const __m512 d1 = _mm512_sub_ps(_mm512_loadu_ps(a + i + 16), _mm512_loadu_ps(b + i + 16));
+        sum0 = _mm512_fmadd_ps(d0, d0, sum0);
+        sum1 = _mm512_fmadd_ps(d1, d1, sum1);
+    }
+    // the remaining values are loaded with a mask, so nothing is read after the end of the arrays
+    for (; i < size; i += 16)
+    {
+        const std::size_t n = size - i;
+        const __mmask16 mask = (n >= 16) ? __mmask16(0xFFFF) : __mmask16((1u << n) - 1u);
+        const __m512 d = _mm512_sub_ps(_mm512_maskz_loadu_ps(mask, a + i), _mm512_maskz_loadu_ps(mask, b + i));
+        sum0 = _mm512_fmadd_ps(d, d, sum0);
+    }
+    return _mm512_reduce_add_ps(_mm512_add_ps(sum0, sum1));
+}
+
+ALICEVISION_TARGET("avx512f,avx512bw") int l2UCharAvx512(const unsigned char* a, const unsigned char* b, std::size_t size)
+{
+    __m512i sum = _mm512_setzero_si512();
+    std::size_t i = 0;
+    for (; i + 32 <= size; i += 32)
+    {
+        const __m512i va = _mm512_cvtepu8_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i)));
+        const __m512i vb = _mm512_cvtepu8_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i)));
+        const __m512i d = _mm512_sub_epi16(va, vb);
+        sum = _mm512_add_epi32(sum, _mm512_madd_epi16(d, d));
+    }
+    int result = _mm512_reduce_add_epi32(sum);
+    for (; i < size; ++i)
+    {
+        const int e = int(a[i]) - int(b[i]);
+        result += e * e;
+    }
+    return result;
+}
+
+ALICEVISION_TARGET("popcnt") unsigned int hammingPopcnt(const unsigned char* a, const unsigned char* b, std::size_t nbBytes)
+{
+    // 2 independent accumulators to hide the popcnt latency
+    std::uint64_t result0 = 0;
+    std::uint64_t result1 = 0;
+    std::size_t i = 0;
+    for (; i + 16 <= nbBytes; i += 16)
+    {
+        result0 += _mm_popcnt_u64(load64(a + i) ^ load64(b + i));
+        result1 += _mm_popcnt_u64(load64(a + i + 8) ^ load64(b + i + 8));
+    }
+    for (; i + 8 <= nbBytes; i += 8)
+        result0 += _mm_popcnt_u64(load64(a + i) ^ load64(b + i));
+    for (; i < nbBytes; ++i)
+        result0 += _mm_popcnt_u32(a[i] ^ b[i]);
+    return static_cast<unsigned int>(result0 + result1);
+}
+
+#endif  // ALICEVISION_METRIC_KERNELS_X86
+
+#ifdef ALICEVISION_METRIC_KERNELS_NEON
+
+float l2FloatNeon(const float* a, const float* b, std::size_t size)
+{
+    float32x4_t sum0 = vdupq_n_f32(0.f);
+    float32x4_t sum1 = vdupq_n_f32(0.f);
+    std::size_t i = 0;
+    for (; i + 8 <= size; i += 8)
+    {
+        const float32x4_t d0 = vsubq_f32(vld1q_f32(a + i), vld1q_f32(b + i));
+        const float32x4_t d1 = vsubq_f32(vld1q_f32(a + i + 4), vld1q_f32(b + i + 4));
+        sum0 = vfmaq_f32(sum0, d0, d0);
+        sum1 = vfmaq_f32(sum1, d1, d1);
+    }
+    float result = vaddvq_f32(vaddq_f32(sum0, sum1));
+    for (; i < size; ++i)
+    {
+        const float e = a[i] - b[i];
+        result += e * e;
+    }
+    return result;
+}
+
+int l2UCharNeon(const unsigned char* a, const unsigned char* b, std::size_t size)
+{
+    uint32x4_t sum = vdupq_n_u32(0);
+    std::size_t i = 0;
+    for (; i + 16 <= size; i += 16)
+    {
+        const uint8x16_t d = vabdq_u8(vld1q_u8(a + i), vld1q_u8(b + i));
+        // the squares of the absolute differences fit in 16 bits
+        sum = vpadalq_u16(sum, vmull_u8(vget_low_u8(d), vget_low_u8(d)));
+        sum = vpadalq_u16(sum, vmull_u8(vget_high_u8(d), vget_high_u8(d)));
+    }
+    int result = static_cast<int>(vaddvq_u32(sum));
+    for (; i < size; ++i)
+    {
+        const int e = int(a[i]) - int(b[i]);
+        result += e * e;
+    }
+    return result;
+}
+
+unsigned int hammingNeon(const unsigned char* a, const unsigned char* b, std::size_t nbBytes)
+{
+    uint32x4_t sum = vdupq_n_u32(0);
+    std::size_t i = 0;
+    for (; i + 16 <= nbBytes; i += 16)
+    {
+        const uint8x16_t bits = vcntq_u8(veorq_u8(vld1q_u8(a + i), vld1q_u8(b + i)));
+        sum = vpadalq_u16(sum, vpaddlq_u8(bits));
+    }
+    unsigned int result = vaddvq_u32(sum);
+    for (; i < nbBytes; ++i)
+        result += popCount64(std::uint64_t(a[i] ^ b[i]));
+    return result;
+}
+
+#endif  // ALICEVISION_METRIC_KERNELS_NEON
+
+MetricKernels selectMetricKernels()
+{
+    MetricKernels kernels = getScalarMetricKernels();
+    const system::CpuFeatures& cpu = system::get_cpu_features();
+    (void)cpu;
+
+#ifdef ALICEVISION_METRIC_KERNELS_X86
+    if (cpu.popcnt)
+    {
+        kernels.hamming = &hammingPopcnt;
+        kernels.name = "popcnt";
+    }
+    if (cpu.avx2 && cpu.fma)
+    {
+        kernels.l2Float = &l2FloatAvx2;
+        kernels.l2UChar = &l2UCharAvx2;
+        kernels.name = "avx2";
+    }
+    if (cpu.avx512f && cpu.avx512bw)
+    {
+        kernels.l2Float = &l2FloatAvx512;
+        kernels.l2UChar = &l2UCharAvx512;
+        kernels.name = "avx512";
+    }
+#endif
+#ifdef ALICEVISION_METRIC_KERNELS_NEON
+    if (cpu.neon)
+    {
+        kernels.l2Float = &l2FloatNeon;
+        kernels.l2UChar = &l2UCharNeon;
+        kernels.hamming = &hammingNeon;
+        kernels.name = "neon";
+    }
+#endif
+
+    ALICEVISION_LOG_DEBUG("Descriptor distance kernels: " << kernels.name);
+    return kernels;
+}
+
+}  // namespace
+
+const MetricKernels& getScalarMetricKernels()
+{
+    static const MetricKernels kernels = {&l2FloatScalar, &l2UCharScalar, &hammingScalar, "scalar"};
+    return kernels;
+}
+
+const MetricKernels& getMetricKernels()
+{
+    static const MetricKernels kernels = selectMetricKernels();
+    return kernels;
+}
+
+}  // namespace feature
+}  // namespace aliceVision
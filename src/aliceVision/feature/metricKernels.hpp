@@ -0,0 +1,59 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2023 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <cstddef>
+
+namespace aliceVision {
+namespace feature {
+
+/**
+ * @brief Distance kernels on raw descriptors, specialized for the instruction sets of the running CPU.
+ *
+ * The AVX2, AVX-512 and NEON versions are compiled in all builds and selected at the first call
+ * from system::get_cpu_features(), so the binaries do not require a specific architecture.
+ */
+struct MetricKernels
+{
+    typedef float (*L2FloatKernel)(const float* a, const float* b, std::size_t size);
+    typedef int (*L2UCharKernel)(const unsigned char* a, const unsigned char* b, std::size_t size);
+    typedef unsigned int (*HammingKernel)(const unsigned char* a, const unsigned char* b, std::size_t nbBytes);
+
+    /// squared euclidean distance of float descriptors
+    L2FloatKernel l2Float;
+    /// squared euclidean distance of unsigned char descriptors, computed exactly with integers
+    L2UCharKernel l2UChar;
+    /// number of different bits of binary descriptors
+    HammingKernel hamming;
+    /// name of the selected instruction sets, for the logs
+    const char* name;
+};
+
+/**
+ * @brief Get the distance kernels selected for the running CPU.
+ */
+const MetricKernels& getMetricKernels();
+
+/**
+ * @brief Get the portable distance kernels, used as reference and on CPUs without the supported extensions.
+ */
+const MetricKernels& getScalarMetricKernels();
+
+/// Squared euclidean distance of 2 float descriptors of the given size
+inline float l2SquaredDistance(const float* a, const float* b, std::size_t size) { return getMetricKernels().l2Float(a, b, size); }
+
+/// Squared euclidean distance of 2 unsigned char descriptors of the given size
+inline int l2SquaredDistance(const unsigned char* a, const unsigned char* b, std::size_t size) { return getMetricKernels().l2UChar(a, b, size); }
+
+/// Hamming distance of 2 binary descriptors of the given size in bytes
+inline unsigned int hammingDistance(const unsigned char* a, const unsigned char* b, std::size_t nbBytes)
+{
+    return getMetricKernels().hamming(a, b, nbBytes);
+}
+
+}  // namespace feature
+}  // namespace aliceVision
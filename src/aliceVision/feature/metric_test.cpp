@@ -6,9 +6,14 @@
 // You can obtain one at https://mozilla.org/MPL/2.0/.
 
 #include <aliceVision/feature/metric.hpp>
+#include <aliceVision/feature/metricKernels.hpp>
+#include <aliceVision/system/Logger.hpp>
+#include <aliceVision/system/Timer.hpp>
 
 #include <iostream>
+#include <random>
 #include <string>
+#include <vector>
 
 #define BOOST_TEST_MODULE matchingMetric
 
@@ -152,3 +157,86 @@ BOOST_AUTO_TEST_CASE(Metric_HAMMING_BITSET_RAW_MEMORY_32BITS)
         }
     }
 }
+
+BOOST_AUTO_TEST_CASE(Metric_kernels_sameAsScalar)
+{
+    const MetricKernels& kernels = getMetricKernels();
+    const MetricKernels& scalarKernels = getScalarMetricKernels();
+    ALICEVISION_LOG_INFO("Descriptor distance kernels: " << kernels.name);
+
+    std::mt19937 generator(0);
+    std::uniform_int_distribution<int> ucharDistribution(0, 255);
+    std::uniform_real_distribution<float> floatDistribution(0.f, 1.f);
+
+    // sizes with and without tails, starting from unaligned addresses
+    for (const std::size_t size : {1, 3, 8, 15, 16, 31, 33, 61, 64, 128, 130})
+    {
+        std::vector<unsigned char> ucharA(size + 1), ucharB(size + 1);
+        std::vector<float> floatA(size + 1), floatB(size + 1);
+        for (std::size_t i = 0; i <= size; ++i)
+        {
+            ucharA[i] = ucharDistribution(generator);
+            ucharB[i] = ucharDistribution(generator);
+            floatA[i] = floatDistribution(generator);
+            floatB[i] = floatDistribution(generator);
+        }
+
+        BOOST_CHECK_EQUAL(kernels.l2UChar(&ucharA[1], &ucharB[1], size), scalarKernels.l2UChar(&ucharA[1], &ucharB[1], size));
+        BOOST_CHECK_EQUAL(kernels.hamming(&ucharA[1], &ucharB[1], size), scalarKernels.hamming(&ucharA[1], &ucharB[1], size));
+        BOOST_CHECK_CLOSE(kernels.l2Float(&floatA[1], &floatB[1], size), scalarKernels.l2Float(&floatA[1], &floatB[1], size), 1e-3);
+        BOOST_CHECK_CLOSE(L2_Vectorized<float>()(&floatA[1], &floatB[1], size), L2_Simple<float>()(&floatA[1], &floatB[1], size), 1e-3);
+        BOOST_CHECK_EQUAL(L2_Vectorized<unsigned char>()(&ucharA[1], &ucharB[1], size), L2_Simple<unsigned char>()(&ucharA[1], &ucharB[1], size));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(Metric_kernels_benchmark)
+{
+    const MetricKernels& kernels = getMetricKernels();
+    const MetricKernels& scalarKernels = getScalarMetricKernels();
+
+    // SIFT and AKAZE descriptors sizes
+    const std::size_t siftSize = 128;
+    const std::size_t akazeSize = 64;
+    const int nbDescriptors = 2000;
+    const int nbIterations = 1000;
+
+    std::mt19937 generator(0);
+    std::uniform_int_distribution<int> ucharDistribution(0, 255);
+    std::vector<unsigned char> ucharData(nbDescriptors * siftSize);
+    std::vector<float> floatData(nbDescriptors * siftSize);
+    for (std::size_t i = 0; i < ucharData.size(); ++i)
+    {
+        ucharData[i] = ucharDistribution(generator);
+        floatData[i] = ucharData[i] / 255.f;
+    }
+
+    // time the distances between the first descriptor and all the others
+    auto benchmark = [&](auto&& distance) {
+        double sum = 0.0;
+        system::Timer timer;
+        for (int it = 0; it < nbIterations; ++it)
+        {
+            for (int i = 0; i < nbDescriptors; ++i)
+                sum += distance(i);
+        }
+        BOOST_CHECK(sum >= 0.0);
+        return timer.elapsedMs();
+    };
+
+    const double l2FloatMs = benchmark([&](int i) { return kernels.l2Float(&floatData[0], &floatData[i * siftSize], siftSize); });
+    const double l2FloatScalarMs = benchmark([&](int i) { return scalarKernels.l2Float(&floatData[0], &floatData[i * siftSize], siftSize); });
+    const double l2UCharMs = benchmark([&](int i) { return kernels.l2UChar(&ucharData[0], &ucharData[i * siftSize], siftSize); });
+    const double l2UCharScalarMs =
+      benchmark([&](int i) { return scalarKernels.l2UChar(&ucharData[0], &ucharData[i * siftSize], siftSize); });
+    const double hammingMs = benchmark([&](int i) { return kernels.hamming(&ucharData[0], &ucharData[i * akazeSize], akazeSize); });
+    const double hammingScalarMs =
+      benchmark([&](int i) { return scalarKernels.hamming(&ucharData[0], &ucharData[i * akazeSize], akazeSize); });
+
+    ALICEVISION_LOG_INFO("Descriptor distance kernels benchmark (" << kernels.name << " / scalar), " << nbIterations * nbDescriptors
+                                                                    << " distances:" << std::endl
+                                                                    << "\t- L2 float: " << l2FloatMs << " ms / " << l2FloatScalarMs << " ms"
+                                                                    << std::endl
+                                                                    << "\t- L2 unsigned char: " << l2UCharMs << " ms / " << l2UCharScalarMs
+                                                                    << " ms" << std::endl
+                                                                    << "\t- Hamming: " << hammingMs << " ms / " << hammingScalarMs << " ms");
+}
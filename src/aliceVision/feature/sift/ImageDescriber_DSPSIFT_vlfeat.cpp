@@ -10,6 +10,7 @@
 #include <aliceVision/feature/ImageDescriber.hpp>
 #include <aliceVision/feature/regionsFactory.hpp>
 #include <aliceVision/feature/sift/SIFT.hpp>
+#include <aliceVision/feature/sift/SiftPatchDescriptor.hpp>
 
 extern "C"
 {
@@ -291,8 +292,6 @@ bool extractDSPSIFT(const image::Image<float>& image,
         regionsCasted->Features().resize(indexSort.size());
         regionsCasted->Descriptors().resize(indexSort.size());
 
-        std::unique_ptr<VlSiftFilt, void (*)(VlSiftFilt*)> sift(vl_sift_new(16, 16, 1, params._numScales, 0), &vl_sift_delete);
-
         // All constant parameters
         const size_t kPatchResolution = 15;
         const size_t kPatchSide = 2 * kPatchResolution + 1;
@@ -311,11 +310,16 @@ bool extractDSPSIFT(const image::Image<float>& image,
             dspNumScales = params.dspNumScales;
         }
 
+        // the patches of all keypoints and DSP scales share the same geometry,
+        // so the spatial binning of the descriptor is computed once
+        const SiftPatchDescriptor patchDescriptor(kPatchResolution, kSigma);
+
 #pragma omp parallel
         {
             VlCovDetBuffer internalBuffer;
             vl_covdetbuffer_init(&internalBuffer);
-            Eigen::Matrix<float, Eigen::Dynamic, 128, Eigen::RowMajor> descriptorsOverDspScales(dspNumScales, 128);
+            SiftPatchDescriptor::Buffer descriptorBuffer;
+            Eigen::Matrix<float, 1, 128> descriptorAtScale;
             std::vector<float> patch(kPatchSide * kPatchSide);
             std::vector<float> patchXY(2 * kPatchSide * kPatchSide);
 
@@ -325,6 +329,9 @@ bool extractDSPSIFT(const image::Image<float>& image,
                 const int iIndex = indexSort[oIndex];
                 const auto& inFeat = features[iIndex];
 
+                // mean of the descriptors over the DSP scales
+                Eigen::Matrix<float, 1, 128> descriptor = Eigen::Matrix<float, 1, 128>::Zero();
+
                 for (int s = 0; s < dspNumScales; ++s)
                 {
                     const double dspScale = dspMinScale + s * dspScaleStep;
@@ -340,26 +347,12 @@ bool extractDSPSIFT(const image::Image<float>& image,
 
                     vl_imgradient_polar_f(patchXY.data(), patchXY.data() + 1, 2, 2 * kPatchSide, patch.data(), kPatchSide, kPatchSide, kPatchSide);
 
-                    vl_sift_calc_raw_descriptor(sift.get(),
-                                                patchXY.data(),
-                                                descriptorsOverDspScales.row(s).data(),
-                                                kPatchSide,
-                                                kPatchSide,
-                                                kPatchResolution,
-                                                kPatchResolution,
-                                                kSigma,
-                                                /*angle0=*/0);
+                    patchDescriptor.computeDescriptor(patchXY.data(), descriptorAtScale.data(), descriptorBuffer);
+                    descriptor += descriptorAtScale;
                 }
 
-                Eigen::Matrix<float, 1, 128> descriptor;
                 if (dspNumScales > 1)
-                {
-                    descriptor = descriptorsOverDspScales.colwise().mean();
-                }
-                else
-                {
-                    descriptor = descriptorsOverDspScales;
-                }
+                    descriptor /= static_cast<float>(dspNumScales);
 
                 // [a0 a2] [r1 -r2]
                 // [a1 a3] [r2 r1]
@@ -22,33 +22,24 @@ namespace feature {
 std::unique_ptr<PopSift> ImageDescriber_SIFT_popSIFT::_popSift{nullptr};
 std::atomic<int> ImageDescriber_SIFT_popSIFT::_instanceCounter{0};
 
-void ImageDescriber_SIFT_popSIFT::setConfigurationPreset(ConfigurationPreset preset)
-{
-    _params.setPreset(preset);
-    _popSift.reset(nullptr);  // reset by describe method
-}
+namespace {
 
-bool ImageDescriber_SIFT_popSIFT::describe(const image::Image<float>& image,
-                                           std::unique_ptr<Regions>& regions,
-                                           const image::Image<unsigned char>* mask)
+/**
+ * @brief Convert the PopSift features of an image to regions
+ */
+void convertFeatures(popsift::Features& popFeatures, std::unique_ptr<Regions>& regions)
 {
-    if (_popSift == nullptr)
-        resetConfiguration();
-
-    std::unique_ptr<SiftJob> job(_popSift->enqueue(image.Width(), image.Height(), &image(0, 0)));
-    std::unique_ptr<popsift::Features> popFeatures(job->get());
-
-    allocate(regions);
+    regions.reset(new SIFT_Regions);
 
     // Build alias to cached data
     SIFT_Regions* regionsCasted = dynamic_cast<SIFT_Regions*>(regions.get());
-    regionsCasted->Features().reserve(popFeatures->getDescriptorCount());
-    regionsCasted->Descriptors().reserve(popFeatures->getDescriptorCount());
+    regionsCasted->Features().reserve(popFeatures.getDescriptorCount());
+    regionsCasted->Descriptors().reserve(popFeatures.getDescriptorCount());
 
-    ALICEVISION_LOG_TRACE("PopSIFT features count: " << popFeatures->getFeatureCount() << ", descriptors count: " << popFeatures->getDescriptorCount()
+    ALICEVISION_LOG_TRACE("PopSIFT features count: " << popFeatures.getFeatureCount() << ", descriptors count: " << popFeatures.getDescriptorCount()
                                                      << std::endl);
 
-    for (const auto& popFeat : *popFeatures)
+    for (const auto& popFeat : popFeatures)
     {
         for (int orientationIndex = 0; orientationIndex < popFeat.num_ori; ++orientationIndex)
         {
@@ -67,6 +58,52 @@ bool ImageDescriber_SIFT_popSIFT::describe(const image::Image<float>& image,
     }
 
     ALICEVISION_LOG_TRACE("aliceVision PopSIFT feature count : " << regionsCasted->RegionCount() << std::endl);
+}
+
+}  // namespace
+
+void ImageDescriber_SIFT_popSIFT::setConfigurationPreset(ConfigurationPreset preset)
+{
+    _params.setPreset(preset);
+    _popSift.reset(nullptr);  // reset by describe method
+}
+
+bool ImageDescriber_SIFT_popSIFT::describe(const image::Image<float>& image,
+                                           std::unique_ptr<Regions>& regions,
+                                           const image::Image<unsigned char>* mask)
+{
+    if (_popSift == nullptr)
+        resetConfiguration();
+
+    std::unique_ptr<SiftJob> job(_popSift->enqueue(image.Width(), image.Height(), &image(0, 0)));
+    std::unique_ptr<popsift::Features> popFeatures(job->get());
+
+    convertFeatures(*popFeatures, regions);
+
+    return true;
+}
+
+bool ImageDescriber_SIFT_popSIFT::describeBatch(const std::vector<const image::Image<float>*>& images,
+                                                std::vector<std::unique_ptr<Regions>>& regions)
+{
+    if (_popSift == nullptr)
+        resetConfiguration();
+
+    // enqueue all the images first, PopSift copies them in its page-locked buffers
+    // and overlaps the upload of the next images with the extraction of the previous ones
+    std::vector<std::unique_ptr<SiftJob>> jobs;
+    jobs.reserve(images.size());
+    for (const image::Image<float>* image : images)
+        jobs.emplace_back(_popSift->enqueue(image->Width(), image->Height(), &(*image)(0, 0)));
+
+    regions.resize(images.size());
+    for (std::size_t i = 0; i < jobs.size(); ++i)
+    {
+        std::unique_ptr<popsift::Features> popFeatures(jobs.at(i)->get());
+        convertFeatures(*popFeatures, regions.at(i));
+    }
+
+    ALICEVISION_LOG_TRACE("PopSIFT batch of " << images.size() << " images done." << std::endl);
 
     return true;
 }
@@ -86,6 +86,16 @@ class ImageDescriber_SIFT_popSIFT : public ImageDescriber
      */
     bool describe(const image::Image<float>& image, std::unique_ptr<Regions>& regions, const image::Image<unsigned char>* mask = nullptr) override;
 
+    /**
+     * @brief Detect regions on a batch of float images and compute their attributes (description)
+     * @note All the images are enqueued before retrieving the first result,
+     *       so PopSift uploads the next images while the GPU extracts the previous ones.
+     * @param[in] images The images
+     * @param[out] regions The detected regions and attributes of each image
+     * @return True if detection succeed for all images.
+     */
+    bool describeBatch(const std::vector<const image::Image<float>*>& images, std::vector<std::unique_ptr<Regions>>& regions) override;
+
     /**
      * @brief Allocate Regions type depending of the ImageDescriber
      * @param[in,out] regions
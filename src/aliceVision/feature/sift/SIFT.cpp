@@ -6,6 +6,10 @@
 
 #include "SIFT.hpp"
 
+#include <algorithm>
+#include <array>
+#include <limits>
+
 namespace aliceVision {
 namespace feature {
 
@@ -136,6 +140,281 @@ void VLFeatInstance::destroy()
         vl_destructor();
 }
 
+namespace {
+
+/**
+ * @brief Order of the keypoints of the grid filtering, the best keypoints first.
+ */
+struct KeypointOrder
+{
+    EFeatureConstrastFiltering contrastFiltering;
+    /// order by peak value instead of scale for the filtering modes without a specific order
+    bool byPeakValue;
+
+    bool operator()(float scaleA, float peakValueA, float scaleB, float peakValueB) const
+    {
+        if (contrastFiltering == EFeatureConstrastFiltering::GridSortScaleSteps ||
+            contrastFiltering == EFeatureConstrastFiltering::GridSortOctaveSteps)
+        {
+            // 3 scale steps per octave, or 1 for the octave steps
+            const float steps = (contrastFiltering == EFeatureConstrastFiltering::GridSortScaleSteps) ? 3.0f : 1.0f;
+            const int scaleStepA = int(log2(scaleA) * steps);
+            const int scaleStepB = int(log2(scaleB) * steps);
+            if (scaleStepA == scaleStepB)
+            {
+                // sort by peak value, when we are in the same scale
+                return peakValueA > peakValueB;
+            }
+            return scaleStepA > scaleStepB;
+        }
+        if (contrastFiltering == EFeatureConstrastFiltering::GridSort)
+            return scaleA * peakValueA > scaleB * peakValueB;
+        if (byPeakValue)
+            return peakValueA > peakValueB;
+        return scaleA > scaleB;
+    }
+};
+
+/// @return the index of the grid cell of a position
+std::size_t getGridCellIndex(float x, float y, std::size_t gridSize, int w, int h)
+{
+    const std::size_t cellX = std::min(std::size_t(x / (w / double(gridSize))), gridSize - 1);
+    const std::size_t cellY = std::min(std::size_t(y / (h / double(gridSize))), gridSize - 1);
+    return cellX * gridSize + cellY;
+}
+
+/**
+ * @brief Grid filtering of the keypoints of an octave.
+ *        Keeps the best keypoints of each cell, then the best other ones up to maxTotalKeypoints.
+ * @note The keypoints are selected with nth_element, the result is not sorted.
+ */
+std::vector<IndexT> gridFilterOctaveKeypoints(const VlSiftKeypoint* keys, int nkeys, const SiftParams& params, int w, int h)
+{
+    const KeypointOrder order{params._contrastFiltering, true};
+    const auto isBetter = [&](IndexT a, IndexT b) { return order(keys[a].sigma, keys[a].peak_value, keys[b].sigma, keys[b].peak_value); };
+
+    const std::size_t sizeMat = params._gridSize * params._gridSize;
+    std::vector<std::vector<IndexT>> keypointsPerCell(sizeMat);
+    for (IndexT i = 0; i < nkeys; ++i)
+        keypointsPerCell[getGridCellIndex(keys[i].x, keys[i].y, params._gridSize, w, h)].push_back(i);
+
+    // the first (maxTotalKeypoints / sizeMat - 1) keypoints of each cell are kept
+    const std::size_t cellCapacity = std::max(params._maxTotalKeypoints / sizeMat, std::size_t(1)) - 1;
+
+    std::vector<IndexT> filteredIndexes;
+    std::vector<IndexT> rejectedIndexes;
+    filteredIndexes.reserve(params._maxTotalKeypoints);
+    rejectedIndexes.reserve(nkeys);
+
+    for (std::vector<IndexT>& cellKeypoints : keypointsPerCell)
+    {
+        const auto cellEnd = cellKeypoints.begin() + std::min(cellCapacity, cellKeypoints.size());
+        std::nth_element(cellKeypoints.begin(), cellEnd, cellKeypoints.end(), isBetter);
+        filteredIndexes.insert(filteredIndexes.end(), cellKeypoints.begin(), cellEnd);
+        rejectedIndexes.insert(rejectedIndexes.end(), cellEnd, cellKeypoints.end());
+    }
+
+    // If we don't have enough features (less than maxTotalKeypoints) after the grid filtering (empty
+    // regions in the grid for example). We add the best other ones, without repartition constraint.
+    if (filteredIndexes.size() < params._maxTotalKeypoints && !rejectedIndexes.empty())
+    {
+        const std::size_t remainingElements = std::min(rejectedIndexes.size(), params._maxTotalKeypoints - filteredIndexes.size());
+        ALICEVISION_LOG_TRACE("Octave Grid filtering -- Copy remaining points: " << remainingElements);
+        std::nth_element(rejectedIndexes.begin(), rejectedIndexes.begin() + remainingElements, rejectedIndexes.end(), isBetter);
+        filteredIndexes.insert(filteredIndexes.end(), rejectedIndexes.begin(), rejectedIndexes.begin() + remainingElements);
+    }
+    return filteredIndexes;
+}
+
+/**
+ * @brief Selection of the features of the image, fed octave by octave before their descriptors are computed.
+ *
+ * With the grid filtering, the best (maxTotalKeypoints / sizeMat - 1) features of each cell and the best
+ * maxTotalKeypoints features rejected by their cell are kept in bounded heaps.
+ * A feature dropped by the heaps cannot be part of the grid filtering result,
+ * so its descriptor is never computed and its slot is reused by the next octaves.
+ * Without the grid filtering, all the features are kept.
+ */
+class FeatureSelection
+{
+  public:
+    static constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+
+    FeatureSelection(const SiftParams& params, int w, int h)
+      : _order{params._contrastFiltering, false},
+        _gridSize(params._gridSize),
+        _maxTotalKeypoints(params._maxTotalKeypoints),
+        _w(w),
+        _h(h)
+    {
+        _gridFiltering = params._gridSize && params._maxTotalKeypoints &&
+                         params._contrastFiltering != EFeatureConstrastFiltering::NonExtremaFiltering;
+        if (_gridFiltering)
+        {
+            const std::size_t sizeMat = _gridSize * _gridSize;
+            _cellHeaps.resize(sizeMat);
+            _cellCapacity = std::max(_maxTotalKeypoints / sizeMat, std::size_t(1)) - 1;
+        }
+    }
+
+    /**
+     * @brief Add a feature to the selection, it may evict a feature previously selected.
+     * @return the slot of the feature, or npos if the feature is not selected
+     */
+    std::size_t insert(const PointFeature& feature, float peakValue)
+    {
+        const std::size_t slot = newSlot(feature, peakValue);
+        ++_nbInserted;
+
+        if (!_gridFiltering)
+        {
+            _allSlots.push_back(slot);
+            return slot;
+        }
+
+        std::vector<std::size_t>& cellHeap = _cellHeaps[getGridCellIndex(feature.x(), feature.y(), _gridSize, _w, _h)];
+        std::size_t rejectedSlot = slot;
+        if (cellHeap.size() < _cellCapacity)
+        {
+            cellHeap.push_back(slot);
+            std::push_heap(cellHeap.begin(), cellHeap.end(), SlotOrder{this});
+            rejectedSlot = npos;
+        }
+        else if (!cellHeap.empty() && isBetter(slot, cellHeap.front()))
+        {
+            // the worst feature of the cell is replaced
+            std::pop_heap(cellHeap.begin(), cellHeap.end(), SlotOrder{this});
+            rejectedSlot = cellHeap.back();
+            cellHeap.back() = slot;
+            std::push_heap(cellHeap.begin(), cellHeap.end(), SlotOrder{this});
+        }
+        if (rejectedSlot != npos)
+            reject(rejectedSlot);
+
+        return _selected[slot] ? slot : npos;
+    }
+
+    /// @return true if the feature of the slot is still selected
+    bool isSelected(std::size_t slot) const { return _selected[slot]; }
+
+    /// The slots of the features dropped during the octave can be reused
+    void endOctave()
+    {
+        _freeSlots.insert(_freeSlots.end(), _droppedSlots.begin(), _droppedSlots.end());
+        _droppedSlots.clear();
+    }
+
+    std::size_t nbSlots() const { return _features.size(); }
+    std::size_t nbInserted() const { return _nbInserted; }
+    const PointFeature& feature(std::size_t slot) const { return _features[slot]; }
+    float peakValue(std::size_t slot) const { return _peakValues[slot]; }
+
+    /**
+     * @return the slots of the result of the grid filtering: the best features of each cell,
+     *         then the best other ones up to maxTotalKeypoints, both sorted.
+     *         All the features sorted without the grid filtering, or if there are less than maxTotalKeypoints.
+     */
+    std::vector<std::size_t> getSelectedSlots() const
+    {
+        std::vector<std::size_t> slots = _allSlots;
+        for (const std::vector<std::size_t>& cellHeap : _cellHeaps)
+            slots.insert(slots.end(), cellHeap.begin(), cellHeap.end());
+        std::sort(slots.begin(), slots.end(), SlotOrder{this});
+
+        if (_gridFiltering)
+        {
+            std::vector<std::size_t> rejectedSlots = _rejectedHeap;
+            if (_nbInserted <= _maxTotalKeypoints)
+            {
+                slots.insert(slots.end(), rejectedSlots.begin(), rejectedSlots.end());
+                std::sort(slots.begin(), slots.end(), SlotOrder{this});
+            }
+            else
+            {
+                // If we do not have enough features (less than maxTotalKeypoints) after the grid filtering (empty regions in
+                // the grid for example). We add the best other ones, without repartition constraint.
+                const std::size_t remainingElements = std::min(rejectedSlots.size(), _maxTotalKeypoints - slots.size());
+                ALICEVISION_LOG_TRACE("Grid filtering -- Copy remaining points: " << remainingElements);
+                std::partial_sort(rejectedSlots.begin(), rejectedSlots.begin() + remainingElements, rejectedSlots.end(), SlotOrder{this});
+                slots.insert(slots.end(), rejectedSlots.begin(), rejectedSlots.begin() + remainingElements);
+            }
+        }
+        return slots;
+    }
+
+  private:
+    bool isBetter(std::size_t a, std::size_t b) const
+    {
+        return _order(_features[a].scale(), _peakValues[a], _features[b].scale(), _peakValues[b]);
+    }
+
+    /// comparator of the slots, the worst feature is on top of the heaps
+    struct SlotOrder
+    {
+        const FeatureSelection* selection;
+        bool operator()(std::size_t a, std::size_t b) const { return selection->isBetter(a, b); }
+    };
+
+    std::size_t newSlot(const PointFeature& feature, float peakValue)
+    {
+        if (_freeSlots.empty())
+        {
+            _features.push_back(feature);
+            _peakValues.push_back(peakValue);
+            _selected.push_back(true);
+            return _features.size() - 1;
+        }
+        const std::size_t slot = _freeSlots.back();
+        _freeSlots.pop_back();
+        _features[slot] = feature;
+        _peakValues[slot] = peakValue;
+        _selected[slot] = true;
+        return slot;
+    }
+
+    void reject(std::size_t slot)
+    {
+        std::size_t droppedSlot = slot;
+        if (_rejectedHeap.size() < _maxTotalKeypoints)
+        {
+            _rejectedHeap.push_back(slot);
+            std::push_heap(_rejectedHeap.begin(), _rejectedHeap.end(), SlotOrder{this});
+            return;
+        }
+        if (isBetter(slot, _rejectedHeap.front()))
+        {
+            std::pop_heap(_rejectedHeap.begin(), _rejectedHeap.end(), SlotOrder{this});
+            droppedSlot = _rejectedHeap.back();
+            _rejectedHeap.back() = slot;
+            std::push_heap(_rejectedHeap.begin(), _rejectedHeap.end(), SlotOrder{this});
+        }
+        _selected[droppedSlot] = false;
+        _droppedSlots.push_back(droppedSlot);
+    }
+
+    const KeypointOrder _order;
+    const std::size_t _gridSize;
+    const std::size_t _maxTotalKeypoints;
+    const int _w;
+    const int _h;
+    bool _gridFiltering = false;
+    std::size_t _cellCapacity = 0;
+    std::size_t _nbInserted = 0;
+
+    // per slot data
+    std::vector<PointFeature> _features;
+    std::vector<float> _peakValues;
+    std::vector<bool> _selected;
+
+    std::vector<std::size_t> _allSlots;
+    std::vector<std::vector<std::size_t>> _cellHeaps;
+    std::vector<std::size_t> _rejectedHeap;
+    std::vector<std::size_t> _droppedSlots;
+    std::vector<std::size_t> _freeSlots;
+};
+
+}  // namespace
+
 template<typename T>
 bool extractSIFT(const image::Image<float>& image,
                  std::unique_ptr<Regions>& regions,
@@ -193,13 +472,9 @@ bool extractSIFT(const image::Image<float>& image,
     SIFT_Region_T* regionsCasted = new SIFT_Region_T();
     regions.reset(regionsCasted);
 
-    // Build alias to cached data
-    // reserve some memory for faster keypoint saving
-    const std::size_t reserveSize = (params._gridSize && params._maxTotalKeypoints) ? params._maxTotalKeypoints : 2000;
-    regionsCasted->Features().reserve(reserveSize);
-    regionsCasted->Descriptors().reserve(reserveSize);
-    std::vector<float> featuresPeakValue;
-    featuresPeakValue.reserve(reserveSize);
+    // the features are selected as they are detected, the descriptors are only computed for the selected ones
+    FeatureSelection selection(params, w, h);
+    std::vector<typename SIFT_Region_T::DescriptorT> slotDescriptors;
 
     size_t maxOctaveKeypoints = params._maxTotalKeypoints;
 
@@ -223,90 +498,7 @@ bool extractSIFT(const image::Image<float>& image,
             // Only filter features if we have more features than the maxTotalKeypoints
             if (nkeys > maxOctaveKeypoints)
             {
-                // Sorting the extracted features according to their dog value (peak threshold)
-                std::vector<std::size_t> keysIndexSort(nkeys);
-                std::iota(keysIndexSort.begin(), keysIndexSort.end(), 0);
-
-                if (params._contrastFiltering == EFeatureConstrastFiltering::GridSortScaleSteps)
-                {
-                    std::sort(keysIndexSort.begin(), keysIndexSort.end(), [&](std::size_t a, std::size_t b) {
-                        const int scaleA = int(log2(keys[a].sigma) * 3.0f);  // 3 scale steps per octave
-                        const int scaleB = int(log2(keys[b].sigma) * 3.0f);
-                        if (scaleA == scaleB)
-                        {
-                            // sort by peak value, when we are in the same scale
-                            return keys[a].peak_value > keys[b].peak_value;
-                        }
-                        return scaleA > scaleB;
-                    });
-                }
-                else if (params._contrastFiltering == EFeatureConstrastFiltering::GridSortOctaveSteps)
-                {
-                    std::sort(keysIndexSort.begin(), keysIndexSort.end(), [&](std::size_t a, std::size_t b) {
-                        const int scaleA = int(log2(keys[a].sigma));  // 3 scale steps per octave
-                        const int scaleB = int(log2(keys[b].sigma));
-                        if (scaleA == scaleB)
-                        {
-                            // sort by peak value, when we are in the same scale
-                            return keys[a].peak_value > keys[b].peak_value;
-                        }
-                        return scaleA > scaleB;
-                    });
-                }
-                else if (params._contrastFiltering == EFeatureConstrastFiltering::GridSort)
-                {
-                    std::sort(keysIndexSort.begin(), keysIndexSort.end(), [&](std::size_t a, std::size_t b) {
-                        return keys[a].sigma * keys[a].peak_value > keys[b].sigma * keys[b].peak_value;
-                    });
-                }
-                else  // GridSortOctaves
-                {
-                    // sort from largest peaks to smallest ones
-                    std::sort(keysIndexSort.begin(), keysIndexSort.end(), [&](std::size_t a, std::size_t b) {
-                        return keys[a].peak_value > keys[b].peak_value;
-                    });
-                }
-
-                std::vector<IndexT> rejected_indexes;
-                filteredKeypointsIndex.reserve(maxOctaveKeypoints);
-                rejected_indexes.reserve(nkeys);
-
-                const std::size_t sizeMat = params._gridSize * params._gridSize;
-                std::vector<std::size_t> countFeatPerCell(sizeMat, 0);
-                for (int idx = 0; idx < sizeMat; ++idx)
-                {
-                    countFeatPerCell[idx] = 0;
-                }
-                const std::size_t keypointsPerCell = params._maxTotalKeypoints / sizeMat;
-                const double regionWidth = w / double(params._gridSize);
-                const double regionHeight = h / double(params._gridSize);
-
-                for (IndexT ii = 0; ii < nkeys; ++ii)
-                {
-                    const IndexT i = keysIndexSort[ii];  // use sorted keypoints
-                    const auto& keypoint = keys[i];
-
-                    const std::size_t cellX = std::min(std::size_t(keypoint.x / regionWidth), params._gridSize);
-                    const std::size_t cellY = std::min(std::size_t(keypoint.y / regionHeight), params._gridSize);
-
-                    std::size_t& count = countFeatPerCell[cellX * params._gridSize + cellY];
-                    ++count;
-
-                    if (count < keypointsPerCell)
-                        filteredKeypointsIndex.push_back(i);
-                    else
-                        rejected_indexes.push_back(i);
-                }
-                // If we don't have enough features (less than maxTotalKeypoints) after the grid filtering (empty
-                // regions in the grid for example). We add the best other ones, without repartition constraint.
-                if (filteredKeypointsIndex.size() < params._maxTotalKeypoints && !rejected_indexes.empty())
-                {
-                    const std::size_t remainingElements =
-                      std::min(rejected_indexes.size(), params._maxTotalKeypoints - filteredKeypointsIndex.size());
-                    ALICEVISION_LOG_TRACE("Octave Grid filtering -- Copy remaining points: " << remainingElements);
-                    filteredKeypointsIndex.insert(
-                      filteredKeypointsIndex.end(), rejected_indexes.begin(), rejected_indexes.begin() + remainingElements);
-                }
+                filteredKeypointsIndex = gridFilterOctaveKeypoints(keys, nkeys, params, w, h);
 
                 ALICEVISION_LOG_TRACE("Octave SIFT keypoints:\n"
                                       << " * detected: " << nkeys << "\n"
@@ -369,101 +561,79 @@ bool extractSIFT(const image::Image<float>& image,
             filteredKeypointsIndex.swap(newFilteredKeypointsIndex);
         }
 
-        std::vector<std::vector<double>> anglesPerKeypoint(filteredKeypointsIndex.size());
+        // compute from 1 to 4 orientations per keypoint
+        std::vector<std::array<double, 4>> anglesPerKeypoint(filteredKeypointsIndex.size(), {0.0, 0.0, 0.0, 0.0});
+        std::vector<int> nbAnglesPerKeypoint(filteredKeypointsIndex.size(), 1);  // by default (1 upright feature)
 
+        if (orientation)
+        {
 #pragma omp parallel for
+            for (int ii = 0; ii < filteredKeypointsIndex.size(); ++ii)
+            {
+                const int i = filteredKeypointsIndex[ii];
+                nbAnglesPerKeypoint[ii] = vl_sift_calc_keypoint_orientations(filt, anglesPerKeypoint[ii].data(), keys + i);
+            }
+        }
+
+        // select the features of the octave, a feature selected may be evicted by a better one of the same octave
+        struct OctaveFeature
+        {
+            int keypointIndex;
+            double angle;
+            std::size_t slot;
+        };
+        std::vector<OctaveFeature> octaveFeatures;
         for (int ii = 0; ii < filteredKeypointsIndex.size(); ++ii)
         {
             const int i = filteredKeypointsIndex[ii];
-
-            double angles[4] = {0.0, 0.0, 0.0, 0.0};
-            int nangles = 1;  // by default (1 upright feature)
-            if (orientation)
-            {  // compute from 1 to 4 orientations
-                nangles = vl_sift_calc_keypoint_orientations(filt, angles, keys + i);
-            }
-
-            Descriptor<vl_sift_pix, 128> vlFeatDescriptor;
-            Descriptor<T, 128> descriptor;
-
-            for (int q = 0; q < nangles; ++q)
+            for (int q = 0; q < nbAnglesPerKeypoint[ii]; ++q)
             {
-                const PointFeature fp(keys[i].x, keys[i].y, keys[i].sigma, static_cast<float>(angles[q]));
+                const double angle = anglesPerKeypoint[ii][q];
+                const std::size_t slot = selection.insert(PointFeature(keys[i].x, keys[i].y, keys[i].sigma, static_cast<float>(angle)), keys[i].peak_value);
+                if (slot != FeatureSelection::npos)
+                    octaveFeatures.push_back({i, angle, slot});
+            }
+        }
+        slotDescriptors.resize(selection.nbSlots());
 
-                vl_sift_calc_keypoint_descriptor(filt, &vlFeatDescriptor[0], keys + i, angles[q]);
-                convertSIFT<T>(&vlFeatDescriptor[0], descriptor, params._rootSift);
+#pragma omp parallel for
+        for (int f = 0; f < octaveFeatures.size(); ++f)
+        {
+            const OctaveFeature& octaveFeature = octaveFeatures[f];
+            if (!selection.isSelected(octaveFeature.slot))
+                continue;
 
-#pragma omp critical
-                {
-                    regionsCasted->Descriptors().push_back(descriptor);
-                    regionsCasted->Features().push_back(fp);
-                    featuresPeakValue.push_back(keys[i].peak_value);
-                }
-            }
+            Descriptor<vl_sift_pix, 128> vlFeatDescriptor;
+            vl_sift_calc_keypoint_descriptor(filt, &vlFeatDescriptor[0], keys + octaveFeature.keypointIndex, octaveFeature.angle);
+            convertSIFT<T>(&vlFeatDescriptor[0], slotDescriptors[octaveFeature.slot], params._rootSift);
         }
+        selection.endOctave();
 
         if (vl_sift_process_next_octave(filt))
             break;  // Last octave
     }
     vl_sift_delete(filt);
 
-    assert(regionsCasted->Features().size() == regionsCasted->Descriptors().size());
-
-    // Sorting the extracted features according to their scale
+    // Sorting the selected features according to their scale
+    std::vector<float> featuresPeakValue;
     {
-        const auto& features = regionsCasted->Features();
-        const auto& descriptors = regionsCasted->Descriptors();
+        const std::vector<std::size_t> selectedSlots = selection.getSelectedSlots();
 
-        std::vector<std::size_t> indexSort(features.size());
-        std::iota(indexSort.begin(), indexSort.end(), 0);
-        if (params._contrastFiltering == EFeatureConstrastFiltering::GridSortScaleSteps)
-        {
-            std::sort(indexSort.begin(), indexSort.end(), [&](std::size_t a, std::size_t b) {
-                const int scaleA = int(log2(features[a].scale()) * 3.0f);  // 3 scale steps per octave
-                const int scaleB = int(log2(features[b].scale()) * 3.0f);
-                if (scaleA == scaleB)
-                {
-                    return featuresPeakValue[a] > featuresPeakValue[b];
-                }
-                return scaleA > scaleB;
-            });
-        }
-        else if (params._contrastFiltering == EFeatureConstrastFiltering::GridSortOctaveSteps)
-        {
-            std::sort(indexSort.begin(), indexSort.end(), [&](std::size_t a, std::size_t b) {
-                const int scaleA = int(log2(features[a].scale()));  // 1 scale steps per octave
-                const int scaleB = int(log2(features[b].scale()));
-                if (scaleA == scaleB)
-                {
-                    return featuresPeakValue[a] > featuresPeakValue[b];
-                }
-                return scaleA > scaleB;
-            });
-        }
-        else if (params._contrastFiltering == EFeatureConstrastFiltering::GridSort)
-        {
-            std::sort(indexSort.begin(), indexSort.end(), [&](std::size_t a, std::size_t b) {
-                return features[a].scale() * featuresPeakValue[a] > features[b].scale() * featuresPeakValue[b];
-            });
-        }
-        else
+        auto& features = regionsCasted->Features();
+        features.reserve(selectedSlots.size());
+        regionsCasted->Descriptors().reserve(selectedSlots.size());
+        featuresPeakValue.reserve(selectedSlots.size());
+        for (const std::size_t slot : selectedSlots)
         {
-            // sort from largest scales to smallest ones
-            std::sort(indexSort.begin(), indexSort.end(), [&](std::size_t a, std::size_t b) { return features[a].scale() > features[b].scale(); });
+            features.push_back(selection.feature(slot));
+            regionsCasted->Descriptors().push_back(slotDescriptors[slot]);
+            featuresPeakValue.push_back(selection.peakValue(slot));
         }
 
-        std::vector<PointFeature> sortedFeatures(features.size());
-        std::vector<typename SIFT_Region_T::DescriptorT> sortedDescriptors(features.size());
-        std::vector<float> sortedFeaturesPeakValue(features.size());
-        for (std::size_t i : indexSort)
+        if (features.size() < selection.nbInserted())
         {
-            sortedFeatures[i] = features[indexSort[i]];
-            sortedDescriptors[i] = descriptors[indexSort[i]];
-            sortedFeaturesPeakValue[i] = featuresPeakValue[indexSort[i]];
+            ALICEVISION_LOG_TRACE("SIFT Features: before: " << selection.nbInserted() << ", after grid filtering: " << features.size());
         }
-        regionsCasted->Features().swap(sortedFeatures);
-        regionsCasted->Descriptors().swap(sortedDescriptors);
-        featuresPeakValue.swap(sortedFeaturesPeakValue);
     }
 
     if (params._maxTotalKeypoints && params._contrastFiltering == EFeatureConstrastFiltering::NonExtremaFiltering)
@@ -511,63 +681,6 @@ bool extractSIFT(const image::Image<float>& image,
             regionsCasted->Descriptors().swap(filteredDescriptors);
         }
     }
-    // Grid filtering of the keypoints to ensure a global repartition
-    else if (params._gridSize && params._maxTotalKeypoints)
-    {
-        const auto& features = regionsCasted->Features();
-        const auto& descriptors = regionsCasted->Descriptors();
-        // Only filter features if we have more features than the maxTotalKeypoints
-        if (features.size() > params._maxTotalKeypoints)
-        {
-            std::vector<IndexT> filteredIndexes;
-            std::vector<IndexT> rejectedIndexes;
-            filteredIndexes.reserve(std::min(features.size(), params._maxTotalKeypoints));
-            rejectedIndexes.reserve(features.size());
-
-            const std::size_t sizeMat = params._gridSize * params._gridSize;
-            std::vector<std::size_t> countFeatPerCell(sizeMat, 0);
-            const std::size_t keypointsPerCell = params._maxTotalKeypoints / sizeMat;
-            const double regionWidth = w / double(params._gridSize);
-            const double regionHeight = h / double(params._gridSize);
-
-            for (IndexT i = 0; i < features.size(); ++i)
-            {
-                const auto& keypoint = features.at(i);
-
-                const std::size_t cellX = std::min(std::size_t(keypoint.x() / regionWidth), params._gridSize);
-                const std::size_t cellY = std::min(std::size_t(keypoint.y() / regionHeight), params._gridSize);
-
-                std::size_t& count = countFeatPerCell[cellX * params._gridSize + cellY];
-                ++count;
-
-                if (count < keypointsPerCell)
-                    filteredIndexes.push_back(i);
-                else
-                    rejectedIndexes.push_back(i);
-            }
-            // If we do not have enough features (less than maxTotalKeypoints) after the grid filtering (empty regions in
-            // the grid for example). We add the best other ones, without repartition constraint.
-            if (filteredIndexes.size() < params._maxTotalKeypoints)
-            {
-                const std::size_t remainingElements = std::min(rejectedIndexes.size(), params._maxTotalKeypoints - filteredIndexes.size());
-                ALICEVISION_LOG_TRACE("Grid filtering -- Copy remaining points: " << remainingElements);
-                filteredIndexes.insert(filteredIndexes.end(), rejectedIndexes.begin(), rejectedIndexes.begin() + remainingElements);
-            }
-
-            std::vector<PointFeature> filteredFeatures(filteredIndexes.size());
-            std::vector<typename SIFT_Region_T::DescriptorT> filteredDescriptors(filteredIndexes.size());
-            for (IndexT i = 0; i < filteredIndexes.size(); ++i)
-            {
-                filteredFeatures[i] = features[filteredIndexes[i]];
-                filteredDescriptors[i] = descriptors[filteredIndexes[i]];
-            }
-
-            ALICEVISION_LOG_TRACE("SIFT Features: before: " << features.size() << ", after grid filtering: " << filteredFeatures.size());
-
-            regionsCasted->Features().swap(filteredFeatures);
-            regionsCasted->Descriptors().swap(filteredDescriptors);
-        }
-    }
     ALICEVISION_LOG_TRACE("SIFT Features: " << regionsCasted->Features().size() << " (max: " << params._maxTotalKeypoints << ").");
     assert(regionsCasted->Features().size() == regionsCasted->Descriptors().size());
 
@@ -0,0 +1,115 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2023 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "SiftPatchDescriptor.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace aliceVision {
+namespace feature {
+
+namespace {
+
+void normalizeHistogram(float* descriptor, int size)
+{
+    float norm = 0.0f;
+    for (int i = 0; i < size; ++i)
+        norm += descriptor[i] * descriptor[i];
+    const float invNorm = 1.0f / (std::sqrt(norm) + std::numeric_limits<float>::epsilon());
+    for (int i = 0; i < size; ++i)
+        descriptor[i] *= invNorm;
+}
+
+}  // namespace
+
+SiftPatchDescriptor::SiftPatchDescriptor(int patchResolution, double sigma, double magnif, double windowSize)
+  : _patchSide(2 * patchResolution + 1)
+{
+    const double binSize = magnif * sigma + std::numeric_limits<double>::epsilon();
+    const int radius = std::min(patchResolution, static_cast<int>(std::floor(std::sqrt(2.0) * binSize * (nbSpatialBins + 1) / 2.0 + 0.5)));
+    const int halfBins = nbSpatialBins / 2;
+
+    for (int dy = -radius; dy <= radius; ++dy)
+    {
+        for (int dx = -radius; dx <= radius; ++dx)
+        {
+            const double nx = dx / binSize;
+            const double ny = dy / binSize;
+            const double win = std::exp(-(nx * nx + ny * ny) / (2.0 * windowSize * windowSize));
+
+            // bilinear distribution in the 4 neighbor spatial bins, starting from the "lower-left" one
+            const int binx = static_cast<int>(std::floor(nx - 0.5));
+            const int biny = static_cast<int>(std::floor(ny - 0.5));
+            const double rbinx = nx - (binx + 0.5);
+            const double rbiny = ny - (biny + 0.5);
+
+            const int pixel = (patchResolution + dy) * _patchSide + (patchResolution + dx);
+
+            for (int dbiny = 0; dbiny < 2; ++dbiny)
+            {
+                for (int dbinx = 0; dbinx < 2; ++dbinx)
+                {
+                    const int bx = binx + dbinx;
+                    const int by = biny + dbiny;
+                    if (bx < -halfBins || bx >= halfBins || by < -halfBins || by >= halfBins)
+                        continue;
+
+                    const double weight = win * std::abs(1 - dbinx - rbinx) * std::abs(1 - dbiny - rbiny);
+                    if (weight <= 0.0)
+                        continue;
+
+                    const int binOffset = ((by + halfBins) * nbSpatialBins + (bx + halfBins)) * nbOrientationBins;
+                    _contributions.push_back({pixel, binOffset, static_cast<float>(weight)});
+                }
+            }
+        }
+    }
+}
+
+void SiftPatchDescriptor::computeDescriptor(const float* gradient, float* out_descriptor, Buffer& buffer) const
+{
+    const int nbPixels = _patchSide * _patchSide;
+    buffer.orientationBins.resize(nbPixels);
+    buffer.lowerModulus.resize(nbPixels);
+    buffer.upperModulus.resize(nbPixels);
+    int* orientationBins = buffer.orientationBins.data();
+    float* lowerModulus = buffer.lowerModulus.data();
+    float* upperModulus = buffer.upperModulus.data();
+
+    // orientation binning of all the pixels, branch-free so the compiler can vectorize it
+    const float orientationScale = static_cast<float>(nbOrientationBins / (2.0 * M_PI));
+    for (int i = 0; i < nbPixels; ++i)
+    {
+        const float modulus = gradient[2 * i];
+        const float nt = gradient[2 * i + 1] * orientationScale;
+        const float bint = std::floor(nt);
+        const float rbint = nt - bint;
+        orientationBins[i] = static_cast<int>(bint);
+        lowerModulus[i] = modulus * (1.0f - rbint);
+        upperModulus[i] = modulus * rbint;
+    }
+
+    std::fill(out_descriptor, out_descriptor + descriptorSize, 0.0f);
+
+    for (const SpatialContribution& c : _contributions)
+    {
+        const int bint = orientationBins[c.pixel];
+        float* bin = out_descriptor + c.binOffset;
+        bin[bint % nbOrientationBins] += c.weight * lowerModulus[c.pixel];
+        bin[(bint + 1) % nbOrientationBins] += c.weight * upperModulus[c.pixel];
+    }
+
+    // standard SIFT descriptors are normalized, truncated and normalized again
+    normalizeHistogram(out_descriptor, descriptorSize);
+    for (int i = 0; i < descriptorSize; ++i)
+        out_descriptor[i] = std::min(out_descriptor[i], 0.2f);
+    normalizeHistogram(out_descriptor, descriptorSize);
+}
+
+}  // namespace feature
+}  // namespace aliceVision
@@ -0,0 +1,70 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2023 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <vector>
+
+namespace aliceVision {
+namespace feature {
+
+/**
+ * @brief SIFT descriptor of normalized square patches, centered on the keypoint and already oriented.
+ *
+ * Equivalent to vl_sift_calc_raw_descriptor on a patch of side (2 * patchResolution + 1) with angle0 = 0.
+ * As the geometry of the patch is the same for all keypoints and all DSP scales,
+ * the spatial bins and Gaussian weights of each pixel are computed once in the constructor.
+ * Only the orientation binning and the accumulation remain per patch.
+ */
+class SiftPatchDescriptor
+{
+  public:
+    /// number of spatial bins per side and of orientation bins
+    static constexpr int nbSpatialBins = 4;
+    static constexpr int nbOrientationBins = 8;
+    static constexpr int descriptorSize = nbSpatialBins * nbSpatialBins * nbOrientationBins;
+
+    /**
+     * @param[in] patchResolution the patch half side, the keypoint is at (patchResolution, patchResolution)
+     * @param[in] sigma the keypoint scale in patch pixels
+     * @param[in] magnif the descriptor magnification factor (vlfeat default)
+     * @param[in] windowSize the Gaussian window standard deviation in spatial bins (vlfeat default)
+     */
+    SiftPatchDescriptor(int patchResolution, double sigma, double magnif = 3.0, double windowSize = nbSpatialBins / 2);
+
+    /// per thread buffers of the orientation binning
+    struct Buffer
+    {
+        std::vector<int> orientationBins;
+        std::vector<float> lowerModulus;
+        std::vector<float> upperModulus;
+    };
+
+    int getPatchSide() const { return _patchSide; }
+
+    /**
+     * @brief Compute the normalized descriptor of a patch.
+     * @param[in] gradient the polar gradient of the patch, interleaved (modulus, angle in [0, 2pi]) as vl_imgradient_polar_f
+     * @param[out] out_descriptor the descriptor of descriptorSize values, L2 normalized and truncated at 0.2
+     * @param[in,out] buffer the buffers reused between calls, not shared between threads
+     */
+    void computeDescriptor(const float* gradient, float* out_descriptor, Buffer& buffer) const;
+
+  private:
+    /// contribution of a patch pixel to a spatial bin
+    struct SpatialContribution
+    {
+        int pixel;
+        int binOffset;
+        float weight;
+    };
+
+    int _patchSide;
+    std::vector<SpatialContribution> _contributions;
+};
+
+}  // namespace feature
+}  // namespace aliceVision
@@ -0,0 +1,134 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2023 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <aliceVision/feature/sift/SIFT.hpp>
+#include <aliceVision/feature/sift/SiftPatchDescriptor.hpp>
+#include <aliceVision/system/Logger.hpp>
+#include <aliceVision/system/Timer.hpp>
+
+extern "C"
+{
+#include <nonFree/sift/vl/imopv.h>
+#include <nonFree/sift/vl/sift.h>
+}
+
+#include <cmath>
+#include <memory>
+#include <random>
+#include <vector>
+
+#define BOOST_TEST_MODULE siftPatchDescriptor
+
+#include <boost/test/unit_test.hpp>
+
+using namespace aliceVision;
+using namespace aliceVision::feature;
+
+namespace {
+
+// same patch geometry as the DSP-SIFT extraction
+const int kPatchResolution = 15;
+const int kPatchSide = 2 * kPatchResolution + 1;
+const double kPatchRelativeExtent = 7.5;
+const double kPatchStep = kPatchRelativeExtent / kPatchResolution;
+const double kSigma = kPatchRelativeExtent / (3.0 * (4 + 1) / 2) / kPatchStep;
+
+/// polar gradients of random smooth patches, interleaved (modulus, angle)
+std::vector<std::vector<float>> createGradientPatches(int nbPatches)
+{
+    std::mt19937 generator(42);
+    std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+
+    std::vector<std::vector<float>> gradients(nbPatches);
+    std::vector<float> patch(kPatchSide * kPatchSide);
+    for (auto& gradient : gradients)
+    {
+        // sum of random waves, so all orientations are represented
+        const float a = distribution(generator), b = distribution(generator), c = distribution(generator), d = distribution(generator);
+        for (int y = 0; y < kPatchSide; ++y)
+            for (int x = 0; x < kPatchSide; ++x)
+                patch[y * kPatchSide + x] = std::sin(a * x + b * y) + 0.5f * std::cos(c * x - d * y) + 0.05f * distribution(generator);
+
+        gradient.resize(2 * kPatchSide * kPatchSide);
+        vl_imgradient_polar_f(gradient.data(), gradient.data() + 1, 2, 2 * kPatchSide, patch.data(), kPatchSide, kPatchSide, kPatchSide);
+    }
+    return gradients;
+}
+
+/// vlfeat global state for the test cases using vl_sift
+struct VLFeatFixture
+{
+    VLFeatFixture() { VLFeatInstance::initialize(); }
+    ~VLFeatFixture() { VLFeatInstance::destroy(); }
+};
+
+}  // namespace
+
+BOOST_FIXTURE_TEST_CASE(siftPatchDescriptor_vlfeatEquivalence, VLFeatFixture)
+{
+    const std::vector<std::vector<float>> gradients = createGradientPatches(100);
+
+    std::unique_ptr<VlSiftFilt, void (*)(VlSiftFilt*)> sift(vl_sift_new(16, 16, 1, 3, 0), &vl_sift_delete);
+    const SiftPatchDescriptor patchDescriptor(kPatchResolution, kSigma);
+    SiftPatchDescriptor::Buffer buffer;
+
+    std::vector<float> expected(SiftPatchDescriptor::descriptorSize);
+    std::vector<float> descriptor(SiftPatchDescriptor::descriptorSize);
+
+    for (const auto& gradient : gradients)
+    {
+        vl_sift_calc_raw_descriptor(
+          sift.get(), gradient.data(), expected.data(), kPatchSide, kPatchSide, kPatchResolution, kPatchResolution, kSigma, /*angle0=*/0);
+        patchDescriptor.computeDescriptor(gradient.data(), descriptor.data(), buffer);
+
+        // vlfeat uses fast approximations of exp and sqrt
+        for (int i = 0; i < SiftPatchDescriptor::descriptorSize; ++i)
+            BOOST_CHECK_SMALL(descriptor[i] - expected[i], 2e-3f);
+    }
+}
+
+BOOST_FIXTURE_TEST_CASE(siftPatchDescriptor_benchmark, VLFeatFixture)
+{
+    // a DSP-SIFT extraction at NORMAL quality computes 6 patch descriptors per keypoint
+    const std::vector<std::vector<float>> gradients = createGradientPatches(1000);
+    const int nbIterations = 20;
+
+    std::unique_ptr<VlSiftFilt, void (*)(VlSiftFilt*)> sift(vl_sift_new(16, 16, 1, 3, 0), &vl_sift_delete);
+    const SiftPatchDescriptor patchDescriptor(kPatchResolution, kSigma);
+    SiftPatchDescriptor::Buffer buffer;
+
+    std::vector<float> descriptor(SiftPatchDescriptor::descriptorSize);
+    float checksumVLFeat = 0.0f;
+    float checksum = 0.0f;
+
+    system::Timer timer;
+    for (int it = 0; it < nbIterations; ++it)
+    {
+        for (const auto& gradient : gradients)
+        {
+            vl_sift_calc_raw_descriptor(
+              sift.get(), gradient.data(), descriptor.data(), kPatchSide, kPatchSide, kPatchResolution, kPatchResolution, kSigma, /*angle0=*/0);
+            checksumVLFeat += descriptor[0];
+        }
+    }
+    const double vlfeatMs = timer.elapsedMs();
+
+    timer.reset();
+    for (int it = 0; it < nbIterations; ++it)
+    {
+        for (const auto& gradient : gradients)
+        {
+            patchDescriptor.computeDescriptor(gradient.data(), descriptor.data(), buffer);
+            checksum += descriptor[0];
+        }
+    }
+    const double patchDescriptorMs = timer.elapsedMs();
+
+    ALICEVISION_LOG_INFO("SIFT patch descriptor benchmark: " << nbIterations * gradients.size() << " patches, vlfeat: " << vlfeatMs
+                                                             << " ms, SiftPatchDescriptor: " << patchDescriptorMs << " ms.");
+
+    BOOST_CHECK_CLOSE(checksum, checksumVLFeat, 1.0);
+}
@@ -6,10 +6,22 @@
 
 #include "FeatureExtractor.hpp"
 #include <aliceVision/image/io.hpp>
+#include <aliceVision/system/MemoryBudget.hpp>
 #include <aliceVision/system/MemoryInfo.hpp>
-#include <aliceVision/alicevision_omp.hpp>
+#include <aliceVision/system/Profiler.hpp>
+#include <aliceVision/system/TaskScheduler.hpp>
 #include <boost/filesystem.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <future>
 #include <iomanip>
+#include <map>
+#include <mutex>
+#include <set>
+#include <thread>
 
 namespace fs = boost::filesystem;
 
@@ -18,7 +30,7 @@ namespace featureEngine {
 
 FeatureExtractorViewJob::FeatureExtractorViewJob(const sfmData::View& view, const std::string& outputFolder)
   : _view(view),
-    _outputBasename(fs::path(fs::path(outputFolder) / fs::path(std::to_string(view.getViewId()))).string())
+    _outputBasename(outputFolder.empty() ? std::string() : (fs::path(outputFolder) / fs::path(std::to_string(view.getViewId()))).string())
 {}
 
 FeatureExtractorViewJob::~FeatureExtractorViewJob() = default;
@@ -30,12 +42,13 @@ void FeatureExtractorViewJob::setImageDescribers(const std::vector<std::shared_p
         const std::shared_ptr<feature::ImageDescriber>& imageDescriber = imageDescribers.at(i);
         feature::EImageDescriberType imageDescriberType = imageDescriber->getDescriberType();
 
-        if (fs::exists(getFeaturesPath(imageDescriberType)) && fs::exists(getDescriptorPath(imageDescriberType)))
+        if (hasOutputFiles() && fs::exists(getFeaturesPath(imageDescriberType)) && fs::exists(getDescriptorPath(imageDescriberType)))
         {
             continue;
         }
 
         _memoryConsuption += imageDescriber->getMemoryConsumption(_view.getImage().getWidth(), _view.getImage().getHeight());
+        _useUCharImage = _useUCharImage || !imageDescriber->useFloatImage();
 
         if (imageDescriber->useCuda())
             _gpuImageDescriberIndexes.push_back(i);
@@ -44,6 +57,165 @@ void FeatureExtractorViewJob::setImageDescribers(const std::vector<std::shared_p
     }
 }
 
+namespace {
+
+/// maximum number of decoded images waiting for the GPU image describers
+const std::size_t maxPrefetchedImages = 4;
+
+/**
+ * @brief Fixed capacity FIFO shared by the pipeline stages.
+ * @note push blocks while the queue is full and pop blocks while it is empty,
+ *       pop returns false once the queue is closed and empty.
+ */
+template<typename T>
+class BoundedQueue
+{
+  public:
+    explicit BoundedQueue(std::size_t capacity)
+      : _capacity(std::max(std::size_t(1), capacity))
+    {}
+
+    void push(T&& value)
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _notFull.wait(lock, [&] { return _queue.size() < _capacity || _closed; });
+        if (_closed)
+            return;
+        _queue.push_back(std::move(value));
+        _notEmpty.notify_one();
+    }
+
+    bool pop(T& out_value)
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _notEmpty.wait(lock, [&] { return !_queue.empty() || _closed; });
+        if (_queue.empty())
+            return false;
+        out_value = std::move(_queue.front());
+        _queue.pop_front();
+        _notFull.notify_one();
+        return true;
+    }
+
+    /// no more values will be pushed, wake up all waiting threads
+    void close()
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _closed = true;
+        _notEmpty.notify_all();
+        _notFull.notify_all();
+    }
+
+  private:
+    const std::size_t _capacity;
+    std::deque<T> _queue;
+    bool _closed = false;
+    std::mutex _mutex;
+    std::condition_variable _notEmpty;
+    std::condition_variable _notFull;
+};
+
+/// extracted regions of a view job waiting to be written
+struct ViewJobResult
+{
+    const FeatureExtractorViewJob* job = nullptr;
+    bool useGPU = false;
+    std::vector<std::unique_ptr<feature::Regions>> regions;
+};
+
+/**
+ * @brief Decoded views shared by the GPU and the CPU stages.
+ * @note A view extracted by both stages is decoded by the first one and kept until the other one takes it.
+ *       At most capacity views wait for their second stage, the oldest ones are dropped and decoded again.
+ */
+class ViewDataCache
+{
+  public:
+    using Data = std::shared_ptr<const FeatureExtractorViewData>;
+
+    explicit ViewDataCache(std::size_t capacity)
+      : _capacity(capacity)
+    {}
+
+    /**
+     * @brief Get the decoded data of a view, decoded by the given function if it is not cached.
+     * @param[in] viewId the view id
+     * @param[in] nbStages the number of stages extracting the view
+     * @param[in] load the function decoding the view
+     */
+    template<typename LoadFunction>
+    Data get(IndexT viewId, int nbStages, LoadFunction&& load)
+    {
+        std::promise<Data> promise;
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            if (nbStages < 2 || _capacity == 0 || _dropped.erase(viewId) > 0)
+            {
+                lock.unlock();
+                return decode(load);
+            }
+
+            const auto it = _entries.find(viewId);
+            if (it != _entries.end())
+            {
+                // the other stage has decoded (or is decoding) this view, it is not needed anymore in the cache
+                std::shared_future<Data> future = it->second;
+                _entries.erase(it);
+                _order.erase(std::find(_order.begin(), _order.end(), viewId));
+                lock.unlock();
+                return future.get();
+            }
+
+            _entries.emplace(viewId, promise.get_future().share());
+            _order.push_back(viewId);
+            if (_order.size() > _capacity)
+            {
+                _entries.erase(_order.front());
+                _dropped.insert(_order.front());
+                _order.pop_front();
+            }
+        }
+
+        try
+        {
+            Data data = decode(load);
+            promise.set_value(data);
+            return data;
+        }
+        catch (...)
+        {
+            promise.set_exception(std::current_exception());
+            throw;
+        }
+    }
+
+  private:
+    template<typename LoadFunction>
+    static Data decode(LoadFunction& load)
+    {
+        auto data = std::make_shared<FeatureExtractorViewData>();
+        load(*data);
+        return data;
+    }
+
+    const std::size_t _capacity;
+    std::map<IndexT, std::shared_future<Data>> _entries;
+    /// cached views in insertion order
+    std::deque<IndexT> _order;
+    /// views dropped from the cache before their second stage
+    std::set<IndexT> _dropped;
+    std::mutex _mutex;
+};
+
+/// memory used by the decoded images of a view
+std::size_t getViewDataMemory(const sfmData::View& view)
+{
+    const std::size_t nbPixels = view.getImage().getWidth() * view.getImage().getHeight();
+    return nbPixels * (sizeof(float) + 2 * sizeof(unsigned char));
+}
+
+}  // namespace
+
 FeatureExtractor::FeatureExtractor(const sfmData::SfMData& sfmData)
   : _sfmData(sfmData)
 {}
@@ -52,7 +224,6 @@ FeatureExtractor::~FeatureExtractor() = default;
 
 void FeatureExtractor::process(const HardwareContext& hContext, const image::EImageColorSpace workingColorSpace)
 {
-    size_t maxAvailableMemory = hContext.getUserMaxMemoryAvailable();
     unsigned int maxAvailableCores = hContext.getMaxThreads();
 
     // iteration on each view in the range in order
@@ -68,14 +239,47 @@ void FeatureExtractor::process(const HardwareContext& hContext, const image::EIm
     }
 
     std::size_t jobMaxMemoryConsuption = 0;
+    std::size_t gpuViewDataMaxMemory = 0;
 
     std::vector<FeatureExtractorViewJob> cpuJobs;
     std::vector<FeatureExtractorViewJob> gpuJobs;
+    std::size_t nbSharedJobs = 0;
 
+    std::vector<const sfmData::View*> views;
     for (auto it = itViewBegin; it != itViewEnd; ++it)
+        views.push_back(it->second.get());
+
+    // restore the features of the unchanged views from the results cache, their view jobs skip them
+    std::vector<std::string> viewsCacheKey(views.size());
+    if (_resultsCache.isEnabled() && !_outputFolder.empty())
     {
-        const sfmData::View& view = *(it->second.get());
+        std::atomic<int> nbRestored{0};
+        system::parallelFor(0, static_cast<int>(views.size()), [&](int i) {
+            viewsCacheKey[i] = getViewCacheKey(*views[i]);
+            if (viewsCacheKey[i].empty())
+                return;
+
+            const FeatureExtractorViewJob viewJob(*views[i], _outputFolder);
+            for (const auto& imageDescriber : _imageDescribers)
+            {
+                const feature::EImageDescriberType imageDescriberType = imageDescriber->getDescriberType();
+                const std::string featuresPath = viewJob.getFeaturesPath(imageDescriberType);
+                const std::string descriptorPath = viewJob.getDescriptorPath(imageDescriberType);
+                if (fs::exists(featuresPath) && fs::exists(descriptorPath))
+                    continue;
+                if (_resultsCache.restore(viewsCacheKey[i] + "." + feature::EImageDescriberType_enumToString(imageDescriberType),
+                                          {featuresPath, descriptorPath}))
+                    ++nbRestored;
+            }
+        });
+        ALICEVISION_LOG_INFO(nbRestored.load() << " view features restored from the results cache.");
+    }
+
+    for (std::size_t i = 0; i < views.size(); ++i)
+    {
+        const sfmData::View& view = *views[i];
         FeatureExtractorViewJob viewJob(view, _outputFolder);
+        viewJob.setCacheKey(viewsCacheKey[i]);
 
         viewJob.setImageDescribers(_imageDescribers);
         jobMaxMemoryConsuption = std::max(jobMaxMemoryConsuption, viewJob.memoryConsuption());
@@ -84,17 +288,55 @@ void FeatureExtractor::process(const HardwareContext& hContext, const image::EIm
             cpuJobs.push_back(viewJob);
 
         if (viewJob.useGPU())
+        {
             gpuJobs.push_back(viewJob);
+            gpuViewDataMaxMemory = std::max(gpuViewDataMaxMemory, getViewDataMemory(view));
+        }
+
+        if (viewJob.useCPU() && viewJob.useGPU())
+            ++nbSharedJobs;
     }
 
-    if (!cpuJobs.empty())
+    if (cpuJobs.empty() && gpuJobs.empty())
+        return;
+
+    system::MemoryInfo memoryInformation = system::getMemoryInfo();
+
+    // Put an upper bound with user specified memory and the memory reserved by the other stages
+    size_t maxMemory = std::min(hContext.getMaxMemory(), system::MemoryBudget::get().getAvailableBytes());
+    size_t maxTotalMemory = std::min(memoryInformation.totalRam, hContext.getUserMaxMemoryAvailable());
+
+    // The GPU stage keeps the prefetched images and the batch being extracted in memory,
+    // it runs at the same time as the CPU stage so its memory is not available for the CPU jobs.
+    std::size_t nbPrefetchedImages = 0;
+    std::size_t gpuBatchSize = 1;
+    std::size_t nbSharedImages = 0;
+    if (!gpuJobs.empty())
     {
-        system::MemoryInfo memoryInformation = system::getMemoryInfo();
+        gpuBatchSize = std::min(static_cast<std::size_t>(_gpuBatchSize), gpuJobs.size());
+        nbPrefetchedImages = std::min(std::max(maxPrefetchedImages, gpuBatchSize), gpuJobs.size());
+        if (gpuViewDataMaxMemory > 0)
+            nbPrefetchedImages = std::min(nbPrefetchedImages, std::size_t((0.1 * maxMemory) / gpuViewDataMaxMemory));
+        nbPrefetchedImages = std::max(std::size_t(1), nbPrefetchedImages);
+        // a batch is never larger than the decoded images queue
+        gpuBatchSize = std::min(gpuBatchSize, nbPrefetchedImages);
+
+        // the views extracted by both stages are kept decoded until the other stage takes them
+        nbSharedImages = std::min(nbPrefetchedImages, nbSharedJobs);
+
+        const std::size_t gpuStageMemory = (nbPrefetchedImages + gpuBatchSize + nbSharedImages) * gpuViewDataMaxMemory;
+        maxMemory = (maxMemory > gpuStageMemory) ? maxMemory - gpuStageMemory : 0;
+
+        ALICEVISION_LOG_INFO("# images prefetched for GPU extraction: " << nbPrefetchedImages);
+        ALICEVISION_LOG_INFO("# images per GPU extraction batch: " << gpuBatchSize);
+        if (nbSharedImages > 0)
+            ALICEVISION_LOG_INFO("# decoded images shared between the GPU and the CPU extraction: " << nbSharedImages);
+    }
 
-        // Put an upper bound with user specified memory
-        size_t maxMemory = std::min(memoryInformation.availableRam, maxAvailableMemory);
-        size_t maxTotalMemory = std::min(memoryInformation.totalRam, maxAvailableMemory);
+    std::size_t nbThreads = 0;
 
+    if (!cpuJobs.empty())
+    {
         ALICEVISION_LOG_INFO("Job max memory consumption for one image: " << jobMaxMemoryConsuption / (1024 * 1024) << " MB");
         ALICEVISION_LOG_INFO("Memory information: " << std::endl << memoryInformation);
 
@@ -105,7 +347,7 @@ void FeatureExtractor::process(const HardwareContext& hContext, const image::EIm
         // This is used to estimate how many jobs can be computed in parallel without SWAP.
         const std::size_t memoryImageCapacity = std::size_t((0.9 * maxMemory) / jobMaxMemoryConsuption);
 
-        std::size_t nbThreads = std::max(std::size_t(1), memoryImageCapacity);
+        nbThreads = std::max(std::size_t(1), memoryImageCapacity);
         ALICEVISION_LOG_INFO("Max number of threads regarding memory usage: " << nbThreads);
         const double oneGB = 1024.0 * 1024.0 * 1024.0;
         if (jobMaxMemoryConsuption > maxMemory)
@@ -138,36 +380,175 @@ void FeatureExtractor::process(const HardwareContext& hContext, const image::EIm
             nbThreads = 1;
         }
 
-        // nbThreads should not be higher than the available cores
-        nbThreads = std::min(static_cast<std::size_t>(maxAvailableCores), nbThreads);
+        // nbThreads should not be higher than the available cores,
+        // keep one core for the GPU stage decoding
+        const std::size_t nbCpuCores = gpuJobs.empty() ? maxAvailableCores : std::max(1u, maxAvailableCores - 1);
+        nbThreads = std::min(nbCpuCores, nbThreads);
 
         // nbThreads should not be higher than the number of jobs
         nbThreads = std::min(cpuJobs.size(), nbThreads);
 
         ALICEVISION_LOG_INFO("# threads for extraction: " << nbThreads);
-        omp_set_nested(1);
-
-#pragma omp parallel for num_threads(nbThreads)
-        for (int i = 0; i < cpuJobs.size(); ++i)
-            computeViewJob(cpuJobs.at(i), false, workingColorSpace);
     }
 
+    // Writing stage: the regions are written by a dedicated thread, so the extraction never waits for the disk.
+    // The extracted regions are small compared to the images, the queue only absorbs the writing latency.
+    BoundedQueue<ViewJobResult> resultsQueue(2 * (nbThreads + 1));
+    std::exception_ptr writerError;
+    std::thread writer([&] {
+        ViewJobResult result;
+        while (resultsQueue.pop(result))
+        {
+            if (writerError)
+                continue;  // keep draining the queue so the extraction stages are not blocked
+            try
+            {
+                saveViewJob(*result.job, result.useGPU, result.regions);
+            }
+            catch (...)
+            {
+                writerError = std::current_exception();
+            }
+        }
+    });
+
+    // Views with both GPU and CPU image describers are decoded once for the two stages
+    ViewDataCache viewDataCache(nbSharedImages);
+    const auto loadSharedViewJob = [&](const FeatureExtractorViewJob& job) {
+        return viewDataCache.get(job.view().getViewId(), (job.useCPU() && job.useGPU()) ? 2 : 1, [&](FeatureExtractorViewData& data) {
+            loadViewJob(job, workingColorSpace, data);
+        });
+    };
+
+    // GPU stage: a decoding thread prefetches the images while the GPU image describers extract the previous ones
+    BoundedQueue<std::pair<std::size_t, std::shared_ptr<const FeatureExtractorViewData>>> gpuDataQueue(nbPrefetchedImages);
+    std::exception_ptr gpuDecoderError;
+    std::exception_ptr gpuExtractorError;
+    std::thread gpuDecoder;
+    std::thread gpuExtractor;
+
     if (!gpuJobs.empty())
     {
-        for (const auto& job : gpuJobs)
-            computeViewJob(job, true, workingColorSpace);
+        gpuDecoder = std::thread([&] {
+            try
+            {
+                for (std::size_t i = 0; i < gpuJobs.size(); ++i)
+                {
+                    gpuDataQueue.push(std::make_pair(i, loadSharedViewJob(gpuJobs.at(i))));
+                }
+            }
+            catch (...)
+            {
+                gpuDecoderError = std::current_exception();
+            }
+            gpuDataQueue.close();
+        });
+
+        gpuExtractor = std::thread([&] {
+            std::pair<std::size_t, std::shared_ptr<const FeatureExtractorViewData>> item;
+            bool decoding = true;
+            while (decoding)
+            {
+                // gather the next batch of decoded views
+                std::vector<const FeatureExtractorViewJob*> batchJobs;
+                std::vector<std::shared_ptr<const FeatureExtractorViewData>> batchData;
+                while (batchJobs.size() < gpuBatchSize && (decoding = gpuDataQueue.pop(item)))
+                {
+                    batchJobs.push_back(&gpuJobs.at(item.first));
+                    batchData.push_back(std::move(item.second));
+                }
+                if (batchJobs.empty())
+                    break;
+
+                try
+                {
+                    std::vector<std::vector<std::unique_ptr<feature::Regions>>> batchRegions;
+                    if (batchJobs.size() == 1)
+                    {
+                        batchRegions.resize(1);
+                        computeViewJob(*batchJobs.front(), *batchData.front(), true, batchRegions.front());
+                    }
+                    else
+                    {
+                        computeViewJobsBatch(batchJobs, batchData, batchRegions);
+                    }
+                    batchData.clear();
+
+                    for (std::size_t i = 0; i < batchJobs.size(); ++i)
+                    {
+                        ViewJobResult result;
+                        result.job = batchJobs.at(i);
+                        result.useGPU = true;
+                        result.regions = std::move(batchRegions.at(i));
+                        resultsQueue.push(std::move(result));
+                    }
+                }
+                catch (...)
+                {
+                    gpuExtractorError = std::current_exception();
+                    gpuDataQueue.close();
+                    break;
+                }
+            }
+        });
+    }
+
+    // CPU stage: each thread decodes and extracts its own view jobs,
+    // so the decoding of a view overlaps the extraction of the others.
+    // The jobs run on the shared task scheduler, limited to nbThreads for the memory usage.
+    std::exception_ptr cpuError;
+    if (!cpuJobs.empty())
+    {
+        try
+        {
+            system::parallelFor(0, static_cast<int>(cpuJobs.size()), [&](int i) {
+                const system::MemoryReservation reservation(cpuJobs.at(i).memoryConsuption());
+
+                const std::shared_ptr<const FeatureExtractorViewData> data = loadSharedViewJob(cpuJobs.at(i));
+
+                ViewJobResult result;
+                result.job = &cpuJobs.at(i);
+                result.useGPU = false;
+                computeViewJob(*result.job, *data, false, result.regions);
+                resultsQueue.push(std::move(result));
+            }, static_cast<int>(nbThreads));
+        }
+        catch (...)
+        {
+            // rethrown once the other stages are joined
+            cpuError = std::current_exception();
+        }
+    }
+
+    if (gpuExtractor.joinable())
+    {
+        gpuExtractor.join();
+        gpuDataQueue.close();  // unblock the decoder if the extractor stopped on error
+        gpuDecoder.join();
+    }
+
+    resultsQueue.close();
+    writer.join();
+
+    for (const std::exception_ptr& error : {cpuError, gpuDecoderError, gpuExtractorError, writerError})
+    {
+        if (error)
+            std::rethrow_exception(error);
     }
 }
 
-void FeatureExtractor::computeViewJob(const FeatureExtractorViewJob& job, bool useGPU, const image::EImageColorSpace workingColorSpace)
+void FeatureExtractor::loadViewJob(const FeatureExtractorViewJob& job,
+                                   const image::EImageColorSpace workingColorSpace,
+                                   FeatureExtractorViewData& out_data) const
 {
-    image::Image<float> imageGrayFloat;
-    image::Image<unsigned char> imageGrayUChar;
-    image::Image<unsigned char> mask;
+    ALICEVISION_PROFILE_SCOPE("featureExtraction::load");
+    image::Image<float>& imageGrayFloat = out_data.imageGrayFloat;
+    image::Image<unsigned char>& mask = out_data.mask;
 
     image::readImage(job.view().getImage().getImagePath(), imageGrayFloat, workingColorSpace);
 
-    double pixelRatio = 1.0;
+    double& pixelRatio = out_data.pixelRatio;
+    pixelRatio = 1.0;
     job.view().getImage().getDoubleMetadata({"PixelAspectRatio"}, pixelRatio);
 
     if (pixelRatio != 1.0)
@@ -184,21 +565,61 @@ void FeatureExtractor::computeViewJob(const FeatureExtractorViewJob& job, bool u
         imageGrayFloat.swap(resizedInput);
     }
 
-    if (!_masksFolder.empty() && fs::exists(_masksFolder))
-    {
-        const auto masksFolder = fs::path(_masksFolder);
-        const auto idMaskPath = masksFolder / fs::path(std::to_string(job.view().getViewId())).replace_extension(_maskExtension);
-        const auto nameMaskPath = masksFolder / fs::path(job.view().getImage().getImagePath()).filename().replace_extension(_maskExtension);
+    // converted once for all the image describers using uchar images, the data is read-only during the extraction
+    if (job.useUCharImage())
+        out_data.imageGrayUChar = (imageGrayFloat.GetMat() * 255.f).cast<unsigned char>();
 
-        if (fs::exists(idMaskPath))
-        {
-            image::readImage(idMaskPath.string(), mask, image::EImageColorSpace::LINEAR);
-        }
-        else if (fs::exists(nameMaskPath))
-        {
-            image::readImage(nameMaskPath.string(), mask, image::EImageColorSpace::LINEAR);
-        }
-    }
+    const std::string maskPath = getMaskPath(job.view());
+    if (!maskPath.empty())
+        image::readImage(maskPath, mask, image::EImageColorSpace::LINEAR);
+}
+
+std::string FeatureExtractor::getMaskPath(const sfmData::View& view) const
+{
+    if (_masksFolder.empty() || !fs::exists(_masksFolder))
+        return std::string();
+
+    const auto masksFolder = fs::path(_masksFolder);
+    const auto idMaskPath = masksFolder / fs::path(std::to_string(view.getViewId())).replace_extension(_maskExtension);
+    const auto nameMaskPath = masksFolder / fs::path(view.getImage().getImagePath()).filename().replace_extension(_maskExtension);
+
+    if (fs::exists(idMaskPath))
+        return idMaskPath.string();
+    if (fs::exists(nameMaskPath))
+        return nameMaskPath.string();
+    return std::string();
+}
+
+std::string FeatureExtractor::getViewCacheKey(const sfmData::View& view) const
+{
+    system::ContentHash hash;
+    hash.addString(_cacheParametersKey);
+
+    if (!hash.addFile(view.getImage().getImagePath()))
+        return std::string();
+
+    const std::string maskPath = getMaskPath(view);
+    hash.addValue(std::uint8_t(!maskPath.empty()));
+    if (!maskPath.empty() && !hash.addFile(maskPath))
+        return std::string();
+
+    double pixelRatio = 1.0;
+    view.getImage().getDoubleMetadata({"PixelAspectRatio"}, pixelRatio);
+    hash.addValue(pixelRatio);
+
+    return hash.toString();
+}
+
+void FeatureExtractor::computeViewJob(const FeatureExtractorViewJob& job,
+                                      const FeatureExtractorViewData& data,
+                                      bool useGPU,
+                                      std::vector<std::unique_ptr<feature::Regions>>& out_regions) const
+{
+    ALICEVISION_PROFILE_SCOPE(useGPU ? "featureExtraction::describe [gpu]" : "featureExtraction::describe [cpu]");
+    const image::Image<float>& imageGrayFloat = data.imageGrayFloat;
+    const image::Image<unsigned char>& imageGrayUChar = data.imageGrayUChar;
+
+    out_regions.clear();
 
     for (const auto& imageDescriberIndex : job.imageDescriberIndexes(useGPU))
     {
@@ -206,7 +627,7 @@ void FeatureExtractor::computeViewJob(const FeatureExtractorViewJob& job, bool u
         const feature::EImageDescriberType imageDescriberType = imageDescriber->getDescriberType();
         const std::string imageDescriberTypeName = feature::EImageDescriberType_enumToString(imageDescriberType);
 
-        // Compute features and descriptors and export them to files
+        // Compute features and descriptors
         ALICEVISION_LOG_INFO("Extracting " << imageDescriberTypeName << " features from view '" << job.view().getImage().getImagePath() << "' "
                                            << (useGPU ? "[gpu]" : "[cpu]"));
 
@@ -218,53 +639,139 @@ void FeatureExtractor::computeViewJob(const FeatureExtractorViewJob& job, bool u
         }
         else
         {
-            // image buffer can't use float image
-            if (imageGrayUChar.Width() == 0)  // the first time, convert the float buffer to uchar
-                imageGrayUChar = (imageGrayFloat.GetMat() * 255.f).cast<unsigned char>();
+            // image buffer can't use float image, use the converted buffer
             imageDescriber->describe(imageGrayUChar, regions);
         }
 
-        if (pixelRatio != 1.0)
+        filterRegions(job, data, regions);
+        out_regions.push_back(std::move(regions));
+    }
+}
+
+void FeatureExtractor::computeViewJobsBatch(const std::vector<const FeatureExtractorViewJob*>& jobs,
+                                            const std::vector<std::shared_ptr<const FeatureExtractorViewData>>& data,
+                                            std::vector<std::vector<std::unique_ptr<feature::Regions>>>& out_regions) const
+{
+    ALICEVISION_PROFILE_SCOPE("featureExtraction::describe batch [gpu]");
+    out_regions.clear();
+    out_regions.resize(jobs.size());
+    for (std::size_t i = 0; i < jobs.size(); ++i)
+        out_regions.at(i).resize(jobs.at(i)->imageDescriberIndexes(true).size());
+
+    for (std::size_t imageDescriberIndex = 0; imageDescriberIndex < _imageDescribers.size(); ++imageDescriberIndex)
+    {
+        const auto& imageDescriber = _imageDescribers.at(imageDescriberIndex);
+        const std::string imageDescriberTypeName = feature::EImageDescriberType_enumToString(imageDescriber->getDescriberType());
+
+        // views of the batch to extract with this image describer and position of its regions in the view job
+        std::vector<std::pair<std::size_t, std::size_t>> batchViews;
+        for (std::size_t i = 0; i < jobs.size(); ++i)
+        {
+            const std::vector<std::size_t>& indexes = jobs.at(i)->imageDescriberIndexes(true);
+            const auto it = std::find(indexes.begin(), indexes.end(), imageDescriberIndex);
+            if (it != indexes.end())
+                batchViews.emplace_back(i, std::distance(indexes.begin(), it));
+        }
+        if (batchViews.empty())
+            continue;
+
+        ALICEVISION_LOG_INFO("Extracting " << imageDescriberTypeName << " features from a batch of " << batchViews.size() << " views [gpu]");
+
+        std::vector<std::unique_ptr<feature::Regions>> regions;
+        if (imageDescriber->useFloatImage())
         {
-            // Re-position point features on input image
-            for (auto& feat : regions->Features())
-            {
-                feat.x() /= pixelRatio;
-            }
+            std::vector<const image::Image<float>*> images;
+            for (const auto& view : batchViews)
+                images.push_back(&data.at(view.first)->imageGrayFloat);
+            imageDescriber->describeBatch(images, regions);
+        }
+        else
+        {
+            regions.resize(batchViews.size());
+            for (std::size_t k = 0; k < batchViews.size(); ++k)
+                imageDescriber->describe(data.at(batchViews.at(k).first)->imageGrayUChar, regions.at(k));
         }
 
-        if (mask.Height() > 0)
+        for (std::size_t k = 0; k < batchViews.size(); ++k)
         {
-            std::vector<feature::FeatureInImage> selectedIndices;
-            for (size_t i = 0, n = regions->RegionCount(); i != n; ++i)
-            {
-                const Vec2 position = regions->GetRegionPosition(i);
-                const int x = int(position.x());
-                const int y = int(position.y());
+            const std::size_t i = batchViews.at(k).first;
+            filterRegions(*jobs.at(i), *data.at(i), regions.at(k));
+            out_regions.at(i).at(batchViews.at(k).second) = std::move(regions.at(k));
+        }
+    }
+}
 
-                bool masked = false;
-                if (x < mask.Width() && y < mask.Height())
-                {
-                    if ((mask(y, x) == 0 && !_maskInvert) || (mask(y, x) != 0 && _maskInvert))
-                    {
-                        masked = true;
-                    }
-                }
+void FeatureExtractor::filterRegions(const FeatureExtractorViewJob& job,
+                                     const FeatureExtractorViewData& data,
+                                     std::unique_ptr<feature::Regions>& regions) const
+{
+    const image::Image<unsigned char>& mask = data.mask;
+    const double pixelRatio = data.pixelRatio;
 
-                if (!masked)
+    if (pixelRatio != 1.0)
+    {
+        // Re-position point features on input image
+        for (auto& feat : regions->Features())
+        {
+            feat.x() /= pixelRatio;
+        }
+    }
+
+    if (mask.Height() > 0)
+    {
+        std::vector<feature::FeatureInImage> selectedIndices;
+        for (size_t i = 0, n = regions->RegionCount(); i != n; ++i)
+        {
+            const Vec2 position = regions->GetRegionPosition(i);
+            const int x = int(position.x());
+            const int y = int(position.y());
+
+            bool masked = false;
+            if (x < mask.Width() && y < mask.Height())
+            {
+                if ((mask(y, x) == 0 && !_maskInvert) || (mask(y, x) != 0 && _maskInvert))
                 {
-                    selectedIndices.push_back({IndexT(i), 0});
+                    masked = true;
                 }
             }
 
-            std::vector<IndexT> out_associated3dPoint;
-            std::map<IndexT, IndexT> out_mapFullToLocal;
-            regions = regions->createFilteredRegions(selectedIndices, out_associated3dPoint, out_mapFullToLocal);
+            if (!masked)
+            {
+                selectedIndices.push_back({IndexT(i), 0});
+            }
         }
 
-        imageDescriber->Save(regions.get(), job.getFeaturesPath(imageDescriberType), job.getDescriptorPath(imageDescriberType));
-        ALICEVISION_LOG_INFO(std::left << std::setw(6) << " " << regions->RegionCount() << " " << imageDescriberTypeName
+        std::vector<IndexT> out_associated3dPoint;
+        std::map<IndexT, IndexT> out_mapFullToLocal;
+        regions = regions->createFilteredRegions(selectedIndices, out_associated3dPoint, out_mapFullToLocal);
+    }
+}
+
+void FeatureExtractor::saveViewJob(const FeatureExtractorViewJob& job, bool useGPU, std::vector<std::unique_ptr<feature::Regions>>& regions) const
+{
+    ALICEVISION_PROFILE_SCOPE("featureExtraction::save");
+    const std::vector<std::size_t>& imageDescriberIndexes = job.imageDescriberIndexes(useGPU);
+
+    for (std::size_t i = 0; i < imageDescriberIndexes.size(); ++i)
+    {
+        const auto& imageDescriber = _imageDescribers.at(imageDescriberIndexes.at(i));
+        const feature::EImageDescriberType imageDescriberType = imageDescriber->getDescriberType();
+        const std::string imageDescriberTypeName = feature::EImageDescriberType_enumToString(imageDescriberType);
+
+        ALICEVISION_LOG_INFO(std::left << std::setw(6) << " " << regions.at(i)->RegionCount() << " " << imageDescriberTypeName
                                        << " features extracted from view '" << job.view().getImage().getImagePath() << "'");
+
+        if (job.hasOutputFiles())
+        {
+            imageDescriber->Save(regions.at(i).get(), job.getFeaturesPath(imageDescriberType), job.getDescriptorPath(imageDescriberType));
+            if (!job.getCacheKey().empty())
+                _resultsCache.store(job.getCacheKey() + "." + imageDescriberTypeName,
+                                    {job.getFeaturesPath(imageDescriberType), job.getDescriptorPath(imageDescriberType)});
+        }
+
+        // only the writing thread adds regions, no lock is needed
+        if (_outputRegions != nullptr)
+            _outputRegions->addRegions(job.view().getViewId(), imageDescriberType, regions.at(i).release());
     }
 }
 
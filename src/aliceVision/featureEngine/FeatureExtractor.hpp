@@ -5,12 +5,31 @@
 // You can obtain one at https://mozilla.org/MPL/2.0/.
 
 #include <aliceVision/feature/feature.hpp>
+#include <aliceVision/feature/RegionsPerView.hpp>
 #include <aliceVision/sfmData/SfMData.hpp>
 #include <aliceVision/sfmData/View.hpp>
 #include <aliceVision/system/hardwareContext.hpp>
+#include <aliceVision/system/ResultCache.hpp>
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
 namespace aliceVision {
 namespace featureEngine {
 
+/**
+ * @brief Decoded inputs of a view job, ready for the feature extraction.
+ */
+struct FeatureExtractorViewData
+{
+    image::Image<float> imageGrayFloat;
+    /// converted from imageGrayFloat if an image describer of the view uses uchar images
+    image::Image<unsigned char> imageGrayUChar;
+    image::Image<unsigned char> mask;
+    double pixelRatio = 1.0;
+};
+
 class FeatureExtractorViewJob
 {
   public:
@@ -22,6 +41,12 @@ class FeatureExtractorViewJob
 
     bool useCPU() const { return !_cpuImageDescriberIndexes.empty(); }
 
+    /// at least one image describer of the view uses uchar images
+    bool useUCharImage() const { return _useUCharImage; }
+
+    /// the features are written in the output folder, false if the extraction is only in memory
+    bool hasOutputFiles() const { return !_outputBasename.empty(); }
+
     std::string getFeaturesPath(feature::EImageDescriberType imageDescriberType) const
     {
         return _outputBasename + "." + EImageDescriberType_enumToString(imageDescriberType) + ".feat";
@@ -34,6 +59,11 @@ class FeatureExtractorViewJob
 
     void setImageDescribers(const std::vector<std::shared_ptr<feature::ImageDescriber>>& imageDescribers);
 
+    /// key of the inputs of the view in the results cache, empty if the view is not cached
+    void setCacheKey(const std::string& cacheKey) { _cacheKey = cacheKey; }
+
+    const std::string& getCacheKey() const { return _cacheKey; }
+
     const sfmData::View& view() const { return _view; }
 
     std::size_t memoryConsuption() const { return _memoryConsuption; }
@@ -46,7 +76,9 @@ class FeatureExtractorViewJob
   private:
     const sfmData::View& _view;
     std::size_t _memoryConsuption = 0;
+    bool _useUCharImage = false;
     std::string _outputBasename;
+    std::string _cacheKey;
     std::vector<std::size_t> _cpuImageDescriberIndexes;
     std::vector<std::size_t> _gpuImageDescriberIndexes;
 };
@@ -70,16 +102,92 @@ class FeatureExtractor
         _maskInvert = invert;
     }
 
+    /**
+     * @brief Set the folder of the features and descriptors files.
+     * @note If empty, no file is written and the views are always extracted, see setOutputRegions.
+     */
     void setOutputFolder(const std::string& folder) { _outputFolder = folder; }
 
+    /**
+     * @brief Keep the extracted regions in memory, to chain the next pipeline stages without intermediate files.
+     * @note The views whose features files already exist in the output folder are not extracted, so not added.
+     * @param[in,out] regionsPerView the container of the extracted regions, must outlive process(), nullptr to disable
+     */
+    void setOutputRegions(feature::RegionsPerView* regionsPerView) { _outputRegions = regionsPerView; }
+
+    /**
+     * @brief Reuse the features of the views whose inputs did not change since a previous run.
+     * @note A view is identified by the content of its image and mask, its pixel ratio and the extraction parameters.
+     * @param[in] cacheFolder the folder of the results cache, disabled if empty
+     * @param[in] parametersKey the key of the extraction parameters, see system::getCommandLineKey
+     */
+    void setResultsCache(const std::string& cacheFolder, const std::string& parametersKey)
+    {
+        _resultsCache = system::ResultCache(cacheFolder);
+        _cacheParametersKey = parametersKey;
+    }
+
+    /**
+     * @brief Set the number of views extracted together by the GPU image describers
+     * @param[in] batchSize the number of views in flight on the GPU, 1 to extract the views one by one
+     */
+    void setGpuBatchSize(int batchSize) { _gpuBatchSize = std::max(1, batchSize); }
+
     void addImageDescriber(std::shared_ptr<feature::ImageDescriber>& imageDescriber) { _imageDescribers.push_back(imageDescriber); }
 
     void process(const HardwareContext& hcontext, const image::EImageColorSpace workingColorSpace = image::EImageColorSpace::SRGB);
 
   private:
+    /**
+     * @return the path of the mask of a view, empty if there is none
+     */
+    std::string getMaskPath(const sfmData::View& view) const;
+
+    /**
+     * @return the key of the inputs of a view in the results cache, empty if its image cannot be read
+     */
+    std::string getViewCacheKey(const sfmData::View& view) const;
+
+    /**
+     * @brief Read the image and the mask of a view job.
+     * @param[in] job the view job
+     * @param[in] workingColorSpace the color space of the extraction
+     * @param[out] out_data the decoded image, mask and pixel ratio
+     */
+    void loadViewJob(const FeatureExtractorViewJob& job, const image::EImageColorSpace workingColorSpace, FeatureExtractorViewData& out_data) const;
+
+    /**
+     * @brief Extract the features of a decoded view job, without writing them.
+     * @param[in] job the view job
+     * @param[in] data the decoded inputs of the view job
+     * @param[in] useGPU extract the GPU or the CPU image describers of the job
+     * @param[out] out_regions the regions of each image describer of job.imageDescriberIndexes(useGPU)
+     */
     void computeViewJob(const FeatureExtractorViewJob& job,
+                        const FeatureExtractorViewData& data,
                         bool useGPU,
-                        const image::EImageColorSpace workingColorSpace = image::EImageColorSpace::SRGB);
+                        std::vector<std::unique_ptr<feature::Regions>>& out_regions) const;
+
+    /**
+     * @brief Extract the GPU features of a batch of decoded view jobs, without writing them.
+     * @note The views of a batch are described together, see ImageDescriber::describeBatch.
+     * @param[in] jobs the view jobs
+     * @param[in] data the decoded inputs of each view job
+     * @param[out] out_regions the regions of each view job, as computeViewJob
+     */
+    void computeViewJobsBatch(const std::vector<const FeatureExtractorViewJob*>& jobs,
+                              const std::vector<std::shared_ptr<const FeatureExtractorViewData>>& data,
+                              std::vector<std::vector<std::unique_ptr<feature::Regions>>>& out_regions) const;
+
+    /**
+     * @brief Apply the pixel ratio and the mask of a view job to its extracted regions.
+     */
+    void filterRegions(const FeatureExtractorViewJob& job, const FeatureExtractorViewData& data, std::unique_ptr<feature::Regions>& regions) const;
+
+    /**
+     * @brief Write the regions extracted by computeViewJob, and move them to the output regions if any.
+     */
+    void saveViewJob(const FeatureExtractorViewJob& job, bool useGPU, std::vector<std::unique_ptr<feature::Regions>>& regions) const;
 
     const sfmData::SfMData& _sfmData;
     std::vector<std::shared_ptr<feature::ImageDescriber>> _imageDescribers;
@@ -87,8 +195,12 @@ class FeatureExtractor
     std::string _maskExtension;
     bool _maskInvert;
     std::string _outputFolder;
+    feature::RegionsPerView* _outputRegions = nullptr;
+    system::ResultCache _resultsCache;
+    std::string _cacheParametersKey;
     int _rangeStart = -1;
     int _rangeSize = -1;
+    int _gpuBatchSize = 1;
 };
 
 }  // namespace featureEngine
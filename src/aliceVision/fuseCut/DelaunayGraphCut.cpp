@@ -8,8 +8,11 @@
 // #define ALICEVISION_DEBUG_VOTE
 
 #include "DelaunayGraphCut.hpp"
-// #include <aliceVision/fuseCut/MaxFlow_CSR.hpp>
+#include <aliceVision/fuseCut/DepthMapsFusion.hpp>
+#include <aliceVision/fuseCut/MaxFlow_CSR.hpp>
 #include <aliceVision/fuseCut/MaxFlow_AdjList.hpp>
+#include <aliceVision/fuseCut/MaxFlow_PushRelabel.hpp>
+#include <aliceVision/fuseCut/MaxFlowSolver.hpp>
 #include <aliceVision/sfmData/SfMData.hpp>
 #include <aliceVision/mvsData/geometry.hpp>
 #include <aliceVision/image/jetColorMap.hpp>
@@ -20,15 +23,18 @@
 #include <aliceVision/mvsUtils/mapIO.hpp>
 #include <aliceVision/image/imageAlgo.hpp>
 #include <aliceVision/system/ProgressDisplay.hpp>
+#include <aliceVision/system/Timer.hpp>
 #include <aliceVision/alicevision_omp.hpp>
 
 #include "nanoflann.hpp"
 
 #include <geogram/points/kd_tree.h>
+#include <geogram/basic/process.h>
 
 #include <boost/filesystem.hpp>
 #include <boost/filesystem/operations.hpp>
 
+#include <algorithm>
 #include <cmath>
 #include <random>
 #include <stdexcept>
@@ -312,7 +318,8 @@ void removeInvalidPoints(std::vector<Point3d>& verticesCoordsPrepare,
     verticesAttrPrepare.swap(verticesAttrTmp);
 }
 
-void createVerticesWithVisibilities(const StaticVector<int>& cams,
+void createVerticesWithVisibilities(const std::vector<int>& camsOrder,
+                                    DepthMapsCache& depthMapsCache,
                                     std::vector<Point3d>& verticesCoordsPrepare,
                                     std::vector<double>& pixSizePrepare,
                                     std::vector<float>& simScorePrepare,
@@ -342,36 +349,28 @@ void createVerticesWithVisibilities(const StaticVector<int>& cams,
         omp_init_lock(&lock);
 
     omp_set_nested(1);
-#pragma omp parallel for num_threads(3)
-    for (int c = 0; c < cams.size(); ++c)
+#pragma omp parallel for num_threads(3) schedule(dynamic, 1)
+    for (int i = 0; i < camsOrder.size(); ++i)
     {
-        ALICEVISION_LOG_INFO("Create visibilities (" << c << "/" << cams.size() << ")");
-        image::Image<float> depthMap;
-        image::Image<float> simMap;
+        const int c = camsOrder[i];
+        ALICEVISION_LOG_INFO("Create visibilities (" << i << "/" << camsOrder.size() << ")");
         const int width = mp.getWidth(c);
         const int height = mp.getHeight(c);
 
-        // read depth map
-        mvsUtils::readMap(c, mp, mvsUtils::EFileType::depthMapFiltered, depthMap);
+        const std::shared_ptr<const CameraDepthMaps> maps = depthMapsCache.get(c);
+        const image::Image<float>& depthMap = maps->depthMap;
 
         if (depthMap.size() <= 0)
-        {
-            ALICEVISION_LOG_WARNING("Empty depth map (cam id: " << c << ")");
             continue;
-        }
 
-        // read similarity map
-        try
+        image::Image<float> simMap;
+        if (maps->hasSimMap())
         {
-            mvsUtils::readMap(c, mp, mvsUtils::EFileType::simMapFiltered, simMap);
-            image::Image<float> simMapTmp(simMap.Width(), simMap.Height());
-            imageAlgo::convolveImage(simMap, simMapTmp, "gaussian", simGaussianSize, simGaussianSize);
-            simMap.swap(simMapTmp);
+            imageAlgo::convolveImage(maps->simMap, simMap, "gaussian", simGaussianSize, simGaussianSize);
         }
-        catch (const std::exception& e)
+        else
         {
-            ALICEVISION_LOG_WARNING("Cannot find similarity map file.");
-            simMap.resize(width * height, -1);
+            simMap.resize(width, height, true, -1);
         }
 
 // Add visibility
@@ -476,7 +475,21 @@ DelaunayGraphCut::DelaunayGraphCut(mvsUtils::MultiViewParams& mp)
     saveTemporaryBinFiles = _mp.userParams.get<bool>("LargeScale.saveTemporaryBinFiles", false);
 
     GEO::initialize();
-    _tetrahedralization = GEO::Delaunay::create(3, "BDEL");
+
+    // parallel Delaunay 3d (spatial partitioning with concurrent insertion, see geogram PDEL)
+    // produces the same cells/neighbors structure as the sequential BDEL, with a different cell order
+    if (_mp.userParams.get<bool>("delaunaycut.parallelDelaunay", true))
+    {
+        GEO::Process::set_max_threads(GEO::index_t(omp_get_max_threads()));
+        _tetrahedralization = GEO::Delaunay::create(3, "PDEL");
+
+        if (_tetrahedralization.is_null())
+            ALICEVISION_LOG_WARNING("Parallel Delaunay tetrahedralization is not available, use the sequential one.");
+    }
+
+    if (_tetrahedralization.is_null())
+        _tetrahedralization = GEO::Delaunay::create(3, "BDEL");
+
     // _tetrahedralization->set_keeps_infinite(true);
     _tetrahedralization->set_stores_neighbors(true);
     // _tetrahedralization->set_stores_cicl(true);
@@ -563,9 +576,10 @@ void DelaunayGraphCut::computeDelaunay()
 
     assert(_verticesCoords.size() == _verticesAttr.size());
 
-    long tall = clock();
+    // wall-clock time, the tetrahedralization may be multi-threaded
+    const system::Timer timer;
     _tetrahedralization->set_vertices(_verticesCoords.size(), _verticesCoords.front().m);
-    mvsUtils::printfElapsedTime(tall, "GEOGRAM Delaunay tetrahedralization ");
+    ALICEVISION_LOG_INFO("GEOGRAM Delaunay tetrahedralization of " << _verticesCoords.size() << " vertices done in " << timer.elapsed() << " s.");
 
     initCells();
 
@@ -640,24 +654,25 @@ StaticVector<StaticVector<int>*>* DelaunayGraphCut::createPtsCams()
     return out;
 }
 
-void DelaunayGraphCut::createPtsCams(StaticVector<StaticVector<int>>& out_ptsCams)
+void DelaunayGraphCut::createPtsCams(CompactJaggedArray<int>& out_ptsCams)
 {
     long t = std::clock();
     ALICEVISION_LOG_INFO("Extract visibilities.");
-    int npts = getNbVertices();
+    const int npts = _verticesAttr.size();
 
-    out_ptsCams.reserve(npts);
+    CompactJaggedArray<int>::Builder builder(npts);
+    for (int i = 0; i < npts; ++i)
+        builder.count(i, _verticesAttr[i].getNbCameras());
+    builder.allocate();
 
-    for (const GC_vertexInfo& v : _verticesAttr)
+#pragma omp parallel for
+    for (int i = 0; i < npts; ++i)
     {
-        StaticVector<int> cams;
-        cams.reserve(v.getNbCameras());
-        for (int c = 0; c < v.getNbCameras(); c++)
-        {
-            cams.push_back(v.cams[c]);
-        }
-        out_ptsCams.push_back(cams);
-    }  // for i
+        const GC_vertexInfo& v = _verticesAttr[i];
+        std::copy(v.cams.begin(), v.cams.begin() + v.getNbCameras(), builder.row(i).begin());
+    }
+
+    out_ptsCams = builder.build();
 
     ALICEVISION_LOG_INFO("Extract visibilities done.");
 
@@ -1110,6 +1125,14 @@ void DelaunayGraphCut::fuseFromDepthMaps(const StaticVector<int>& cams, const Po
 {
     ALICEVISION_LOG_INFO("fuseFromDepthMaps, maxVertices: " << params.maxPoints);
 
+    if (!params.fusedPointsFilepath.empty() && boost::filesystem::exists(params.fusedPointsFilepath))
+    {
+        ALICEVISION_LOG_INFO("Use fused points from file: " << params.fusedPointsFilepath);
+        if (readFusedPoints(params.fusedPointsFilepath, voxel, _verticesCoords, _verticesAttr) == 0)
+            throw std::runtime_error("Depth map fusion gives an empty result.");
+        return;
+    }
+
     // Load depth from depth maps, select points per depth maps (1 value per tile).
     // Filter points inside other points (with a volume defined by the pixelSize)
     // If too much points at the end, increment a coefficient factor on the pixel size
@@ -1118,19 +1141,20 @@ void DelaunayGraphCut::fuseFromDepthMaps(const StaticVector<int>& cams, const Po
     const unsigned long nbValidDepths = computeNumberOfAllPoints(_mp, _mp.getProcessDownscale());
     ALICEVISION_LOG_INFO("Number of all valid depths in input depth maps: " << nbValidDepths);
     std::size_t nbPixels = 0;
-    for (const auto& imgParams : _mp.getImagesParams())
+    for (int i = 0; i < cams.size(); ++i)
     {
-        nbPixels += imgParams.size;
+        nbPixels += _mp.getImageParams(cams[i]).size;
     }
     ALICEVISION_LOG_INFO("Number of pixels from all input images: " << nbPixels);
     int step = std::floor(std::sqrt(double(nbPixels) / double(params.maxInputPoints)));
     step = std::max(step, params.minStep);
+    // only the selected cameras have points, so the memory does not depend on the total number of cameras
     std::size_t realMaxVertices = 0;
-    std::vector<int> startIndex(_mp.getNbCameras(), 0);
-    for (int i = 0; i < _mp.getNbCameras(); ++i)
+    std::vector<std::size_t> startIndex(_mp.getNbCameras(), 0);
+    for (int i = 0; i < cams.size(); ++i)
     {
-        const auto& imgParams = _mp.getImageParams(i);
-        startIndex[i] = realMaxVertices;
+        const auto& imgParams = _mp.getImageParams(cams[i]);
+        startIndex[cams[i]] = realMaxVertices;
         realMaxVertices += divideRoundUp(imgParams.width, step) * divideRoundUp(imgParams.height, step);
     }
     std::vector<Point3d> verticesCoordsPrepare(realMaxVertices);
@@ -1147,59 +1171,38 @@ void DelaunayGraphCut::fuseFromDepthMaps(const StaticVector<int>& cams, const Po
     ALICEVISION_LOG_INFO("realMaxVertices: " << realMaxVertices);
     ALICEVISION_LOG_INFO("minVis: " << params.minVis);
 
+    // Cameras are visited in a visibility-coherent order, alternating the order direction between the passes,
+    // so the last depth maps of a pass are still in the cache at the beginning of the next one.
+    const std::vector<int> camsOrder = computeCamerasVisitOrder(_mp.CArr, cams);
+    const std::vector<int> camsReverseOrder(camsOrder.rbegin(), camsOrder.rend());
+    DepthMapsCache depthMapsCache(_mp, params.maxNbCachedDepthMaps);
+    ALICEVISION_LOG_INFO("Depth maps cache size: " << depthMapsCache.getMaxNbCameras() << " cameras.");
+
     ALICEVISION_LOG_INFO("Load depth maps and add points.");
     {
         omp_set_nested(1);
-#pragma omp parallel for num_threads(3)
-        for (int c = 0; c < cams.size(); c++)
+#pragma omp parallel for num_threads(3) schedule(dynamic, 1)
+        for (int i = 0; i < camsOrder.size(); i++)
         {
-            image::Image<float> depthMap;
-            image::Image<float> simMap;
-            image::Image<unsigned char> numOfModalsMap;
-
+            const int c = camsOrder[i];
             const int width = _mp.getWidth(c);
             const int height = _mp.getHeight(c);
 
-            {
-                // read depth map
-                mvsUtils::readMap(c, _mp, mvsUtils::EFileType::depthMapFiltered, depthMap);
+            const std::shared_ptr<const CameraDepthMaps> maps = depthMapsCache.get(c, true);
+            const image::Image<float>& depthMap = maps->depthMap;
+            const image::Image<unsigned char>& numOfModalsMap = maps->nmodMap;
 
-                if (depthMap.size() <= 0)
-                {
-                    ALICEVISION_LOG_WARNING("Empty depth map (cam id: " << c << ")");
-                    continue;
-                }
-
-                // read similarity map
-                try
-                {
-                    mvsUtils::readMap(c, _mp, mvsUtils::EFileType::simMapFiltered, simMap);
-                    image::Image<float> simMapTmp;
-                    imageAlgo::convolveImage(simMap, simMapTmp, "gaussian", params.simGaussianSizeInit, params.simGaussianSizeInit);
-                    simMap.swap(simMapTmp);
-                }
-                catch (const std::exception& e)
-                {
-                    ALICEVISION_LOG_WARNING("simMap file can't be found.");
-                    simMap.resize(width, height, true, -1);
-                }
+            if (depthMap.size() <= 0)
+                continue;
 
-                // read nmod map
-                int wTmp, hTmp;
-                const std::string nmodMapFilepath = getFileNameFromIndex(_mp, c, mvsUtils::EFileType::nmodMap);
-                // If we have an nModMap in input (from depthmapfilter) use it,
-                // else init with a constant value.
-                if (boost::filesystem::exists(nmodMapFilepath))
-                {
-                    image::readImage(nmodMapFilepath, numOfModalsMap, image::EImageColorSpace::NO_CONVERSION);
-                    if (numOfModalsMap.Width() != width || numOfModalsMap.Height() != height)
-                        throw std::runtime_error("Wrong nmod map dimensions: " + nmodMapFilepath);
-                }
-                else
-                {
-                    ALICEVISION_LOG_WARNING("nModMap file can't be found: " << nmodMapFilepath);
-                    numOfModalsMap.resize(width, height, true, 1);
-                }
+            image::Image<float> simMap;
+            if (maps->hasSimMap())
+            {
+                imageAlgo::convolveImage(maps->simMap, simMap, "gaussian", params.simGaussianSizeInit, params.simGaussianSizeInit);
+            }
+            else
+            {
+                simMap.resize(width, height, true, -1);
             }
 
             const int syMax = divideRoundUp(height, step);
@@ -1209,7 +1212,7 @@ void DelaunayGraphCut::fuseFromDepthMaps(const StaticVector<int>& cams, const Po
             {
                 for (int sx = 0; sx < sxMax; ++sx)
                 {
-                    const int index = startIndex[c] + sy * sxMax + sx;
+                    const std::size_t index = startIndex[c] + sy * sxMax + sx;
                     float bestDepth = std::numeric_limits<float>::max();
                     float bestScore = 0;
                     float bestSimScore = 0;
@@ -1295,7 +1298,8 @@ void DelaunayGraphCut::fuseFromDepthMaps(const StaticVector<int>& cams, const Po
 
     // Compute the vertices positions and simScore from all input depthMap/simMap images,
     // and declare the visibility information (the cameras indexes seeing the vertex).
-    createVerticesWithVisibilities(cams,
+    createVerticesWithVisibilities(camsReverseOrder,
+                                   depthMapsCache,
                                    verticesCoordsPrepare,
                                    pixSizePrepare,
                                    simScorePrepare,
@@ -1413,7 +1417,8 @@ void DelaunayGraphCut::fuseFromDepthMaps(const StaticVector<int>& cams, const Po
     {
         ALICEVISION_LOG_INFO("Create final visibilities");
         // Initialize the vertice attributes and declare the visibility information
-        createVerticesWithVisibilities(cams,
+        createVerticesWithVisibilities(camsOrder,
+                                       depthMapsCache,
                                        verticesCoordsPrepare,
                                        pixSizePrepare,
                                        simScorePrepare,
@@ -1425,11 +1430,16 @@ void DelaunayGraphCut::fuseFromDepthMaps(const StaticVector<int>& cams, const Po
                                        params.simGaussianSize);
     }
 
+    ALICEVISION_LOG_INFO("Depth maps loaded " << depthMapsCache.getNbLoads() << " times for " << camsOrder.size() << " cameras.");
+
     if (verticesCoordsPrepare.empty())
         throw std::runtime_error("Depth map fusion gives an empty result.");
 
     ALICEVISION_LOG_WARNING("fuseFromDepthMaps done: " << verticesCoordsPrepare.size() << " points created.");
 
+    if (!params.fusedPointsFilepath.empty())
+        writeFusedPoints(params.fusedPointsFilepath, verticesCoordsPrepare, verticesAttrPrepare);
+
     // Insert the new elements
     if (_verticesCoords.empty())
     {
@@ -1977,66 +1987,82 @@ void DelaunayGraphCut::fillGraph(double nPixelSizeBehind,
 
     size_t progressStep = verticesRandIds.size() / 100;
     progressStep = std::max(size_t(1), progressStep);
-#pragma omp parallel for reduction(+:totalStepsFront,totalRayFront,totalStepsBehind,totalRayBehind,totalCamHaveVisibilityOnVertex,totalOfVertex,totalIsRealNrc)
-    for (int i = 0; i < verticesRandIds.size(); i++)
-    {
-        if (i % progressStep == 0)
-        {
-            ++progressDisplay;
-        }
 
-        const int vertexIndex = verticesRandIds[i];
-        const GC_vertexInfo& v = _verticesAttr[vertexIndex];
+    // votes on the cells weights are accumulated in thread-local buffers without any synchronization
+    // and applied to the shared cells weights in batches, when a buffer is full and at the end
+    const std::size_t maxNbVotesPerThread = _mp.userParams.get<std::size_t>("delaunaycut.fillGraphMaxNbVotesPerThread", 1 << 20);
 
-        GeometriesCount subTotalGeometriesIntersectedFrontCount;
-        GeometriesCount subTotalGeometriesIntersectedBehindCount;
+#pragma omp parallel
+    {
+        CellVotesBuffer votes(maxNbVotesPerThread);
 
-        if (v.isReal())
+#pragma omp for schedule(dynamic, 64) reduction(+:totalStepsFront,totalRayFront,totalStepsBehind,totalRayBehind,totalCamHaveVisibilityOnVertex,totalOfVertex,totalIsRealNrc)
+        for (int i = 0; i < verticesRandIds.size(); i++)
         {
-            ++totalIsRealNrc;
-            // "weight" is called alpha(p) in the paper
-            const float weight = weightFcn((float)v.nrc, labatutWeights, v.getNbCameras());  // number of cameras
+            if (i % progressStep == 0)
+            {
+                ++progressDisplay;
+            }
+
+            const int vertexIndex = verticesRandIds[i];
+            const GC_vertexInfo& v = _verticesAttr[vertexIndex];
+
+            GeometriesCount subTotalGeometriesIntersectedFrontCount;
+            GeometriesCount subTotalGeometriesIntersectedBehindCount;
 
-            for (int c = 0; c < v.cams.size(); c++)
+            if (v.isReal())
             {
-                assert(v.cams[c] >= 0);
-                assert(v.cams[c] < _mp.ncams);
-
-                int stepsFront = 0;
-                int stepsBehind = 0;
-                GeometriesCount geometriesIntersectedFrontCount;
-                GeometriesCount geometriesIntersectedBehindCount;
-                fillGraphPartPtRc(stepsFront,
-                                  stepsBehind,
-                                  geometriesIntersectedFrontCount,
-                                  geometriesIntersectedBehindCount,
-                                  vertexIndex,
-                                  v.cams[c],
-                                  weight,
-                                  fullWeight,
-                                  nPixelSizeBehind,
-                                  fillOut,
-                                  distFcnHeight);
-
-                totalStepsFront += stepsFront;
-                totalRayFront += 1;
-                totalStepsBehind += stepsBehind;
-                totalRayBehind += 1;
-
-                subTotalGeometriesIntersectedFrontCount += geometriesIntersectedFrontCount;
-                subTotalGeometriesIntersectedBehindCount += geometriesIntersectedBehindCount;
-            }  // for c
-
-            totalCamHaveVisibilityOnVertex += v.cams.size();
-            totalOfVertex += 1;
-
-            boost::atomic_ref<std::size_t>{totalGeometriesIntersectedFrontCount.facets} += subTotalGeometriesIntersectedFrontCount.facets;
-            boost::atomic_ref<std::size_t>{totalGeometriesIntersectedFrontCount.vertices} += subTotalGeometriesIntersectedFrontCount.vertices;
-            boost::atomic_ref<std::size_t>{totalGeometriesIntersectedFrontCount.edges} += subTotalGeometriesIntersectedFrontCount.edges;
-            boost::atomic_ref<std::size_t>{totalGeometriesIntersectedBehindCount.facets} += subTotalGeometriesIntersectedBehindCount.facets;
-            boost::atomic_ref<std::size_t>{totalGeometriesIntersectedBehindCount.vertices} += subTotalGeometriesIntersectedBehindCount.vertices;
-            boost::atomic_ref<std::size_t>{totalGeometriesIntersectedBehindCount.edges} += subTotalGeometriesIntersectedBehindCount.edges;
+                ++totalIsRealNrc;
+                // "weight" is called alpha(p) in the paper
+                const float weight = weightFcn((float)v.nrc, labatutWeights, v.getNbCameras());  // number of cameras
+
+                for (int c = 0; c < v.cams.size(); c++)
+                {
+                    assert(v.cams[c] >= 0);
+                    assert(v.cams[c] < _mp.ncams);
+
+                    int stepsFront = 0;
+                    int stepsBehind = 0;
+                    GeometriesCount geometriesIntersectedFrontCount;
+                    GeometriesCount geometriesIntersectedBehindCount;
+                    fillGraphPartPtRc(votes,
+                                      stepsFront,
+                                      stepsBehind,
+                                      geometriesIntersectedFrontCount,
+                                      geometriesIntersectedBehindCount,
+                                      vertexIndex,
+                                      v.cams[c],
+                                      weight,
+                                      fullWeight,
+                                      nPixelSizeBehind,
+                                      fillOut,
+                                      distFcnHeight);
+
+                    totalStepsFront += stepsFront;
+                    totalRayFront += 1;
+                    totalStepsBehind += stepsBehind;
+                    totalRayBehind += 1;
+
+                    subTotalGeometriesIntersectedFrontCount += geometriesIntersectedFrontCount;
+                    subTotalGeometriesIntersectedBehindCount += geometriesIntersectedBehindCount;
+                }  // for c
+
+                totalCamHaveVisibilityOnVertex += v.cams.size();
+                totalOfVertex += 1;
+
+                boost::atomic_ref<std::size_t>{totalGeometriesIntersectedFrontCount.facets} += subTotalGeometriesIntersectedFrontCount.facets;
+                boost::atomic_ref<std::size_t>{totalGeometriesIntersectedFrontCount.vertices} += subTotalGeometriesIntersectedFrontCount.vertices;
+                boost::atomic_ref<std::size_t>{totalGeometriesIntersectedFrontCount.edges} += subTotalGeometriesIntersectedFrontCount.edges;
+                boost::atomic_ref<std::size_t>{totalGeometriesIntersectedBehindCount.facets} += subTotalGeometriesIntersectedBehindCount.facets;
+                boost::atomic_ref<std::size_t>{totalGeometriesIntersectedBehindCount.vertices} += subTotalGeometriesIntersectedBehindCount.vertices;
+                boost::atomic_ref<std::size_t>{totalGeometriesIntersectedBehindCount.edges} += subTotalGeometriesIntersectedBehindCount.edges;
+            }
+
+            if (votes.isFull())
+                flushCellVotes(votes);
         }
+
+        flushCellVotes(votes);
     }
 
     ALICEVISION_LOG_DEBUG("_verticesAttr.size(): " << _verticesAttr.size() << "(" << verticesRandIds.size() << ")");
@@ -2055,7 +2081,65 @@ void DelaunayGraphCut::fillGraph(double nPixelSizeBehind,
     mvsUtils::printfElapsedTime(t1, "s-t graph weights computed : ");
 }
 
-void DelaunayGraphCut::fillGraphPartPtRc(int& outTotalStepsFront,
+void DelaunayGraphCut::flushCellVotes(CellVotesBuffer& buffer)
+{
+    using EField = CellVotesBuffer::EField;
+    using Vote = CellVotesBuffer::Vote;
+
+    std::vector<Vote>& votes = buffer.votes;
+
+    // group the votes by cell and field, so each cell weight is updated once
+    std::sort(votes.begin(), votes.end(), [](const Vote& a, const Vote& b) {
+        return (a.cellIndex < b.cellIndex) || (a.cellIndex == b.cellIndex && a.field < b.field);
+    });
+
+    std::size_t i = 0;
+    while (i < votes.size())
+    {
+        const CellIndex cellIndex = votes[i].cellIndex;
+        const EField field = votes[i].field;
+
+        float value = 0.0f;
+        for (; i < votes.size() && votes[i].cellIndex == cellIndex && votes[i].field == field; ++i)
+        {
+            if (field == EField::cellSWeight)
+                value = votes[i].value;  // set, not accumulated
+            else
+                value += votes[i].value;
+        }
+
+        GC_cellInfo& c = _cellsAttr[cellIndex];
+        switch (field)
+        {
+            case EField::cellSWeight:
+                boost::atomic_ref<float>{c.cellSWeight} = value;
+                break;
+            case EField::cellTWeight:
+                boost::atomic_ref<float>{c.cellTWeight} += value;
+                break;
+            case EField::gEdgeVisWeight0:
+            case EField::gEdgeVisWeight1:
+            case EField::gEdgeVisWeight2:
+            case EField::gEdgeVisWeight3:
+                boost::atomic_ref<float>{c.gEdgeVisWeight[static_cast<int>(field) - static_cast<int>(EField::gEdgeVisWeight0)]} += value;
+                break;
+            case EField::fullnessScore:
+                boost::atomic_ref<float>{c.fullnessScore} += value;
+                break;
+            case EField::emptinessScore:
+                boost::atomic_ref<float>{c.emptinessScore} += value;
+                break;
+            case EField::on:
+                boost::atomic_ref<float>{c.on} += value;
+                break;
+        }
+    }
+
+    votes.clear();
+}
+
+void DelaunayGraphCut::fillGraphPartPtRc(CellVotesBuffer& votes,
+                                         int& outTotalStepsFront,
                                          int& outTotalStepsBehind,
                                          GeometriesCount& outFrontCount,
                                          GeometriesCount& outBehindCount,
@@ -2067,6 +2151,8 @@ void DelaunayGraphCut::fillGraphPartPtRc(int& outTotalStepsFront,
                                          bool fillOut,
                                          float distFcnHeight)  // nPixelSizeBehind=2*spaceSteps allPoints=1 behind=0 fillOut=1 distFcnHeight=0
 {
+    using EField = CellVotesBuffer::EField;
+
     const int maxint = std::numeric_limits<int>::max();
     const double marginEpsilonFactor = 1.0e-4;
 
@@ -2143,11 +2229,11 @@ void DelaunayGraphCut::fillGraphPartPtRc(int& outTotalStepsFront,
             if (geometry.type == EGeometryType::Facet)
             {
                 ++outFrontCount.facets;
-                boost::atomic_ref<float>{_cellsAttr[geometry.facet.cellIndex].emptinessScore} += weight;
+                votes.add(geometry.facet.cellIndex, EField::emptinessScore, weight);
 
                 {
                     const float dist = distFcn(maxDist, (originPt - lastIntersectPt).size(), distFcnHeight);
-                    boost::atomic_ref<float>{_cellsAttr[geometry.facet.cellIndex].gEdgeVisWeight[geometry.facet.localVertexIndex]} += weight * dist;
+                    votes.addEdgeVis(geometry.facet.cellIndex, geometry.facet.localVertexIndex, weight * dist);
                 }
 
                 // Take the mirror facet to iterate over the next cell
@@ -2176,7 +2262,7 @@ void DelaunayGraphCut::fillGraphPartPtRc(int& outTotalStepsFront,
                 // current one.
                 if (previousGeometry.type == EGeometryType::Facet)
                 {
-                    boost::atomic_ref<float>{_cellsAttr[previousGeometry.facet.cellIndex].emptinessScore} += weight;
+                    votes.add(previousGeometry.facet.cellIndex, EField::emptinessScore, weight);
                 }
 
                 if (geometry.type == EGeometryType::Vertex)
@@ -2205,7 +2291,7 @@ void DelaunayGraphCut::fillGraphPartPtRc(int& outTotalStepsFront,
             // Declare the last part of the empty path as connected to EMPTY (S node in the graph cut)
             if (lastIntersectedFacet.cellIndex != GEO::NO_CELL && (_mp.CArr[cam] - intersectPt).size() < 0.2 * pointCamDistance)
             {
-                boost::atomic_ref<float>{_cellsAttr[lastIntersectedFacet.cellIndex].cellSWeight} = (float)maxint;
+                votes.add(lastIntersectedFacet.cellIndex, EField::cellSWeight, (float)maxint);
             }
         }
 
@@ -2217,7 +2303,7 @@ void DelaunayGraphCut::fillGraphPartPtRc(int& outTotalStepsFront,
                 // lastGeoIsVertex is supposed to be positive in almost all cases.
                 // If we do not reach the camera, we still vote on the last tetrehedra.
                 // Possible reaisons: the camera is not part of the vertices or we encounter a numerical error in intersectNextGeom
-                boost::atomic_ref<float>{_cellsAttr[lastIntersectedFacet.cellIndex].cellSWeight} = (float)maxint;
+                votes.add(lastIntersectedFacet.cellIndex, EField::cellSWeight, (float)maxint);
             }
             // else
             // {
@@ -2291,11 +2377,11 @@ void DelaunayGraphCut::fillGraphPartPtRc(int& outTotalStepsFront,
                 // Vote for the first cell found (only once)
                 if (firstIteration)
                 {
-                    boost::atomic_ref<float>{_cellsAttr[geometry.facet.cellIndex].on} += fWeight;
+                    votes.add(geometry.facet.cellIndex, EField::on, fWeight);
                     firstIteration = false;
                 }
 
-                boost::atomic_ref<float>{_cellsAttr[geometry.facet.cellIndex].fullnessScore} += fWeight;
+                votes.add(geometry.facet.cellIndex, EField::fullnessScore, fWeight);
 
                 // Take the mirror facet to iterate over the next cell
                 const Facet mFacet = mirrorFacet(geometry.facet);
@@ -2309,7 +2395,7 @@ void DelaunayGraphCut::fillGraphPartPtRc(int& outTotalStepsFront,
 
                 {
                     const float dist = distFcn(maxDist, (originPt - lastIntersectPt).size(), distFcnHeight);
-                    boost::atomic_ref<float>{_cellsAttr[geometry.facet.cellIndex].gEdgeVisWeight[geometry.facet.localVertexIndex]} += fWeight * dist;
+                    votes.addEdgeVis(geometry.facet.cellIndex, geometry.facet.localVertexIndex, fWeight * dist);
                 }
                 if (previousGeometry.type == EGeometryType::Facet && outBehindCount.facets > 1000)
                 {
@@ -2344,7 +2430,7 @@ void DelaunayGraphCut::fillGraphPartPtRc(int& outTotalStepsFront,
 
                     for (const CellIndex& ci : neighboringCells)
                     {
-                        boost::atomic_ref<float>{_cellsAttr[neighboringCells[0]].on} += fWeight;
+                        votes.add(neighboringCells[0], EField::on, fWeight);
                     }
                     firstIteration = false;
                 }
@@ -2354,7 +2440,7 @@ void DelaunayGraphCut::fillGraphPartPtRc(int& outTotalStepsFront,
                 // current one.
                 if (previousGeometry.type == EGeometryType::Facet)
                 {
-                    boost::atomic_ref<float>{_cellsAttr[previousGeometry.facet.cellIndex].fullnessScore} += fWeight;
+                    votes.add(previousGeometry.facet.cellIndex, EField::fullnessScore, fWeight);
                 }
 
                 if (geometry.type == EGeometryType::Vertex)
@@ -2384,7 +2470,7 @@ void DelaunayGraphCut::fillGraphPartPtRc(int& outTotalStepsFront,
         // found facet Vote for the last intersected facet (farthest from the camera)
         if (lastIntersectedFacet.cellIndex != GEO::NO_CELL)
         {
-            boost::atomic_ref<float>{_cellsAttr[lastIntersectedFacet.cellIndex].cellTWeight} += fWeight;
+            votes.add(lastIntersectedFacet.cellIndex, EField::cellTWeight, fWeight);
         }
     }
 }
@@ -3236,15 +3322,37 @@ void DelaunayGraphCut::addToInfiniteSw(float sW)
 }
 
 void DelaunayGraphCut::maxflow()
+{
+    const EMaxFlowSolver solver =
+      EMaxFlowSolver_stringToEnum(_mp.userParams.get<std::string>("delaunaycut.maxflowSolver", EMaxFlowSolver_enumToString(EMaxFlowSolver::BOYKOV_KOLMOGOROV)));
+
+    ALICEVISION_LOG_INFO("Maxflow solver: " << solver);
+
+    switch (solver)
+    {
+        case EMaxFlowSolver::BOYKOV_KOLMOGOROV:
+            maxflowCompute<MaxFlow_AdjList>();
+            break;
+        case EMaxFlowSolver::BOYKOV_KOLMOGOROV_CSR:
+            maxflowCompute<MaxFlow_CSR>();
+            break;
+        case EMaxFlowSolver::PUSH_RELABEL:
+            maxflowCompute<MaxFlow_PushRelabel>();
+            break;
+    }
+}
+
+template<class MaxFlowGraph>
+void DelaunayGraphCut::maxflowCompute()
 {
     long t_maxflow = clock();
+    const system::Timer timer;
 
     ALICEVISION_LOG_INFO("Maxflow: start allocation.");
     const std::size_t nbCells = _cellsAttr.size();
     ALICEVISION_LOG_INFO("Number of cells: " << nbCells);
 
-    // MaxFlow_CSR maxFlowGraph(nbCells);
-    MaxFlow_AdjList maxFlowGraph(nbCells);
+    MaxFlowGraph maxFlowGraph(nbCells);
 
     ALICEVISION_LOG_INFO("Maxflow: add nodes.");
     // fill s-t edges
@@ -3312,8 +3420,10 @@ void DelaunayGraphCut::maxflow()
     long t_maxflow_compute = clock();
     // Find graph-cut solution
     ALICEVISION_LOG_INFO("Maxflow: compute.");
+    const system::Timer timerCompute;
     const float totalFlow = maxFlowGraph.compute();
     mvsUtils::printfElapsedTime(t_maxflow_compute, "Maxflow computation ");
+    ALICEVISION_LOG_INFO("Maxflow computation wall-clock time: " << timerCompute.elapsed() << " s.");
     ALICEVISION_LOG_INFO("totalFlow: " << totalFlow);
 
     ALICEVISION_LOG_INFO("Maxflow: update full/empty cells status.");
@@ -3328,6 +3438,7 @@ void DelaunayGraphCut::maxflow()
     ALICEVISION_LOG_WARNING("Maxflow full/nbCells: " << nbFullCells << " / " << nbCells);
 
     mvsUtils::printfElapsedTime(t_maxflow, "Full maxflow step");
+    ALICEVISION_LOG_INFO("Full maxflow step wall-clock time: " << timer.elapsed() << " s.");
 
     ALICEVISION_LOG_INFO("Maxflow: done.");
 }
@@ -8,6 +8,7 @@
 
 #include <aliceVision/system/Logger.hpp>
 #include <aliceVision/image/Rgb.hpp>
+#include <aliceVision/mvsData/CompactJaggedArray.hpp>
 #include <aliceVision/mvsData/Point3d.hpp>
 #include <aliceVision/mvsData/StaticVector.hpp>
 #include <aliceVision/mvsData/Voxel.hpp>
@@ -23,6 +24,7 @@
 
 #include <map>
 #include <set>
+#include <string>
 
 namespace aliceVision {
 
@@ -57,6 +59,11 @@ struct FuseParams
     // Weight for helper points from mask. Do not create helper points if zero.
     float maskHelperPointsWeight = 0.0;
     int maskBorderSize = 1;
+    /// Max number of cameras depth maps kept in memory during the fusion
+    int maxNbCachedDepthMaps = 12;
+    /// Binary file of the fused points (see writeFusedPoints). If it exists, the points are read from it instead of
+    /// fusing the depth maps, else the fusion result is written in it. Not used if empty.
+    std::string fusedPointsFilepath;
 };
 
 class DelaunayGraphCut
@@ -193,6 +200,52 @@ class DelaunayGraphCut
         }
     };
 
+    /**
+     * @brief Thread-local buffer of the votes on the cells weights during fillGraph.
+     * @note Votes are recorded without any synchronization, then sorted by cell, merged and applied
+     *       to the shared cells weights in batches (see flushCellVotes), so each cell weight receives
+     *       a single atomic update per batch instead of one per ray step.
+     */
+    struct CellVotesBuffer
+    {
+        /// cell weight receiving the vote
+        enum class EField : std::uint8_t
+        {
+            cellSWeight = 0,  //< set (not accumulated)
+            cellTWeight,
+            gEdgeVisWeight0,  //< gEdgeVisWeight[i] is gEdgeVisWeight0 + i
+            gEdgeVisWeight1,
+            gEdgeVisWeight2,
+            gEdgeVisWeight3,
+            fullnessScore,
+            emptinessScore,
+            on
+        };
+
+        struct Vote
+        {
+            CellIndex cellIndex;
+            EField field;
+            float value;
+        };
+
+        explicit CellVotesBuffer(std::size_t maxNbVotes)
+          : capacity(maxNbVotes)
+        {
+            votes.reserve(capacity);
+        }
+
+        inline void add(CellIndex cellIndex, EField field, float value) { votes.push_back({cellIndex, field, value}); }
+        inline void addEdgeVis(CellIndex cellIndex, VertexIndex localVertexIndex, float value)
+        {
+            votes.push_back({cellIndex, static_cast<EField>(static_cast<int>(EField::gEdgeVisWeight0) + localVertexIndex), value});
+        }
+        inline bool isFull() const { return votes.size() >= capacity; }
+
+        std::vector<Vote> votes;
+        std::size_t capacity;
+    };
+
     mvsUtils::MultiViewParams& _mp;
 
     GEO::Delaunay_var _tetrahedralization;
@@ -386,7 +439,7 @@ class DelaunayGraphCut
     void saveDh(const std::string& fileNameDh, const std::string& fileNameInfo);
 
     StaticVector<StaticVector<int>*>* createPtsCams();
-    void createPtsCams(StaticVector<StaticVector<int>>& out_ptsCams);
+    void createPtsCams(CompactJaggedArray<int>& out_ptsCams);
     StaticVector<int>* getPtsCamsHist();
     StaticVector<int>* getPtsNrcHist();
     StaticVector<int> getIsUsedPerCamera() const;
@@ -469,7 +522,16 @@ class DelaunayGraphCut
     float weightFcn(float nrc, bool labatutWeights, int ncams);
 
     void fillGraph(double nPixelSizeBehind, bool labatutWeights, bool fillOut, float distFcnHeight, float fullWeight);
-    void fillGraphPartPtRc(int& out_nstepsFront,
+
+    /**
+     * @brief Apply the buffered votes to the cells weights and clear the buffer.
+     * @note Thread-safe, can be called concurrently with different buffers.
+     * @param[in,out] buffer the thread-local votes buffer
+     */
+    void flushCellVotes(CellVotesBuffer& buffer);
+
+    void fillGraphPartPtRc(CellVotesBuffer& votes,
+                           int& out_nstepsFront,
                            int& out_nstepsBehind,
                            GeometriesCount& outFrontCount,
                            GeometriesCount& outBehindCount,
@@ -492,8 +554,18 @@ class DelaunayGraphCut
 
     void addToInfiniteSw(float sW);
 
+    /**
+     * @brief Compute the graph cut of the cells, with the max-flow solver selected by "delaunaycut.maxflowSolver".
+     */
     void maxflow();
 
+    /**
+     * @brief Fill the given max-flow graph from the cells weights, compute it and update the full/empty cells status.
+     * @note MaxFlowGraph is one of MaxFlow_AdjList, MaxFlow_CSR or MaxFlow_PushRelabel.
+     */
+    template<class MaxFlowGraph>
+    void maxflowCompute();
+
     void voteFullEmptyScore(const StaticVector<int>& cams, const std::string& folderName);
 
     void createDensePointCloud(const Point3d hexah[8],
@@ -0,0 +1,228 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2023 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "DepthMapsFusion.hpp"
+
+#include <aliceVision/system/Logger.hpp>
+#include <aliceVision/mvsUtils/common.hpp>
+#include <aliceVision/mvsUtils/fileIO.hpp>
+#include <aliceVision/mvsUtils/mapIO.hpp>
+#include <aliceVision/image/io.hpp>
+
+#include <boost/filesystem.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <limits>
+#include <stdexcept>
+
+namespace aliceVision {
+namespace fuseCut {
+
+namespace {
+/// "AVFP" fused points file signature
+const std::uint32_t fusedPointsFileMagic = 0x50465641;
+const std::uint32_t fusedPointsFileVersion = 1;
+}  // namespace
+
+DepthMapsCache::DepthMapsCache(const mvsUtils::MultiViewParams& mp, int maxNbCameras)
+  : _mp(mp),
+    _maxNbCameras(std::max(maxNbCameras, 1))
+{}
+
+std::shared_ptr<const CameraDepthMaps> DepthMapsCache::get(int rc, bool loadNmodMap)
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto it = _entries.find(rc);
+        if (it != _entries.end() && (!loadNmodMap || it->second.maps->hasNmodMap() || it->second.maps->depthMap.size() == 0))
+        {
+            _lru.splice(_lru.begin(), _lru, it->second.lruIt);
+            return it->second.maps;
+        }
+    }
+
+    // load outside of the lock, so the cameras are loaded in parallel
+    auto maps = std::make_shared<CameraDepthMaps>();
+    load(rc, loadNmodMap, *maps);
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    ++_nbLoads;
+
+    auto it = _entries.find(rc);
+    if (it != _entries.end())
+    {
+        // loaded meanwhile by another thread or without the nmod map, replace it
+        it->second.maps = maps;
+        _lru.splice(_lru.begin(), _lru, it->second.lruIt);
+        return maps;
+    }
+
+    while (_entries.size() >= static_cast<std::size_t>(_maxNbCameras))
+    {
+        _entries.erase(_lru.back());
+        _lru.pop_back();
+    }
+
+    _lru.push_front(rc);
+    _entries[rc] = {maps, _lru.begin()};
+    return maps;
+}
+
+void DepthMapsCache::load(int rc, bool loadNmodMap, CameraDepthMaps& out_maps) const
+{
+    const int width = _mp.getWidth(rc);
+    const int height = _mp.getHeight(rc);
+
+    // read depth map
+    mvsUtils::readMap(rc, _mp, mvsUtils::EFileType::depthMapFiltered, out_maps.depthMap);
+
+    if (out_maps.depthMap.size() <= 0)
+    {
+        ALICEVISION_LOG_WARNING("Empty depth map (cam id: " << rc << ")");
+        return;
+    }
+
+    // read similarity map
+    try
+    {
+        mvsUtils::readMap(rc, _mp, mvsUtils::EFileType::simMapFiltered, out_maps.simMap);
+    }
+    catch (const std::exception& e)
+    {
+        ALICEVISION_LOG_WARNING("simMap file can't be found (cam id: " << rc << ").");
+        out_maps.simMap = image::Image<float>();
+    }
+
+    if (!loadNmodMap)
+        return;
+
+    // read nmod map
+    const std::string nmodMapFilepath = mvsUtils::getFileNameFromIndex(_mp, rc, mvsUtils::EFileType::nmodMap);
+    if (boost::filesystem::exists(nmodMapFilepath))
+    {
+        image::readImage(nmodMapFilepath, out_maps.nmodMap, image::EImageColorSpace::NO_CONVERSION);
+        if (out_maps.nmodMap.Width() != width || out_maps.nmodMap.Height() != height)
+            throw std::runtime_error("Wrong nmod map dimensions: " + nmodMapFilepath);
+    }
+    else
+    {
+        ALICEVISION_LOG_WARNING("nModMap file can't be found: " << nmodMapFilepath);
+        // constant value, so the nmod map is not requested again
+        out_maps.nmodMap.resize(width, height, true, 1);
+    }
+}
+
+std::vector<int> computeCamerasVisitOrder(const std::vector<Point3d>& camCenters, const StaticVector<int>& cams)
+{
+    std::vector<int> order;
+    order.reserve(cams.size());
+    if (cams.empty())
+        return order;
+
+    std::vector<bool> visited(cams.size(), false);
+    int current = 0;
+    visited[current] = true;
+    order.push_back(cams[current]);
+
+    for (int i = 1; i < cams.size(); ++i)
+    {
+        const Point3d& c = camCenters[cams[current]];
+        double bestDist = std::numeric_limits<double>::max();
+        int best = -1;
+        for (int j = 0; j < cams.size(); ++j)
+        {
+            if (visited[j])
+                continue;
+            const double dist = (camCenters[cams[j]] - c).size2();
+            if (dist < bestDist)
+            {
+                bestDist = dist;
+                best = j;
+            }
+        }
+        current = best;
+        visited[current] = true;
+        order.push_back(cams[current]);
+    }
+    return order;
+}
+
+void writeFusedPoints(const std::string& filepath, const std::vector<Point3d>& verticesCoords, const std::vector<GC_vertexInfo>& verticesAttr)
+{
+    if (verticesCoords.size() != verticesAttr.size())
+        throw std::invalid_argument("writeFusedPoints: points coordinates and attributes sizes differ.");
+
+    ALICEVISION_LOG_INFO("Write " << verticesCoords.size() << " fused points: " << filepath);
+
+    FILE* f = fopen(filepath.c_str(), "wb");
+    if (f == nullptr)
+        ALICEVISION_THROW_ERROR("Cannot open fused points file: " << filepath);
+
+    const std::uint64_t nbPoints = verticesCoords.size();
+    fwrite(&fusedPointsFileMagic, sizeof(std::uint32_t), 1, f);
+    fwrite(&fusedPointsFileVersion, sizeof(std::uint32_t), 1, f);
+    fwrite(&nbPoints, sizeof(std::uint64_t), 1, f);
+    for (std::size_t i = 0; i < verticesCoords.size(); ++i)
+    {
+        fwrite(verticesCoords[i].m, sizeof(double), 3, f);
+        verticesAttr[i].fwriteinfo(f);
+    }
+
+    const bool error = ferror(f) != 0;
+    fclose(f);
+    if (error)
+        ALICEVISION_THROW_ERROR("Failed to write fused points file: " << filepath);
+}
+
+std::size_t readFusedPoints(const std::string& filepath,
+                            const Point3d* hexah,
+                            std::vector<Point3d>& verticesCoords,
+                            std::vector<GC_vertexInfo>& verticesAttr)
+{
+    FILE* f = fopen(filepath.c_str(), "rb");
+    if (f == nullptr)
+        ALICEVISION_THROW_ERROR("Cannot open fused points file: " << filepath);
+
+    std::uint32_t magic = 0;
+    std::uint32_t version = 0;
+    std::uint64_t nbPoints = 0;
+    if (fread(&magic, sizeof(std::uint32_t), 1, f) != 1 || fread(&version, sizeof(std::uint32_t), 1, f) != 1 ||
+        fread(&nbPoints, sizeof(std::uint64_t), 1, f) != 1 || magic != fusedPointsFileMagic || version != fusedPointsFileVersion)
+    {
+        fclose(f);
+        ALICEVISION_THROW_ERROR("Invalid fused points file: " << filepath);
+    }
+
+    std::size_t nbKeptPoints = 0;
+    for (std::uint64_t i = 0; i < nbPoints; ++i)
+    {
+        Point3d p;
+        GC_vertexInfo v;
+        if (fread(p.m, sizeof(double), 3, f) != 3)
+            break;
+        v.freadinfo(f);
+
+        if (hexah != nullptr && !mvsUtils::isPointInHexahedron(p, hexah))
+            continue;
+
+        verticesCoords.push_back(p);
+        verticesAttr.push_back(std::move(v));
+        ++nbKeptPoints;
+    }
+
+    const bool error = (ferror(f) != 0) || (feof(f) != 0);
+    fclose(f);
+    if (error)
+        ALICEVISION_THROW_ERROR("Truncated fused points file: " << filepath);
+
+    ALICEVISION_LOG_INFO(nbKeptPoints << " fused points read (" << nbPoints << " in file): " << filepath);
+    return nbKeptPoints;
+}
+
+}  // namespace fuseCut
+}  // namespace aliceVision
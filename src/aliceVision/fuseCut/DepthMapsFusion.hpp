@@ -0,0 +1,115 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2023 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <aliceVision/fuseCut/delaunayGraphCutTypes.hpp>
+#include <aliceVision/image/Image.hpp>
+#include <aliceVision/mvsData/Point3d.hpp>
+#include <aliceVision/mvsData/StaticVector.hpp>
+#include <aliceVision/mvsUtils/MultiViewParams.hpp>
+
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace aliceVision {
+namespace fuseCut {
+
+/**
+ * @brief Filtered depth map of a camera and its associated maps, as loaded from disk.
+ */
+struct CameraDepthMaps
+{
+    image::Image<float> depthMap;
+    /// raw similarity map (without any gaussian filtering), empty if there is no similarity map file
+    image::Image<float> simMap;
+    /// number of modals map, empty if there is no nmod map file
+    image::Image<unsigned char> nmodMap;
+
+    inline bool hasSimMap() const { return simMap.size() > 0; }
+    inline bool hasNmodMap() const { return nmodMap.size() > 0; }
+};
+
+/**
+ * @brief Thread-safe least recently used cache of the loaded camera depth maps.
+ *
+ * @note The depth maps fusion reads each depth map several times (points selection, visibilities, refinement).
+ *       The cache bounds the number of depth maps in memory, whatever the number of cameras.
+ *       Maps are shared, so an evicted map stays valid until its last user releases it:
+ *       the real bound is the cache size plus the number of concurrent users.
+ */
+class DepthMapsCache
+{
+  public:
+    DepthMapsCache(const mvsUtils::MultiViewParams& mp, int maxNbCameras);
+
+    /**
+     * @brief Get the maps of the given camera, load them if needed.
+     * @param[in] rc the camera index
+     * @param[in] loadNmodMap load the number of modals map if not already in the cache
+     * @return the camera maps, the depth map is empty if the camera has no depth map
+     */
+    std::shared_ptr<const CameraDepthMaps> get(int rc, bool loadNmodMap = false);
+
+    inline int getMaxNbCameras() const { return _maxNbCameras; }
+    inline std::size_t getNbLoads() const { return _nbLoads; }
+
+  private:
+    void load(int rc, bool loadNmodMap, CameraDepthMaps& out_maps) const;
+
+    struct Entry
+    {
+        std::shared_ptr<const CameraDepthMaps> maps;
+        std::list<int>::iterator lruIt;
+    };
+
+    const mvsUtils::MultiViewParams& _mp;
+    const int _maxNbCameras;
+    std::mutex _mutex;
+    /// cameras from the most recently used to the least recently used one
+    std::list<int> _lru;
+    std::map<int, Entry> _entries;
+    std::size_t _nbLoads = 0;
+};
+
+/**
+ * @brief Sort the cameras to visit them in a visibility-coherent order:
+ *        each camera is followed by its nearest camera (by camera center) not yet visited.
+ * @note Consecutive cameras share most of their visibility, so they access the same points
+ *       and a small depth maps cache is reused when the fusion passes alternate the order direction.
+ * @param[in] camCenters the centers of all cameras
+ * @param[in] cams the cameras to visit
+ * @return the cameras in the visit order
+ */
+std::vector<int> computeCamerasVisitOrder(const std::vector<Point3d>& camCenters, const StaticVector<int>& cams);
+
+/**
+ * @brief Write the fused points and their visibilities in a binary file.
+ * @note The Delaunay tetrahedralization can read them back with readFusedPoints instead of fusing the depth maps again.
+ */
+void writeFusedPoints(const std::string& filepath, const std::vector<Point3d>& verticesCoords, const std::vector<GC_vertexInfo>& verticesAttr);
+
+/**
+ * @brief Read the fused points from a binary file written by writeFusedPoints and append them.
+ * @note The file is read sequentially and only the points inside the hexahedron are kept,
+ *       so the memory does not depend on the size of the file.
+ * @param[in] filepath the fused points file
+ * @param[in] hexah the hexahedron to keep the points inside, all points are kept if nullptr
+ * @param[in,out] verticesCoords the points coordinates
+ * @param[in,out] verticesAttr the points visibilities
+ * @return number of points kept
+ */
+std::size_t readFusedPoints(const std::string& filepath,
+                            const Point3d* hexah,
+                            std::vector<Point3d>& verticesCoords,
+                            std::vector<GC_vertexInfo>& verticesAttr);
+
+}  // namespace fuseCut
+}  // namespace aliceVision
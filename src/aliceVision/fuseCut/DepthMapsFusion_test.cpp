@@ -0,0 +1,84 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2023 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <aliceVision/fuseCut/DepthMapsFusion.hpp>
+
+#include <boost/filesystem.hpp>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#define BOOST_TEST_MODULE fuseCut_depthMapsFusion
+
+#include <boost/test/unit_test.hpp>
+
+using namespace aliceVision;
+using namespace aliceVision::fuseCut;
+
+BOOST_AUTO_TEST_CASE(fuseCut_camerasVisitOrder)
+{
+    // cameras on a line, in a shuffled order
+    const std::vector<Point3d> camCenters = {{0.0, 0.0, 0.0}, {4.0, 0.0, 0.0}, {1.0, 0.0, 0.0}, {3.0, 0.0, 0.0}, {2.0, 0.0, 0.0}, {10.0, 0.0, 0.0}};
+
+    StaticVector<int> cams;
+    for (int c : {0, 1, 2, 3, 4})
+        cams.push_back(c);
+
+    const std::vector<int> order = computeCamerasVisitOrder(camCenters, cams);
+    BOOST_CHECK((order == std::vector<int>{0, 2, 4, 3, 1}));
+
+    BOOST_CHECK(computeCamerasVisitOrder(camCenters, StaticVector<int>()).empty());
+}
+
+BOOST_AUTO_TEST_CASE(fuseCut_fusedPoints_io)
+{
+    std::vector<Point3d> verticesCoords;
+    std::vector<GC_vertexInfo> verticesAttr;
+    for (int i = 0; i < 10; ++i)
+    {
+        verticesCoords.emplace_back(double(i), 0.5, 0.5);
+        GC_vertexInfo v;
+        v.pixSize = 0.1f * i;
+        v.nrc = i;
+        for (int c = 0; c < i % 3; ++c)
+            v.cams.push_back(c);
+        verticesAttr.push_back(v);
+    }
+
+    const std::string filepath = (boost::filesystem::temp_directory_path() / "fuseCut_fusedPoints_test.bin").string();
+    writeFusedPoints(filepath, verticesCoords, verticesAttr);
+
+    // read all points
+    {
+        std::vector<Point3d> readCoords;
+        std::vector<GC_vertexInfo> readAttr;
+        BOOST_CHECK_EQUAL(readFusedPoints(filepath, nullptr, readCoords, readAttr), verticesCoords.size());
+        BOOST_REQUIRE_EQUAL(readCoords.size(), verticesCoords.size());
+        BOOST_REQUIRE_EQUAL(readAttr.size(), verticesAttr.size());
+        for (std::size_t i = 0; i < verticesCoords.size(); ++i)
+        {
+            BOOST_CHECK(readCoords[i] == verticesCoords[i]);
+            BOOST_CHECK_EQUAL(readAttr[i].pixSize, verticesAttr[i].pixSize);
+            BOOST_CHECK_EQUAL(readAttr[i].nrc, verticesAttr[i].nrc);
+            BOOST_CHECK(readAttr[i].cams.getData() == verticesAttr[i].cams.getData());
+        }
+    }
+
+    // read the points inside the box [2.5, 5.5] x [0, 1] x [0, 1]
+    {
+        const Point3d hexah[8] = {{2.5, 0.0, 0.0}, {5.5, 0.0, 0.0}, {5.5, 1.0, 0.0}, {2.5, 1.0, 0.0},
+                                  {2.5, 0.0, 1.0}, {5.5, 0.0, 1.0}, {5.5, 1.0, 1.0}, {2.5, 1.0, 1.0}};
+        std::vector<Point3d> readCoords;
+        std::vector<GC_vertexInfo> readAttr;
+        BOOST_CHECK_EQUAL(readFusedPoints(filepath, hexah, readCoords, readAttr), 3);
+        BOOST_REQUIRE_EQUAL(readCoords.size(), 3);
+        BOOST_CHECK(readCoords.front() == verticesCoords[3]);
+        BOOST_CHECK_EQUAL(readAttr.back().nrc, 5);
+    }
+
+    boost::filesystem::remove(filepath);
+}
@@ -6,6 +6,7 @@
 
 #include <aliceVision/sfmData/SfMData.hpp>
 #include <aliceVision/fuseCut/LargeScale.hpp>
+#include <aliceVision/fuseCut/ReconstructionPlan.hpp>
 
 #include <string>
 
@@ -44,3 +45,33 @@ BOOST_AUTO_TEST_CASE(fuseCut_largeScale_io)
     BOOST_CHECK_EQUAL(ls.dimensions, newLs.dimensions);
     BOOST_CHECK_EQUAL(ls.maxOcTreeDim, newLs.maxOcTreeDim);
 }
+
+BOOST_AUTO_TEST_CASE(fuseCut_tilesGridDimensions)
+{
+    // 4 x 2 x 1 box
+    const Point3d hexah[8] = {
+      {0.0, 0.0, 0.0},
+      {4.0, 0.0, 0.0},
+      {4.0, 2.0, 0.0},
+      {0.0, 2.0, 0.0},
+      {0.0, 0.0, 1.0},
+      {4.0, 0.0, 1.0},
+      {4.0, 2.0, 1.0},
+      {0.0, 2.0, 1.0},
+    };
+
+    const Voxel single = computeTilesGridDimensions(hexah, 1);
+    BOOST_CHECK_EQUAL(single.x * single.y * single.z, 1);
+
+    // the longest side is divided first
+    const Voxel two = computeTilesGridDimensions(hexah, 2);
+    BOOST_CHECK_EQUAL(two.x, 2);
+    BOOST_CHECK_EQUAL(two.y, 1);
+    BOOST_CHECK_EQUAL(two.z, 1);
+
+    // cubic tiles
+    const Voxel eight = computeTilesGridDimensions(hexah, 8);
+    BOOST_CHECK_EQUAL(eight.x, 4);
+    BOOST_CHECK_EQUAL(eight.y, 2);
+    BOOST_CHECK_EQUAL(eight.z, 1);
+}
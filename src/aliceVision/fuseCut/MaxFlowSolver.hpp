@@ -0,0 +1,62 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2023 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+namespace aliceVision {
+namespace fuseCut {
+
+/**
+ * @brief Max-flow solver used for the graph cut of the Delaunay tetrahedralization.
+ */
+enum class EMaxFlowSolver
+{
+    BOYKOV_KOLMOGOROV = 0,  //< boost Boykov-Kolmogorov on an adjacency list graph, single-threaded (see MaxFlow_AdjList)
+    BOYKOV_KOLMOGOROV_CSR,  //< boost Boykov-Kolmogorov on a compact 32-bit CSR graph, single-threaded, lower memory peak (see MaxFlow_CSR)
+    PUSH_RELABEL            //< synchronous push-relabel, multi-threaded (see MaxFlow_PushRelabel)
+};
+
+inline std::string EMaxFlowSolver_enumToString(EMaxFlowSolver solver)
+{
+    switch (solver)
+    {
+        case EMaxFlowSolver::BOYKOV_KOLMOGOROV:
+            return "boykovKolmogorov";
+        case EMaxFlowSolver::BOYKOV_KOLMOGOROV_CSR:
+            return "boykovKolmogorovCSR";
+        case EMaxFlowSolver::PUSH_RELABEL:
+            return "pushRelabel";
+    }
+    throw std::out_of_range("Invalid max-flow solver enum");
+}
+
+inline EMaxFlowSolver EMaxFlowSolver_stringToEnum(const std::string& solver)
+{
+    if (solver == "boykovKolmogorov")
+        return EMaxFlowSolver::BOYKOV_KOLMOGOROV;
+    if (solver == "boykovKolmogorovCSR")
+        return EMaxFlowSolver::BOYKOV_KOLMOGOROV_CSR;
+    if (solver == "pushRelabel")
+        return EMaxFlowSolver::PUSH_RELABEL;
+    throw std::out_of_range("Invalid max-flow solver: " + solver);
+}
+
+inline std::ostream& operator<<(std::ostream& os, EMaxFlowSolver e) { return os << EMaxFlowSolver_enumToString(e); }
+
+inline std::istream& operator>>(std::istream& in, EMaxFlowSolver& solver)
+{
+    std::string token;
+    in >> token;
+    solver = EMaxFlowSolver_stringToEnum(token);
+    return in;
+}
+
+}  // namespace fuseCut
+}  // namespace aliceVision
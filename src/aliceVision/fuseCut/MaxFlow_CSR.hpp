@@ -14,9 +14,12 @@
 #include <boost/graph/adjacency_list.hpp>
 #include <boost/graph/compressed_sparse_row_graph.hpp>
 #include <boost/graph/boykov_kolmogorov_max_flow.hpp>
-#include <boost/container/flat_map.hpp>
 
 #include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
 
 namespace aliceVision {
 namespace fuseCut {
@@ -24,22 +27,24 @@ namespace fuseCut {
 /**
  * @brief Maxflow computation based on a compressed sparse row graph reprensentation.
  *
- * @note: The graph itself consumes much less memory than AdjList, but this improvement is
- * limited by the creation of the reverse edges which requires the creation of a temporary map.
- * The memory peak is still slightly better than AdjList version, but it would be great to find
- * another way to retrieve the reverse edges, as it could reduce a lot the required amount of memory.
+ * @note: The graph itself consumes much less memory than AdjList: vertices and edges are indexed on 32 bits
+ * and the capacities are stored as float.
+ * The CSR graph is built in-place from the input edges with a single counting-sort pass,
+ * and the reverse edges are retrieved from the input edge pairs (an edge and its reverse edge are always added together)
+ * instead of an intermediate map, so the memory peak is only slightly higher than the graph itself.
  */
 class MaxFlow_CSR
 {
   public:
     using NodeType = unsigned int;
+    using EdgeIndexType = unsigned int;
     using ValueType = float;
 
     using edge_descriptor = typename boost::compressed_sparse_row_graph<boost::directedS,
                                                                         boost::no_property,  // VertexProperty
                                                                         boost::no_property,  // EdgeProperty
-                                                                        unsigned int,        // Vertex
-                                                                        unsigned int         // EdgeIndex
+                                                                        NodeType,            // Vertex
+                                                                        EdgeIndexType        // EdgeIndex
                                                                         >::edge_descriptor;
 
     struct Vertex
@@ -63,13 +68,14 @@ class MaxFlow_CSR
 
         ValueType capacity{};
         ValueType residual{};
+        /// reverse edge, used to store the input edge index until the CSR graph is built
         edge_descriptor reverse{};
     };
     using Graph = boost::compressed_sparse_row_graph<boost::directedS,
                                                      Vertex,        // VertexProperty
                                                      Edge,          // EdgeProperty
-                                                     unsigned int,  // Vertex
-                                                     unsigned int   // EdgeIndex
+                                                     NodeType,      // Vertex
+                                                     EdgeIndexType  // EdgeIndex
                                                      >;
     using vertex_descriptor = typename Graph::vertex_descriptor;
     using vertex_size_type = typename Graph::vertices_size_type;
@@ -83,7 +89,8 @@ class MaxFlow_CSR
     {
         ALICEVISION_LOG_INFO("MaxFlow constructor.");
         const std::size_t nbEdgesEstimation = numNodes * 9 + numNodes * 2;
-        _edges.reserve(nbEdgesEstimation);
+        _sources.reserve(nbEdgesEstimation);
+        _targets.reserve(nbEdgesEstimation);
         _edgesData.reserve(nbEdgesEstimation);
     }
 
@@ -105,24 +112,32 @@ class MaxFlow_CSR
     {
         assert(capacity >= 0 && reverseCapacity >= 0);
 
-        // int edgeIndex = _edges.size();
-        _edges.push_back(std::make_pair(n1, n2));  // edge
+        // input index of the edge, its reverse edge is the next one
+        const std::size_t edgeIndex = _edgesData.size();
 
-        // int reverseEdgeIndex = _edges.size();
-        _edges.push_back(std::make_pair(n2, n1));  // reverse edge
+        _sources.push_back(n1);  // edge
+        _targets.push_back(n2);
 
-        ValueType defaultResidual = 0.0;
-        _edgesData.push_back(Edge(capacity, defaultResidual));         //, reverseEdgeIndex));
-        _edgesData.push_back(Edge(reverseCapacity, defaultResidual));  //, edgeIndex));
+        _sources.push_back(n2);  // reverse edge
+        _targets.push_back(n1);
+
+        const ValueType defaultResidual = 0.0;
+        _edgesData.push_back(Edge(capacity, defaultResidual, edge_descriptor(n1, EdgeIndexType(edgeIndex))));
+        _edgesData.push_back(Edge(reverseCapacity, defaultResidual, edge_descriptor(n2, EdgeIndexType(edgeIndex + 1))));
     }
 
     inline ValueType compute()
     {
         ALICEVISION_LOG_INFO("Compute boykov_kolmogorov_max_flow.");
 
-        Graph graph(boost::edges_are_unsorted_multi_pass, _edges.begin(), _edges.end(), _edgesData.begin(), _numNodes);
-        // Graph graph(boost::edges_are_unsorted, _edges.begin(), _edges.end(), _edgesData.begin(), _numNodes);
-        // Graph graph(boost::edges_are_sorted, _edges.begin(), _edges.end(), _edgesData.begin(), _numNodes);
+        if (_edgesData.size() > std::size_t(std::numeric_limits<EdgeIndexType>::max()))
+            throw std::runtime_error("MaxFlow_CSR: too many edges (" + std::to_string(_edgesData.size()) + ") for 32-bit edge indices.");
+
+        // in-place counting sort of the edges by source, the input vectors are swapped into the graph
+        Graph graph(boost::construct_inplace_from_sources_and_targets, _sources, _targets, _edgesData, _numNodes);
+        std::vector<NodeType>().swap(_sources);
+        std::vector<NodeType>().swap(_targets);
+        std::vector<Edge>().swap(_edgesData);
 
         const vertex_size_type nbVertices = boost::num_vertices(graph);
         const edges_size_type nbEdges = boost::num_edges(graph);
@@ -130,34 +145,19 @@ class MaxFlow_CSR
         ALICEVISION_LOG_INFO("# vertices: " << nbVertices);
         ALICEVISION_LOG_INFO("# edges: " << nbEdges);
 
-        /*
-        // Cannot be used as it is far too compute intensive
-        Graph::edge_iterator ei, ee;
-        for(boost::tie(ei, ee) = boost::edges(graph); ei != ee; ++ei)
-        {
-            Graph::vertex_descriptor v1 = boost::source(*ei, graph);
-            Graph::vertex_descriptor v2 = boost::target(*ei, graph);
-            std::pair<Graph::edge_descriptor, bool> opp_edge = boost::edge(v2, v1, graph); // VERY compute intensive
-
-            graph[opp_edge.first].reverse = *ei; // and edge_reverse of *ei will be (or already have been) set by the opp_edge
-        }
-        */
         {
-            // flat_map use less memory than std::map
-            // This step represent the memory peak, would be great to find a way to reduce it.
-            boost::container::flat_map<std::pair<Graph::vertex_descriptor, Graph::vertex_descriptor>, Graph::edge_descriptor> edgeDescriptors;
+            // input edge index to graph edge index
+            std::vector<EdgeIndexType> edgeIndexes(nbEdges);
             Graph::edge_iterator ei, ee;
             for (boost::tie(ei, ee) = boost::edges(graph); ei != ee; ++ei)
             {
-                Graph::vertex_descriptor v1 = boost::source(*ei, graph);
-                Graph::vertex_descriptor v2 = boost::target(*ei, graph);
-                edgeDescriptors[std::make_pair(v1, v2)] = *ei;
+                edgeIndexes[graph[*ei].reverse.idx] = ei->idx;
             }
+            // input edges are added by pair (edge, reverse edge)
             for (boost::tie(ei, ee) = boost::edges(graph); ei != ee; ++ei)
             {
-                Graph::vertex_descriptor v1 = boost::source(*ei, graph);
-                Graph::vertex_descriptor v2 = boost::target(*ei, graph);
-                graph[*ei].reverse = edgeDescriptors[std::make_pair(v2, v1)];
+                const EdgeIndexType reverseInputIndex = graph[*ei].reverse.idx ^ 1;
+                graph[*ei].reverse = edge_descriptor(boost::target(*ei, graph), edgeIndexes[reverseInputIndex]);
             }
         }
         ALICEVISION_LOG_INFO("boykov_kolmogorov_max_flow: start.");
@@ -190,7 +190,8 @@ class MaxFlow_CSR
 
   protected:
     std::size_t _numNodes;
-    std::vector<std::pair<std::size_t, std::size_t>> _edges;
+    std::vector<NodeType> _sources;
+    std::vector<NodeType> _targets;
     std::vector<Edge> _edgesData;
     std::vector<bool> _isTarget;
     const NodeType _S;  //< emptyness
@@ -0,0 +1,313 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2023 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "MaxFlow_PushRelabel.hpp"
+
+#include <aliceVision/system/Logger.hpp>
+#include <aliceVision/alicevision_omp.hpp>
+
+#include <boost/atomic/atomic_ref.hpp>
+
+#include <algorithm>
+
+namespace aliceVision {
+namespace fuseCut {
+
+MaxFlow_PushRelabel::ValueType MaxFlow_PushRelabel::compute()
+{
+    ALICEVISION_LOG_INFO("Compute push-relabel max flow (" << omp_get_max_threads() << " threads).");
+
+    buildResidualGraph();
+
+    ALICEVISION_LOG_INFO("# vertices: " << _numNodes << ", # arcs: " << _arcHead.size());
+
+    _maxHeight = NodeType(_numNodes + 1);
+    _height.assign(_numNodes, _maxHeight);
+    _addedExcess.assign(_numNodes, 0.0f);
+    _isActive.assign(_numNodes, 0);
+    _activeNodes.clear();
+
+    double flow = 0.0;
+    std::size_t nbRounds = 0;
+    std::size_t nbGlobalRelabels = 0;
+
+    while (true)
+    {
+        for (const NodeType n : _activeNodes)
+            _isActive[n] = 0;
+        _activeNodes.clear();
+
+        // heights drift away from the exact distances to the sink after many relabels, recompute them
+        globalRelabel();
+        ++nbGlobalRelabels;
+
+#pragma omp parallel
+        {
+            std::vector<NodeType> localActiveNodes;
+
+#pragma omp for nowait
+            for (std::int64_t i = 0; i < std::int64_t(_numNodes); ++i)
+            {
+                if (_excess[i] > 0.0f && _height[i] < _maxHeight)
+                    localActiveNodes.push_back(NodeType(i));
+            }
+
+#pragma omp critical
+            _activeNodes.insert(_activeNodes.end(), localActiveNodes.begin(), localActiveNodes.end());
+        }
+
+        if (_activeNodes.empty())
+            break;
+
+        for (const NodeType n : _activeNodes)
+            _isActive[n] = 1;
+
+        std::size_t work = 0;
+        while (!_activeNodes.empty() && work < _numNodes)
+        {
+            work += _activeNodes.size();
+            flow += pushRelabelRound();
+            ++nbRounds;
+        }
+    }
+
+    ALICEVISION_LOG_INFO("Push-relabel: " << nbRounds << " rounds, " << nbGlobalRelabels << " global relabels.");
+
+    // minimum cut: the last global relabel gives the nodes that can reach the sink in the residual graph
+    _isTarget.resize(_numNodes);
+    for (std::size_t n = 0; n < _numNodes; ++n)
+        _isTarget[n] = (_height[n] < _maxHeight);
+
+    // free the residual graph
+    std::vector<ArcIndex>().swap(_firstArc);
+    std::vector<NodeType>().swap(_arcHead);
+    std::vector<ArcIndex>().swap(_arcReverse);
+    std::vector<ValueType>().swap(_arcResidual);
+    std::vector<ValueType>().swap(_addedExcess);
+    std::vector<NodeType>().swap(_height);
+    std::vector<NodeType>().swap(_activeNodes);
+    std::vector<std::uint8_t>().swap(_isActive);
+
+    return ValueType(flow);
+}
+
+void MaxFlow_PushRelabel::buildResidualGraph()
+{
+    _firstArc.assign(_numNodes + 1, 0);
+    for (const InputEdge& e : _inputEdges)
+    {
+        ++_firstArc[e.n1 + 1];
+        ++_firstArc[e.n2 + 1];
+    }
+    for (std::size_t n = 0; n < _numNodes; ++n)
+        _firstArc[n + 1] += _firstArc[n];
+
+    const std::size_t nbArcs = _firstArc[_numNodes];
+    _arcHead.resize(nbArcs);
+    _arcReverse.resize(nbArcs);
+    _arcResidual.resize(nbArcs);
+
+    std::vector<ArcIndex> nextArc(_firstArc.begin(), _firstArc.end() - 1);
+    for (const InputEdge& e : _inputEdges)
+    {
+        const ArcIndex a1 = nextArc[e.n1]++;
+        const ArcIndex a2 = nextArc[e.n2]++;
+
+        _arcHead[a1] = e.n2;
+        _arcReverse[a1] = a2;
+        _arcResidual[a1] = e.capacity;
+
+        _arcHead[a2] = e.n1;
+        _arcReverse[a2] = a1;
+        _arcResidual[a2] = e.reverseCapacity;
+    }
+
+    std::vector<InputEdge>().swap(_inputEdges);  // force clear to free some RAM
+}
+
+void MaxFlow_PushRelabel::globalRelabel()
+{
+    // level-synchronous parallel breadth-first search from the sink on the reverse residual arcs
+    std::vector<NodeType> frontier;
+
+#pragma omp parallel
+    {
+        std::vector<NodeType> localFrontier;
+
+#pragma omp for nowait
+        for (std::int64_t i = 0; i < std::int64_t(_numNodes); ++i)
+        {
+            if (_sinkResidual[i] > 0.0f)
+            {
+                _height[i] = 1;
+                localFrontier.push_back(NodeType(i));
+            }
+            else
+            {
+                _height[i] = _maxHeight;
+            }
+        }
+
+#pragma omp critical
+        frontier.insert(frontier.end(), localFrontier.begin(), localFrontier.end());
+    }
+
+    NodeType level = 1;
+    std::vector<NodeType> nextFrontier;
+
+    while (!frontier.empty())
+    {
+        nextFrontier.clear();
+
+#pragma omp parallel
+        {
+            std::vector<NodeType> localFrontier;
+
+#pragma omp for schedule(dynamic, 256) nowait
+            for (std::int64_t i = 0; i < std::int64_t(frontier.size()); ++i)
+            {
+                const NodeType v = frontier[i];
+                for (ArcIndex a = _firstArc[v]; a < _firstArc[v + 1]; ++a)
+                {
+                    // u can push to v through the reverse arc
+                    if (_arcResidual[_arcReverse[a]] <= 0.0f)
+                        continue;
+
+                    const NodeType u = _arcHead[a];
+                    boost::atomic_ref<NodeType> uHeight{_height[u]};
+                    NodeType expected = _maxHeight;
+                    if (uHeight.load(boost::memory_order_relaxed) == _maxHeight && uHeight.compare_exchange_strong(expected, level + 1))
+                        localFrontier.push_back(u);
+                }
+            }
+
+#pragma omp critical
+            nextFrontier.insert(nextFrontier.end(), localFrontier.begin(), localFrontier.end());
+        }
+
+        frontier.swap(nextFrontier);
+        ++level;
+    }
+}
+
+double MaxFlow_PushRelabel::pushRelabelRound()
+{
+    const std::int64_t nbActiveNodes = std::int64_t(_activeNodes.size());
+
+    std::vector<NodeType> newHeights(nbActiveNodes);
+    std::vector<NodeType> receivers;
+    double sinkFlow = 0.0;
+
+    // Push: only the active node u writes the residual capacities of its arcs and of their reverse arcs
+    // to the lower nodes v (height(v) + 1 == height(u)), which cannot push back to u during this round.
+    // The excess received is accumulated in _addedExcess, so the excess of the active nodes is not shared.
+#pragma omp parallel
+    {
+        std::vector<NodeType> localReceivers;
+
+#pragma omp for schedule(dynamic, 256) reduction(+ : sinkFlow)
+        for (std::int64_t i = 0; i < nbActiveNodes; ++i)
+        {
+            const NodeType u = _activeNodes[i];
+            const NodeType uHeight = _height[u];
+            ValueType e = _excess[u];
+
+            if (_sinkResidual[u] > 0.0f)
+            {
+                const ValueType delta = std::min(e, _sinkResidual[u]);
+                _sinkResidual[u] -= delta;
+                e -= delta;
+                sinkFlow += delta;
+            }
+
+            for (ArcIndex a = _firstArc[u]; a < _firstArc[u + 1] && e > 0.0f; ++a)
+            {
+                const NodeType v = _arcHead[a];
+                if (_height[v] + 1 != uHeight || _arcResidual[a] <= 0.0f)
+                    continue;
+
+                const ValueType delta = std::min(e, _arcResidual[a]);
+                _arcResidual[a] -= delta;
+                _arcResidual[_arcReverse[a]] += delta;
+                e -= delta;
+
+                // first excess received by an inactive node during this round
+                if (boost::atomic_ref<ValueType>{_addedExcess[v]}.fetch_add(delta) == 0.0f && !_isActive[v])
+                    localReceivers.push_back(v);
+            }
+
+            _excess[u] = e;
+        }
+
+        // Relabel: new heights are computed from the heights of the push step
+#pragma omp for schedule(dynamic, 256)
+        for (std::int64_t i = 0; i < nbActiveNodes; ++i)
+        {
+            const NodeType u = _activeNodes[i];
+            NodeType h = _height[u];
+            if (_excess[u] > 0.0f)
+            {
+                h = _maxHeight;
+                for (ArcIndex a = _firstArc[u]; a < _firstArc[u + 1]; ++a)
+                {
+                    if (_arcResidual[a] > 0.0f)
+                        h = std::min(h, NodeType(_height[_arcHead[a]] + 1));
+                }
+                h = std::min(h, _maxHeight);
+            }
+            newHeights[i] = h;
+        }
+
+#pragma omp for
+        for (std::int64_t i = 0; i < nbActiveNodes; ++i)
+            _height[_activeNodes[i]] = newHeights[i];
+
+#pragma omp critical
+        receivers.insert(receivers.end(), localReceivers.begin(), localReceivers.end());
+    }
+
+    // Update the active nodes list
+    std::vector<NodeType> nextActiveNodes;
+    nextActiveNodes.reserve(_activeNodes.size() + receivers.size());
+
+#pragma omp parallel
+    {
+        std::vector<NodeType> localActiveNodes;
+
+#pragma omp for nowait
+        for (std::int64_t i = 0; i < nbActiveNodes; ++i)
+        {
+            const NodeType u = _activeNodes[i];
+            _excess[u] += _addedExcess[u];
+            _addedExcess[u] = 0.0f;
+            _isActive[u] = 0;
+            if (_excess[u] > 0.0f && _height[u] < _maxHeight)
+                localActiveNodes.push_back(u);
+        }
+
+#pragma omp for nowait
+        for (std::int64_t i = 0; i < std::int64_t(receivers.size()); ++i)
+        {
+            const NodeType v = receivers[i];
+            _excess[v] += _addedExcess[v];
+            _addedExcess[v] = 0.0f;
+            localActiveNodes.push_back(v);
+        }
+
+#pragma omp critical
+        nextActiveNodes.insert(nextActiveNodes.end(), localActiveNodes.begin(), localActiveNodes.end());
+    }
+
+    for (const NodeType n : nextActiveNodes)
+        _isActive[n] = 1;
+
+    _activeNodes.swap(nextActiveNodes);
+
+    return sinkFlow;
+}
+
+}  // namespace fuseCut
+}  // namespace aliceVision
@@ -0,0 +1,118 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2023 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace aliceVision {
+namespace fuseCut {
+
+/**
+ * @brief Multi-threaded maxflow computation based on a synchronous push-relabel algorithm.
+ *
+ * @note Same interface as MaxFlow_AdjList and MaxFlow_CSR.
+ *       The graph is stored as a compressed sparse row residual graph, the source and sink edges are
+ *       stored per node (initial excess / sink residual capacity) instead of as edges of two huge nodes.
+ *       Each round pushes the excess of all active nodes in parallel, then relabels them in parallel
+ *       from the heights of the previous round, so the labeling stays valid without any lock.
+ *       Heights are periodically recomputed with a parallel breadth-first search from the sink (global relabel).
+ *       The algorithm stops on a maximum preflow, which is enough to get the minimum cut:
+ *       the target nodes are the ones that can still reach the sink in the residual graph.
+ *
+ * @see MaxFlow_AdjList for the single-threaded Boykov-Kolmogorov version.
+ */
+class MaxFlow_PushRelabel
+{
+  public:
+    using NodeType = unsigned int;
+    using ValueType = float;
+    using ArcIndex = std::size_t;
+
+  public:
+    explicit MaxFlow_PushRelabel(std::size_t numNodes)
+      : _numNodes(numNodes),
+        _excess(numNodes, 0.0f),
+        _sinkResidual(numNodes, 0.0f)
+    {
+        const std::size_t nbEdgesEstimation = numNodes * 4;
+        _inputEdges.reserve(nbEdgesEstimation);
+    }
+
+    inline void addNode(NodeType n, ValueType source, ValueType sink)
+    {
+        assert(source >= 0 && sink >= 0);
+        const ValueType score = source - sink;
+        if (score > 0)
+            _excess[n] += score;  // source edge is saturated from the start
+        else
+            _sinkResidual[n] -= score;
+    }
+
+    inline void addEdge(NodeType n1, NodeType n2, ValueType capacity, ValueType reverseCapacity)
+    {
+        assert(capacity >= 0 && reverseCapacity >= 0);
+        _inputEdges.push_back({n1, n2, capacity, reverseCapacity});
+    }
+
+    ValueType compute();
+
+    /// is empty
+    inline bool isSource(NodeType n) const { return !_isTarget[n]; }
+    /// is full
+    inline bool isTarget(NodeType n) const { return _isTarget[n]; }
+
+  private:
+    struct InputEdge
+    {
+        NodeType n1;
+        NodeType n2;
+        ValueType capacity;
+        ValueType reverseCapacity;
+    };
+
+    /// build the compressed sparse row residual graph from the input edges
+    void buildResidualGraph();
+
+    /**
+     * @brief Set the height of each node to its exact distance to the sink in the residual graph.
+     * @note Nodes that cannot reach the sink are set to the maximum height.
+     */
+    void globalRelabel();
+
+    /**
+     * @brief Push the excess of the active nodes, relabel them and update the active nodes list.
+     * @return flow pushed to the sink during this round
+     */
+    double pushRelabelRound();
+
+    std::size_t _numNodes;
+    std::vector<InputEdge> _inputEdges;
+
+    // residual graph
+    std::vector<ArcIndex> _firstArc;      //< first arc of each node, size numNodes + 1
+    std::vector<NodeType> _arcHead;       //< target node of each arc
+    std::vector<ArcIndex> _arcReverse;    //< reverse arc of each arc
+    std::vector<ValueType> _arcResidual;  //< residual capacity of each arc
+
+    // preflow
+    std::vector<ValueType> _excess;
+    std::vector<ValueType> _addedExcess;  //< excess received during the current round
+    std::vector<ValueType> _sinkResidual;
+    std::vector<NodeType> _height;  //< distance label to the sink (sink height is 0)
+    NodeType _maxHeight = 0;        //< height of the nodes that cannot reach the sink
+
+    std::vector<NodeType> _activeNodes;   //< nodes with excess that can still reach the sink
+    std::vector<std::uint8_t> _isActive;  //< is the node in the active nodes list
+
+    std::vector<bool> _isTarget;
+};
+
+}  // namespace fuseCut
+}  // namespace aliceVision
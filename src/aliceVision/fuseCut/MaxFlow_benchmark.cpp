@@ -0,0 +1,94 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <aliceVision/fuseCut/MaxFlow_AdjList.hpp>
+#include <aliceVision/fuseCut/MaxFlow_CSR.hpp>
+#include <aliceVision/fuseCut/MaxFlow_PushRelabel.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <vector>
+
+using namespace aliceVision;
+using namespace aliceVision::fuseCut;
+
+namespace {
+
+struct Edge
+{
+    int n1;
+    int n2;
+    float capacity;
+    float reverseCapacity;
+};
+
+/**
+ * @brief 3d grid graph, 6-connected, with the source on one side and the sink on the other side.
+ */
+void createGridGraph(int size, std::vector<float>& sources, std::vector<float>& sinks, std::vector<Edge>& edges)
+{
+    std::mt19937 generator(0);
+    std::uniform_real_distribution<float> weightDist(0.1f, 10.0f);
+
+    const auto index = [size](int x, int y, int z) { return (z * size + y) * size + x; };
+
+    sources.assign(size * size * size, 0.0f);
+    sinks.assign(size * size * size, 0.0f);
+    edges.clear();
+
+    for (int z = 0; z < size; ++z)
+    {
+        for (int y = 0; y < size; ++y)
+        {
+            for (int x = 0; x < size; ++x)
+            {
+                const int n = index(x, y, z);
+                if (z < size / 4)
+                    sources[n] = weightDist(generator);
+                if (z >= 3 * size / 4)
+                    sinks[n] = weightDist(generator);
+
+                if (x + 1 < size)
+                    edges.push_back({n, index(x + 1, y, z), weightDist(generator), weightDist(generator)});
+                if (y + 1 < size)
+                    edges.push_back({n, index(x, y + 1, z), weightDist(generator), weightDist(generator)});
+                if (z + 1 < size)
+                    edges.push_back({n, index(x, y, z + 1), weightDist(generator), weightDist(generator)});
+            }
+        }
+    }
+}
+
+/**
+ * @brief Build and solve the max-flow of a grid graph of state.range(0)^3 nodes.
+ */
+template<class MaxFlowGraph>
+void BM_MaxFlow(benchmark::State& state)
+{
+    std::vector<float> sources;
+    std::vector<float> sinks;
+    std::vector<Edge> edges;
+    createGridGraph(static_cast<int>(state.range(0)), sources, sinks, edges);
+
+    for (auto _ : state)
+    {
+        MaxFlowGraph graph(sources.size());
+        for (std::size_t n = 0; n < sources.size(); ++n)
+            graph.addNode(n, sources[n], sinks[n]);
+        for (const Edge& e : edges)
+            graph.addEdge(e.n1, e.n2, e.capacity, e.reverseCapacity);
+        benchmark::DoNotOptimize(graph.compute());
+    }
+
+    state.SetItemsProcessed(state.iterations() * sources.size());
+}
+
+}  // namespace
+
+BENCHMARK_TEMPLATE(BM_MaxFlow, MaxFlow_CSR)->Arg(16)->Arg(32)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_MaxFlow, MaxFlow_AdjList)->Arg(16)->Arg(32)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_MaxFlow, MaxFlow_PushRelabel)->Arg(16)->Arg(32)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,219 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2023 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <aliceVision/fuseCut/MaxFlow_AdjList.hpp>
+#include <aliceVision/fuseCut/MaxFlow_CSR.hpp>
+#include <aliceVision/fuseCut/MaxFlow_PushRelabel.hpp>
+#include <aliceVision/system/Logger.hpp>
+#include <aliceVision/system/Timer.hpp>
+
+#include <random>
+#include <string>
+#include <vector>
+
+#define BOOST_TEST_MODULE fuseCut_maxflow
+
+#include <boost/test/unit_test.hpp>
+#include <boost/test/tools/floating_point_comparison.hpp>
+
+using namespace aliceVision;
+using namespace aliceVision::fuseCut;
+
+struct TestGraph
+{
+    struct Node
+    {
+        float source;
+        float sink;
+    };
+    struct Edge
+    {
+        int n1;
+        int n2;
+        float capacity;
+        float reverseCapacity;
+    };
+
+    std::vector<Node> nodes;
+    std::vector<Edge> edges;
+
+    template<class MaxFlowGraph>
+    void fill(MaxFlowGraph& graph) const
+    {
+        for (std::size_t n = 0; n < nodes.size(); ++n)
+            graph.addNode(n, nodes[n].source, nodes[n].sink);
+        for (const Edge& e : edges)
+            graph.addEdge(e.n1, e.n2, e.capacity, e.reverseCapacity);
+    }
+
+    /// cost of the cut given by the solver nodes labels
+    template<class MaxFlowGraph>
+    double cutCost(const MaxFlowGraph& graph) const
+    {
+        double cost = 0.0;
+        for (std::size_t n = 0; n < nodes.size(); ++n)
+        {
+            const float score = nodes[n].source - nodes[n].sink;
+            if (score > 0 && graph.isTarget(n))
+                cost += score;
+            else if (score < 0 && graph.isSource(n))
+                cost -= score;
+        }
+        for (const Edge& e : edges)
+        {
+            if (graph.isSource(e.n1) && graph.isTarget(e.n2))
+                cost += e.capacity;
+            else if (graph.isSource(e.n2) && graph.isTarget(e.n1))
+                cost += e.reverseCapacity;
+        }
+        return cost;
+    }
+};
+
+/**
+ * @brief Random graph with the structure of the Delaunay tetrahedralization graph cut:
+ *        each cell has at most 4 neighbors and a few cells are strongly linked to the source or the sink.
+ */
+TestGraph createRandomTestGraph(int nbNodes, unsigned int seed)
+{
+    std::mt19937 generator(seed);
+    std::uniform_real_distribution<float> weightDist(0.0f, 10.0f);
+    std::uniform_int_distribution<int> nodeDist(0, nbNodes - 1);
+    std::uniform_int_distribution<int> terminalDist(0, 9);
+
+    TestGraph graph;
+    graph.nodes.resize(nbNodes);
+    for (TestGraph::Node& node : graph.nodes)
+    {
+        const int terminal = terminalDist(generator);
+        node.source = (terminal == 0) ? 100.0f * weightDist(generator) : 0.0f;
+        node.sink = (terminal == 1) ? 100.0f * weightDist(generator) : weightDist(generator) * 0.1f;
+    }
+    for (int n = 0; n < nbNodes; ++n)
+    {
+        for (int k = 0; k < 2; ++k)
+        {
+            const int m = (k == 0) ? (n + 1) % nbNodes : nodeDist(generator);
+            if (m != n)
+                graph.edges.push_back({n, m, weightDist(generator), weightDist(generator)});
+        }
+    }
+    return graph;
+}
+
+/**
+ * @brief 3d grid graph, 6-connected, with the source on one side and the sink on the other side.
+ */
+TestGraph createGridTestGraph(int size, unsigned int seed)
+{
+    std::mt19937 generator(seed);
+    std::uniform_real_distribution<float> weightDist(0.1f, 10.0f);
+
+    const auto index = [size](int x, int y, int z) { return (z * size + y) * size + x; };
+
+    TestGraph graph;
+    graph.nodes.resize(size * size * size);
+    for (int z = 0; z < size; ++z)
+    {
+        for (int y = 0; y < size; ++y)
+        {
+            for (int x = 0; x < size; ++x)
+            {
+                TestGraph::Node& node = graph.nodes[index(x, y, z)];
+                node.source = (z < size / 4) ? weightDist(generator) : 0.0f;
+                node.sink = (z >= 3 * size / 4) ? weightDist(generator) : 0.0f;
+
+                if (x + 1 < size)
+                    graph.edges.push_back({index(x, y, z), index(x + 1, y, z), weightDist(generator), weightDist(generator)});
+                if (y + 1 < size)
+                    graph.edges.push_back({index(x, y, z), index(x, y + 1, z), weightDist(generator), weightDist(generator)});
+                if (z + 1 < size)
+                    graph.edges.push_back({index(x, y, z), index(x, y, z + 1), weightDist(generator), weightDist(generator)});
+            }
+        }
+    }
+    return graph;
+}
+
+BOOST_AUTO_TEST_CASE(fuseCut_maxflow_pushRelabel_simple)
+{
+    // S -> 0 (5), S -> 1 (3), 0 -> 1 (2), 0 -> 2 (2), 1 -> 2 (4), 2 -> T (10)
+    // max flow is 6 (cut {S,0,1} / {2,T})
+    TestGraph testGraph;
+    testGraph.nodes = {{5.0f, 0.0f}, {3.0f, 0.0f}, {0.0f, 10.0f}};
+    testGraph.edges = {{0, 1, 2.0f, 0.0f}, {0, 2, 2.0f, 0.0f}, {1, 2, 4.0f, 0.0f}};
+
+    MaxFlow_PushRelabel graph(testGraph.nodes.size());
+    testGraph.fill(graph);
+    const float flow = graph.compute();
+
+    BOOST_CHECK_CLOSE(flow, 6.0f, 1e-4);
+    BOOST_CHECK(graph.isSource(0));
+    BOOST_CHECK(graph.isSource(1));
+    BOOST_CHECK(graph.isTarget(2));
+}
+
+BOOST_AUTO_TEST_CASE(fuseCut_maxflow_pushRelabel_vs_boykovKolmogorov)
+{
+    for (unsigned int seed = 0; seed < 10; ++seed)
+    {
+        const TestGraph testGraph = createRandomTestGraph(2000, seed);
+
+        MaxFlow_AdjList graphBK(testGraph.nodes.size());
+        testGraph.fill(graphBK);
+        const float flowBK = graphBK.compute();
+
+        MaxFlow_PushRelabel graphPR(testGraph.nodes.size());
+        testGraph.fill(graphPR);
+        const float flowPR = graphPR.compute();
+
+        BOOST_CHECK_CLOSE(flowPR, flowBK, 1e-2);
+        // the cut may differ on ties but must be minimal
+        BOOST_CHECK_CLOSE(testGraph.cutCost(graphPR), testGraph.cutCost(graphBK), 1e-3);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(fuseCut_maxflow_csr_vs_adjList)
+{
+    for (unsigned int seed = 0; seed < 5; ++seed)
+    {
+        const TestGraph testGraph = createRandomTestGraph(2000, seed);
+
+        MaxFlow_AdjList graphAdjList(testGraph.nodes.size());
+        testGraph.fill(graphAdjList);
+        const float flowAdjList = graphAdjList.compute();
+
+        MaxFlow_CSR graphCSR(testGraph.nodes.size());
+        testGraph.fill(graphCSR);
+        const float flowCSR = graphCSR.compute();
+
+        BOOST_CHECK_CLOSE(flowCSR, flowAdjList, 1e-2);
+        BOOST_CHECK_CLOSE(testGraph.cutCost(graphCSR), testGraph.cutCost(graphAdjList), 1e-3);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(fuseCut_maxflow_benchmark)
+{
+    const TestGraph testGraph = createGridTestGraph(32, 0);
+
+    ALICEVISION_LOG_INFO("Max-flow benchmark: " << testGraph.nodes.size() << " nodes, " << testGraph.edges.size() << " edges.");
+
+    system::Timer timer;
+    MaxFlow_AdjList graphBK(testGraph.nodes.size());
+    testGraph.fill(graphBK);
+    const float flowBK = graphBK.compute();
+    ALICEVISION_LOG_INFO("Max-flow benchmark: boykovKolmogorov: " << timer.elapsedMs() << " ms.");
+
+    timer.reset();
+    MaxFlow_PushRelabel graphPR(testGraph.nodes.size());
+    testGraph.fill(graphPR);
+    const float flowPR = graphPR.compute();
+    ALICEVISION_LOG_INFO("Max-flow benchmark: pushRelabel: " << timer.elapsedMs() << " ms.");
+
+    // the float flow accumulated by the boost Boykov-Kolmogorov is less accurate than the cut cost
+    BOOST_CHECK_CLOSE(flowPR, flowBK, 0.1);
+    BOOST_CHECK_CLOSE(testGraph.cutCost(graphPR), testGraph.cutCost(graphBK), 1e-3);
+}
@@ -6,6 +6,7 @@
 
 #include "OctreeTracks.hpp"
 #include <aliceVision/system/Logger.hpp>
+#include <aliceVision/alicevision_omp.hpp>
 #include <aliceVision/mvsData/geometry.hpp>
 #include <aliceVision/mvsUtils/common.hpp>
 #include <aliceVision/mvsUtils/fileIO.hpp>
@@ -13,246 +14,197 @@
 #include <boost/accumulators/accumulators.hpp>
 #include <boost/accumulators/statistics.hpp>
 
+#include <algorithm>
+#include <cstdint>
 #include <iostream>
+#include <numeric>
 
 namespace aliceVision {
 namespace fuseCut {
 
-OctreeTracks::Node::Node(NodeType type) { type_ = type; }
+namespace {
 
-OctreeTracks::trackStruct* OctreeTracks::getTrack(int x, int y, int z)
+/**
+ * @brief Stable parallel LSD radix sort of the input indices by key.
+ * @param[in,out] keys the input keys, sorted on output
+ * @param[in,out] indices the input indices, permuted as the keys
+ * @param[in] nbKeyBits the number of significant bits of the keys
+ */
+void radixSortByKey(std::vector<std::uint64_t>& keys, std::vector<int>& indices, int nbKeyBits)
 {
-    if (!((x >= 0 && x < size_) && (y >= 0 && y < size_) && (z >= 0 && z < size_)))
-    {
-        return nullptr;
-    }
+    constexpr int digitBits = 8;
+    constexpr int nbBuckets = 1 << digitBits;
 
-    Node** n = &root_;
-    int size = size_;
+    const std::size_t n = keys.size();
 
-    while (size != 1)
-    {
-        if (*n == nullptr)
-        {
-            return nullptr;
-        }
+    // the inputs are split in contiguous chunks, sorted digit by digit in parallel
+    // the chunk offsets of a bucket follow the chunk order, which keeps the sort stable
+    const int nbChunks = static_cast<int>(std::max<std::size_t>(1, std::min<std::size_t>(omp_get_max_threads(), n / 4096)));
+    const std::size_t chunkSize = (n + nbChunks - 1) / nbChunks;
 
-        size /= 2;
-        n = &reinterpret_cast<Branch*>(*n)->children[!((x & size) == 0)][!((y & size) == 0)][!((z & size) == 0)];
-    }
+    std::vector<std::uint64_t> keysTmp(n);
+    std::vector<int> indicesTmp(n);
+    std::vector<std::size_t> histograms(nbChunks * nbBuckets);
 
-    if (*n == nullptr)
+    for (int shift = 0; shift < nbKeyBits; shift += digitBits)
     {
-        return nullptr;
-    }
+        std::fill(histograms.begin(), histograms.end(), 0);
 
-    return reinterpret_cast<trackStruct*>(*n);
-}
-
-void OctreeTracks::addPoint(int x, int y, int z, float sim, float pixSize, Point3d& p, int rc)
-{
-    assert(x >= 0 && x < size_);
-    assert(y >= 0 && y < size_);
-    assert(z >= 0 && z < size_);
-
-    Node** n = &root_;
-    int size = size_;
-
-    while (size != 1)
-    {
-        if (*n == nullptr)
+#pragma omp parallel for
+        for (int c = 0; c < nbChunks; ++c)
         {
-            *n = new Branch();
+            std::size_t* histogram = &histograms[c * nbBuckets];
+            for (std::size_t i = c * chunkSize; i < std::min(n, (c + 1) * chunkSize); ++i)
+                ++histogram[(keys[i] >> shift) & (nbBuckets - 1)];
         }
-        else
+
+        // skip the digit shared by all the keys
+        bool isSharedDigit = false;
+        for (int d = 0; d < nbBuckets && !isSharedDigit; ++d)
         {
-            size /= 2;
-            n = &reinterpret_cast<Branch*>(*n)->children[!((x & size) == 0)][!((y & size) == 0)][!((z & size) == 0)];
+            std::size_t bucketSize = 0;
+            for (int c = 0; c < nbChunks; ++c)
+                bucketSize += histograms[c * nbBuckets + d];
+            isSharedDigit = (bucketSize == n);
         }
-    }
-
-    if (*n == nullptr)
-    {
-        *n = new trackStruct(sim, pixSize, p, rc);
-        leafsNumber_++;
-    }
-    else
-    {
-        reinterpret_cast<trackStruct*>(*n)->addPoint(sim, pixSize, p, rc);
-    }
-}
+        if (isSharedDigit)
+            continue;
 
-void OctreeTracks::addTrack(int x, int y, int z, OctreeTracks::trackStruct* t)
-{
-    assert(x >= 0 && x < size_);
-    assert(y >= 0 && y < size_);
-    assert(z >= 0 && z < size_);
-
-    Node** n = &root_;
-    int size = size_;
-
-    while (size != 1)
-    {
-        if (*n == nullptr)
+        // histograms to output offsets, bucket-major then chunk order
+        std::size_t offset = 0;
+        for (int d = 0; d < nbBuckets; ++d)
         {
-            *n = new Branch();
+            for (int c = 0; c < nbChunks; ++c)
+            {
+                const std::size_t count = histograms[c * nbBuckets + d];
+                histograms[c * nbBuckets + d] = offset;
+                offset += count;
+            }
         }
-        else
+
+#pragma omp parallel for
+        for (int c = 0; c < nbChunks; ++c)
         {
-            size /= 2;
-            n = &reinterpret_cast<Branch*>(*n)->children[!((x & size) == 0)][!((y & size) == 0)][!((z & size) == 0)];
+            std::size_t* offsets = &histograms[c * nbBuckets];
+            for (std::size_t i = c * chunkSize; i < std::min(n, (c + 1) * chunkSize); ++i)
+            {
+                const std::size_t o = offsets[(keys[i] >> shift) & (nbBuckets - 1)]++;
+                keysTmp[o] = keys[i];
+                indicesTmp[o] = indices[i];
+            }
         }
-    }
 
-    if (*n == nullptr)
-    {
-        *n = new trackStruct(t);
-        leafsNumber_++;
-    }
-    else
-    {
-        reinterpret_cast<trackStruct*>(*n)->addTrack(t);
+        keys.swap(keysTmp);
+        indices.swap(indicesTmp);
     }
 }
 
-StaticVector<OctreeTracks::trackStruct*>* OctreeTracks::getAllPoints()
+/**
+ * @return the number of distinct sorted keys
+ */
+int getNbDistinctKeys(const std::vector<std::uint64_t>& sortedKeys)
 {
-    StaticVector<trackStruct*>* out = new StaticVector<trackStruct*>();
-    out->reserve(leafsNumber_);
-    if (root_ != nullptr)
+    int nbDistinctKeys = 0;
+    for (std::size_t i = 0; i < sortedKeys.size(); ++i)
     {
-        getAllPointsRecursive(out, root_);
+        if (i == 0 || sortedKeys[i] != sortedKeys[i - 1])
+            ++nbDistinctKeys;
     }
-    return out;
+    return nbDistinctKeys;
 }
 
-void OctreeTracks::getAllPointsRecursive(StaticVector<trackStruct*>* out, Node* node)
+}  // namespace
+
+int OctreeTracks::getMortonCodeBits() const
 {
-    assert(node);
+    int nbLevels = 0;
+    while ((1 << nbLevels) < size_)
+        ++nbLevels;
+    return 3 * nbLevels;
+}
 
-    switch (node->type_)
+std::uint64_t OctreeTracks::getMortonCode(int x, int y, int z) const
+{
+    // same order as the children of a pointer-based octree: x, then y, then z
+    std::uint64_t code = 0;
+    for (int size = size_ / 2; size > 0; size /= 2)
     {
-        case BranchNode:
-        {
-            Branch* b = reinterpret_cast<Branch*>(node);
-            for (int i = 0; i < 2; ++i)
-            {
-                for (int j = 0; j < 2; ++j)
-                {
-                    for (int k = 0; k < 2; ++k)
-                    {
-                        if (b->children[i][j][k] != nullptr)
-                        {
-                            getAllPointsRecursive(out, b->children[i][j][k]);
-                        }
-                    }
-                }
-            }
-        }
-        break;
-        case LeafNode:
-            out->push_back(reinterpret_cast<trackStruct*>(node));
-            break;
+        code = (code << 3) | (std::uint64_t((x & size) != 0) << 2) | (std::uint64_t((y & size) != 0) << 1) | std::uint64_t((z & size) != 0);
     }
+    return code;
 }
 
-void OctreeTracks::getNPointsByLevelsRecursive(Node* node, int level, StaticVector<int>* nptsAtLevel)
+template<class CreateTrack, class AddToTrack>
+void OctreeTracks::buildLeaves(const std::vector<std::uint64_t>& sortedKeys,
+                               const std::vector<int>& sortedIndices,
+                               CreateTrack&& createTrack,
+                               AddToTrack&& addToTrack)
 {
-    assert(node);
+    // first sorted input of each leaf
+    std::vector<int> leavesFirst;
+    leavesFirst.reserve(getNbDistinctKeys(sortedKeys) + 1);
+    for (std::size_t i = 0; i < sortedKeys.size(); ++i)
+    {
+        if (i == 0 || sortedKeys[i] != sortedKeys[i - 1])
+            leavesFirst.push_back(static_cast<int>(i));
+    }
+    const int nbLeaves = static_cast<int>(leavesFirst.size());
+    leavesFirst.push_back(static_cast<int>(sortedKeys.size()));
+
+    _leavesKeys.resize(nbLeaves);
+    _leavesTracks.clear();
+    _leavesTracks.resize(nbLeaves);
 
-    switch (node->type_)
+    // each leaf is merged independently, its inputs are merged in their input order
+#pragma omp parallel for schedule(dynamic, 256)
+    for (int l = 0; l < nbLeaves; ++l)
     {
-        case BranchNode:
-        {
-            Branch* b = reinterpret_cast<Branch*>(node);
-            for (int i = 0; i < 2; ++i)
-            {
-                for (int j = 0; j < 2; ++j)
-                {
-                    for (int k = 0; k < 2; ++k)
-                    {
-                        if (b->children[i][j][k] != nullptr)
-                        {
-                            (*nptsAtLevel)[level + 1] += 1;
-                            getNPointsByLevelsRecursive(b->children[i][j][k], level + 1, nptsAtLevel);
-                        }
-                    }
-                }
-            }
-        }
-        break;
-        case LeafNode:
-            //
-            break;
+        const int first = leavesFirst[l];
+        _leavesKeys[l] = sortedKeys[first];
+
+        trackStruct& track = _leavesTracks[l];
+        createTrack(track, sortedIndices[first]);
+        for (int i = first + 1; i < leavesFirst[l + 1]; ++i)
+            addToTrack(track, sortedIndices[i]);
     }
 }
 
-OctreeTracks::Branch::Branch()
-  : Node(BranchNode)
+OctreeTracks::trackStruct* OctreeTracks::getTrack(int x, int y, int z)
 {
-    for (int i = 0; i < 2; ++i)
+    if (!((x >= 0 && x < size_) && (y >= 0 && y < size_) && (z >= 0 && z < size_)))
     {
-        for (int j = 0; j < 2; ++j)
-        {
-            for (int k = 0; k < 2; ++k)
-            {
-                children[i][j][k] = nullptr;
-            }
-        }
+        return nullptr;
+    }
+
+    const std::uint64_t key = getMortonCode(x, y, z);
+    const auto it = std::lower_bound(_leavesKeys.begin(), _leavesKeys.end(), key);
+
+    if (it == _leavesKeys.end() || *it != key)
+    {
+        return nullptr;
     }
+
+    return &_leavesTracks[it - _leavesKeys.begin()];
 }
 
-OctreeTracks::Branch::~Branch()
+StaticVector<OctreeTracks::trackStruct*>* OctreeTracks::getAllPoints()
 {
-    for (int i = 0; i < 2; ++i)
+    StaticVector<trackStruct*>* out = new StaticVector<trackStruct*>();
+    out->reserve(_leavesTracks.size());
+    for (trackStruct& track : _leavesTracks)
     {
-        for (int j = 0; j < 2; ++j)
-        {
-            for (int k = 0; k < 2; ++k)
-            {
-                assert(children[i][j][k] != this);
-                /*
-                Node *node = children[i][j][k];
-                if (node!=NULL) {
-                        if ( node->type_ == BranchNode ) {
-                                delete reinterpret_cast<Branch*>(node);
-                        }else {
-                                if ( node->type_ == LeafNode ) {
-                                        delete reinterpret_cast<trackStruct*>(node);
-                                }else{
-                                        printf("WARNING unknows node type\n");
-                                };
-                        }
-                        node = NULL;
-                        children[i][j][k] = NULL;
-                }
-                */
-                if (children[i][j][k] != nullptr)
-                {
-                    if (children[i][j][k]->type_ == BranchNode)
-                    {
-                        delete reinterpret_cast<Branch*>(children[i][j][k]);
-                    }
-                    else
-                    {
-                        if (children[i][j][k]->type_ == LeafNode)
-                        {
-                            delete reinterpret_cast<trackStruct*>(children[i][j][k]);
-                        }
-                        else
-                        {
-                            ALICEVISION_LOG_WARNING("Unknows node type.");
-                        }
-                    }
-                    children[i][j][k] = nullptr;
-                }
-            }
-        }
+        out->push_back(&track);
     }
+    return out;
 }
 
+OctreeTracks::trackStruct::trackStruct()
+  : npts(0),
+    minPixSize(0.0f),
+    minSim(0.0f)
+{}
+
 OctreeTracks::trackStruct::trackStruct(float sim, float pixSize, const Point3d& p, int rc)
-  : Node(LeafNode)
 {
     npts = 1;
     point = p;
@@ -263,7 +215,6 @@ OctreeTracks::trackStruct::trackStruct(float sim, float pixSize, const Point3d&
 }
 
 OctreeTracks::trackStruct::trackStruct(trackStruct* t)
-  : Node(LeafNode)
 {
     npts = t->npts;
     point = t->point;
@@ -272,8 +223,6 @@ OctreeTracks::trackStruct::trackStruct(trackStruct* t)
     minSim = t->minSim;
 }
 
-OctreeTracks::trackStruct::~trackStruct() {}
-
 void OctreeTracks::trackStruct::addPoint(float sim, float pixSize, const Point3d& p, int rc)
 {
     int index = indexOf(rc);
@@ -495,19 +444,9 @@ OctreeTracks::OctreeTracks(const Point3d* voxel_, mvsUtils::MultiViewParams* mp_
         size_ *= 2;
     }
 
-    root_ = nullptr;
-    leafsNumber_ = 0;
 }
 
-OctreeTracks::~OctreeTracks()
-{
-    // printf("deleting octree\n");
-    if (root_ != nullptr)
-    {
-        delete reinterpret_cast<Branch*>(root_);
-    }
-    // printf("deleted\n");
-}
+OctreeTracks::~OctreeTracks() {}
 
 bool OctreeTracks::getVoxelOfOctreeFor3DPoint(Voxel& out, Point3d& tp)
 {
@@ -621,7 +560,10 @@ void OctreeTracks::filterOctreeTracks2(StaticVector<trackStruct*>* tracks)
 
     float clusterSizeThr = _mp.userParams.get<double>("OctreeTracks.clusterSizeThr", 2.0f);
 
-    // long t1 = initEstimate();
+    // the octree is read-only, the tracks are checked in parallel
+    std::vector<char> keepTracks(tracks->size(), 0);
+
+#pragma omp parallel for schedule(dynamic, 256)
     for (int i = 0; i < tracks->size(); i++)
     {
         int n = (int)ceil(((*tracks)[i]->minPixSize * clusterSizeThr) / sx);
@@ -630,12 +572,11 @@ void OctreeTracks::filterOctreeTracks2(StaticVector<trackStruct*>* tracks)
         Voxel vox;
         if ((n > 1) && (getVoxelOfOctreeFor3DPoint(vox, (*tracks)[i]->point)))
         {
-            // printf("n %i\n",n);
-            for (int xp = -n; xp <= n; xp++)
+            for (int xp = -n; xp <= n && ok; xp++)
             {
-                for (int yp = -n; yp <= n; yp++)
+                for (int yp = -n; yp <= n && ok; yp++)
                 {
-                    for (int zp = -n; zp <= n; zp++)
+                    for (int zp = -n; zp <= n && ok; zp++)
                     {
                         trackStruct* nt = getTrack(vox.x + xp, vox.y + yp, vox.z + zp);
                         if ((xp == 0) && (yp == 0) && (zp == 0))
@@ -653,13 +594,16 @@ void OctreeTracks::filterOctreeTracks2(StaticVector<trackStruct*>* tracks)
                 }
             }
         }
-        if (ok)
+        keepTracks[i] = ok;
+    }
+
+    for (int i = 0; i < tracks->size(); i++)
+    {
+        if (keepTracks[i])
         {
             tracksOut.push_back((*tracks)[i]);
         }  // ELSE DO NOT DELETE BECAUSE IT IS POINTER TO THE STRUCTURE
-        // printfEstimate(i, tracks->size(), t1);
     }
-    // finishEstimate();
 
     tracks->swap(tracksOut);
 }
@@ -673,14 +617,29 @@ StaticVector<OctreeTracks::trackStruct*>* OctreeTracks::fillOctree(int maxPts, c
 
     t1 = clock();
 
-    // long t1=initEstimate();
+    // point of a depth map falling in the octree
+    struct OctreePoint
+    {
+        Point3d p;
+        float sim;
+        float pixSize;
+        int rc;
+    };
+
+    // the depth maps points are read and located in the octree in parallel
+    std::vector<std::vector<OctreePoint>> camsPoints(cams.size());
+    std::vector<std::vector<std::uint64_t>> camsKeys(cams.size());
+
+#pragma omp parallel for schedule(dynamic)
     for (int camid = 0; camid < cams.size(); camid++)
     {
         int rc = cams[camid];
         StaticVector<Point3d>* pts = loadArrayFromFile<Point3d>(depthMapsPtsSimsTmpDir + std::to_string(_mp.getViewId(rc)) + "pts.bin");
         StaticVector<float>* sims = loadArrayFromFile<float>(depthMapsPtsSimsTmpDir + std::to_string(_mp.getViewId(rc)) + "sims.bin");
 
-        // long tpts=initEstimate();
+        std::vector<OctreePoint>& camPoints = camsPoints[camid];
+        std::vector<std::uint64_t>& camKeys = camsKeys[camid];
+
         for (int i = 0; i < pts->size(); i++)
         {
             float sim = (*sims)[i];
@@ -697,24 +656,48 @@ StaticVector<OctreeTracks::trackStruct*>* OctreeTracks::fillOctree(int maxPts, c
                         sim -= 2.0f;
                     }
                 }
-                float pixSize = _mp.getCamPixelSize(p, rc);
-                addPoint(otVox.x, otVox.y, otVox.z, sim, pixSize, p, rc);
-            }
-            if (leafsNumber_ > 2 * maxPts)
-            {
-                return nullptr;
+                const float pixSize = _mp.getCamPixelSize(p, rc);
+                camPoints.push_back({p, sim, pixSize, rc});
+                camKeys.push_back(getMortonCode(otVox.x, otVox.y, otVox.z));
             }
-
-            // printfEstimate(i, pts->size(), tpts);
         }  // for i
-           // finishEstimate();
 
         delete pts;
         delete sims;
+    }
 
-        // printfEstimate(camid, cams.size(), t1);
+    // gather the points in the cameras order
+    std::size_t nbPoints = 0;
+    for (const auto& camPoints : camsPoints)
+        nbPoints += camPoints.size();
+
+    std::vector<OctreePoint> points;
+    std::vector<std::uint64_t> keys;
+    points.reserve(nbPoints);
+    keys.reserve(nbPoints);
+    for (int camid = 0; camid < cams.size(); camid++)
+    {
+        points.insert(points.end(), camsPoints[camid].begin(), camsPoints[camid].end());
+        keys.insert(keys.end(), camsKeys[camid].begin(), camsKeys[camid].end());
+        std::vector<OctreePoint>().swap(camsPoints[camid]);
+        std::vector<std::uint64_t>().swap(camsKeys[camid]);
     }
-    // finishEstimate();
+
+    // sort the points by leaf, the points of a leaf stay in the cameras and depth maps order
+    std::vector<int> indices(nbPoints);
+    std::iota(indices.begin(), indices.end(), 0);
+    radixSortByKey(keys, indices, getMortonCodeBits());
+
+    if (getNbDistinctKeys(keys) > 2 * maxPts)
+    {
+        return nullptr;
+    }
+
+    buildLeaves(
+      keys,
+      indices,
+      [&](trackStruct& track, int i) { track = trackStruct(points[i].sim, points[i].pixSize, points[i].p, points[i].rc); },
+      [&](trackStruct& track, int i) { track.addPoint(points[i].sim, points[i].pixSize, points[i].p, points[i].rc); });
 
     StaticVector<trackStruct*>* tracks = getAllPoints();
     mvsUtils::printfElapsedTime(t1, "fillOctree fill");
@@ -759,16 +742,31 @@ StaticVector<OctreeTracks::trackStruct*>* OctreeTracks::fillOctreeFromTracks(Sta
 {
     long t1 = clock();
 
+    std::vector<std::uint64_t> keys;
+    std::vector<int> indices;
+    keys.reserve(tracksIn->size());
+    indices.reserve(tracksIn->size());
+
     for (int i = 0; i < tracksIn->size(); i++)
     {
         trackStruct* t = (*tracksIn)[i];
         Voxel otVox;
         if (getVoxelOfOctreeFor3DPoint(otVox, t->point))
         {
-            addTrack(otVox.x, otVox.y, otVox.z, t);
+            keys.push_back(getMortonCode(otVox.x, otVox.y, otVox.z));
+            indices.push_back(i);
         }
     }  // for i
 
+    // sort the tracks by leaf, the tracks of a leaf stay in the input order
+    radixSortByKey(keys, indices, getMortonCodeBits());
+
+    buildLeaves(
+      keys,
+      indices,
+      [&](trackStruct& track, int i) { track = trackStruct((*tracksIn)[i]); },
+      [&](trackStruct& track, int i) { track.addTrack((*tracksIn)[i]); });
+
     StaticVector<trackStruct*>* tracks = getAllPoints();
 
     mvsUtils::printfElapsedTime(t1, "fillOctreeFromTracks");
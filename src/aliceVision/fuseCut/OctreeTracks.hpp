@@ -13,37 +13,24 @@
 #include <aliceVision/mvsData/Voxel.hpp>
 #include <aliceVision/fuseCut/Fuser.hpp>
 
+#include <cstdint>
+#include <vector>
+
 namespace aliceVision {
 namespace fuseCut {
 
+/**
+ * @brief Sparse octree of the tracks of a voxel.
+ *
+ * The octree is linear: the leaves are identified by the Morton code of their sub-voxel and stored
+ * in a single pool sorted by Morton code, which is also the depth-first order of a pointer-based octree.
+ * The inputs are sorted by Morton code with a stable parallel radix sort and the inputs of each leaf
+ * are merged in parallel, in their input order.
+ */
 class OctreeTracks : public Fuser
 {
   public:
-    enum NodeType
-    {
-        BranchNode,
-        LeafNode
-    };
-
-    class Node
-    {
-      public:
-        NodeType type_ : 2;
-
-        explicit Node(NodeType type);
-        ~Node(){};
-    };
-
-    class Branch : public Node
-    {
-      public:
-        Node* children[2][2][2];
-
-        Branch();
-        ~Branch();
-    };
-
-    class trackStruct : public Node
+    class trackStruct
     {
       public:
         int npts;
@@ -52,10 +39,9 @@ class OctreeTracks : public Fuser
         float minPixSize;
         float minSim;
 
+        trackStruct();
         explicit trackStruct(trackStruct* t);
         trackStruct(float sim, float pixSize, const Point3d& p, int rc);
-        ~trackStruct();
-        void resizeCamsAdd(int nadd);
         void addPoint(float sim, float pixSize, const Point3d& p, int rc);
         void addTrack(trackStruct* t);
         void addDistinctNonzeroCamsFromTrackAsZeroCams(trackStruct* t);
@@ -63,16 +49,13 @@ class OctreeTracks : public Fuser
         void doPrintf();
     };
 
-    Node* root_;
     int size_;
-    int leafsNumber_;
 
-    // trackStruct* at( int x, int y, int z );
+    /**
+     * @return the track of the given sub-voxel or nullptr if it is empty
+     */
     trackStruct* getTrack(int x, int y, int z);
-    void addTrack(int x, int y, int z, trackStruct* t);
-    void addPoint(int x, int y, int z, float sim, float pixSize, Point3d& p, int rc);
     StaticVector<trackStruct*>* getAllPoints();
-    void getAllPointsRecursive(StaticVector<trackStruct*>* out, Node* node);
 
     Point3d O, vx, vy, vz;
     float sx, sy, sz, svx, svy, svz;
@@ -100,7 +83,34 @@ class OctreeTracks : public Fuser
     StaticVector<trackStruct*>* fillOctreeFromTracks(StaticVector<trackStruct*>* tracksIn);
     StaticVector<trackStruct*>* fillOctree(int maxPts, const std::string& depthMapsPtsSimsTmpDir);
     StaticVector<int>* getTracksCams(StaticVector<OctreeTracks::trackStruct*>* tracks);
-    void getNPointsByLevelsRecursive(Node* node, int level, StaticVector<int>* nptsAtLevel);
+
+  private:
+    /**
+     * @return the Morton code of the given sub-voxel, x being the most significant bit of each level
+     */
+    std::uint64_t getMortonCode(int x, int y, int z) const;
+
+    /**
+     * @return the number of significant bits of the Morton codes
+     */
+    int getMortonCodeBits() const;
+
+    /**
+     * @brief Build the leaves pool from the inputs sorted by Morton code.
+     * @note The leaves are built in parallel, the inputs of a leaf are merged in their sorted order.
+     * @param[in] sortedKeys the Morton code of each input, sorted
+     * @param[in] sortedIndices the index of each input, in the same order
+     * @param[in] createTrack function(track, index) initializing the track of a leaf from its first input
+     * @param[in] addToTrack function(track, index) merging the next inputs of a leaf into its track
+     */
+    template<class CreateTrack, class AddToTrack>
+    void buildLeaves(const std::vector<std::uint64_t>& sortedKeys,
+                     const std::vector<int>& sortedIndices,
+                     CreateTrack&& createTrack,
+                     AddToTrack&& addToTrack);
+
+    std::vector<std::uint64_t> _leavesKeys;  //< Morton code of each leaf, sorted
+    std::vector<trackStruct> _leavesTracks;  //< pool of the leaves tracks, in the same order
 };
 
 }  // namespace fuseCut
@@ -278,7 +278,12 @@ void loadLargeScalePtsCams(const std::vector<std::string>& recsDirs, StaticVecto
         {
             throw std::runtime_error("Missing file: " + filePtsCamsFromDCTName);
         }
-        loadArrayOfArraysFromFile<int>(out_ptsCams, filePtsCamsFromDCTName);
+        // loadArrayOfArraysFromFile resizes its output, append each part to out_ptsCams
+        StaticVector<StaticVector<int>> ptsCamsi;
+        loadArrayOfArraysFromFile<int>(ptsCamsi, filePtsCamsFromDCTName);
+        out_ptsCams.reserveAdd(ptsCamsi.size());
+        for (StaticVector<int>& ptCams : ptsCamsi)
+            out_ptsCams.getDataWritable().push_back(std::move(ptCams));
     }
 }
 
@@ -304,10 +309,36 @@ StaticVector<rgb>* getTrisColorsRgb(mesh::Mesh* me, StaticVector<rgb>* ptsColors
     return trisColors;
 }
 
+Voxel computeTilesGridDimensions(const Point3d* hexah, int nbTiles)
+{
+    const double sx = (hexah[1] - hexah[0]).size();
+    const double sy = (hexah[3] - hexah[0]).size();
+    const double sz = (hexah[4] - hexah[0]).size();
+
+    Voxel dimensions(1, 1, 1);
+    while (dimensions.x * dimensions.y * dimensions.z < nbTiles)
+    {
+        const double tx = sx / dimensions.x;
+        const double ty = sy / dimensions.y;
+        const double tz = sz / dimensions.z;
+
+        if (tx >= ty && tx >= tz)
+            ++dimensions.x;
+        else if (ty >= tz)
+            ++dimensions.y;
+        else
+            ++dimensions.z;
+    }
+    return dimensions;
+}
+
 mesh::Mesh* joinMeshes(const std::vector<std::string>& recsDirs, StaticVector<Point3d>* voxelsArray, LargeScale* ls)
 {
-    ReconstructionPlan rp(ls->dimensions, &ls->space[0], ls->mp, ls->spaceVoxelsFolderName);
+    return joinMeshes(recsDirs, voxelsArray, 0.96f);
+}
 
+mesh::Mesh* joinMeshes(const std::vector<std::string>& recsDirs, StaticVector<Point3d>* voxelsArray, float borderInflateFactor)
+{
     ALICEVISION_LOG_DEBUG("Detecting size of merged mesh.");
     int npts = 0;
     int ntris = 0;
@@ -347,8 +378,7 @@ mesh::Mesh* joinMeshes(const std::vector<std::string>& recsDirs, StaticVector<Po
     ALICEVISION_LOG_DEBUG("Merging part to one mesh without connecting them.");
     for (int i = 0; i < recsDirs.size(); i++)
     {
-        if (ls->mp->verbose)
-            ALICEVISION_LOG_DEBUG("Merging part: " << i);
+        ALICEVISION_LOG_DEBUG("Merging part: " << i);
         std::string folderName = recsDirs[i];
 
         std::string fileName = folderName + "mesh.bin";
@@ -359,8 +389,7 @@ mesh::Mesh* joinMeshes(const std::vector<std::string>& recsDirs, StaticVector<Po
 
             // to remove artefacts on the border
             Point3d hexah[8];
-            float inflateFactor = 0.96;
-            mvsUtils::inflateHexahedron(&(*voxelsArray)[i * 8], hexah, inflateFactor);
+            mvsUtils::inflateHexahedron(&(*voxelsArray)[i * 8], hexah, borderInflateFactor);
             mei->removeTrianglesOutsideHexahedron(hexah);
 
             ALICEVISION_LOG_DEBUG("Adding mesh part " << i << " to mesh");
@@ -32,6 +32,25 @@ class ReconstructionPlan : public VoxelsGrid
 };
 
 void reconstructAccordingToOptimalReconstructionPlan(int gl, LargeScale* ls);
+
+/**
+ * @brief Compute the dimensions of a grid of at least nbTiles tiles over the given hexahedron,
+ *        the longest tile side is divided first to get tiles as cubic as possible.
+ * @param[in] hexah the hexahedron to divide
+ * @param[in] nbTiles the minimum number of tiles
+ * @return the number of tiles along each axis of the hexahedron
+ */
+Voxel computeTilesGridDimensions(const Point3d* hexah, int nbTiles);
+
+/**
+ * @brief Join the meshes of the given reconstruction folders, without connecting them.
+ * @note The triangles of each mesh outside its voxel inflated by borderInflateFactor are removed.
+ * @param[in] recsDirs the reconstruction folders (containing mesh.bin), missing meshes are skipped
+ * @param[in] voxelsArray the voxel of each reconstruction folder (8 points per voxel)
+ * @param[in] borderInflateFactor the voxel inflate factor used to remove the mesh borders
+ * @return the joined mesh
+ */
+mesh::Mesh* joinMeshes(const std::vector<std::string>& recsDirs, StaticVector<Point3d>* voxelsArray, float borderInflateFactor);
 mesh::Mesh* joinMeshes(const std::vector<std::string>& recsDirs, StaticVector<Point3d>* voxelsArray, LargeScale* ls);
 mesh::Mesh* joinMeshes(int gl, LargeScale* ls);
 mesh::Mesh* joinMeshes(const std::string& voxelsArrayFileName, LargeScale* ls);
@@ -0,0 +1,142 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <Eigen/Geometry>
+
+#include <algorithm>
+#include <numeric>
+#include <vector>
+
+namespace aliceVision {
+namespace geometry {
+
+/**
+ * @brief Bounding volume hierarchy over a static set of axis-aligned boxes.
+ *
+ * Used to find the boxes intersecting a query box without testing all of them.
+ * The tree is built top-down, each node is split at the median of the box centers along its largest axis.
+ * The nodes are stored in a flat array and the queries are read-only, so they can run in parallel.
+ */
+class AABBTree
+{
+  public:
+    using Box = Eigen::AlignedBox3d;
+
+    AABBTree() = default;
+
+    /**
+     * @param[in] boxes the boxes to index, referenced by their index in this vector
+     */
+    explicit AABBTree(const std::vector<Box>& boxes)
+      : _boxes(boxes)
+    {
+        if (_boxes.empty())
+            return;
+        _indices.resize(_boxes.size());
+        std::iota(_indices.begin(), _indices.end(), 0);
+        _nodes.resize(1);
+        build(0, 0, static_cast<int>(_boxes.size()));
+    }
+
+    /// number of indexed boxes
+    std::size_t size() const { return _boxes.size(); }
+
+    const Box& getBox(int index) const { return _boxes[index]; }
+
+    /**
+     * @brief Call f(index) for each indexed box intersecting the query box (touching boxes included).
+     * @param[in] query the query box
+     * @param[in] f the function called with the index of each intersecting box
+     */
+    template<class F>
+    void forEachIntersecting(const Box& query, F&& f) const
+    {
+        if (_nodes.empty())
+            return;
+
+        int stack[64];
+        int stackSize = 0;
+        stack[stackSize++] = 0;
+        while (stackSize > 0)
+        {
+            const Node& node = _nodes[stack[--stackSize]];
+            if (!node.box.intersects(query))
+                continue;
+
+            if (node.count > 0)
+            {
+                for (int i = node.first; i < node.first + node.count; ++i)
+                {
+                    if (_boxes[_indices[i]].intersects(query))
+                        f(_indices[i]);
+                }
+            }
+            else
+            {
+                stack[stackSize++] = node.first;
+                stack[stackSize++] = node.first + 1;
+            }
+        }
+    }
+
+  private:
+    static constexpr int maxLeafSize = 4;
+
+    struct Node
+    {
+        Box box;
+        /// first index in _indices for a leaf, index of the first child otherwise (the second one follows)
+        int first = 0;
+        /// number of boxes of a leaf, 0 for an inner node
+        int count = 0;
+    };
+
+    /**
+     * @brief Build the allocated node of the boxes in [first, last[ of _indices and its children.
+     * @param[in] nodeIndex the node index in _nodes
+     */
+    void build(int nodeIndex, int first, int last)
+    {
+        Box box;
+        Box centers;
+        for (int i = first; i < last; ++i)
+        {
+            box.extend(_boxes[_indices[i]]);
+            centers.extend(_boxes[_indices[i]].center());
+        }
+        _nodes[nodeIndex].box = box;
+
+        if (last - first <= maxLeafSize)
+        {
+            _nodes[nodeIndex].first = first;
+            _nodes[nodeIndex].count = last - first;
+            return;
+        }
+
+        int axis;
+        centers.sizes().maxCoeff(&axis);
+        const int middle = first + (last - first) / 2;
+        std::nth_element(_indices.begin() + first, _indices.begin() + middle, _indices.begin() + last, [&](int a, int b) {
+            return _boxes[a].center()(axis) < _boxes[b].center()(axis);
+        });
+
+        // children are allocated next to each other
+        const int leftIndex = static_cast<int>(_nodes.size());
+        _nodes.resize(_nodes.size() + 2);
+        _nodes[nodeIndex].first = leftIndex;
+        build(leftIndex, first, middle);
+        build(leftIndex + 1, middle, last);
+    }
+
+    std::vector<Box> _boxes;
+    std::vector<int> _indices;
+    std::vector<Node> _nodes;
+};
+
+}  // namespace geometry
+}  // namespace aliceVision
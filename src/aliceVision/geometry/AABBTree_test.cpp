@@ -0,0 +1,69 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <aliceVision/geometry/AABBTree.hpp>
+
+#include <random>
+#include <set>
+#include <utility>
+
+#define BOOST_TEST_MODULE AABBTree
+
+#include <boost/test/unit_test.hpp>
+
+using namespace aliceVision;
+using namespace aliceVision::geometry;
+
+BOOST_AUTO_TEST_CASE(AABBTree_empty)
+{
+    const AABBTree tree(std::vector<AABBTree::Box>{});
+    int count = 0;
+    tree.forEachIntersecting(AABBTree::Box(Eigen::Vector3d::Zero(), Eigen::Vector3d::Ones()), [&](int) { ++count; });
+    BOOST_CHECK_EQUAL(count, 0);
+}
+
+BOOST_AUTO_TEST_CASE(AABBTree_sameAsBruteForce)
+{
+    std::mt19937 generator(0);
+    std::uniform_real_distribution<double> positionDist(0.0, 100.0);
+    std::uniform_real_distribution<double> sizeDist(0.1, 5.0);
+
+    std::vector<AABBTree::Box> boxes(1000);
+    for (AABBTree::Box& box : boxes)
+    {
+        const Eigen::Vector3d min(positionDist(generator), positionDist(generator), positionDist(generator));
+        const Eigen::Vector3d size(sizeDist(generator), sizeDist(generator), sizeDist(generator));
+        box = AABBTree::Box(min, min + size);
+    }
+    // touching boxes are intersecting
+    boxes.push_back(AABBTree::Box(Eigen::Vector3d(200, 200, 200), Eigen::Vector3d(201, 201, 201)));
+    boxes.push_back(AABBTree::Box(Eigen::Vector3d(201, 200, 200), Eigen::Vector3d(202, 201, 201)));
+
+    const AABBTree tree(boxes);
+    BOOST_CHECK_EQUAL(tree.size(), boxes.size());
+
+    std::set<std::pair<int, int>> expectedPairs;
+    for (int i = 0; i < static_cast<int>(boxes.size()); ++i)
+    {
+        for (int j = i + 1; j < static_cast<int>(boxes.size()); ++j)
+        {
+            if (boxes[i].intersects(boxes[j]))
+                expectedPairs.insert(std::make_pair(i, j));
+        }
+    }
+
+    std::set<std::pair<int, int>> pairs;
+    for (int i = 0; i < static_cast<int>(boxes.size()); ++i)
+    {
+        tree.forEachIntersecting(boxes[i], [&](int j) {
+            if (j > i)
+                pairs.insert(std::make_pair(i, j));
+        });
+    }
+
+    BOOST_CHECK(pairs == expectedPairs);
+    BOOST_CHECK(pairs.count(std::make_pair(1000, 1001)) == 1);
+}
@@ -3,6 +3,11 @@
 #include <aliceVision/config.hpp>
 #include <aliceVision/system/Logger.hpp>
 
+#include <boost/property_tree/json_parser.hpp>
+#include <boost/property_tree/ptree.hpp>
+
+#include <algorithm>
+#include <cstdlib>
 #include <sstream>
 #include <memory.h>
 
@@ -162,5 +167,246 @@ std::string gpuInformationCUDA()
     return information;
 }
 
+#if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_CUDA)
+namespace {
+
+/**
+ * @brief Measure the bandwidth of a copy.
+ * @return the bandwidth in GB/s, 0 if the copy failed
+ */
+double measureCopyBandwidth(void* dst, const void* src, std::size_t size, cudaMemcpyKind kind, double bytesPerCopyFactor = 1.0)
+{
+    constexpr int nbCopies = 10;
+
+    cudaEvent_t start, stop;
+    cudaEventCreate(&start);
+    cudaEventCreate(&stop);
+
+    // warm-up copy
+    bool valid = (cudaMemcpy(dst, src, size, kind) == cudaSuccess);
+
+    cudaEventRecord(start);
+    for (int i = 0; valid && i < nbCopies; ++i)
+        valid = (cudaMemcpyAsync(dst, src, size, kind) == cudaSuccess);
+    cudaEventRecord(stop);
+    cudaEventSynchronize(stop);
+
+    float elapsedMs = 0.f;
+    cudaEventElapsedTime(&elapsedMs, start, stop);
+    cudaEventDestroy(start);
+    cudaEventDestroy(stop);
+
+    if (!valid || elapsedMs <= 0.f)
+    {
+        cudaGetLastError();  // clear error
+        return 0.0;
+    }
+    return bytesPerCopyFactor * double(size) * nbCopies / (elapsedMs * 1e-3) / 1e9;
+}
+
+}  // namespace
+#endif
+
+bool measureGpuProfileCUDA(int deviceId, GpuProfile& out_profile)
+{
+#if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_CUDA)
+    cudaDeviceProp deviceProperties;
+    if (cudaGetDeviceProperties(&deviceProperties, deviceId) != cudaSuccess || cudaSetDevice(deviceId) != cudaSuccess)
+    {
+        ALICEVISION_LOG_ERROR("Cannot profile the CUDA gpu device " << deviceId);
+        cudaGetLastError();  // clear error
+        return false;
+    }
+
+    out_profile = GpuProfile();
+    out_profile.name = deviceProperties.name;
+    out_profile.deviceId = deviceId;
+    out_profile.computeCapabilityMajor = deviceProperties.major;
+    out_profile.computeCapabilityMinor = deviceProperties.minor;
+    out_profile.totalMemoryMB = double(deviceProperties.totalGlobalMem) / (1024.0 * 1024.0);
+
+    // copy bandwidths
+    {
+        constexpr std::size_t bufferSize = 64 * 1024 * 1024;
+        void* hostBuffer = nullptr;
+        void* deviceBuffers[2] = {nullptr, nullptr};
+
+        if (cudaMallocHost(&hostBuffer, bufferSize) == cudaSuccess && cudaMalloc(&deviceBuffers[0], bufferSize) == cudaSuccess &&
+            cudaMalloc(&deviceBuffers[1], bufferSize) == cudaSuccess)
+        {
+            std::fill_n(static_cast<char*>(hostBuffer), bufferSize, 0);
+            out_profile.hostToDeviceBandwidthGBs = measureCopyBandwidth(deviceBuffers[0], hostBuffer, bufferSize, cudaMemcpyHostToDevice);
+            out_profile.deviceToHostBandwidthGBs = measureCopyBandwidth(hostBuffer, deviceBuffers[0], bufferSize, cudaMemcpyDeviceToHost);
+            // a device copy reads and writes the device memory
+            out_profile.deviceBandwidthGBs = measureCopyBandwidth(deviceBuffers[1], deviceBuffers[0], bufferSize, cudaMemcpyDeviceToDevice, 2.0);
+        }
+        else
+        {
+            ALICEVISION_LOG_WARNING("Cannot allocate the bandwidth benchmark buffers on the CUDA gpu device " << deviceId);
+            cudaGetLastError();  // clear error
+        }
+
+        cudaFreeHost(hostBuffer);
+        cudaFree(deviceBuffers[0]);
+        cudaFree(deviceBuffers[1]);
+    }
+
+    // allocatable memory, in blocks of the size of the typical depth map buffers
+    {
+        constexpr std::size_t blockSize = 32 * 1024 * 1024;
+        std::size_t available = 0, total = 0;
+        if (cudaMemGetInfo(&available, &total) == cudaSuccess && available > 0)
+        {
+            std::vector<void*> blocks;
+            void* block = nullptr;
+            while (cudaMalloc(&block, blockSize) == cudaSuccess)
+                blocks.push_back(block);
+            cudaGetLastError();  // clear the allocation error
+
+            for (void* allocatedBlock : blocks)
+                cudaFree(allocatedBlock);
+
+            out_profile.allocatableMemoryRatio = std::min(1.0, double(blocks.size() * blockSize) / double(available));
+        }
+        else
+        {
+            cudaGetLastError();  // clear error
+        }
+    }
+
+    ALICEVISION_LOG_INFO("GPU profile of the device " << deviceId << " (" << out_profile.name << "):" << std::endl
+                                                      << "\t- allocatable memory ratio: " << out_profile.allocatableMemoryRatio << std::endl
+                                                      << "\t- host to device bandwidth: " << out_profile.hostToDeviceBandwidthGBs << " GB/s" << std::endl
+                                                      << "\t- device to host bandwidth: " << out_profile.deviceToHostBandwidthGBs << " GB/s" << std::endl
+                                                      << "\t- device bandwidth:         " << out_profile.deviceBandwidthGBs << " GB/s");
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool measureGpuProfilesCUDA(std::vector<GpuProfile>& out_profiles)
+{
+    out_profiles.clear();
+#if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_CUDA)
+    int nbDevices = 0;
+    if (cudaGetDeviceCount(&nbDevices) != cudaSuccess)
+    {
+        ALICEVISION_LOG_WARNING("Could not determine number of CUDA cards in this system");
+        nbDevices = 0;
+    }
+
+    for (int deviceId = 0; deviceId < nbDevices; ++deviceId)
+    {
+        GpuProfile profile;
+        if (measureGpuProfileCUDA(deviceId, profile))
+            out_profiles.push_back(profile);
+    }
+#endif
+    return !out_profiles.empty();
+}
+
+bool writeGpuProfiles(const std::string& filepath, const std::vector<GpuProfile>& profiles)
+{
+    namespace bpt = boost::property_tree;
+
+    bpt::ptree gpusTree;
+    for (const GpuProfile& profile : profiles)
+    {
+        bpt::ptree gpuTree;
+        gpuTree.put("name", profile.name);
+        gpuTree.put("deviceId", profile.deviceId);
+        gpuTree.put("computeCapabilityMajor", profile.computeCapabilityMajor);
+        gpuTree.put("computeCapabilityMinor", profile.computeCapabilityMinor);
+        gpuTree.put("totalMemoryMB", profile.totalMemoryMB);
+        gpuTree.put("allocatableMemoryRatio", profile.allocatableMemoryRatio);
+        gpuTree.put("hostToDeviceBandwidthGBs", profile.hostToDeviceBandwidthGBs);
+        gpuTree.put("deviceToHostBandwidthGBs", profile.deviceToHostBandwidthGBs);
+        gpuTree.put("deviceBandwidthGBs", profile.deviceBandwidthGBs);
+        gpusTree.push_back(std::make_pair("", gpuTree));
+    }
+
+    bpt::ptree fileTree;
+    fileTree.add_child("gpus", gpusTree);
+
+    try
+    {
+        bpt::write_json(filepath, fileTree);
+    }
+    catch (const bpt::json_parser_error& e)
+    {
+        ALICEVISION_LOG_ERROR("Cannot write the GPU profiles file '" << filepath << "': " << e.what());
+        return false;
+    }
+    return true;
+}
+
+bool readGpuProfiles(const std::string& filepath, std::vector<GpuProfile>& out_profiles)
+{
+    namespace bpt = boost::property_tree;
+
+    out_profiles.clear();
+    try
+    {
+        bpt::ptree fileTree;
+        bpt::read_json(filepath, fileTree);
+
+        for (const bpt::ptree::value_type& gpuNode : fileTree.get_child("gpus"))
+        {
+            const bpt::ptree& gpuTree = gpuNode.second;
+            GpuProfile profile;
+            profile.name = gpuTree.get<std::string>("name");
+            profile.deviceId = gpuTree.get<int>("deviceId", -1);
+            profile.computeCapabilityMajor = gpuTree.get<int>("computeCapabilityMajor", 0);
+            profile.computeCapabilityMinor = gpuTree.get<int>("computeCapabilityMinor", 0);
+            profile.totalMemoryMB = gpuTree.get<double>("totalMemoryMB", 0.0);
+            profile.allocatableMemoryRatio = gpuTree.get<double>("allocatableMemoryRatio", 0.0);
+            profile.hostToDeviceBandwidthGBs = gpuTree.get<double>("hostToDeviceBandwidthGBs", 0.0);
+            profile.deviceToHostBandwidthGBs = gpuTree.get<double>("deviceToHostBandwidthGBs", 0.0);
+            profile.deviceBandwidthGBs = gpuTree.get<double>("deviceBandwidthGBs", 0.0);
+            out_profiles.push_back(profile);
+        }
+    }
+    catch (const bpt::ptree_error& e)
+    {
+        ALICEVISION_LOG_WARNING("Cannot read the GPU profiles file '" << filepath << "': " << e.what());
+        out_profiles.clear();
+        return false;
+    }
+    return true;
+}
+
+bool getCurrentGpuProfileCUDA(GpuProfile& out_profile)
+{
+#if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_CUDA)
+    const char* profilesFilepath = std::getenv("ALICEVISION_GPU_PROFILE");
+    if (profilesFilepath == nullptr || profilesFilepath[0] == '\0')
+        return false;
+
+    int deviceId = 0;
+    cudaDeviceProp deviceProperties;
+    if (cudaGetDevice(&deviceId) != cudaSuccess || cudaGetDeviceProperties(&deviceProperties, deviceId) != cudaSuccess)
+    {
+        cudaGetLastError();  // clear error
+        return false;
+    }
+
+    std::vector<GpuProfile> profiles;
+    if (!readGpuProfiles(profilesFilepath, profiles))
+        return false;
+
+    const auto it = std::find_if(profiles.begin(), profiles.end(), [&](const GpuProfile& profile) { return profile.name == deviceProperties.name; });
+    if (it == profiles.end())
+    {
+        ALICEVISION_LOG_WARNING("No GPU profile for the device '" << deviceProperties.name << "' in '" << profilesFilepath << "'.");
+        return false;
+    }
+    out_profile = *it;
+    return true;
+#else
+    return false;
+#endif
+}
+
 }  // namespace gpu
 }  // namespace aliceVision
@@ -7,6 +7,7 @@
 #pragma once
 
 #include <string>
+#include <vector>
 
 namespace aliceVision {
 namespace gpu {
@@ -26,5 +27,67 @@ bool gpuSupportCUDA(int minComputeCapabilityMajor, int minComputeCapabilityMinor
  */
 std::string gpuInformationCUDA();
 
+/**
+ * @brief Measured capabilities of a GPU, used to size the GPU computations.
+ */
+struct GpuProfile
+{
+    /// device name, the key of the profile
+    std::string name;
+    int deviceId = -1;
+    int computeCapabilityMajor = 0;
+    int computeCapabilityMinor = 0;
+    double totalMemoryMB = 0.0;
+    /// fraction of the available memory that can be allocated in blocks of a typical buffer size
+    double allocatableMemoryRatio = 0.0;
+    /// pinned host to device copy bandwidth
+    double hostToDeviceBandwidthGBs = 0.0;
+    /// device to pinned host copy bandwidth
+    double deviceToHostBandwidthGBs = 0.0;
+    /// device to device copy bandwidth (read + write)
+    double deviceBandwidthGBs = 0.0;
+};
+
+/**
+ * @brief Run a short calibration benchmark on a CUDA device.
+ * @note The benchmark allocates most of the available device memory for a moment.
+ * @param[in] deviceId the CUDA device id
+ * @param[out] out_profile the measured profile
+ * @return false if the device cannot be profiled or if AliceVision is built without CUDA
+ */
+bool measureGpuProfileCUDA(int deviceId, GpuProfile& out_profile);
+
+/**
+ * @brief Run the calibration benchmark on all the CUDA devices, see measureGpuProfileCUDA.
+ * @param[out] out_profiles the measured profiles
+ * @return false if no device can be profiled
+ */
+bool measureGpuProfilesCUDA(std::vector<GpuProfile>& out_profiles);
+
+/**
+ * @brief Write GPU profiles in a JSON file.
+ * @param[in] filepath the JSON file path
+ * @param[in] profiles the GPU profiles
+ * @return false if the file cannot be written
+ */
+bool writeGpuProfiles(const std::string& filepath, const std::vector<GpuProfile>& profiles);
+
+/**
+ * @brief Read GPU profiles from a JSON file.
+ * @param[in] filepath the JSON file path
+ * @param[out] out_profiles the GPU profiles
+ * @return false if the file cannot be read
+ */
+bool readGpuProfiles(const std::string& filepath, std::vector<GpuProfile>& out_profiles);
+
+/**
+ * @brief Get the profile of the current CUDA device from the file of the ALICEVISION_GPU_PROFILE environment variable,
+ *        written by the hardwareResources software.
+ * @note The profiles are matched by device name.
+ * @param[out] out_profile the profile of the current device
+ * @return false if there is no profile for the current device
+ */
+bool getCurrentGpuProfileCUDA(GpuProfile& out_profile);
+
 }  // namespace gpu
 }  // namespace aliceVision
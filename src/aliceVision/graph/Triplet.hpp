@@ -13,6 +13,8 @@
 #include <lemon/list_graph.h>
 
 #include <algorithm>
+#include <iterator>
+#include <map>
 #include <vector>
 
 namespace aliceVision {
@@ -113,27 +115,57 @@ bool List_Triplets(const GraphT& g, std::vector<Triplet>& vec_triplets)
 }
 
 /// Return triplets contained in the graph build from IterablePairs
+/// Each triplet is found once from its two smallest nodes, by intersecting their sorted lists
+/// of neighbours with a higher id. The nodes are processed in parallel and the triplets are
+/// returned in ascending order.
 template<typename IterablePairs>
 inline std::vector<graph::Triplet> tripletListing(const IterablePairs& pairs)
 {
-    std::vector<graph::Triplet> vec_triplets;
+    // Neighbours with a higher id of each node (the pairs may be given in both directions)
+    std::map<IndexT, std::vector<IndexT>> map_upperNeighbours;
+    for (const auto& pair : pairs)
+    {
+        if (pair.first != pair.second)
+            map_upperNeighbours[std::min(pair.first, pair.second)].push_back(std::max(pair.first, pair.second));
+    }
 
-    indexedGraph putativeGraph(pairs);
+    std::vector<std::pair<IndexT, std::vector<IndexT>*>> vec_nodes;
+    vec_nodes.reserve(map_upperNeighbours.size());
+    for (auto& node : map_upperNeighbours)
+    {
+        std::vector<IndexT>& neighbours = node.second;
+        std::sort(neighbours.begin(), neighbours.end());
+        neighbours.erase(std::unique(neighbours.begin(), neighbours.end()), neighbours.end());
+        vec_nodes.emplace_back(node.first, &neighbours);
+    }
 
-    graph::List_Triplets<indexedGraph::GraphT>(putativeGraph.g, vec_triplets);
+    std::vector<std::vector<graph::Triplet>> vec_tripletsPerNode(vec_nodes.size());
 
-    // Change triplets to ImageIds
-    for (size_t i = 0; i < vec_triplets.size(); ++i)
+#pragma omp parallel for schedule(dynamic)
+    for (int n = 0; n < (int)vec_nodes.size(); ++n)
     {
-        graph::Triplet& triplet = vec_triplets[i];
-        IndexT I = triplet.i, J = triplet.j, K = triplet.k;
-        I = (*putativeGraph.map_nodeMapIndex)[putativeGraph.g.nodeFromId(I)];
-        J = (*putativeGraph.map_nodeMapIndex)[putativeGraph.g.nodeFromId(J)];
-        K = (*putativeGraph.map_nodeMapIndex)[putativeGraph.g.nodeFromId(K)];
-        IndexT triplet_[3] = {I, J, K};
-        std::sort(&triplet_[0], &triplet_[3]);
-        triplet = graph::Triplet(triplet_[0], triplet_[1], triplet_[2]);
+        const IndexT I = vec_nodes[n].first;
+        const std::vector<IndexT>& neighboursI = *vec_nodes[n].second;
+        std::vector<IndexT> vec_commonNeighbours;
+
+        for (auto itJ = neighboursI.begin(); itJ != neighboursI.end(); ++itJ)
+        {
+            const auto itNeighboursJ = map_upperNeighbours.find(*itJ);
+            if (itNeighboursJ == map_upperNeighbours.end())
+                continue;
+            const std::vector<IndexT>& neighboursJ = itNeighboursJ->second;
+
+            // K > J linked to I and J
+            vec_commonNeighbours.clear();
+            std::set_intersection(std::next(itJ), neighboursI.end(), neighboursJ.begin(), neighboursJ.end(), std::back_inserter(vec_commonNeighbours));
+            for (const IndexT K : vec_commonNeighbours)
+                vec_tripletsPerNode[n].emplace_back(I, *itJ, K);
+        }
     }
+
+    std::vector<graph::Triplet> vec_triplets;
+    for (const std::vector<graph::Triplet>& triplets : vec_tripletsPerNode)
+        vec_triplets.insert(vec_triplets.end(), triplets.begin(), triplets.end());
     return vec_triplets;
 }
 
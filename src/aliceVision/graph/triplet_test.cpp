@@ -8,6 +8,8 @@
 #include "aliceVision/graph/Triplet.hpp"
 
 #include <iostream>
+#include <set>
+#include <tuple>
 #include <vector>
 
 #define BOOST_TEST_MODULE tripletFinder
@@ -15,6 +17,7 @@
 #include <boost/test/unit_test.hpp>
 #include <boost/test/tools/floating_point_comparison.hpp>
 
+using namespace aliceVision;
 using namespace aliceVision::graph;
 
 BOOST_AUTO_TEST_CASE(test_no_triplet)
@@ -254,3 +257,34 @@ BOOST_AUTO_TEST_CASE(test_for_triplet)
         BOOST_CHECK_EQUAL(4, vec_triplets.size());
     }
 }
+
+BOOST_AUTO_TEST_CASE(test_triplet_listing)
+{
+    // complete graph of 5 nodes, with pairs given in both directions and a self loop
+    std::set<std::pair<IndexT, IndexT>> pairs;
+    for (IndexT i = 0; i < 5; ++i)
+    {
+        for (IndexT j = i + 1; j < 5; ++j)
+        {
+            pairs.emplace(i, j);
+            if ((i + j) % 2)
+                pairs.emplace(j, i);
+        }
+    }
+    pairs.emplace(2, 2);
+
+    const std::vector<Triplet> vec_triplets = tripletListing(pairs);
+    BOOST_CHECK_EQUAL(10, vec_triplets.size());
+
+    // the triplets are unique and in ascending order
+    for (std::size_t t = 0; t < vec_triplets.size(); ++t)
+    {
+        const Triplet& triplet = vec_triplets[t];
+        BOOST_CHECK(triplet.i < triplet.j && triplet.j < triplet.k);
+        if (t > 0)
+        {
+            const Triplet& previous = vec_triplets[t - 1];
+            BOOST_CHECK(std::make_tuple(previous.i, previous.j, previous.k) < std::make_tuple(triplet.i, triplet.j, triplet.k));
+        }
+    }
+}
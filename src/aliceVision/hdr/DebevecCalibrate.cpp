@@ -14,6 +14,7 @@
 
 #include <OpenImageIO/imagebufalgo.h>
 
+#include <algorithm>
 #include <iostream>
 #include <fstream>
 #include <cassert>
@@ -45,35 +46,32 @@ bool DebevecCalibrate::process(const std::vector<std::vector<ImageSample>>& ldrS
     // Initialize response
     response = rgbCurve(channelQuantization);
 
-    // Store intermediate data for all three channels
-
-    // Initialize intermediate buffers
-    for (unsigned int channel = 0; channel < channelsCount; ++channel)
+    // The unknowns are the response curve (channelQuantization values) and the log irradiance of each sample.
+    // Each sample only appears in the equations of its own brackets, so the irradiances are eliminated
+    // sample by sample (Schur complement) and only the small dense system of the response curve is solved.
+    // The channels are independent and solved concurrently.
+#pragma omp parallel for
+    for (int channel = 0; channel < int(channelsCount); ++channel)
     {
-        Eigen::MatrixXd A(channelQuantization, channelQuantization);
-        Eigen::MatrixXd B(channelQuantization, totalPoints);
-        Eigen::DiagonalMatrix<double, Eigen::Dynamic> Dinv(totalPoints);
-        Eigen::VectorXd h1(channelQuantization);
-        Eigen::VectorXd h2(totalPoints);
-
-        // Initialize
-        A.fill(0);
-        B.fill(0);
-        h1.fill(0);
-        h2.fill(0);
-        Dinv.setZero();
-
-        size_t countPoints = 0;
+        Eigen::MatrixXd left = Eigen::MatrixXd::Zero(channelQuantization, channelQuantization);
+        Eigen::VectorXd right = Eigen::VectorXd::Zero(channelQuantization);
+
+        // Non zero coefficients of the sample column of the full system: (response index, -w_ij^2)
+        std::vector<std::pair<std::size_t, double>> column;
+
         for (size_t groupId = 0; groupId < ldrSamples.size(); groupId++)
         {
             /*Process a group of brackets*/
             const std::vector<ImageSample>& group = ldrSamples[groupId];
-            const std::vector<double>& local_times = times[groupId];
 
             for (size_t sampleId = 0; sampleId < group.size(); sampleId++)
             {
                 const ImageSample& sample = group[sampleId];
 
+                double d = 0.0;
+                double h2 = 0.0;
+                column.clear();
+
                 for (size_t bracketPos = 0; bracketPos < sample.descriptions.size(); bracketPos++)
                 {
                     const float time = std::log(sample.descriptions[bracketPos].exposure);
@@ -84,20 +82,43 @@ bool DebevecCalibrate::process(const std::vector<std::vector<ImageSample>>& ldrS
 
                     const float w_ij = std::max(1e-6f, weight(value, channel));
 
-                    const std::size_t pospoint = countPoints + sampleId;
-
                     const double w_ij_2 = w_ij * w_ij;
                     const double w_ij2_time = w_ij_2 * time;
 
-                    Dinv.diagonal()[pospoint] += w_ij_2;
-                    A(index, index) += w_ij_2;
-                    B(index, pospoint) -= w_ij_2;
-                    h1(index) += w_ij2_time;
-                    h2(pospoint) += -w_ij2_time;
+                    d += w_ij_2;
+                    left(index, index) += w_ij_2;
+                    right(index) += w_ij2_time;
+                    h2 += -w_ij2_time;
+
+                    // Several brackets of the same sample may fall in the same bin
+                    auto it = std::find_if(column.begin(), column.end(), [index](const std::pair<std::size_t, double>& c) { return c.first == index; });
+                    if (it == column.end())
+                    {
+                        column.emplace_back(index, -w_ij_2);
+                    }
+                    else
+                    {
+                        it->second -= w_ij_2;
+                    }
+                }
+
+                if (column.empty())
+                {
+                    continue;
                 }
-            }
 
-            countPoints += group.size();
+                // left -= b * b^T / d, right -= b * h2 / d
+                const double dinv = 1.0 / d;
+                for (const auto& ci : column)
+                {
+                    const double bi = ci.second * dinv;
+                    for (const auto& cj : column)
+                    {
+                        left(ci.first, cj.first) -= bi * cj.second;
+                    }
+                    right(ci.first) -= bi * h2;
+                }
+            }
         }
 
         // Make sure the discrete response curve has a minimal second derivative
@@ -111,17 +132,17 @@ bool DebevecCalibrate::process(const std::vector<std::vector<ImageSample>>& ldrS
             const double v2 = -2.0f * lambda * w;
             const double v3 = lambda * w;
 
-            A(k, k) += v1 * v1;
-            A(k, k + 1) += v1 * v2;
-            A(k, k + 2) += v1 * v3;
+            left(k, k) += v1 * v1;
+            left(k, k + 1) += v1 * v2;
+            left(k, k + 2) += v1 * v3;
 
-            A(k + 1, k) += v2 * v1;
-            A(k + 1, k + 1) += v2 * v2;
-            A(k + 1, k + 2) += v2 * v3;
+            left(k + 1, k) += v2 * v1;
+            left(k + 1, k + 1) += v2 * v2;
+            left(k + 1, k + 2) += v2 * v3;
 
-            A(k + 2, k) += v3 * v1;
-            A(k + 2, k + 1) += v3 * v2;
-            A(k + 2, k + 2) += v3 * v3;
+            left(k + 2, k) += v3 * v1;
+            left(k + 2, k + 1) += v3 * v2;
+            left(k + 2, k + 2) += v3 * v3;
         }
 
         //
@@ -129,31 +150,15 @@ bool DebevecCalibrate::process(const std::vector<std::vector<ImageSample>>& ldrS
         // Enforce f(0.5) = 0.0
         //
         const size_t pos_middle = std::floor(channelQuantization / 2);
-        A(pos_middle, pos_middle) += 1.0f;
+        left(pos_middle, pos_middle) += 1.0f;
 
-        // M is
+        // The full normal equations are
         //
-        // [ATL ATR]   [[Mgradient       ][     0]]
-        // [ABL ABR] = [[constraintMiddle][     0]]
-        //             [Mleft               Mright]
+        // [A  B] [f]   [h1]
+        // [B^T D] [g] = [h2]
         //
-        // [A B] = [Atl Atr]^T [Atl Atr] = [Atl   0]^T [Atl   0]
-        // [C D]   [Abl Abr]   [Abl Abr]   [Abl Abr]   [Abl Abr]
-        // [A B] = [Atl^T Abl^T][Atl   0] = [Atl^TAtl + Abl^TAbl Abl^TAbr]
-        // [C D]   [0     Abr^T][Abl Abr]   [Abr^TAbl            Abr^TAbr]
-        // [h1] = [Atl^T bh + Abl^T bb] = [Abl^T bb]
-        // [h2]   [Atr^T bh + Abr^T bb]   [Abr^T bb]
-        const Eigen::MatrixXd C = B.transpose();
-
-        for (int i = 0; i < Dinv.rows(); i++)
-        {
-            Dinv.diagonal()[i] = 1.0 / Dinv.diagonal()[i];
-        }
-
-        const Eigen::MatrixXd Bdinv = B * Dinv;
-        const Eigen::MatrixXd left = A - Bdinv * C;
-        const Eigen::VectorXd right = h1 - Bdinv * h2;
-
+        // with D diagonal (one value per sample) and B having one non zero per bracket of each sample column.
+        // Eliminating g gives (A - B D^-1 B^T) f = h1 - B D^-1 h2, accumulated above sample by sample.
         const Eigen::VectorXd x = left.lu().solve(right);
 
         // Copy the result to the response curve
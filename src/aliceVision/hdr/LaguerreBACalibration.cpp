@@ -8,12 +8,16 @@
 #include "sampling.hpp"
 
 #include <aliceVision/alicevision_omp.hpp>
+#include <aliceVision/numeric/numeric.hpp>
 #include <aliceVision/system/Logger.hpp>
 
 #include <Eigen/Dense>
 
 #include <ceres/ceres.h>
 
+#include <algorithm>
+#include <array>
+#include <map>
 #include <utility>
 #include <iostream>
 #include <cassert>
@@ -70,59 +74,105 @@ double d_laguerreFunction_d_x(double a, double x)
                                   d_atanx_d_denom * d_denom_d_cos_m_pi_x * d_cos_m_pi_x_d_m_pi_x * d_m_pi_x_d_x);
 }
 
-class HdrResidualAnalytic : public ceres::SizedCostFunction<2, 1, 1>
+/**
+ * @brief Colors of a sample in two consecutive brackets, with the sine and cosine of the Laguerre function
+ *        which only depend on the colors.
+ */
+struct HdrSamplePair
 {
-  public:
-    HdrResidualAnalytic(double a, double b)
-      : _colorA(a),
-        _colorB(b)
+    HdrSamplePair() = default;
+
+    HdrSamplePair(double a, double b)
+      : colorA(a),
+        colorB(b),
+        sinA(sin(M_PI * a)),
+        cosA(cos(M_PI * a)),
+        sinB(sin(M_PI * b)),
+        cosB(cos(M_PI * b))
     {}
 
+    double colorA = 0.0;
+    double colorB = 0.0;
+    double sinA = 0.0;
+    double cosA = 1.0;
+    double sinB = 0.0;
+    double cosB = 1.0;
+};
+
+/**
+ * @brief Residuals of a batch of samples of the same channel and exposure pair.
+ *
+ * Each sample has the 2 residuals of the symmetric transfer error between the two brackets.
+ * Ceres handles a few large residual blocks much better than millions of tiny ones,
+ * and the terms of the inverse Laguerre function of the sample colors are precomputed.
+ */
+class HdrBatchResidualAnalytic : public ceres::CostFunction
+{
+  public:
+    explicit HdrBatchResidualAnalytic(std::vector<HdrSamplePair>&& samples)
+      : _samples(std::move(samples))
+    {
+        set_num_residuals(2 * _samples.size());
+        mutable_parameter_block_sizes()->push_back(1);
+        mutable_parameter_block_sizes()->push_back(1);
+    }
+
     bool Evaluate(double const* const* parameters, double* residuals, double** jacobians) const override
     {
-        double laguerre_param = parameters[0][0];
-        double ratio_expB_over_expA = parameters[1][0];
+        const double laguerre_param = parameters[0][0];
+        const double ratio_expB_over_expA = parameters[1][0];
 
-        double a = laguerreFunctionInv(laguerre_param, _colorA) * ratio_expB_over_expA;
-        double b = laguerreFunctionInv(laguerre_param, _colorB) / ratio_expB_over_expA;
+        const double c = 2.0 / M_PI;
 
-        double errorCost_1 = laguerreFunction(laguerre_param, a) - _colorB;
-        double errorCost_2 = laguerreFunction(laguerre_param, b) - _colorA;
+        for (std::size_t i = 0; i < _samples.size(); ++i)
+        {
+            const HdrSamplePair& sample = _samples[i];
 
-        residuals[0] = errorCost_1;
-        residuals[1] = errorCost_2;
+            // inverse Laguerre function of the sample colors and its derivative, laguerreFunction(-laguerre_param, color)
+            const double nomA = -laguerre_param * sample.sinA;
+            const double denomA = 1.0 + laguerre_param * sample.cosA;
+            const double nomB = -laguerre_param * sample.sinB;
+            const double denomB = 1.0 + laguerre_param * sample.cosB;
 
-        if (jacobians == nullptr)
-        {
-            return true;
-        }
+            const double invA = sample.colorA + c * atan(nomA / denomA);
+            const double invB = sample.colorB + c * atan(nomB / denomB);
 
-        if (jacobians[0] != nullptr)
-        {
-            double d_errorCost_1_d_laguerre_param =
-              d_laguerreFunction_d_param(laguerre_param, a) +
-              d_laguerreFunction_d_x(laguerre_param, a) * ratio_expB_over_expA * -d_laguerreFunction_d_param(-laguerre_param, _colorA);
-            double d_errorCost_2_d_laguerre_param =
-              d_laguerreFunction_d_param(laguerre_param, b) +
-              d_laguerreFunction_d_x(laguerre_param, b) / ratio_expB_over_expA * -d_laguerreFunction_d_param(-laguerre_param, _colorB);
-
-            jacobians[0][0] = d_errorCost_1_d_laguerre_param;
-            jacobians[0][1] = d_errorCost_2_d_laguerre_param;
-        }
+            const double a = invA * ratio_expB_over_expA;
+            const double b = invB / ratio_expB_over_expA;
 
-        if (jacobians[1] != nullptr)
-        {
-            jacobians[1][0] = d_laguerreFunction_d_x(laguerre_param, a) * laguerreFunctionInv(laguerre_param, _colorA);
-            jacobians[1][1] = d_laguerreFunction_d_x(laguerre_param, b) * laguerreFunctionInv(laguerre_param, _colorB) *
-                              (-1.0 / (ratio_expB_over_expA * ratio_expB_over_expA));
+            residuals[2 * i] = laguerreFunction(laguerre_param, a) - sample.colorB;
+            residuals[2 * i + 1] = laguerreFunction(laguerre_param, b) - sample.colorA;
+
+            if (jacobians == nullptr)
+            {
+                continue;
+            }
+
+            const double d_laguerre_d_x_a = d_laguerreFunction_d_x(laguerre_param, a);
+            const double d_laguerre_d_x_b = d_laguerreFunction_d_x(laguerre_param, b);
+
+            if (jacobians[0] != nullptr)
+            {
+                const double d_invA_d_minus_param = c * (denomA * sample.sinA + nomA * sample.cosA) / (nomA * nomA + denomA * denomA);
+                const double d_invB_d_minus_param = c * (denomB * sample.sinB + nomB * sample.cosB) / (nomB * nomB + denomB * denomB);
+
+                jacobians[0][2 * i] = d_laguerreFunction_d_param(laguerre_param, a) + d_laguerre_d_x_a * ratio_expB_over_expA * -d_invA_d_minus_param;
+                jacobians[0][2 * i + 1] =
+                  d_laguerreFunction_d_param(laguerre_param, b) + d_laguerre_d_x_b / ratio_expB_over_expA * -d_invB_d_minus_param;
+            }
+
+            if (jacobians[1] != nullptr)
+            {
+                jacobians[1][2 * i] = d_laguerre_d_x_a * invA;
+                jacobians[1][2 * i + 1] = d_laguerre_d_x_b * invB * (-1.0 / (ratio_expB_over_expA * ratio_expB_over_expA));
+            }
         }
 
         return true;
     }
 
   private:
-    double _colorA;
-    double _colorB;
+    const std::vector<HdrSamplePair> _samples;
 };
 
 class ExposureConstraint : public ceres::SizedCostFunction<1, 1>
@@ -184,33 +234,107 @@ void LaguerreBACalibration::process(const std::vector<std::vector<ImageSample>>&
         problem.AddParameterBlock(&param.second, 1);
     }
 
-    // Convert selected samples into residual blocks
+    // index of each exposure pair parameter
+    std::vector<double*> exposurePairsParams;
+    std::map<std::pair<double, double>, std::size_t> exposurePairsIndex;
+    for (auto& param : exposureParameters)
+    {
+        exposurePairsIndex[param.first] = exposurePairsParams.size();
+        exposurePairsParams.push_back(&param.second);
+    }
+    const std::size_t nbExposurePairs = exposurePairsParams.size();
+
+    const auto getExposurePairIndex = [&](const ImageSample& sample, int bracketPos) -> int {
+        const auto it =
+          exposurePairsIndex.find(std::pair<double, double>(sample.descriptions[bracketPos].exposure, sample.descriptions[bracketPos + 1].exposure));
+        return (it == exposurePairsIndex.end()) ? -1 : int(it->second);
+    };
+
+    // count the sample pairs of each group per exposure pair
+    std::vector<std::vector<std::size_t>> nbSamplePairsPerGroup(ldrSamples.size(), std::vector<std::size_t>(nbExposurePairs, 0));
+    std::size_t nbIgnoredSamplePairs = 0;
+
+#pragma omp parallel for reduction(+ : nbIgnoredSamplePairs)
     for (int groupId = 0; groupId < ldrSamples.size(); ++groupId)
     {
-        const std::vector<ImageSample>& group = ldrSamples[groupId];
+        for (const ImageSample& sample : ldrSamples[groupId])
+        {
+            for (int bracketPos = 0; bracketPos < int(sample.descriptions.size()) - 1; bracketPos++)
+            {
+                const int exposurePairIndex = getExposurePairIndex(sample, bracketPos);
+                if (exposurePairIndex < 0)
+                    ++nbIgnoredSamplePairs;
+                else
+                    ++nbSamplePairsPerGroup[groupId][exposurePairIndex];
+            }
+        }
+    }
+
+    if (nbIgnoredSamplePairs > 0)
+    {
+        ALICEVISION_LOG_WARNING(nbIgnoredSamplePairs << " sample pairs ignored, their exposures are not consecutive exposures of a group.");
+    }
+
+    // the sample pairs of each exposure pair are stored in the groups order, whatever the number of threads,
+    // and split into batches of residuals
+    const std::size_t batchSize = 1024;
 
-        for (int sampleId = 0; sampleId < group.size(); sampleId++)
+    std::vector<std::vector<std::size_t>> offsetsPerGroup(ldrSamples.size(), std::vector<std::size_t>(nbExposurePairs, 0));
+    std::vector<std::array<std::vector<std::vector<HdrSamplePair>>, 3>> samplePairsBatches(nbExposurePairs);
+    for (std::size_t exposurePairIndex = 0; exposurePairIndex < nbExposurePairs; ++exposurePairIndex)
+    {
+        std::size_t offset = 0;
+        for (std::size_t groupId = 0; groupId < ldrSamples.size(); ++groupId)
         {
-            const ImageSample& sample = group[sampleId];
+            offsetsPerGroup[groupId][exposurePairIndex] = offset;
+            offset += nbSamplePairsPerGroup[groupId][exposurePairIndex];
+        }
 
-            for (int bracketPos = 0; bracketPos < sample.descriptions.size() - 1; bracketPos++)
-            {
-                std::pair<double, double> exposurePair;
-                exposurePair.first = sample.descriptions[bracketPos].exposure;
-                exposurePair.second = sample.descriptions[bracketPos + 1].exposure;
+        for (int channel = 0; channel < 3; channel++)
+        {
+            std::vector<std::vector<HdrSamplePair>>& batches = samplePairsBatches[exposurePairIndex][channel];
+            batches.resize(divideRoundUp(offset, batchSize));
+            for (std::size_t batchId = 0; batchId < batches.size(); ++batchId)
+                batches[batchId].resize(std::min(batchSize, offset - batchId * batchSize));
+        }
+    }
+
+#pragma omp parallel for
+    for (int groupId = 0; groupId < ldrSamples.size(); ++groupId)
+    {
+        std::vector<std::size_t>& offsets = offsetsPerGroup[groupId];
 
-                double* expParam = &exposureParameters[exposurePair];
+        for (const ImageSample& sample : ldrSamples[groupId])
+        {
+            for (int bracketPos = 0; bracketPos < int(sample.descriptions.size()) - 1; bracketPos++)
+            {
+                const int exposurePairIndex = getExposurePairIndex(sample, bracketPos);
+                if (exposurePairIndex < 0)
+                    continue;
 
+                const std::size_t offset = offsets[exposurePairIndex]++;
                 for (int channel = 0; channel < 3; channel++)
                 {
-                    ceres::CostFunction* cost =
-                      new HdrResidualAnalytic(sample.descriptions[bracketPos].mean(channel), sample.descriptions[bracketPos + 1].mean(channel));
-                    problem.AddResidualBlock(cost, lossFunction, &(laguerreParam.data()[channel]), expParam);
+                    samplePairsBatches[exposurePairIndex][channel][offset / batchSize][offset % batchSize] =
+                      HdrSamplePair(sample.descriptions[bracketPos].mean(channel), sample.descriptions[bracketPos + 1].mean(channel));
                 }
             }
         }
     }
 
+    // Convert selected samples into residual blocks, one per batch of samples
+    for (std::size_t exposurePairIndex = 0; exposurePairIndex < nbExposurePairs; ++exposurePairIndex)
+    {
+        for (int channel = 0; channel < 3; channel++)
+        {
+            for (std::vector<HdrSamplePair>& batch : samplePairsBatches[exposurePairIndex][channel])
+            {
+                ceres::CostFunction* cost = new HdrBatchResidualAnalytic(std::move(batch));
+                problem.AddResidualBlock(cost, lossFunction, &(laguerreParam.data()[channel]), exposurePairsParams[exposurePairIndex]);
+            }
+        }
+    }
+
     if (!refineExposures)
     {
         for (auto& param : exposureParameters)
@@ -238,6 +362,7 @@ void LaguerreBACalibration::process(const std::vector<std::vector<ImageSample>>&
     solverOptions.max_num_iterations = 100;
     solverOptions.function_tolerance = 1e-16;
     solverOptions.parameter_tolerance = 1e-16;
+    solverOptions.num_threads = omp_get_max_threads();
 
     ceres::Solver::Summary summary;
     ceres::Solve(solverOptions, &problem, &summary);
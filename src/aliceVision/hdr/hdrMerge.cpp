@@ -83,111 +83,95 @@ void hdrMerge::process(const std::vector<image::Image<image::RGBfColor>>& images
     lowLight.resize(width, height, true, image::RGBfColor(0.f, 0.f, 0.f));
     noMidLight.resize(width, height, true, image::RGBfColor(0.f, 0.f, 0.f));
 
-#pragma omp parallel for
-    for (int y = 0; y < height; ++y)
-    {
-        for (int x = 0; x < width; ++x)
-        {
-            // for each pixels
-            image::RGBfColor& radianceColor = radiance(y, x);
-            image::RGBfColor& highLightColor = highLight(y, x);
-            image::RGBfColor& lowLightColor = lowLight(y, x);
-            image::RGBfColor& noMidLightColor = noMidLight(y, x);
+    const std::size_t nbImages = images.size();
+    const int refImageIndex = mergingParams.refImageIndex;
 
-            std::vector<std::vector<double>> vv_coeff;
-            std::vector<std::vector<double>> vv_value;
-            std::vector<std::vector<double>> vv_normalizedValue;
+#pragma omp parallel
+    {
+        // Curves values of one row, for each image and channel: [(e * 3 + channel) * width + x]
+        std::vector<float> rowResponses(nbImages * 3 * width);
+        std::vector<float> rowCoeffs(nbImages * 3 * width);
 
-            // Compute merging range
-            std::vector<int> v_firstIndex;
-            std::vector<int> v_lastIndex;
-            for (std::size_t channel = 0; channel < 3; ++channel)
+#pragma omp for
+        for (int y = 0; y < height; ++y)
+        {
+            // Evaluate the response and weight curves of the row, image by image
+            for (std::size_t e = 0; e < nbImages; ++e)
             {
-                int firstIndex = mergingParams.refImageIndex;
-                while (firstIndex > 0 &&
-                       (response(images[firstIndex](y, x)(channel), channel) > v_minValue[channel] || firstIndex == images.size() - 1))
-                {
-                    firstIndex--;
-                }
-                v_firstIndex.push_back(firstIndex);
+                const rgbCurve& imageWeight = e == 0 ? weightShortestExposure : (e == nbImages - 1 ? weightLongestExposure : weight);
+                const float* row = images[e](y, 0).data();
 
-                int lastIndex = v_firstIndex[channel] + 1;
-                while (lastIndex < images.size() - 1 && response(images[lastIndex](y, x)(channel), channel) < v_maxValue[channel])
+                for (std::size_t channel = 0; channel < 3; ++channel)
                 {
-                    lastIndex++;
-                }
-                v_lastIndex.push_back(lastIndex);
-            }
+                    float* responses = &rowResponses[(e * 3 + channel) * width];
+                    float* coeffs = &rowCoeffs[(e * 3 + channel) * width];
 
-            // Compute merging coeffs and values to be merged
-            for (std::size_t channel = 0; channel < 3; ++channel)
-            {
-                std::vector<double> v_coeff;
-                std::vector<double> v_normalizedValue;
-                std::vector<double> v_value;
+                    response.evaluate(responses, row + channel, 3, width, channel);
+                    imageWeight.evaluate(coeffs, row + channel, 3, width, channel);
 
-                for (std::size_t e = 0; e < images.size(); ++e)
-                {
-                    const double value = images[e](y, x)(channel);
-                    const double resp = response(value, channel);
-                    const double normalizedValue = resp / times[e];
-                    double coeff = std::max(0.001f,
-                                            e == 0 ? weightShortestExposure(value, channel)
-                                                   : (e == images.size() - 1 ? weightLongestExposure(value, channel) : weight(value, channel)));
-
-                    v_value.push_back(value);
-                    v_normalizedValue.push_back(normalizedValue);
-                    v_coeff.push_back(coeff);
+                    for (std::size_t x = 0; x < width; ++x)
+                    {
+                        coeffs[x] = std::max(0.001f, coeffs[x]);
+                    }
                 }
-
-                vv_coeff.push_back(v_coeff);
-                vv_normalizedValue.push_back(v_normalizedValue);
-                vv_value.push_back(v_value);
             }
 
-            // Compute light masks if required (monitoring and debug purposes)
-            if (mergingParams.computeLightMasks)
+            for (int x = 0; x < width; ++x)
             {
+                // for each pixels
+                image::RGBfColor& radianceColor = radiance(y, x);
+                image::RGBfColor& highLightColor = highLight(y, x);
+                image::RGBfColor& lowLightColor = lowLight(y, x);
+                image::RGBfColor& noMidLightColor = noMidLight(y, x);
+
                 for (std::size_t channel = 0; channel < 3; ++channel)
                 {
-                    int idxMaxValue = 0;
-                    int idxMinValue = 0;
-                    double maxValue = 0.0;
-                    double minValue = 10000.0;
-                    bool jump = true;
-                    for (std::size_t e = 0; e < images.size(); ++e)
+                    const auto resp = [&](std::size_t e) { return rowResponses[(e * 3 + channel) * width + x]; };
+                    const auto coeff = [&](std::size_t e) { return rowCoeffs[(e * 3 + channel) * width + x]; };
+
+                    // Compute merging range
+                    int firstIndex = refImageIndex;
+                    while (firstIndex > 0 && (resp(firstIndex) > v_minValue[channel] || firstIndex == nbImages - 1))
                     {
-                        if (vv_value[channel][e] > maxValue)
-                        {
-                            maxValue = vv_value[channel][e];
-                            idxMaxValue = e;
-                        }
-                        if (vv_value[channel][e] < minValue)
+                        firstIndex--;
+                    }
+
+                    int lastIndex = firstIndex + 1;
+                    while (lastIndex < nbImages - 1 && resp(lastIndex) < v_maxValue[channel])
+                    {
+                        lastIndex++;
+                    }
+
+                    // Compute light masks if required (monitoring and debug purposes)
+                    if (mergingParams.computeLightMasks)
+                    {
+                        double maxValue = 0.0;
+                        double minValue = 10000.0;
+                        bool jump = true;
+                        for (std::size_t e = 0; e < nbImages; ++e)
                         {
-                            minValue = vv_value[channel][e];
-                            idxMinValue = e;
+                            const double value = images[e](y, x)(channel);
+                            maxValue = std::max(maxValue, value);
+                            minValue = std::min(minValue, value);
+                            jump = jump && ((value < mergingParams.minSignificantValue && e < nbImages - 1) ||
+                                            (value > mergingParams.maxSignificantValue && e > 0));
                         }
-                        jump = jump && ((vv_value[channel][e] < mergingParams.minSignificantValue && e < images.size() - 1) ||
-                                        (vv_value[channel][e] > mergingParams.maxSignificantValue && e > 0));
+                        highLightColor(channel) = minValue > mergingParams.maxSignificantValue ? 1.0 : 0.0;
+                        lowLightColor(channel) = maxValue < mergingParams.minSignificantValue ? 1.0 : 0.0;
+                        noMidLightColor(channel) = jump ? 1.0 : 0.0;
                     }
-                    highLightColor(channel) = minValue > mergingParams.maxSignificantValue ? 1.0 : 0.0;
-                    lowLightColor(channel) = maxValue < mergingParams.minSignificantValue ? 1.0 : 0.0;
-                    noMidLightColor(channel) = jump ? 1.0 : 0.0;
-                }
-            }
 
-            // Compute the final result and adjust the exposure to the reference one.
-            for (std::size_t channel = 0; channel < 3; ++channel)
-            {
-                double v = 0.0;
-                double sumCoeff = 0.0;
-                for (std::size_t i = v_firstIndex[channel]; i <= v_lastIndex[channel]; ++i)
-                {
-                    v += vv_coeff[channel][i] * vv_normalizedValue[channel][i];
-                    sumCoeff += vv_coeff[channel][i];
+                    // Compute the final result and adjust the exposure to the reference one.
+                    double v = 0.0;
+                    double sumCoeff = 0.0;
+                    for (std::size_t i = firstIndex; i <= lastIndex; ++i)
+                    {
+                        v += coeff(i) * (resp(i) / times[i]);
+                        sumCoeff += coeff(i);
+                    }
+                    radianceColor(channel) =
+                      mergingParams.targetCameraExposure * (sumCoeff != 0.0 ? v / sumCoeff : resp(refImageIndex) / times[refImageIndex]);
                 }
-                radianceColor(channel) =
-                  mergingParams.targetCameraExposure * (sumCoeff != 0.0 ? v / sumCoeff : vv_normalizedValue[channel][mergingParams.refImageIndex]);
             }
         }
     }
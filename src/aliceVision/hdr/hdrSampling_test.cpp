@@ -0,0 +1,107 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#define BOOST_TEST_MODULE hdr_sampling
+
+#include "sampling.hpp"
+
+#include <boost/filesystem.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <fstream>
+#include <random>
+
+using namespace aliceVision;
+
+namespace fs = boost::filesystem;
+
+namespace {
+
+void checkSamplesEqual(const std::vector<hdr::ImageSample>& a, const std::vector<hdr::ImageSample>& b)
+{
+    BOOST_REQUIRE_EQUAL(a.size(), b.size());
+    for (std::size_t i = 0; i < a.size(); ++i)
+    {
+        BOOST_CHECK_EQUAL(a[i].x, b[i].x);
+        BOOST_CHECK_EQUAL(a[i].y, b[i].y);
+        BOOST_REQUIRE_EQUAL(a[i].descriptions.size(), b[i].descriptions.size());
+        for (std::size_t k = 0; k < a[i].descriptions.size(); ++k)
+        {
+            const hdr::PixelDescription& pa = a[i].descriptions[k];
+            const hdr::PixelDescription& pb = b[i].descriptions[k];
+            BOOST_CHECK_EQUAL(pa.srcId, pb.srcId);
+            BOOST_CHECK_EQUAL(pa.exposure, pb.exposure);
+            for (int c = 0; c < 3; ++c)
+            {
+                BOOST_CHECK_EQUAL(pa.mean(c), pb.mean(c));
+                BOOST_CHECK_EQUAL(pa.variance(c), pb.variance(c));
+            }
+        }
+    }
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(hdr_sampling_writeRead)
+{
+    std::mt19937 generator(0);
+    std::uniform_real_distribution<float> distribution(0.f, 1.f);
+
+    std::vector<hdr::ImageSample> samples(200);
+    for (std::size_t i = 0; i < samples.size(); ++i)
+    {
+        samples[i].x = i * 3;
+        samples[i].y = i * 7;
+
+        // some samples have no description
+        samples[i].descriptions.resize(i % 5);
+        for (std::size_t k = 0; k < samples[i].descriptions.size(); ++k)
+        {
+            hdr::PixelDescription& p = samples[i].descriptions[k];
+            p.srcId = IndexT(k + 10);
+            p.exposure = float(1 << k);
+            for (int c = 0; c < 3; ++c)
+            {
+                p.mean(c) = distribution(generator);
+                p.variance(c) = distribution(generator);
+            }
+        }
+    }
+
+    const fs::path folder = fs::temp_directory_path() / fs::unique_path();
+    fs::create_directories(folder);
+
+    // compact file
+    const std::string samplesPath = (folder / "samples.dat").string();
+    BOOST_CHECK(hdr::writeSamples(samplesPath, samples));
+
+    std::vector<hdr::ImageSample> loaded;
+    BOOST_CHECK(hdr::readSamples(samplesPath, loaded));
+    checkSamplesEqual(samples, loaded);
+
+    // legacy file written with the stream operators
+    const std::string legacyPath = (folder / "legacy.dat").string();
+    {
+        std::ofstream file(legacyPath, std::ios::binary);
+        const std::size_t size = samples.size();
+        file.write((const char*)&size, sizeof(size));
+        for (const hdr::ImageSample& sample : samples)
+        {
+            file << sample;
+        }
+    }
+
+    std::vector<hdr::ImageSample> loadedLegacy;
+    BOOST_CHECK(hdr::readSamples(legacyPath, loadedLegacy));
+    checkSamplesEqual(samples, loadedLegacy);
+
+    // truncated file
+    fs::resize_file(samplesPath, fs::file_size(samplesPath) / 2);
+    std::vector<hdr::ImageSample> truncated;
+    BOOST_CHECK(!hdr::readSamples(samplesPath, truncated));
+
+    fs::remove_all(folder);
+}
@@ -386,6 +386,26 @@ float rgbCurve::operator()(float sample, std::size_t channel) const
     return (1.0f - fractionalPart) * _data[channel][infIndex] + fractionalPart * _data[channel][infIndex + 1];
 }
 
+void rgbCurve::evaluate(float* output, const float* samples, std::size_t stride, std::size_t count, std::size_t channel) const
+{
+    assert(channel < _data.size());
+
+    const float* curve = _data[channel].data();
+    const std::size_t lastIndex = getSize() - 1;
+    const float size = getSize() - 1.0f;
+
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        // same as getIndex, the scaled value is positive
+        const float valueScaled = std::max(0.f, std::min(1.f, samples[i * stride])) * size;
+        const std::size_t infIndex = std::size_t(valueScaled);
+        const float fractionalPart = valueScaled - float(infIndex);
+
+        /* Do not interpolate 1.0 */
+        output[i] = (infIndex == lastIndex) ? curve[infIndex] : (1.0f - fractionalPart) * curve[infIndex] + fractionalPart * curve[infIndex + 1];
+    }
+}
+
 const rgbCurve rgbCurve::operator+(const rgbCurve& other) const { return sum(other); }
 
 const rgbCurve rgbCurve::operator-(const rgbCurve& other) const { return subtract(other); }
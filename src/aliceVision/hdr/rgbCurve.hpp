@@ -247,6 +247,16 @@ class rgbCurve
      */
     float operator()(float sample, std::size_t channel) const;
 
+    /**
+     * @brief Evaluate the channel curve for a list of samples, same values as operator()
+     * @param[out] output the curve values, count contiguous floats
+     * @param[in] samples the samples, with a distance of stride floats between two samples
+     * @param[in] stride the distance between two samples (3 for the channel of RGB pixels)
+     * @param[in] count the number of samples
+     * @param[in] channel the curve channel
+     */
+    void evaluate(float* output, const float* samples, std::size_t stride, std::size_t count, std::size_t channel) const;
+
     /**
      * @brief Operator+ Call sum method
      * @param[in] other
@@ -10,6 +10,8 @@
 #include <aliceVision/system/Logger.hpp>
 
 #include <OpenImageIO/imagebufalgo.h>
+#include <cstring>
+#include <fstream>
 #include <random>
 
 namespace aliceVision {
@@ -90,6 +92,203 @@ std::istream& operator>>(std::istream& is, PixelDescription& p)
     return is;
 }
 
+namespace {
+
+/// Identifies the compact sample files, the legacy files start with the number of samples
+const char samplesFileMagic[8] = {'A', 'V', 'H', 'D', 'R', 'S', 'M', '1'};
+
+/// Size of a PixelDescription in the compact sample files: srcId, exposure, mean and variance
+constexpr std::size_t descriptionFileSize = sizeof(IndexT) + 7 * sizeof(float);
+
+template <typename T>
+void writeValue(std::vector<char>& buffer, std::size_t& pos, const T& value)
+{
+    std::memcpy(buffer.data() + pos, &value, sizeof(T));
+    pos += sizeof(T);
+}
+
+template <typename T>
+T readValue(const std::vector<char>& buffer, std::size_t pos)
+{
+    T value;
+    std::memcpy(&value, buffer.data() + pos, sizeof(T));
+    return value;
+}
+
+}  // namespace
+
+bool writeSamples(const std::string& filepath, const std::vector<ImageSample>& samples)
+{
+    const std::uint64_t count = samples.size();
+
+    // offsets of the descriptions of each sample
+    std::vector<std::uint64_t> offsets(count + 1, 0);
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        offsets[i + 1] = offsets[i] + samples[i].descriptions.size();
+    }
+
+    const std::size_t headerSize = sizeof(samplesFileMagic) + sizeof(std::uint64_t) * (count + 2);
+    const std::size_t coordinatesSize = 2 * sizeof(std::uint32_t) * count;
+    std::vector<char> buffer(headerSize + coordinatesSize + descriptionFileSize * offsets[count]);
+
+    std::size_t pos = 0;
+    std::memcpy(buffer.data(), samplesFileMagic, sizeof(samplesFileMagic));
+    pos += sizeof(samplesFileMagic);
+    writeValue(buffer, pos, count);
+    for (const std::uint64_t offset : offsets)
+    {
+        writeValue(buffer, pos, offset);
+    }
+
+#pragma omp parallel for
+    for (std::int64_t i = 0; i < std::int64_t(count); ++i)
+    {
+        const ImageSample& sample = samples[i];
+
+        std::size_t posCoordinates = headerSize + 2 * sizeof(std::uint32_t) * i;
+        writeValue(buffer, posCoordinates, std::uint32_t(sample.x));
+        writeValue(buffer, posCoordinates, std::uint32_t(sample.y));
+
+        std::size_t posDescriptions = headerSize + coordinatesSize + descriptionFileSize * offsets[i];
+        for (const PixelDescription& p : sample.descriptions)
+        {
+            writeValue(buffer, posDescriptions, p.srcId);
+            writeValue(buffer, posDescriptions, p.exposure);
+            for (int c = 0; c < 3; ++c)
+            {
+                writeValue(buffer, posDescriptions, p.mean(c));
+            }
+            for (int c = 0; c < 3; ++c)
+            {
+                writeValue(buffer, posDescriptions, p.variance(c));
+            }
+        }
+    }
+
+    std::ofstream file(filepath, std::ios::binary);
+    if (!file.is_open())
+    {
+        ALICEVISION_LOG_ERROR("Cannot write samples to file " << filepath << ".");
+        return false;
+    }
+
+    file.write(buffer.data(), buffer.size());
+
+    return bool(file);
+}
+
+bool readSamples(const std::string& filepath, std::vector<ImageSample>& samples)
+{
+    samples.clear();
+
+    std::ifstream file(filepath, std::ios::binary | std::ios::ate);
+    if (!file.is_open())
+    {
+        ALICEVISION_LOG_ERROR("Cannot read samples from file " << filepath << ".");
+        return false;
+    }
+
+    const std::size_t fileSize = std::size_t(file.tellg());
+    file.seekg(0);
+
+    char magic[sizeof(samplesFileMagic)] = {0};
+    file.read(magic, sizeof(magic));
+    if (!file || std::memcmp(magic, samplesFileMagic, sizeof(samplesFileMagic)) != 0)
+    {
+        // legacy file, written sample by sample with the stream operators
+        file.clear();
+        file.seekg(0);
+
+        std::size_t size = 0;
+        file.read((char*)&size, sizeof(size));
+
+        samples.resize(size);
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            file >> samples[i];
+        }
+
+        if (!file)
+        {
+            ALICEVISION_LOG_ERROR("Invalid samples file " << filepath << ".");
+            samples.clear();
+            return false;
+        }
+
+        return true;
+    }
+
+    std::vector<char> buffer(fileSize);
+    file.seekg(0);
+    file.read(buffer.data(), buffer.size());
+    if (!file || fileSize < sizeof(samplesFileMagic) + 2 * sizeof(std::uint64_t))
+    {
+        ALICEVISION_LOG_ERROR("Invalid samples file " << filepath << ".");
+        return false;
+    }
+
+    const std::uint64_t count = readValue<std::uint64_t>(buffer, sizeof(samplesFileMagic));
+    if (count > fileSize)
+    {
+        ALICEVISION_LOG_ERROR("Invalid samples file " << filepath << ".");
+        return false;
+    }
+
+    const std::size_t headerSize = sizeof(samplesFileMagic) + sizeof(std::uint64_t) * (count + 2);
+    const std::size_t coordinatesSize = 2 * sizeof(std::uint32_t) * count;
+    if (headerSize + coordinatesSize > fileSize)
+    {
+        ALICEVISION_LOG_ERROR("Invalid samples file " << filepath << ".");
+        return false;
+    }
+
+    std::vector<std::uint64_t> offsets(count + 1);
+    for (std::size_t i = 0; i <= count; ++i)
+    {
+        offsets[i] = readValue<std::uint64_t>(buffer, sizeof(samplesFileMagic) + sizeof(std::uint64_t) * (i + 1));
+        if ((i > 0 && offsets[i] < offsets[i - 1]) || offsets[i] > fileSize ||
+            headerSize + coordinatesSize + descriptionFileSize * offsets[i] > fileSize)
+        {
+            ALICEVISION_LOG_ERROR("Invalid samples file " << filepath << ".");
+            return false;
+        }
+    }
+
+    samples.resize(count);
+
+#pragma omp parallel for
+    for (std::int64_t i = 0; i < std::int64_t(count); ++i)
+    {
+        ImageSample& sample = samples[i];
+
+        const std::size_t posCoordinates = headerSize + 2 * sizeof(std::uint32_t) * i;
+        sample.x = readValue<std::uint32_t>(buffer, posCoordinates);
+        sample.y = readValue<std::uint32_t>(buffer, posCoordinates + sizeof(std::uint32_t));
+
+        sample.descriptions.resize(offsets[i + 1] - offsets[i]);
+
+        std::size_t pos = headerSize + coordinatesSize + descriptionFileSize * offsets[i];
+        for (PixelDescription& p : sample.descriptions)
+        {
+            p.srcId = readValue<IndexT>(buffer, pos);
+            pos += sizeof(IndexT);
+            p.exposure = readValue<float>(buffer, pos);
+            pos += sizeof(float);
+            for (int c = 0; c < 3; ++c, pos += sizeof(float))
+            {
+                p.mean(c) = readValue<float>(buffer, pos);
+            }
+            for (int c = 0; c < 3; ++c, pos += sizeof(float))
+            {
+                p.variance(c) = readValue<float>(buffer, pos);
+            }
+        }
+    }
+
+    return true;
+}
+
 void integral(image::Image<image::Rgb<double>>& dest, const Eigen::Matrix<image::RGBfColor, Eigen::Dynamic, Eigen::Dynamic>& source)
 {
     /*
@@ -173,16 +372,20 @@ bool Sampling::extractSamplesFromImages(std::vector<ImageSample>& out_samples,
         }
     }
 
-    Image<RGBfColor> img;
+    // Decode the brackets concurrently, the decoding dominates the extraction
+    std::vector<Image<RGBfColor>> images(imagePaths.size());
+#pragma omp parallel for schedule(dynamic)
+    for (int idBracket = 0; idBracket < int(imagePaths.size()); ++idBracket)
+    {
+        readImage(imagePaths[idBracket], images[idBracket], imgReadOptions);
+    }
 
     // For all brackets, For each pixel, compute image sample
     image::Image<ImageSample> samples(imageWidth, imageHeight, true);
     for (unsigned int idBracket = 0; idBracket < imagePaths.size(); ++idBracket)
     {
         const double exposure = times[idBracket];
-
-        // Load image
-        readImage(imagePaths[idBracket], img, imgReadOptions);
+        const Image<RGBfColor>& img = images[idBracket];
 
         if (img.Width() != imageWidth || img.Height() != imageHeight)
         {
@@ -292,6 +495,9 @@ bool Sampling::extractSamplesFromImages(std::vector<ImageSample>& out_samples,
                 }
             }
         }
+
+        // release the bracket once sampled
+        images[idBracket] = Image<RGBfColor>();
     }
 
     if (samples.Width() == 0)
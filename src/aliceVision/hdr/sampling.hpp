@@ -44,6 +44,24 @@ std::ostream& operator<<(std::ostream& os, const PixelDescription& p);
 std::istream& operator>>(std::istream& os, ImageSample& s);
 std::istream& operator>>(std::istream& os, PixelDescription& p);
 
+/**
+ * @brief Write the samples of a bracket group in a compact binary file.
+ *        The descriptions are stored contiguously, with the offset of each sample, so they can be read in parallel.
+ * @param[in] filepath the output file
+ * @param[in] samples the samples of the group
+ * @return false if the file cannot be written
+ */
+bool writeSamples(const std::string& filepath, const std::vector<ImageSample>& samples);
+
+/**
+ * @brief Read the samples of a bracket group written by writeSamples.
+ *        Files written with the ImageSample stream operators are also supported.
+ * @param[in] filepath the input file
+ * @param[out] samples the samples of the group
+ * @return false if the file cannot be read or is invalid
+ */
+bool readSamples(const std::string& filepath, std::vector<ImageSample>& samples);
+
 class Sampling
 {
   public:
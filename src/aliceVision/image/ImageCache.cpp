@@ -7,6 +7,7 @@
 #include "ImageCache.hpp"
 
 #include <aliceVision/system/Logger.hpp>
+#include <aliceVision/system/hardwareContext.hpp>
 
 namespace aliceVision {
 namespace image {
@@ -118,7 +119,62 @@ ImageCache::ImageCache(float capacity_MiB, float maxSize_MiB, const ImageReadOpt
     _options(options)
 {}
 
-ImageCache::~ImageCache() {}
+ImageCache::~ImageCache() { waitPrefetch(); }
+
+bool ImageCache::touch(const CacheKey& key)
+{
+    auto it = std::find(_keys.begin(), _keys.end(), key);
+    if (it == _keys.end())
+    {
+        return false;
+    }
+
+    // image becomes MRU
+    _keys.erase(it);
+    _keys.push_back(key);
+    return true;
+}
+
+void ImageCache::waitPrefetch()
+{
+    std::list<std::future<void>> prefetches;
+    {
+        const std::scoped_lock<std::mutex> lockPrefetch(_mutexPrefetch);
+        prefetches.swap(_prefetches);
+    }
+
+    for (std::future<void>& f : prefetches)
+    {
+        f.wait();
+    }
+}
+
+void ImageCache::setMemoryLimits(float capacity_MiB, float maxSize_MiB)
+{
+    const std::scoped_lock<std::mutex> lockGeneral(_mutexGeneral);
+    const std::scoped_lock<std::mutex> lockPeek(_mutexPeek);
+
+    _info.setLimits(capacity_MiB, maxSize_MiB);
+}
+
+ImageCache& ImageCache::getShared()
+{
+    static ImageCache sharedCache = []() {
+        const float availableMemory_MiB = HardwareContext().getMaxMemory() / (1024.f * 1024.f);
+        return ImageCache(0.25f * availableMemory_MiB, 0.5f * availableMemory_MiB, ImageReadOptions(EImageColorSpace::LINEAR));
+    }();
+
+    return sharedCache;
+}
+
+void ImageCache::configureShared(const HardwareContext& hardwareContext, float capacityRatio)
+{
+    const float availableMemory_MiB = hardwareContext.getMaxMemory() / (1024.f * 1024.f);
+    const float capacity_MiB = std::clamp(capacityRatio, 0.f, 1.f) * availableMemory_MiB;
+
+    // the maximal size leaves room for the images in use when the capacity is reached
+    getShared().setMemoryLimits(capacity_MiB, std::max(capacity_MiB, std::min(2.f * capacity_MiB, availableMemory_MiB)));
+}
 
 std::string ImageCache::toString() const
 {
@@ -128,6 +184,7 @@ std::string ImageCache::toString() const
     {
         std::string keyDesc = key.filename + ", nbChannels: " + std::to_string(key.nbChannels) + ", typeDesc: " + std::to_string(key.typeDesc) +
                               ", downscaleLevel: " + std::to_string(key.downscaleLevel) +
+                              ", colorSpace: " + EImageColorSpace_enumToString(key.colorSpace) +
                               ", usages: " + std::to_string(_imagePtrs.at(key).useCount()) +
                               ", size: " + std::to_string(_imagePtrs.at(key).memorySize());
         description += "\n * " + keyDesc;
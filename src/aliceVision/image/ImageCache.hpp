@@ -19,16 +19,20 @@
 #include <memory>
 #include <unordered_map>
 #include <functional>
+#include <future>
 #include <list>
 #include <mutex>
 #include <thread>
 #include <algorithm>
 
 namespace aliceVision {
+
+class HardwareContext;
+
 namespace image {
 
 /**
- * @brief A struct used to identify a cached image using its file description, color type info and downscale level.
+ * @brief A struct used to identify a cached image using its file description, color type info, downscale level and color space.
  */
 struct CacheKey
 {
@@ -36,20 +40,22 @@ struct CacheKey
     int nbChannels;
     oiio::TypeDesc::BASETYPE typeDesc;
     int downscaleLevel;
+    EImageColorSpace colorSpace;
     std::time_t lastWriteTime;
 
-    CacheKey(const std::string& path, int nchannels, oiio::TypeDesc::BASETYPE baseType, int level, std::time_t time)
+    CacheKey(const std::string& path, int nchannels, oiio::TypeDesc::BASETYPE baseType, int level, EImageColorSpace colorspace, std::time_t time)
       : filename(path),
         nbChannels(nchannels),
         typeDesc(baseType),
         downscaleLevel(level),
+        colorSpace(colorspace),
         lastWriteTime(time)
     {}
 
     bool operator==(const CacheKey& other) const
     {
         return (filename == other.filename && nbChannels == other.nbChannels && typeDesc == other.typeDesc &&
-                downscaleLevel == other.downscaleLevel && lastWriteTime == other.lastWriteTime);
+                downscaleLevel == other.downscaleLevel && colorSpace == other.colorSpace && lastWriteTime == other.lastWriteTime);
     }
 };
 
@@ -62,6 +68,7 @@ struct CacheKeyHasher
         boost::hash_combine(seed, key.nbChannels);
         boost::hash_combine(seed, key.typeDesc);
         boost::hash_combine(seed, key.downscaleLevel);
+        boost::hash_combine(seed, static_cast<int>(key.colorSpace));
         boost::hash_combine(seed, key.lastWriteTime);
         return seed;
     }
@@ -73,8 +80,8 @@ struct CacheKeyHasher
 struct CacheInfo
 {
     /// memory usage limits
-    const unsigned long long int capacity;
-    const unsigned long long int maxSize;
+    unsigned long long int capacity;
+    unsigned long long int maxSize;
 
     /// current state of the cache
     int nbImages = 0;
@@ -85,15 +92,18 @@ struct CacheInfo
     int nbLoadFromCache = 0;
     int nbRemoveUnused = 0;
 
-    CacheInfo(float capacity_MiB, float maxSize_MiB)
-      : capacity(capacity_MiB * 1024 * 1024),
-        maxSize(maxSize_MiB * 1024 * 1024)
+    CacheInfo(float capacity_MiB, float maxSize_MiB) { setLimits(capacity_MiB, maxSize_MiB); }
+
+    void setLimits(float capacity_MiB, float maxSize_MiB)
     {
         // Check that max size is higher than capacity
-        if (maxSize < capacity)
+        if (maxSize_MiB < capacity_MiB)
         {
             ALICEVISION_THROW_ERROR("[image] ImageCache: maximum size must be higher than capacity");
         }
+
+        capacity = capacity_MiB * 1024 * 1024;
+        maxSize = maxSize_MiB * 1024 * 1024;
     }
 };
 
@@ -202,6 +212,9 @@ inline std::shared_ptr<Image<RGBAfColor>> CacheValue::get<RGBAfColor>()
  * or until there is nothing to remove
  * 5. if the image fits in the maximal size, load it, store it and return it
  * 6. the image is too big for the cache, throw an error.
+ *
+ * A process-wide instance is available through ImageCache::getShared() so that the modules reading the same images
+ * (depth map estimation, filtering, texturing) decode them once under a single memory budget.
  */
 class ImageCache
 {
@@ -234,7 +247,51 @@ class ImageCache
      * @throws std::runtime_error if the image does not fit in the maximal size of the cache
      */
     template<typename TPix>
-    std::shared_ptr<Image<TPix>> get(const std::string& filename, int downscaleLevel = 1, bool cachedOnly = false, bool lazyCleaning = true);
+    std::shared_ptr<Image<TPix>> get(const std::string& filename, int downscaleLevel = 1, bool cachedOnly = false, bool lazyCleaning = true)
+    {
+        return get<TPix>(filename, downscaleLevel, _options.workingColorSpace, cachedOnly, lazyCleaning);
+    }
+
+    /**
+     * @brief Retrieve a cached image at a given downscale level in a given working color space.
+     * @note This method is thread-safe.
+     * @param[in] filename the image's filename on disk
+     * @param[in] downscaleLevel the downscale level
+     * @param[in] workingColorSpace the color space of the returned image, overriding the one of the reading options
+     * @param[in] cachedOnly if true, only return images that are already in the cache
+     * @param[in] lazyCleaning if true, will try lazy cleaning heuristic before LRU cleaning
+     * @return a shared pointer to the cached image
+     * @throws std::runtime_error if the image does not fit in the maximal size of the cache
+     */
+    template<typename TPix>
+    std::shared_ptr<Image<TPix>> get(const std::string& filename,
+                                     int downscaleLevel,
+                                     EImageColorSpace workingColorSpace,
+                                     bool cachedOnly = false,
+                                     bool lazyCleaning = true);
+
+    /**
+     * @brief Load an image in the cache in the background, a later call to get will not wait for the disk.
+     * @note This method is thread-safe. Loading errors are logged and ignored.
+     * @param[in] filename the image's filename on disk
+     * @param[in] downscaleLevel the downscale level
+     * @param[in] workingColorSpace the color space of the cached image
+     */
+    template<typename TPix>
+    void prefetch(const std::string& filename, int downscaleLevel, EImageColorSpace workingColorSpace);
+
+    /**
+     * @brief Wait for all the pending background loadings.
+     */
+    void waitPrefetch();
+
+    /**
+     * @brief Change the memory usage limits of the cache, the images in use are kept.
+     * @note This method is thread-safe.
+     * @param[in] capacity_MiB the cache capacity (in MiB)
+     * @param[in] maxSize_MiB the cache maximal size (in MiB)
+     */
+    void setMemoryLimits(float capacity_MiB, float maxSize_MiB);
 
     /**
      * @brief Check if an image at a given downscale level is currently in the cache.
@@ -246,6 +303,20 @@ class ImageCache
     template<typename TPix>
     bool contains(const std::string& filename, int downscaleLevel = 1) const;
 
+    /**
+     * @brief Get the process-wide image cache.
+     *        Its memory budget is a fraction of the available memory, see configureShared.
+     * @note The working color space should be given explicitly to get, the default reading options are in linear.
+     */
+    static ImageCache& getShared();
+
+    /**
+     * @brief Set the memory budget of the process-wide image cache from the hardware context.
+     * @param[in] hardwareContext the hardware context with the user memory limits
+     * @param[in] capacityRatio the ratio of the available memory dedicated to the cached images
+     */
+    static void configureShared(const HardwareContext& hardwareContext, float capacityRatio = 0.25f);
+
     /**
      * @return information on the current cache state and usage
      */
@@ -271,21 +342,37 @@ class ImageCache
     template<typename TPix>
     void load(const CacheKey& key, std::unique_lock<std::mutex>& lockPeek);
 
+    /**
+     * @brief Move an entry of the cache to the Most-Recently-Used position if it exists, the peeking mutex must be locked.
+     * @param[in] key the key used to identify the entry in the cache
+     * @return whether or not the cache contains the entry
+     */
+    bool touch(const CacheKey& key);
+
     CacheInfo _info;
     ImageReadOptions _options;
     std::unordered_map<CacheKey, CacheValue, CacheKeyHasher> _imagePtrs;
     /// ordered from LRU (Least Recently Used) to MRU (Most Recently Used)
     std::list<CacheKey> _keys;
 
+    /// pending background loadings
+    std::list<std::future<void>> _prefetches;
+
+    /// lock order: _mutexGeneral before _mutexPeek
     mutable std::mutex _mutexGeneral;
     mutable std::mutex _mutexPeek;
+    mutable std::mutex _mutexPrefetch;
 };
 
 // Since some methods in the ImageCache class are templated
 // their definition must be given in this header file
 
 template<typename TPix>
-std::shared_ptr<Image<TPix>> ImageCache::get(const std::string& filename, int downscaleLevel, bool cachedOnly, bool lazyCleaning)
+std::shared_ptr<Image<TPix>> ImageCache::get(const std::string& filename,
+                                             int downscaleLevel,
+                                             EImageColorSpace workingColorSpace,
+                                             bool cachedOnly,
+                                             bool lazyCleaning)
 {
     if (downscaleLevel < 1)
     {
@@ -301,29 +388,31 @@ std::shared_ptr<Image<TPix>> ImageCache::get(const std::string& filename, int do
     using TInfo = ColorTypeInfo<TPix>;
 
     auto lastWriteTime = boost::filesystem::last_write_time(filename);
-    CacheKey keyReq(filename, TInfo::size, TInfo::typeDesc, downscaleLevel, lastWriteTime);
+    CacheKey keyReq(filename, TInfo::size, TInfo::typeDesc, downscaleLevel, workingColorSpace, lastWriteTime);
 
     // find the requested image in the cached images
+    if (touch(keyReq))
     {
-        auto it = std::find(_keys.begin(), _keys.end(), keyReq);
-        if (it != _keys.end())
-        {
-            // image becomes LRU
-            _keys.erase(it);
-            _keys.push_back(keyReq);
-
-            _info.nbLoadFromCache++;
+        _info.nbLoadFromCache++;
 
-            ALICEVISION_LOG_TRACE("[image] ImageCache: " << toString());
-            return _imagePtrs.at(keyReq).get<TPix>();
-        }
-        else if (cachedOnly)
-        {
-            return nullptr;
-        }
+        ALICEVISION_LOG_TRACE("[image] ImageCache: " << toString());
+        return _imagePtrs.at(keyReq).get<TPix>();
+    }
+    else if (cachedOnly)
+    {
+        return nullptr;
     }
 
+    lockPeek.unlock();
     const std::scoped_lock<std::mutex> lockGeneral(_mutexGeneral);
+    lockPeek.lock();
+
+    // the image may have been loaded by another thread in the meantime
+    if (touch(keyReq))
+    {
+        _info.nbLoadFromCache++;
+        return _imagePtrs.at(keyReq).get<TPix>();
+    }
 
     // retrieve image size
     int width, height;
@@ -415,14 +504,11 @@ void ImageCache::load(const CacheKey& key, std::unique_lock<std::mutex>& lockPee
 
     auto img = std::make_shared<Image<TPix>>();
 
-    // load image from disk
-    readImage(key.filename, *img, _options);
-
-    // apply downscale
-    if (key.downscaleLevel > 1)
-    {
-        imageAlgo::resizeImage(key.downscaleLevel, *img);
-    }
+    // load image from disk at the requested downscale
+    ImageReadOptions options = _options;
+    options.workingColorSpace = key.colorSpace;
+    options.downscale = std::max(1, key.downscaleLevel);
+    readImage(key.filename, *img, options);
 
     lockPeek.lock();
 
@@ -454,11 +540,29 @@ bool ImageCache::contains(const std::string& filename, int downscaleLevel) const
     using TInfo = ColorTypeInfo<TPix>;
 
     auto lastWriteTime = boost::filesystem::last_write_time(filename);
-    CacheKey keyReq(filename, TInfo::size, TInfo::typeDesc, downscaleLevel, lastWriteTime);
+    CacheKey keyReq(filename, TInfo::size, TInfo::typeDesc, downscaleLevel, _options.workingColorSpace, lastWriteTime);
 
-    auto it = std::find(_keys.begin(), _keys.end(), keyReq);
+    return _imagePtrs.find(keyReq) != _imagePtrs.end();
+}
+
+template<typename TPix>
+void ImageCache::prefetch(const std::string& filename, int downscaleLevel, EImageColorSpace workingColorSpace)
+{
+    const std::scoped_lock<std::mutex> lockPrefetch(_mutexPrefetch);
+
+    // forget the finished loadings
+    _prefetches.remove_if([](const std::future<void>& f) { return f.wait_for(std::chrono::seconds(0)) == std::future_status::ready; });
 
-    return it != _keys.end();
+    _prefetches.emplace_back(std::async(std::launch::async, [this, filename, downscaleLevel, workingColorSpace]() {
+        try
+        {
+            get<TPix>(filename, downscaleLevel, workingColorSpace);
+        }
+        catch (const std::exception& e)
+        {
+            ALICEVISION_LOG_WARNING("[image] ImageCache: failed to prefetch " << filename << ": " << e.what());
+        }
+    }));
 }
 
 }  // namespace image
@@ -0,0 +1,141 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <aliceVision/image/Image.hpp>
+
+#include <cassert>
+#include <type_traits>
+
+namespace aliceVision {
+namespace image {
+
+namespace detail {
+
+template<typename T>
+using RowMajorMatrix = Eigen::Matrix<typename std::remove_const<T>::type, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+
+/// strided map over mutable or read-only (const T) pixels
+template<typename T>
+using ImageViewMap =
+  Eigen::Map<typename std::conditional<std::is_const<T>::value, const RowMajorMatrix<T>, RowMajorMatrix<T>>::type, Eigen::Unaligned, Eigen::OuterStride<>>;
+
+}  // namespace detail
+
+/**
+ * @brief Non-owning view over row major pixels stored in an external buffer
+ *        (Image, oiio::ImageBuf local pixels, cv::Mat, host copy of a device buffer...).
+ *
+ * The rows may be padded: two consecutive rows are separated by rowStride pixels.
+ * The view has the same accessors as Image, so that it can be used as an input image
+ * of the convolution, filtering, resampling and warping functions without copying the pixels.
+ * Use ImageView<const T> for read-only buffers.
+ * @warning The view does not extend the lifetime of the buffer and cannot be resized.
+ */
+template<typename T>
+class ImageView : public detail::ImageViewMap<T>
+{
+  public:
+    typedef typename std::remove_const<T>::type Tpixel;  //-- Pixel data type
+    typedef detail::ImageViewMap<T> Base;
+
+    /**
+     * @brief Build a view over an external buffer
+     * @param data Pointer to the first pixel
+     * @param width Width of the image (ie number of column)
+     * @param height Height of the image (ie number of row)
+     * @param rowStride Number of pixels between the beginning of two consecutive rows (0: width)
+     */
+    inline ImageView(T* data, int width, int height, int rowStride = 0)
+      : Base(data, height, width, Eigen::OuterStride<>(rowStride > 0 ? rowStride : width))
+    {}
+
+    /**
+     * @brief Build a view over all the pixels of an image
+     * @param img Source image, must outlive the view
+     */
+    inline ImageView(typename std::conditional<std::is_const<T>::value, const Image<Tpixel>, Image<Tpixel>>::type& img)
+      : Base(img.data(), img.Height(), img.Width(), Eigen::OuterStride<>(img.Width()))
+    {}
+
+    /**
+     * @brief Build a read-only view from a mutable one
+     * @param view Source view
+     */
+    template<typename U, typename = typename std::enable_if<std::is_const<T>::value && std::is_same<U, Tpixel>::value>::type>
+    inline ImageView(const ImageView<U>& view)
+      : Base(view.data(), view.Height(), view.Width(), Eigen::OuterStride<>(view.RowStride()))
+    {}
+
+    /**
+     * @brief Build a view over a rectangular region of the image
+     * @param y Index of the first row
+     * @param x Index of the first column
+     * @param width Width of the region
+     * @param height Height of the region
+     * @return the view of the region, sharing the same buffer
+     */
+    inline ImageView<T> subView(int y, int x, int width, int height) const
+    {
+        assert(Contains(y, x) && Contains(y + height - 1, x + width - 1));
+        return ImageView<T>(const_cast<T*>(&Base::coeffRef(y, x)), width, height, RowStride());
+    }
+
+    /**
+     * @brief Retrieve the width of the image
+     * @return Width of image
+     */
+    inline int Width() const { return static_cast<int>(Base::cols()); }
+
+    /**
+     * @brief Retrieve the height of the image
+     * @return Height of the image
+     */
+    inline int Height() const { return static_cast<int>(Base::rows()); }
+
+    /**
+     * @brief Retrieve the number of pixels between the beginning of two consecutive rows
+     * @return Row stride (in pixels)
+     */
+    inline int RowStride() const { return static_cast<int>(Base::outerStride()); }
+
+    /**
+     * @brief Tell if the rows are stored without padding
+     */
+    inline bool IsContiguous() const { return RowStride() == Width(); }
+
+    /**
+     * @brief Return the depth in byte of the pixel
+     * @return depth of the pixel (in byte)
+     */
+    inline int Depth() const { return sizeof(Tpixel); }
+
+    /**
+     * @brief Return the number of channels
+     * @return number of channels
+     */
+    inline int Channels() const { return NbChannels<Tpixel>::size; }
+
+    /**
+     * @brief Get low level access to the viewed pixels
+     * @return reference to the underlying map
+     */
+    inline const Base& GetMat() const { return (*this); }
+    inline Base& GetMat() { return (*this); }
+
+    /**
+     * @brief Tell if a point is inside the image.
+     * @param y Index of the row
+     * @param x Index of the column
+     * @retval true If pixel (y,x) is inside the image
+     * @retval false If pixel (y,x) is outside the image
+     */
+    inline bool Contains(int y, int x) const { return 0 <= x && x < Base::cols() && 0 <= y && y < Base::rows(); }
+};
+
+}  // namespace image
+}  // namespace aliceVision
@@ -388,9 +388,11 @@ struct Sampler2d
      ** @param x X-coordinate of sampling
      ** @return Sampled value
      **/
-    template<typename T>
-    T operator()(const Image<T>& src, const float y, const float x) const
+    template<typename ImageType>
+    typename ImageType::Tpixel operator()(const ImageType& src, const float y, const float x) const
     {
+        typedef typename ImageType::Tpixel T;
+
         const int im_width = src.Width();
         const int im_height = src.Height();
 
@@ -3,10 +3,24 @@
 #include <aliceVision/system/Logger.hpp>
 
 #include <boost/filesystem.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include <cstring>
 
 namespace aliceVision {
 namespace image {
 
+/// Maximal number of released buffers kept for reuse, for each object size
+static const size_t maxFreeBuffersPerSize = 4;
+
+struct CacheManager::MappedIndex
+{
+    boost::interprocess::file_mapping file;
+    boost::interprocess::mapped_region region;
+    size_t size{0};
+};
+
 CacheManager::CacheManager(const std::string& pathStorage, size_t blockSize, size_t maxBlocksPerIndex)
   : _blockSize(blockSize),
     _incoreBlockUsageCount(0),
@@ -24,6 +38,7 @@ void CacheManager::wipe()
     deleteIndexFiles();
 
     _mru.clear();
+    _freeBuffers.clear();
 
     _incoreBlockUsageCount = 0;
     _nextStartBlockId = 0;
@@ -48,12 +63,65 @@ std::string CacheManager::getPathForIndex(size_t indexId)
     return _indexPaths[indexId];
 }
 
+unsigned char* CacheManager::getMappedIndex(size_t indexId, size_t requiredSize)
+{
+    auto it = _indexMappings.find(indexId);
+    if (it != _indexMappings.end() && it->second->size >= requiredSize)
+    {
+        return static_cast<unsigned char*>(it->second->region.get_address());
+    }
+
+    // The file is preallocated to the size of all its blocks, it only grows for objects crossing the end of the index
+    const size_t size = std::max(requiredSize, _blockCountPerIndex * _blockSize);
+    const std::string path = getPathForIndex(indexId);
+
+    std::unique_ptr<MappedIndex> mapped(new MappedIndex);
+    try
+    {
+        if (!boost::filesystem::exists(path))
+        {
+            std::ofstream file(path, std::ios::binary | std::ios::out);
+            if (!file.is_open())
+            {
+                return nullptr;
+            }
+        }
+
+        if (it != _indexMappings.end())
+        {
+            _indexMappings.erase(it);
+        }
+
+        ALICEVISION_LOG_TRACE("CacheManager::getMappedIndex: map " << size << " bytes of '" << path << "'.");
+
+        boost::filesystem::resize_file(path, size);
+        mapped->file = boost::interprocess::file_mapping(path.c_str(), boost::interprocess::read_write);
+        mapped->region = boost::interprocess::mapped_region(mapped->file, boost::interprocess::read_write, 0, size);
+        mapped->size = size;
+    }
+    catch (const std::exception& e)
+    {
+        ALICEVISION_LOG_ERROR("CacheManager::getMappedIndex: cannot map '" << path << "': " << e.what());
+        return nullptr;
+    }
+
+    unsigned char* address = static_cast<unsigned char*>(mapped->region.get_address());
+    _indexMappings[indexId] = std::move(mapped);
+
+    return address;
+}
+
 void CacheManager::deleteIndexFiles()
 {
+    // Unmap the files before removing them
+    _indexMappings.clear();
+
     std::size_t cacheSize = 0;
     for (std::pair<const size_t, std::string>& p : _indexPaths)
     {
-        const std::size_t s = boost::filesystem::file_size(p.second);
+        boost::system::error_code ec;
+        const std::uintmax_t fileSize = boost::filesystem::file_size(p.second, ec);
+        const std::size_t s = ec ? 0 : fileSize;
         ALICEVISION_LOG_TRACE("CacheManager::deleteIndexFiles: '" << p.second << "': " << s / (1024 * 1024) << "MB.");
         cacheSize += s;
     }
@@ -72,43 +140,12 @@ void CacheManager::deleteIndexFiles()
 
 bool CacheManager::prepareBlockGroup(size_t startBlockId, size_t blocksCount)
 {
-    size_t index_id = startBlockId / _blockCountPerIndex;
-    size_t block_id_in_index = startBlockId % _blockCountPerIndex;
-    size_t position_in_index = block_id_in_index * _blockSize;
-    size_t len = _blockSize * blocksCount;
-
-    std::string pathname = getPathForIndex(index_id);
-    boost::filesystem::path path(pathname);
-
-    std::ofstream file_index;
-    if (boost::filesystem::exists(path))
-    {
-        file_index.open(pathname, std::ios::binary | std::ios::out | std::ios::in);
-    }
-    else
-    {
-        file_index.open(pathname, std::ios::binary | std::ios::out);
-    }
-
-    if (!file_index.is_open())
-    {
-        return false;
-    }
-
-    ALICEVISION_LOG_TRACE("CacheManager::prepareBlockGroup: " << blocksCount * _blockSize << " bytes to '" << path << "'.");
-
-    /*write a dummy byte at the end of the tile to "book" this place on disk*/
-    file_index.seekp(position_in_index + len - 1, file_index.beg);
-    if (!file_index)
-    {
-        return false;
-    }
-
-    char c[1];
-    c[0] = 0xff;
-    file_index.write(c, 1);
+    const size_t indexId = startBlockId / _blockCountPerIndex;
+    const size_t blockIdInIndex = startBlockId % _blockCountPerIndex;
+    const size_t positionInIndex = blockIdInIndex * _blockSize;
+    const size_t groupLength = _blockSize * blocksCount;
 
-    return true;
+    return getMappedIndex(indexId, positionInIndex + groupLength) != nullptr;
 }
 
 std::unique_ptr<unsigned char> CacheManager::load(size_t startBlockId, size_t blockCount)
@@ -118,28 +155,16 @@ std::unique_ptr<unsigned char> CacheManager::load(size_t startBlockId, size_t bl
     const size_t positionInIndex = blockIdInIndex * _blockSize;
     const size_t groupLength = _blockSize * blockCount;
 
-    const std::string path = getPathForIndex(indexId);
-
-    std::ifstream file_index(path, std::ios::binary);
-    if (!file_index.is_open())
+    const unsigned char* mapped = getMappedIndex(indexId, positionInIndex + groupLength);
+    if (mapped == nullptr)
     {
         return std::unique_ptr<unsigned char>();
     }
 
-    file_index.seekg(positionInIndex, std::ios::beg);
-    if (file_index.fail())
-    {
-        return std::unique_ptr<unsigned char>();
-    }
+    ALICEVISION_LOG_TRACE("CacheManager::load: read " << groupLength << " bytes from index " << indexId << " at position " << positionInIndex << ".");
 
-    ALICEVISION_LOG_TRACE("CacheManager::load: read " << groupLength << " bytes from '" << path << "' at position " << positionInIndex << ".");
-
-    std::unique_ptr<unsigned char> data(new unsigned char[groupLength]);
-    file_index.read(reinterpret_cast<char*>(data.get()), groupLength);
-    if (!file_index)
-    {
-        return std::unique_ptr<unsigned char>();
-    }
+    std::unique_ptr<unsigned char> data = allocateBuffer(blockCount);
+    std::memcpy(data.get(), mapped + positionInIndex, groupLength);
 
     return data;
 }
@@ -151,40 +176,52 @@ bool CacheManager::save(std::unique_ptr<unsigned char>&& data, size_t startBlock
     const size_t positionInIndex = blockIdInIndex * _blockSize;
     const size_t groupLength = _blockSize * blockCount;
 
-    const std::string path = getPathForIndex(indexId);
-
-    std::ofstream file_index(path, std::ios::binary | std::ios::out | std::ios::in);
-    if (!file_index.is_open())
+    const unsigned char* bytesToWrite = data.get();
+    if (bytesToWrite == nullptr)
     {
         return false;
     }
 
-    file_index.seekp(positionInIndex, std::ios::beg);
-    if (file_index.fail())
+    unsigned char* mapped = getMappedIndex(indexId, positionInIndex + groupLength);
+    if (mapped == nullptr)
     {
         return false;
     }
 
-    const unsigned char* bytesToWrite = data.get();
-    if (bytesToWrite == nullptr)
+    // Write data, the system flushes the mapped pages to the file only under memory pressure
+    ALICEVISION_LOG_TRACE("CacheManager::save: write " << groupLength << " bytes to index " << indexId << " at position " << positionInIndex << ".");
+    std::memcpy(mapped + positionInIndex, bytesToWrite, groupLength);
+
+    releaseBuffer(std::move(data), blockCount);
+
+    return true;
+}
+
+std::unique_ptr<unsigned char> CacheManager::allocateBuffer(size_t blockCount)
+{
+    std::vector<std::unique_ptr<unsigned char>>& buffers = _freeBuffers[blockCount];
+    if (buffers.empty())
     {
-        return false;
+        return std::unique_ptr<unsigned char>(new unsigned char[_blockSize * blockCount]);
     }
-    else
+
+    std::unique_ptr<unsigned char> data = std::move(buffers.back());
+    buffers.pop_back();
+
+    return data;
+}
+
+void CacheManager::releaseBuffer(std::unique_ptr<unsigned char>&& data, size_t blockCount)
+{
+    std::vector<std::unique_ptr<unsigned char>>& buffers = _freeBuffers[blockCount];
+    if (buffers.size() < maxFreeBuffersPerSize)
     {
-        // Write data
-        ALICEVISION_LOG_TRACE("CacheManager::save: write " << groupLength << " bytes to '" << path << "' at position " << positionInIndex << ".");
-        file_index.write(reinterpret_cast<const char*>(bytesToWrite), groupLength);
+        buffers.push_back(std::move(data));
     }
-
-    if (!file_index)
+    else
     {
-        return false;
+        data.reset();
     }
-
-    file_index.close();
-
-    return true;
 }
 
 size_t CacheManager::getFreeBlockId(size_t blockCount)
@@ -242,8 +279,7 @@ bool CacheManager::acquireObject(std::unique_ptr<unsigned char>& data, size_t ob
         */
         if (memitem.startBlockId == ~0)
         {
-            std::unique_ptr<unsigned char> buffer(new unsigned char[_blockSize * memitem.countBlock]);
-            data = std::move(buffer);
+            data = allocateBuffer(memitem.countBlock);
         }
         else
         {
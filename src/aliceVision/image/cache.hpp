@@ -19,6 +19,7 @@
 
 #include <fstream>
 #include <list>
+#include <vector>
 #include <sstream>
 #include <queue>
 
@@ -132,6 +133,13 @@ class CacheManager
     using IndexedStoragePaths = std::unordered_map<size_t, std::string>;
     using IndexedFreeBlocks = std::unordered_map<size_t, std::list<size_t>>;
 
+    /*
+    A cache file preallocated to its maximal size and mapped in memory
+    */
+    struct MappedIndex;
+    using IndexedMappings = std::unordered_map<size_t, std::unique_ptr<MappedIndex>>;
+    using IndexedFreeBuffers = std::unordered_map<size_t, std::vector<std::unique_ptr<unsigned char>>>;
+
     /*
     An item of the Most Recently used container
     */
@@ -210,6 +218,7 @@ class CacheManager
 
   protected:
     std::string getPathForIndex(size_t indexId);
+    unsigned char* getMappedIndex(size_t indexId, size_t requiredSize);
     void deleteIndexFiles();
     void wipe();
 
@@ -223,6 +232,9 @@ class CacheManager
     void addFreeBlock(size_t blockId, size_t blockCount);
     size_t getFreeBlockId(size_t blockCount);
 
+    std::unique_ptr<unsigned char> allocateBuffer(size_t blockCount);
+    void releaseBuffer(std::unique_ptr<unsigned char>&& data, size_t blockCount);
+
   protected:
     size_t _blockSize{0};
     size_t _incoreBlockUsageCount{0};
@@ -233,7 +245,9 @@ class CacheManager
 
     std::string _basePathStorage;
     IndexedStoragePaths _indexPaths;
+    IndexedMappings _indexMappings;
     IndexedFreeBlocks _freeBlocks;
+    IndexedFreeBuffers _freeBuffers;
 
     MRUType _mru;
     MemoryMap _memoryMap;
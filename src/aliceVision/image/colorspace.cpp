@@ -13,16 +13,31 @@
 #include <boost/algorithm/string.hpp>
 #include <boost/filesystem.hpp>
 
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
+
 namespace fs = boost::filesystem;
 
 namespace aliceVision {
 namespace image {
 
 namespace {
-oiio::ColorConfig colorConfigOCIO(getDefaultColorConfigFilePath());
-}
+// loaded at the first use rather than at the startup of every program
+std::mutex colorConfigOCIOMutex;
+std::unique_ptr<oiio::ColorConfig> colorConfigOCIO;
+}  // namespace
 
-oiio::ColorConfig& getGlobalColorConfigOCIO() { return colorConfigOCIO; }
+oiio::ColorConfig& getGlobalColorConfigOCIO()
+{
+    std::lock_guard<std::mutex> lock(colorConfigOCIOMutex);
+    if (!colorConfigOCIO)
+    {
+        colorConfigOCIO = std::make_unique<oiio::ColorConfig>(getDefaultColorConfigFilePath());
+    }
+    return *colorConfigOCIO;
+}
 
 std::string getColorConfigFilePathFromSourceCode()
 {
@@ -124,23 +139,62 @@ std::string getDefaultColorConfigFilePath()
 
 void initColorConfigOCIO(const std::string& colorConfigFilePath)
 {
-    colorConfigOCIO.reset(colorConfigFilePath);
-    if (!colorConfigOCIO.supportsOpenColorIO())
+    std::lock_guard<std::mutex> lock(colorConfigOCIOMutex);
+    if (colorConfigOCIO)
+        colorConfigOCIO->reset(colorConfigFilePath);
+    else
+        colorConfigOCIO = std::make_unique<oiio::ColorConfig>(colorConfigFilePath);
+
+    if (!colorConfigOCIO->supportsOpenColorIO())
     {
         ALICEVISION_THROW_ERROR("OpenImageIO has not been compiled with OCIO.");
     }
-    const std::string error = colorConfigOCIO.geterror();
+    const std::string error = colorConfigOCIO->geterror();
     if (!error.empty())
     {
         ALICEVISION_THROW_ERROR("Erroneous OCIO config file " << colorConfigFilePath << ":" << std::endl << error);
     }
-    int ocioVersion = colorConfigOCIO.OpenColorIO_version_hex();
+    int ocioVersion = colorConfigOCIO->OpenColorIO_version_hex();
     int ocioMajor = (ocioVersion & 0xFF000000) >> 24;
     int ocioMinor = (ocioVersion & 0x00FF0000) >> 16;
     int ocioPatch = (ocioVersion & 0x0000FF00) >> 8;
     ALICEVISION_LOG_INFO("OCIO color config initialized with OCIO version: " << ocioMajor << "." << ocioMinor << "." << ocioPatch);
 }
 
+oiio::ColorProcessorHandle getColorProcessor(const std::string& fromColorSpace, const std::string& toColorSpace, const std::string& colorConfigFilePath)
+{
+    using ProcessorKey = std::tuple<std::string, std::string, std::string>;
+
+    static std::mutex cacheMutex;
+    static std::map<std::string, std::unique_ptr<oiio::ColorConfig>> colorConfigs;
+    static std::map<ProcessorKey, oiio::ColorProcessorHandle> processors;
+
+    std::lock_guard<std::mutex> lock(cacheMutex);
+
+    const ProcessorKey key(colorConfigFilePath, fromColorSpace, toColorSpace);
+    const auto it = processors.find(key);
+    if (it != processors.end())
+    {
+        return it->second;
+    }
+
+    std::unique_ptr<oiio::ColorConfig>& colorConfig = colorConfigs[colorConfigFilePath];
+    if (!colorConfig)
+    {
+        colorConfig.reset(new oiio::ColorConfig(colorConfigFilePath));
+    }
+
+    const oiio::ColorProcessorHandle processor = colorConfig->createColorProcessor(fromColorSpace, toColorSpace);
+    if (!processor)
+    {
+        ALICEVISION_LOG_WARNING("Cannot create the color processor from " << fromColorSpace << " to " << toColorSpace << ": "
+                                                                           << colorConfig->geterror());
+    }
+    processors.emplace(key, processor);
+
+    return processor;
+}
+
 std::string EImageColorSpace_informations()
 {
     return EImageColorSpace_enumToString(EImageColorSpace::AUTO) + ", " + EImageColorSpace_enumToString(EImageColorSpace::LINEAR) + ", " +
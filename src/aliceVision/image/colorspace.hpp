@@ -45,7 +45,24 @@ std::istream& operator>>(std::istream& in, EImageColorSpace& dataType);
 
 std::string getDefaultColorConfigFilePath();
 void initColorConfigOCIO(const std::string& colorConfigFilePath);
+
+/**
+ * @return the global OCIO configuration, the default one is loaded at the first call
+ */
 oiio::ColorConfig& getGlobalColorConfigOCIO();
 
+/**
+ * @brief Get the color processor of a conversion between two color spaces.
+ *        The color configs and the processors are created once and shared between the calls,
+ *        so that the conversion of an image does not parse the OCIO config file again.
+ * @param[in] fromColorSpace The source color space name
+ * @param[in] toColorSpace The destination color space name
+ * @param[in] colorConfigFilePath The OCIO config file, empty for the OIIO default color config
+ * @return the color processor, null if the conversion is not supported
+ */
+oiio::ColorProcessorHandle getColorProcessor(const std::string& fromColorSpace,
+                                             const std::string& toColorSpace,
+                                             const std::string& colorConfigFilePath = "");
+
 }  // namespace image
 }  // namespace aliceVision
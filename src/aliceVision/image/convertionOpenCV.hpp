@@ -11,6 +11,7 @@
 #if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_OPENCV)
 
     #include "aliceVision/image/Image.hpp"
+    #include "aliceVision/image/ImageView.hpp"
     #include <aliceVision/numeric/numeric.hpp>
 
     #include <opencv2/core.hpp>
@@ -112,6 +113,40 @@ inline void cvMatBGRToImageRGBA(const cv::Mat& img, image::Image<image::RGBAfCol
     }
 }
 
+/**
+ * @brief Get a view over the pixels of an OpenCV image (cv::Mat), without copy
+ * The channels order is kept (BGR for the images loaded by OpenCV)
+ * @tparam T - pixel type, must have the size of the matrix elements
+ * @param[in] mat - input OpenCV image
+ * @return the view over the matrix pixels, valid as long as the matrix data
+ */
+template<typename T>
+inline image::ImageView<T> cvMatToImageView(cv::Mat& mat)
+{
+    if (mat.dims != 2 || mat.elemSize() != sizeof(T) || mat.step[0] % sizeof(T) != 0)
+    {
+        throw std::invalid_argument("Cannot get an image view from an OpenCV matrix of type '" + std::to_string(mat.type()) + "'.");
+    }
+    return image::ImageView<T>(mat.ptr<T>(), mat.cols, mat.rows, static_cast<int>(mat.step[0] / sizeof(T)));
+}
+
+/**
+ * @brief Get an OpenCV image (cv::Mat) sharing the pixels of an aliceVision image view, without copy
+ * @tparam T - pixel type, must have the size of the OpenCV type elements
+ * @param[in] view - input image view
+ * @param[in] cvtype - OpenCV mat type (e.g. CV_32FC1, CV_8UC3)
+ * @return the OpenCV image, valid as long as the viewed pixels
+ */
+template<typename T>
+inline cv::Mat imageViewToCvMat(const image::ImageView<T>& view, int cvtype)
+{
+    if (CV_ELEM_SIZE(cvtype) != sizeof(typename image::ImageView<T>::Tpixel))
+    {
+        throw std::invalid_argument("Cannot handle OpenCV matrix type '" + std::to_string(cvtype) + "'.");
+    }
+    return cv::Mat(view.Height(), view.Width(), cvtype, const_cast<typename image::ImageView<T>::Tpixel*>(view.data()), view.RowStride() * sizeof(T));
+}
+
 }  // namespace image
 }  // namespace aliceVision
 
@@ -10,7 +10,7 @@
 namespace aliceVision {
 namespace image {
 
-void SeparableConvolution2d(const RowMatrixXf& image,
+void SeparableConvolution2d(const Eigen::Ref<const RowMatrixXf, 0, Eigen::OuterStride<>>& image,
                             const Eigen::Matrix<float, 1, Eigen::Dynamic>& kernel_x,
                             const Eigen::Matrix<float, 1, Eigen::Dynamic>& kernel_y,
                             RowMatrixXf* out)
@@ -11,8 +11,10 @@
 #include <aliceVision/numeric/Accumulator.hpp>
 #include <aliceVision/image/convolutionBase.hpp>
 #include <aliceVision/image/Image.hpp>
+#include <aliceVision/image/ImageView.hpp>
 #include <aliceVision/config.hpp>
 
+#include <algorithm>
 #include <vector>
 #include <cassert>
 
@@ -26,6 +28,9 @@
 namespace aliceVision {
 namespace image {
 
+/// minimal number of pixels for a multithreaded 1d convolution
+constexpr int convolutionParallelMinSize = 1 << 16;
+
 /**
  ** General image convolution by a kernel
  ** assume kernel has odd size in both dimensions and (border pixel are copied)
@@ -33,15 +38,15 @@ namespace image {
  ** @param kernel convolution kernel
  ** @param out resulting image
  **/
-template<typename Image>
-void ImageConvolution(const Image& img, const Mat& kernel, Image& out)
+template<typename ImageTypeIn, typename ImageTypeOut>
+void ImageConvolution(const ImageTypeIn& img, const Mat& kernel, ImageTypeOut& out)
 {
     const int kernel_width = kernel.cols();
     const int kernel_height = kernel.rows();
 
     assert(kernel_width % 2 != 0 && kernel_height % 2 != 0);
 
-    typedef typename Image::Tpixel pix_t;
+    typedef typename ImageTypeIn::Tpixel pix_t;
     typedef typename Accumulator<pix_t>::Type acc_pix_t;
 
     out.resize(img.Width(), img.Height());
@@ -91,33 +96,39 @@ void ImageHorizontalConvolution(const ImageTypeIn& img, const Kernel& kernel, Im
     const int kernel_width = kernel.size();
     const int half_kernel_width = kernel_width / 2;
 
-    std::vector<pix_t, Eigen::aligned_allocator<pix_t>> line(cols + kernel_width);
-
-    for (int row = 0; row < rows; ++row)
+    // rows are independent, only large images are worth the threads
+#pragma omp parallel if (rows * cols >= convolutionParallelMinSize)
     {
-        // Copy line
-        const pix_t start_pix = img.coeffRef(row, 0);
-        for (int k = 0; k < half_kernel_width; ++k)  // pad before
-        {
-            line[k] = start_pix;
-        }
-        memcpy(&line[0] + half_kernel_width, img.data() + row * cols, sizeof(pix_t) * cols);
-        const pix_t end_pix = img.coeffRef(row, cols - 1);
-        for (int k = 0; k < half_kernel_width; ++k)  // pad after
+        std::vector<pix_t, Eigen::aligned_allocator<pix_t>> line(cols + kernel_width);
+
+#pragma omp for
+        for (int row = 0; row < rows; ++row)
         {
-            line[k + half_kernel_width + cols] = end_pix;
-        }
+            // Copy line
+            const pix_t start_pix = img.coeffRef(row, 0);
+            for (int k = 0; k < half_kernel_width; ++k)  // pad before
+            {
+                line[k] = start_pix;
+            }
+            memcpy(&line[0] + half_kernel_width, &img.coeffRef(row, 0), sizeof(pix_t) * cols);
+            const pix_t end_pix = img.coeffRef(row, cols - 1);
+            for (int k = 0; k < half_kernel_width; ++k)  // pad after
+            {
+                line[k + half_kernel_width + cols] = end_pix;
+            }
 
-        // Apply convolution
-        conv_buffer_(&line[0], kernel.data(), cols, kernel_width);
+            // Apply convolution
+            conv_buffer_(&line[0], kernel.data(), cols, kernel_width);
 
-        memcpy(out.data() + row * cols, &line[0], sizeof(pix_t) * cols);
+            memcpy(out.data() + row * cols, &line[0], sizeof(pix_t) * cols);
+        }
     }
 }
 
 /**
  ** Vertical (1d) convolution
  ** assume kernel has odd size
+ ** The output rows are accumulated from whole input rows, so that the memory is read contiguously and the inner loop vectorizes.
  ** @param img Input image
  ** @param kernel convolution kernel
  ** @param out Output image
@@ -126,6 +137,7 @@ template<typename ImageTypeIn, typename ImageTypeOut, typename Kernel>
 void ImageVerticalConvolution(const ImageTypeIn& img, const Kernel& kernel, ImageTypeOut& out)
 {
     typedef typename ImageTypeIn::Tpixel pix_t;
+    typedef typename Kernel::Scalar kernel_t;
 
     const int kernel_width = kernel.size();
     const int half_kernel_width = kernel_width / 2;
@@ -135,30 +147,32 @@ void ImageVerticalConvolution(const ImageTypeIn& img, const Kernel& kernel, Imag
 
     out.resize(cols, rows);
 
-    std::vector<pix_t, Eigen::aligned_allocator<pix_t>> line(rows + kernel_width);
-
-    for (int col = 0; col < cols; ++col)
+#pragma omp parallel if (rows * cols >= convolutionParallelMinSize)
     {
-        // Copy column
-        for (int k = 0; k < half_kernel_width; ++k)
-        {
-            line[k] = img.coeffRef(0, col);
-        }
-        for (int k = 0; k < rows; ++k)
-        {
-            line[k + half_kernel_width] = img.coeffRef(k, col);
-        }
-        for (int k = 0; k < half_kernel_width; ++k)
-        {
-            line[k + half_kernel_width + rows] = img.coeffRef(rows - 1, col);
-        }
-
-        // Apply convolution
-        conv_buffer_(&line[0], kernel.data(), rows, kernel_width);
+        std::vector<kernel_t, Eigen::aligned_allocator<kernel_t>> sum(cols);
 
+#pragma omp for
         for (int row = 0; row < rows; ++row)
         {
-            out.coeffRef(row, col) = line[row];
+            std::fill(sum.begin(), sum.end(), kernel_t(0));
+
+            for (int k = 0; k < kernel_width; ++k)
+            {
+                // replicate the border rows
+                const int inRow = std::min(std::max(row + k - half_kernel_width, 0), rows - 1);
+                const pix_t* inLine = &img.coeffRef(inRow, 0);
+                const kernel_t weight = kernel.data()[k];
+
+                for (int col = 0; col < cols; ++col)
+                {
+                    sum[col] += inLine[col] * weight;
+                }
+            }
+
+            for (int col = 0; col < cols; ++col)
+            {
+                out.coeffRef(row, col) = sum[col];
+            }
         }
     }
 }
@@ -171,16 +185,16 @@ void ImageVerticalConvolution(const ImageTypeIn& img, const Kernel& kernel, Imag
  ** @param vert_k vertical kernel
  ** @param out output image
  **/
-template<typename ImageType, typename Kernel>
-void ImageSeparableConvolution(const ImageType& img, const Kernel& horiz_k, const Kernel& vert_k, ImageType& out)
+template<typename ImageTypeIn, typename ImageTypeOut, typename Kernel>
+void ImageSeparableConvolution(const ImageTypeIn& img, const Kernel& horiz_k, const Kernel& vert_k, ImageTypeOut& out)
 {
     // Cast the Kernel to the appropriate type
-    typedef typename ImageType::Tpixel pix_t;
+    typedef typename ImageTypeIn::Tpixel pix_t;
     typedef Eigen::Matrix<typename Accumulator<pix_t>::Type, Eigen::Dynamic, 1> VecKernel;
     const VecKernel horiz_k_cast = horiz_k.template cast<typename Accumulator<pix_t>::Type>();
     const VecKernel vert_k_cast = vert_k.template cast<typename Accumulator<pix_t>::Type>();
 
-    ImageType tmp;
+    Image<pix_t> tmp;
     ImageHorizontalConvolution(img, horiz_k_cast, tmp);
     ImageVerticalConvolution(tmp, vert_k_cast, out);
 }
@@ -188,7 +202,7 @@ void ImageSeparableConvolution(const ImageType& img, const Kernel& horiz_k, cons
 typedef Eigen::Matrix<float, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> RowMatrixXf;
 
 /// Specialization for Float based image (for arbitrary sized kernel)
-void SeparableConvolution2d(const RowMatrixXf& image,
+void SeparableConvolution2d(const Eigen::Ref<const RowMatrixXf, 0, Eigen::OuterStride<>>& image,
                             const Eigen::Matrix<float, 1, Eigen::Dynamic>& kernel_x,
                             const Eigen::Matrix<float, 1, Eigen::Dynamic>& kernel_y,
                             RowMatrixXf* out);
@@ -207,5 +221,24 @@ void ImageSeparableConvolution(const Image<float>& img, const Kernel& horiz_k, c
     SeparableConvolution2d(img.GetMat(), horiz_k_cast, vert_k_cast, &((Image<float>::Base&)out));
 }
 
+// Same specialization for the views over float pixels (no copy of the input, same borders as Image<float>)
+template<typename Kernel>
+void ImageSeparableConvolution(const ImageView<const float>& img, const Kernel& horiz_k, const Kernel& vert_k, Image<float>& out)
+{
+    typedef Image<float>::Tpixel pix_t;
+    typedef Eigen::Matrix<typename aliceVision::Accumulator<pix_t>::Type, Eigen::Dynamic, 1> VecKernel;
+    const VecKernel horiz_k_cast = horiz_k.template cast<typename aliceVision::Accumulator<pix_t>::Type>();
+    const VecKernel vert_k_cast = vert_k.template cast<typename aliceVision::Accumulator<pix_t>::Type>();
+
+    out.resize(img.Width(), img.Height());
+    SeparableConvolution2d(img.GetMat(), horiz_k_cast, vert_k_cast, &((Image<float>::Base&)out));
+}
+
+template<typename Kernel>
+void ImageSeparableConvolution(const ImageView<float>& img, const Kernel& horiz_k, const Kernel& vert_k, Image<float>& out)
+{
+    ImageSeparableConvolution(ImageView<const float>(img), horiz_k, vert_k, out);
+}
+
 }  // namespace image
 }  // namespace aliceVision
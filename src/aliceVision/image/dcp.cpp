@@ -12,6 +12,7 @@
 #include <cstdio>
 #include <cstring>
 #include <functional>
+#include <mutex>
 
 namespace aliceVision {
 namespace image {
@@ -246,6 +247,38 @@ const std::vector<std::vector<float>> WYSZECKI_ROBERSTON_TABLE = {
 
 // Useful matrices
 const DCPProfile::Matrix IdentityMatrix = {1.0, 0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 1.0};
+
+/**
+ * @brief Call f(rgb) on the 3 first channels of each pixel of an image, to modify them in place.
+ * The float images in memory are accessed directly, the others through getpixel/setpixel.
+ */
+template<class F>
+void forEachRGBPixel(OIIO::ImageBuf& image, F&& f)
+{
+    const OIIO::ImageSpec& spec = image.spec();
+    if (spec.format == OIIO::TypeDesc::FLOAT && spec.nchannels >= 3 && image.localpixels() != nullptr)
+    {
+        const OIIO::stride_t pixelStride = image.pixel_stride();
+#pragma omp parallel for
+        for (int i = 0; i < spec.height; ++i)
+        {
+            char* pixel = static_cast<char*>(image.pixeladdr(spec.x, spec.y + i));
+            for (int j = 0; j < spec.width; ++j, pixel += pixelStride)
+                f(reinterpret_cast<float*>(pixel));
+        }
+        return;
+    }
+
+#pragma omp parallel for
+    for (int i = 0; i < spec.height; ++i)
+        for (int j = 0; j < spec.width; ++j)
+        {
+            float rgb[3];
+            image.getpixel(j, i, rgb, 3);
+            f(rgb);
+            image.setpixel(j, i, rgb, 3);
+        }
+}
 const DCPProfile::Matrix CAT02_MATRIX = {0.7328, 0.4296, -0.1624, -0.7036, 1.6975, 0.0061, 0.0030, 0.0136, 0.9834};
 const DCPProfile::Matrix xyzD50ToSrgbD65LinearMatrix =
   {3.2404542, -1.5371385, -0.4985314, -0.9692660, 1.8760108, 0.0415560, 0.0556434, -0.2040259, 1.0572252};
@@ -1349,23 +1382,17 @@ void DCPProfile::apply(OIIO::ImageBuf& image, const DCPProfileApplyParams& param
     }
 
     // Apply DCP profile
-#pragma omp parallel for
-    for (int i = 0; i < image.spec().height; ++i)
-        for (int j = 0; j < image.spec().width; ++j)
+    forEachRGBPixel(image, [&](float* rgb) {
+        for (int c = 0; c < 3; ++c)
         {
-            float rgb[3];
-            image.getpixel(j, i, rgb, 3);
-            for (int c = 0; c < 3; ++c)
-            {
-                rgb[c] *= 65535.0;
-            }
-            apply(rgb, params);
-            for (int c = 0; c < 3; ++c)
-            {
-                rgb[c] /= 65535.0;
-            }
-            image.setpixel(j, i, rgb, 3);
+            rgb[c] *= 65535.0;
         }
+        apply(rgb, params);
+        for (int c = 0; c < 3; ++c)
+        {
+            rgb[c] /= 65535.0;
+        }
+    });
 }
 
 void DCPProfile::apply(float* rgb, const DCPProfileApplyParams& params) const
@@ -2309,24 +2336,19 @@ void DCPProfile::applyLinear(OIIO::ImageBuf& image, const Triple& neutral, doubl
 
     ALICEVISION_LOG_INFO("cameraToACES2065Matrix: " << cameraToACES2065Matrix);
 
-#pragma omp parallel for
-    for (int i = 0; i < image.spec().height; ++i)
-        for (int j = 0; j < image.spec().width; ++j)
-        {
-            float rgb[3];
-            image.getpixel(j, i, rgb, 3);
-
-            float rgbOut[3];
-            for (int r = 0; r < 3; ++r)
-            {
-                rgbOut[r] = 0.0;
-                for (int c = 0; c < 3; ++c)
-                {
-                    rgbOut[r] += cameraToACES2065Matrix[r][c] * rgb[c];
-                }
-            }
-            image.setpixel(j, i, rgbOut, 3);
-        }
+    float m[3][3];
+    for (int r = 0; r < 3; ++r)
+        for (int c = 0; c < 3; ++c)
+            m[r][c] = static_cast<float>(cameraToACES2065Matrix[r][c]);
+
+    forEachRGBPixel(image, [&m](float* rgb) {
+        const float r = rgb[0];
+        const float g = rgb[1];
+        const float b = rgb[2];
+        rgb[0] = m[0][0] * r + m[0][1] * g + m[0][2] * b;
+        rgb[1] = m[1][0] * r + m[1][1] * g + m[1][2] * b;
+        rgb[2] = m[2][0] * r + m[2][1] * g + m[2][2] * b;
+    });
 }
 
 void DCPProfile::applyLinear(Image<image::RGBAfColor>& image,
@@ -2339,22 +2361,22 @@ void DCPProfile::applyLinear(Image<image::RGBAfColor>& image,
 
     ALICEVISION_LOG_INFO("cameraToACES2065Matrix: " << cameraToACES2065Matrix);
 
+    float m[3][3];
+    for (int r = 0; r < 3; ++r)
+        for (int c = 0; c < 3; ++c)
+            m[r][c] = static_cast<float>(cameraToACES2065Matrix[r][c]);
+
 #pragma omp parallel for
     for (int i = 0; i < image.Height(); ++i)
         for (int j = 0; j < image.Width(); ++j)
         {
-            const RGBAfColor rgb = image(i, j);
-
-            RGBAfColor rgbOut = rgb;
-            for (int r = 0; r < 3; ++r)
-            {
-                rgbOut[r] = 0.0;
-                for (int c = 0; c < 3; ++c)
-                {
-                    rgbOut[r] += cameraToACES2065Matrix[r][c] * rgb[c];
-                }
-            }
-            image(i, j) = rgbOut;
+            RGBAfColor& rgb = image(i, j);
+            const float r = rgb.r();
+            const float g = rgb.g();
+            const float b = rgb.b();
+            rgb.r() = m[0][0] * r + m[0][1] * g + m[0][2] * b;
+            rgb.g() = m[1][0] * r + m[1][1] * g + m[1][2] * b;
+            rgb.b() = m[2][0] * r + m[2][1] * g + m[2][2] * b;
         }
 }
 
@@ -2366,6 +2388,31 @@ void DCPProfile::getColorTemperatureAndTintFromNeutral(const Triple& neutral, do
     setChromaticityCoordinates(x, y, cct, tint);
 }
 
+std::shared_ptr<const DCPProfile> getCachedDCPProfile(const std::string& filename)
+{
+    struct CachedProfile
+    {
+        std::time_t lastWriteTime;
+        std::shared_ptr<const DCPProfile> profile;
+    };
+    static std::mutex cacheMutex;
+    static std::map<std::string, CachedProfile> cache;
+
+    boost::system::error_code ec;
+    const std::time_t lastWriteTime = bfs::last_write_time(filename, ec);
+
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    const auto it = cache.find(filename);
+    if (it != cache.end() && it->second.lastWriteTime == lastWriteTime)
+    {
+        return it->second.profile;
+    }
+
+    std::shared_ptr<const DCPProfile> profile = std::make_shared<const DCPProfile>(filename);
+    cache[filename] = {lastWriteTime, profile};
+    return profile;
+}
+
 DCPDatabase::DCPDatabase(const std::string& databaseDirPath) { load(databaseDirPath, true); }
 
 int DCPDatabase::load(const std::string& databaseDirPath, bool force)
@@ -2427,7 +2474,7 @@ bool DCPDatabase::retrieveDcpForCamera(const std::string& make, const std::strin
 
         if (it != dcpFilenamesList.end())
         {
-            dcpProf.Load(*it);
+            dcpProf = *getCachedDCPProfile(*it);
             dcpStore.insert(std::pair<std::string, image::DCPProfile>(dcpKey, dcpProf));
             return true;
         }
@@ -298,6 +298,14 @@ class DCPProfile final
     SplineToneCurve igammatab_srgb;
 };
 
+/**
+ * @brief Get a DCP profile loaded from a file.
+ * The profiles are parsed once per process and shared between the threads, a profile is reloaded if its file is modified.
+ * @param[in] filename The dcp path on disk
+ * @return the loaded DCP profile
+ */
+std::shared_ptr<const DCPProfile> getCachedDCPProfile(const std::string& filename);
+
 /**
  * @brief DCPDatabase manages DCP profiles loading and caching
  */
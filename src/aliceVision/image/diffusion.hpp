@@ -39,7 +39,13 @@ void ImagePeronaMalikG2DiffusionCoef(const Image& Lx, const Image& Ly, const typ
     }
 
     typedef typename Image::Tpixel Real;
-    out.array() = (static_cast<Real>(1.f) + (Lx.array().square() + Ly.array().square()) / (k * k)).inverse();
+    const Real k2 = k * k;
+
+#pragma omp parallel for
+    for (int i = 0; i < height; ++i)
+    {
+        out.row(i).array() = (static_cast<Real>(1.f) + (Lx.row(i).array().square() + Ly.row(i).array().square()) / k2).inverse();
+    }
 }
 
 /**
@@ -50,9 +56,16 @@ void ImagePeronaMalikG2DiffusionCoef(const Image& Lx, const Image& Ly, const typ
 ** @param out Output image
 ** @param row_start Row range beginning (range is [row_start ; row_end [ )
 ** @param row_end Row range end (range is [row_start ; row_end [ )
+** @param add_src if true, out is the diffused image (src + step) instead of the step
 **/
 template<typename Image>
-void ImageFEDCentral(const Image& src, const Image& diff, const typename Image::Tpixel half_t, Image& out, const int row_start, const int row_end)
+void ImageFEDCentral(const Image& src,
+                     const Image& diff,
+                     const typename Image::Tpixel half_t,
+                     Image& out,
+                     const int row_start,
+                     const int row_end,
+                     const bool add_src = false)
 {
     typedef typename Image::Tpixel Real;
     const int width = src.Width();
@@ -81,7 +94,7 @@ void ImageFEDCentral(const Image& src, const Image& diff, const typename Image::
             const Real c = (cur_diff + n_diff[2]) * (cur_src - n_src[2]);
             const Real d = (cur_diff + n_diff[3]) * (n_src[3] - cur_src);
             const Real value = half_t * (a - c + d - b);
-            out(i, j) = value;
+            out(i, j) = add_src ? cur_src + value : value;
         }
     }
 }
@@ -92,9 +105,10 @@ void ImageFEDCentral(const Image& src, const Image& diff, const typename Image::
 ** @param diff diffusion coefficient image
 ** @param half_t Half diffusion time
 ** @param out Output image
+** @param add_src if true, out is the diffused image (src + step) instead of the step
 **/
 template<typename Image>
-void ImageFEDCentralCPPThread(const Image& src, const Image& diff, const typename Image::Tpixel half_t, Image& out)
+void ImageFEDCentralCPPThread(const Image& src, const Image& diff, const typename Image::Tpixel half_t, Image& out, const bool add_src = false)
 {
     const int nb_thread = omp_get_max_threads();
 
@@ -105,7 +119,7 @@ void ImageFEDCentralCPPThread(const Image& src, const Image& diff, const typenam
 #pragma omp parallel for schedule(dynamic)
     for (int i = 1; i < static_cast<int>(range.size()); ++i)
     {
-        ImageFEDCentral(src, diff, half_t, out, range[i - 1], range[i]);
+        ImageFEDCentral(src, diff, half_t, out, range[i - 1], range[i], add_src);
     }
 }
 
@@ -114,10 +128,11 @@ void ImageFEDCentralCPPThread(const Image& src, const Image& diff, const typenam
 ** @param src input image
 ** @param diff diffusion coefficient image
 ** @param t diffusion time
-** @param out output image
+** @param out output image (must not be src)
+** @param add_src if true, out is the diffused image (src + step) instead of the step
 **/
 template<typename Image>
-void ImageFED(const Image& src, const Image& diff, const typename Image::Tpixel t, Image& out)
+void ImageFED(const Image& src, const Image& diff, const typename Image::Tpixel t, Image& out, const bool add_src = false)
 {
     typedef typename Image::Tpixel Real;
     const int width = src.Width();
@@ -131,7 +146,7 @@ void ImageFED(const Image& src, const Image& diff, const typename Image::Tpixel
     Real n_src[4];
 
     // Take care of the central part
-    ImageFEDCentralCPPThread(src, diff, half_t, out);
+    ImageFEDCentralCPPThread(src, diff, half_t, out, add_src);
 
     // Take care of the border
     // - first/last row
@@ -154,7 +169,7 @@ void ImageFED(const Image& src, const Image& diff, const typename Image::Tpixel
         const Real c = (cur_diff + n_diff[2]) * (cur_src - n_src[2]);
         const Real d = (cur_diff + n_diff[3]) * (n_src[3] - cur_src);
         const Real value = half_t * (a - c + d);
-        out(0, j) = value;
+        out(0, j) = add_src ? cur_src + value : value;
     }
 
     // Compute FED step on last row
@@ -174,7 +189,7 @@ void ImageFED(const Image& src, const Image& diff, const typename Image::Tpixel
         const Real b = (cur_diff + n_diff[1]) * (cur_src - n_src[1]);
         const Real c = (cur_diff + n_diff[2]) * (cur_src - n_src[2]);
         const Real value = half_t * (a - c - b);
-        out(height - 1, j) = value;
+        out(height - 1, j) = add_src ? cur_src + value : value;
     }
 
     // Compute FED step on first col
@@ -194,7 +209,7 @@ void ImageFED(const Image& src, const Image& diff, const typename Image::Tpixel
         const Real b = (cur_diff + n_diff[1]) * (cur_src - n_src[1]);
         const Real d = (cur_diff + n_diff[3]) * (n_src[3] - cur_src);
         const Real value = half_t * (a + d - b);
-        out(i, 0) = value;
+        out(i, 0) = add_src ? cur_src + value : value;
     }
 
     // Compute FED step on last col
@@ -214,7 +229,16 @@ void ImageFED(const Image& src, const Image& diff, const typename Image::Tpixel
         const Real c = (cur_diff + n_diff[2]) * (cur_src - n_src[2]);
         const Real d = (cur_diff + n_diff[3]) * (n_src[3] - cur_src);
         const Real value = half_t * (-c + d - b);
-        out(i, width - 1) = value;
+        out(i, width - 1) = add_src ? cur_src + value : value;
+    }
+
+    // Corners are not diffused
+    if (add_src)
+    {
+        out(0, 0) = src(0, 0);
+        out(0, width - 1) = src(0, width - 1);
+        out(height - 1, 0) = src(height - 1, 0);
+        out(height - 1, width - 1) = src(height - 1, width - 1);
     }
 }
 
@@ -227,11 +251,12 @@ void ImageFED(const Image& src, const Image& diff, const typename Image::Tpixel
 template<typename Image>
 void ImageFEDCycle(Image& self, const Image& diff, const std::vector<typename Image::Tpixel>& tau)
 {
+    // each step writes the diffused image in the other buffer, no separate accumulation pass
     Image tmp;
     for (int i = 0; i < tau.size(); ++i)
     {
-        ImageFED(self, diff, tau[i], tmp);
-        self.array() += tmp.array();
+        ImageFED(self, diff, tau[i], tmp, true);
+        self.swap(tmp);
     }
 }
 
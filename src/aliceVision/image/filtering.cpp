@@ -7,9 +7,108 @@
 
 #include "filtering.hpp"
 
+#include <aliceVision/alicevision_omp.hpp>
+
+#include <vector>
+
 namespace aliceVision {
 namespace image {
 
+namespace {
+
+/**
+ ** Separable convolution with 3-taps kernels whose taps are spaced by step pixels
+ ** (i.e. the non-zero taps of a (2 * step + 1) kernel), same borders as SeparableConvolution2d
+ ** @param img Input image
+ ** @param kernelHoriz horizontal kernel taps at offsets -step, 0, step
+ ** @param kernelVert vertical kernel taps at offsets -step, 0, step
+ ** @param step taps spacing
+ ** @param out Output image
+ **/
+void SparseSeparableConvolution(const Image<float>& img, const float kernelHoriz[3], const float kernelVert[3], const int step, Image<float>& out)
+{
+    const int width = img.Width();
+    const int height = img.Height();
+
+    out.resize(width, height, false);
+
+#pragma omp parallel if (width * height >= convolutionParallelMinSize)
+    {
+        // vertically filtered row with its horizontal borders
+        std::vector<float> line(width + 2 * step);
+        float* lineCenter = line.data() + step;
+
+#pragma omp for schedule(dynamic)
+        for (int i = 0; i < height; ++i)
+        {
+            // mirrored borders without repeating the edge row
+            const int iUp = (i >= step) ? i - step : step - i;
+            const int iDown = (i + step < height) ? i + step : 2 * (height - 1) - i - step;
+
+            const float* rowUp = img.data() + static_cast<std::size_t>(iUp) * width;
+            const float* rowCur = img.data() + static_cast<std::size_t>(i) * width;
+            const float* rowDown = img.data() + static_cast<std::size_t>(iDown) * width;
+            for (int j = 0; j < width; ++j)
+            {
+                lineCenter[j] = kernelVert[0] * rowUp[j] + kernelVert[1] * rowCur[j] + kernelVert[2] * rowDown[j];
+            }
+
+            // horizontal borders as built by SeparableConvolution2d
+            for (int m = 1; m <= step; ++m)
+            {
+                lineCenter[-m] = lineCenter[m];
+                lineCenter[width - 1 + m] = lineCenter[width - 2 - m];
+            }
+
+            float* rowOut = out.data() + static_cast<std::size_t>(i) * width;
+            for (int j = 0; j < width; ++j)
+            {
+                rowOut[j] = kernelHoriz[0] * lineCenter[j - step] + kernelHoriz[1] * lineCenter[j] + kernelHoriz[2] * lineCenter[j + step];
+            }
+        }
+    }
+}
+
+}  // namespace
+
+void ImageScaledScharrXDerivative(const Image<float>& img, Image<float>& out, const int scale, const bool bNormalize)
+{
+    // too small for the mirrored borders, use the generic convolution
+    if (img.Width() < 2 * scale + 2 || img.Height() < 2 * scale + 1)
+    {
+        ImageScaledScharrXDerivative<Image<float>>(img, out, scale, bNormalize);
+        return;
+    }
+
+    // Scharr parameter for derivative
+    const double w = 10.0 / 3.0;
+    const double norm = bNormalize ? 1.0 / (2.0 * scale * (w + 2.0)) : 1.0;
+
+    const float kernelHoriz[3] = {-1.f, 0.f, 1.f};
+    const float kernelVert[3] = {static_cast<float>(norm), static_cast<float>(w * norm), static_cast<float>(norm)};
+
+    SparseSeparableConvolution(img, kernelHoriz, kernelVert, scale, out);
+}
+
+void ImageScaledScharrYDerivative(const Image<float>& img, Image<float>& out, const int scale, const bool bNormalize)
+{
+    // too small for the mirrored borders, use the generic convolution
+    if (img.Width() < 2 * scale + 2 || img.Height() < 2 * scale + 1)
+    {
+        ImageScaledScharrYDerivative<Image<float>>(img, out, scale, bNormalize);
+        return;
+    }
+
+    // Scharr parameter for derivative
+    const double w = 10.0 / 3.0;
+    const double norm = bNormalize ? 1.0 / (2.0 * scale * (w + 2.0)) : 1.0;
+
+    const float kernelHoriz[3] = {static_cast<float>(norm), static_cast<float>(w * norm), static_cast<float>(norm)};
+    const float kernelVert[3] = {-1.f, 0.f, 1.f};
+
+    SparseSeparableConvolution(img, kernelHoriz, kernelVert, scale, out);
+}
+
 Vec ComputeGaussianKernel(const std::size_t size, const double sigma)
 {
     // If kernel size is 0 computes it's size using uber formula
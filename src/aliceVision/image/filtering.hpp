@@ -32,8 +32,8 @@ namespace image {
  ** @param out Output image
  ** @param normalize true if kernel must be scaled by 1/2
  **/
-template<typename Image>
-void ImageXDerivative(const Image& img, Image& out, const bool normalize = true)
+template<typename ImageTypeIn, typename ImageTypeOut>
+void ImageXDerivative(const ImageTypeIn& img, ImageTypeOut& out, const bool normalize = true)
 {
     Vec3 kernel(-1.0, 0.0, 1.0);
 
@@ -49,8 +49,8 @@ void ImageXDerivative(const Image& img, Image& out, const bool normalize = true)
  ** @param out Output image
  ** @param normalize true if kernel must be normalized
  **/
-template<typename Image>
-void ImageYDerivative(const Image& img, Image& out, const bool normalize = true)
+template<typename ImageTypeIn, typename ImageTypeOut>
+void ImageYDerivative(const ImageTypeIn& img, ImageTypeOut& out, const bool normalize = true)
 {
     Vec3 kernel(-1.0, 0.0, 1.0);
 
@@ -66,8 +66,8 @@ void ImageYDerivative(const Image& img, Image& out, const bool normalize = true)
  ** @param out Output image
  ** @param normalize true if kernel must be scaled by 1/8
  **/
-template<typename Image>
-void ImageSobelXDerivative(const Image& img, Image& out, const bool normalize = true)
+template<typename ImageTypeIn, typename ImageTypeOut>
+void ImageSobelXDerivative(const ImageTypeIn& img, ImageTypeOut& out, const bool normalize = true)
 {
     Vec3 kernel_horiz(-1.0, 0.0, 1.0);
 
@@ -88,8 +88,8 @@ void ImageSobelXDerivative(const Image& img, Image& out, const bool normalize =
  ** @param out Output image
  ** @param normalize true if kernel must be scaled by 1/8
  **/
-template<typename Image>
-void ImageSobelYDerivative(const Image& img, Image& out, const bool normalize = true)
+template<typename ImageTypeIn, typename ImageTypeOut>
+void ImageSobelYDerivative(const ImageTypeIn& img, ImageTypeOut& out, const bool normalize = true)
 {
     Vec3 kernel_horiz(1.0, 2.0, 1.0);
 
@@ -110,8 +110,8 @@ void ImageSobelYDerivative(const Image& img, Image& out, const bool normalize =
  ** @param out Output image
  ** @param normalize true if kernel must be scaled by 1/32
  **/
-template<typename Image>
-void ImageScharrXDerivative(const Image& img, Image& out, const bool normalize = true)
+template<typename ImageTypeIn, typename ImageTypeOut>
+void ImageScharrXDerivative(const ImageTypeIn& img, ImageTypeOut& out, const bool normalize = true)
 {
     Vec3 kernel_horiz(-1.0, 0.0, 1.0);
 
@@ -132,8 +132,8 @@ void ImageScharrXDerivative(const Image& img, Image& out, const bool normalize =
  ** @param out Output image
  ** @param normalize true if kernel must be scaled by 1/32
  **/
-template<typename Image>
-void ImageScharrYDerivative(const Image& img, Image& out, const bool normalize = true)
+template<typename ImageTypeIn, typename ImageTypeOut>
+void ImageScharrYDerivative(const ImageTypeIn& img, ImageTypeOut& out, const bool normalize = true)
 {
     Vec3 kernel_horiz(3.0, 10.0, 3.0);
 
@@ -155,8 +155,8 @@ void ImageScharrYDerivative(const Image& img, Image& out, const bool normalize =
  ** @param scale scale of filter (1 -> 3x3 filter ; 2 -> 5x5, ...)
  ** @param bNormalize true if kernel must be normalized
  **/
-template<typename Image>
-void ImageScaledScharrXDerivative(const Image& img, Image& out, const int scale, const bool bNormalize = true)
+template<typename ImageTypeIn, typename ImageTypeOut>
+void ImageScaledScharrXDerivative(const ImageTypeIn& img, ImageTypeOut& out, const int scale, const bool bNormalize = true)
 {
     const int kernel_size = 3 + 2 * (scale - 1);
 
@@ -196,8 +196,8 @@ void ImageScaledScharrXDerivative(const Image& img, Image& out, const int scale,
  ** @param scale scale of filter (1 -> 3x3 filter ; 2 -> 5x5, ...)
  ** @param bNormalize true if kernel must be normalized
  **/
-template<typename Image>
-void ImageScaledScharrYDerivative(const Image& img, Image& out, const int scale, const bool bNormalize = true)
+template<typename ImageTypeIn, typename ImageTypeOut>
+void ImageScaledScharrYDerivative(const ImageTypeIn& img, ImageTypeOut& out, const int scale, const bool bNormalize = true)
 {
     /*
     General Y-derivative function
@@ -230,6 +230,26 @@ void ImageScaledScharrYDerivative(const Image& img, Image& out, const int scale,
     ImageSeparableConvolution(img, kernel_horiz, kernel_vert, out);
 }
 
+/**
+ ** Compute X-derivative using scaled Scharr filter on a float image
+ ** Only the 3 non-zero taps of the scaled kernels are evaluated.
+ ** @param img Input image
+ ** @param out Output image
+ ** @param scale scale of filter (1 -> 3x3 filter ; 2 -> 5x5, ...)
+ ** @param bNormalize true if kernel must be normalized
+ **/
+void ImageScaledScharrXDerivative(const Image<float>& img, Image<float>& out, const int scale, const bool bNormalize = true);
+
+/**
+ ** Compute Y-derivative using scaled Scharr filter on a float image
+ ** Only the 3 non-zero taps of the scaled kernels are evaluated.
+ ** @param img Input image
+ ** @param out Output image
+ ** @param scale scale of filter (1 -> 3x3 filter ; 2 -> 5x5, ...)
+ ** @param bNormalize true if kernel must be normalized
+ **/
+void ImageScaledScharrYDerivative(const Image<float>& img, Image<float>& out, const int scale, const bool bNormalize = true);
+
 /**
  ** Compute (isotropic) gaussian filtering of an image using filter width of k * sigma
  ** @param img Input image
@@ -238,8 +258,8 @@ void ImageScaledScharrYDerivative(const Image& img, Image& out, const int scale,
  ** @param k confidence interval param - kernel is width k * sigma * 2 + 1 -- using k = 3 gives 99% of gaussian curve
  ** @param border_mgmt either BORDER_COPY or BORDER_CROP to tell what to do with borders
  **/
-template<typename Image>
-void ImageGaussianFilter(const Image& img, const double sigma, Image& out, const int k = 3)
+template<typename ImageTypeIn, typename ImageTypeOut>
+void ImageGaussianFilter(const ImageTypeIn& img, const double sigma, ImageTypeOut& out, const int k = 3)
 {
     // Compute Gaussian filter
     const int k_size = (int)2 * k * sigma + 1;
@@ -287,8 +307,8 @@ Vec ComputeGaussianKernel(const std::size_t size, const double sigma);
  ** @param kernel_size_x Size of horizontal kernel (must be an odd number or 0 for automatic computation)
  ** @param kernel_size_y Size of vertical kernel (must be an add number or 0 for automatic computation)
  **/
-template<typename Image>
-void ImageGaussianFilter(const Image& img, const double sigma, Image& out, const size_t kernel_size_x, const size_t kernel_size_y)
+template<typename ImageTypeIn, typename ImageTypeOut>
+void ImageGaussianFilter(const ImageTypeIn& img, const double sigma, ImageTypeOut& out, const size_t kernel_size_x, const size_t kernel_size_y)
 {
     assert(kernel_size_x % 2 == 1 || kernel_size_x == 0);
     assert(kernel_size_y % 2 == 1 || kernel_size_y == 0);
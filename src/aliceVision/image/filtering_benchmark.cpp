@@ -0,0 +1,43 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <aliceVision/image/Image.hpp>
+#include <aliceVision/image/filtering.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <random>
+
+using namespace aliceVision;
+using namespace aliceVision::image;
+
+/**
+ * @brief Gaussian filter of a random state.range(0) x state.range(0) float image with sigma = state.range(1).
+ */
+static void BM_ImageGaussianFilter(benchmark::State& state)
+{
+    const int size = static_cast<int>(state.range(0));
+    const double sigma = static_cast<double>(state.range(1));
+
+    std::mt19937 generator(0);
+    std::uniform_real_distribution<float> valueDist(0.0f, 1.0f);
+
+    Image<float> in(size, size);
+    for (int y = 0; y < size; ++y)
+        for (int x = 0; x < size; ++x)
+            in(y, x) = valueDist(generator);
+
+    Image<float> out;
+    for (auto _ : state)
+    {
+        ImageGaussianFilter(in, sigma, out);
+        benchmark::DoNotOptimize(out.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * size * size);
+}
+
+BENCHMARK(BM_ImageGaussianFilter)->Args({1024, 2})->Args({1024, 6})->Args({4096, 2})->Unit(benchmark::kMillisecond);
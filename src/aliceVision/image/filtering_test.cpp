@@ -139,3 +139,45 @@ BOOST_AUTO_TEST_CASE(Image_Convolution_Sobel_X_Y)
     BOOST_CHECK_NO_THROW(
       writeImage("out_SobelY.png", outFilteredCast, image::ImageWriteOptions().toColorSpace(image::EImageColorSpace::NO_CONVERSION)));
 }
+
+BOOST_AUTO_TEST_CASE(Image_Convolution_Horizontal_Vertical)
+{
+    Image<float> in(53, 37);
+    for (int i = 0; i < in.size(); ++i)
+        in.data()[i] = static_cast<float>(rand() % 255);
+
+    Vec kernel(5);
+    kernel << 0.1, 0.2, 0.4, 0.2, 0.1;
+    const Eigen::VectorXf kernelf = kernel.cast<float>();
+
+    // same result as the 2d convolution with a row or column kernel (border pixels are copied)
+    Image<float> outHorizontal, outVertical, outHorizontal2d, outVertical2d;
+    ImageHorizontalConvolution(in, kernelf, outHorizontal);
+    ImageVerticalConvolution(in, kernelf, outVertical);
+    ImageConvolution(in, Mat(kernel.transpose()), outHorizontal2d);
+    ImageConvolution(in, Mat(kernel), outVertical2d);
+
+    BOOST_CHECK_SMALL((outHorizontal.GetMat() - outHorizontal2d.GetMat()).cwiseAbs().maxCoeff(), 1e-3f);
+    BOOST_CHECK_SMALL((outVertical.GetMat() - outVertical2d.GetMat()).cwiseAbs().maxCoeff(), 1e-3f);
+}
+
+BOOST_AUTO_TEST_CASE(Image_Convolution_Scaled_Scharr_Sparse)
+{
+    Image<float> in(61, 43);
+    for (int i = 0; i < in.size(); ++i)
+        in.data()[i] = static_cast<float>(rand() % 255) / 255.f;
+
+    // the float overloads only evaluate the non-zero taps, same result as the generic separable convolution
+    for (int scale = 1; scale <= 4; ++scale)
+    {
+        Image<float> outSparse, outGeneric;
+
+        ImageScaledScharrXDerivative(in, outSparse, scale);
+        ImageScaledScharrXDerivative<Image<float>>(in, outGeneric, scale);
+        BOOST_CHECK_SMALL((outSparse.GetMat() - outGeneric.GetMat()).cwiseAbs().maxCoeff(), 1e-5f);
+
+        ImageScaledScharrYDerivative(in, outSparse, scale);
+        ImageScaledScharrYDerivative<Image<float>>(in, outGeneric, scale);
+        BOOST_CHECK_SMALL((outSparse.GetMat() - outGeneric.GetMat()).cwiseAbs().maxCoeff(), 1e-5f);
+    }
+}
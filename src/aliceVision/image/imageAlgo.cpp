@@ -35,11 +35,16 @@ float func_LABtoXYZ(float t)
         return 0.1284f * (t - 0.1379f);
 }
 
-void RGBtoXYZ(oiio::ImageBuf::Iterator<float>& pixel)
+namespace {
+
+// The conversions are written for both the OIIO pixel iterators and the packed float pixels (float*)
+
+template<typename Pixel>
+void RGBtoXYZImpl(Pixel& pixel)
 {
+    static const Eigen::Matrix3f M = (Eigen::Matrix3f() << 0.4124f, 0.3576f, 0.1805f, 0.2126f, 0.7152f, 0.0722f, 0.0193f, 0.1192f, 0.9504f).finished();
+
     const Eigen::Vector3f rgb(pixel[0], pixel[1], pixel[2]);
-    Eigen::Matrix3f M;
-    M << 0.4124f, 0.3576f, 0.1805f, 0.2126f, 0.7152f, 0.0722f, 0.0193f, 0.1192f, 0.9504f;
     const Eigen::Vector3f xyz_vec = M * rgb;
 
     pixel[0] = xyz_vec[0] * 0.9505f;
@@ -47,11 +52,13 @@ void RGBtoXYZ(oiio::ImageBuf::Iterator<float>& pixel)
     pixel[2] = xyz_vec[2] * 1.0890f;
 }
 
-void XYZtoRGB(oiio::ImageBuf::Iterator<float>& pixel)
+template<typename Pixel>
+void XYZtoRGBImpl(Pixel& pixel)
 {
+    static const Eigen::Matrix3f M =
+      (Eigen::Matrix3f() << 3.2406f, -1.5372f, -0.4986f, -0.9689f, 1.8758f, 0.0415f, 0.0557f, -0.2040f, 1.0570f).finished();
+
     const Eigen::Vector3f xyz(pixel[0] / 0.9505f, pixel[1], pixel[2] / 1.0890f);
-    Eigen::Matrix3f M;
-    M << 3.2406f, -1.5372f, -0.4986f, -0.9689f, 1.8758f, 0.0415f, 0.0557f, -0.2040f, 1.0570f;
     const Eigen::Vector3f rgb_vec = M * xyz;
 
     pixel[0] = rgb_vec[0];
@@ -59,18 +66,21 @@ void XYZtoRGB(oiio::ImageBuf::Iterator<float>& pixel)
     pixel[2] = rgb_vec[2];
 }
 
-void XYZtoLAB(oiio::ImageBuf::Iterator<float>& pixel)
+template<typename Pixel>
+void XYZtoLABImpl(Pixel& pixel)
 {
-    float L = 116.0f * func_XYZtoLAB(pixel[1]) - 16.0f;
-    float A = 500.0f * (func_XYZtoLAB(pixel[0]) - func_XYZtoLAB(pixel[1]));
-    float B = 200.0f * (func_XYZtoLAB(pixel[1]) - func_XYZtoLAB(pixel[2]));
+    const float fy = func_XYZtoLAB(pixel[1]);
+    float L = 116.0f * fy - 16.0f;
+    float A = 500.0f * (func_XYZtoLAB(pixel[0]) - fy);
+    float B = 200.0f * (fy - func_XYZtoLAB(pixel[2]));
 
     pixel[0] = L / 100.0f;
     pixel[1] = A / 100.0f;
     pixel[2] = B / 100.0f;
 }
 
-void LABtoXYZ(oiio::ImageBuf::Iterator<float>& pixel)
+template<typename Pixel>
+void LABtoXYZImpl(Pixel& pixel)
 {
     float L_offset = (pixel[0] * 100.0f + 16.0f) / 116.0f;
 
@@ -79,16 +89,80 @@ void LABtoXYZ(oiio::ImageBuf::Iterator<float>& pixel)
     pixel[2] = func_LABtoXYZ(L_offset - pixel[2] * 100.0f / 200.0f);
 }
 
+/**
+ * @brief Apply a conversion on the float pixels of an image buffer stored in memory, rows are processed in parallel
+ * @param[in,out] image The image buffer
+ * @param[in] pixelFunc The conversion, called with a pointer to the first channel of each pixel
+ * @return false if the pixels are not 3 or more float channels stored in memory
+ */
+template<typename PixelFunc>
+bool processLocalPixels(oiio::ImageBuf& image, const PixelFunc& pixelFunc)
+{
+    const oiio::ImageSpec& spec = image.spec();
+
+    if (image.localpixels() == nullptr || spec.format != oiio::TypeDesc::FLOAT || spec.nchannels < 3 || spec.depth > 1 || spec.deep)
+    {
+        return false;
+    }
+
+    const std::ptrdiff_t pixelStride = image.pixel_stride() / static_cast<std::ptrdiff_t>(sizeof(float));
+
+    oiio::ImageBufAlgo::parallel_image(image.roi(), [&image, &pixelFunc, pixelStride](oiio::ROI roi) {
+        for (int y = roi.ybegin; y < roi.yend; ++y)
+        {
+            float* pixel = static_cast<float*>(image.pixeladdr(roi.xbegin, y));
+            for (int x = roi.xbegin; x < roi.xend; ++x, pixel += pixelStride)
+            {
+                pixelFunc(pixel);
+            }
+        }
+    });
+
+    return true;
+}
+
+/**
+ * @brief Apply a conversion on all the pixels of an image buffer,
+ *        directly on the packed pixels when possible, through the OIIO pixel iterators otherwise
+ */
+template<typename PixelFunc>
+void processPixels(oiio::ImageBuf& image, const PixelFunc& pixelFunc)
+{
+    if (!processLocalPixels(image, pixelFunc))
+    {
+        processImage(image, [&pixelFunc](oiio::ImageBuf::Iterator<float>& pixel) { pixelFunc(pixel); });
+    }
+}
+
+/**
+ * @brief Convert between two OIIO/OCIO color spaces in place, with a shared color processor
+ */
+void colorconvertOIIO(oiio::ImageBuf& imgBuf, const std::string& fromColorSpace, const std::string& toColorSpace)
+{
+    const oiio::ColorProcessorHandle processor = image::getColorProcessor(fromColorSpace, toColorSpace);
+    oiio::ImageBufAlgo::colorconvert(imgBuf, imgBuf, processor.get(), true);
+}
+
+}  // namespace
+
+void RGBtoXYZ(oiio::ImageBuf::Iterator<float>& pixel) { RGBtoXYZImpl(pixel); }
+
+void XYZtoRGB(oiio::ImageBuf::Iterator<float>& pixel) { XYZtoRGBImpl(pixel); }
+
+void XYZtoLAB(oiio::ImageBuf::Iterator<float>& pixel) { XYZtoLABImpl(pixel); }
+
+void LABtoXYZ(oiio::ImageBuf::Iterator<float>& pixel) { LABtoXYZImpl(pixel); }
+
 void RGBtoLAB(oiio::ImageBuf::Iterator<float>& pixel)
 {
-    RGBtoXYZ(pixel);
-    XYZtoLAB(pixel);
+    RGBtoXYZImpl(pixel);
+    XYZtoLABImpl(pixel);
 }
 
 void LABtoRGB(oiio::ImageBuf::Iterator<float>& pixel)
 {
-    LABtoXYZ(pixel);
-    XYZtoRGB(pixel);
+    LABtoXYZImpl(pixel);
+    XYZtoRGBImpl(pixel);
 }
 
 void processImage(oiio::ImageBuf& image, std::function<void(oiio::ImageBuf::Iterator<float>&)> pixelFunc)
@@ -146,47 +220,55 @@ void colorconvert(oiio::ImageBuf& imgBuf, image::EImageColorSpace fromColorSpace
     else if (toColorSpace == EImageColorSpace::LINEAR)
     {
         if (fromColorSpace == EImageColorSpace::SRGB)
-            oiio::ImageBufAlgo::colorconvert(
-              imgBuf, imgBuf, EImageColorSpace_enumToOIIOString(EImageColorSpace::SRGB), EImageColorSpace_enumToOIIOString(EImageColorSpace::LINEAR));
+            colorconvertOIIO(imgBuf, EImageColorSpace_enumToOIIOString(EImageColorSpace::SRGB), EImageColorSpace_enumToOIIOString(EImageColorSpace::LINEAR));
         else if (fromColorSpace == EImageColorSpace::XYZ)
-            processImage(imgBuf, &XYZtoRGB);
+            processPixels(imgBuf, [](auto& pixel) { XYZtoRGBImpl(pixel); });
         else if (fromColorSpace == EImageColorSpace::LAB)
-            processImage(imgBuf, &LABtoRGB);
+            processPixels(imgBuf, [](auto& pixel) {
+                LABtoXYZImpl(pixel);
+                XYZtoRGBImpl(pixel);
+            });
     }
     else if (toColorSpace == EImageColorSpace::SRGB)
     {
         if (fromColorSpace == EImageColorSpace::XYZ)
-            processImage(imgBuf, &XYZtoRGB);
+            processPixels(imgBuf, [](auto& pixel) { XYZtoRGBImpl(pixel); });
         else if (fromColorSpace == EImageColorSpace::LAB)
-            processImage(imgBuf, &LABtoRGB);
-        oiio::ImageBufAlgo::colorconvert(
-          imgBuf, imgBuf, EImageColorSpace_enumToOIIOString(EImageColorSpace::LINEAR), EImageColorSpace_enumToOIIOString(EImageColorSpace::SRGB));
+            processPixels(imgBuf, [](auto& pixel) {
+                LABtoXYZImpl(pixel);
+                XYZtoRGBImpl(pixel);
+            });
+        colorconvertOIIO(imgBuf, EImageColorSpace_enumToOIIOString(EImageColorSpace::LINEAR), EImageColorSpace_enumToOIIOString(EImageColorSpace::SRGB));
     }
     else if (toColorSpace == EImageColorSpace::XYZ)
     {
         if (fromColorSpace == EImageColorSpace::LINEAR)
-            processImage(imgBuf, &RGBtoXYZ);
+            processPixels(imgBuf, [](auto& pixel) { RGBtoXYZImpl(pixel); });
         else if (fromColorSpace == EImageColorSpace::SRGB)
         {
-            oiio::ImageBufAlgo::colorconvert(
-              imgBuf, imgBuf, EImageColorSpace_enumToOIIOString(EImageColorSpace::SRGB), EImageColorSpace_enumToOIIOString(EImageColorSpace::LINEAR));
-            processImage(imgBuf, &RGBtoXYZ);
+            colorconvertOIIO(imgBuf, EImageColorSpace_enumToOIIOString(EImageColorSpace::SRGB), EImageColorSpace_enumToOIIOString(EImageColorSpace::LINEAR));
+            processPixels(imgBuf, [](auto& pixel) { RGBtoXYZImpl(pixel); });
         }
         else if (fromColorSpace == EImageColorSpace::LAB)
-            processImage(imgBuf, &LABtoXYZ);
+            processPixels(imgBuf, [](auto& pixel) { LABtoXYZImpl(pixel); });
     }
     else if (toColorSpace == EImageColorSpace::LAB)
     {
         if (fromColorSpace == EImageColorSpace::LINEAR)
-            processImage(imgBuf, &RGBtoLAB);
+            processPixels(imgBuf, [](auto& pixel) {
+                RGBtoXYZImpl(pixel);
+                XYZtoLABImpl(pixel);
+            });
         else if (fromColorSpace == EImageColorSpace::SRGB)
         {
-            oiio::ImageBufAlgo::colorconvert(
-              imgBuf, imgBuf, EImageColorSpace_enumToOIIOString(EImageColorSpace::SRGB), EImageColorSpace_enumToOIIOString(EImageColorSpace::LINEAR));
-            processImage(imgBuf, &RGBtoLAB);
+            colorconvertOIIO(imgBuf, EImageColorSpace_enumToOIIOString(EImageColorSpace::SRGB), EImageColorSpace_enumToOIIOString(EImageColorSpace::LINEAR));
+            processPixels(imgBuf, [](auto& pixel) {
+                RGBtoXYZImpl(pixel);
+                XYZtoLABImpl(pixel);
+            });
         }
         else if (fromColorSpace == EImageColorSpace::XYZ)
-            processImage(imgBuf, &XYZtoLAB);
+            processPixels(imgBuf, [](auto& pixel) { XYZtoLABImpl(pixel); });
     }
     ALICEVISION_LOG_TRACE("Convert image from " << EImageColorSpace_enumToString(fromColorSpace) << " to "
                                                 << EImageColorSpace_enumToString(toColorSpace));
@@ -614,6 +696,7 @@ void imageDiff(const image::Image<image::RGBfColor>& inImg,
 {
     outImg.resize(inImg.Width(), inImg.Height());
 
+#pragma omp parallel for
     for (int iy = 0; iy < inImg.Height(); iy++)
     {
         for (int ix = 0; ix < inImg.Width(); ix++)
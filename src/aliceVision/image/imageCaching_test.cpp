@@ -56,3 +56,33 @@ BOOST_AUTO_TEST_CASE(load_all_pixel_types)
     BOOST_CHECK_EQUAL(cache.info().nbImages, 6);
     BOOST_CHECK_EQUAL(cache.info().nbLoadFromDisk, 6);
 }
+
+BOOST_AUTO_TEST_CASE(load_color_spaces)
+{
+    ImageCache cache(256, 1024, EImageColorSpace::LINEAR);
+    const std::string filename = std::string(THIS_SOURCE_DIR) + "/image_test/lena.png";
+    auto imgLinear = cache.get<RGBfColor>(filename, 1, EImageColorSpace::LINEAR);
+    auto imgSRGB = cache.get<RGBfColor>(filename, 1, EImageColorSpace::SRGB);
+    BOOST_CHECK_NE(imgLinear, imgSRGB);
+    BOOST_CHECK_EQUAL(cache.get<RGBfColor>(filename), imgLinear);
+    BOOST_CHECK_EQUAL(cache.info().nbImages, 2);
+    BOOST_CHECK_EQUAL(cache.info().nbLoadFromDisk, 2);
+}
+
+BOOST_AUTO_TEST_CASE(prefetch_image)
+{
+    ImageCache cache(256, 1024, EImageColorSpace::LINEAR);
+    const std::string filename = std::string(THIS_SOURCE_DIR) + "/image_test/lena.png";
+    cache.prefetch<RGBfColor>(filename, 2, EImageColorSpace::LINEAR);
+    cache.prefetch<RGBfColor>(filename, 2, EImageColorSpace::LINEAR);
+    cache.waitPrefetch();
+    BOOST_CHECK_EQUAL(cache.info().nbImages, 1);
+    BOOST_CHECK_EQUAL(cache.info().nbLoadFromDisk, 1);
+    BOOST_CHECK(cache.get<RGBfColor>(filename, 2, EImageColorSpace::LINEAR, true) != nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(shared_cache)
+{
+    BOOST_CHECK_EQUAL(&ImageCache::getShared(), &ImageCache::getShared());
+    BOOST_CHECK_GE(ImageCache::getShared().info().maxSize, ImageCache::getShared().info().capacity);
+}
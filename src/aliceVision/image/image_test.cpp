@@ -65,6 +65,69 @@ BOOST_AUTO_TEST_CASE(Image_Basis)
     BOOST_CHECK_EQUAL(5, imaToResize.Width());
 }
 
+BOOST_AUTO_TEST_CASE(Image_View)
+{
+    // external buffer with padded rows
+    const int width = 20;
+    const int height = 15;
+    const int rowStride = 24;
+    std::vector<float> buffer(rowStride * height);
+    for (std::size_t i = 0; i < buffer.size(); ++i)
+        buffer[i] = static_cast<float>(rand() % 255);
+
+    ImageView<float> view(buffer.data(), width, height, rowStride);
+    BOOST_CHECK_EQUAL(width, view.Width());
+    BOOST_CHECK_EQUAL(height, view.Height());
+    BOOST_CHECK_EQUAL(rowStride, view.RowStride());
+    BOOST_CHECK(!view.IsContiguous());
+    BOOST_CHECK_EQUAL(buffer[3 * rowStride + 7], view(3, 7));
+
+    // writes go to the external buffer
+    view(4, 2) = -1.f;
+    BOOST_CHECK_EQUAL(-1.f, buffer[4 * rowStride + 2]);
+
+    const Image<float> image(view.GetMat());
+    const ImageView<const float> constView(view);
+    BOOST_CHECK(image.GetMat() == constView.GetMat());
+
+    const ImageView<const float> imageView(image);
+    BOOST_CHECK(imageView.IsContiguous());
+    BOOST_CHECK(imageView.data() == image.data());
+
+    const ImageView<float> subView = view.subView(2, 3, 10, 8);
+    BOOST_CHECK_EQUAL(10, subView.Width());
+    BOOST_CHECK_EQUAL(8, subView.Height());
+    BOOST_CHECK_EQUAL(view(5, 6), subView(3, 3));
+
+    // the image processing functions give the same results on the view and on the copied image
+    Image<float> outView, outImage;
+    ImageGaussianFilter(constView, 1.5, outView);
+    ImageGaussianFilter(image, 1.5, outImage);
+    BOOST_CHECK(outView.GetMat() == outImage.GetMat());
+
+    ImageGaussianFilter(view, 1.5, outView);
+    BOOST_CHECK(outView.GetMat() == outImage.GetMat());
+
+    ImageSobelXDerivative(constView, outView);
+    ImageSobelXDerivative(image, outImage);
+    BOOST_CHECK(outView.GetMat() == outImage.GetMat());
+
+    Image<RGBColor> rgbImage(width, height);
+    for (int i = 0; i < rgbImage.size(); ++i)
+        rgbImage(i) = RGBColor(rand() % 255, rand() % 255, rand() % 255);
+    Image<RGBColor> rgbOutView, rgbOutImage;
+    ImageGaussianFilter(ImageView<const RGBColor>(rgbImage), 1.0, rgbOutView);
+    ImageGaussianFilter(rgbImage, 1.0, rgbOutImage);
+    BOOST_CHECK(rgbOutView.GetMat() == rgbOutImage.GetMat());
+
+    ImageHalfSample(constView, outView);
+    ImageHalfSample(image, outImage);
+    BOOST_CHECK(outView.GetMat() == outImage.GetMat());
+
+    const Sampler2d<SamplerLinear> sampler;
+    BOOST_CHECK_EQUAL(sampler(image, 5.3f, 7.6f), sampler(constView, 5.3f, 7.6f));
+}
+
 BOOST_AUTO_TEST_CASE(Image_PixelTypes)
 {
     RGBColor a(BLACK);
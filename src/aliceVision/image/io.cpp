@@ -8,6 +8,7 @@
 #include <aliceVision/image/all.hpp>
 
 #include <aliceVision/system/Logger.hpp>
+#include <aliceVision/system/Storage.hpp>
 
 #include <OpenImageIO/imageio.h>
 #include <OpenImageIO/imagebuf.h>
@@ -448,6 +449,33 @@ oiio::ParamValueList readImageMetadata(const std::string& path, int& width, int&
     return spec.extra_attribs;
 }
 
+namespace {
+
+/// number of bytes of a remote image file copied to read its header
+const std::uint64_t imageHeaderSize = 1024 * 1024;
+
+/**
+ * @brief Open an image file to read its header.
+ * @note Only the beginning of a remote file is copied in the local cache if its format has the header at the beginning,
+ *       the whole file is copied otherwise or if the header is incomplete.
+ */
+std::unique_ptr<oiio::ImageInput> openImageHeader(const std::string& path, const oiio::ImageSpec* configSpec = nullptr)
+{
+    if (!system::isRemotePath(path))
+        return oiio::ImageInput::open(path, configSpec);
+
+    const std::string extension = boost::to_lower_copy(fs::extension(path));
+    if (extension == ".jpg" || extension == ".jpeg" || extension == ".png" || extension == ".exr")
+    {
+        std::unique_ptr<oiio::ImageInput> in = oiio::ImageInput::open(system::getStorageLocalHeaderPath(path, imageHeaderSize), configSpec);
+        if (in)
+            return in;
+    }
+    return oiio::ImageInput::open(system::getStorageLocalPath(path), configSpec);
+}
+
+}  // namespace
+
 oiio::ImageSpec readImageSpec(const std::string& path)
 {
   oiio::ImageSpec configSpec;
@@ -457,7 +485,7 @@ oiio::ImageSpec readImageSpec(const std::string& path)
     configSpec.attribute("raw:user_flip", 0); // disable auto rotation of the image buffer but keep exif metadata orientation valid  
 #endif 
 
-  std::unique_ptr<oiio::ImageInput> in(oiio::ImageInput::open(path, &configSpec));
+  std::unique_ptr<oiio::ImageInput> in(openImageHeader(path, &configSpec));
 
   if(!in)
     throw std::runtime_error("Can't find/open image file '" + path + "'.");
@@ -500,7 +528,7 @@ void getBufferFromImage(Image<RGBColor>& image, oiio::ImageBuf& buffer) { getBuf
 
 bool isRawFormat(const std::string& path)
 {
-    std::unique_ptr<oiio::ImageInput> in(oiio::ImageInput::open(path));
+    std::unique_ptr<oiio::ImageInput> in(openImageHeader(path));
     if(!in)
     {
         ALICEVISION_THROW_ERROR("The input image file '" << path << "' cannot be opened or does not exist.");
@@ -510,6 +538,41 @@ bool isRawFormat(const std::string& path)
     return (imgFormat.compare("raw") == 0);
 }
 
+/**
+ * @brief Get the finest mip level of an image file that can be used for a given downscale
+ * @param[in] path The input image file path
+ * @param[in] downscale The requested downscale factor
+ * @param[out] miplevel The selected mip level (0 if the file has no mip levels)
+ * @return the downscale factor of the selected mip level
+ */
+int getMipLevelForDownscale(const std::string& path, int downscale, int& miplevel)
+{
+    miplevel = 0;
+
+    std::unique_ptr<oiio::ImageInput> in(oiio::ImageInput::open(path));
+    if (!in)
+        return 1;
+
+    const oiio::ImageSpec fullSpec = in->spec();
+    int levelDownscale = 1;
+    oiio::ImageSpec levelSpec;
+
+    // each mip level halves the previous one
+    while ((downscale % (levelDownscale * 2) == 0) && in->seek_subimage(0, miplevel + 1, levelSpec))
+    {
+        if (levelSpec.width != std::max(1, fullSpec.width / (levelDownscale * 2)) ||
+            levelSpec.height != std::max(1, fullSpec.height / (levelDownscale * 2)))
+            break;
+
+        ++miplevel;
+        levelDownscale *= 2;
+    }
+
+    in->close();
+
+    return levelDownscale;
+}
+
 template<typename T>
 void readImage(const std::string& path, oiio::TypeDesc format, int nchannels, Image<T>& image, const ImageReadOptions& imageReadOptions)
 {
@@ -521,6 +584,13 @@ void readImage(const std::string& path, oiio::TypeDesc format, int nchannels, Im
     if (nchannels == 2)
         ALICEVISION_THROW_ERROR("Load of 2 channels is not supported. Image file: '" + path + "'.");
 
+    // a remote image is read from its copy in the local cache
+    if (system::isRemotePath(path))
+    {
+        readImage(system::getStorageLocalPath(path), format, nchannels, image, imageReadOptions);
+        return;
+    }
+
     if(!fs::exists(path))
         ALICEVISION_THROW_ERROR("No such image file: '" << path << "'.");
 
@@ -678,9 +748,55 @@ void readImage(const std::string& path, oiio::TypeDesc format, int nchannels, Im
         }
     }
 
-    oiio::ImageBuf inBuf(path, 0, 0, NULL, &configSpec);
+    // use the decoder reduced resolution when it matches the requested downscale
+    const int downscale = std::max(1, imageReadOptions.downscale);
+    int nativeDownscale = 1;
+    int miplevel = 0;
+
+    if (downscale > 1)
+    {
+        if (isRawImage)
+        {
+            if (downscale % 2 == 0)
+            {
+                configSpec.attribute("raw:half_size", 1); // libRaw half size decoding (no demosaicing interpolation)
+                nativeDownscale = 2;
+            }
+        }
+        else
+        {
+            nativeDownscale = getMipLevelForDownscale(path, downscale, miplevel);
+        }
+    }
+
+    // region of interest at the decoded resolution
+    oiio::ROI nativeROI = imageReadOptions.subROI;
+    if (nativeROI.defined())
+    {
+        nativeROI.xbegin = imageReadOptions.subROI.xbegin / nativeDownscale;
+        nativeROI.xend = nativeROI.xbegin + imageReadOptions.subROI.width() / nativeDownscale;
+        nativeROI.ybegin = imageReadOptions.subROI.ybegin / nativeDownscale;
+        nativeROI.yend = nativeROI.ybegin + imageReadOptions.subROI.height() / nativeDownscale;
+        nativeROI.zbegin = 0;
+        nativeROI.zend = 1;
+        nativeROI.chbegin = 0;
+        nativeROI.chend = 10000;
+    }
 
-    inBuf.read(0, 0, true, oiio::TypeDesc::FLOAT); // force image convertion to float (for grayscale and color space convertion)
+    oiio::ImageBuf inBuf;
+
+    if (nativeROI.defined() && !isRawImage)
+    {
+        // only the tiles or scanlines covering the region of interest are decoded
+        const oiio::ImageBuf fileBuf(path, 0, miplevel, NULL, &configSpec);
+        const oiio::ImageBuf roiBuf = oiio::ImageBufAlgo::cut(fileBuf, nativeROI);
+        inBuf.copy(roiBuf, oiio::TypeDesc::FLOAT); // force image convertion to float (for grayscale and color space convertion)
+    }
+    else
+    {
+        inBuf.reset(path, 0, miplevel, NULL, &configSpec);
+        inBuf.read(0, miplevel, true, oiio::TypeDesc::FLOAT); // force image convertion to float (for grayscale and color space convertion)
+    }
 
     if(!inBuf.initialized())
         ALICEVISION_THROW_ERROR("Failed to open the image file: '" << path << "'.");
@@ -706,12 +822,19 @@ void readImage(const std::string& path, oiio::TypeDesc format, int nchannels, Im
 
             orientation += (orientation == 2 || orientation == 4) ? -1 : 1;
         }
+
+        // raw images are decoded entirely, crop after the mirroring to keep the region in the image orientation
+        if (nativeROI.defined())
+        {
+            oiio::ImageBuf roiBuf = oiio::ImageBufAlgo::cut(inBuf, nativeROI);
+            inBuf.swap(roiBuf);
+        }
     }
 
     // Apply DCP profile
     if (!imageReadOptions.colorProfileFileName.empty() && imageReadOptions.rawColorInterpretation == ERawColorInterpretation::DcpLinearProcessing)
     {
-        image::DCPProfile dcpProfile(imageReadOptions.colorProfileFileName);
+        const std::shared_ptr<const image::DCPProfile> dcpProfile = image::getCachedDCPProfile(imageReadOptions.colorProfileFileName);
 
         //oiio::ParamValueList imgMetadata = readImageMetadata(path);
         std::string cam_mul = "";
@@ -742,7 +865,7 @@ void readImage(const std::string& path, oiio::TypeDesc format, int nchannels, Im
 
         double cct = imageReadOptions.correlatedColorTemperature;
 
-        dcpProfile.applyLinear(inBuf, neutral, cct, imageReadOptions.doWBAfterDemosaicing, imageReadOptions.useDCPColorMatrixOnly);
+        dcpProfile->applyLinear(inBuf, neutral, cct, imageReadOptions.doWBAfterDemosaicing, imageReadOptions.useDCPColorMatrixOnly);
     }
 
     // color conversion
@@ -823,24 +946,35 @@ void readImage(const std::string& path, oiio::TypeDesc format, int nchannels, Im
         {
             throw std::runtime_error("ALICEVISION_ROOT is not defined, OCIO config file cannot be accessed.");
         }
-        oiio::ImageBuf colorspaceBuf;
-        oiio::ColorConfig colorConfig(colorConfigPath);
-        oiio::ImageBufAlgo::colorconvert(colorspaceBuf,
-                                         inBuf,
-                                         fromColorSpaceName,
-                                         EImageColorSpace_enumToOIIOString(imageReadOptions.workingColorSpace),
-                                         true,
-                                         "",
-                                         "",
-                                         &colorConfig);
-                                         inBuf = colorspaceBuf;
+        // shared processor, converted in place on the decoded float pixels
+        const oiio::ColorProcessorHandle processor =
+          getColorProcessor(fromColorSpaceName, EImageColorSpace_enumToOIIOString(imageReadOptions.workingColorSpace), colorConfigPath);
+        if (!processor || !oiio::ImageBufAlgo::colorconvert(inBuf, inBuf, processor.get(), true))
+        {
+            throw std::runtime_error("Cannot convert image '" + path + "' from " + fromColorSpaceName + " to " +
+                                     EImageColorSpace_enumToOIIOString(imageReadOptions.workingColorSpace) + ".");
+        }
     }
     else
     {
-        oiio::ImageBuf colorspaceBuf;
-        oiio::ImageBufAlgo::colorconvert(
-          colorspaceBuf, inBuf, fromColorSpaceName, EImageColorSpace_enumToOIIOString(imageReadOptions.workingColorSpace));
-        inBuf = colorspaceBuf;
+        const oiio::ColorProcessorHandle processor =
+          getColorProcessor(fromColorSpaceName, EImageColorSpace_enumToOIIOString(imageReadOptions.workingColorSpace));
+        if (!processor || !oiio::ImageBufAlgo::colorconvert(inBuf, inBuf, processor.get(), true))
+        {
+            throw std::runtime_error("Cannot convert image '" + path + "' from " + fromColorSpaceName + " to " +
+                                     EImageColorSpace_enumToOIIOString(imageReadOptions.workingColorSpace) + ".");
+        }
+    }
+
+    // apply the part of the downscale not done by the decoder
+    if (downscale > nativeDownscale)
+    {
+        const int remainingDownscale = downscale / nativeDownscale;
+        const oiio::ImageSpec resizedSpec(
+          inBuf.spec().width / remainingDownscale, inBuf.spec().height / remainingDownscale, inBuf.spec().nchannels, oiio::TypeDesc::FLOAT);
+        oiio::ImageBuf resizedBuf(resizedSpec);
+        oiio::ImageBufAlgo::resize(resizedBuf, inBuf, "", 0, oiio::ROI::All());
+        inBuf.swap(resizedBuf);
     }
 
     // convert to grayscale if needed
@@ -903,7 +1037,7 @@ void readImageNoFloat(const std::string& path, oiio::TypeDesc format, Image<T>&
 {
   oiio::ImageSpec configSpec;
 
-  oiio::ImageBuf inBuf(path, 0, 0, NULL, &configSpec);
+  oiio::ImageBuf inBuf(system::getStorageLocalPath(path), 0, 0, NULL, &configSpec);
 
   inBuf.read(0, 0, true, format);
 
@@ -1053,21 +1187,16 @@ void writeImage(const std::string& path,
         {
             throw std::runtime_error("ALICEVISION_ROOT is not defined, OCIO config file cannot be accessed.");
         }
-        oiio::ColorConfig colorConfig(colorConfigPath);
-        oiio::ImageBufAlgo::colorconvert(colorspaceBuf,
-                                         *outBuf,
-                                         EImageColorSpace_enumToOIIOString(fromColorSpace),
-                                         EImageColorSpace_enumToOIIOString(toColorSpace),
-                                         true,
-                                         "",
-                                         "",
-                                         &colorConfig);
+        const oiio::ColorProcessorHandle processor =
+          getColorProcessor(EImageColorSpace_enumToOIIOString(fromColorSpace), EImageColorSpace_enumToOIIOString(toColorSpace), colorConfigPath);
+        oiio::ImageBufAlgo::colorconvert(colorspaceBuf, *outBuf, processor.get(), true);
         outBuf = &colorspaceBuf;
     }
     else
     {
-        oiio::ImageBufAlgo::colorconvert(
-          colorspaceBuf, *outBuf, EImageColorSpace_enumToOIIOString(fromColorSpace), EImageColorSpace_enumToOIIOString(toColorSpace));
+        const oiio::ColorProcessorHandle processor =
+          getColorProcessor(EImageColorSpace_enumToOIIOString(fromColorSpace), EImageColorSpace_enumToOIIOString(toColorSpace));
+        oiio::ImageBufAlgo::colorconvert(colorspaceBuf, *outBuf, processor.get(), true);
         outBuf = &colorspaceBuf;
     }
 
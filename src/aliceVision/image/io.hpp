@@ -8,6 +8,7 @@
 #pragma once
 
 #include "Image.hpp"
+#include "ImageView.hpp"
 #include "pixelTypes.hpp"
 #include "colorspace.hpp"
 
@@ -17,6 +18,7 @@
 #include <OpenImageIO/imagebuf.h>
 #include <OpenImageIO/color.h>
 
+#include <stdexcept>
 #include <string>
 
 namespace aliceVision {
@@ -219,7 +221,8 @@ struct ImageReadOptions
                      ERawColorInterpretation rawColorInterpretation = ERawColorInterpretation::LibRawWhiteBalancing,
                      const std::string& colorProfile = "",
                      const bool useDCPColorMatrixOnly = true,
-                     const oiio::ROI& roi = oiio::ROI())
+                     const oiio::ROI& roi = oiio::ROI(),
+                     int downscale = 1)
       : workingColorSpace(workingColorSpace),
         inputColorSpace(inputColorSpace),
         rawColorInterpretation(rawColorInterpretation),
@@ -231,7 +234,8 @@ struct ImageReadOptions
         rawAutoBright(false),
         rawExposureAdjustment(1.0),
         correlatedColorTemperature(-1.0),
-        subROI(roi)
+        subROI(roi),
+        downscale(downscale)
     {}
 
     EImageColorSpace workingColorSpace;
@@ -245,9 +249,13 @@ struct ImageReadOptions
     bool rawAutoBright;
     float rawExposureAdjustment;
     double correlatedColorTemperature;
-    // ROI for this image.
+    // ROI for this image, in full resolution pixels.
     // If the image contains an roi, this is the roi INSIDE the roi.
+    // Only the tiles or scanlines covering it are decoded when the format allows it.
     oiio::ROI subROI;
+    // Downscale factor of the output image (width / downscale, height / downscale).
+    // The decoder reduced resolution paths (mip levels, raw half size) are used when they match the factor.
+    int downscale;
 };
 
 /**
@@ -526,6 +534,46 @@ struct ColorTypeInfo<RGBAfColor>
     static const oiio::TypeDesc::BASETYPE typeDesc = oiio::TypeDesc::FLOAT;
 };
 
+/**
+ * @brief get OIIO buffer wrapping the pixels of an image view, without copy
+ * @param[in] image Image view, its rows must not be padded
+ * @param[out] buffer OIIO buffer, valid as long as the viewed pixels
+ */
+template<typename T>
+void getBufferFromImage(const ImageView<T>& image, oiio::ImageBuf& buffer)
+{
+    typedef typename ImageView<T>::Tpixel pix_t;
+
+    if (!image.IsContiguous())
+    {
+        throw std::invalid_argument("Cannot wrap an image view with padded rows in an OIIO buffer.");
+    }
+
+    const oiio::ImageSpec imageSpec(image.Width(), image.Height(), ColorTypeInfo<pix_t>::size, ColorTypeInfo<pix_t>::typeDesc);
+    oiio::ImageBuf imageBuf(imageSpec, const_cast<pix_t*>(image.data()));
+    buffer.swap(imageBuf);
+}
+
+/**
+ * @brief get a view over the pixels of an in-memory OIIO buffer, without copy
+ * @param[in] buffer OIIO buffer holding local pixels of type T
+ * @return the view over the buffer pixels, valid as long as the buffer
+ */
+template<typename T>
+ImageView<T> getImageViewFromBuffer(oiio::ImageBuf& buffer)
+{
+    typedef typename ImageView<T>::Tpixel pix_t;
+    const oiio::ImageSpec& spec = buffer.spec();
+
+    if (buffer.localpixels() == nullptr || spec.format != oiio::TypeDesc(ColorTypeInfo<pix_t>::typeDesc) || spec.nchannels != ColorTypeInfo<pix_t>::size ||
+        buffer.pixel_stride() != static_cast<oiio::stride_t>(sizeof(pix_t)) || buffer.scanline_stride() % static_cast<oiio::stride_t>(sizeof(pix_t)) != 0)
+    {
+        throw std::invalid_argument("Cannot get an image view from an OIIO buffer without local pixels of the requested type.");
+    }
+
+    return ImageView<T>(static_cast<T*>(buffer.localpixels()), spec.width, spec.height, static_cast<int>(buffer.scanline_stride() / static_cast<oiio::stride_t>(sizeof(pix_t))));
+}
+
 bool isRawFormat(const std::string& path);
 
 bool tryLoadMask(Image<unsigned char>* mask,
@@ -270,3 +270,65 @@ BOOST_AUTO_TEST_CASE(read_write_from_grayscale_to_rgb)
         remove(filename.c_str());
     }
 }
+
+BOOST_AUTO_TEST_CASE(read_downscale_roi)
+{
+    Image<float> image(64, 48);
+    for (int y = 0; y < image.Height(); ++y)
+        for (int x = 0; x < image.Width(); ++x)
+            image(y, x) = static_cast<float>(x + y * image.Width()) / static_cast<float>(image.size());
+
+    for (const auto& extension : {"png", "tiff", "exr"})
+    {
+        const std::string filename = std::string("test_downscale.") + extension;
+        BOOST_CHECK_NO_THROW(writeImage(filename, image, image::ImageWriteOptions().toColorSpace(image::EImageColorSpace::NO_CONVERSION)));
+
+        // downscale
+        image::ImageReadOptions downscaleOptions(image::EImageColorSpace::NO_CONVERSION);
+        downscaleOptions.downscale = 4;
+
+        Image<float> downscaled;
+        BOOST_CHECK_NO_THROW(readImage(filename, downscaled, downscaleOptions));
+        BOOST_CHECK_EQUAL(downscaled.Width(), image.Width() / 4);
+        BOOST_CHECK_EQUAL(downscaled.Height(), image.Height() / 4);
+
+        // region of interest
+        image::ImageReadOptions roiOptions(image::EImageColorSpace::NO_CONVERSION);
+        roiOptions.subROI = oiio::ROI(8, 40, 4, 20);
+
+        Image<float> roi;
+        BOOST_CHECK_NO_THROW(readImage(filename, roi, roiOptions));
+        BOOST_CHECK_EQUAL(roi.Width(), 32);
+        BOOST_CHECK_EQUAL(roi.Height(), 16);
+        BOOST_CHECK_CLOSE(roi(0, 0), image(4, 8), 1.0);
+        BOOST_CHECK_CLOSE(roi(15, 31), image(19, 39), 1.0);
+
+        remove(filename.c_str());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(read_write_colorconvert_roundtrip)
+{
+    Image<RGBAfColor> image(16, 8);
+    for (int y = 0; y < image.Height(); ++y)
+        for (int x = 0; x < image.Width(); ++x)
+            image(y, x) = RGBAfColor(x / 16.f, y / 8.f, (x + y) / 24.f, 0.5f);
+
+    for (const auto colorSpace : {EImageColorSpace::XYZ, EImageColorSpace::LAB})
+    {
+        Image<RGBAfColor> converted(image);
+        colorconvert(converted, EImageColorSpace::LINEAR, colorSpace);
+        colorconvert(converted, colorSpace, EImageColorSpace::LINEAR);
+
+        for (int y = 0; y < image.Height(); ++y)
+        {
+            for (int x = 0; x < image.Width(); ++x)
+            {
+                for (int c = 0; c < 3; ++c)
+                    BOOST_CHECK_SMALL(converted(y, x)[c] - image(y, x)[c], 1e-3f);
+                // alpha is left untouched
+                BOOST_CHECK_EQUAL(converted(y, x).a(), image(y, x).a());
+            }
+        }
+    }
+}
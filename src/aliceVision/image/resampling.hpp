@@ -27,8 +27,8 @@ namespace image {
  * @param[out] out image to store the downscaled result
  * @param[in] downscale downscale value
  */
-template<typename SamplerType, typename Image>
-void downscaleImage(const Image& src, Image& out, int downscale)
+template<typename SamplerType, typename ImageTypeIn, typename ImageTypeOut>
+void downscaleImage(const ImageTypeIn& src, ImageTypeOut& out, int downscale)
 {
     const int new_width = src.Width() / downscale;
     const int new_height = src.Height() / downscale;
@@ -52,10 +52,23 @@ void downscaleImage(const Image& src, Image& out, int downscale)
  ** @param[in] src input image
  ** @param[out] out output image
  **/
-template<typename Image>
-void ImageHalfSample(const Image& src, Image& out)
+template<typename ImageTypeIn, typename ImageTypeOut>
+void ImageHalfSample(const ImageTypeIn& src, ImageTypeOut& out)
 {
-    downscaleImage<SamplerLinear, Image>(src, out, 2);
+    const int new_width = src.Width() / 2;
+    const int new_height = src.Height() / 2;
+
+    out.resize(new_width, new_height);
+
+    // the bilinear samples at the output pixels centers fall exactly on the odd input pixels,
+    // same result as downscaleImage<SamplerLinear> without the interpolation cost
+    for (int i = 0; i < new_height; ++i)
+    {
+        for (int j = 0; j < new_width; ++j)
+        {
+            out(i, j) = src(2 * i + 1, 2 * j + 1);
+        }
+    }
 }
 
 /**
@@ -68,13 +81,13 @@ void ImageHalfSample(const Image& src, Image& out)
  ** @param[out] Output image
  ** @note sampling_pos.size() must be equal to output_width * output_height
  **/
-template<typename Image, typename RessamplingFunctor>
-void GenericRessample(const Image& src,
+template<typename ImageTypeIn, typename RessamplingFunctor, typename ImageTypeOut>
+void GenericRessample(const ImageTypeIn& src,
                       const std::vector<std::pair<float, float>>& sampling_pos,
                       const int output_width,
                       const int output_height,
                       const RessamplingFunctor& sampling_func,
-                      Image& out)
+                      ImageTypeOut& out)
 {
     assert(sampling_pos.size() == output_width * output_height);
 
@@ -119,3 +119,19 @@ BOOST_AUTO_TEST_CASE(Ressampling_SampleRotate)
     BOOST_CHECK_NO_THROW(ImageRotation(image, Sampler2d<SamplerSpline16>(), "SamplerSpline16"));
     BOOST_CHECK_NO_THROW(ImageRotation(image, Sampler2d<SamplerSpline64>(), "SamplerSpline64"));
 }
+
+BOOST_AUTO_TEST_CASE(Ressampling_HalfSample)
+{
+    Image<float> image(41, 30);
+    for (int i = 0; i < image.size(); ++i)
+        image.data()[i] = static_cast<float>(std::rand() % 255);
+
+    // same result as the bilinear downscale
+    Image<float> halfSampled, downscaled;
+    ImageHalfSample(image, halfSampled);
+    downscaleImage<SamplerLinear>(image, downscaled, 2);
+
+    BOOST_CHECK_EQUAL(halfSampled.Width(), 20);
+    BOOST_CHECK_EQUAL(halfSampled.Height(), 15);
+    BOOST_CHECK(halfSampled.GetMat() == downscaled.GetMat());
+}
@@ -26,8 +26,8 @@ bool ApplyH_AndCheckOrientation(const Mat3& H, double& x, double& y)
 
 /// Warp an image im given a homography H with a backward approach
 /// H must be already have been resized accordingly
-template<class Image>
-void Warp(const Image& im, const Mat3& H, Image& out)
+template<class ImageTypeIn, class ImageTypeOut>
+void Warp(const ImageTypeIn& im, const Mat3& H, ImageTypeOut& out)
 {
     const int wOut = static_cast<int>(out.Width());
     const int hOut = static_cast<int>(out.Height());
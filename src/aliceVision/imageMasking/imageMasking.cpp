@@ -5,7 +5,6 @@
 // You can obtain one at https://mozilla.org/MPL/2.0/.
 
 #include "imageMasking.hpp"
-#include "eigen2cvHelpers.hpp"
 
 #include <aliceVision/image/Image.hpp>
 #include <aliceVision/image/io.hpp>
@@ -13,7 +12,6 @@
 
 #include <opencv2/opencv.hpp>
 #include <opencv2/core/core.hpp>
-#include <opencv2/core/eigen.hpp>
 #include <opencv2/imgproc.hpp>
 
 namespace aliceVision {
@@ -26,19 +24,13 @@ uint8_t remap_float2uint8(float value) { return uint8_t(clamp(value) * 255.f + 0
 
 cv::Mat wrapCvMask(OutImage& result) { return cv::Mat(result.rows(), result.cols(), CV_8UC1, result.data(), result.rowStride()); }
 
-void rotateHue(cv::Mat& hsv, uint8_t delta)
+cv::Mat wrapCvImage(image::Image<image::RGBColor>& input)
 {
-    // cannot use cv::add because it saturates the output.
-    // do not use forEach because this call is already parallelized.
-    for (int r = 0; r < hsv.rows; r++)
-    {
-        for (int c = 0; c < hsv.cols; c++)
-        {
-            auto& pixel = hsv.at<cv::Point3_<uint8_t>>(r, c);
-            pixel.x += delta;
-        }
-    }
+    return cv::Mat(input.rows(), input.cols(), CV_8UC3, input.data(), input.rowStride() * sizeof(image::RGBColor));
 }
+
+/// number of rows converted to HSV at once, small enough for the HSV strip to stay in cache
+constexpr int hsvStripHeight = 16;
 }  // namespace
 
 void hsv(OutImage& result,
@@ -58,21 +50,45 @@ void hsv(OutImage& result,
     image::Image<image::RGBColor> input;
     image::readImage(inputPath, input, image::EImageColorSpace::SRGB);
 
-    cv::Mat input_hsv;
-    cv::eigen2cv(input.GetMat(), input_hsv);                     // copy the buffer, but a copy is needed to convert to HSV colorspace anyway.
-    cv::cvtColor(input_hsv, input_hsv, cv::COLOR_RGB2HSV_FULL);  // "_FULL" to encode hue in the [0, 255] range.
-    rotateHue(input_hsv, uint8_t((0.5f - hue) * 256.f));         // hue == 0 <=> hue == 1
+    const cv::Mat input_cv = wrapCvImage(input);  // no copy, the HSV conversion is done per strip of rows
 
     result.resize(input.Width(), input.Height(), false);  // allocate un-initialized
     const cv::Mat result_cv = wrapCvMask(result);
 
+    const uint8_t hueDelta = uint8_t((0.5f - hue) * 256.f);  // hue == 0 <=> hue == 1
     const uint8_t lowH = remap_float2uint8(0.5f - hueRange);
     const uint8_t highH = remap_float2uint8(0.5f + hueRange);
     const uint8_t lowS = remap_float2uint8(minSaturation);
     const uint8_t highS = remap_float2uint8(maxSaturation);
     const uint8_t lowV = remap_float2uint8(minValue);
     const uint8_t highV = remap_float2uint8(maxValue);
-    cv::inRange(input_hsv, cv::Scalar(lowH, lowS, lowV), cv::Scalar(highH, highS, highV), result_cv);
+
+    // HSV conversion, hue rotation and thresholds fused per strip of rows
+    const int nbStrips = (input_cv.rows + hsvStripHeight - 1) / hsvStripHeight;
+    cv::parallel_for_(cv::Range(0, nbStrips), [&](const cv::Range& range) {
+        cv::Mat hsvStrip;
+        for (int strip = range.start; strip < range.end; ++strip)
+        {
+            const int firstRow = strip * hsvStripHeight;
+            const int lastRow = std::min(firstRow + hsvStripHeight, input_cv.rows);
+            cv::cvtColor(input_cv.rowRange(firstRow, lastRow), hsvStrip, cv::COLOR_RGB2HSV_FULL);  // "_FULL" to encode hue in the [0, 255] range.
+
+            for (int r = 0; r < hsvStrip.rows; ++r)
+            {
+                const cv::Vec3b* hsvRow = hsvStrip.ptr<cv::Vec3b>(r);
+                uint8_t* resultRow = result_cv.ptr<uint8_t>(firstRow + r);
+                for (int c = 0; c < hsvStrip.cols; ++c)
+                {
+                    // the hue rotation wraps around with the uint8 overflow
+                    const uint8_t h = hsvRow[c][0] + hueDelta;
+                    const uint8_t s = hsvRow[c][1];
+                    const uint8_t v = hsvRow[c][2];
+                    const bool inRange = h >= lowH && h <= highH && s >= lowS && s <= highS && v >= lowV && v <= highV;
+                    resultRow[c] = inRange ? 255 : 0;
+                }
+            }
+        }
+    });
 };
 
 void autoGrayscaleThreshold(OutImage& result, const std::string& inputPath)
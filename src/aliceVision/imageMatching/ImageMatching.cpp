@@ -6,10 +6,45 @@
 
 #include "ImageMatching.hpp"
 #include <aliceVision/voctree/databaseIO.hpp>
+#include <aliceVision/system/Logger.hpp>
+
+#include "nanoflann.hpp"
+
+#include <algorithm>
+#include <cmath>
 
 namespace aliceVision {
 namespace imageMatching {
 
+namespace {
+
+/**
+ * @brief nanoflann adaptor over the camera positions
+ */
+struct PositionsAdaptator
+{
+    using Derived = PositionsAdaptator;
+    using T = double;
+
+    const std::vector<Vec3>& _data;
+    PositionsAdaptator(const std::vector<Vec3>& data)
+      : _data(data)
+    {}
+
+    inline const Derived& derived() const { return *this; }
+    inline size_t kdtree_get_point_count() const { return _data.size(); }
+    inline T kdtree_get_pt(const size_t idx, int dim) const { return _data[idx](dim); }
+    template<class BBOX>
+    bool kdtree_get_bbox(BBOX& bb) const
+    {
+        return false;
+    }
+};
+
+using PositionsKdTree = nanoflann::KDTreeSingleIndexAdaptor<nanoflann::L2_Simple_Adaptor<double, PositionsAdaptator>, PositionsAdaptator, 3>;
+
+}  // namespace
+
 std::ostream& operator<<(std::ostream& os, const PairList& pl)
 {
     for (PairList::const_iterator plIter = pl.begin(); plIter != pl.end(); ++plIter)
@@ -40,6 +75,10 @@ std::string EImageMatchingMethod_enumToString(EImageMatchingMethod m)
             return "Frustum";
         case EImageMatchingMethod::FRUSTUM_OR_VOCABULARYTREE:
             return "FrustumOrVocabularyTree";
+        case EImageMatchingMethod::SPATIAL:
+            return "Spatial";
+        case EImageMatchingMethod::SPATIAL_VOCABULARYTREE:
+            return "SpatialVocabularyTree";
     }
     throw std::out_of_range("Invalid EImageMatchingMethod enum: " + std::to_string(int(m)));
 }
@@ -61,6 +100,10 @@ EImageMatchingMethod EImageMatchingMethod_stringToEnum(const std::string& m)
         return EImageMatchingMethod::FRUSTUM;
     if (mode == "frustumorvocabularytree")
         return EImageMatchingMethod::FRUSTUM_OR_VOCABULARYTREE;
+    if (mode == "spatial")
+        return EImageMatchingMethod::SPATIAL;
+    if (mode == "spatialvocabularytree")
+        return EImageMatchingMethod::SPATIAL_VOCABULARYTREE;
 
     throw std::out_of_range("Invalid EImageMatchingMethod: " + m);
 }
@@ -231,13 +274,135 @@ void generateAllMatchesBetweenTwoMap(const std::set<IndexT>& viewIdsA, const std
     }
 }
 
+bool generateSpatialMatches(const sfmData::SfMData& sfmData, const SpatialMatchingParams& params, OrderedPairList& outPairList)
+{
+    // use the poses if some views are reconstructed, the GPS positions are not in the same coordinate system
+    const bool usePoses = !sfmData.getValidViews().empty();
+
+    std::vector<IndexT> viewIds;
+    std::vector<Vec3> positions;
+    std::vector<Vec3> directions;
+    std::vector<IndexT> unlocatedViewIds;
+
+    for (const auto& viewPair : sfmData.getViews())
+    {
+        const sfmData::View& view = *viewPair.second;
+
+        if (usePoses && sfmData.isPoseAndIntrinsicDefined(&view))
+        {
+            const geometry::Pose3 pose = sfmData.getPose(view).getTransform();
+            viewIds.push_back(viewPair.first);
+            positions.push_back(pose.center());
+            directions.push_back(pose.rotation().transpose() * Vec3(0.0, 0.0, 1.0));
+        }
+        else if (!usePoses && view.getImage().hasGpsMetadata())
+        {
+            viewIds.push_back(viewPair.first);
+            positions.push_back(view.getImage().getGpsPositionFromMetadata());
+        }
+        else
+        {
+            unlocatedViewIds.push_back(viewPair.first);
+        }
+    }
+
+    if (positions.empty())
+    {
+        ALICEVISION_LOG_ERROR("No view with a known pose or GPS position.");
+        return false;
+    }
+
+    ALICEVISION_LOG_INFO("Spatial matching of " << positions.size() << " views using the " << (usePoses ? "poses." : "GPS positions."));
+
+    static const std::size_t MAX_LEAF_ELEMENTS = 10;
+    const PositionsAdaptator adaptator(positions);
+    PositionsKdTree kdTree(3, adaptator, nanoflann::KDTreeSingleIndexAdaptorParams(MAX_LEAF_ELEMENTS));
+    kdTree.buildIndex();
+
+    // the view itself is returned by the search
+    const std::size_t nbNeighbors = std::min((params.nbNeighbors == 0 ? positions.size() : params.nbNeighbors + 1), positions.size());
+    const double maxSquaredDistance = params.maxDistance * params.maxDistance;
+    const double minCosAngle = std::cos(degreeToRadian(params.maxAngle));
+
+    std::vector<std::vector<IndexT>> neighborsPerView(positions.size());
+
+#pragma omp parallel for schedule(dynamic)
+    for (int i = 0; i < static_cast<int>(positions.size()); ++i)
+    {
+        std::vector<std::size_t> indices(nbNeighbors);
+        std::vector<double> squaredDistances(nbNeighbors);
+        nanoflann::KNNResultSet<double, std::size_t> resultSet(nbNeighbors);
+        resultSet.init(indices.data(), squaredDistances.data());
+        kdTree.findNeighbors(resultSet, positions[i].data(), nanoflann::SearchParameters());
+        const std::size_t nbFound = resultSet.size();
+
+        for (std::size_t n = 0; n < nbFound; ++n)
+        {
+            const std::size_t j = indices[n];
+            if (j == static_cast<std::size_t>(i))
+                continue;
+            if (maxSquaredDistance > 0.0 && squaredDistances[n] > maxSquaredDistance)
+                continue;
+            if (usePoses && directions[i].dot(directions[j]) < minCosAngle)
+                continue;
+            neighborsPerView[i].push_back(viewIds[j]);
+        }
+    }
+
+    for (std::size_t i = 0; i < viewIds.size(); ++i)
+    {
+        for (const IndexT neighborId : neighborsPerView[i])
+            outPairList[std::min(viewIds[i], neighborId)].insert(std::max(viewIds[i], neighborId));
+    }
+
+    if (!unlocatedViewIds.empty())
+    {
+        ALICEVISION_LOG_WARNING(unlocatedViewIds.size() << " views without position are paired with all the other views.");
+        for (const IndexT viewId : unlocatedViewIds)
+        {
+            for (const auto& viewPair : sfmData.getViews())
+            {
+                if (viewPair.first != viewId)
+                    outPairList[std::min(viewId, viewPair.first)].insert(std::max(viewId, viewPair.first));
+            }
+        }
+    }
+    return true;
+}
+
+void intersectPairLists(OrderedPairList& pairList, const OrderedPairList& filterPairList)
+{
+    const auto hasPair = [&filterPairList](ImageID a, ImageID b) {
+        const auto it = filterPairList.find(a);
+        return it != filterPairList.end() && it->second.count(b) > 0;
+    };
+
+    for (auto it = pairList.begin(); it != pairList.end();)
+    {
+        OrderedListOfImageID& matches = it->second;
+        for (auto matchIt = matches.begin(); matchIt != matches.end();)
+        {
+            if (hasPair(it->first, *matchIt) || hasPair(*matchIt, it->first))
+                ++matchIt;
+            else
+                matchIt = matches.erase(matchIt);
+        }
+
+        if (matches.empty())
+            it = pairList.erase(it);
+        else
+            ++it;
+    }
+}
+
 void generateFromVoctree(PairList& allMatches,
                          const std::map<IndexT, std::string>& descriptorsFiles,
                          const aliceVision::voctree::Database& db,
                          const aliceVision::voctree::VocabularyTree<DescriptorFloat>& tree,
                          EImageMatchingMode modeMultiSfM,
                          std::size_t nbMaxDescriptors,
-                         std::size_t numImageQuery)
+                         std::size_t numImageQuery,
+                         const std::string& histogramsFolder)
 {
     ALICEVISION_LOG_INFO("Generate matches in mode: " + EImageMatchingMode_enumToString(modeMultiSfM));
 
@@ -247,6 +412,8 @@ void generateFromVoctree(PairList& allMatches,
         numImageQuery = db.size();
     }
 
+    const uint64_t treeHash = (modeMultiSfM == EImageMatchingMode::A_B && !histogramsFolder.empty()) ? tree.hash() : 0;
+
     // initialize allMatches
 
     for (const auto& descriptorPair : descriptorsFiles)
@@ -273,11 +440,8 @@ void generateFromVoctree(PairList& allMatches,
         }
         else  // mode AB
         {
-            // compute the sparse histogram of each image A
-            std::vector<DescriptorUChar> descriptors;
-            // read the descriptors
-            loadDescsFromBinFile(featuresPathA, descriptors, false, nbMaxDescriptors);
-            imageSH = tree.quantizeToSparse(descriptors);
+            // compute the sparse histogram of each image A, or reuse the saved one
+            voctree::quantizeDescriptorsFile<DescriptorUChar>(featuresPathA, tree, treeHash, histogramsFolder, nbMaxDescriptors, imageSH);
         }
 
         std::vector<aliceVision::voctree::DocMatch> matches;
@@ -307,7 +471,8 @@ void conditionVocTree(const std::string& treeName,
                       bool useMultiSfM,
                       const std::map<IndexT, std::string>& descriptorsFilesA,
                       std::size_t numImageQuery,
-                      OrderedPairList& selectedPairs)
+                      OrderedPairList& selectedPairs,
+                      const std::string& histogramsFolder)
 {
     if (treeName.empty())
     {
@@ -366,7 +531,7 @@ void conditionVocTree(const std::string& treeName,
             if ((matchingMode == EImageMatchingMode::A_A_AND_A_B) || (matchingMode == EImageMatchingMode::A_AB) ||
                 (matchingMode == EImageMatchingMode::A_A))
             {
-                nbFeaturesLoadedInputA = voctree::populateDatabase<DescriptorUChar>(sfmDataA, featuresFolders, tree, db, nbMaxDescriptors);
+                nbFeaturesLoadedInputA = voctree::populateDatabase<DescriptorUChar>(sfmDataA, featuresFolders, tree, db, nbMaxDescriptors, histogramsFolder);
                 nbSetDescriptors = db.getSparseHistogramPerImage().size();
 
                 if (nbFeaturesLoadedInputA == 0)
@@ -377,13 +542,13 @@ void conditionVocTree(const std::string& treeName,
 
             if ((matchingMode == EImageMatchingMode::A_AB) || (matchingMode == EImageMatchingMode::A_B))
             {
-                nbFeaturesLoadedInputB = voctree::populateDatabase<DescriptorUChar>(sfmDataB, featuresFolders, tree, db, nbMaxDescriptors);
+                nbFeaturesLoadedInputB = voctree::populateDatabase<DescriptorUChar>(sfmDataB, featuresFolders, tree, db, nbMaxDescriptors, histogramsFolder);
                 nbSetDescriptors = db.getSparseHistogramPerImage().size();
             }
 
             if (matchingMode == EImageMatchingMode::A_A_AND_A_B)
             {
-                nbFeaturesLoadedInputB = voctree::populateDatabase<DescriptorUChar>(sfmDataB, featuresFolders, tree, db2, nbMaxDescriptors);
+                nbFeaturesLoadedInputB = voctree::populateDatabase<DescriptorUChar>(sfmDataB, featuresFolders, tree, db2, nbMaxDescriptors, histogramsFolder);
                 nbSetDescriptors += db2.getSparseHistogramPerImage().size();
             }
 
@@ -419,12 +584,12 @@ void conditionVocTree(const std::string& treeName,
 
         if (matchingMode == EImageMatchingMode::A_A_AND_A_B)
         {
-            generateFromVoctree(allMatches, descriptorsFilesA, db, tree, EImageMatchingMode::A_A, nbMaxDescriptors, numImageQuery);
-            generateFromVoctree(allMatches, descriptorsFilesA, db2, tree, EImageMatchingMode::A_B, nbMaxDescriptors, numImageQuery);
+            generateFromVoctree(allMatches, descriptorsFilesA, db, tree, EImageMatchingMode::A_A, nbMaxDescriptors, numImageQuery, histogramsFolder);
+            generateFromVoctree(allMatches, descriptorsFilesA, db2, tree, EImageMatchingMode::A_B, nbMaxDescriptors, numImageQuery, histogramsFolder);
         }
         else
         {
-            generateFromVoctree(allMatches, descriptorsFilesA, db, tree, matchingMode, nbMaxDescriptors, numImageQuery);
+            generateFromVoctree(allMatches, descriptorsFilesA, db, tree, matchingMode, nbMaxDescriptors, numImageQuery, histogramsFolder);
         }
 
         auto detect_elapsed = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::steady_clock::now() - detect_start);
@@ -481,6 +646,16 @@ EImageMatchingMethod selectImageMatchingMethod(EImageMatchingMethod method,
         }
     }
 
+    // if not enough images to use the VOCABULARYTREE, only use the spatial neighbors
+    if (method == EImageMatchingMethod::SPATIAL_VOCABULARYTREE)
+    {
+        if ((sfmDataA.getViews().size() + sfmDataB.getViews().size()) < minNbImages)
+        {
+            ALICEVISION_LOG_DEBUG("Use SPATIAL method instead of SPATIAL_VOCABULARYTREE (less images than minNbImages).");
+            method = EImageMatchingMethod::SPATIAL;
+        }
+    }
+
     // if not enough images to use the VOCABULARYTREE use the EXHAUSTIVE method
     if (method == EImageMatchingMethod::VOCABULARYTREE || method == EImageMatchingMethod::SEQUENTIAL_AND_VOCABULARYTREE)
     {
@@ -54,7 +54,9 @@ enum class EImageMatchingMethod
     SEQUENTIAL = 2,
     SEQUENTIAL_AND_VOCABULARYTREE = 3,
     FRUSTUM = 4,
-    FRUSTUM_OR_VOCABULARYTREE = 5
+    FRUSTUM_OR_VOCABULARYTREE = 5,
+    SPATIAL = 6,
+    SPATIAL_VOCABULARYTREE = 7
 };
 
 /**
@@ -119,13 +121,46 @@ void generateSequentialMatches(const sfmData::SfMData& sfmData, size_t nbMatches
 void generateAllMatchesInOneMap(const std::set<IndexT>& viewIds, OrderedPairList& outPairList);
 void generateAllMatchesBetweenTwoMap(const std::set<IndexT>& viewIdsA, const std::set<IndexT>& viewIdsB, OrderedPairList& outPairList);
 
+/**
+ * @brief Parameters of the spatial image matching
+ */
+struct SpatialMatchingParams
+{
+    /// number of nearest views to pair with each view
+    std::size_t nbNeighbors = 50;
+    /// maximum distance between two paired views, in the unit of the poses or in meters for the GPS positions (0 means no limit)
+    double maxDistance = 0.0;
+    /// maximum angle in degrees between the viewing directions of two paired views, only used with known poses
+    double maxAngle = 90.0;
+};
+
+/**
+ * @brief Pair each view with its nearest views, using a kd-tree over the camera positions.
+ *        The positions come from the poses if some views are reconstructed, otherwise from the GPS metadata (in ECEF).
+ *        With the poses, the pairs with diverging viewing directions are removed as their frustums are unlikely to overlap.
+ *        The views without position are paired with all the other views.
+ * @param[in] sfmData the scene
+ * @param[in] params the spatial matching parameters
+ * @param[in,out] outPairList the pairs are added to this list
+ * @return false if no view has a position
+ */
+bool generateSpatialMatches(const sfmData::SfMData& sfmData, const SpatialMatchingParams& params, OrderedPairList& outPairList);
+
+/**
+ * @brief Only keep the pairs of pairList that are also in filterPairList, whatever the order of the two views
+ * @param[in,out] pairList the pairs to filter
+ * @param[in] filterPairList the allowed pairs
+ */
+void intersectPairLists(OrderedPairList& pairList, const OrderedPairList& filterPairList);
+
 void generateFromVoctree(PairList& allMatches,
                          const std::map<IndexT, std::string>& descriptorsFiles,
                          const voctree::Database& db,
                          const voctree::VocabularyTree<DescriptorFloat>& tree,
                          EImageMatchingMode modeMultiSfM,
                          std::size_t nbMaxDescriptors,
-                         std::size_t numImageQuery);
+                         std::size_t numImageQuery,
+                         const std::string& histogramsFolder);
 
 void conditionVocTree(const std::string& treeName,
                       bool withWeights,
@@ -140,7 +175,8 @@ void conditionVocTree(const std::string& treeName,
                       bool useMultiSfM,
                       const std::map<IndexT, std::string>& descriptorsFilesA,
                       std::size_t numImageQuery,
-                      OrderedPairList& selectedPairs);
+                      OrderedPairList& selectedPairs,
+                      const std::string& histogramsFolder);
 
 EImageMatchingMethod selectImageMatchingMethod(EImageMatchingMethod method,
                                                const sfmData::SfMData& sfmDataA,
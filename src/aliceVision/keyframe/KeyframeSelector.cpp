@@ -89,7 +89,7 @@ KeyframeSelector::KeyframeSelector(const std::vector<std::string>& mediaPaths,
     scoresMap["OpticalFlow"] = &_flowScores;
 
     // Parse the sensor database if the path is not empty
-    if (!_sensorDbPath.empty() && sensorDB::parseDatabase(_sensorDbPath, _sensorDatabase))
+    if (!_sensorDbPath.empty() && _sensorDatabase.load(_sensorDbPath))
     {
         _parsedSensorDb = true;
     }
@@ -537,11 +537,13 @@ bool KeyframeSelector::computeScoresProc(const std::size_t startFrame,
     }
 
     std::size_t currentFrame = startFrame;
-    cv::Mat currentMatSharpness;              // OpenCV matrix for the sharpness computation
-    cv::Mat previousMatFlow, currentMatFlow;  // OpenCV matrices for the optical flow computation
+    cv::Mat currentMatSharpness;                          // OpenCV matrix for the sharpness computation
+    cv::Mat currentMatFlow;                               // OpenCV matrix for the optical flow computation
+    std::vector<cv::Mat> previousMatsFlow(feeds.size());  // Previous frame of each feed for the optical flow computation
     auto ptrFlow = cv::optflow::createOptFlow_DeepFlow();
 
-    cv::Mat currentMatFlowMask, currentMatMask;  // OpenCV matrices that will contain the masks
+    cv::Mat currentMatFlowMask, currentMatMask;         // OpenCV matrices that will contain the masks
+    cv::Mat currentMatGrayscale, currentMaskGrayscale;  // Frame and mask decoded once at full resolution
 
     while (currentFrame < endFrame)
     {
@@ -553,8 +555,8 @@ bool KeyframeSelector::computeScoresProc(const std::size_t startFrame,
             auto& feed = *feeds.at(mediaIndex);
 
             if (currentFrame > startFrame)
-            {  // Get currentFrame - 1 for the optical flow computation
-                previousMatFlow = readImage(feed, rescaledWidthFlow);
+            {
+                // The previous frame has already been decoded for the optical flow computation, only move to the next one
                 feed.goToNextFrame();
 
                 if (masksProvided)
@@ -572,67 +574,72 @@ bool KeyframeSelector::computeScoresProc(const std::size_t startFrame,
              *   - otherwise (feed not correctly moved to the next frame), keep on going to the next frame until it is
              *     valid or the end of the feed is reached
              */
-            if (!skipSharpnessComputation)
+            try
             {
-                try
+                // Decode the frame once, it is rescaled for the sharpness and the optical flow computations
+                currentMatGrayscale = readImage(feed);
+                if (masksProvided)
                 {
-                    // Read image for sharpness and rescale it if requested
-                    currentMatSharpness = readImage(feed, rescaledWidthSharpness);
-                    if (masksProvided)
-                    {
-                        auto& maskFeed = *maskFeeds.at(mediaIndex);
-                        currentMatMask = readImage(maskFeed, rescaledWidthSharpness);
-                    }
+                    auto& maskFeed = *maskFeeds.at(mediaIndex);
+                    currentMaskGrayscale = readImage(maskFeed);
                 }
-                catch (const std::invalid_argument& ex)
+            }
+            catch (const std::invalid_argument& ex)
+            {
+                bool success = false;
+                while (!success && currentFrame < nbFrames)
                 {
-                    bool success = false;
-                    while (!success && currentFrame < nbFrames)
+                    // currentFrame + 1 = currently evaluated frame with indexing starting at 1, for display reasons
+                    // currentFrame + 2 = next frame to evaluate with indexing starting at 1, for display reasons
+                    ALICEVISION_LOG_WARNING("Invalid or missing frame " << currentFrame + 1 << ", attempting to read frame " << currentFrame + 2
+                                                                        << ".");
+
                     {
-                        // currentFrame + 1 = currently evaluated frame with indexing starting at 1, for display reasons
-                        // currentFrame + 2 = next frame to evaluate with indexing starting at 1, for display reasons
-                        ALICEVISION_LOG_WARNING("Invalid or missing frame " << currentFrame + 1 << ", attempting to read frame " << currentFrame + 2
-                                                                            << ".");
+                        // Push dummy scores for the frame that was skipped
+                        const std::scoped_lock lock(_mutex);
+                        _sharpnessScores[currentFrame] = -1.f;
+                        _flowScores[currentFrame] = -1.f;
+                    }
 
-                        {
-                            // Push dummy scores for the frame that was skipped
-                            const std::scoped_lock lock(_mutex);
-                            _sharpnessScores[currentFrame] = -1.f;
-                            _flowScores[currentFrame] = -1.f;
-                        }
+                    success = feed.goToFrame(++currentFrame);
+                    if (success)
+                    {
+                        currentMatGrayscale = readImage(feed);
 
-                        success = feed.goToFrame(++currentFrame);
-                        if (success)
+                        if (masksProvided)
                         {
-                            currentMatSharpness = readImage(feed, rescaledWidthSharpness);
-
-                            if (masksProvided)
-                            {
-                                auto& maskFeed = *maskFeeds.at(mediaIndex);
-                                maskFeed.goToFrame(currentFrame);
-                                currentMatMask = readImage(maskFeed, rescaledWidthSharpness);
-                            }
+                            auto& maskFeed = *maskFeeds.at(mediaIndex);
+                            maskFeed.goToFrame(currentFrame);
+                            currentMaskGrayscale = readImage(maskFeed);
                         }
                     }
                 }
             }
 
+            if (!skipSharpnessComputation)
+            {
+                // Rescale the image for sharpness if requested
+                currentMatSharpness = rescaleImage(currentMatGrayscale, rescaledWidthSharpness);
+                if (masksProvided)
+                {
+                    currentMatMask = rescaleImage(currentMaskGrayscale, rescaledWidthSharpness);
+                }
+            }
+
             if (rescaledWidthSharpness == rescaledWidthFlow && !skipSharpnessComputation)
             {
                 currentMatFlow = currentMatSharpness;
                 if (masksProvided)
                 {
-                    auto& maskFeed = *maskFeeds.at(mediaIndex);
                     currentMatFlowMask = currentMatMask;
                 }
             }
             else
             {
-                currentMatFlow = readImage(feed, rescaledWidthFlow);
+                currentMatFlow = rescaleImage(currentMatGrayscale, rescaledWidthFlow);
                 if (masksProvided)
                 {
-                    auto& maskFeed = *maskFeeds.at(mediaIndex);
-                    currentMatFlowMask = readImage(maskFeed, rescaledWidthFlow);
+                    currentMatFlowMask = rescaleImage(currentMaskGrayscale, rescaledWidthFlow);
                 }
             }
 
@@ -646,10 +653,13 @@ bool KeyframeSelector::computeScoresProc(const std::size_t startFrame,
             // Compute optical flow
             if (currentFrame > startFrame)
             {
-                const double flow = estimateFlow(ptrFlow, currentMatFlow, previousMatFlow, flowCellSize, currentMatFlowMask);
+                const double flow = estimateFlow(ptrFlow, currentMatFlow, previousMatsFlow.at(mediaIndex), flowCellSize, currentMatFlowMask);
                 minimalFlow = std::min(minimalFlow, flow);
             }
 
+            // Keep the current frame for the optical flow computation of the next one
+            previousMatsFlow.at(mediaIndex) = currentMatFlow;
+
             std::string rigInfo = feeds.size() > 1 ? " (media " + std::to_string(mediaIndex + 1) + "/" + std::to_string(feeds.size()) + ")" : "";
             ALICEVISION_LOG_INFO("Finished processing frame " << currentFrame + 1 << "/" << nbFrames << rigInfo);
         }
@@ -974,22 +984,23 @@ cv::Mat KeyframeSelector::readImage(dataio::FeedProvider& feed, std::size_t widt
     }
 
     // Convert content to OpenCV
-    cv::Mat cvFrame(cv::Size(image.cols(), image.rows()), CV_8UC3, image.data(), image.cols() * 3);
+    const cv::Mat cvFrame = image::imageViewToCvMat(image::ImageView<const image::RGBColor>(image), CV_8UC3);
 
     // Convert to grayscale
     cv::Mat cvGrayscale;
     cv::cvtColor(cvFrame, cvGrayscale, cv::COLOR_BGR2GRAY);
 
     // Resize to smaller size if requested
-    if (width == 0)
-        return cvGrayscale;
+    return rescaleImage(cvGrayscale, width);
+}
 
-    cv::Mat cvRescaled;
-    if (cvGrayscale.cols > width && width > 0)
-    {
-        cv::resize(cvGrayscale, cvRescaled, cv::Size(width, double(cvGrayscale.rows) * double(width) / double(cvGrayscale.cols)));
-    }
+cv::Mat KeyframeSelector::rescaleImage(const cv::Mat& grayscaleImage, std::size_t width)
+{
+    if (width == 0 || static_cast<std::size_t>(grayscaleImage.cols) <= width)
+        return grayscaleImage;
 
+    cv::Mat cvRescaled;
+    cv::resize(grayscaleImage, cvRescaled, cv::Size(width, double(grayscaleImage.rows) * double(width) / double(grayscaleImage.cols)));
     return cvRescaled;
 }
 
@@ -1017,6 +1028,7 @@ double KeyframeSelector::computeSharpness(const cv::Mat& grayscaleImage, const s
     cv::Mat maskedSum = sum;
     cv::Mat maskedSquaredSum = squaredSum;
     cv::Mat paddedMask;
+    cv::Mat maskCount;
     // If the mask exists, apply it directly on the integral and squared integral images:
     // The sharpness information will still be retained but the masked pixels will now appear as 0s,
     // and they will be counted out during the standard deviation computation.
@@ -1027,6 +1039,10 @@ double KeyframeSelector::computeSharpness(const cv::Mat& grayscaleImage, const s
         mask.copyTo(paddedMask(cv::Rect(1, 1, paddedMask.size().width - 1, paddedMask.size().height - 1)));
         sum.copyTo(maskedSum, paddedMask);
         squaredSum.copyTo(maskedSquaredSum, paddedMask);
+
+        // Integral image of the valid pixels, to count them in each window in constant time
+        const cv::Mat validPixels = (paddedMask != 0) / 255;
+        cv::integral(validPixels, maskCount, CV_32S);
     }
 
     double maxstd = 0.0;
@@ -1037,7 +1053,7 @@ double KeyframeSelector::computeSharpness(const cv::Mat& grayscaleImage, const s
     {
         for (x = 1; x < sum.cols - windowSize; x += windowSize / 4)
         {
-            maxstd = std::max(maxstd, computeSharpnessStd(maskedSum, maskedSquaredSum, x, y, windowSize, paddedMask));
+            maxstd = std::max(maxstd, computeSharpnessStd(maskedSum, maskedSquaredSum, x, y, windowSize, maskCount));
         }
 
         // Compute sharpness over the last part of the image for windowSize along the x-axis;
@@ -1045,7 +1061,7 @@ double KeyframeSelector::computeSharpness(const cv::Mat& grayscaleImage, const s
         if (x >= sum.cols - windowSize)
         {
             x = sum.cols - windowSize - 1;
-            maxstd = std::max(maxstd, computeSharpnessStd(maskedSum, maskedSquaredSum, x, y, windowSize, paddedMask));
+            maxstd = std::max(maxstd, computeSharpnessStd(maskedSum, maskedSquaredSum, x, y, windowSize, maskCount));
         }
     }
 
@@ -1054,7 +1070,7 @@ double KeyframeSelector::computeSharpness(const cv::Mat& grayscaleImage, const s
     if (y >= sum.rows - windowSize)
     {
         y = sum.rows - windowSize - 1;
-        maxstd = std::max(maxstd, computeSharpnessStd(maskedSum, maskedSquaredSum, x, y, windowSize, paddedMask));
+        maxstd = std::max(maxstd, computeSharpnessStd(maskedSum, maskedSquaredSum, x, y, windowSize, maskCount));
     }
 
     return maxstd;
@@ -1065,7 +1081,7 @@ const double KeyframeSelector::computeSharpnessStd(const cv::Mat& sum,
                                                    const int x,
                                                    const int y,
                                                    const int windowSize,
-                                                   const cv::Mat& mask)
+                                                   const cv::Mat& maskCount)
 {
     double totalCount = windowSize * windowSize;
 
@@ -1081,11 +1097,11 @@ const double KeyframeSelector::computeSharpnessStd(const cv::Mat& sum,
     br = squaredSum.at<double>(y + windowSize, x + windowSize);
     const double s2 = br + tl - tr - bl;
 
-    if (!mask.empty())
+    if (!maskCount.empty())
     {
         // Count the number of pixels that are non-masked. Masked pixels are 0s.
-        cv::Mat maskROI = mask(cv::Rect(x, y, windowSize, windowSize));
-        totalCount = cv::countNonZero(maskROI);
+        totalCount = maskCount.at<int>(y + windowSize, x + windowSize) + maskCount.at<int>(y, x) - maskCount.at<int>(y, x + windowSize) -
+                     maskCount.at<int>(y + windowSize, x);
     }
 
     const double var = (s2 - (s1 * s1) / totalCount) / totalCount;
@@ -1392,7 +1408,7 @@ bool KeyframeSelector::writeSfMDataFromSequences(const std::string& mediaPath,
         double sensorWidth = -1.0;
         sensorDB::Datasheet datasheet;
 
-        if (_parsedSensorDb && !make.empty() && !model.empty() && sensorDB::getInfo(make, model, _sensorDatabase, datasheet))
+        if (_parsedSensorDb && !make.empty() && !model.empty() && _sensorDatabase.getInfo(make, model, datasheet))
         {
             sensorWidth = datasheet._sensorWidth;
         }
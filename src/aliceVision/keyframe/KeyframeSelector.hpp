@@ -8,7 +8,7 @@
 
 #include <aliceVision/dataio/FeedProvider.hpp>
 #include <aliceVision/image/all.hpp>
-#include <aliceVision/sensorDB/parseDatabase.hpp>
+#include <aliceVision/sensorDB/SensorDatabase.hpp>
 #include <aliceVision/sfmData/SfMData.hpp>
 #include <aliceVision/sfmDataIO/sfmDataIO.hpp>
 
@@ -218,6 +218,15 @@ class KeyframeSelector
      */
     cv::Mat readImage(dataio::FeedProvider& feed, std::size_t width = 0);
 
+    /**
+     * @brief Rescale a grayscale OpenCV matrix
+     * @param[in] grayscaleImage The input grayscale matrix
+     * @param[in] width The width to resize the input image to. The height will be adjusted with respect to the size ratio.
+     *                  There will be no resizing if this parameter is set to 0 or is larger than the image width
+     * @return An OpenCV Mat object containing the rescaled image
+     */
+    static cv::Mat rescaleImage(const cv::Mat& grayscaleImage, std::size_t width);
+
     /**
      * @brief Compute the sharpness and optical flow scores for the input media paths for a given range of frames
      * @param[in] startFrame the index of the first frame to compute the scores for
@@ -259,7 +268,8 @@ class KeyframeSelector
      * @param[in] x the x-coordinate of the top-left corner of the window for the local standard deviation computation
      * @param[in] y the y-coordinate of the top-left corner of the window for the local standard deviation computation
      * @param[in] windowSize the size of the window along the x- and y-axis for the local standard deviation computation
-     * @param[in] mask the mask associated to the frame the integral and integral images were calculated from
+     * @param[in] maskCount the integral image of the valid pixels of the mask associated to the frame,
+     *            an empty cv::Mat if there is no mask
      * @return a const double value representating the local standard deviation of the Laplacian
      */
     const double computeSharpnessStd(const cv::Mat& sum,
@@ -267,7 +277,7 @@ class KeyframeSelector
                                      const int x,
                                      const int y,
                                      const int windowSize,
-                                     const cv::Mat& mask);
+                                     const cv::Mat& maskCount);
 
     /**
      * @brief Estimate the optical flow score for an input grayscale frame based on its previous frame cell by cell
@@ -404,7 +414,7 @@ class KeyframeSelector
     unsigned int _frameHeight = 0;
 
     /// Parsed sensor database
-    std::vector<sensorDB::Datasheet> _sensorDatabase;
+    sensorDB::SensorDatabase _sensorDatabase;
     bool _parsedSensorDb = false;
 
     /// Map media path index with names of the output images (used when the input medias are videos)
@@ -7,7 +7,10 @@
 
 #include <expat.h>
 
+#include <fstream>
+#include <functional>
 #include <iostream>
+#include <limits>
 #include <math.h>
 
 template<typename T>
@@ -1126,10 +1129,12 @@ void LCPinfo::setVignetteModel(const std::string& name)
         currLensParam.vignParams.VignetteModelParam3 = std::stof(_currText.c_str());
 }
 
-void LCPdatabase::loadDirectory(const boost::filesystem::path& p)
+void LCPdatabase::listDirectory(const boost::filesystem::path& p, std::time_t& lastWriteTime)
 {
     if (boost::filesystem::is_directory(p))
     {
+        lastWriteTime = std::max(lastWriteTime, boost::filesystem::last_write_time(p));
+
         // In some border cases, multiple LCP files could match with the image metadata
         // and we stop the search as soon as we have found a valid match.
         // So to ensure a repeatable behavior, we sort the files by name.
@@ -1138,7 +1143,7 @@ void LCPdatabase::loadDirectory(const boost::filesystem::path& p)
             sortedPaths.push_back(x.path());
         std::sort(sortedPaths.begin(), sortedPaths.end());
         for (auto&& x : sortedPaths)
-            loadDirectory(x);
+            listDirectory(x, lastWriteTime);
     }
     else if (boost::filesystem::is_regular_file(p) && (boost::filesystem::extension(p) == ".lcp"))
     {
@@ -1146,6 +1151,194 @@ void LCPdatabase::loadDirectory(const boost::filesystem::path& p)
     }
 }
 
+void LCPdatabase::loadDirectory(const boost::filesystem::path& p)
+{
+    const std::size_t first = _lcpFilepaths.size();
+    std::time_t lastWriteTime = 0;
+    listDirectory(p, lastWriteTime);
+
+    // a single file is fully parsed when retrieved, no need for an index
+    if (!boost::filesystem::is_directory(p) || _lcpFilepaths.size() == first)
+        return;
+
+    const std::string folder = boost::filesystem::absolute(p).lexically_normal().string();
+    const std::string indexFilepath =
+      !_indexFilepath.empty() ? _indexFilepath
+                              : (boost::filesystem::temp_directory_path() /
+                                 ("aliceVision_lcpIndex_" + std::to_string(std::hash<std::string>()(folder)) + ".txt"))
+                                  .string();
+
+    if (loadIndex(indexFilepath, folder, lastWriteTime, first))
+    {
+        ALICEVISION_LOG_DEBUG("LCP headers loaded from the index file: " << indexFilepath);
+        return;
+    }
+
+    ALICEVISION_LOG_INFO("Index the headers of " << _lcpFilepaths.size() - first << " LCP file(s).");
+#pragma omp parallel for schedule(dynamic)
+    for (int i = static_cast<int>(first); i < static_cast<int>(_lcpFilepaths.size()); ++i)
+        indexHeader(_lcpFilepaths[i]);
+
+    saveIndex(indexFilepath, folder, lastWriteTime, first);
+}
+
+void LCPdatabase::indexHeader(LcpPath& lcpPath)
+{
+    lcpPath.indexed = true;
+    try
+    {
+        const LCPinfo lcpHeader(lcpPath.path.string(), false);
+
+        lcpPath.reducedCameraMaker = reduceString(lcpHeader.getCameraMaker());
+        lcpPath.reducedCameraModel = reduceString(lcpHeader.getCameraModel());
+        lcpPath.reducedCameraPrettyName = reduceString(lcpHeader.getCameraPrettyName());
+        lcpPath.reducedLensPrettyName = reduceString(lcpHeader.getLensPrettyName());
+
+        std::vector<std::string> lensModelsLCP;
+        lcpHeader.getLensModels(lensModelsLCP);
+        lcpPath.reducedLensModels = reduceStrings(lensModelsLCP);
+
+        lcpHeader.getLensIDs(lcpPath.lensIDs);
+        lcpPath.isRaw = lcpHeader.isRawProfile();
+        lcpPath.valid = true;
+    }
+    catch (const std::exception& e)
+    {
+        ALICEVISION_LOG_WARNING("Cannot read the LCP file header \"" << lcpPath.path.string() << "\": " << e.what());
+        lcpPath.valid = false;
+    }
+}
+
+namespace {
+
+constexpr const char* lcpIndexMagic = "AVLCPINDEX";
+constexpr int lcpIndexVersion = 1;
+
+/// the reduced strings are alphanumeric, an empty one is written as "-"
+void writeReducedString(std::ostream& os, const std::string& str) { os << " " << (str.empty() ? "-" : str); }
+
+bool readReducedString(std::istream& is, std::string& str)
+{
+    if (!(is >> str))
+        return false;
+    if (str == "-")
+        str.clear();
+    return true;
+}
+
+}  // namespace
+
+bool LCPdatabase::loadIndex(const std::string& indexFilepath, const std::string& folder, std::time_t lastWriteTime, std::size_t first)
+{
+    std::ifstream is(indexFilepath);
+    if (!is.is_open())
+        return false;
+
+    std::string magic;
+    int version = 0;
+    std::string indexFolder;
+    long long indexLastWriteTime = 0;
+    std::size_t nbFiles = 0;
+    is >> magic >> version;
+    is.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+    std::getline(is, indexFolder);
+    is >> indexLastWriteTime >> nbFiles;
+    is.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+
+    if (!is || magic != lcpIndexMagic || version != lcpIndexVersion || indexFolder != folder ||
+        indexLastWriteTime != static_cast<long long>(lastWriteTime) || nbFiles != _lcpFilepaths.size() - first)
+    {
+        ALICEVISION_LOG_DEBUG("The LCP index file is out of date: " << indexFilepath);
+        return false;
+    }
+
+    std::vector<LcpPath> entries;
+    entries.reserve(nbFiles);
+    for (std::size_t i = 0; i < nbFiles; ++i)
+    {
+        std::string filepath;
+        std::getline(is, filepath);
+        if (!is || filepath != _lcpFilepaths[first + i].path.string())
+            return false;
+
+        LcpPath entry(_lcpFilepaths[first + i]);
+        std::size_t nbLensModels = 0;
+        std::size_t nbLensIDs = 0;
+        is >> entry.valid >> entry.isRaw;
+        readReducedString(is, entry.reducedCameraMaker);
+        readReducedString(is, entry.reducedCameraModel);
+        readReducedString(is, entry.reducedCameraPrettyName);
+        readReducedString(is, entry.reducedLensPrettyName);
+        is >> nbLensModels;
+        entry.reducedLensModels.resize(nbLensModels);
+        for (std::string& lensModel : entry.reducedLensModels)
+            readReducedString(is, lensModel);
+        is >> nbLensIDs;
+        entry.lensIDs.resize(nbLensIDs);
+        for (int& lensID : entry.lensIDs)
+            is >> lensID;
+        is.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+        if (!is)
+            return false;
+
+        entry.indexed = true;
+        entries.push_back(std::move(entry));
+    }
+
+    std::move(entries.begin(), entries.end(), _lcpFilepaths.begin() + first);
+    return true;
+}
+
+void LCPdatabase::saveIndex(const std::string& indexFilepath, const std::string& folder, std::time_t lastWriteTime, std::size_t first) const
+{
+    // written in a temporary file and renamed, as concurrent processes may read or write the same index
+    const std::string tmpFilepath = indexFilepath + "." + boost::filesystem::unique_path().string() + ".tmp";
+    {
+        std::ofstream os(tmpFilepath);
+        if (!os.is_open())
+        {
+            ALICEVISION_LOG_WARNING("Cannot write the LCP index file: " << indexFilepath);
+            return;
+        }
+
+        os << lcpIndexMagic << " " << lcpIndexVersion << "\n";
+        os << folder << "\n";
+        os << static_cast<long long>(lastWriteTime) << " " << _lcpFilepaths.size() - first << "\n";
+        for (std::size_t i = first; i < _lcpFilepaths.size(); ++i)
+        {
+            const LcpPath& entry = _lcpFilepaths[i];
+            os << entry.path.string() << "\n";
+            os << entry.valid << " " << entry.isRaw;
+            writeReducedString(os, entry.reducedCameraMaker);
+            writeReducedString(os, entry.reducedCameraModel);
+            writeReducedString(os, entry.reducedCameraPrettyName);
+            writeReducedString(os, entry.reducedLensPrettyName);
+            os << " " << entry.reducedLensModels.size();
+            for (const std::string& lensModel : entry.reducedLensModels)
+                writeReducedString(os, lensModel);
+            os << " " << entry.lensIDs.size();
+            for (const int lensID : entry.lensIDs)
+                os << " " << lensID;
+            os << "\n";
+        }
+        if (!os)
+        {
+            ALICEVISION_LOG_WARNING("Cannot write the LCP index file: " << indexFilepath);
+            os.close();
+            boost::filesystem::remove(tmpFilepath);
+            return;
+        }
+    }
+
+    boost::system::error_code ec;
+    boost::filesystem::rename(tmpFilepath, indexFilepath, ec);
+    if (ec)
+    {
+        ALICEVISION_LOG_WARNING("Cannot write the LCP index file: " << indexFilepath << " (" << ec.message() << ")");
+        boost::filesystem::remove(tmpFilepath, ec);
+    }
+}
+
 std::string reduceString(const std::string& str)
 {
     std::string s = str;
@@ -1206,38 +1399,29 @@ LCPinfo* LCPdatabase::findLCP(const std::string& cameraMake,
         return retrieveLCP(cachetoLcpPathIt->second);
     }
 
-    for (const LcpPath& lcpPath : _lcpFilepaths)
+    for (LcpPath& lcpPath : _lcpFilepaths)
     {
         const bool filepathContainsMake = (lcpPath.reducedPath.find(reducedCameraMake) != std::string::npos);
         if (!filepathContainsMake)
             continue;
 
-        auto headerIt = _lcpHeaderCache.find(lcpPath.reducedPath);
-        if (headerIt == _lcpHeaderCache.end())
-        {
-            // If not already in the cache of LCP headers, add it.
-            _lcpHeaderCache[lcpPath.path.string()] = LCPinfo(lcpPath.path.string(), false);
-            headerIt = _lcpHeaderCache.find(lcpPath.path.string());
-        }
-
-        const LCPinfo& lcpHeader = headerIt->second;
-
-        const std::string reducedCameraModelLCP = reduceString(_omitCameraModel ? lcpHeader.getCameraMaker() : lcpHeader.getCameraModel());
-        const std::string reducedCameraPrettyNameLCP = reduceString(lcpHeader.getCameraPrettyName());
-        const std::string reducedLensPrettyNameLCP = reduceString(lcpHeader.getLensPrettyName());
-
-        std::vector<std::string> lensModelsLCP;
-        lcpHeader.getLensModels(lensModelsLCP);
-        const std::vector<std::string> reducedLensModelsLCP = reduceStrings(lensModelsLCP);
+        // the LCP files added outside of a folder are not indexed
+        if (!lcpPath.indexed)
+            indexHeader(lcpPath);
+        if (!lcpPath.valid)
+            continue;
 
-        std::vector<int> lensIDsLCP;
-        lcpHeader.getLensIDs(lensIDsLCP);
+        const std::string& reducedCameraModelLCP = _omitCameraModel ? lcpPath.reducedCameraMaker : lcpPath.reducedCameraModel;
+        const std::string& reducedCameraPrettyNameLCP = lcpPath.reducedCameraPrettyName;
+        const std::string& reducedLensPrettyNameLCP = lcpPath.reducedLensPrettyName;
+        const std::vector<std::string>& reducedLensModelsLCP = lcpPath.reducedLensModels;
+        const std::vector<int>& lensIDsLCP = lcpPath.lensIDs;
 
         const bool cameraOK = ((reducedCameraModelLCP == reducedCameraModel) || (reducedCameraPrettyNameLCP == reducedCameraModel));
         const bool lensOK = ((reducedLensPrettyNameLCP.find(reducedLensModel) != std::string::npos) ||
                              (std::find(reducedLensModelsLCP.begin(), reducedLensModelsLCP.end(), reducedLensModel) != reducedLensModelsLCP.end()));
         const bool lensIDOK = (std::find(lensIDsLCP.begin(), lensIDsLCP.end(), lensID) != lensIDsLCP.end());
-        const bool isRaw = lcpHeader.isRawProfile();
+        const bool isRaw = lcpPath.isRaw;
 
         const bool lcpFound = (cameraOK && lensOK && lensIDOK && ((isRaw && rawMode < 2) || (!isRaw && (rawMode % 2 == 0))));
         if (!lcpFound)
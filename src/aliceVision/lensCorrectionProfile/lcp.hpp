@@ -6,6 +6,7 @@
 #include <vector>
 #include <sstream>
 #include <map>
+#include <ctime>
 
 enum class LCPCorrectionMode
 {
@@ -623,9 +624,13 @@ class LCPdatabase
     /**
      * @brief LCPdatabase constructor
      * @param[in] folder The folder containing all lcp files
+     * @param[in] omitCameraModel Match the LCP files on the camera maker and the lens only
+     * @param[in] indexFilepath The index file of the LCP headers, see loadDirectory.
+     *            If empty, a file named after the folder in the temporary directory.
      */
-    LCPdatabase(const std::string& folder, bool omitCameraModel = false)
-      : _omitCameraModel(omitCameraModel)
+    LCPdatabase(const std::string& folder, bool omitCameraModel = false, const std::string& indexFilepath = "")
+      : _indexFilepath(indexFilepath),
+        _omitCameraModel(omitCameraModel)
     {
         loadDirectory(folder);
     }
@@ -635,6 +640,13 @@ class LCPdatabase
 
     size_t size() const { return _lcpFilepaths.size(); }
 
+    /**
+     * @brief Add the LCP files of a folder (recursively) or a single LCP file to the database.
+     *
+     * The headers of the LCP files of a folder are indexed once for the matching (camera and lens names, lens IDs, raw status).
+     * The index is saved in the index file and reused as long as the folder is unchanged (same files and
+     * same modification time of its subfolders). The LCP files are fully parsed only when they are retrieved.
+     */
     void loadDirectory(const boost::filesystem::path& p);
 
     LCPinfo* retrieveLCP() { return retrieveLCP(_lcpFilepaths.begin()->path.string()); }
@@ -662,6 +674,7 @@ class LCPdatabase
     LCPinfo* findLCP(const std::string& cameraMake, const std::string& cameraModel, const std::string& lensModel, const int lensID, int rawMode);
 
   private:
+    /// LCP file and the reduced header fields used for the matching
     struct LcpPath
     {
         LcpPath(const boost::filesystem::path& p)
@@ -670,12 +683,42 @@ class LCPdatabase
         {}
         boost::filesystem::path path;
         std::string reducedPath;
+
+        /// false if the header has not been indexed
+        bool indexed = false;
+        /// false if the header cannot be parsed, the file never matches
+        bool valid = false;
+        std::string reducedCameraMaker;
+        std::string reducedCameraModel;
+        std::string reducedCameraPrettyName;
+        std::string reducedLensPrettyName;
+        std::vector<std::string> reducedLensModels;
+        std::vector<int> lensIDs;
+        bool isRaw = false;
     };
 
+    /**
+     * @brief List the LCP files of a folder recursively, sorted by name.
+     * @param[in,out] lastWriteTime the latest modification time of the listed folders
+     */
+    void listDirectory(const boost::filesystem::path& p, std::time_t& lastWriteTime);
+
+    /// Parse the header of an LCP file into its index entry
+    static void indexHeader(LcpPath& lcpPath);
+
+    /**
+     * @brief Fill the index entries of the LCP files in [first, end[ from the index file.
+     * @return false if the index file does not exist or does not match the folder
+     */
+    bool loadIndex(const std::string& indexFilepath, const std::string& folder, std::time_t lastWriteTime, std::size_t first);
+
+    /// Save the index entries of the LCP files in [first, end[ in the index file
+    void saveIndex(const std::string& indexFilepath, const std::string& folder, std::time_t lastWriteTime, std::size_t first) const;
+
     /// List of all LCP files
     std::vector<LcpPath> _lcpFilepaths;
-    /// Cache the header of LCP files
-    std::map<std::string, LCPinfo> _lcpHeaderCache;
+    /// Index file of the LCP headers
+    std::string _indexFilepath;
     /// Cache of fully loaded LCP files
     std::map<std::string, LCPinfo> _lcpCache;
     /// Map the label from the camera to the matching LCP filepath
@@ -8,6 +8,7 @@
 #include "augmentedNormals.hpp"
 
 #include <aliceVision/system/Logger.hpp>
+#include <aliceVision/alicevision_omp.hpp>
 
 #include <Eigen/Dense>
 
@@ -16,117 +17,103 @@
 namespace aliceVision {
 namespace lightingEstimation {
 
+namespace {
+
+/// number of pixels accumulated at once in the normal equations
+constexpr int pixelsBlockSize = 1024;
+
+inline float getChannel(float value, int) { return value; }
+
+inline float getChannel(const image::RGBfColor& value, int channel) { return value(channel); }
+
 /**
- * @brief Evaluate albedo and normal product for one channel
+ * @brief Accumulate the normal equations of the lighting least squares of an image
+ * Each valid pixel adds the row (albedo * augmented normal) and the picture value of each channel.
+ * The pixels are processed by blocks: the rows of a block are stored in a matrix and accumulated with a matrix product.
  */
-void albedoNormalsProduct(MatrixXf& rhoTimesN, const MatrixXf& albedoChannel, const image::Image<AugmentedNormal>& augmentedNormals)
+template<typename T>
+void accumulateNormalEquations(const image::Image<T>& albedo,
+                               const image::Image<T>& picture,
+                               const image::Image<image::RGBfColor>& normals,
+                               int nbChannels,
+                               std::array<Eigen::Matrix<double, 9, 9>, 3>& ata,
+                               std::array<Eigen::Matrix<double, 9, 1>, 3>& atb,
+                               std::array<std::size_t, 3>& nbRows)
 {
-    std::size_t validIndex = 0;
-    for (int i = 0; i < augmentedNormals.size(); ++i)
+    const int nbPixels = static_cast<int>(normals.size());
+    const int nbBlocks = (nbPixels + pixelsBlockSize - 1) / pixelsBlockSize;
+
+#pragma omp parallel
     {
-        // If the normal is undefined
-        if (augmentedNormals(i).nx() == -1.0f && augmentedNormals(i).ny() == -1.0f && augmentedNormals(i).nz() == -1.0f)
+        std::array<Eigen::Matrix<double, 9, 9>, 3> localAtA;
+        std::array<Eigen::Matrix<double, 9, 1>, 3> localAtB;
+        std::array<std::size_t, 3> localNbRows{0, 0, 0};
+        for (int channel = 0; channel < nbChannels; ++channel)
         {
-            continue;
+            localAtA[channel].setZero();
+            localAtB[channel].setZero();
         }
-        rhoTimesN(validIndex, 0) = albedoChannel(i) * augmentedNormals(i).nx();
-        rhoTimesN(validIndex, 1) = albedoChannel(i) * augmentedNormals(i).ny();
-        rhoTimesN(validIndex, 2) = albedoChannel(i) * augmentedNormals(i).nz();
-        rhoTimesN(validIndex, 3) = albedoChannel(i) * augmentedNormals(i).nambiant();
-        rhoTimesN(validIndex, 4) = albedoChannel(i) * augmentedNormals(i).nx_ny();
-        rhoTimesN(validIndex, 5) = albedoChannel(i) * augmentedNormals(i).nx_nz();
-        rhoTimesN(validIndex, 6) = albedoChannel(i) * augmentedNormals(i).ny_nz();
-        rhoTimesN(validIndex, 7) = albedoChannel(i) * augmentedNormals(i).nx2_ny2();
-        rhoTimesN(validIndex, 8) = albedoChannel(i) * augmentedNormals(i).nz2();
-        ++validIndex;
-    }
-}
 
-void prepareImageData(const MatrixXf& albedo,
-                      const MatrixXf& picture,
-                      const image::Image<AugmentedNormal>& augmentedNormals,
-                      MatrixXf& rhoTimesN,
-                      MatrixXf& colors)
-{
-    std::size_t nbValidPoints = 0;
+        Eigen::Matrix<double, 9, Eigen::Dynamic> rows(9, pixelsBlockSize);
+        Eigen::Matrix<double, Eigen::Dynamic, 1> colors(pixelsBlockSize);
 
-    for (int i = 0; i < augmentedNormals.size(); ++i)
-    {
-        // if the normal is undefined
-        if (augmentedNormals(i).nx() == -1.0f && augmentedNormals(i).ny() == -1.0f && augmentedNormals(i).nz() == -1.0f)
-            continue;
-        ++nbValidPoints;
-    }
+#pragma omp for schedule(static)
+        for (int block = 0; block < nbBlocks; ++block)
+        {
+            const int first = block * pixelsBlockSize;
+            const int last = std::min(first + pixelsBlockSize, nbPixels);
 
-    rhoTimesN.resize(nbValidPoints, 9);
-    albedoNormalsProduct(rhoTimesN, albedo, augmentedNormals);
-    colors.resize(nbValidPoints, 1);
+            for (int channel = 0; channel < nbChannels; ++channel)
+            {
+                int nbValid = 0;
+                for (int i = first; i < last; ++i)
+                {
+                    const image::RGBfColor& normal = normals.data()[i];
+
+                    // if the normal is undefined
+                    if (normal(0) == -1.0f && normal(1) == -1.0f && normal(2) == -1.0f)
+                        continue;
+
+                    const AugmentedNormal augmentedNormal(normal(0), normal(1), normal(2));
+                    rows.col(nbValid) = (getChannel(albedo.data()[i], channel) * augmentedNormal).template cast<double>();
+                    colors(nbValid) = getChannel(picture.data()[i], channel);
+                    ++nbValid;
+                }
+
+                localAtA[channel].noalias() += rows.leftCols(nbValid) * rows.leftCols(nbValid).transpose();
+                localAtB[channel].noalias() += rows.leftCols(nbValid) * colors.head(nbValid);
+                localNbRows[channel] += nbValid;
+            }
+        }
 
-    {
-        std::size_t validIndex = 0;
-        for (int i = 0; i < augmentedNormals.size(); ++i)
+#pragma omp critical(lightingEstimation_normalEquations)
         {
-            // if the normal is undefined
-            if (augmentedNormals(i).nx() == -1.0f && augmentedNormals(i).ny() == -1.0f && augmentedNormals(i).nz() == -1.0f)
-                continue;
-
-            colors(validIndex++) = picture(i);
+            for (int channel = 0; channel < nbChannels; ++channel)
+            {
+                ata[channel] += localAtA[channel];
+                atb[channel] += localAtB[channel];
+                nbRows[channel] += localNbRows[channel];
+            }
         }
     }
 }
 
+}  // namespace
+
+LighthingEstimator::LighthingEstimator() { clear(); }
+
 void LighthingEstimator::addImage(const image::Image<float>& albedo,
                                   const image::Image<float>& picture,
                                   const image::Image<image::RGBfColor>& normals)
 {
-    using namespace Eigen;
-
-    // augmented normales
-    image::Image<AugmentedNormal> augmentedNormals(normals.cast<AugmentedNormal>());
-
-    const std::size_t nbPixels = augmentedNormals.Width() * augmentedNormals.Height();
-
-    MatrixXf rhoTimesN;
-    MatrixXf colors;
-
-    // map albedo, image
-    Map<const MatrixXf> channelAlbedo(albedo.data(), nbPixels, 1);
-    Map<const MatrixXf> channelPicture(picture.data(), nbPixels, 1);
-
-    prepareImageData(channelAlbedo, channelPicture, augmentedNormals, rhoTimesN, colors);
-
-    // store image data
-    _all_rhoTimesN.at(0).push_back(rhoTimesN);
-    _all_pictureChannel.at(0).push_back(colors);
+    accumulateNormalEquations(albedo, picture, normals, 1, _ata, _atb, _nbRows);
 }
 
 void LighthingEstimator::addImage(const image::Image<image::RGBfColor>& albedo,
                                   const image::Image<image::RGBfColor>& picture,
                                   const image::Image<image::RGBfColor>& normals)
 {
-    using namespace Eigen;
-
-    // augmented normales
-    image::Image<AugmentedNormal> augmentedNormals(normals.cast<AugmentedNormal>());
-
-    const std::size_t nbPixels = augmentedNormals.Width() * augmentedNormals.Height();
-
-    // estimate lighting per channel
-    for (std::size_t channel = 0; channel < 3; ++channel)
-    {
-        MatrixXf rhoTimesN;
-        MatrixXf colors;
-
-        // map albedo, image
-        Map<const MatrixXf, 0, InnerStride<3>> channelAlbedo(static_cast<const float*>(&(albedo(0, 0)(channel))), nbPixels, 1);
-        Map<const MatrixXf, 0, InnerStride<3>> channelPicture(static_cast<const float*>(&(picture(0, 0)(channel))), nbPixels, 1);
-
-        prepareImageData(channelAlbedo, channelPicture, augmentedNormals, rhoTimesN, colors);
-
-        // store image data
-        _all_rhoTimesN.at(channel).push_back(rhoTimesN);
-        _all_pictureChannel.at(channel).push_back(colors);
-    }
+    accumulateNormalEquations(albedo, picture, normals, 3, _ata, _atb, _nbRows);
 }
 
 void LighthingEstimator::estimateLigthing(LightingVector& lighting) const
@@ -136,7 +123,7 @@ void LighthingEstimator::estimateLigthing(LightingVector& lighting) const
     // check number of channels
     for (int channel = 0; channel < 3; ++channel)
     {
-        if (_all_rhoTimesN.at(channel).empty())
+        if (_nbRows.at(channel) == 0)
         {
             nbChannels = channel;
             break;
@@ -146,63 +133,31 @@ void LighthingEstimator::estimateLigthing(LightingVector& lighting) const
     // for each channel
     for (int channel = 0; channel < nbChannels; ++channel)
     {
-        std::size_t nbRows_all_rhoTimesN = 0;
-        std::size_t nbRows_all_pictureChannel = 0;
-
-        // count and check matrices rows
-        {
-            for (const MatrixXf& matrix : _all_rhoTimesN.at(channel))
-                nbRows_all_rhoTimesN += matrix.rows();
-
-            for (const MatrixXf& matrix : _all_pictureChannel.at(channel))
-                nbRows_all_pictureChannel += matrix.rows();
-
-            assert(nbRows_all_rhoTimesN == nbRows_all_pictureChannel);
-        }
+        ALICEVISION_LOG_INFO("Estimate ligthing channel: rhoTimesN(" << _nbRows.at(channel) << "x9)");
 
-        // agglomerate rhoTimesN
-        MatrixXf rhoTimesN(nbRows_all_rhoTimesN, 9);
-        {
-            std::size_t nbRow = 0;
-            for (const MatrixXf& matrix : _all_rhoTimesN.at(channel))
-            {
-                for (int matrixRow = 0; matrixRow < matrix.rows(); ++matrixRow)
-                    rhoTimesN.row(nbRow + matrixRow) = matrix.row(matrixRow);
-                nbRow += matrix.rows();
-            }
-        }
-
-        // agglomerate pictureChannel
-        MatrixXf pictureChannel(nbRows_all_pictureChannel, 1);
-        {
-            std::size_t nbRow = 0;
-            for (const MatrixXf& matrix : _all_pictureChannel.at(channel))
-            {
-                for (int matrixRow = 0; matrixRow < matrix.rows(); ++matrixRow)
-                    pictureChannel.row(nbRow + matrixRow) = matrix.row(matrixRow);
-                nbRow += matrix.rows();
-            }
-        }
-
-        ALICEVISION_LOG_INFO("Estimate ligthing channel: rhoTimesN(" << rhoTimesN.rows() << "x" << rhoTimesN.cols() << ")");
-        Eigen::Matrix<float, 9, 1> lightingC = rhoTimesN.colPivHouseholderQr().solve(pictureChannel);
+        // least squares solution from the normal equations
+        const Eigen::Matrix<double, 9, 1> lightingC = _ata.at(channel).colPivHouseholderQr().solve(_atb.at(channel));
 
         // lighting vectors fusion
-        lighting.col(channel) = lightingC;
+        lighting.col(channel) = lightingC.cast<float>();
 
         // luminance estimation
         if (nbChannels == 1)
         {
-            lighting.col(1) = lightingC;
-            lighting.col(2) = lightingC;
+            lighting.col(1) = lighting.col(0);
+            lighting.col(2) = lighting.col(0);
         }
     }
 }
 
 void LighthingEstimator::clear()
 {
-    _all_rhoTimesN = std::array<std::vector<MatrixXf>, 3>();
-    _all_pictureChannel = std::array<std::vector<MatrixXf>, 3>();
+    for (int channel = 0; channel < 3; ++channel)
+    {
+        _ata.at(channel).setZero();
+        _atb.at(channel).setZero();
+        _nbRows.at(channel) = 0;
+    }
 }
 
 }  // namespace lightingEstimation
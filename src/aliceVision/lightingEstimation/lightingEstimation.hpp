@@ -13,6 +13,7 @@
 #include <Eigen/Core>
 #include <Eigen/Dense>
 
+#include <array>
 #include <iostream>
 
 namespace aliceVision {
@@ -32,12 +33,17 @@ using LightingVector = Eigen::Matrix<float, 9, 3>;
  * @warning Image pixel type can be:
  * - RGB (float) for light and color estimation
  * - Greyscale (float) for luminance estimation
+ * The images are not stored: only the normal equations of the least squares are accumulated,
+ * so the memory does not depend on the number and the size of the images.
  */
 class LighthingEstimator
 {
   public:
+    LighthingEstimator();
+
     /**
      * @brief Aggregate image data
+     * @note Images can be added from several threads
      * @param[in] albedo the corresponding albedo image (float image)
      * @param[in] picture the corresponding picture (float image)
      * @param[in] normals the corresponding normals image
@@ -46,6 +52,7 @@ class LighthingEstimator
 
     /**
      * @brief Aggregate image data
+     * @note Images can be added from several threads
      * @param[in] albedo the corresponding albedo image (RGBf image)
      * @param[in] picture the corresponding picture (RGBf image)
      * @param[in] normals the corresponding normals image
@@ -66,8 +73,11 @@ class LighthingEstimator
     void clear();
 
   private:
-    std::array<std::vector<MatrixXf>, 3> _all_rhoTimesN;
-    std::array<std::vector<MatrixXf>, 3> _all_pictureChannel;
+    /// normal equations (rhoTimesN^T * rhoTimesN and rhoTimesN^T * pictureChannel) per channel
+    std::array<Eigen::Matrix<double, 9, 9>, 3> _ata;
+    std::array<Eigen::Matrix<double, 9, 1>, 3> _atb;
+    /// number of accumulated pixels per channel
+    std::array<std::size_t, 3> _nbRows;
 };
 
 }  // namespace lightingEstimation
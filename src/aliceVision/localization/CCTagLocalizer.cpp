@@ -24,6 +24,8 @@
 #include <boost/filesystem.hpp>
 
 #include <algorithm>
+#include <functional>
+#include <memory>
 #include <sstream>
 
 namespace aliceVision {
@@ -42,6 +44,8 @@ CCTagLocalizer::CCTagLocalizer(const sfmData::SfMData& sfmData, const std::strin
         throw std::invalid_argument("Unable to load the descriptors from " + descriptorsFolder);
     }
 
+    buildMarkerIndex();
+
     //  for(const auto & landmark : landmarks)
     //  {
     //    // Use the first observation to retrieve the associated descriptor.
@@ -189,6 +193,114 @@ bool CCTagLocalizer::loadReconstructionDescriptors(const sfmData::SfMData& sfm_d
     return true;
 }
 
+void CCTagLocalizer::buildMarkerIndex()
+{
+    _markerIndex.clear();
+
+    // the views are visited by increasing id, the entries of each marker are sorted by view id
+    for (const auto& viewRegions : _regionsPerView.getData())
+    {
+        const auto itRegions = viewRegions.second.find(_cctagDescType);
+        if (itRegions == viewRegions.second.end())
+            continue;
+
+        const feature::CCTAG_Regions& cctagRegions = dynamic_cast<const feature::CCTAG_Regions&>(*itRegions->second);
+        const auto& descriptors = cctagRegions.Descriptors();
+        for (std::size_t j = 0; j < descriptors.size(); ++j)
+        {
+            const IndexT cctagId = feature::getCCTagId(descriptors[j]);
+            if (cctagId == UndefinedIndexT)
+                continue;
+
+            std::vector<std::pair<IndexT, IndexT>>& markerViews = _markerIndex[cctagId];
+            // keep only the first region of the marker in the view, as viewMatching does
+            if (markerViews.empty() || markerViews.back().first != viewRegions.first)
+                markerViews.emplace_back(viewRegions.first, static_cast<IndexT>(j));
+        }
+    }
+
+    ALICEVISION_LOG_DEBUG("Marker index built with " << _markerIndex.size() << " markers.");
+}
+
+void CCTagLocalizer::getNearestKeyFrames(const std::vector<IndexT>& queryMarkers,
+                                         std::size_t nNearestKeyFrames,
+                                         std::vector<IndexT>& out_kNearestFrames) const
+{
+    {
+        std::lock_guard<std::mutex> lock(_keyFramesCacheMutex);
+        for (auto it = _keyFramesCache.begin(); it != _keyFramesCache.end(); ++it)
+        {
+            if (it->nNearestKeyFrames == nNearestKeyFrames && it->markers == queryMarkers)
+            {
+                out_kNearestFrames = it->keyFrames;
+                // move the entry to the front, the least recently used entries are dropped first
+                if (it != _keyFramesCache.begin())
+                {
+                    KeyFramesCacheEntry entry = std::move(*it);
+                    _keyFramesCache.erase(it);
+                    _keyFramesCache.push_front(std::move(entry));
+                }
+                return;
+            }
+        }
+    }
+
+    // the similarity of a view is the number of query markers it sees
+    std::unordered_map<IndexT, std::size_t> similarities;
+    for (const IndexT cctagId : queryMarkers)
+    {
+        const auto itMarker = _markerIndex.find(cctagId);
+        if (itMarker == _markerIndex.end())
+            continue;
+        for (const auto& viewRegion : itMarker->second)
+            ++similarities[viewRegion.first];
+    }
+
+    // sort by decreasing similarity then decreasing view id, the order of kNearestKeyFrames
+    std::vector<std::pair<std::size_t, IndexT>> sortedViewSimilarities;
+    sortedViewSimilarities.reserve(similarities.size());
+    for (const auto& similarity : similarities)
+        sortedViewSimilarities.emplace_back(similarity.second, similarity.first);
+
+    const std::size_t nbKeyFrames = std::min(nNearestKeyFrames, sortedViewSimilarities.size());
+    std::partial_sort(sortedViewSimilarities.begin(),
+                      sortedViewSimilarities.begin() + nbKeyFrames,
+                      sortedViewSimilarities.end(),
+                      std::greater<std::pair<std::size_t, IndexT>>());
+
+    // all the views of the map share at least one marker with the query
+    out_kNearestFrames.clear();
+    out_kNearestFrames.reserve(nbKeyFrames);
+    for (std::size_t i = 0; i < nbKeyFrames; ++i)
+        out_kNearestFrames.push_back(sortedViewSimilarities[i].second);
+
+    std::lock_guard<std::mutex> lock(_keyFramesCacheMutex);
+    _keyFramesCache.push_front({queryMarkers, nNearestKeyFrames, out_kNearestFrames});
+    if (_keyFramesCache.size() > _keyFramesCacheSize)
+        _keyFramesCache.pop_back();
+}
+
+void CCTagLocalizer::matchKeyFrame(const std::vector<IndexT>& queryRegionMarkers,
+                                   IndexT keyframeId,
+                                   std::vector<matching::IndMatch>& out_featureMatches) const
+{
+    out_featureMatches.clear();
+
+    const auto lessViewId = [](const std::pair<IndexT, IndexT>& viewRegion, IndexT viewId) { return viewRegion.first < viewId; };
+
+    for (std::size_t i = 0; i < queryRegionMarkers.size(); ++i)
+    {
+        const auto itMarker = _markerIndex.find(queryRegionMarkers[i]);
+        if (itMarker == _markerIndex.end())
+            continue;
+
+        const std::vector<std::pair<IndexT, IndexT>>& markerViews = itMarker->second;
+        const auto itView = std::lower_bound(markerViews.begin(), markerViews.end(), keyframeId, lessViewId);
+        if (itView != markerViews.end() && itView->first == keyframeId)
+            out_featureMatches.emplace_back(i, itView->second);
+    }
+}
+
 bool CCTagLocalizer::localize(const image::Image<float>& imageGrey,
                               const LocalizerParameters* parameters,
                               std::mt19937& randomNumberGenerator,
@@ -196,6 +308,21 @@ bool CCTagLocalizer::localize(const image::Image<float>& imageGrey,
                               camera::Pinhole& queryIntrinsics,
                               LocalizationResult& localizationResult,
                               const std::string& imagePath)
+{
+    // extract descriptors and features from image
+    feature::MapRegionsPerDesc tmpQueryRegions;
+    extractFeatures(imageGrey, parameters, tmpQueryRegions, imagePath);
+
+    std::pair<std::size_t, std::size_t> imageSize = std::make_pair(imageGrey.Width(), imageGrey.Height());
+
+    return localize(
+      tmpQueryRegions, imageSize, parameters, randomNumberGenerator, useInputIntrinsics, queryIntrinsics, localizationResult, imagePath);
+}
+
+void CCTagLocalizer::extractFeatures(const image::Image<float>& imageGrey,
+                                     const LocalizerParameters* parameters,
+                                     feature::MapRegionsPerDesc& tmpQueryRegions,
+                                     const std::string& imagePath)
 {
     namespace bfs = boost::filesystem;
 
@@ -204,13 +331,12 @@ bool CCTagLocalizer::localize(const image::Image<float>& imageGrey,
     {
         throw std::invalid_argument("The CCTag localizer parameters are not in the right format.");
     }
-    // extract descriptors and features from image
     ALICEVISION_LOG_DEBUG("[features]\tExtract CCTag from query image");
 
     image::Image<unsigned char> imageGrayUChar;  // cctag image describer don't support float image
     imageGrayUChar = (imageGrey.GetMat() * 255.f).cast<unsigned char>();
 
-    feature::MapRegionsPerDesc tmpQueryRegions;
+    tmpQueryRegions.clear();
 
     _imageDescriber.setCudaPipe(_cudaPipe);
     _imageDescriber.setConfigurationPreset(param->_featurePreset);
@@ -227,8 +353,66 @@ bool CCTagLocalizer::localize(const image::Image<float>& imageGrey,
         // just debugging -- save the svg image with detected cctag
         matching::saveCCTag2SVG(imagePath, imageSize, cctagQueryRegions, param->_visualDebug + "/" + bfs::path(imagePath).stem().string() + ".svg");
     }
-    return localize(
-      tmpQueryRegions, imageSize, parameters, randomNumberGenerator, useInputIntrinsics, queryIntrinsics, localizationResult, imagePath);
+}
+
+void CCTagLocalizer::extractFeaturesBatch(const std::vector<const image::Image<float>*>& imagesGrey,
+                                          const LocalizerParameters* parameters,
+                                          std::vector<feature::MapRegionsPerDesc>& queryRegions,
+                                          const std::vector<std::string>& imagePaths)
+{
+    namespace bfs = boost::filesystem;
+
+    const CCTagLocalizer::Parameters* param = static_cast<const CCTagLocalizer::Parameters*>(parameters);
+    if (!param)
+    {
+        throw std::invalid_argument("The CCTag localizer parameters are not in the right format.");
+    }
+
+    const int nbImages = static_cast<int>(imagesGrey.size());
+    queryRegions.resize(nbImages);
+
+    if (nbImages == 1)
+    {
+        extractFeatures(*imagesGrey.front(), parameters, queryRegions.front(), imagePaths.empty() ? std::string() : imagePaths.front());
+        return;
+    }
+
+    ALICEVISION_LOG_DEBUG("[features]\tExtract CCTag from " << nbImages << " query images");
+
+    // one describer per image, the CUDA pipes cannot be shared between concurrent detections
+    std::vector<std::unique_ptr<feature::ImageDescriber_CCTAG>> imageDescribers(nbImages);
+    for (int i = 0; i < nbImages; ++i)
+    {
+        imageDescribers[i].reset(new feature::ImageDescriber_CCTAG());
+        imageDescribers[i]->setUseCuda(_imageDescriber.useCuda());
+        imageDescribers[i]->setCudaPipe(_cudaPipe + i);
+        imageDescribers[i]->setConfigurationPreset(param->_featurePreset);
+    }
+
+#pragma omp parallel for num_threads(nbImages)
+    for (int i = 0; i < nbImages; ++i)
+    {
+        image::Image<unsigned char> imageGrayUChar;  // cctag image describer don't support float image
+        imageGrayUChar = (imagesGrey[i]->GetMat() * 255.f).cast<unsigned char>();
+
+        queryRegions[i].clear();
+        imageDescribers[i]->describe(imageGrayUChar, queryRegions[i][_cctagDescType]);
+    }
+
+    for (int i = 0; i < nbImages; ++i)
+    {
+        ALICEVISION_LOG_DEBUG("[features]\tExtract CCTAG done: found " << queryRegions[i].at(_cctagDescType)->RegionCount() << " features");
+
+        if (!param->_visualDebug.empty() && i < static_cast<int>(imagePaths.size()) && !imagePaths[i].empty())
+        {
+            const feature::CCTAG_Regions& cctagQueryRegions = queryRegions[i].getRegions<feature::CCTAG_Regions>(_cctagDescType);
+            const std::pair<std::size_t, std::size_t> imageSize = std::make_pair(imagesGrey[i]->Width(), imagesGrey[i]->Height());
+
+            // just debugging -- save the svg image with detected cctag
+            matching::saveCCTag2SVG(
+              imagePaths[i], imageSize, cctagQueryRegions, param->_visualDebug + "/" + bfs::path(imagePaths[i]).stem().string() + ".svg");
+        }
+    }
 }
 
 void CCTagLocalizer::setCudaPipe(int i) { _cudaPipe = i; }
@@ -385,24 +569,19 @@ bool CCTagLocalizer::localizeRig(const std::vector<image::Image<float>>& vec_ima
     assert(numCams == vec_queryIntrinsics.size());
     assert(numCams == vec_subPoses.size() + 1);
 
-    std::vector<feature::MapRegionsPerDesc> vec_queryRegions(numCams);
+    std::vector<feature::MapRegionsPerDesc> vec_queryRegions;
     std::vector<std::pair<std::size_t, std::size_t>> vec_imageSize;
+    std::vector<const image::Image<float>*> vec_imageGreyPtr;
 
-    //@todo parallelize?
     for (size_t i = 0; i < numCams; ++i)
     {
-        image::Image<unsigned char> imageGrayUChar;  // cctag image describer don't support float image
-        imageGrayUChar = (vec_imageGrey.at(i).GetMat() * 255.f).cast<unsigned char>();
-
-        // extract descriptors and features from each image
-        ALICEVISION_LOG_DEBUG("[features]\tExtract CCTag from query image...");
-        _imageDescriber.setConfigurationPreset(param->_featurePreset);
-        _imageDescriber.describe(imageGrayUChar, vec_queryRegions[i][_imageDescriber.getDescriberType()]);
-        ALICEVISION_LOG_DEBUG("[features]\tExtract CCTAG done: found " << vec_queryRegions[i].at(_imageDescriber.getDescriberType())->RegionCount()
-                                                                       << " features");
+        vec_imageGreyPtr.push_back(&vec_imageGrey[i]);
         // add the image size for this image
         vec_imageSize.emplace_back(vec_imageGrey[i].Width(), vec_imageGrey[i].Height());
     }
+
+    // extract descriptors and features from the images of all the cameras at once
+    extractFeaturesBatch(vec_imageGreyPtr, parameters, vec_queryRegions);
     assert(vec_imageSize.size() == vec_queryRegions.size());
 
     return localizeRig(
@@ -725,10 +904,19 @@ void CCTagLocalizer::getAllAssociations(const feature::CCTAG_Regions& queryRegio
                                         std::vector<voctree::DocMatch>& out_matchedImages,
                                         const std::string& imagePath) const
 {
-    std::vector<IndexT> nearestKeyFrames;
-    nearestKeyFrames.reserve(param._nNearestKeyFrames);
+    // the marker of each query region and the sorted set of the visible markers
+    std::vector<IndexT> queryRegionMarkers;
+    queryRegionMarkers.reserve(queryRegions.Descriptors().size());
+    for (const auto& desc : queryRegions.Descriptors())
+        queryRegionMarkers.push_back(feature::getCCTagId(desc));
 
-    kNearestKeyFrames(queryRegions, _cctagDescType, _regionsPerView, param._nNearestKeyFrames, nearestKeyFrames);
+    std::vector<IndexT> queryMarkers(queryRegionMarkers);
+    queryMarkers.erase(std::remove(queryMarkers.begin(), queryMarkers.end(), UndefinedIndexT), queryMarkers.end());
+    std::sort(queryMarkers.begin(), queryMarkers.end());
+    queryMarkers.erase(std::unique(queryMarkers.begin(), queryMarkers.end()), queryMarkers.end());
+
+    std::vector<IndexT> nearestKeyFrames;
+    getNearestKeyFrames(queryMarkers, param._nNearestKeyFrames, nearestKeyFrames);
 
     out_matchedImages.clear();
     out_matchedImages.reserve(nearestKeyFrames.size());
@@ -744,7 +932,7 @@ void CCTagLocalizer::getAllAssociations(const feature::CCTAG_Regions& queryRegio
 
         // Matching
         std::vector<matching::IndMatch> vec_featureMatches;
-        viewMatching(queryRegions, matchedCCtagRegions, vec_featureMatches);
+        matchKeyFrame(queryRegionMarkers, keyframeId, vec_featureMatches);
         ALICEVISION_LOG_DEBUG("[matching]\tFound " << vec_featureMatches.size() << " matches.");
 
         out_matchedImages.emplace_back(keyframeId, vec_featureMatches.size());
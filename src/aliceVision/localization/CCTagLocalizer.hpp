@@ -19,6 +19,11 @@
 
 #include <iostream>
 #include <bitset>
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace aliceVision {
 namespace localization {
@@ -42,6 +47,20 @@ class CCTagLocalizer : public ILocalizer
 
     void setCudaPipe(int i) override;
 
+    void extractFeatures(const image::Image<float>& imageGrey,
+                         const LocalizerParameters* parameters,
+                         feature::MapRegionsPerDesc& queryRegions,
+                         const std::string& imagePath = std::string()) override;
+
+    /**
+     * @brief Extract the CCTags of several images concurrently, each image with its own
+     *        describer and its own CUDA pipe (starting from the pipe set by setCudaPipe).
+     */
+    void extractFeaturesBatch(const std::vector<const image::Image<float>*>& imagesGrey,
+                              const LocalizerParameters* parameters,
+                              std::vector<feature::MapRegionsPerDesc>& queryRegions,
+                              const std::vector<std::string>& imagePaths = std::vector<std::string>()) override;
+
     /**
      * @brief Just a wrapper around the different localization algorithm, the algorith
      * used to localized is chosen using \p param._algorithm
@@ -153,6 +172,26 @@ class CCTagLocalizer : public ILocalizer
   private:
     bool loadReconstructionDescriptors(const sfmData::SfMData& sfm_data, const std::string& feat_directory);
 
+    /// build the marker index from the reconstructed regions of the views
+    void buildMarkerIndex();
+
+    /**
+     * @brief Retrieve the k nearest keyframes of a set of visible markers with the marker index.
+     *        Same result as kNearestKeyFrames, the keyframes of the last marker sets are cached
+     *        as the consecutive frames of a feed (or the cameras of a rig) usually see the same markers.
+     *
+     * @param[in] queryMarkers The sorted ids of the markers visible in the query.
+     * @param[in] nNearestKeyFrames Number of nearest keyframes to return.
+     * @param[out] out_kNearestFrames The ids of the nearest keyframes.
+     */
+    void getNearestKeyFrames(const std::vector<IndexT>& queryMarkers, std::size_t nNearestKeyFrames, std::vector<IndexT>& out_kNearestFrames) const;
+
+    /**
+     * @brief Match the query regions with the reconstructed regions of a keyframe through the marker index,
+     *        same result as viewMatching.
+     */
+    void matchKeyFrame(const std::vector<IndexT>& queryRegionMarkers, IndexT keyframeId, std::vector<matching::IndMatch>& out_featureMatches) const;
+
     // for each view index, it contains the cctag features and descriptors that have an
     // associated 3D point
     feature::RegionsPerView _regionsPerView;
@@ -167,6 +206,23 @@ class CCTagLocalizer : public ILocalizer
     // processing different image dimensions.
     int _cudaPipe = 0;
 
+    /// for each marker id, the <view id, region index> of the reconstructed regions of this marker,
+    /// sorted by view id (only the first region of the marker in each view)
+    std::unordered_map<IndexT, std::vector<std::pair<IndexT, IndexT>>> _markerIndex;
+
+    /// nearest keyframes of a set of visible markers
+    struct KeyFramesCacheEntry
+    {
+        std::vector<IndexT> markers;
+        std::size_t nNearestKeyFrames;
+        std::vector<IndexT> keyFrames;
+    };
+
+    /// the nearest keyframes of the last marker sets, the most recent first
+    mutable std::deque<KeyFramesCacheEntry> _keyFramesCache;
+    mutable std::mutex _keyFramesCacheMutex;
+    static constexpr std::size_t _keyFramesCacheSize = 16;
+
     //
     // std::map<IndexT, Vec3> _cctagDatabase;
 };
@@ -14,6 +14,8 @@
 #include <aliceVision/localization/LocalizationResult.hpp>
 
 #include <random>
+#include <string>
+#include <vector>
 
 namespace aliceVision {
 namespace localization {
@@ -73,6 +75,41 @@ class ILocalizer
 
     const sfmData::SfMData& getSfMData() const { return _sfm_data; }
 
+    /**
+     * @brief Extract the features of one image, the first step of the image localization.
+     *        It only uses the image describers of the localizer, so it can run concurrently
+     *        with the localization of other regions.
+     *
+     * @param[in] imageGrey The input greyscale image.
+     * @param[in] param The parameters for the localization.
+     * @param[out] queryRegions The regions extracted from the image.
+     * @param[in] imagePath Optional complete path to the image, used only for debugging purposes.
+     */
+    virtual void extractFeatures(const image::Image<float>& imageGrey,
+                                 const LocalizerParameters* param,
+                                 feature::MapRegionsPerDesc& queryRegions,
+                                 const std::string& imagePath = std::string()) = 0;
+
+    /**
+     * @brief Extract the features of several images at once, e.g. the cameras of a rig
+     *        or the frames waiting in a feed. By default the images are processed one after the other,
+     *        a localizer can override it to process them concurrently.
+     *
+     * @param[in] imagesGrey The input greyscale images.
+     * @param[in] param The parameters for the localization.
+     * @param[out] queryRegions The regions extracted from each image.
+     * @param[in] imagePaths Optional complete paths to the images, used only for debugging purposes.
+     */
+    virtual void extractFeaturesBatch(const std::vector<const image::Image<float>*>& imagesGrey,
+                                      const LocalizerParameters* param,
+                                      std::vector<feature::MapRegionsPerDesc>& queryRegions,
+                                      const std::vector<std::string>& imagePaths = std::vector<std::string>())
+    {
+        queryRegions.resize(imagesGrey.size());
+        for (std::size_t i = 0; i < imagesGrey.size(); ++i)
+            extractFeatures(*imagesGrey[i], param, queryRegions[i], (i < imagePaths.size()) ? imagePaths[i] : std::string());
+    }
+
     /**
      * @brief Localize one image
      *
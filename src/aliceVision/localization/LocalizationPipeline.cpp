@@ -0,0 +1,248 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "LocalizationPipeline.hpp"
+
+#include <aliceVision/system/Logger.hpp>
+#include <aliceVision/system/Timer.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace aliceVision {
+namespace localization {
+
+namespace {
+
+/**
+ * @brief A frame moving through the stages of the pipeline
+ */
+struct PipelineFrame
+{
+    LocalizedFrame frame;
+    image::Image<float> imageGrey;
+    std::pair<std::size_t, std::size_t> imageSize;
+    feature::MapRegionsPerDesc regions;
+    system::Timer latencyTimer;
+};
+
+/**
+ * @brief Bounded queue between two stages of the pipeline
+ */
+class FrameQueue
+{
+  public:
+    explicit FrameQueue(std::size_t maxSize)
+      : _maxSize(std::max<std::size_t>(maxSize, 1))
+    {}
+
+    /**
+     * @brief Add a frame, wait while the queue is full
+     * @return false if the queue has been closed, the frame is not added
+     */
+    bool push(std::unique_ptr<PipelineFrame>&& frame)
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _notFull.wait(lock, [this] { return _closed || _frames.size() < _maxSize; });
+        if (_closed)
+            return false;
+        _frames.push_back(std::move(frame));
+        _notEmpty.notify_one();
+        return true;
+    }
+
+    /**
+     * @brief Take the next frame, wait while the queue is empty
+     * @return false if the queue has been closed and there are no more frames
+     */
+    bool pop(std::unique_ptr<PipelineFrame>& frame)
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _notEmpty.wait(lock, [this] { return _closed || !_frames.empty(); });
+        if (_frames.empty())
+            return false;
+        frame = std::move(_frames.front());
+        _frames.pop_front();
+        _notFull.notify_one();
+        return true;
+    }
+
+    /**
+     * @brief Take the frames already in the queue, wait while the queue is empty
+     * @param[out] frames the frames taken, at least one
+     * @param[in] maxCount the maximum number of frames to take
+     * @return false if the queue has been closed and there are no more frames
+     */
+    bool popAvailable(std::vector<std::unique_ptr<PipelineFrame>>& frames, std::size_t maxCount)
+    {
+        frames.clear();
+        std::unique_lock<std::mutex> lock(_mutex);
+        _notEmpty.wait(lock, [this] { return _closed || !_frames.empty(); });
+        while (!_frames.empty() && frames.size() < maxCount)
+        {
+            frames.push_back(std::move(_frames.front()));
+            _frames.pop_front();
+        }
+        _notFull.notify_all();
+        return !frames.empty();
+    }
+
+    /**
+     * @brief No more frames will be added, the remaining frames can still be taken
+     */
+    void close()
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _closed = true;
+        _notFull.notify_all();
+        _notEmpty.notify_all();
+    }
+
+  private:
+    const std::size_t _maxSize;
+    std::deque<std::unique_ptr<PipelineFrame>> _frames;
+    bool _closed = false;
+    std::mutex _mutex;
+    std::condition_variable _notFull;
+    std::condition_variable _notEmpty;
+};
+
+}  // namespace
+
+LocalizationPipeline::LocalizationPipeline(ILocalizer& localizer, const LocalizerParameters* param, std::size_t queueSize)
+  : _localizer(localizer),
+    _param(param),
+    _queueSize(queueSize)
+{}
+
+bool LocalizationPipeline::run(dataio::FeedProvider& feed, std::mt19937& gen, const std::function<void(LocalizedFrame&)>& callback)
+{
+    FrameQueue readFrames(_queueSize);
+    FrameQueue extractedFrames(_queueSize);
+    std::atomic<bool> succeeded(true);
+
+    // read the frames of the feed
+    std::thread reader([&]() {
+        try
+        {
+            for (std::size_t index = 0;; ++index)
+            {
+                std::unique_ptr<PipelineFrame> pipelineFrame(new PipelineFrame());
+                LocalizedFrame& frame = pipelineFrame->frame;
+
+                if (!feed.readImage(pipelineFrame->imageGrey, frame.intrinsics, frame.name, frame.hasIntrinsics))
+                    break;
+                feed.goToNextFrame();
+
+                frame.index = index;
+                frame.readTime = pipelineFrame->latencyTimer.elapsedMs();
+
+                // the next stage has stopped
+                if (!readFrames.push(std::move(pipelineFrame)))
+                    break;
+            }
+        }
+        catch (const std::exception& e)
+        {
+            ALICEVISION_LOG_ERROR("Failed to read the frames of the feed: " << e.what());
+            succeeded = false;
+        }
+        readFrames.close();
+    });
+
+    // extract the features of the frames
+    std::thread extractor([&]() {
+        try
+        {
+            // the frames waiting in the queue are extracted together, so a localizer
+            // able to process several images concurrently is not limited to one frame at a time
+            std::vector<std::unique_ptr<PipelineFrame>> pipelineFrames;
+            bool stopped = false;
+            while (!stopped && readFrames.popAvailable(pipelineFrames, _queueSize))
+            {
+                std::vector<const image::Image<float>*> imagesGrey;
+                std::vector<std::string> imagePaths;
+                for (const auto& pipelineFrame : pipelineFrames)
+                {
+                    imagesGrey.push_back(&pipelineFrame->imageGrey);
+                    imagePaths.push_back(pipelineFrame->frame.name);
+                }
+
+                system::Timer timer;
+                std::vector<feature::MapRegionsPerDesc> regions;
+                _localizer.extractFeaturesBatch(imagesGrey, _param, regions, imagePaths);
+                const double extractionTime = timer.elapsedMs();
+
+                for (std::size_t i = 0; i < pipelineFrames.size(); ++i)
+                {
+                    std::unique_ptr<PipelineFrame>& pipelineFrame = pipelineFrames[i];
+                    pipelineFrame->regions = std::move(regions[i]);
+                    pipelineFrame->imageSize = std::make_pair(pipelineFrame->imageGrey.Width(), pipelineFrame->imageGrey.Height());
+                    // the image is no longer needed
+                    pipelineFrame->imageGrey = image::Image<float>();
+                    pipelineFrame->frame.extractionTime = extractionTime;
+
+                    // the next stage has stopped
+                    if (!extractedFrames.push(std::move(pipelineFrame)))
+                    {
+                        stopped = true;
+                        break;
+                    }
+                }
+            }
+        }
+        catch (const std::exception& e)
+        {
+            ALICEVISION_LOG_ERROR("Failed to extract the features of the frames: " << e.what());
+            succeeded = false;
+        }
+        // stop the reading if the extraction stopped early
+        readFrames.close();
+        extractedFrames.close();
+    });
+
+    // localize the frames in the feed order
+    try
+    {
+        std::unique_ptr<PipelineFrame> pipelineFrame;
+        while (extractedFrames.pop(pipelineFrame))
+        {
+            LocalizedFrame& frame = pipelineFrame->frame;
+
+            system::Timer timer;
+            frame.localized = _localizer.localize(
+              pipelineFrame->regions, pipelineFrame->imageSize, _param, gen, frame.hasIntrinsics, frame.intrinsics, frame.result, frame.name);
+            frame.localizationTime = timer.elapsedMs();
+            frame.latency = pipelineFrame->latencyTimer.elapsedMs();
+
+            callback(frame);
+        }
+    }
+    catch (const std::exception& e)
+    {
+        ALICEVISION_LOG_ERROR("Failed to localize the frames: " << e.what());
+        succeeded = false;
+    }
+
+    // stop the other stages if the localization stopped early
+    extractedFrames.close();
+    readFrames.close();
+
+    reader.join();
+    extractor.join();
+
+    return succeeded;
+}
+
+}  // namespace localization
+}  // namespace aliceVision
@@ -0,0 +1,84 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <aliceVision/localization/ILocalizer.hpp>
+#include <aliceVision/localization/LocalizationResult.hpp>
+#include <aliceVision/camera/camera.hpp>
+#include <aliceVision/dataio/FeedProvider.hpp>
+
+#include <cstddef>
+#include <functional>
+#include <random>
+#include <string>
+
+namespace aliceVision {
+namespace localization {
+
+/**
+ * @brief A frame of the feed processed by the LocalizationPipeline
+ */
+struct LocalizedFrame
+{
+    /// index of the frame in the feed
+    std::size_t index = 0;
+    /// path of the media of the frame
+    std::string name;
+    /// intrinsics of the camera, refined or estimated by the localization
+    camera::Pinhole intrinsics;
+    /// whether the intrinsics were provided by the feed
+    bool hasIntrinsics = false;
+    /// whether the frame has been localized
+    bool localized = false;
+    /// the localization result
+    LocalizationResult result;
+    /// time spent reading the frame (ms)
+    double readTime = 0.0;
+    /// time spent extracting the features (ms), of all the frames extracted together with this one
+    double extractionTime = 0.0;
+    /// time spent in the retrieval, the matching and the resection (ms)
+    double localizationTime = 0.0;
+    /// time between the start of the reading and the end of the localization (ms)
+    double latency = 0.0;
+};
+
+/**
+ * @brief Localize the frames of a feed with the reading, the feature extraction and the localization
+ *        running concurrently in their own thread.
+ *
+ * The localization of the frames is done in the feed order in the calling thread, as the localizer
+ * may keep the previous frames to match the next ones. The reading and the extraction of the next
+ * frames are done meanwhile, at most queueSize frames are waiting between two stages.
+ */
+class LocalizationPipeline
+{
+  public:
+    /**
+     * @brief Constructor
+     * @param[in] localizer the initialized localizer
+     * @param[in] param the parameters of the localization
+     * @param[in] queueSize the maximum number of frames waiting between two stages
+     */
+    LocalizationPipeline(ILocalizer& localizer, const LocalizerParameters* param, std::size_t queueSize = 2);
+
+    /**
+     * @brief Localize all the frames of the feed
+     * @param[in,out] feed the feed of the frames
+     * @param[in,out] gen the random generator used by the localization
+     * @param[in] callback called for each frame in the feed order, from the calling thread
+     * @return false if an error occurred
+     */
+    bool run(dataio::FeedProvider& feed, std::mt19937& gen, const std::function<void(LocalizedFrame&)>& callback);
+
+  private:
+    ILocalizer& _localizer;
+    const LocalizerParameters* _param;
+    std::size_t _queueSize;
+};
+
+}  // namespace localization
+}  // namespace aliceVision
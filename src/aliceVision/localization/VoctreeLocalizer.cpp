@@ -182,8 +182,22 @@ bool VoctreeLocalizer::localize(const image::Image<float>& imageGrey,
                                 const std::string& imagePath /* = std::string() */)
 {
     // A. extract descriptors and features from image
-    ALICEVISION_LOG_DEBUG("[features]\tExtract Regions from query image");
     feature::MapRegionsPerDesc queryRegionsPerDesc;
+    extractFeatures(imageGrey, param, queryRegionsPerDesc, imagePath);
+
+    const std::pair<std::size_t, std::size_t> queryImageSize = std::make_pair(imageGrey.Width(), imageGrey.Height());
+
+    return localize(
+      queryRegionsPerDesc, queryImageSize, param, randomNumberGenerator, useInputIntrinsics, queryIntrinsics, localizationResult, imagePath);
+}
+
+void VoctreeLocalizer::extractFeatures(const image::Image<float>& imageGrey,
+                                       const LocalizerParameters* param,
+                                       feature::MapRegionsPerDesc& queryRegionsPerDesc,
+                                       const std::string& imagePath /* = std::string() */)
+{
+    ALICEVISION_LOG_DEBUG("[features]\tExtract Regions from query image");
+    queryRegionsPerDesc.clear();
 
     image::Image<unsigned char> imageGrayUChar;  // uchar image copy for uchar image describer
 
@@ -231,9 +245,6 @@ bool VoctreeLocalizer::localize(const image::Image<float>& imageGrey,
         matching::saveFeatures2SVG(
           imagePath, queryImageSize, extractedFeatures, param->_visualDebug + "/" + bfs::path(imagePath).stem().string() + ".svg");
     }
-
-    return localize(
-      queryRegionsPerDesc, queryImageSize, param, randomNumberGenerator, useInputIntrinsics, queryIntrinsics, localizationResult, imagePath);
 }
 
 bool VoctreeLocalizer::loadReconstructionDescriptors(const sfmData::SfMData& sfm_data, const std::string& feat_directory)
@@ -592,6 +603,52 @@ bool VoctreeLocalizer::localizeAllResults(const feature::MapRegionsPerDesc& quer
                                           camera::Pinhole& queryIntrinsics,
                                           LocalizationResult& localizationResult,
                                           const std::string& imagePath)
+{
+    bool bResection = false;
+    bool tracked = false;
+
+    // first try to match only the database images seen by the last localized frames
+    if (param._useTracking)
+    {
+        std::vector<voctree::DocMatch> trackedViews;
+        if (getTrackedViews(param, trackedViews))
+        {
+            camera::Pinhole trackedIntrinsics = queryIntrinsics;
+            bResection = resectionFromViews(
+              queryRegions, queryImageSize, param, randomNumberGenerator, useInputIntrinsics, trackedIntrinsics, &trackedViews, localizationResult, imagePath);
+            tracked = bResection && localizationResult.isValid() && localizationResult.getInliers().size() >= param._trackingMinInliers;
+            if (tracked)
+                queryIntrinsics = trackedIntrinsics;
+            else
+                ALICEVISION_LOG_DEBUG("[tracking]\tTracking failed, querying the vocabulary tree");
+        }
+    }
+
+    if (!tracked)
+    {
+        bResection = resectionFromViews(
+          queryRegions, queryImageSize, param, randomNumberGenerator, useInputIntrinsics, queryIntrinsics, nullptr, localizationResult, imagePath);
+    }
+
+    // the frame buffer also keeps the last poses for the tracking
+    if (bResection && (param._nbFrameBufferMatching > 0 || param._useTracking))
+    {
+        // add everything to the buffer
+        _frameBuffer.emplace_back(localizationResult, queryRegions);
+    }
+
+    return localizationResult.isValid();
+}
+
+bool VoctreeLocalizer::resectionFromViews(const feature::MapRegionsPerDesc& queryRegions,
+                                          const std::pair<std::size_t, std::size_t>& queryImageSize,
+                                          const Parameters& param,
+                                          std::mt19937& randomNumberGenerator,
+                                          bool useInputIntrinsics,
+                                          camera::Pinhole& queryIntrinsics,
+                                          const std::vector<voctree::DocMatch>* views,
+                                          LocalizationResult& localizationResult,
+                                          const std::string& imagePath)
 {
     sfm::ImageLocalizerMatchData resectionData;
     // a map containing for each pair <pt3D_id, pt2D_id> the number of times that
@@ -600,18 +657,37 @@ bool VoctreeLocalizer::localizeAllResults(const feature::MapRegionsPerDesc& quer
 
     // get all the association from the database images
     std::vector<voctree::DocMatch> matchedImages;
-    getAllAssociations(queryRegions,
-                       queryImageSize,
-                       param,
-                       randomNumberGenerator,
-                       useInputIntrinsics,
-                       queryIntrinsics,
-                       occurences,
-                       resectionData.pt2D,
-                       resectionData.pt3D,
-                       resectionData.vec_descType,
-                       matchedImages,
-                       imagePath);
+    if (views)
+    {
+        matchedImages = *views;
+        getAssociationsFromViews(queryRegions,
+                                 queryImageSize,
+                                 param,
+                                 randomNumberGenerator,
+                                 useInputIntrinsics,
+                                 queryIntrinsics,
+                                 matchedImages,
+                                 occurences,
+                                 resectionData.pt2D,
+                                 resectionData.pt3D,
+                                 resectionData.vec_descType,
+                                 imagePath);
+    }
+    else
+    {
+        getAllAssociations(queryRegions,
+                           queryImageSize,
+                           param,
+                           randomNumberGenerator,
+                           useInputIntrinsics,
+                           queryIntrinsics,
+                           occurences,
+                           resectionData.pt2D,
+                           resectionData.pt3D,
+                           resectionData.vec_descType,
+                           matchedImages,
+                           imagePath);
+    }
 
     const std::size_t numCollectedPts = occurences.size();
     std::vector<IndMatch3D2D> associationIDs;
@@ -651,7 +727,7 @@ bool VoctreeLocalizer::localizeAllResults(const feature::MapRegionsPerDesc& quer
               imagePath, queryImageSize, resectionData.pt2D, param._visualDebug + "/" + bfs::path(imagePath).stem().string() + ".associations.svg");
         }
         localizationResult = LocalizationResult(resectionData, associationIDs, pose, queryIntrinsics, matchedImages, bResection);
-        return localizationResult.isValid();
+        return false;
     }
     ALICEVISION_LOG_DEBUG("[poseEstimation]\tResection SUCCEDED");
 
@@ -707,13 +783,74 @@ bool VoctreeLocalizer::localizeAllResults(const feature::MapRegionsPerDesc& quer
                                         << " max = " << std::sqrt(sqrErrors.maxCoeff()));
     }
 
-    if (param._nbFrameBufferMatching > 0)
+    return true;
+}
+
+bool VoctreeLocalizer::getTrackedViews(const Parameters& param, std::vector<voctree::DocMatch>& out_trackedViews)
+{
+    out_trackedViews.clear();
+
+    // the frustums of the last localized frames, from the most recent one
+    std::vector<geometry::Frustum> frameFrustums;
+    std::vector<Vec3> frameCenters;
+    for (auto it = _frameBuffer.end(); it != _frameBuffer.begin() && frameFrustums.size() < param._trackingNbPoses;)
     {
-        // add everything to the buffer
-        _frameBuffer.emplace_back(localizationResult, queryRegions);
+        --it;
+        const LocalizationResult& frameResult = it->_locResult;
+        if (!frameResult.isValid())
+            continue;
+        const camera::Pinhole& frameIntrinsics = frameResult.getIntrinsics();
+        const geometry::Pose3& framePose = frameResult.getPose();
+        frameFrustums.emplace_back(frameIntrinsics.w(), frameIntrinsics.h(), frameIntrinsics.K(), framePose.rotation(), framePose.center());
+        frameCenters.push_back(framePose.center());
     }
 
-    return localizationResult.isValid();
+    if (frameFrustums.empty())
+        return false;
+
+    if (!_frustumFilter)
+        _frustumFilter.reset(new sfm::FrustumFilter(_sfm_data));
+
+    const sfm::FrustumFilter::FrustumsT& viewFrustums = _frustumFilter->getFrustums();
+
+    std::vector<IndexT> viewIds;
+    viewIds.reserve(viewFrustums.size());
+    for (const auto& viewFrustum : viewFrustums)
+    {
+        if (_regionsPerView.viewExist(viewFrustum.first))
+            viewIds.push_back(viewFrustum.first);
+    }
+
+    // distance of each view to the closest frame seeing it
+    std::vector<float> distances(viewIds.size(), std::numeric_limits<float>::max());
+
+#pragma omp parallel for schedule(dynamic)
+    for (int i = 0; i < static_cast<int>(viewIds.size()); ++i)
+    {
+        const geometry::Frustum& viewFrustum = viewFrustums.at(viewIds[i]);
+        const Vec3 viewCenter = _sfm_data.getPose(*_sfm_data.getViews().at(viewIds[i])).getTransform().center();
+
+        for (std::size_t f = 0; f < frameFrustums.size(); ++f)
+        {
+            if (frameFrustums[f].intersect(viewFrustum))
+                distances[i] = std::min(distances[i], static_cast<float>((frameCenters[f] - viewCenter).norm()));
+        }
+    }
+
+    for (std::size_t i = 0; i < viewIds.size(); ++i)
+    {
+        if (distances[i] < std::numeric_limits<float>::max())
+            out_trackedViews.emplace_back(viewIds[i], distances[i]);
+    }
+
+    // the closest views first
+    std::sort(out_trackedViews.begin(), out_trackedViews.end());
+    if (param._numResults != 0 && out_trackedViews.size() > param._numResults)
+        out_trackedViews.resize(param._numResults);
+
+    ALICEVISION_LOG_DEBUG("[tracking]\t" << out_trackedViews.size() << " images seen by the last " << frameFrustums.size() << " frames");
+
+    return !out_trackedViews.empty();
 }
 
 void VoctreeLocalizer::getAllAssociations(const feature::MapRegionsPerDesc& queryRegions,
@@ -746,6 +883,99 @@ void VoctreeLocalizer::getAllAssociations(const feature::MapRegionsPerDesc& quer
     // Request closest images from voctree
     _database.find(requestImageWords, (param._numResults == 0) ? (_database.size()) : (param._numResults), out_matchedImages);
 
+    getAssociationsFromViews(queryRegions,
+                             imageSize,
+                             param,
+                             randomNumberGenerator,
+                             useInputIntrinsics,
+                             queryIntrinsics,
+                             out_matchedImages,
+                             out_occurences,
+                             out_pt2D,
+                             out_pt3D,
+                             out_descTypes,
+                             imagePath);
+}
+
+void VoctreeLocalizer::getAllAssociationsRig(const std::vector<feature::MapRegionsPerDesc>& vec_queryRegions,
+                                             const std::vector<std::pair<std::size_t, std::size_t>>& vec_imageSize,
+                                             const Parameters& param,
+                                             std::mt19937& randomNumberGenerator,
+                                             const std::vector<camera::Pinhole>& vec_queryIntrinsics,
+                                             std::vector<OccurenceMap>& out_vec_occurences,
+                                             std::vector<Mat>& out_vec_pt2D,
+                                             std::vector<Mat>& out_vec_pt3D,
+                                             std::vector<std::vector<feature::EImageDescriberType>>& out_vec_descTypes,
+                                             std::vector<std::vector<voctree::DocMatch>>& out_vec_matchedImages) const
+{
+    const std::size_t numCams = vec_queryRegions.size();
+
+    out_vec_occurences.assign(numCams, OccurenceMap());
+    out_vec_pt2D.assign(numCams, Mat());
+    out_vec_pt3D.assign(numCams, Mat());
+    out_vec_descTypes.assign(numCams, std::vector<feature::EImageDescriberType>());
+
+    // A. Find the (visually) similar images in the database for all the cameras at once
+    ALICEVISION_LOG_DEBUG("[database]\tRequest closest images from voctree for the " << numCams << " cameras");
+    std::vector<voctree::SparseHistogram> requestImagesWords(numCams);
+
+#pragma omp parallel for
+    for (int camID = 0; camID < static_cast<int>(numCams); ++camID)
+    {
+        if (vec_queryRegions[camID].count(_voctreeDescType) != 0)
+            requestImagesWords[camID] = _voctree->quantizeToSparse(vec_queryRegions[camID].at(_voctreeDescType)->blindDescriptors());
+    }
+
+    _database.findBatch(requestImagesWords, (param._numResults == 0) ? (_database.size()) : (param._numResults), out_vec_matchedImages);
+
+    // each camera has its own generator, seeded in order so that the results are reproducible
+    std::vector<std::mt19937> generators;
+    generators.reserve(numCams);
+    for (std::size_t camID = 0; camID < numCams; ++camID)
+        generators.emplace_back(randomNumberGenerator());
+
+    // B. match the images of the cameras concurrently
+#pragma omp parallel for schedule(dynamic)
+    for (int camID = 0; camID < static_cast<int>(numCams); ++camID)
+    {
+        if (vec_queryRegions[camID].count(_voctreeDescType) == 0)
+        {
+            ALICEVISION_LOG_WARNING("[database]\t No feature type " << feature::EImageDescriberType_enumToString(_voctreeDescType)
+                                                                    << " in query region of camera " << camID << ".");
+            out_vec_matchedImages[camID].clear();
+            continue;
+        }
+
+        const bool useInputIntrinsics = true;
+        getAssociationsFromViews(vec_queryRegions[camID],
+                                 vec_imageSize[camID],
+                                 param,
+                                 generators[camID],
+                                 useInputIntrinsics,
+                                 vec_queryIntrinsics[camID],
+                                 out_vec_matchedImages[camID],
+                                 out_vec_occurences[camID],
+                                 out_vec_pt2D[camID],
+                                 out_vec_pt3D[camID],
+                                 out_vec_descTypes[camID]);
+    }
+}
+
+void VoctreeLocalizer::getAssociationsFromViews(const feature::MapRegionsPerDesc& queryRegions,
+                                                const std::pair<std::size_t, std::size_t>& imageSize,
+                                                const Parameters& param,
+                                                std::mt19937& randomNumberGenerator,
+                                                bool useInputIntrinsics,
+                                                const camera::Pinhole& queryIntrinsics,
+                                                const std::vector<voctree::DocMatch>& views,
+                                                OccurenceMap& out_occurences,
+                                                Mat& out_pt2D,
+                                                Mat& out_pt3D,
+                                                std::vector<feature::EImageDescriberType>& out_descTypes,
+                                                const std::string& imagePath) const
+{
+    assert(out_descTypes.empty());
+
     //  // Debugging log
     //  // for each similar image found print score and number of features
     //  for(const voctree::DocMatch& currMatch : matchedImages )
@@ -768,7 +998,7 @@ void VoctreeLocalizer::getAllAssociations(const feature::MapRegionsPerDesc& quer
     // query image adn the similar image
     // stop when param._maxResults successful matches have been found
     std::size_t goodMatches = 0;
-    for (const voctree::DocMatch& matchedImage : out_matchedImages)
+    for (const voctree::DocMatch& matchedImage : views)
     {
         // minimum number of points that allows a reliable 3D reconstruction
         const size_t minNum3DPoints = 5;
@@ -1144,38 +1374,54 @@ bool VoctreeLocalizer::localizeRig(const std::vector<image::Image<float>>& vec_i
 
     std::vector<feature::MapRegionsPerDesc> vec_queryRegions(numCams);
     std::vector<std::pair<std::size_t, std::size_t>> vec_imageSize;
+    std::vector<const image::Image<float>*> vec_images;
 
-    //@todo parallelize?
     for (size_t i = 0; i < numCams; ++i)
     {
         // add the image size for this image
         vec_imageSize.emplace_back(vec_imageGrey[i].Width(), vec_imageGrey[i].Height());
+        vec_images.push_back(&vec_imageGrey[i]);
+    }
 
-        image::Image<unsigned char> imageGrayUChar;  // uchar image copy for uchar image describer
+    // uchar image copies for uchar image describers
+    std::vector<image::Image<unsigned char>> vec_imageGrayUChar(numCams);
 
-        // extract descriptors and features from each image
-        for (auto& imageDescriber : _imageDescribers)
-        {
-            ALICEVISION_LOG_DEBUG("[features]\tExtract " << feature::EImageDescriberType_enumToString(imageDescriber->getDescriberType())
-                                                         << " from query image...");
-            imageDescriber->describe(vec_imageGrey[i], vec_queryRegions[i][imageDescriber->getDescriberType()]);
+    // extract descriptors and features from all the images together,
+    // the describers with an asynchronous implementation keep all the images in flight
+    for (auto& imageDescriber : _imageDescribers)
+    {
+        const auto descType = imageDescriber->getDescriberType();
+        ALICEVISION_LOG_DEBUG("[features]\tExtract " << feature::EImageDescriberType_enumToString(descType) << " from the " << numCams
+                                                     << " query images...");
 
-            if (imageDescriber->useFloatImage())
-            {
-                imageDescriber->describe(vec_imageGrey[i], vec_queryRegions[i][imageDescriber->getDescriberType()]);
-            }
-            else
+        system::Timer timer;
+        imageDescriber->setCudaPipe(_cudaPipe);
+        imageDescriber->setConfigurationPreset(parameters->_featurePreset);
+
+        if (imageDescriber->useFloatImage())
+        {
+            std::vector<std::unique_ptr<feature::Regions>> regions;
+            imageDescriber->describeBatch(vec_images, regions);
+            for (size_t i = 0; i < numCams; ++i)
+                vec_queryRegions[i][descType] = std::move(regions[i]);
+        }
+        else
+        {
+            for (size_t i = 0; i < numCams; ++i)
             {
                 // image descriptor can't use float image
-                if (imageGrayUChar.Width() == 0)  // the first time, convert the float buffer to uchar
-                    imageGrayUChar = (vec_imageGrey.at(i).GetMat() * 255.f).cast<unsigned char>();
-                imageDescriber->describe(imageGrayUChar, vec_queryRegions[i][imageDescriber->getDescriberType()]);
+                if (vec_imageGrayUChar[i].Width() == 0)  // the first time, convert the float buffer to uchar
+                    vec_imageGrayUChar[i] = (vec_imageGrey[i].GetMat() * 255.f).cast<unsigned char>();
+                imageDescriber->describe(vec_imageGrayUChar[i], vec_queryRegions[i][descType]);
             }
-            ALICEVISION_LOG_DEBUG("[features]\tExtract done: found " << vec_queryRegions[i][imageDescriber->getDescriberType()]->RegionCount()
-                                                                     << " features");
         }
-        ALICEVISION_LOG_DEBUG("[features]\tAll descriptors extracted. Found " << vec_queryRegions[i].getNbAllRegions() << " features");
+        ALICEVISION_LOG_DEBUG("[features]\tExtract " << feature::EImageDescriberType_enumToString(descType) << " done in " << timer.elapsedMs()
+                                                     << " [ms]");
     }
+
+    for (size_t i = 0; i < numCams; ++i)
+        ALICEVISION_LOG_DEBUG("[features]\tAll descriptors extracted. Found " << vec_queryRegions[i].getNbAllRegions() << " features in image " << i);
+
     assert(vec_imageSize.size() == vec_queryRegions.size());
 
     return localizeRig(
@@ -1240,34 +1486,20 @@ bool VoctreeLocalizer::localizeRig_opengv(const std::vector<feature::MapRegionsP
     std::vector<Mat> vec_pts2D(numCams);
 
     // for each camera retrieve the associations
-    //@todo parallelize?
+    getAllAssociationsRig(vec_queryRegions,
+                          vec_imageSize,
+                          *param,
+                          randomNumberGenerator,
+                          vec_queryIntrinsics,
+                          vec_occurrences,
+                          vec_pts2D,
+                          vec_pts3D,
+                          descTypesPerCamera,
+                          vec_matchedImages);
+
     size_t numAssociations = 0;
-    for (std::size_t camID = 0; camID < numCams; ++camID)
-    {
-        // this map is used to collect the 2d-3d associations as we go through the images
-        // the key is a pair <Id3D, Id2d>
-        // the element is the pair 3D point - 2D point
-        auto& occurrences = vec_occurrences[camID];
-        auto& matchedImages = vec_matchedImages[camID];
-        auto& descTypes = descTypesPerCamera[camID];
-        auto& imageSize = vec_imageSize[camID];
-        Mat& pts3D = vec_pts3D[camID];
-        Mat& pts2D = vec_pts2D[camID];
-        camera::Pinhole& queryIntrinsics = vec_queryIntrinsics[camID];
-        const bool useInputIntrinsics = true;
-        getAllAssociations(vec_queryRegions[camID],
-                           imageSize,
-                           *param,
-                           randomNumberGenerator,
-                           useInputIntrinsics,
-                           queryIntrinsics,
-                           occurrences,
-                           pts2D,
-                           pts3D,
-                           descTypes,
-                           matchedImages);
+    for (const auto& occurrences : vec_occurrences)
         numAssociations += occurrences.size();
-    }
 
     // @todo Here it could be possible to filter the associations according to their
     // occurrences, eg giving priority to those associations that are more frequent
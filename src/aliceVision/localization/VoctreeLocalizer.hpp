@@ -10,6 +10,7 @@
 #include <aliceVision/feature/ImageDescriber.hpp>
 #include <aliceVision/sfmData/SfMData.hpp>
 #include <aliceVision/sfm/pipeline/localization/SfMLocalizer.hpp>
+#include <aliceVision/sfm/FrustumFilter.hpp>
 #include <aliceVision/stl/mapUtils.hpp>
 #include <aliceVision/voctree/VocabularyTree.hpp>
 #include <aliceVision/voctree/Database.hpp>
@@ -56,7 +57,10 @@ class VoctreeLocalizer : public ILocalizer
             _numCommonViews(3),
             _ccTagUseCuda(true),
             _matchingError(std::numeric_limits<double>::infinity()),
-            _nbFrameBufferMatching(10)
+            _nbFrameBufferMatching(10),
+            _useTracking(false),
+            _trackingNbPoses(3),
+            _trackingMinInliers(20)
         {}
 
         /// Enable/disable guided matching when matching images
@@ -77,6 +81,13 @@ class VoctreeLocalizer : public ILocalizer
         double _matchingError;
         /// maximum capacity of the frame buffer
         std::size_t _nbFrameBufferMatching;
+        /// for algorithm AllResults, match first the database views seen by the last localized frames
+        /// and query the vocabulary tree only if it fails
+        bool _useTracking;
+        /// number of last localized frames used to select the database views when tracking
+        std::size_t _trackingNbPoses;
+        /// minimum number of inliers to accept the pose estimated when tracking
+        std::size_t _trackingMinInliers;
     };
 
   public:
@@ -104,6 +115,11 @@ class VoctreeLocalizer : public ILocalizer
 
     void setCudaPipe(int i) override { _cudaPipe = i; }
 
+    void extractFeatures(const image::Image<float>& imageGrey,
+                         const LocalizerParameters* param,
+                         feature::MapRegionsPerDesc& queryRegions,
+                         const std::string& imagePath = std::string()) override;
+
     /**
      * @brief Just a wrapper around the different localization algorithm, the algorithm
      * used to localized is chosen using \p param._algorithm. This version extract the
@@ -243,6 +259,7 @@ class VoctreeLocalizer : public ILocalizer
 
     /**
      * @brief Retrieve matches to all images of the database.
+     * It queries the vocabulary tree for the images to match then calls getAssociationsFromViews.
      *
      * @param[in] queryRegions
      * @param[in] imageSize
@@ -270,7 +287,96 @@ class VoctreeLocalizer : public ILocalizer
                             std::vector<voctree::DocMatch>& out_matchedImages,
                             const std::string& imagePath = std::string()) const;
 
+    /**
+     * @brief Retrieve matches to all images of the database for each camera of a rig.
+     * The vocabulary tree is queried for all the cameras at once, then the cameras are matched concurrently.
+     *
+     * @param[in] vec_queryRegions The input features of each camera
+     * @param[in] vec_imageSize The size of the input image of each camera
+     * @param[in] param The parameters for the localization
+     * @param[in] randomNumberGenerator The random seed
+     * @param[in] vec_queryIntrinsics The intrinsics of each camera
+     * @param[out] out_vec_occurences The associations of each camera
+     * @param[out] out_vec_pt2D The 2D points of each camera
+     * @param[out] out_vec_pt3D The 3D points of each camera
+     * @param[out] out_vec_descTypes The describer types of the points of each camera
+     * @param[out] out_vec_matchedImages The matched images of each camera
+     */
+    void getAllAssociationsRig(const std::vector<feature::MapRegionsPerDesc>& vec_queryRegions,
+                               const std::vector<std::pair<std::size_t, std::size_t>>& vec_imageSize,
+                               const Parameters& param,
+                               std::mt19937& randomNumberGenerator,
+                               const std::vector<camera::Pinhole>& vec_queryIntrinsics,
+                               std::vector<OccurenceMap>& out_vec_occurences,
+                               std::vector<Mat>& out_vec_pt2D,
+                               std::vector<Mat>& out_vec_pt3D,
+                               std::vector<std::vector<feature::EImageDescriberType>>& out_vec_descTypes,
+                               std::vector<std::vector<voctree::DocMatch>>& out_vec_matchedImages) const;
+
+    /**
+     * @brief Retrieve matches to the given images of the database.
+     *
+     * @param[in] queryRegions
+     * @param[in] imageSize
+     * @param[in] param
+     * @param[in] randomNumberGenerator
+     * @param[in] useInputIntrinsics
+     * @param[in] queryIntrinsics
+     * @param[in] views the images of the database to match, in order of preference
+     * @param[out] out_occurences
+     * @param[out] out_pt2D output matrix of 2D points
+     * @param[out] out_pt3D output matrix of 3D points
+     * @param[out] out_descTypes output vector of describerType
+     * @param[in] imagePath
+     */
+    void getAssociationsFromViews(const feature::MapRegionsPerDesc& queryRegions,
+                                  const std::pair<std::size_t, std::size_t>& imageSize,
+                                  const Parameters& param,
+                                  std::mt19937& randomNumberGenerator,
+                                  bool useInputIntrinsics,
+                                  const camera::Pinhole& queryIntrinsics,
+                                  const std::vector<voctree::DocMatch>& views,
+                                  OccurenceMap& out_occurences,
+                                  Mat& out_pt2D,
+                                  Mat& out_pt3D,
+                                  std::vector<feature::EImageDescriberType>& out_descTypes,
+                                  const std::string& imagePath = std::string()) const;
+
   private:
+    /**
+     * @brief Estimate the pose from all the 2D-3D associations found with the images of the database.
+     *
+     * @param[in] queryRegions The input features of the query image
+     * @param[in] imageSize The size of the input image
+     * @param[in] param The parameters for the localization
+     * @param[in] randomNumberGenerator The random seed
+     * @param[in] useInputIntrinsics Uses the \p queryIntrinsics as known calibration
+     * @param[in,out] queryIntrinsics Intrinsic parameters of the camera
+     * @param[in] views The images of the database to match, if null they are retrieved with the vocabulary tree
+     * @param[out] localizationResult The localization result containing the pose and the associations.
+     * @param[in] imagePath Optional complete path to the image, used only for debugging purposes.
+     * @return true if the resection succeeded
+     */
+    bool resectionFromViews(const feature::MapRegionsPerDesc& queryRegions,
+                            const std::pair<std::size_t, std::size_t>& imageSize,
+                            const Parameters& param,
+                            std::mt19937& randomNumberGenerator,
+                            bool useInputIntrinsics,
+                            camera::Pinhole& queryIntrinsics,
+                            const std::vector<voctree::DocMatch>* views,
+                            LocalizationResult& localizationResult,
+                            const std::string& imagePath);
+
+    /**
+     * @brief Select the images of the database seen by the last localized frames of the frame buffer,
+     * their frustums intersect the frustum of one of the frames.
+     *
+     * @param[in] param The parameters for the localization
+     * @param[out] out_trackedViews The selected images, scored by the distance to the closest frame
+     * @return true if some images have been selected
+     */
+    bool getTrackedViews(const Parameters& param, std::vector<voctree::DocMatch>& out_trackedViews);
+
     /**
      * @brief Load the vocabulary tree.
 
@@ -356,6 +462,9 @@ class VoctreeLocalizer : public ILocalizer
     /// Last frames buffer
     BoundedBuffer<FrameData> _frameBuffer;
 
+    /// the frustums of the images of the database, computed on the first tracking
+    std::unique_ptr<sfm::FrustumFilter> _frustumFilter;
+
     matching::EMatcherType _matcherType = matching::ANN_L2;
 };
 
@@ -0,0 +1,216 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2023 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <aliceVision/numeric/numeric.hpp>
+#include <aliceVision/matching/ArrayMatcher.hpp>
+#include <aliceVision/feature/metric.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+namespace aliceVision {
+namespace matching {
+
+/**
+ * @brief Exhaustive squared L2 matcher processing the queries and the dataset by cache blocks.
+ *
+ * The squared distance is expanded as |q|^2 + |d|^2 - 2 q.d with the squared norms computed once,
+ * so each pair only costs a dot product. A block of dataset rows is compared to a block of queries
+ * while it is in cache, instead of streaming the whole dataset for each query.
+ * The dot products of unsigned char descriptors are accumulated in integers, which the compiler vectorizes.
+ *
+ * @note The dot products of unsigned char descriptors are exact,
+ *       so the results are the same as ArrayMatcher_bruteForce for SIFT descriptors.
+ */
+template<typename Scalar = float, typename Metric = feature::L2_Vectorized<Scalar>>
+class ArrayMatcher_bruteForceBlocked : public ArrayMatcher<Scalar, Metric>
+{
+  public:
+    typedef typename Metric::ResultType DistanceType;
+
+    ArrayMatcher_bruteForceBlocked() {}
+    virtual ~ArrayMatcher_bruteForceBlocked() {}
+
+    /**
+     * Build the matching structure
+     *
+     * \param[in] dataset   Input data.
+     * \param[in] nbRows    The number of component.
+     * \param[in] dimension Length of the data contained in the dataset.
+     *
+     * \return True if success.
+     */
+    bool Build(std::mt19937& randomNumberGenerator, const Scalar* dataset, int nbRows, int dimension)
+    {
+        _nbRows = 0;
+        _dimension = dimension;
+        _dataset.clear();
+        _datasetSquaredNorms.clear();
+
+        if (nbRows < 1)
+            return false;
+
+        _nbRows = nbRows;
+        _dataset.assign(dataset, dataset + std::size_t(nbRows) * dimension);
+        _datasetSquaredNorms.resize(nbRows);
+        for (int i = 0; i < nbRows; ++i)
+        {
+            const Scalar* row = _dataset.data() + std::size_t(i) * dimension;
+            _datasetSquaredNorms[i] = dotProduct(row, row, dimension);
+        }
+        return true;
+    }
+
+    /**
+     * Search the nearest Neighbor of the scalar array query.
+     *
+     * \param[in]   query     The query array
+     * \param[out]  indice    The indice of array in the dataset that
+     *  have been computed as the nearest array.
+     * \param[out]  distance  The distance between the two arrays.
+     *
+     * \return True if success.
+     */
+    bool SearchNeighbour(const Scalar* query, int* indice, DistanceType* distance)
+    {
+        IndMatches indices;
+        std::vector<DistanceType> distances;
+        if (!SearchNeighbours(query, 1, &indices, &distances, 1))
+            return false;
+        *indice = indices.front()._j;
+        *distance = distances.front();
+        return true;
+    }
+
+    /**
+     * Search the N nearest Neighbor of the scalar array query.
+     *
+     * \param[in]   query     The query array
+     * \param[in]   nbQuery   The number of query rows
+     * \param[out]  indices   The corresponding (query, neighbor) indices
+     * \param[out]  distances The distances between the matched arrays.
+     * \param[out]  NN        The number of maximal neighbor that will be searched.
+     *
+     * \return True if success.
+     */
+    bool SearchNeighbours(const Scalar* query, int nbQuery, IndMatches* pvec_indices, std::vector<DistanceType>* pvec_distances, size_t NN)
+    {
+        if (_nbRows == 0)
+            return false;
+
+        if (NN > _nbRows || nbQuery < 1 || NN < 1)
+            return false;
+
+        const int nbBlocks = (nbQuery + queryBlockSize - 1) / queryBlockSize;
+
+        pvec_distances->resize(nbQuery * NN);
+        pvec_indices->resize(nbQuery * NN);
+
+#pragma omp parallel for schedule(dynamic)
+        for (int block = 0; block < nbBlocks; ++block)
+        {
+            const int firstQuery = block * queryBlockSize;
+            const int blockQueries = std::min(queryBlockSize, nbQuery - firstQuery);
+
+            std::vector<double> querySquaredNorms(blockQueries);
+            for (int q = 0; q < blockQueries; ++q)
+            {
+                const Scalar* queryPtr = query + std::size_t(firstQuery + q) * _dimension;
+                querySquaredNorms[q] = dotProduct(queryPtr, queryPtr, _dimension);
+            }
+
+            // the N smallest distances of each query of the block, sorted by insertion
+            std::vector<double> bestDistances(blockQueries * NN, std::numeric_limits<double>::max());
+            std::vector<int> bestIndices(blockQueries * NN, -1);
+
+            for (int firstRow = 0; firstRow < _nbRows; firstRow += datasetBlockSize)
+            {
+                const int lastRow = std::min(firstRow + datasetBlockSize, _nbRows);
+
+                for (int q = 0; q < blockQueries; ++q)
+                {
+                    const Scalar* queryPtr = query + std::size_t(firstQuery + q) * _dimension;
+                    double* queryBestDistances = bestDistances.data() + q * NN;
+                    int* queryBestIndices = bestIndices.data() + q * NN;
+
+                    for (int i = firstRow; i < lastRow; ++i)
+                    {
+                        const Scalar* rowPtr = _dataset.data() + std::size_t(i) * _dimension;
+                        const double d =
+                          std::max(0.0, querySquaredNorms[q] + _datasetSquaredNorms[i] - 2.0 * dotProduct(queryPtr, rowPtr, _dimension));
+                        if (d >= queryBestDistances[NN - 1])
+                            continue;
+                        int k = NN - 1;
+                        for (; k > 0 && queryBestDistances[k - 1] > d; --k)
+                        {
+                            queryBestDistances[k] = queryBestDistances[k - 1];
+                            queryBestIndices[k] = queryBestIndices[k - 1];
+                        }
+                        queryBestDistances[k] = d;
+                        queryBestIndices[k] = i;
+                    }
+                }
+            }
+
+            for (int q = 0; q < blockQueries; ++q)
+            {
+                const int queryIndex = firstQuery + q;
+                for (std::size_t k = 0; k < NN; ++k)
+                {
+                    (*pvec_distances)[queryIndex * NN + k] = static_cast<DistanceType>(bestDistances[q * NN + k]);
+                    (*pvec_indices)[queryIndex * NN + k] = IndMatch(queryIndex, bestIndices[q * NN + k]);
+                }
+            }
+        }
+        return true;
+    }
+
+  private:
+    /// number of queries and of dataset rows compared together, the dataset rows of a block stay in cache
+    static constexpr int queryBlockSize = 64;
+    static constexpr int datasetBlockSize = 512;
+
+    static inline double dotProduct(const Scalar* a, const Scalar* b, int dimension)
+    {
+        if (std::is_same<Scalar, unsigned char>::value)
+        {
+            // exact and vectorized: 128 * 255 * 255 fits in 32 bits
+            std::int32_t result = 0;
+            for (int k = 0; k < dimension; ++k)
+                result += std::int32_t(a[k]) * std::int32_t(b[k]);
+            return result;
+        }
+        else
+        {
+            // independent accumulators to break the dependency chain of the sum
+            double result[4] = {0.0, 0.0, 0.0, 0.0};
+            int k = 0;
+            for (; k + 3 < dimension; k += 4)
+            {
+                result[0] += double(a[k]) * double(b[k]);
+                result[1] += double(a[k + 1]) * double(b[k + 1]);
+                result[2] += double(a[k + 2]) * double(b[k + 2]);
+                result[3] += double(a[k + 3]) * double(b[k + 3]);
+            }
+            for (; k < dimension; ++k)
+                result[0] += double(a[k]) * double(b[k]);
+            return (result[0] + result[1]) + (result[2] + result[3]);
+        }
+    }
+
+    int _nbRows = 0;
+    int _dimension = 0;
+    std::vector<Scalar> _dataset;
+    std::vector<double> _datasetSquaredNorms;
+};
+
+}  // namespace matching
+}  // namespace aliceVision
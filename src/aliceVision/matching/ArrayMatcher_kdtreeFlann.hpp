@@ -10,10 +10,15 @@
 #include <aliceVision/matching/ArrayMatcher.hpp>
 #include <aliceVision/config.hpp>
 #include <aliceVision/alicevision_omp.hpp>
+#include <aliceVision/system/Logger.hpp>
 
 #include <flann/flann.hpp>
 
+#include <boost/filesystem.hpp>
+
+#include <cstdio>
 #include <memory>
+#include <string>
 
 namespace aliceVision {
 namespace matching {
@@ -35,6 +40,14 @@ class ArrayMatcher_kdtreeFlann : public ArrayMatcher<Scalar, Metric>
 
     virtual ~ArrayMatcher_kdtreeFlann() = default;
 
+    /**
+     * @brief Set the file of the serialized index, the index is loaded from it if it exists,
+     *        and built then saved to it otherwise.
+     * @note The file must be specific to the dataset, FLANN only checks the size of the dataset.
+     * @param[in] indexFilepath the index file, no serialization if empty
+     */
+    void setIndexFilepath(const std::string& indexFilepath) { _indexFilepath = indexFilepath; }
+
     /**
      * Build the matching structure
      *
@@ -54,12 +67,41 @@ class ArrayMatcher_kdtreeFlann : public ArrayMatcher<Scalar, Metric>
         //-- Build Flann Matrix container (map to already allocated memory)
         _datasetM.reset(new flann::Matrix<Scalar>((Scalar*)dataset, nbRows, dimension));
 
+        if (!_indexFilepath.empty() && boost::filesystem::exists(_indexFilepath))
+        {
+            try
+            {
+                _index.reset(new flann::Index<Metric>(*_datasetM, flann::SavedIndexParams(_indexFilepath)));
+                return true;
+            }
+            catch (const std::exception& e)
+            {
+                ALICEVISION_LOG_WARNING("Cannot load the kd-tree index '" << _indexFilepath << "', it is built again: " << e.what());
+            }
+        }
+
         //-- Build FLANN index
         flann::KDTreeIndexParams params(4);
         params["random_seed"] = 1;
         _index.reset(new flann::Index<Metric>(*_datasetM, params));
         _index->buildIndex();
 
+        if (!_indexFilepath.empty())
+        {
+            // the index is saved in a temporary file then renamed, a concurrent reader never loads a partial index
+            const std::string tmpFilepath = _indexFilepath + "." + boost::filesystem::unique_path().string() + ".tmp";
+            try
+            {
+                _index->save(tmpFilepath);
+                boost::filesystem::rename(tmpFilepath, _indexFilepath);
+            }
+            catch (const std::exception& e)
+            {
+                ALICEVISION_LOG_WARNING("Cannot save the kd-tree index '" << _indexFilepath << "': " << e.what());
+                std::remove(tmpFilepath.c_str());
+            }
+        }
+
         return true;
     }
 
@@ -138,6 +180,7 @@ class ArrayMatcher_kdtreeFlann : public ArrayMatcher<Scalar, Metric>
     std::unique_ptr<flann::Matrix<Scalar>> _datasetM;
     std::unique_ptr<flann::Index<Metric>> _index;
     std::size_t _dimension;
+    std::string _indexFilepath;
 };
 
 }  // namespace matching
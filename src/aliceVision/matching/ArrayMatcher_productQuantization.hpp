@@ -0,0 +1,407 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2023 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <aliceVision/numeric/numeric.hpp>
+#include <aliceVision/matching/ArrayMatcher.hpp>
+#include <aliceVision/feature/metric.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <vector>
+
+namespace aliceVision {
+namespace matching {
+
+/**
+ * @brief Product quantizer of descriptors.
+ *
+ * The descriptor space is split into contiguous subspaces, each one quantized with its own k-means codebook
+ * of at most 256 centroids, so a descriptor is encoded with one byte per subspace.
+ * The squared L2 distance between a query and an encoded descriptor is approximated by the sum of the
+ * distances between the query subvectors and the centroids of the code (asymmetric distance),
+ * read from a table computed once per query.
+ */
+class ProductQuantizer
+{
+  public:
+    static constexpr int maxNbCentroids = 256;
+
+    /**
+     * @brief Train the codebooks with k-means on a random sample of the dataset.
+     * @param[in] randomNumberGenerator the generator used to sample the dataset and to initialize the centroids
+     * @param[in] dataset the descriptors, row-major
+     * @param[in] nbRows the number of descriptors
+     * @param[in] dimension the length of the descriptors
+     * @param[in] nbSubspaces the number of subspaces, i.e. the size of the codes in bytes
+     * @return false if the dataset is empty
+     */
+    template<typename Scalar>
+    bool train(std::mt19937& randomNumberGenerator, const Scalar* dataset, int nbRows, int dimension, int nbSubspaces)
+    {
+        _dimension = dimension;
+        _nbSubspaces = std::max(1, std::min(nbSubspaces, dimension));
+        _nbCentroids = 0;
+        _centroids.clear();
+        _subspacesBegin.resize(_nbSubspaces + 1);
+        for (int m = 0; m <= _nbSubspaces; ++m)
+            _subspacesBegin[m] = (m * dimension) / _nbSubspaces;
+
+        if (nbRows < 1 || dimension < 1)
+            return false;
+
+        // random sample of the training rows (partial Fisher-Yates shuffle)
+        std::vector<int> rows(nbRows);
+        std::iota(rows.begin(), rows.end(), 0);
+        const int nbTrainingRows = std::min(nbRows, maxNbTrainingRowsPerCentroid * maxNbCentroids);
+        for (int i = 0; i < nbTrainingRows; ++i)
+        {
+            std::uniform_int_distribution<int> distribution(i, nbRows - 1);
+            std::swap(rows[i], rows[distribution(randomNumberGenerator)]);
+        }
+        rows.resize(nbTrainingRows);
+
+        std::vector<float> training(std::size_t(nbTrainingRows) * dimension);
+        for (int i = 0; i < nbTrainingRows; ++i)
+            std::copy_n(dataset + std::size_t(rows[i]) * dimension, dimension, training.begin() + std::size_t(i) * dimension);
+
+        // the initial centroids are the first training rows, which are already in random order
+        _nbCentroids = std::min(maxNbCentroids, nbTrainingRows);
+        _centroids.resize(std::size_t(_nbCentroids) * dimension);
+
+#pragma omp parallel for schedule(dynamic)
+        for (int m = 0; m < _nbSubspaces; ++m)
+            trainSubspace(m, training, nbTrainingRows);
+
+        return true;
+    }
+
+    /**
+     * @brief Encode descriptors with the trained codebooks.
+     * @param[in] dataset the descriptors, row-major
+     * @param[in] nbRows the number of descriptors
+     * @param[out] codes the codes, getCodeSize() bytes per descriptor
+     */
+    template<typename Scalar>
+    void encode(const Scalar* dataset, int nbRows, std::vector<std::uint8_t>& codes) const
+    {
+        codes.resize(std::size_t(nbRows) * _nbSubspaces);
+
+#pragma omp parallel for
+        for (int i = 0; i < nbRows; ++i)
+        {
+            const Scalar* row = dataset + std::size_t(i) * _dimension;
+            for (int m = 0; m < _nbSubspaces; ++m)
+            {
+                const int begin = _subspacesBegin[m];
+                codes[std::size_t(i) * _nbSubspaces + m] = static_cast<std::uint8_t>(getNearestCentroid(m, row + begin));
+            }
+        }
+    }
+
+    /**
+     * @brief Compute the table of the squared distances between the query subvectors and the centroids.
+     * @param[in] query the query descriptor
+     * @param[out] table the distance to centroid c of subspace m at index m * maxNbCentroids + c
+     */
+    template<typename Scalar>
+    void computeDistanceTable(const Scalar* query, std::vector<float>& table) const
+    {
+        table.assign(std::size_t(_nbSubspaces) * maxNbCentroids, 0.0f);
+        for (int m = 0; m < _nbSubspaces; ++m)
+        {
+            const int begin = _subspacesBegin[m];
+            for (int c = 0; c < _nbCentroids; ++c)
+                table[m * maxNbCentroids + c] = squaredDistance(query + begin, getCentroid(m, c), getSubspaceDimension(m));
+        }
+    }
+
+    /**
+     * @return the asymmetric squared distance between a query, given by its distance table, and an encoded descriptor
+     */
+    inline float asymmetricDistance(const float* table, const std::uint8_t* code) const
+    {
+        float result = 0.0f;
+        for (int m = 0; m < _nbSubspaces; ++m)
+            result += table[m * maxNbCentroids + code[m]];
+        return result;
+    }
+
+    /// @return the size of the codes in bytes
+    int getCodeSize() const { return _nbSubspaces; }
+
+    int getNbCentroids() const { return _nbCentroids; }
+
+  private:
+    /// maximum number of training rows per centroid, bounds the training time
+    static constexpr int maxNbTrainingRowsPerCentroid = 32;
+    static constexpr int nbIterations = 8;
+
+    int getSubspaceDimension(int m) const { return _subspacesBegin[m + 1] - _subspacesBegin[m]; }
+
+    /// the centroids of subspace m are stored contiguously, starting at _nbCentroids * _subspacesBegin[m]
+    const float* getCentroid(int m, int c) const
+    {
+        return _centroids.data() + std::size_t(_nbCentroids) * _subspacesBegin[m] + std::size_t(c) * getSubspaceDimension(m);
+    }
+
+    float* getCentroid(int m, int c)
+    {
+        return _centroids.data() + std::size_t(_nbCentroids) * _subspacesBegin[m] + std::size_t(c) * getSubspaceDimension(m);
+    }
+
+    template<typename Scalar>
+    static inline float squaredDistance(const Scalar* a, const float* b, int dimension)
+    {
+        float result = 0.0f;
+        for (int k = 0; k < dimension; ++k)
+        {
+            const float diff = float(a[k]) - b[k];
+            result += diff * diff;
+        }
+        return result;
+    }
+
+    template<typename Scalar>
+    int getNearestCentroid(int m, const Scalar* subvector) const
+    {
+        const int subDimension = getSubspaceDimension(m);
+        int nearest = 0;
+        float nearestDistance = std::numeric_limits<float>::max();
+        for (int c = 0; c < _nbCentroids; ++c)
+        {
+            const float d = squaredDistance(subvector, getCentroid(m, c), subDimension);
+            if (d < nearestDistance)
+            {
+                nearestDistance = d;
+                nearest = c;
+            }
+        }
+        return nearest;
+    }
+
+    /// Lloyd iterations on one subspace, a centroid without assigned rows keeps its position
+    void trainSubspace(int m, const std::vector<float>& training, int nbTrainingRows)
+    {
+        const int begin = _subspacesBegin[m];
+        const int subDimension = getSubspaceDimension(m);
+
+        for (int c = 0; c < _nbCentroids; ++c)
+            std::copy_n(training.data() + std::size_t(c) * _dimension + begin, subDimension, getCentroid(m, c));
+
+        std::vector<int> assignments(nbTrainingRows, -1);
+        std::vector<double> sums(std::size_t(_nbCentroids) * subDimension);
+        std::vector<int> counts(_nbCentroids);
+
+        for (int iteration = 0; iteration < nbIterations; ++iteration)
+        {
+            bool changed = false;
+            for (int i = 0; i < nbTrainingRows; ++i)
+            {
+                const int nearest = getNearestCentroid(m, training.data() + std::size_t(i) * _dimension + begin);
+                changed |= (nearest != assignments[i]);
+                assignments[i] = nearest;
+            }
+            if (!changed)
+                break;
+
+            std::fill(sums.begin(), sums.end(), 0.0);
+            std::fill(counts.begin(), counts.end(), 0);
+            for (int i = 0; i < nbTrainingRows; ++i)
+            {
+                const float* subvector = training.data() + std::size_t(i) * _dimension + begin;
+                double* sum = sums.data() + std::size_t(assignments[i]) * subDimension;
+                for (int k = 0; k < subDimension; ++k)
+                    sum[k] += subvector[k];
+                ++counts[assignments[i]];
+            }
+            for (int c = 0; c < _nbCentroids; ++c)
+            {
+                if (counts[c] == 0)
+                    continue;
+                float* centroid = getCentroid(m, c);
+                for (int k = 0; k < subDimension; ++k)
+                    centroid[k] = static_cast<float>(sums[std::size_t(c) * subDimension + k] / counts[c]);
+            }
+        }
+    }
+
+    int _dimension = 0;
+    int _nbSubspaces = 0;
+    int _nbCentroids = 0;
+    std::vector<int> _subspacesBegin;
+    std::vector<float> _centroids;
+};
+
+/**
+ * @brief Approximate L2 matcher on product quantized descriptors with exact re-ranking.
+ *
+ * The dataset is stored as product quantization codes (one byte per subspace, 16 bytes by default instead of
+ * 128 bytes for a SIFT descriptor). The candidates of each query are the dataset rows with the smallest
+ * asymmetric distances, which are then re-ranked with the exact distances computed on the raw descriptors.
+ *
+ * @note The raw dataset is not copied: it must stay valid while the matcher is used,
+ *       which is the case of the Regions of RegionsMatcher.
+ */
+template<typename Scalar = float, typename Metric = feature::L2_Vectorized<Scalar>>
+class ArrayMatcher_productQuantization : public ArrayMatcher<Scalar, Metric>
+{
+  public:
+    typedef typename Metric::ResultType DistanceType;
+
+    /**
+     * @param[in] nbSubspaces the number of subspaces, i.e. the size of the codes in bytes
+     * @param[in] nbCandidates the number of candidates re-ranked with the exact distance for each query
+     */
+    explicit ArrayMatcher_productQuantization(int nbSubspaces = 16, int nbCandidates = 16)
+      : _nbSubspaces(nbSubspaces),
+        _nbCandidates(nbCandidates)
+    {}
+    virtual ~ArrayMatcher_productQuantization() {}
+
+    /**
+     * Build the matching structure
+     *
+     * \param[in] dataset   Input data.
+     * \param[in] nbRows    The number of component.
+     * \param[in] dimension Length of the data contained in the dataset.
+     *
+     * \return True if success.
+     */
+    bool Build(std::mt19937& randomNumberGenerator, const Scalar* dataset, int nbRows, int dimension)
+    {
+        _nbRows = 0;
+        _dimension = dimension;
+        _dataset = nullptr;
+        _codes.clear();
+
+        if (nbRows < 1)
+            return false;
+
+        if (!_quantizer.train(randomNumberGenerator, dataset, nbRows, dimension, _nbSubspaces))
+            return false;
+
+        _quantizer.encode(dataset, nbRows, _codes);
+        _nbRows = nbRows;
+        _dataset = dataset;
+        return true;
+    }
+
+    /**
+     * Search the nearest Neighbor of the scalar array query.
+     *
+     * \param[in]   query     The query array
+     * \param[out]  indice    The indice of array in the dataset that
+     *  have been computed as the nearest array.
+     * \param[out]  distance  The distance between the two arrays.
+     *
+     * \return True if success.
+     */
+    bool SearchNeighbour(const Scalar* query, int* indice, DistanceType* distance)
+    {
+        IndMatches indices;
+        std::vector<DistanceType> distances;
+        if (!SearchNeighbours(query, 1, &indices, &distances, 1))
+            return false;
+        *indice = indices.front()._j;
+        *distance = distances.front();
+        return true;
+    }
+
+    /**
+     * Search the N nearest Neighbor of the scalar array query.
+     *
+     * \param[in]   query     The query array
+     * \param[in]   nbQuery   The number of query rows
+     * \param[out]  indices   The corresponding (query, neighbor) indices
+     * \param[out]  distances The distances between the matched arrays.
+     * \param[out]  NN        The number of maximal neighbor that will be searched.
+     *
+     * \return True if success.
+     */
+    bool SearchNeighbours(const Scalar* query, int nbQuery, IndMatches* pvec_indices, std::vector<DistanceType>* pvec_distances, size_t NN)
+    {
+        if (_nbRows == 0)
+            return false;
+
+        if (NN > _nbRows || nbQuery < 1 || NN < 1)
+            return false;
+
+        const int nbCandidates = std::min(_nbRows, std::max(int(NN), _nbCandidates));
+        const int codeSize = _quantizer.getCodeSize();
+
+        pvec_distances->resize(nbQuery * NN);
+        pvec_indices->resize(nbQuery * NN);
+
+#pragma omp parallel
+        {
+            std::vector<float> table;
+            std::vector<float> candidatesDistances(nbCandidates);
+            std::vector<int> candidatesIndices(nbCandidates);
+            std::vector<std::pair<DistanceType, int>> reranked(nbCandidates);
+
+#pragma omp for schedule(dynamic, 16)
+            for (int q = 0; q < nbQuery; ++q)
+            {
+                const Scalar* queryPtr = query + std::size_t(q) * _dimension;
+                _quantizer.computeDistanceTable(queryPtr, table);
+
+                // the candidates with the smallest asymmetric distances, sorted by insertion
+                std::fill(candidatesDistances.begin(), candidatesDistances.end(), std::numeric_limits<float>::max());
+                std::fill(candidatesIndices.begin(), candidatesIndices.end(), -1);
+                for (int i = 0; i < _nbRows; ++i)
+                {
+                    const float d = _quantizer.asymmetricDistance(table.data(), _codes.data() + std::size_t(i) * codeSize);
+                    if (d >= candidatesDistances[nbCandidates - 1])
+                        continue;
+                    int k = nbCandidates - 1;
+                    for (; k > 0 && candidatesDistances[k - 1] > d; --k)
+                    {
+                        candidatesDistances[k] = candidatesDistances[k - 1];
+                        candidatesIndices[k] = candidatesIndices[k - 1];
+                    }
+                    candidatesDistances[k] = d;
+                    candidatesIndices[k] = i;
+                }
+
+                // exact re-ranking on the raw descriptors
+                for (int k = 0; k < nbCandidates; ++k)
+                {
+                    const int i = candidatesIndices[k];
+                    reranked[k] = std::make_pair(_metric(queryPtr, _dataset + std::size_t(i) * _dimension, _dimension), i);
+                }
+                std::partial_sort(reranked.begin(), reranked.begin() + NN, reranked.end());
+
+                for (std::size_t k = 0; k < NN; ++k)
+                {
+                    (*pvec_distances)[q * NN + k] = reranked[k].first;
+                    (*pvec_indices)[q * NN + k] = IndMatch(q, reranked[k].second);
+                }
+            }
+        }
+        return true;
+    }
+
+    /// @return the size of the matching structure in bytes, without the raw dataset
+    std::size_t getCodesSize() const { return _codes.size(); }
+
+  private:
+    int _nbSubspaces;
+    int _nbCandidates;
+    int _nbRows = 0;
+    int _dimension = 0;
+    const Scalar* _dataset = nullptr;
+    ProductQuantizer _quantizer;
+    std::vector<std::uint8_t> _codes;
+    Metric _metric;
+};
+
+}  // namespace matching
+}  // namespace aliceVision
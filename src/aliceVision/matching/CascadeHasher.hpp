@@ -187,24 +187,66 @@ class CascadeHasher
                 }
             }
         }
-        // Build the Buckets
+        BuildBuckets(hashed_descriptions);
+        return hashed_descriptions;
+    }
+
+    // Build the Buckets from the bucket ids of the hashed descriptions
+    void BuildBuckets(HashedDescriptions& hashed_descriptions) const
+    {
+        hashed_descriptions.buckets.clear();
+        hashed_descriptions.buckets.resize(nb_bucket_groups_);
+        for (int i = 0; i < nb_bucket_groups_; ++i)
         {
-            hashed_descriptions.buckets.resize(nb_bucket_groups_);
-            for (int i = 0; i < nb_bucket_groups_; ++i)
-            {
-                hashed_descriptions.buckets[i].resize(nb_buckets_per_group_);
+            hashed_descriptions.buckets[i].resize(nb_buckets_per_group_);
 
-                // Add the descriptor ID to the proper bucket group and id.
-                for (int j = 0; j < hashed_descriptions.hashed_desc.size(); ++j)
-                {
-                    const uint16_t bucket_id = hashed_descriptions.hashed_desc[j].bucket_ids[i];
-                    hashed_descriptions.buckets[i][bucket_id].push_back(j);
-                }
+            // Add the descriptor ID to the proper bucket group and id.
+            for (int j = 0; j < hashed_descriptions.hashed_desc.size(); ++j)
+            {
+                const uint16_t bucket_id = hashed_descriptions.hashed_desc[j].bucket_ids[i];
+                hashed_descriptions.buckets[i][bucket_id].push_back(j);
             }
         }
-        return hashed_descriptions;
     }
 
+    // Write the hashing projections
+    void Save(std::ostream& stream) const
+    {
+        const int32_t header[3] = {nb_hash_code_, nb_bucket_groups_, nb_bits_per_bucket_};
+        stream.write(reinterpret_cast<const char*>(header), sizeof(header));
+        stream.write(reinterpret_cast<const char*>(primary_hash_projection_.data()), primary_hash_projection_.size() * sizeof(float));
+        for (const Eigen::MatrixXf& projection : secondary_hash_projection_)
+            stream.write(reinterpret_cast<const char*>(projection.data()), projection.size() * sizeof(float));
+    }
+
+    // Read the hashing projections written by Save, returns false if the stream is invalid
+    bool Load(std::istream& stream)
+    {
+        int32_t header[3];
+        if (!stream.read(reinterpret_cast<char*>(header), sizeof(header)))
+            return false;
+        if (header[0] <= 0 || header[0] > 255 || header[1] <= 0 || header[1] > 255 || header[2] <= 0 || header[2] > 16)
+            return false;
+
+        nb_hash_code_ = header[0];
+        nb_bucket_groups_ = header[1];
+        nb_bits_per_bucket_ = header[2];
+        nb_buckets_per_group_ = 1 << nb_bits_per_bucket_;
+
+        primary_hash_projection_.resize(nb_hash_code_, nb_hash_code_);
+        stream.read(reinterpret_cast<char*>(primary_hash_projection_.data()), primary_hash_projection_.size() * sizeof(float));
+        secondary_hash_projection_.resize(nb_bucket_groups_);
+        for (Eigen::MatrixXf& projection : secondary_hash_projection_)
+        {
+            projection.resize(nb_bits_per_bucket_, nb_hash_code_);
+            stream.read(reinterpret_cast<char*>(projection.data()), projection.size() * sizeof(float));
+        }
+        return static_cast<bool>(stream);
+    }
+
+    int NbHashCode() const { return nb_hash_code_; }
+    int NbBucketGroups() const { return nb_bucket_groups_; }
+
     // Matches two collection of hashed descriptions with a fast matching scheme
     // based on the hash codes previously generated.
     template<typename MatrixT, typename DistanceType>
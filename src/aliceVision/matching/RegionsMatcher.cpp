@@ -8,7 +8,9 @@
 #include "aliceVision/matching/matcherType.hpp"
 #include "aliceVision/matching/RegionsMatcher.hpp"
 #include "aliceVision/matching/ArrayMatcher_bruteForce.hpp"
+#include "aliceVision/matching/ArrayMatcher_bruteForceBlocked.hpp"
 #include "aliceVision/matching/ArrayMatcher_kdtreeFlann.hpp"
+#include "aliceVision/matching/ArrayMatcher_productQuantization.hpp"
 #include "aliceVision/matching/ArrayMatcher_cascadeHashing.hpp"
 
 #include <aliceVision/system/Logger.hpp>
@@ -45,15 +47,17 @@ RegionsDatabaseMatcher::RegionsDatabaseMatcher()
 
 RegionsDatabaseMatcher::RegionsDatabaseMatcher(std::mt19937& randomNumberGenerator,
                                                matching::EMatcherType matcherType,
-                                               const feature::Regions& databaseRegions)
+                                               const feature::Regions& databaseRegions,
+                                               const std::string& kdTreeIndexFilepath)
   : _matcherType(matcherType)
 {
-    _regionsMatcher = createRegionsMatcher(randomNumberGenerator, databaseRegions, matcherType);
+    _regionsMatcher = createRegionsMatcher(randomNumberGenerator, databaseRegions, matcherType, kdTreeIndexFilepath);
 }
 
 std::unique_ptr<IRegionsMatcher> createRegionsMatcher(std::mt19937& randomNumberGenerator,
                                                       const feature::Regions& regions,
-                                                      matching::EMatcherType matcherType)
+                                                      matching::EMatcherType matcherType,
+                                                      const std::string& kdTreeIndexFilepath)
 {
     std::unique_ptr<IRegionsMatcher> out;
 
@@ -78,10 +82,23 @@ std::unique_ptr<IRegionsMatcher> createRegionsMatcher(std::mt19937& randomNumber
                     out.reset(new matching::RegionsMatcher<MatcherT>(randomNumberGenerator, regions, true));
                 }
                 break;
+                case BLOCKED_BRUTE_FORCE_L2:
+                {
+                    typedef ArrayMatcher_bruteForceBlocked<unsigned char> MatcherT;
+                    out.reset(new matching::RegionsMatcher<MatcherT>(randomNumberGenerator, regions, true));
+                }
+                break;
+                case PRODUCT_QUANTIZATION_L2:
+                {
+                    typedef ArrayMatcher_productQuantization<unsigned char> MatcherT;
+                    out.reset(new matching::RegionsMatcher<MatcherT>(randomNumberGenerator, regions, true));
+                }
+                break;
                 case ANN_L2:
                 {
                     typedef ArrayMatcher_kdtreeFlann<unsigned char> MatcherT;
-                    out.reset(new matching::RegionsMatcher<MatcherT>(randomNumberGenerator, regions, true));
+                    out.reset(new matching::RegionsMatcher<MatcherT>(
+                      randomNumberGenerator, regions, true, [&](MatcherT& matcher) { matcher.setIndexFilepath(kdTreeIndexFilepath); }));
                 }
                 break;
                 case CASCADE_HASHING_L2:
@@ -107,10 +124,23 @@ std::unique_ptr<IRegionsMatcher> createRegionsMatcher(std::mt19937& randomNumber
                     out.reset(new matching::RegionsMatcher<MatcherT>(randomNumberGenerator, regions, true));
                 }
                 break;
+                case BLOCKED_BRUTE_FORCE_L2:
+                {
+                    typedef ArrayMatcher_bruteForceBlocked<float> MatcherT;
+                    out.reset(new matching::RegionsMatcher<MatcherT>(randomNumberGenerator, regions, true));
+                }
+                break;
+                case PRODUCT_QUANTIZATION_L2:
+                {
+                    typedef ArrayMatcher_productQuantization<float> MatcherT;
+                    out.reset(new matching::RegionsMatcher<MatcherT>(randomNumberGenerator, regions, true));
+                }
+                break;
                 case ANN_L2:
                 {
                     typedef ArrayMatcher_kdtreeFlann<float> MatcherT;
-                    out.reset(new matching::RegionsMatcher<MatcherT>(randomNumberGenerator, regions, true));
+                    out.reset(new matching::RegionsMatcher<MatcherT>(
+                      randomNumberGenerator, regions, true, [&](MatcherT& matcher) { matcher.setIndexFilepath(kdTreeIndexFilepath); }));
                 }
                 break;
                 case CASCADE_HASHING_L2:
@@ -136,10 +166,23 @@ std::unique_ptr<IRegionsMatcher> createRegionsMatcher(std::mt19937& randomNumber
                     out.reset(new matching::RegionsMatcher<MatcherT>(randomNumberGenerator, regions, true));
                 }
                 break;
+                case BLOCKED_BRUTE_FORCE_L2:
+                {
+                    typedef ArrayMatcher_bruteForceBlocked<double> MatcherT;
+                    out.reset(new matching::RegionsMatcher<MatcherT>(randomNumberGenerator, regions, true));
+                }
+                break;
+                case PRODUCT_QUANTIZATION_L2:
+                {
+                    typedef ArrayMatcher_productQuantization<double> MatcherT;
+                    out.reset(new matching::RegionsMatcher<MatcherT>(randomNumberGenerator, regions, true));
+                }
+                break;
                 case ANN_L2:
                 {
                     typedef ArrayMatcher_kdtreeFlann<double> MatcherT;
-                    out.reset(new matching::RegionsMatcher<MatcherT>(randomNumberGenerator, regions, true));
+                    out.reset(new matching::RegionsMatcher<MatcherT>(
+                      randomNumberGenerator, regions, true, [&](MatcherT& matcher) { matcher.setIndexFilepath(kdTreeIndexFilepath); }));
                 }
                 break;
                 case CASCADE_HASHING_L2:
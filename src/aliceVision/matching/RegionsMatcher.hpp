@@ -16,6 +16,8 @@
 #include "aliceVision/feature/Regions.hpp"
 #include "aliceVision/feature/RegionsPerView.hpp"
 
+#include <functional>
+#include <string>
 #include <vector>
 #include <random>
 
@@ -101,14 +103,21 @@ class RegionsMatcher : public IRegionsMatcher
      * @param regions The Regions to be used as database.
      * @param b_squared_metric Whether to use a squared metric for the ratio test
      * when matching two Regions.
+     * @param configureMatcher Called on the array matcher before its build, if set.
      */
-    RegionsMatcher(std::mt19937& randomNumberGenerator, const feature::Regions& regions, bool b_squared_metric = false)
+    RegionsMatcher(std::mt19937& randomNumberGenerator,
+                   const feature::Regions& regions,
+                   bool b_squared_metric = false,
+                   const std::function<void(ArrayMatcherT&)>& configureMatcher = nullptr)
       : IRegionsMatcher(regions),
         b_squared_metric_(b_squared_metric)
     {
         if (regions_.RegionCount() == 0)
             return;
 
+        if (configureMatcher)
+            configureMatcher(matcher_);
+
         const Scalar* tab = reinterpret_cast<const Scalar*>(regions_.DescriptorRawData());
         matcher_.Build(randomNumberGenerator, tab, regions_.RegionCount(), regions_.DescriptorLength());
     }
@@ -195,8 +204,12 @@ class RegionsDatabaseMatcher
      * @param[in] matcherType The type of matcher to use to match the Regions.
      * @param[in] database_regions The Regions that will be used as database to
      * match other Regions (query).
+     * @param[in] kdTreeIndexFilepath The file of the serialized index of ANN_L2, no serialization if empty.
      */
-    RegionsDatabaseMatcher(std::mt19937& randomNumberGenerator, matching::EMatcherType matcherType, const feature::Regions& database_regions);
+    RegionsDatabaseMatcher(std::mt19937& randomNumberGenerator,
+                           matching::EMatcherType matcherType,
+                           const feature::Regions& database_regions,
+                           const std::string& kdTreeIndexFilepath = "");
 
     /**
      * @brief Find corresponding points between the query Regions and the database one
@@ -254,9 +267,14 @@ class RegionsDatabaseMatcherPerDesc
     std::map<feature::EImageDescriberType, RegionsDatabaseMatcher> _mapMatchers;
 };
 
+/**
+ * @brief Create the matcher of the given database regions.
+ * @param[in] kdTreeIndexFilepath The file of the serialized index of ANN_L2, no serialization if empty.
+ */
 std::unique_ptr<IRegionsMatcher> createRegionsMatcher(std::mt19937& randomNumberGenerator,
                                                       const feature::Regions& regions,
-                                                      matching::EMatcherType matcherType);
+                                                      matching::EMatcherType matcherType,
+                                                      const std::string& kdTreeIndexFilepath = "");
 
 }  // namespace matching
 }  // namespace aliceVision
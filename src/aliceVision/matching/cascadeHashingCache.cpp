@@ -0,0 +1,204 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2023 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "cascadeHashingCache.hpp"
+
+#include <aliceVision/system/Logger.hpp>
+
+#include <boost/filesystem.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+namespace aliceVision {
+namespace matching {
+
+namespace fs = boost::filesystem;
+
+namespace {
+
+const char hashedDescriptionsMagic[4] = {'A', 'V', 'C', 'H'};
+const std::uint32_t hashedDescriptionsVersion = 1;
+
+/// header of the hashed descriptions files, followed by the hash codes then the bucket ids of each description
+struct HashedDescriptionsHeader
+{
+    char magic[4];
+    std::uint32_t version;
+    std::uint64_t hasherKey;
+    std::uint64_t descriptorsKey;
+    std::uint32_t nbDescriptions;
+    std::uint32_t nbHashCodeBits;
+    std::uint32_t nbHashCodeBlocks;
+    std::uint32_t nbBucketGroups;
+};
+
+/// write the content in a temporary file renamed to the given path
+bool writeFileAtomically(const std::string& filepath, const std::string& content)
+{
+    const fs::path tmpPath = fs::path(filepath).string() + "." + fs::unique_path().string() + ".tmp";
+    {
+        std::ofstream file(tmpPath.string(), std::ios::out | std::ios::binary);
+        if (!file.is_open() || !file.write(content.data(), content.size()))
+        {
+            ALICEVISION_LOG_WARNING("Cannot write the cascade hashing cache file '" << filepath << "'.");
+            return false;
+        }
+    }
+    boost::system::error_code ec;
+    fs::rename(tmpPath, filepath, ec);
+    if (ec)
+    {
+        ALICEVISION_LOG_WARNING("Cannot write the cascade hashing cache file '" << filepath << "': " << ec.message());
+        fs::remove(tmpPath, ec);
+        return false;
+    }
+    return true;
+}
+
+}  // namespace
+
+std::uint64_t hashBytes(const void* data, std::size_t size, std::uint64_t seed)
+{
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    std::uint64_t hash = seed;
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        hash ^= bytes[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+std::uint64_t getCascadeHasherKey(const CascadeHasher& cascadeHasher, const Eigen::VectorXf& zeroMeanDescriptor)
+{
+    std::ostringstream stream;
+    cascadeHasher.Save(stream);
+    const std::string projections = stream.str();
+    const std::uint64_t hash = hashBytes(projections.data(), projections.size());
+    return hashBytes(zeroMeanDescriptor.data(), zeroMeanDescriptor.size() * sizeof(float), hash);
+}
+
+bool saveCascadeHasher(const std::string& filepath, const CascadeHasher& cascadeHasher, const Eigen::VectorXf& zeroMeanDescriptor)
+{
+    std::ostringstream stream;
+    cascadeHasher.Save(stream);
+    const std::int32_t size = static_cast<std::int32_t>(zeroMeanDescriptor.size());
+    stream.write(reinterpret_cast<const char*>(&size), sizeof(size));
+    stream.write(reinterpret_cast<const char*>(zeroMeanDescriptor.data()), size * sizeof(float));
+    return writeFileAtomically(filepath, stream.str());
+}
+
+bool loadCascadeHasher(const std::string& filepath, CascadeHasher& out_cascadeHasher, Eigen::VectorXf& out_zeroMeanDescriptor)
+{
+    std::ifstream stream(filepath, std::ios::in | std::ios::binary);
+    if (!stream.is_open())
+        return false;
+
+    if (!out_cascadeHasher.Load(stream))
+        return false;
+
+    std::int32_t size = 0;
+    if (!stream.read(reinterpret_cast<char*>(&size), sizeof(size)) || size <= 0 || size > 4096)
+        return false;
+    out_zeroMeanDescriptor.resize(size);
+    return static_cast<bool>(stream.read(reinterpret_cast<char*>(out_zeroMeanDescriptor.data()), size * sizeof(float)));
+}
+
+bool saveHashedDescriptions(const std::string& filepath,
+                            const HashedDescriptions& hashedDescriptions,
+                            std::uint64_t hasherKey,
+                            std::uint64_t descriptorsKey)
+{
+    HashedDescriptionsHeader header;
+    std::memcpy(header.magic, hashedDescriptionsMagic, sizeof(header.magic));
+    header.version = hashedDescriptionsVersion;
+    header.hasherKey = hasherKey;
+    header.descriptorsKey = descriptorsKey;
+    header.nbDescriptions = static_cast<std::uint32_t>(hashedDescriptions.hashed_desc.size());
+    header.nbHashCodeBits = hashedDescriptions.hashed_desc.empty() ? 0 : hashedDescriptions.hashed_desc.front().hash_code.size();
+    header.nbHashCodeBlocks = hashedDescriptions.hashed_desc.empty() ? 0 : hashedDescriptions.hashed_desc.front().hash_code.num_blocks();
+    header.nbBucketGroups = hashedDescriptions.hashed_desc.empty() ? 0 : hashedDescriptions.hashed_desc.front().bucket_ids.size();
+
+    std::string content(sizeof(header) + header.nbDescriptions * (header.nbHashCodeBlocks + header.nbBucketGroups * sizeof(std::uint16_t)), '\0');
+    char* out = &content[0];
+    std::memcpy(out, &header, sizeof(header));
+    out += sizeof(header);
+    for (const HashedDescription& desc : hashedDescriptions.hashed_desc)
+    {
+        std::memcpy(out, desc.hash_code.data(), header.nbHashCodeBlocks);
+        out += header.nbHashCodeBlocks;
+    }
+    for (const HashedDescription& desc : hashedDescriptions.hashed_desc)
+    {
+        std::memcpy(out, desc.bucket_ids.data(), header.nbBucketGroups * sizeof(std::uint16_t));
+        out += header.nbBucketGroups * sizeof(std::uint16_t);
+    }
+    return writeFileAtomically(filepath, content);
+}
+
+bool loadHashedDescriptions(const std::string& filepath,
+                            const CascadeHasher& cascadeHasher,
+                            std::uint64_t hasherKey,
+                            std::uint64_t descriptorsKey,
+                            std::size_t nbDescriptors,
+                            HashedDescriptions& out_hashedDescriptions)
+{
+    boost::system::error_code ec;
+    const std::uintmax_t fileSize = fs::file_size(filepath, ec);
+    if (ec || fileSize < sizeof(HashedDescriptionsHeader))
+        return false;
+
+    boost::interprocess::file_mapping file;
+    boost::interprocess::mapped_region region;
+    try
+    {
+        file = boost::interprocess::file_mapping(filepath.c_str(), boost::interprocess::read_only);
+        region = boost::interprocess::mapped_region(file, boost::interprocess::read_only, 0, fileSize);
+    }
+    catch (const boost::interprocess::interprocess_exception& e)
+    {
+        ALICEVISION_LOG_WARNING("Cannot map the cascade hashing cache file '" << filepath << "': " << e.what());
+        return false;
+    }
+
+    const char* data = static_cast<const char*>(region.get_address());
+    HashedDescriptionsHeader header;
+    std::memcpy(&header, data, sizeof(header));
+
+    // the cached file must come from the same hasher and descriptors
+    if (std::memcmp(header.magic, hashedDescriptionsMagic, sizeof(header.magic)) != 0 || header.version != hashedDescriptionsVersion ||
+        header.hasherKey != hasherKey || header.descriptorsKey != descriptorsKey || header.nbDescriptions != nbDescriptors)
+        return false;
+    if (nbDescriptors > 0 && (header.nbBucketGroups != std::uint32_t(cascadeHasher.NbBucketGroups()) || header.nbHashCodeBits < std::uint32_t(cascadeHasher.NbHashCode()) ||
+                              header.nbHashCodeBlocks != stl::dynamic_bitset(header.nbHashCodeBits).num_blocks()))
+        return false;
+
+    const std::size_t bucketIdsSize = header.nbBucketGroups * sizeof(std::uint16_t);
+    if (fileSize != sizeof(header) + std::uintmax_t(header.nbDescriptions) * (header.nbHashCodeBlocks + bucketIdsSize))
+        return false;
+
+    const char* hashCodes = data + sizeof(header);
+    const char* bucketIds = hashCodes + std::size_t(header.nbDescriptions) * header.nbHashCodeBlocks;
+
+    out_hashedDescriptions.hashed_desc.resize(header.nbDescriptions);
+    for (std::size_t i = 0; i < header.nbDescriptions; ++i)
+    {
+        HashedDescription& desc = out_hashedDescriptions.hashed_desc[i];
+        desc.hash_code = stl::dynamic_bitset(header.nbHashCodeBits);
+        std::memcpy(desc.hash_code.data(), hashCodes + i * header.nbHashCodeBlocks, header.nbHashCodeBlocks);
+        desc.bucket_ids.resize(header.nbBucketGroups);
+        std::memcpy(desc.bucket_ids.data(), bucketIds + i * bucketIdsSize, bucketIdsSize);
+    }
+    cascadeHasher.BuildBuckets(out_hashedDescriptions);
+    return true;
+}
+
+}  // namespace matching
+}  // namespace aliceVision
@@ -0,0 +1,77 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2023 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <aliceVision/matching/CascadeHasher.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace aliceVision {
+namespace matching {
+
+/**
+ * @brief Hash of raw bytes (FNV-1a), used to identify the data a cached file was computed from.
+ * @param[in] data the bytes to hash
+ * @param[in] size the number of bytes
+ * @param[in] seed the hash of the previous bytes, to hash several buffers
+ */
+std::uint64_t hashBytes(const void* data, std::size_t size, std::uint64_t seed = 14695981039346656037ULL);
+
+/**
+ * @brief Identifier of a cascade hasher and of the zero mean descriptor used to center the descriptors.
+ * @note Hashed descriptions can only be compared if they were created with the same key.
+ */
+std::uint64_t getCascadeHasherKey(const CascadeHasher& cascadeHasher, const Eigen::VectorXf& zeroMeanDescriptor);
+
+/**
+ * @brief Save a cascade hasher and its zero mean descriptor.
+ * @note The file is written next to its final path then renamed, so concurrent readers never see a partial file.
+ * @return false if the file cannot be written
+ */
+bool saveCascadeHasher(const std::string& filepath, const CascadeHasher& cascadeHasher, const Eigen::VectorXf& zeroMeanDescriptor);
+
+/**
+ * @brief Load a cascade hasher and its zero mean descriptor saved by saveCascadeHasher.
+ * @return false if the file does not exist or is invalid
+ */
+bool loadCascadeHasher(const std::string& filepath, CascadeHasher& out_cascadeHasher, Eigen::VectorXf& out_zeroMeanDescriptor);
+
+/**
+ * @brief Save the hashed descriptions of an image (primary hash codes and bucket ids).
+ * @param[in] filepath the hashed descriptions file path
+ * @param[in] hashedDescriptions the hashed descriptions
+ * @param[in] hasherKey the key of the hasher used to create the hashed descriptions
+ * @param[in] descriptorsKey the key of the hashed descriptors
+ * @return false if the file cannot be written
+ */
+bool saveHashedDescriptions(const std::string& filepath,
+                            const HashedDescriptions& hashedDescriptions,
+                            std::uint64_t hasherKey,
+                            std::uint64_t descriptorsKey);
+
+/**
+ * @brief Load the hashed descriptions of an image saved by saveHashedDescriptions.
+ * @note The file is memory mapped and the buckets are rebuilt from the bucket ids.
+ * @param[in] filepath the hashed descriptions file path
+ * @param[in] cascadeHasher the current hasher
+ * @param[in] hasherKey the key of the current hasher
+ * @param[in] descriptorsKey the key of the current descriptors
+ * @param[in] nbDescriptors the number of current descriptors
+ * @param[out] out_hashedDescriptions the loaded hashed descriptions
+ * @return false if the file does not exist or was not created from the same hasher and descriptors
+ */
+bool loadHashedDescriptions(const std::string& filepath,
+                            const CascadeHasher& cascadeHasher,
+                            std::uint64_t hasherKey,
+                            std::uint64_t descriptorsKey,
+                            std::size_t nbDescriptors,
+                            HashedDescriptions& out_hashedDescriptions);
+
+}  // namespace matching
+}  // namespace aliceVision
@@ -0,0 +1,76 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2023 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <aliceVision/matching/cascadeHashingCache.hpp>
+
+#include <boost/filesystem.hpp>
+
+#include <random>
+
+#define BOOST_TEST_MODULE cascadeHashingCache
+
+#include <boost/test/unit_test.hpp>
+
+using namespace aliceVision;
+using namespace aliceVision::matching;
+
+namespace fs = boost::filesystem;
+
+typedef Eigen::Matrix<float, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> BaseMat;
+
+BOOST_AUTO_TEST_CASE(cascadeHashingCache_saveLoad)
+{
+    const int dimension = 128;
+    const int nbDescriptors = 300;
+
+    std::mt19937 generator(0);
+    std::uniform_real_distribution<float> distribution(0.f, 1.f);
+    BaseMat descriptors(nbDescriptors, dimension);
+    for (int i = 0; i < descriptors.size(); ++i)
+        descriptors.data()[i] = distribution(generator);
+
+    CascadeHasher hasher;
+    hasher.Init(generator, dimension);
+    const Eigen::VectorXf zeroMean = CascadeHasher::GetZeroMeanDescriptor(descriptors);
+    const HashedDescriptions hashed = hasher.CreateHashedDescriptions(descriptors, zeroMean);
+
+    const fs::path folder = fs::temp_directory_path() / fs::unique_path();
+    fs::create_directories(folder);
+    const std::string hasherPath = (folder / "cascadeHasher.bin").string();
+    const std::string hashesPath = (folder / "0.hash").string();
+
+    // the reloaded hasher has the same key
+    BOOST_CHECK(saveCascadeHasher(hasherPath, hasher, zeroMean));
+    CascadeHasher loadedHasher;
+    Eigen::VectorXf loadedZeroMean;
+    BOOST_CHECK(loadCascadeHasher(hasherPath, loadedHasher, loadedZeroMean));
+    const std::uint64_t hasherKey = getCascadeHasherKey(hasher, zeroMean);
+    BOOST_CHECK_EQUAL(hasherKey, getCascadeHasherKey(loadedHasher, loadedZeroMean));
+
+    const std::uint64_t descriptorsKey = hashBytes(descriptors.data(), descriptors.size() * sizeof(float));
+    BOOST_CHECK(saveHashedDescriptions(hashesPath, hashed, hasherKey, descriptorsKey));
+
+    HashedDescriptions loaded;
+    BOOST_CHECK(loadHashedDescriptions(hashesPath, loadedHasher, hasherKey, descriptorsKey, nbDescriptors, loaded));
+    BOOST_REQUIRE_EQUAL(loaded.hashed_desc.size(), hashed.hashed_desc.size());
+    for (int i = 0; i < nbDescriptors; ++i)
+    {
+        const HashedDescription& a = hashed.hashed_desc[i];
+        const HashedDescription& b = loaded.hashed_desc[i];
+        BOOST_CHECK_EQUAL(a.hash_code.size(), b.hash_code.size());
+        BOOST_CHECK(std::equal(a.hash_code.data(), a.hash_code.data() + a.hash_code.num_blocks(), b.hash_code.data()));
+        BOOST_CHECK(a.bucket_ids == b.bucket_ids);
+    }
+    BOOST_CHECK(loaded.buckets == hashed.buckets);
+
+    // the cache is not used if the descriptors or the hasher change
+    HashedDescriptions invalid;
+    BOOST_CHECK(!loadHashedDescriptions(hashesPath, loadedHasher, hasherKey, descriptorsKey + 1, nbDescriptors, invalid));
+    BOOST_CHECK(!loadHashedDescriptions(hashesPath, loadedHasher, hasherKey + 1, descriptorsKey, nbDescriptors, invalid));
+    BOOST_CHECK(!loadHashedDescriptions((folder / "missing.hash").string(), loadedHasher, hasherKey, descriptorsKey, nbDescriptors, invalid));
+
+    fs::remove_all(folder);
+}
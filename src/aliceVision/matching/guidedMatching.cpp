@@ -7,9 +7,127 @@
 
 #include "guidedMatching.hpp"
 
+#include <algorithm>
+
 namespace aliceVision {
 namespace matching {
 
+namespace {
+
+/// cell index of a coordinate in cells units, clamped to [-1, nbCells] before the integer conversion
+inline int toCell(double v, int nbCells) { return static_cast<int>(std::floor(std::max(-1.0, std::min(double(nbCells), v)))); }
+
+}  // namespace
+
+PointsGrid::PointsGrid(const std::vector<Vec2>& points, int nbPointsPerCell)
+{
+    if (points.empty())
+        return;
+
+    Vec2 pMin = points.front();
+    Vec2 pMax = points.front();
+    for (const Vec2& p : points)
+    {
+        pMin = pMin.cwiseMin(p);
+        pMax = pMax.cwiseMax(p);
+    }
+
+    // square cells with about nbPointsPerCell points per cell for uniformly spread points
+    const Vec2 extent = pMax - pMin;
+    const double area = std::max(extent(0), 1.0) * std::max(extent(1), 1.0);
+    _cellSize = std::max(1.0, std::sqrt(area * std::max(1, nbPointsPerCell) / double(points.size())));
+    _origin = pMin;
+    _nbCellsX = static_cast<int>(extent(0) / _cellSize) + 1;
+    _nbCellsY = static_cast<int>(extent(1) / _cellSize) + 1;
+
+    // counting sort of the points per cell
+    std::vector<IndexT> pointsCells(points.size());
+    _cellsOffsets.assign(_nbCellsX * _nbCellsY + 1, 0);
+    for (std::size_t i = 0; i < points.size(); ++i)
+    {
+        const int cellX = std::min(_nbCellsX - 1, static_cast<int>((points[i](0) - _origin(0)) / _cellSize));
+        const int cellY = std::min(_nbCellsY - 1, static_cast<int>((points[i](1) - _origin(1)) / _cellSize));
+        pointsCells[i] = cellX * _nbCellsY + cellY;
+        ++_cellsOffsets[pointsCells[i] + 1];
+    }
+    for (std::size_t c = 1; c < _cellsOffsets.size(); ++c)
+        _cellsOffsets[c] += _cellsOffsets[c - 1];
+
+    _pointsIds.resize(points.size());
+    std::vector<IndexT> fillPos(_cellsOffsets.begin(), _cellsOffsets.end() - 1);
+    for (std::size_t i = 0; i < points.size(); ++i)
+        _pointsIds[fillPos[pointsCells[i]]++] = static_cast<IndexT>(i);
+}
+
+void PointsGrid::appendCells(int cellX, int cellY0, int cellY1, std::vector<IndexT>& out_candidates) const
+{
+    // the cells of a column are contiguous
+    const int firstCell = cellX * _nbCellsY + cellY0;
+    const int lastCell = cellX * _nbCellsY + cellY1;
+    out_candidates.insert(out_candidates.end(), _pointsIds.begin() + _cellsOffsets[firstCell], _pointsIds.begin() + _cellsOffsets[lastCell + 1]);
+}
+
+void PointsGrid::getCandidatesInBand(const Vec3& line, double halfWidth, std::vector<IndexT>& out_candidates) const
+{
+    if (_pointsIds.empty())
+        return;
+
+    const double norm = line.head<2>().norm();
+    if (!(norm > 0.0) || !std::isfinite(norm))
+        return;
+
+    // normalized line in the grid frame: a.x + b.y + c = 0 with x, y in cells units
+    const double a = line(0) / norm;
+    const double b = line(1) / norm;
+    const double c = (line(2) / norm + a * _origin(0) + b * _origin(1)) / _cellSize;
+    const double w = halfWidth / _cellSize;
+
+    if (std::abs(b) >= std::abs(a))
+    {
+        // mostly horizontal line: for each column of cells, the rows crossed by the band
+        const double dy = w / std::abs(b);
+        for (int cellX = 0; cellX < _nbCellsX; ++cellX)
+        {
+            const double y0 = -(a * cellX + c) / b;
+            const double y1 = -(a * (cellX + 1) + c) / b;
+            const int cellY0 = std::max(0, toCell(std::min(y0, y1) - dy, _nbCellsY));
+            const int cellY1 = std::min(_nbCellsY - 1, toCell(std::max(y0, y1) + dy, _nbCellsY));
+            if (cellY0 <= cellY1)
+                appendCells(cellX, cellY0, cellY1, out_candidates);
+        }
+    }
+    else
+    {
+        // mostly vertical line: the columns crossed by the band for each row of cells
+        const double dx = w / std::abs(a);
+        for (int cellY = 0; cellY < _nbCellsY; ++cellY)
+        {
+            const double x0 = -(b * cellY + c) / a;
+            const double x1 = -(b * (cellY + 1) + c) / a;
+            const int cellX0 = std::max(0, toCell(std::min(x0, x1) - dx, _nbCellsX));
+            const int cellX1 = std::min(_nbCellsX - 1, toCell(std::max(x0, x1) + dx, _nbCellsX));
+            for (int cellX = cellX0; cellX <= cellX1; ++cellX)
+                appendCells(cellX, cellY, cellY, out_candidates);
+        }
+    }
+}
+
+void PointsGrid::getCandidatesInDisc(const Vec2& center, double radius, std::vector<IndexT>& out_candidates) const
+{
+    if (_pointsIds.empty() || !center.allFinite())
+        return;
+
+    const int cellX0 = std::max(0, toCell((center(0) - radius - _origin(0)) / _cellSize, _nbCellsX));
+    const int cellX1 = std::min(_nbCellsX - 1, toCell((center(0) + radius - _origin(0)) / _cellSize, _nbCellsX));
+    const int cellY0 = std::max(0, toCell((center(1) - radius - _origin(1)) / _cellSize, _nbCellsY));
+    const int cellY1 = std::min(_nbCellsY - 1, toCell((center(1) + radius - _origin(1)) / _cellSize, _nbCellsY));
+    if (cellY0 > cellY1)
+        return;
+
+    for (int cellX = cellX0; cellX <= cellX1; ++cellX)
+        appendCells(cellX, cellY0, cellY1, out_candidates);
+}
+
 unsigned int pix_to_bucket(const Vec2i& x, int W, int H)
 {
     if (x(1) == 0)
@@ -12,18 +12,126 @@
 #include <aliceVision/feature/RegionsPerView.hpp>
 #include <aliceVision/feature/Regions.hpp>
 #include <aliceVision/camera/IntrinsicBase.hpp>
+#include <aliceVision/alicevision_omp.hpp>
 
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 namespace aliceVision {
 namespace matching {
 
+/**
+ * @brief Uniform grid over the 2d points of an image, to find the guided matching candidates
+ *        in a band or a disc without testing all the points.
+ * @note The points of each cell are stored in compressed sparse rows, in ascending order.
+ */
+class PointsGrid
+{
+  public:
+    /**
+     * @brief Build the grid with about nbPointsPerCell points per cell on average.
+     */
+    explicit PointsGrid(const std::vector<Vec2>& points, int nbPointsPerCell = 4);
+
+    /**
+     * @brief Get the points of the cells overlapping the band |a.x + b.y + c| <= halfWidth.
+     * @param[in] line the line (a, b, c), not necessarily normalized
+     * @param[in] halfWidth the band half width in pixels
+     * @param[out] out_candidates the candidate points indexes (superset of the points in the band)
+     */
+    void getCandidatesInBand(const Vec3& line, double halfWidth, std::vector<IndexT>& out_candidates) const;
+
+    /**
+     * @brief Get the points of the cells overlapping the disc.
+     * @param[in] center the disc center
+     * @param[in] radius the disc radius in pixels
+     * @param[out] out_candidates the candidate points indexes (superset of the points in the disc)
+     */
+    void getCandidatesInDisc(const Vec2& center, double radius, std::vector<IndexT>& out_candidates) const;
+
+  private:
+    void appendCells(int cellX, int cellY0, int cellY1, std::vector<IndexT>& out_candidates) const;
+
+    Vec2 _origin{0.0, 0.0};
+    double _cellSize = 1.0;
+    int _nbCellsX = 0;
+    int _nbCellsY = 0;
+    /// offsets of each cell in _pointsIds (nbCells + 1 values), cells stored column by column
+    std::vector<IndexT> _cellsOffsets;
+    std::vector<IndexT> _pointsIds;
+};
+
+namespace detail {
+
+/// the error is the squared distance to ErrorT::epipolarLine(model, xLeft)
+template<typename ModelT, typename ErrorT, typename = void>
+struct hasEpipolarLine : std::false_type
+{};
+
+template<typename ModelT, typename ErrorT>
+struct hasEpipolarLine<ModelT, ErrorT, std::void_t<decltype(ErrorT::epipolarLine(std::declval<const ModelT&>(), std::declval<const Vec2&>()))>>
+  : std::true_type
+{};
+
+/// the error is the squared distance to ErrorT::transfer(model, xLeft)
+template<typename ModelT, typename ErrorT, typename = void>
+struct hasTransfer : std::false_type
+{};
+
+template<typename ModelT, typename ErrorT>
+struct hasTransfer<ModelT, ErrorT, std::void_t<decltype(ErrorT::transfer(std::declval<const ModelT&>(), std::declval<const Vec2&>()))>>
+  : std::true_type
+{};
+
+}  // namespace detail
+
+/**
+ * @brief The guided matching can use a PointsGrid if the error gives the area of the valid right points.
+ */
+template<typename ModelT, typename ErrorT>
+constexpr bool hasGuidedMatchingSearchArea()
+{
+    return detail::hasEpipolarLine<ModelT, ErrorT>::value || detail::hasTransfer<ModelT, ErrorT>::value;
+}
+
+/**
+ * @brief Get the right points that may have an error to the model below the threshold.
+ * @note Only valid if hasGuidedMatchingSearchArea<ModelT, ErrorT>().
+ * @param[in] grid the right points grid
+ * @param[in] mod the model
+ * @param[in] xLeft the left point
+ * @param[in] errorTh the squared error threshold
+ * @param[out] out_candidates the right points to test
+ */
+template<typename ModelT, typename ErrorT>
+void getGuidedMatchingCandidates(const PointsGrid& grid, const ModelT& mod, const Vec2& xLeft, double errorTh, std::vector<IndexT>& out_candidates)
+{
+    out_candidates.clear();
+    if constexpr (detail::hasEpipolarLine<ModelT, ErrorT>::value)
+    {
+        grid.getCandidatesInBand(ErrorT::epipolarLine(mod, xLeft), std::sqrt(errorTh), out_candidates);
+    }
+    else if constexpr (detail::hasTransfer<ModelT, ErrorT>::value)
+    {
+        const Vec3 xRight = ErrorT::transfer(mod, xLeft);
+        if (xRight(2) != 0.0)
+            grid.getCandidatesInDisc(xRight.head<2>() / xRight(2), std::sqrt(errorTh), out_candidates);
+    }
+}
+
 /**
  * @brief Guided Matching (features only):
  *        Use a model to find valid correspondences:
  *        Keep the best corresponding points for the given model under the
  *        user specified distance.
  *
+ * @note If the error gives the area of the valid right points, only the right points
+ *       of this area are tested. The left points are processed in parallel.
+ *
  * @tparam ModelT The used model type
  * @tparam ErrorT The metric to compute distance to the model
  *
@@ -39,30 +147,58 @@ void guidedMatching(const ModelT& mod, const Mat& xLeft, const Mat& xRight, doub
     assert(xLeft.rows() == xRight.rows());
 
     const ErrorT errorEstimator = ErrorT();
+    const Mat::Index nbLeft = xLeft.cols();
+    const Mat::Index nbRight = xRight.cols();
 
-    // looking for the corresponding points that have
-    // the smallest distance (smaller than the provided Threshold)
-    for (Mat::Index i = 0; i < xLeft.cols(); ++i)
+    std::vector<Vec2> rightPoints(nbRight);
+    for (Mat::Index j = 0; j < nbRight; ++j)
+        rightPoints[j] = xRight.col(j);
+    const PointsGrid grid(rightPoints);
+
+    // best right point of each left point, in the left points order whatever the threads
+    std::vector<IndexT> bestRight(nbLeft, UndefinedIndexT);
+
+#pragma omp parallel
     {
-        double min = std::numeric_limits<double>::max();
-        matching::IndMatch match;
-        for (Mat::Index j = 0; j < xRight.cols(); ++j)
+        std::vector<IndexT> candidates;
+
+        // looking for the corresponding points that have
+        // the smallest distance (smaller than the provided Threshold)
+#pragma omp for schedule(dynamic, 256)
+        for (Mat::Index i = 0; i < nbLeft; ++i)
         {
-            // compute the geometric error: error to the model
-            const double err = errorEstimator.error(mod, xLeft.col(i), xRight.col(j));
+            const Vec2 xL = xLeft.col(i);
+            if (hasGuidedMatchingSearchArea<ModelT, ErrorT>())
+            {
+                getGuidedMatchingCandidates<ModelT, ErrorT>(grid, mod, xL, errorTh, candidates);
+            }
+            else
+            {
+                candidates.resize(nbRight);
+                std::iota(candidates.begin(), candidates.end(), IndexT(0));
+            }
 
-            // if smaller error update corresponding index
-            if (err < errorTh && err < min)
+            double min = std::numeric_limits<double>::max();
+            for (const IndexT j : candidates)
             {
-                min = err;
-                match = matching::IndMatch(i, j);
+                // compute the geometric error: error to the model
+                const double err = errorEstimator.error(mod, xL, rightPoints[j]);
+
+                // if smaller error update corresponding index
+                if (err < errorTh && err < min)
+                {
+                    min = err;
+                    bestRight[i] = j;
+                }
             }
         }
-        if (min < errorTh)
-        {
-            // save the best corresponding index
-            out_validMatches.push_back(match);
-        }
+    }
+
+    for (Mat::Index i = 0; i < nbLeft; ++i)
+    {
+        // save the best corresponding index
+        if (bestRight[i] != UndefinedIndexT)
+            out_validMatches.emplace_back(i, bestRight[i]);
     }
 
     // remove duplicates (when multiple points at same position exist)
@@ -205,6 +341,9 @@ void guidedMatching(const ModelT& mod,
  * @param[in] errorTh Maximal authorized error threshold
  * @param[in] distRatio Maximal authorized distance ratio
  * @param[out] out_matches Ouput corresponding index
+ *
+ * @note If the error gives the area of the valid right points (epipolar band or disc around the transfer),
+ *       only the right points of this area are tested. The left points are processed in parallel.
  */
 template<typename ModelT, typename ErrorT>
 void guidedMatching(const ModelT& mod,
@@ -247,26 +386,53 @@ void guidedMatching(const ModelT& mod,
             rRegionsPos[i] = rRegions.GetRegionPosition(i);
     }
 
-    for (std::size_t i = 0; i < lRegions.RegionCount(); ++i)
+    const PointsGrid grid(rRegionsPos);
+    const std::size_t nbLeft = lRegions.RegionCount();
+    const std::size_t nbRight = rRegions.RegionCount();
+
+    // best right point of each left point, in the left points order whatever the threads
+    std::vector<IndexT> bestRight(nbLeft, UndefinedIndexT);
+
+#pragma omp parallel
     {
-        distanceRatio<double> dR;
-        for (std::size_t j = 0; j < rRegions.RegionCount(); ++j)
+        std::vector<IndexT> candidates;
+
+#pragma omp for schedule(dynamic, 256)
+        for (int i = 0; i < static_cast<int>(nbLeft); ++i)
         {
-            // compute the geometric error: error to the model
-            const double geomErr = errorEstimator.error(mod, lRegionsPos[i], rRegionsPos[j]);
+            if (hasGuidedMatchingSearchArea<ModelT, ErrorT>())
+            {
+                getGuidedMatchingCandidates<ModelT, ErrorT>(grid, mod, lRegionsPos[i], errorTh, candidates);
+            }
+            else
+            {
+                candidates.resize(nbRight);
+                std::iota(candidates.begin(), candidates.end(), IndexT(0));
+            }
 
-            if (geomErr < errorTh)
+            distanceRatio<double> dR;
+            for (const IndexT j : candidates)
             {
-                // update the corresponding points & distance (if required)
-                dR.update(j, lRegions.SquaredDescriptorDistance(i, &rRegions, j));
+                // compute the geometric error: error to the model
+                const double geomErr = errorEstimator.error(mod, lRegionsPos[i], rRegionsPos[j]);
+
+                if (geomErr < errorTh)
+                {
+                    // update the corresponding points & distance (if required)
+                    dR.update(j, lRegions.SquaredDescriptorDistance(i, &rRegions, j));
+                }
             }
+            // add correspondence only iff the distance ratio is valid
+            if (dR.isValid(distRatio))
+                bestRight[i] = static_cast<IndexT>(dR.idx);
         }
-        // add correspondence only iff the distance ratio is valid
-        if (dR.isValid(distRatio))
-        {
-            // save the best corresponding index
-            out_matches.emplace_back(i, dR.idx);
-        }
+    }
+
+    for (std::size_t i = 0; i < nbLeft; ++i)
+    {
+        // save the best corresponding index
+        if (bestRight[i] != UndefinedIndexT)
+            out_matches.emplace_back(i, bestRight[i]);
     }
 
     // remove duplicates (when multiple points at same position exist)
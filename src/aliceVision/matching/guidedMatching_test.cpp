@@ -0,0 +1,131 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2023 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <aliceVision/matching/guidedMatching.hpp>
+
+#include <random>
+#include <set>
+
+#define BOOST_TEST_MODULE matchingGuidedMatching
+
+#include <boost/test/unit_test.hpp>
+
+using namespace aliceVision;
+using namespace aliceVision::matching;
+
+namespace {
+
+struct TestModel
+{
+    Mat3 M;
+};
+
+/// squared distance of x2 to the line M.x1, searched in the epipolar band
+struct LineError
+{
+    double error(const TestModel& mod, const Vec2& x1, const Vec2& x2) const
+    {
+        const Vec3 l = epipolarLine(mod, x1);
+        return Square(l.dot(Vec3(x2(0), x2(1), 1.0))) / l.head<2>().squaredNorm();
+    }
+
+    static Vec3 epipolarLine(const TestModel& mod, const Vec2& x1) { return mod.M * Vec3(x1(0), x1(1), 1.0); }
+};
+
+struct LineErrorBruteForce
+{
+    double error(const TestModel& mod, const Vec2& x1, const Vec2& x2) const { return LineError().error(mod, x1, x2); }
+};
+
+/// squared distance of x2 to the transfer M.x1, searched around the transfer
+struct TransferError
+{
+    double error(const TestModel& mod, const Vec2& x1, const Vec2& x2) const
+    {
+        const Vec3 x = transfer(mod, x1);
+        return (x2 - x.head<2>() / x(2)).squaredNorm();
+    }
+
+    static Vec3 transfer(const TestModel& mod, const Vec2& x1) { return mod.M * Vec3(x1(0), x1(1), 1.0); }
+};
+
+struct TransferErrorBruteForce
+{
+    double error(const TestModel& mod, const Vec2& x1, const Vec2& x2) const { return TransferError().error(mod, x1, x2); }
+};
+
+Mat randomPoints(std::mt19937& generator, int nbPoints)
+{
+    std::uniform_real_distribution<double> distX(0.0, 1000.0);
+    std::uniform_real_distribution<double> distY(0.0, 700.0);
+    Mat points(2, nbPoints);
+    for (int i = 0; i < nbPoints; ++i)
+        points.col(i) << distX(generator), distY(generator);
+    return points;
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(guidedMatching_pointsGrid_band)
+{
+    std::mt19937 generator(42);
+    const Mat points = randomPoints(generator, 2000);
+    std::vector<Vec2> pointsVec(points.cols());
+    for (int i = 0; i < points.cols(); ++i)
+        pointsVec[i] = points.col(i);
+    const PointsGrid grid(pointsVec);
+
+    std::uniform_real_distribution<double> dist(-1.0, 1.0);
+    std::vector<IndexT> candidates;
+    for (int t = 0; t < 50; ++t)
+    {
+        const Vec3 line(dist(generator), dist(generator), 500.0 * dist(generator));
+        const double halfWidth = 5.0;
+        candidates.clear();
+        grid.getCandidatesInBand(line, halfWidth, candidates);
+        const std::set<IndexT> candidatesSet(candidates.begin(), candidates.end());
+        BOOST_CHECK_EQUAL(candidatesSet.size(), candidates.size());
+
+        // all the points of the band are candidates
+        for (int i = 0; i < points.cols(); ++i)
+        {
+            const double d = std::abs(line.dot(Vec3(points(0, i), points(1, i), 1.0))) / line.head<2>().norm();
+            if (d <= halfWidth)
+                BOOST_CHECK(candidatesSet.count(i));
+        }
+        BOOST_CHECK_LT(candidates.size(), points.cols());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(guidedMatching_sameAsBruteForce)
+{
+    std::mt19937 generator(42);
+    const Mat xLeft = randomPoints(generator, 3000);
+    const Mat xRight = randomPoints(generator, 3000);
+
+    TestModel mod;
+    mod.M << 0.01, 0.002, -3.0, -0.003, 0.005, 2.0, 0.001, -0.004, 1.0;
+
+    const double errorTh = Square(4.0);
+
+    {
+        IndMatches matches, matchesBruteForce;
+        guidedMatching<TestModel, LineError>(mod, xLeft, xRight, errorTh, matches);
+        guidedMatching<TestModel, LineErrorBruteForce>(mod, xLeft, xRight, errorTh, matchesBruteForce);
+        BOOST_CHECK(!matches.empty());
+        BOOST_CHECK(matches == matchesBruteForce);
+    }
+
+    // homography like transfer
+    mod.M << 1.01, 0.02, 3.0, -0.01, 0.99, -2.0, 1e-6, -2e-6, 1.0;
+    {
+        IndMatches matches, matchesBruteForce;
+        guidedMatching<TestModel, TransferError>(mod, xLeft, xRight, Square(20.0), matches);
+        guidedMatching<TestModel, TransferErrorBruteForce>(mod, xLeft, xRight, Square(20.0), matchesBruteForce);
+        BOOST_CHECK(!matches.empty());
+        BOOST_CHECK(matches == matchesBruteForce);
+    }
+}
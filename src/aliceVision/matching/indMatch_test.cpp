@@ -108,6 +108,71 @@ BOOST_AUTO_TEST_CASE(IndMatch_IO)
     boost::filesystem::remove_all(testFolder);
 }
 
+BOOST_AUTO_TEST_CASE(IndMatch_IO_BINARY)
+{
+    const std::string testFolder = "matchingBinTest";
+    boost::filesystem::create_directory(testFolder);
+    {
+        std::set<IndexT> viewsKeys;
+        PairwiseMatches matches;
+
+        // Test save + load of empty data
+        BOOST_CHECK(Save(matches, testFolder, "bin", false));
+        BOOST_CHECK(Load(matches, viewsKeys, {testFolder}, {}));
+        BOOST_CHECK_EQUAL(0, matches.size());
+    }
+    boost::filesystem::remove_all(testFolder);
+    boost::filesystem::create_directory(testFolder);
+    {
+        std::set<IndexT> viewsKeys = {0, 1, 2};
+        PairwiseMatches matches;
+        // Test export with not empty data, including non-monotonic and large feature indices
+        matches[std::make_pair(0, 1)][EImageDescriberType::UNKNOWN] = {{10, 3}, {2, 4000000000u}, {7, 0}};
+        matches[std::make_pair(0, 1)][EImageDescriberType::SIFT] = {{5, 5}};
+        matches[std::make_pair(1, 2)][EImageDescriberType::UNKNOWN] = {{0, 0}, {1, 1}, {2, 2}};
+        const PairwiseMatches savedMatches = matches;
+
+        BOOST_CHECK(Save(matches, testFolder, "bin", false));
+        matches.clear();
+        BOOST_CHECK(Load(matches, viewsKeys, {testFolder}, {}));
+        BOOST_CHECK_EQUAL(2, matches.size());
+
+        for (const auto& pairMatches : savedMatches)
+        {
+            for (const auto& descMatches : pairMatches.second)
+            {
+                const IndMatches& loaded = matches.at(pairMatches.first).at(descMatches.first);
+                BOOST_CHECK_EQUAL(descMatches.second.size(), loaded.size());
+                for (std::size_t i = 0; i < loaded.size(); ++i)
+                    BOOST_CHECK_EQUAL(descMatches.second[i], loaded[i]);
+            }
+        }
+
+        // Random access to a single pair
+        PairwiseMatches pairMatches;
+        BOOST_CHECK(LoadMatchFilePairs(pairMatches, (fs::path(testFolder) / "matches.bin").string(), {std::make_pair(1, 2)}));
+        BOOST_CHECK_EQUAL(1, pairMatches.size());
+        BOOST_CHECK_EQUAL(3, pairMatches.at(std::make_pair(1, 2)).at(EImageDescriberType::UNKNOWN).size());
+    }
+    boost::filesystem::remove_all(testFolder);
+    boost::filesystem::create_directory(testFolder);
+    {
+        std::set<IndexT> viewsKeys = {0, 1, 2};
+        PairwiseMatches matches;
+        matches[std::make_pair(0, 1)][EImageDescriberType::UNKNOWN] = {{0, 0}, {1, 1}};
+        matches[std::make_pair(1, 2)][EImageDescriberType::UNKNOWN] = {{0, 0}, {1, 1}, {2, 2}};
+
+        // Test one file per image
+        BOOST_CHECK(Save(matches, testFolder, "bin", true));
+        matches.clear();
+        BOOST_CHECK(Load(matches, viewsKeys, {testFolder}, {EImageDescriberType::UNKNOWN}));
+        BOOST_CHECK_EQUAL(2, matches.size());
+        BOOST_CHECK_EQUAL(2, matches.at(std::make_pair(0, 1)).at(EImageDescriberType::UNKNOWN).size());
+        BOOST_CHECK_EQUAL(3, matches.at(std::make_pair(1, 2)).at(EImageDescriberType::UNKNOWN).size());
+    }
+    boost::filesystem::remove_all(testFolder);
+}
+
 BOOST_AUTO_TEST_CASE(IndMatch_DuplicateRemoval_NoRemoval)
 {
     std::vector<IndMatch> vec_indMatch;
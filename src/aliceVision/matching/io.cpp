@@ -9,10 +9,14 @@
 #include <aliceVision/matching/IndMatch.hpp>
 #include <aliceVision/config.hpp>
 #include <aliceVision/system/Logger.hpp>
+#include <aliceVision/system/Storage.hpp>
+#include <aliceVision/alicevision_omp.hpp>
 
 #include <boost/filesystem.hpp>
-#include <boost/range/iterator_range.hpp>
 
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
 #include <map>
 #include <fstream>
 #include <iterator>
@@ -24,60 +28,284 @@ namespace fs = boost::filesystem;
 namespace aliceVision {
 namespace matching {
 
-bool LoadMatchFile(PairwiseMatches& matches, const std::string& filepath)
+namespace {
+
+// Binary matches file (.bin):
+//   header:  magic (8 bytes), version (uint32), reserved (uint32), nbPairs (uint64)
+//   index:   nbPairs x { I (uint32), J (uint32), offset (uint64), size (uint64) }
+//   blocks:  for each pair, at the given offset from the beginning of the file:
+//            nbDescType, then for each descType: name length, name, nbMatches
+//            and the matches as zigzag delta-encoded feature indices.
+//   All integers in blocks are stored as LEB128 varints.
+
+const char matchesBinMagic[8] = {'A', 'V', 'M', 'T', 'C', 'H', 'B', '\0'};
+const std::uint32_t matchesBinVersion = 1;
+
+struct MatchesBinHeader
 {
-    const std::string ext = fs::extension(filepath);
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t reserved;
+    std::uint64_t nbPairs;
+};
+
+struct MatchesBinIndexEntry
+{
+    std::uint32_t I;
+    std::uint32_t J;
+    std::uint64_t offset;
+    std::uint64_t size;
+};
+
+static_assert(sizeof(MatchesBinHeader) == 24, "The binary matches file header must be packed.");
+static_assert(sizeof(MatchesBinIndexEntry) == 24, "The binary matches file index entries must be packed.");
+
+inline void writeVarint(std::string& buffer, std::uint64_t value)
+{
+    while (value >= 0x80)
+    {
+        buffer.push_back(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    buffer.push_back(static_cast<char>(value));
+}
+
+inline bool readVarint(const char*& ptr, const char* end, std::uint64_t& value)
+{
+    value = 0;
+    for (int shift = 0; shift < 64 && ptr < end; shift += 7)
+    {
+        const std::uint8_t byte = static_cast<std::uint8_t>(*ptr++);
+        value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+        if (!(byte & 0x80))
+            return true;
+    }
+    return false;
+}
+
+inline std::uint64_t zigzagEncode(std::int64_t value) { return (static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63); }
+
+inline std::int64_t zigzagDecode(std::uint64_t value) { return static_cast<std::int64_t>(value >> 1) ^ -static_cast<std::int64_t>(value & 1); }
 
-    if (!fs::exists(filepath))
+void encodeMatchesBinBlock(std::string& buffer, const MatchesPerDescType& matchesPerDesc)
+{
+    writeVarint(buffer, matchesPerDesc.size());
+    for (const auto& m : matchesPerDesc)
+    {
+        const std::string descTypeStr = feature::EImageDescriberType_enumToString(m.first);
+        writeVarint(buffer, descTypeStr.size());
+        buffer.append(descTypeStr);
+        writeVarint(buffer, m.second.size());
+
+        std::int64_t prevI = 0;
+        std::int64_t prevJ = 0;
+        for (const IndMatch& match : m.second)
+        {
+            writeVarint(buffer, zigzagEncode(static_cast<std::int64_t>(match._i) - prevI));
+            writeVarint(buffer, zigzagEncode(static_cast<std::int64_t>(match._j) - prevJ));
+            prevI = match._i;
+            prevJ = match._j;
+        }
+    }
+}
+
+bool decodeMatchesBinBlock(const char* ptr, const char* end, MatchesPerDescType& matchesPerDesc)
+{
+    std::uint64_t nbDescType = 0;
+    if (!readVarint(ptr, end, nbDescType))
         return false;
 
-    if (ext == ".txt")
+    for (std::uint64_t d = 0; d < nbDescType; ++d)
     {
-        std::ifstream stream(filepath);
-        if (!stream.is_open())
+        std::uint64_t descTypeLength = 0;
+        if (!readVarint(ptr, end, descTypeLength) || descTypeLength > static_cast<std::uint64_t>(end - ptr))
             return false;
+        const std::string descTypeStr(ptr, descTypeLength);
+        ptr += descTypeLength;
+
+        std::uint64_t nbMatches = 0;
+        if (!readVarint(ptr, end, nbMatches) || nbMatches > static_cast<std::uint64_t>(end - ptr))
+            return false;
+
+        IndMatches& matchesVec = matchesPerDesc[feature::EImageDescriberType_stringToEnum(descTypeStr)];
+        matchesVec.resize(nbMatches);
 
-        // Read from the text file
-        // I J
-        // nbDescType
-        // descType matchesCount
-        // idx idx
-        // ...
-        // descType matchesCount
-        // idx idx
-        // ...
-        std::size_t I = 0;
-        std::size_t J = 0;
-        std::size_t nbDescType = 0;
-        while (stream >> I >> J >> nbDescType)
+        std::int64_t prevI = 0;
+        std::int64_t prevJ = 0;
+        for (IndMatch& match : matchesVec)
         {
-            for (std::size_t i = 0; i < nbDescType; ++i)
-            {
-                std::string descTypeStr;
-                std::size_t nbMatches = 0;
-                // Read descType and number of matches
-                stream >> descTypeStr >> nbMatches;
-
-                feature::EImageDescriberType descType = feature::EImageDescriberType_stringToEnum(descTypeStr);
-                std::vector<IndMatch> matchesPerDesc(nbMatches);
-                // Read all matches
-                for (std::size_t i = 0; i < nbMatches; ++i)
-                {
-                    stream >> matchesPerDesc[i];
-                }
-                matches[std::make_pair(I, J)][descType] = std::move(matchesPerDesc);
-            }
+            std::uint64_t deltaI = 0;
+            std::uint64_t deltaJ = 0;
+            if (!readVarint(ptr, end, deltaI) || !readVarint(ptr, end, deltaJ))
+                return false;
+            prevI += zigzagDecode(deltaI);
+            prevJ += zigzagDecode(deltaJ);
+            match._i = static_cast<IndexT>(prevI);
+            match._j = static_cast<IndexT>(prevJ);
         }
-        stream.close();
-        return true;
     }
-    else
+    return true;
+}
+
+bool readMatchesBinIndex(std::ifstream& stream, std::vector<MatchesBinIndexEntry>& index, const std::string& filepath)
+{
+    MatchesBinHeader header;
+    stream.read(reinterpret_cast<char*>(&header), sizeof(MatchesBinHeader));
+    if (!stream || std::memcmp(header.magic, matchesBinMagic, sizeof(matchesBinMagic)) != 0)
+    {
+        ALICEVISION_LOG_WARNING("Invalid binary matches file: " << filepath);
+        return false;
+    }
+    if (header.version > matchesBinVersion)
+    {
+        ALICEVISION_LOG_WARNING("Unsupported binary matches file version (" << header.version << "): " << filepath);
+        return false;
+    }
+
+    index.resize(header.nbPairs);
+    stream.read(reinterpret_cast<char*>(index.data()), index.size() * sizeof(MatchesBinIndexEntry));
+    if (!stream)
+    {
+        ALICEVISION_LOG_WARNING("Invalid binary matches file index: " << filepath);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Visit the matches of a binary match file, pair by pair.
+ * @param[in] filepath the binary match file to load
+ * @param[in] pairsFilter if not empty, only visit these pairs (using the per-pair index)
+ * @param[in] visitor function called for each loaded pair
+ */
+bool visitMatchBinFile(const std::string& filepath, const PairSet& pairsFilter, const PairMatchesVisitor& visitor)
+{
+    std::ifstream stream(filepath, std::ios::in | std::ios::binary);
+    if (!stream.is_open())
+        return false;
+
+    std::vector<MatchesBinIndexEntry> index;
+    if (!readMatchesBinIndex(stream, index, filepath))
+        return false;
+
+    std::string block;
+    for (const MatchesBinIndexEntry& entry : index)
+    {
+        const Pair pair(entry.I, entry.J);
+        if (!pairsFilter.empty() && pairsFilter.count(pair) == 0)
+            continue;
+
+        block.resize(entry.size);
+        stream.seekg(entry.offset);
+        stream.read(&block[0], entry.size);
+
+        MatchesPerDescType matchesPerDesc;
+        if (!stream || !decodeMatchesBinBlock(block.data(), block.data() + block.size(), matchesPerDesc))
+        {
+            ALICEVISION_LOG_WARNING("Invalid binary matches block for pair (" << entry.I << ", " << entry.J << "): " << filepath);
+            return false;
+        }
+        visitor(pair, matchesPerDesc);
+    }
+    return true;
+}
+
+/**
+ * @brief Visit the matches of a text match file, pair by pair.
+ * @param[in] filepath the text match file to load
+ * @param[in] visitor function called for each loaded pair
+ */
+bool visitMatchTxtFile(const std::string& filepath, const PairMatchesVisitor& visitor)
+{
+    std::ifstream stream(filepath);
+    if (!stream.is_open())
+        return false;
+
+    // Read from the text file
+    // I J
+    // nbDescType
+    // descType matchesCount
+    // idx idx
+    // ...
+    // descType matchesCount
+    // idx idx
+    // ...
+    std::size_t I = 0;
+    std::size_t J = 0;
+    std::size_t nbDescType = 0;
+    while (stream >> I >> J >> nbDescType)
     {
-        ALICEVISION_LOG_WARNING("Unknown matching file format: " << ext);
+        MatchesPerDescType matchesPerDescType;
+        for (std::size_t i = 0; i < nbDescType; ++i)
+        {
+            std::string descTypeStr;
+            std::size_t nbMatches = 0;
+            // Read descType and number of matches
+            stream >> descTypeStr >> nbMatches;
+
+            feature::EImageDescriberType descType = feature::EImageDescriberType_stringToEnum(descTypeStr);
+            std::vector<IndMatch> matchesPerDesc(nbMatches);
+            // Read all matches
+            for (std::size_t i = 0; i < nbMatches; ++i)
+            {
+                stream >> matchesPerDesc[i];
+            }
+            matchesPerDescType[descType] = std::move(matchesPerDesc);
+        }
+        visitor(std::make_pair(I, J), matchesPerDescType);
     }
+    stream.close();
+    return true;
+}
+
+/// Visitor that stores the visited pairs into \p matches
+PairMatchesVisitor storeMatchesVisitor(PairwiseMatches& matches)
+{
+    return [&matches](const Pair& pair, MatchesPerDescType& matchesPerDesc) {
+        for (auto& descMatches : matchesPerDesc)
+            matches[pair][descMatches.first] = std::move(descMatches.second);
+    };
+}
+
+}  // namespace
+
+bool VisitMatchFile(const std::string& filepath, const PairMatchesVisitor& visitor)
+{
+    const std::string ext = fs::extension(filepath);
+
+    if (!system::storageFileExists(filepath))
+        return false;
+
+    // a remote file is read from its copy in the local cache
+    const std::string localFilepath = system::getStorageLocalPath(filepath);
+
+    if (ext == ".bin")
+        return visitMatchBinFile(localFilepath, PairSet(), visitor);
+    else if (ext == ".txt")
+        return visitMatchTxtFile(localFilepath, visitor);
+
+    ALICEVISION_LOG_WARNING("Unknown matching file format: " << ext);
     return false;
 }
 
+bool LoadMatchFile(PairwiseMatches& matches, const std::string& filepath) { return VisitMatchFile(filepath, storeMatchesVisitor(matches)); }
+
+bool LoadMatchFilePairs(PairwiseMatches& matches, const std::string& filepath, const PairSet& pairs)
+{
+    if (!system::storageFileExists(filepath))
+        return false;
+
+    const PairMatchesVisitor storeVisitor = storeMatchesVisitor(matches);
+
+    if (fs::extension(filepath) == ".bin")
+        return visitMatchBinFile(system::getStorageLocalPath(filepath), pairs, storeVisitor);
+
+    return VisitMatchFile(filepath, [&](const Pair& pair, MatchesPerDescType& matchesPerDesc) {
+        if (pairs.count(pair))
+            storeVisitor(pair, matchesPerDesc);
+    });
+}
+
 void filterMatchesByViews(PairwiseMatches& matches, const std::set<IndexT>& viewsKeys)
 {
     matching::PairwiseMatches filteredMatches;
@@ -164,25 +392,43 @@ std::size_t LoadMatchFilePerImage(PairwiseMatches& matches,
 }
 
 /**
- * Load and add pair-wise matches to \p matches from all files in \p folder matching \p pattern.
- * @param[out] matches PairwiseMatches to add loaded matches to
- * @param[in] folder Folder to load matches files from
- * @param[in] pattern Pattern that files must respect to be loaded
+ * List all files in \p folder matching (i.e containing) one of the \p patterns.
+ * @param[in] folder Folder to list matches files from
+ * @param[in] patterns Patterns that files must respect to be listed
  */
-std::size_t loadMatchesFromFolder(PairwiseMatches& matches, const std::string& folder, const std::string& pattern)
+std::vector<std::string> listMatchFilesInFolder(const std::string& folder, const std::vector<std::string>& patterns)
 {
-    std::size_t nbLoadedMatchFiles = 0;
     std::vector<std::string> matchFiles;
-    // list all matches files in 'folder' matching (i.e containing) 'pattern'
-    for (const auto& entry : boost::make_iterator_range(fs::directory_iterator(folder), {}))
+    for (const std::string& path : system::storageListFolder(folder))
     {
-        if (entry.path().string().find(pattern) != std::string::npos)
+        for (const std::string& pattern : patterns)
         {
-            matchFiles.push_back(entry.path().string());
+            if (path.find(pattern) != std::string::npos)
+            {
+                matchFiles.push_back(path);
+                break;
+            }
         }
     }
+    return matchFiles;
+}
 
-#pragma omp parallel for num_threads(3)
+/**
+ * Load and add pair-wise matches to \p matches from all files in \p folder matching one of the \p patterns.
+ * @param[out] matches PairwiseMatches to add loaded matches to
+ * @param[in] folder Folder to load matches files from
+ * @param[in] patterns Patterns that files must respect to be loaded
+ */
+std::size_t loadMatchesFromFolder(PairwiseMatches& matches, const std::string& folder, const std::vector<std::string>& patterns)
+{
+    std::size_t nbLoadedMatchFiles = 0;
+    const std::vector<std::string> matchFiles = listMatchFilesInFolder(folder, patterns);
+
+    // binary files are cheap to decode, load them with all the available threads
+    const bool allBinary = std::all_of(matchFiles.begin(), matchFiles.end(), [](const std::string& f) { return fs::extension(f) == ".bin"; });
+    const int nbThreads = allBinary ? omp_get_max_threads() : std::min(3, omp_get_max_threads());
+
+#pragma omp parallel for num_threads(nbThreads) schedule(dynamic)
     for (int i = 0; i < matchFiles.size(); ++i)
     {
         const std::string& matchFile = matchFiles[i];
@@ -217,29 +463,53 @@ std::size_t loadMatchesFromFolder(PairwiseMatches& matches, const std::string& f
     return nbLoadedMatchFiles;
 }
 
-bool Load(PairwiseMatches& matches,
-          const std::set<IndexT>& viewsKeysFilter,
-          const std::vector<std::string>& folders,
-          const std::vector<feature::EImageDescriberType>& descTypesFilter,
-          int maxNbMatches,
-          int minNbMatches)
-{
-    std::size_t nbLoadedMatchFiles = 0;
-    const std::string pattern = "matches.txt";
+namespace {
+
+const std::vector<std::string> matchFilesPatterns = {"matches.txt", "matches.bin"};
 
-    // build up a set with normalized paths to remove duplicates
+/// Build up a set with normalized paths to remove duplicates
+std::set<std::string> getNormalizedFolders(const std::vector<std::string>& folders)
+{
     std::set<std::string> foldersSet;
     for (const auto& folder : folders)
     {
-        if (fs::exists(folder))
+        if (system::isRemotePath(folder))
+        {
+            foldersSet.insert(folder);
+        }
+        else if (fs::exists(folder))
         {
             foldersSet.insert(fs::canonical(folder).string());
         }
     }
+    return foldersSet;
+}
+
+}  // namespace
+
+std::vector<std::string> ListMatchFiles(const std::vector<std::string>& folders)
+{
+    std::vector<std::string> matchFiles;
+    for (const auto& folder : getNormalizedFolders(folders))
+    {
+        const std::vector<std::string> folderMatchFiles = listMatchFilesInFolder(folder, matchFilesPatterns);
+        matchFiles.insert(matchFiles.end(), folderMatchFiles.begin(), folderMatchFiles.end());
+    }
+    return matchFiles;
+}
+
+bool Load(PairwiseMatches& matches,
+          const std::set<IndexT>& viewsKeysFilter,
+          const std::vector<std::string>& folders,
+          const std::vector<feature::EImageDescriberType>& descTypesFilter,
+          int maxNbMatches,
+          int minNbMatches)
+{
+    std::size_t nbLoadedMatchFiles = 0;
 
-    for (const auto& folder : foldersSet)
+    for (const auto& folder : getNormalizedFolders(folders))
     {
-        nbLoadedMatchFiles += loadMatchesFromFolder(matches, folder, pattern);
+        nbLoadedMatchFiles += loadMatchesFromFolder(matches, folder, matchFilesPatterns);
     }
 
     if (!nbLoadedMatchFiles)
@@ -302,6 +572,61 @@ class MatchExporter
         fs::rename(tmpPath, filepath);
     }
 
+    void saveBin(const std::string& filepath, const PairwiseMatches::const_iterator& matchBegin, const PairwiseMatches::const_iterator& matchEnd)
+    {
+        const fs::path bPath = fs::path(filepath);
+        const std::string tmpPath = (bPath.parent_path() / bPath.stem()).string() + "." + fs::unique_path().string() + bPath.extension().string();
+
+        const std::size_t nbPairs = std::distance(matchBegin, matchEnd);
+
+        // encode all pair blocks and build the per-pair index
+        std::vector<MatchesBinIndexEntry> index;
+        index.reserve(nbPairs);
+        std::string blocks;
+        std::uint64_t offset = sizeof(MatchesBinHeader) + nbPairs * sizeof(MatchesBinIndexEntry);
+        for (PairwiseMatches::const_iterator match = matchBegin; match != matchEnd; ++match)
+        {
+            const std::size_t blockBegin = blocks.size();
+            encodeMatchesBinBlock(blocks, match->second);
+
+            MatchesBinIndexEntry entry;
+            entry.I = match->first.first;
+            entry.J = match->first.second;
+            entry.offset = offset + blockBegin;
+            entry.size = blocks.size() - blockBegin;
+            index.push_back(entry);
+        }
+
+        MatchesBinHeader header;
+        std::memcpy(header.magic, matchesBinMagic, sizeof(matchesBinMagic));
+        header.version = matchesBinVersion;
+        header.reserved = 0;
+        header.nbPairs = nbPairs;
+
+        // write temporary file
+        {
+            std::ofstream stream(tmpPath, std::ios::out | std::ios::binary);
+            stream.write(reinterpret_cast<const char*>(&header), sizeof(MatchesBinHeader));
+            stream.write(reinterpret_cast<const char*>(index.data()), index.size() * sizeof(MatchesBinIndexEntry));
+            stream.write(blocks.data(), blocks.size());
+            if (!stream.good())
+                throw std::runtime_error("Can't save binary matches file: " + tmpPath);
+        }
+
+        // rename temporary file
+        fs::rename(tmpPath, filepath);
+    }
+
+    void save(const std::string& filepath, const PairwiseMatches::const_iterator& matchBegin, const PairwiseMatches::const_iterator& matchEnd)
+    {
+        if (m_ext == ".txt")
+            saveTxt(filepath, matchBegin, matchEnd);
+        else if (m_ext == ".bin")
+            saveBin(filepath, matchBegin, matchEnd);
+        else
+            throw std::runtime_error(std::string("Unknown matching file format: ") + m_ext);
+    }
+
   public:
     MatchExporter(const PairwiseMatches& matches, const std::string& folder, const std::string& filename)
       : m_matches(matches),
@@ -316,10 +641,7 @@ class MatchExporter
     {
         const std::string filepath = (fs::path(m_directory) / m_filename).string();
 
-        if (m_ext == ".txt")
-            saveTxt(filepath, m_matches.begin(), m_matches.end());
-        else
-            throw std::runtime_error(std::string("Unknown matching file format: ") + m_ext);
+        save(filepath, m_matches.begin(), m_matches.end());
     }
 
     /// Export matches into separate files, one for each image.
@@ -339,10 +661,7 @@ class MatchExporter
             const std::string filepath = (fs::path(m_directory) / (std::to_string(key) + "." + m_filename)).string();
             ALICEVISION_LOG_DEBUG("Export Matches in: " << filepath);
 
-            if (m_ext == ".txt")
-                saveTxt(filepath, matchBegin, match);
-            else
-                throw std::runtime_error(std::string("Unknown matching file format: ") + m_ext);
+            save(filepath, matchBegin, match);
 
             matchBegin = match;
         }
@@ -9,19 +9,52 @@
 
 #include <aliceVision/matching/IndMatch.hpp>
 
+#include <functional>
 #include <string>
+#include <vector>
 
 namespace aliceVision {
 namespace matching {
 
 /**
- * @brief Load a match file.
+ * @brief Function called for each image pair read from a match file.
+ * The matches can be moved out of \p matchesPerDesc.
+ */
+using PairMatchesVisitor = std::function<void(const Pair& pair, MatchesPerDescType& matchesPerDesc)>;
+
+/**
+ * @brief Read a match file pair by pair, without keeping all its matches in memory.
+ *
+ * @param[in] filepath the match file to read
+ * @param[in] visitor function called for each image pair of the file
+ */
+bool VisitMatchFile(const std::string& filepath, const PairMatchesVisitor& visitor);
+
+/**
+ * @brief List all the match files (txt or bin) in the given folders.
+ * @param[in] folders The list of folders where to look for the match files.
+ * @return the list of match files paths
+ */
+std::vector<std::string> ListMatchFiles(const std::vector<std::string>& folders);
+
+/**
+ * @brief Load a match file (txt or bin file format).
  *
  * @param[out] matches container for the output matches
  * @param[in] filepath the match file to load
  */
 bool LoadMatchFile(PairwiseMatches& matches, const std::string& filepath);
 
+/**
+ * @brief Load only the given pairs from a match file.
+ * Binary match files are read with random access using their per-pair index.
+ *
+ * @param[out] matches container for the output matches
+ * @param[in] filepath the match file to load
+ * @param[in] pairs the image pairs to load
+ */
+bool LoadMatchFilePairs(PairwiseMatches& matches, const std::string& filepath, const PairSet& pairs);
+
 /**
  * @brief Load the match file for each image.
  * @param[out] matches container for the output matches.
@@ -76,7 +109,7 @@ void filterTopMatches(PairwiseMatches& allMatches, int maxNum, int minNum);
  *
  * @param[in] matches: container for the output matches
  * @param[in] folder: folder containing the match files
- * @param[in] extension: txt or bin file format
+ * @param[in] extension: txt or bin (compact binary with a per-pair index) file format
  * @param[in] matchFilePerImage: do we store a global match file
  *            or one match file per image
  * @param[in] prefix: optional prefix for the output file(s)
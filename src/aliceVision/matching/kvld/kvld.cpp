@@ -80,6 +80,39 @@ void ImageScale::GradAndNorm(const Image<float>& I, Image<float>& angle, Image<f
     }
 }
 
+std::shared_ptr<const ImageScale> ImageScaleCache::get(const std::string& imagePath)
+{
+    std::shared_ptr<Entry> entry;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        std::shared_ptr<Entry>& cached = _entries[imagePath];
+        if (!cached)
+            cached = std::make_shared<Entry>();
+        cached->lastRequest = ++_nbRequests;
+        entry = cached;
+
+        // release the least recently requested pyramid, the pairs still using it keep their own reference
+        if (_entries.size() > _maxSize)
+        {
+            auto oldestIt = _entries.begin();
+            for (auto it = _entries.begin(); it != _entries.end(); ++it)
+            {
+                if (it->second->lastRequest < oldestIt->second->lastRequest)
+                    oldestIt = it;
+            }
+            _entries.erase(oldestIt);
+        }
+    }
+
+    // built outside of the lock, the other images stay available while this one is built
+    std::call_once(entry->built, [&]() {
+        Image<unsigned char> imageGrey;
+        readImage(imagePath, imageGrey, EImageColorSpace::LINEAR);
+        entry->scale = std::make_shared<const ImageScale>(Image<float>(imageGrey.GetMat().cast<float>()));
+    });
+    return entry->scale;
+}
+
 int ImageScale::getIndex(const double r) const
 {
     const double step = sqrt(2.0);
@@ -138,6 +171,13 @@ VLD::VLD(const ImageScale& series, T const& P1, T const& P2)
     const float sigma2 = r * r;
     //======calculating the descriptor=====//
 
+    // the sampling is done on the pixels of a disk around each point of the line, clipped to the pixels with a gradient
+    // (1 pixel away from the borders), so the inner loop only tests the disk and uses precomputed factors
+    const double twoPi = 2 * constants::pi<double>();
+    const double gaussianFactor = -1.0 / (4.5 * sigma2);
+    const double binFactor = binNum / twoPi;
+    const double subdirectionFactor = subdirection / twoPi;
+
     double statistic[binNum];
     for (int i = 0; i < dimension; i++)
     {
@@ -148,44 +188,40 @@ VLD::VLD(const ImageScale& series, T const& P1, T const& P2)
         xi /= float(ratio);
         yi /= float(ratio);
 
-        for (int y = int(yi - r); y <= int(yi + r + 0.5); y++)
+        const int yBegin = std::max(int(yi - r), 1);
+        const int yEnd = std::min(int(yi + r + 0.5), h - 2);
+        const int xBegin = std::max(int(xi - r), 1);
+        const int xEnd = std::min(int(xi + r + 0.5), w - 2);
+        double* descriptorI = descriptor.data() + subdirection * i;
+
+        for (int y = yBegin; y <= yEnd; y++)
         {
-            for (int x = int(xi - r); x <= int(xi + r + 0.5); x++)
+            const float dy2 = (float(y) - yi) * (float(y) - yi);
+            for (int x = xBegin; x <= xEnd; x++)
             {
-                float d = point_distance(xi, yi, float(x), float(y));
-                if (d <= r && inside(w, h, x, y, 1))
-                {
-                    //================angle and magnitude==========================//
-                    double angle;
-                    if (ang(y, x) >= 0)
-                        angle = ang(y, x) - mainAngle;  // relative angle
-                    else
-                        angle = 0.0;
-
-                    // cout<<angle<<endl;
-                    while (angle < 0)
-                        angle += 2 * constants::pi<double>();
-                    while (angle >= 2 * constants::pi<double>())
-                        angle -= 2 * constants::pi<double>();
-
-                    //===============principle angle==============================//
-                    const int index = int(angle * binNum / (2 * constants::pi<double>()) + 0.5);
-
-                    double Gweight = exp(-d * d / 4.5 / sigma2) * (m(y, x));
-                    if (index < binNum)
-                        statistic[index] += Gweight;
-                    else  // possible since the 0.5
-                        statistic[0] += Gweight;
-
-                    //==============the descriptor===============================//
-                    const int index2 = int(angle * subdirection / (2 * constants::pi<double>()) + 0.5);
-                    assert(index2 >= 0 && index2 <= subdirection);
-
-                    if (index2 < subdirection)
-                        descriptor[subdirection * i + index2] += Gweight;
-                    else
-                        descriptor[subdirection * i] += Gweight;  // possible since the 0.5
-                }
+                const float d2 = (float(x) - xi) * (float(x) - xi) + dy2;
+                if (d2 > r * r)
+                    continue;
+
+                //================angle and magnitude==========================//
+                const float pixelAngle = ang(y, x);
+                double angle = (pixelAngle >= 0) ? pixelAngle - mainAngle : 0.0;  // relative angle
+                // both angles are in [0, 2*PI[
+                if (angle < 0)
+                    angle += twoPi;
+                if (angle >= twoPi)
+                    angle -= twoPi;
+
+                const double Gweight = std::exp(d2 * gaussianFactor) * m(y, x);
+
+                //===============principle angle==============================//
+                const int index = int(angle * binFactor + 0.5);
+                statistic[index < binNum ? index : 0] += Gweight;  // index == binNum possible since the 0.5
+
+                //==============the descriptor===============================//
+                const int index2 = int(angle * subdirectionFactor + 0.5);
+                assert(index2 >= 0 && index2 <= subdirection);
+                descriptorI[index2 < subdirection ? index2 : 0] += Gweight;  // index2 == subdirection possible since the 0.5
             }
         }
         //=====================find the biggest angle of ith SIFT==================//
@@ -213,15 +249,31 @@ float KVLD(const Image<float>& I1,
            std::vector<bool>& valide,
            KvldParameters& kvldParameters)
 {
-    matchesFiltered.clear();
-    score.clear();
-    ImageScale Chaine1(I1);
-    ImageScale Chaine2(I2);
+    const ImageScale Chaine1(I1);
+    const ImageScale Chaine2(I2);
 
     std::cout << "Image scale-space complete..." << std::endl;
 
-    const float range1 = getRange(I1, std::min(F1.size(), matches.size()), kvldParameters.inlierRate);
-    const float range2 = getRange(I2, std::min(F2.size(), matches.size()), kvldParameters.inlierRate);
+    return KVLD(Chaine1, Chaine2, F1, F2, matches, matchesFiltered, score, E, valide, kvldParameters);
+}
+
+float KVLD(const ImageScale& Chaine1,
+           const ImageScale& Chaine2,
+           const std::vector<feature::PointFeature>& F1,
+           const std::vector<feature::PointFeature>& F2,
+           const std::vector<Pair>& matches,
+           std::vector<Pair>& matchesFiltered,
+           std::vector<double>& score,
+           aliceVision::Mat& E,
+           std::vector<bool>& valide,
+           KvldParameters& kvldParameters)
+{
+    matchesFiltered.clear();
+    score.clear();
+
+    // the first scale image has the size of the original image
+    const float range1 = getRange(Chaine1.magnitudes[0], std::min(F1.size(), matches.size()), kvldParameters.inlierRate);
+    const float range2 = getRange(Chaine2.magnitudes[0], std::min(F2.size(), matches.size()), kvldParameters.inlierRate);
 
     const size_t size = matches.size();
 
@@ -20,6 +20,10 @@
 #include <iostream>
 #include <vector>
 #include <sstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
 #include "algorithm.h"
 
 #include <aliceVision/system/Logger.hpp>
@@ -77,6 +81,35 @@ struct ImageScale
     void GradAndNorm(const aliceVision::image::Image<float>& I, aliceVision::image::Image<float>& angle, aliceVision::image::Image<float>& m);
 };
 
+//====== Cache of the pyramids of scale images ======//
+// The pyramid of an image is built once and shared by all the pairs of this image, which may be validated by several threads:
+// a thread requesting a pyramid being built waits for it instead of building it again.
+//
+// maxSize: maximum number of pyramids kept in the cache, the least recently requested ones are released first
+class ImageScaleCache
+{
+  public:
+    explicit ImageScaleCache(std::size_t maxSize = 16)
+      : _maxSize(std::max(std::size_t(1), maxSize))
+    {}
+
+    // get the pyramid of the grey levels of the given image file, built on the first request
+    std::shared_ptr<const ImageScale> get(const std::string& imagePath);
+
+  private:
+    struct Entry
+    {
+        std::once_flag built;
+        std::shared_ptr<const ImageScale> scale;
+        std::size_t lastRequest = 0;
+    };
+
+    std::size_t _maxSize;
+    std::size_t _nbRequests = 0;
+    std::mutex _mutex;
+    std::map<std::string, std::shared_ptr<Entry>> _entries;
+};
+
 //====== VLD structures ======//
 class VLD
 {
@@ -175,4 +208,17 @@ float KVLD(const aliceVision::image::Image<float>& I1,
            std::vector<bool>& valide,
            KvldParameters& kvldParameters);
 
+// Same as above with the pyramids of scale images of I1 and I2 already built,
+// so they can be shared by all the pairs of an image (see ImageScaleCache) and by the successive KVLD calls of a pair.
+float KVLD(const ImageScale& Chaine1,
+           const ImageScale& Chaine2,
+           const std::vector<aliceVision::feature::PointFeature>& F1,
+           const std::vector<aliceVision::feature::PointFeature>& F2,
+           const std::vector<aliceVision::Pair>& matches,
+           std::vector<aliceVision::Pair>& matchesFiltered,
+           std::vector<double>& score,
+           aliceVision::Mat& E,
+           std::vector<bool>& valide,
+           KvldParameters& kvldParameters);
+
 #endif  // KVLD_H
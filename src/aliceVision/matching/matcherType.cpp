@@ -26,6 +26,10 @@ std::string EMatcherType_enumToString(EMatcherType matcherType)
             return "FAST_CASCADE_HASHING_L2";
         case EMatcherType::BRUTE_FORCE_HAMMING:
             return "BRUTE_FORCE_HAMMING";
+        case EMatcherType::BLOCKED_BRUTE_FORCE_L2:
+            return "BLOCKED_BRUTE_FORCE_L2";
+        case EMatcherType::PRODUCT_QUANTIZATION_L2:
+            return "PRODUCT_QUANTIZATION_L2";
     }
     throw std::out_of_range("Invalid matcherType enum");
 }
@@ -42,6 +46,10 @@ EMatcherType EMatcherType_stringToEnum(const std::string& matcherType)
         return EMatcherType::FAST_CASCADE_HASHING_L2;
     if (matcherType == "BRUTE_FORCE_HAMMING")
         return EMatcherType::BRUTE_FORCE_HAMMING;
+    if (matcherType == "BLOCKED_BRUTE_FORCE_L2")
+        return EMatcherType::BLOCKED_BRUTE_FORCE_L2;
+    if (matcherType == "PRODUCT_QUANTIZATION_L2")
+        return EMatcherType::PRODUCT_QUANTIZATION_L2;
     throw std::out_of_range("Invalid matcherType : " + matcherType);
 }
 
@@ -6,6 +6,11 @@
 
 #include "matchesFiltering.hpp"
 
+#include <aliceVision/alicevision_omp.hpp>
+
+#include <algorithm>
+#include <map>
+
 namespace aliceVision {
 namespace matching {
 
@@ -63,40 +68,44 @@ void thresholdMatches(aliceVision::matching::IndMatches& outputMatches, const st
     }
 }
 
-void matchesGridFiltering(const aliceVision::feature::Regions& lRegions,
-                          const std::pair<std::size_t, std::size_t>& lImgSize,
-                          const aliceVision::feature::Regions& rRegions,
-                          const std::pair<std::size_t, std::size_t>& rImgSize,
-                          const aliceVision::Pair& indexImagePair,
-                          aliceVision::matching::IndMatches& outMatches,
-                          size_t gridSize)
+namespace {
+
+/**
+ * @brief Grid cell of a feature position, clamped to the grid for the features/markers centers outside the image.
+ */
+inline int getGridCell(const feature::PointFeature& point, float cellWidth, float cellHeight, std::size_t gridSize)
 {
-    const size_t leftCellWidth = divideRoundUp(lImgSize.first, gridSize);
-    const size_t leftCellHeight = divideRoundUp(lImgSize.second, gridSize);
-    const size_t rightCellWidth = divideRoundUp(rImgSize.first, gridSize);
-    const size_t rightCellHeight = divideRoundUp(rImgSize.second, gridSize);
+    const float maxCoord = static_cast<float>(gridSize - 1);
+    const int cellX = static_cast<int>(clamp(std::floor(point.x() / cellWidth), 0.f, maxCoord));
+    const int cellY = static_cast<int>(clamp(std::floor(point.y() / cellHeight), 0.f, maxCoord));
+    return cellX + cellY * static_cast<int>(gridSize);
+}
 
-    std::vector<aliceVision::matching::IndMatches> completeGrid(gridSize * gridSize * 2);
+/**
+ * @brief Grid ordering of the matches, from the grid cell of their left and right features.
+ * @param[in] getLeftCell function returning the left grid cell of a match
+ * @param[in] getRightCell function returning the right grid cell of a match
+ * @param[in,out] outMatches The matches to order
+ * @param[in,out] cells buffer of 2 * gridSize * gridSize cells, reused between calls
+ * @param[in] gridSize Number of cell per axis
+ */
+template<class LeftCellFn, class RightCellFn>
+void gridOrdering(LeftCellFn getLeftCell, RightCellFn getRightCell, IndMatches& outMatches, std::vector<IndMatches>& cells, std::size_t gridSize)
+{
+    const std::size_t nbCellsPerGrid = gridSize * gridSize;
+    cells.resize(2 * nbCellsPerGrid);
     // Reserve all cells
-    for (aliceVision::matching::IndMatches& cell : completeGrid)
+    for (IndMatches& cell : cells)
     {
-        cell.reserve(outMatches.size() / completeGrid.size());
+        cell.clear();
+        cell.reserve(outMatches.size() / cells.size());
     }
+
     // Split matches in grid cells
-    for (const auto& match : outMatches)
+    for (const IndMatch& match : outMatches)
     {
-        const aliceVision::feature::PointFeature& leftPoint = lRegions.Features()[match._i];
-        const aliceVision::feature::PointFeature& rightPoint = rRegions.Features()[match._j];
-
-        const float leftGridIndex_f = std::floor(leftPoint.x() / (float)leftCellWidth) + std::floor(leftPoint.y() / (float)leftCellHeight) * gridSize;
-        const float rightGridIndex_f =
-          std::floor(rightPoint.x() / (float)rightCellWidth) + std::floor(rightPoint.y() / (float)rightCellHeight) * gridSize;
-        // clamp the values if we have feature/marker centers outside the image size.
-        const std::size_t leftGridIndex = clamp(leftGridIndex_f, 0.f, float(gridSize - 1));
-        const std::size_t rightGridIndex = clamp(rightGridIndex_f, 0.f, float(gridSize - 1));
-
-        aliceVision::matching::IndMatches& currentCaseL = completeGrid[leftGridIndex];
-        aliceVision::matching::IndMatches& currentCaseR = completeGrid[rightGridIndex + gridSize * gridSize];
+        IndMatches& currentCaseL = cells[getLeftCell(match)];
+        IndMatches& currentCaseR = cells[getRightCell(match) + nbCellsPerGrid];
 
         if (currentCaseL.size() <= currentCaseR.size())
         {
@@ -109,30 +118,70 @@ void matchesGridFiltering(const aliceVision::feature::Regions& lRegions,
     }
 
     // max Size of the cells:
-    int maxSize = 0;
-    for (const auto& cell : completeGrid)
-    {
-        if (cell.size() > maxSize)
-        {
-            maxSize = cell.size();
-        }
-    }
-
-    aliceVision::matching::IndMatches finalMatches;
-    finalMatches.reserve(outMatches.size());
+    std::size_t maxSize = 0;
+    for (const auto& cell : cells)
+        maxSize = std::max(maxSize, cell.size());
 
     // Combine all cells into a global ordered vector
-    for (int cmpt = 0; cmpt < maxSize; ++cmpt)
+    std::size_t matchIndex = 0;
+    for (std::size_t cmpt = 0; cmpt < maxSize; ++cmpt)
     {
-        for (const auto& cell : completeGrid)
+        for (const auto& cell : cells)
         {
             if (cmpt < cell.size())
-            {
-                finalMatches.push_back(cell[cmpt]);
-            }
+                outMatches[matchIndex++] = cell[cmpt];
         }
     }
-    outMatches.swap(finalMatches);
+}
+
+}  // namespace
+
+void computeFeaturesGridCells(const feature::Regions& regions,
+                              const std::pair<std::size_t, std::size_t>& imgSize,
+                              std::vector<int>& outFeaturesCell,
+                              std::size_t gridSize)
+{
+    const float cellWidth = static_cast<float>(divideRoundUp(imgSize.first, gridSize));
+    const float cellHeight = static_cast<float>(divideRoundUp(imgSize.second, gridSize));
+
+    const std::vector<feature::PointFeature>& features = regions.Features();
+    outFeaturesCell.resize(features.size());
+    for (std::size_t i = 0; i < features.size(); ++i)
+        outFeaturesCell[i] = getGridCell(features[i], cellWidth, cellHeight, gridSize);
+}
+
+void matchesGridFiltering(const aliceVision::feature::Regions& lRegions,
+                          const std::pair<std::size_t, std::size_t>& lImgSize,
+                          const aliceVision::feature::Regions& rRegions,
+                          const std::pair<std::size_t, std::size_t>& rImgSize,
+                          const aliceVision::Pair& indexImagePair,
+                          aliceVision::matching::IndMatches& outMatches,
+                          size_t gridSize)
+{
+    const float leftCellWidth = static_cast<float>(divideRoundUp(lImgSize.first, gridSize));
+    const float leftCellHeight = static_cast<float>(divideRoundUp(lImgSize.second, gridSize));
+    const float rightCellWidth = static_cast<float>(divideRoundUp(rImgSize.first, gridSize));
+    const float rightCellHeight = static_cast<float>(divideRoundUp(rImgSize.second, gridSize));
+
+    std::vector<IndMatches> cells;
+    gridOrdering([&](const IndMatch& match) { return getGridCell(lRegions.Features()[match._i], leftCellWidth, leftCellHeight, gridSize); },
+                 [&](const IndMatch& match) { return getGridCell(rRegions.Features()[match._j], rightCellWidth, rightCellHeight, gridSize); },
+                 outMatches,
+                 cells,
+                 gridSize);
+}
+
+void matchesGridFiltering(const std::vector<int>& lFeaturesCell,
+                          const std::vector<int>& rFeaturesCell,
+                          IndMatches& outMatches,
+                          std::vector<IndMatches>& cellsBuffer,
+                          std::size_t gridSize)
+{
+    gridOrdering([&](const IndMatch& match) { return lFeaturesCell[match._i]; },
+                 [&](const IndMatch& match) { return rFeaturesCell[match._j]; },
+                 outMatches,
+                 cellsBuffer,
+                 gridSize);
 }
 
 void matchesGridFilteringForAllPairs(const PairwiseMatches& geometricMatches,
@@ -142,55 +191,90 @@ void matchesGridFilteringForAllPairs(const PairwiseMatches& geometricMatches,
                                      std::size_t numMatchesToKeep,
                                      PairwiseMatches& outPairwiseMatches)
 {
+    const std::size_t gridSize = 3;
+
+    // matches of a pair for a describer type
+    struct PairMatches
+    {
+        Pair indexImagePair;
+        feature::EImageDescriberType descType;
+        const IndMatches* inputMatches;
+        IndMatches outMatches;
+    };
+
+    std::vector<PairMatches> allPairsMatches;
     for (const auto& geometricMatch : geometricMatches)
     {
-        // Get the image pair and their matches.
-        const Pair& indexImagePair = geometricMatch.first;
-        const MatchesPerDescType& matchesPerDesc = geometricMatch.second;
+        for (const auto& match : geometricMatch.second)
+        {
+            assert(match.first != feature::EImageDescriberType::UNINITIALIZED);
+            allPairsMatches.push_back({geometricMatch.first, match.first, &match.second, {}});
+        }
+    }
 
-        for (const auto& match : matchesPerDesc)
+    // grid cell of each feature, computed once per view and describer type and shared by all the pairs
+    using ViewDescType = std::pair<IndexT, feature::EImageDescriberType>;
+    std::map<ViewDescType, std::vector<int>> featuresCellPerView;
+    if (useGridSort)
+    {
+        for (const PairMatches& pairMatches : allPairsMatches)
         {
-            const feature::EImageDescriberType descType = match.first;
-            assert(descType != feature::EImageDescriberType::UNINITIALIZED);
-            const IndMatches& inputMatches = match.second;
+            featuresCellPerView[ViewDescType(pairMatches.indexImagePair.first, pairMatches.descType)];
+            featuresCellPerView[ViewDescType(pairMatches.indexImagePair.second, pairMatches.descType)];
+        }
 
-            const feature::Regions* rRegions = &regionPerView.getRegions(indexImagePair.second, descType);
-            const feature::Regions* lRegions = &regionPerView.getRegions(indexImagePair.first, descType);
+        std::vector<std::pair<const ViewDescType, std::vector<int>>*> featuresCells;
+        for (auto& featuresCell : featuresCellPerView)
+            featuresCells.push_back(&featuresCell);
 
-            // get the regions for the current view pair:
-            if (rRegions && lRegions)
-            {
-                // sorting function:
-                aliceVision::matching::IndMatches outMatches;
-                sortMatches_byFeaturesScale(inputMatches, *lRegions, *rRegions, outMatches);
+#pragma omp parallel for schedule(dynamic)
+        for (int i = 0; i < static_cast<int>(featuresCells.size()); ++i)
+        {
+            const ViewDescType& viewDescType = featuresCells[i]->first;
+            computeFeaturesGridCells(regionPerView.getRegions(viewDescType.first, viewDescType.second),
+                                     sfmData.getView(viewDescType.first).getImage().getImgSize(),
+                                     featuresCells[i]->second,
+                                     gridSize);
+        }
+    }
 
-                if (useGridSort)
-                {
-                    // TODO: rename as matchesGridOrdering
-                    matchesGridFiltering(*lRegions,
-                                         sfmData.getView(indexImagePair.first).getImage().getImgSize(),
-                                         *rRegions,
-                                         sfmData.getView(indexImagePair.second).getImage().getImgSize(),
-                                         indexImagePair,
-                                         outMatches);
-                }
+#pragma omp parallel
+    {
+        // cells buffer reused for all the pairs of the thread
+        std::vector<IndMatches> cellsBuffer;
 
-                if (numMatchesToKeep > 0)
-                {
-                    size_t finalSize = std::min(numMatchesToKeep, outMatches.size());
-                    outMatches.resize(finalSize);
-                }
+#pragma omp for schedule(dynamic)
+        for (int i = 0; i < static_cast<int>(allPairsMatches.size()); ++i)
+        {
+            PairMatches& pairMatches = allPairsMatches[i];
+            const Pair& indexImagePair = pairMatches.indexImagePair;
+
+            const feature::Regions& lRegions = regionPerView.getRegions(indexImagePair.first, pairMatches.descType);
+            const feature::Regions& rRegions = regionPerView.getRegions(indexImagePair.second, pairMatches.descType);
+
+            // sorting function:
+            sortMatches_byFeaturesScale(*pairMatches.inputMatches, lRegions, rRegions, pairMatches.outMatches);
 
-                // std::cout << "Left features: " << lRegions->Features().size() << ", right features: " << rRegions->Features().size() << ", num
-                // matches: " << inputMatches.size() << ", num filtered matches: " << outMatches.size() << std::endl;
-                outPairwiseMatches[indexImagePair].insert(std::make_pair(descType, outMatches));
+            if (useGridSort)
+            {
+                // TODO: rename as matchesGridOrdering
+                matchesGridFiltering(featuresCellPerView.at(ViewDescType(indexImagePair.first, pairMatches.descType)),
+                                     featuresCellPerView.at(ViewDescType(indexImagePair.second, pairMatches.descType)),
+                                     pairMatches.outMatches,
+                                     cellsBuffer,
+                                     gridSize);
             }
-            else
+
+            if (numMatchesToKeep > 0)
             {
-                ALICEVISION_LOG_INFO("You cannot perform the grid filtering with these regions");
+                size_t finalSize = std::min(numMatchesToKeep, pairMatches.outMatches.size());
+                pairMatches.outMatches.resize(finalSize);
             }
         }
     }
+
+    for (PairMatches& pairMatches : allPairsMatches)
+        outPairwiseMatches[pairMatches.indexImagePair].insert(std::make_pair(pairMatches.descType, std::move(pairMatches.outMatches)));
 }
 
 void filterMatchesByMin2DMotion(PairwiseMatches& mapPutativesMatches, const feature::RegionsPerView& regionPerView, double minRequired2DMotion)
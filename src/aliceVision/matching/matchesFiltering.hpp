@@ -67,6 +67,32 @@ void matchesGridFiltering(const aliceVision::feature::Regions& lRegions,
                           aliceVision::matching::IndMatches& outMatches,
                           size_t gridSize = 3);
 
+/**
+ * @brief Compute the grid cell of each feature of a view, to share it between the pairs of the view.
+ * @param[in] regions The regions of the picture
+ * @param[in] imgSize Image size
+ * @param[out] outFeaturesCell The grid cell index of each feature (x + y * gridSize)
+ * @param[in] gridSize Number of cell per axis
+ */
+void computeFeaturesGridCells(const feature::Regions& regions,
+                              const std::pair<std::size_t, std::size_t>& imgSize,
+                              std::vector<int>& outFeaturesCell,
+                              std::size_t gridSize = 3);
+
+/**
+ * @brief Perform the grid filtering on the matches, from the precomputed grid cells of the features.
+ * @param[in] lFeaturesCell The grid cell of each feature of the first picture (see computeFeaturesGridCells)
+ * @param[in] rFeaturesCell The grid cell of each feature of the second picture
+ * @param[in,out] outMatches The matches, in the grid order in output
+ * @param[in,out] cellsBuffer Buffer of the matches per cell, reused between the calls
+ * @param[in] gridSize Number of cell per axis
+ */
+void matchesGridFiltering(const std::vector<int>& lFeaturesCell,
+                          const std::vector<int>& rFeaturesCell,
+                          IndMatches& outMatches,
+                          std::vector<IndMatches>& cellsBuffer,
+                          std::size_t gridSize = 3);
+
 void matchesGridFilteringForAllPairs(const PairwiseMatches& geometricMatches,
                                      const sfmData::SfMData& sfmData,
                                      const feature::RegionsPerView& regionPerView,
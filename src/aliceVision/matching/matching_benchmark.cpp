@@ -0,0 +1,66 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <aliceVision/matching/ArrayMatcher_bruteForce.hpp>
+#include <aliceVision/matching/ArrayMatcher_bruteForceBlocked.hpp>
+#include <aliceVision/matching/ArrayMatcher_kdtreeFlann.hpp>
+#include <aliceVision/matching/ArrayMatcher_cascadeHashing.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <vector>
+
+using namespace aliceVision;
+using namespace aliceVision::matching;
+
+namespace {
+
+/// SIFT-like descriptors dimension
+const int descriptorDimension = 128;
+
+std::vector<float> createRandomDescriptors(int nbDescriptors, unsigned int seed)
+{
+    std::mt19937 generator(seed);
+    std::uniform_int_distribution<int> distribution(0, 255);
+
+    std::vector<float> descriptors(std::size_t(nbDescriptors) * descriptorDimension);
+    for (float& value : descriptors)
+        value = static_cast<float>(distribution(generator));
+    return descriptors;
+}
+
+/**
+ * @brief Match two random descriptor sets of state.range(0) descriptors, 2 nearest neighbors per query.
+ */
+template<class MatcherT>
+void BM_ArrayMatcher(benchmark::State& state)
+{
+    const int nbDescriptors = static_cast<int>(state.range(0));
+    const std::vector<float> dataset = createRandomDescriptors(nbDescriptors, 0);
+    const std::vector<float> queries = createRandomDescriptors(nbDescriptors, 1);
+
+    for (auto _ : state)
+    {
+        std::mt19937 randomNumberGenerator(0);
+        MatcherT matcher;
+        matcher.Build(randomNumberGenerator, dataset.data(), nbDescriptors, descriptorDimension);
+
+        IndMatches indices;
+        std::vector<typename MatcherT::DistanceType> distances;
+        matcher.SearchNeighbours(queries.data(), nbDescriptors, &indices, &distances, 2);
+        benchmark::DoNotOptimize(distances.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * nbDescriptors);
+}
+
+}  // namespace
+
+BENCHMARK_TEMPLATE(BM_ArrayMatcher, ArrayMatcher_bruteForce<float>)->Arg(1000)->Arg(4000)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_ArrayMatcher, ArrayMatcher_bruteForceBlocked<float>)->Arg(1000)->Arg(4000)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_ArrayMatcher, ArrayMatcher_kdtreeFlann<float>)->Arg(1000)->Arg(4000)->Arg(16000)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_ArrayMatcher, ArrayMatcher_cascadeHashing<float>)->Arg(1000)->Arg(4000)->Arg(16000)->Unit(benchmark::kMillisecond);
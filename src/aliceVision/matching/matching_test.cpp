@@ -7,8 +7,13 @@
 
 #include "aliceVision/numeric/numeric.hpp"
 #include "aliceVision/matching/ArrayMatcher_bruteForce.hpp"
+#include "aliceVision/matching/ArrayMatcher_bruteForceBlocked.hpp"
 #include "aliceVision/matching/ArrayMatcher_kdtreeFlann.hpp"
+#include "aliceVision/matching/ArrayMatcher_productQuantization.hpp"
 #include "aliceVision/matching/ArrayMatcher_cascadeHashing.hpp"
+
+#include <boost/filesystem.hpp>
+
 #include <iostream>
 
 #define BOOST_TEST_MODULE matching
@@ -123,6 +128,191 @@ BOOST_AUTO_TEST_CASE(Matching_ArrayMatcher_kdtreeFlann_Simple__NN)
     BOOST_CHECK_EQUAL(IndMatch(0, 4), vec_nIndice[4]);
 }
 
+BOOST_AUTO_TEST_CASE(Matching_ArrayMatcher_kdtreeFlann_SavedIndex)
+{
+    std::mt19937 gen(0);
+    std::uniform_real_distribution<float> distribution(0.0f, 1.0f);
+
+    const int nbRows = 500;
+    const int dimension = 8;
+    std::vector<float> dataset(nbRows * dimension);
+    for (float& value : dataset)
+        value = distribution(gen);
+    const std::vector<float> queries(dataset.begin(), dataset.begin() + 10 * dimension);
+
+    const std::string indexFilepath = (boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("%%%%-%%%%.flann")).string();
+
+    // the first build saves the index, the second one loads it
+    IndMatches builtIndices, loadedIndices;
+    std::vector<float> builtDistances, loadedDistances;
+    {
+        ArrayMatcher_kdtreeFlann<float> matcher;
+        matcher.setIndexFilepath(indexFilepath);
+        BOOST_CHECK(matcher.Build(gen, dataset.data(), nbRows, dimension));
+        BOOST_CHECK(boost::filesystem::exists(indexFilepath));
+        BOOST_CHECK(matcher.SearchNeighbours(queries.data(), 10, &builtIndices, &builtDistances, 2));
+    }
+    {
+        ArrayMatcher_kdtreeFlann<float> matcher;
+        matcher.setIndexFilepath(indexFilepath);
+        BOOST_CHECK(matcher.Build(gen, dataset.data(), nbRows, dimension));
+        BOOST_CHECK(matcher.SearchNeighbours(queries.data(), 10, &loadedIndices, &loadedDistances, 2));
+    }
+    BOOST_CHECK(builtIndices == loadedIndices);
+    BOOST_CHECK(builtDistances == loadedDistances);
+
+    // each query is its own nearest neighbour
+    for (int i = 0; i < 10; ++i)
+        BOOST_CHECK_EQUAL(loadedIndices[i * 2]._j, i);
+
+    boost::filesystem::remove(indexFilepath);
+}
+
+BOOST_AUTO_TEST_CASE(Matching_ArrayMatcher_bruteForceBlocked_NN)
+{
+    std::random_device rd;
+    std::mt19937 gen(rd());
+
+    const float array[] = {0, 1, 2, 5, 6};
+    ArrayMatcher_bruteForceBlocked<float> matcher;
+    BOOST_CHECK(matcher.Build(gen, array, 5, 1));
+
+    const float query[] = {2};
+    IndMatches vec_nIndice;
+    std::vector<float> vec_fDistance;
+    BOOST_CHECK(matcher.SearchNeighbours(query, 1, &vec_nIndice, &vec_fDistance, 5));
+
+    BOOST_CHECK_EQUAL(5, vec_nIndice.size());
+    BOOST_CHECK_EQUAL(5, vec_fDistance.size());
+
+    // Check distances:
+    BOOST_CHECK_SMALL(static_cast<double>(vec_fDistance[0] - Square(2.0f - 2.0f)), 1e-6);
+    BOOST_CHECK_SMALL(static_cast<double>(vec_fDistance[1] - Square(1.0f - 2.0f)), 1e-6);
+    BOOST_CHECK_SMALL(static_cast<double>(vec_fDistance[2] - Square(0.0f - 2.0f)), 1e-6);
+    BOOST_CHECK_SMALL(static_cast<double>(vec_fDistance[3] - Square(5.0f - 2.0f)), 1e-6);
+    BOOST_CHECK_SMALL(static_cast<double>(vec_fDistance[4] - Square(6.0f - 2.0f)), 1e-6);
+
+    // Check indexes:
+    BOOST_CHECK_EQUAL(IndMatch(0, 2), vec_nIndice[0]);
+    BOOST_CHECK_EQUAL(IndMatch(0, 1), vec_nIndice[1]);
+    BOOST_CHECK_EQUAL(IndMatch(0, 0), vec_nIndice[2]);
+    BOOST_CHECK_EQUAL(IndMatch(0, 3), vec_nIndice[3]);
+    BOOST_CHECK_EQUAL(IndMatch(0, 4), vec_nIndice[4]);
+}
+
+BOOST_AUTO_TEST_CASE(Matching_ArrayMatcher_bruteForceBlocked_SameAsBruteForce)
+{
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<int> distribution(0, 255);
+
+    // SIFT like descriptors, several blocks of queries and of dataset rows
+    const int dimension = 128;
+    const int nbRows = 5000;
+    const int nbQueries = 600;
+    std::vector<unsigned char> dataset(nbRows * dimension);
+    std::vector<unsigned char> queries(nbQueries * dimension);
+    for (auto& v : dataset)
+        v = distribution(gen);
+    for (auto& v : queries)
+        v = distribution(gen);
+
+    ArrayMatcher_bruteForce<unsigned char, feature::L2_Vectorized<unsigned char>> matcher;
+    ArrayMatcher_bruteForceBlocked<unsigned char> matcherBlocked;
+    BOOST_CHECK(matcher.Build(gen, dataset.data(), nbRows, dimension));
+    BOOST_CHECK(matcherBlocked.Build(gen, dataset.data(), nbRows, dimension));
+
+    IndMatches indices, indicesBlocked;
+    std::vector<float> distances, distancesBlocked;
+    BOOST_CHECK(matcher.SearchNeighbours(queries.data(), nbQueries, &indices, &distances, 2));
+    BOOST_CHECK(matcherBlocked.SearchNeighbours(queries.data(), nbQueries, &indicesBlocked, &distancesBlocked, 2));
+
+    BOOST_REQUIRE_EQUAL(indices.size(), indicesBlocked.size());
+    for (std::size_t i = 0; i < indices.size(); ++i)
+    {
+        // the dot products of unsigned char descriptors are exact in float
+        BOOST_CHECK_EQUAL(distances[i], distancesBlocked[i]);
+        if (i % 2 == 0 && distances[i] < distances[i + 1])
+            BOOST_CHECK_EQUAL(indices[i], indicesBlocked[i]);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(Matching_ArrayMatcher_productQuantization_NN)
+{
+    std::mt19937 gen(42);
+
+    const float array[] = {0, 1, 2, 5, 6};
+    ArrayMatcher_productQuantization<float> matcher;
+    BOOST_CHECK(matcher.Build(gen, array, 5, 1));
+
+    const float query[] = {2};
+    IndMatches vec_nIndice;
+    std::vector<float> vec_fDistance;
+    BOOST_CHECK(matcher.SearchNeighbours(query, 1, &vec_nIndice, &vec_fDistance, 5));
+
+    BOOST_CHECK_EQUAL(5, vec_nIndice.size());
+    BOOST_CHECK_EQUAL(5, vec_fDistance.size());
+
+    // all the rows are re-ranked with the exact distance
+    BOOST_CHECK_SMALL(static_cast<double>(vec_fDistance[0] - Square(2.0f - 2.0f)), 1e-6);
+    BOOST_CHECK_SMALL(static_cast<double>(vec_fDistance[1] - Square(1.0f - 2.0f)), 1e-6);
+    BOOST_CHECK_SMALL(static_cast<double>(vec_fDistance[2] - Square(0.0f - 2.0f)), 1e-6);
+    BOOST_CHECK_SMALL(static_cast<double>(vec_fDistance[3] - Square(5.0f - 2.0f)), 1e-6);
+    BOOST_CHECK_SMALL(static_cast<double>(vec_fDistance[4] - Square(6.0f - 2.0f)), 1e-6);
+
+    BOOST_CHECK_EQUAL(IndMatch(0, 2), vec_nIndice[0]);
+    BOOST_CHECK_EQUAL(IndMatch(0, 1), vec_nIndice[1]);
+    BOOST_CHECK_EQUAL(IndMatch(0, 0), vec_nIndice[2]);
+    BOOST_CHECK_EQUAL(IndMatch(0, 3), vec_nIndice[3]);
+    BOOST_CHECK_EQUAL(IndMatch(0, 4), vec_nIndice[4]);
+}
+
+BOOST_AUTO_TEST_CASE(Matching_ArrayMatcher_productQuantization_Recall)
+{
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<int> distribution(0, 255);
+    std::normal_distribution<float> noise(0.0f, 8.0f);
+
+    // SIFT like descriptors, each query is a noisy copy of a dataset row
+    const int dimension = 128;
+    const int nbRows = 5000;
+    const int nbQueries = 500;
+    std::vector<unsigned char> dataset(nbRows * dimension);
+    std::vector<unsigned char> queries(nbQueries * dimension);
+    for (auto& v : dataset)
+        v = distribution(gen);
+    for (int q = 0; q < nbQueries; ++q)
+    {
+        for (int k = 0; k < dimension; ++k)
+        {
+            const float v = dataset[(q * 7) * dimension + k] + noise(gen);
+            queries[q * dimension + k] = static_cast<unsigned char>(std::min(255.0f, std::max(0.0f, v)));
+        }
+    }
+
+    ArrayMatcher_bruteForce<unsigned char, feature::L2_Vectorized<unsigned char>> matcher;
+    ArrayMatcher_productQuantization<unsigned char> matcherPQ;
+    BOOST_CHECK(matcher.Build(gen, dataset.data(), nbRows, dimension));
+    BOOST_CHECK(matcherPQ.Build(gen, dataset.data(), nbRows, dimension));
+    BOOST_CHECK_EQUAL(matcherPQ.getCodesSize(), nbRows * 16);
+
+    IndMatches indices, indicesPQ;
+    std::vector<float> distances, distancesPQ;
+    BOOST_CHECK(matcher.SearchNeighbours(queries.data(), nbQueries, &indices, &distances, 2));
+    BOOST_CHECK(matcherPQ.SearchNeighbours(queries.data(), nbQueries, &indicesPQ, &distancesPQ, 2));
+
+    BOOST_REQUIRE_EQUAL(indices.size(), indicesPQ.size());
+    int nbFound = 0;
+    for (std::size_t i = 0; i < indices.size(); i += 2)
+    {
+        if (indices[i] != indicesPQ[i])
+            continue;
+        ++nbFound;
+        // the re-ranked distances are exact
+        BOOST_CHECK_EQUAL(distances[i], distancesPQ[i]);
+    }
+    BOOST_CHECK_GE(nbFound, nbQueries * 95 / 100);
+}
+
 //-- Test LIMIT case (empty arrays)
 
 BOOST_AUTO_TEST_CASE(Matching_ArrayMatcher_bruteForce_Simple_EmptyArrays)
@@ -166,3 +356,31 @@ BOOST_AUTO_TEST_CASE(Matching_Cascade_Hashing_Simple_EmptyArrays)
     float fDistance = -1.0f;
     BOOST_CHECK(!matcher.SearchNeighbour(&array[0], &nIndice, &fDistance));
 }
+
+BOOST_AUTO_TEST_CASE(Matching_ArrayMatcher_bruteForceBlocked_Simple_EmptyArrays)
+{
+    std::random_device rd;
+    std::mt19937 gen(rd());
+
+    std::vector<float> array;
+    ArrayMatcher_bruteForceBlocked<float> matcher;
+    BOOST_CHECK(!matcher.Build(gen, &array[0], 0, 4));
+
+    int nIndice = -1;
+    float fDistance = -1.0f;
+    BOOST_CHECK(!matcher.SearchNeighbour(&array[0], &nIndice, &fDistance));
+}
+
+BOOST_AUTO_TEST_CASE(Matching_ArrayMatcher_productQuantization_Simple_EmptyArrays)
+{
+    std::random_device rd;
+    std::mt19937 gen(rd());
+
+    std::vector<float> array;
+    ArrayMatcher_productQuantization<float> matcher;
+    BOOST_CHECK(!matcher.Build(gen, &array[0], 0, 4));
+
+    int nIndice = -1;
+    float fDistance = -1.0f;
+    BOOST_CHECK(!matcher.SearchNeighbour(&array[0], &nIndice, &fDistance));
+}
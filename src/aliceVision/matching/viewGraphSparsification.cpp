@@ -0,0 +1,132 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "viewGraphSparsification.hpp"
+
+#include <aliceVision/system/Logger.hpp>
+
+#include <algorithm>
+#include <map>
+#include <numeric>
+#include <vector>
+
+namespace aliceVision {
+namespace matching {
+
+namespace {
+
+/// Union-find of the views, for the spanning forest
+class ViewsUnionFind
+{
+  public:
+    explicit ViewsUnionFind(std::size_t nbViews)
+      : _parents(nbViews)
+    {
+        std::iota(_parents.begin(), _parents.end(), 0);
+    }
+
+    std::size_t find(std::size_t i)
+    {
+        while (_parents[i] != i)
+        {
+            _parents[i] = _parents[_parents[i]];
+            i = _parents[i];
+        }
+        return i;
+    }
+
+    /// @return false if the views are already connected
+    bool unite(std::size_t a, std::size_t b)
+    {
+        a = find(a);
+        b = find(b);
+        if (a == b)
+            return false;
+        _parents[b] = a;
+        return true;
+    }
+
+  private:
+    std::vector<std::size_t> _parents;
+};
+
+}  // namespace
+
+PairSet selectViewGraphPairs(const PairwiseMatches& pairwiseMatches, std::size_t nbNeighboursPerView)
+{
+    struct WeightedPair
+    {
+        Pair pair;
+        int nbMatches;
+    };
+
+    // pairs sorted by decreasing number of matches (ties by pair for a deterministic selection)
+    std::vector<WeightedPair> pairs;
+    pairs.reserve(pairwiseMatches.size());
+    for (const auto& matchesPair : pairwiseMatches)
+        pairs.push_back({matchesPair.first, matchesPair.second.getNbAllMatches()});
+    std::stable_sort(pairs.begin(), pairs.end(), [](const WeightedPair& a, const WeightedPair& b) { return a.nbMatches > b.nbMatches; });
+
+    // dense view indexes
+    std::map<IndexT, std::size_t> viewIndexes;
+    for (const WeightedPair& weightedPair : pairs)
+    {
+        viewIndexes.emplace(weightedPair.pair.first, viewIndexes.size());
+        viewIndexes.emplace(weightedPair.pair.second, viewIndexes.size());
+    }
+
+    PairSet keptPairs;
+
+    // maximum spanning forest (Kruskal)
+    ViewsUnionFind unionFind(viewIndexes.size());
+    for (const WeightedPair& weightedPair : pairs)
+    {
+        if (unionFind.unite(viewIndexes.at(weightedPair.pair.first), viewIndexes.at(weightedPair.pair.second)))
+            keptPairs.insert(weightedPair.pair);
+    }
+
+    // best pairs of each view
+    std::vector<std::size_t> nbNeighbours(viewIndexes.size(), 0);
+    for (const WeightedPair& weightedPair : pairs)
+    {
+        std::size_t& nbNeighboursI = nbNeighbours[viewIndexes.at(weightedPair.pair.first)];
+        std::size_t& nbNeighboursJ = nbNeighbours[viewIndexes.at(weightedPair.pair.second)];
+        if (nbNeighboursI < nbNeighboursPerView || nbNeighboursJ < nbNeighboursPerView)
+            keptPairs.insert(weightedPair.pair);
+        ++nbNeighboursI;
+        ++nbNeighboursJ;
+    }
+
+    return keptPairs;
+}
+
+std::size_t sparsifyViewGraph(PairwiseMatches& pairwiseMatches, std::size_t nbNeighboursPerView, PairwiseMatches* droppedMatches)
+{
+    if (nbNeighboursPerView == 0)
+        return 0;
+
+    const std::size_t nbPairs = pairwiseMatches.size();
+    const PairSet keptPairs = selectViewGraphPairs(pairwiseMatches, nbNeighboursPerView);
+
+    for (auto it = pairwiseMatches.begin(); it != pairwiseMatches.end();)
+    {
+        if (keptPairs.count(it->first))
+        {
+            ++it;
+            continue;
+        }
+        if (droppedMatches)
+            droppedMatches->emplace(it->first, std::move(it->second));
+        it = pairwiseMatches.erase(it);
+    }
+
+    ALICEVISION_LOG_INFO("View graph sparsification: " << pairwiseMatches.size() << " pairs kept out of " << nbPairs << " ("
+                                                        << nbNeighboursPerView << " best pairs per view).");
+    return nbPairs - pairwiseMatches.size();
+}
+
+}  // namespace matching
+}  // namespace aliceVision
@@ -0,0 +1,40 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <aliceVision/matching/IndMatch.hpp>
+#include <aliceVision/types.hpp>
+
+#include <cstddef>
+
+namespace aliceVision {
+namespace matching {
+
+/**
+ * @brief Select a sparse subset of the view graph of the pairwise matches.
+ *
+ * The pairs of a maximum spanning forest (weighted by the number of matches) keep the connected components
+ * of the view graph, then the nbNeighboursPerView best pairs of each view are added to keep the loops.
+ * A pair is kept if it is in the spanning forest or if it is one of the best pairs of one of its views.
+ *
+ * @param[in] pairwiseMatches The pairwise matches
+ * @param[in] nbNeighboursPerView The number of best pairs kept per view
+ * @return the kept pairs
+ */
+PairSet selectViewGraphPairs(const PairwiseMatches& pairwiseMatches, std::size_t nbNeighboursPerView);
+
+/**
+ * @brief Remove the redundant pairs of the view graph of the pairwise matches (see selectViewGraphPairs).
+ * @param[in,out] pairwiseMatches The pairwise matches
+ * @param[in] nbNeighboursPerView The number of best pairs kept per view, 0 to keep all the pairs
+ * @param[out] droppedMatches If not null, the matches of the removed pairs are moved there
+ * @return the number of removed pairs
+ */
+std::size_t sparsifyViewGraph(PairwiseMatches& pairwiseMatches, std::size_t nbNeighboursPerView, PairwiseMatches* droppedMatches = nullptr);
+
+}  // namespace matching
+}  // namespace aliceVision
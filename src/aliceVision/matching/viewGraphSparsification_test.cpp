@@ -0,0 +1,94 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <aliceVision/matching/viewGraphSparsification.hpp>
+
+#define BOOST_TEST_MODULE matchingViewGraphSparsification
+
+#include <boost/test/unit_test.hpp>
+
+using namespace aliceVision;
+using namespace aliceVision::matching;
+
+namespace {
+
+/// complete view graph, the number of matches of a pair decreases with the distance between its views
+PairwiseMatches createCompleteViewGraph(IndexT nbViews)
+{
+    PairwiseMatches pairwiseMatches;
+    for (IndexT i = 0; i < nbViews; ++i)
+    {
+        for (IndexT j = i + 1; j < nbViews; ++j)
+        {
+            const std::size_t nbMatches = 100 / (j - i);
+            IndMatches& matches = pairwiseMatches[Pair(i, j)][feature::EImageDescriberType::SIFT];
+            for (std::size_t m = 0; m < nbMatches; ++m)
+                matches.emplace_back(m, m);
+        }
+    }
+    return pairwiseMatches;
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(ViewGraphSparsification_chain)
+{
+    const PairwiseMatches pairwiseMatches = createCompleteViewGraph(10);
+
+    // the spanning tree is the chain of the consecutive views
+    const PairSet spanningPairs = selectViewGraphPairs(pairwiseMatches, 0);
+    BOOST_CHECK_EQUAL(spanningPairs.size(), 9);
+    for (IndexT i = 0; i + 1 < 10; ++i)
+        BOOST_CHECK(spanningPairs.count(Pair(i, i + 1)));
+
+    // the 2 best pairs of the inner views are the chain pairs, the end views add a loop
+    const PairSet keptPairs = selectViewGraphPairs(pairwiseMatches, 2);
+    BOOST_CHECK_EQUAL(keptPairs.size(), 11);
+    BOOST_CHECK(keptPairs.count(Pair(0, 2)));
+    BOOST_CHECK(keptPairs.count(Pair(7, 9)));
+    BOOST_CHECK(!keptPairs.count(Pair(0, 3)));
+
+    // with 4 best pairs, each view is connected to its views at distance 2
+    const PairSet densePairs = selectViewGraphPairs(pairwiseMatches, 4);
+    for (IndexT i = 0; i + 2 < 10; ++i)
+        BOOST_CHECK(densePairs.count(Pair(i, i + 2)));
+    BOOST_CHECK(!densePairs.count(Pair(3, 7)));
+}
+
+BOOST_AUTO_TEST_CASE(ViewGraphSparsification_connectedComponents)
+{
+    PairwiseMatches pairwiseMatches = createCompleteViewGraph(5);
+
+    // a second component with a single weak pair
+    pairwiseMatches[Pair(10, 11)][feature::EImageDescriberType::SIFT].emplace_back(0, 0);
+
+    const PairSet keptPairs = selectViewGraphPairs(pairwiseMatches, 1);
+    BOOST_CHECK(keptPairs.count(Pair(10, 11)));
+    BOOST_CHECK_EQUAL(keptPairs.size(), 5);
+}
+
+BOOST_AUTO_TEST_CASE(ViewGraphSparsification_droppedMatches)
+{
+    const PairwiseMatches allMatches = createCompleteViewGraph(8);
+
+    // no sparsification
+    PairwiseMatches pairwiseMatches = allMatches;
+    BOOST_CHECK_EQUAL(sparsifyViewGraph(pairwiseMatches, 0), 0);
+    BOOST_CHECK_EQUAL(pairwiseMatches.size(), allMatches.size());
+
+    PairwiseMatches droppedMatches;
+    const std::size_t nbDropped = sparsifyViewGraph(pairwiseMatches, 2, &droppedMatches);
+    BOOST_CHECK_EQUAL(nbDropped, droppedMatches.size());
+    BOOST_CHECK_EQUAL(pairwiseMatches.size() + droppedMatches.size(), allMatches.size());
+    BOOST_CHECK_EQUAL(pairwiseMatches.size(), selectViewGraphPairs(allMatches, 2).size());
+
+    // the matches of the dropped pairs are kept
+    for (const auto& matchesPair : droppedMatches)
+    {
+        BOOST_CHECK(!pairwiseMatches.count(matchesPair.first));
+        BOOST_CHECK_EQUAL(matchesPair.second.getNbAllMatches(), allMatches.at(matchesPair.first).getNbAllMatches());
+    }
+}
@@ -5,6 +5,10 @@
 // You can obtain one at https://mozilla.org/MPL/2.0/.
 
 #include "GeometricFilter.hpp"
+#include <aliceVision/matchingImageCollection/GeometricFilterMatrix_F_AC.hpp>
+#include <aliceVision/matchingImageCollection/GeometricFilterMatrix_E_AC.hpp>
+#include <aliceVision/matchingImageCollection/GeometricFilterMatrix_H_AC.hpp>
+#include <aliceVision/matchingImageCollection/GeometricFilterMatrix_HGrowing.hpp>
 
 namespace aliceVision {
 namespace matchingImageCollection {
@@ -33,5 +37,79 @@ void removePoorlyOverlappingImagePairs(PairwiseMatches& geometricMatches,
     }
 }
 
+void geometricFiltering(PairwiseMatches& out_geometricMatches,
+                        const sfmData::SfMData* sfmData,
+                        const feature::RegionsPerView& regionsPerView,
+                        EGeometricFilterType geometricFilterType,
+                        double geometricErrorMax,
+                        int maxIteration,
+                        robustEstimation::ERobustEstimator geometricEstimator,
+                        const PairwiseMatches& putativeMatches,
+                        std::mt19937& randomNumberGenerator,
+                        bool guidedMatching)
+{
+    switch (geometricFilterType)
+    {
+        case EGeometricFilterType::NO_FILTERING:
+            out_geometricMatches = putativeMatches;
+            break;
+
+        case EGeometricFilterType::FUNDAMENTAL_MATRIX:
+            robustModelEstimation(out_geometricMatches,
+                                  sfmData,
+                                  regionsPerView,
+                                  GeometricFilterMatrix_F_AC(geometricErrorMax, maxIteration, geometricEstimator),
+                                  putativeMatches,
+                                  randomNumberGenerator,
+                                  guidedMatching);
+            break;
+
+        case EGeometricFilterType::FUNDAMENTAL_WITH_DISTORTION:
+            robustModelEstimation(out_geometricMatches,
+                                  sfmData,
+                                  regionsPerView,
+                                  GeometricFilterMatrix_F_AC(geometricErrorMax, maxIteration, geometricEstimator, true),
+                                  putativeMatches,
+                                  randomNumberGenerator,
+                                  guidedMatching);
+            break;
+
+        case EGeometricFilterType::ESSENTIAL_MATRIX:
+            robustModelEstimation(out_geometricMatches,
+                                  sfmData,
+                                  regionsPerView,
+                                  GeometricFilterMatrix_E_AC(geometricErrorMax, maxIteration),
+                                  putativeMatches,
+                                  randomNumberGenerator,
+                                  guidedMatching);
+            removePoorlyOverlappingImagePairs(out_geometricMatches, putativeMatches, 0.3f, 50);
+            break;
+
+        case EGeometricFilterType::HOMOGRAPHY_MATRIX:
+        {
+            const bool onlyGuidedMatching = true;
+            robustModelEstimation(out_geometricMatches,
+                                  sfmData,
+                                  regionsPerView,
+                                  GeometricFilterMatrix_H_AC(geometricErrorMax, maxIteration),
+                                  putativeMatches,
+                                  randomNumberGenerator,
+                                  guidedMatching,
+                                  onlyGuidedMatching ? -1.0 : 0.6);
+        }
+        break;
+
+        case EGeometricFilterType::HOMOGRAPHY_GROWING:
+            robustModelEstimation(out_geometricMatches,
+                                  sfmData,
+                                  regionsPerView,
+                                  GeometricFilterMatrix_HGrowing(geometricErrorMax, maxIteration),
+                                  putativeMatches,
+                                  randomNumberGenerator,
+                                  guidedMatching);
+            break;
+    }
+}
+
 }  // namespace matchingImageCollection
 }  // namespace aliceVision
@@ -12,6 +12,9 @@
 #include <aliceVision/feature/RegionsPerView.hpp>
 #include <aliceVision/matching/IndMatch.hpp>
 #include <aliceVision/matchingImageCollection/GeometricFilterMatrix.hpp>
+#include <aliceVision/matchingImageCollection/GeometricFilterType.hpp>
+#include <aliceVision/robustEstimation/estimators.hpp>
+#include <aliceVision/system/Logger.hpp>
 #include <aliceVision/system/ProgressDisplay.hpp>
 
 #include <map>
@@ -28,6 +31,7 @@ using namespace aliceVision::matching;
  * or all the pairs and regions correspondences contained in the putativeMatches set.
  * Allow to keep only geometrically coherent matches.
  * It discards pairs that do not lead to a valid robust model estimation.
+ * Pairs with less putative matches than GeometryFunctor::getMinimumNbRequiredMatches() are discarded without estimation.
  * @param[out] geometricMatches
  * @param[in] sfmData
  * @param[in] regionsPerView
@@ -51,11 +55,26 @@ void robustModelEstimation(PairwiseMatches& out_geometricMatches,
 
     auto progressDisplay = system::createConsoleProgressDisplay(putativeMatches.size(), std::cout, "Robust Model Estimation\n");
 
+    // random access to the pairs, and early rejection of the pairs that cannot lead to a valid model
+    // before any feature retrieval or estimation buffer allocation
+    const std::size_t minNbMatches = functor.getMinimumNbRequiredMatches();
+    std::vector<PairwiseMatches::const_iterator> pairsToEstimate;
+    pairsToEstimate.reserve(putativeMatches.size());
+    for (PairwiseMatches::const_iterator iter = putativeMatches.begin(); iter != putativeMatches.end(); ++iter)
+    {
+        if (static_cast<std::size_t>(iter->second.getNbAllMatches()) < minNbMatches)
+            ++progressDisplay;
+        else
+            pairsToEstimate.push_back(iter);
+    }
+
+    ALICEVISION_LOG_DEBUG("Robust Model Estimation: " << putativeMatches.size() - pairsToEstimate.size() << " pairs with less than "
+                                                      << minNbMatches << " putative matches discarded.");
+
 #pragma omp parallel for schedule(dynamic)
-    for (int i = 0; i < (int)putativeMatches.size(); ++i)
+    for (int i = 0; i < (int)pairsToEstimate.size(); ++i)
     {
-        PairwiseMatches::const_iterator iter = putativeMatches.begin();
-        std::advance(iter, i);
+        PairwiseMatches::const_iterator iter = pairsToEstimate[i];
 
         const Pair currentPair = iter->first;
         const MatchesPerDescType& putativeMatchesPerType = iter->second;
@@ -100,5 +119,31 @@ void removePoorlyOverlappingImagePairs(PairwiseMatches& geometricMatches,
                                        float minimumRatio,
                                        std::size_t minimumGeometricCount);
 
+/**
+ * @brief Perform the robust model estimation of the given geometric filter type, see robustModelEstimation.
+ * @note The essential matrix filter also removes the poorly overlapping image pairs,
+ *       the homography matrix filter only keeps the guided matches if guidedMatching is enabled.
+ * @param[out] out_geometricMatches the geometric matches
+ * @param[in] sfmData the input SfMData, for the cameras of the views
+ * @param[in] regionsPerView the regions of the views
+ * @param[in] geometricFilterType the geometric model
+ * @param[in] geometricErrorMax the maximum error of the model, 0 for the a contrario estimated threshold
+ * @param[in] maxIteration the maximum number of iterations of the robust estimation
+ * @param[in] geometricEstimator the robust estimator of the fundamental matrix filters
+ * @param[in] putativeMatches the putative matches
+ * @param[in] randomNumberGenerator the random number generator
+ * @param[in] guidedMatching refine the matches with the estimated model
+ */
+void geometricFiltering(PairwiseMatches& out_geometricMatches,
+                        const sfmData::SfMData* sfmData,
+                        const feature::RegionsPerView& regionsPerView,
+                        EGeometricFilterType geometricFilterType,
+                        double geometricErrorMax,
+                        int maxIteration,
+                        robustEstimation::ERobustEstimator geometricEstimator,
+                        const PairwiseMatches& putativeMatches,
+                        std::mt19937& randomNumberGenerator,
+                        bool guidedMatching);
+
 }  // namespace matchingImageCollection
 }  // namespace aliceVision
@@ -7,6 +7,8 @@
 
 #pragma once
 
+#include <cstddef>
+
 namespace aliceVision {
 
 namespace feature {
@@ -46,6 +48,14 @@ struct GeometricFilterMatrix
                                           const double dDistanceRatio,
                                           matching::MatchesPerDescType& matches) = 0;
 
+    /**
+     * @brief Get the minimum number of putative matches of a pair to try an estimation.
+     * @note A pair with fewer matches cannot lead to a valid model, so it can be discarded
+     *       before retrieving its features.
+     * @return 0 if the filter does not know its minimum
+     */
+    virtual std::size_t getMinimumNbRequiredMatches() const { return 0; }
+
     double m_dPrecision;  // upper_bound precision used for robust estimation
     double m_dPrecision_robust;
     std::size_t m_stIteration;  // maximal number of iteration for robust estimation
@@ -35,6 +35,9 @@ struct GeometricFilterMatrix_E_AC : public GeometricFilterMatrix
         m_E(Mat3::Identity())
     {}
 
+    /// strong support needs more inliers than the 5 points of the essential solver
+    std::size_t getMinimumNbRequiredMatches() const override { return 5 + 1; }
+
     /**
      * @brief Given two sets of image points, it estimates the essential matrix
      *        relating them using a robust method (like A Contrario Ransac).
@@ -44,6 +44,9 @@ struct GeometricFilterMatrix_F_AC : public GeometricFilterMatrix
         m_estimateDistortion(estimateDistortion)
     {}
 
+    /// strong support needs more inliers than the 7 points of the smallest fundamental solver
+    std::size_t getMinimumNbRequiredMatches() const override { return 7 + 1; }
+
     /**
      * @brief Given two sets of image points, it estimates the fundamental matrix
      * relating them using a robust method (like A Contrario Ransac).
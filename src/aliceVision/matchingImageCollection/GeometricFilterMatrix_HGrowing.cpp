@@ -5,6 +5,7 @@
 // You can obtain one at https://mozilla.org/MPL/2.0/.
 
 #include <aliceVision/matching/svgVisualization.hpp>
+#include <aliceVision/alicevision_omp.hpp>
 #include "GeometricFilterMatrix_HGrowing.hpp"
 
 namespace aliceVision {
@@ -116,40 +117,56 @@ void filterMatchesByHGrowing(const std::vector<feature::PointFeature>& siofeatur
     using namespace aliceVision::matching;
 
     IndMatches remainingMatches = putativeMatches;
-    GeometricFilterMatrix_HGrowing dummy;
+
+    // The seeds are grown concurrently by batches, then the batch results are merged in the seeds order:
+    // the result of a seed covered by the planar matches of a previous seed is discarded, as this seed is skipped by the serial growing.
+    // So the result does not depend on the number of threads. Within an already parallel region (e.g. the pairs of a geometric
+    // filtering), the batches have a single seed and no growing is wasted.
+    const int batchSize = omp_in_parallel() ? 1 : omp_get_max_threads();
+    std::vector<std::set<IndexT>> batchPlanarMatchesId(batchSize);
+    std::vector<Mat3> batchHomographies(batchSize);
+    std::vector<char> batchIsGrown(batchSize);
 
     for (IndexT iH = 0; iH < param._maxNbHomographies; ++iH)
     {
-        std::set<IndexT> usedMatchesId, bestMatchesId;
+        std::vector<bool> isUsedMatch(remainingMatches.size(), false);
+        std::set<IndexT> bestMatchesId;  // be careful: it contains the id. in the 'remainingMatches' vector not 'putativeMatches' vector.
         Mat3 bestHomography;
 
-// -- Estimate H using homography-growing approach
-#pragma omp parallel for  // (huge optimization but modify results a little)
-        for (int iMatch = 0; iMatch < remainingMatches.size(); ++iMatch)
+        for (int batchBegin = 0; batchBegin < remainingMatches.size(); batchBegin += batchSize)
         {
-            // Growing a homography from one match ([F.Srajer, 2016] algo. 1, p. 20)
-            // each match is used once only per homography estimation (increases computation time) [1st improvement ([F.Srajer, 2016] p. 20) ]
-            if (usedMatchesId.find(iMatch) != usedMatchesId.end())
-                continue;
-            std::set<IndexT> planarMatchesId;  // be careful: it contains the id. in the 'remainingMatches' vector not 'putativeMatches' vector.
-            Mat3 homography;
-
-            if (!growHomography(siofeatures_I, siofeatures_J, remainingMatches, iMatch, planarMatchesId, homography, param._growParam))
+            const int batchEnd = std::min(batchBegin + batchSize, int(remainingMatches.size()));
+
+            // -- Estimate H using homography-growing approach
+#pragma omp parallel for schedule(dynamic) if (batchSize > 1)
+            for (int iMatch = batchBegin; iMatch < batchEnd; ++iMatch)
             {
-                continue;
+                // Growing a homography from one match ([F.Srajer, 2016] algo. 1, p. 20)
+                // each match is used once only per homography estimation (increases computation time) [1st improvement ([F.Srajer, 2016] p. 20) ]
+                const int iSeed = iMatch - batchBegin;
+                batchIsGrown[iSeed] = !isUsedMatch[iMatch] && growHomography(siofeatures_I,
+                                                                               siofeatures_J,
+                                                                               remainingMatches,
+                                                                               iMatch,
+                                                                               batchPlanarMatchesId[iSeed],
+                                                                               batchHomographies[iSeed],
+                                                                               param._growParam);
             }
 
-#pragma omp critical
-            usedMatchesId.insert(planarMatchesId.begin(), planarMatchesId.end());
-
-            if (planarMatchesId.size() > bestMatchesId.size())
+            // conflicts resolution, in the seeds order
+            for (int iMatch = batchBegin; iMatch < batchEnd; ++iMatch)
             {
-#pragma omp critical
+                const int iSeed = iMatch - batchBegin;
+                if (!batchIsGrown[iSeed] || isUsedMatch[iMatch])
+                    continue;
+
+                for (const IndexT id : batchPlanarMatchesId[iSeed])
+                    isUsedMatch[id] = true;
+
+                if (batchPlanarMatchesId[iSeed].size() > bestMatchesId.size())
                 {
-                    // if(iH == 3) { std::cout << "best iMatch" << iMatch << std::endl; }
-                    bestMatchesId =
-                      planarMatchesId;  // be careful: it contains the id. in the 'remainingMatches' vector not 'putativeMatches' vector.
-                    bestHomography = homography;
+                    std::swap(bestMatchesId, batchPlanarMatchesId[iSeed]);
+                    bestHomography = batchHomographies[iSeed];
                 }
             }
         }  // 'iMatch'
@@ -179,11 +196,18 @@ void filterMatchesByHGrowing(const std::vector<feature::PointFeature>& siofeatur
         }
 
         // update remaining matches (/!\ Keep ordering)
-        std::size_t cpt = 0;
-        for (IndexT id : bestMatchesId)
         {
-            remainingMatches.erase(remainingMatches.begin() + id - cpt);
-            ++cpt;
+            std::vector<bool> isBestMatch(remainingMatches.size(), false);
+            for (IndexT id : bestMatchesId)
+                isBestMatch[id] = true;
+
+            std::size_t nbRemainingMatches = 0;
+            for (std::size_t id = 0; id < remainingMatches.size(); ++id)
+            {
+                if (!isBestMatch[id])
+                    remainingMatches[nbRemainingMatches++] = remainingMatches[id];
+            }
+            remainingMatches.resize(nbRemainingMatches);
         }
 
         // stop when the number of remaining matches is too small
@@ -0,0 +1,104 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <aliceVision/matchingImageCollection/GeometricFilterMatrix_HGrowing.hpp>
+#include <aliceVision/alicevision_omp.hpp>
+
+#include <random>
+
+#define BOOST_TEST_MODULE matchingImageCollectionHGrowing
+
+#include <boost/test/unit_test.hpp>
+
+using namespace aliceVision;
+
+/**
+ * @brief Add matches between random features of the plane seen in the first image and their transformation by the similarity
+ *        (rotation, scale, translation) to the second image.
+ */
+void addPlanarMatches(std::mt19937& generator,
+                      double angle,
+                      double scale,
+                      const Vec2& translation,
+                      std::size_t nbMatches,
+                      std::vector<feature::PointFeature>& featuresI,
+                      std::vector<feature::PointFeature>& featuresJ,
+                      matching::IndMatches& matches)
+{
+    std::uniform_real_distribution<float> coordDistribution(0.f, 1000.f);
+    std::uniform_real_distribution<float> scaleDistribution(1.f, 5.f);
+    std::uniform_real_distribution<float> orientationDistribution(0.f, 1.f);
+
+    Eigen::Matrix2d rotation;
+    rotation << std::cos(angle), -std::sin(angle), std::sin(angle), std::cos(angle);
+
+    for (std::size_t i = 0; i < nbMatches; ++i)
+    {
+        const Vec2 pointI(coordDistribution(generator), coordDistribution(generator));
+        const Vec2 pointJ = scale * rotation * pointI + translation;
+        const float featureScale = scaleDistribution(generator);
+        const float featureOrientation = orientationDistribution(generator);
+
+        matches.emplace_back(featuresI.size(), featuresJ.size());
+        featuresI.emplace_back(float(pointI(0)), float(pointI(1)), featureScale, featureOrientation);
+        featuresJ.emplace_back(float(pointJ(0)), float(pointJ(1)), float(scale) * featureScale, featureOrientation + float(angle));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(matchingImageCollection_filterMatchesByHGrowing)
+{
+    std::mt19937 generator(42);
+
+    std::vector<feature::PointFeature> featuresI;
+    std::vector<feature::PointFeature> featuresJ;
+    matching::IndMatches putativeMatches;
+
+    // 2 planes with different similarities, the matches of the planes are interleaved
+    matching::IndMatches matchesPlane0, matchesPlane1;
+    addPlanarMatches(generator, 0.1, 1.2, Vec2(50.0, -20.0), 60, featuresI, featuresJ, matchesPlane0);
+    addPlanarMatches(generator, -0.5, 0.8, Vec2(300.0, 400.0), 40, featuresI, featuresJ, matchesPlane1);
+    for (std::size_t i = 0; i < matchesPlane0.size(); ++i)
+    {
+        putativeMatches.push_back(matchesPlane0[i]);
+        if (i < matchesPlane1.size())
+            putativeMatches.push_back(matchesPlane1[i]);
+    }
+
+    const matchingImageCollection::HGrowingFilteringParam param;
+
+    std::vector<std::pair<Mat3, matching::IndMatches>> homographiesAndMatches;
+    matching::IndMatches geometricInliers;
+    matchingImageCollection::filterMatchesByHGrowing(featuresI, featuresJ, putativeMatches, homographiesAndMatches, geometricInliers, param);
+
+    BOOST_CHECK_EQUAL(homographiesAndMatches.size(), 2);
+    BOOST_CHECK_EQUAL(geometricInliers.size(), putativeMatches.size());
+
+    // the matches of each homography belong to a single plane
+    for (const auto& homographyAndMatches : homographiesAndMatches)
+    {
+        const matching::IndMatches& matches = homographyAndMatches.second;
+        BOOST_REQUIRE(!matches.empty());
+        const bool isPlane0 = matches.front()._i < matchesPlane0.size();
+        for (const matching::IndMatch& match : matches)
+            BOOST_CHECK_EQUAL(match._i < matchesPlane0.size(), isPlane0);
+    }
+
+    // the seeds are grown concurrently, the result does not depend on the number of threads
+    const int nbThreads = omp_get_max_threads();
+    omp_set_num_threads(1);
+
+    std::vector<std::pair<Mat3, matching::IndMatches>> homographiesAndMatchesSerial;
+    matching::IndMatches geometricInliersSerial;
+    matchingImageCollection::filterMatchesByHGrowing(
+      featuresI, featuresJ, putativeMatches, homographiesAndMatchesSerial, geometricInliersSerial, param);
+
+    omp_set_num_threads(nbThreads);
+
+    BOOST_CHECK(geometricInliers == geometricInliersSerial);
+    BOOST_REQUIRE_EQUAL(homographiesAndMatches.size(), homographiesAndMatchesSerial.size());
+    for (std::size_t i = 0; i < homographiesAndMatches.size(); ++i)
+        BOOST_CHECK(homographiesAndMatches[i].first == homographiesAndMatchesSerial[i].first);
+}
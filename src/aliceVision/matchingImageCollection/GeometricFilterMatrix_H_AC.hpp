@@ -32,6 +32,9 @@ struct GeometricFilterMatrix_H_AC : public GeometricFilterMatrix
         m_H(Mat3::Identity())
     {}
 
+    /// strong support needs more inliers than the 4 points of the homography solver
+    std::size_t getMinimumNbRequiredMatches() const override { return 4 + 1; }
+
     /**
      * @brief Given two sets of image points, it estimates the homography matrix
      * relating them using a robust method (like A Contrario Ransac).
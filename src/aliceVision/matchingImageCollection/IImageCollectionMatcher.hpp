@@ -39,6 +39,22 @@ class IImageCollectionMatcher
                        feature::EImageDescriberType descType,
                        matching::PairwiseMatches& map_putatives_matches  // the output pairwise photometric corresponding points
     ) const = 0;
+
+    /**
+     * @brief Find corresponding points between some pair of view Ids for several describer types.
+     * @note The default implementation matches the describer types one after the other,
+     *       a matcher may override it to schedule all the describer types of a pair together.
+     */
+    virtual void Match(std::mt19937& randomNumberGenerator,
+                       const feature::RegionsPerView& regionsPerView,
+                       const PairSet& pairs,  // list of pair to consider for matching
+                       const std::vector<feature::EImageDescriberType>& descTypes,
+                       matching::PairwiseMatches& map_putatives_matches  // the output pairwise photometric corresponding points
+    ) const
+    {
+        for (const feature::EImageDescriberType descType : descTypes)
+            Match(randomNumberGenerator, regionsPerView, pairs, descType, map_putatives_matches);
+    }
 };
 
 }  // namespace matchingImageCollection
@@ -7,20 +7,26 @@
 
 #include <aliceVision/matchingImageCollection/ImageCollectionMatcher_cascadeHashing.hpp>
 #include <aliceVision/matching/ArrayMatcher_cascadeHashing.hpp>
+#include <aliceVision/matching/cascadeHashingCache.hpp>
 #include <aliceVision/matching/IndMatchDecorator.hpp>
 #include <aliceVision/matching/filters.hpp>
 #include <aliceVision/system/ProgressDisplay.hpp>
 #include <aliceVision/config.hpp>
 
+#include <boost/filesystem.hpp>
+
 namespace aliceVision {
 namespace matchingImageCollection {
 
 using namespace aliceVision::matching;
 using namespace aliceVision::feature;
 
-ImageCollectionMatcher_cascadeHashing ::ImageCollectionMatcher_cascadeHashing(float distRatio)
+namespace fs = boost::filesystem;
+
+ImageCollectionMatcher_cascadeHashing ::ImageCollectionMatcher_cascadeHashing(float distRatio, const std::string& cacheFolder)
   : IImageCollectionMatcher(),
-    f_dist_ratio_(distRatio)
+    f_dist_ratio_(distRatio),
+    _cacheFolder(cacheFolder)
 {}
 
 namespace impl {
@@ -30,6 +36,7 @@ void Match(std::mt19937& gen,
            const PairSet& pairs,
            EImageDescriberType descType,
            float fDistRatio,
+           const std::string& cacheFolder,
            PairwiseMatches& map_PutativesMatches  // the pairwise photometric corresponding points
 )
 {
@@ -49,21 +56,31 @@ void Match(std::mt19937& gen,
 
     typedef Eigen::Matrix<ScalarT, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> BaseMat;
 
-    // Init the cascade hasher
+    const std::string descTypeName = EImageDescriberType_enumToString(descType);
+
+    // Init the cascade hasher, reuse the cached one so the cached hashed descriptions stay valid
     CascadeHasher cascade_hasher;
+    // Compute the zero mean descriptor that will be used for hashing (one for all the image regions)
+    Eigen::VectorXf zero_mean_descriptor;
+
+    std::size_t dimension = 0;
     if (!used_index.empty())
+        dimension = regionsPerView.getRegions(*used_index.begin(), descType).DescriptorLength();
+
+    const std::string hasherFilepath =
+      cacheFolder.empty() ? std::string() : (fs::path(cacheFolder) / ("cascadeHasher." + descTypeName + ".bin")).string();
+    bool hasherLoaded = false;
+    if (!hasherFilepath.empty() && loadCascadeHasher(hasherFilepath, cascade_hasher, zero_mean_descriptor))
     {
-        const IndexT I = *used_index.begin();
-        const feature::Regions& regionsI = regionsPerView.getRegions(I, descType);
-        const size_t dimension = regionsI.DescriptorLength();
-        cascade_hasher.Init(gen, dimension);
+        hasherLoaded = (std::size_t(cascade_hasher.NbHashCode()) == dimension && std::size_t(zero_mean_descriptor.size()) == dimension);
+        if (hasherLoaded)
+            ALICEVISION_LOG_INFO("Cascade hasher loaded from '" << hasherFilepath << "'.");
     }
 
-    std::map<IndexT, HashedDescriptions> hashed_base_;
-
-    // Compute the zero mean descriptor that will be used for hashing (one for all the image regions)
-    Eigen::VectorXf zero_mean_descriptor;
+    if (!used_index.empty() && !hasherLoaded)
     {
+        cascade_hasher.Init(gen, dimension);
+
         Eigen::MatrixXf matForZeroMean;
         for (int i = 0; i < used_index.size(); ++i)
         {
@@ -85,8 +102,16 @@ void Match(std::mt19937& gen,
             }
         }
         zero_mean_descriptor = CascadeHasher::GetZeroMeanDescriptor(matForZeroMean);
+
+        if (!hasherFilepath.empty())
+            saveCascadeHasher(hasherFilepath, cascade_hasher, zero_mean_descriptor);
     }
 
+    const std::uint64_t hasherKey = getCascadeHasherKey(cascade_hasher, zero_mean_descriptor);
+
+    std::map<IndexT, HashedDescriptions> hashed_base_;
+    int nbLoadedHashedDescriptions = 0;
+
 // Index the input regions
 #pragma omp parallel for schedule(dynamic)
     for (int i = 0; i < used_index.size(); ++i)
@@ -99,13 +124,36 @@ void Match(std::mt19937& gen,
         const size_t dimension = regionsI.DescriptorLength();
 
         Eigen::Map<BaseMat> mat_I((ScalarT*)tabI, regionsI.RegionCount(), dimension);
-        HashedDescriptions hashed_description = cascade_hasher.CreateHashedDescriptions(mat_I, zero_mean_descriptor);
+
+        HashedDescriptions hashed_description;
+        bool loaded = false;
+        if (!cacheFolder.empty())
+        {
+            // the cached hashes are only valid for the same hasher and the same descriptors
+            const std::string filepath = (fs::path(cacheFolder) / (std::to_string(I) + "." + descTypeName + ".hash")).string();
+            const std::uint64_t descriptorsKey = hashBytes(tabI, regionsI.RegionCount() * dimension * sizeof(ScalarT));
+            loaded = loadHashedDescriptions(filepath, cascade_hasher, hasherKey, descriptorsKey, regionsI.RegionCount(), hashed_description);
+            if (!loaded)
+            {
+                hashed_description = cascade_hasher.CreateHashedDescriptions(mat_I, zero_mean_descriptor);
+                saveHashedDescriptions(filepath, hashed_description, hasherKey, descriptorsKey);
+            }
+        }
+        else
+        {
+            hashed_description = cascade_hasher.CreateHashedDescriptions(mat_I, zero_mean_descriptor);
+        }
 #pragma omp critical
         {
             hashed_base_[I] = std::move(hashed_description);
+            if (loaded)
+                ++nbLoadedHashedDescriptions;
         }
     }
 
+    if (!cacheFolder.empty())
+        ALICEVISION_LOG_INFO("Cascade hashing: " << nbLoadedHashedDescriptions << "/" << used_index.size() << " hashed images loaded from the cache.");
+
     // Perform matching between all the pairs
     for (Map_vectorT::const_iterator iter = map_Pairs.begin(); iter != map_Pairs.end(); ++iter)
     {
@@ -211,11 +259,11 @@ void ImageCollectionMatcher_cascadeHashing::Match(std::mt19937& gen,
 
     if (regions.Type_id() == typeid(unsigned char).name())
     {
-        impl::Match<unsigned char>(gen, regionsPerView, pairs, descType, f_dist_ratio_, map_PutativesMatches);
+        impl::Match<unsigned char>(gen, regionsPerView, pairs, descType, f_dist_ratio_, _cacheFolder, map_PutativesMatches);
     }
     else if (regions.Type_id() == typeid(float).name())
     {
-        impl::Match<float>(gen, regionsPerView, pairs, descType, f_dist_ratio_, map_PutativesMatches);
+        impl::Match<float>(gen, regionsPerView, pairs, descType, f_dist_ratio_, _cacheFolder, map_PutativesMatches);
     }
     else
     {
@@ -9,6 +9,8 @@
 
 #include "aliceVision/matchingImageCollection/IImageCollectionMatcher.hpp"
 
+#include <string>
+
 namespace aliceVision {
 namespace matchingImageCollection {
 
@@ -19,12 +21,20 @@ namespace matchingImageCollection {
  * a threshold over the distance ratio of the 2 nearest neighbours.
  *
  * @note: Cascade hashing tables are computed once and used for all the regions.
+ *        If a cache folder is given, the hasher and the hashed descriptions of each image are saved in it
+ *        and reused by the next runs, as long as the descriptors of the image do not change.
  * @warning: all descriptors are loaded in memory. You need to ensure that it can fit in RAM.
  */
 class ImageCollectionMatcher_cascadeHashing : public IImageCollectionMatcher
 {
   public:
-    ImageCollectionMatcher_cascadeHashing(float dist_ratio);
+    /**
+     * @param[in] dist_ratio the distance ratio used to discard spurious correspondences
+     * @param[in] cacheFolder the folder of the cached hashed descriptions, no cache if empty
+     */
+    explicit ImageCollectionMatcher_cascadeHashing(float dist_ratio, const std::string& cacheFolder = "");
+
+    using IImageCollectionMatcher::Match;
 
     /// Find corresponding points between some pair of view Ids
     void Match(std::mt19937& randomNumberGenerator,
@@ -37,6 +47,8 @@ class ImageCollectionMatcher_cascadeHashing : public IImageCollectionMatcher
   private:
     // Distance ratio used to discard spurious correspondence
     float f_dist_ratio_;
+    // Folder of the cached hashed descriptions
+    std::string _cacheFolder;
 };
 
 }  // namespace matchingImageCollection
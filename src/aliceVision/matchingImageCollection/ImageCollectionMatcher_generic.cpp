@@ -10,9 +10,22 @@
 #include <aliceVision/matching/ArrayMatcher_kdtreeFlann.hpp>
 #include <aliceVision/matching/ArrayMatcher_cascadeHashing.hpp>
 #include <aliceVision/matching/RegionsMatcher.hpp>
+#include <aliceVision/matching/cascadeHashingCache.hpp>
 #include <aliceVision/matchingImageCollection/IImageCollectionMatcher.hpp>
 #include <aliceVision/system/ProgressDisplay.hpp>
 #include <aliceVision/config.hpp>
+#include <aliceVision/alicevision_omp.hpp>
+
+#include <boost/filesystem.hpp>
+
+#include <algorithm>
+#include <list>
+#include <map>
+#include <memory>
+#include <set>
+#include <sstream>
+
+namespace fs = boost::filesystem;
 
 namespace aliceVision {
 namespace matchingImageCollection {
@@ -20,26 +33,196 @@ namespace matchingImageCollection {
 using namespace aliceVision::matching;
 using namespace aliceVision::feature;
 
-ImageCollectionMatcher_generic::ImageCollectionMatcher_generic(float distRatio, bool crossMatching, EMatcherType matcherType)
+ImageCollectionMatcher_generic::ImageCollectionMatcher_generic(float distRatio,
+                                                               bool crossMatching,
+                                                               EMatcherType matcherType,
+                                                               const std::string& kdTreeIndexCacheFolder)
   : IImageCollectionMatcher(),
     _f_dist_ratio(distRatio),
     _useCrossMatching(crossMatching),
-    _matcherType(matcherType)
+    _matcherType(matcherType),
+    _kdTreeIndexCacheFolder(kdTreeIndexCacheFolder)
 {}
 
+namespace {
+
+/// number of consecutive rows (and columns) of the pairs adjacency matrix matched together,
+/// the matchers of the views of a tile are built once and shared by all the pairs of the tile
+const std::size_t tileSize = 8;
+
+/// maximum number of matchers kept in memory, the matchers of a view are reused by the next tiles of the view (as a row or as a column)
+const std::size_t maxCachedMatchers = 8 * tileSize;
+
+/// view id and describer type of a matcher
+typedef std::pair<std::size_t, EImageDescriberType> MatcherKey;
+
+/// matchers indexed by view id and describer type
+typedef std::map<MatcherKey, std::shared_ptr<RegionsDatabaseMatcher>> MatchersPerView;
+
+/**
+ * @brief Bounded cache of the matchers, the least recently used matchers are released first.
+ */
+class MatchersCache
+{
+  public:
+    explicit MatchersCache(std::size_t maxSize)
+      : _maxSize(maxSize)
+    {}
+
+    /// @return the cached matcher, nullptr if it is not in the cache
+    std::shared_ptr<RegionsDatabaseMatcher> get(const MatcherKey& key)
+    {
+        const auto it = _matchers.find(key);
+        if (it == _matchers.end())
+            return nullptr;
+        _lastUses.splice(_lastUses.begin(), _lastUses, it->second.second);
+        return it->second.first;
+    }
+
+    void add(const MatcherKey& key, const std::shared_ptr<RegionsDatabaseMatcher>& matcher)
+    {
+        _lastUses.push_front(key);
+        _matchers[key] = std::make_pair(matcher, _lastUses.begin());
+        while (_matchers.size() > _maxSize)
+        {
+            _matchers.erase(_lastUses.back());
+            _lastUses.pop_back();
+        }
+    }
+
+  private:
+    std::size_t _maxSize;
+    std::list<MatcherKey> _lastUses;
+    std::map<MatcherKey, std::pair<std::shared_ptr<RegionsDatabaseMatcher>, std::list<MatcherKey>::iterator>> _matchers;
+};
+
+/**
+ * @brief Get the file of the serialized kd-tree index of the given regions.
+ * @note The file name contains the hash of the descriptors, the index is only reused for the same descriptors.
+ */
+std::string getKdTreeIndexFilepath(const std::string& folder, std::size_t viewId, EImageDescriberType descType, const feature::Regions& regions)
+{
+    std::size_t scalarSize = sizeof(unsigned char);
+    if (regions.Type_id() == typeid(float).name())
+        scalarSize = sizeof(float);
+    else if (regions.Type_id() == typeid(double).name())
+        scalarSize = sizeof(double);
+
+    std::ostringstream descriptorsKey;
+    descriptorsKey << std::hex << hashBytes(regions.DescriptorRawData(), regions.RegionCount() * regions.DescriptorLength() * scalarSize);
+
+    return (fs::path(folder) / (std::to_string(viewId) + "." + EImageDescriberType_enumToString(descType) + "." + descriptorsKey.str() + ".flann"))
+      .string();
+}
+
+/**
+ * @brief Get the matchers of all the describer types of the given views, the missing ones are built in parallel.
+ * @note Each matcher gets its own random number generator seeded from the input one,
+ *       so the result does not depend on the threads scheduling. Views without regions are skipped.
+ */
+void buildMatchers(std::mt19937& randomNumberGenerator,
+                   EMatcherType matcherType,
+                   const feature::RegionsPerView& regionsPerView,
+                   const std::vector<feature::EImageDescriberType>& descTypes,
+                   const std::vector<std::size_t>& viewIds,
+                   const std::string& kdTreeIndexCacheFolder,
+                   MatchersCache& matchersCache,
+                   MatchersPerView& out_matchers)
+{
+    out_matchers.clear();
+
+    std::vector<MatcherKey> missingKeys;
+    for (const std::size_t viewId : viewIds)
+    {
+        for (const feature::EImageDescriberType descType : descTypes)
+        {
+            const MatcherKey key(viewId, descType);
+            std::shared_ptr<RegionsDatabaseMatcher> matcher = matchersCache.get(key);
+            if (matcher)
+                out_matchers.emplace(key, matcher);
+            else
+                missingKeys.push_back(key);
+        }
+    }
+
+    const std::size_t nbMatchers = missingKeys.size();
+
+    std::vector<std::mt19937::result_type> seeds(nbMatchers);
+    for (auto& seed : seeds)
+        seed = randomNumberGenerator();
+
+    std::vector<std::shared_ptr<RegionsDatabaseMatcher>> matchers(nbMatchers);
+
+#pragma omp parallel for schedule(dynamic)
+    for (int i = 0; i < (int)nbMatchers; ++i)
+    {
+        const feature::Regions& regions = regionsPerView.getRegions(missingKeys[i].first, missingKeys[i].second);
+        if (regions.RegionCount() == 0)
+            continue;
+
+        const std::string kdTreeIndexFilepath = (matcherType == ANN_L2 && !kdTreeIndexCacheFolder.empty())
+                                                  ? getKdTreeIndexFilepath(kdTreeIndexCacheFolder, missingKeys[i].first, missingKeys[i].second, regions)
+                                                  : std::string();
+        std::mt19937 generator(seeds[i]);
+        matchers[i] = std::make_shared<RegionsDatabaseMatcher>(generator, matcherType, regions, kdTreeIndexFilepath);
+    }
+
+    for (std::size_t i = 0; i < nbMatchers; ++i)
+    {
+        if (!matchers[i])
+            continue;
+        matchersCache.add(missingKeys[i], matchers[i]);
+        out_matchers.emplace(missingKeys[i], matchers[i]);
+    }
+}
+
+/// Keep the matches I->J that are also found from J to I
+void keepCrossMatches(const IndMatches& matchesCross, IndMatches& matches)
+{
+    // Create a dictionnary of matches indexed by their pair of indexes
+    std::set<std::pair<int, int>> checkMatches;
+    for (const IndMatch& m : matchesCross)
+        checkMatches.emplace(m._i, m._j);
+
+    IndMatches checkedMatches;
+    for (const IndMatch& m : matches)
+    {
+        // Check with reversed key (images are swapped)
+        if (checkMatches.count(std::make_pair(int(m._j), int(m._i))))
+            checkedMatches.push_back(m);
+    }
+    std::swap(matches, checkedMatches);
+}
+
+}  // namespace
+
 void ImageCollectionMatcher_generic::Match(std::mt19937& randomNumberGenerator,
                                            const feature::RegionsPerView& regionsPerView,
                                            const PairSet& pairs,
                                            feature::EImageDescriberType descType,
                                            matching::PairwiseMatches& map_PutativesMatches) const  // the pairwise photometric corresponding points
 {
+    Match(randomNumberGenerator, regionsPerView, pairs, std::vector<feature::EImageDescriberType>{descType}, map_PutativesMatches);
+}
+
+void ImageCollectionMatcher_generic::Match(std::mt19937& randomNumberGenerator,
+                                           const feature::RegionsPerView& regionsPerView,
+                                           const PairSet& pairs,
+                                           const std::vector<feature::EImageDescriberType>& descTypes,
+                                           matching::PairwiseMatches& map_PutativesMatches) const  // the pairwise photometric corresponding points
+{
+    if (descTypes.empty())
+        return;
+
 #if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_OPENMP)
     ALICEVISION_LOG_DEBUG("Using the OPENMP thread interface");
 #endif
-    const bool b_multithreaded_pair_search = (_matcherType == CASCADE_HASHING_L2);
-    // -> set to true for CASCADE_HASHING_L2, since OpenMP instructions are not used in this matcher
+    const bool b_multithreaded_pair_search = (_matcherType == CASCADE_HASHING_L2) || (descTypes.size() > 1);
+    // -> set to true for CASCADE_HASHING_L2, since OpenMP instructions are not used in this matcher,
+    //    and with several describer types, which are then matched concurrently for each pair
 
-    auto progressDisplay = system::createConsoleProgressDisplay(pairs.size(), std::cout);
+    const int nbDescTypes = int(descTypes.size());
+    auto progressDisplay = system::createConsoleProgressDisplay(pairs.size() * descTypes.size(), std::cout);
 
     // Sort pairs according the first index to minimize the MatcherT build operations
     typedef std::map<size_t, std::vector<size_t>> Map_vectorT;
@@ -49,75 +232,98 @@ void ImageCollectionMatcher_generic::Match(std::mt19937& randomNumberGenerator,
         map_Pairs[iter->first].push_back(iter->second);
     }
 
-    // Perform matching between all the pairs
-    for (Map_vectorT::const_iterator iter = map_Pairs.begin(); iter != map_Pairs.end(); ++iter)
+    std::vector<size_t> rowViewIds;
+    rowViewIds.reserve(map_Pairs.size());
+    for (const auto& row : map_Pairs)
+        rowViewIds.push_back(row.first);
+
+    // Traverse the pairs adjacency matrix by tiles: the matchers of a block of rows are built once for all their pairs,
+    // and with cross matching, the matchers of each block of columns are built once per block of rows instead of once per pair.
+    // All the describer types are scheduled together: the regions of a view are visited once per tile for all of them.
+    // The matchers are kept in a bounded cache, so a view used again as a row or as a column does not rebuild its matcher.
+    if (!_kdTreeIndexCacheFolder.empty() && _matcherType == ANN_L2)
+        fs::create_directories(_kdTreeIndexCacheFolder);
+
+    MatchersCache matchersCache(std::max(maxCachedMatchers, 2 * tileSize) * descTypes.size());
+    MatchersPerView rowMatchers;
+    MatchersPerView columnMatchers;
+    for (std::size_t rowBegin = 0; rowBegin < rowViewIds.size(); rowBegin += tileSize)
     {
-        const size_t I = iter->first;
-        const std::vector<size_t>& indexToCompare = iter->second;
+        const std::vector<size_t> blockRowViewIds(rowViewIds.begin() + rowBegin,
+                                                  rowViewIds.begin() + std::min(rowBegin + tileSize, rowViewIds.size()));
 
-        const feature::Regions& regionsI = regionsPerView.getRegions(I, descType);
-        if (regionsI.RegionCount() == 0)
+        // Initialize the matching interfaces
+        buildMatchers(randomNumberGenerator, _matcherType, regionsPerView, descTypes, blockRowViewIds, _kdTreeIndexCacheFolder, matchersCache, rowMatchers);
+
+        // pairs of the block of rows, sorted by column
+        std::vector<Pair> blockPairs;
+        for (const size_t I : blockRowViewIds)
         {
-            progressDisplay += indexToCompare.size();
-            continue;
+            for (const size_t J : map_Pairs.at(I))
+                blockPairs.emplace_back(I, J);
         }
+        std::sort(blockPairs.begin(), blockPairs.end(), [](const Pair& a, const Pair& b) {
+            return std::make_pair(a.second, a.first) < std::make_pair(b.second, b.first);
+        });
 
-        // Initialize the matching interface
-        matching::RegionsDatabaseMatcher matcher(randomNumberGenerator, _matcherType, regionsI);
-
-#pragma omp parallel for schedule(dynamic) if (b_multithreaded_pair_search)
-        for (int j = 0; j < (int)indexToCompare.size(); ++j)
+        std::size_t tileBegin = 0;
+        while (tileBegin < blockPairs.size())
         {
-            const size_t J = indexToCompare[j];
-
-            const feature::Regions& regionsJ = regionsPerView.getRegions(J, descType);
-            if (regionsJ.RegionCount() == 0 || regionsI.Type_id() != regionsJ.Type_id())
+            // the pairs of the next tileSize columns
+            std::vector<size_t> tileColumnViewIds;
+            std::size_t tileEnd = tileBegin;
+            for (; tileEnd < blockPairs.size(); ++tileEnd)
             {
-                ++progressDisplay;
-                continue;
+                const size_t J = blockPairs[tileEnd].second;
+                if (tileColumnViewIds.empty() || tileColumnViewIds.back() != J)
+                {
+                    if (tileColumnViewIds.size() == tileSize)
+                        break;
+                    tileColumnViewIds.push_back(J);
+                }
             }
 
-            IndMatches vec_putatives_matches;
-            matcher.Match(_f_dist_ratio, regionsJ, vec_putatives_matches);
-
             if (_useCrossMatching)
-            {
-                // Initialize the matching interface
-                matching::RegionsDatabaseMatcher matcherCross(randomNumberGenerator, _matcherType, regionsJ);
+                buildMatchers(
+                  randomNumberGenerator, _matcherType, regionsPerView, descTypes, tileColumnViewIds, _kdTreeIndexCacheFolder, matchersCache, columnMatchers);
 
-                IndMatches vec_putatives_matches_cross;
-                matcherCross.Match(_f_dist_ratio, regionsI, vec_putatives_matches_cross);
+#pragma omp parallel for schedule(dynamic) if (b_multithreaded_pair_search)
+            for (int t = (int)tileBegin * nbDescTypes; t < (int)tileEnd * nbDescTypes; ++t)
+            {
+                const size_t I = blockPairs[t / nbDescTypes].first;
+                const size_t J = blockPairs[t / nbDescTypes].second;
+                const feature::EImageDescriberType descType = descTypes[t % nbDescTypes];
 
-                // Create a dictionnary of matches indexed by their pair of indexes
-                std::map<std::pair<int, int>, IndMatch> check_matches;
-                for (IndMatch& m : vec_putatives_matches_cross)
+                const auto matcherIt = rowMatchers.find(std::make_pair(I, descType));
+                const feature::Regions& regionsJ = regionsPerView.getRegions(J, descType);
+                if (matcherIt == rowMatchers.end() || regionsJ.RegionCount() == 0 ||
+                    matcherIt->second->getDatabaseRegions().Type_id() != regionsJ.Type_id())
                 {
-                    std::pair<int, int> key = std::make_pair(m._i, m._j);
-                    check_matches[key] = m;
+#pragma omp critical
+                    ++progressDisplay;
+                    continue;
                 }
 
-                IndMatches vec_putatives_matches_checked;
-                for (IndMatch& m : vec_putatives_matches)
+                IndMatches vec_putatives_matches;
+                matcherIt->second->Match(_f_dist_ratio, regionsJ, vec_putatives_matches);
+
+                if (_useCrossMatching)
                 {
-                    // Check with reversed key (images are swapped)
-                    std::pair<int, int> key = std::make_pair(m._j, m._i);
-                    if (check_matches.find(key) != check_matches.end())
-                    {
-                        vec_putatives_matches_checked.push_back(m);
-                    }
+                    IndMatches vec_putatives_matches_cross;
+                    columnMatchers.at(std::make_pair(J, descType))->Match(_f_dist_ratio, matcherIt->second->getDatabaseRegions(), vec_putatives_matches_cross);
+                    keepCrossMatches(vec_putatives_matches_cross, vec_putatives_matches);
                 }
 
-                std::swap(vec_putatives_matches, vec_putatives_matches_checked);
-            }
-
 #pragma omp critical
-            {
-                ++progressDisplay;
-                if (!vec_putatives_matches.empty())
                 {
-                    map_PutativesMatches[std::make_pair(I, J)].emplace(descType, std::move(vec_putatives_matches));
+                    ++progressDisplay;
+                    if (!vec_putatives_matches.empty())
+                    {
+                        map_PutativesMatches[std::make_pair(I, J)].emplace(descType, std::move(vec_putatives_matches));
+                    }
                 }
             }
+            tileBegin = tileEnd;
         }
     }
 }
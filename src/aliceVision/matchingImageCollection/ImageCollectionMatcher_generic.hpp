@@ -9,6 +9,8 @@
 
 #include "aliceVision/matchingImageCollection/IImageCollectionMatcher.hpp"
 
+#include <string>
+
 namespace aliceVision {
 namespace matchingImageCollection {
 
@@ -23,7 +25,13 @@ namespace matchingImageCollection {
 class ImageCollectionMatcher_generic : public IImageCollectionMatcher
 {
   public:
-    ImageCollectionMatcher_generic(float dist_ratio, bool crossMatching, matching::EMatcherType matcherType);
+    /**
+     * @param[in] kdTreeIndexCacheFolder the folder of the serialized kd-tree indexes of ANN_L2, no serialization if empty
+     */
+    ImageCollectionMatcher_generic(float dist_ratio,
+                                   bool crossMatching,
+                                   matching::EMatcherType matcherType,
+                                   const std::string& kdTreeIndexCacheFolder = "");
 
     /// Find corresponding points between some pair of view Ids
     void Match(std::mt19937& randomNumberGenerator,
@@ -33,6 +41,15 @@ class ImageCollectionMatcher_generic : public IImageCollectionMatcher
                matching::PairwiseMatches& map_PutativesMatches  // the pairwise photometric corresponding points
     ) const;
 
+    /// Find corresponding points between some pair of view Ids,
+    /// the pairs and describer types are matched concurrently and the matchers of a view are built together for all describer types
+    void Match(std::mt19937& randomNumberGenerator,
+               const feature::RegionsPerView& regionsPerView,
+               const PairSet& pairs,
+               const std::vector<feature::EImageDescriberType>& descTypes,
+               matching::PairwiseMatches& map_PutativesMatches  // the pairwise photometric corresponding points
+    ) const;
+
   private:
     // Distance ratio used to discard spurious correspondence
     float _f_dist_ratio;
@@ -40,6 +57,8 @@ class ImageCollectionMatcher_generic : public IImageCollectionMatcher
     bool _useCrossMatching;
     // Matcher Type
     matching::EMatcherType _matcherType;
+    // Folder of the serialized kd-tree indexes
+    std::string _kdTreeIndexCacheFolder;
 };
 
 }  // namespace matchingImageCollection
@@ -16,7 +16,11 @@
 namespace aliceVision {
 namespace matchingImageCollection {
 
-std::unique_ptr<IImageCollectionMatcher> createImageCollectionMatcher(matching::EMatcherType matcherType, float distRatio, bool crossMatching)
+std::unique_ptr<IImageCollectionMatcher> createImageCollectionMatcher(matching::EMatcherType matcherType,
+                                                                      float distRatio,
+                                                                      bool crossMatching,
+                                                                      const std::string& cascadeHashingCacheFolder,
+                                                                      const std::string& kdTreeIndexCacheFolder)
 {
     std::unique_ptr<IImageCollectionMatcher> matcherPtr;
 
@@ -26,17 +30,23 @@ std::unique_ptr<IImageCollectionMatcher> createImageCollectionMatcher(matching::
             matcherPtr.reset(new ImageCollectionMatcher_generic(distRatio, crossMatching, matching::BRUTE_FORCE_L2));
             break;
         case matching::ANN_L2:
-            matcherPtr.reset(new ImageCollectionMatcher_generic(distRatio, crossMatching, matching::ANN_L2));
+            matcherPtr.reset(new ImageCollectionMatcher_generic(distRatio, crossMatching, matching::ANN_L2, kdTreeIndexCacheFolder));
             break;
         case matching::CASCADE_HASHING_L2:
             matcherPtr.reset(new ImageCollectionMatcher_generic(distRatio, crossMatching, matching::CASCADE_HASHING_L2));
             break;
         case matching::FAST_CASCADE_HASHING_L2:
-            matcherPtr.reset(new ImageCollectionMatcher_cascadeHashing(distRatio));
+            matcherPtr.reset(new ImageCollectionMatcher_cascadeHashing(distRatio, cascadeHashingCacheFolder));
             break;
         case matching::BRUTE_FORCE_HAMMING:
             matcherPtr.reset(new ImageCollectionMatcher_generic(distRatio, crossMatching, matching::BRUTE_FORCE_HAMMING));
             break;
+        case matching::BLOCKED_BRUTE_FORCE_L2:
+            matcherPtr.reset(new ImageCollectionMatcher_generic(distRatio, crossMatching, matching::BLOCKED_BRUTE_FORCE_L2));
+            break;
+        case matching::PRODUCT_QUANTIZATION_L2:
+            matcherPtr.reset(new ImageCollectionMatcher_generic(distRatio, crossMatching, matching::PRODUCT_QUANTIZATION_L2));
+            break;
 
         default:
             throw std::out_of_range("Invalid matcherType enum");
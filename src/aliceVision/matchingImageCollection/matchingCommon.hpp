@@ -10,15 +10,23 @@
 #include "aliceVision/matching/matcherType.hpp"
 #include "aliceVision/matchingImageCollection/IImageCollectionMatcher.hpp"
 
+#include <string>
+
 namespace aliceVision {
 namespace matchingImageCollection {
 
 /**
  *
  * @param matcherType
+ * @param cascadeHashingCacheFolder the folder of the cached hashed descriptions of FAST_CASCADE_HASHING_L2, no cache if empty
+ * @param kdTreeIndexCacheFolder the folder of the serialized kd-tree indexes of ANN_L2, no serialization if empty
  * @return
  */
-std::unique_ptr<IImageCollectionMatcher> createImageCollectionMatcher(matching::EMatcherType matcherType, float distRatio, bool crossMatching);
+std::unique_ptr<IImageCollectionMatcher> createImageCollectionMatcher(matching::EMatcherType matcherType,
+                                                                      float distRatio,
+                                                                      bool crossMatching,
+                                                                      const std::string& cascadeHashingCacheFolder = "",
+                                                                      const std::string& kdTreeIndexCacheFolder = "");
 
 }  // namespace matchingImageCollection
 }  // namespace aliceVision
\ No newline at end of file
@@ -45,4 +45,22 @@ PairSet exhaustivePairs(const sfmData::Views& views, int rangeStart, int rangeSi
     return pairs;
 }
 
+PairSet getNewViewsPairs(const PairSet& pairs, const PairSet& existingPairs)
+{
+    std::set<IndexT> existingViews;
+    for (const Pair& pair : existingPairs)
+    {
+        existingViews.insert(pair.first);
+        existingViews.insert(pair.second);
+    }
+
+    PairSet newPairs;
+    for (const Pair& pair : pairs)
+    {
+        if (!existingViews.count(pair.first) || !existingViews.count(pair.second))
+            newPairs.insert(pair);
+    }
+    return newPairs;
+}
+
 };  // namespace aliceVision
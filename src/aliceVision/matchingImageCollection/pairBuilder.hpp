@@ -16,4 +16,13 @@ namespace aliceVision {
 /// Generate all the (I,J) pairs of the upper diagonal of the NxN matrix
 PairSet exhaustivePairs(const sfmData::Views& views, int rangeStart = -1, int rangeSize = 0);
 
+/**
+ * @brief Select the pairs of an incremental matching.
+ * @note The views missing from the existing pairs are the new views. Pairs are compared whatever their order.
+ * @param[in] pairs the candidate pairs
+ * @param[in] existingPairs the pairs of the previous matching
+ * @return the candidate pairs with at least one new view
+ */
+PairSet getNewViewsPairs(const PairSet& pairs, const PairSet& existingPairs);
+
 };  // namespace aliceVision
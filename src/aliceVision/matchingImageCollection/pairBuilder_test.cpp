@@ -58,3 +58,18 @@ BOOST_AUTO_TEST_CASE(matchingImageCollection_exhaustivePairs)
         BOOST_CHECK(pairSet.find(std::make_pair(65, 89)) != pairSet.end());
     }
 }
+
+BOOST_AUTO_TEST_CASE(matchingImageCollection_getNewViewsPairs)
+{
+    // views 0, 1 and 2 were matched, 3 and 4 are new
+    const PairSet existingPairs = {{0, 1}, {2, 1}};
+    const PairSet pairs = {{0, 1}, {0, 2}, {1, 2}, {0, 3}, {3, 4}, {2, 4}};
+
+    const PairSet newPairs = getNewViewsPairs(pairs, existingPairs);
+
+    const PairSet expectedPairs = {{0, 3}, {3, 4}, {2, 4}};
+    BOOST_CHECK(newPairs == expectedPairs);
+
+    // without existing pairs, all the pairs are new
+    BOOST_CHECK(getNewViewsPairs(pairs, PairSet()) == pairs);
+}
@@ -6,6 +6,10 @@
 
 #include "Mesh.hpp"
 #include <aliceVision/system/Logger.hpp>
+#include <aliceVision/mesh/geoMesh.hpp>
+#include <aliceVision/mesh/meshBinaryIO.hpp>
+#include <aliceVision/mesh/MeshTopology.hpp>
+#include <aliceVision/mesh/meshRasterization.hpp>
 #include <aliceVision/mesh/meshVisibility.hpp>
 #include <aliceVision/mvsData/geometry.hpp>
 #include <aliceVision/mvsData/OrientedPoint.hpp>
@@ -34,6 +38,64 @@ Mesh::Mesh() {}
 
 Mesh::~Mesh() {}
 
+void Mesh::checkSpatialIndexes() const
+{
+    // the mutex is locked by the caller
+    if (_spatialIndexes.ptsData != pts.getData().data() || _spatialIndexes.nbPts != pts.size() ||
+        _spatialIndexes.trisData != tris.getData().data() || _spatialIndexes.nbTris != tris.size())
+    {
+        _spatialIndexes.verticesKdTree.reset();
+        _spatialIndexes.facetsAABB.reset();
+        _spatialIndexes.ptsData = pts.getData().data();
+        _spatialIndexes.nbPts = pts.size();
+        _spatialIndexes.trisData = tris.getData().data();
+        _spatialIndexes.nbTris = tris.size();
+    }
+}
+
+std::shared_ptr<const GEO::AdaptiveKdTree> Mesh::getVerticesKdTree() const
+{
+    std::lock_guard<std::mutex> lock(_spatialIndexes.mutex);
+    checkSpatialIndexes();
+    if (_spatialIndexes.verticesKdTree == nullptr)
+    {
+        ALICEVISION_LOG_DEBUG("Build mesh vertices kd-tree (" << pts.size() << " vertices).");
+        auto kdTree = std::make_shared<GEO::AdaptiveKdTree>(3);
+        if (!pts.empty())
+            kdTree->set_points(pts.size(), pts.front().m);
+        _spatialIndexes.verticesKdTree = kdTree;
+    }
+    return _spatialIndexes.verticesKdTree;
+}
+
+std::shared_ptr<const GeoMeshFacetsAABB> Mesh::getFacetsAABB() const
+{
+    std::lock_guard<std::mutex> lock(_spatialIndexes.mutex);
+    checkSpatialIndexes();
+    if (_spatialIndexes.facetsAABB == nullptr)
+    {
+        ALICEVISION_LOG_DEBUG("Build mesh triangles AABB tree (" << tris.size() << " triangles).");
+        GEO::initialize();
+        _spatialIndexes.facetsAABB = std::make_shared<GeoMeshFacetsAABB>(*this);
+    }
+    return _spatialIndexes.facetsAABB;
+}
+
+std::shared_ptr<const MeshTopology> Mesh::getTopology() const
+{
+    std::lock_guard<std::mutex> lock(_topology.mutex);
+    if (_topology.topology == nullptr || _topology.trisData != tris.getData().data() || _topology.nbTris != tris.size() ||
+        _topology.nbPts != pts.size())
+    {
+        ALICEVISION_LOG_DEBUG("Build mesh topology (" << pts.size() << " vertices, " << tris.size() << " triangles).");
+        _topology.topology = std::make_shared<MeshTopology>(*this);
+        _topology.trisData = tris.getData().data();
+        _topology.nbTris = tris.size();
+        _topology.nbPts = pts.size();
+    }
+    return _topology.topology;
+}
+
 std::string EFileType_enumToString(const EFileType meshFileType)
 {
     switch (meshFileType)
@@ -77,6 +139,13 @@ std::istream& operator>>(std::istream& in, EFileType& meshFileType)
 
 void Mesh::save(const std::string& filepath)
 {
+    if (isBinaryMeshFile(filepath))
+    {
+        ALICEVISION_LOG_INFO("Save binary mesh file");
+        saveBinaryMesh(*this, filepath);
+        return;
+    }
+
     const std::string fileTypeStr = boost::filesystem::path(filepath).extension().string().substr(1);
     const EFileType fileType = mesh::EFileType_stringToEnum(fileTypeStr);
 
@@ -538,87 +607,49 @@ bool Mesh::doesTriangleIntersectsRectangle(Mesh::triangle_proj& tp, Mesh::rectan
 
 void Mesh::getPtsNeighborTriangles(StaticVector<StaticVector<int>>& out_ptsNeighTris) const
 {
-    // array of tuples <x: vertexIndex, y: triangleIndex, z: numberOfNeighbors>
-    StaticVector<Voxel> vertexNeighborhoodPairs;
-    vertexNeighborhoodPairs.reserve(tris.size() * 3);
-    for (int i = 0; i < tris.size(); ++i)
-    {
-        vertexNeighborhoodPairs.push_back(Voxel(tris[i].v[0], i, 0));
-        vertexNeighborhoodPairs.push_back(Voxel(tris[i].v[1], i, 0));
-        vertexNeighborhoodPairs.push_back(Voxel(tris[i].v[2], i, 0));
-    }
-    qsort(&vertexNeighborhoodPairs[0], vertexNeighborhoodPairs.size(), sizeof(Voxel), qSortCompareVoxelByXAsc);
+    const std::shared_ptr<const MeshTopology> topology = getTopology();
 
-    int i = 0;  // index of the unique pair of <vertex, neighborhood>
-    int j = 0;  // index of the vertex
-    int k = 0;  // number of neighbors
-    int firstid = 0;
-    while (i < vertexNeighborhoodPairs.size())
-    {
-        ++k;
-        // (*vertexNeighborhoodPairs)[i].z = j;
-        if ((i == vertexNeighborhoodPairs.size() - 1) || (vertexNeighborhoodPairs[i].x != vertexNeighborhoodPairs[i + 1].x))
-        {
-            vertexNeighborhoodPairs[firstid].z = k;  // store the number of neighbors
-            ++j;
-            firstid = i + 1;
-            k = 0;
-        }
-        ++i;
-    }
-    int npts = j;
-
-    out_ptsNeighTris.reserve(pts.size());
     out_ptsNeighTris.resize(pts.size());
-
-    i = 0;
-    for (j = 0; j < npts; ++j)
+    for (int ptId = 0; ptId < pts.size(); ++ptId)
     {
-        int middlePtId = vertexNeighborhoodPairs[i].x;
-        int nbNeighbors = vertexNeighborhoodPairs[i].z;
-        int i0 = i;
-        int i1 = i + nbNeighbors;
-        i = i1;
-
-        StaticVector<int>& triTmp = out_ptsNeighTris[middlePtId];
-        triTmp.reserve(nbNeighbors);
-        for (int l = i0; l < i1; ++l)
-        {
-            triTmp.push_back(vertexNeighborhoodPairs[l].y);  // index of triangle
-        }
+        const MeshTopology::Range vertexTris = topology->getVertexTriangles(ptId);
+        StaticVector<int>& triTmp = out_ptsNeighTris[ptId];
+        triTmp.clear();
+        triTmp.reserve(vertexTris.size());
+        for (const int triId : vertexTris)
+            triTmp.push_back(triId);
     }
 }
 
 void Mesh::getPtsNeighbors(std::vector<std::vector<int>>& out_ptsNeigh) const
 {
+    const std::shared_ptr<const MeshTopology> topology = getTopology();
+
     out_ptsNeigh.resize(pts.size());
-    for (int triangleId = 0; triangleId < tris.size(); ++triangleId)
+    for (int ptId = 0; ptId < pts.size(); ++ptId)
     {
-        const Mesh::triangle& triangle = tris[triangleId];
-        for (int k = 0; k < 3; ++k)
-        {
-            int ptId = triangle.v[k];
-            std::vector<int>& ptNeigh = out_ptsNeigh[ptId];
-            if (std::find(ptNeigh.begin(), ptNeigh.end(), triangle.v[(k + 1) % 3]) == ptNeigh.end())
-                ptNeigh.push_back(triangle.v[(k + 1) % 3]);
-            if (std::find(ptNeigh.begin(), ptNeigh.end(), triangle.v[(k + 2) % 3]) == ptNeigh.end())
-                ptNeigh.push_back(triangle.v[(k + 2) % 3]);
-        }
+        const MeshTopology::Range neighbors = topology->getVertexNeighbors(ptId);
+        out_ptsNeigh[ptId].assign(neighbors.begin(), neighbors.end());
     }
 }
 
 void Mesh::getPtsNeighPtsOrdered(StaticVector<StaticVector<int>>& out_ptsNeighPts) const
 {
-    StaticVector<StaticVector<int>> ptsNeighborTriangles;
-    getPtsNeighborTriangles(ptsNeighborTriangles);
+    const std::shared_ptr<const MeshTopology> topology = getTopology();
 
     out_ptsNeighPts.resize(pts.size());
 
+    StaticVector<int> neighborTriangles;
     for (int middlePtId = 0; middlePtId < pts.size(); ++middlePtId)
     {
-        StaticVector<int>& neighborTriangles = ptsNeighborTriangles[middlePtId];
-        if (neighborTriangles.empty())
+        const MeshTopology::Range vertexTris = topology->getVertexTriangles(middlePtId);
+        if (vertexTris.empty())
             continue;
+        // copy the triangles, they are removed while walking around the vertex
+        neighborTriangles.clear();
+        neighborTriangles.reserve(vertexTris.size());
+        for (const int triId : vertexTris)
+            neighborTriangles.push_back(triId);
 
         StaticVector<int> vhid;
         vhid.reserve(neighborTriangles.size() * 2);
@@ -687,77 +718,17 @@ void Mesh::getPtsNeighPtsOrdered(StaticVector<StaticVector<int>>& out_ptsNeighPt
     }
 }
 
-void Mesh::getTrisMap(StaticVector<StaticVector<int>>& out, const mvsUtils::MultiViewParams& mp, int rc, int /*scale*/, int w, int h)
+void Mesh::getTrisMap(CompactJaggedArray<int>& out, const mvsUtils::MultiViewParams& mp, int rc, int scale, int w, int h)
 {
-    long tstart = clock();
-
-    ALICEVISION_LOG_INFO("getTrisMap.");
-    StaticVector<int> nmap;
-    nmap.reserve(w * h);
-    nmap.resize_with(w * h, 0);
-
-    long t1 = mvsUtils::initEstimate();
+    StaticVector<int> allTris;
+    allTris.reserve(tris.size());
     for (int i = 0; i < tris.size(); ++i)
-    {
-        triangle_proj tp = getTriangleProjection(i, mp, rc, w, h);
-        if ((isTriangleProjectionInImage(mp, tp, rc, 0)))
-        {
-            Pixel pix;
-            for (pix.x = tp.lu.x; pix.x <= tp.rd.x; ++pix.x)
-            {
-                for (pix.y = tp.lu.y; pix.y <= tp.rd.y; ++pix.y)
-                {
-                    Mesh::rectangle re = Mesh::rectangle(pix, 1);
-                    if (doesTriangleIntersectsRectangle(tp, re))
-                    {
-                        nmap[pix.x * h + pix.y] += 1;
-                    }
-                }  // for y
-            }      // for x
-        }          // isthere
-        mvsUtils::printfEstimate(i, tris.size(), t1);
-    }  // for i ntris
-    mvsUtils::finishEstimate();
+        allTris.push_back(i);
 
-    // allocate
-    out.reserve(w * h);
-    out.resize(w * h);
-    for (int i = 0; i < w * h; ++i)
-    {
-        if (nmap[i] > 0)
-        {
-            out[i].reserve(nmap[i]);
-        }
-    }
-
-    // fill
-    t1 = mvsUtils::initEstimate();
-    for (int i = 0; i < tris.size(); ++i)
-    {
-        triangle_proj tp = getTriangleProjection(i, mp, rc, w, h);
-        if ((isTriangleProjectionInImage(mp, tp, rc, 0)))
-        {
-            Pixel pix;
-            for (pix.x = tp.lu.x; pix.x <= tp.rd.x; ++pix.x)
-            {
-                for (pix.y = tp.lu.y; pix.y <= tp.rd.y; ++pix.y)
-                {
-                    Mesh::rectangle re = Mesh::rectangle(pix, 1);
-                    if (doesTriangleIntersectsRectangle(tp, re))
-                    {
-                        out[pix.x * h + pix.y].push_back(i);
-                    }
-                }  // for y
-            }      // for x
-        }          // isthere
-        mvsUtils::printfEstimate(i, tris.size(), t1);
-    }  // for i ntris
-    mvsUtils::finishEstimate();
-
-    mvsUtils::printfElapsedTime(tstart);
+    getTrisMap(out, allTris, mp, rc, scale, w, h);
 }
 
-void Mesh::getTrisMap(StaticVector<StaticVector<int>>& out,
+void Mesh::getTrisMap(CompactJaggedArray<int>& out,
                       StaticVector<int>& visTris,
                       const mvsUtils::MultiViewParams& mp,
                       int rc,
@@ -768,17 +739,17 @@ void Mesh::getTrisMap(StaticVector<StaticVector<int>>& out,
     long tstart = clock();
 
     ALICEVISION_LOG_INFO("getTrisMap.");
-    StaticVector<int> nmap;
-    nmap.reserve(w * h);
-    nmap.resize_with(w * h, 0);
 
-    long t1 = mvsUtils::initEstimate();
-    for (int m = 0; m < visTris.size(); ++m)
-    {
-        int i = visTris[m];
-        triangle_proj tp = getTriangleProjection(i, mp, rc, w, h);
-        if ((isTriangleProjectionInImage(mp, tp, rc, 0)))
+    // call func(pixelIndex, triangleIndex) for each pixel intersected by each triangle
+    const auto forEachTrianglePixel = [&](const auto& func) {
+#pragma omp parallel for schedule(dynamic, 64)
+        for (int m = 0; m < visTris.size(); ++m)
         {
+            const int i = visTris[m];
+            triangle_proj tp = getTriangleProjection(i, mp, rc, w, h);
+            if (!isTriangleProjectionInImage(mp, tp, rc, 0))
+                continue;
+
             Pixel pix;
             for (pix.x = tp.lu.x; pix.x <= tp.rd.x; ++pix.x)
             {
@@ -786,63 +757,53 @@ void Mesh::getTrisMap(StaticVector<StaticVector<int>>& out,
                 {
                     Mesh::rectangle re = Mesh::rectangle(pix, 1);
                     if (doesTriangleIntersectsRectangle(tp, re))
-                    {
-                        nmap[pix.x * h + pix.y] += 1;
-                    }
-                }  // for y
-            }      // for x
-        }          // isthere
-        mvsUtils::printfEstimate(i, tris.size(), t1);
-    }  // for i ntris
-    mvsUtils::finishEstimate();
-
-    // allocate
-    out.resize(w * h);
-    for (int i = 0; i < w * h; ++i)
-    {
-        if (nmap[i] > 0)
-        {
-            out[i].reserve(nmap[i]);
+                        func(pix.x * h + pix.y, i);
+                }
+            }
         }
-    }
+    };
 
-    // fill
-    t1 = mvsUtils::initEstimate();
-    for (int m = 0; m < visTris.size(); ++m)
-    {
-        int i = visTris[m];
-        triangle_proj tp = getTriangleProjection(i, mp, rc, w, h);
-        if ((isTriangleProjectionInImage(mp, tp, rc, 0)))
-        {
-            Pixel pix;
-            for (pix.x = tp.lu.x; pix.x <= tp.rd.x; ++pix.x)
-            {
-                for (pix.y = tp.lu.y; pix.y <= tp.rd.y; ++pix.y)
-                {
-                    Mesh::rectangle re = Mesh::rectangle(pix, 1);
-                    if (doesTriangleIntersectsRectangle(tp, re))
-                    {
-                        out[pix.x * h + pix.y].push_back(i);
-                    }
-                }  // for y
-            }      // for x
-        }          // isthere
-        mvsUtils::printfEstimate(i, tris.size(), t1);
-    }  // for i ntris
-    mvsUtils::finishEstimate();
+    CompactJaggedArray<int>::Builder builder(w * h);
+    forEachTrianglePixel([&](int pixelIndex, int) { builder.count(pixelIndex); });
+    builder.allocate();
+    forEachTrianglePixel([&](int pixelIndex, int triIndex) { builder.add(pixelIndex, triIndex); });
+
+    out = builder.build();
+    // parallel fill: restore the triangles order
+    out.sortRows();
 
     mvsUtils::printfElapsedTime(tstart);
 }
 
-void Mesh::getDepthMap(StaticVector<float>& depthMap, const mvsUtils::MultiViewParams& mp, int rc, int scale, int w, int h)
+void Mesh::getDepthMap(StaticVector<float>& depthMap, const mvsUtils::MultiViewParams& mp, int rc, int /*scale*/, int w, int h)
 {
-    StaticVector<StaticVector<int>> tmp;
-    getTrisMap(tmp, mp, rc, scale, w, h);
-    getDepthMap(depthMap, tmp, mp, rc, scale, w, h);
+    TrianglesIdsMap trisIdsMap;
+    rasterizeTrianglesIds(*this, mp, rc, w, h, trisIdsMap);
+
+    const double sx = double(w) / double(mp.getWidth(rc));
+    const double sy = double(h) / double(mp.getHeight(rc));
+
+    depthMap.resize_with(w * h, -1.0f);
+
+#pragma omp parallel for
+    for (int y = 0; y < h; ++y)
+    {
+        for (int x = 0; x < w; ++x)
+        {
+            const int idTri = trisIdsMap.getTriangleId(x, y);
+            if (idTri < 0)
+                continue;
+
+            // distance from the camera center to the nearest triangle along the pixel ray
+            const Point2d p((x + 0.5) / sx - 0.5, (y + 0.5) / sy - 0.5);
+            const Point3d lpi = linePlaneIntersect(mp.CArr[rc], (mp.iCamArr[rc] * p).normalize(), pts[tris[idTri].v[0]], computeTriangleNormal(idTri));
+            depthMap[x * h + y] = (mp.CArr[rc] - lpi).size();
+        }
+    }
 }
 
 void Mesh::getDepthMap(StaticVector<float>& depthMap,
-                       StaticVector<StaticVector<int>>& tmp,
+                       const CompactJaggedArray<int>& trisMap,
                        const mvsUtils::MultiViewParams& mp,
                        int rc,
                        int scale,
@@ -856,7 +817,7 @@ void Mesh::getDepthMap(StaticVector<float>& depthMap,
     {
         for (pix.y = 0; pix.y < h; ++pix.y)
         {
-            StaticVector<int>& ti = tmp[pix.x * h + pix.y];
+            const CompactJaggedArray<int>::ConstRow ti = trisMap[pix.x * h + pix.y];
             if (!ti.empty())
             {
                 Point2d p;
@@ -952,7 +913,7 @@ void Mesh::getVisibleTrianglesIndexes(StaticVector<int>& out_visTri,
 {
     StaticVector<float> depthMap;
     loadArrayFromFile<float>(depthMap, depthMapFilepath);
-    StaticVector<StaticVector<int>> trisMap;
+    CompactJaggedArray<int> trisMap;
     loadArrayOfArraysFromFile<int>(trisMap, trisMapFilepath);
 
     getVisibleTrianglesIndexes(out_visTri, trisMap, depthMap, mp, rc, w, h);
@@ -970,12 +931,26 @@ void Mesh::getVisibleTrianglesIndexes(StaticVector<int>& out_visTri,
 
     StaticVector<float> depthMap;
     loadArrayFromFile<float>(depthMap, depthMapFilepath);
-    StaticVector<StaticVector<int>> trisMap;
+    CompactJaggedArray<int> trisMap;
     loadArrayOfArraysFromFile<int>(trisMap, trisMapFilepath);
 
     getVisibleTrianglesIndexes(out_visTri, trisMap, depthMap, mp, rc, w, h);
 }
 
+void Mesh::getVisibleTrianglesIndexes(StaticVector<int>& out_visTri, const mvsUtils::MultiViewParams& mp, int rc, int w, int h)
+{
+    TrianglesIdsMap trisIdsMap;
+    rasterizeTrianglesIds(*this, mp, rc, w, h, trisIdsMap);
+
+    std::vector<int> visibleTriangles;
+    getVisibleTriangles(trisIdsMap, visibleTriangles);
+
+    out_visTri.clear();
+    out_visTri.reserve(visibleTriangles.size());
+    for (const int idTri : visibleTriangles)
+        out_visTri.push_back(idTri);
+}
+
 void Mesh::getVisibleTrianglesIndexes(StaticVector<int>& out_visTri,
                                       StaticVector<float>& depthMap,
                                       const mvsUtils::MultiViewParams& mp,
@@ -1009,7 +984,7 @@ void Mesh::getVisibleTrianglesIndexes(StaticVector<int>& out_visTri,
 }
 
 void Mesh::getVisibleTrianglesIndexes(StaticVector<int>& out_visTri,
-                                      StaticVector<StaticVector<int>>& trisMap,
+                                      const CompactJaggedArray<int>& trisMap,
                                       StaticVector<float>& depthMap,
                                       const mvsUtils::MultiViewParams& mp,
                                       int rc,
@@ -1028,7 +1003,7 @@ void Mesh::getVisibleTrianglesIndexes(StaticVector<int>& out_visTri,
     {
         for (pix.y = 0; pix.y < h; ++pix.y)
         {
-            StaticVector<int>& ti = trisMap[pix.x * h + pix.y];
+            const CompactJaggedArray<int>::ConstRow ti = trisMap[pix.x * h + pix.y];
             if (!ti.empty())
             {
                 Point2d p;
@@ -1281,6 +1256,7 @@ void Mesh::laplacianSmoothPts(StaticVector<StaticVector<int>>& ptsNeighPts, doub
     {
         pts[i] = pts[i] + nms[i];
     }
+    invalidateSpatialIndexes();
 }
 
 Point3d Mesh::computeTriangleNormal(int idTri) const
@@ -1309,9 +1285,38 @@ double Mesh::computeTriangleMinEdgeLength(int idTri) const
 
 void Mesh::computeNormalsForPts(StaticVector<Point3d>& out_nms) const
 {
-    StaticVector<StaticVector<int>> ptsNeighTris;
-    getPtsNeighborTriangles(ptsNeighTris);
-    computeNormalsForPts(ptsNeighTris, out_nms);
+    const std::shared_ptr<const MeshTopology> topology = getTopology();
+
+    out_nms.resize_with(pts.size(), Point3d(0.0f, 0.0f, 0.0f));
+
+#pragma omp parallel for
+    for (int i = 0; i < pts.size(); ++i)
+    {
+        const MeshTopology::Range vertexTris = topology->getVertexTriangles(i);
+        if (vertexTris.empty())
+            continue;
+
+        Point3d n = Point3d(0.0f, 0.0f, 0.0f);
+        float nn = 0.0f;
+        for (const int triId : vertexTris)
+        {
+            const Point3d n1 = computeTriangleNormal(triId);
+            if (!std::isnan(n1.x) && !std::isnan(n1.y) && !std::isnan(n1.z))  // check if is not NaN
+            {
+                n = n + n1;
+                nn += 1.0f;
+            }
+        }
+        n = n / nn;
+
+        n = n.normalize();
+        if (std::isnan(n.x) || std::isnan(n.y) || std::isnan(n.z))  // check if is not NaN
+        {
+            n = Point3d(0.0f, 0.0f, 0.0f);
+        }
+
+        out_nms[i] = n;
+    }
 }
 
 void Mesh::computeNormalsForPts(StaticVector<StaticVector<int>>& ptsNeighTris, StaticVector<Point3d>& out_nms) const
@@ -1667,8 +1672,8 @@ int Mesh::subdivideMesh(const Mesh& refMesh, float ratioSubdiv, bool remapVisibi
     ALICEVISION_LOG_INFO("nb points in refMesh: " << refMesh.pts.size());
     ALICEVISION_LOG_INFO("targetNbPts: " << targetNbPts);
 
-    GEO::AdaptiveKdTree refMesh_kdTree(3);
-    refMesh_kdTree.set_points(refMesh.pts.size(), refMesh.pts.front().m);
+    const std::shared_ptr<const GEO::AdaptiveKdTree> refMeshKdTreePtr = refMesh.getVerticesKdTree();
+    const GEO::AdaptiveKdTree& refMesh_kdTree = *refMeshKdTreePtr;
 
     int nbAllSubdiv = 0;
     int nsubd = 0;
@@ -1914,14 +1919,12 @@ void Mesh::letJustTringlesIdsInMesh(const StaticVectorBool& trisToStay)
     tris.swap(trisTmp);
 }
 
-void Mesh::computeTrisCams(StaticVector<StaticVector<int>>& trisCams, const mvsUtils::MultiViewParams& mp, const std::string tmpDir)
+void Mesh::computeTrisCams(CompactJaggedArray<int>& trisCams, const mvsUtils::MultiViewParams& mp, const std::string tmpDir)
 {
     if (mp.verbose)
         ALICEVISION_LOG_DEBUG("Computing tris cams.");
 
-    StaticVector<int> ntrisCams;
-    ntrisCams.reserve(tris.size());
-    ntrisCams.resize_with(tris.size(), 0);
+    CompactJaggedArray<int>::Builder builder(tris.size());
 
     long t1 = mvsUtils::initEstimate();
     for (int rc = 0; rc < mp.ncams; ++rc)
@@ -1929,69 +1932,74 @@ void Mesh::computeTrisCams(StaticVector<StaticVector<int>>& trisCams, const mvsU
         std::string visTrisFilepath = tmpDir + "visTris" + std::to_string(mp.getViewId(rc)) + ".bin";
         StaticVector<int> visTris;
         loadArrayFromFile<int>(visTris, visTrisFilepath);
-        if (!visTris.empty())
-        {
-            for (int i = 0; i < visTris.size(); ++i)
-            {
-                int idTri = visTris[i];
-                ++ntrisCams[idTri];
-            }
-        }
+        for (int i = 0; i < visTris.size(); ++i)
+            builder.count(visTris[i]);
         mvsUtils::printfEstimate(rc, mp.ncams, t1);
     }
     mvsUtils::finishEstimate();
 
-    trisCams.reserve(tris.size());
-
-    for (int i = 0; i < tris.size(); ++i)
-    {
-        if (ntrisCams[i] > 0)
-        {
-            trisCams[i].reserve(ntrisCams[i]);
-        }
-    }
+    builder.allocate();
 
+    // fill in the cameras order, so each row is sorted
     t1 = mvsUtils::initEstimate();
     for (int rc = 0; rc < mp.ncams; ++rc)
     {
         std::string visTrisFilepath = tmpDir + "visTris" + std::to_string(mp.getViewId(rc)) + ".bin";
         StaticVector<int> visTris;
         loadArrayFromFile<int>(visTris, visTrisFilepath);
-        if (!visTris.empty())
-        {
-            for (int i = 0; i < visTris.size(); ++i)
-            {
-                int idTri = visTris[i];
-                trisCams[idTri].push_back(rc);
-            }
-        }
+        for (int i = 0; i < visTris.size(); ++i)
+            builder.add(visTris[i], rc);
         mvsUtils::printfEstimate(rc, mp.ncams, t1);
     }
     mvsUtils::finishEstimate();
+
+    trisCams = builder.build();
 }
 
-void Mesh::computeTrisCamsFromPtsCams(StaticVector<StaticVector<int>>& trisCams) const
+void Mesh::computeTrisCamsFromPtsCams(CompactJaggedArray<int>& trisCams) const
 {
     // TODO: try intersection
-    trisCams.reserve(tris.size());
+    const int nbTris = tris.size();
 
-    for (int idTri = 0; idTri < tris.size(); ++idTri)
-    {
+    // distinct cameras of the 3 vertices of the triangle, in the vertices order
+    const auto getTriangleCams = [&](int idTri, std::vector<int>& cams) {
         const Mesh::triangle& t = tris[idTri];
-        StaticVector<int> cams;
-
-        int maxcams = sizeOfStaticVector<int>(pointsVisibilities[t.v[0]]) + sizeOfStaticVector<int>(pointsVisibilities[t.v[1]]) +
-                      sizeOfStaticVector<int>(pointsVisibilities[t.v[2]]);
-        cams.reserve(maxcams);
+        cams.clear();
         for (int k = 0; k < 3; ++k)
         {
-            for (int i = 0; i < sizeOfStaticVector<int>(pointsVisibilities[t.v[k]]); ++i)
+            for (const int cam : pointsVisibilities[t.v[k]])
             {
-                cams.push_back_distinct(pointsVisibilities[t.v[k]][i]);
+                if (std::find(cams.begin(), cams.end(), cam) == cams.end())
+                    cams.push_back(cam);
             }
         }
-        trisCams.push_back(cams);
+    };
+
+    CompactJaggedArray<int>::Builder builder(nbTris);
+
+#pragma omp parallel
+    {
+        std::vector<int> cams;
+
+#pragma omp for
+        for (int idTri = 0; idTri < nbTris; ++idTri)
+        {
+            getTriangleCams(idTri, cams);
+            builder.count(idTri, static_cast<int>(cams.size()));
+        }
+
+#pragma omp single
+        builder.allocate();
+
+#pragma omp for
+        for (int idTri = 0; idTri < nbTris; ++idTri)
+        {
+            getTriangleCams(idTri, cams);
+            std::copy(cams.begin(), cams.end(), builder.row(idTri).begin());
+        }
     }
+
+    trisCams = builder.build();
 }
 
 void Mesh::initFromDepthMap(const mvsUtils::MultiViewParams& mp, StaticVector<float>& depthMap, int rc, int scale, float alpha)
@@ -2206,6 +2214,7 @@ void Mesh::changeTriPtId(int triId, int oldPtId, int newPtId)
             tris[triId].v[k] = newPtId;
         }
     }
+    invalidateTopology();
 }
 
 int Mesh::getTriPtIndex(int triId, int ptId, bool failIfDoesNotExists) const
@@ -2363,6 +2372,15 @@ void Mesh::load(const std::string& filepath, bool mergeCoincidentVerts, Material
         ALICEVISION_THROW_ERROR("Mesh::load: no such file: " << filepath);
     }
 
+    if (isBinaryMeshFile(filepath))
+    {
+        // the vertices are already shared and the format has no material properties
+        loadBinaryMesh(*this, filepath);
+        ALICEVISION_LOG_DEBUG("Vertices: " << pts.size());
+        ALICEVISION_LOG_DEBUG("Triangles: " << tris.size());
+        return;
+    }
+
     // see https://github.com/assimp/assimp/blob/master/include/assimp/postprocess.h#L85
     const unsigned int pFlags =
       // If this flag is not specified, no vertices are referenced by more than one face
@@ -2551,6 +2569,7 @@ void Mesh::load(const std::string& filepath, bool mergeCoincidentVerts, Material
             f.v[1] = oldToNewMap[f.v[1]];
             f.v[2] = oldToNewMap[f.v[2]];
         }
+        invalidateTopology();
     }
 
     // set number of materials used
@@ -8,6 +8,7 @@
 
 #include <aliceVision/image/Rgb.hpp>
 #include <aliceVision/mesh/Material.hpp>
+#include <aliceVision/mvsData/CompactJaggedArray.hpp>
 #include <aliceVision/mvsData/Matrix3x3.hpp>
 #include <aliceVision/mvsData/Point2d.hpp>
 #include <aliceVision/mvsData/Point3d.hpp>
@@ -16,6 +17,9 @@
 #include <aliceVision/mvsUtils/common.hpp>
 #include <aliceVision/stl/bitmask.hpp>
 
+#include <memory>
+#include <mutex>
+
 namespace GEO {
 class AdaptiveKdTree;
 }
@@ -23,6 +27,9 @@ class AdaptiveKdTree;
 namespace aliceVision {
 namespace mesh {
 
+struct GeoMeshFacetsAABB;
+struct MeshTopology;
+
 using PointVisibility = StaticVector<int>;
 using PointsVisibility = StaticVector<PointVisibility>;
 
@@ -149,6 +156,73 @@ class Mesh
     /// Per triangle material id
     std::vector<int> _trisMtlIds;
 
+  private:
+    /**
+     * @brief Spatial indexes of the mesh, built on first use.
+     * @note Copies of the mesh do not share the spatial indexes.
+     */
+    struct SpatialIndexesCache
+    {
+        std::mutex mutex;
+        std::shared_ptr<const GEO::AdaptiveKdTree> verticesKdTree;
+        std::shared_ptr<const GeoMeshFacetsAABB> facetsAABB;
+        /// vertices and triangles arrays used to build the spatial indexes
+        const Point3d* ptsData = nullptr;
+        std::size_t nbPts = 0;
+        const triangle* trisData = nullptr;
+        std::size_t nbTris = 0;
+
+        SpatialIndexesCache() = default;
+        SpatialIndexesCache(const SpatialIndexesCache&) {}
+        SpatialIndexesCache& operator=(const SpatialIndexesCache&)
+        {
+            clear();
+            return *this;
+        }
+
+        void clear()
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            verticesKdTree.reset();
+            facetsAABB.reset();
+        }
+    };
+
+    mutable SpatialIndexesCache _spatialIndexes;
+
+    /// clear the spatial indexes if the vertices or triangles arrays have been resized or reallocated
+    void checkSpatialIndexes() const;
+
+    /**
+     * @brief Vertices adjacency of the mesh, built on first use.
+     * @note Copies of the mesh do not share the topology.
+     */
+    struct TopologyCache
+    {
+        std::mutex mutex;
+        std::shared_ptr<const MeshTopology> topology;
+        /// triangles array and number of vertices used to build the topology
+        const triangle* trisData = nullptr;
+        std::size_t nbTris = 0;
+        std::size_t nbPts = 0;
+
+        TopologyCache() = default;
+        TopologyCache(const TopologyCache&) {}
+        TopologyCache& operator=(const TopologyCache&)
+        {
+            clear();
+            return *this;
+        }
+
+        void clear()
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            topology.reset();
+        }
+    };
+
+    mutable TopologyCache _topology;
+
   public:
     StaticVector<Point3d> pts;
     StaticVector<Mesh::triangle> tris;
@@ -163,16 +237,27 @@ class Mesh
     Mesh();
     ~Mesh();
 
+    /**
+     * @brief Save the mesh, the file format is given by the extension.
+     * @note The binary mesh format (.avmesh, see meshBinaryIO.hpp) also keeps the visibilities.
+     */
     void save(const std::string& filepath);
 
     bool loadFromBin(const std::string& binFilepath);
     void saveToBin(const std::string& binFilepath);
+    /**
+     * @brief Load the mesh, the file format is given by the extension.
+     * @note mergeCoincidentVerts and material are not used with the binary mesh format (.avmesh).
+     */
     void load(const std::string& filepath, bool mergeCoincidentVerts = false, Material* material = nullptr);
 
     void addMesh(const Mesh& mesh);
 
-    void getTrisMap(StaticVector<StaticVector<int>>& out, const mvsUtils::MultiViewParams& mp, int rc, int scale, int w, int h);
-    void getTrisMap(StaticVector<StaticVector<int>>& out,
+    /**
+     * @brief Get the triangles intersecting each pixel of the camera (pixel index x * h + y), sorted in ascending order.
+     */
+    void getTrisMap(CompactJaggedArray<int>& out, const mvsUtils::MultiViewParams& mp, int rc, int scale, int w, int h);
+    void getTrisMap(CompactJaggedArray<int>& out,
                     StaticVector<int>& visTris,
                     const mvsUtils::MultiViewParams& mp,
                     int rc,
@@ -190,7 +275,7 @@ class Mesh
 
     void getDepthMap(StaticVector<float>& depthMap, const mvsUtils::MultiViewParams& mp, int rc, int scale, int w, int h);
     void getDepthMap(StaticVector<float>& depthMap,
-                     StaticVector<StaticVector<int>>& tmp,
+                     const CompactJaggedArray<int>& trisMap,
                      const mvsUtils::MultiViewParams& mp,
                      int rc,
                      int scale,
@@ -201,6 +286,10 @@ class Mesh
     void getPtsNeighborTriangles(StaticVector<StaticVector<int>>& out_ptsNeighTris) const;
     void getPtsNeighPtsOrdered(StaticVector<StaticVector<int>>& out_ptsNeighTris) const;
 
+    /**
+     * @brief Get the triangles visible in at least one pixel of the camera, by rendering the triangle ids with a z-buffer.
+     */
+    void getVisibleTrianglesIndexes(StaticVector<int>& out_visTri, const mvsUtils::MultiViewParams& mp, int rc, int w, int h);
     void getVisibleTrianglesIndexes(StaticVector<int>& out_visTri,
                                     const std::string& tmpDir,
                                     const mvsUtils::MultiViewParams& mp,
@@ -215,7 +304,7 @@ class Mesh
                                     int w,
                                     int h);
     void getVisibleTrianglesIndexes(StaticVector<int>& out_visTri,
-                                    StaticVector<StaticVector<int>>& trisMap,
+                                    const CompactJaggedArray<int>& trisMap,
                                     StaticVector<float>& depthMap,
                                     const mvsUtils::MultiViewParams& mp,
                                     int rc,
@@ -273,11 +362,38 @@ class Mesh
 
     Point2d getTrianglePixelInternalPoint(Mesh::triangle_proj& tp, Mesh::rectangle& re);
 
+    /**
+     * @brief Get the kd-tree of the mesh vertices, built on first use and shared by all the nearest vertex searches.
+     * @note Thread-safe. The kd-tree is rebuilt if the vertices array is resized or reallocated,
+     *       invalidateSpatialIndexes() must be called after an in-place modification of the vertices.
+     *       The kd-tree references the vertices array, so it is only valid while the vertices are not modified.
+     */
+    std::shared_ptr<const GEO::AdaptiveKdTree> getVerticesKdTree() const;
+
+    /**
+     * @brief Get the AABB tree of the mesh triangles, built on first use and shared by all the nearest triangle and ray searches.
+     * @note Same rules as getVerticesKdTree(), the triangles are also checked.
+     */
+    std::shared_ptr<const GeoMeshFacetsAABB> getFacetsAABB() const;
+
+    /// Release the spatial indexes, to call after an in-place modification of the mesh geometry.
+    void invalidateSpatialIndexes() const { _spatialIndexes.clear(); }
+
+    /**
+     * @brief Get the vertices adjacency (neighbor triangles and vertices), built on first use and shared by the mesh algorithms.
+     * @note Thread-safe. The topology is rebuilt if the triangles array is resized or reallocated or if the number of vertices changes,
+     *       invalidateTopology() must be called after an in-place modification of the triangles.
+     */
+    std::shared_ptr<const MeshTopology> getTopology() const;
+
+    /// Release the topology, to call after an in-place modification of the triangles.
+    void invalidateTopology() const { _topology.clear(); }
+
     int subdivideMesh(const Mesh& refMesh, float ratioSubdiv, bool remapVisibilities);
     int subdivideMeshOnce(const Mesh& refMesh, const GEO::AdaptiveKdTree& refMesh_kdTree, float ratioSubdiv);
 
-    void computeTrisCams(StaticVector<StaticVector<int>>& trisCams, const mvsUtils::MultiViewParams& mp, const std::string tmpDir);
-    void computeTrisCamsFromPtsCams(StaticVector<StaticVector<int>>& trisCams) const;
+    void computeTrisCams(CompactJaggedArray<int>& trisCams, const mvsUtils::MultiViewParams& mp, const std::string tmpDir);
+    void computeTrisCamsFromPtsCams(CompactJaggedArray<int>& trisCams) const;
 
     void initFromDepthMap(const mvsUtils::MultiViewParams& mp, float* depthMap, int rc, int scale, int step, float alpha);
     void initFromDepthMap(const mvsUtils::MultiViewParams& mp, StaticVector<float>& depthMap, int rc, int scale, float alpha);
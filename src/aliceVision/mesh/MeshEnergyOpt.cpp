@@ -9,6 +9,8 @@
 
 #include <boost/filesystem.hpp>
 
+#include <cmath>
+
 namespace aliceVision {
 namespace mesh {
 
@@ -23,54 +25,135 @@ MeshEnergyOpt::MeshEnergyOpt(mvsUtils::MultiViewParams* _mp)
 
 MeshEnergyOpt::~MeshEnergyOpt() = default;
 
-void MeshEnergyOpt::computeLaplacianPtsParallel(StaticVector<Point3d>& out_lapPts)
+namespace {
+
+/// same validity check as MeshAnalyze::applyLaplacianOperator: not null and without NaN
+inline bool isValidSmoothingVector(const Point3d& v)
 {
-    out_lapPts.reserve(pts.size());
-    out_lapPts.resize_with(pts.size(), Point3d(0.0f, 0.0f, 0.f));
-    int nlabpts = 0;
+    const float d = v.size();
+    const Point3d n = v.normalize();
+    return !(std::isnan(d) || std::isnan(n.x) || std::isnan(n.y) || std::isnan(n.z));
+}
 
-#pragma omp parallel for
-    for (int i = 0; i < pts.size(); i++)
+/**
+ * @brief Laplacian operator of MeshAnalyze::applyLaplacianOperator on the compact neighborhood.
+ * @param[out] hasNullNeighbor true if the laplacian is discarded because of a neighbor at the origin
+ */
+inline bool applyCompactLaplacianOperator(CompactJaggedArray<int>::ConstRow neighbors,
+                                          int ptId,
+                                          const StaticVector<Point3d>& ptsToApplyLaplacianOp,
+                                          Point3d& ln,
+                                          bool& hasNullNeighbor)
+{
+    hasNullNeighbor = false;
+    if (neighbors.empty())
+        return false;
+
+    ln = Point3d(0.0f, 0.0f, 0.0f);
+    for (const int neighbor : neighbors)
     {
-        Point3d lapPt;
-        if (getLaplacianSmoothingVector(i, lapPt))
+        const Point3d& npt = ptsToApplyLaplacianOp[neighbor];
+        if ((npt.x == 0.0f) && (npt.y == 0.0f) && (npt.z == 0.0f))
         {
-            out_lapPts[i] = lapPt;
-            nlabpts++;
+            hasNullNeighbor = true;
+            return false;
         }
+        ln = ln + npt;
     }
+    ln = (ln / (float)neighbors.size()) - ptsToApplyLaplacianOp[ptId];
+
+    return isValidSmoothingVector(ln);
 }
 
-void MeshEnergyOpt::updateGradientParallel(float lambda, const Point3d& LU, const Point3d& RD, StaticVectorBool& ptsCanMove)
+}  // namespace
+
+void MeshEnergyOpt::computeSmoothingNeighborhood(SmoothingNeighborhood& out_neighborhood) const
 {
-    // printf("nlabpts %i of %i\n",nlabpts,pts->size());
-    StaticVector<Point3d> lapPts;
-    computeLaplacianPtsParallel(lapPts);
+    out_neighborhood.neighbors = CompactJaggedArray<int>::fromRows(ptsNeighPtsOrdered);
+    const CompactJaggedArray<int>& neighbors = out_neighborhood.neighbors;
 
-    StaticVector<Point3d> newPts;
-    newPts.reserve(pts.size());
-    newPts.push_back_arr(&pts);
+    const int nbPts = neighbors.size();
+    out_neighborhood.biLaplacianScales.assign(nbPts, 0.0f);
 
+    // kobbelt kampagna 98, see MeshAnalyze::getBiLaplacianSmoothingVector
 #pragma omp parallel for
-    for (int i = 0; i < pts.size(); ++i)
+    for (int i = 0; i < nbPts; ++i)
     {
-        if (ptsCanMove.empty() || ptsCanMove[i])
-        {
-            Point3d n;
+        if (neighbors.getRowSize(i) == 0 || ptsNeighTrisSortedAsc[i].empty())
+            continue;
 
-            if (getBiLaplacianSmoothingVector(i, lapPts, n))
+        float sum = 0.0f;
+        for (const int neighbor : neighbors[i])
+        {
+            const int neighValence = neighbors.getRowSize(neighbor);
+            if (neighValence > 0)
             {
-                Point3d p = newPts[i] + n * lambda;
-                if ((p.x > LU.x) && (p.y > LU.y) && (p.z > LU.z) && (p.x < RD.x) && (p.y < RD.y) && (p.z < RD.z))
-                {
-                    newPts[i] = p;
-                }
+                sum += 1.0f / (float)neighValence;
             }
         }
+        const float v = 1.0f + (1.0f / (float)neighbors.getRowSize(i)) * sum;
+        out_neighborhood.biLaplacianScales[i] = 1.0f / v;
     }
+}
+
+int MeshEnergyOpt::computeLaplacianPtsParallel(const SmoothingNeighborhood& neighborhood,
+                                               const StaticVector<Point3d>& inPts,
+                                               StaticVector<Point3d>& out_lapPts) const
+{
+    int nbNullNeighbors = 0;
 
-    pts.clear();
-    pts.swap(newPts);
+#pragma omp parallel for reduction(+ : nbNullNeighbors)
+    for (int i = 0; i < inPts.size(); i++)
+    {
+        Point3d lapPt;
+        bool hasNullNeighbor;
+        if (applyCompactLaplacianOperator(neighborhood.neighbors[i], i, inPts, lapPt, hasNullNeighbor))
+            out_lapPts[i] = lapPt;
+        else
+            out_lapPts[i] = Point3d(0.0f, 0.0f, 0.0f);
+        nbNullNeighbors += hasNullNeighbor;
+    }
+    return nbNullNeighbors;
+}
+
+int MeshEnergyOpt::updateGradientParallel(float lambda,
+                                          const Point3d& LU,
+                                          const Point3d& RD,
+                                          const StaticVectorBool& ptsCanMove,
+                                          const SmoothingNeighborhood& neighborhood,
+                                          const StaticVector<Point3d>& lapPts,
+                                          StaticVector<Point3d>& out_newPts) const
+{
+    int nbNullNeighbors = 0;
+
+#pragma omp parallel for reduction(+ : nbNullNeighbors)
+    for (int i = 0; i < pts.size(); ++i)
+    {
+        out_newPts[i] = pts[i];
+
+        const float biLaplacianScale = neighborhood.biLaplacianScales[i];
+        if (biLaplacianScale == 0.0f || !(ptsCanMove.empty() || ptsCanMove[i]))
+            continue;
+
+        // bi-laplacian smoothing vector, see MeshAnalyze::getBiLaplacianSmoothingVector
+        Point3d n;
+        bool hasNullNeighbor;
+        if (!applyCompactLaplacianOperator(neighborhood.neighbors[i], i, lapPts, n, hasNullNeighbor))
+        {
+            nbNullNeighbors += hasNullNeighbor;
+            continue;
+        }
+        n = Point3d(0.0f, 0.0f, 0.0f) - n * biLaplacianScale;
+        if (!isValidSmoothingVector(n))
+            continue;
+
+        const Point3d p = pts[i] + n * lambda;
+        if ((p.x > LU.x) && (p.y > LU.y) && (p.z > LU.z) && (p.x < RD.x) && (p.y < RD.y) && (p.z < RD.z))
+        {
+            out_newPts[i] = p;
+        }
+    }
+    return nbNullNeighbors;
 }
 
 bool MeshEnergyOpt::optimizeSmooth(float lambda, int niter, StaticVectorBool& ptsCanMove)
@@ -97,13 +180,28 @@ bool MeshEnergyOpt::optimizeSmooth(float lambda, int niter, StaticVectorBool& pt
 
     ALICEVISION_LOG_INFO("Optimizing mesh smooth: " << std::endl << "\t- lamda: " << lambda << std::endl << "\t- niters: " << niter << std::endl);
 
+    SmoothingNeighborhood neighborhood;
+    computeSmoothingNeighborhood(neighborhood);
+
+    // buffers reused by all the iterations
+    StaticVector<Point3d> lapPts;
+    lapPts.resize(pts.size());
+    StaticVector<Point3d> newPts;
+    newPts.resize(pts.size());
+
     for (int i = 0; i < niter; i++)
     {
         ALICEVISION_LOG_INFO("Optimizing mesh smooth: iteration " << i);
-        updateGradientParallel(lambda, LU, RD, ptsCanMove);
+        int nbNullNeighbors = computeLaplacianPtsParallel(neighborhood, pts, lapPts);
+        nbNullNeighbors += updateGradientParallel(lambda, LU, RD, ptsCanMove, neighborhood, lapPts, newPts);
+        pts.swap(newPts);
+
+        if (nbNullNeighbors > 0)
+            ALICEVISION_LOG_WARNING("Optimizing mesh smooth: " << nbNullNeighbors << " smoothing vector(s) discarded because of a neighbor at the origin.");
         // if(saveDebug)
         //     save(folder + "mesh_smoothed_" + std::to_string(i));
     }
+    invalidateSpatialIndexes();
 
     return true;
 }
@@ -6,10 +6,13 @@
 
 #pragma once
 
+#include <aliceVision/mvsData/CompactJaggedArray.hpp>
 #include <aliceVision/mvsData/Point3d.hpp>
 #include <aliceVision/mvsData/StaticVector.hpp>
 #include <aliceVision/mesh/MeshAnalyze.hpp>
 
+#include <vector>
+
 namespace aliceVision {
 namespace mesh {
 
@@ -22,8 +25,34 @@ class MeshEnergyOpt : public MeshAnalyze
     bool optimizeSmooth(float lambda, int niter, StaticVectorBool& ptsCanMove);
 
   private:
-    void computeLaplacianPtsParallel(StaticVector<Point3d>& out_lapPts);
-    void updateGradientParallel(float lambda, const Point3d& LU, const Point3d& RD, StaticVectorBool& ptsCanMove);
+    /// neighborhood of the vertices, constant over the smoothing iterations
+    struct SmoothingNeighborhood
+    {
+        /// ordered neighbor vertices (ptsNeighPtsOrdered) in a single buffer
+        CompactJaggedArray<int> neighbors;
+        /// scale of the bi-laplacian vector from the neighbors valence, 0 if the vertex cannot be smoothed
+        std::vector<float> biLaplacianScales;
+    };
+
+    void computeSmoothingNeighborhood(SmoothingNeighborhood& out_neighborhood) const;
+
+    /**
+     * @brief Compute the laplacian of all the points.
+     * @return the number of laplacians discarded because of a null neighbor
+     */
+    int computeLaplacianPtsParallel(const SmoothingNeighborhood& neighborhood, const StaticVector<Point3d>& inPts, StaticVector<Point3d>& out_lapPts) const;
+
+    /**
+     * @brief Move all the points along their bi-laplacian (Jacobi update: the new points only depend on the previous ones).
+     * @return the number of bi-laplacians discarded because of a null neighbor
+     */
+    int updateGradientParallel(float lambda,
+                               const Point3d& LU,
+                               const Point3d& RD,
+                               const StaticVectorBool& ptsCanMove,
+                               const SmoothingNeighborhood& neighborhood,
+                               const StaticVector<Point3d>& lapPts,
+                               StaticVector<Point3d>& out_newPts) const;
 };
 
 }  // namespace mesh
@@ -0,0 +1,76 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2023 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "MeshTopology.hpp"
+
+#include <aliceVision/alicevision_omp.hpp>
+
+#include <algorithm>
+
+namespace aliceVision {
+namespace mesh {
+
+MeshTopology::MeshTopology(const Mesh& mesh)
+{
+    const int nbPts = mesh.pts.size();
+    const int nbTris = mesh.tris.size();
+
+    // vertex to triangles: count and fill in the triangles order, so each row is sorted
+    {
+        CompactJaggedArray<int>::Builder builder(nbPts);
+        for (int triId = 0; triId < nbTris; ++triId)
+        {
+            for (int k = 0; k < 3; ++k)
+                builder.count(mesh.tris[triId].v[k]);
+        }
+        builder.allocate();
+        for (int triId = 0; triId < nbTris; ++triId)
+        {
+            for (int k = 0; k < 3; ++k)
+                builder.add(mesh.tris[triId].v[k], triId);
+        }
+        vertexTris = builder.build();
+    }
+
+    // vertex to vertices: the 2 other vertices of each triangle, deduplicated per row
+    const std::vector<std::size_t>& vertexTrisOffsets = vertexTris.getOffsets();
+    std::vector<int> neighbors(vertexTris.getNbElements() * 2);
+
+    CompactJaggedArray<int>::Builder builder(nbPts);
+
+#pragma omp parallel for
+    for (int ptId = 0; ptId < nbPts; ++ptId)
+    {
+        int* rowBegin = neighbors.data() + 2 * vertexTrisOffsets[ptId];
+        int* rowEnd = rowBegin;
+        for (const int triId : vertexTris[ptId])
+        {
+            const Mesh::triangle& t = mesh.tris[triId];
+            for (int k = 0; k < 3; ++k)
+            {
+                if (t.v[k] != ptId)
+                    *rowEnd++ = t.v[k];
+            }
+        }
+        std::sort(rowBegin, rowEnd);
+        builder.count(ptId, static_cast<int>(std::unique(rowBegin, rowEnd) - rowBegin));
+    }
+
+    builder.allocate();
+
+#pragma omp parallel for
+    for (int ptId = 0; ptId < nbPts; ++ptId)
+    {
+        const CompactJaggedArray<int>::Row row = builder.row(ptId);
+        const int* rowBegin = neighbors.data() + 2 * vertexTrisOffsets[ptId];
+        std::copy(rowBegin, rowBegin + row.size(), row.begin());
+    }
+
+    vertexPts = builder.build();
+}
+
+}  // namespace mesh
+}  // namespace aliceVision
@@ -0,0 +1,43 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2023 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <aliceVision/mesh/Mesh.hpp>
+#include <aliceVision/mvsData/CompactJaggedArray.hpp>
+
+namespace aliceVision {
+namespace mesh {
+
+/**
+ * @brief Compact adjacency of the mesh vertices, stored in compressed sparse rows.
+ *
+ * @note Built in linear time with a counting sort, without any per-vertex allocation.
+ *       Use Mesh::getTopology() to share it between the mesh algorithms.
+ */
+struct MeshTopology
+{
+    /// contiguous range of indexes
+    using Range = CompactJaggedArray<int>::ConstRow;
+
+    /// triangles of each vertex, sorted in ascending order
+    CompactJaggedArray<int> vertexTris;
+    /// neighbor vertices of each vertex (sharing an edge), unique and sorted in ascending order
+    CompactJaggedArray<int> vertexPts;
+
+    explicit MeshTopology(const Mesh& mesh);
+
+    inline int getNbPts() const { return vertexTris.size(); }
+
+    /// triangles using the vertex, sorted in ascending order
+    inline Range getVertexTriangles(int ptId) const { return vertexTris[ptId]; }
+
+    /// vertices sharing an edge with the vertex, sorted in ascending order
+    inline Range getVertexNeighbors(int ptId) const { return vertexPts[ptId]; }
+};
+
+}  // namespace mesh
+}  // namespace aliceVision
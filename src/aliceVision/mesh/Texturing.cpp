@@ -7,8 +7,10 @@
 #include "Texturing.hpp"
 #include "geoMesh.hpp"
 #include "UVAtlas.hpp"
+#include "meshRasterization.hpp"
 
 #include <aliceVision/system/Logger.hpp>
+#include <aliceVision/image/cache.hpp>
 #include <aliceVision/image/io.hpp>
 #include <aliceVision/image/pixelTypes.hpp>
 #include <aliceVision/numeric/numeric.hpp>
@@ -36,7 +38,9 @@
 #include <assimp/scene.h>
 #include <assimp/postprocess.h>
 
+#include <algorithm>
 #include <map>
+#include <numeric>
 #include <set>
 
 // Debug mode: save atlases decomposition in frequency bands and
@@ -166,6 +170,119 @@ Point3d barycentricToCartesian(const Point3d* triangle, const Point2d& coords)
     return triangle[0] + (triangle[2] - triangle[0]) * coords.x + (triangle[1] - triangle[0]) * coords.y;
 }
 
+/**
+ * @brief Compute the bounding box in texture pixels of a triangle UV coordinates.
+ * @param[in] mesh the mesh with UV coordinates
+ * @param[in] textureSide the texture side in pixels
+ * @param[in] triangleId the triangle index
+ * @param[out] triPixs the triangle UV coordinates in texture pixels, remapped in the triangle UDIM
+ * @param[out] LU the bounding box left-up corner (included)
+ * @param[out] RD the bounding box right-down corner (excluded)
+ */
+void getTriangleTexturePixels(const Mesh& mesh, unsigned int textureSide, unsigned int triangleId, Point2d* triPixs, Pixel& LU, Pixel& RD)
+{
+    const auto& triangleUvIds = mesh.trisUvIds[triangleId];
+    // compute the Bottom-Left minima of the current UDIM for [0,1] range remapping
+    Point2d udimBL;
+    const StaticVector<Point2d>& uvCoords = mesh.uvCoords;
+    udimBL.x = std::floor(std::min({uvCoords[triangleUvIds.m[0]].x, uvCoords[triangleUvIds.m[1]].x, uvCoords[triangleUvIds.m[2]].x}));
+    udimBL.y = std::floor(std::min({uvCoords[triangleUvIds.m[0]].y, uvCoords[triangleUvIds.m[1]].y, uvCoords[triangleUvIds.m[2]].y}));
+
+    for (int k = 0; k < 3; ++k)
+    {
+        const int uvPointIndex = triangleUvIds.m[k];
+        Point2d uv = uvCoords[uvPointIndex];
+        // UDIM: remap coordinates between [0,1]
+        uv = uv - udimBL;
+
+        triPixs[k] = uv * textureSide;  // UV coordinates
+    }
+
+    // compute triangle bounding box in pixel indexes
+    // min values: floor(value)
+    // max values: ceil(value)
+    LU.x = static_cast<int>(std::floor(std::min({triPixs[0].x, triPixs[1].x, triPixs[2].x})));
+    LU.y = static_cast<int>(std::floor(std::min({triPixs[0].y, triPixs[1].y, triPixs[2].y})));
+    RD.x = static_cast<int>(std::ceil(std::max({triPixs[0].x, triPixs[1].x, triPixs[2].x})));
+    RD.y = static_cast<int>(std::ceil(std::max({triPixs[0].y, triPixs[1].y, triPixs[2].y})));
+
+    // sanity check: clamp values to [0; textureSide]
+    const int texSide = static_cast<int>(textureSide);
+    LU.x = clamp(LU.x, 0, texSide);
+    LU.y = clamp(LU.y, 0, texSide);
+    RD.x = clamp(RD.x, 0, texSide);
+    RD.y = clamp(RD.y, 0, texSide);
+}
+
+/**
+ * @brief Iterate over the texture pixels of a triangle seen by a camera.
+ * @param[in] f the function called with the 1D texture pixel index and the 2D coordinates in the camera image
+ */
+template<class Function>
+void forEachTriangleTexturePixel(const Mesh& mesh,
+                                 const mvsUtils::MultiViewParams& mp,
+                                 int camId,
+                                 const image::Image<image::RGBfColor>& camImg,
+                                 unsigned int textureSide,
+                                 unsigned int triangleId,
+                                 Function f)
+{
+    // retrieve triangle 3D and UV coordinates
+    Point2d triPixs[3];
+    Point3d triPts[3];
+    Pixel LU, RD;
+    getTriangleTexturePixels(mesh, textureSide, triangleId, triPixs, LU, RD);
+    for (int k = 0; k < 3; ++k)
+        triPts[k] = mesh.pts[mesh.tris[triangleId].v[k]];  // 3D coordinates
+
+    // iterate over pixels of the triangle's bounding box
+    for (int y = LU.y; y < RD.y; ++y)
+    {
+        for (int x = LU.x; x < RD.x; ++x)
+        {
+            Pixel pix(x, y);  // top-left corner of the pixel
+            Point2d barycCoords;
+
+            // test if the pixel is inside triangle
+            // and retrieve its barycentric coordinates
+            if (!isPixelInTriangle(triPixs, pix, barycCoords))
+            {
+                continue;
+            }
+
+            // remap 'y' to image coordinates system (inverted Y axis)
+            const unsigned int y_ = (textureSide - 1) - y;
+            // 1D pixel index
+            const unsigned int xyoffset = y_ * textureSide + x;
+            // get 3D coordinates
+            const Point3d pt3d = barycentricToCartesian(triPts, barycCoords);
+            // get 2D coordinates in source image
+            Point2d pixRC;
+            mp.getPixelFor3DPoint(&pixRC, pt3d, camId);
+            // exclude out of bounds pixels
+            if (!mp.isPixelInImage(pixRC, camId))
+                continue;
+
+            // If the color is pure zero (ie. no contributions), we consider it as an invalid pixel.
+            if (getInterpolateColor(camImg, pixRC.y, pixRC.x) == image::RGBfColor(0.f, 0.f, 0.f))
+                continue;
+
+            f(xyoffset, pixRC);
+        }
+    }
+}
+
+namespace {
+
+/// accumulated color and weight of a texture pixel, stored in the out-of-core tiles
+struct AccuPixel
+{
+    image::RGBfColor color;
+    float count;
+};
+
+}  // namespace
+
 void Texturing::generateUVsBasicMethod(mvsUtils::MultiViewParams& mp)
 {
     if (!mesh)
@@ -300,6 +417,11 @@ void Texturing::generateTextures(const mvsUtils::MultiViewParams& mp,
     }
     std::partial_sum(m.begin(), m.end(), m.begin());
 
+    if (texParams.useRasterizedVisibility)
+        computeTrianglesCamerasVisibility(*mesh, mp, texParams.rasterizationDownscale, _trianglesCams);
+    else
+        _trianglesCams.clear();
+
     ALICEVISION_LOG_INFO("Texturing in " + image::EImageColorSpace_enumToString(texParams.workingColorSpace) + " colorspace.");
     mvsUtils::ImagesCache<image::Image<image::RGBfColor>> imageCache(mp, texParams.workingColorSpace, texParams.correctEV);
 
@@ -346,6 +468,14 @@ void Texturing::generateTextures(const mvsUtils::MultiViewParams& mp,
     ALICEVISION_LOG_INFO("Total amount of an atlas pyramid in memory: " << atlasPyramidMaxMemSize << " MB.");
     ALICEVISION_LOG_INFO("Processing " << nbAtlas << " atlases by chunks of " << nbAtlasMax);
 
+    if (texParams.tiledAccumulation)
+    {
+        // read each image once and accumulate all atlases in out-of-core tiles
+        const std::size_t tilesMemory = std::size_t(std::max(0, availableMem - int(atlasPyramidMaxMemSize))) * std::pow(2, 20);
+        generateTexturesTiled(mp, imageCache, outPath, tilesMemory, textureFileType);
+        return;
+    }
+
     // generateTexture for the maximum number of atlases, and iterate
     const std::div_t divresult = div(nbAtlas, nbAtlasMax);
     std::vector<size_t> atlasIDs;
@@ -366,22 +496,13 @@ void Texturing::generateTextures(const mvsUtils::MultiViewParams& mp,
     }
 }
 
-void Texturing::generateTexturesSubSet(const mvsUtils::MultiViewParams& mp,
-                                       const std::vector<size_t>& atlasIDs,
-                                       mvsUtils::ImagesCache<image::Image<image::RGBfColor>>& imageCache,
-                                       const bfs::path& outPath,
-                                       image::EImageFileType textureFileType)
+void Texturing::computeContributionsPerCamera(const mvsUtils::MultiViewParams& mp,
+                                              const std::vector<size_t>& atlasIDs,
+                                              std::vector<CameraContributions>& contributionsPerCamera) const
 {
-    if (atlasIDs.size() > _atlases.size())
-        throw std::runtime_error("Invalid atlas IDs ");
-
-    unsigned int textureSize = texParams.textureSide * texParams.textureSide;
-
     // We select the best cameras for each triangle and store it per camera for each output texture files.
     // Triangles contributions are stored per frequency bands for multi-band blending.
-    using AtlasIndex = size_t;
-    using ScorePerTriangle = std::vector<std::pair<unsigned int, float>>;  // list of <triangleId, score>
-    std::vector<std::map<AtlasIndex, std::vector<ScorePerTriangle>>> contributionsPerCamera(mp.ncams);
+    contributionsPerCamera.assign(mp.ncams, CameraContributions());
 
     // for each atlasID, calculate contributionPerCamera
     for (const size_t atlasID : atlasIDs)
@@ -394,39 +515,47 @@ void Texturing::generateTexturesSubSet(const mvsUtils::MultiViewParams& mp,
         {
             int triangleID = _atlases[atlasID][i];
 
-            // Fuse visibilities of the 3 vertices
-            std::vector<int> allTriCams;
-            for (int k = 0; k < 3; ++k)
+            std::vector<std::pair<int, int>> selectedTriCams;  // <camId, nbVertices>
+            if (!_trianglesCams.empty())
+            {
+                // Rasterized visibility: the triangle is seen by the camera, consider it as supported by the 3 vertices
+                for (const int camId : _trianglesCams[triangleID])
+                    selectedTriCams.emplace_back(camId, 3);
+            }
+            else
             {
-                const int pointIndex = mesh->tris[triangleID].v[k];
-                const StaticVector<int> pointVisibilities = mesh->pointsVisibilities[pointIndex];
-                if (!pointVisibilities.empty())
+                // Fuse visibilities of the 3 vertices
+                std::vector<int> allTriCams;
+                for (int k = 0; k < 3; ++k)
                 {
-                    std::copy(pointVisibilities.begin(), pointVisibilities.end(), std::inserter(allTriCams, allTriCams.end()));
+                    const int pointIndex = mesh->tris[triangleID].v[k];
+                    const StaticVector<int> pointVisibilities = mesh->pointsVisibilities[pointIndex];
+                    if (!pointVisibilities.empty())
+                    {
+                        std::copy(pointVisibilities.begin(), pointVisibilities.end(), std::inserter(allTriCams, allTriCams.end()));
+                    }
+                }
+                std::sort(allTriCams.begin(), allTriCams.end());
+
+                for (int j = 0; j < allTriCams.size(); ++j)
+                {
+                    const int camId = allTriCams[j];
+                    if (!selectedTriCams.empty() && selectedTriCams.back().first == camId)
+                    {
+                        ++selectedTriCams.back().second;
+                    }
+                    else
+                    {
+                        selectedTriCams.emplace_back(camId, 1);
+                    }
                 }
             }
-            if (allTriCams.empty())
+            if (selectedTriCams.empty())
             {
                 // triangle without visibility
                 ALICEVISION_LOG_TRACE("No visibility for triangle " << triangleID << " in texture atlas " << atlasID << ".");
                 continue;
             }
-            std::sort(allTriCams.begin(), allTriCams.end());
-
-            std::vector<std::pair<int, int>> selectedTriCams;  // <camId, nbVertices>
-            selectedTriCams.emplace_back(allTriCams.front(), 1);
-            for (int j = 1; j < allTriCams.size(); ++j)
-            {
-                const unsigned int camId = allTriCams[j];
-                if (selectedTriCams.back().first == camId)
-                {
-                    ++selectedTriCams.back().second;
-                }
-                else
-                {
-                    selectedTriCams.emplace_back(camId, 1);
-                }
-            }
 
             assert(!selectedTriCams.empty());
 
@@ -509,6 +638,19 @@ void Texturing::generateTexturesSubSet(const mvsUtils::MultiViewParams& mp,
             }
         }
     }
+}
+
+void Texturing::generateTexturesSubSet(const mvsUtils::MultiViewParams& mp,
+                                       const std::vector<size_t>& atlasIDs,
+                                       mvsUtils::ImagesCache<image::Image<image::RGBfColor>>& imageCache,
+                                       const bfs::path& outPath,
+                                       image::EImageFileType textureFileType)
+{
+    if (atlasIDs.size() > _atlases.size())
+        throw std::runtime_error("Invalid atlas IDs ");
+
+    std::vector<CameraContributions> contributionsPerCamera;
+    computeContributionsPerCamera(mp, atlasIDs, contributionsPerCamera);
 
     ALICEVISION_LOG_INFO("Reading pixel color.");
 
@@ -517,10 +659,18 @@ void Texturing::generateTexturesSubSet(const mvsUtils::MultiViewParams& mp,
     for (std::size_t atlasID : atlasIDs)
         accuPyramids[atlasID].init(texParams.nbBand, texParams.textureSide, texParams.textureSide);
 
+    // cameras with contributions, in processing order
+    std::vector<int> usedCamIds;
+    for (int camId = 0; camId < contributionsPerCamera.size(); ++camId)
+    {
+        if (!contributionsPerCamera[camId].empty())
+            usedCamIds.push_back(camId);
+    }
+
     // for each camera, for each texture, iterate over triangles and fill the accuPyramids map
     for (int camId = 0; camId < contributionsPerCamera.size(); ++camId)
     {
-        const std::map<AtlasIndex, std::vector<ScorePerTriangle>>& cameraContributions = contributionsPerCamera[camId];
+        const CameraContributions& cameraContributions = contributionsPerCamera[camId];
 
         if (cameraContributions.empty())
         {
@@ -532,16 +682,36 @@ void Texturing::generateTexturesSubSet(const mvsUtils::MultiViewParams& mp,
 
         // Load camera image from cache
         auto imgPtr = imageCache.getImg_sync(camId);
+
+        // read the next camera images while this one is processed
+        imageCache.prefetch(std::vector<int>(std::upper_bound(usedCamIds.begin(), usedCamIds.end(), camId), usedCamIds.end()));
         const image::Image<image::RGBfColor>& camImg = *imgPtr;
 
         // Calculate laplacianPyramid
         std::vector<image::Image<image::RGBfColor>> pyramidL;  // laplacian pyramid
         imageAlgo::laplacianPyramid(pyramidL, camImg, texParams.nbBand, texParams.multiBandDownscale);
 
+        // downscale factor of each level of the pyramid
+        std::vector<int> downscaleCoefs(pyramidL.size());
+        for (std::size_t level = 0; level < pyramidL.size(); ++level)
+            downscaleCoefs[level] = std::pow(texParams.multiBandDownscale, level);
+
+        // contributions of the camera to all the texture files and frequency bands, processed in a single parallel loop.
+        // a triangle contributes to a single band of a camera, and the triangles of a texture file do not overlap.
+        struct TriangleContribution
+        {
+            AccuPyramid* accuPyramid;
+            int band;
+            unsigned int triangleId;
+            float triangleScore;
+        };
+        std::vector<TriangleContribution> triangleContributions;
+
         // for each output texture file
         for (const auto& c : cameraContributions)
         {
             AtlasIndex atlasID = c.first;
+            AccuPyramid& accuPyramid = accuPyramids.at(atlasID);
             ALICEVISION_LOG_INFO("  - Texture file: " << atlasID + 1);
             // for each frequency band
             for (int band = 0; band < c.second.size(); ++band)
@@ -549,198 +719,329 @@ void Texturing::generateTexturesSubSet(const mvsUtils::MultiViewParams& mp,
                 const ScorePerTriangle& trianglesId = c.second[band];
                 ALICEVISION_LOG_INFO("      - band " << band + 1 << ": " << trianglesId.size() << " triangles.");
 
+                for (const auto& triangleScore : trianglesId)
+                    triangleContributions.push_back({&accuPyramid, band, triangleScore.first, texParams.useScore ? triangleScore.second : 1.0f});
+            }
+        }
+
 // for each triangle
-#pragma omp parallel for
-                for (int ti = 0; ti < trianglesId.size(); ++ti)
+#pragma omp parallel for schedule(dynamic)
+        for (int ti = 0; ti < triangleContributions.size(); ++ti)
+        {
+            const TriangleContribution& contribution = triangleContributions[ti];
+            const float triangleScore = contribution.triangleScore;
+
+            forEachTriangleTexturePixel(*mesh, mp, camId, camImg, texParams.textureSide, contribution.triangleId,
+                                        [&](unsigned int xyoffset, const Point2d& pixRC) {
+                                            // Fill the accumulated pyramid for this pixel
+                                            // each frequency band also contributes to lower frequencies (higher band indexes)
+                                            for (std::size_t bandContrib = contribution.band; bandContrib < pyramidL.size(); ++bandContrib)
+                                            {
+                                                AccuImage& accuImage = contribution.accuPyramid->pyramid[bandContrib];
+
+                                                // fill the accumulated color map for this pixel
+                                                const auto pixDownscaled = pixRC / downscaleCoefs[bandContrib];
+                                                accuImage.img(xyoffset) +=
+                                                  getInterpolateColor(pyramidL[bandContrib], pixDownscaled.y, pixDownscaled.x) * triangleScore;
+                                                accuImage.imgCount[xyoffset] += triangleScore;
+                                            }
+                                        });
+        }
+    }
+
+    // compute the final colors and write the texture files
+    for (std::size_t atlasID : atlasIDs)
+        writeAccumulatedTexture(accuPyramids.at(atlasID), atlasID, outPath, textureFileType);
+}
+
+void Texturing::generateTexturesTiled(const mvsUtils::MultiViewParams& mp,
+                                      mvsUtils::ImagesCache<image::Image<image::RGBfColor>>& imageCache,
+                                      const bfs::path& outPath,
+                                      std::size_t tilesMemory,
+                                      image::EImageFileType textureFileType)
+{
+    const int tileSide = 256;
+    const int textureSide = static_cast<int>(texParams.textureSide);
+    const int nbTilesPerSide = divideRoundUp(textureSide, tileSide);
+    const int nbTilesPerLevel = nbTilesPerSide * nbTilesPerSide;
+    const std::size_t levelMemSize = std::size_t(nbTilesPerLevel) * tileSide * tileSide * sizeof(AccuPixel);
+
+    std::vector<size_t> atlasIDs(_atlases.size());
+    std::iota(atlasIDs.begin(), atlasIDs.end(), 0);
+
+    std::vector<CameraContributions> contributionsPerCamera;
+    computeContributionsPerCamera(mp, atlasIDs, contributionsPerCamera);
+
+    // the tiles of an atlas level are filled together, so they must fit in memory
+    tilesMemory = std::max(tilesMemory, 2 * levelMemSize);
+    ALICEVISION_LOG_INFO("Tiled accumulation: " << nbTilesPerLevel << " tiles per atlas level, " << tilesMemory / (1024 * 1024)
+                                                << " MB of tiles in memory.");
+
+    image::TileCacheManager::shared_ptr cacheManager = image::TileCacheManager::create(outPath.string(), tileSide, tileSide, 64);
+    cacheManager->setMaxMemory(tilesMemory);
+
+    // tiles per atlas and per level, created on first use
+    using LevelTiles = std::vector<image::CachedTile::smart_pointer>;
+    std::vector<std::vector<LevelTiles>> atlasesTiles(_atlases.size(), std::vector<LevelTiles>(texParams.nbBand, LevelTiles(nbTilesPerLevel)));
+
+    // visit the cameras grouped by their main texture atlas, so the tiles of an atlas stay in memory
+    std::vector<std::pair<AtlasIndex, int>> camerasOrder;  // <main atlasID, camId>
+    for (int camId = 0; camId < contributionsPerCamera.size(); ++camId)
+    {
+        const CameraContributions& cameraContributions = contributionsPerCamera[camId];
+        if (cameraContributions.empty())
+            continue;
+
+        AtlasIndex mainAtlasID = cameraContributions.begin()->first;
+        std::size_t mainAtlasNbTriangles = 0;
+        for (const auto& c : cameraContributions)
+        {
+            std::size_t nbTriangles = 0;
+            for (const ScorePerTriangle& bandTriangles : c.second)
+                nbTriangles += bandTriangles.size();
+            if (nbTriangles > mainAtlasNbTriangles)
+            {
+                mainAtlasNbTriangles = nbTriangles;
+                mainAtlasID = c.first;
+            }
+        }
+        camerasOrder.emplace_back(mainAtlasID, camId);
+    }
+    std::sort(camerasOrder.begin(), camerasOrder.end());
+
+    ALICEVISION_LOG_INFO("Reading pixel color: " << camerasOrder.size() << " cameras used.");
+
+    for (std::size_t i = 0; i < camerasOrder.size(); ++i)
+    {
+        const int camId = camerasOrder[i].second;
+        const CameraContributions& cameraContributions = contributionsPerCamera[camId];
+        ALICEVISION_LOG_INFO("- camera " << mp.getViewId(camId) << " (" << i + 1 << "/" << camerasOrder.size() << ") with contributions to "
+                                         << cameraContributions.size() << " texture files.");
+
+        // Load camera image from cache
+        auto imgPtr = imageCache.getImg_sync(camId);
+        const image::Image<image::RGBfColor>& camImg = *imgPtr;
+
+        // Calculate laplacianPyramid
+        std::vector<image::Image<image::RGBfColor>> pyramidL;  // laplacian pyramid
+        imageAlgo::laplacianPyramid(pyramidL, camImg, texParams.nbBand, texParams.multiBandDownscale);
+
+        for (const auto& c : cameraContributions)
+        {
+            const AtlasIndex atlasID = c.first;
+            const int nbLevels = std::min(pyramidL.size(), atlasesTiles[atlasID].size());
+
+            // each frequency band contributes to its level and to the lower frequencies (higher levels)
+            for (int level = 0; level < nbLevels; ++level)
+            {
+                const int nbBands = std::min(level + 1, static_cast<int>(c.second.size()));
+
+                // select the tiles covered by the contributing triangles
+                std::vector<bool> usedTiles(nbTilesPerLevel, false);
+                for (int band = 0; band < nbBands; ++band)
                 {
-                    const unsigned int triangleId = std::get<0>(trianglesId[ti]);
-                    const float triangleScore = texParams.useScore ? std::get<1>(trianglesId[ti]) : 1.0f;
-                    // retrieve triangle 3D and UV coordinates
-                    Point2d triPixs[3];
-                    Point3d triPts[3];
-                    auto& triangleUvIds = mesh->trisUvIds[triangleId];
-                    // compute the Bottom-Left minima of the current UDIM for [0,1] range remapping
-                    Point2d udimBL;
-                    StaticVector<Point2d>& uvCoords = mesh->uvCoords;
-                    udimBL.x = std::floor(std::min({uvCoords[triangleUvIds[0]].x, uvCoords[triangleUvIds[1]].x, uvCoords[triangleUvIds[2]].x}));
-                    udimBL.y = std::floor(std::min({uvCoords[triangleUvIds[0]].y, uvCoords[triangleUvIds[1]].y, uvCoords[triangleUvIds[2]].y}));
-
-                    for (int k = 0; k < 3; ++k)
+                    for (const auto& triangleScore : c.second[band])
                     {
-                        const int pointIndex = mesh->tris[triangleId].v[k];
-                        triPts[k] = mesh->pts[pointIndex];  // 3D coordinates
-                        const int uvPointIndex = triangleUvIds.m[k];
-                        Point2d uv = uvCoords[uvPointIndex];
-                        // UDIM: remap coordinates between [0,1]
-                        uv = uv - udimBL;
-
-                        triPixs[k] = uv * texParams.textureSide;  // UV coordinates
+                        Point2d triPixs[3];
+                        Pixel LU, RD;
+                        getTriangleTexturePixels(*mesh, texParams.textureSide, triangleScore.first, triPixs, LU, RD);
+                        if (LU.x >= RD.x || LU.y >= RD.y)
+                            continue;
+                        // inverted Y axis in the texture image
+                        const int tileMinY = (textureSide - RD.y) / tileSide;
+                        const int tileMaxY = (textureSide - 1 - LU.y) / tileSide;
+                        for (int ty = tileMinY; ty <= tileMaxY; ++ty)
+                            for (int tx = LU.x / tileSide; tx <= (RD.x - 1) / tileSide; ++tx)
+                                usedTiles[ty * nbTilesPerSide + tx] = true;
                     }
+                }
+
+                // bring the selected tiles in memory
+                LevelTiles& levelTiles = atlasesTiles[atlasID][level];
+                std::vector<AccuPixel*> tilesData(nbTilesPerLevel, nullptr);
+                for (int tileId = 0; tileId < nbTilesPerLevel; ++tileId)
+                {
+                    if (!usedTiles[tileId])
+                        continue;
+
+                    image::CachedTile::smart_pointer& tile = levelTiles[tileId];
+                    const bool isNewTile = (tile == nullptr);
+                    if (isNewTile)
+                        tile = cacheManager->requireNewCachedTile<AccuPixel>(tileSide, tileSide);
+                    if (tile == nullptr || !tile->acquire())
+                        ALICEVISION_THROW_ERROR("Cannot acquire the tile " << tileId << " of the texture atlas " << atlasID << ".");
+
+                    tilesData[tileId] = reinterpret_cast<AccuPixel*>(tile->getDataPointer());
+                    if (isNewTile)
+                        std::fill_n(tilesData[tileId], tileSide * tileSide, AccuPixel{image::RGBfColor(0.f, 0.f, 0.f), 0.f});
+                }
 
-                    // compute triangle bounding box in pixel indexes
-                    // min values: floor(value)
-                    // max values: ceil(value)
-                    Pixel LU, RD;
-                    LU.x = static_cast<int>(std::floor(std::min({triPixs[0].x, triPixs[1].x, triPixs[2].x})));
-                    LU.y = static_cast<int>(std::floor(std::min({triPixs[0].y, triPixs[1].y, triPixs[2].y})));
-                    RD.x = static_cast<int>(std::ceil(std::max({triPixs[0].x, triPixs[1].x, triPixs[2].x})));
-                    RD.y = static_cast<int>(std::ceil(std::max({triPixs[0].y, triPixs[1].y, triPixs[2].y})));
-
-                    // sanity check: clamp values to [0; textureSide]
-                    int texSide = static_cast<int>(texParams.textureSide);
-                    LU.x = clamp(LU.x, 0, texSide);
-                    LU.y = clamp(LU.y, 0, texSide);
-                    RD.x = clamp(RD.x, 0, texSide);
-                    RD.y = clamp(RD.y, 0, texSide);
-
-                    // iterate over pixels of the triangle's bounding box
-                    for (int y = LU.y; y < RD.y; ++y)
+                const int downscaleCoef = std::pow(texParams.multiBandDownscale, level);
+                for (int band = 0; band < nbBands; ++band)
+                {
+                    const ScorePerTriangle& trianglesId = c.second[band];
+
+// for each triangle
+#pragma omp parallel for
+                    for (int ti = 0; ti < trianglesId.size(); ++ti)
                     {
-                        for (int x = LU.x; x < RD.x; ++x)
-                        {
-                            Pixel pix(x, y);  // top-left corner of the pixel
-                            Point2d barycCoords;
+                        const unsigned int triangleId = std::get<0>(trianglesId[ti]);
+                        const float triangleScore = texParams.useScore ? std::get<1>(trianglesId[ti]) : 1.0f;
+
+                        forEachTriangleTexturePixel(*mesh, mp, camId, camImg, texParams.textureSide, triangleId,
+                                                    [&](unsigned int xyoffset, const Point2d& pixRC) {
+                                                        const int x = xyoffset % textureSide;
+                                                        const int y = xyoffset / textureSide;
+                                                        AccuPixel* tileData = tilesData[(y / tileSide) * nbTilesPerSide + x / tileSide];
+                                                        AccuPixel& accuPixel = tileData[(y % tileSide) * tileSide + x % tileSide];
+
+                                                        const auto pixDownscaled = pixRC / downscaleCoef;
+                                                        accuPixel.color +=
+                                                          getInterpolateColor(pyramidL[level], pixDownscaled.y, pixDownscaled.x) * triangleScore;
+                                                        accuPixel.count += triangleScore;
+                                                    });
+                    }
+                }
+            }
+        }
+    }
 
-                            // test if the pixel is inside triangle
-                            // and retrieve its barycentric coordinates
-                            if (!isPixelInTriangle(triPixs, pix, barycCoords))
-                            {
-                                continue;
-                            }
+    // gather the tiles of each atlas in memory, one atlas at a time
+    for (std::size_t atlasID : atlasIDs)
+    {
+        AccuPyramid accuPyramid;
+        accuPyramid.init(texParams.nbBand, texParams.textureSide, texParams.textureSide);
 
-                            // remap 'y' to image coordinates system (inverted Y axis)
-                            const unsigned int y_ = (texParams.textureSide - 1) - y;
-                            // 1D pixel index
-                            unsigned int xyoffset = y_ * texParams.textureSide + x;
-                            // get 3D coordinates
-                            Point3d pt3d = barycentricToCartesian(triPts, barycCoords);
-                            // get 2D coordinates in source image
-                            Point2d pixRC;
-                            mp.getPixelFor3DPoint(&pixRC, pt3d, camId);
-                            // exclude out of bounds pixels
-                            if (!mp.isPixelInImage(pixRC, camId))
-                                continue;
-
-                            // If the color is pure zero (ie. no contributions), we consider it as an invalid pixel.
-                            if (getInterpolateColor(camImg, pixRC.y, pixRC.x) == image::RGBfColor(0.f, 0.f, 0.f))
-                                continue;
-
-                            // Fill the accumulated pyramid for this pixel
-                            // each frequency band also contributes to lower frequencies (higher band indexes)
-                            AccuPyramid& accuPyramid = accuPyramids.at(atlasID);
-                            for (std::size_t bandContrib = band; bandContrib < pyramidL.size(); ++bandContrib)
-                            {
-                                int downscaleCoef = std::pow(texParams.multiBandDownscale, bandContrib);
-                                AccuImage& accuImage = accuPyramid.pyramid[bandContrib];
-
-                                // fill the accumulated color map for this pixel
-                                const auto pixDownscaled = pixRC / downscaleCoef;
-                                accuImage.img(xyoffset) +=
-                                  getInterpolateColor(pyramidL[bandContrib], pixDownscaled.y, pixDownscaled.x) * triangleScore;
-                                accuImage.imgCount[xyoffset] += triangleScore;
-                            }
-                        }
+        for (std::size_t level = 0; level < atlasesTiles[atlasID].size(); ++level)
+        {
+            AccuImage& accuImage = accuPyramid.pyramid[level];
+            const LevelTiles& levelTiles = atlasesTiles[atlasID][level];
+            for (int tileId = 0; tileId < nbTilesPerLevel; ++tileId)
+            {
+                const image::CachedTile::smart_pointer& tile = levelTiles[tileId];
+                if (tile == nullptr)
+                    continue;  // no contribution
+                if (!tile->acquire())
+                    ALICEVISION_THROW_ERROR("Cannot acquire the tile " << tileId << " of the texture atlas " << atlasID << ".");
+
+                const AccuPixel* tileData = reinterpret_cast<const AccuPixel*>(tile->getDataPointer());
+                const int tileX = (tileId % nbTilesPerSide) * tileSide;
+                const int tileY = (tileId / nbTilesPerSide) * tileSide;
+                for (int y = 0; y < tileSide && tileY + y < textureSide; ++y)
+                {
+                    for (int x = 0; x < tileSide && tileX + x < textureSide; ++x)
+                    {
+                        const AccuPixel& accuPixel = tileData[y * tileSide + x];
+                        const unsigned int xyoffset = (tileY + y) * textureSide + tileX + x;
+                        accuImage.img(xyoffset) = accuPixel.color;
+                        accuImage.imgCount[xyoffset] = accuPixel.count;
                     }
                 }
             }
         }
+        // release the atlas tiles
+        atlasesTiles[atlasID].clear();
+
+        writeAccumulatedTexture(accuPyramid, atlasID, outPath, textureFileType);
     }
+}
 
+void Texturing::writeAccumulatedTexture(AccuPyramid& accuPyramid,
+                                        const std::size_t atlasID,
+                                        const bfs::path& outPath,
+                                        image::EImageFileType textureFileType)
+{
     // calculate atlas texture in the first level of the pyramid (avoid creating a new buffer)
     // debug mode : write all the frequencies levels for each texture
-    for (std::size_t atlasID : atlasIDs)
-    {
-        AccuPyramid& accuPyramid = accuPyramids.at(atlasID);
-        AccuImage& atlasTexture = accuPyramid.pyramid[0];
-        ALICEVISION_LOG_INFO("Create texture " << atlasID + 1);
+    AccuImage& atlasTexture = accuPyramid.pyramid[0];
+    ALICEVISION_LOG_INFO("Create texture " << atlasID + 1);
 
 #if TEXTURING_MBB_DEBUG
+    {
+        // write the number of contribution per atlas frequency bands
+        if (!texParams.useScore)
         {
-            // write the number of contribution per atlas frequency bands
-            if (!texParams.useScore)
+            for (std::size_t level = 0; level < accuPyramid.pyramid.size(); ++level)
             {
-                for (std::size_t level = 0; level < accuPyramid.pyramid.size(); ++level)
-                {
-                    AccuImage& atlasLevelTexture = accuPyramid.pyramid[level];
+                AccuImage& atlasLevelTexture = accuPyramid.pyramid[level];
 
-                    // write the number of contributions for each texture
-                    std::vector<float> imgContrib(textureSize);
+                // write the number of contributions for each texture
+                std::vector<float> imgContrib(texParams.textureSide * texParams.textureSide);
 
-                    for (unsigned int yp = 0; yp < texParams.textureSide; ++yp)
+                for (unsigned int yp = 0; yp < texParams.textureSide; ++yp)
+                {
+                    unsigned int yoffset = yp * texParams.textureSide;
+                    for (unsigned int xp = 0; xp < texParams.textureSide; ++xp)
                     {
-                        unsigned int yoffset = yp * texParams.textureSide;
-                        for (unsigned int xp = 0; xp < texParams.textureSide; ++xp)
-                        {
-                            unsigned int xyoffset = yoffset + xp;
-                            imgContrib[xyoffset] = atlasLevelTexture.imgCount[xyoffset];
-                        }
+                        unsigned int xyoffset = yoffset + xp;
+                        imgContrib[xyoffset] = atlasLevelTexture.imgCount[xyoffset];
                     }
+                }
 
-                    const std::string textureName = "contrib_" + std::to_string(1001 + atlasID) + std::string("_") + std::to_string(level) +
-                                                    std::string(".") +
-                                                    EImageFileType_enumToString(textureFileType);  // starts at '1001' for UDIM compatibility
-                    bfs::path texturePath = outPath / textureName;
+                const std::string textureName = "contrib_" + std::to_string(1001 + atlasID) + std::string("_") + std::to_string(level) +
+                                                std::string(".") +
+                                                EImageFileType_enumToString(textureFileType);  // starts at '1001' for UDIM compatibility
+                bfs::path texturePath = outPath / textureName;
 
-                    using namespace imageIO;
-                    OutputFileColorSpace colorspace(EImageColorSpace::SRGB, EImageColorSpace::AUTO);
-                    if (texParams.convertLAB)
-                        colorspace.from = EImageColorSpace::LAB;
-                    writeImage(texturePath.string(), texParams.textureSide, texParams.textureSide, imgContrib, EImageQuality::OPTIMIZED, colorspace);
-                }
+                using namespace imageIO;
+                OutputFileColorSpace colorspace(EImageColorSpace::SRGB, EImageColorSpace::AUTO);
+                if (texParams.convertLAB)
+                    colorspace.from = EImageColorSpace::LAB;
+                writeImage(texturePath.string(), texParams.textureSide, texParams.textureSide, imgContrib, EImageQuality::OPTIMIZED, colorspace);
             }
         }
+    }
 #endif
 
-        ALICEVISION_LOG_INFO("  - Computing final (average) color.");
-        for (unsigned int yp = 0; yp < texParams.textureSide; ++yp)
+    ALICEVISION_LOG_INFO("  - Computing final (average) color.");
+    for (unsigned int yp = 0; yp < texParams.textureSide; ++yp)
+    {
+        unsigned int yoffset = yp * texParams.textureSide;
+        for (unsigned int xp = 0; xp < texParams.textureSide; ++xp)
         {
-            unsigned int yoffset = yp * texParams.textureSide;
-            for (unsigned int xp = 0; xp < texParams.textureSide; ++xp)
-            {
-                unsigned int xyoffset = yoffset + xp;
+            unsigned int xyoffset = yoffset + xp;
 
-                // If the imgCount is valid on the first band, it will be valid on all the other bands
-                if (atlasTexture.imgCount[xyoffset] == 0)
-                    continue;
+            // If the imgCount is valid on the first band, it will be valid on all the other bands
+            if (atlasTexture.imgCount[xyoffset] == 0)
+                continue;
 
-                atlasTexture.img(xyoffset) /= atlasTexture.imgCount[xyoffset];
-                atlasTexture.imgCount[xyoffset] = 1;
+            atlasTexture.img(xyoffset) /= atlasTexture.imgCount[xyoffset];
+            atlasTexture.imgCount[xyoffset] = 1;
 
-                for (std::size_t level = 1; level < accuPyramid.pyramid.size(); ++level)
-                {
-                    AccuImage& atlasLevelTexture = accuPyramid.pyramid[level];
-                    atlasLevelTexture.img(xyoffset) /= atlasLevelTexture.imgCount[xyoffset];
-                }
+            for (std::size_t level = 1; level < accuPyramid.pyramid.size(); ++level)
+            {
+                AccuImage& atlasLevelTexture = accuPyramid.pyramid[level];
+                atlasLevelTexture.img(xyoffset) /= atlasLevelTexture.imgCount[xyoffset];
             }
         }
+    }
 
 #if TEXTURING_MBB_DEBUG
+    {
+        // write each frequency band, for each texture
+        for (std::size_t level = 0; level < accuPyramid.pyramid.size(); ++level)
         {
-            // write each frequency band, for each texture
-            for (std::size_t level = 0; level < accuPyramid.pyramid.size(); ++level)
-            {
-                AccuImage& atlasLevelTexture = accuPyramid.pyramid[level];
-                writeTexture(atlasLevelTexture, atlasID, outPath, textureFileType, level);
-            }
+            AccuImage& atlasLevelTexture = accuPyramid.pyramid[level];
+            writeTexture(atlasLevelTexture, atlasID, outPath, textureFileType, level);
         }
+    }
 #endif
 
-        // Fuse frequency bands into the first buffer, calculate final texture
-        for (unsigned int yp = 0; yp < texParams.textureSide; ++yp)
+    // Fuse frequency bands into the first buffer, calculate final texture
+    for (unsigned int yp = 0; yp < texParams.textureSide; ++yp)
+    {
+        unsigned int yoffset = yp * texParams.textureSide;
+        for (unsigned int xp = 0; xp < texParams.textureSide; ++xp)
         {
-            unsigned int yoffset = yp * texParams.textureSide;
-            for (unsigned int xp = 0; xp < texParams.textureSide; ++xp)
+            unsigned int xyoffset = yoffset + xp;
+            for (std::size_t level = 1; level < accuPyramid.pyramid.size(); ++level)
             {
-                unsigned int xyoffset = yoffset + xp;
-                for (std::size_t level = 1; level < accuPyramid.pyramid.size(); ++level)
-                {
-                    AccuImage& atlasLevelTexture = accuPyramid.pyramid[level];
-                    atlasTexture.img(xyoffset) += atlasLevelTexture.img(xyoffset);
-                }
+                AccuImage& atlasLevelTexture = accuPyramid.pyramid[level];
+                atlasTexture.img(xyoffset) += atlasLevelTexture.img(xyoffset);
             }
         }
-        writeTexture(atlasTexture, atlasID, outPath, textureFileType, -1);
     }
+    writeTexture(atlasTexture, atlasID, outPath, textureFileType, -1);
 }
 
 void Texturing::generateNormalAndHeightMaps(const mvsUtils::MultiViewParams& mp,
@@ -96,6 +96,9 @@ struct TexturingParams
 
     bool forceVisibleByAllVertices = false;  //< triangle visibility is based on the union of vertices visiblity
     EVisibilityRemappingMethod visibilityRemappingMethod = EVisibilityRemappingMethod::PullPush;
+    bool useRasterizedVisibility = false;     //< triangle visibility is computed by rendering the mesh from each camera
+    unsigned int rasterizationDownscale = 4;  //< downscale factor of the images for the visibility rendering
+    bool tiledAccumulation = false;           //< read each image once and accumulate the atlases in out-of-core tiles
 
     float subdivisionTargetRatio = 0.8;
 };
@@ -108,6 +111,9 @@ struct Texturing
     /// texture atlas to 3D triangle ids
     std::vector<std::vector<int>> _atlases;
 
+    /// 3D triangle id to the cameras seeing it, empty if the rasterized visibility is not used
+    std::vector<std::vector<int>> _trianglesCams;
+
     /// Material and texture information
     Material material;
 
@@ -192,6 +198,12 @@ struct Texturing
         }
     };
 
+    using AtlasIndex = std::size_t;
+    /// list of <triangleId, score>
+    using ScorePerTriangle = std::vector<std::pair<unsigned int, float>>;
+    /// triangles contributions of a camera per texture atlas and per frequency band
+    using CameraContributions = std::map<AtlasIndex, std::vector<ScorePerTriangle>>;
+
     /// Generate texture files for all texture atlases
     void generateTextures(const mvsUtils::MultiViewParams& mp,
                           const bfs::path& outPath,
@@ -205,6 +217,29 @@ struct Texturing
                                 const bfs::path& outPath,
                                 image::EImageFileType textureFileType = image::EImageFileType::PNG);
 
+    /**
+     * @brief Generate texture files for all texture atlases, reading each image once.
+     * @note The atlases are accumulated in tiles stored on disk when they do not fit in memory,
+     *       the cameras are visited grouped by their main atlas to limit the tiles reloads.
+     * @param[in] tilesMemory the memory allowed for the tiles in memory (bytes)
+     */
+    void generateTexturesTiled(const mvsUtils::MultiViewParams& mp,
+                               mvsUtils::ImagesCache<image::Image<image::RGBfColor>>& imageCache,
+                               const bfs::path& outPath,
+                               std::size_t tilesMemory,
+                               image::EImageFileType textureFileType = image::EImageFileType::PNG);
+
+    /// Select the best cameras for each triangle of the given texture atlases
+    void computeContributionsPerCamera(const mvsUtils::MultiViewParams& mp,
+                                       const std::vector<size_t>& atlasIDs,
+                                       std::vector<CameraContributions>& contributionsPerCamera) const;
+
+    /// Compute the final color of an accumulated atlas pyramid and write its texture file
+    void writeAccumulatedTexture(AccuPyramid& accuPyramid,
+                                 const std::size_t atlasID,
+                                 const bfs::path& outPath,
+                                 image::EImageFileType textureFileType);
+
     void generateNormalAndHeightMaps(const mvsUtils::MultiViewParams& mp,
                                      const Mesh& denseMesh,
                                      const bfs::path& outPath,
@@ -6,12 +6,196 @@
 
 #include "UVAtlas.hpp"
 #include <aliceVision/system/Logger.hpp>
+#include <aliceVision/mesh/MeshTopology.hpp>
 
+#include <algorithm>
 #include <iostream>
+#include <limits>
+#include <memory>
 
 namespace aliceVision {
 namespace mesh {
 
+namespace {
+
+/**
+ * @brief Pairs of triangles sharing an edge, in the order of the edges (sorted pairs of vertices).
+ * @note An edge shared by n triangles gives the n - 1 pairs of consecutive triangles (in ascending order).
+ * @return the pairs per lower vertex of the edges
+ */
+CompactJaggedArray<std::pair<int, int>> computeEdgeAdjacentTriangles(const Mesh& mesh)
+{
+    const std::shared_ptr<const MeshTopology> topology = mesh.getTopology();
+    const int nbPts = topology->getNbPts();
+
+    // triangles of the edge, sorted and unique
+    const auto getEdgeTriangles = [&](int ptId, int neighborId, std::vector<int>& edgeTris) {
+        edgeTris.clear();
+        for (const int triId : topology->getVertexTriangles(ptId))
+        {
+            const Mesh::triangle& t = mesh.tris[triId];
+            const bool hasNeighbor = (t.v[0] == neighborId || t.v[1] == neighborId || t.v[2] == neighborId);
+            if (hasNeighbor && (edgeTris.empty() || edgeTris.back() != triId))
+                edgeTris.push_back(triId);
+        }
+    };
+
+    CompactJaggedArray<std::pair<int, int>>::Builder builder(nbPts);
+
+#pragma omp parallel
+    {
+        std::vector<int> edgeTris;
+#pragma omp for
+        for (int ptId = 0; ptId < nbPts; ++ptId)
+        {
+            int nbPairs = 0;
+            for (const int neighborId : topology->getVertexNeighbors(ptId))
+            {
+                // each edge from its lower vertex
+                if (neighborId < ptId)
+                    continue;
+                getEdgeTriangles(ptId, neighborId, edgeTris);
+                nbPairs += std::max(0, static_cast<int>(edgeTris.size()) - 1);
+            }
+            builder.count(ptId, nbPairs);
+        }
+    }
+
+    builder.allocate();
+
+#pragma omp parallel
+    {
+        std::vector<int> edgeTris;
+#pragma omp for
+        for (int ptId = 0; ptId < nbPts; ++ptId)
+        {
+            const CompactJaggedArray<std::pair<int, int>>::Row row = builder.row(ptId);
+            int pos = 0;
+            for (const int neighborId : topology->getVertexNeighbors(ptId))
+            {
+                if (neighborId < ptId)
+                    continue;
+                getEdgeTriangles(ptId, neighborId, edgeTris);
+                for (std::size_t k = 1; k < edgeTris.size(); ++k)
+                    row[pos++] = std::make_pair(edgeTris[k - 1], edgeTris[k]);
+            }
+        }
+    }
+
+    return builder.build();
+}
+
+/**
+ * @brief Bottom-left skyline packing of rectangles in a square texture.
+ *
+ * The skyline is the list of the top heights of the packed rectangles along the texture width.
+ * Each rectangle is placed on the lowest position of the skyline where it fits.
+ */
+class SkylinePacker
+{
+  public:
+    explicit SkylinePacker(int side)
+      : _side(side)
+    {
+        _skyline.push_back({0, 0, side});
+    }
+
+    /**
+     * @brief Insert a rectangle.
+     * @param[in] width the rectangle width
+     * @param[in] height the rectangle height
+     * @param[out] position the left-up position of the rectangle
+     * @return false if the rectangle does not fit in the texture
+     */
+    bool insert(int width, int height, Pixel& position)
+    {
+        int bestIndex = -1;
+        int bestY = std::numeric_limits<int>::max();
+        for (int i = 0; i < static_cast<int>(_skyline.size()); ++i)
+        {
+            const int y = fit(i, width, height);
+            if (y >= 0 && y < bestY)
+            {
+                bestIndex = i;
+                bestY = y;
+            }
+        }
+        if (bestIndex < 0)
+            return false;
+
+        const Segment segment{_skyline[bestIndex].x, bestY + height, width};
+        position = Pixel(segment.x, bestY);
+        _skyline.insert(_skyline.begin() + bestIndex, segment);
+
+        // shrink or remove the segments under the new one
+        const int segmentEnd = segment.x + segment.width;
+        const std::size_t next = bestIndex + 1;
+        while (next < _skyline.size() && _skyline[next].x < segmentEnd)
+        {
+            Segment& s = _skyline[next];
+            const int overlap = segmentEnd - s.x;
+            if (s.width > overlap)
+            {
+                s.x += overlap;
+                s.width -= overlap;
+                break;
+            }
+            _skyline.erase(_skyline.begin() + next);
+        }
+
+        // merge with the neighbor segments at the same height
+        if (next < _skyline.size() && _skyline[next].y == _skyline[bestIndex].y)
+        {
+            _skyline[bestIndex].width += _skyline[next].width;
+            _skyline.erase(_skyline.begin() + next);
+        }
+        if (bestIndex > 0 && _skyline[bestIndex - 1].y == _skyline[bestIndex].y)
+        {
+            _skyline[bestIndex - 1].width += _skyline[bestIndex].width;
+            _skyline.erase(_skyline.begin() + bestIndex);
+        }
+
+        _usedArea += static_cast<double>(width) * height;
+        return true;
+    }
+
+    /// ratio of the texture covered by the inserted rectangles
+    double getFillRatio() const { return _usedArea / (static_cast<double>(_side) * _side); }
+
+  private:
+    struct Segment
+    {
+        int x;
+        int y;
+        int width;
+    };
+
+    /**
+     * @return the top of a rectangle placed on the segment, or -1 if it does not fit
+     */
+    int fit(int index, int width, int height) const
+    {
+        if (_skyline[index].x + width > _side)
+            return -1;
+        int y = 0;
+        int remainingWidth = width;
+        for (std::size_t i = index; remainingWidth > 0; ++i)
+        {
+            y = std::max(y, _skyline[i].y);
+            if (y + height > _side)
+                return -1;
+            remainingWidth -= _skyline[i].width;
+        }
+        return y;
+    }
+
+    int _side;
+    double _usedArea = 0.0;
+    std::vector<Segment> _skyline;
+};
+
+}  // namespace
+
 UVAtlas::UVAtlas(const Mesh& mesh, mvsUtils::MultiViewParams& mp, unsigned int textureSide, unsigned int gutterSize)
   : _textureSide(textureSide),
     _gutterSize(gutterSize),
@@ -37,7 +221,7 @@ void UVAtlas::createCharts(std::vector<Chart>& charts, mvsUtils::MultiViewParams
     ALICEVISION_LOG_INFO("Creating texture charts.");
 
     // compute per cam triangle visibility
-    StaticVector<StaticVector<int>> trisCams;
+    CompactJaggedArray<int> trisCams;
     _mesh.computeTrisCamsFromPtsCams(trisCams);
 
     // create one chart per triangle
@@ -49,7 +233,7 @@ void UVAtlas::createCharts(std::vector<Chart>& charts, mvsUtils::MultiViewParams
         std::vector<std::pair<float, int>> commonCameraIDs;
 
         // project triangle in all cams
-        auto cameras = trisCams[i];
+        const CompactJaggedArray<int>::ConstRow cameras = trisCams[i];
         for (int c = 0; c < cameras.size(); ++c)
         {
             int cameraID = cameras[c];
@@ -89,63 +273,27 @@ void UVAtlas::packCharts(std::vector<Chart>& charts, mvsUtils::MultiViewParams&
 {
     ALICEVISION_LOG_INFO("Packing texture charts (" << charts.size() << " charts).");
 
-    std::function<int(int)> findChart = [&](int cid) {
-        Chart& c = charts[cid];
-        if (c.mergedWith >= 0)
+    // root chart, with path compression
+    const auto findChart = [&](int cid) {
+        int root = cid;
+        while (charts[root].mergedWith >= 0)
+            root = charts[root].mergedWith;
+        while (charts[cid].mergedWith >= 0)
         {
-            int r = findChart(c.mergedWith);
-            c.mergedWith = r;
-            return r;
+            const int next = charts[cid].mergedWith;
+            charts[cid].mergedWith = root;
+            cid = next;
         }
-        return cid;
+        return root;
     };
 
-    // list mesh edges (with duplicates)
-    std::vector<Edge> alledges;
-    for (int i = 0; i < _mesh.tris.size(); ++i)
-    {
-        int a = _mesh.tris[i].v[0];
-        int b = _mesh.tris[i].v[1];
-        int c = _mesh.tris[i].v[2];
-        Edge e1;
-        e1.pointIDs = std::make_pair(std::min(a, b), std::max(a, b));
-        e1.triangleIDs.emplace_back(i);
-        alledges.emplace_back(e1);
-        Edge e2;
-        e2.pointIDs = std::make_pair(std::min(b, c), std::max(b, c));
-        e2.triangleIDs.emplace_back(i);
-        alledges.emplace_back(e2);
-        Edge e3;
-        e3.pointIDs = std::make_pair(std::min(c, a), std::max(c, a));
-        e3.triangleIDs.emplace_back(i);
-        alledges.emplace_back(e3);
-    }
-    std::sort(alledges.begin(), alledges.end());
+    const CompactJaggedArray<std::pair<int, int>> adjacentTriangles = computeEdgeAdjacentTriangles(_mesh);
 
-    // merge edges (no duplicate)
-    std::vector<Edge> edges;
-    auto eit = alledges.begin() + 1;
-    while (eit != alledges.end())
+    // merge charts, in the order of the mesh edges
+    for (const std::pair<int, int>& triangles : adjacentTriangles.getData())
     {
-        auto& a = *(eit - 1);
-        auto& b = *eit;
-        if (a == b)
-        {
-            a.triangleIDs.insert(a.triangleIDs.end(), b.triangleIDs.begin(), b.triangleIDs.end());
-            sort(a.triangleIDs.begin(), a.triangleIDs.end());
-            edges.push_back(a);
-        }
-        ++eit;
-    }
-    alledges.clear();
-
-    // merge charts
-    for (auto& e : edges)
-    {
-        if (e.triangleIDs.size() != 2)
-            continue;
-        int chartIDA = findChart(e.triangleIDs[0]);
-        int chartIDB = findChart(e.triangleIDs[1]);
+        int chartIDA = findChart(triangles.first);
+        int chartIDB = findChart(triangles.second);
         if (chartIDA == chartIDB)
             continue;
         Chart& a = charts[chartIDA];
@@ -163,6 +311,7 @@ void UVAtlas::packCharts(std::vector<Chart>& charts, mvsUtils::MultiViewParams&
             // merge b in a
             a.commonCameraIDs = cameraIntersection;
             a.triangleIDs.insert(a.triangleIDs.end(), b.triangleIDs.begin(), b.triangleIDs.end());
+            std::vector<int>().swap(b.triangleIDs);
             b.mergedWith = chartIDA;
         }
         else
@@ -170,10 +319,10 @@ void UVAtlas::packCharts(std::vector<Chart>& charts, mvsUtils::MultiViewParams&
             // merge a in b
             b.commonCameraIDs = cameraIntersection;
             b.triangleIDs.insert(b.triangleIDs.end(), a.triangleIDs.begin(), a.triangleIDs.end());
+            std::vector<int>().swap(a.triangleIDs);
             a.mergedWith = chartIDB;
         }
     }
-    edges.clear();
 
     // remove merged charts
     charts.erase(remove_if(charts.begin(), charts.end(), [](Chart& c) { return (c.mergedWith >= 0); }), charts.end());
@@ -235,18 +384,22 @@ void UVAtlas::createTextureAtlases(std::vector<Chart>& charts, mvsUtils::MultiVi
 {
     ALICEVISION_LOG_INFO("Creating texture atlases.");
 
-    // sort charts by size, descending
+    if (charts.empty())
+        return;
+
+    // sort charts by size, descending, the tallest first for the skyline packing
     std::sort(charts.begin(), charts.end(), [](const Chart& a, const Chart& b) {
-        int wa = a.targetWidth();
-        int wb = b.targetWidth();
-        if (wa == wb)
-            return a.targetHeight() > b.targetHeight();
-        return wa > wb;
+        const int ha = a.targetHeight();
+        const int hb = b.targetHeight();
+        if (ha == hb)
+            return a.targetWidth() > b.targetWidth();
+        return ha > hb;
     });
 
     std::size_t i = 0;                  // forward index
     std::size_t j = charts.size() - 1;  // backward index
     std::size_t texCount = 0;
+    double sumFillRatio = 0.0;
 
     // insert charts into one or more texture atlas
     while (i <= j)
@@ -255,25 +408,20 @@ void UVAtlas::createTextureAtlases(std::vector<Chart>& charts, mvsUtils::MultiVi
         // create a texture atlas
         ALICEVISION_LOG_INFO("\t- texture atlas " << texCount);
         std::vector<Chart> atlas;
-        // create a tree root
-        ChartRect* root = new ChartRect();
-        root->LU.x = 0;
-        root->LU.y = 0;
-        root->RD.x = _textureSide - 1;
-        root->RD.y = _textureSide - 1;
+        SkylinePacker packer(_textureSide - 1);
 
         const auto insertChart = [&](size_t idx) -> bool {
             Chart& chart = charts[idx];
-            ChartRect* rect = root->insert(chart, _gutterSize);
-            if (!rect)
+            Pixel position;
+            if (!packer.insert(chart.targetWidth() + _gutterSize * 2, chart.targetHeight() + _gutterSize * 2, position))
                 return false;
 
             // store the final position
-            chart.targetLU = rect->LU;
+            chart.targetLU = position;
             chart.targetLU.x += _gutterSize;
             chart.targetLU.y += _gutterSize;
             // add to the current texture atlas
-            atlas.emplace_back(chart);
+            atlas.emplace_back(std::move(chart));
             return true;
         };
         // insert as many charts as possible in forward direction (largest to smallest)
@@ -291,92 +439,13 @@ void UVAtlas::createTextureAtlases(std::vector<Chart>& charts, mvsUtils::MultiVi
             throw std::runtime_error("Unable to add any chart to this atlas");
 
         // atlas is full or all charts have been handled
-        ALICEVISION_LOG_INFO("Filled with " << atlas.size() << " charts.");
+        ALICEVISION_LOG_INFO("Filled with " << atlas.size() << " charts (fill ratio: " << packer.getFillRatio() * 100.0 << "%).");
+        sumFillRatio += packer.getFillRatio();
         // store this texture
-        _atlases.emplace_back(atlas);
-        // clear the whole tree
-        root->clear();
-        delete root;
+        _atlases.emplace_back(std::move(atlas));
     }
-}
-
-void UVAtlas::ChartRect::clear()
-{
-    if (child[0])
-        child[0]->clear();
-    if (child[1])
-        child[1]->clear();
-    delete child[0];
-    delete child[1];
-}
 
-UVAtlas::ChartRect* UVAtlas::ChartRect::insert(Chart& chart, size_t gutter)
-{
-    if (child[0] || child[1])  // not a leaf
-    {
-        if (child[0])
-            if (ChartRect* rect = child[0]->insert(chart, gutter))
-                return rect;
-        if (child[1])
-            if (ChartRect* rect = child[1]->insert(chart, gutter))
-                return rect;
-        return nullptr;
-    }
-    else
-    {
-        size_t chartWidth = chart.targetWidth() + gutter * 2;
-        size_t chartHeight = chart.targetHeight() + gutter * 2;
-        // if there is already a chart here
-        if (c)
-            return nullptr;
-        // not enough space
-        if (chartWidth > (RD.x - LU.x))
-            return nullptr;
-        if (chartHeight > (RD.y - LU.y))
-            return nullptr;
-        // split & create children
-        if (chartWidth >= chartHeight)
-        {
-            if (chartWidth < (RD.x - LU.x))
-            {
-                child[0] = new ChartRect();
-                child[0]->LU.x = LU.x + chartWidth;
-                child[0]->LU.y = LU.y;
-                child[0]->RD.x = RD.x;
-                child[0]->RD.y = LU.y + chartHeight;
-            }
-            if (chartHeight < (RD.y - LU.y))
-            {
-                child[1] = new ChartRect();
-                child[1]->LU.x = LU.x;
-                child[1]->LU.y = LU.y + chartHeight;
-                child[1]->RD.x = RD.x;
-                child[1]->RD.y = RD.y;
-            }
-        }
-        else
-        {
-            if (chartHeight < (RD.y - LU.y))
-            {
-                child[0] = new ChartRect();
-                child[0]->LU.x = LU.x;
-                child[0]->LU.y = LU.y + chartHeight;
-                child[0]->RD.x = LU.x + chartWidth;
-                child[0]->RD.y = RD.y;
-            }
-            if (chartWidth < (RD.x - LU.x))
-            {
-                child[1] = new ChartRect();
-                child[1]->LU.x = LU.x + chartWidth;
-                child[1]->LU.y = LU.y;
-                child[1]->RD.x = RD.x;
-                child[1]->RD.y = RD.y;
-            }
-        }
-        // insert chart
-        c = &chart;
-        return this;
-    }
+    ALICEVISION_LOG_INFO("Texture atlases: " << texCount << ", mean fill ratio: " << sumFillRatio / texCount * 100.0 << "%.");
 }
 
 }  // namespace mesh
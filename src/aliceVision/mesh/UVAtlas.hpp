@@ -46,16 +46,6 @@ class UVAtlas
         int targetHeight() const { return sourceHeight() * downscale; }
     };
 
-    struct ChartRect
-    {
-        Chart* c = nullptr;
-        ChartRect* child[2]{nullptr, nullptr};
-        Pixel LU;
-        Pixel RD;
-        void clear();
-        ChartRect* insert(Chart& chart, size_t gutter);
-    };
-
   public:
     UVAtlas(const Mesh& mesh, mvsUtils::MultiViewParams& mp, unsigned int textureSide, unsigned int gutterSize);
 
@@ -2,7 +2,11 @@
 
 #include <aliceVision/mesh/Mesh.hpp>
 
+#include <geogram/basic/attributes.h>
 #include <geogram/mesh/mesh.h>
+#include <geogram/mesh/mesh_AABB.h>
+
+#include <memory>
 
 namespace aliceVision {
 namespace mesh {
@@ -40,5 +44,32 @@ inline void toGeoMesh(const Mesh& src, GEO::Mesh& dst)
     assert(src.tris.size() == dst.facets.nb());
 }
 
+/**
+ * @brief Geogram copy of an aliceVision::Mesh with the AABB tree of its triangles.
+ *
+ * @note GEO::MeshFacetsAABB reorders the geogram mesh (mesh_reorder),
+ *       the aliceVision vertex index of each geogram vertex is kept in reorderedVertices.
+ */
+struct GeoMeshFacetsAABB
+{
+    GEO::Mesh geoMesh;
+    std::unique_ptr<GEO::MeshFacetsAABB> aabb;
+    /// aliceVision vertex index of each geogram vertex
+    GEO::vector<GEO::index_t> reorderedVertices;
+
+    explicit GeoMeshFacetsAABB(const Mesh& mesh)
+    {
+        toGeoMesh(mesh, geoMesh);
+
+        GEO::Attribute<GEO::index_t> reorderedVerticesAttr(geoMesh.vertices.attributes(), "reorder");
+        for (GEO::index_t i = 0; i < geoMesh.vertices.nb(); ++i)
+            reorderedVerticesAttr[i] = i;
+
+        aabb = std::make_unique<GEO::MeshFacetsAABB>(geoMesh);  // warning: mesh_reorder called inside
+
+        reorderedVertices = reorderedVerticesAttr.get_vector();
+    }
+};
+
 }  // namespace mesh
 }  // namespace aliceVision
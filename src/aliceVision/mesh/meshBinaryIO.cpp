@@ -0,0 +1,350 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "meshBinaryIO.hpp"
+
+#include <aliceVision/system/Logger.hpp>
+#include <aliceVision/alicevision_omp.hpp>
+
+#include <boost/algorithm/string/case_conv.hpp>
+#include <boost/filesystem.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+namespace aliceVision {
+namespace mesh {
+
+namespace {
+
+constexpr char fileMagic[8] = {'A', 'V', 'M', 'E', 'S', 'H', '\0', '\0'};
+constexpr std::uint32_t fileVersion = 1;
+constexpr std::uint64_t sectionAlignment = 64;
+
+struct FileHeader
+{
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t nbSections;
+    std::int32_t nbMaterials;
+    char reserved[12];
+};
+
+struct SectionEntry
+{
+    std::uint32_t type;
+    std::uint32_t elementSize;
+    std::uint64_t nbElements;
+    std::uint64_t offset;
+    std::uint64_t reserved;
+};
+
+static_assert(sizeof(FileHeader) == 32, "Unexpected binary mesh header size");
+static_assert(sizeof(SectionEntry) == 32, "Unexpected binary mesh section entry size");
+
+// the sections are read and written directly from the mesh arrays
+static_assert(sizeof(Point3d) == 3 * sizeof(double), "Point3d is not packed");
+static_assert(sizeof(Point2d) == 2 * sizeof(double), "Point2d is not packed");
+static_assert(sizeof(Voxel) == 3 * sizeof(std::int32_t), "Voxel is not packed");
+static_assert(sizeof(rgb) == 3, "rgb is not packed");
+
+/// contiguous array to write in a section
+struct SectionData
+{
+    EBinaryMeshSection type;
+    std::uint32_t elementSize;
+    std::uint64_t nbElements;
+    const void* data;
+};
+
+template<class T>
+SectionData makeSection(EBinaryMeshSection type, const std::vector<T>& values)
+{
+    return {type, static_cast<std::uint32_t>(sizeof(T)), values.size(), values.data()};
+}
+
+std::uint64_t alignOffset(std::uint64_t offset) { return (offset + sectionAlignment - 1) / sectionAlignment * sectionAlignment; }
+
+void checkByteOrder()
+{
+    const std::uint16_t value = 1;
+    unsigned char firstByte;
+    std::memcpy(&firstByte, &value, 1);
+    if (firstByte != 1)
+        ALICEVISION_THROW_ERROR("The binary mesh format is only supported on little-endian platforms.");
+}
+
+const SectionEntry* findSection(const std::vector<SectionEntry>& sections, EBinaryMeshSection type)
+{
+    for (const SectionEntry& section : sections)
+    {
+        if (section.type == static_cast<std::uint32_t>(type))
+            return &section;
+    }
+    return nullptr;
+}
+
+template<class T>
+void readSection(std::ifstream& file, const SectionEntry& section, std::vector<T>& values, const std::string& filepath)
+{
+    if (section.elementSize != sizeof(T))
+    {
+        ALICEVISION_THROW_ERROR("Invalid element size (" << section.elementSize << ") of the section " << section.type
+                                                         << " in the binary mesh file: " << filepath);
+    }
+    values.resize(section.nbElements);
+    file.seekg(section.offset);
+    file.read(reinterpret_cast<char*>(values.data()), static_cast<std::streamsize>(section.nbElements * sizeof(T)));
+    if (!file)
+        ALICEVISION_THROW_ERROR("Cannot read the section " << section.type << " of the binary mesh file: " << filepath);
+}
+
+/// read an optional per triangle section, empty if the section is not in the file
+template<class T>
+void readTrianglesSection(std::ifstream& file,
+                          const std::vector<SectionEntry>& sections,
+                          EBinaryMeshSection type,
+                          int nbTris,
+                          std::vector<T>& values,
+                          const std::string& filepath)
+{
+    values.clear();
+    const SectionEntry* section = findSection(sections, type);
+    if (section == nullptr)
+        return;
+    if (section->nbElements != static_cast<std::uint64_t>(nbTris))
+        ALICEVISION_THROW_ERROR("The section " << section->type << " does not match the number of triangles in the binary mesh file: " << filepath);
+    readSection(file, *section, values, filepath);
+}
+
+}  // namespace
+
+bool isBinaryMeshFile(const std::string& filepath)
+{
+    return boost::algorithm::to_lower_copy(boost::filesystem::path(filepath).extension().string()) == binaryMeshExtension;
+}
+
+void saveBinaryMesh(const Mesh& mesh, const std::string& filepath)
+{
+    checkByteOrder();
+
+    const int nbTris = mesh.tris.size();
+
+    // the triangles without their alive flag
+    std::vector<Voxel> trisVertices(nbTris);
+    bool allAlive = true;
+#pragma omp parallel for reduction(&& : allAlive)
+    for (int i = 0; i < nbTris; ++i)
+    {
+        const Mesh::triangle& t = mesh.tris[i];
+        trisVertices[i] = Voxel(t.v[0], t.v[1], t.v[2]);
+        allAlive = allAlive && t.alive;
+    }
+
+    std::vector<std::uint8_t> trisAlive;
+    if (!allAlive)
+    {
+        trisAlive.resize(nbTris);
+#pragma omp parallel for
+        for (int i = 0; i < nbTris; ++i)
+            trisAlive[i] = mesh.tris[i].alive ? 1 : 0;
+    }
+
+    // the visibilities of all the vertices in a single array
+    std::vector<std::uint64_t> visibilitiesOffsets;
+    std::vector<int> visibilities;
+    if (!mesh.pointsVisibilities.empty())
+    {
+        const int nbPts = mesh.pointsVisibilities.size();
+        visibilitiesOffsets.resize(nbPts + 1, 0);
+        for (int i = 0; i < nbPts; ++i)
+            visibilitiesOffsets[i + 1] = visibilitiesOffsets[i] + mesh.pointsVisibilities[i].size();
+
+        visibilities.resize(visibilitiesOffsets.back());
+#pragma omp parallel for
+        for (int i = 0; i < nbPts; ++i)
+        {
+            const PointVisibility& pointVisibility = mesh.pointsVisibilities[i];
+            std::copy(pointVisibility.begin(), pointVisibility.end(), visibilities.begin() + visibilitiesOffsets[i]);
+        }
+    }
+
+    std::vector<SectionData> sections;
+    sections.push_back(makeSection(EBinaryMeshSection::VERTICES, mesh.pts.getData()));
+    sections.push_back(makeSection(EBinaryMeshSection::TRIANGLES, trisVertices));
+    if (!trisAlive.empty())
+        sections.push_back(makeSection(EBinaryMeshSection::TRIANGLES_ALIVE, trisAlive));
+    if (!mesh.uvCoords.empty())
+        sections.push_back(makeSection(EBinaryMeshSection::UVS, mesh.uvCoords.getData()));
+    if (!mesh.trisUvIds.empty())
+        sections.push_back(makeSection(EBinaryMeshSection::TRIANGLES_UV_IDS, mesh.trisUvIds.getData()));
+    if (!mesh.normals.empty())
+        sections.push_back(makeSection(EBinaryMeshSection::NORMALS, mesh.normals.getData()));
+    if (!mesh.trisNormalsIds.empty())
+        sections.push_back(makeSection(EBinaryMeshSection::TRIANGLES_NORMAL_IDS, mesh.trisNormalsIds.getData()));
+    if (!mesh.trisMtlIds().empty())
+        sections.push_back(makeSection(EBinaryMeshSection::TRIANGLES_MATERIAL_IDS, mesh.trisMtlIds()));
+    if (!mesh.colors().empty())
+        sections.push_back(makeSection(EBinaryMeshSection::COLORS, mesh.colors()));
+    if (!visibilitiesOffsets.empty())
+    {
+        sections.push_back(makeSection(EBinaryMeshSection::VISIBILITIES_OFFSETS, visibilitiesOffsets));
+        sections.push_back(makeSection(EBinaryMeshSection::VISIBILITIES, visibilities));
+    }
+
+    FileHeader header{};
+    std::memcpy(header.magic, fileMagic, sizeof(fileMagic));
+    header.version = fileVersion;
+    header.nbSections = static_cast<std::uint32_t>(sections.size());
+    header.nbMaterials = mesh.nmtls;
+
+    std::vector<SectionEntry> entries(sections.size());
+    std::uint64_t offset = alignOffset(sizeof(FileHeader) + sections.size() * sizeof(SectionEntry));
+    for (std::size_t i = 0; i < sections.size(); ++i)
+    {
+        entries[i] = {static_cast<std::uint32_t>(sections[i].type), sections[i].elementSize, sections[i].nbElements, offset, 0};
+        offset = alignOffset(offset + sections[i].elementSize * sections[i].nbElements);
+    }
+
+    std::ofstream file(filepath, std::ios::binary);
+    if (!file)
+        ALICEVISION_THROW_ERROR("Cannot open the binary mesh file: " << filepath);
+
+    file.write(reinterpret_cast<const char*>(&header), sizeof(FileHeader));
+    file.write(reinterpret_cast<const char*>(entries.data()), static_cast<std::streamsize>(entries.size() * sizeof(SectionEntry)));
+
+    std::uint64_t position = sizeof(FileHeader) + entries.size() * sizeof(SectionEntry);
+    const char padding[sectionAlignment] = {};
+    for (std::size_t i = 0; i < sections.size(); ++i)
+    {
+        file.write(padding, static_cast<std::streamsize>(entries[i].offset - position));
+        const std::uint64_t size = sections[i].elementSize * sections[i].nbElements;
+        file.write(static_cast<const char*>(sections[i].data), static_cast<std::streamsize>(size));
+        position = entries[i].offset + size;
+    }
+
+    if (!file)
+        ALICEVISION_THROW_ERROR("Cannot write the binary mesh file: " << filepath);
+
+    ALICEVISION_LOG_DEBUG("Binary mesh saved: " << filepath << " (" << mesh.pts.size() << " vertices, " << nbTris << " triangles).");
+}
+
+void loadBinaryMesh(Mesh& mesh, const std::string& filepath)
+{
+    checkByteOrder();
+
+    std::ifstream file(filepath, std::ios::binary | std::ios::ate);
+    if (!file)
+        ALICEVISION_THROW_ERROR("Cannot open the binary mesh file: " << filepath);
+    const std::uint64_t fileSize = static_cast<std::uint64_t>(file.tellg());
+    file.seekg(0);
+
+    FileHeader header;
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(FileHeader)) || std::memcmp(header.magic, fileMagic, sizeof(fileMagic)) != 0)
+        ALICEVISION_THROW_ERROR("Invalid binary mesh file: " << filepath);
+    if (header.version != fileVersion)
+        ALICEVISION_THROW_ERROR("Unsupported binary mesh version " << header.version << " in file: " << filepath);
+
+    std::vector<SectionEntry> sections(header.nbSections);
+    if (sizeof(FileHeader) + sections.size() * sizeof(SectionEntry) > fileSize ||
+        !file.read(reinterpret_cast<char*>(sections.data()), static_cast<std::streamsize>(sections.size() * sizeof(SectionEntry))))
+    {
+        ALICEVISION_THROW_ERROR("Cannot read the section table of the binary mesh file: " << filepath);
+    }
+    for (const SectionEntry& section : sections)
+    {
+        if (section.elementSize == 0 || section.offset > fileSize || section.nbElements > (fileSize - section.offset) / section.elementSize)
+            ALICEVISION_THROW_ERROR("The section " << section.type << " is out of the binary mesh file: " << filepath);
+    }
+
+    const SectionEntry* verticesSection = findSection(sections, EBinaryMeshSection::VERTICES);
+    const SectionEntry* trianglesSection = findSection(sections, EBinaryMeshSection::TRIANGLES);
+    if (verticesSection == nullptr || trianglesSection == nullptr)
+        ALICEVISION_THROW_ERROR("Missing vertices or triangles in the binary mesh file: " << filepath);
+
+    readSection(file, *verticesSection, mesh.pts.getDataWritable(), filepath);
+    const int nbPts = mesh.pts.size();
+
+    std::vector<Voxel> trisVertices;
+    readSection(file, *trianglesSection, trisVertices, filepath);
+    const int nbTris = static_cast<int>(trisVertices.size());
+
+    std::vector<std::uint8_t> trisAlive;
+    readTrianglesSection(file, sections, EBinaryMeshSection::TRIANGLES_ALIVE, nbTris, trisAlive, filepath);
+
+    mesh.tris.resize(nbTris);
+    bool validTris = true;
+#pragma omp parallel for reduction(&& : validTris)
+    for (int i = 0; i < nbTris; ++i)
+    {
+        const Voxel& v = trisVertices[i];
+        Mesh::triangle& t = mesh.tris[i];
+        t = Mesh::triangle(v.x, v.y, v.z);
+        t.alive = trisAlive.empty() || trisAlive[i] != 0;
+        for (int k = 0; k < 3; ++k)
+            validTris = validTris && v.m[k] >= 0 && v.m[k] < nbPts;
+    }
+    if (!validTris)
+        ALICEVISION_THROW_ERROR("Invalid vertex index in the triangles of the binary mesh file: " << filepath);
+
+    mesh.uvCoords.clear();
+    if (const SectionEntry* section = findSection(sections, EBinaryMeshSection::UVS))
+        readSection(file, *section, mesh.uvCoords.getDataWritable(), filepath);
+    readTrianglesSection(file, sections, EBinaryMeshSection::TRIANGLES_UV_IDS, nbTris, mesh.trisUvIds.getDataWritable(), filepath);
+
+    mesh.normals.clear();
+    if (const SectionEntry* section = findSection(sections, EBinaryMeshSection::NORMALS))
+        readSection(file, *section, mesh.normals.getDataWritable(), filepath);
+    readTrianglesSection(file, sections, EBinaryMeshSection::TRIANGLES_NORMAL_IDS, nbTris, mesh.trisNormalsIds.getDataWritable(), filepath);
+
+    readTrianglesSection(file, sections, EBinaryMeshSection::TRIANGLES_MATERIAL_IDS, nbTris, mesh.trisMtlIds(), filepath);
+    mesh.nmtls = header.nbMaterials;
+
+    mesh.colors().clear();
+    if (const SectionEntry* section = findSection(sections, EBinaryMeshSection::COLORS))
+    {
+        if (section->nbElements != static_cast<std::uint64_t>(nbPts))
+            ALICEVISION_THROW_ERROR("The colors do not match the number of vertices in the binary mesh file: " << filepath);
+        readSection(file, *section, mesh.colors(), filepath);
+    }
+
+    mesh.pointsVisibilities.clear();
+    const SectionEntry* visibilitiesOffsetsSection = findSection(sections, EBinaryMeshSection::VISIBILITIES_OFFSETS);
+    const SectionEntry* visibilitiesSection = findSection(sections, EBinaryMeshSection::VISIBILITIES);
+    if (visibilitiesOffsetsSection != nullptr && visibilitiesSection != nullptr)
+    {
+        std::vector<std::uint64_t> visibilitiesOffsets;
+        std::vector<int> visibilities;
+        readSection(file, *visibilitiesOffsetsSection, visibilitiesOffsets, filepath);
+        readSection(file, *visibilitiesSection, visibilities, filepath);
+
+        bool validOffsets = visibilitiesOffsets.size() == static_cast<std::size_t>(nbPts) + 1 && visibilitiesOffsets.front() == 0 &&
+                            visibilitiesOffsets.back() == visibilities.size();
+        for (int i = 0; validOffsets && i < nbPts; ++i)
+            validOffsets = visibilitiesOffsets[i] <= visibilitiesOffsets[i + 1];
+        if (!validOffsets)
+            ALICEVISION_THROW_ERROR("Invalid visibilities in the binary mesh file: " << filepath);
+
+        mesh.pointsVisibilities.resize(nbPts);
+#pragma omp parallel for
+        for (int i = 0; i < nbPts; ++i)
+        {
+            mesh.pointsVisibilities[i].getDataWritable().assign(visibilities.begin() + visibilitiesOffsets[i],
+                                                                visibilities.begin() + visibilitiesOffsets[i + 1]);
+        }
+    }
+
+    mesh.invalidateSpatialIndexes();
+    mesh.invalidateTopology();
+
+    ALICEVISION_LOG_DEBUG("Binary mesh loaded: " << filepath << " (" << nbPts << " vertices, " << nbTris << " triangles).");
+}
+
+}  // namespace mesh
+}  // namespace aliceVision
@@ -0,0 +1,149 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <aliceVision/mesh/Mesh.hpp>
+#include <aliceVision/system/Logger.hpp>
+
+#include <exception>
+#include <string>
+
+namespace aliceVision {
+namespace mesh {
+
+/**
+ * @brief Binary mesh format (.avmesh), intermediate format between the mesh tools.
+ *
+ * All the values are little-endian, the sections are raw arrays that can be read or memory-mapped as is.
+ * The vertices are in the AliceVision coordinate system (not the OBJ one, no axis flip).
+ *
+ * Layout:
+ * - header (32 bytes): magic "AVMESH\0\0", uint32 version, uint32 number of sections, int32 number of materials,
+ *   12 reserved bytes,
+ * - section table (32 bytes per section): uint32 section type, uint32 element size, uint64 number of elements,
+ *   uint64 offset of the section data from the beginning of the file, 8 reserved bytes,
+ * - section data, each section aligned on 64 bytes.
+ *
+ * The section types are listed in EBinaryMeshSection. Only the vertices and the triangles are required,
+ * unknown sections are ignored by the reader.
+ */
+enum class EBinaryMeshSection : unsigned int
+{
+    VERTICES = 1,               //< double[3] per vertex
+    TRIANGLES = 2,              //< int32[3] vertex indices per triangle
+    TRIANGLES_ALIVE = 3,        //< uint8 per triangle, only written if some triangles are not alive
+    UVS = 4,                    //< double[2] per UV coordinate
+    TRIANGLES_UV_IDS = 5,       //< int32[3] UV indices per triangle
+    NORMALS = 6,                //< double[3] per normal
+    TRIANGLES_NORMAL_IDS = 7,   //< int32[3] normal indices per triangle
+    TRIANGLES_MATERIAL_IDS = 8, //< int32 per triangle
+    COLORS = 9,                 //< uint8[3] per vertex
+    VISIBILITIES_OFFSETS = 10,  //< uint64 per vertex + 1, offset of the visibilities of each vertex
+    VISIBILITIES = 11           //< int32 camera index per visibility
+};
+
+/// file extension of the binary mesh format
+constexpr const char* binaryMeshExtension = ".avmesh";
+
+/**
+ * @param[in] filepath the mesh file path
+ * @return true if the file path has the binary mesh format extension
+ */
+bool isBinaryMeshFile(const std::string& filepath);
+
+/**
+ * @brief Save a mesh in the binary mesh format, with its UVs, normals, material ids, colors and visibilities.
+ * @param[in] mesh the mesh to save
+ * @param[in] filepath the output .avmesh file path
+ */
+void saveBinaryMesh(const Mesh& mesh, const std::string& filepath);
+
+/**
+ * @brief Load a mesh in the binary mesh format.
+ * @param[out] mesh the loaded mesh, all its data are replaced
+ * @param[in] filepath the input .avmesh file path
+ */
+void loadBinaryMesh(Mesh& mesh, const std::string& filepath);
+
+/**
+ * @brief Load a binary mesh file into an OpenMesh triangle mesh, for the tools based on OpenMesh.
+ * @note The vertices are converted to the OBJ coordinate system, as OpenMesh reads them from the OBJ files.
+ * @param[out] out the OpenMesh triangle mesh
+ * @param[in] filepath the input .avmesh file path
+ * @return false if the file cannot be loaded
+ */
+template<class OpenMeshT>
+bool loadBinaryOpenMesh(OpenMeshT& out, const std::string& filepath)
+{
+    Mesh mesh;
+    try
+    {
+        loadBinaryMesh(mesh, filepath);
+    }
+    catch (const std::exception& e)
+    {
+        ALICEVISION_LOG_ERROR(e.what());
+        return false;
+    }
+
+    using Scalar = typename OpenMeshT::Point::value_type;
+    out.clear();
+    out.reserve(mesh.pts.size(), 3 * mesh.tris.size() / 2, mesh.tris.size());
+    for (const Point3d& p : mesh.pts)
+        out.add_vertex(typename OpenMeshT::Point(static_cast<Scalar>(p.x), static_cast<Scalar>(-p.y), static_cast<Scalar>(-p.z)));
+    for (const Mesh::triangle& t : mesh.tris)
+    {
+        if (t.alive)
+            out.add_face(out.vertex_handle(t.v[0]), out.vertex_handle(t.v[1]), out.vertex_handle(t.v[2]));
+    }
+    return true;
+}
+
+/**
+ * @brief Save an OpenMesh triangle mesh in the binary mesh format, see loadBinaryOpenMesh.
+ * @param[in] in the OpenMesh triangle mesh, without deleted elements
+ * @param[in] filepath the output .avmesh file path
+ * @return false if the file cannot be saved
+ */
+template<class OpenMeshT>
+bool saveBinaryOpenMesh(const OpenMeshT& in, const std::string& filepath)
+{
+    Mesh mesh;
+    mesh.pts.reserve(in.n_vertices());
+    for (const auto vh : in.vertices())
+    {
+        const auto& p = in.point(vh);
+        mesh.pts.push_back(Point3d(static_cast<double>(p[0]), -static_cast<double>(p[1]), -static_cast<double>(p[2])));
+    }
+    mesh.tris.reserve(in.n_faces());
+    for (const auto fh : in.faces())
+    {
+        Mesh::triangle t;
+        int k = 0;
+        for (const auto vh : in.fv_range(fh))
+        {
+            if (k < 3)
+                t.v[k] = vh.idx();
+            ++k;
+        }
+        mesh.tris.push_back(t);
+    }
+
+    try
+    {
+        saveBinaryMesh(mesh, filepath);
+    }
+    catch (const std::exception& e)
+    {
+        ALICEVISION_LOG_ERROR(e.what());
+        return false;
+    }
+    return true;
+}
+
+}  // namespace mesh
+}  // namespace aliceVision
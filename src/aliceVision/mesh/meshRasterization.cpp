@@ -0,0 +1,231 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2023 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "meshRasterization.hpp"
+
+#include <aliceVision/system/Logger.hpp>
+#include <aliceVision/alicevision_omp.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace aliceVision {
+namespace mesh {
+
+namespace {
+
+/// vertex projected in the rendered map
+struct ProjectedVertex
+{
+    double x;
+    double y;
+    double invZ;
+    bool valid;
+};
+
+/// number of rendered pixels of depth tolerance for the visibility test
+const double visibilityDepthTolerance = 2.0;
+
+inline double edgeFunction(const ProjectedVertex& a, const ProjectedVertex& b, double x, double y)
+{
+    return (b.x - a.x) * (y - a.y) - (b.y - a.y) * (x - a.x);
+}
+
+inline ProjectedVertex projectVertex(const Point3d& p, const Matrix3x4& P, double sx, double sy)
+{
+    const Point3d XT = P * p;
+    ProjectedVertex pv;
+    pv.valid = XT.z > 0.0;
+    if (!pv.valid)
+        return pv;
+    // sample the rendered pixels at their centers
+    pv.x = (XT.x / XT.z + 0.5) * sx - 0.5;
+    pv.y = (XT.y / XT.z + 0.5) * sy - 0.5;
+    pv.invZ = 1.0 / XT.z;
+    return pv;
+}
+
+void rasterizeTriangle(int triId, const ProjectedVertex& a, const ProjectedVertex& b, const ProjectedVertex& c, int minY, int maxY, TrianglesIdsMap& map)
+{
+    const double area = edgeFunction(a, b, c.x, c.y);
+    if (area == 0.0)
+        return;
+    const double invArea = 1.0 / area;
+
+    const int x0 = std::max(0, static_cast<int>(std::ceil(std::min({a.x, b.x, c.x}))));
+    const int x1 = std::min(map.width - 1, static_cast<int>(std::floor(std::max({a.x, b.x, c.x}))));
+    const int y0 = std::max(minY, static_cast<int>(std::ceil(std::min({a.y, b.y, c.y}))));
+    const int y1 = std::min(maxY, static_cast<int>(std::floor(std::max({a.y, b.y, c.y}))));
+
+    for (int y = y0; y <= y1; ++y)
+    {
+        for (int x = x0; x <= x1; ++x)
+        {
+            // barycentric coordinates, whatever the triangle orientation
+            const double w0 = edgeFunction(b, c, x, y) * invArea;
+            const double w1 = edgeFunction(c, a, x, y) * invArea;
+            const double w2 = edgeFunction(a, b, x, y) * invArea;
+            if (w0 < 0.0 || w1 < 0.0 || w2 < 0.0)
+                continue;
+
+            // the inverse depth is linear in image space
+            const float invZ = static_cast<float>(w0 * a.invZ + w1 * b.invZ + w2 * c.invZ);
+            const int index = y * map.width + x;
+            if (invZ > map.invDepths[index])
+            {
+                map.invDepths[index] = invZ;
+                map.trisIds[index] = triId;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Depth test of a 3d point against the rendered map.
+ * @return true if the point is in the map and not occluded
+ */
+bool isPointVisible(const TrianglesIdsMap& map,
+                    const mvsUtils::MultiViewParams& mp,
+                    int camId,
+                    double sx,
+                    double sy,
+                    const Point3d& p,
+                    double depthTolerance)
+{
+    const ProjectedVertex pv = projectVertex(p, mp.camArr[camId], sx, sy);
+    if (!pv.valid)
+        return false;
+    const int x = static_cast<int>(std::round(pv.x));
+    const int y = static_cast<int>(std::round(pv.y));
+    if (x < 0 || y < 0 || x >= map.width || y >= map.height)
+        return false;
+    const float bufferInvZ = map.getInvDepth(x, y);
+    if (bufferInvZ <= 0.0f)
+        return true;
+    return (1.0 / pv.invZ) <= (1.0 / bufferInvZ) + depthTolerance;
+}
+
+}  // namespace
+
+void rasterizeTrianglesIds(const Mesh& mesh,
+                           const mvsUtils::MultiViewParams& mp,
+                           int camId,
+                           int width,
+                           int height,
+                           TrianglesIdsMap& out_map,
+                           const StaticVector<int>* trianglesIds)
+{
+    out_map.width = width;
+    out_map.height = height;
+    out_map.trisIds.assign(width * height, -1);
+    out_map.invDepths.assign(width * height, 0.0f);
+
+    if (width <= 0 || height <= 0)
+        return;
+
+    const double sx = double(width) / double(mp.getWidth(camId));
+    const double sy = double(height) / double(mp.getHeight(camId));
+    const Matrix3x4& P = mp.camArr[camId];
+
+    // project all vertices once
+    std::vector<ProjectedVertex> projectedPts(mesh.pts.size());
+#pragma omp parallel for
+    for (int i = 0; i < mesh.pts.size(); ++i)
+        projectedPts[i] = projectVertex(mesh.pts[i], P, sx, sy);
+
+    // bin the triangles per band of rows, each band is rendered by a single thread
+    const int nbBands = std::max(1, std::min(height, omp_get_max_threads() * 4));
+    const int bandHeight = (height + nbBands - 1) / nbBands;
+    std::vector<std::vector<int>> bandsTriangles(nbBands);
+
+    const int nbTriangles = (trianglesIds != nullptr) ? trianglesIds->size() : mesh.tris.size();
+    for (int t = 0; t < nbTriangles; ++t)
+    {
+        const int triId = (trianglesIds != nullptr) ? (*trianglesIds)[t] : t;
+        const Mesh::triangle& tri = mesh.tris[triId];
+        const ProjectedVertex& a = projectedPts[tri.v[0]];
+        const ProjectedVertex& b = projectedPts[tri.v[1]];
+        const ProjectedVertex& c = projectedPts[tri.v[2]];
+        if (!a.valid || !b.valid || !c.valid)
+            continue;
+
+        if (std::max({a.x, b.x, c.x}) < 0.0 || std::min({a.x, b.x, c.x}) > width - 1)
+            continue;
+
+        const int y0 = std::max(0, static_cast<int>(std::ceil(std::min({a.y, b.y, c.y}))));
+        const int y1 = std::min(height - 1, static_cast<int>(std::floor(std::max({a.y, b.y, c.y}))));
+        if (y0 > y1)
+            continue;
+
+        for (int band = y0 / bandHeight; band <= y1 / bandHeight; ++band)
+            bandsTriangles[band].push_back(triId);
+    }
+
+#pragma omp parallel for schedule(dynamic)
+    for (int band = 0; band < nbBands; ++band)
+    {
+        const int minY = band * bandHeight;
+        const int maxY = std::min(height, minY + bandHeight) - 1;
+        for (const int triId : bandsTriangles[band])
+        {
+            const Mesh::triangle& tri = mesh.tris[triId];
+            rasterizeTriangle(triId, projectedPts[tri.v[0]], projectedPts[tri.v[1]], projectedPts[tri.v[2]], minY, maxY, out_map);
+        }
+    }
+}
+
+void getVisibleTriangles(const TrianglesIdsMap& map, std::vector<int>& out_visibleTriangles)
+{
+    out_visibleTriangles.clear();
+    for (const int triId : map.trisIds)
+    {
+        if (triId >= 0)
+            out_visibleTriangles.push_back(triId);
+    }
+    std::sort(out_visibleTriangles.begin(), out_visibleTriangles.end());
+    out_visibleTriangles.erase(std::unique(out_visibleTriangles.begin(), out_visibleTriangles.end()), out_visibleTriangles.end());
+}
+
+void computeTrianglesCamerasVisibility(const Mesh& mesh,
+                                       const mvsUtils::MultiViewParams& mp,
+                                       int downscale,
+                                       std::vector<std::vector<int>>& out_trianglesCams)
+{
+    ALICEVISION_LOG_INFO("Compute triangles visibility by rasterization (downscale: " << downscale << ").");
+
+    out_trianglesCams.assign(mesh.tris.size(), std::vector<int>());
+    downscale = std::max(1, downscale);
+
+    TrianglesIdsMap map;
+    for (int camId = 0; camId < mp.ncams; ++camId)
+    {
+        const int width = std::max(1, mp.getWidth(camId) / downscale);
+        const int height = std::max(1, mp.getHeight(camId) / downscale);
+        rasterizeTrianglesIds(mesh, mp, camId, width, height, map);
+
+        const double sx = double(width) / double(mp.getWidth(camId));
+        const double sy = double(height) / double(mp.getHeight(camId));
+
+        // each triangle is updated by a single thread and cameras are added in increasing order
+#pragma omp parallel for
+        for (int triId = 0; triId < mesh.tris.size(); ++triId)
+        {
+            const Point3d center = mesh.computeTriangleCenterOfGravity(triId);
+            const double depthTolerance = visibilityDepthTolerance * mp.getCamPixelSize(center, camId) * double(downscale);
+
+            bool visible = isPointVisible(map, mp, camId, sx, sy, center, depthTolerance);
+            for (int k = 0; !visible && k < 3; ++k)
+                visible = isPointVisible(map, mp, camId, sx, sy, mesh.pts[mesh.tris[triId].v[k]], depthTolerance);
+
+            if (visible)
+                out_trianglesCams[triId].push_back(camId);
+        }
+        ALICEVISION_LOG_DEBUG("Triangles visibility: camera " << camId + 1 << "/" << mp.ncams << " done.");
+    }
+}
+
+}  // namespace mesh
+}  // namespace aliceVision
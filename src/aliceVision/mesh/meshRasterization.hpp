@@ -0,0 +1,77 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2023 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <aliceVision/mesh/Mesh.hpp>
+#include <aliceVision/mvsData/StaticVector.hpp>
+#include <aliceVision/mvsUtils/MultiViewParams.hpp>
+
+#include <vector>
+
+namespace aliceVision {
+namespace mesh {
+
+/**
+ * @brief Triangle ids of a mesh rendered from a camera with a z-buffer.
+ * @note The maps are stored row by row. Pixel (x, y) is sampled at its center.
+ */
+struct TrianglesIdsMap
+{
+    int width = 0;
+    int height = 0;
+    /// id of the nearest triangle per pixel, -1 if no triangle
+    std::vector<int> trisIds;
+    /// inverse of the camera space depth of the nearest triangle per pixel, 0 if no triangle
+    std::vector<float> invDepths;
+
+    inline int getTriangleId(int x, int y) const { return trisIds[y * width + x]; }
+    inline float getInvDepth(int x, int y) const { return invDepths[y * width + x]; }
+};
+
+/**
+ * @brief Render the triangle ids of the mesh from the given camera.
+ * @note The image rows are split in bands rendered in parallel, so no pixel is shared between threads.
+ *       Triangles with a vertex behind the camera are not rendered.
+ * @param[in] mesh the mesh to render
+ * @param[in] mp the multi-view parameters
+ * @param[in] camId the camera index
+ * @param[in] width the rendered map width, the camera image is rescaled to this size
+ * @param[in] height the rendered map height
+ * @param[out] out_map the rendered triangle ids and depths
+ * @param[in] trianglesIds the triangles to render, all triangles if nullptr
+ */
+void rasterizeTrianglesIds(const Mesh& mesh,
+                           const mvsUtils::MultiViewParams& mp,
+                           int camId,
+                           int width,
+                           int height,
+                           TrianglesIdsMap& out_map,
+                           const StaticVector<int>* trianglesIds = nullptr);
+
+/**
+ * @brief Get the ids of the triangles visible in at least one pixel of the rendered map.
+ * @param[in] map the rendered triangle ids
+ * @param[out] out_visibleTriangles the sorted visible triangle ids
+ */
+void getVisibleTriangles(const TrianglesIdsMap& map, std::vector<int>& out_visibleTriangles);
+
+/**
+ * @brief Compute the cameras seeing each triangle by rendering the mesh from each camera.
+ * @note A triangle is visible from a camera if its center of gravity or one of its vertices passes the depth test,
+ *       so the triangles smaller than a rendered pixel are not lost.
+ * @param[in] mesh the mesh
+ * @param[in] mp the multi-view parameters
+ * @param[in] downscale the rendering downscale factor of the camera images
+ * @param[out] out_trianglesCams the sorted camera indexes seeing each triangle
+ */
+void computeTrianglesCamerasVisibility(const Mesh& mesh,
+                                       const mvsUtils::MultiViewParams& mp,
+                                       int downscale,
+                                       std::vector<std::vector<int>>& out_trianglesCams);
+
+}  // namespace mesh
+}  // namespace aliceVision
@@ -24,13 +24,12 @@ void getNearestVertices(const Mesh& refMesh, const Mesh& mesh, StaticVector<int>
     ALICEVISION_LOG_DEBUG("getNearestVertices start.");
     out_nearestVertex.resize(mesh.pts.size(), -1);
 
-    GEO::AdaptiveKdTree refMesh_kdTree(3);
-    refMesh_kdTree.set_points(refMesh.pts.size(), refMesh.pts.front().m);
+    const std::shared_ptr<const GEO::AdaptiveKdTree> refMesh_kdTree = refMesh.getVerticesKdTree();
 
 #pragma omp parallel for
     for (int i = 0; i < mesh.pts.size(); ++i)
     {
-        out_nearestVertex[i] = refMesh_kdTree.get_nearest_neighbor(mesh.pts[i].m);
+        out_nearestVertex[i] = refMesh_kdTree->get_nearest_neighbor(mesh.pts[i].m);
     }
     ALICEVISION_LOG_DEBUG("getNearestVertices done.");
 }
@@ -42,8 +41,7 @@ void remapMeshVisibilities_pullVerticesVisibility(const Mesh& refMesh, Mesh& mes
     const PointsVisibility& refPtsVisibilities = refMesh.pointsVisibilities;
     PointsVisibility& out_ptsVisibilities = mesh.pointsVisibilities;
 
-    GEO::AdaptiveKdTree refMesh_kdTree(3);
-    refMesh_kdTree.set_points(refMesh.pts.size(), refMesh.pts.front().m);
+    const std::shared_ptr<const GEO::AdaptiveKdTree> refMesh_kdTree = refMesh.getVerticesKdTree();
 
     out_ptsVisibilities.resize(mesh.pts.size());
 
@@ -52,7 +50,7 @@ void remapMeshVisibilities_pullVerticesVisibility(const Mesh& refMesh, Mesh& mes
     {
         PointVisibility& pOut = out_ptsVisibilities[i];
 
-        int iRef = refMesh_kdTree.get_nearest_neighbor(mesh.pts[i].m);
+        int iRef = refMesh_kdTree->get_nearest_neighbor(mesh.pts[i].m);
         if (iRef == -1)
             continue;
         const PointVisibility& pRef = refPtsVisibilities[iRef];
@@ -80,18 +78,10 @@ void remapMeshVisibilities_pushVerticesVisibilityToTriangles(const Mesh& refMesh
     const PointsVisibility& refPtsVisibilities = refMesh.pointsVisibilities;
     PointsVisibility& out_ptsVisibilities = mesh.pointsVisibilities;
 
-    GEO::initialize();
-    GEO::Mesh meshG;
-    toGeoMesh(mesh, meshG);
-
-    // MeshFacetAABB will reorder the mesh, so we need to keep indices
-    GEO::Attribute<GEO::index_t> reorderedVerticesAttr(meshG.vertices.attributes(), "reorder");
-    for (int i = 0; i < meshG.vertices.nb(); ++i)
-        reorderedVerticesAttr[i] = i;
-
-    GEO::MeshFacetsAABB meshAABB(meshG);  // warning: mesh_reorder called inside
-
-    GEO::vector<GEO::index_t> reorderedVertices = reorderedVerticesAttr.get_vector();
+    const std::shared_ptr<const GeoMeshFacetsAABB> facetsAABB = mesh.getFacetsAABB();
+    const GEO::Mesh& meshG = facetsAABB->geoMesh;
+    const GEO::MeshFacetsAABB& meshAABB = *facetsAABB->aabb;
+    const GEO::vector<GEO::index_t>& reorderedVertices = facetsAABB->reorderedVertices;
 
     if (out_ptsVisibilities.size() != mesh.pts.size())
     {
@@ -142,18 +132,8 @@ void remapMeshVisibilities_meshItself(const mvsUtils::MultiViewParams& mp, Mesh&
 
     PointsVisibility& out_ptsVisibilities = mesh.pointsVisibilities;
 
-    GEO::initialize();
-    GEO::Mesh meshG;
-    toGeoMesh(mesh, meshG);
-
-    // MeshFacetAABB will reorder the mesh, so we need to keep indices
-    GEO::Attribute<GEO::index_t> reorderedVerticesAttr(meshG.vertices.attributes(), "reorder");
-    for (int i = 0; i < meshG.vertices.nb(); ++i)
-        reorderedVerticesAttr[i] = i;
-
-    GEO::MeshFacetsAABB meshAABB(meshG);  // warning: mesh_reorder called inside
-
-    GEO::vector<GEO::index_t> reorderedVertices = reorderedVerticesAttr.get_vector();
+    const std::shared_ptr<const GeoMeshFacetsAABB> facetsAABB = mesh.getFacetsAABB();
+    const GEO::MeshFacetsAABB& meshAABB = *facetsAABB->aabb;
 
     if (out_ptsVisibilities.size() != mesh.pts.size())
     {
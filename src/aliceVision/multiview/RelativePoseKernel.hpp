@@ -140,8 +140,11 @@ class RelativePoseKernel_K : public robustEstimation::PointFittingRansacKernel<S
 
     void fit(const std::vector<std::size_t>& samples, std::vector<ModelT_>& models) const override
     {
-        const Mat x1 = buildSubsetMatrix(_x1k, samples);
-        const Mat x2 = buildSubsetMatrix(_x2k, samples);
+        // reuse the sample matrices of the thread instead of allocating them at each call
+        static thread_local Mat x1;
+        static thread_local Mat x2;
+        buildSubsetMatrix(_x1k, samples, x1);
+        buildSubsetMatrix(_x2k, samples, x2);
 
         PFRansacKernel::PFKernel::_kernelSolver.solve(x1, x2, models);
     }
@@ -154,6 +157,14 @@ class RelativePoseKernel_K : public robustEstimation::PointFittingRansacKernel<S
         return _errorEstimator.error(modelF, PFRansacKernel::PFKernel::_x1.col(sample), PFRansacKernel::PFKernel::_x2.col(sample));
     }
 
+    void errors(const ModelT_& model, std::vector<double>& errors) const override
+    {
+        // the fundamental matrix is computed once for all the samples
+        Mat3 F;
+        fundamentalFromEssential(model.getMatrix(), _K1, _K2, &F);
+        PFRansacKernel::PFKernel::estimatorErrors(ModelT_(F), errors);
+    }
+
     void unnormalize(ModelT_& model) const override
     {
         // do nothing, no normalization in this case
@@ -91,20 +91,26 @@ enum polynomialCoefficient
 
 using Pc = polynomialCoefficient;
 
+/**
+ * @brief Coefficients of a polynomial in the basis of monomials above.
+ * @note Fixed size, so the solver does not allocate memory.
+ */
+using Vec20 = Eigen::Matrix<double, 20, 1>;
+
 /**
  * @brief Multiply two polynomials of degree 1.
  */
-Vec o1(const Vec& a, const Vec& b);
+Vec20 o1(const Vec20& a, const Vec20& b);
 
 /**
  * @brief Multiply a polynomial of degree 2, a, by a polynomial of degree 1, b.
  */
-Vec o2(const Vec& a, const Vec& b);
+Vec20 o2(const Vec20& a, const Vec20& b);
 
 /**
  * @brief Compute the nullspace of the linear constraints given by the matches.
  */
-Mat fivePointsNullspaceBasis(const Mat2X& x1, const Mat2X& x2);
+Eigen::Matrix<double, 9, 4> fivePointsNullspaceBasis(const Mat& x1, const Mat& x2);
 
 }  // namespace relativePose
 }  // namespace multiview
@@ -69,6 +69,14 @@ class EssentialKernel : public robustEstimation::PointFittingKernel<SolverT, Err
         return KernelBase::_errorEstimator.error(modelF, KernelBase::_x1.col(sample), KernelBase::_x2.col(sample));
     }
 
+    void errors(const ModelT& model, std::vector<double>& errors) const override
+    {
+        // the fundamental matrix is computed once for all the samples
+        Mat3 F;
+        fundamentalFromEssential(model.getMatrix(), _K1, _K2, &F);
+        KernelBase::estimatorErrors(robustEstimation::Mat3Model(F), errors);
+    }
+
   protected:
     // The two camera calibrated camera matrix
     Mat3 _K1, _K2;
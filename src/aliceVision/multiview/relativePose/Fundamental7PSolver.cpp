@@ -29,7 +29,7 @@ void Fundamental7PSolver::solve(const Mat& x1, const Mat& x2, std::vector<robust
 
         // in the minimal solution use fixed sized matrix to let Eigen and the
         // compiler doing the maximum of optimization.
-        Mat9 A = Mat::Zero(9, 9);
+        Mat9 A = Mat9::Zero();
         encodeEpipolarEquation(x1, x2, &A);
 
         // Eigen::FullPivLU<Mat9> luA(A);
@@ -99,7 +99,7 @@ void Fundamental7PSphericalSolver::solve(const Mat& x1, const Mat& x2, std::vect
         typedef Eigen::Matrix<double, 9, 9> Mat9;
         // In the minimal solution use fixed sized matrix to let Eigen and the
         //  compiler doing the maximum of optimization.
-        Mat9 A = Mat::Zero(9, 9);
+        Mat9 A = Mat9::Zero();
         encodeEpipolarSphericalEquation(x1, x2, &A);
         //    Eigen::FullPivLU<Mat9> luA(A);
         //    ALICEVISION_LOG_DEBUG("\n rank(A) = " << luA.rank());
@@ -11,10 +11,47 @@
 #include <aliceVision/robustEstimation/ISolver.hpp>
 #include <aliceVision/multiview/relativePose/ISolverErrorRelativePose.hpp>
 
+#include <algorithm>
+#include <vector>
+
 namespace aliceVision {
 namespace multiview {
 namespace relativePose {
 
+/**
+ * @brief Compute the terms of the epipolar errors of all the correspondences, by blocks of fixed capacity on the stack:
+ *        the algebraic error y^T F x and the squared norms of the 2 first coordinates of F x and F^T y.
+ * @param[in] F The fundamental matrix
+ * @param[in] x1 Points in the first image. One per column.
+ * @param[in] x2 Corresponding points in the second image. One per column.
+ * @param[in] blockFunctor Called for each block with (start, yFx, squared norm of Fx, squared norm of F^T y) as row arrays
+ */
+template<typename BlockFunctorT>
+inline void forEachEpipolarBlock(const Mat3& F, const Mat& x1, const Mat& x2, BlockFunctorT&& blockFunctor)
+{
+    using Block3 = Eigen::Matrix<double, 3, Eigen::Dynamic, Eigen::ColMajor, 3, robustEstimation::batchErrorsBlockSize>;
+    using BlockRow = Eigen::Array<double, 1, Eigen::Dynamic, Eigen::RowMajor, 1, robustEstimation::batchErrorsBlockSize>;
+
+    Block3 Fx;
+    Block3 Ft_y;
+    for (Eigen::Index start = 0; start < x1.cols(); start += robustEstimation::batchErrorsBlockSize)
+    {
+        const Eigen::Index size = std::min(robustEstimation::batchErrorsBlockSize, x1.cols() - start);
+
+        Fx.noalias() = F.leftCols<2>() * x1.middleCols(start, size);
+        Fx.colwise() += F.col(2);
+        Ft_y.noalias() = F.topRows<2>().transpose() * x2.middleCols(start, size);
+        Ft_y.colwise() += F.row(2).transpose();
+
+        const BlockRow yFx = x2.row(0).segment(start, size).array() * Fx.row(0).array() +
+                             x2.row(1).segment(start, size).array() * Fx.row(1).array() + Fx.row(2).array();
+        const BlockRow Fx_norm2 = Fx.topRows<2>().colwise().squaredNorm().array();
+        const BlockRow Ft_y_norm2 = Ft_y.topRows<2>().colwise().squaredNorm().array();
+
+        blockFunctor(start, yFx, Fx_norm2, Ft_y_norm2);
+    }
+}
+
 /**
  * @brief Compute FundamentalSampsonError related to the Fundamental matrix and 2 correspondences
  */
@@ -31,6 +68,14 @@ struct FundamentalSampsonError : public ISolverErrorRelativePose<robustEstimatio
 
         return Square(y.dot(F_x)) / (F_x.head<2>().squaredNorm() + Ft_y.head<2>().squaredNorm());
     }
+
+    void errors(const robustEstimation::Mat3Model& F, const Mat& x1, const Mat& x2, std::vector<double>& errors) const
+    {
+        errors.resize(x1.cols());
+        forEachEpipolarBlock(F.getMatrix(), x1, x2, [&](Eigen::Index start, const auto& yFx, const auto& Fx_norm2, const auto& Ft_y_norm2) {
+            Eigen::Map<Eigen::ArrayXd>(errors.data() + start, yFx.size()) = (yFx.square() / (Fx_norm2 + Ft_y_norm2)).transpose();
+        });
+    }
 };
 
 struct FundamentalSymmetricEpipolarDistanceError : public ISolverErrorRelativePose<robustEstimation::Mat3Model>
@@ -47,6 +92,14 @@ struct FundamentalSymmetricEpipolarDistanceError : public ISolverErrorRelativePo
         // @note the divide by 4 is to make this match the Sampson distance.
         return Square(y.dot(F_x)) * (1.0 / F_x.head<2>().squaredNorm() + 1.0 / Ft_y.head<2>().squaredNorm()) / 4.0;
     }
+
+    void errors(const robustEstimation::Mat3Model& F, const Mat& x1, const Mat& x2, std::vector<double>& errors) const
+    {
+        errors.resize(x1.cols());
+        forEachEpipolarBlock(F.getMatrix(), x1, x2, [&](Eigen::Index start, const auto& yFx, const auto& Fx_norm2, const auto& Ft_y_norm2) {
+            Eigen::Map<Eigen::ArrayXd>(errors.data() + start, yFx.size()) = (yFx.square() * (Fx_norm2.inverse() + Ft_y_norm2.inverse()) / 4.0).transpose();
+        });
+    }
 };
 
 struct FundamentalEpipolarDistanceError : public ISolverErrorRelativePose<robustEstimation::Mat3Model>
@@ -61,6 +114,20 @@ struct FundamentalEpipolarDistanceError : public ISolverErrorRelativePose<robust
 
         return Square(F_x.dot(y)) / F_x.head<2>().squaredNorm();
     }
+
+    void errors(const robustEstimation::Mat3Model& F, const Mat& x1, const Mat& x2, std::vector<double>& errors) const
+    {
+        errors.resize(x1.cols());
+        forEachEpipolarBlock(F.getMatrix(), x1, x2, [&](Eigen::Index start, const auto& yFx, const auto& Fx_norm2, const auto& Ft_y_norm2) {
+            Eigen::Map<Eigen::ArrayXd>(errors.data() + start, yFx.size()) = (yFx.square() / Fx_norm2).transpose();
+        });
+    }
+
+    /**
+     * @brief Epipolar line of x1 in image 2, the error is the squared distance of x2 to this line.
+     * @note Used by the guided matching to only test the points of the epipolar band.
+     */
+    static Vec3 epipolarLine(const robustEstimation::Mat3Model& F, const Vec2& x1) { return F.getMatrix() * Vec3(x1(0), x1(1), 1.0); }
 };
 
 struct EpipolarSphericalDistanceError
@@ -12,6 +12,9 @@
 #include <aliceVision/robustEstimation/ISolver.hpp>
 #include <aliceVision/multiview/relativePose/ISolverErrorRelativePose.hpp>
 
+#include <algorithm>
+#include <vector>
+
 namespace aliceVision {
 namespace multiview {
 namespace relativePose {
@@ -28,6 +31,30 @@ struct HomographyAsymmetricError : ISolverErrorRelativePose<robustEstimation::Ma
         const Vec2 x2_est = x2h_est.head<2>() / x2h_est[2];
         return (x2 - x2_est).squaredNorm();
     }
+
+    void errors(const robustEstimation::Mat3Model& H, const Mat& x1, const Mat& x2, std::vector<double>& errors) const
+    {
+        using Block3 = Eigen::Matrix<double, 3, Eigen::Dynamic, Eigen::ColMajor, 3, robustEstimation::batchErrorsBlockSize>;
+
+        errors.resize(x1.cols());
+        Block3 x2h_est;
+        for (Eigen::Index start = 0; start < x1.cols(); start += robustEstimation::batchErrorsBlockSize)
+        {
+            const Eigen::Index size = std::min(robustEstimation::batchErrorsBlockSize, x1.cols() - start);
+
+            x2h_est.noalias() = H.getMatrix().leftCols<2>() * x1.middleCols(start, size);
+            x2h_est.colwise() += H.getMatrix().col(2);
+
+            Eigen::Map<Eigen::RowVectorXd>(errors.data() + start, size) =
+              (x2.middleCols(start, size).array() - x2h_est.topRows<2>().array().rowwise() / x2h_est.row(2).array()).matrix().colwise().squaredNorm();
+        }
+    }
+
+    /**
+     * @brief Homogeneous transfer of x1 in image 2, the error is the squared distance of x2 to this point.
+     * @note Used by the guided matching to only test the points around the transfer.
+     */
+    static Vec3 transfer(const robustEstimation::Mat3Model& H, const Vec2& x1) { return H.getMatrix() * euclideanToHomogeneous(x1); }
 };
 
 }  // namespace relativePose
@@ -9,6 +9,7 @@
 #include <aliceVision/numeric/projection.hpp>
 #include <aliceVision/robustEstimation/ISolver.hpp>
 #include <aliceVision/multiview/relativePose/FundamentalKernel.hpp>
+#include <aliceVision/multiview/relativePose/HomographyError.hpp>
 
 #define BOOST_TEST_MODULE fundamentalKernelSolver
 #include <boost/test/unit_test.hpp>
@@ -122,3 +123,30 @@ BOOST_AUTO_TEST_CASE(NormalizedFundamental8PKernel_EasyCase)
 
     BOOST_CHECK(expectKernelProperties<relativePose::NormalizedFundamental8PKernel>(x1, x2));
 }
+
+// check that the errors computed in one pass match the errors computed for each sample
+template<typename ErrorT>
+void expectBatchErrors(const robustEstimation::Mat3Model& model, const Mat& x1, const Mat& x2)
+{
+    const ErrorT errorEstimator;
+    std::vector<double> errors;
+    errorEstimator.errors(model, x1, x2, errors);
+
+    BOOST_CHECK_EQUAL(errors.size(), static_cast<std::size_t>(x1.cols()));
+    for (Mat::Index i = 0; i < x1.cols(); ++i)
+        BOOST_CHECK_CLOSE(errors.at(i), errorEstimator.error(model, x1.col(i), x2.col(i)), 1e-8);
+}
+
+BOOST_AUTO_TEST_CASE(FundamentalErrors_Batch)
+{
+    // more points than a block of the batch errors
+    const int nbPoints = 3 * robustEstimation::batchErrorsBlockSize + 7;
+    const Mat x1 = Mat::Random(2, nbPoints) * 100.0;
+    const Mat x2 = Mat::Random(2, nbPoints) * 100.0;
+    const robustEstimation::Mat3Model model(Mat3::Random());
+
+    expectBatchErrors<relativePose::FundamentalSampsonError>(model, x1, x2);
+    expectBatchErrors<relativePose::FundamentalSymmetricEpipolarDistanceError>(model, x1, x2);
+    expectBatchErrors<relativePose::FundamentalEpipolarDistanceError>(model, x1, x2);
+    expectBatchErrors<relativePose::HomographyAsymmetricError>(model, x1, x2);
+}
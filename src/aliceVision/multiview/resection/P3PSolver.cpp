@@ -77,10 +77,8 @@ void solveQuartic(const Vec5& factors, Vec4& realRoots)
  * @return true if correct execution, false if world points aligned
  * @author: Laurent Kneip, adapted to the project by Pierre Moulon
  */
-bool computeP3PPoses(const Mat3& featureVectors, const Mat3& worldPoints, Mat& solutions)
+bool computeP3PPoses(const Mat3& featureVectors, const Mat3& worldPoints, Eigen::Matrix<double, 3, 16>& solutions)
 {
-    solutions = Mat(3, 4 * 4);
-
     // extraction of world points
 
     Vec3 P1 = worldPoints.col(0);
@@ -240,7 +238,7 @@ void P3PSolver::solve(const Mat& x2d, const Mat& x3d, std::vector<robustEstimati
     Vec3 t;
     Mat34 P;
 
-    Mat solutions = Mat(3, 16);
+    Eigen::Matrix<double, 3, 16> solutions;
 
     Mat3 pt2D_3x3;
     pt2D_3x3.block<2, 3>(0, 0) = x2d;
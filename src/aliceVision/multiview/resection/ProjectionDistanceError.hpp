@@ -11,10 +11,37 @@
 #include <aliceVision/robustEstimation/ISolver.hpp>
 #include <aliceVision/multiview/resection/ISolverErrorResection.hpp>
 
+#include <algorithm>
+#include <vector>
+
 namespace aliceVision {
 namespace multiview {
 namespace resection {
 
+/**
+ * @brief Compute the projection residuals of all the correspondences, by blocks of fixed capacity on the stack
+ * @param[in] P The projection matrix
+ * @param[in] x2d 2d points. One per column.
+ * @param[in] x3d Corresponding 3d points. One per column.
+ * @param[in] blockFunctor Called for each block with (start, 2xN array of the residuals)
+ */
+template<typename BlockFunctorT>
+inline void forEachProjectionBlock(const Mat34& P, const Mat& x2d, const Mat& x3d, BlockFunctorT&& blockFunctor)
+{
+    using Block3 = Eigen::Matrix<double, 3, Eigen::Dynamic, Eigen::ColMajor, 3, robustEstimation::batchErrorsBlockSize>;
+
+    Block3 PX;
+    for (Eigen::Index start = 0; start < x2d.cols(); start += robustEstimation::batchErrorsBlockSize)
+    {
+        const Eigen::Index size = std::min(robustEstimation::batchErrorsBlockSize, x2d.cols() - start);
+
+        PX.noalias() = P.leftCols<3>() * x3d.middleCols(start, size);
+        PX.colwise() += P.col(3);
+
+        blockFunctor(start, (PX.topRows<2>().array().rowwise() / PX.row(2).array() - x2d.middleCols(start, size).array()).matrix());
+    }
+}
+
 /**
  * @brief Compute the residual of the projection distance
  *        (pt2D, project(P,pt3D))
@@ -25,6 +52,14 @@ struct ProjectionDistanceError : public ISolverErrorResection<robustEstimation::
     {
         return (project(P.getMatrix(), p3d) - p2d).norm();
     }
+
+    void errors(const robustEstimation::Mat34Model& P, const Mat& x2d, const Mat& x3d, std::vector<double>& errors) const
+    {
+        errors.resize(x2d.cols());
+        forEachProjectionBlock(P.getMatrix(), x2d, x3d, [&](Eigen::Index start, const auto& residuals) {
+            Eigen::Map<Eigen::RowVectorXd>(errors.data() + start, residuals.cols()) = residuals.colwise().norm();
+        });
+    }
 };
 
 /**
@@ -37,6 +72,14 @@ struct ProjectionDistanceSquaredError : public ISolverErrorResection<robustEstim
     {
         return (project(P.getMatrix(), p3d) - p2d).squaredNorm();
     }
+
+    void errors(const robustEstimation::Mat34Model& P, const Mat& x2d, const Mat& x3d, std::vector<double>& errors) const
+    {
+        errors.resize(x2d.cols());
+        forEachProjectionBlock(P.getMatrix(), x2d, x3d, [&](Eigen::Index start, const auto& residuals) {
+            Eigen::Map<Eigen::RowVectorXd>(errors.data() + start, residuals.cols()) = residuals.colwise().squaredNorm();
+        });
+    }
 };
 
 }  // namespace resection
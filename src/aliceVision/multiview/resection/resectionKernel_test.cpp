@@ -206,3 +206,28 @@ BOOST_AUTO_TEST_CASE(EuclideanResection_Points6AllRandomInput)
         BOOST_CHECK(bFound);
     }
 }
+
+BOOST_AUTO_TEST_CASE(ProjectionErrors_Batch)
+{
+    // more points than a block of the batch errors
+    const int nbPoints = 2 * robustEstimation::batchErrorsBlockSize + 11;
+    const NViewDataSet d = NRealisticCamerasRing(1, nbPoints);
+    const Mat x = d._x[0] + Mat::Random(2, nbPoints);
+    const Mat X = d._X;
+    const robustEstimation::Mat34Model model(d.P(0));
+
+    const resection::ProjectionDistanceError error;
+    const resection::ProjectionDistanceSquaredError squaredError;
+    std::vector<double> errors;
+    std::vector<double> squaredErrors;
+    error.errors(model, x, X, errors);
+    squaredError.errors(model, x, X, squaredErrors);
+
+    BOOST_CHECK_EQUAL(errors.size(), static_cast<std::size_t>(nbPoints));
+    BOOST_CHECK_EQUAL(squaredErrors.size(), static_cast<std::size_t>(nbPoints));
+    for (int i = 0; i < nbPoints; ++i)
+    {
+        BOOST_CHECK_CLOSE(errors.at(i), error.error(model, x.col(i), X.col(i)), 1e-8);
+        BOOST_CHECK_CLOSE(squaredErrors.at(i), squaredError.error(model, x.col(i), X.col(i)), 1e-8);
+    }
+}
@@ -7,6 +7,7 @@
 
 #include "l1.hpp"
 #include <aliceVision/system/Logger.hpp>
+#include <aliceVision/alicevision_omp.hpp>
 
 #ifdef ALICEVISION_ROTATION_AVERAGING_WITH_BOOST
     #include <boost/graph/adjacency_list.hpp>
@@ -29,6 +30,8 @@
 #include "ceres/ceres.h"
 #include "ceres/rotation.h"
 
+#include <Eigen/SparseCholesky>
+
 #include <map>
 #include <queue>
 #include <stdint.h>
@@ -43,6 +46,43 @@ namespace aliceVision {
 namespace rotationAveraging {
 namespace l1 {
 
+// Solver of the normal equations A^t*W*A:
+// dense LDLT for the dense matrices, sparse LDLT for the sparse ones
+// (the sparsity pattern is the same for all the iterations, so it is only analyzed once).
+template<typename MATRIX_TYPE>
+struct NormalEquationsSolver
+{
+    typedef Eigen::Matrix<REAL, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> Matrix;
+
+    bool factorize(const Matrix& H)
+    {
+        solver.compute(H);
+        return solver.info() == Eigen::Success;
+    }
+
+    Eigen::LDLT<Matrix> solver;
+};
+
+template<>
+struct NormalEquationsSolver<Eigen::SparseMatrix<REAL, Eigen::ColMajor>>
+{
+    typedef Eigen::SparseMatrix<REAL, Eigen::ColMajor> Matrix;
+
+    bool factorize(const Matrix& H)
+    {
+        if (!patternAnalyzed)
+        {
+            solver.analyzePattern(H);
+            patternAnalyzed = true;
+        }
+        solver.factorize(H);
+        return solver.info() == Eigen::Success;
+    }
+
+    Eigen::SimplicialLDLT<Matrix> solver;
+    bool patternAnalyzed = false;
+};
+
 // Minimum l1 error approximation:
 //
 // Let A be a M x N matrix with full rank. Given y of R^M, the problem
@@ -66,7 +106,7 @@ inline bool TRobustRegressionL1PD(const MATRIX_TYPE& A,
                                   REAL pdtol,
                                   unsigned pdmaxiter)
 {
-    typedef Eigen::Matrix<REAL, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> Matrix;
+    typedef typename NormalEquationsSolver<MATRIX_TYPE>::Matrix Matrix;
     typedef Eigen::Matrix<REAL, Eigen::Dynamic, 1> Vector;
     const unsigned M = (unsigned)y.size();
     const unsigned N = (unsigned)xp.size();
@@ -101,6 +141,7 @@ inline bool TRobustRegressionL1PD(const MATRIX_TYPE& A,
     Vector Axp(M), Atvp(M);
     Vector &Adx(sigx), &du(w2), &w1p(dx);
     Matrix H11p(N, N);
+    NormalEquationsSolver<MATRIX_TYPE> solver;
     Vector &dlamu1(tmpM3), &dlamu2(tmpM4);
     for (unsigned pditer = 0; pditer < pdmaxiter; ++pditer)
     {
@@ -133,7 +174,9 @@ inline bool TRobustRegressionL1PD(const MATRIX_TYPE& A,
         w1p = At * (tmpM4 - tmpM3 - (sig2.cwiseQuotient(sig1).cwiseProduct(w2)));
 
         // optimized solver as A is positive definite and symmetric
-        dx = H11p.ldlt().solve(w1p);
+        if (!solver.factorize(H11p))
+            return false;
+        dx = solver.solver.solve(w1p);
 
         Adx = A * dx;
 
@@ -248,7 +291,6 @@ inline bool TIterativelyReweightedLeastSquares(const MATRIX_TYPE& A,
                                                REAL sigma,
                                                REAL eps)
 {
-    typedef Eigen::Matrix<REAL, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> Matrix;
     typedef Eigen::Matrix<REAL, Eigen::Dynamic, 1> Vector;
     const unsigned m = (unsigned)b.size();
     const unsigned n = (unsigned)x.size();
@@ -259,6 +301,7 @@ inline bool TIterativelyReweightedLeastSquares(const MATRIX_TYPE& A,
     const REAL sigmaSq(Square(sigma));
     unsigned iter = 0;
     REAL delta = std::numeric_limits<REAL>::max(), deltap;
+    NormalEquationsSolver<MATRIX_TYPE> solver;
     do
     {
         xp = x;
@@ -273,14 +316,14 @@ inline bool TIterativelyReweightedLeastSquares(const MATRIX_TYPE& A,
         }
         // solve the linear system using l2 norm
         const MATRIX_TYPE AtF(A.transpose() * e.asDiagonal());
-        const Eigen::LDLT<Matrix> solver(AtF * A);  // compute the Cholesky decomposition
-        if (solver.info() != Eigen::Success)
+        // compute the Cholesky decomposition
+        if (!solver.factorize(AtF * A))
         {
             ALICEVISION_LOG_WARNING("error: decomposing linear system failed");
             return false;
         }
-        x = solver.solve(AtF * b);
-        if (solver.info() != Eigen::Success)
+        x = solver.solver.solve(AtF * b);
+        if (solver.solver.info() != Eigen::Success)
         {
             ALICEVISION_LOG_WARNING("error: solving linear system failed");
             return false;
@@ -455,6 +498,7 @@ unsigned int FilterRelativeRotations(const RelativeRotations& RelRs, const Matri
     assert(threshold >= 0);
     // compute errors for each relative rotation
     std::vector<float> errors(RelRs.size());
+#pragma omp parallel for
     for (int r = 0; r < RelRs.size(); ++r)
     {
         const RelativeRotation& relR = RelRs[r];
@@ -509,6 +553,7 @@ REAL RelRotationAvgError(const RelativeRotations& RelRs, const Matrix3x3Arr& Rs,
     return boost::accumulators::mean(acc);
 #else
     std::vector<REAL> vec_err(RelRs.size(), REAL(0.0));
+#pragma omp parallel for
     for (int i = 0; i < RelRs.size(); ++i)
     {
         const RelativeRotation& relR = RelRs[i];
@@ -597,34 +642,40 @@ bool GlobalRotationsRobust(const RelativeRotations& RelRs,
 // build A in Ax=b
 inline void _FillMappingMatrix(const RelativeRotations& RelRs, const size_t nMainViewID, Eigen::SparseMatrix<REAL, Eigen::ColMajor>& A)
 {
-    A.reserve(A.rows() * 2);  // estimate of the number of non-zeros (optional)
-    Eigen::SparseMatrix<REAL, Eigen::ColMajor>::Index i = 0, j = 0;
+    // the rows are filled in order but the columns are not: build from triplets
+    // to avoid the costly random insertions in the column major storage
+    typedef Eigen::SparseMatrix<REAL, Eigen::ColMajor>::StorageIndex StorageIndex;
+    std::vector<Eigen::Triplet<REAL, StorageIndex>> triplets;
+    triplets.reserve(RelRs.size() * 6);
+    StorageIndex i = 0, j = 0;
     for (int r = 0; r < RelRs.size(); ++r)
     {
         const RelativeRotation& relR = RelRs[r];
         if (relR.i != nMainViewID)
         {
             j = 3 * (relR.i < nMainViewID ? relR.i : relR.i - 1);
-            A.insert(i + 0, j + 0) = REAL(-1);
-            A.insert(i + 1, j + 1) = REAL(-1);
-            A.insert(i + 2, j + 2) = REAL(-1);
+            triplets.emplace_back(i + 0, j + 0, REAL(-1));
+            triplets.emplace_back(i + 1, j + 1, REAL(-1));
+            triplets.emplace_back(i + 2, j + 2, REAL(-1));
         }
         if (relR.j != nMainViewID)
         {
             j = 3 * (relR.j < nMainViewID ? relR.j : relR.j - 1);
-            A.insert(i + 0, j + 0) = REAL(1);
-            A.insert(i + 1, j + 1) = REAL(1);
-            A.insert(i + 2, j + 2) = REAL(1);
+            triplets.emplace_back(i + 0, j + 0, REAL(1));
+            triplets.emplace_back(i + 1, j + 1, REAL(1));
+            triplets.emplace_back(i + 2, j + 2, REAL(1));
         }
         i += 3;
     }
+    A.setFromTriplets(triplets.begin(), triplets.end());
     A.makeCompressed();
 }
 
 // compute errors for each relative rotation
 inline void _FillErrorMatrix(const RelativeRotations& RelRs, const Matrix3x3Arr& Rs, Eigen::Matrix<REAL, Eigen::Dynamic, 1>& b)
 {
-    for (size_t r = 0; r < RelRs.size(); ++r)
+#pragma omp parallel for
+    for (std::ptrdiff_t r = 0; r < static_cast<std::ptrdiff_t>(RelRs.size()); ++r)
     {
         const RelativeRotation& relR = RelRs[r];
         const Matrix3x3& Ri = Rs[relR.i];
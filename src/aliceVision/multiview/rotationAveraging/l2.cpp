@@ -10,8 +10,11 @@
 #include <aliceVision/alicevision_omp.hpp>
 #include <aliceVision/system/Logger.hpp>
 
+#include <Eigen/SparseCholesky>
+
 #include <vector>
 #include <map>
+#include <random>
 
 #include <ceres/ceres.h>
 #include <ceres/rotation.h>
@@ -48,6 +51,78 @@ Mat3 ClosestSVDRotationMatrix(const Mat3& rotMat)
 // <eigenvalue, eigenvector> pair comparator
 bool compare_first_abs(std::pair<double, Vec> const& x, std::pair<double, Vec> const& y) { return fabs(x.first) < fabs(y.first); }
 
+namespace {
+
+//-- Encode the constraints (6.62 Martinec Thesis page 100) in the normal matrix AtA:
+// => weight * ( rj - Rij * ri ) = 0
+sMat buildNormalMatrix(size_t nCamera, const RelativeRotations& vec_relativeRot)
+{
+    const size_t nRotationEstimation = vec_relativeRot.size();
+    //--
+    // Setup the Action Matrix
+    //--
+    std::vector<Eigen::Triplet<double>> tripletList;
+    tripletList.reserve(nRotationEstimation * 12);  // 3*3 + 3
+    sMat::Index cpt = 0;
+    for (RelativeRotations::const_iterator iter = vec_relativeRot.begin(); iter != vec_relativeRot.end(); iter++, cpt++)
+    {
+        //-- Encode weight * ( rj - Rij * ri ) = 0
+        const size_t i = iter->i;
+        const size_t j = iter->j;
+
+        // A.block<3,3>(3 * cpt, 3 * i) = - Rij * weight;
+        for (int row = 0; row < 3; ++row)
+        {
+            for (int col = 0; col < 3; ++col)
+                tripletList.push_back(Eigen::Triplet<double>(3 * cpt + row, 3 * i + col, -iter->Rij(row, col) * iter->weight));
+        }
+
+        // A.block<3,3>(3 * cpt, 3 * j) = Id * weight;
+        for (int row = 0; row < 3; ++row)
+            tripletList.push_back(Eigen::Triplet<double>(3 * cpt + row, 3 * j + row, 1.0 * iter->weight));
+    }
+
+    // nCamera * 3 because each columns have 3 elements.
+    sMat A(nRotationEstimation * 3, 3 * nCamera);
+    A.setFromTriplets(tripletList.begin(), tripletList.end());
+    tripletList.clear();
+
+    return A.transpose() * A;
+}
+
+//--
+// Search the closest matrix :
+//  - From the 3 vectors of the nullspace get back column and reconstruct Rotation matrix
+//  - Enforce the orthogonality constraint
+//     (approximate rotation in the Frobenius norm using SVD).
+//--
+void rotationsFromNullspace(size_t nCamera,
+                            const Vec& nullspaceVector0,
+                            const Vec& nullspaceVector1,
+                            const Vec& nullspaceVector2,
+                            std::vector<Mat3>& vec_ApprRotMatrix)
+{
+    vec_ApprRotMatrix.clear();
+    vec_ApprRotMatrix.reserve(nCamera);
+    for (size_t i = 0; i < nCamera; ++i)
+    {
+        Mat3 Rotation;
+        Rotation << nullspaceVector0.segment(3 * i, 3), nullspaceVector1.segment(3 * i, 3), nullspaceVector2.segment(3 * i, 3);
+
+        //-- Compute the closest SVD rotation matrix
+        Rotation = ClosestSVDRotationMatrix(Rotation);
+        vec_ApprRotMatrix.push_back(Rotation);
+    }
+    // Force R0 to be Identity
+    const Mat3 R0T = vec_ApprRotMatrix[0].transpose();
+    for (size_t i = 0; i < nCamera; ++i)
+    {
+        vec_ApprRotMatrix[i] *= R0T;
+    }
+}
+
+}  // namespace
+
 //-- Solve the Global Rotation matrix registration for each camera given a list
 //    of relative orientation using matrix parametrization
 //    [1] formula 6.62 page 100. Dense formulation.
@@ -76,45 +151,7 @@ bool L2RotationAveraging(size_t nCamera,
                          // Output
                          std::vector<Mat3>& vec_ApprRotMatrix)
 {
-    const size_t nRotationEstimation = vec_relativeRot.size();
-    //--
-    // Setup the Action Matrix
-    //--
-    std::vector<Eigen::Triplet<double>> tripletList;
-    tripletList.reserve(nRotationEstimation * 12);  // 3*3 + 3
-    //-- Encode constraint (6.62 Martinec Thesis page 100):
-    sMat::Index cpt = 0;
-    for (RelativeRotations::const_iterator iter = vec_relativeRot.begin(); iter != vec_relativeRot.end(); iter++, cpt++)
-    {
-        const RelativeRotation& Elem = *iter;
-
-        //-- Encode weight * ( rj - Rij * ri ) = 0
-        const size_t i = iter->i;
-        const size_t j = iter->j;
-
-        // A.block<3,3>(3 * cpt, 3 * i) = - Rij * weight;
-        tripletList.push_back(Eigen::Triplet<double>(3 * cpt, 3 * i, -iter->Rij(0, 0) * iter->weight));
-        tripletList.push_back(Eigen::Triplet<double>(3 * cpt, 3 * i + 1, -iter->Rij(0, 1) * iter->weight));
-        tripletList.push_back(Eigen::Triplet<double>(3 * cpt, 3 * i + 2, -iter->Rij(0, 2) * iter->weight));
-        tripletList.push_back(Eigen::Triplet<double>(3 * cpt + 1, 3 * i, -iter->Rij(1, 0) * iter->weight));
-        tripletList.push_back(Eigen::Triplet<double>(3 * cpt + 1, 3 * i + 1, -iter->Rij(1, 1) * iter->weight));
-        tripletList.push_back(Eigen::Triplet<double>(3 * cpt + 1, 3 * i + 2, -iter->Rij(1, 2) * iter->weight));
-        tripletList.push_back(Eigen::Triplet<double>(3 * cpt + 2, 3 * i, -iter->Rij(2, 0) * iter->weight));
-        tripletList.push_back(Eigen::Triplet<double>(3 * cpt + 2, 3 * i + 1, -iter->Rij(2, 1) * iter->weight));
-        tripletList.push_back(Eigen::Triplet<double>(3 * cpt + 2, 3 * i + 2, -iter->Rij(2, 2) * iter->weight));
-
-        // A.block<3,3>(3 * cpt, 3 * j) = Id * weight;
-        tripletList.push_back(Eigen::Triplet<double>(3 * cpt, 3 * j, 1.0 * iter->weight));
-        tripletList.push_back(Eigen::Triplet<double>(3 * cpt + 1, 3 * j + 1, 1.0 * iter->weight));
-        tripletList.push_back(Eigen::Triplet<double>(3 * cpt + 2, 3 * j + 2, 1.0 * iter->weight));
-    }
-
-    // nCamera * 3 because each columns have 3 elements.
-    sMat A(nRotationEstimation * 3, 3 * nCamera);
-    A.setFromTriplets(tripletList.begin(), tripletList.end());
-    tripletList.clear();
-
-    sMat AtAsparse = A.transpose() * A;
+    const sMat AtAsparse = buildNormalMatrix(nCamera, vec_relativeRot);
     const Mat AtA = Mat(AtAsparse);  // convert to dense
 
     // You can use either SVD or eigen solver (eigen solver will be faster) to solve Ax=0
@@ -142,36 +179,63 @@ bool L2RotationAveraging(size_t nCamera,
         }
         std::stable_sort(eigs.begin(), eigs.end(), &compare_first_abs);
 
-        const Vec& NullspaceVector0 = eigs[0].second;
-        const Vec& NullspaceVector1 = eigs[1].second;
-        const Vec& NullspaceVector2 = eigs[2].second;
-
-        //--
-        // Search the closest matrix :
-        //  - From solution of SVD get back column and reconstruct Rotation matrix
-        //  - Enforce the orthogonality constraint
-        //     (approximate rotation in the Frobenius norm using SVD).
-        //--
-        vec_ApprRotMatrix.clear();
-        vec_ApprRotMatrix.reserve(nCamera);
-        for (size_t i = 0; i < nCamera; ++i)
-        {
-            Mat3 Rotation;
-            Rotation << NullspaceVector0.segment(3 * i, 3), NullspaceVector1.segment(3 * i, 3), NullspaceVector2.segment(3 * i, 3);
+        rotationsFromNullspace(nCamera, eigs[0].second, eigs[1].second, eigs[2].second, vec_ApprRotMatrix);
+        return true;
+    }
+}
 
-            //-- Compute the closest SVD rotation matrix
-            Rotation = ClosestSVDRotationMatrix(Rotation);
-            vec_ApprRotMatrix.push_back(Rotation);
-        }
-        // Force R0 to be Identity
-        const Mat3 R0T = vec_ApprRotMatrix[0].transpose();
-        for (size_t i = 0; i < nCamera; ++i)
-        {
-            vec_ApprRotMatrix[i] *= R0T;
-        }
+bool L2RotationAveraging_Sparse(size_t nCamera, const RelativeRotations& vec_relativeRot, std::vector<Mat3>& vec_ApprRotMatrix, size_t maxIterations)
+{
+    const sMat AtA = buildNormalMatrix(nCamera, vec_relativeRot);
+    const Eigen::Index nbRows = AtA.rows();
+
+    // AtA is singular (its nullspace is the solution), a small shift makes it positive definite.
+    // The shift is negligible compared to the other eigenvalues, so it does not slow down the convergence.
+    sMat shiftedAtA = AtA;
+    const double shift = 1e-10 * std::max(1.0, Vec(AtA.diagonal()).maxCoeff());
+    for (Eigen::Index i = 0; i < nbRows; ++i)
+        shiftedAtA.coeffRef(i, i) += shift;
+
+    Eigen::SimplicialLDLT<sMat> solver(shiftedAtA);
+    if (solver.info() != Eigen::Success)
+    {
+        ALICEVISION_LOG_DEBUG("L2RotationAveraging_Sparse: cannot factorize the normal matrix.");
+        return false;
+    }
 
-        return true;
+    // Inverse subspace iteration on the 3 smallest eigenvectors,
+    // started from a fixed random basis so the result is deterministic
+    std::mt19937 generator(0);
+    std::normal_distribution<double> distribution;
+    Mat basis(nbRows, 3);
+    for (Eigen::Index i = 0; i < basis.size(); ++i)
+        basis.data()[i] = distribution(generator);
+    basis = Eigen::HouseholderQR<Mat>(basis).householderQ() * Mat::Identity(nbRows, 3);
+
+    for (size_t iteration = 0; iteration < maxIterations; ++iteration)
+    {
+        const Mat solved = solver.solve(basis);
+        if (solver.info() != Eigen::Success)
+            return false;
+
+        const Mat nextBasis = Eigen::HouseholderQR<Mat>(solved).householderQ() * Mat::Identity(nbRows, 3);
+
+        // distance between the subspaces of the 2 bases
+        const double change = (nextBasis - basis * (basis.transpose() * nextBasis)).norm();
+        basis = nextBasis;
+        if (change < 1e-12)
+            break;
     }
+
+    // Rayleigh-Ritz: sort the vectors of the subspace by eigenvalues, as the dense formulation
+    const Mat3 projectedAtA = basis.transpose() * (AtA * basis);
+    Eigen::SelfAdjointEigenSolver<Mat3> es(projectedAtA);
+    if (es.info() != Eigen::Success)
+        return false;
+    const Mat nullspace = basis * es.eigenvectors();
+
+    rotationsFromNullspace(nCamera, nullspace.col(0), nullspace.col(1), nullspace.col(2), vec_ApprRotMatrix);
+    return true;
 }
 
 // Ceres Functor to minimize global rotation regarding fixed relative rotation
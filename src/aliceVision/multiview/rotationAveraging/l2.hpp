@@ -60,6 +60,17 @@ bool L2RotationAveraging(size_t nCamera,
                          // Output
                          std::vector<Mat3>& vec_ApprRotMatrix);
 
+//-- Same as L2RotationAveraging, with a sparse formulation:
+//    the 3 vectors of the nullspace are found by inverse subspace iteration
+//    with a sparse Cholesky factorization of AtA, instead of the full eigen decomposition of the dense AtA.
+//    Memory and time grow with the number of relative rotations instead of the cube of the number of cameras.
+//- maxIterations:         The maximum number of subspace iterations
+bool L2RotationAveraging_Sparse(size_t nCamera,
+                                const RelativeRotations& vec_relativeRot,
+                                // Output
+                                std::vector<Mat3>& vec_ApprRotMatrix,
+                                size_t maxIterations = 100);
+
 // None linear refinement of the rotation using an angle-axis representation
 bool L2RotationAveraging_Refine(const RelativeRotations& vec_relativeRot, std::vector<aliceVision::Mat3>& vec_ApprRotMatrix);
 
@@ -8,12 +8,14 @@
 #include "aliceVision/multiview/rotationAveraging/rotationAveraging.hpp"
 #include "aliceVision/multiview/essential.hpp"
 #include <aliceVision/system/Logger.hpp>
+#include <aliceVision/system/Timer.hpp>
 #include "aliceVision/multiview/NViewDataSet.hpp"
 
 #include <iostream>
 #include <fstream>
 #include <vector>
 #include <iterator>
+#include <random>
 #include <utility>
 
 #define BOOST_TEST_MODULE rotationAveraging
@@ -101,6 +103,42 @@ BOOST_AUTO_TEST_CASE(rotationAveraging_RotationLeastSquare_3_Camera)
     BOOST_CHECK_SMALL(FrobeniusDistance(R20, R), 1e-2);
 }
 
+// The sparse formulation finds the same rotations as the dense one, on a noisy loop of cameras
+BOOST_AUTO_TEST_CASE(rotationAveraging_RotationLeastSquare_Sparse)
+{
+    const std::size_t nCamera = 50;
+    std::mt19937 randomNumberGenerator(0);
+    std::normal_distribution<double> noiseDistribution(0.0, 0.01);
+
+    std::vector<Mat3> vec_gtR(nCamera);
+    for (std::size_t i = 0; i < nCamera; ++i)
+        vec_gtR[i] = RotationAroundZ(2. * M_PI * i / nCamera) * RotationAroundX(0.1 * std::sin(double(i)));
+
+    // each camera is linked to its 3 next neighbours
+    RelativeRotations vec_relativeRotEstimate;
+    for (std::size_t i = 0; i < nCamera; ++i)
+    {
+        for (std::size_t k = 1; k <= 3; ++k)
+        {
+            const std::size_t j = (i + k) % nCamera;
+            const Mat3 noise = RotationAroundX(noiseDistribution(randomNumberGenerator)) * RotationAroundY(noiseDistribution(randomNumberGenerator));
+            vec_relativeRotEstimate.push_back(RelativeRotation(i, j, noise * vec_gtR[j] * vec_gtR[i].transpose()));
+        }
+    }
+
+    std::vector<Mat3> vec_globalR, vec_globalRSparse;
+    BOOST_CHECK(L2RotationAveraging(nCamera, vec_relativeRotEstimate, vec_globalR));
+    BOOST_CHECK(L2RotationAveraging_Sparse(nCamera, vec_relativeRotEstimate, vec_globalRSparse));
+    BOOST_REQUIRE_EQUAL(nCamera, vec_globalRSparse.size());
+
+    for (std::size_t i = 0; i < nCamera; ++i)
+    {
+        EXPECT_MATRIX_NEAR(vec_globalR[i], vec_globalRSparse[i], 1e-8);
+        // close to the ground truth, up to the global rotation fixed by the first camera
+        BOOST_CHECK_SMALL(FrobeniusDistance(Mat3(vec_gtR[i] * vec_gtR[0].transpose()), vec_globalRSparse[i]), 0.1);
+    }
+}
+
 BOOST_AUTO_TEST_CASE(rotationAveraging_RefineRotationsAvgL1IRLS_SimpleTriplet)
 {
     //--
@@ -311,6 +349,72 @@ BOOST_AUTO_TEST_CASE(rotationAveraging_RefineRotationsAvgL1IRLS_CompleteGraph_ou
     }
 }
 
+// Large synthetic view graph: each camera of a ring is linked to its next neighbours
+// with noisy relative rotations, and some of them are outliers
+BOOST_AUTO_TEST_CASE(rotationAveraging_RefineRotationsAvgL1IRLS_LargeGraph)
+{
+    const std::size_t iNviews = 2000;
+    const std::size_t nbNeighbours = 4;
+    const std::size_t outlierStep = 50;
+    NViewDataSet d = NRealisticCamerasRing(iNviews, 5, NViewDatasetConfigurator(1, 1, 0, 0, 5, 0));
+
+    std::mt19937 randomNumberGenerator;
+    std::normal_distribution<double> noise(0.0, degreeToRadian(0.1));
+    std::uniform_real_distribution<double> outlierAngle(degreeToRadian(10.0), degreeToRadian(90.0));
+
+    RelativeRotations vec_relativeRotEstimate;
+    std::vector<std::size_t> vec_outliers;
+    for (std::size_t i = 0; i < iNviews; ++i)
+    {
+        for (std::size_t k = 1; k <= nbNeighbours; ++k)
+        {
+            const std::size_t j = (i + k) % iNviews;
+            Mat3 Rrel;
+            Vec3 trel;
+            relativeCameraMotion(d._R[i], d._t[i], d._R[j], d._t[j], &Rrel, &trel);
+
+            // the first edges are kept as inliers for the initial spanning tree
+            if (k > 1 && vec_relativeRotEstimate.size() % outlierStep == 0)
+            {
+                vec_outliers.push_back(vec_relativeRotEstimate.size());
+                Rrel = RotationAroundX(outlierAngle(randomNumberGenerator)) * Rrel;
+            }
+            else
+            {
+                const Vec3 axisAngle(noise(randomNumberGenerator), noise(randomNumberGenerator), noise(randomNumberGenerator));
+                Rrel = Eigen::AngleAxisd(axisAngle.norm(), axisAngle.normalized()).toRotationMatrix() * Rrel;
+            }
+            vec_relativeRotEstimate.push_back(RelativeRotation(i, j, Rrel, k == 1 ? 1.0f : 0.5f));
+        }
+    }
+
+    //- Solve the global rotation estimation problem :
+    Matrix3x3Arr vec_globalR(iNviews);
+    std::size_t nMainViewID = 0;
+    std::vector<bool> inliers;
+    system::Timer timer;
+    BOOST_CHECK(GlobalRotationsRobust(vec_relativeRotEstimate, vec_globalR, nMainViewID, 0.0f, &inliers));
+    ALICEVISION_LOG_INFO("Rotation averaging of " << iNviews << " views and " << vec_relativeRotEstimate.size()
+                                                  << " relative rotations: " << timer.elapsed() << "s");
+
+    // Check that the outliers have been found
+    for (std::size_t r : vec_outliers)
+        BOOST_CHECK(!inliers[r]);
+
+    // Check that the global rotations are consistent with the inlier relative rotations
+    // (the absolute error drifts slowly along the ring)
+    double maxError = 0.0;
+    for (std::size_t r = 0; r < vec_relativeRotEstimate.size(); ++r)
+    {
+        if (!inliers[r])
+            continue;
+        const RelativeRotation& relR = vec_relativeRotEstimate[r];
+        maxError = std::max(maxError, FrobeniusDistance(relR.Rij, Mat3(vec_globalR[relR.j] * vec_globalR[relR.i].transpose())));
+    }
+    ALICEVISION_LOG_INFO("Max relative rotation error (Frobenius distance): " << maxError);
+    BOOST_CHECK_SMALL(maxError, 0.02);
+}
+
 /*
 template<typename TYPE, int N>
 inline REAL ComputePSNR(const Eigen::Matrix<REAL, N,1>& x0, const Eigen::Matrix<REAL, N,1>& x)
@@ -161,7 +161,9 @@ bool solve_translations_problem_softl1(const std::vector<relativeInfo>& vec_init
     }
     else
     {
-        options.linear_solver_type = ceres::DENSE_NORMAL_CHOLESKY;
+        // the dense solver does not scale to large view graphs: use an iterative solver instead
+        options.linear_solver_type = (nb_poses > 1000) ? ceres::CGNR : ceres::DENSE_NORMAL_CHOLESKY;
+        options.preconditioner_type = ceres::JACOBI;
     }
     options.max_num_iterations = std::max(50, (int)(nb_scales * 2));
     options.minimizer_progress_to_stdout = false;
@@ -126,7 +126,9 @@ bool solve_translations_problem_l2_chordal(const int* edges,
     }
     else
     {
-        options.linear_solver_type = ceres::DENSE_NORMAL_CHOLESKY;
+        // the dense solver does not scale to large view graphs: use an iterative solver instead
+        options.linear_solver_type = (num_nodes > 1000) ? ceres::CGNR : ceres::DENSE_NORMAL_CHOLESKY;
+        options.preconditioner_type = ceres::JACOBI;
     }
 
     Solver::Summary summary;
@@ -70,7 +70,7 @@ Vec3 Triangulation::compute(int iter) const
     // Iterative weighted linear least squares
     Mat3 AtA;
     Vec3 Atb, X;
-    std::vector<double> weights(nviews, double(1.0));
+    weights.assign(nviews, 1.0);
     for (int it = 0; it < iter; ++it)
     {
         AtA.fill(0.0);
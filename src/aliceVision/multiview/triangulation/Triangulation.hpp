@@ -11,6 +11,7 @@
 #include <aliceVision/numeric/numeric.hpp>
 #include <aliceVision/robustEstimation/ISolver.hpp>
 #include <aliceVision/numeric/algebra.hpp>
+#include <aliceVision/multiview/triangulation/triangulationDLT.hpp>
 
 #include <vector>
 #include <random>
@@ -35,7 +36,7 @@ void TriangulateNView(const Mat2X& x, const std::vector<Mat34>& Ps, Vec4& X, con
 /**
  * @brief Compute a 3D position of a point from several images of it. In particular,
  * compute the projective point X in R^4 such that x ~ PX.
- * Algorithm is the standard DLT
+ * Algorithm is the standard DLT, solved with fixed-size matrices (see NViewDLT)
  * It also allows to specify some (optional) weight for each point (solving the
  * weighted least squared problem)
  *
@@ -51,16 +52,12 @@ void TriangulateNViewAlgebraic(const ContainerT& x, const std::vector<Mat34>& Ps
     Mat2X::Index nviews = CountElements(x);
     assert(static_cast<std::size_t>(nviews) == Ps.size());
 
-    Mat design(2 * nviews, 4);
+    NViewDLT dlt;
     for (Mat2X::Index i = 0; i < nviews; ++i)
     {
-        design.block<2, 4>(2 * i, 0) = SkewMatMinimal(getElement<ContainerT>(x, i)) * Ps[i];
-        if (weights != nullptr)
-        {
-            design.block<2, 4>(2 * i, 0) *= (*weights)[i];
-        }
+        dlt.add(Ps[i], getElement<ContainerT>(x, i), (weights != nullptr) ? (*weights)[i] : 1.0);
     }
-    Nullspace(design, X);
+    dlt.compute(X);
 }
 
 /**
@@ -89,6 +86,7 @@ class Triangulation
   public:
     std::size_t size() const { return views.size(); }
 
+    // Keep the allocated memory, so that an instance can be reused for several points
     void clear() { views.clear(); }
 
     void add(const Mat34& projMatrix, const Vec2& p) { views.emplace_back(projMatrix, p); }
@@ -114,6 +112,7 @@ class Triangulation
     mutable double zmax;                        // max depth, mutable since modified in compute(...) const;
     mutable double err;                         // re-projection error, mutable since modified in compute(...) const;
     std::vector<std::pair<Mat34, Vec2>> views;  // Proj matrix and associated image point
+    mutable std::vector<double> weights;        // weight of each view, mutable since modified in compute(...) const;
 };
 
 template<class ContainerT>
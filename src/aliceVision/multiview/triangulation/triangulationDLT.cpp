@@ -60,5 +60,32 @@ void TriangulateSphericalDLT(const Mat34& P1, const Vec3& x1, const Mat34& P2, c
     homogeneousToEuclidean(X_homogeneous, X_euclidean);
 }
 
+void NViewDLT::add(const Mat34& P, const Vec2& x, double weight)
+{
+    // stack the triangular factor and the 2 new rows, then re-triangularize them:
+    // [R; A] and its QR factor R' have the same nullspace.
+    Eigen::Matrix<double, 6, 4> stacked;
+    stacked.topRows<4>() = _R;
+    stacked.row(4) = weight * (x[0] * P.row(2) - P.row(0));
+    stacked.row(5) = weight * (x[1] * P.row(2) - P.row(1));
+
+    const Eigen::HouseholderQR<Eigen::Matrix<double, 6, 4>> qr(stacked);
+    _R = qr.matrixQR().topRows<4>().triangularView<Eigen::Upper>();
+    ++_nbViews;
+}
+
+void NViewDLT::compute(Vec4& X_homogeneous) const
+{
+    assert(_nbViews >= 2);
+    Nullspace(_R, X_homogeneous);
+}
+
+void NViewDLT::compute(Vec3& X_euclidean) const
+{
+    Vec4 X_homogeneous;
+    compute(X_homogeneous);
+    homogeneousToEuclidean(X_homogeneous, X_euclidean);
+}
+
 }  // namespace multiview
 }  // namespace aliceVision
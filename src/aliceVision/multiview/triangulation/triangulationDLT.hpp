@@ -10,6 +10,8 @@
 
 #include <aliceVision/numeric/numeric.hpp>
 
+#include <cstddef>
+
 namespace aliceVision {
 namespace multiview {
 
@@ -57,5 +59,57 @@ void TriangulateSphericalDLT(const Mat34& P1, const Vec3& x1, const Mat34& P2, c
  */
 void TriangulateSphericalDLT(const Mat34& P1, const Vec3& x1, const Mat34& P2, const Vec3& x2, Vec3& X_euclidean);
 
+/**
+ * @brief Multi-view DLT triangulation with fixed-size matrices.
+ *        The two equations of each observation are folded into a 4x4 triangular factor by a QR update,
+ *        so the nullspace of the 2N x 4 design matrix is computed on the stack, whatever the number of views.
+ *        An instance can be reused for several points with reset().
+ */
+class NViewDLT
+{
+  public:
+    NViewDLT() { reset(); }
+
+    /**
+     * @brief Remove all the observations
+     */
+    void reset()
+    {
+        _R.setZero();
+        _nbViews = 0;
+    }
+
+    /**
+     * @brief Get the number of added observations
+     * @return number of observations
+     */
+    std::size_t size() const { return _nbViews; }
+
+    /**
+     * @brief Add an observation
+     * @param[in] P a projection matrix K (R | t)
+     * @param[in] x a 2d observation vector (in pixels)
+     * @param[in] weight the (optional) weight of the observation
+     */
+    void add(const Mat34& P, const Vec2& x, double weight = 1.0);
+
+    /**
+     * @brief Triangulate the point from the added observations (at least 2)
+     * @param[out] X_homogeneous a homogeneous 3d point
+     */
+    void compute(Vec4& X_homogeneous) const;
+
+    /**
+     * @brief Triangulate the point from the added observations (at least 2)
+     * @param[out] X_euclidean a 3d point
+     */
+    void compute(Vec3& X_euclidean) const;
+
+  private:
+    /// upper-triangular factor of the design matrix
+    Mat4 _R;
+    std::size_t _nbViews;
+};
+
 }  // namespace multiview
 }  // namespace aliceVision
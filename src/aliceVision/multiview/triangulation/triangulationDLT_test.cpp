@@ -32,3 +32,36 @@ BOOST_AUTO_TEST_CASE(Triangulation_TriangulateDLT)
         BOOST_CHECK_SMALL(DistanceLInfinity(X_estimated, X_gt), 1e-8);
     }
 }
+
+BOOST_AUTO_TEST_CASE(Triangulation_NViewDLT)
+{
+    const int nviews = 8;
+    const int npoints = 12;
+    const NViewDataSet d = NRealisticCamerasRing(nviews, npoints);
+
+    // the same instance is reused for all the points
+    multiview::NViewDLT dlt;
+    for (int i = 0; i < npoints; ++i)
+    {
+        dlt.reset();
+        for (int j = 0; j < nviews; ++j)
+            dlt.add(d.P(j), d._x[j].col(i));
+
+        BOOST_CHECK_EQUAL(dlt.size(), static_cast<std::size_t>(nviews));
+
+        Vec3 X_estimated;
+        dlt.compute(X_estimated);
+        const Vec3 X_gt = d._X.col(i);
+        BOOST_CHECK_SMALL(DistanceLInfinity(X_estimated, X_gt), 1e-8);
+
+        // two views give the same point as the 2-view DLT
+        dlt.reset();
+        dlt.add(d.P(0), d._x[0].col(i));
+        dlt.add(d.P(1), d._x[1].col(i));
+
+        Vec3 X_nView, X_twoViews;
+        dlt.compute(X_nView);
+        multiview::TriangulateDLT(d.P(0), d._x[0].col(i), d.P(1), d._x[1].col(i), X_twoViews);
+        BOOST_CHECK_SMALL(DistanceLInfinity(X_nView, X_twoViews), 1e-8);
+    }
+}
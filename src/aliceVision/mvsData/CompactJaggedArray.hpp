@@ -0,0 +1,286 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <aliceVision/system/Logger.hpp>
+#include <aliceVision/alicevision_omp.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdio>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace aliceVision {
+
+/**
+ * @brief Array of variable size rows stored in compressed sparse rows: one offsets array and one data array.
+ *
+ * Replaces StaticVector<StaticVector<T>> when the rows are not modified after the construction:
+ * two allocations in total instead of one per row, and the rows are contiguous in memory.
+ * Use CompactJaggedArray::Builder to construct it in two passes (count then fill), possibly in parallel.
+ */
+template<class T>
+class CompactJaggedArray
+{
+  public:
+    /// contiguous range of elements of a row
+    template<class ValueT>
+    struct RowRange
+    {
+        ValueT* first;
+        ValueT* last;
+
+        inline ValueT* begin() const { return first; }
+        inline ValueT* end() const { return last; }
+        inline int size() const { return static_cast<int>(last - first); }
+        inline bool empty() const { return first == last; }
+        inline ValueT& operator[](int i) const { return first[i]; }
+
+        /// read-only view of a writable row
+        inline operator RowRange<const ValueT>() const { return {first, last}; }
+    };
+
+    using Row = RowRange<T>;
+    using ConstRow = RowRange<const T>;
+
+    class Builder;
+
+    CompactJaggedArray()
+      : _offsets(1, 0)
+    {}
+
+    /**
+     * @param[in] offsets the offset of each row in the data, followed by the data size
+     * @param[in] data the elements of all the rows
+     */
+    CompactJaggedArray(std::vector<std::size_t> offsets, std::vector<T> data)
+      : _offsets(std::move(offsets)),
+        _data(std::move(data))
+    {
+        assert(!_offsets.empty() && _offsets.back() == _data.size());
+    }
+
+    /**
+     * @brief Copy nested containers (e.g. StaticVector<StaticVector<T>>).
+     * @param[in] rows the rows to copy
+     * @return the compact array
+     */
+    template<class Rows>
+    static CompactJaggedArray fromRows(const Rows& rows);
+
+    /// number of rows
+    inline int size() const { return static_cast<int>(_offsets.size()) - 1; }
+    inline bool empty() const { return size() == 0; }
+
+    /// number of elements of all the rows
+    inline std::size_t getNbElements() const { return _data.size(); }
+
+    inline int getRowSize(int row) const { return static_cast<int>(_offsets[row + 1] - _offsets[row]); }
+
+    inline Row operator[](int row) { return {_data.data() + _offsets[row], _data.data() + _offsets[row + 1]}; }
+    inline ConstRow operator[](int row) const { return {_data.data() + _offsets[row], _data.data() + _offsets[row + 1]}; }
+
+    /// offset of each row in the data (size() + 1 values)
+    const std::vector<std::size_t>& getOffsets() const { return _offsets; }
+    const std::vector<T>& getData() const { return _data; }
+
+    void clear()
+    {
+        _offsets.assign(1, 0);
+        _data.clear();
+    }
+
+    void swap(CompactJaggedArray& other)
+    {
+        _offsets.swap(other._offsets);
+        _data.swap(other._data);
+    }
+
+    /**
+     * @brief Sort the elements of each row in ascending order.
+     * @note Use it after a parallel fill to get a deterministic result.
+     */
+    void sortRows()
+    {
+        const int nbRows = size();
+#pragma omp parallel for schedule(dynamic, 1024)
+        for (int row = 0; row < nbRows; ++row)
+            std::sort(_data.begin() + _offsets[row], _data.begin() + _offsets[row + 1]);
+    }
+
+  private:
+    std::vector<std::size_t> _offsets;
+    std::vector<T> _data;
+};
+
+/**
+ * @brief Two-pass construction of a CompactJaggedArray.
+ *
+ * 1. count() the number of elements of each row,
+ * 2. allocate() the rows,
+ * 3. add() the elements, or write them in the row() returned after the allocation,
+ * 4. build() the array.
+ *
+ * count() and add() are thread-safe, so both passes can be parallelized over the input
+ * even if several threads write to the same row. In this case the order of the elements in a row
+ * depends on the threads scheduling (see CompactJaggedArray::sortRows).
+ */
+template<class T>
+class CompactJaggedArray<T>::Builder
+{
+  public:
+    explicit Builder(int nbRows)
+      : _counters(nbRows)
+    {
+        _array._offsets.assign(nbRows + 1, 0);
+    }
+
+    /**
+     * @brief Count elements of a row, first pass.
+     * @param[in] row the row index
+     * @param[in] n the number of elements to count
+     */
+    inline void count(int row, int n = 1) { _counters[row].fetch_add(n, std::memory_order_relaxed); }
+
+    /**
+     * @brief Allocate the rows with the counted sizes, between the two passes.
+     */
+    void allocate()
+    {
+        const int nbRows = static_cast<int>(_counters.size());
+        for (int row = 0; row < nbRows; ++row)
+        {
+            _array._offsets[row + 1] = _array._offsets[row] + _counters[row].load(std::memory_order_relaxed);
+            // reused as the fill position of the row
+            _counters[row].store(0, std::memory_order_relaxed);
+        }
+        _array._data.resize(_array._offsets.back());
+    }
+
+    /**
+     * @brief Append an element to a row, second pass.
+     * @param[in] row the row index
+     * @param[in] value the element
+     */
+    inline void add(int row, const T& value)
+    {
+        const int pos = _counters[row].fetch_add(1, std::memory_order_relaxed);
+        assert(_array._offsets[row] + pos < _array._offsets[row + 1]);
+        _array._data[_array._offsets[row] + pos] = value;
+    }
+
+    /**
+     * @brief Get a row to write it directly, after the allocation.
+     * @note Do not mix with add() on the same row.
+     */
+    inline Row row(int row) { return _array[row]; }
+
+    /**
+     * @return the array, the builder should not be used anymore
+     */
+    CompactJaggedArray<T> build() { return std::move(_array); }
+
+  private:
+    CompactJaggedArray<T> _array;
+    std::vector<std::atomic<int>> _counters;
+};
+
+template<class T>
+template<class Rows>
+CompactJaggedArray<T> CompactJaggedArray<T>::fromRows(const Rows& rows)
+{
+    const int nbRows = static_cast<int>(rows.size());
+    Builder builder(nbRows);
+    for (int row = 0; row < nbRows; ++row)
+        builder.count(row, static_cast<int>(rows[row].size()));
+    builder.allocate();
+
+#pragma omp parallel for
+    for (int row = 0; row < nbRows; ++row)
+        std::copy(rows[row].begin(), rows[row].end(), builder.row(row).begin());
+
+    return builder.build();
+}
+
+/**
+ * @brief Save in the saveArrayOfArraysToFile format.
+ */
+template<class T>
+void saveArrayOfArraysToFile(const std::string& fileName, const CompactJaggedArray<T>& aa)
+{
+    ALICEVISION_LOG_DEBUG("[IO] saveArrayOfArraysToFile: " << fileName);
+    FILE* f = fopen(fileName.c_str(), "wb");
+    if (f == nullptr)
+    {
+        ALICEVISION_THROW_ERROR("[IO] saveArrayOfArraysToFile: can't open file " << fileName);
+    }
+
+    const int n = aa.size();
+    fwrite(&n, sizeof(int), 1, f);
+    for (int i = 0; i < n; ++i)
+    {
+        const int m = aa.getRowSize(i);
+        fwrite(&m, sizeof(int), 1, f);
+        if (m > 0)
+            fwrite(aa[i].begin(), sizeof(T), m, f);
+    }
+    fclose(f);
+}
+
+/**
+ * @brief Load a file of the saveArrayOfArraysToFile format.
+ */
+template<class T>
+void loadArrayOfArraysFromFile(CompactJaggedArray<T>& out_aa, const std::string& fileName)
+{
+    ALICEVISION_LOG_DEBUG("[IO] loadArrayOfArraysFromFile: " << fileName);
+    FILE* f = fopen(fileName.c_str(), "rb");
+    if (f == nullptr)
+    {
+        ALICEVISION_THROW_ERROR("[IO] loadArrayOfArraysFromFile: can't open file " << fileName);
+    }
+
+    int n = 0;
+    if (fread(&n, sizeof(int), 1, f) != 1)
+    {
+        fclose(f);
+        ALICEVISION_THROW_ERROR("[IO] loadArrayOfArraysFromFile: can't read outer array size");
+    }
+
+    // the rows are stored with their size: read them in a single buffer
+    std::vector<std::size_t> offsets(n + 1, 0);
+    std::vector<T> data;
+    for (int i = 0; i < n; ++i)
+    {
+        int m = 0;
+        if (fread(&m, sizeof(int), 1, f) != 1)
+        {
+            fclose(f);
+            ALICEVISION_THROW_ERROR("[IO] loadArrayOfArraysFromFile: can't read inner array size");
+        }
+        offsets[i + 1] = offsets[i] + std::max(m, 0);
+        if (m > 0)
+        {
+            const std::size_t first = data.size();
+            data.resize(first + m);
+            if (fread(&data[first], sizeof(T), m, f) != static_cast<std::size_t>(m))
+            {
+                fclose(f);
+                ALICEVISION_THROW_ERROR("[IO] loadArrayOfArraysFromFile: can't read vector element");
+            }
+        }
+    }
+    fclose(f);
+
+    out_aa = CompactJaggedArray<T>(std::move(offsets), std::move(data));
+}
+
+}  // namespace aliceVision
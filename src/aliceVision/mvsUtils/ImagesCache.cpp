@@ -5,6 +5,7 @@
 // You can obtain one at https://mozilla.org/MPL/2.0/.
 
 #include "ImagesCache.hpp"
+#include <aliceVision/image/ImageCache.hpp>
 #include <aliceVision/mvsUtils/common.hpp>
 #include <aliceVision/mvsUtils/fileIO.hpp>
 
@@ -57,6 +58,11 @@ void ImagesCache<Image>::initIC(std::vector<std::string>& imagesNames)
 {
     float oneimagemb = (sizeof(Color) * _mp.getMaxImageWidth() * _mp.getMaxImageHeight()) / 1024.f / 1024.f;
     float maxmbCPU = (float)_mp.userParams.get<int>("images_cache.maxmbCPU", 5000);
+    if (_correctEV == ECorrectEV::NO_CORRECTION)
+    {
+        // the preloaded images are held by the shared image cache, stay within its budget
+        maxmbCPU = std::min(maxmbCPU, image::ImageCache::getShared().info().maxSize / 1024.f / 1024.f);
+    }
     int npreload = std::max((int)(maxmbCPU / oneimagemb), 5);  // image cache has a minimum size of 5
     npreload = std::min(_mp.ncams, npreload);
 
@@ -66,6 +72,7 @@ void ImagesCache<Image>::initIC(std::vector<std::string>& imagesNames)
     }
 
     _camIdMapId.resize(_mp.ncams, -1);
+    _prefetched.resize(_mp.ncams, 0);
     setCacheSize(npreload);
 
     {
@@ -77,6 +84,14 @@ void ImagesCache<Image>::initIC(std::vector<std::string>& imagesNames)
     }
 }
 
+template<typename Image>
+ImagesCache<Image>::~ImagesCache()
+{
+    const ImagesCacheStats stats = getStats();
+    ALICEVISION_LOG_DEBUG("Images cache: " << stats.nbHits << " hits, " << stats.nbMisses << " misses, " << stats.nbStalls << " stalls, "
+                                           << stats.nbPrefetches << " prefetches.");
+}
+
 template<typename Image>
 void ImagesCache<Image>::setCacheSize(int nbPreload)
 {
@@ -107,21 +122,60 @@ void ImagesCache<Image>::refreshData(int camId)
 
         // reload data from files
         long t1 = clock();
-        if (_imgs[mapId] == nullptr)
+        const std::string imagePath = _imagesNames.at(camId);
+
+        if (_correctEV == ECorrectEV::NO_CORRECTION)
         {
-            const int maxWidth = _mp.getMaxImageWidth();
-            const int maxHeight = _mp.getMaxImageHeight();
-            _imgs[mapId] = std::make_shared<Image>(maxWidth, maxHeight);
+            // the images are shared with the other modules through the process-wide image cache
+            image::ImageCache& sharedCache = image::ImageCache::getShared();
+            const int processScale = std::max(1, _mp.getProcessDownscale());
+
+            _imgs[mapId] = sharedCache.get<Color>(imagePath, processScale, _colorspace, true);
+            {
+                const std::lock_guard<std::mutex> lock(_statsMutex);
+                if (_imgs[mapId] != nullptr)
+                    ++_stats.nbHits;
+                else if (_prefetched[camId])
+                    ++_stats.nbStalls;
+                else
+                    ++_stats.nbMisses;
+                _prefetched[camId] = 0;
+            }
+
+            if (_imgs[mapId] == nullptr)
+                _imgs[mapId] = sharedCache.get<Color>(imagePath, processScale, _colorspace);
+
+            if ((_imgs[mapId]->Width() != _mp.getOriginalWidth(camId) / processScale) ||
+                (_imgs[mapId]->Height() != _mp.getOriginalHeight(camId) / processScale))
+            {
+                ALICEVISION_THROW_ERROR("Bad image dimension for camera " << camId << ": " << imagePath << ".");
+            }
         }
+        else
+        {
+            // exposure corrected images are private, never overwrite an image of the shared cache
+            if (_imgs[mapId] == nullptr || _imgs[mapId].use_count() > 1)
+            {
+                const int maxWidth = _mp.getMaxImageWidth();
+                const int maxHeight = _mp.getMaxImageHeight();
+                _imgs[mapId] = std::make_shared<Image>(maxWidth, maxHeight);
+            }
 
-        const std::string imagePath = _imagesNames.at(camId);
-        loadImage(imagePath, _mp, camId, *(_imgs[mapId]), _colorspace, _correctEV);
+            loadImage(imagePath, _mp, camId, *(_imgs[mapId]), _colorspace, _correctEV);
+
+            const std::lock_guard<std::mutex> lock(_statsMutex);
+            ++_stats.nbMisses;
+        }
 
         ALICEVISION_LOG_DEBUG("Add " << imagePath << " to image cache. " << formatElapsedTime(t1));
     }
     else
     {
         ALICEVISION_LOG_DEBUG("Reuse " << _imagesNames.at(camId) << " from image cache. ");
+
+        const std::lock_guard<std::mutex> lock(_statsMutex);
+        ++_stats.nbHits;
+        _prefetched[camId] = 0;
     }
 }
 
@@ -151,6 +205,54 @@ void ImagesCache<Image>::refreshImages_async(const std::vector<int>& camIds)
     _asyncObjects.emplace_back(std::async(std::launch::async, &ImagesCache<Image>::refreshImages_sync, this, camIds));
 }
 
+template<typename Image>
+void ImagesCache<Image>::prefetch(const std::vector<int>& camIds)
+{
+    if (_correctEV != ECorrectEV::NO_CORRECTION)
+        return;
+
+    image::ImageCache& sharedCache = image::ImageCache::getShared();
+    const int processScale = std::max(1, _mp.getProcessDownscale());
+
+    // keep a slot for the image in use and stay within the shared cache capacity
+    const unsigned long long int oneImageSize = sizeof(Color) * _mp.getMaxImageWidth() * _mp.getMaxImageHeight();
+    const unsigned long long int freeCapacity =
+      (sharedCache.info().capacity > sharedCache.info().contentSize) ? sharedCache.info().capacity - sharedCache.info().contentSize : 0;
+    const std::size_t maxNbPrefetches = std::min<std::size_t>(std::max(_N_PRELOADED_IMAGES - 1, 1), freeCapacity / std::max(oneImageSize, 1ull));
+
+    std::size_t nbPrefetches = 0;
+    for (int camId : camIds)
+    {
+        if (nbPrefetches >= maxNbPrefetches)
+            break;
+
+        {
+            const std::lock_guard<std::mutex> lock(_statsMutex);
+            // already in the cache slots
+            if (_camIdMapId[camId] != -1)
+                continue;
+            // already requested, still counts in the read-ahead
+            if (_prefetched[camId])
+            {
+                ++nbPrefetches;
+                continue;
+            }
+            _prefetched[camId] = 1;
+            ++_stats.nbPrefetches;
+        }
+
+        sharedCache.prefetch<Color>(_imagesNames.at(camId), processScale, _colorspace);
+        ++nbPrefetches;
+    }
+}
+
+template<typename Image>
+ImagesCacheStats ImagesCache<Image>::getStats() const
+{
+    const std::lock_guard<std::mutex> lock(_statsMutex);
+    return _stats;
+}
+
 template class ImagesCache<image::Image<image::RGBfColor>>;
 template class ImagesCache<image::Image<image::RGBAfColor>>;
 
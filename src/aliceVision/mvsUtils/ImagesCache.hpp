@@ -28,6 +28,21 @@ enum class ECorrectEV
 
 std::string ECorrectEV_enumToString(const ECorrectEV correctEV);
 
+/**
+ * @brief Usage counters of an ImagesCache, to tune the read-ahead.
+ */
+struct ImagesCacheStats
+{
+    /// images already loaded when requested
+    int nbHits = 0;
+    /// images loaded on demand
+    int nbMisses = 0;
+    /// images requested while their read-ahead was still loading
+    int nbStalls = 0;
+    /// images requested for read-ahead
+    int nbPrefetches = 0;
+};
+
 template<typename Image>
 class ImagesCache
 {
@@ -55,6 +70,11 @@ class ImagesCache
     image::EImageColorSpace _colorspace{image::EImageColorSpace::AUTO};
     ECorrectEV _correctEV{ECorrectEV::NO_CORRECTION};
 
+    /// cameras requested for read-ahead and not used since
+    std::vector<char> _prefetched;
+    ImagesCacheStats _stats;
+    mutable std::mutex _statsMutex;
+
   public:
     ImagesCache(const MultiViewParams& mp, image::EImageColorSpace colorspace, ECorrectEV correctEV = ECorrectEV::NO_CORRECTION);
 
@@ -66,7 +86,7 @@ class ImagesCache
     void initIC(std::vector<std::string>& imagesNames);
     void setCacheSize(int nbPreload);
     void setCorrectEV(const ECorrectEV correctEV) { _correctEV = correctEV; }
-    ~ImagesCache() = default;
+    ~ImagesCache();
 
     inline ImgSharedPtr getImg_sync(int camId)
     {
@@ -83,6 +103,19 @@ class ImagesCache
     void refreshImages_sync(const std::vector<int>& camIds);
 
     void refreshImages_async(const std::vector<int>& camIds);
+
+    /**
+     * @brief Load the images of the upcoming cameras in the background, in the order of the sequence.
+     *        The number of images loaded ahead is bounded by the cache size and the shared image cache budget.
+     * @note Only the images without exposure correction are loaded ahead, as they are held by the shared image cache.
+     * @param[in] camIds the upcoming cameras, from the next one to use
+     */
+    void prefetch(const std::vector<int>& camIds);
+
+    /**
+     * @return the usage counters of the cache
+     */
+    ImagesCacheStats getStats() const;
 };
 
 }  // namespace mvsUtils
@@ -26,6 +26,8 @@
 #include <boost/algorithm/string/classification.hpp>
 #include <boost/lexical_cast.hpp>
 
+#include <algorithm>
+#include <exception>
 #include <iostream>
 #include <set>
 
@@ -512,9 +514,32 @@ void MultiViewParams::decomposeProjectionMatrix(Point3d& Co,
     iPo = iRo * iKo;
 }
 
-StaticVector<int> MultiViewParams::findNearestCamsFromLandmarks(int rc, int nbNearestCams) const
+void MultiViewParams::buildCamsLandmarks() const
 {
-    StaticVector<int> out;
+    _camsLandmarks.assign(getNbCameras(), {});
+
+    for (const auto& landmarkPair : _sfmData.getLandmarks())
+    {
+        for (const auto& observationPair : landmarkPair.second.observations)
+        {
+            const auto it = _imageIdsPerViewId.find(observationPair.first);
+            if (it != _imageIdsPerViewId.end())
+                _camsLandmarks.at(it->second).push_back(&landmarkPair.second);
+        }
+    }
+}
+
+std::vector<SortedId> MultiViewParams::getCamCovisibilityScores(int rc) const
+{
+    {
+        std::lock_guard<std::mutex> lock(_camsCovisibilityScoresMutex);
+        const auto it = _camsCovisibilityScores.find(rc);
+        if (it != _camsCovisibilityScores.end())
+            return it->second;
+    }
+
+    std::call_once(_camsLandmarksOnce, [this] { buildCamsLandmarks(); });
+
     std::vector<SortedId> ids;
     ids.reserve(getNbCameras());
 
@@ -526,9 +551,10 @@ StaticVector<int> MultiViewParams::findNearestCamsFromLandmarks(int rc, int nbNe
     const geometry::Pose3 pose = _sfmData.getPose(view).getTransform();
     const camera::IntrinsicBase* intrinsicPtr = _sfmData.getIntrinsicPtr(view.getIntrinsicId());
 
-    for (const auto& landmarkPair : _sfmData.getLandmarks())
+    // only the landmarks observed by the R camera
+    for (const sfmData::Landmark* landmark : _camsLandmarks.at(rc))
     {
-        const auto& observations = landmarkPair.second.observations;
+        const auto& observations = landmark->observations;
 
         auto viewObsIt = observations.find(viewId);
         if (viewObsIt == observations.end())
@@ -558,6 +584,16 @@ StaticVector<int> MultiViewParams::findNearestCamsFromLandmarks(int rc, int nbNe
 
     qsort(&ids[0], ids.size(), sizeof(SortedId), qsortCompareSortedIdDesc);
 
+    std::lock_guard<std::mutex> lock(_camsCovisibilityScoresMutex);
+    _camsCovisibilityScores.emplace(rc, ids);
+    return ids;
+}
+
+StaticVector<int> MultiViewParams::findNearestCamsFromLandmarks(int rc, int nbNearestCams) const
+{
+    StaticVector<int> out;
+    const std::vector<SortedId> ids = getCamCovisibilityScores(rc);
+
     // ensure the ideal number of target cameras is not superior to the actual number of cameras
     const int maxTc = std::min({getNbCameras(), nbNearestCams, static_cast<int>(ids.size())});
     out.reserve(maxTc);
@@ -602,9 +638,12 @@ std::vector<int> MultiViewParams::findTileNearestCams(int rc, int nbNearestCams,
 
     const ROI fullsizeRoi = upscaleROI(roi, getProcessDownscale());  // landmark observations are in the full-size image coordinate system
 
-    for (const auto& landmarkPair : sfmData.getLandmarks())
+    std::call_once(_camsLandmarksOnce, [this] { buildCamsLandmarks(); });
+
+    // only the landmarks observed by the R camera
+    for (const sfmData::Landmark* landmark : _camsLandmarks.at(rc))
     {
-        const auto& observations = landmarkPair.second.observations;
+        const auto& observations = landmark->observations;
 
         auto viewObsIt = observations.find(viewId);
 
@@ -683,31 +722,75 @@ StaticVector<int> MultiViewParams::findCamsWhichIntersectsHexahedron(const Point
     return tcams;
 }
 
-StaticVector<int> MultiViewParams::findCamsWhichIntersectsHexahedron(const Point3d hexah[8]) const
+void MultiViewParams::buildCamsFrustums() const
 {
-    StaticVector<int> tcams;
-    tcams.reserve(getNbCameras());
+    std::vector<float> minDepths(getNbCameras(), -1.f);
+    std::vector<float> maxDepths(getNbCameras(), -1.f);
+    std::exception_ptr readError;
+
+#pragma omp parallel for
     for (int rc = 0; rc < getNbCameras(); rc++)
     {
-        const auto metadata = image::readImageMetadata(getImagePath(rc));
-
-        const float minDepth = metadata.get_float("AliceVision:minDepth", -1);
-        const float maxDepth = metadata.get_float("AliceVision:maxDepth", -1);
+        try
+        {
+            const auto metadata = image::readImageMetadata(getImagePath(rc));
+            minDepths[rc] = metadata.get_float("AliceVision:minDepth", -1);
+            maxDepths[rc] = metadata.get_float("AliceVision:maxDepth", -1);
+        }
+        catch (...)
+        {
+#pragma omp critical(MultiViewParams_buildCamsFrustums)
+            readError = std::current_exception();
+        }
+    }
+    if (readError)
+        std::rethrow_exception(readError);
 
-        if (minDepth == -1 && maxDepth == -1)
+    std::vector<geometry::AABBTree::Box> boxes;
+    for (int rc = 0; rc < getNbCameras(); rc++)
+    {
+        if (minDepths[rc] == -1 && maxDepths[rc] == -1)
         {
             ALICEVISION_LOG_WARNING("Cannot find min / max depth metadata in image: " << getImagePath(rc)
                                                                                       << ". Assumes that all images should be used.");
-            tcams.push_back(rc);
-        }
-        else
-        {
-            Point3d rchex[8];
-            getCamHexahedron(CArr.at(rc), iCamArr.at(rc), getWidth(rc), getHeight(rc), minDepth, maxDepth, rchex);
-            if (intersectsHexahedronHexahedron(rchex, hexah))
-                tcams.push_back(rc);
+            _camsWithoutFrustum.push_back(rc);
+            continue;
         }
+
+        std::array<Point3d, 8> rchex;
+        getCamHexahedron(CArr.at(rc), iCamArr.at(rc), getWidth(rc), getHeight(rc), minDepths[rc], maxDepths[rc], rchex.data());
+
+        geometry::AABBTree::Box box;
+        for (const Point3d& p : rchex)
+            box.extend(Eigen::Vector3d(p.x, p.y, p.z));
+
+        _camsFrustums.push_back(rchex);
+        _camsFrustumsCam.push_back(rc);
+        boxes.push_back(box);
     }
+    _camsFrustumsTree = geometry::AABBTree(boxes);
+}
+
+StaticVector<int> MultiViewParams::findCamsWhichIntersectsHexahedron(const Point3d hexah[8]) const
+{
+    std::call_once(_camsFrustumsOnce, [this] { buildCamsFrustums(); });
+
+    geometry::AABBTree::Box hexahBox;
+    for (int i = 0; i < 8; ++i)
+        hexahBox.extend(Eigen::Vector3d(hexah[i].x, hexah[i].y, hexah[i].z));
+
+    // the camera frustums can only intersect the hexahedron if their bounding boxes do
+    std::vector<int> cams = _camsWithoutFrustum;
+    _camsFrustumsTree.forEachIntersecting(hexahBox, [&](int i) {
+        if (intersectsHexahedronHexahedron(_camsFrustums[i].data(), hexah))
+            cams.push_back(_camsFrustumsCam[i]);
+    });
+    std::sort(cams.begin(), cams.end());
+
+    StaticVector<int> tcams;
+    tcams.reserve(cams.size());
+    for (int rc : cams)
+        tcams.push_back(rc);
     return tcams;
 }
 
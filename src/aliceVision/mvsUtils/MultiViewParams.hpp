@@ -13,12 +13,15 @@
 #include <aliceVision/mvsData/ROI.hpp>
 #include <aliceVision/mvsData/StaticVector.hpp>
 #include <aliceVision/mvsData/structures.hpp>
+#include <aliceVision/geometry/AABBTree.hpp>
 
 #include <boost/property_tree/ptree.hpp>
 
+#include <array>
 #include <string>
 #include <vector>
 #include <map>
+#include <mutex>
 
 namespace aliceVision {
 
@@ -26,6 +29,7 @@ namespace bpt = boost::property_tree;
 
 namespace sfmData {
 class SfMData;
+struct Landmark;
 }  // namespace sfmData
 
 namespace mvsUtils {
@@ -220,6 +224,7 @@ class MultiViewParams
 
     /**
      * @brief findCamsWhichIntersectsHexahedron
+     * @note The camera frustums are read from the images min/max depth metadata and indexed on the first call.
      * @param hexah 0-3 frontal face, 4-7 back face
      * @return
      */
@@ -227,6 +232,7 @@ class MultiViewParams
 
     /**
      * @brief findNearestCamsFromLandmarks
+     * @note The co-visibility scores of a camera are computed on its first call and kept for the next ones.
      * @param rc
      * @param nbNearestCams
      * @return
@@ -243,9 +249,17 @@ class MultiViewParams
      */
     std::vector<int> findTileNearestCams(int rc, int nbNearestCams, const std::vector<int>& tCams, const ROI& roi) const;
 
-    inline void setMinViewAngle(float minViewAngle) { _minViewAngle = minViewAngle; }
+    inline void setMinViewAngle(float minViewAngle)
+    {
+        _minViewAngle = minViewAngle;
+        _camsCovisibilityScores.clear();
+    }
 
-    inline void setMaxViewAngle(float maxViewAngle) { _maxViewAngle = maxViewAngle; }
+    inline void setMaxViewAngle(float maxViewAngle)
+    {
+        _maxViewAngle = maxViewAngle;
+        _camsCovisibilityScores.clear();
+    }
 
   private:
     /// image params list (width, height, size)
@@ -273,6 +287,31 @@ class MultiViewParams
     /// input sfmData
     const sfmData::SfMData& _sfmData;
 
+    /// landmarks observed by each camera, in the landmarks order
+    mutable std::vector<std::vector<const sfmData::Landmark*>> _camsLandmarks;
+    mutable std::once_flag _camsLandmarksOnce;
+    /// co-visibility scores of the cameras already searched, sorted by decreasing score
+    mutable std::map<int, std::vector<SortedId>> _camsCovisibilityScores;
+    mutable std::mutex _camsCovisibilityScoresMutex;
+    /// frustums (between min/max depths) of the cameras with depths metadata
+    mutable std::vector<std::array<Point3d, 8>> _camsFrustums;
+    /// camera index of each box of the frustums tree
+    mutable std::vector<int> _camsFrustumsCam;
+    /// bounding boxes tree of the camera frustums
+    mutable geometry::AABBTree _camsFrustumsTree;
+    /// cameras without depths metadata, they intersect all the hexahedrons
+    mutable std::vector<int> _camsWithoutFrustum;
+    mutable std::once_flag _camsFrustumsOnce;
+
+    /**
+     * @brief Get the co-visibility scores of a camera: number of landmarks seen with each other camera
+     *        with a view angle in [minViewAngle, maxViewAngle], sorted by decreasing score
+     */
+    std::vector<SortedId> getCamCovisibilityScores(int rc) const;
+
+    void buildCamsLandmarks() const;
+    void buildCamsFrustums() const;
+
     void loadMatricesFromTxtFile(int index, const std::string& fileNameP, const std::string& fileNameD);
     void loadMatricesFromRawProjectionMatrix(int index, const double* rawProjMatix);
     void loadMatricesFromSfM(int index);
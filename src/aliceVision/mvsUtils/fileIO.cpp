@@ -384,14 +384,20 @@ Matrix3x4 load3x4MatrixFromFile(std::istream& in)
 template<class Image>
 void loadImage(const std::string& path, const MultiViewParams& mp, int camId, Image& img, image::EImageColorSpace colorspace, ECorrectEV correctEV)
 {
+    // scale choosed by the user and apply during the process
+    const int processScale = mp.getProcessDownscale();
+
     // check image size
-    auto checkImageSize = [&path, &mp, camId, &img]() {
-        if ((mp.getOriginalWidth(camId) != img.Width()) || (mp.getOriginalHeight(camId) != img.Height()))
+    auto checkImageSize = [&path, &mp, camId, &img](int downscale) {
+        const int expectedWidth = mp.getOriginalWidth(camId) / downscale;
+        const int expectedHeight = mp.getOriginalHeight(camId) / downscale;
+
+        if ((expectedWidth != img.Width()) || (expectedHeight != img.Height()))
         {
             std::stringstream s;
             s << "Bad image dimension for camera : " << camId << "\n";
             s << "\t- image path : " << path << "\n";
-            s << "\t- expected dimension : " << mp.getOriginalWidth(camId) << "x" << mp.getOriginalHeight(camId) << "\n";
+            s << "\t- expected dimension : " << expectedWidth << "x" << expectedHeight << "\n";
             s << "\t- real dimension : " << img.Width() << "x" << img.Height() << "\n";
             throw std::runtime_error(s.str());
         }
@@ -399,14 +405,18 @@ void loadImage(const std::string& path, const MultiViewParams& mp, int camId, Im
 
     if (correctEV == ECorrectEV::NO_CORRECTION)
     {
-        image::readImage(path, img, colorspace);
-        checkImageSize();
+        // decode directly at the process scale
+        image::ImageReadOptions readOptions(colorspace);
+        readOptions.downscale = std::max(1, processScale);
+
+        image::readImage(path, img, readOptions);
+        checkImageSize(readOptions.downscale);
     }
     // if exposure correction, apply it in linear colorspace and then convert colorspace
     else
     {
         image::readImage(path, img, image::EImageColorSpace::LINEAR);
-        checkImageSize();
+        checkImageSize(1);
 
         const auto metadata = image::readImageMetadata(path);
 
@@ -430,17 +440,14 @@ void loadImage(const std::string& path, const MultiViewParams& mp, int camId, Im
 
             imageAlgo::colorconvert(img, image::EImageColorSpace::LINEAR, colorspace);
         }
-    }
 
-    // scale choosed by the user and apply during the process
-    const int processScale = mp.getProcessDownscale();
-
-    if (processScale > 1)
-    {
-        ALICEVISION_LOG_DEBUG("Downscale (x" << processScale << ") image: " << mp.getViewId(camId) << ".");
-        Image bmpr;
-        imageAlgo::resizeImage(processScale, img, bmpr);
-        img.swap(bmpr);
+        if (processScale > 1)
+        {
+            ALICEVISION_LOG_DEBUG("Downscale (x" << processScale << ") image: " << mp.getViewId(camId) << ".");
+            Image bmpr;
+            imageAlgo::resizeImage(processScale, img, bmpr);
+            img.swap(bmpr);
+        }
     }
 }
 
@@ -14,6 +14,10 @@
 #include <boost/filesystem.hpp>
 #include <boost/regex.hpp>
 
+#include <map>
+#include <mutex>
+#include <set>
+
 namespace fs = boost::filesystem;
 
 namespace aliceVision {
@@ -308,6 +312,84 @@ void addSingleTileMapWeighted(int rc,
     }
 }
 
+namespace {
+
+/**
+ * @brief Fullsize map merged in memory from its tiles
+ */
+template<typename T>
+struct MergedTilesMap
+{
+    EFileType fileType;
+    TileParams tileParams;
+    int scale = 1;
+    int step = 1;
+    std::string customSuffix;
+    image::Image<T> map;
+};
+
+/**
+ * @brief Fullsize maps merged in memory from their tiles, per R camera and per map path
+ */
+template<typename T>
+using MergedTilesMapsPerCamera = std::map<int, std::map<std::string, MergedTilesMap<T>>>;
+
+std::mutex mergedTilesMapsMutex;  //< protects the R cameras set and the maps containers
+std::set<int> mergedTilesMapsCams;  //< R cameras with tiles merged in memory
+
+template<typename T>
+MergedTilesMapsPerCamera<T>& getMergedTilesMaps()
+{
+    static MergedTilesMapsPerCamera<T> mergedTilesMaps;
+    return mergedTilesMaps;
+}
+
+}  // namespace
+
+/**
+ * @brief Add a tile map to the corresponding fullsize map merged in memory.
+ * @note The fullsize map of a R camera is only updated by the thread computing this camera.
+ * @return false if the tiles of the given R camera are not merged in memory
+ */
+template<typename T>
+bool addTileToMergedMap(int rc,
+                        const MultiViewParams& mp,
+                        const EFileType fileType,
+                        const TileParams& tileParams,
+                        const ROI& roi,
+                        const image::Image<T>& in_tileMap,
+                        int scale,
+                        int step,
+                        const std::string& customSuffix)
+{
+    MergedTilesMap<T>* mergedMap = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(mergedTilesMapsMutex);
+
+        if (mergedTilesMapsCams.count(rc) == 0)
+            return false;
+
+        mergedMap = &(getMergedTilesMaps<T>()[rc][getFileNameFromIndex(mp, rc, fileType, customSuffix)]);
+    }
+
+    const int scaleStep = scale * step;
+
+    if (mergedMap->map.size() == 0)
+    {
+        mergedMap->fileType = fileType;
+        mergedMap->tileParams = tileParams;
+        mergedMap->scale = scale;
+        mergedMap->step = step;
+        mergedMap->customSuffix = customSuffix;
+        mergedMap->map.resize(divideRoundUp(mp.getWidth(rc), scaleStep), divideRoundUp(mp.getHeight(rc), scaleStep), true, T(0.f));  // additive process
+    }
+
+    // tile weighting is done in place
+    image::Image<T> tileMap = in_tileMap;
+    addSingleTileMapWeighted(rc, mp, tileParams, roi, scaleStep, tileMap, mergedMap->map);
+    return true;
+}
+
 template<typename T>
 void readMapFromFileOrTiles(int rc,
                             const MultiViewParams& mp,
@@ -437,6 +519,11 @@ void writeMapToFileOrTile(int rc,
 
     if (downscaledROI.width() != imageWidth || downscaledROI.height() != imageHeight)  // is a tile
     {
+        // merge the tile in memory if enabled for this R camera, the fullsize map is written at the end
+        if (addTileToMergedMap(rc, mp, fileType, tileParams, roi, in_map, scale, step, customSuffix))
+            return;
+
+
         // tiled map
         mapPath = getFileNameFromIndex(mp, rc, fileType, customSuffix, roi.x.begin, roi.y.begin);
     }
@@ -658,6 +745,59 @@ unsigned long getNbDepthValuesFromDepthMap(int rc, const MultiViewParams& mp, in
     return nbDepthValues;
 }
 
+/**
+ * @brief Write the fullsize maps merged in memory of the given R camera.
+ * @param[in] rc the related R camera index
+ * @param[in] mp the multi-view parameters
+ * @param[in] mergedMaps the fullsize maps merged in memory
+ */
+template<typename T>
+void writeMergedTilesMaps(int rc, const MultiViewParams& mp, const std::map<std::string, MergedTilesMap<T>>& mergedMaps)
+{
+    const ROI roi = ROI(0, mp.getWidth(rc), 0, mp.getHeight(rc));  // fullsize roi
+
+    for (const auto& mergedMapPair : mergedMaps)
+    {
+        const MergedTilesMap<T>& mergedMap = mergedMapPair.second;
+        writeMapToFileOrTile(rc, mp, mergedMap.fileType, mergedMap.tileParams, roi, mergedMap.map, mergedMap.scale, mergedMap.step, mergedMap.customSuffix);
+    }
+}
+
+void beginMapTilesMerging(int rc)
+{
+    std::lock_guard<std::mutex> lock(mergedTilesMapsMutex);
+    mergedTilesMapsCams.insert(rc);
+}
+
+void endMapTilesMerging(int rc, const MultiViewParams& mp)
+{
+    std::map<std::string, MergedTilesMap<float>> floatMaps;
+    std::map<std::string, MergedTilesMap<image::RGBfColor>> colorMaps;
+
+    {
+        std::lock_guard<std::mutex> lock(mergedTilesMapsMutex);
+
+        mergedTilesMapsCams.erase(rc);
+
+        auto floatMapsIt = getMergedTilesMaps<float>().find(rc);
+        if (floatMapsIt != getMergedTilesMaps<float>().end())
+        {
+            floatMaps.swap(floatMapsIt->second);
+            getMergedTilesMaps<float>().erase(floatMapsIt);
+        }
+
+        auto colorMapsIt = getMergedTilesMaps<image::RGBfColor>().find(rc);
+        if (colorMapsIt != getMergedTilesMaps<image::RGBfColor>().end())
+        {
+            colorMaps.swap(colorMapsIt->second);
+            getMergedTilesMaps<image::RGBfColor>().erase(colorMapsIt);
+        }
+    }
+
+    writeMergedTilesMaps(rc, mp, floatMaps);
+    writeMergedTilesMaps(rc, mp, colorMaps);
+}
+
 void deleteMapTiles(int rc, const MultiViewParams& mp, const EFileType fileType, const std::string& customSuffix)
 {
     std::vector<std::string> mapTilePathList;
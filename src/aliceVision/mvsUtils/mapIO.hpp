@@ -137,6 +137,21 @@ inline void writeMap(int rc,
  */
 unsigned long getNbDepthValuesFromDepthMap(int rc, const MultiViewParams& mp, int scale = 1, int step = 1, const std::string& customSuffix = "");
 
+/**
+ * @brief Merge in memory the tile maps of the given R camera written with writeMap,
+ *        instead of writing a file per tile. Each map is written in a single file by endMapTilesMerging.
+ * @param[in] rc the related R camera index
+ */
+void beginMapTilesMerging(int rc);
+
+/**
+ * @brief Write the fullsize maps merged in memory from the tiles of the given R camera
+ *        and stop merging its tiles in memory.
+ * @param[in] rc the related R camera index
+ * @param[in] mp the multi-view parameters
+ */
+void endMapTilesMerging(int rc, const MultiViewParams& mp);
+
 /**
  * @brief Delete map tiles files.
  * @param[in] rc the related R camera index
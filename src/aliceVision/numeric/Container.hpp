@@ -135,4 +135,25 @@ TMat buildSubsetMatrix(const TMat& A, const TCols& columns)
     return compressed;
 }
 
+/**
+ * @brief It extracts the columns of given indices from the given matrix into an existing matrix
+ * @note The memory of the output matrix is reused if it already has the right size,
+ *       so the extraction does not allocate when it is repeated with the same number of columns.
+ *
+ * @param[in] A The NxM input matrix
+ * @param[in] columns The list of K indices to extract
+ * @param[out] compressed The NxK output matrix
+ */
+template<typename TMat, typename TCols>
+void buildSubsetMatrix(const TMat& A, const TCols& columns, TMat& compressed)
+{
+    compressed.resize(A.rows(), columns.size());
+    for (std::size_t i = 0; i < static_cast<std::size_t>(columns.size()); ++i)
+    {
+        // check for indices out of range
+        assert(columns[i] < A.cols());
+        compressed.col(i) = A.col(columns[i]);
+    }
+}
+
 }  // namespace aliceVision
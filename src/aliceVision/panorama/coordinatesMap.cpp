@@ -8,6 +8,8 @@
 
 #include "sphericalMapping.hpp"
 
+#include <aliceVision/camera/DistortionGrid.hpp>
+
 namespace aliceVision {
 
 bool CoordinatesMap::build(const std::pair<int, int>& panoramaSize,
@@ -24,6 +26,22 @@ bool CoordinatesMap::build(const std::pair<int, int>& panoramaSize,
     int min_x = std::numeric_limits<int>::max();
     int min_y = std::numeric_limits<int>::max();
 
+    /**
+     * Lookup grid of the projection over the bounding box,
+     * undefined where the rays are not visible
+     */
+    const camera::DistortionGrid projectionGrid(
+      [&](const Vec2& coords) {
+          const Vec3 ray = SphericalMapping::fromEquirectangular(coords, panoramaSize.first, panoramaSize.second);
+          if (!intrinsics.isVisibleRay(pose(ray)))
+          {
+              return Vec2(Vec2::Constant(std::numeric_limits<double>::quiet_NaN()));
+          }
+          return intrinsics.project(pose, ray.homogeneous(), true);
+      },
+      Vec2(coarseBbox.left, coarseBbox.top),
+      Vec2(coarseBbox.left + coarseBbox.width - 1, coarseBbox.top + coarseBbox.height - 1));
+
     for (int y = 0; y < coarseBbox.height; y++)
     {
         int cy = y + coarseBbox.top;
@@ -51,7 +69,7 @@ bool CoordinatesMap::build(const std::pair<int, int>& panoramaSize,
             /**
              * Project this ray to camera pixel coordinates
              */
-            const Vec2 pix_disto_d = intrinsics.project(pose, ray.homogeneous(), true);
+            const Vec2 pix_disto_d = projectionGrid(Vec2(cx, cy));
             const Vec2f pix_disto = pix_disto_d.cast<float>();
 
             /**
@@ -121,4 +139,89 @@ bool CoordinatesMap::computeScale(double& result, float ratioUpscale)
     return true;
 }
 
+void CoordinatesMap::compress(Compressed& compressed) const
+{
+    const float precision = 64.0f;
+
+    compressed.offsetX = _offset_x;
+    compressed.offsetY = _offset_y;
+    compressed.boundingBox = _boundingBox;
+    compressed.mask = _mask;
+    compressed.offsets = aliceVision::image::Image<Eigen::Matrix<int16_t, 2, 1>>();
+    compressed.coordinates = aliceVision::image::Image<Eigen::Vector2f>();
+
+    Eigen::Vector2f minCoordinates = Eigen::Vector2f::Constant(std::numeric_limits<float>::max());
+    Eigen::Vector2f maxCoordinates = Eigen::Vector2f::Constant(std::numeric_limits<float>::lowest());
+    for (int i = 0; i < _coordinates.Height(); i++)
+    {
+        for (int j = 0; j < _coordinates.Width(); j++)
+        {
+            if (!_mask(i, j))
+            {
+                continue;
+            }
+
+            minCoordinates = minCoordinates.cwiseMin(_coordinates(i, j));
+            maxCoordinates = maxCoordinates.cwiseMax(_coordinates(i, j));
+        }
+    }
+
+    compressed.reference = (minCoordinates + maxCoordinates) * 0.5f;
+
+    // The offsets must fit in a signed 16 bits integer
+    const float maxOffset = float(std::numeric_limits<int16_t>::max() - 1) / precision;
+    const bool fits = ((maxCoordinates - minCoordinates).maxCoeff() * 0.5f < maxOffset);
+    if (!fits)
+    {
+        compressed.coordinates = _coordinates;
+        return;
+    }
+
+    compressed.offsets = aliceVision::image::Image<Eigen::Matrix<int16_t, 2, 1>>(
+      _coordinates.Width(), _coordinates.Height(), true, Eigen::Matrix<int16_t, 2, 1>::Zero());
+    for (int i = 0; i < _coordinates.Height(); i++)
+    {
+        for (int j = 0; j < _coordinates.Width(); j++)
+        {
+            if (!_mask(i, j))
+            {
+                continue;
+            }
+
+            const Eigen::Vector2f offset = (_coordinates(i, j) - compressed.reference) * precision;
+            compressed.offsets(i, j) = Eigen::Matrix<int16_t, 2, 1>(int16_t(std::round(offset.x())), int16_t(std::round(offset.y())));
+        }
+    }
+}
+
+void CoordinatesMap::uncompress(const Compressed& compressed)
+{
+    const float precision = 64.0f;
+
+    _offset_x = compressed.offsetX;
+    _offset_y = compressed.offsetY;
+    _boundingBox = compressed.boundingBox;
+    _mask = compressed.mask;
+
+    if (compressed.offsets.size() == 0)
+    {
+        _coordinates = compressed.coordinates;
+        return;
+    }
+
+    _coordinates = aliceVision::image::Image<Eigen::Vector2f>(_mask.Width(), _mask.Height(), true, Eigen::Vector2f::Zero());
+    for (int i = 0; i < _coordinates.Height(); i++)
+    {
+        for (int j = 0; j < _coordinates.Width(); j++)
+        {
+            if (!_mask(i, j))
+            {
+                continue;
+            }
+
+            _coordinates(i, j) = compressed.reference + compressed.offsets(i, j).cast<float>() / precision;
+        }
+    }
+}
+
 }  // namespace aliceVision
@@ -16,6 +16,21 @@ namespace aliceVision {
 class CoordinatesMap
 {
   public:
+    /**
+     * @brief Compact copy of a map: the coordinates are stored as fixed point offsets (1/64 pixel) from a reference position.
+     *        The coordinates are kept as is when they span more than the offsets range.
+     */
+    struct Compressed
+    {
+        size_t offsetX = 0;
+        size_t offsetY = 0;
+        BoundingBox boundingBox;
+        Eigen::Vector2f reference;
+        aliceVision::image::Image<Eigen::Matrix<int16_t, 2, 1>> offsets;
+        aliceVision::image::Image<Eigen::Vector2f> coordinates;
+        aliceVision::image::Image<unsigned char> mask;
+    };
+
     /**
      * Build coordinates map given camera properties
      * @param panoramaSize desired output panoramaSize
@@ -29,6 +44,10 @@ class CoordinatesMap
 
     bool computeScale(double& result, float ratioUpscale);
 
+    void compress(Compressed& compressed) const;
+
+    void uncompress(const Compressed& compressed);
+
     size_t getOffsetX() const { return _offset_x; }
 
     size_t getOffsetY() const { return _offset_y; }
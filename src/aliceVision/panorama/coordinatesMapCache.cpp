@@ -0,0 +1,95 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "coordinatesMapCache.hpp"
+
+#include "remapBbox.hpp"
+
+namespace aliceVision {
+
+void CoordinatesMapCache::selectCamera(IndexT intrinsicId, IndexT poseId, bool store)
+{
+    if (_store && store && intrinsicId == _intrinsicId && poseId == _poseId)
+    {
+        return;
+    }
+
+    _intrinsicId = intrinsicId;
+    _poseId = poseId;
+    _store = store;
+
+    _hasBoxes = false;
+    _validBoxes = false;
+    _boxes.clear();
+    _maps.clear();
+}
+
+bool CoordinatesMapCache::getWarpedBoundingBoxes(std::vector<BoundingBox>& boxes,
+                                                 const geometry::Pose3& pose,
+                                                 const camera::IntrinsicBase& intrinsics)
+{
+    if (!_store)
+    {
+        return computeWarpedBoundingBoxes(boxes, _panoramaSize, pose, intrinsics, _tileSize);
+    }
+
+    if (!_hasBoxes)
+    {
+        _validBoxes = computeWarpedBoundingBoxes(_boxes, _panoramaSize, pose, intrinsics, _tileSize);
+        _hasBoxes = true;
+    }
+
+    boxes = _boxes;
+
+    return _validBoxes;
+}
+
+bool CoordinatesMapCache::getMap(CoordinatesMap& map, const geometry::Pose3& pose, const camera::IntrinsicBase& intrinsics, const BoundingBox& bbox)
+{
+    if (!_store)
+    {
+        return map.build(_panoramaSize, pose, intrinsics, bbox);
+    }
+
+    const std::tuple<int, int, int, int> key(bbox.left, bbox.top, bbox.width, bbox.height);
+
+    bool found = false;
+#pragma omp critical(coordinatesMapCache)
+    {
+        const auto it = _maps.find(key);
+        if (it != _maps.end())
+        {
+            map.uncompress(it->second);
+            found = true;
+        }
+    }
+
+    if (found)
+    {
+        return true;
+    }
+
+    // Built outside of the lock, the tiles are distinct in a view
+    if (!map.build(_panoramaSize, pose, intrinsics, bbox))
+    {
+        return false;
+    }
+
+    CoordinatesMap::Compressed compressed;
+    map.compress(compressed);
+
+    // All the views of the camera use the same (uncompressed) map
+    map.uncompress(compressed);
+
+#pragma omp critical(coordinatesMapCache)
+    {
+        _maps[key] = std::move(compressed);
+    }
+
+    return true;
+}
+
+}  // namespace aliceVision
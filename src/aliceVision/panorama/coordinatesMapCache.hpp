@@ -0,0 +1,70 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <aliceVision/types.hpp>
+#include <aliceVision/geometry/Pose3.hpp>
+#include <aliceVision/camera/camera.hpp>
+
+#include "boundingBox.hpp"
+#include "coordinatesMap.hpp"
+
+#include <map>
+#include <tuple>
+#include <vector>
+
+namespace aliceVision {
+
+/**
+ * @brief Warped bounding boxes and coordinates maps of one camera, reused by the next views of the same camera.
+ *        The views sharing an intrinsic and a pose (brackets, rig) have the same warped geometry.
+ *        Only the selected camera is kept in memory, its maps are stored compressed.
+ */
+class CoordinatesMapCache
+{
+  public:
+    CoordinatesMapCache(const std::pair<int, int>& panoramaSize, int tileSize)
+      : _panoramaSize(panoramaSize),
+        _tileSize(tileSize)
+    {}
+
+    /**
+     * @brief Select the camera of the next requests, the data of the previous camera is released if it is another one
+     * @param[in] intrinsicId the intrinsic of the camera
+     * @param[in] poseId the pose of the camera
+     * @param[in] store keep the results for the next views of this camera
+     */
+    void selectCamera(IndexT intrinsicId, IndexT poseId, bool store);
+
+    /**
+     * @brief Same as computeWarpedBoundingBoxes, computed once for the selected camera
+     */
+    bool getWarpedBoundingBoxes(std::vector<BoundingBox>& boxes, const geometry::Pose3& pose, const camera::IntrinsicBase& intrinsics);
+
+    /**
+     * @brief Same as CoordinatesMap::build, computed once per tile for the selected camera.
+     *        Can be called concurrently for different tiles.
+     */
+    bool getMap(CoordinatesMap& map, const geometry::Pose3& pose, const camera::IntrinsicBase& intrinsics, const BoundingBox& bbox);
+
+  private:
+    const std::pair<int, int> _panoramaSize;
+    const int _tileSize;
+
+    IndexT _intrinsicId = UndefinedIndexT;
+    IndexT _poseId = UndefinedIndexT;
+    bool _store = false;
+
+    bool _hasBoxes = false;
+    bool _validBoxes = false;
+    std::vector<BoundingBox> _boxes;
+
+    /// compressed maps indexed by their bounding box (left, top, width, height)
+    std::map<std::tuple<int, int, int, int>, CoordinatesMap::Compressed> _maps;
+};
+
+}  // namespace aliceVision
@@ -0,0 +1,34 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "DeviceGaussianPyramid.hpp"
+
+#include <aliceVision/half.hpp>
+
+#include <limits>
+
+namespace aliceVision {
+
+DeviceGaussianPyramid::DeviceGaussianPyramid(const image::Image<image::RGBfColor>& source, std::size_t scalesCount)
+{
+    cuda_createGaussianPyramid(_levels, source.data()->data(), source.Width(), source.Height(), scalesCount);
+}
+
+DeviceGaussianPyramid::~DeviceGaussianPyramid() { cuda_destroyGaussianPyramid(_levels); }
+
+void DeviceGaussianPyramid::warp(image::Image<image::RGBfColor>& output,
+                                 const image::Image<Eigen::Vector2f>& coordinates,
+                                 const image::Image<unsigned char>& mask,
+                                 bool clamp) const
+{
+    output.resize(coordinates.Width(), coordinates.Height(), false);
+
+    const float maxValue = clamp ? float(HALF_MAX) : std::numeric_limits<float>::infinity();
+
+    cuda_gaussianWarp(output.data()->data(), coordinates.data()->data(), mask.data(), coordinates.Width(), coordinates.Height(), _levels, maxValue);
+}
+
+}  // namespace aliceVision
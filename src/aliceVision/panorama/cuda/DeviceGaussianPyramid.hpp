@@ -0,0 +1,54 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <aliceVision/image/all.hpp>
+#include <aliceVision/panorama/cuda/deviceWarping.hpp>
+
+#include <vector>
+
+namespace aliceVision {
+
+/**
+ * @brief Gaussian pyramid of a source image stored in device memory, same levels as GaussianPyramidNoMask.
+ *        It is built once per source image, then all the tiles of the panorama are warped from it on the GPU.
+ */
+class DeviceGaussianPyramid
+{
+  public:
+    /**
+     * @brief Upload the source image and build the pyramid levels on the GPU
+     * @param[in] source the source image
+     * @param[in] scalesCount the number of levels (see GaussianPyramidNoMask::computeScalesCount)
+     */
+    DeviceGaussianPyramid(const image::Image<image::RGBfColor>& source, std::size_t scalesCount);
+
+    ~DeviceGaussianPyramid();
+
+    DeviceGaussianPyramid(const DeviceGaussianPyramid&) = delete;
+    DeviceGaussianPyramid& operator=(const DeviceGaussianPyramid&) = delete;
+
+    std::size_t getScalesCount() const { return _levels.size(); }
+
+    /**
+     * @brief Warp one tile of the panorama, same result as GaussianWarper::warp with a GaussianPyramidNoMask.
+     *        Can be called concurrently from several threads.
+     * @param[out] output the warped tile (pixels outside of the mask are set to red, as on the CPU)
+     * @param[in] coordinates the source image coordinates of each pixel of the tile
+     * @param[in] mask the valid pixels of the tile
+     * @param[in] clamp clamp the colors to the half float range
+     */
+    void warp(image::Image<image::RGBfColor>& output,
+              const image::Image<Eigen::Vector2f>& coordinates,
+              const image::Image<unsigned char>& mask,
+              bool clamp) const;
+
+  private:
+    std::vector<DevicePyramidLevel> _levels;
+};
+
+}  // namespace aliceVision
@@ -0,0 +1,221 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <cuda_runtime.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <sstream>
+#include <stdexcept>
+
+namespace aliceVision {
+
+/**
+ * @brief Throw if a CUDA call failed
+ */
+inline void checkCudaError(cudaError_t err, const char* message)
+{
+    if (err != cudaSuccess)
+    {
+        std::stringstream s;
+        s << message << ": " << cudaGetErrorString(err);
+        throw std::runtime_error(s.str());
+    }
+}
+
+inline unsigned int divUp(unsigned int a, unsigned int b) { return (a + b - 1) / b; }
+
+/// kernel launch block of the image kernels
+inline dim3 imageBlock() { return dim3(32, 8, 1); }
+
+inline dim3 imageGrid(int width, int height) { return dim3(divUp(width, imageBlock().x), divUp(height, imageBlock().y), 1); }
+
+/**
+ * @brief Pitched float image with C interleaved channels in device memory
+ */
+template<int C>
+class DeviceImage
+{
+  public:
+    DeviceImage() = default;
+
+    DeviceImage(int width, int height) { allocate(width, height); }
+
+    ~DeviceImage() { cudaFree(_buffer); }
+
+    DeviceImage(const DeviceImage&) = delete;
+    DeviceImage& operator=(const DeviceImage&) = delete;
+
+    void allocate(int width, int height)
+    {
+        if (_buffer != nullptr && width == _width && height == _height)
+        {
+            return;
+        }
+
+        cudaFree(_buffer);
+        _buffer = nullptr;
+        _width = width;
+        _height = height;
+        checkCudaError(cudaMallocPitch(reinterpret_cast<void**>(&_buffer), &_pitch, std::max(1, width) * C * sizeof(float), std::max(1, height)),
+                       "Cannot allocate panorama image in device memory");
+    }
+
+    void swap(DeviceImage& other)
+    {
+        std::swap(_buffer, other._buffer);
+        std::swap(_pitch, other._pitch);
+        std::swap(_width, other._width);
+        std::swap(_height, other._height);
+    }
+
+    /**
+     * @brief Upload a contiguous host image (width * C floats per row)
+     */
+    void upload(const float* host, int width, int height, cudaStream_t stream)
+    {
+        allocate(width, height);
+        checkCudaError(cudaMemcpy2DAsync(_buffer, _pitch, host, width * C * sizeof(float), width * C * sizeof(float), height, cudaMemcpyHostToDevice, stream),
+                       "Cannot upload panorama image");
+    }
+
+    /**
+     * @brief Download into a contiguous host image of the same size
+     */
+    void download(float* host, cudaStream_t stream) const
+    {
+        checkCudaError(
+          cudaMemcpy2DAsync(host, _width * C * sizeof(float), _buffer, _pitch, _width * C * sizeof(float), _height, cudaMemcpyDeviceToHost, stream),
+          "Cannot download panorama image");
+    }
+
+    float* getBuffer() const { return _buffer; }
+    std::size_t getPitch() const { return _pitch; }
+    int getWidth() const { return _width; }
+    int getHeight() const { return _height; }
+
+  private:
+    float* _buffer = nullptr;
+    std::size_t _pitch = 0;
+    int _width = 0;
+    int _height = 0;
+};
+
+/**
+ * @brief Address of the first channel of pixel (x, y) of a pitched buffer
+ */
+template<int C>
+__device__ inline float* pixelAt(float* buffer, std::size_t pitch, int x, int y)
+{
+    return reinterpret_cast<float*>(reinterpret_cast<char*>(buffer) + y * pitch) + x * C;
+}
+
+template<int C>
+__device__ inline const float* pixelAt(const float* buffer, std::size_t pitch, int x, int y)
+{
+    return reinterpret_cast<const float*>(reinterpret_cast<const char*>(buffer) + y * pitch) + x * C;
+}
+
+/**
+ * @brief Mirror border, same as convolveRow: 5432 | 123456 | 5432
+ */
+__device__ inline int mirrorIndex(int x, int size) { return (x < 0) ? -x : ((x >= size) ? size - 1 - (x + 1 - size) : x); }
+
+/**
+ * @brief Horizontal pass of the 5x5 Gaussian filter, evaluated on one column every step columns
+ */
+template<int C>
+__global__ void gaussian5Horizontal_kernel(float* out, std::size_t outPitch, const float* in, std::size_t inPitch, int inWidth, int outWidth, int height, int step)
+{
+    const int x = blockIdx.x * blockDim.x + threadIdx.x;
+    const int y = blockIdx.y * blockDim.y + threadIdx.y;
+
+    if (x >= outWidth || y >= height)
+        return;
+
+    // normalized binomial kernel of convolveGaussian5x5
+    const float gaussian5[5] = {1.0f / 16.0f, 4.0f / 16.0f, 6.0f / 16.0f, 4.0f / 16.0f, 1.0f / 16.0f};
+
+    float sum[C] = {};
+    for (int k = 0; k < 5; ++k)
+    {
+        const float* p = pixelAt<C>(in, inPitch, mirrorIndex(x * step + k - 2, inWidth), y);
+        for (int c = 0; c < C; ++c)
+            sum[c] += gaussian5[k] * p[c];
+    }
+
+    float* o = pixelAt<C>(out, outPitch, x, y);
+    for (int c = 0; c < C; ++c)
+        o[c] = sum[c];
+}
+
+/**
+ * @brief Vertical pass of the 5x5 Gaussian filter, evaluated on one row every step rows, the result is multiplied by factor
+ */
+template<int C>
+__global__ void gaussian5Vertical_kernel(float* out,
+                                         std::size_t outPitch,
+                                         const float* in,
+                                         std::size_t inPitch,
+                                         int width,
+                                         int inHeight,
+                                         int outHeight,
+                                         int step,
+                                         float factor)
+{
+    const int x = blockIdx.x * blockDim.x + threadIdx.x;
+    const int y = blockIdx.y * blockDim.y + threadIdx.y;
+
+    if (x >= width || y >= outHeight)
+        return;
+
+    // normalized binomial kernel of convolveGaussian5x5
+    const float gaussian5[5] = {1.0f / 16.0f, 4.0f / 16.0f, 6.0f / 16.0f, 4.0f / 16.0f, 1.0f / 16.0f};
+
+    float sum[C] = {};
+    for (int k = 0; k < 5; ++k)
+    {
+        const float* p = pixelAt<C>(in, inPitch, x, mirrorIndex(y * step + k - 2, inHeight));
+        for (int c = 0; c < C; ++c)
+            sum[c] += gaussian5[k] * p[c];
+    }
+
+    float* o = pixelAt<C>(out, outPitch, x, y);
+    for (int c = 0; c < C; ++c)
+        o[c] = sum[c] * factor;
+}
+
+/**
+ * @brief 5x5 Gaussian filter (convolveGaussian5x5 without loop), optionally followed by the decimation by 2
+ *        (convolveGaussian5x5Downscale). The output is allocated.
+ * @param[out] output the filtered image
+ * @param[in] input the input image
+ * @param[out] tmp buffer of the horizontal pass
+ * @param[in] decimate keep one pixel out of 2 in both directions (output size = input size / 2)
+ * @param[in] factor multiplication of the result
+ */
+template<int C>
+void cuda_gaussian5(DeviceImage<C>& output, const DeviceImage<C>& input, DeviceImage<C>& tmp, bool decimate, float factor, cudaStream_t stream)
+{
+    const int step = decimate ? 2 : 1;
+    const int outWidth = decimate ? input.getWidth() / 2 : input.getWidth();
+    const int outHeight = decimate ? input.getHeight() / 2 : input.getHeight();
+
+    tmp.allocate(outWidth, input.getHeight());
+    output.allocate(outWidth, outHeight);
+
+    gaussian5Horizontal_kernel<C><<<imageGrid(outWidth, input.getHeight()), imageBlock(), 0, stream>>>(
+      tmp.getBuffer(), tmp.getPitch(), input.getBuffer(), input.getPitch(), input.getWidth(), outWidth, input.getHeight(), step);
+
+    gaussian5Vertical_kernel<C><<<imageGrid(outWidth, outHeight), imageBlock(), 0, stream>>>(
+      output.getBuffer(), output.getPitch(), tmp.getBuffer(), tmp.getPitch(), outWidth, input.getHeight(), outHeight, step, factor);
+
+    checkCudaError(cudaGetLastError(), "Cannot filter panorama image");
+}
+
+}  // namespace aliceVision
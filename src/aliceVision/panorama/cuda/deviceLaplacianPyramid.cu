@@ -0,0 +1,302 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "deviceLaplacianPyramid.hpp"
+
+#include <aliceVision/panorama/cuda/deviceImage.cuh>
+
+namespace aliceVision {
+
+namespace {
+
+/**
+ * @brief Set the colors and the weights to 0 outside of the mask
+ */
+__global__ void maskColor_kernel(float* masked,
+                                 std::size_t maskedPitch,
+                                 const float* color,
+                                 std::size_t colorPitch,
+                                 float* weights,
+                                 std::size_t weightsPitch,
+                                 const float* mask,
+                                 std::size_t maskPitch,
+                                 int width,
+                                 int height)
+{
+    const int x = blockIdx.x * blockDim.x + threadIdx.x;
+    const int y = blockIdx.y * blockDim.y + threadIdx.y;
+
+    if (x >= width || y >= height)
+        return;
+
+    const float* c = pixelAt<3>(color, colorPitch, x, y);
+    float* o = pixelAt<3>(masked, maskedPitch, x, y);
+
+    if (fabsf(*pixelAt<1>(mask, maskPitch, x, y)) > 1e-6f)
+    {
+        o[0] = c[0];
+        o[1] = c[1];
+        o[2] = c[2];
+    }
+    else
+    {
+        o[0] = 0.0f;
+        o[1] = 0.0f;
+        o[2] = 0.0f;
+        *pixelAt<1>(weights, weightsPitch, x, y) = 0.0f;
+    }
+}
+
+/**
+ * @brief Normalize the filtered colors by the filtered mask, the mask becomes binary
+ */
+__global__ void normalizeByMask_kernel(float* color, std::size_t colorPitch, float* mask, std::size_t maskPitch, int width, int height)
+{
+    const int x = blockIdx.x * blockDim.x + threadIdx.x;
+    const int y = blockIdx.y * blockDim.y + threadIdx.y;
+
+    if (x >= width || y >= height)
+        return;
+
+    float* c = pixelAt<3>(color, colorPitch, x, y);
+    float* m = pixelAt<1>(mask, maskPitch, x, y);
+
+    if (fabsf(*m) > 1e-6f)
+    {
+        c[0] = c[0] / *m;
+        c[1] = c[1] / *m;
+        c[2] = c[2] / *m;
+        *m = 1.0f;
+    }
+    else
+    {
+        c[0] = 0.0f;
+        c[1] = 0.0f;
+        c[2] = 0.0f;
+        *m = 0.0f;
+    }
+}
+
+/**
+ * @brief Normalize the accumulated colors by the accumulated weights
+ */
+__global__ void normalizeByWeights_kernel(float* color, std::size_t colorPitch, const float* weights, std::size_t weightsPitch, int width, int height)
+{
+    const int x = blockIdx.x * blockDim.x + threadIdx.x;
+    const int y = blockIdx.y * blockDim.y + threadIdx.y;
+
+    if (x >= width || y >= height)
+        return;
+
+    float* c = pixelAt<3>(color, colorPitch, x, y);
+    const float w = *pixelAt<1>(weights, weightsPitch, x, y);
+
+    if (w < 1e-6f)
+    {
+        c[0] = 0.0f;
+        c[1] = 0.0f;
+        c[2] = 0.0f;
+    }
+    else
+    {
+        c[0] = c[0] / w;
+        c[1] = c[1] / w;
+        c[2] = c[2] / w;
+    }
+}
+
+/**
+ * @brief Upscale by 2 with zeros between the input pixels, same as upscale
+ */
+__global__ void upscale_kernel(float* out, std::size_t outPitch, int outWidth, int outHeight, const float* in, std::size_t inPitch, int inWidth, int inHeight)
+{
+    const int x = blockIdx.x * blockDim.x + threadIdx.x;
+    const int y = blockIdx.y * blockDim.y + threadIdx.y;
+
+    if (x >= outWidth || y >= outHeight)
+        return;
+
+    float* o = pixelAt<3>(out, outPitch, x, y);
+
+    if ((x % 2) == 0 && (y % 2) == 0 && x / 2 < inWidth && y / 2 < inHeight)
+    {
+        const float* c = pixelAt<3>(in, inPitch, x / 2, y / 2);
+        o[0] = c[0];
+        o[1] = c[1];
+        o[2] = c[2];
+    }
+    else
+    {
+        o[0] = 0.0f;
+        o[1] = 0.0f;
+        o[2] = 0.0f;
+    }
+}
+
+/**
+ * @brief a += sign * b
+ */
+__global__ void accumulate_kernel(float* a, std::size_t aPitch, const float* b, std::size_t bPitch, int width, int height, float sign)
+{
+    const int x = blockIdx.x * blockDim.x + threadIdx.x;
+    const int y = blockIdx.y * blockDim.y + threadIdx.y;
+
+    if (x >= width || y >= height)
+        return;
+
+    float* pa = pixelAt<3>(a, aPitch, x, y);
+    const float* pb = pixelAt<3>(b, bPitch, x, y);
+
+    pa[0] = pa[0] + sign * pb[0];
+    pa[1] = pa[1] + sign * pb[1];
+    pa[2] = pa[2] + sign * pb[2];
+}
+
+/**
+ * @brief Upscale the coarser level and filter it, as in the laplacian pyramid expansion
+ * @param[out] output expanded image, of the size of the finer level
+ */
+void expand(DeviceImage<3>& output, const DeviceImage<3>& coarse, int width, int height, DeviceImage<3>& upscaled, DeviceImage<3>& tmp, cudaStream_t stream)
+{
+    upscaled.allocate(width, height);
+    upscale_kernel<<<imageGrid(width, height), imageBlock(), 0, stream>>>(
+      upscaled.getBuffer(), upscaled.getPitch(), width, height, coarse.getBuffer(), coarse.getPitch(), coarse.getWidth(), coarse.getHeight());
+    checkCudaError(cudaGetLastError(), "Cannot upscale panorama level");
+
+    // values must be multiplied by 4 as the upscale fills with zeros
+    cuda_gaussian5(output, upscaled, tmp, false, 4.0f, stream);
+}
+
+}  // namespace
+
+void cuda_laplacianDecompose(const float* color,
+                             const float* weights,
+                             const float* mask,
+                             int width,
+                             int height,
+                             int levelsCount,
+                             float* const* bands,
+                             float* const* bandWeights,
+                             float* coarseColor,
+                             float* coarseWeights,
+                             float* coarseMask)
+{
+    const cudaStream_t stream = cudaStreamPerThread;
+
+    DeviceImage<3> color_d;
+    DeviceImage<3> nextColor_d;
+    DeviceImage<3> masked_d;
+    DeviceImage<3> expanded_d;
+    DeviceImage<3> upscaled_d;
+    DeviceImage<3> tmp3_d;
+    DeviceImage<1> weights_d;
+    DeviceImage<1> nextWeights_d;
+    DeviceImage<1> mask_d;
+    DeviceImage<1> nextMask_d;
+    DeviceImage<1> tmp1_d;
+
+    color_d.upload(color, width, height, stream);
+    weights_d.upload(weights, width, height, stream);
+    mask_d.upload(mask, width, height, stream);
+
+    for (int l = 0; l + 1 < levelsCount; ++l)
+    {
+        const int levelWidth = color_d.getWidth();
+        const int levelHeight = color_d.getHeight();
+
+        // apply mask to content before convolution
+        masked_d.allocate(levelWidth, levelHeight);
+        maskColor_kernel<<<imageGrid(levelWidth, levelHeight), imageBlock(), 0, stream>>>(masked_d.getBuffer(),
+                                                                                          masked_d.getPitch(),
+                                                                                          color_d.getBuffer(),
+                                                                                          color_d.getPitch(),
+                                                                                          weights_d.getBuffer(),
+                                                                                          weights_d.getPitch(),
+                                                                                          mask_d.getBuffer(),
+                                                                                          mask_d.getPitch(),
+                                                                                          levelWidth,
+                                                                                          levelHeight);
+        checkCudaError(cudaGetLastError(), "Cannot mask panorama level");
+
+        // blur and decimate the colors and the mask, only the kept pixels are filtered
+        cuda_gaussian5(nextColor_d, masked_d, tmp3_d, true, 1.0f, stream);
+        cuda_gaussian5(nextMask_d, mask_d, tmp1_d, true, 1.0f, stream);
+
+        // normalize given mask (make sure the convolution sum is 1)
+        normalizeByMask_kernel<<<imageGrid(nextColor_d.getWidth(), nextColor_d.getHeight()), imageBlock(), 0, stream>>>(
+          nextColor_d.getBuffer(), nextColor_d.getPitch(), nextMask_d.getBuffer(), nextMask_d.getPitch(), nextColor_d.getWidth(), nextColor_d.getHeight());
+        checkCudaError(cudaGetLastError(), "Cannot normalize panorama level");
+
+        // only keep the difference (band pass)
+        expand(expanded_d, nextColor_d, levelWidth, levelHeight, upscaled_d, tmp3_d, stream);
+        accumulate_kernel<<<imageGrid(levelWidth, levelHeight), imageBlock(), 0, stream>>>(
+          color_d.getBuffer(), color_d.getPitch(), expanded_d.getBuffer(), expanded_d.getPitch(), levelWidth, levelHeight, -1.0f);
+        checkCudaError(cudaGetLastError(), "Cannot compute panorama band");
+
+        // downscale weights
+        cuda_gaussian5(nextWeights_d, weights_d, tmp1_d, true, 1.0f, stream);
+
+        // the downloads are ordered before the next writes in these buffers on the same stream
+        color_d.download(bands[l], stream);
+        weights_d.download(bandWeights[l], stream);
+
+        color_d.swap(nextColor_d);
+        weights_d.swap(nextWeights_d);
+        mask_d.swap(nextMask_d);
+    }
+
+    color_d.download(coarseColor, stream);
+    weights_d.download(coarseWeights, stream);
+    mask_d.download(coarseMask, stream);
+
+    checkCudaError(cudaStreamSynchronize(stream), "Cannot decompose panorama input");
+}
+
+void cuda_laplacianCollapse(float* const* levels, const float* const* weights, const int* widths, const int* heights, int levelsCount)
+{
+    if (levelsCount <= 0)
+    {
+        return;
+    }
+
+    const cudaStream_t stream = cudaStreamPerThread;
+
+    DeviceImage<3> current_d;
+    DeviceImage<3> level_d;
+    DeviceImage<3> expanded_d;
+    DeviceImage<3> upscaled_d;
+    DeviceImage<3> tmp_d;
+    DeviceImage<1> weights_d;
+
+    // the levels are stored in log space, removeNegativeValues has no effect on them
+    for (int l = levelsCount - 1; l >= 0; --l)
+    {
+        const int width = widths[l];
+        const int height = heights[l];
+
+        level_d.upload(levels[l], width, height, stream);
+        weights_d.upload(weights[l], width, height, stream);
+
+        normalizeByWeights_kernel<<<imageGrid(width, height), imageBlock(), 0, stream>>>(
+          level_d.getBuffer(), level_d.getPitch(), weights_d.getBuffer(), weights_d.getPitch(), width, height);
+        checkCudaError(cudaGetLastError(), "Cannot normalize panorama level");
+
+        if (l + 1 < levelsCount)
+        {
+            expand(expanded_d, current_d, width, height, upscaled_d, tmp_d, stream);
+            accumulate_kernel<<<imageGrid(width, height), imageBlock(), 0, stream>>>(
+              level_d.getBuffer(), level_d.getPitch(), expanded_d.getBuffer(), expanded_d.getPitch(), width, height, 1.0f);
+            checkCudaError(cudaGetLastError(), "Cannot collapse panorama level");
+        }
+
+        current_d.swap(level_d);
+    }
+
+    current_d.download(levels[0], stream);
+    checkCudaError(cudaStreamSynchronize(stream), "Cannot collapse panorama levels");
+}
+
+}  // namespace aliceVision
@@ -0,0 +1,50 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+namespace aliceVision {
+
+/**
+ * @brief Laplacian decomposition of one input on the GPU, same steps as LaplacianPyramid::apply.
+ *        The level l has the size (width >> l, height >> l), the input size must be divisible by 2^(levelsCount - 1).
+ *        All the host buffers are contiguous, colors are RGB floats.
+ * @param[in] color the feathered input colors
+ * @param[in] weights the input weights
+ * @param[in] mask the input mask
+ * @param[in] width the input width
+ * @param[in] height the input height
+ * @param[in] levelsCount the number of levels of the pyramid
+ * @param[out] bands the band-pass colors of the levels [0, levelsCount - 1[
+ * @param[out] bandWeights the weights of the levels [0, levelsCount - 1[
+ * @param[out] coarseColor the colors of the coarsest level
+ * @param[out] coarseWeights the weights of the coarsest level
+ * @param[out] coarseMask the mask of the coarsest level
+ */
+void cuda_laplacianDecompose(const float* color,
+                             const float* weights,
+                             const float* mask,
+                             int width,
+                             int height,
+                             int levelsCount,
+                             float* const* bands,
+                             float* const* bandWeights,
+                             float* coarseColor,
+                             float* coarseWeights,
+                             float* coarseMask);
+
+/**
+ * @brief Normalize the accumulated levels by their weights and collapse the pyramid on the GPU,
+ *        same steps as LaplacianPyramid::rebuild. All the host buffers are contiguous, colors are RGB floats.
+ * @param[in,out] levels the accumulated weighted colors of the levels, levels[0] is replaced by the collapsed image
+ * @param[in] weights the accumulated weights of the levels
+ * @param[in] widths the width of the levels
+ * @param[in] heights the height of the levels
+ * @param[in] levelsCount the number of levels
+ */
+void cuda_laplacianCollapse(float* const* levels, const float* const* weights, const int* widths, const int* heights, int levelsCount);
+
+}  // namespace aliceVision
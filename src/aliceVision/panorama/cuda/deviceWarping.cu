@@ -0,0 +1,293 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "deviceWarping.hpp"
+
+#include <aliceVision/panorama/cuda/deviceImage.cuh>
+
+#include <memory>
+
+namespace aliceVision {
+
+namespace {
+
+/// maximum number of levels of the device pyramid, more than enough for any image size
+constexpr int maxLevels = 16;
+
+/**
+ * @brief Kernel parameters of the pyramid levels
+ */
+struct DeviceLevels
+{
+    const float* buffer[maxLevels];
+    std::size_t pitch[maxLevels];
+    int width[maxLevels];
+    int height[maxLevels];
+    int count;
+};
+
+/**
+ * @brief Bilinear sampling, same as image::Sampler2d<image::SamplerLinear>
+ */
+__device__ float3 sampleLinear(const DeviceLevels& levels, int level, float y, float x)
+{
+    const float* buffer = levels.buffer[level];
+    const std::size_t pitch = levels.pitch[level];
+    const int width = levels.width[level];
+    const int height = levels.height[level];
+
+    const float dx = x - floorf(x);
+    const float dy = y - floorf(y);
+    const float coefsX[2] = {1.0f - dx, dx};
+    const float coefsY[2] = {1.0f - dy, dy};
+
+    const int gridX = static_cast<int>(floorf(x));
+    const int gridY = static_cast<int>(floorf(y));
+
+    float3 res = make_float3(0.0f, 0.0f, 0.0f);
+    float totalWeight = 0.0f;
+    for (int i = 0; i < 2; ++i)
+    {
+        const int curI = gridY + i;
+        if (curI < 0 || curI >= height)
+            continue;
+
+        for (int j = 0; j < 2; ++j)
+        {
+            const int curJ = gridX + j;
+            if (curJ < 0 || curJ >= width)
+                continue;
+
+            const float w = coefsX[j] * coefsY[i];
+            const float* p = pixelAt<3>(buffer, pitch, curJ, curI);
+            res.x += p[0] * w;
+            res.y += p[1] * w;
+            res.z += p[2] * w;
+            totalWeight += w;
+        }
+    }
+
+    // too unstable, return the nearest pixel
+    if (totalWeight <= 0.2f)
+    {
+        const int row = min(max(gridY, 0), height - 1);
+        const int col = min(max(gridX, 0), width - 1);
+        const float* p = pixelAt<3>(buffer, pitch, col, row);
+        return make_float3(p[0], p[1], p[2]);
+    }
+
+    if (totalWeight != 1.0f)
+    {
+        res.x /= totalWeight;
+        res.y /= totalWeight;
+        res.z /= totalWeight;
+    }
+
+    return res;
+}
+
+/**
+ * @brief Multi level warp of one pixel of the tile, same as GaussianWarper::warp
+ */
+__global__ void gaussianWarp_kernel(float* out,
+                                    std::size_t outPitch,
+                                    const float* coordinates,
+                                    std::size_t coordinatesPitch,
+                                    const unsigned char* mask,
+                                    int width,
+                                    int height,
+                                    DeviceLevels levels,
+                                    float maxValue)
+{
+    const int j = blockIdx.x * blockDim.x + threadIdx.x;
+    const int i = blockIdx.y * blockDim.y + threadIdx.y;
+
+    if (j >= width || i >= height)
+        return;
+
+    float* o = pixelAt<3>(out, outPitch, j, i);
+
+    if (!mask[i * width + j])
+    {
+        o[0] = 1.0f;
+        o[1] = 0.0f;
+        o[2] = 0.0f;
+        return;
+    }
+
+    const int nextI = max((i == height - 1) ? i - 1 : i + 1, 0);
+    const int nextJ = max((j == width - 1) ? j - 1 : j + 1, 0);
+
+    const float* coordMM = pixelAt<2>(coordinates, coordinatesPitch, j, i);
+
+    float3 color;
+    if (!mask[nextI * width + j] || !mask[i * width + nextJ])
+    {
+        color = sampleLinear(levels, 0, coordMM[1], coordMM[0]);
+    }
+    else
+    {
+        const float* coordMP = pixelAt<2>(coordinates, coordinatesPitch, nextJ, i);
+        const float* coordPM = pixelAt<2>(coordinates, coordinatesPitch, j, nextI);
+
+        const float dxx = coordPM[0] - coordMM[0];
+        const float dxy = coordMP[0] - coordMM[0];
+        const float dyx = coordPM[1] - coordMM[1];
+        const float dyy = coordMP[1] - coordMM[1];
+        const float det = fabsf(dxx * dyy - dxy * dyx);
+
+        const float flevel = fmaxf(0.0f, 0.5f * log2f(det));
+        const int blevel = min(levels.count - 1, static_cast<int>(floorf(flevel)));
+
+        const float dscale = ldexpf(1.0f, -blevel);
+        const float x = coordMM[0] * dscale;
+        const float y = coordMM[1] * dscale;
+
+        if (x >= levels.width[blevel] - 1 || y >= levels.height[blevel] - 1)
+        {
+            // fallback to the first level if outside
+            color = sampleLinear(levels, 0, coordMM[1], coordMM[0]);
+        }
+        else
+        {
+            color = sampleLinear(levels, blevel, y, x);
+            if (color.x > maxValue)
+                color.x = maxValue;
+            if (color.y > maxValue)
+                color.y = maxValue;
+            if (color.z > maxValue)
+                color.z = maxValue;
+        }
+    }
+
+    o[0] = color.x;
+    o[1] = color.y;
+    o[2] = color.z;
+}
+
+struct CudaFree
+{
+    void operator()(void* ptr) const { cudaFree(ptr); }
+};
+
+}  // namespace
+
+void cuda_createGaussianPyramid(std::vector<DevicePyramidLevel>& levels, const float* source, int width, int height, std::size_t levelsCount)
+{
+    const cudaStream_t stream = cudaStreamPerThread;
+
+    levels.clear();
+
+    try
+    {
+        for (std::size_t l = 0; l < std::min<std::size_t>(std::max<std::size_t>(levelsCount, 1), maxLevels); ++l)
+        {
+            DevicePyramidLevel level;
+            level.width = width;
+            level.height = height;
+            checkCudaError(cudaMallocPitch(reinterpret_cast<void**>(&level.buffer), &level.pitch, std::max(1, width) * 3 * sizeof(float), std::max(1, height)),
+                           "Cannot allocate the panorama source pyramid in device memory");
+            levels.push_back(level);
+
+            width /= 2;
+            height /= 2;
+        }
+
+        const DevicePyramidLevel& base = levels[0];
+        checkCudaError(cudaMemcpy2DAsync(base.buffer,
+                                         base.pitch,
+                                         source,
+                                         base.width * 3 * sizeof(float),
+                                         base.width * 3 * sizeof(float),
+                                         base.height,
+                                         cudaMemcpyHostToDevice,
+                                         stream),
+                       "Cannot upload the panorama source image");
+
+        // blur only the pixels kept by the decimation, as GaussianPyramidNoMask::process
+        DeviceImage<3> tmp;
+        for (std::size_t l = 0; l + 1 < levels.size(); ++l)
+        {
+            const DevicePyramidLevel& in = levels[l];
+            const DevicePyramidLevel& out = levels[l + 1];
+
+            tmp.allocate(out.width, in.height);
+
+            gaussian5Horizontal_kernel<3><<<imageGrid(out.width, in.height), imageBlock(), 0, stream>>>(
+              tmp.getBuffer(), tmp.getPitch(), in.buffer, in.pitch, in.width, out.width, in.height, 2);
+
+            gaussian5Vertical_kernel<3><<<imageGrid(out.width, out.height), imageBlock(), 0, stream>>>(
+              out.buffer, out.pitch, tmp.getBuffer(), tmp.getPitch(), out.width, in.height, out.height, 2, 1.0f);
+
+            checkCudaError(cudaGetLastError(), "Cannot build the panorama source pyramid");
+        }
+
+        checkCudaError(cudaStreamSynchronize(stream), "Cannot build the panorama source pyramid");
+    }
+    catch (...)
+    {
+        cuda_destroyGaussianPyramid(levels);
+        throw;
+    }
+}
+
+void cuda_destroyGaussianPyramid(std::vector<DevicePyramidLevel>& levels)
+{
+    for (DevicePyramidLevel& level : levels)
+    {
+        cudaFree(level.buffer);
+    }
+    levels.clear();
+}
+
+void cuda_gaussianWarp(float* output,
+                       const float* coordinates,
+                       const unsigned char* mask,
+                       int width,
+                       int height,
+                       const std::vector<DevicePyramidLevel>& levels,
+                       float maxValue)
+{
+    // one stream per host thread, the tiles are warped concurrently
+    const cudaStream_t stream = cudaStreamPerThread;
+
+    DeviceLevels deviceLevels;
+    deviceLevels.count = static_cast<int>(std::min<std::size_t>(levels.size(), maxLevels));
+    for (int l = 0; l < deviceLevels.count; ++l)
+    {
+        deviceLevels.buffer[l] = levels[l].buffer;
+        deviceLevels.pitch[l] = levels[l].pitch;
+        deviceLevels.width[l] = levels[l].width;
+        deviceLevels.height[l] = levels[l].height;
+    }
+
+    DeviceImage<2> coordinates_d;
+    coordinates_d.upload(coordinates, width, height, stream);
+
+    unsigned char* mask_ptr = nullptr;
+    checkCudaError(cudaMalloc(reinterpret_cast<void**>(&mask_ptr), std::max(1, width * height)), "Cannot allocate the panorama tile mask in device memory");
+    const std::unique_ptr<unsigned char, CudaFree> mask_d(mask_ptr);
+    checkCudaError(cudaMemcpyAsync(mask_d.get(), mask, width * height, cudaMemcpyHostToDevice, stream), "Cannot upload the panorama tile mask");
+
+    DeviceImage<3> output_d(width, height);
+
+    gaussianWarp_kernel<<<imageGrid(width, height), imageBlock(), 0, stream>>>(output_d.getBuffer(),
+                                                                               output_d.getPitch(),
+                                                                               coordinates_d.getBuffer(),
+                                                                               coordinates_d.getPitch(),
+                                                                               mask_d.get(),
+                                                                               width,
+                                                                               height,
+                                                                               deviceLevels,
+                                                                               maxValue);
+    checkCudaError(cudaGetLastError(), "Cannot warp the panorama tile");
+
+    output_d.download(output, stream);
+
+    checkCudaError(cudaStreamSynchronize(stream), "Cannot warp the panorama tile");
+}
+
+}  // namespace aliceVision
@@ -0,0 +1,59 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace aliceVision {
+
+/**
+ * @brief Level of a RGB float pyramid in device memory (pitched buffer)
+ */
+struct DevicePyramidLevel
+{
+    float* buffer = nullptr;
+    std::size_t pitch = 0;
+    int width = 0;
+    int height = 0;
+};
+
+/**
+ * @brief Upload a RGB float image and build its gaussian pyramid on the GPU, same levels as GaussianPyramidNoMask
+ * @param[out] levels the allocated levels, level 0 is the source image
+ * @param[in] source the contiguous RGB float source image
+ * @param[in] width the source image width
+ * @param[in] height the source image height
+ * @param[in] levelsCount the number of levels
+ */
+void cuda_createGaussianPyramid(std::vector<DevicePyramidLevel>& levels, const float* source, int width, int height, std::size_t levelsCount);
+
+/**
+ * @brief Release the levels of a pyramid built with cuda_createGaussianPyramid
+ */
+void cuda_destroyGaussianPyramid(std::vector<DevicePyramidLevel>& levels);
+
+/**
+ * @brief Multi level warp of a panorama tile on the GPU, same as GaussianWarper::warp.
+ *        Can be called concurrently from several host threads.
+ * @param[out] output the contiguous RGB float warped tile
+ * @param[in] coordinates the contiguous source image coordinates (x, y) of each pixel of the tile
+ * @param[in] mask the contiguous mask of the valid pixels of the tile
+ * @param[in] width the tile width
+ * @param[in] height the tile height
+ * @param[in] levels the source pyramid
+ * @param[in] maxValue the maximum value of the warped colors
+ */
+void cuda_gaussianWarp(float* output,
+                       const float* coordinates,
+                       const unsigned char* mask,
+                       int width,
+                       int height,
+                       const std::vector<DevicePyramidLevel>& levels,
+                       float maxValue);
+
+}  // namespace aliceVision
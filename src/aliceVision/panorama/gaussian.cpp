@@ -14,46 +14,60 @@ GaussianPyramidNoMask::GaussianPyramidNoMask(const size_t width_base, const size
   : _width_base(width_base),
     _height_base(height_base)
 {
-    /**
-     * Compute optimal scale
-     * The smallest level will be at least of size min_size
-     */
-    size_t min_dim = std::min(_width_base, _height_base);
-    size_t min_size = 32;
-    _scales = std::min(limit_scales, static_cast<size_t>(floor(log2(double(min_dim) / float(min_size)))));
+    // at least the input itself
+    _scales = std::max<size_t>(1, computeScalesCount(_width_base, _height_base, limit_scales));
 
     /**
      * Create pyramid
+     * The first level is the input given to process
      **/
     size_t new_width = _width_base;
     size_t new_height = _height_base;
-    for (int i = 0; i < _scales; i++)
+    _pyramid_color.emplace_back();
+    for (int i = 1; i < _scales; i++)
     {
-        _pyramid_color.push_back(image::Image<image::RGBfColor>(new_width, new_height, true, image::RGBfColor(0)));
-        _filter_buffer.push_back(image::Image<image::RGBfColor>(new_width, new_height, true, image::RGBfColor(0)));
         new_height /= 2;
         new_width /= 2;
+        _pyramid_color.push_back(image::Image<image::RGBfColor>(new_width, new_height));
     }
 }
 
+size_t GaussianPyramidNoMask::computeScalesCount(const size_t width_base, const size_t height_base, const size_t limit_scales)
+{
+    /**
+     * Compute optimal scale
+     * The smallest level will be at least of size min_size
+     */
+    size_t min_dim = std::min(width_base, height_base);
+    size_t min_size = 32;
+    return std::min(limit_scales, static_cast<size_t>(floor(log2(double(min_dim) / float(min_size)))));
+}
+
 bool GaussianPyramidNoMask::process(const image::Image<image::RGBfColor>& input)
 {
-    if (input.Height() != _pyramid_color[0].Height())
+    image::Image<image::RGBfColor> copy(input);
+
+    return process(std::move(copy));
+}
+
+bool GaussianPyramidNoMask::process(image::Image<image::RGBfColor>&& input)
+{
+    if (input.Height() != _height_base)
         return false;
-    if (input.Width() != _pyramid_color[0].Width())
+    if (input.Width() != _width_base)
         return false;
 
     /**
      * Build pyramid
      */
-    _pyramid_color[0] = input;
+    _pyramid_color[0].swap(input);
     for (int lvl = 0; lvl < _scales - 1; lvl++)
     {
-        const image::Image<image::RGBfColor>& source = _pyramid_color[lvl];
-        image::Image<image::RGBfColor>& dst = _filter_buffer[lvl];
-
-        convolveGaussian5x5(dst, source);
-        downscale(_pyramid_color[lvl + 1], _filter_buffer[lvl]);
+        // blur only the pixels kept by the decimation
+        if (!convolveGaussian5x5Downscale(_pyramid_color[lvl + 1], _pyramid_color[lvl]))
+        {
+            return false;
+        }
     }
 
     return true;
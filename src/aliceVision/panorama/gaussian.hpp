@@ -15,8 +15,19 @@ class GaussianPyramidNoMask
   public:
     GaussianPyramidNoMask(const size_t width_base, const size_t height_base, const size_t limit_scales = 64);
 
+    /**
+     * @brief Number of levels of the pyramid of an image, the smallest level is at least 32 pixels large
+     */
+    static size_t computeScalesCount(const size_t width_base, const size_t height_base, const size_t limit_scales = 64);
+
     bool process(const image::Image<image::RGBfColor>& input);
 
+    /**
+     * @brief Build the pyramid without copying the input, which becomes the first level
+     * @param[in] input the image to decompose, left empty
+     */
+    bool process(image::Image<image::RGBfColor>&& input);
+
     bool downscale(image::Image<image::RGBfColor>& output, const image::Image<image::RGBfColor>& input);
 
     const size_t getScalesCount() const { return _scales; }
@@ -27,7 +38,6 @@ class GaussianPyramidNoMask
 
   protected:
     std::vector<image::Image<image::RGBfColor>> _pyramid_color;
-    std::vector<image::Image<image::RGBfColor>> _filter_buffer;
     size_t _width_base;
     size_t _height_base;
     size_t _scales;
@@ -166,4 +176,136 @@ bool convolveGaussian5x5(image::Image<T>& output, const image::Image<T>& input,
     return true;
 }
 
+/**
+ * @brief Horizontal 5 taps gaussian filter [1 4 6 4 1] / 16 of the even columns of a row (mirrored borders)
+ * @param[out] output The filtered row of outputWidth pixels
+ * @param[in] input The input row of inputWidth pixels, channels are interleaved floats
+ */
+template<int Channels>
+inline void gaussian5DecimateRow(float* output, const float* input, int inputWidth, int outputWidth)
+{
+    const float w0 = 1.0f / 16.0f;
+    const float w1 = 4.0f / 16.0f;
+    const float w2 = 6.0f / 16.0f;
+
+    /* mirror 5432 | 123456 | 5432 */
+    const auto mirror = [inputWidth](int x) { return (x < 0) ? -x : ((x >= inputWidth) ? 2 * inputWidth - 2 - x : x); };
+
+    // the taps of the columns [1, lastInside] do not need the mirror
+    const int lastInside = std::min(outputWidth - 1, (inputWidth - 3) / 2);
+
+    for (int j = 0; j < outputWidth; j++)
+    {
+        if (j >= 1 && j <= lastInside)
+        {
+            const float* p = input + (2 * j - 2) * Channels;
+            float* o = output + j * Channels;
+            for (int c = 0; c < Channels; c++)
+            {
+                o[c] = (p[c] + p[4 * Channels + c]) * w0 + (p[Channels + c] + p[3 * Channels + c]) * w1 + p[2 * Channels + c] * w2;
+            }
+
+            continue;
+        }
+
+        const float* p0 = input + mirror(2 * j - 2) * Channels;
+        const float* p1 = input + mirror(2 * j - 1) * Channels;
+        const float* p2 = input + mirror(2 * j) * Channels;
+        const float* p3 = input + mirror(2 * j + 1) * Channels;
+        const float* p4 = input + mirror(2 * j + 2) * Channels;
+        float* o = output + j * Channels;
+        for (int c = 0; c < Channels; c++)
+        {
+            o[c] = (p0[c] + p4[c]) * w0 + (p1[c] + p3[c]) * w1 + p2[c] * w2;
+        }
+    }
+}
+
+/**
+ * @brief Vertical 5 taps gaussian filter [1 4 6 4 1] / 16 of 5 rows of count contiguous floats
+ */
+inline void gaussian5Rows(float* output, const float* r0, const float* r1, const float* r2, const float* r3, const float* r4, int count)
+{
+    const float w0 = 1.0f / 16.0f;
+    const float w1 = 4.0f / 16.0f;
+    const float w2 = 6.0f / 16.0f;
+
+    // contiguous and independent, vectorized by the compiler
+    for (int k = 0; k < count; k++)
+    {
+        output[k] = (r0[k] + r4[k]) * w0 + (r1[k] + r3[k]) * w1 + r2[k] * w2;
+    }
+}
+
+/**
+ * @brief Gaussian 5x5 blur followed by a decimation by 2, only the kept pixels are filtered.
+ *        Same result as convolveGaussian5x5 (without loop) followed by GaussianPyramidNoMask::downscale.
+ *        The output is computed by bands of rows in parallel, each band keeps only the 5 last horizontally filtered rows.
+ * @param[out] output The downscaled image (input width / 2, input height / 2)
+ * @param[in] input The input image, with float channels
+ */
+template<class T>
+bool convolveGaussian5x5Downscale(image::Image<T>& output, const image::Image<T>& input)
+{
+    constexpr int channels = sizeof(T) / sizeof(float);
+    static_assert(channels * sizeof(float) == sizeof(T), "The pixels must be made of floats");
+
+    if (output.Width() != input.Width() / 2 || output.Height() != input.Height() / 2 || input.Width() < 3 || input.Height() < 3)
+    {
+        return false;
+    }
+
+    const int inputWidth = input.Width();
+    const int inputHeight = input.Height();
+    const int outputWidth = output.Width();
+    const int outputHeight = output.Height();
+    const int rowSize = outputWidth * channels;
+
+    /* mirror 5432 | 123456 | 5432 */
+    const auto mirror = [inputHeight](int y) { return (y < 0) ? -y : ((y >= inputHeight) ? 2 * inputHeight - 2 - y : y); };
+
+    const int bandHeight = 32;
+    const int bandsCount = (outputHeight + bandHeight - 1) / bandHeight;
+
+#pragma omp parallel for
+    for (int band = 0; band < bandsCount; band++)
+    {
+        const int firstRow = band * bandHeight;
+        const int lastRow = std::min(outputHeight, firstRow + bandHeight);
+
+        // rolling buffer of the horizontally filtered input rows, the input row y is stored in the slot y mod 5
+        std::vector<float> buffer(5 * rowSize);
+        const auto slot = [&buffer, rowSize](int y) { return buffer.data() + (((y % 5) + 5) % 5) * rowSize; };
+        const auto filterRow = [&](int y) {
+            gaussian5DecimateRow<channels>(
+              slot(y), reinterpret_cast<const float*>(input.data() + std::size_t(mirror(y)) * inputWidth), inputWidth, outputWidth);
+        };
+
+        for (int y = 2 * firstRow - 2; y < 2 * firstRow + 2; y++)
+        {
+            filterRow(y);
+        }
+
+        for (int i = firstRow; i < lastRow; i++)
+        {
+            // the output row i needs the input rows [2i - 2, 2i + 2], the previous ones are already filtered
+            if (i > firstRow)
+            {
+                filterRow(2 * i + 1);
+            }
+            filterRow(2 * i + 2);
+
+            gaussian5Rows(reinterpret_cast<float*>(output.data() + std::size_t(i) * outputWidth),
+                          slot(2 * i - 2),
+                          slot(2 * i - 1),
+                          slot(2 * i),
+                          slot(2 * i + 1),
+                          slot(2 * i + 2),
+                          rowSize);
+        }
+    }
+
+    return true;
+}
+
 }  // namespace aliceVision
\ No newline at end of file
@@ -6,7 +6,7 @@
 
 #pragma once
 
-#include <boost/graph/adjacency_list.hpp>
+#include <boost/graph/compressed_sparse_row_graph.hpp>
 #include <boost/graph/boykov_kolmogorov_max_flow.hpp>
 
 #include <aliceVision/image/all.hpp>
@@ -16,129 +16,163 @@
 #include "imageOps.hpp"
 #include "seams.hpp"
 
+#include <atomic>
+
 namespace aliceVision {
 
 /**
- * @brief Maxflow computation based on a standard Adjacency List graph reprensentation.
+ * @brief Maxflow computation based on a compressed sparse row graph representation.
  *
- * @see MaxFlow_CSR which use less memory.
+ * The edges are accumulated in flat arrays and the graph is built in-place with a single counting sort,
+ * an edge and its reverse edge are always added together so the reverse edges are retrieved from the input order.
  */
-class MaxFlow_AdjList
+class MaxFlow_CSR
 {
   public:
-    using NodeType = int;
+    using NodeType = unsigned int;
+    using EdgeIndexType = unsigned int;
     using ValueType = float;
 
-    using Traits = boost::adjacency_list_traits<boost::vecS,  // OutEdgeListS
-                                                boost::vecS,  // VertexListS
-                                                boost::directedS,
-                                                boost::vecS  // EdgeListS
-                                                >;
-    using edge_descriptor = typename Traits::edge_descriptor;
-    using vertex_descriptor = typename Traits::vertex_descriptor;
-    using vertex_size_type = typename Traits::vertices_size_type;
+    using edge_descriptor = typename boost::compressed_sparse_row_graph<boost::directedS,
+                                                                        boost::no_property,  // VertexProperty
+                                                                        boost::no_property,  // EdgeProperty
+                                                                        NodeType,            // Vertex
+                                                                        EdgeIndexType        // EdgeIndex
+                                                                        >::edge_descriptor;
+
+    struct Vertex
+    {
+        boost::default_color_type color{};
+        ValueType distance{};
+        edge_descriptor predecessor{};
+    };
     struct Edge
     {
+        Edge(ValueType pCapacity, edge_descriptor pReverse)
+          : capacity(pCapacity),
+            reverse(pReverse)
+        {}
+        Edge() {}
+
         ValueType capacity{};
         ValueType residual{};
-        edge_descriptor reverse;
+        /// reverse edge, used to store the input edge index until the CSR graph is built
+        edge_descriptor reverse{};
     };
-    using Graph = boost::adjacency_list<boost::vecS,  // OutEdgeListS
-                                        boost::vecS,  // VertexListS
-                                        boost::directedS,
-                                        boost::no_property,  // VertexProperty
-                                        Edge,                // EdgeProperty
-                                        boost::no_property,  // GraphProperty
-                                        boost::vecS          // EdgeListS
-                                        >;
-    using VertexIterator = typename boost::graph_traits<Graph>::vertex_iterator;
+    using Graph = boost::compressed_sparse_row_graph<boost::directedS,
+                                                     Vertex,        // VertexProperty
+                                                     Edge,          // EdgeProperty
+                                                     NodeType,      // Vertex
+                                                     EdgeIndexType  // EdgeIndex
+                                                     >;
+    using vertex_size_type = typename Graph::vertices_size_type;
+    using edges_size_type = typename Graph::edges_size_type;
 
   public:
-    explicit MaxFlow_AdjList(size_t numNodes)
-      : _graph(numNodes + 2),
+    explicit MaxFlow_CSR(size_t numNodes)
+      : _numNodes(numNodes + 2),
         _S(NodeType(numNodes)),
         _T(NodeType(numNodes + 1))
     {
-        VertexIterator vi, vi_end;
-        for (boost::tie(vi, vi_end) = vertices(_graph); vi != vi_end; ++vi)
-        {
-            _graph.m_vertices[*vi].m_out_edges.reserve(9);
-        }
-        _graph.m_vertices[numNodes].m_out_edges.reserve(numNodes);
-        _graph.m_vertices[numNodes + 1].m_out_edges.reserve(numNodes);
-    }
-
-    inline void addNodeToSource(NodeType n, ValueType source)
-    {
-        assert(source >= 0);
-
-        edge_descriptor edge(boost::add_edge(_S, n, _graph).first);
-        edge_descriptor reverseEdge(boost::add_edge(n, _S, _graph).first);
-
-        _graph[edge].capacity = source;
-        _graph[edge].reverse = reverseEdge;
-        _graph[reverseEdge].reverse = edge;
-        _graph[reverseEdge].capacity = source;
+        // 2 neighbors edges and 1 terminal edge per node, each with its reverse edge
+        const std::size_t nbEdgesEstimation = numNodes * 6;
+        _sources.reserve(nbEdgesEstimation);
+        _targets.reserve(nbEdgesEstimation);
+        _edgesData.reserve(nbEdgesEstimation);
     }
 
-    inline void addNodeToSink(NodeType n, ValueType sink)
+    /**
+     * @brief Connect a node to the terminals, only the difference of the capacities is kept as it gives the same cut
+     */
+    inline void addNode(NodeType n, ValueType source, ValueType sink)
     {
-        assert(sink >= 0);
+        assert(source >= 0 && sink >= 0);
 
-        edge_descriptor edge(boost::add_edge(_T, n, _graph).first);
-        edge_descriptor reverseEdge(boost::add_edge(n, _T, _graph).first);
-
-        _graph[edge].capacity = sink;
-        _graph[edge].reverse = reverseEdge;
-        _graph[reverseEdge].reverse = edge;
-        _graph[reverseEdge].capacity = sink;
+        const ValueType score = source - sink;
+        if (score > 0)
+        {
+            addEdge(_S, n, score, score);
+        }
+        else if (score < 0)
+        {
+            addEdge(n, _T, -score, -score);
+        }
     }
 
     inline void addEdge(NodeType n1, NodeType n2, ValueType capacity, ValueType reverseCapacity)
     {
         assert(capacity >= 0 && reverseCapacity >= 0);
 
-        edge_descriptor edge(boost::add_edge(n1, n2, _graph).first);
-        edge_descriptor reverseEdge(boost::add_edge(n2, n1, _graph).first);
-        _graph[edge].capacity = capacity;
-        _graph[edge].reverse = reverseEdge;
+        // input index of the edge, its reverse edge is the next one
+        const std::size_t edgeIndex = _edgesData.size();
 
-        _graph[reverseEdge].capacity = reverseCapacity;
-        _graph[reverseEdge].reverse = edge;
-    }
+        _sources.push_back(n1);
+        _targets.push_back(n2);
+        _sources.push_back(n2);
+        _targets.push_back(n1);
 
-    void printStats() const;
-    void printColorStats() const;
+        _edgesData.push_back(Edge(capacity, edge_descriptor(n1, EdgeIndexType(edgeIndex))));
+        _edgesData.push_back(Edge(reverseCapacity, edge_descriptor(n2, EdgeIndexType(edgeIndex + 1))));
+    }
 
     inline ValueType compute()
     {
-        vertex_size_type nbVertices(boost::num_vertices(_graph));
-        _color.resize(nbVertices, boost::white_color);
-        std::vector<edge_descriptor> pred(nbVertices);
-        std::vector<vertex_size_type> dist(nbVertices);
-
-        ValueType v = boost::boykov_kolmogorov_max_flow(_graph,
-                                                        boost::get(&Edge::capacity, _graph),
-                                                        boost::get(&Edge::residual, _graph),
-                                                        boost::get(&Edge::reverse, _graph),
-                                                        &pred[0],
-                                                        &_color[0],
-                                                        &dist[0],
-                                                        boost::get(boost::vertex_index, _graph),
+        // in-place counting sort of the edges by source, the input vectors are swapped into the graph
+        Graph graph(boost::construct_inplace_from_sources_and_targets, _sources, _targets, _edgesData, _numNodes);
+        std::vector<NodeType>().swap(_sources);
+        std::vector<NodeType>().swap(_targets);
+        std::vector<Edge>().swap(_edgesData);
+
+        const vertex_size_type nbVertices = boost::num_vertices(graph);
+        const edges_size_type nbEdges = boost::num_edges(graph);
+
+        {
+            // input edge index to graph edge index
+            std::vector<EdgeIndexType> edgeIndexes(nbEdges);
+            typename Graph::edge_iterator ei, ee;
+            for (boost::tie(ei, ee) = boost::edges(graph); ei != ee; ++ei)
+            {
+                edgeIndexes[graph[*ei].reverse.idx] = ei->idx;
+            }
+            // input edges are added by pair (edge, reverse edge)
+            for (boost::tie(ei, ee) = boost::edges(graph); ei != ee; ++ei)
+            {
+                const EdgeIndexType reverseInputIndex = graph[*ei].reverse.idx ^ 1;
+                graph[*ei].reverse = edge_descriptor(boost::target(*ei, graph), edgeIndexes[reverseInputIndex]);
+            }
+        }
+
+        ValueType v = boost::boykov_kolmogorov_max_flow(graph,
+                                                        boost::get(&Edge::capacity, graph),
+                                                        boost::get(&Edge::residual, graph),
+                                                        boost::get(&Edge::reverse, graph),
+                                                        boost::get(&Vertex::predecessor, graph),
+                                                        boost::get(&Vertex::color, graph),
+                                                        boost::get(&Vertex::distance, graph),
+                                                        boost::get(boost::vertex_index, graph),
                                                         _S,
                                                         _T);
 
+        _isSource.resize(nbVertices);
+        for (std::size_t vi = 0; vi < nbVertices; ++vi)
+        {
+            _isSource[vi] = (graph[vi].color == boost::black_color);
+        }
+
         return v;
     }
 
     /// is empty
-    inline bool isSource(NodeType n) const { return (_color[n] == boost::black_color); }
+    inline bool isSource(NodeType n) const { return _isSource[n]; }
     /// is full
-    inline bool isTarget(NodeType n) const { return (_color[n] == boost::white_color); }
+    inline bool isTarget(NodeType n) const { return !_isSource[n]; }
 
   protected:
-    Graph _graph;
-    std::vector<boost::default_color_type> _color;
+    std::size_t _numNodes;
+    std::vector<NodeType> _sources;
+    std::vector<NodeType> _targets;
+    std::vector<Edge> _edgesData;
+    std::vector<bool> _isSource;
     const NodeType _S;  //< emptyness
     const NodeType _T;  //< fullness
 };
@@ -480,7 +514,7 @@ class GraphcutSeams
         return true;
     }
 
-    bool processInput(double& newCost, InputData& input)
+    BoundingBox getLocalBoundingBox(const InputData& input) const
     {
         // Get bounding box of input in panorama
         // Dilate to have some pixels outside of the input
@@ -489,6 +523,38 @@ class GraphcutSeams
         localBbox.clampTop();
         localBbox.clampBottom(_labels.Height() - 1);
 
+        return localBbox;
+    }
+
+    /**
+     * @brief Check if two local bounding boxes share pixels of the labels, taking the horizontal loop into account
+     */
+    bool overlapWithLoop(const BoundingBox& first, const BoundingBox& second) const
+    {
+        const int width = _labels.Width();
+        if (first.width >= width || second.width >= width)
+        {
+            return !first.intersectionWith(BoundingBox(0, second.top, width, second.height)).isEmpty();
+        }
+
+        for (int shift = -width; shift <= width; shift += width)
+        {
+            BoundingBox shifted = second;
+            shifted.left += shift;
+
+            if (!first.intersectionWith(shifted).isEmpty())
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    bool processInput(double& newCost, InputData& input)
+    {
+        const BoundingBox localBbox = getLocalBoundingBox(input);
+
         // Output must keep a margin also
         BoundingBox outputBbox = input.rect;
         outputBbox.left = input.rect.left - localBbox.left;
@@ -579,6 +645,45 @@ class GraphcutSeams
             costs[info.first] = std::numeric_limits<double>::max();
         }
 
+        // Inputs with disjoint local bounding boxes read and write disjoint parts of the labels.
+        // Group them greedily in batches which are processed in parallel.
+        std::vector<std::vector<InputData*>> batches;
+        std::vector<std::vector<BoundingBox>> batchesBbox;
+        for (auto& info : _inputs)
+        {
+            const BoundingBox localBbox = getLocalBoundingBox(info.second);
+
+            size_t batchId = 0;
+            for (; batchId < batches.size(); batchId++)
+            {
+                bool overlap = false;
+                for (const BoundingBox& other : batchesBbox[batchId])
+                {
+                    if (overlapWithLoop(localBbox, other))
+                    {
+                        overlap = true;
+                        break;
+                    }
+                }
+
+                if (!overlap)
+                {
+                    break;
+                }
+            }
+
+            if (batchId == batches.size())
+            {
+                batches.emplace_back();
+                batchesBbox.emplace_back();
+            }
+
+            batches[batchId].push_back(&info.second);
+            batchesBbox[batchId].push_back(localBbox);
+        }
+
+        ALICEVISION_LOG_INFO("GraphCut processing " << _inputs.size() << " inputs in " << batches.size() << " batches");
+
         for (int i = 0; i < 10; i++)
         {
             ALICEVISION_LOG_INFO("GraphCut processing iteration #" << i);
@@ -586,19 +691,33 @@ class GraphcutSeams
             // For each possible label, try to extends its domination on the label's world
             bool hasChange = false;
 
-            int pos = 0;
-            for (auto& info : _inputs)
+            for (const auto& batch : batches)
             {
-                double cost;
-                if (!processInput(cost, info.second))
+                std::vector<double> batchCosts(batch.size(), 0.0);
+                std::atomic<bool> success(true);
+
+#pragma omp parallel for schedule(dynamic)
+                for (int k = 0; k < batch.size(); k++)
+                {
+                    if (!processInput(batchCosts[k], *batch[k]))
+                    {
+                        success = false;
+                    }
+                }
+
+                if (!success)
                 {
                     return false;
                 }
 
-                if (costs[info.first] != cost)
+                for (int k = 0; k < batch.size(); k++)
                 {
-                    costs[info.first] = cost;
-                    hasChange = true;
+                    double& cost = costs[batch[k]->id];
+                    if (cost != batchCosts[k])
+                    {
+                        cost = batchCosts[k];
+                        hasChange = true;
+                    }
                 }
             }
 
@@ -611,7 +730,7 @@ class GraphcutSeams
         return true;
     }
 
-    double cost(const image::Image<IndexT> localLabels, const image::Image<PixelInfo>& input, IndexT currentLabel)
+    double cost(const image::Image<IndexT>& localLabels, const image::Image<PixelInfo>& input, IndexT currentLabel)
     {
         double cost = 0.0;
 
@@ -633,6 +752,10 @@ class GraphcutSeams
                 if (labely == UndefinedIndexT)
                     continue;
 
+                // No seam here, the cost is null
+                if (label == labelx && label == labely)
+                    continue;
+
                 image::RGBfColor CColorLC;
                 image::RGBfColor CColorLX;
                 image::RGBfColor CColorLY;
@@ -802,14 +925,16 @@ class GraphcutSeams
         }
 
         // The rectangle is a grid.
-        // However we want to ignore a lot of pixel.
-        // Let's create an index per valid pixels for graph cut reference
+        // However only the pixels seen by both alpha and an ennemy may change owner :
+        // pixels only seen by alpha are forced to alpha, pixels only seen by an ennemy are kept.
+        // Let's create an index per contested pixel for graph cut reference,
+        // so the graph size scales with the seams band and not with the image area.
         int count = 0;
         for (int y = 0; y < labels.Height(); y++)
         {
             for (int x = 0; x < labels.Width(); x++)
             {
-                if (mask(y, x) == 0)
+                if (mask(y, x) != 3)
                 {
                     continue;
                 }
@@ -819,157 +944,83 @@ class GraphcutSeams
             }
         }
 
-        // Create graph
-        MaxFlow_AdjList gc(count);
-        size_t countValid = 0;
-
-        for (int y = 0; y < labels.Height(); y++)
-        {
-            for (int x = 0; x < labels.Width(); x++)
-            {
-                // If this pixel is not valid, ignore
-                if (mask(y, x) == 0)
-                {
-                    continue;
-                }
-
-                // Get this pixel ID
-                int node_id = ids(y, x);
-
-                int ym1 = std::max(y - 1, 0);
-                int xm1 = std::max(x - 1, 0);
-                int yp1 = std::min(y + 1, labels.Height() - 1);
-                int xp1 = std::min(x + 1, labels.Width() - 1);
-
-                if (mask(y, x) == 1)
-                {
-                    // Only add nodes close to borders
-                    if (mask(ym1, xm1) == 1 && mask(ym1, x) == 1 && mask(ym1, xp1) == 1 && mask(y, xm1) == 1 && mask(y, xp1) == 1 &&
-                        mask(yp1, xm1) == 1 && mask(yp1, x) == 1 && mask(yp1, xp1) == 1)
-                    {
-                        continue;
-                    }
-
-                    // This pixel is only seen by alpha.
-                    // Enforce its domination by stating that removing this pixel
-                    // from alpha territoy is infinitly costly (impossible).
-                    gc.addNodeToSource(node_id, 100000);
-                }
-                else if (mask(y, x) == 2)
-                {
-                    // Only add nodes close to borders
-                    if (mask(ym1, xm1) == 2 && mask(ym1, x) == 2 && mask(ym1, xp1) == 2 && mask(y, xm1) == 2 && mask(y, xp1) == 2 &&
-                        mask(yp1, xm1) == 2 && mask(yp1, x) == 2 && mask(yp1, xp1) == 2)
-                    {
-                        continue;
-                    }
-
-                    // This pixel is only seen by an ennemy.
-                    // Enforce its domination by stating that removing this pixel
-                    // from ennemy territory is infinitly costly (impossible).
-                    gc.addNodeToSink(node_id, 100000);
-                }
-                else if (mask(y, x) == 3)
-                {
-                    // This pixel is seen by both alpha and enemies but is owned by ennemy.
-                    // Make sure that changing node owner will have no direct cost.
-                    // Connect it to both alpha and ennemy for the moment
-                    // (Graph cut will not allow a pixel to have both owners at the end).
-                    gc.addNodeToSource(node_id, 0);
-                    gc.addNodeToSink(node_id, 0);
-                    countValid++;
-                }
-            }
-        }
-
-        if (countValid == 0)
+        if (count == 0)
         {
             // We have no possibility for territory expansion
             // let's exit
             return true;
         }
 
-        // Loop over alpha bounding box.
-        // Let's define the transition cost.
         // When two neighboor pixels have different labels, there is a seam (border) cost.
-        // Graph cut will try to make sure the territory will have a minimal border cost
+        // Graph cut will try to make sure the territory will have a minimal border cost.
+        // A contested pixel is always seen by alpha and an ennemy, so is any of its contested or fixed neighboors.
+        auto seamCost = [&](int y1, int x1, int y2, int x2) {
+            float d1 = (color_label(y1, x1) - color_other(y1, x1)).norm();
+            float d2 = (color_label(y2, x2) - color_other(y2, x2)).norm();
+
+            d1 = std::min(2.0f, d1);
+            d2 = std::min(2.0f, d2);
+
+            return d1 * 100.0f + d2 * 100.0f + 1.0f;
+        };
+
+        // Create graph
+        MaxFlow_CSR gc(count);
 
         for (int y = 0; y < labels.Height(); y++)
         {
             for (int x = 0; x < labels.Width(); x++)
             {
-                if (mask(y, x) == 0)
+                if (mask(y, x) != 3)
                 {
                     continue;
                 }
 
                 int node_id = ids(y, x);
 
-                // Make sure it is possible to estimate this horizontal border
-                if (y < mask.Height() - 1)
-                {
-                    // Make sure the other pixel is owned by someone
-                    if (mask(y + 1, x))
-                    {
-                        int other_node_id = ids(y + 1, x);
-                        float w = 1000;
-
-                        if (((mask(y, x) & 1) && (mask(y + 1, x) & 2)) || ((mask(y, x) & 2) && (mask(y + 1, x) & 1)))
-                        {
-                            float d1 = (color_label(y, x) - color_other(y, x)).norm();
-                            float d2 = (color_label(y + 1, x) - color_other(y + 1, x)).norm();
-
-                            d1 = std::min(2.0f, d1);
-                            d2 = std::min(2.0f, d2);
+                // Seams with fixed neighboors are moved on the terminal edges :
+                // a neighboor owned by alpha costs if this pixel is left to the ennemy, and conversely.
+                float source = 0.0f;
+                float sink = 0.0f;
 
-                            w = (d1 + d2) * 100.0 + 1.0;
-                        }
+                const int neighboors[4][2] = {{y - 1, x}, {y + 1, x}, {y, x - 1}, {y, x + 1}};
+                for (const auto& neighboor : neighboors)
+                {
+                    const int ny = neighboor[0];
+                    const int nx = neighboor[1];
 
-                        gc.addEdge(node_id, other_node_id, w, w);
+                    if (ny < 0 || ny >= labels.Height() || nx < 0 || nx >= labels.Width())
+                    {
+                        continue;
                     }
-                }
 
-                if (x < mask.Width() - 1)
-                {
-                    if (mask(y, x + 1))
+                    if (mask(ny, nx) == 1)
                     {
-                        int other_node_id = ids(y, x + 1);
-                        float w = 1000;
-
-                        if (((mask(y, x) & 1) && (mask(y, x + 1) & 2)) || ((mask(y, x) & 2) && (mask(y, x + 1) & 1)))
-                        {
-                            float d1 = (color_label(y, x) - color_other(y, x)).norm();
-                            float d2 = (color_label(y, x + 1) - color_other(y, x + 1)).norm();
-
-                            d1 = std::min(2.0f, d1);
-                            d2 = std::min(2.0f, d2);
-
-                            w = (d1 + d2) * 100.0 + 1.0;
-                        }
-
-                        gc.addEdge(node_id, other_node_id, w, w);
+                        source += seamCost(y, x, ny, nx);
+                    }
+                    else if (mask(ny, nx) == 2)
+                    {
+                        sink += seamCost(y, x, ny, nx);
+                    }
+                    else if (mask(ny, nx) == 3 && (ny > y || nx > x))
+                    {
+                        const float w = seamCost(y, x, ny, nx);
+                        gc.addEdge(node_id, ids(ny, nx), w, w);
                     }
                 }
+
+                gc.addNode(node_id, source, sink);
             }
         }
 
         gc.compute();
 
-        int changeCount = 0;
         for (int y = 0; y < labels.Height(); y++)
         {
             for (int x = 0; x < labels.Width(); x++)
             {
-                IndexT label = labels(y, x);
-                int id = ids(y, x);
-
-                if (gc.isSource(id))
+                if (mask(y, x) == 1 || (mask(y, x) == 3 && gc.isSource(ids(y, x))))
                 {
-                    if (label != currentLabel)
-                    {
-                        changeCount++;
-                    }
-
                     labels(y, x) = currentLabel;
                 }
             }
@@ -15,9 +15,12 @@ namespace aliceVision {
 class LaplacianCompositer : public Compositer
 {
   public:
-    LaplacianCompositer(size_t outputWidth, size_t outputHeight, size_t scale)
+    /**
+     * @param[in] useGpu build and collapse the laplacian pyramids on the GPU (requires CUDA)
+     */
+    LaplacianCompositer(size_t outputWidth, size_t outputHeight, size_t scale, bool useGpu = false)
       : Compositer(outputWidth, outputHeight),
-        _pyramidPanorama(outputWidth, outputHeight, scale + 1),
+        _pyramidPanorama(outputWidth, outputHeight, scale + 1, useGpu),
         _bands(scale + 1)
     {}
 
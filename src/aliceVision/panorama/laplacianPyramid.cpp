@@ -10,12 +10,19 @@
 #include "gaussian.hpp"
 #include "compositer.hpp"
 
+#include <aliceVision/config.hpp>
+
+#if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_CUDA)
+    #include <aliceVision/panorama/cuda/deviceLaplacianPyramid.hpp>
+#endif
+
 namespace aliceVision {
 
-LaplacianPyramid::LaplacianPyramid(size_t base_width, size_t base_height, size_t max_levels)
+LaplacianPyramid::LaplacianPyramid(size_t base_width, size_t base_height, size_t max_levels, bool useGpu)
   : _baseWidth(base_width),
     _baseHeight(base_height),
-    _maxLevels(max_levels)
+    _maxLevels(max_levels),
+    _useGpu(useGpu)
 {
     omp_init_lock(&_merge_lock);
 }
@@ -60,11 +67,8 @@ bool LaplacianPyramid::apply(aliceVision::image::Image<image::RGBfColor>& source
     int offsetY = outputBoundingBox.top;
 
     image::Image<image::RGBfColor> currentColor(width, height, true, image::RGBfColor(0.0));
-    image::Image<image::RGBfColor> nextColor;
     image::Image<float> currentWeights(width, height, true, 0.0f);
-    image::Image<float> nextWeights;
     image::Image<float> currentMask(width, height, true, 0.0f);
-    image::Image<float> nextMask;
 
     for (int i = 0; i < source.Height(); i++)
     {
@@ -79,6 +83,99 @@ bool LaplacianPyramid::apply(aliceVision::image::Image<image::RGBfColor>& source
     mask = aliceVision::image::Image<float>();
     weights = aliceVision::image::Image<float>();
 
+    if (!decompose(currentColor, currentWeights, currentMask, offsetX, offsetY))
+    {
+        return false;
+    }
+
+    InputInfo iinfo;
+    iinfo.offsetX = offsetX;
+    iinfo.offsetY = offsetY;
+    iinfo.color = currentColor;
+    iinfo.mask = currentMask;
+    iinfo.weights = currentWeights;
+
+    omp_set_lock(&_merge_lock);
+    _inputInfos.push_back(iinfo);
+    omp_unset_lock(&_merge_lock);
+
+    return true;
+}
+
+bool LaplacianPyramid::decompose(image::Image<image::RGBfColor>& currentColor,
+                                 image::Image<float>& currentWeights,
+                                 image::Image<float>& currentMask,
+                                 int& offsetX,
+                                 int& offsetY)
+{
+#if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_CUDA)
+    if (_useGpu)
+    {
+        const int levelsCount = static_cast<int>(_levels.size());
+        const int width = currentColor.Width();
+        const int height = currentColor.Height();
+
+        std::vector<image::Image<image::RGBfColor>> bands(levelsCount - 1);
+        std::vector<image::Image<float>> bandWeights(levelsCount - 1);
+        std::vector<float*> bandsPtr(levelsCount - 1);
+        std::vector<float*> bandWeightsPtr(levelsCount - 1);
+        for (int l = 0; l < levelsCount - 1; l++)
+        {
+            bands[l].resize(width >> l, height >> l, false);
+            bandWeights[l].resize(width >> l, height >> l, false);
+            bandsPtr[l] = bands[l].data()->data();
+            bandWeightsPtr[l] = bandWeights[l].data();
+        }
+
+        const int coarseWidth = width >> (levelsCount - 1);
+        const int coarseHeight = height >> (levelsCount - 1);
+        image::Image<image::RGBfColor> coarseColor(coarseWidth, coarseHeight);
+        image::Image<float> coarseWeights(coarseWidth, coarseHeight);
+        image::Image<float> coarseMask(coarseWidth, coarseHeight);
+
+        cuda_laplacianDecompose(currentColor.data()->data(),
+                                currentWeights.data(),
+                                currentMask.data(),
+                                width,
+                                height,
+                                levelsCount,
+                                bandsPtr.data(),
+                                bandWeightsPtr.data(),
+                                coarseColor.data()->data(),
+                                coarseWeights.data(),
+                                coarseMask.data());
+
+        for (int l = 0; l < levelsCount - 1; l++)
+        {
+            // Merge this view with previous ones
+            omp_set_lock(&_merge_lock);
+            bool res = merge(bands[l], bandWeights[l], l, offsetX, offsetY);
+            omp_unset_lock(&_merge_lock);
+
+            if (!res)
+            {
+                return false;
+            }
+
+            offsetX = offsetX / 2;
+            offsetY = offsetY / 2;
+        }
+
+        currentColor = coarseColor;
+        currentWeights = coarseWeights;
+        currentMask = coarseMask;
+
+        return true;
+    }
+#endif
+
+    int width = currentColor.Width();
+    int height = currentColor.Height();
+
+    image::Image<image::RGBfColor> nextColor;
+    image::Image<float> nextWeights;
+    image::Image<float> nextMask;
+
     for (int l = 0; l < _levels.size() - 1; l++)
     {
         BoundingBox inputBbox;
@@ -224,17 +321,6 @@ bool LaplacianPyramid::apply(aliceVision::image::Image<image::RGBfColor>& source
         offsetY = offsetY / 2;
     }
 
-    InputInfo iinfo;
-    iinfo.offsetX = offsetX;
-    iinfo.offsetY = offsetY;
-    iinfo.color = currentColor;
-    iinfo.mask = currentMask;
-    iinfo.weights = currentWeights;
-
-    omp_set_lock(&_merge_lock);
-    _inputInfos.push_back(iinfo);
-    omp_unset_lock(&_merge_lock);
-
     return true;
 }
 
@@ -279,6 +365,62 @@ bool LaplacianPyramid::rebuild(image::Image<image::RGBAfColor>& output, const Bo
         }
     }
 
+    if (!collapse())
+    {
+        return false;
+    }
+
+    image::Image<image::RGBfColor>& level = _levels[0];
+    image::Image<float>& weight = _weights[0];
+    for (int i = 0; i < roi.height; i++)
+    {
+        int y = i + roi.top;
+
+        for (int j = 0; j < roi.width; j++)
+        {
+            int x = j + roi.left;
+
+            output(i, j).r() = level(y, x).r();
+            output(i, j).g() = level(y, x).g();
+            output(i, j).b() = level(y, x).b();
+
+            if (weight(y, x) < 1e-6)
+            {
+                output(i, j).a() = 0.0f;
+            }
+            else
+            {
+                output(i, j).a() = 1.0f;
+            }
+        }
+    }
+
+    return true;
+}
+
+bool LaplacianPyramid::collapse()
+{
+#if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_CUDA)
+    if (_useGpu)
+    {
+        const int levelsCount = static_cast<int>(_levels.size());
+        std::vector<float*> levelsPtr(levelsCount);
+        std::vector<const float*> weightsPtr(levelsCount);
+        std::vector<int> widths(levelsCount);
+        std::vector<int> heights(levelsCount);
+        for (int l = 0; l < levelsCount; l++)
+        {
+            levelsPtr[l] = _levels[l].data()->data();
+            weightsPtr[l] = _weights[l].data();
+            widths[l] = _levels[l].Width();
+            heights[l] = _levels[l].Height();
+        }
+
+        cuda_laplacianCollapse(levelsPtr.data(), weightsPtr.data(), widths.data(), heights.data(), levelsCount);
+        return true;
+    }
+#endif
+
     // We first want to compute the final pixels mean
     for (int l = 0; l < _levels.size(); l++)
     {
@@ -345,31 +487,6 @@ bool LaplacianPyramid::rebuild(image::Image<image::RGBAfColor>& output, const Bo
         removeNegativeValues(_levels[currentLevel]);
     }
 
-    image::Image<image::RGBfColor>& level = _levels[0];
-    image::Image<float>& weight = _weights[0];
-    for (int i = 0; i < roi.height; i++)
-    {
-        int y = i + roi.top;
-
-        for (int j = 0; j < roi.width; j++)
-        {
-            int x = j + roi.left;
-
-            output(i, j).r() = level(y, x).r();
-            output(i, j).g() = level(y, x).g();
-            output(i, j).b() = level(y, x).b();
-
-            if (weight(y, x) < 1e-6)
-            {
-                output(i, j).a() = 0.0f;
-            }
-            else
-            {
-                output(i, j).a() = 1.0f;
-            }
-        }
-    }
-
     return true;
 }
 
@@ -25,7 +25,10 @@ class LaplacianPyramid
     };
 
   public:
-    LaplacianPyramid(size_t base_width, size_t base_height, size_t max_levels);
+    /**
+     * @param[in] useGpu decompose the inputs and collapse the pyramid on the GPU (requires CUDA)
+     */
+    LaplacianPyramid(size_t base_width, size_t base_height, size_t max_levels, bool useGpu = false);
 
     virtual ~LaplacianPyramid();
 
@@ -45,10 +48,28 @@ class LaplacianPyramid
 
     bool rebuild(image::Image<image::RGBAfColor>& output, const BoundingBox& roi);
 
+  private:
+    /**
+     * @brief Split an input into band-pass levels merged in the pyramid
+     * @param[in,out] currentColor, currentWeights, currentMask the input, replaced by its coarsest level
+     * @param[in,out] offsetX, offsetY the input offset, replaced by the offset at the coarsest level
+     */
+    bool decompose(image::Image<image::RGBfColor>& currentColor,
+                   image::Image<float>& currentWeights,
+                   image::Image<float>& currentMask,
+                   int& offsetX,
+                   int& offsetY);
+
+    /**
+     * @brief Normalize the merged levels and collapse them into the first level
+     */
+    bool collapse();
+
   private:
     int _baseWidth;
     int _baseHeight;
     int _maxLevels;
+    bool _useGpu;
     omp_lock_t _merge_lock;
 
     std::vector<image::Image<image::RGBfColor>> _levels;
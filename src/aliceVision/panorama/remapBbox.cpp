@@ -6,6 +6,7 @@
 
 #include "remapBbox.hpp"
 #include "sphericalMapping.hpp"
+#include "coordinatesMap.hpp"
 
 namespace aliceVision {
 
@@ -433,4 +434,179 @@ bool computeCoarseBB(BoundingBox& coarse_bbox,
     return ret;
 }
 
+/**
+ * @brief Union of the bounding boxes of the valid pixels of a line of tiles
+ * @return true if at least one tile contains valid pixels
+ */
+bool unionValidTiles(BoundingBox& globalBbox,
+                     const std::vector<BoundingBox>& tiles,
+                     const std::pair<int, int>& panoramaSize,
+                     const geometry::Pose3& pose,
+                     const aliceVision::camera::IntrinsicBase& intrinsics)
+{
+    std::vector<BoundingBox> validBboxes(tiles.size());
+
+#pragma omp parallel for
+    for (int id = 0; id < tiles.size(); id++)
+    {
+        // Prepare coordinates map
+        CoordinatesMap map;
+        if (!map.build(panoramaSize, pose, intrinsics, tiles[id]))
+        {
+            continue;
+        }
+
+        validBboxes[id] = map.getBoundingBox();
+    }
+
+    // Ordered union, the result does not depend on the threads scheduling
+    bool found = false;
+    for (const BoundingBox& bbox : validBboxes)
+    {
+        if (!bbox.isEmpty())
+        {
+            globalBbox = globalBbox.unionWith(bbox);
+            found = true;
+        }
+    }
+
+    return found;
+}
+
+bool computeWarpedBoundingBoxes(std::vector<BoundingBox>& boxes,
+                                const std::pair<int, int>& panoramaSize,
+                                const geometry::Pose3& pose,
+                                const aliceVision::camera::IntrinsicBase& intrinsics,
+                                int tileSize)
+{
+    boxes.clear();
+
+    // Compute coarse bounding box to make computations faster
+    BoundingBox coarseBboxInitial;
+    if (!computeCoarseBB(coarseBboxInitial, panoramaSize, pose, intrinsics))
+    {
+        return false;
+    }
+
+    std::vector<BoundingBox> coarsesBbox;
+    if (coarseBboxInitial.width > coarseBboxInitial.height * 2.0)
+    {
+        const int count = int(double(coarseBboxInitial.width) / double(coarseBboxInitial.height));
+        const int width = coarseBboxInitial.width / count;
+
+        int pos = 0;
+        for (int id = 0; id < count; id++)
+        {
+            BoundingBox subCoarseBbox;
+            subCoarseBbox.left = coarseBboxInitial.left + pos;
+            subCoarseBbox.top = coarseBboxInitial.top;
+            subCoarseBbox.width = width;
+            subCoarseBbox.height = coarseBboxInitial.height;
+
+            coarsesBbox.push_back(subCoarseBbox);
+            pos += width;
+        }
+    }
+    else
+    {
+        coarsesBbox.push_back(coarseBboxInitial);
+    }
+
+    for (const BoundingBox& coarseBbox : coarsesBbox)
+    {
+        // round to the closest tiles
+        BoundingBox snappedCoarseBbox = coarseBbox;
+        snappedCoarseBbox.snapToGrid(tileSize);
+
+        auto getTile = [&](int x, int y) {
+            BoundingBox localBbox;
+            localBbox.left = x + snappedCoarseBbox.left;
+            localBbox.top = y + snappedCoarseBbox.top;
+            localBbox.width = tileSize;
+            localBbox.height = tileSize;
+
+            localBbox.clampRight(snappedCoarseBbox.getRight());
+            localBbox.clampBottom(snappedCoarseBbox.getBottom());
+
+            return localBbox;
+        };
+
+        // Initialize bouding box for image
+        BoundingBox globalBbox;
+
+        // Search for first non empty line of tiles starting from the top
+        for (int y = 0; y < snappedCoarseBbox.height; y += tileSize)
+        {
+            std::vector<BoundingBox> tiles;
+            for (int x = 0; x < snappedCoarseBbox.width; x += tileSize)
+            {
+                tiles.push_back(getTile(x, y));
+            }
+
+            if (unionValidTiles(globalBbox, tiles, panoramaSize, pose, intrinsics))
+            {
+                break;
+            }
+        }
+
+        // Search for first non empty line of tiles starting from the bottom
+        for (int y = snappedCoarseBbox.height - 1; y >= 0; y -= tileSize)
+        {
+            std::vector<BoundingBox> tiles;
+            for (int x = 0; x < snappedCoarseBbox.width; x += tileSize)
+            {
+                tiles.push_back(getTile(x, y));
+            }
+
+            if (unionValidTiles(globalBbox, tiles, panoramaSize, pose, intrinsics))
+            {
+                break;
+            }
+        }
+
+        // Search for first non empty column of tiles starting from the left
+        for (int x = 0; x < snappedCoarseBbox.width; x += tileSize)
+        {
+            std::vector<BoundingBox> tiles;
+            for (int y = 0; y < snappedCoarseBbox.height; y += tileSize)
+            {
+                tiles.push_back(getTile(x, y));
+            }
+
+            if (unionValidTiles(globalBbox, tiles, panoramaSize, pose, intrinsics))
+            {
+                break;
+            }
+        }
+
+        // Search for first non empty column of tiles starting from the right
+        for (int x = snappedCoarseBbox.width - 1; x >= 0; x -= tileSize)
+        {
+            std::vector<BoundingBox> tiles;
+            for (int y = 0; y < snappedCoarseBbox.height; y += tileSize)
+            {
+                tiles.push_back(getTile(x, y));
+            }
+
+            if (unionValidTiles(globalBbox, tiles, panoramaSize, pose, intrinsics))
+            {
+                break;
+            }
+        }
+
+        // Rare case ... When all boxes valid are after the loop
+        if (globalBbox.left >= panoramaSize.first)
+        {
+            globalBbox.left -= panoramaSize.first;
+        }
+
+        globalBbox.width = std::min(globalBbox.width, panoramaSize.first);
+        globalBbox.height = std::min(globalBbox.height, panoramaSize.second);
+
+        boxes.push_back(globalBbox);
+    }
+
+    return true;
+}
+
 }  // namespace aliceVision
@@ -12,6 +12,8 @@
 
 #include "boundingBox.hpp"
 
+#include <vector>
+
 namespace aliceVision {
 
 bool computeCoarseBB(BoundingBox& coarse_bbox,
@@ -19,4 +21,21 @@ bool computeCoarseBB(BoundingBox& coarse_bbox,
                      const geometry::Pose3& pose,
                      const aliceVision::camera::IntrinsicBase& intrinsics);
 
-}
\ No newline at end of file
+/**
+ * @brief Compute the bounding boxes of the warped images of a view.
+ *        Very wide views are split in several boxes, each box is reduced to the pixels seen by the camera.
+ *        The result is deterministic, all the steps using the warped images of a view share the same boxes.
+ * @param[out] boxes the bounding boxes in the panorama, one per warped image
+ * @param[in] panoramaSize the panorama size
+ * @param[in] pose the camera pose
+ * @param[in] intrinsics the camera intrinsics
+ * @param[in] tileSize the size of the tiles of the warped images
+ * @return false if the view is not visible in the panorama
+ */
+bool computeWarpedBoundingBoxes(std::vector<BoundingBox>& boxes,
+                                const std::pair<int, int>& panoramaSize,
+                                const geometry::Pose3& pose,
+                                const aliceVision::camera::IntrinsicBase& intrinsics,
+                                int tileSize);
+
+}  // namespace aliceVision
@@ -442,9 +442,8 @@ bool HierarchicalGraphcutSeams::process()
         }
         else
         {
-            double sw = double(0.2 * w);
-            double sh = double(0.2 * h);
-            _graphcuts[level].setMaximalDistance(sqrt(sw * sw + sh * sh));
+            // The coarser level already solved the seams, only refine them in a narrow band
+            _graphcuts[level].setMaximalDistance(_refinementBandWidth);
         }
 
         if (!_graphcuts[level].process())
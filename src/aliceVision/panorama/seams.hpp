@@ -83,6 +83,9 @@ class HierarchicalGraphcutSeams
     size_t _countLevels;
     size_t _outputWidth;
     size_t _outputHeight;
+
+    /// distance to the seams (in pixels) where the labels may change on the levels refined from a coarser one
+    int _refinementBandWidth = 16;
 };
 
 }  // namespace aliceVision
\ No newline at end of file
@@ -5,6 +5,7 @@
 // You can obtain one at https://mozilla.org/MPL/2.0/.
 
 #include "warper.hpp"
+#include "distance.hpp"
 #include <aliceVision/half.hpp>
 
 namespace aliceVision {
@@ -152,4 +153,92 @@ bool GaussianWarper::warp(const CoordinatesMap& map, const GaussianPyramidNoMask
     return true;
 }
 
+#if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_CUDA)
+bool GaussianWarper::warp(const CoordinatesMap& map, const DeviceGaussianPyramid& pyramid, bool clamp)
+{
+    /**
+     * Copy additional info from map
+     */
+    _offset_x = map.getOffsetX();
+    _offset_y = map.getOffsetY();
+    _mask = map.getMask();
+
+    pyramid.warp(_color, map.getCoordinates(), _mask, clamp);
+
+    return true;
+}
+#endif
+
+bool warpRegion(image::Image<image::RGBfColor>& color,
+                image::Image<unsigned char>& mask,
+                image::Image<float>& weights,
+                const GaussianPyramidNoMask* pyramid,
+                const BoundingBox& region,
+                const std::pair<int, int>& panoramaSize,
+                const geometry::Pose3& pose,
+                const camera::IntrinsicBase& intrinsics,
+                int tileSize,
+                bool clamp)
+{
+    if (pyramid)
+    {
+        color = image::Image<image::RGBfColor>(region.width, region.height, true, image::RGBfColor(0.0f));
+    }
+    else
+    {
+        color = image::Image<image::RGBfColor>();
+    }
+    mask = image::Image<unsigned char>(region.width, region.height, true, 0);
+    weights = image::Image<float>(region.width, region.height, true, 0.0f);
+
+    // Full tiles, the borders of the region are warped as in the tiled images of panoramaWarping
+    std::vector<BoundingBox> tiles;
+    for (int y = 0; y < region.height; y += tileSize)
+    {
+        for (int x = 0; x < region.width; x += tileSize)
+        {
+            tiles.emplace_back(region.left + x, region.top + y, tileSize, tileSize);
+        }
+    }
+
+#pragma omp parallel for
+    for (int id = 0; id < tiles.size(); id++)
+    {
+        const BoundingBox& tile = tiles[id];
+
+        CoordinatesMap map;
+        if (!map.build(panoramaSize, pose, intrinsics, tile))
+        {
+            continue;
+        }
+
+        GaussianWarper warper;
+        if (pyramid && !warper.warp(map, *pyramid, clamp))
+        {
+            continue;
+        }
+
+        image::Image<float> tileWeights;
+        if (!distanceToCenter(tileWeights, map, intrinsics.w(), intrinsics.h()))
+        {
+            continue;
+        }
+
+        // Tiles do not overlap, each thread writes its own block
+        const int x = tile.left - region.left;
+        const int y = tile.top - region.top;
+        const int width = std::min(tileSize, region.width - x);
+        const int height = std::min(tileSize, region.height - y);
+
+        if (pyramid)
+        {
+            color.block(y, x, height, width) = warper.getColor().block(0, 0, height, width);
+        }
+        mask.block(y, x, height, width) = map.getMask().block(0, 0, height, width);
+        weights.block(y, x, height, width) = tileWeights.block(0, 0, height, width);
+    }
+
+    return true;
+}
+
 }  // namespace aliceVision
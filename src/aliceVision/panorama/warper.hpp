@@ -9,6 +9,12 @@
 #include "coordinatesMap.hpp"
 #include "gaussian.hpp"
 
+#include <aliceVision/config.hpp>
+
+#if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_CUDA)
+    #include <aliceVision/panorama/cuda/DeviceGaussianPyramid.hpp>
+#endif
+
 namespace aliceVision {
 
 class Warper
@@ -36,6 +42,37 @@ class GaussianWarper : public Warper
 {
   public:
     virtual bool warp(const CoordinatesMap& map, const GaussianPyramidNoMask& pyramid, bool clamp);
+
+#if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_CUDA)
+    /**
+     * @brief Same warp, the pyramid is sampled on the GPU
+     */
+    bool warp(const CoordinatesMap& map, const DeviceGaussianPyramid& pyramid, bool clamp);
+#endif
 };
 
-}  // namespace aliceVision
\ No newline at end of file
+/**
+ * @brief Warp a region of the panorama in memory, tile by tile with the same tiles as panoramaWarping
+ * @param[out] color the warped colors (region size), left empty if no pyramid is given
+ * @param[out] mask the pixels seen by the camera (region size)
+ * @param[out] weights the distance to the image center of each pixel (region size)
+ * @param[in] pyramid the source image pyramid, nullptr to only compute the mask and the weights
+ * @param[in] region the region in the panorama
+ * @param[in] panoramaSize the panorama size
+ * @param[in] pose the camera pose
+ * @param[in] intrinsics the camera intrinsics
+ * @param[in] tileSize the size of the tiles
+ * @param[in] clamp clamp the colors to the half float range
+ */
+bool warpRegion(image::Image<image::RGBfColor>& color,
+                image::Image<unsigned char>& mask,
+                image::Image<float>& weights,
+                const GaussianPyramidNoMask* pyramid,
+                const BoundingBox& region,
+                const std::pair<int, int>& panoramaSize,
+                const geometry::Pose3& pose,
+                const camera::IntrinsicBase& intrinsics,
+                int tileSize,
+                bool clamp);
+
+}  // namespace aliceVision
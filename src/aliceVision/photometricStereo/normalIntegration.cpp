@@ -10,11 +10,13 @@
 
 #include <aliceVision/numeric/projection.hpp>
 #include <aliceVision/numeric/numeric.hpp>
+#include <aliceVision/alicevision_omp.hpp>
 
 #include <iostream>
 #include <sstream>
 #include <fstream>
 #include <algorithm>
+#include <cstdint>
 #include <math.h>
 
 #include <Eigen/Dense>
@@ -32,6 +34,301 @@
 namespace aliceVision {
 namespace photometricStereo {
 
+namespace {
+
+/// maximum number of iterations of the conjugate gradient of the masked integration
+constexpr int maxIntegrationIterations = 5000;
+/// relative residual of the conjugate gradient at convergence
+constexpr float integrationTolerance = 1e-4f;
+/// weight of the prior on the pixels with a known value
+constexpr float priorWeight = 1.0f;
+
+/// a 1x1 mask means that all the pixels are used
+inline bool isInMask(const image::Image<float>& mask, int i, int j)
+{
+    return (mask.rows() == 1 && mask.cols() == 1) || mask(i, j) > 0.7;
+}
+
+/// true if some pixels are outside the mask
+bool hasHoles(const image::Image<float>& mask)
+{
+    if (mask.rows() == 1 && mask.cols() == 1)
+        return false;
+    return (mask.array() <= 0.7f).any();
+}
+
+/**
+ * @brief Solve the Poisson equation with Neumann boundary conditions on the whole image, with the DCT.
+ * @param[in] p, q the gradients along the columns and the rows
+ * @param[out] z the integrated values, up to a constant
+ */
+void solvePoissonDCT(const Eigen::MatrixXf& p, const Eigen::MatrixXf& q, Eigen::MatrixXf& z)
+{
+    const int nbRows = p.rows();
+    const int nbCols = p.cols();
+
+    // cv::dct only supports even sizes: replicate the last row / column of the gradients if needed
+    const int nbRowsPad = nbRows + nbRows % 2;
+    const int nbColsPad = nbCols + nbCols % 2;
+
+    Eigen::MatrixXf pPad(nbRowsPad, nbColsPad);
+    Eigen::MatrixXf qPad(nbRowsPad, nbColsPad);
+    pPad.topLeftCorner(nbRows, nbCols) = p;
+    qPad.topLeftCorner(nbRows, nbCols) = q;
+    if (nbRowsPad != nbRows)
+    {
+        pPad.row(nbRows).head(nbCols) = p.row(nbRows - 1);
+        qPad.row(nbRows).head(nbCols) = q.row(nbRows - 1);
+    }
+    if (nbColsPad != nbCols)
+    {
+        pPad.col(nbCols) = pPad.col(nbCols - 1);
+        qPad.col(nbCols) = qPad.col(nbCols - 1);
+    }
+
+    // Prepare normal integration
+    Eigen::MatrixXf f(nbRowsPad, nbColsPad);
+    getDivergenceField(pPad, qPad, f);
+    setBoundaryConditions(pPad, qPad, f);
+
+    // Cosine transform of f
+    cv::Mat f_openCV;
+    cv::eigen2cv(f, f_openCV);
+    cv::Mat fcos;
+    cv::dct(f_openCV, fcos);
+
+    // Eigenvalues of the Laplacian, separable along the rows and the columns
+    std::vector<double> rowsEigenValues(nbRowsPad);
+    std::vector<double> colsEigenValues(nbColsPad);
+    for (int i = 0; i < nbRowsPad; ++i)
+        rowsEigenValues[i] = 4 * std::pow(std::sin(0.5 * M_PI * i / nbRowsPad), 2);
+    for (int j = 0; j < nbColsPad; ++j)
+        colsEigenValues[j] = 4 * std::pow(std::sin(0.5 * M_PI * j / nbColsPad), 2);
+
+    // Cosine transform of z
+#pragma omp parallel for
+    for (int i = 0; i < nbRowsPad; ++i)
+    {
+        float* row = fcos.ptr<float>(i);
+        for (int j = 0; j < nbColsPad; ++j)
+            row[j] = static_cast<float>(row[j] / std::max(rowsEigenValues[i] + colsEigenValues[j], 0.0001));
+    }
+
+    // Inverse cosine transform
+    cv::Mat z_openCV;
+    cv::idct(fcos, z_openCV);
+
+    Eigen::MatrixXf zPad;
+    cv::cv2eigen(z_openCV, zPad);
+    z = zPad.topLeftCorner(nbRows, nbCols);
+}
+
+/**
+ * @brief Least-squares integration of the gradients on the pixels of the mask, with an optional prior.
+ *
+ * Minimizes the sum over the pairs of neighbor pixels (k, l) of the mask of (z_l - z_k - g_kl)^2,
+ * with g_kl the mean gradient of the two pixels, plus the sum over the pixels of w_k (z_k - z0_k)^2.
+ * The normal equations are solved with a matrix-free Jacobi preconditioned conjugate gradient, multithreaded.
+ *
+ * @param[in] p, q the gradients along the columns and the rows
+ * @param[in] mask the pixels to integrate
+ * @param[in] z0 the prior values
+ * @param[in] w the weight of the prior of each pixel
+ * @param[in,out] z the initial guess, then the integrated values
+ * @return the number of iterations
+ */
+int solveMaskedPoisson(const Eigen::MatrixXf& p,
+                       const Eigen::MatrixXf& q,
+                       const image::Image<float>& mask,
+                       const Eigen::MatrixXf& z0,
+                       const Eigen::MatrixXf& w,
+                       Eigen::MatrixXf& z)
+{
+    const int nbRows = p.rows();
+    const int nbCols = p.cols();
+    const std::size_t nbPixels = static_cast<std::size_t>(nbRows) * nbCols;
+
+    const auto inMask = [&](int i, int j) { return i >= 0 && i < nbRows && j >= 0 && j < nbCols && isInMask(mask, i, j); };
+
+    // Right hand side and inverse of the diagonal of the normal equations
+    Eigen::MatrixXf b = Eigen::MatrixXf::Zero(nbRows, nbCols);
+    Eigen::MatrixXf invDiag = Eigen::MatrixXf::Zero(nbRows, nbCols);
+
+#pragma omp parallel for
+    for (int j = 0; j < nbCols; ++j)
+    {
+        for (int i = 0; i < nbRows; ++i)
+        {
+            if (!inMask(i, j))
+                continue;
+
+            float bk = w(i, j) * z0(i, j);
+            float diag = w(i, j);
+            // edges to the right and below start at this pixel, edges from the left and above end at it
+            if (inMask(i, j + 1))
+            {
+                bk -= 0.5f * (p(i, j) + p(i, j + 1));
+                diag += 1.f;
+            }
+            if (inMask(i + 1, j))
+            {
+                bk -= 0.5f * (q(i, j) + q(i + 1, j));
+                diag += 1.f;
+            }
+            if (inMask(i, j - 1))
+            {
+                bk += 0.5f * (p(i, j - 1) + p(i, j));
+                diag += 1.f;
+            }
+            if (inMask(i - 1, j))
+            {
+                bk += 0.5f * (q(i - 1, j) + q(i, j));
+                diag += 1.f;
+            }
+            b(i, j) = bk;
+            // isolated pixels without prior are not modified
+            invDiag(i, j) = diag > 0.f ? 1.f / diag : 0.f;
+        }
+    }
+
+    // out = A * x, with A the graph Laplacian of the mask plus the prior weights
+    const auto applyA = [&](const Eigen::MatrixXf& x, Eigen::MatrixXf& out) {
+#pragma omp parallel for
+        for (int j = 0; j < nbCols; ++j)
+        {
+            for (int i = 0; i < nbRows; ++i)
+            {
+                if (!inMask(i, j))
+                {
+                    out(i, j) = 0.f;
+                    continue;
+                }
+                const float xk = x(i, j);
+                float v = w(i, j) * xk;
+                if (inMask(i, j + 1))
+                    v += xk - x(i, j + 1);
+                if (inMask(i + 1, j))
+                    v += xk - x(i + 1, j);
+                if (inMask(i, j - 1))
+                    v += xk - x(i, j - 1);
+                if (inMask(i - 1, j))
+                    v += xk - x(i - 1, j);
+                out(i, j) = v;
+            }
+        }
+    };
+
+    const double bNorm = b.norm();
+    if (bNorm == 0.0)
+    {
+        ALICEVISION_LOG_INFO("Normal integration: null gradients, nothing to integrate.");
+        return 0;
+    }
+
+    Eigen::MatrixXf r(nbRows, nbCols);
+    Eigen::MatrixXf d(nbRows, nbCols);
+    Eigen::MatrixXf Ad(nbRows, nbCols);
+
+    applyA(z, Ad);
+    r = b - Ad;
+    d = invDiag.cwiseProduct(r);
+    double rs = r.cwiseProduct(d).sum();
+
+    float* zData = z.data();
+    float* rData = r.data();
+    float* dData = d.data();
+    const float* AdData = Ad.data();
+    const float* invDiagData = invDiag.data();
+
+    int k = 0;
+    for (; k < maxIntegrationIterations && rs > 0.0; ++k)
+    {
+        applyA(d, Ad);
+
+        double dAd = 0.0;
+#pragma omp parallel for reduction(+ : dAd)
+        for (std::int64_t n = 0; n < static_cast<std::int64_t>(nbPixels); ++n)
+            dAd += static_cast<double>(dData[n]) * AdData[n];
+        if (dAd <= 0.0)
+            break;
+        const float alpha = static_cast<float>(rs / dAd);
+
+        // update of the solution and of the residual, then preconditioned residual
+        double rsNew = 0.0;
+        double rNorm2 = 0.0;
+#pragma omp parallel for reduction(+ : rsNew, rNorm2)
+        for (std::int64_t n = 0; n < static_cast<std::int64_t>(nbPixels); ++n)
+        {
+            zData[n] += alpha * dData[n];
+            rData[n] -= alpha * AdData[n];
+            rsNew += static_cast<double>(rData[n]) * rData[n] * invDiagData[n];
+            rNorm2 += static_cast<double>(rData[n]) * rData[n];
+        }
+
+        if (std::sqrt(rNorm2) < integrationTolerance * bNorm)
+        {
+            ++k;
+            break;
+        }
+
+        const float beta = static_cast<float>(rsNew / rs);
+        rs = rsNew;
+#pragma omp parallel for
+        for (std::int64_t n = 0; n < static_cast<std::int64_t>(nbPixels); ++n)
+            dData[n] = invDiagData[n] * rData[n] + beta * dData[n];
+    }
+
+    ALICEVISION_LOG_INFO("Normal integration: " << k << " conjugate gradient iteration(s).");
+    return k;
+}
+
+/**
+ * @brief Depth map from the integrated values, in the pixels of the mask, relative to the center of the image.
+ * Since we are not in a MV context, we can change the position of our depthmap. We can then get away from negative values.
+ */
+void setRelativeDepth(const Eigen::MatrixXf& z, bool perspective, const Eigen::Matrix3f& K, const image::Image<float>& mask, image::Image<float>& depth)
+{
+    const int nbRows = z.rows();
+    const int nbCols = z.cols();
+    depth.resize(nbCols, nbRows, false);
+
+    const auto toDepth = [perspective](float v) { return perspective ? -std::exp(v) : v; };
+    const float centerDepth = toDepth(z(nbRows / 2, nbCols / 2));
+
+#pragma omp parallel for
+    for (int j = 0; j < nbCols; ++j)
+    {
+        for (int i = 0; i < nbRows; ++i)
+        {
+            if (isInMask(mask, i, j))
+            {
+                depth(i, j) = toDepth(z(i, j)) - centerDepth + 10 * K(0, 0);
+            }
+            else
+            {
+                depth(i, j) = -1.0;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Integrate the normal map with the DCT solver, or with the masked solver if some pixels are outside the mask.
+ */
+void integrateNormals(const image::Image<image::RGBfColor>& normals,
+                      image::Image<float>& depth,
+                      bool perspective,
+                      const Eigen::Matrix3f& K,
+                      const image::Image<float>& normalsMask)
+{
+    if (hasHoles(normalsMask))
+        smoothIntegration(normals, depth, perspective, K, normalsMask, image::Image<float>(), image::Image<float>());
+    else
+        DCTIntegration(normals, depth, perspective, K, normalsMask);
+}
+
+}  // namespace
+
 void normalIntegration(const std::string& inputPath, const bool& perspective, const int& downscale, const std::string& outputFolder)
 {
     std::string normalMapPath = inputPath + "/normals.png";
@@ -67,7 +364,7 @@ void normalIntegration(const std::string& inputPath, const bool& perspective, co
 
     image::Image<float> depthMap(nbCols, nbRows);
     image::Image<float> distanceMap(nbCols, nbRows);
-    DCTIntegration(normalsImPNG2, depthMap, perspective, K, normalsMask);
+    integrateNormals(normalsImPNG2, depthMap, perspective, K, normalsMask);
 
     // AliceVision uses distance-to-origin convention
     convertZtoDistance(depthMap, distanceMap, K);
@@ -176,7 +473,7 @@ void normalIntegration(const sfmData::SfMData& sfmData,
             image::Image<float> depthMap;
 
             aliceVision::image::Image<float> distanceMap;
-            DCTIntegration(normalsImPNG2, depthMap, perspective, K, normalsMask);
+            integrateNormals(normalsImPNG2, depthMap, perspective, K, normalsMask);
             image::Image<float> z0(nbCols, nbRows);
             image::Image<float> maskZ0(nbCols, nbRows);
             getZ0FromLandmarks(sfmData, z0, maskZ0, viewId, normalsMask);
@@ -262,7 +559,7 @@ void normalIntegration(const sfmData::SfMData& sfmData,
 
         // Main fonction
         image::Image<float> depthMap(nbCols, nbRows);
-        DCTIntegration(normalsImPNG2, depthMap, perspective, K, normalsMask);
+        integrateNormals(normalsImPNG2, depthMap, perspective, K, normalsMask);
 
         // AliceVision uses distance-to-origin convention
         image::Image<float> distanceMap(nbCols, nbRows);
@@ -324,76 +621,13 @@ void DCTIntegration(const image::Image<image::RGBfColor>& normals,
     Eigen::MatrixXf p(nbRows, nbCols);
     Eigen::MatrixXf q(nbRows, nbCols);
 
-    Eigen::MatrixXf f(nbRows, nbCols);
-
     // Prepare normal integration
     normal2PQ(normals, p, q, perspective, K, normalsMask);
-    getDivergenceField(p, q, f);
-    setBoundaryConditions(p, q, f);
-
-    // Convert f to OpenCV matrix
-    cv::Mat f_openCV(nbRows, nbCols, CV_32FC1);
-    cv::eigen2cv(f, f_openCV);
 
-    // Cosine transform of f
-    cv::Mat fcos(nbRows, nbCols, CV_32FC1);
-    cv::dct(f_openCV, fcos);
-
-    // Cosine transform of z
-    cv::Mat z_bar_bar(nbRows, nbCols, CV_32FC1);
-
-    for (int j = 0; j < nbCols; j++)
-    {
-        for (int i = 0; i < nbRows; i++)
-        {
-            double denom = 4 * (pow(sin(0.5 * M_PI * j / nbCols), 2) + pow(sin(0.5 * M_PI * i / nbRows), 2));
-            denom = std::max(denom, 0.0001);
-            z_bar_bar.at<float>(i, j) = fcos.at<float>(i, j) / denom;
-        }
-    }
-
-    // Inverse cosine transform
-    cv::Mat z(nbRows, nbCols, CV_32FC1);
-    cv::idct(z_bar_bar, z);
+    Eigen::MatrixXf z;
+    solvePoissonDCT(p, q, z);
 
-    for (int j = 0; j < nbCols; ++j)
-    {
-        for (int i = 0; i < nbRows; ++i)
-        {
-            if (normalsMask(i, j) > 0.7)
-            {
-                if (perspective)
-                {
-                    depth(i, j) = -std::exp(z.at<float>(i, j));
-                }
-                else
-                {
-                    depth(i, j) = z.at<float>(i, j);
-                }
-            }
-            else
-            {
-                depth(i, j) = nanf("1");
-            }
-        }
-    }
-
-    // Since we are not in a MV context, we can change the position of our depthmap
-    // We can then get away from negative values
-    for (int j = 0; j < nbCols; ++j)
-    {
-        for (int i = 0; i < nbRows; ++i)
-        {
-            if (normalsMask(i, j) > 0.7)
-            {
-                depth(i, j) = depth(i, j) - depth(floor(nbRows / 2), floor(nbCols / 2)) + 10 * K(0, 0);
-            }
-            else
-            {
-                depth(i, j) = -1.0;
-            }
-        }
-    }
+    setRelativeDepth(z, perspective, K, normalsMask, depth);
 }
 
 void normal2PQ(const image::Image<image::RGBfColor>& normals,
@@ -409,9 +643,10 @@ void normal2PQ(const image::Image<image::RGBfColor>& normals,
 
     bool hasMask = !((normalsMask.rows() == 1) && (normalsMask.cols() == 1));
 
-    for (size_t j = 0; j < p.cols(); ++j)
+#pragma omp parallel for
+    for (int j = 0; j < p.cols(); ++j)
     {
-        for (size_t i = 0; i < p.rows(); ++i)
+        for (int i = 0; i < p.rows(); ++i)
         {
             normalsX(i, j) = normals(i, j)(0);
             normalsY(i, j) = normals(i, j)(1);
@@ -423,11 +658,12 @@ void normal2PQ(const image::Image<image::RGBfColor>& normals,
     {
         float f = (K(0, 0) + K(1, 1)) / 2;
 
-        for (size_t j = 0; j < p.cols(); ++j)
+#pragma omp parallel for
+        for (int j = 0; j < p.cols(); ++j)
         {
             float u = j - K(0, 2);
 
-            for (size_t i = 0; i < p.rows(); ++i)
+            for (int i = 0; i < p.rows(); ++i)
             {
                 float v = i - K(1, 2);
 
@@ -447,9 +683,10 @@ void normal2PQ(const image::Image<image::RGBfColor>& normals,
     }
     else
     {
-        for (size_t j = 0; j < p.cols(); ++j)
+#pragma omp parallel for
+        for (int j = 0; j < p.cols(); ++j)
         {
-            for (size_t i = 0; i < p.rows(); ++i)
+            for (int i = 0; i < p.rows(); ++i)
             {
                 if ((normalsZ(i, j) == 0) || (hasMask && (normalsMask(i, j) == 0)))
                 {
@@ -597,7 +834,51 @@ void smoothIntegration(const image::Image<image::RGBfColor>& normals,
                        const image::Image<float>& z0,
                        const image::Image<float>& maskZ0)
 {
-    std::cout << "WIP" << std::endl;
+    const int nbCols = normals.cols();
+    const int nbRows = normals.rows();
+
+    Eigen::MatrixXf p(nbRows, nbCols);
+    Eigen::MatrixXf q(nbRows, nbCols);
+    normal2PQ(normals, p, q, perspective, K, mask);
+
+    // Prior on the integrated values (depth, or log-depth in the perspective case)
+    const bool hasPrior = (z0.rows() == nbRows) && (z0.cols() == nbCols) && (maskZ0.rows() == nbRows) && (maskZ0.cols() == nbCols);
+    Eigen::MatrixXf w = Eigen::MatrixXf::Zero(nbRows, nbCols);
+    Eigen::MatrixXf zPrior = Eigen::MatrixXf::Zero(nbRows, nbCols);
+    if (hasPrior)
+    {
+        w = priorWeight * (maskZ0.array() > 0.f).cast<float>();
+        zPrior = z0;
+    }
+
+    // the DCT solution on the whole image gives the low frequencies, the conjugate gradient starts from it
+    Eigen::MatrixXf z;
+    solvePoissonDCT(p, q, z);
+
+    const double priorSum = w.sum();
+    if (priorSum > 0.0)
+    {
+        const float offset = static_cast<float>((w.array() * (zPrior - z).array()).sum() / priorSum);
+        z.array() += offset;
+    }
+
+    solveMaskedPoisson(p, q, mask, zPrior, w, z);
+
+    if (priorSum > 0.0)
+    {
+        // absolute depth
+        depth.resize(nbCols, nbRows, false);
+#pragma omp parallel for
+        for (int j = 0; j < nbCols; ++j)
+        {
+            for (int i = 0; i < nbRows; ++i)
+                depth(i, j) = isInMask(mask, i, j) ? (perspective ? std::exp(z(i, j)) : z(i, j)) : -1.0f;
+        }
+    }
+    else
+    {
+        setRelativeDepth(z, perspective, K, mask, depth);
+    }
 }
 
 void convertZtoDistance(const aliceVision::image::Image<float>& zMap, aliceVision::image::Image<float>& distanceMap, const Eigen::Matrix3f& K)
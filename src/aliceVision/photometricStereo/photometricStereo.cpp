@@ -10,6 +10,8 @@
 #include <aliceVision/image/all.hpp>
 #include <aliceVision/image/io.hpp>
 #include <aliceVision/image/imageAlgo.hpp>
+#include <aliceVision/numeric/numeric.hpp>
+#include <aliceVision/alicevision_omp.hpp>
 
 // Eigen
 #include <Eigen/Dense>
@@ -27,6 +29,13 @@ namespace fs = boost::filesystem;
 namespace aliceVision {
 namespace photometricStereo {
 
+namespace {
+
+/// number of pixels of the batches of the robust solve
+constexpr int robustBatchSize = 4096;
+
+}  // namespace
+
 void photometricStereo(const std::string& inputPath,
                        const std::string& lightData,
                        const std::string& outputPath,
@@ -324,50 +333,29 @@ void photometricStereo(const std::vector<std::string>& imageList,
         }
     }
 
-    // Tiling
-    int auxMaskSize = maskSize;
-    int numberOfPixels = auxMaskSize * imageList.size() * 3;
-    int numberOfMasks = 1;
-
-    while (numberOfPixels > sizeMax)
-    {
-        numberOfMasks = numberOfMasks * 2;
-        auxMaskSize = floor(auxMaskSize / 4);
-        numberOfPixels = auxMaskSize * imageList.size() * 3;
-    }
+    // Tiling: the pictures are read tile by tile to bound the memory usage
+    const std::size_t maxTileSize = std::max<std::size_t>(1, static_cast<std::size_t>(sizeMax / (3 * imageList.size())));
+    const std::size_t numberOfMasks = std::max<std::size_t>(1, divideRoundUp(maskSize, maxTileSize));
+    const std::size_t tileSize = divideRoundUp(maskSize, numberOfMasks);
 
     Eigen::MatrixXf normalsVect = Eigen::MatrixXf::Zero(lightMat.cols(), pictRows * pictCols);
     Eigen::MatrixXf albedoVect = Eigen::MatrixXf::Zero(3, pictRows * pictCols);
 
-    int remainingPixels = maskSize;
+    // the least-squares solutions of all the pixels share the pseudo-inverse of the light matrix
+    Eigen::MatrixXf lightMatPinv;
+    computePseudoInverse(lightMat, lightMatPinv);
+
     std::vector<int> currentMaskIndices;
 
-    for (int currentMaskIndex = 0; currentMaskIndex < numberOfMasks; ++currentMaskIndex)
+    for (std::size_t currentMaskIndex = 0; currentMaskIndex < numberOfMasks; ++currentMaskIndex)
     {
-        int currentMaskSize;
+        const std::size_t firstPixel = currentMaskIndex * tileSize;
+        if (firstPixel >= maskSize)
+            break;
+        const int currentMaskSize = static_cast<int>(std::min(tileSize, maskSize - firstPixel));
 
-        if (numberOfMasks == 1)
-        {
-            currentMaskSize = maskSize;
-            currentMaskIndices.resize(currentMaskSize);
-            currentMaskIndices = indices;
-        }
-        else
-        {
-            if (currentMaskIndex == numberOfMasks - 1)
-            {
-                currentMaskIndices.resize(remainingPixels);
-                slice(indices, currentMaskIndex * auxMaskSize, remainingPixels, currentMaskIndices);
-                currentMaskSize = remainingPixels;
-            }
-            else
-            {
-                currentMaskIndices.resize(auxMaskSize);
-                slice(indices, currentMaskIndex * auxMaskSize, auxMaskSize, currentMaskIndices);
-                remainingPixels = remainingPixels - auxMaskSize;
-                currentMaskSize = auxMaskSize;
-            }
-        }
+        currentMaskIndices.resize(currentMaskSize);
+        slice(indices, firstPixel, currentMaskSize, currentMaskIndices);
 
         Eigen::MatrixXf imMat(3 * imageList.size(), currentMaskSize);
         Eigen::MatrixXf imMat_gray(imageList.size(), currentMaskSize);
@@ -400,86 +388,46 @@ void photometricStereo(const std::vector<std::string>& imageList,
                                                          currentPicture.block(2, 0, 1, currentMaskSize) * 0.0722;
         }
 
-        Eigen::MatrixXf M_channel(3, currentMaskSize);
-        int currentIdx;
+        Eigen::MatrixXf M_channel(lightMat.cols(), currentMaskSize);
 
         if (PSParameters.isRobust)
         {
-            float mu = 0.1;
-            int max_iterations = 1000;
-            float epsilon = 0.001;
+            // independent batches of pixels, each one with its own convergence test
+            const int nbBatches = divideRoundUp(currentMaskSize, robustBatchSize);
+            int maxIterations = 0;
 
-            // Errors (E) and Lagrange multiplicators (W) initialisation
-            Eigen::MatrixXf E = lightMat * M_channel - imMat_gray;
-            Eigen::MatrixXf W = Eigen::MatrixXf::Zero(E.rows(), E.cols());
-
-            Eigen::MatrixXf M_kminus1;
-            Eigen::MatrixXf newImMat;
-
-            for (size_t k = 0; k < max_iterations; ++k)
+#pragma omp parallel for schedule(dynamic) reduction(max : maxIterations)
+            for (int b = 0; b < nbBatches; ++b)
             {
-                // Copy for convergence test
-                M_kminus1 = M_channel;
-
-                // M update
-                newImMat = imMat_gray + E - W / mu;
-                M_channel = lightMat.bdcSvd(Eigen::ComputeThinU | Eigen::ComputeThinV).solve(newImMat);
-
-                // E update
-                Eigen::MatrixXf E_before = E;
-                shrink(lightMat * M_channel - imMat_gray + W / mu, 1.0 / mu, E);
+                const int firstCol = b * robustBatchSize;
+                const int nbCols = std::min(robustBatchSize, currentMaskSize - firstCol);
 
-                // W update
-                W = W + mu * (lightMat * M_channel - imMat_gray - E);
-
-                // Convergence test
-                Eigen::MatrixXf dev = M_kminus1 - M_channel;
-                float relativeDev = dev.norm() / M_channel.norm();
-
-                if (k > 10 && relativeDev < epsilon)
-                {
-                    ALICEVISION_LOG_INFO(k);
-                    ALICEVISION_LOG_INFO("Convergence");
-                    break;
-                }
+                Eigen::MatrixXf M_batch;
+                const int nbIterations = robustSolve(lightMat, lightMatPinv, imMat_gray.middleCols(firstCol, nbCols), M_batch);
+                M_channel.middleCols(firstCol, nbCols) = M_batch;
+                maxIterations = std::max(maxIterations, nbIterations);
             }
+            ALICEVISION_LOG_INFO("Robust normal estimation: " << nbBatches << " batch(es), at most " << maxIterations << " iterations.");
 
-            for (size_t i = 0; i < maskSize; ++i)
+#pragma omp parallel for
+            for (int i = 0; i < currentMaskSize; ++i)
             {
-                if (hasMask)
-                {
-                    currentIdx = indices.at(i);  // Index in picture
-                }
-                else
-                {
-                    currentIdx = i;
-                }
+                const int currentIdx = currentMaskIndices[i];  // Index in picture
                 normalsVect.col(currentIdx) = M_channel.col(i) / M_channel.col(i).norm();
             }
 
-            int currentIdx;
-            for (size_t ch = 0; ch < 3; ++ch)
+            // Channelwise albedo estimation: median of the ratios between the pixel values and the shading
+#pragma omp parallel for
+            for (int i = 0; i < currentMaskSize; ++i)
             {
-                // Create I matrix for current pixel
-                Eigen::MatrixXf pixelValues_channel(imageList.size(), maskSize);
-                for (size_t i = 0; i < imageList.size(); ++i)
-                {
-                    pixelValues_channel.block(i, 0, 1, maskSize) = imMat.block(ch + 3 * i, 0, 1, maskSize);
-                }
+                const int currentIdx = currentMaskIndices[i];  // Index in picture
+                const Eigen::VectorXf currentShading = lightMat * normalsVect.col(currentIdx);
 
-                for (size_t i = 0; i < maskSize; ++i)
+                Eigen::VectorXf result(imageList.size());
+                for (size_t ch = 0; ch < 3; ++ch)
                 {
-                    if (hasMask)
-                    {
-                        currentIdx = indices.at(i);  // Index in picture
-                    }
-                    else
-                    {
-                        currentIdx = i;
-                    }
-                    Eigen::VectorXf currentI = pixelValues_channel.col(i);
-                    Eigen::VectorXf currentShading = lightMat * normalsVect.col(currentIdx);
-                    Eigen::VectorXf result = currentI.cwiseProduct(currentShading.cwiseInverse());
+                    for (size_t j = 0; j < imageList.size(); ++j)
+                        result(j) = imMat(ch + 3 * j, i) / currentShading(j);
                     median(result, albedoVect(ch, currentIdx));
                 }
             }
@@ -487,18 +435,12 @@ void photometricStereo(const std::vector<std::string>& imageList,
         else
         {
             // Normal estimation
-            M_channel = lightMat.bdcSvd(Eigen::ComputeThinU | Eigen::ComputeThinV).solve(imMat_gray);
+            M_channel.noalias() = lightMatPinv * imMat_gray;
 
-            for (size_t i = 0; i < currentMaskSize; ++i)
+#pragma omp parallel for
+            for (int i = 0; i < currentMaskSize; ++i)
             {
-                if (hasMask)
-                {
-                    currentIdx = currentMaskIndices.at(i);  // Index in picture
-                }
-                else
-                {
-                    currentIdx = i;
-                }
+                const int currentIdx = currentMaskIndices[i];  // Index in picture
                 normalsVect.col(currentIdx) = M_channel.col(i) / M_channel.col(i).norm();
             }
 
@@ -506,24 +448,18 @@ void photometricStereo(const std::vector<std::string>& imageList,
             for (size_t ch = 0; ch < 3; ++ch)
             {
                 // Create I matrix for current pixel
-                Eigen::MatrixXf pixelValues_channel(imageList.size(), maskSize);
+                Eigen::MatrixXf pixelValues_channel(imageList.size(), currentMaskSize);
                 for (size_t i = 0; i < imageList.size(); ++i)
                 {
-                    pixelValues_channel.block(i, 0, 1, maskSize) = imMat.block(ch + 3 * i, 0, 1, maskSize);
+                    pixelValues_channel.row(i) = imMat.row(ch + 3 * i);
                 }
 
-                M_channel = lightMat.bdcSvd(Eigen::ComputeThinU | Eigen::ComputeThinV).solve(pixelValues_channel);
+                M_channel.noalias() = lightMatPinv * pixelValues_channel;
 
-                for (size_t i = 0; i < currentMaskSize; ++i)
+#pragma omp parallel for
+                for (int i = 0; i < currentMaskSize; ++i)
                 {
-                    if (hasMask)
-                    {
-                        currentIdx = currentMaskIndices.at(i);  // Index in picture
-                    }
-                    else
-                    {
-                        currentIdx = i;
-                    }
+                    const int currentIdx = currentMaskIndices[i];  // Index in picture
                     albedoVect(ch, currentIdx) = M_channel.col(i).norm();
                 }
             }
@@ -604,28 +540,70 @@ bool compareFunction(std::string a, std::string b) { return a < b; }
 
 void shrink(const Eigen::MatrixXf& mat, const float rho, Eigen::MatrixXf& E)
 {
-    for (size_t i = 0; i < E.rows(); ++i)
-    {
-        for (size_t j = 0; j < E.cols(); ++j)
-        {
-            if (mat(i, j) > 0)
-            {
-                E(i, j) = std::max(std::abs(mat(i, j)) - rho, float(0.0));
-            }
-            else
-            {
-                E(i, j) = -std::max(std::abs(mat(i, j)) - rho, float(0.0));
-            }
-        }
-    }
+    // soft thresholding, vectorized on the whole matrix
+    E = (mat.array().abs() - rho).max(0.0f) * mat.array().sign();
 }
 
 void median(const Eigen::MatrixXf& d, float& median)
 {
     Eigen::MatrixXf aux = d;
-    std::sort(aux.data(), aux.data() + aux.size());
-    size_t middle = aux.size() / 2;
-    aux.size() % 2 == 0 ? median = aux((aux.size() - 1) / 2) + aux((aux.size() + 1) / 2) : median = aux(middle);
+    float* first = aux.data();
+    float* last = aux.data() + aux.size();
+    const Eigen::Index middle = aux.size() / 2;
+
+    std::nth_element(first, first + middle, last);
+    median = first[middle];
+    if (aux.size() % 2 == 0)
+    {
+        // the lower middle value is the maximum of the lower half
+        median = 0.5f * (median + *std::max_element(first, first + middle));
+    }
+}
+
+void computePseudoInverse(const Eigen::MatrixXf& lightMat, Eigen::MatrixXf& lightMatPinv)
+{
+    lightMatPinv = lightMat.bdcSvd(Eigen::ComputeThinU | Eigen::ComputeThinV).solve(Eigen::MatrixXf::Identity(lightMat.rows(), lightMat.rows()));
+}
+
+int robustSolve(const Eigen::MatrixXf& lightMat, const Eigen::MatrixXf& lightMatPinv, const Eigen::MatrixXf& imMat, Eigen::MatrixXf& M)
+{
+    const float mu = 0.1;
+    const int max_iterations = 1000;
+    const float epsilon = 0.001;
+
+    // least-squares initialisation
+    M.noalias() = lightMatPinv * imMat;
+
+    // Errors (E) and Lagrange multiplicators (W) initialisation
+    Eigen::MatrixXf E = lightMat * M - imMat;
+    Eigen::MatrixXf W = Eigen::MatrixXf::Zero(E.rows(), E.cols());
+
+    Eigen::MatrixXf M_kminus1;
+    Eigen::MatrixXf residual;
+
+    int k = 0;
+    for (; k < max_iterations; ++k)
+    {
+        // Copy for convergence test
+        M_kminus1 = M;
+
+        // M update
+        M.noalias() = lightMatPinv * (imMat + E - W / mu);
+
+        // E update
+        residual.noalias() = lightMat * M;
+        residual -= imMat;
+        shrink(residual + W / mu, 1.0 / mu, E);
+
+        // W update
+        W += mu * (residual - E);
+
+        // Convergence test
+        const float relativeDev = (M_kminus1 - M).norm() / M.norm();
+        if (k > 10 && relativeDev < epsilon)
+            break;
+    }
+    return k;
 }
 
 void slice(const std::vector<int>& inputVector, int start, int numberOfElements, std::vector<int>& currentMaskIndices)
@@ -118,6 +118,24 @@ void shrink(const Eigen::MatrixXf& mat, const float rho, Eigen::MatrixXf& E);
  */
 void median(const Eigen::MatrixXf& d, float& median);
 
+/**
+ * @brief Compute the pseudo-inverse of the light matrix, computed once and shared by all the pixels
+ * @param[in] lightMat List of light direction/coefficients (SH), one row per picture
+ * @param[out] lightMatPinv Pseudo-inverse of lightMat, the least-squares solution of the PS system is lightMatPinv * I
+ */
+void computePseudoInverse(const Eigen::MatrixXf& lightMat, Eigen::MatrixXf& lightMatPinv);
+
+/**
+ * @brief Robust solve of the PS system for a batch of pixels (ADMM with a sparse error term)
+ * The batch has its own convergence test, so independent batches can be solved in parallel
+ * @param[in] lightMat List of light direction/coefficients (SH)
+ * @param[in] lightMatPinv Pseudo-inverse of lightMat (see computePseudoInverse)
+ * @param[in] imMat Gray levels of the pixels, one column per pixel and one row per picture
+ * @param[out] M Solution, one column per pixel
+ * @return the number of iterations
+ */
+int robustSolve(const Eigen::MatrixXf& lightMat, const Eigen::MatrixXf& lightMatPinv, const Eigen::MatrixXf& imMat, Eigen::MatrixXf& M);
+
 void slice(const std::vector<int>& inputVector, int start, int numberOfElements, std::vector<int>& currentMaskIndices);
 
 void applyRotation(const Eigen::MatrixXd& rotation, image::Image<image::RGBfColor>& normals);
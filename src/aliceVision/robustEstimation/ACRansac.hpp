@@ -63,10 +63,10 @@ void makelogcombi_k(std::size_t k, std::size_t nmax, std::vector<Type>& l, std::
 }
 
 template<typename Type>
-void makelogcombi(std::size_t k, std::size_t n, std::vector<Type>& vec_logc_k, std::vector<Type>& vec_logc_n)
+void makelogcombi(std::size_t k, std::size_t n, std::vector<Type>& vec_logc_k, std::vector<Type>& vec_logc_n, std::vector<Type>& vec_log10)
 {
     // compute a lookuptable of log10 value for the range [0,n+1]
-    std::vector<Type> vec_log10(n + 1);
+    vec_log10.resize(n + 1);
     for (std::size_t k = 0; k <= n; ++k)
         vec_log10[k] = log10((Type)k);
 
@@ -74,11 +74,84 @@ void makelogcombi(std::size_t k, std::size_t n, std::vector<Type>& vec_logc_k, s
     makelogcombi_k(k, n, vec_logc_k, vec_log10);
 }
 
+template<typename Type>
+void makelogcombi(std::size_t k, std::size_t n, std::vector<Type>& vec_logc_k, std::vector<Type>& vec_logc_n)
+{
+    std::vector<Type> vec_log10;
+    makelogcombi(k, n, vec_logc_k, vec_logc_n, vec_log10);
+}
+
 /**
  * @brief NFA and associated index
  */
 using ErrorIndex = std::pair<double, size_t>;
 
+/**
+ * @brief Options of the hypotheses evaluation of ACRANSAC
+ */
+struct ACRansacOptions
+{
+    /// only sort the residuals that can give a lower NFA than the best model, found with a histogram of the residuals
+    /// @note the result is the same as with a full sort
+    bool histogramNFA = true;
+    /// once a meaningful model is found, reject the hypotheses with a Sequential Probability Ratio Test (SPRT) [Matas & Chum 2005]
+    /// evaluating the points in random order against the precision of the best model
+    /// @note the NFA of the returned model is exact, but a rejected hypothesis could have been a better model
+    bool preemptiveEvaluation = false;
+    /// time of a hypothesis estimation, in number of point evaluations
+    double sprtModelCost = 200.0;
+    /// initial probability for a point to be consistent with a bad model, updated from the rejected hypotheses
+    double sprtInitialDelta = 0.05;
+};
+
+/**
+ * @brief Scratch memory of ACRANSAC, reused between the estimations of a thread.
+ * @note The buffers keep the capacity of the largest estimation, so the estimation
+ *       of many small problems (e.g. image pairs) does not allocate anymore.
+ */
+struct ACRansacBuffers
+{
+    /// [residual,index] sorted by residual
+    std::vector<ErrorIndex> residuals;
+    /// residuals in the data order
+    std::vector<double> errors;
+    /// possible sampling indices
+    std::vector<std::size_t> sampleIndices;
+    /// sample indices of the current iteration
+    std::vector<std::size_t> sample;
+    /// points evaluation order of the preemptive evaluation
+    std::vector<std::size_t> evaluationOrder;
+    /// number of residuals per octave of square error
+    std::vector<std::size_t> histogram;
+    /// log combi tables of the (sizeSample, nData) couple below
+    std::vector<float> logc_n;
+    std::vector<float> logc_k;
+    std::vector<float> log10;
+    std::size_t logcSizeSample = 0;
+    std::size_t logcNbData = 0;
+
+    /**
+     * @brief Tabulate the log combi for the given problem size if not already done.
+     */
+    void makeLogCombi(std::size_t sizeSample, std::size_t nData)
+    {
+        if (sizeSample == logcSizeSample && nData == logcNbData && !logc_n.empty())
+            return;
+        makelogcombi(sizeSample, nData, logc_k, logc_n, log10);
+        logcSizeSample = sizeSample;
+        logcNbData = nData;
+    }
+
+    /**
+     * @brief Get the buffers of the calling thread.
+     */
+    static ACRansacBuffers& getThreadBuffers()
+    {
+        static thread_local ACRansacBuffers buffers;
+        return buffers;
+    }
+};
+
 /**
  * @brief Find best NFA and its index wrt square error threshold in e.
  */
@@ -89,10 +162,11 @@ inline ErrorIndex bestNFA(int startIndex,  // number of point required for estim
                           double maxThreshold,
                           const std::vector<float>& logc_n,
                           const std::vector<float>& logc_k,
-                          double errorVectorDimension = 1.0)
+                          double errorVectorDimension = 1.0,
+                          std::size_t nbSortedResiduals = std::numeric_limits<std::size_t>::max())
 {
     ErrorIndex bestIndex(std::numeric_limits<double>::infinity(), startIndex);
-    const size_t n = e.size();
+    const size_t n = std::min(e.size(), nbSortedResiduals);
 
     for (size_t k = startIndex + 1; k <= n && e[k - 1].first <= maxThreshold; ++k)
     {
@@ -111,6 +185,102 @@ inline ErrorIndex bestNFA(int startIndex,  // number of point required for estim
     return bestIndex;
 }
 
+/**
+ * @brief Sort the smallest residuals of e that can give a NFA lower than nfaUpperBound.
+ *
+ * The residuals are binned by octave of their square error. The NFA of the k-th sorted residual
+ * is bounded below by the NFA computed with the lower edge of its bin, so the residuals after
+ * the last bin with a bound lower than nfaUpperBound are only partitioned, not sorted.
+ * The first residuals are the same as with a full sort.
+ *
+ * @return the number of sorted residuals at the beginning of e, 0 if none can give a lower NFA
+ */
+inline std::size_t sortResidualsBelowNFA(int startIndex,
+                                         double logalpha0,
+                                         std::vector<ErrorIndex>& e,
+                                         double loge0,
+                                         double maxThreshold,
+                                         const std::vector<float>& logc_n,
+                                         const std::vector<float>& logc_k,
+                                         double errorVectorDimension,
+                                         double nfaUpperBound,
+                                         std::vector<std::size_t>& histogram)
+{
+    const std::size_t n = e.size();
+    if (nfaUpperBound == std::numeric_limits<double>::infinity())
+    {
+        std::sort(e.begin(), e.end());
+        return n;
+    }
+
+    // bin 0: square errors below 2^minExponent, then one bin per octave
+    constexpr int minExponent = -64;
+    constexpr int nbBins = 130;
+    const double minError = std::ldexp(1.0, minExponent);
+
+    histogram.assign(nbBins, 0);
+    for (const ErrorIndex& error : e)
+    {
+        if (error.first > maxThreshold)
+            continue;
+        const int bin = (error.first < minError) ? 0 : std::min(nbBins - 1, std::ilogb(error.first) - minExponent + 1);
+        ++histogram[bin];
+    }
+
+    std::size_t nbSorted = 0;
+    std::size_t k = 0;
+    for (int bin = 0; bin < nbBins; ++bin)
+    {
+        if (histogram[bin] == 0)
+            continue;
+
+        const std::size_t first = std::max(k + 1, static_cast<std::size_t>(startIndex + 1));
+        k += histogram[bin];
+
+        // same expression as bestNFA with the lower edge of the bin
+        const double lowerEdge = (bin == 0) ? 0.0 : std::ldexp(1.0, bin - 1 + minExponent);
+        const double residual = sqrt(lowerEdge) + std::numeric_limits<float>::epsilon();
+        const double logalpha = logalpha0 + errorVectorDimension * log10(residual);
+
+        for (std::size_t i = first; i <= k; ++i)
+        {
+            const double nfa = loge0 + logalpha * (double)(i - startIndex) + logc_n[i] + logc_k[i];
+            if (nfa < nfaUpperBound)
+            {
+                nbSorted = k;
+                break;
+            }
+        }
+    }
+
+    if (nbSorted == 0)
+        return 0;
+
+    if (nbSorted < n)
+        std::nth_element(e.begin(), e.begin() + nbSorted, e.end());
+    std::sort(e.begin(), e.begin() + nbSorted);
+    return nbSorted;
+}
+
+/**
+ * @brief Decision threshold of the SPRT, from the optimal randomized RANSAC [Matas & Chum 2005]
+ * @param[in] epsilon probability for a point to be consistent with a good model
+ * @param[in] delta probability for a point to be consistent with a bad model (lower than epsilon)
+ * @param[in] modelCost time of a hypothesis estimation, in number of point evaluations
+ * @param[in] nbModelsPerSample average number of models per sample
+ */
+inline double sprtDecisionThreshold(double epsilon, double delta, double modelCost, double nbModelsPerSample)
+{
+    const double c = (1.0 - delta) * std::log((1.0 - delta) / (1.0 - epsilon)) + delta * std::log(delta / epsilon);
+    const double k = modelCost * nbModelsPerSample / c;
+
+    // fixed point of A = k + 1 + log(A)
+    double a = k + 1.0;
+    for (int i = 0; i < 10; ++i)
+        a = k + 1.0 + std::log(a);
+    return a;
+}
+
 /**
  * @brief An implementation of the "Random Sample Consensus" algorithm based on a-contrario estimator
  * to automatically estimate the error threshold.
@@ -139,6 +309,7 @@ inline ErrorIndex bestNFA(int startIndex,  // number of point required for estim
  * @param[in] nIter maximum number of consecutive iterations
  * @param[out] model returned model if found
  * @param[in] precision upper bound of the precision
+ * @param[in] options hypotheses evaluation options
  *
  * @return (errorMax, minNFA)
  */
@@ -148,7 +319,8 @@ std::pair<double, double> ACRANSAC(const Kernel& kernel,
                                    std::vector<size_t>& vec_inliers,
                                    std::size_t nIter = 1024,
                                    typename Kernel::ModelT* model = nullptr,
-                                   double precision = std::numeric_limits<double>::infinity())
+                                   double precision = std::numeric_limits<double>::infinity(),
+                                   const ACRansacOptions& options = ACRansacOptions())
 {
     vec_inliers.clear();
 
@@ -161,17 +333,27 @@ std::pair<double, double> ACRANSAC(const Kernel& kernel,
                                   ? std::numeric_limits<double>::infinity()
                                   : precision * precision * kernel.thresholdNormalizer() * kernel.thresholdNormalizer();
 
-    std::vector<ErrorIndex> vec_residuals(nData);  // [residual,index]
-    std::vector<double> vec_residuals_(nData);
+    // use the scratch memory of the thread to avoid the allocations per estimation
+    ACRansacBuffers& buffers = ACRansacBuffers::getThreadBuffers();
+
+    std::vector<ErrorIndex>& vec_residuals = buffers.residuals;  // [residual,index]
+    std::vector<double>& vec_residuals_ = buffers.errors;
+    vec_residuals.resize(nData);
+    vec_residuals_.resize(nData);
 
     // Possible sampling indices [0,..,nData] (will change in the optimization phase)
-    std::vector<size_t> vec_index(nData);
+    std::vector<size_t>& vec_index = buffers.sampleIndices;
+    vec_index.resize(nData);
     std::iota(vec_index.begin(), vec_index.end(), 0);
 
     // Precompute log combi
     const double loge0 = log10((double)kernel.getMaximumNbModels() * (nData - sizeSample));
-    std::vector<float> vec_logc_n, vec_logc_k;
-    makelogcombi(sizeSample, nData, vec_logc_k, vec_logc_n);
+    buffers.makeLogCombi(sizeSample, nData);
+    const std::vector<float>& vec_logc_n = buffers.logc_n;
+    const std::vector<float>& vec_logc_k = buffers.logc_k;
+
+    std::vector<std::size_t>& vec_sample = buffers.sample;  // Sample indices
+    std::vector<typename Kernel::ModelT> vec_models;        // Up to max_models solutions
 
     // Output parameters
     double minNFA = std::numeric_limits<double>::infinity();
@@ -183,16 +365,36 @@ std::pair<double, double> ACRANSAC(const Kernel& kernel,
 
     bool bACRansacMode = (precision == std::numeric_limits<double>::infinity());
 
+    // Preemptive evaluation: the points are evaluated in a random order, the same for all the hypotheses
+    std::vector<std::size_t>& vec_evaluationOrder = buffers.evaluationOrder;
+    if (options.preemptiveEvaluation)
+    {
+        vec_evaluationOrder.resize(nData);
+        std::iota(vec_evaluationOrder.begin(), vec_evaluationOrder.end(), 0);
+        std::shuffle(vec_evaluationOrder.begin(), vec_evaluationOrder.end(), randomNumberGenerator);
+    }
+    bool sprtEnabled = false;
+    double sprtEpsilon = 0.0;
+    double sprtDelta = options.sprtInitialDelta;
+    double sprtThreshold = std::numeric_limits<double>::infinity();
+    std::size_t sprtNbRejected = 0;
+
+    const auto updateSprt = [&]() {
+        sprtEpsilon = (double)vec_inliers.size() / nData;
+        sprtEnabled = options.preemptiveEvaluation && minNFA < 0 && sprtEpsilon < 1.0 && sprtDelta > 0.0 && sprtDelta < sprtEpsilon;
+        if (sprtEnabled)
+            sprtThreshold = sprtDecisionThreshold(sprtEpsilon, sprtDelta, options.sprtModelCost, kernel.getMaximumNbModels());
+    };
+
     // Main estimation loop.
     for (std::size_t iter = 0; iter < nIter; ++iter)
     {
-        std::vector<std::size_t> vec_sample(sizeSample);  // Sample indices
         if (bACRansacMode)
             uniformSample(randomNumberGenerator, sizeSample, vec_index, vec_sample);  // Get random sample
         else
             uniformSample(randomNumberGenerator, sizeSample, nData, vec_sample);  // Get random sample
 
-        std::vector<typename Kernel::ModelT> vec_models;  // Up to max_models solutions
+        vec_models.clear();
         kernel.fit(vec_sample, vec_models);
 
         // Evaluate models
@@ -200,7 +402,42 @@ std::pair<double, double> ACRANSAC(const Kernel& kernel,
         for (std::size_t k = 0; k < vec_models.size(); ++k)
         {
             // Residuals computation and ordering
-            kernel.errors(vec_models[k], vec_residuals_);
+            if (sprtEnabled)
+            {
+                // SPRT on the points consistent with the precision of the best model
+                double lambda = 1.0;
+                std::size_t nbTested = 0;
+                std::size_t nbConsistent = 0;
+                for (std::size_t i : vec_evaluationOrder)
+                {
+                    const double error = kernel.error(i, vec_models[k]);
+                    vec_residuals_[i] = error;
+                    ++nbTested;
+                    if (error <= errorMax)
+                    {
+                        ++nbConsistent;
+                        lambda *= sprtDelta / sprtEpsilon;
+                    }
+                    else
+                    {
+                        lambda *= (1.0 - sprtDelta) / (1.0 - sprtEpsilon);
+                    }
+                    if (lambda > sprtThreshold)
+                        break;
+                }
+                if (lambda > sprtThreshold)
+                {
+                    // rejected hypothesis: update the probability of consistency with a bad model
+                    sprtDelta = (sprtDelta * sprtNbRejected + (double)nbConsistent / nbTested) / (sprtNbRejected + 1);
+                    ++sprtNbRejected;
+                    updateSprt();
+                    continue;
+                }
+            }
+            else
+            {
+                kernel.errors(vec_models[k], vec_residuals_);
+            }
 
             if (!bACRansacMode)
             {
@@ -220,11 +457,23 @@ std::pair<double, double> ACRANSAC(const Kernel& kernel,
                     const double error = vec_residuals_[i];
                     vec_residuals[i] = ErrorIndex(error, i);
                 }
-                std::sort(vec_residuals.begin(), vec_residuals.end());
+
+                std::size_t nbSorted = nData;
+                if (options.histogramNFA)
+                {
+                    nbSorted = sortResidualsBelowNFA(sizeSample, kernel.logalpha0(), vec_residuals, loge0, maxThreshold, vec_logc_n, vec_logc_k,
+                                                     kernel.errorVectorDimension(), minNFA, buffers.histogram);
+                    if (nbSorted == 0)
+                        continue;  // cannot be better than the best model
+                }
+                else
+                {
+                    std::sort(vec_residuals.begin(), vec_residuals.end());
+                }
 
                 // Most meaningful discrimination inliers/outliers
-                const ErrorIndex best =
-                  bestNFA(sizeSample, kernel.logalpha0(), vec_residuals, loge0, maxThreshold, vec_logc_n, vec_logc_k, kernel.errorVectorDimension());
+                const ErrorIndex best = bestNFA(
+                  sizeSample, kernel.logalpha0(), vec_residuals, loge0, maxThreshold, vec_logc_n, vec_logc_k, kernel.errorVectorDimension(), nbSorted);
 
                 if (best.first < minNFA /*&& vec_residuals[best.second-1].first < errorMax*/)
                 {
@@ -237,6 +486,7 @@ std::pair<double, double> ACRANSAC(const Kernel& kernel,
                     errorMax = vec_residuals[best.second - 1].first;  // Error threshold
                     if (model)
                         *model = vec_models[k];
+                    updateSprt();
 
                     ALICEVISION_LOG_TRACE("  nfa=" << minNFA << " inliers=" << best.second << "/" << nData << " precisionNormalized=" << errorMax
                                                    << " precision=" << kernel.unormalizeError(errorMax) << " (iter=" << iter
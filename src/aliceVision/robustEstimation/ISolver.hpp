@@ -81,6 +81,12 @@ class UndefinedSolver : public ISolver<ModelT_>
     }
 };
 
+/**
+ * @brief Number of samples scored together by the batch errors of the error functors:
+ *        their temporaries are fixed-capacity matrices on the stack.
+ */
+constexpr Eigen::Index batchErrorsBlockSize = 128;
+
 /**
  * @brief Matrix based model to be used in a solver.
  */
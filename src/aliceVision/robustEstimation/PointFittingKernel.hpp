@@ -14,10 +14,28 @@
 
 #include <vector>
 #include <cassert>
+#include <type_traits>
+#include <utility>
 
 namespace aliceVision {
 namespace robustEstimation {
 
+/**
+ * @brief Detect the error functors able to compute the errors of all the samples in one pass with:
+ *        void errors(const ModelT& model, const Mat& x1, const Mat& x2, std::vector<double>& errors) const
+ */
+template<typename ErrorT, typename ModelT, typename = void>
+struct HasBatchErrors : std::false_type
+{};
+
+template<typename ErrorT, typename ModelT>
+struct HasBatchErrors<ErrorT,
+                      ModelT,
+                      std::void_t<decltype(std::declval<const ErrorT&>().errors(
+                        std::declval<const ModelT&>(), std::declval<const Mat&>(), std::declval<const Mat&>(), std::declval<std::vector<double>&>()))>>
+  : std::true_type
+{};
+
 /**
  * @brief This is one example (targeted at solvers that operate on correspondences
  * between two views) that shows the "kernel" part of a robust fitting
@@ -76,8 +94,12 @@ class PointFittingKernel
      */
     inline virtual void fit(const std::vector<std::size_t>& samples, std::vector<ModelT>& models) const
     {
-        const Mat x1 = buildSubsetMatrix(_x1, samples);
-        const Mat x2 = buildSubsetMatrix(_x2, samples);
+        // the minimal solvers are called for each iteration of the robust estimation:
+        // reuse the sample matrices of the thread instead of allocating them at each call
+        static thread_local Mat x1;
+        static thread_local Mat x2;
+        buildSubsetMatrix(_x1, samples, x1);
+        buildSubsetMatrix(_x2, samples, x2);
         _kernelSolver.solve(x1, x2, models);
     }
 
@@ -99,9 +121,16 @@ class PointFittingKernel
      */
     inline virtual void errors(const ModelT& model, std::vector<double>& errors) const
     {
-        errors.resize(_x1.cols());
-        for (std::size_t sample = 0; sample < _x1.cols(); ++sample)
-            errors.at(sample) = error(sample, model);
+        if constexpr (HasBatchErrors<ErrorT, ModelT>::value)
+        {
+            estimatorErrors(model, errors);
+        }
+        else
+        {
+            errors.resize(_x1.cols());
+            for (std::size_t sample = 0; sample < _x1.cols(); ++sample)
+                errors[sample] = error(sample, model);
+        }
     }
 
     /**
@@ -111,6 +140,27 @@ class PointFittingKernel
     inline std::size_t nbSamples() const { return _x1.cols(); }
 
   protected:
+    /**
+     * @brief Return the errors of the error functor for each sample point,
+     *        in one vectorized pass if the error functor supports it
+     * @note The kernels overriding error() must also override errors(), with this function on their own model.
+     * @param[in] model
+     * @param[out] errors
+     */
+    inline void estimatorErrors(const ModelT& model, std::vector<double>& errors) const
+    {
+        if constexpr (HasBatchErrors<ErrorT, ModelT>::value)
+        {
+            _errorEstimator.errors(model, _x1, _x2, errors);
+        }
+        else
+        {
+            errors.resize(_x1.cols());
+            for (std::size_t sample = 0; sample < _x1.cols(); ++sample)
+                errors[sample] = _errorEstimator.error(model, _x1.col(sample), _x2.col(sample));
+        }
+    }
+
     /// left corresponding data
     const Mat& _x1;
     /// right corresponding data
@@ -7,6 +7,8 @@
 
 #pragma once
 
+#include <vector>
+
 namespace aliceVision {
 namespace robustEstimation {
 
@@ -25,10 +27,16 @@ class ScoreEvaluator
     double score(const Kernel& kernel, const typename Kernel::ModelT& model, const std::vector<T>& samples, std::vector<T>& inliers, double threshold)
       const
     {
+        // when most of the samples are scored, compute the errors of all of them in one vectorized pass
+        static thread_local std::vector<double> allErrors;
+        const bool batch = (2 * samples.size() >= kernel.nbSamples());
+        if (batch)
+            kernel.errors(model, allErrors);
+
         double cost = 0.0;
         for (std::size_t j = 0; j < samples.size(); ++j)
         {
-            double error = kernel.error(samples.at(j), model);
+            const double error = batch ? allErrors[samples[j]] : kernel.error(samples[j], model);
             if (error < threshold)
             {
                 cost += error;
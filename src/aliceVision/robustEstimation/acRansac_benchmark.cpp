@@ -0,0 +1,50 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <aliceVision/numeric/numeric.hpp>
+#include <aliceVision/robustEstimation/LineKernel.hpp>
+#include <aliceVision/robustEstimation/ACRansac.hpp>
+#include <aliceVision/robustEstimation/lineTestGenerator.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <vector>
+
+using namespace aliceVision;
+using namespace aliceVision::robustEstimation;
+
+/**
+ * @brief ACRANSAC line fitting on state.range(0) points with state.range(1) percent of outliers.
+ */
+static void BM_ACRansac_LineKernel(benchmark::State& state)
+{
+    const std::size_t nbPoints = static_cast<std::size_t>(state.range(0));
+    const double outlierRatio = static_cast<double>(state.range(1)) / 100.0;
+
+    std::mt19937 generator(0);
+    Mat2X xy(2, nbPoints);
+    std::vector<std::size_t> inliersGT;
+    generateLine(nbPoints, outlierRatio, 0.5, Vec2(-2.0, 6.3), generator, xy, inliersGT);
+
+    const int width = static_cast<int>(xy.row(0).maxCoeff() - xy.row(0).minCoeff());
+    const int height = static_cast<int>(xy.row(1).maxCoeff() - xy.row(1).minCoeff());
+
+    for (auto _ : state)
+    {
+        std::mt19937 randomNumberGenerator(0);
+        LineKernel lineKernel(xy, width, height);
+        std::vector<std::size_t> inliers;
+        LineKernel::ModelT model;
+
+        ACRANSAC(lineKernel, randomNumberGenerator, inliers, 1024, &model);
+        benchmark::DoNotOptimize(inliers.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * nbPoints);
+}
+
+BENCHMARK(BM_ACRansac_LineKernel)->Args({1000, 30})->Args({1000, 60})->Args({10000, 30})->Unit(benchmark::kMillisecond);
@@ -156,6 +156,56 @@ BOOST_AUTO_TEST_CASE(RansacLineFitter_RealisticCase)
     BOOST_CHECK_SMALL(GTModel(1) - model.getMatrix()[1], 1e-9);
 }
 
+// test that sorting only the residuals that can improve the NFA gives the same result as the full sort
+// and that the preemptive evaluation still finds the model in a heavily contaminated dataset
+BOOST_AUTO_TEST_CASE(RansacLineFitter_PreemptiveEvaluation)
+{
+    const int nbPoints = 2000;
+    const float outlierRatio = .7f;
+    Vec2 GTModel;  // y = 0.3x - 2
+    GTModel << -2, .3;
+
+    std::mt19937 gen;
+    Mat2X points(2, nbPoints);
+    std::vector<std::size_t> vec_inliersGT;
+    generateLine(nbPoints, outlierRatio, 0.5, GTModel, gen, points, vec_inliersGT);
+
+    LineKernel lineKernel(points, nbPoints, nbPoints);
+
+    ACRansacOptions fullSortOptions;
+    fullSortOptions.histogramNFA = false;
+
+    std::mt19937 randomNumberGenerator1;
+    std::vector<std::size_t> inliersFullSort;
+    robustEstimation::MatrixModel<Vec2> modelFullSort;
+    const std::pair<double, double> retFullSort =
+      ACRANSAC(lineKernel, randomNumberGenerator1, inliersFullSort, 500, &modelFullSort, std::numeric_limits<double>::infinity(), fullSortOptions);
+
+    std::mt19937 randomNumberGenerator2;
+    std::vector<std::size_t> inliersHistogram;
+    robustEstimation::MatrixModel<Vec2> modelHistogram;
+    const std::pair<double, double> retHistogram = ACRANSAC(lineKernel, randomNumberGenerator2, inliersHistogram, 500, &modelHistogram);
+
+    BOOST_CHECK_EQUAL(retFullSort.first, retHistogram.first);
+    BOOST_CHECK_EQUAL(retFullSort.second, retHistogram.second);
+    BOOST_CHECK(inliersFullSort == inliersHistogram);
+
+    ACRansacOptions preemptiveOptions;
+    preemptiveOptions.preemptiveEvaluation = true;
+
+    std::mt19937 randomNumberGenerator3;
+    std::vector<std::size_t> inliersPreemptive;
+    robustEstimation::MatrixModel<Vec2> modelPreemptive;
+    const std::pair<double, double> retPreemptive =
+      ACRANSAC(lineKernel, randomNumberGenerator3, inliersPreemptive, 500, &modelPreemptive, std::numeric_limits<double>::infinity(), preemptiveOptions);
+
+    BOOST_CHECK(retPreemptive.second < 0);
+    BOOST_CHECK(inliersPreemptive.size() <= vec_inliersGT.size());
+    BOOST_CHECK(inliersPreemptive.size() > 0.9 * vec_inliersGT.size());
+    BOOST_CHECK_SMALL(GTModel(0) - modelPreemptive.getMatrix()[0], 0.5);
+    BOOST_CHECK_SMALL(GTModel(1) - modelPreemptive.getMatrix()[1], 0.01);
+}
+
 // generate nbPoints along a line and add gaussian noise.
 // move some point in the dataset to create outlier contamined data
 void generateLine(Mat& points, std::size_t nbPoints, int W, int H, float noise, float outlierRatio)
@@ -33,10 +33,10 @@ namespace robustEstimation {
  * @param[in] lowerBound The lower bound of the range.
  * @param[in] upperBound The upper bound of the range (not included).
  * @param[in] numSamples Number of unique samples to draw.
- * @return samples The vector containing the samples.
+ * @param[out] samples The vector containing the samples, its memory is reused.
  */
 template<typename IntT>
-inline std::vector<IntT> randSample(std::mt19937& randomNumberGenerator, IntT lowerBound, IntT upperBound, IntT numSamples)
+inline void randSample(std::mt19937& randomNumberGenerator, IntT lowerBound, IntT upperBound, IntT numSamples, std::vector<IntT>& samples)
 {
     const auto rangeSize = upperBound - lowerBound;
 
@@ -50,32 +50,67 @@ inline std::vector<IntT> randSample(std::mt19937& randomNumberGenerator, IntT lo
         // generate a vector with all the elements in the range, shuffle it and
         // return the first numSample elements.
         // this should be more time efficient than drawing at each time.
-        std::vector<IntT> result(rangeSize);
-        std::iota(result.begin(), result.end(), lowerBound);
-        std::shuffle(result.begin(), result.end(), randomNumberGenerator);
-        result.resize(numSamples);
-        return result;
+        samples.resize(rangeSize);
+        std::iota(samples.begin(), samples.end(), lowerBound);
+        std::shuffle(samples.begin(), samples.end(), randomNumberGenerator);
+        samples.resize(numSamples);
     }
     else
     {
         // otherwise if the number of required samples is small wrt the range
         // use the optimized Robert Floyd algorithm.
         // this has linear complexity and minimize the memory usage.
-        std::unordered_set<IntT> samples;
-        for (IntT d = upperBound - numSamples; d < upperBound; ++d)
+        samples.clear();
+        if (numSamples <= 32)
         {
-            IntT t = std::uniform_int_distribution<>(0, d)(randomNumberGenerator) + lowerBound;
-            if (samples.find(t) == samples.end())
-                samples.insert(t);
-            else
-                samples.insert(d);
+            // minimal samples of the robust estimators: a linear search avoids any allocation
+            for (IntT d = upperBound - numSamples; d < upperBound; ++d)
+            {
+                IntT t = std::uniform_int_distribution<>(0, d)(randomNumberGenerator) + lowerBound;
+                if (std::find(samples.begin(), samples.end(), t) == samples.end())
+                    samples.push_back(t);
+                else
+                    samples.push_back(d);
+            }
+        }
+        else
+        {
+            std::unordered_set<IntT> drawn;
+            for (IntT d = upperBound - numSamples; d < upperBound; ++d)
+            {
+                IntT t = std::uniform_int_distribution<>(0, d)(randomNumberGenerator) + lowerBound;
+                if (drawn.insert(t).second)
+                    samples.push_back(t);
+                else
+                {
+                    drawn.insert(d);
+                    samples.push_back(d);
+                }
+            }
         }
         assert(samples.size() == numSamples);
-        std::vector<IntT> result(std::make_move_iterator(samples.begin()), std::make_move_iterator(samples.end()));
-        return result;
     }
 }
 
+/**
+ * @brief Generate a unique random samples without replacement in the
+ * range [lowerBound upperBound).
+ * @see randSample
+ *
+ * @param[in] generator the random number generator to use
+ * @param[in] lowerBound The lower bound of the range.
+ * @param[in] upperBound The upper bound of the range (not included).
+ * @param[in] numSamples Number of unique samples to draw.
+ * @return samples The vector containing the samples.
+ */
+template<typename IntT>
+inline std::vector<IntT> randSample(std::mt19937& randomNumberGenerator, IntT lowerBound, IntT upperBound, IntT numSamples)
+{
+    std::vector<IntT> result;
+    randSample(randomNumberGenerator, lowerBound, upperBound, numSamples, result);
+    return result;
+}
+
 /**
  * @brief Pick a random subset of the integers in the range [0, upperBound).
  *
@@ -114,7 +149,7 @@ inline void uniformSample(std::mt19937& randomNumberGenerator,
                           std::size_t numSamples,
                           std::vector<IntT>& samples)
 {
-    samples = randSample<IntT>(randomNumberGenerator, lowerBound, upperBound, numSamples);
+    randSample<IntT>(randomNumberGenerator, lowerBound, upperBound, numSamples, samples);
 }
 
 /**
@@ -145,7 +180,7 @@ inline void uniformSample(std::mt19937& randomNumberGenerator,
                           const std::vector<std::size_t>& elements,
                           std::vector<std::size_t>& sample)
 {
-    sample = randSample<std::size_t>(randomNumberGenerator, 0, elements.size(), sampleSize);
+    randSample<std::size_t>(randomNumberGenerator, 0, elements.size(), sampleSize, sample);
     assert(sample.size() == sampleSize);
     for (auto& s : sample)
     {
@@ -13,17 +13,18 @@
 #include <aliceVision/image/all.hpp>
 #include <aliceVision/image/imageAlgo.hpp>
 #include <aliceVision/numeric/numeric.hpp>
+#include <aliceVision/alicevision_omp.hpp>
+
+#include <utility>
 
 namespace aliceVision {
 namespace segmentation {
 
-void imageToPlanes(std::vector<float>& output, const image::Image<image::RGBfColor>::Base& source)
+void imageToPlanes(float* output, const image::Image<image::RGBfColor>::Base& source)
 {
     size_t planeSize = source.rows() * source.cols();
 
-    output.resize(planeSize * 3);
-
-    float* planeR = output.data();
+    float* planeR = output;
     float* planeG = planeR + planeSize;
     float* planeB = planeG + planeSize;
 
@@ -63,26 +64,61 @@ bool Segmentation::initialize()
     _ortSession = std::make_unique<Ort::Session>(*_ortEnvironment, _parameters.modelWeights.c_str(), ortSessionOptions);
     #endif
 
-    Ort::MemoryInfo memInfoCuda("Cuda", OrtAllocatorType::OrtArenaAllocator, 0, OrtMemType::OrtMemTypeDefault);
-    Ort::Allocator cudaAllocator(*_ortSession, memInfoCuda);
-
-    _output.resize(_parameters.classes.size() * _parameters.modelHeight * _parameters.modelWidth);
-    _cudaInput = cudaAllocator.Alloc(_output.size() * sizeof(float));
-    _cudaOutput = cudaAllocator.Alloc(_output.size() * sizeof(float));
 #else
     #if defined(_WIN32) || defined(_WIN64)
     std::wstring modelWeights(_parameters.modelWeights.begin(), _parameters.modelWeights.end());
-    _ortSession = std::make_unique<Ort::Session>(ortEnvironment, modelWeights.c_str(), ortSessionOptions);
+    _ortSession = std::make_unique<Ort::Session>(*_ortEnvironment, modelWeights.c_str(), ortSessionOptions);
     #else
     _ortSession = std::make_unique<Ort::Session>(*_ortEnvironment, _parameters.modelWeights.c_str(), ortSessionOptions);
     #endif
 #endif
 
+    // A model exported with a fixed batch size imposes it
+    const std::vector<int64_t> modelInputShape = _ortSession->GetInputTypeInfo(0).GetTensorTypeAndShapeInfo().GetShape();
+    if (!modelInputShape.empty() && modelInputShape[0] > 0 && modelInputShape[0] != _parameters.batchSize)
+    {
+        ALICEVISION_LOG_WARNING("The segmentation model has a fixed batch size of " << modelInputShape[0] << ", the requested batch size ("
+                                                                                    << _parameters.batchSize << ") is ignored.");
+        _parameters.batchSize = static_cast<int>(modelInputShape[0]);
+    }
+    _parameters.batchSize = std::max(1, _parameters.batchSize);
+
+    const int64_t batchSize = _parameters.batchSize;
+    std::vector<int64_t> inputDimensions = {batchSize, 3, _parameters.modelHeight, _parameters.modelWidth};
+    std::vector<int64_t> outputDimensions = {batchSize, static_cast<int64_t>(_parameters.classes.size()), _parameters.modelHeight, _parameters.modelWidth};
+
+    _input.assign(batchSize * 3 * _parameters.modelHeight * _parameters.modelWidth, 0.0f);
+    _output.resize(batchSize * _parameters.classes.size() * _parameters.modelHeight * _parameters.modelWidth);
+
+    // The tensors are bound once to the session and reused for all the batches
+#if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_CUDA)
+    Ort::MemoryInfo memInfo("Cuda", OrtAllocatorType::OrtArenaAllocator, 0, OrtMemType::OrtMemTypeDefault);
+    Ort::Allocator cudaAllocator(*_ortSession, memInfo);
+
+    _cudaInput = cudaAllocator.Alloc(_input.size() * sizeof(float));
+    _cudaOutput = cudaAllocator.Alloc(_output.size() * sizeof(float));
+    float* inputData = reinterpret_cast<float*>(_cudaInput);
+    float* outputData = reinterpret_cast<float*>(_cudaOutput);
+#else
+    Ort::MemoryInfo memInfo = Ort::MemoryInfo::CreateCpu(OrtAllocatorType::OrtArenaAllocator, OrtMemType::OrtMemTypeDefault);
+    float* inputData = _input.data();
+    float* outputData = _output.data();
+#endif
+
+    _inputTensor = Ort::Value::CreateTensor<float>(memInfo, inputData, _input.size(), inputDimensions.data(), inputDimensions.size());
+    _outputTensor = Ort::Value::CreateTensor<float>(memInfo, outputData, _output.size(), outputDimensions.data(), outputDimensions.size());
+
+    _ioBinding = std::make_unique<Ort::IoBinding>(*_ortSession);
+    _ioBinding->BindInput("input", _inputTensor);
+    _ioBinding->BindOutput("output", _outputTensor);
+
     return true;
 }
 
 bool Segmentation::terminate()
 {
+    _ioBinding.reset();
+
 #if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_CUDA)
     Ort::MemoryInfo mem_info_cuda("Cuda", OrtAllocatorType::OrtArenaAllocator, 0, OrtMemType::OrtMemTypeDefault);
     Ort::Allocator cudaAllocator(*_ortSession, mem_info_cuda);
@@ -94,6 +130,17 @@ bool Segmentation::terminate()
 }
 
 bool Segmentation::processImage(image::Image<IndexT>& labels, const image::Image<image::RGBfColor>& source)
+{
+    image::Image<image::RGBfColor> preprocessed;
+    if (!preprocessImage(preprocessed, source))
+    {
+        return false;
+    }
+
+    return processPreprocessedImage(labels, preprocessed, source.Width(), source.Height());
+}
+
+bool Segmentation::preprocessImage(image::Image<image::RGBfColor>& preprocessed, const image::Image<image::RGBfColor>& source) const
 {
     // Todo : handle orientation and small images smaller than model input
 
@@ -134,26 +181,31 @@ bool Segmentation::processImage(image::Image<IndexT>& labels, const image::Image
     }
 
     // Resize image
-    image::Image<image::RGBfColor> resized;
-    imageAlgo::resizeImage(resizedWidth, resizedHeight, source, resized);
+    imageAlgo::resizeImage(resizedWidth, resizedHeight, source, preprocessed);
 
     // Normalize image to fit model statistics
+#pragma omp parallel for
     for (int i = 0; i < resizedHeight; i++)
     {
         for (int j = 0; j < resizedWidth; j++)
         {
-            image::RGBfColor value = resized(i, j);
-            resized(i, j) = (value - _parameters.center) * _parameters.scale;
+            image::RGBfColor value = preprocessed(i, j);
+            preprocessed(i, j) = (value - _parameters.center) * _parameters.scale;
         }
     }
 
+    return true;
+}
+
+bool Segmentation::processPreprocessedImage(image::Image<IndexT>& labels, const image::Image<image::RGBfColor>& preprocessed, int width, int height)
+{
     image::Image<IndexT> resizedLabels;
-    if (!tiledProcess(resizedLabels, resized))
+    if (!tiledProcess(resizedLabels, preprocessed))
     {
         return false;
     }
 
-    imageAlgo::resampleImage(source.Width(), source.Height(), resizedLabels, labels, false);
+    imageAlgo::resampleImage(width, height, resizedLabels, labels, false);
 
     return true;
 }
@@ -166,7 +218,8 @@ bool Segmentation::tiledProcess(image::Image<IndexT>& labels, const image::Image
 
     image::Image<ScoredLabel> scoredLabels(source.Width(), source.Height(), true, {0, 0.0f});
 
-    // Loop over tiles
+    // Position of the tiles in the input image
+    std::vector<std::pair<int, int>> tiles;
     for (int i = 0; i < cheight; i++)
     {
         // Compute starting point with overlap on previous
@@ -194,19 +247,37 @@ bool Segmentation::tiledProcess(image::Image<IndexT>& labels, const image::Image
             }
 
             // x and y contains the position of the tile in the input image
-            auto& block = source.block(y, x, _parameters.modelHeight, _parameters.modelWidth);
+            tiles.emplace_back(x, y);
+        }
+    }
 
-            // Compute tile
-            image::Image<ScoredLabel> tileLabels(_parameters.modelWidth, _parameters.modelHeight, true, {0, 0.0f});
+    // Process the tiles by batches
+    const int batchSize = _parameters.batchSize;
+    const std::size_t inputTileSize = 3 * _parameters.modelHeight * _parameters.modelWidth;
+    std::vector<image::Image<ScoredLabel>> tileLabels(batchSize);
 
-#if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_CUDA)
-            processTileGPU(tileLabels, block);
-#else
-            processTile(tileLabels, block);
-#endif
+    for (std::size_t firstTile = 0; firstTile < tiles.size(); firstTile += batchSize)
+    {
+        const int nbTiles = static_cast<int>(std::min<std::size_t>(batchSize, tiles.size() - firstTile));
+
+        // Fill the input buffer of the batch in parallel
+#pragma omp parallel for
+        for (int t = 0; t < nbTiles; ++t)
+        {
+            const auto& [x, y] = tiles[firstTile + t];
+            imageToPlanes(_input.data() + t * inputTileSize, source.block(y, x, _parameters.modelHeight, _parameters.modelWidth));
+        }
 
-            // Update the global labeling
-            mergeLabels(scoredLabels, tileLabels, x, y);
+        if (!processBatch(tileLabels, nbTiles))
+        {
+            return false;
+        }
+
+        // Update the global labeling
+        for (int t = 0; t < nbTiles; ++t)
+        {
+            const auto& [x, y] = tiles[firstTile + t];
+            mergeLabels(scoredLabels, tileLabels[t], x, y);
         }
     }
 
@@ -234,7 +305,7 @@ bool Segmentation::mergeLabels(image::Image<ScoredLabel>& labels, image::Image<S
     return true;
 }
 
-bool Segmentation::labelsFromModelOutput(image::Image<ScoredLabel>& labels, const std::vector<float>& modelOutput)
+bool Segmentation::labelsFromModelOutput(image::Image<ScoredLabel>& labels, const float* modelOutput)
 {
     for (int outputY = 0; outputY < _parameters.modelHeight; outputY++)
     {
@@ -263,68 +334,15 @@ bool Segmentation::labelsFromModelOutput(image::Image<ScoredLabel>& labels, cons
     return true;
 }
 
-bool Segmentation::processTile(image::Image<ScoredLabel>& labels, const image::Image<image::RGBfColor>::Base& source)
+bool Segmentation::processBatch(std::vector<image::Image<ScoredLabel>>& labels, int nbTiles)
 {
-    Ort::MemoryInfo memInfo = Ort::MemoryInfo::CreateCpu(OrtAllocatorType::OrtArenaAllocator, OrtMemType::OrtMemTypeDefault);
-
-    std::vector<const char*> inputNames{"input"};
-    std::vector<const char*> outputNames{"output"};
-    std::vector<int64_t> inputDimensions = {1, 3, _parameters.modelHeight, _parameters.modelWidth};
-    std::vector<int64_t> outputDimensions = {1, static_cast<int64_t>(_parameters.classes.size()), _parameters.modelHeight, _parameters.modelWidth};
-
-    std::vector<float> output(_parameters.classes.size() * _parameters.modelHeight * _parameters.modelWidth);
-    Ort::Value outputTensors =
-      Ort::Value::CreateTensor<float>(memInfo, output.data(), output.size(), outputDimensions.data(), outputDimensions.size());
-
-    std::vector<float> transformedInput;
-    imageToPlanes(transformedInput, source);
-
-    Ort::Value inputTensors =
-      Ort::Value::CreateTensor<float>(memInfo, transformedInput.data(), transformedInput.size(), inputDimensions.data(), inputDimensions.size());
-
-    try
-    {
-        _ortSession->Run(Ort::RunOptions{nullptr}, inputNames.data(), &inputTensors, 1, outputNames.data(), &outputTensors, 1);
-    }
-    catch (const Ort::Exception& exception)
-    {
-        ALICEVISION_LOG_ERROR("ERROR running model inference: " << exception.what());
-        return false;
-    }
-
-    if (!labelsFromModelOutput(labels, output))
-    {
-        return false;
-    }
-
-    return true;
-}
-
 #if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_CUDA)
-bool Segmentation::processTileGPU(image::Image<ScoredLabel>& labels, const image::Image<image::RGBfColor>::Base& source)
-{
-    Ort::MemoryInfo mem_info_cuda("Cuda", OrtAllocatorType::OrtArenaAllocator, 0, OrtMemType::OrtMemTypeDefault);
-    Ort::Allocator cudaAllocator(*_ortSession, mem_info_cuda);
-
-    std::vector<const char*> inputNames{"input"};
-    std::vector<const char*> outputNames{"output"};
-    std::vector<int64_t> inputDimensions = {1, 3, _parameters.modelHeight, _parameters.modelWidth};
-    std::vector<int64_t> outputDimensions = {1, static_cast<int64_t>(_parameters.classes.size()), _parameters.modelHeight, _parameters.modelWidth};
-
-    Ort::Value outputTensors = Ort::Value::CreateTensor<float>(
-      mem_info_cuda, reinterpret_cast<float*>(_cudaOutput), _output.size(), outputDimensions.data(), outputDimensions.size());
-
-    std::vector<float> transformedInput;
-    imageToPlanes(transformedInput, source);
-
-    cudaMemcpy(_cudaInput, transformedInput.data(), sizeof(float) * transformedInput.size(), cudaMemcpyHostToDevice);
-
-    Ort::Value inputTensors = Ort::Value::CreateTensor<float>(
-      mem_info_cuda, reinterpret_cast<float*>(_cudaInput), transformedInput.size(), inputDimensions.data(), inputDimensions.size());
+    cudaMemcpy(_cudaInput, _input.data(), sizeof(float) * _input.size(), cudaMemcpyHostToDevice);
+#endif
 
     try
     {
-        _ortSession->Run(Ort::RunOptions{nullptr}, inputNames.data(), &inputTensors, 1, outputNames.data(), &outputTensors, 1);
+        _ortSession->Run(Ort::RunOptions{nullptr}, *_ioBinding);
     }
     catch (const Ort::Exception& exception)
     {
@@ -332,16 +350,21 @@ bool Segmentation::processTileGPU(image::Image<ScoredLabel>& labels, const image
         return false;
     }
 
+#if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_CUDA)
     cudaMemcpy(_output.data(), _cudaOutput, sizeof(float) * _output.size(), cudaMemcpyDeviceToHost);
+#endif
+
+    const std::size_t outputTileSize = _parameters.classes.size() * _parameters.modelHeight * _parameters.modelWidth;
 
-    if (!labelsFromModelOutput(labels, _output))
+#pragma omp parallel for
+    for (int t = 0; t < nbTiles; ++t)
     {
-        return false;
+        labels[t].resize(_parameters.modelWidth, _parameters.modelHeight, false);
+        labelsFromModelOutput(labels[t], _output.data() + t * outputTileSize);
     }
 
     return true;
 }
-#endif
 
 }  // namespace segmentation
 }  // namespace aliceVision
\ No newline at end of file
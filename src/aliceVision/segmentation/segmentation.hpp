@@ -39,6 +39,8 @@ class Segmentation
         int modelWidth;
         int modelHeight;
         double overlapRatio;
+        /// number of tiles per inference run, replaced by the batch size of the model if it is fixed
+        int batchSize = 1;
     };
 
   public:
@@ -60,6 +62,23 @@ class Segmentation
      */
     bool processImage(image::Image<IndexT>& labels, const image::Image<image::RGBfColor>& source);
 
+    /**
+     * Resize and normalize an input image for the model, first step of processImage
+     * Only reads the parameters, so it can run in another thread than the inference
+     * @param preprocessed the resized and normalized image
+     * @param source is the input image to process
+     */
+    bool preprocessImage(image::Image<image::RGBfColor>& preprocessed, const image::Image<image::RGBfColor>& source) const;
+
+    /**
+     * Estimate the segmentation of a preprocessed image, second step of processImage
+     * @param labels the labels image resulting from the process
+     * @param preprocessed the image resulting from preprocessImage
+     * @param width the width of the input image
+     * @param height the height of the input image
+     */
+    bool processPreprocessedImage(image::Image<IndexT>& labels, const image::Image<image::RGBfColor>& preprocessed, int width, int height);
+
   private:
     /**
      * Onnx creation code
@@ -83,23 +102,14 @@ class Segmentation
      * @param labels the output labels imaage
      * @param modeloutput the model output vector
      */
-    bool labelsFromModelOutput(image::Image<ScoredLabel>& labels, const std::vector<float>& modelOutput);
+    bool labelsFromModelOutput(image::Image<ScoredLabel>& labels, const float* modelOutput);
 
     /**
-     * Process effectively a buffer of the model input size
-     * param labels the output labels
-     * @param source the source tile
+     * Process effectively a batch of tiles, stored as planes in the input buffer
+     * @param labels the output labels of each tile
+     * @param nbTiles the number of tiles of the batch, the other slots of the input buffer are ignored
      */
-    bool processTile(image::Image<ScoredLabel>& labels, const image::Image<image::RGBfColor>::Base& source);
-
-/**
- * Process effectively a buffer of the model input size
- * param labels the output labels
- * @param source the source tile
- */
-#if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_CUDA)
-    bool processTileGPU(image::Image<ScoredLabel>& labels, const image::Image<image::RGBfColor>::Base& source);
-#endif
+    bool processBatch(std::vector<image::Image<ScoredLabel>>& labels, int nbTiles);
 
     /**
      * Merge tile labels with global labels image
@@ -115,6 +125,12 @@ class Segmentation
     std::unique_ptr<Ort::Env> _ortEnvironment;
     std::unique_ptr<Ort::Session> _ortSession;
 
+    /// input and output tensors of a batch, bound once to the session
+    std::unique_ptr<Ort::IoBinding> _ioBinding;
+    Ort::Value _inputTensor{nullptr};
+    Ort::Value _outputTensor{nullptr};
+
+    std::vector<float> _input;
     std::vector<float> _output;
 
 #if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_CUDA)
@@ -7,48 +7,67 @@
 
 #include "Datasheet.hpp"
 
+#include <cctype>
 #include <string>
-#include <algorithm>
-
-#include <boost/algorithm/string.hpp>
-#include <boost/algorithm/string/predicate.hpp>
 
 namespace aliceVision {
 namespace sensorDB {
 
-bool Datasheet::operator==(const Datasheet& other) const
-{
-    std::string brandA = _brand;
-    std::string brandB = other._brand;
-
-    boost::algorithm::to_lower(brandA);
-    boost::algorithm::to_lower(brandB);
-
-    brandA.erase(std::remove_if(brandA.begin(), brandA.end(), ::ispunct), brandA.end());  // remove punctuation
-    brandB.erase(std::remove_if(brandB.begin(), brandB.end(), ::ispunct), brandB.end());  // remove punctuation
+namespace {
 
-    brandA.erase(std::remove_if(brandA.begin(), brandA.end(), ::isspace), brandA.end());  // remove spaces
-    brandB.erase(std::remove_if(brandB.begin(), brandB.end(), ::isspace), brandB.end());  // remove spaces
+/// punctuation and spaces are ignored in the comparison of the names
+inline bool isIgnored(char c)
+{
+    const unsigned char uc = static_cast<unsigned char>(c);
+    return std::ispunct(uc) || std::isspace(uc);
+}
 
-    if ((brandA == brandB) || (boost::algorithm::starts_with(brandA, brandB)) || (boost::algorithm::starts_with(brandB, brandA)))
+/**
+ * @brief Compare two names ignoring the case, the punctuation and the spaces, without allocation.
+ * @param[in] firstA, lastA the characters of the first name
+ * @param[in] firstB, lastB the characters of the second name
+ * @return true if one of the normalized names starts with the other one
+ */
+template<class Iterator>
+bool isNormalizedPrefix(Iterator firstA, Iterator lastA, Iterator firstB, Iterator lastB)
+{
+    while (true)
     {
-        std::string modelA = _model;
-        std::string modelB = other._model;
+        while (firstA != lastA && isIgnored(*firstA))
+            ++firstA;
+        while (firstB != lastB && isIgnored(*firstB))
+            ++firstB;
+
+        if (firstA == lastA || firstB == lastB)
+            return true;
 
-        boost::algorithm::to_lower(modelA);
-        boost::algorithm::to_lower(modelB);
+        if (std::tolower(static_cast<unsigned char>(*firstA)) != std::tolower(static_cast<unsigned char>(*firstB)))
+            return false;
 
-        modelA.erase(std::remove_if(modelA.begin(), modelA.end(), ::ispunct), modelA.end());  // remove punctuation
-        modelB.erase(std::remove_if(modelB.begin(), modelB.end(), ::ispunct), modelB.end());  // remove punctuation
+        ++firstA;
+        ++firstB;
+    }
+}
 
-        modelA.erase(std::remove_if(modelA.begin(), modelA.end(), ::isspace), modelA.end());  // remove spaces
-        modelB.erase(std::remove_if(modelB.begin(), modelB.end(), ::isspace), modelB.end());  // remove spaces
+}  // namespace
 
-        if ((modelA == modelB) || (boost::algorithm::ends_with(modelA, modelB)) || (boost::algorithm::ends_with(modelB, modelA)))
-            return true;
+std::string normalizeName(const std::string& name)
+{
+    std::string normalized;
+    normalized.reserve(name.size());
+    for (const char c : name)
+    {
+        if (!isIgnored(c))
+            normalized += static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
     }
+    return normalized;
+}
 
-    return false;
+bool Datasheet::operator==(const Datasheet& other) const
+{
+    // brands match if one starts with the other, models if one ends with the other
+    return isNormalizedPrefix(_brand.begin(), _brand.end(), other._brand.begin(), other._brand.end()) &&
+           isNormalizedPrefix(_model.rbegin(), _model.rend(), other._model.rbegin(), other._model.rend());
 }
 
 }  // namespace sensorDB
@@ -38,5 +38,12 @@ struct Datasheet
     double _sensorWidth;
 };
 
+/**
+ * @brief Normalize a brand or model name as in the datasheets comparison.
+ * @param[in] name The brand or model name
+ * @return The name in lower case, without punctuation and spaces
+ */
+std::string normalizeName(const std::string& name);
+
 }  // namespace sensorDB
 }  // namespace aliceVision
@@ -0,0 +1,84 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "SensorDatabase.hpp"
+#include <aliceVision/sensorDB/parseDatabase.hpp>
+
+#include <algorithm>
+#include <utility>
+
+namespace aliceVision {
+namespace sensorDB {
+
+namespace {
+
+/// key of a camera, the separator cannot be in a normalized name
+std::string getCameraKey(const std::string& brand, const std::string& model) { return normalizeName(brand) + ';' + normalizeName(model); }
+
+}  // namespace
+
+SensorDatabase::SensorDatabase(std::vector<Datasheet> datasheets)
+  : _datasheets(std::move(datasheets))
+{
+    buildIndex();
+}
+
+bool SensorDatabase::load(const std::string& databaseFilePath)
+{
+    std::vector<Datasheet> datasheets;
+    if (!parseDatabase(databaseFilePath, datasheets))
+        return false;
+
+    _datasheets = std::move(datasheets);
+    buildIndex();
+    return true;
+}
+
+void SensorDatabase::buildIndex()
+{
+    _index.clear();
+    _index.reserve(_datasheets.size());
+    for (int i = 0; i < static_cast<int>(_datasheets.size()); ++i)
+        _index.emplace(getCameraKey(_datasheets[i]._brand, _datasheets[i]._model), i);
+
+    std::lock_guard<std::mutex> lock(_fuzzyLookupsMutex);
+    _fuzzyLookups.clear();
+}
+
+int SensorDatabase::findDatasheet(const std::string& brand, const std::string& model) const
+{
+    const std::string key = getCameraKey(brand, model);
+
+    const auto indexIt = _index.find(key);
+    if (indexIt != _index.end())
+        return indexIt->second;
+
+    std::lock_guard<std::mutex> lock(_fuzzyLookupsMutex);
+
+    const auto lookupIt = _fuzzyLookups.find(key);
+    if (lookupIt != _fuzzyLookups.end())
+        return lookupIt->second;
+
+    const Datasheet refDatasheet(brand, model, -1.);
+    const auto datasheetIt = std::find(_datasheets.begin(), _datasheets.end(), refDatasheet);
+    const int datasheetIndex = (datasheetIt == _datasheets.end()) ? -1 : static_cast<int>(datasheetIt - _datasheets.begin());
+
+    _fuzzyLookups.emplace(key, datasheetIndex);
+    return datasheetIndex;
+}
+
+bool SensorDatabase::getInfo(const std::string& brand, const std::string& model, Datasheet& datasheetContent) const
+{
+    const int datasheetIndex = findDatasheet(brand, model);
+    if (datasheetIndex < 0)
+        return false;
+
+    datasheetContent = _datasheets[datasheetIndex];
+    return true;
+}
+
+}  // namespace sensorDB
+}  // namespace aliceVision
@@ -0,0 +1,80 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <aliceVision/sensorDB/Datasheet.hpp>
+
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace aliceVision {
+namespace sensorDB {
+
+/**
+ * @brief Sensor database indexed for the lookup of many views.
+ *
+ * The datasheets are indexed by normalized brand and model (see normalizeName).
+ * A camera that is not found with its exact normalized names falls back to the
+ * fuzzy comparison of getInfo, and the result is cached as the views of a dataset
+ * share a few cameras.
+ */
+class SensorDatabase
+{
+  public:
+    SensorDatabase() = default;
+
+    /**
+     * @param[in] datasheets The datasheets of the database
+     */
+    explicit SensorDatabase(std::vector<Datasheet> datasheets);
+
+    // no copy constructor, the cache has a mutex
+    SensorDatabase(SensorDatabase const&) = delete;
+
+    // no copy operator
+    void operator=(SensorDatabase const&) = delete;
+
+    /**
+     * @brief Parse and index the given sensor database file
+     * @param[in] databaseFilePath The file path of the database
+     * @return True if ok
+     */
+    bool load(const std::string& databaseFilePath);
+
+    /**
+     * @brief Get information for the given camera brand / model
+     * @note Thread-safe.
+     * @param[in] brand The camera brand
+     * @param[in] model The camera model
+     * @param[out] datasheetContent The corresponding datasheet
+     * @return True if ok
+     */
+    bool getInfo(const std::string& brand, const std::string& model, Datasheet& datasheetContent) const;
+
+    const std::vector<Datasheet>& getDatasheets() const { return _datasheets; }
+
+    bool empty() const { return _datasheets.empty(); }
+
+  private:
+    void buildIndex();
+
+    /// @return the index of the datasheet of the given camera, or -1 if not found
+    int findDatasheet(const std::string& brand, const std::string& model) const;
+
+    std::vector<Datasheet> _datasheets;
+    /// normalized brand and model to the first datasheet with these names
+    std::unordered_map<std::string, int> _index;
+    /// results of the fuzzy lookups
+    mutable std::unordered_map<std::string, int> _fuzzyLookups;
+    mutable std::mutex _fuzzyLookupsMutex;
+};
+
+}  // namespace sensorDB
+}  // namespace aliceVision
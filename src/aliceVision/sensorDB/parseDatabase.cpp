@@ -9,7 +9,6 @@
 #include <aliceVision/sensorDB/Datasheet.hpp>
 
 #include <boost/filesystem.hpp>
-#include <boost/algorithm/string.hpp>
 
 #include <vector>
 #include <string>
@@ -30,25 +29,24 @@ bool parseDatabase(const std::string& databaseFilePath, std::vector<Datasheet>&
         return false;
 
     std::string line;
-    while (fileIn.good())
+    while (std::getline(fileIn, line))
     {
-        getline(fileIn, line);
-        if (!line.empty())
-        {
-            if (line[0] != '#')
-            {
-                std::vector<std::string> values;
-                boost::split(values, line, boost::is_any_of(";"));
+        if (line.empty() || line[0] == '#')
+            continue;
 
-                if (values.size() >= 4)
-                {
-                    const std::string brand = values[0];
-                    const std::string model = values[1];
-                    const double sensorWidth = std::stod(values[2]);
-                    databaseStructure.emplace_back(brand, model, sensorWidth);
-                }
-            }
-        }
+        // brand;model;sensorWidth;source[;...], split without allocating the fields
+        const std::size_t brandEnd = line.find(';');
+        if (brandEnd == std::string::npos)
+            continue;
+        const std::size_t modelEnd = line.find(';', brandEnd + 1);
+        if (modelEnd == std::string::npos)
+            continue;
+        const std::size_t sensorWidthEnd = line.find(';', modelEnd + 1);
+        if (sensorWidthEnd == std::string::npos)
+            continue;
+
+        const double sensorWidth = std::stod(line.substr(modelEnd + 1, sensorWidthEnd - modelEnd - 1));
+        databaseStructure.emplace_back(line.substr(0, brandEnd), line.substr(brandEnd + 1, modelEnd - brandEnd - 1), sensorWidth);
     }
     return true;
 }
@@ -0,0 +1,80 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <aliceVision/sensorDB/parseDatabase.hpp>
+#include <aliceVision/sensorDB/SensorDatabase.hpp>
+
+#include <boost/filesystem.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <string>
+#include <vector>
+
+using namespace aliceVision::sensorDB;
+namespace fs = boost::filesystem;
+
+namespace {
+
+const std::string sDatabase = (fs::path(THIS_SOURCE_DIR) / "cameraSensors.db").string();
+
+/**
+ * @brief Parse the sensor database, done at the startup of cameraInit.
+ */
+void BM_ParseDatabase(benchmark::State& state)
+{
+    for (auto _ : state)
+    {
+        std::vector<Datasheet> database;
+        parseDatabase(sDatabase, database);
+        benchmark::DoNotOptimize(database.size());
+    }
+}
+
+/**
+ * @brief Look for a camera in the database, done for each view by cameraInit.
+ *        state.range(0) is 1 for a camera of the database, 0 for an unknown camera (full scan).
+ */
+void BM_GetInfo(benchmark::State& state)
+{
+    std::vector<Datasheet> database;
+    parseDatabase(sDatabase, database);
+
+    const bool known = state.range(0) != 0;
+    const std::string brand = known ? "Sony" : "UnknownBrand";
+    const std::string model = known ? "ILCE-7RM3" : "Unknown Model";
+
+    for (auto _ : state)
+    {
+        Datasheet datasheet;
+        benchmark::DoNotOptimize(getInfo(brand, model, database, datasheet));
+    }
+}
+
+/**
+ * @brief Look for a camera in the indexed database, same cameras as BM_GetInfo.
+ */
+void BM_SensorDatabase_GetInfo(benchmark::State& state)
+{
+    SensorDatabase database;
+    database.load(sDatabase);
+
+    const bool known = state.range(0) != 0;
+    const std::string brand = known ? "Sony" : "UnknownBrand";
+    const std::string model = known ? "ILCE-7RM3" : "Unknown Model";
+
+    for (auto _ : state)
+    {
+        Datasheet datasheet;
+        benchmark::DoNotOptimize(database.getInfo(brand, model, datasheet));
+    }
+}
+
+}  // namespace
+
+BENCHMARK(BM_ParseDatabase)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_GetInfo)->Arg(1)->Arg(0)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_SensorDatabase_GetInfo)->Arg(1)->Arg(0)->Unit(benchmark::kMicrosecond);
@@ -6,6 +6,7 @@
 // You can obtain one at https://mozilla.org/MPL/2.0/.
 
 #include <aliceVision/sensorDB/parseDatabase.hpp>
+#include <aliceVision/sensorDB/SensorDatabase.hpp>
 
 #include <boost/filesystem.hpp>
 
@@ -111,3 +112,45 @@ BOOST_AUTO_TEST_CASE(ParseDatabaseCanon_EOS_1100D)
     BOOST_CHECK(getInfo(sBrand, sModel, vec_database, datasheet));
     BOOST_CHECK_EQUAL(22.2, datasheet._sensorWidth);
 }
+
+BOOST_AUTO_TEST_CASE(SensorDatabaseInvalid)
+{
+    SensorDatabase database;
+    BOOST_CHECK(!database.load(std::string(THIS_SOURCE_DIR)));
+    BOOST_CHECK(database.empty());
+}
+
+BOOST_AUTO_TEST_CASE(SensorDatabaseSameAsParseDatabase)
+{
+    std::vector<Datasheet> vec_database;
+    BOOST_CHECK(parseDatabase(sDatabase, vec_database));
+
+    SensorDatabase database;
+    BOOST_CHECK(database.load(sDatabase));
+    BOOST_CHECK_EQUAL(vec_database.size(), database.getDatasheets().size());
+
+    // exact names, case and punctuation differences, fuzzy match and unknown camera
+    const std::vector<std::pair<std::string, std::string>> cameras = {{"Canon", "Canon PowerShot SD900"},
+                                                                      {"Canon", "Canon EOS 5D Mark II"},
+                                                                      {"CANON", "canon eos-550d"},
+                                                                      {"Canon", "PowerShot A710 IS"},
+                                                                      {"NotExistBrand", "NotExistModel"}};
+
+    for (const auto& camera : cameras)
+    {
+        Datasheet expected;
+        Datasheet datasheet;
+        const bool found = getInfo(camera.first, camera.second, vec_database, expected);
+        // twice to use the cached lookup
+        for (int i = 0; i < 2; ++i)
+        {
+            BOOST_CHECK_EQUAL(found, database.getInfo(camera.first, camera.second, datasheet));
+            if (found)
+            {
+                BOOST_CHECK_EQUAL(expected._brand, datasheet._brand);
+                BOOST_CHECK_EQUAL(expected._model, datasheet._model);
+                BOOST_CHECK_EQUAL(expected._sensorWidth, datasheet._sensorWidth);
+            }
+        }
+    }
+}
@@ -12,8 +12,10 @@
 #include <aliceVision/stl/mapUtils.hpp>
 #include <aliceVision/types.hpp>
 #include <aliceVision/geometry/HalfPlane.hpp>
+#include <aliceVision/geometry/AABBTree.hpp>
 #include <aliceVision/config.hpp>
 
+#include <algorithm>
 #include <fstream>
 
 namespace aliceVision {
@@ -58,30 +60,76 @@ void FrustumFilter::initFrustum(const sfmData::SfMData& sfmData)
 
 PairSet FrustumFilter::getFrustumIntersectionPairs() const
 {
-    PairSet pairs;
-    // List active view Id
+    // List active view Id (frustum)
     std::vector<IndexT> viewIds;
-    viewIds.reserve(z_near_z_far_perView.size());
-    std::transform(z_near_z_far_perView.begin(), z_near_z_far_perView.end(), std::back_inserter(viewIds), stl::RetrieveKey());
+    viewIds.reserve(frustum_perView.size());
+    std::transform(frustum_perView.begin(), frustum_perView.end(), std::back_inserter(viewIds), stl::RetrieveKey());
+    std::sort(viewIds.begin(), viewIds.end());
+
+    const int nbViews = static_cast<int>(viewIds.size());
+    std::vector<const Frustum*> frustums(nbViews);
+    for (int i = 0; i < nbViews; ++i)
+        frustums[i] = &frustum_perView.at(viewIds[i]);
+
+    // Bounding boxes of the truncated frustums (the convex hull of their points).
+    // The other frustums are not bounded and are tested against all the views.
+    std::vector<AABBTree::Box> boxes;
+    std::vector<int> boundedViews;
+    std::vector<int> boxPerView(nbViews, -1);
+    for (int i = 0; i < nbViews; ++i)
+    {
+        if (!frustums[i]->isTruncated())
+            continue;
+        AABBTree::Box box;
+        for (const Vec3& point : frustums[i]->frustum_points())
+            box.extend(point);
+        // margin for the tolerance of the exact intersection test
+        const double margin = 1e-6 * box.diagonal().norm();
+        box.min().array() -= margin;
+        box.max().array() += margin;
+
+        boxPerView[i] = static_cast<int>(boxes.size());
+        boxes.push_back(box);
+        boundedViews.push_back(i);
+    }
+    const AABBTree tree(boxes);
 
-    auto progressDisplay =
-      system::createConsoleProgressDisplay(viewIds.size() * (viewIds.size() - 1) / 2, std::cout, "\nCompute frustum intersection\n");
+    auto progressDisplay = system::createConsoleProgressDisplay(nbViews, std::cout, "\nCompute frustum intersection\n");
 
-// Exhaustive comparison (use the fact that the intersect function is symmetric)
-#pragma omp parallel for
-    for (int i = 0; i < (int)viewIds.size(); ++i)
+    // Exact intersection test on the candidate pairs (i, j) with i < j, the intersect function is symmetric
+    std::vector<std::vector<int>> intersectingViews(nbViews);
+#pragma omp parallel for schedule(dynamic)
+    for (int i = 0; i < nbViews; ++i)
     {
-        for (size_t j = i + 1; j < viewIds.size(); ++j)
+        std::vector<int>& candidates = intersectingViews[i];
+        if (boxPerView[i] != -1)
         {
-            if (frustum_perView.at(viewIds[i]).intersect(frustum_perView.at(viewIds[j])))
+            tree.forEachIntersecting(boxes[boxPerView[i]], [&](int boxIndex) {
+                if (boundedViews[boxIndex] > i)
+                    candidates.push_back(boundedViews[boxIndex]);
+            });
+            for (int j = i + 1; j < nbViews; ++j)
             {
-#pragma omp critical
-                {
-                    pairs.insert(std::make_pair(viewIds[i], viewIds[j]));
-                }
+                if (boxPerView[j] == -1)
+                    candidates.push_back(j);
             }
-            ++progressDisplay;
         }
+        else
+        {
+            for (int j = i + 1; j < nbViews; ++j)
+                candidates.push_back(j);
+        }
+
+        candidates.erase(std::remove_if(candidates.begin(), candidates.end(), [&](int j) { return !frustums[i]->intersect(*frustums[j]); }),
+                         candidates.end());
+        ++progressDisplay;
+    }
+
+    PairSet pairs;
+    for (int i = 0; i < nbViews; ++i)
+    {
+        for (const int j : intersectingViews[i])
+            pairs.insert(std::make_pair(viewIds[i], viewIds[j]));
     }
     return pairs;
 }
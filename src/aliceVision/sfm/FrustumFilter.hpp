@@ -32,6 +32,9 @@ class FrustumFilter
     /// return intersecting View frustum pairs
     PairSet getFrustumIntersectionPairs() const;
 
+    /// return the frustum of the valid views
+    const FrustumsT& getFrustums() const { return frustum_perView; }
+
     /// export defined frustum in PLY file for viewing
     bool export_Ply(const std::string& filename) const;
 
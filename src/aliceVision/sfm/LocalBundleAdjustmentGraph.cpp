@@ -7,6 +7,7 @@
 #include "LocalBundleAdjustmentGraph.hpp"
 #include <aliceVision/stl/stl.hpp>
 #include <aliceVision/sfmData/SfMData.hpp>
+#include <aliceVision/alicevision_omp.hpp>
 #include <boost/filesystem.hpp>
 
 #include <lemon/bfs.h>
@@ -59,16 +60,19 @@ void LocalBundleAdjustmentGraph::setAllParametersToRefine(const sfmData::SfMData
     _statePerLandmarkId.clear();
 
     // poses
+    _statePerPoseId.reserve(sfmData.getPoses().size());
     for (sfmData::Poses::const_iterator itPose = sfmData.getPoses().begin(); itPose != sfmData.getPoses().end(); ++itPose)
-        _statePerPoseId[itPose->first] = BundleAdjustment::EParameterState::REFINED;
+        _statePerPoseId.emplace_hint(_statePerPoseId.end(), itPose->first, BundleAdjustment::EParameterState::REFINED);
 
     // instrinsics
+    _statePerIntrinsicId.reserve(sfmData.getIntrinsics().size());
     for (const auto& itIntrinsic : sfmData.getIntrinsics())
-        _statePerIntrinsicId[itIntrinsic.first] = BundleAdjustment::EParameterState::REFINED;
+        _statePerIntrinsicId.emplace_hint(_statePerIntrinsicId.end(), itIntrinsic.first, BundleAdjustment::EParameterState::REFINED);
 
     // landmarks
+    _statePerLandmarkId.reserve(sfmData.getLandmarks().size());
     for (const auto& itLandmark : sfmData.getLandmarks())
-        _statePerLandmarkId[itLandmark.first] = BundleAdjustment::EParameterState::REFINED;
+        _statePerLandmarkId.emplace_hint(_statePerLandmarkId.end(), itLandmark.first, BundleAdjustment::EParameterState::REFINED);
 }
 
 void LocalBundleAdjustmentGraph::saveIntrinsicsToHistory(const sfmData::SfMData& sfmData)
@@ -321,9 +325,15 @@ void LocalBundleAdjustmentGraph::computeGraphDistances(const sfmData::SfMData& s
         else
             bfs.addSource(it->second);
     }
-    bfs.start();
+
+    // bounded-depth visit: the nodes further than the constant region (limit + 1) are ignored in any case,
+    // so the nodes at this distance are reached but not expanded
+    const int maxDistance = static_cast<int>(_graphDistanceLimit) + 1;
+    while (!bfs.emptyQueue() && bfs.dist(bfs.nextNode()) < maxDistance)
+        bfs.processNextNode();
 
     // handle bfs results (distances)
+    _distancePerViewId.reserve(_nodePerViewId.size());
     for (const auto& x : _nodePerViewId)  // each node in the graph
     {
         auto& node = x.second;
@@ -335,7 +345,7 @@ void LocalBundleAdjustmentGraph::computeGraphDistances(const sfmData::SfMData& s
             // dist(): "If node v is not reached from the root(s), then the return value of this function is undefined."
             // this is why the distance is previously set to -1.
         }
-        _distancePerViewId[x.first] = d;
+        _distancePerViewId.emplace_hint(_distancePerViewId.end(), x.first, d);
     }
 
     // re-mapping from <ViewId, distance> to <PoseId, distance>:
@@ -345,11 +355,11 @@ void LocalBundleAdjustmentGraph::computeGraphDistances(const sfmData::SfMData& s
         const IndexT idPose = sfmData.getViews().at(x.first)->getPoseId();  // PoseId of a resected camera
 
         auto poseIt = _distancePerPoseId.find(idPose);
-        // if multiple views share the same pose
-        if (poseIt != _distancePerPoseId.end())
-            poseIt->second = std::min(poseIt->second, x.second);
-        else
+        // if multiple views share the same pose (-1 is the largest distance)
+        if (poseIt == _distancePerPoseId.end())
             _distancePerPoseId[idPose] = x.second;
+        else if (poseIt->second == -1 || (x.second != -1 && x.second < poseIt->second))
+            poseIt->second = x.second;
     }
 }
 
@@ -379,39 +389,55 @@ void LocalBundleAdjustmentGraph::convertDistancesToStates(const sfmData::SfMData
     //    - Refined <=> its connected to a refined camera
 
     // poses
+    _statePerPoseId.reserve(sfmData.getPoses().size());
     for (const auto& posePair : sfmData.getPoses())
     {
         const IndexT poseId = posePair.first;
         const int distance = getPoseDistance(poseId);
         const BundleAdjustment::EParameterState state = getStateFromDistance(distance);
 
-        _statePerPoseId[poseId] = state;
+        _statePerPoseId.emplace_hint(_statePerPoseId.end(), poseId, state);
     }
 
     // instrinsics
     checkFocalLengthsConsistency(kWindowSize, kStdevPercentage);
 
+    _statePerIntrinsicId.reserve(sfmData.getIntrinsics().size());
     for (const auto& itIntrinsic : sfmData.getIntrinsics())
     {
-        if (isFocalLengthConstant(itIntrinsic.first))
-            _statePerIntrinsicId[itIntrinsic.first] = BundleAdjustment::EParameterState::CONSTANT;
-        else
-            _statePerIntrinsicId[itIntrinsic.first] = BundleAdjustment::EParameterState::REFINED;
+        _statePerIntrinsicId.emplace_hint(_statePerIntrinsicId.end(),
+                                          itIntrinsic.first,
+                                          isFocalLengthConstant(itIntrinsic.first) ? BundleAdjustment::EParameterState::CONSTANT
+                                                                                   : BundleAdjustment::EParameterState::REFINED);
     }
 
+    // state of each posed view, looked up for each observation
+    stl::flat_map<IndexT, BundleAdjustment::EParameterState> statePerViewId;
+    statePerViewId.reserve(_distancePerViewId.size());
+    for (const auto& viewDistance : _distancePerViewId)
+        statePerViewId.emplace_hint(statePerViewId.end(), viewDistance.first, getStateFromDistance(viewDistance.second));
+
     // landmarks
+    std::vector<std::pair<IndexT, BundleAdjustment::EParameterState>> landmarksStates;
+    landmarksStates.reserve(sfmData.getLandmarks().size());
     for (const auto& itLandmark : sfmData.getLandmarks())
+        landmarksStates.emplace_back(itLandmark.first, BundleAdjustment::EParameterState::IGNORED);
+
+#pragma omp parallel for schedule(dynamic, 1024)
+    for (int i = 0; i < static_cast<int>(landmarksStates.size()); ++i)
     {
-        const IndexT landmarkId = itLandmark.first;
-        const sfmData::Observations& observations = itLandmark.second.observations;
+        const IndexT landmarkId = landmarksStates[i].first;
+        const sfmData::Observations& observations = sfmData.getLandmarks().at(landmarkId).observations;
 
         assert(observations.size() >= 2);
 
         std::array<bool, 3> states = {false, false, false};
         for (const auto& observationIt : observations)
         {
-            const int distance = getViewDistance(observationIt.first);
-            const BundleAdjustment::EParameterState viewState = getStateFromDistance(distance);
+            // views missing from the graph are not connected to the new views
+            const auto viewStateIt = statePerViewId.find(observationIt.first);
+            const BundleAdjustment::EParameterState viewState =
+              (viewStateIt != statePerViewId.end()) ? viewStateIt->second : BundleAdjustment::EParameterState::IGNORED;
             states.at(static_cast<std::size_t>(viewState)) = true;
         }
 
@@ -421,12 +447,17 @@ void LocalBundleAdjustmentGraph::convertDistancesToStates(const sfmData::SfMData
         // for these particular cases, we can have landmarks with refined AND ignored cameras.
         // in this particular case, we prefer to ignore the landmark to avoid wrong/unconstraint refinements.
 
-        if (!states.at(static_cast<std::size_t>(BundleAdjustment::EParameterState::REFINED)) ||
-            states.at(static_cast<std::size_t>(BundleAdjustment::EParameterState::IGNORED)))
-            _statePerLandmarkId[landmarkId] = BundleAdjustment::EParameterState::IGNORED;
-        else
-            _statePerLandmarkId[landmarkId] = BundleAdjustment::EParameterState::REFINED;
+        if (states.at(static_cast<std::size_t>(BundleAdjustment::EParameterState::REFINED)) &&
+            !states.at(static_cast<std::size_t>(BundleAdjustment::EParameterState::IGNORED)))
+            landmarksStates[i].second = BundleAdjustment::EParameterState::REFINED;
     }
+
+    // the landmarks are sorted by id with the default HashMap
+    if (!std::is_sorted(landmarksStates.begin(), landmarksStates.end()))
+        std::sort(landmarksStates.begin(), landmarksStates.end());
+    _statePerLandmarkId.reserve(landmarksStates.size());
+    for (const auto& landmarkState : landmarksStates)
+        _statePerLandmarkId.emplace_hint(_statePerLandmarkId.end(), landmarkState.first, landmarkState.second);
 }
 
 std::vector<Pair> LocalBundleAdjustmentGraph::getNewEdges(const sfmData::SfMData& sfmData,
@@ -437,11 +468,6 @@ std::vector<Pair> LocalBundleAdjustmentGraph::getNewEdges(const sfmData::SfMData
 {
     std::vector<Pair> newEdges;
 
-    // get landmarks id. of all the reconstructed 3D points (: landmarks)
-    // TODO: avoid copy and use boost::transform_iterator
-    std::set<IndexT> landmarkIds;
-    std::transform(sfmData.getLandmarks().begin(), sfmData.getLandmarks().end(), std::inserter(landmarkIds, landmarkIds.begin()), stl::RetrieveKey());
-
     for (IndexT viewId : newViewsId)
     {
         std::map<IndexT, std::size_t> sharedLandmarksPerView;
@@ -449,17 +475,15 @@ std::vector<Pair> LocalBundleAdjustmentGraph::getNewEdges(const sfmData::SfMData
         // get all the tracks of the new added view
         const aliceVision::track::TrackIdSet& newViewTrackIds = tracksPerView.at(viewId);
 
-        // keep the reconstructed tracks (with an associated landmark)
-        std::vector<IndexT> newViewLandmarks;  // all landmarks (already reconstructed) visible from the new view
-
-        newViewLandmarks.reserve(newViewTrackIds.size());
-        std::set_intersection(
-          newViewTrackIds.begin(), newViewTrackIds.end(), landmarkIds.begin(), landmarkIds.end(), std::back_inserter(newViewLandmarks));
-
-        // retrieve the common track Ids
-        for (IndexT landmarkId : newViewLandmarks)
+        // retrieve the common track Ids, for the reconstructed tracks only (with an associated landmark):
+        // lookup of the tracks of the view, not proportional to the number of landmarks of the scene
+        for (IndexT trackId : newViewTrackIds)
         {
-            for (const auto& observations : sfmData.getLandmarks().at(landmarkId).observations)
+            const auto landmarkIt = sfmData.getLandmarks().find(trackId);
+            if (landmarkIt == sfmData.getLandmarks().end())
+                continue;
+
+            for (const auto& observations : landmarkIt->second.observations)
             {
                 if (observations.first == viewId)
                     continue;  // do not compare an observation with itself
@@ -7,6 +7,7 @@
 #pragma once
 
 #include <aliceVision/types.hpp>
+#include <aliceVision/stl/FlatMap.hpp>
 #include <aliceVision/track/TracksBuilder.hpp>
 #include <aliceVision/sfm/bundle/BundleAdjustment.hpp>
 
@@ -153,6 +154,8 @@ class LocalBundleAdjustmentGraph
     /**
      * @brief Compute the intragraph-distance between all the nodes of the graph (posed views) and the newly resected views.
      * @details The graph-distances are computed using a Breadth-first Search (BFS) method.
+     * The search stops at the graph-distance limit + 1 (the constant region): the views further away
+     * are ignored in any case, so they get the -1 distance of the views not connected to the new views.
      * @param[in] sfmData contains all the information about the reconstruction, notably the posed views
      * @param[in] newReconstructedViews The list of the newly resected views used (used as source in the BFS algorithm)
      */
@@ -304,15 +307,15 @@ class LocalBundleAdjustmentGraph
     /// Associates each node (in the graph) to its corresponding view.
     std::map<lemon::ListGraph::Node, IndexT> _viewIdPerNode;
     /// Store the graph-distances from the new views (0: is a new view, -1: is not connected to the new views)
-    std::map<IndexT, int> _distancePerViewId;
+    stl::flat_map<IndexT, int> _distancePerViewId;
     /// Store the graph-distances from the new poses (0: is a new pose, -1: is not connected to the new poses)
-    std::map<IndexT, int> _distancePerPoseId;
+    stl::flat_map<IndexT, int> _distancePerPoseId;
     /// Store the \c EParameterState of each pose in the scene.
-    std::map<IndexT, BundleAdjustment::EParameterState> _statePerPoseId;
+    stl::flat_map<IndexT, BundleAdjustment::EParameterState> _statePerPoseId;
     /// Store the \c EParameterState of each intrinsic in the scene.
-    std::map<IndexT, BundleAdjustment::EParameterState> _statePerIntrinsicId;
+    stl::flat_map<IndexT, BundleAdjustment::EParameterState> _statePerIntrinsicId;
     /// Store the \c EParameterState of each landmark in the scene.
-    std::map<IndexT, BundleAdjustment::EParameterState> _statePerLandmarkId;
+    stl::flat_map<IndexT, BundleAdjustment::EParameterState> _statePerLandmarkId;
 
     // Intrinsics data
     // - Local BA needs to know the evolution of all the intrinsics parameters.
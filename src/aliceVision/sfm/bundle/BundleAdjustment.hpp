@@ -73,6 +73,60 @@ inline std::istream& operator>>(std::istream& in, EFeatureConstraint& m)
     return in;
 }
 
+/**
+ * @brief Defines the Schur complement linear solvers of the bundle adjustment.
+ */
+enum class EBundleAdjustmentSolver
+{
+    AUTO = 0,             //< dense for small problems, sparse for large ones
+    DENSE_SCHUR = 1,      //< dense factorization of the reduced camera system
+    SPARSE_SCHUR = 2,     //< sparse factorization of the reduced camera system
+    ITERATIVE_SCHUR = 3   //< preconditioned conjugate gradient on the reduced camera system
+};
+
+inline std::string EBundleAdjustmentSolver_enumToString(EBundleAdjustmentSolver m)
+{
+    switch (m)
+    {
+        case EBundleAdjustmentSolver::AUTO:
+            return "auto";
+        case EBundleAdjustmentSolver::DENSE_SCHUR:
+            return "denseSchur";
+        case EBundleAdjustmentSolver::SPARSE_SCHUR:
+            return "sparseSchur";
+        case EBundleAdjustmentSolver::ITERATIVE_SCHUR:
+            return "iterativeSchur";
+    }
+    throw std::out_of_range("Invalid EBundleAdjustmentSolver enum: " + std::to_string(int(m)));
+}
+
+inline EBundleAdjustmentSolver EBundleAdjustmentSolver_stringToEnum(const std::string& m)
+{
+    std::string solver = m;
+    std::transform(solver.begin(), solver.end(), solver.begin(), ::tolower);
+
+    if (solver == "auto")
+        return EBundleAdjustmentSolver::AUTO;
+    if (solver == "denseschur")
+        return EBundleAdjustmentSolver::DENSE_SCHUR;
+    if (solver == "sparseschur")
+        return EBundleAdjustmentSolver::SPARSE_SCHUR;
+    if (solver == "iterativeschur")
+        return EBundleAdjustmentSolver::ITERATIVE_SCHUR;
+
+    throw std::out_of_range("Invalid EBundleAdjustmentSolver: " + m);
+}
+
+inline std::ostream& operator<<(std::ostream& os, EBundleAdjustmentSolver m) { return os << EBundleAdjustmentSolver_enumToString(m); }
+
+inline std::istream& operator>>(std::istream& in, EBundleAdjustmentSolver& m)
+{
+    std::string token;
+    in >> token;
+    m = EBundleAdjustmentSolver_stringToEnum(token);
+    return in;
+}
+
 class BundleAdjustment
 {
   public:
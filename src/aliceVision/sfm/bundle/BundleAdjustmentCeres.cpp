@@ -19,7 +19,9 @@
 #include <ceres/rotation.h>
 
 #include <fstream>
+#include <limits>
 #include <memory>
+#include <set>
 
 namespace fs = boost::filesystem;
 
@@ -184,6 +186,30 @@ class IntrinsicsManifold : public ceres::Manifold
     bool _lockDistortion;
 };
 
+/**
+ * @brief Create the automatic differentiation cost function of a Pinhole residual functor
+ *        The size of the intrinsic block is given by the functor distortion model.
+ * @param[in] functor The residual functor, owned by the cost function
+ * @return cost functor
+ */
+template<typename ResidualFunctor>
+ceres::CostFunction* createAutoDiffCostFunction(ResidualFunctor* functor)
+{
+    return new ceres::AutoDiffCostFunction<ResidualFunctor, 2, ResidualFunctor::nbIntrinsicParams, 6, 3>(functor);
+}
+
+/**
+ * @brief Create the automatic differentiation cost function of a Pinhole residual functor with a rig sub-pose
+ *        The size of the intrinsic block is given by the functor distortion model.
+ * @param[in] functor The residual functor, owned by the cost function
+ * @return cost functor
+ */
+template<typename ResidualFunctor>
+ceres::CostFunction* createRigAutoDiffCostFunction(ResidualFunctor* functor)
+{
+    return new ceres::AutoDiffCostFunction<ResidualFunctor, 2, ResidualFunctor::nbIntrinsicParams, 6, 6, 3>(functor);
+}
+
 /**
  * @brief Create the appropriate cost functor according the provided input camera intrinsic model
  * @param[in] intrinsicPtr The intrinsic pointer
@@ -210,30 +236,23 @@ ceres::CostFunction* createCostFunctionFromIntrinsics(const IntrinsicBase* intri
     switch (intrinsicPtr->getType())
     {
         case EINTRINSIC::PINHOLE_CAMERA:
-            return new ceres::AutoDiffCostFunction<ResidualErrorFunctor_Pinhole, 2, 4, 6, 3>(new ResidualErrorFunctor_Pinhole(w, h, obsUndistorted));
+            return createAutoDiffCostFunction(new ResidualErrorFunctor_Pinhole(w, h, obsUndistorted));
         case EINTRINSIC::PINHOLE_CAMERA_RADIAL1:
-            return new ceres::AutoDiffCostFunction<ResidualErrorFunctor_PinholeRadialK1, 2, 5, 6, 3>(
-              new ResidualErrorFunctor_PinholeRadialK1(w, h, obsUndistorted));
+            return createAutoDiffCostFunction(new ResidualErrorFunctor_PinholeRadialK1(w, h, obsUndistorted));
         case EINTRINSIC::PINHOLE_CAMERA_RADIAL3:
-            return new ceres::AutoDiffCostFunction<ResidualErrorFunctor_PinholeRadialK3, 2, 7, 6, 3>(
-              new ResidualErrorFunctor_PinholeRadialK3(w, h, obsUndistorted));
+            return createAutoDiffCostFunction(new ResidualErrorFunctor_PinholeRadialK3(w, h, obsUndistorted));
         case EINTRINSIC::PINHOLE_CAMERA_3DERADIAL4:
-            return new ceres::AutoDiffCostFunction<ResidualErrorFunctor_Pinhole3DERadial4, 2, 10, 6, 3>(
-              new ResidualErrorFunctor_Pinhole3DERadial4(w, h, obsUndistorted));
+            return createAutoDiffCostFunction(new ResidualErrorFunctor_Pinhole3DERadial4(w, h, obsUndistorted));
         case EINTRINSIC::PINHOLE_CAMERA_3DECLASSICLD:
-            return new ceres::AutoDiffCostFunction<ResidualErrorFunctor_Pinhole3DEClassicLD, 2, 9, 6, 3>(
-              new ResidualErrorFunctor_Pinhole3DEClassicLD(w, h, obsUndistorted));
+            return createAutoDiffCostFunction(new ResidualErrorFunctor_Pinhole3DEClassicLD(w, h, obsUndistorted));
         case EINTRINSIC::PINHOLE_CAMERA_3DEANAMORPHIC4:
-            return new ceres::AutoDiffCostFunction<ResidualErrorFunctor_Pinhole, 2, 4, 6, 3>(new ResidualErrorFunctor_Pinhole(w, h, obsUndistorted));
+            return createAutoDiffCostFunction(new ResidualErrorFunctor_Pinhole(w, h, obsUndistorted));
         case EINTRINSIC::PINHOLE_CAMERA_BROWN:
-            return new ceres::AutoDiffCostFunction<ResidualErrorFunctor_PinholeBrownT2, 2, 9, 6, 3>(
-              new ResidualErrorFunctor_PinholeBrownT2(w, h, obsUndistorted));
+            return createAutoDiffCostFunction(new ResidualErrorFunctor_PinholeBrownT2(w, h, obsUndistorted));
         case EINTRINSIC::PINHOLE_CAMERA_FISHEYE:
-            return new ceres::AutoDiffCostFunction<ResidualErrorFunctor_PinholeFisheye, 2, 8, 6, 3>(
-              new ResidualErrorFunctor_PinholeFisheye(w, h, obsUndistorted));
+            return createAutoDiffCostFunction(new ResidualErrorFunctor_PinholeFisheye(w, h, obsUndistorted));
         case EINTRINSIC::PINHOLE_CAMERA_FISHEYE1:
-            return new ceres::AutoDiffCostFunction<ResidualErrorFunctor_PinholeFisheye1, 2, 5, 6, 3>(
-              new ResidualErrorFunctor_PinholeFisheye1(w, h, obsUndistorted));
+            return createAutoDiffCostFunction(new ResidualErrorFunctor_PinholeFisheye1(w, h, obsUndistorted));
         default:
             throw std::logic_error("Cannot create cost function, unrecognized intrinsic type in BA.");
     }
@@ -265,37 +284,101 @@ ceres::CostFunction* createRigCostFunctionFromIntrinsics(const IntrinsicBase* in
     switch (intrinsicPtr->getType())
     {
         case EINTRINSIC::PINHOLE_CAMERA:
-            return new ceres::AutoDiffCostFunction<ResidualErrorFunctor_Pinhole, 2, 4, 6, 6, 3>(
-              new ResidualErrorFunctor_Pinhole(w, h, obsUndistorted));
+            return createRigAutoDiffCostFunction(new ResidualErrorFunctor_Pinhole(w, h, obsUndistorted));
         case EINTRINSIC::PINHOLE_CAMERA_RADIAL1:
-            return new ceres::AutoDiffCostFunction<ResidualErrorFunctor_PinholeRadialK1, 2, 5, 6, 6, 3>(
-              new ResidualErrorFunctor_PinholeRadialK1(w, h, obsUndistorted));
+            return createRigAutoDiffCostFunction(new ResidualErrorFunctor_PinholeRadialK1(w, h, obsUndistorted));
         case EINTRINSIC::PINHOLE_CAMERA_RADIAL3:
-            return new ceres::AutoDiffCostFunction<ResidualErrorFunctor_PinholeRadialK3, 2, 7, 6, 6, 3>(
-              new ResidualErrorFunctor_PinholeRadialK3(w, h, obsUndistorted));
+            return createRigAutoDiffCostFunction(new ResidualErrorFunctor_PinholeRadialK3(w, h, obsUndistorted));
         case EINTRINSIC::PINHOLE_CAMERA_3DERADIAL4:
-            return new ceres::AutoDiffCostFunction<ResidualErrorFunctor_Pinhole3DERadial4, 2, 10, 6, 6, 3>(
-              new ResidualErrorFunctor_Pinhole3DERadial4(w, h, obsUndistorted));
+            return createRigAutoDiffCostFunction(new ResidualErrorFunctor_Pinhole3DERadial4(w, h, obsUndistorted));
         case EINTRINSIC::PINHOLE_CAMERA_3DECLASSICLD:
-            return new ceres::AutoDiffCostFunction<ResidualErrorFunctor_Pinhole3DEClassicLD, 2, 9, 6, 6, 3>(
-              new ResidualErrorFunctor_Pinhole3DEClassicLD(w, h, obsUndistorted));
+            return createRigAutoDiffCostFunction(new ResidualErrorFunctor_Pinhole3DEClassicLD(w, h, obsUndistorted));
         case EINTRINSIC::PINHOLE_CAMERA_3DEANAMORPHIC4:
-            return new ceres::AutoDiffCostFunction<ResidualErrorFunctor_Pinhole, 2, 4, 6, 6, 3>(
-              new ResidualErrorFunctor_Pinhole(w, h, obsUndistorted));
+            return createRigAutoDiffCostFunction(new ResidualErrorFunctor_Pinhole(w, h, obsUndistorted));
         case EINTRINSIC::PINHOLE_CAMERA_BROWN:
-            return new ceres::AutoDiffCostFunction<ResidualErrorFunctor_PinholeBrownT2, 2, 9, 6, 6, 3>(
-              new ResidualErrorFunctor_PinholeBrownT2(w, h, obsUndistorted));
+            return createRigAutoDiffCostFunction(new ResidualErrorFunctor_PinholeBrownT2(w, h, obsUndistorted));
         case EINTRINSIC::PINHOLE_CAMERA_FISHEYE:
-            return new ceres::AutoDiffCostFunction<ResidualErrorFunctor_PinholeFisheye, 2, 8, 6, 6, 3>(
-              new ResidualErrorFunctor_PinholeFisheye(w, h, obsUndistorted));
+            return createRigAutoDiffCostFunction(new ResidualErrorFunctor_PinholeFisheye(w, h, obsUndistorted));
         case EINTRINSIC::PINHOLE_CAMERA_FISHEYE1:
-            return new ceres::AutoDiffCostFunction<ResidualErrorFunctor_PinholeFisheye1, 2, 5, 6, 6, 3>(
-              new ResidualErrorFunctor_PinholeFisheye1(w, h, obsUndistorted));
+            return createRigAutoDiffCostFunction(new ResidualErrorFunctor_PinholeFisheye1(w, h, obsUndistorted));
         default:
             throw std::logic_error("Cannot create rig cost function, unrecognized intrinsic type in BA.");
     }
 }
 
+/**
+ * @brief Create the appropriate cost functor according the provided input rig camera intrinsic model,
+ *        with a constant rig sub-pose folded in the functor
+ * @param[in] intrinsicPtr The intrinsic pointer
+ * @param[in] observation The corresponding observation
+ * @param[in] subPose The constant sub-pose of the camera in the rig
+ * @return cost functor, with the parameter blocks of a camera without rig
+ */
+ceres::CostFunction* createConstantSubPoseCostFunctionFromIntrinsics(const IntrinsicBase* intrinsicPtr,
+                                                                     const sfmData::Observation& observation,
+                                                                     const geometry::Pose3& subPose)
+{
+    int w = intrinsicPtr->w();
+    int h = intrinsicPtr->h();
+
+    // Apply undistortion to observation
+    sfmData::Observation obsUndistorted = observation;
+    const camera::IntrinsicScaleOffsetDisto* intrinsicDistortionPtr = dynamic_cast<const camera::IntrinsicScaleOffsetDisto*>(intrinsicPtr);
+    if (intrinsicDistortionPtr)
+    {
+        auto undistortion = intrinsicDistortionPtr->getUndistortion();
+        if (undistortion)
+        {
+            obsUndistorted.x = undistortion->undistort(observation.x);
+        }
+    }
+
+    switch (intrinsicPtr->getType())
+    {
+        case EINTRINSIC::PINHOLE_CAMERA:
+            return createAutoDiffCostFunction(
+              new ResidualErrorFunctor_PinholeConstantSubPoseT<PinholeDistortion_None>(w, h, obsUndistorted, subPose));
+        case EINTRINSIC::PINHOLE_CAMERA_RADIAL1:
+            return createAutoDiffCostFunction(
+              new ResidualErrorFunctor_PinholeConstantSubPoseT<PinholeDistortion_RadialK1>(w, h, obsUndistorted, subPose));
+        case EINTRINSIC::PINHOLE_CAMERA_RADIAL3:
+            return createAutoDiffCostFunction(
+              new ResidualErrorFunctor_PinholeConstantSubPoseT<PinholeDistortion_RadialK3>(w, h, obsUndistorted, subPose));
+        case EINTRINSIC::PINHOLE_CAMERA_3DERADIAL4:
+            return createAutoDiffCostFunction(
+              new ResidualErrorFunctor_PinholeConstantSubPoseT<PinholeDistortion_3DERadial4>(w, h, obsUndistorted, subPose));
+        case EINTRINSIC::PINHOLE_CAMERA_3DECLASSICLD:
+            return createAutoDiffCostFunction(
+              new ResidualErrorFunctor_PinholeConstantSubPoseT<PinholeDistortion_3DEClassicLD>(w, h, obsUndistorted, subPose));
+        case EINTRINSIC::PINHOLE_CAMERA_3DEANAMORPHIC4:
+            return createAutoDiffCostFunction(
+              new ResidualErrorFunctor_PinholeConstantSubPoseT<PinholeDistortion_None>(w, h, obsUndistorted, subPose));
+        case EINTRINSIC::PINHOLE_CAMERA_BROWN:
+            return createAutoDiffCostFunction(
+              new ResidualErrorFunctor_PinholeConstantSubPoseT<PinholeDistortion_BrownT2>(w, h, obsUndistorted, subPose));
+        case EINTRINSIC::PINHOLE_CAMERA_FISHEYE:
+            return createAutoDiffCostFunction(
+              new ResidualErrorFunctor_PinholeConstantSubPoseT<PinholeDistortion_Fisheye>(w, h, obsUndistorted, subPose));
+        case EINTRINSIC::PINHOLE_CAMERA_FISHEYE1:
+            return createAutoDiffCostFunction(
+              new ResidualErrorFunctor_PinholeConstantSubPoseT<PinholeDistortion_Fisheye1>(w, h, obsUndistorted, subPose));
+        default:
+            throw std::logic_error("Cannot create rig cost function, unrecognized intrinsic type in BA.");
+    }
+}
+
+/**
+ * @brief Get the sub-pose of a view of a rig if it is constant
+ * @param[in] sfmData The input SfMData
+ * @param[in] view The view, part of a rig
+ * @return the constant sub-pose, nullptr if the sub-pose is refined
+ */
+const geometry::Pose3* getConstantRigSubPose(const sfmData::SfMData& sfmData, const sfmData::View& view)
+{
+    const sfmData::RigSubPose& rigSubPose = sfmData.getRigs().at(view.getRigId()).getSubPose(view.getSubPoseId());
+    return (rigSubPose.status == sfmData::ERigSubPoseStatus::CONSTANT) ? &rigSubPose.pose : nullptr;
+}
+
 /**
  * @brief Create the appropriate cost functor according the provided input camera intrinsic model
  * @param[in] intrinsicPtr The intrinsic pointer
@@ -383,6 +466,37 @@ void BundleAdjustmentCeres::CeresOptions::setSparseBA()
     }
 }
 
+void BundleAdjustmentCeres::CeresOptions::setIterativeBA()
+{
+    // the Schur complement is never built, so the memory stays linear in the number of cameras
+    preconditionerType = ceres::SCHUR_JACOBI;
+    linearSolverType = ceres::ITERATIVE_SCHUR;
+    sparseLinearAlgebraLibraryType = ceres::SUITE_SPARSE;  // not used but just to avoid a warning in ceres
+    ALICEVISION_LOG_DEBUG("BundleAdjustment[Ceres]: ITERATIVE_SCHUR, SCHUR_JACOBI");
+}
+
+void BundleAdjustmentCeres::CeresOptions::setSolver(EBundleAdjustmentSolver solver, bool preferSparse)
+{
+    switch (solver)
+    {
+        case EBundleAdjustmentSolver::AUTO:
+            if (preferSparse)
+                setSparseBA();
+            else
+                setDenseBA();
+            break;
+        case EBundleAdjustmentSolver::DENSE_SCHUR:
+            setDenseBA();
+            break;
+        case EBundleAdjustmentSolver::SPARSE_SCHUR:
+            setSparseBA();
+            break;
+        case EBundleAdjustmentSolver::ITERATIVE_SCHUR:
+            setIterativeBA();
+            break;
+    }
+}
+
 bool BundleAdjustmentCeres::Statistics::exportToFile(const std::string& folder, const std::string& filename) const
 {
     std::ofstream os;
@@ -511,6 +625,26 @@ void BundleAdjustmentCeres::setSolverOptions(ceres::Solver::Options& solverOptio
     solverOptions.num_linear_solver_threads = _ceresOptions.nbThreads;
 #endif
 
+    if (_ceresOptions.useMixedPrecision)
+    {
+#if CERES_VERSION_MAJOR >= 2
+        solverOptions.use_mixed_precision_solves = true;
+        solverOptions.max_num_refinement_iterations = 3;
+#else
+        ALICEVISION_LOG_WARNING("BundleAdjustment[Ceres]: mixed precision solves require Ceres 2, fallback to double precision.");
+#endif
+    }
+
+    if (_ceresOptions.useGpu)
+    {
+#if CERES_VERSION_MAJOR > 2 || (CERES_VERSION_MAJOR == 2 && CERES_VERSION_MINOR >= 1)
+        if (ceres::IsDenseLinearAlgebraLibraryTypeAvailable(ceres::CUDA))
+            solverOptions.dense_linear_algebra_library_type = ceres::CUDA;
+        else
+#endif
+            ALICEVISION_LOG_WARNING("BundleAdjustment[Ceres]: CUDA is not available in Ceres, fallback to the CPU.");
+    }
+
     if (_ceresOptions.useParametersOrdering)
     {
         // copy ParameterBlockOrdering
@@ -824,12 +958,26 @@ void BundleAdjustmentCeres::addLandmarksToProblem(const sfmData::SfMData& sfmDat
                 _linearSolverOrdering.AddElementToGroup(intrinsicBlockPtr, 2);
             }
 
-            if (view.isPartOfRig() && !view.isPoseIndependant())
+            const bool isRigView = view.isPartOfRig() && !view.isPoseIndependant();
+            const geometry::Pose3* constantSubPose = isRigView ? getConstantRigSubPose(sfmData, view) : nullptr;
+
+            if (constantSubPose != nullptr)
+            {
+                // the constant sub-pose is folded in the cost function, only the rig pose is refined
+                ceres::CostFunction* costFunction =
+                  createConstantSubPoseCostFunctionFromIntrinsics(sfmData.getIntrinsicPtr(view.getIntrinsicId()), observation, *constantSubPose);
+
+                problem.AddResidualBlock(costFunction, lossFunction, intrinsicBlockPtr, poseBlockPtr, landmarkBlockPtr);
+            }
+            else if (isRigView)
             {
                 ceres::CostFunction* costFunction = createRigCostFunctionFromIntrinsics(sfmData.getIntrinsicPtr(view.getIntrinsicId()), observation);
 
                 double* rigBlockPtr = _rigBlocks.at(view.getRigId()).at(view.getSubPoseId()).data();
-                _linearSolverOrdering.AddElementToGroup(rigBlockPtr, 1);
+
+                // the sub-poses are shared by all the rig poses, they are eliminated last like the intrinsics
+                if (_ceresOptions.useParametersOrdering)
+                    _linearSolverOrdering.AddElementToGroup(rigBlockPtr, 2);
 
                 problem.AddResidualBlock(costFunction,
                                          lossFunction,
@@ -890,7 +1038,7 @@ void BundleAdjustmentCeres::addConstraints2DToProblem(const sfmData::SfMData& sf
 
         ceres::CostFunction* costFunction = createConstraintsCostFunctionFromIntrinsics(
           sfmData.getIntrinsicPtr(view_1.getIntrinsicId()), constraint.ObservationFirst.x, constraint.ObservationSecond.x);
-        problem.AddResidualBlock(costFunction, lossFunction, intrinsicBlockPtr_1, poseBlockPtr_1, poseBlockPtr_2);
+        _constraintsResiduals.push_back(problem.AddResidualBlock(costFunction, lossFunction, intrinsicBlockPtr_1, poseBlockPtr_1, poseBlockPtr_2));
     }
 }
 
@@ -913,7 +1061,7 @@ void BundleAdjustmentCeres::addRotationPriorsToProblem(const sfmData::SfMData& s
 
         ceres::CostFunction* costFunction =
           new ceres::AutoDiffCostFunction<ResidualErrorRotationPriorFunctor, 3, 6, 6>(new ResidualErrorRotationPriorFunctor(prior._second_R_first));
-        problem.AddResidualBlock(costFunction, lossFunction, poseBlockPtr_1, poseBlockPtr_2);
+        _constraintsResiduals.push_back(problem.AddResidualBlock(costFunction, lossFunction, poseBlockPtr_1, poseBlockPtr_2));
     }
 }
 
@@ -946,6 +1094,14 @@ void BundleAdjustmentCeres::resetProblem()
 {
     _statistics = Statistics();
 
+    // the persistent problem refers to the blocks wrappers
+    _persistentProblem.reset();
+    _persistentLossFunction.reset();
+    _observationsResiduals.clear();
+    _persistentManifolds.clear();
+    _persistentPosesConstantParameters.clear();
+    _constraintsResiduals.clear();
+
     _allParametersBlocks.clear();
     _posesBlocks.clear();
     _intrinsicsBlocks.clear();
@@ -955,6 +1111,510 @@ void BundleAdjustmentCeres::resetProblem()
     _linearSolverOrdering.Clear();
 }
 
+void BundleAdjustmentCeres::setPersistentManifold(double* parameterBlock, ceres::Manifold* manifold)
+{
+    // the problem does not own the manifolds, the previous one is released once replaced
+    _persistentProblem->SetManifold(parameterBlock, manifold);
+
+    if (manifold == nullptr)
+        _persistentManifolds.erase(parameterBlock);
+    else
+        _persistentManifolds[parameterBlock].reset(manifold);
+}
+
+void BundleAdjustmentCeres::removePersistentParameterBlock(double* parameterBlock)
+{
+    _persistentProblem->RemoveParameterBlock(parameterBlock);
+    _persistentManifolds.erase(parameterBlock);
+    _persistentPosesConstantParameters.erase(parameterBlock);
+}
+
+void BundleAdjustmentCeres::updatePersistentProblem(const sfmData::SfMData& sfmData, ERefineOptions refineOptions)
+{
+    // the residual blocks of the persistent problem refer to its loss function
+    if (_persistentProblem != nullptr && _persistentLossFunction != _ceresOptions.lossFunction)
+        resetProblem();
+
+    _statistics = Statistics();
+    _allParametersBlocks.clear();
+    _linearSolverOrdering.Clear();
+
+    if (_persistentProblem == nullptr)
+    {
+        ceres::Problem::Options problemOptions;
+        problemOptions.loss_function_ownership = ceres::DO_NOT_TAKE_OWNERSHIP;
+        problemOptions.manifold_ownership = ceres::DO_NOT_TAKE_OWNERSHIP;
+        // residual and parameter blocks are removed at each update
+        problemOptions.enable_fast_removal = true;
+        _persistentProblem.reset(new ceres::Problem(problemOptions));
+        _persistentLossFunction = _ceresOptions.lossFunction;
+    }
+
+    ceres::Problem& problem = *_persistentProblem;
+    ceres::LossFunction* lossFunction = _persistentLossFunction.get();
+
+    // ensure we are not using incompatible options
+    // REFINEINTRINSICS_OPTICALCENTER_ALWAYS and REFINEINTRINSICS_OPTICALCENTER_IF_ENOUGH_DATA cannot be used at the same time
+    assert(!((refineOptions & REFINE_INTRINSICS_OPTICALOFFSET_ALWAYS) && (refineOptions & REFINE_INTRINSICS_OPTICALOFFSET_IF_ENOUGH_DATA)));
+
+    const bool refineTranslation = refineOptions & REFINE_TRANSLATION;
+    const bool refineRotation = refineOptions & REFINE_ROTATION;
+    const bool refineIntrinsicsOpticalCenter =
+      (refineOptions & REFINE_INTRINSICS_OPTICALOFFSET_ALWAYS) || (refineOptions & REFINE_INTRINSICS_OPTICALOFFSET_IF_ENOUGH_DATA);
+    const bool refineIntrinsicsFocalLength = refineOptions & REFINE_INTRINSICS_FOCAL;
+    const bool refineIntrinsicsDistortion = refineOptions & REFINE_INTRINSICS_DISTORTION;
+    const bool refineIntrinsics = refineIntrinsicsDistortion || refineIntrinsicsFocalLength || refineIntrinsicsOpticalCenter;
+    const bool refineStructure = refineOptions & REFINE_STRUCTURE;
+
+    // 2D constraints and rotation priors are few, they are rebuilt at each update
+    for (const ceres::ResidualBlockId residualId : _constraintsResiduals)
+        problem.RemoveResidualBlock(residualId);
+    _constraintsResiduals.clear();
+
+    // count the number of reconstructed views per intrinsic
+    std::map<IndexT, std::size_t> intrinsicsUsage;
+    for (const auto& viewPair : sfmData.getViews())
+    {
+        const sfmData::View& view = *(viewPair.second);
+        std::size_t& usage = intrinsicsUsage[view.getIntrinsicId()];
+        if (sfmData.isPoseAndIntrinsicDefined(&view))
+            ++usage;
+    }
+
+    const auto isPoseKept = [&](IndexT poseId) -> bool {
+        return sfmData.getPoses().count(poseId) && getPoseState(poseId) != EParameterState::IGNORED;
+    };
+
+    const auto isRigSubPoseKept = [&](IndexT rigId, IndexT subPoseId) -> bool {
+        const auto rigIt = sfmData.getRigs().find(rigId);
+        if (rigIt == sfmData.getRigs().end() || subPoseId >= rigIt->second.getNbSubPoses())
+            return false;
+        return rigIt->second.getSubPose(subPoseId).status != sfmData::ERigSubPoseStatus::UNINITIALIZED;
+    };
+
+    // intrinsics to keep in the problem, an intrinsic block is rebuilt if its number of parameters changed
+    std::set<IndexT> intrinsicsKept;
+    for (const auto& intrinsicBlockPair : _intrinsicsBlocks)
+    {
+        const IndexT intrinsicId = intrinsicBlockPair.first;
+        const auto intrinsicIt = sfmData.getIntrinsics().find(intrinsicId);
+        const auto usageIt = intrinsicsUsage.find(intrinsicId);
+
+        if (intrinsicIt == sfmData.getIntrinsics().end() || usageIt == intrinsicsUsage.end() || usageIt->second <= 0 ||
+            getIntrinsicState(intrinsicId) == EParameterState::IGNORED ||
+            intrinsicIt->second->getParams().size() != intrinsicBlockPair.second.size())
+            continue;
+
+        intrinsicsKept.insert(intrinsicId);
+    }
+
+    // remove the observations residual blocks of the outliers and of the removed or ignored parameters
+    for (auto landmarkResidualsIt = _observationsResiduals.begin(); landmarkResidualsIt != _observationsResiduals.end();)
+    {
+        const IndexT landmarkId = landmarkResidualsIt->first;
+        const auto landmarkIt = sfmData.getLandmarks().find(landmarkId);
+        const bool isLandmarkKept = (landmarkIt != sfmData.getLandmarks().end()) && getLandmarkState(landmarkId) != EParameterState::IGNORED;
+
+        auto& residuals = landmarkResidualsIt->second;
+        for (auto residualIt = residuals.begin(); residualIt != residuals.end();)
+        {
+            const IndexT viewId = residualIt->first;
+            const ObservationResidual& residual = residualIt->second;
+            bool isValid = isLandmarkKept;
+
+            if (isValid)
+            {
+                const auto observationIt = landmarkIt->second.observations.find(viewId);
+                isValid = (observationIt != landmarkIt->second.observations.end()) && observationIt->second.x == residual.x &&
+                          observationIt->second.scale == residual.scale;
+            }
+
+            if (isValid)
+            {
+                const sfmData::View& view = sfmData.getView(viewId);
+                isValid = view.getPoseId() == residual.poseId && view.getIntrinsicId() == residual.intrinsicId && isPoseKept(residual.poseId) &&
+                          intrinsicsKept.count(residual.intrinsicId);
+
+                if (isValid && view.isPartOfRig() && !view.isPoseIndependant())
+                    isValid = isRigSubPoseKept(view.getRigId(), view.getSubPoseId());
+
+                // a folded sub-pose must still be constant and unchanged
+                if (isValid && residual.hasConstantSubPose)
+                {
+                    const geometry::Pose3* constantSubPose = getConstantRigSubPose(sfmData, view);
+                    isValid = (constantSubPose != nullptr) && constantSubPose->rotation() == residual.constantSubPose.rotation() &&
+                              constantSubPose->translation() == residual.constantSubPose.translation();
+                }
+            }
+
+            if (isValid)
+            {
+                ++residualIt;
+                continue;
+            }
+
+            problem.RemoveResidualBlock(residual.residualId);
+            residualIt = residuals.erase(residualIt);
+        }
+
+        if (residuals.empty())
+            landmarkResidualsIt = _observationsResiduals.erase(landmarkResidualsIt);
+        else
+            ++landmarkResidualsIt;
+    }
+
+    // remove the parameter blocks no longer used, their residual blocks have been removed above
+    for (auto poseBlockIt = _posesBlocks.begin(); poseBlockIt != _posesBlocks.end();)
+    {
+        if (isPoseKept(poseBlockIt->first))
+        {
+            ++poseBlockIt;
+            continue;
+        }
+        removePersistentParameterBlock(poseBlockIt->second.data());
+        poseBlockIt = _posesBlocks.erase(poseBlockIt);
+    }
+
+    for (auto& rigBlocksPair : _rigBlocks)
+    {
+        for (auto subPoseBlockIt = rigBlocksPair.second.begin(); subPoseBlockIt != rigBlocksPair.second.end();)
+        {
+            if (isRigSubPoseKept(rigBlocksPair.first, subPoseBlockIt->first))
+            {
+                ++subPoseBlockIt;
+                continue;
+            }
+            removePersistentParameterBlock(subPoseBlockIt->second.data());
+            subPoseBlockIt = rigBlocksPair.second.erase(subPoseBlockIt);
+        }
+    }
+
+    for (auto intrinsicBlockIt = _intrinsicsBlocks.begin(); intrinsicBlockIt != _intrinsicsBlocks.end();)
+    {
+        if (intrinsicsKept.count(intrinsicBlockIt->first))
+        {
+            ++intrinsicBlockIt;
+            continue;
+        }
+        removePersistentParameterBlock(intrinsicBlockIt->second.data());
+        intrinsicBlockIt = _intrinsicsBlocks.erase(intrinsicBlockIt);
+    }
+
+    for (auto landmarkBlockIt = _landmarksBlocks.begin(); landmarkBlockIt != _landmarksBlocks.end();)
+    {
+        const IndexT landmarkId = landmarkBlockIt->first;
+        if (sfmData.getLandmarks().count(landmarkId) && getLandmarkState(landmarkId) != EParameterState::IGNORED)
+        {
+            ++landmarkBlockIt;
+            continue;
+        }
+        removePersistentParameterBlock(landmarkBlockIt->second.data());
+        landmarkBlockIt = _landmarksBlocks.erase(landmarkBlockIt);
+    }
+
+    // update the extrinsics parameter blocks
+    const auto updatePose = [&](const sfmData::CameraPose& cameraPose, bool isConstant, std::array<double, 6>& poseBlock) {
+        const Mat3& R = cameraPose.getTransform().rotation();
+        const Vec3& t = cameraPose.getTransform().translation();
+
+        double angleAxis[3];
+        ceres::RotationMatrixToAngleAxis(static_cast<const double*>(R.data()), angleAxis);
+        poseBlock.at(0) = angleAxis[0];
+        poseBlock.at(1) = angleAxis[1];
+        poseBlock.at(2) = angleAxis[2];
+        poseBlock.at(3) = t(0);
+        poseBlock.at(4) = t(1);
+        poseBlock.at(5) = t(2);
+
+        double* poseBlockPtr = poseBlock.data();
+        if (!problem.HasParameterBlock(poseBlockPtr))
+            problem.AddParameterBlock(poseBlockPtr, 6);
+
+        _allParametersBlocks.push_back(poseBlockPtr);
+
+        if (cameraPose.isLocked() || isConstant || (!refineTranslation && !refineRotation))
+        {
+            _statistics.addState(EParameter::POSE, EParameterState::CONSTANT);
+            problem.SetParameterBlockConstant(poseBlockPtr);
+            return;
+        }
+
+        problem.SetParameterBlockVariable(poseBlockPtr);
+
+        std::vector<int> constantExtrinsic;
+        if (!refineRotation)
+            constantExtrinsic.insert(constantExtrinsic.end(), {0, 1, 2});
+        if (!refineTranslation)
+            constantExtrinsic.insert(constantExtrinsic.end(), {3, 4, 5});
+
+        // only replace the subset manifold if the refined parameters changed
+        const auto constantIt = _persistentPosesConstantParameters.find(poseBlockPtr);
+        if ((constantIt == _persistentPosesConstantParameters.end() && !constantExtrinsic.empty()) ||
+            (constantIt != _persistentPosesConstantParameters.end() && constantIt->second != constantExtrinsic))
+        {
+            setPersistentManifold(poseBlockPtr, constantExtrinsic.empty() ? nullptr : new ceres::SubsetManifold(6, constantExtrinsic));
+            _persistentPosesConstantParameters[poseBlockPtr] = constantExtrinsic;
+        }
+
+        _statistics.addState(EParameter::POSE, EParameterState::REFINED);
+    };
+
+    for (const auto& posePair : sfmData.getPoses())
+    {
+        const IndexT poseId = posePair.first;
+
+        if (getPoseState(poseId) == EParameterState::IGNORED)
+        {
+            _statistics.addState(EParameter::POSE, EParameterState::IGNORED);
+            continue;
+        }
+
+        updatePose(posePair.second, getPoseState(poseId) == EParameterState::CONSTANT, _posesBlocks[poseId]);
+    }
+
+    for (const auto& rigPair : sfmData.getRigs())
+    {
+        const IndexT rigId = rigPair.first;
+        const sfmData::Rig& rig = rigPair.second;
+
+        for (std::size_t subPoseId = 0; subPoseId < rig.getNbSubPoses(); ++subPoseId)
+        {
+            const sfmData::RigSubPose& rigSubPose = rig.getSubPose(subPoseId);
+
+            if (rigSubPose.status == sfmData::ERigSubPoseStatus::UNINITIALIZED)
+                continue;
+
+            updatePose(sfmData::CameraPose(rigSubPose.pose),
+                       rigSubPose.status == sfmData::ERigSubPoseStatus::CONSTANT,
+                       _rigBlocks[rigId][subPoseId]);
+        }
+    }
+
+    // update the intrinsics parameter blocks
+    for (const auto& intrinsicPair : sfmData.getIntrinsics())
+    {
+        const IndexT intrinsicId = intrinsicPair.first;
+        const auto& intrinsicPtr = intrinsicPair.second;
+        const auto usageIt = intrinsicsUsage.find(intrinsicId);
+        if (usageIt == intrinsicsUsage.end())
+            continue;
+        const std::size_t usageCount = usageIt->second;
+
+        if (usageCount <= 0 || getIntrinsicState(intrinsicId) == EParameterState::IGNORED)
+        {
+            _statistics.addState(EParameter::INTRINSIC, EParameterState::IGNORED);
+            continue;
+        }
+
+        assert(isValid(intrinsicPtr->getType()));
+
+        const std::vector<double> params = intrinsicPtr->getParams();
+        std::vector<double>& intrinsicBlock = _intrinsicsBlocks[intrinsicId];
+        double* intrinsicBlockPtr = nullptr;
+
+        if (intrinsicBlock.empty())
+        {
+            intrinsicBlock = params;
+            intrinsicBlockPtr = intrinsicBlock.data();
+            problem.AddParameterBlock(intrinsicBlockPtr, intrinsicBlock.size());
+        }
+        else
+        {
+            // keep the block memory, it is registered in the problem
+            std::copy(params.begin(), params.end(), intrinsicBlock.begin());
+            intrinsicBlockPtr = intrinsicBlock.data();
+
+            // clear the bounds of the previous adjustment
+            for (int i = 0; i < static_cast<int>(intrinsicBlock.size()); ++i)
+            {
+                problem.SetParameterLowerBound(intrinsicBlockPtr, i, -std::numeric_limits<double>::max());
+                problem.SetParameterUpperBound(intrinsicBlockPtr, i, std::numeric_limits<double>::max());
+            }
+        }
+
+        _allParametersBlocks.push_back(intrinsicBlockPtr);
+
+        if (intrinsicPtr->isLocked() || !refineIntrinsics || getIntrinsicState(intrinsicId) == EParameterState::CONSTANT)
+        {
+            _statistics.addState(EParameter::INTRINSIC, EParameterState::CONSTANT);
+            problem.SetParameterBlockConstant(intrinsicBlockPtr);
+            continue;
+        }
+
+        problem.SetParameterBlockVariable(intrinsicBlockPtr);
+
+        bool lockCenter = false;
+        bool lockFocal = false;
+        bool lockRatio = true;
+        bool lockDistortion = false;
+        double focalRatio = 1.0;
+
+        if (refineIntrinsicsFocalLength)
+        {
+            std::shared_ptr<camera::IntrinsicScaleOffset> intrinsicScaleOffset =
+              std::dynamic_pointer_cast<camera::IntrinsicScaleOffset>(intrinsicPtr);
+            if (intrinsicScaleOffset->getInitialScale().x() > 0 && intrinsicScaleOffset->getInitialScale().y() > 0)
+            {
+                const unsigned int maxFocalError = 0.2 * std::max(intrinsicPtr->w(), intrinsicPtr->h());
+                problem.SetParameterLowerBound(
+                  intrinsicBlockPtr, 0, static_cast<double>(intrinsicScaleOffset->getInitialScale().x() - maxFocalError));
+                problem.SetParameterUpperBound(
+                  intrinsicBlockPtr, 0, static_cast<double>(intrinsicScaleOffset->getInitialScale().x() + maxFocalError));
+                problem.SetParameterLowerBound(
+                  intrinsicBlockPtr, 1, static_cast<double>(intrinsicScaleOffset->getInitialScale().y() - maxFocalError));
+                problem.SetParameterUpperBound(
+                  intrinsicBlockPtr, 1, static_cast<double>(intrinsicScaleOffset->getInitialScale().y() + maxFocalError));
+            }
+            else
+            {
+                problem.SetParameterLowerBound(intrinsicBlockPtr, 0, 0.0);
+                problem.SetParameterLowerBound(intrinsicBlockPtr, 1, 0.0);
+            }
+
+            focalRatio = intrinsicBlockPtr[0] / intrinsicBlockPtr[1];
+
+            if (intrinsicScaleOffset)
+                lockRatio = intrinsicScaleOffset->isRatioLocked();
+        }
+        else
+        {
+            lockFocal = true;
+        }
+
+        if ((refineOptions & REFINE_INTRINSICS_OPTICALOFFSET_ALWAYS) ||
+            ((refineOptions & REFINE_INTRINSICS_OPTICALOFFSET_IF_ENOUGH_DATA) && _minNbImagesToRefineOpticalCenter > 0 &&
+             usageCount >= _minNbImagesToRefineOpticalCenter))
+        {
+            const double opticalCenterMinPercent = -0.05;
+            const double opticalCenterMaxPercent = 0.05;
+
+            problem.SetParameterLowerBound(intrinsicBlockPtr, 2, opticalCenterMinPercent * intrinsicPtr->w());
+            problem.SetParameterUpperBound(intrinsicBlockPtr, 2, opticalCenterMaxPercent * intrinsicPtr->w());
+            problem.SetParameterLowerBound(intrinsicBlockPtr, 3, opticalCenterMinPercent * intrinsicPtr->h());
+            problem.SetParameterUpperBound(intrinsicBlockPtr, 3, opticalCenterMaxPercent * intrinsicPtr->h());
+        }
+        else
+        {
+            lockCenter = true;
+        }
+
+        if (!refineIntrinsicsDistortion || intrinsicPtr->getDistortionInitializationMode() == camera::EInitMode::CALIBRATED)
+            lockDistortion = true;
+
+        // the focal ratio depends on the current values, the manifold is always replaced
+        setPersistentManifold(intrinsicBlockPtr,
+                              new IntrinsicsManifold(intrinsicBlock.size(), focalRatio, lockFocal, lockRatio, lockCenter, lockDistortion));
+
+        _statistics.addState(EParameter::INTRINSIC, EParameterState::REFINED);
+    }
+
+    // update the landmarks parameter blocks and add the residual blocks of the new observations
+    for (const auto& landmarkPair : sfmData.getLandmarks())
+    {
+        const IndexT landmarkId = landmarkPair.first;
+        const sfmData::Landmark& landmark = landmarkPair.second;
+
+        if (getLandmarkState(landmarkId) == EParameterState::IGNORED)
+        {
+            _statistics.addState(EParameter::LANDMARK, EParameterState::IGNORED);
+            continue;
+        }
+
+        std::array<double, 3>& landmarkBlock = _landmarksBlocks[landmarkId];
+        for (std::size_t i = 0; i < 3; ++i)
+            landmarkBlock.at(i) = landmark.X(Eigen::Index(i));
+
+        double* landmarkBlockPtr = landmarkBlock.data();
+        if (!problem.HasParameterBlock(landmarkBlockPtr))
+            problem.AddParameterBlock(landmarkBlockPtr, 3);
+
+        _allParametersBlocks.push_back(landmarkBlockPtr);
+
+        const bool isConstant = !refineStructure || getLandmarkState(landmarkId) == EParameterState::CONSTANT;
+        if (isConstant)
+            problem.SetParameterBlockConstant(landmarkBlockPtr);
+        else
+            problem.SetParameterBlockVariable(landmarkBlockPtr);
+
+        HashMap<IndexT, ObservationResidual>& residuals = _observationsResiduals[landmarkId];
+
+        for (const auto& observationPair : landmark.observations)
+        {
+            const IndexT viewId = observationPair.first;
+            const sfmData::Observation& observation = observationPair.second;
+
+            _statistics.addState(EParameter::LANDMARK, isConstant ? EParameterState::CONSTANT : EParameterState::REFINED);
+
+            // the residual block is already in the problem
+            if (residuals.count(viewId))
+                continue;
+
+            const sfmData::View& view = sfmData.getView(viewId);
+
+            assert(getPoseState(view.getPoseId()) != EParameterState::IGNORED);
+            assert(getIntrinsicState(view.getIntrinsicId()) != EParameterState::IGNORED);
+
+            double* poseBlockPtr = _posesBlocks.at(view.getPoseId()).data();
+            double* intrinsicBlockPtr = _intrinsicsBlocks.at(view.getIntrinsicId()).data();
+
+            ObservationResidual& residual = residuals[viewId];
+            residual.poseId = view.getPoseId();
+            residual.intrinsicId = view.getIntrinsicId();
+            residual.x = observation.x;
+            residual.scale = observation.scale;
+
+            const bool isRigView = view.isPartOfRig() && !view.isPoseIndependant();
+            const geometry::Pose3* constantSubPose = isRigView ? getConstantRigSubPose(sfmData, view) : nullptr;
+            residual.hasConstantSubPose = (constantSubPose != nullptr);
+
+            if (constantSubPose != nullptr)
+            {
+                residual.constantSubPose = *constantSubPose;
+
+                ceres::CostFunction* costFunction =
+                  createConstantSubPoseCostFunctionFromIntrinsics(sfmData.getIntrinsicPtr(view.getIntrinsicId()), observation, *constantSubPose);
+
+                residual.residualId = problem.AddResidualBlock(costFunction, lossFunction, intrinsicBlockPtr, poseBlockPtr, landmarkBlockPtr);
+            }
+            else if (isRigView)
+            {
+                ceres::CostFunction* costFunction = createRigCostFunctionFromIntrinsics(sfmData.getIntrinsicPtr(view.getIntrinsicId()), observation);
+                double* rigBlockPtr = _rigBlocks.at(view.getRigId()).at(view.getSubPoseId()).data();
+
+                residual.residualId =
+                  problem.AddResidualBlock(costFunction, lossFunction, intrinsicBlockPtr, poseBlockPtr, rigBlockPtr, landmarkBlockPtr);
+            }
+            else
+            {
+                ceres::CostFunction* costFunction = createCostFunctionFromIntrinsics(sfmData.getIntrinsicPtr(view.getIntrinsicId()), observation);
+
+                residual.residualId = problem.AddResidualBlock(costFunction, lossFunction, intrinsicBlockPtr, poseBlockPtr, landmarkBlockPtr);
+            }
+        }
+
+        if (residuals.empty())
+            _observationsResiduals.erase(landmarkId);
+    }
+
+    // add 2D constraints and rotation priors to the Ceres problem
+    addConstraints2DToProblem(sfmData, refineOptions, problem);
+    addRotationPriorsToProblem(sfmData, refineOptions, problem);
+
+    // apply a specific parameter ordering on all the blocks of the problem
+    if (_ceresOptions.useParametersOrdering)
+    {
+        for (auto& landmarkBlockPair : _landmarksBlocks)
+            _linearSolverOrdering.AddElementToGroup(landmarkBlockPair.second.data(), 0);
+        for (auto& poseBlockPair : _posesBlocks)
+            _linearSolverOrdering.AddElementToGroup(poseBlockPair.second.data(), 1);
+        for (auto& rigBlocksPair : _rigBlocks)
+            for (auto& subPoseBlockPair : rigBlocksPair.second)
+                _linearSolverOrdering.AddElementToGroup(subPoseBlockPair.second.data(), 2);
+        for (auto& intrinsicBlockPair : _intrinsicsBlocks)
+            _linearSolverOrdering.AddElementToGroup(intrinsicBlockPair.second.data(), 2);
+    }
+}
+
 void BundleAdjustmentCeres::updateFromSolution(sfmData::SfMData& sfmData, ERefineOptions refineOptions) const
 {
     const bool refinePoses = (refineOptions & REFINE_ROTATION) || (refineOptions & REFINE_TRANSLATION);
@@ -996,6 +1656,10 @@ void BundleAdjustmentCeres::updateFromSolution(sfmData::SfMData& sfmData, ERefin
                 sfmData::RigSubPose& subPose = rig.getSubPose(subPoseit.first);
                 const std::array<double, 6>& subPoseBlock = subPoseit.second;
 
+                // a constant sub-pose is kept as is, it may be folded in the cost functions
+                if (subPose.status == sfmData::ERigSubPoseStatus::CONSTANT)
+                    continue;
+
                 Mat3 R_refined;
                 ceres::AngleAxisToRotationMatrix(subPoseBlock.data(), R_refined.data());
                 const Vec3 t_refined(subPoseBlock.at(3), subPoseBlock.at(4), subPoseBlock.at(5));
@@ -1058,7 +1722,10 @@ void BundleAdjustmentCeres::createJacobian(const sfmData::SfMData& sfmData, ERef
     problem.Evaluate(evalOpt, &cost, NULL, NULL, &jacobian);
 }
 
-bool BundleAdjustmentCeres::adjust(sfmData::SfMData& sfmData, ERefineOptions refineOptions)
+void BundleAdjustmentCeres::createJacobian(const sfmData::SfMData& sfmData,
+                                           ERefineOptions refineOptions,
+                                           ceres::CRSMatrix& jacobian,
+                                           JacobianLayout& layout)
 {
     // create problem
     ceres::Problem::Options problemOptions;
@@ -1066,6 +1733,54 @@ bool BundleAdjustmentCeres::adjust(sfmData::SfMData& sfmData, ERefineOptions ref
     ceres::Problem problem(problemOptions);
     createProblem(sfmData, refineOptions, problem);
 
+    // columns of the parameter blocks, the Jacobian is in the tangent space of the manifolds
+    layout = JacobianLayout();
+    std::map<const double*, int> blocksIndex;
+    int column = 0;
+    for (const double* blockPtr : _allParametersBlocks)
+    {
+        const int size = problem.ParameterBlockTangentSize(blockPtr);
+        blocksIndex.emplace(blockPtr, static_cast<int>(layout.blocks.size()));
+        layout.blocks.emplace_back(column, size);
+        column += size;
+    }
+    for (const auto& poseBlockPair : _posesBlocks)
+        layout.posesBlock.emplace(poseBlockPair.first, blocksIndex.at(poseBlockPair.second.data()));
+    for (const auto& intrinsicBlockPair : _intrinsicsBlocks)
+        layout.intrinsicsBlock.emplace(intrinsicBlockPair.first, blocksIndex.at(intrinsicBlockPair.second.data()));
+    for (const auto& landmarkBlockPair : _landmarksBlocks)
+        layout.landmarksBlock.emplace(landmarkBlockPair.first, blocksIndex.at(landmarkBlockPair.second.data()));
+
+    // configure Jacobian engine
+    double cost = 0.0;
+    ceres::Problem::EvaluateOptions evalOpt;
+    evalOpt.parameter_blocks = _allParametersBlocks;
+    evalOpt.num_threads = 8;
+    evalOpt.apply_loss_function = true;
+
+    problem.Evaluate(evalOpt, &cost, NULL, NULL, &jacobian);
+}
+
+bool BundleAdjustmentCeres::adjust(sfmData::SfMData& sfmData, ERefineOptions refineOptions)
+{
+    // create problem
+    ceres::Problem::Options problemOptions;
+    problemOptions.loss_function_ownership = ceres::DO_NOT_TAKE_OWNERSHIP;
+    ceres::Problem localProblem(problemOptions);
+    ceres::Problem* problemPtr = &localProblem;
+
+    if (_ceresOptions.usePersistentProblem)
+    {
+        updatePersistentProblem(sfmData, refineOptions);
+        problemPtr = _persistentProblem.get();
+    }
+    else
+    {
+        createProblem(sfmData, refineOptions, localProblem);
+    }
+
+    ceres::Problem& problem = *problemPtr;
+
     // configure a Bundle Adjustment engine and run it
     // make Ceres automatically detect the bundle structure.
     ceres::Solver::Options options;
@@ -12,10 +12,13 @@
 #include <aliceVision/sfm/bundle/BundleAdjustment.hpp>
 #include <aliceVision/sfm/LocalBundleAdjustmentGraph.hpp>
 #include <aliceVision/numeric/numeric.hpp>
+#include <aliceVision/geometry/Pose3.hpp>
 
 #include <ceres/ceres.h>
 
+#include <map>
 #include <memory>
+#include <vector>
 
 namespace aliceVision {
 
@@ -45,6 +48,14 @@ class BundleAdjustmentCeres : public BundleAdjustment
 
         void setDenseBA();
         void setSparseBA();
+        void setIterativeBA();
+
+        /**
+         * @brief Select the linear solver of the reduced camera system
+         * @param[in] solver the requested solver
+         * @param[in] preferSparse the choice for EBundleAdjustmentSolver::AUTO, sparse or dense
+         */
+        void setSolver(EBundleAdjustmentSolver solver, bool preferSparse);
 
         ceres::LinearSolverType linearSolverType;
         ceres::PreconditionerType preconditionerType;
@@ -53,6 +64,12 @@ class BundleAdjustmentCeres : public BundleAdjustment
         unsigned int nbThreads;
         unsigned int maxNumIterations;
         bool useParametersOrdering = true;
+        /// solve the linear systems in single precision with double precision iterative refinement
+        bool useMixedPrecision = false;
+        /// factorize the dense reduced camera system on the GPU if Ceres has been built with CUDA
+        bool useGpu = false;
+        /// keep the Ceres problem between the calls to adjust and only apply the changes of the scene
+        bool usePersistentProblem = false;
         bool summary = false;
         bool verbose = true;
     };
@@ -125,6 +142,28 @@ class BundleAdjustmentCeres : public BundleAdjustment
      */
     void createJacobian(const sfmData::SfMData& sfmData, ERefineOptions refineOptions, ceres::CRSMatrix& jacobian);
 
+    /// columns of the parameter blocks in a Jacobian created by createJacobian
+    struct JacobianLayout
+    {
+        /// first column and number of columns of each parameter block, in the column order
+        std::vector<std::pair<int, int>> blocks;
+        /// parameter block index of each pose
+        HashMap<IndexT, int> posesBlock;
+        /// parameter block index of each intrinsic
+        HashMap<IndexT, int> intrinsicsBlock;
+        /// parameter block index of each landmark
+        HashMap<IndexT, int> landmarksBlock;
+    };
+
+    /**
+     * @brief Create a jacobian CRSMatrix and the columns of its parameter blocks
+     * @param[in] sfmData The input SfMData contains all the information about the reconstruction
+     * @param[in] refineOptions The chosen refine flag
+     * @param[out] jacobian The jacobian CSRMatrix
+     * @param[out] layout The columns of the parameter blocks, in the tangent space of their manifold
+     */
+    void createJacobian(const sfmData::SfMData& sfmData, ERefineOptions refineOptions, ceres::CRSMatrix& jacobian, JacobianLayout& layout);
+
     /**
      * @brief Perform a Bundle Adjustment on the SfM scene with refinement of the requested parameters
      * @param[in,out] sfmData The input SfMData contains all the information about the reconstruction
@@ -140,6 +179,19 @@ class BundleAdjustmentCeres : public BundleAdjustment
      */
     inline void useLocalStrategyGraph(const std::shared_ptr<const LocalBundleAdjustmentGraph>& localGraph) { _localGraph = localGraph; }
 
+    /**
+     * @brief Get the user Ceres options
+     * @return Ceres options structure const ref
+     */
+    inline const CeresOptions& getCeresOptions() const { return _ceresOptions; }
+
+    /**
+     * @brief Replace the user Ceres options, to reconfigure the solver between two adjustments of a persistent problem
+     * @note The persistent problem is rebuilt if the loss function changes
+     * @param[in] options The user Ceres options
+     */
+    inline void setCeresOptions(const CeresOptions& options) { _ceresOptions = options; }
+
     /**
      * @brief Get bundle adjustment statistics structure
      * @return statistics structure const ptr
@@ -214,6 +266,29 @@ class BundleAdjustmentCeres : public BundleAdjustment
      */
     void createProblem(const sfmData::SfMData& sfmData, ERefineOptions refineOptions, ceres::Problem& problem);
 
+    /**
+     * @brief Update the persistent Ceres problem with the changes of the scene since the previous adjustment:
+     *  - remove the residual blocks of the outliers and of the ignored or removed parameters,
+     *  - remove the parameter blocks no longer in the scene or set as ignored,
+     *  - add the new parameter and residual blocks and update the constant / variable states.
+     * @param[in] sfmData The input SfMData contains all the information about the reconstruction
+     * @param[in] refineOptions The chosen refine flag
+     */
+    void updatePersistentProblem(const sfmData::SfMData& sfmData, ERefineOptions refineOptions);
+
+    /**
+     * @brief Replace the manifold of a parameter block of the persistent problem
+     * @param[in] parameterBlock The parameter block pointer
+     * @param[in] manifold The new manifold (ownership is taken) or nullptr
+     */
+    void setPersistentManifold(double* parameterBlock, ceres::Manifold* manifold);
+
+    /**
+     * @brief Remove a parameter block and its manifold from the persistent problem
+     * @param[in] parameterBlock The parameter block pointer
+     */
+    void removePersistentParameterBlock(double* parameterBlock);
+
     /**
      * @brief Update The given SfMData with the solver solution
      * @param[in,out] sfmData The input SfMData contains all the information about the reconstruction, notably the poses and sub-poses
@@ -286,6 +361,37 @@ class BundleAdjustmentCeres : public BundleAdjustment
     /// hinted order for ceres to eliminate blocks when solving.
     /// note: this ceres parameter is built internally and must be reset on each call to the solver.
     ceres::ParameterBlockOrdering _linearSolverOrdering;
+
+    /// 2D constraints and rotation priors residual blocks
+    std::vector<ceres::ResidualBlockId> _constraintsResiduals;
+
+    // persistent problem data
+
+    /**
+     * @brief Residual block of a landmark observation in the persistent problem.
+     */
+    struct ObservationResidual
+    {
+        ceres::ResidualBlockId residualId;
+        IndexT poseId;
+        IndexT intrinsicId;
+        Vec2 x;
+        double scale;
+        /// the constant rig sub-pose is folded in the cost function
+        bool hasConstantSubPose = false;
+        geometry::Pose3 constantSubPose;
+    };
+
+    /// persistent Ceres problem, kept between the calls to adjust
+    std::unique_ptr<ceres::Problem> _persistentProblem;
+    /// loss function used by the residual blocks of the persistent problem
+    std::shared_ptr<ceres::LossFunction> _persistentLossFunction;
+    /// observations residual blocks per landmark id and view id
+    HashMap<IndexT, HashMap<IndexT, ObservationResidual>> _observationsResiduals;
+    /// manifolds of the persistent problem parameter blocks
+    std::map<double*, std::unique_ptr<ceres::Manifold>> _persistentManifolds;
+    /// constant parameters of the poses subset manifolds
+    std::map<double*, std::vector<int>> _persistentPosesConstantParameters;
 };
 
 }  // namespace sfm
@@ -0,0 +1,416 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2023 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <aliceVision/sfm/bundle/BundleAdjustmentPartitioned.hpp>
+#include <aliceVision/sfm/LocalBundleAdjustmentGraph.hpp>
+#include <aliceVision/sfm/utils/alignment.hpp>
+#include <aliceVision/sfmData/SfMData.hpp>
+#include <aliceVision/track/Track.hpp>
+#include <aliceVision/alicevision_omp.hpp>
+#include <aliceVision/system/Logger.hpp>
+
+#include <algorithm>
+#include <deque>
+#include <unordered_map>
+
+namespace aliceVision {
+namespace sfm {
+
+void BundleAdjustmentPartitioned::buildPosesGraph(const sfmData::SfMData& sfmData, std::map<IndexT, std::vector<IndexT>>& posesGraph) const
+{
+    posesGraph.clear();
+
+    // count the shared landmarks of each pair of poses
+    std::unordered_map<std::uint64_t, std::size_t> nbSharedLandmarksPerPair;
+    std::vector<IndexT> landmarkPoses;
+
+    for (const auto& landmarkPair : sfmData.getLandmarks())
+    {
+        landmarkPoses.clear();
+        for (const auto& observationPair : landmarkPair.second.observations)
+        {
+            const sfmData::View& view = sfmData.getView(observationPair.first);
+            if (sfmData.isPoseAndIntrinsicDefined(&view))
+                landmarkPoses.push_back(view.getPoseId());
+        }
+
+        // the views of a rig share the same pose
+        std::sort(landmarkPoses.begin(), landmarkPoses.end());
+        landmarkPoses.erase(std::unique(landmarkPoses.begin(), landmarkPoses.end()), landmarkPoses.end());
+
+        for (std::size_t i = 0; i < landmarkPoses.size(); ++i)
+            for (std::size_t j = i + 1; j < landmarkPoses.size(); ++j)
+                ++nbSharedLandmarksPerPair[(std::uint64_t(landmarkPoses[i]) << 32) | landmarkPoses[j]];
+    }
+
+    for (const auto& posePair : sfmData.getPoses())
+        posesGraph[posePair.first];
+
+    for (const auto& pairCount : nbSharedLandmarksPerPair)
+    {
+        if (pairCount.second < _partitionOptions.minNbSharedLandmarks)
+            continue;
+
+        const IndexT poseA = IndexT(pairCount.first >> 32);
+        const IndexT poseB = IndexT(pairCount.first & 0xFFFFFFFF);
+        posesGraph[poseA].push_back(poseB);
+        posesGraph[poseB].push_back(poseA);
+    }
+
+    // deterministic region growing
+    for (auto& adjacentPair : posesGraph)
+        std::sort(adjacentPair.second.begin(), adjacentPair.second.end());
+}
+
+void BundleAdjustmentPartitioned::partition(const std::map<IndexT, std::vector<IndexT>>& posesGraph)
+{
+    _submaps.clear();
+    _submapPerPose.clear();
+
+    const std::size_t maxNbPoses = std::max<std::size_t>(1, _partitionOptions.maxNbPosesPerSubmap);
+
+    // grow the submaps from the first unassigned pose by breadth first search
+    for (const auto& seedPair : posesGraph)
+    {
+        if (_submapPerPose.count(seedPair.first))
+            continue;
+
+        const std::size_t submapIndex = _submaps.size();
+        _submaps.emplace_back();
+        Submap& submap = _submaps.back();
+
+        std::deque<IndexT> queue = {seedPair.first};
+        _submapPerPose[seedPair.first] = submapIndex;
+
+        while (!queue.empty() && submap.corePoses.size() < maxNbPoses)
+        {
+            const IndexT poseId = queue.front();
+            queue.pop_front();
+            submap.corePoses.insert(poseId);
+
+            for (const IndexT adjacentPoseId : posesGraph.at(poseId))
+            {
+                if (_submapPerPose.count(adjacentPoseId))
+                    continue;
+                _submapPerPose[adjacentPoseId] = submapIndex;
+                queue.push_back(adjacentPoseId);
+            }
+        }
+
+        // the queued poses are not in the submap
+        for (const IndexT poseId : queue)
+            _submapPerPose.erase(poseId);
+    }
+
+    // merge the small submaps into their most connected neighbour submap
+    const std::size_t minNbPoses = maxNbPoses / 4;
+    for (std::size_t submapIndex = 0; submapIndex < _submaps.size(); ++submapIndex)
+    {
+        Submap& submap = _submaps.at(submapIndex);
+        if (submap.corePoses.empty() || submap.corePoses.size() >= minNbPoses)
+            continue;
+
+        std::map<std::size_t, std::size_t> nbEdgesPerSubmap;
+        for (const IndexT poseId : submap.corePoses)
+            for (const IndexT adjacentPoseId : posesGraph.at(poseId))
+            {
+                const std::size_t adjacentSubmapIndex = _submapPerPose.at(adjacentPoseId);
+                if (adjacentSubmapIndex != submapIndex)
+                    ++nbEdgesPerSubmap[adjacentSubmapIndex];
+            }
+
+        if (nbEdgesPerSubmap.empty())
+            continue;
+
+        const auto bestIt = std::max_element(nbEdgesPerSubmap.begin(), nbEdgesPerSubmap.end(), [](const auto& a, const auto& b) {
+            return a.second < b.second;
+        });
+
+        Submap& mergedSubmap = _submaps.at(bestIt->first);
+        for (const IndexT poseId : submap.corePoses)
+        {
+            mergedSubmap.corePoses.insert(poseId);
+            _submapPerPose[poseId] = bestIt->first;
+        }
+        submap.corePoses.clear();
+    }
+
+    // remove the empty submaps
+    _submaps.erase(std::remove_if(_submaps.begin(), _submaps.end(), [](const Submap& submap) { return submap.corePoses.empty(); }),
+                   _submaps.end());
+
+    for (std::size_t submapIndex = 0; submapIndex < _submaps.size(); ++submapIndex)
+    {
+        Submap& submap = _submaps.at(submapIndex);
+        for (const IndexT poseId : submap.corePoses)
+            _submapPerPose[poseId] = submapIndex;
+
+        // extend the submap with the separator cameras
+        submap.poses = submap.corePoses;
+        std::set<IndexT> ring = submap.corePoses;
+        for (std::size_t distance = 0; distance < _partitionOptions.overlapDistance; ++distance)
+        {
+            std::set<IndexT> nextRing;
+            for (const IndexT poseId : ring)
+                for (const IndexT adjacentPoseId : posesGraph.at(poseId))
+                    if (submap.poses.insert(adjacentPoseId).second)
+                        nextRing.insert(adjacentPoseId);
+            ring.swap(nextRing);
+        }
+    }
+}
+
+bool BundleAdjustmentPartitioned::adjustSeparators(sfmData::SfMData& sfmData,
+                                                   const std::map<IndexT, std::vector<IndexT>>& posesGraph,
+                                                   ERefineOptions refineOptions) const
+{
+    // the separator poses are connected to a pose of another submap
+    std::set<IndexT> separatorPoses;
+    for (const auto& adjacentPair : posesGraph)
+        for (const IndexT adjacentPoseId : adjacentPair.second)
+            if (_submapPerPose.at(adjacentPair.first) != _submapPerPose.at(adjacentPoseId))
+                separatorPoses.insert(adjacentPair.first);
+
+    if (separatorPoses.empty())
+        return true;
+
+    std::set<IndexT> separatorViews;
+    for (const auto& viewPair : sfmData.getViews())
+        if (sfmData.isPoseAndIntrinsicDefined(viewPair.second.get()) && separatorPoses.count(viewPair.second->getPoseId()))
+            separatorViews.insert(viewPair.first);
+
+    // the landmark ids are the track ids
+    track::TracksPerView tracksPerView;
+    for (const auto& viewPair : sfmData.getViews())
+        if (sfmData.isPoseAndIntrinsicDefined(viewPair.second.get()))
+            tracksPerView[viewPair.first];
+    for (const auto& landmarkPair : sfmData.getLandmarks())
+        for (const auto& observationPair : landmarkPair.second.observations)
+            tracksPerView[observationPair.first].push_back(landmarkPair.first);
+    for (auto& tracksPair : tracksPerView)
+        std::sort(tracksPair.second.begin(), tracksPair.second.end());
+
+    std::shared_ptr<LocalBundleAdjustmentGraph> localGraph = std::make_shared<LocalBundleAdjustmentGraph>(sfmData);
+    localGraph->setGraphDistanceLimit(_partitionOptions.overlapDistance);
+    localGraph->updateGraphWithNewViews(sfmData, tracksPerView, separatorViews, _partitionOptions.minNbSharedLandmarks);
+    localGraph->computeGraphDistances(sfmData, separatorViews);
+    localGraph->convertDistancesToStates(sfmData);
+
+    ALICEVISION_LOG_INFO("Partitioned bundle adjustment: refine the " << separatorPoses.size() << " separator poses and their neighbourhood ("
+                                                                      << localGraph->getNbPosesPerState(EParameterState::REFINED)
+                                                                      << " refined poses).");
+
+    BundleAdjustmentCeres BA(_ceresOptions, _minNbImagesToRefineOpticalCenter);
+    BA.useLocalStrategyGraph(localGraph);
+    return BA.adjust(sfmData, refineOptions);
+}
+
+bool BundleAdjustmentPartitioned::adjust(sfmData::SfMData& sfmData, ERefineOptions refineOptions)
+{
+    _submaps.clear();
+    _submapPerPose.clear();
+
+    // the scene fits in one submap
+    if (sfmData.getPoses().size() <= _partitionOptions.maxNbPosesPerSubmap)
+    {
+        BundleAdjustmentCeres BA(_ceresOptions, _minNbImagesToRefineOpticalCenter);
+        return BA.adjust(sfmData, refineOptions);
+    }
+
+    std::map<IndexT, std::vector<IndexT>> posesGraph;
+    buildPosesGraph(sfmData, posesGraph);
+    partition(posesGraph);
+
+    ALICEVISION_LOG_INFO("Partitioned bundle adjustment: " << sfmData.getPoses().size() << " poses in " << _submaps.size() << " submaps.");
+
+    if (_submaps.size() < 2)
+    {
+        BundleAdjustmentCeres BA(_ceresOptions, _minNbImagesToRefineOpticalCenter);
+        return BA.adjust(sfmData, refineOptions);
+    }
+
+    // build the submaps scenes
+    std::vector<sfmData::SfMData> submapsData(_submaps.size());
+    std::map<IndexT, std::vector<std::size_t>> submapsPerPose;
+
+    for (std::size_t submapIndex = 0; submapIndex < _submaps.size(); ++submapIndex)
+    {
+        sfmData::SfMData& submapData = submapsData.at(submapIndex);
+
+        for (const IndexT poseId : _submaps.at(submapIndex).poses)
+        {
+            submapData.getPoses().emplace(poseId, sfmData.getPoses().at(poseId));
+            submapsPerPose[poseId].push_back(submapIndex);
+        }
+
+        for (const auto& viewPair : sfmData.getViews())
+        {
+            const sfmData::View& view = *viewPair.second;
+            if (!sfmData.isPoseAndIntrinsicDefined(&view) || !submapData.getPoses().count(view.getPoseId()))
+                continue;
+
+            submapData.getViews().emplace(viewPair.first, viewPair.second);
+
+            // the intrinsics are refined independently in each submap
+            if (!submapData.getIntrinsics().count(view.getIntrinsicId()))
+                submapData.getIntrinsics().emplace(view.getIntrinsicId(),
+                                                   std::shared_ptr<camera::IntrinsicBase>(sfmData.getIntrinsics().at(view.getIntrinsicId())->clone()));
+        }
+
+        // the rig sub-poses are only refined in the final adjustment
+        submapData.getRigs() = sfmData.getRigs();
+        for (auto& rigPair : submapData.getRigs())
+            for (sfmData::RigSubPose& subPose : rigPair.second.getSubPoses())
+                if (subPose.status != sfmData::ERigSubPoseStatus::UNINITIALIZED)
+                    subPose.status = sfmData::ERigSubPoseStatus::CONSTANT;
+    }
+
+    // split the landmarks observations between the submaps
+    for (const auto& landmarkPair : sfmData.getLandmarks())
+    {
+        const sfmData::Landmark& landmark = landmarkPair.second;
+        std::map<std::size_t, sfmData::Observations> observationsPerSubmap;
+
+        for (const auto& observationPair : landmark.observations)
+        {
+            const sfmData::View& view = sfmData.getView(observationPair.first);
+            const auto submapsIt = submapsPerPose.find(view.getPoseId());
+            if (!sfmData.isPoseAndIntrinsicDefined(&view) || submapsIt == submapsPerPose.end())
+                continue;
+
+            for (const std::size_t submapIndex : submapsIt->second)
+                observationsPerSubmap[submapIndex].emplace(observationPair.first, observationPair.second);
+        }
+
+        for (const auto& submapObservations : observationsPerSubmap)
+        {
+            if (submapObservations.second.size() < 2)
+                continue;
+            submapsData.at(submapObservations.first)
+              .getLandmarks()
+              .emplace(landmarkPair.first, sfmData::Landmark(landmark.X, landmark.descType, submapObservations.second, landmark.rgb));
+        }
+    }
+
+    // adjust and align the submaps in parallel
+    BundleAdjustmentCeres::CeresOptions submapOptions = _ceresOptions;
+    submapOptions.nbThreads = std::max<unsigned int>(1, _ceresOptions.nbThreads / static_cast<unsigned int>(_submaps.size()));
+    submapOptions.verbose = false;
+    submapOptions.usePersistentProblem = false;
+
+    std::vector<char> submapsValid(_submaps.size(), 0);
+
+#pragma omp parallel for schedule(dynamic)
+    for (int submapIndex = 0; submapIndex < static_cast<int>(submapsData.size()); ++submapIndex)
+    {
+        sfmData::SfMData& submapData = submapsData.at(submapIndex);
+
+        BundleAdjustmentCeres BA(submapOptions, _minNbImagesToRefineOpticalCenter);
+        if (!BA.adjust(submapData, refineOptions))
+        {
+            ALICEVISION_LOG_WARNING("Partitioned bundle adjustment: the submap " << submapIndex << " failed.");
+            continue;
+        }
+
+        // the gauge of each submap is free, align it to the scene through its cameras
+        std::mt19937 randomNumberGenerator(_partitionOptions.randomSeed + submapIndex);
+        double S;
+        Mat3 R;
+        Vec3 t;
+        if (!computeSimilarityFromCommonCameras_poseId(submapData, sfmData, randomNumberGenerator, &S, &R, &t))
+        {
+            ALICEVISION_LOG_WARNING("Partitioned bundle adjustment: the submap " << submapIndex << " cannot be aligned.");
+            continue;
+        }
+
+        applyTransform(submapData, S, R, t);
+        submapsValid.at(submapIndex) = 1;
+    }
+
+    // merge the poses from the submap they belong to
+    for (std::size_t submapIndex = 0; submapIndex < _submaps.size(); ++submapIndex)
+    {
+        if (!submapsValid.at(submapIndex))
+            continue;
+
+        for (const IndexT poseId : _submaps.at(submapIndex).corePoses)
+        {
+            sfmData::CameraPose& pose = sfmData.getPoses().at(poseId);
+            if (!pose.isLocked())
+                pose.setTransform(submapsData.at(submapIndex).getPoses().at(poseId).getTransform());
+        }
+    }
+
+    // merge the landmarks from the submap with the most observations from its own poses
+    std::map<IndexT, std::pair<std::size_t, std::size_t>> bestSubmapPerLandmark;
+    for (std::size_t submapIndex = 0; submapIndex < _submaps.size(); ++submapIndex)
+    {
+        if (!submapsValid.at(submapIndex))
+            continue;
+
+        const sfmData::SfMData& submapData = submapsData.at(submapIndex);
+        for (const auto& landmarkPair : submapData.getLandmarks())
+        {
+            std::size_t nbCoreObservations = 0;
+            for (const auto& observationPair : landmarkPair.second.observations)
+                if (_submapPerPose.at(submapData.getView(observationPair.first).getPoseId()) == submapIndex)
+                    ++nbCoreObservations;
+
+            auto bestIt = bestSubmapPerLandmark.find(landmarkPair.first);
+            if (bestIt == bestSubmapPerLandmark.end())
+                bestSubmapPerLandmark.emplace(landmarkPair.first, std::make_pair(nbCoreObservations, submapIndex));
+            else if (nbCoreObservations > bestIt->second.first)
+                bestIt->second = std::make_pair(nbCoreObservations, submapIndex);
+        }
+    }
+
+    for (const auto& bestPair : bestSubmapPerLandmark)
+        sfmData.getLandmarks().at(bestPair.first).X = submapsData.at(bestPair.second.second).getLandmarks().at(bestPair.first).X;
+
+    // average the refined intrinsics, weighted by the number of poses of each submap
+    if (refineOptions & REFINE_INTRINSICS_ALL)
+    {
+        std::map<IndexT, std::pair<std::vector<double>, double>> weightedParams;
+
+        for (std::size_t submapIndex = 0; submapIndex < _submaps.size(); ++submapIndex)
+        {
+            if (!submapsValid.at(submapIndex))
+                continue;
+
+            const sfmData::SfMData& submapData = submapsData.at(submapIndex);
+            const double weight = _submaps.at(submapIndex).corePoses.size();
+
+            for (const auto& intrinsicPair : submapData.getIntrinsics())
+            {
+                const std::vector<double> params = intrinsicPair.second->getParams();
+                auto& weighted = weightedParams[intrinsicPair.first];
+                if (weighted.first.empty())
+                    weighted.first.assign(params.size(), 0.0);
+                for (std::size_t i = 0; i < params.size(); ++i)
+                    weighted.first[i] += weight * params[i];
+                weighted.second += weight;
+            }
+        }
+
+        for (auto& weightedPair : weightedParams)
+        {
+            const std::shared_ptr<camera::IntrinsicBase>& intrinsic = sfmData.getIntrinsics().at(weightedPair.first);
+            if (intrinsic->isLocked() || weightedPair.second.second <= 0.0)
+                continue;
+
+            std::vector<double>& params = weightedPair.second.first;
+            for (double& param : params)
+                param /= weightedPair.second.second;
+            intrinsic->updateFromParams(params);
+        }
+    }
+
+    // refine the boundaries of the submaps
+    return adjustSeparators(sfmData, posesGraph, refineOptions);
+}
+
+}  // namespace sfm
+}  // namespace aliceVision
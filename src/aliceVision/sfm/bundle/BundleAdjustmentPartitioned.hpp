@@ -0,0 +1,132 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2023 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <aliceVision/types.hpp>
+#include <aliceVision/sfm/bundle/BundleAdjustment.hpp>
+#include <aliceVision/sfm/bundle/BundleAdjustmentCeres.hpp>
+
+#include <map>
+#include <random>
+#include <set>
+#include <vector>
+
+namespace aliceVision {
+
+namespace sfmData {
+class SfMData;
+}  // namespace sfmData
+
+namespace sfm {
+
+/**
+ * @brief Bundle adjustment of large scenes by overlapping submaps.
+ *
+ * The poses are partitioned into submaps by region growing on the graph of the poses sharing landmarks.
+ * Each submap is extended with the poses of its neighbour submaps up to a graph-distance (separator cameras),
+ * adjusted independently and in parallel, then aligned to the scene through its cameras and merged:
+ *  - the poses are taken from the submap they belong to,
+ *  - the landmarks from the submap with the most observations from its own poses,
+ *  - the refined intrinsics are averaged over the submaps.
+ * A last bundle adjustment refines the separator cameras and their neighbourhood only,
+ * using the graph-distances of the LocalBundleAdjustmentGraph.
+ */
+class BundleAdjustmentPartitioned : public BundleAdjustment
+{
+  public:
+    /**
+     * @brief Contains the partition parameters.
+     */
+    struct PartitionOptions
+    {
+        /// maximum number of poses in a submap (without its separator cameras)
+        std::size_t maxNbPosesPerSubmap = 500;
+        /// graph-distance of the separator cameras added around each submap,
+        /// also used as the distance of the refined cameras around the separators in the final adjustment
+        std::size_t overlapDistance = 1;
+        /// minimum number of shared landmarks to connect two poses in the graph
+        std::size_t minNbSharedLandmarks = 50;
+        /// seed of the random generators of the submaps alignment
+        unsigned int randomSeed = std::mt19937::default_seed;
+    };
+
+    /**
+     * @brief Partitioned bundle adjustment constructor
+     * @param[in] ceresOptions The user Ceres options, used for the submaps and the final adjustment
+     * @param[in] partitionOptions The partition parameters
+     * @param[in] minNbImagesToRefineOpticalCenter The minimum number of images to refine the optical center
+     */
+    BundleAdjustmentPartitioned(const BundleAdjustmentCeres::CeresOptions& ceresOptions = BundleAdjustmentCeres::CeresOptions(),
+                                const PartitionOptions& partitionOptions = PartitionOptions(),
+                                int minNbImagesToRefineOpticalCenter = 3)
+      : _ceresOptions(ceresOptions),
+        _partitionOptions(partitionOptions),
+        _minNbImagesToRefineOpticalCenter(minNbImagesToRefineOpticalCenter)
+    {}
+
+    /**
+     * @brief Perform a partitioned Bundle Adjustment on the SfM scene with refinement of the requested parameters
+     *        A single bundle adjustment is performed if the scene fits in one submap.
+     * @param[in,out] sfmData The input SfMData contains all the information about the reconstruction
+     * @param[in] refineOptions The chosen refine flag
+     * @return false if the bundle adjustment failed else true
+     * @see BundleAdjustment::Adjust
+     */
+    bool adjust(sfmData::SfMData& sfmData, ERefineOptions refineOptions = REFINE_ALL);
+
+    /**
+     * @brief Get the number of submaps of the last adjustment
+     * @return number of submaps
+     */
+    inline std::size_t getNbSubmaps() const { return _submaps.size(); }
+
+  private:
+    /**
+     * @brief A submap: its own poses and its poses with the separator cameras.
+     */
+    struct Submap
+    {
+        std::set<IndexT> corePoses;
+        std::set<IndexT> poses;
+    };
+
+    /**
+     * @brief Build the graph of the poses sharing at least PartitionOptions::minNbSharedLandmarks landmarks
+     * @param[in] sfmData The input SfMData
+     * @param[out] posesGraph The adjacent poses of each pose
+     */
+    void buildPosesGraph(const sfmData::SfMData& sfmData, std::map<IndexT, std::vector<IndexT>>& posesGraph) const;
+
+    /**
+     * @brief Partition the poses into submaps by region growing and extend them with the separator cameras
+     * @param[in] posesGraph The adjacent poses of each pose
+     */
+    void partition(const std::map<IndexT, std::vector<IndexT>>& posesGraph);
+
+    /**
+     * @brief Final bundle adjustment of the separator cameras and their neighbourhood
+     * @param[in,out] sfmData The merged SfMData
+     * @param[in] posesGraph The adjacent poses of each pose
+     * @param[in] refineOptions The chosen refine flag
+     * @return false if the bundle adjustment failed else true
+     */
+    bool adjustSeparators(sfmData::SfMData& sfmData, const std::map<IndexT, std::vector<IndexT>>& posesGraph, ERefineOptions refineOptions) const;
+
+    /// user Ceres options
+    BundleAdjustmentCeres::CeresOptions _ceresOptions;
+    /// partition parameters
+    PartitionOptions _partitionOptions;
+    int _minNbImagesToRefineOpticalCenter = 3;
+
+    /// submaps of the last adjustment
+    std::vector<Submap> _submaps;
+    /// submap index of each pose
+    std::map<IndexT, std::size_t> _submapPerPose;
+};
+
+}  // namespace sfm
+}  // namespace aliceVision
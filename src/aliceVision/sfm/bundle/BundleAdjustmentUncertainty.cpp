@@ -0,0 +1,473 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "BundleAdjustmentUncertainty.hpp"
+
+#include <aliceVision/system/Logger.hpp>
+#include <aliceVision/alicevision_omp.hpp>
+
+#include <Eigen/SparseCholesky>
+
+#include <algorithm>
+#include <map>
+#include <memory>
+
+namespace aliceVision {
+namespace sfm {
+
+namespace {
+
+using SparseMatrixRowMajor = Eigen::SparseMatrix<double, Eigen::RowMajor>;
+using MatrixX3d = Eigen::Matrix<double, Eigen::Dynamic, 3>;
+
+/// parameter of a Jacobian column
+struct ColumnInfo
+{
+    /// camera block of the column, -1 if it is not a camera parameter
+    int cameraBlock = -1;
+    /// landmark of the column, -1 if it is not a landmark parameter
+    int landmark = -1;
+    /// index of the parameter in its block
+    int offset = 0;
+};
+
+/// Jacobian row split into its landmark and camera blocks
+struct RowBlocks
+{
+    int landmark = -1;
+    Vec3 landmarkValues;
+    /// the camera blocks of the row and their values, only the first nbBlocks entries are used
+    std::vector<int> blocks;
+    std::vector<Eigen::VectorXd> values;
+    std::size_t nbBlocks = 0;
+
+    const Eigen::VectorXd* find(int block) const
+    {
+        for (std::size_t i = 0; i < nbBlocks; ++i)
+        {
+            if (blocks[i] == block)
+                return &values[i];
+        }
+        return nullptr;
+    }
+};
+
+/**
+ * @brief Decode a row of the Jacobian, the values of the constant and fixed camera parameters are skipped.
+ * @return false if the row has several landmarks
+ */
+bool decodeRow(const SparseMatrixRowMajor& jacobian,
+               int row,
+               const std::vector<ColumnInfo>& columns,
+               const std::vector<std::pair<int, int>>& cameraBlocks,
+               const std::vector<std::vector<int>>& reducedIndexes,
+               RowBlocks& out)
+{
+    out.landmark = -1;
+    out.landmarkValues.setZero();
+    out.nbBlocks = 0;
+
+    for (SparseMatrixRowMajor::InnerIterator it(jacobian, row); it; ++it)
+    {
+        const ColumnInfo& column = columns[it.col()];
+        if (column.landmark >= 0)
+        {
+            if (out.landmark >= 0 && out.landmark != column.landmark)
+                return false;
+            out.landmark = column.landmark;
+            out.landmarkValues(column.offset) += it.value();
+        }
+        else if (column.cameraBlock >= 0 && reducedIndexes[column.cameraBlock][column.offset] >= 0)
+        {
+            std::size_t i = 0;
+            while (i < out.nbBlocks && out.blocks[i] != column.cameraBlock)
+                ++i;
+            if (i == out.nbBlocks)
+            {
+                if (out.blocks.size() == i)
+                {
+                    out.blocks.emplace_back();
+                    out.values.emplace_back();
+                }
+                out.blocks[i] = column.cameraBlock;
+                out.values[i].setZero(cameraBlocks[column.cameraBlock].second);
+                ++out.nbBlocks;
+            }
+            out.values[i](column.offset) += it.value();
+        }
+    }
+    return true;
+}
+
+/// pseudo-inverse of the normal matrix of a landmark, for the landmarks with a degenerate geometry
+Mat3 pseudoInverse(const Mat3& m)
+{
+    const Eigen::SelfAdjointEigenSolver<Mat3> solver(m);
+    const Vec3& eigenValues = solver.eigenvalues();
+    const double threshold = 1e-12 * eigenValues.cwiseAbs().maxCoeff();
+    Vec3 inverseValues;
+    for (int i = 0; i < 3; ++i)
+        inverseValues(i) = (std::abs(eigenValues(i)) > threshold) ? 1.0 / eigenValues(i) : 0.0;
+    return solver.eigenvectors() * inverseValues.asDiagonal() * solver.eigenvectors().transpose();
+}
+
+/**
+ * @brief Entries of the inverse of a sparse symmetric matrix in the pattern of its LDL^T factor (selected inversion).
+ *
+ * Computed backward from the last column with the Takahashi recurrence, for i > j in the pattern of the column j of L:
+ *   Z(i,j) = - sum_{k > j} L(k,j) Z(i,k)
+ *   Z(j,j) = 1 / D(j) - sum_{k > j} L(k,j) Z(k,j)
+ * The pattern of a column of L is a clique of the filled graph, so all the Z(i,k) are known from the previous columns.
+ */
+class SelectedInverse
+{
+  public:
+    template<class LDLT>
+    explicit SelectedInverse(const LDLT& ldlt)
+    {
+        const auto& L = ldlt.matrixL().nestedExpression();
+        const auto& D = ldlt.vectorD();
+        const int n = L.cols();
+
+        _rows.resize(n);
+        _values.resize(n);
+        _diagonal.resize(n);
+        _permutation = ldlt.permutationP().indices();
+
+        std::vector<std::vector<double>> factor(n);
+#pragma omp parallel for
+        for (int j = 0; j < n; ++j)
+        {
+            std::vector<std::pair<int, double>> column;
+            for (typename std::decay<decltype(L)>::type::InnerIterator it(L, j); it; ++it)
+            {
+                if (it.row() > j)
+                    column.emplace_back(it.row(), it.value());
+            }
+            std::sort(column.begin(), column.end());
+            _rows[j].resize(column.size());
+            factor[j].resize(column.size());
+            for (std::size_t k = 0; k < column.size(); ++k)
+            {
+                _rows[j][k] = column[k].first;
+                factor[j][k] = column[k].second;
+            }
+            _values[j].resize(column.size());
+        }
+
+        for (int j = n - 1; j >= 0; --j)
+        {
+            const std::vector<int>& rows = _rows[j];
+            const std::vector<double>& l = factor[j];
+            const int m = rows.size();
+
+#pragma omp parallel for if (m > 256)
+            for (int t = 0; t < m; ++t)
+            {
+                double sum = 0.0;
+                for (int u = 0; u < m; ++u)
+                    sum += l[u] * permutedValue(rows[t], rows[u]);
+                _values[j][t] = -sum;
+            }
+
+            double sum = 0.0;
+            for (int u = 0; u < m; ++u)
+                sum += l[u] * _values[j][u];
+            _diagonal[j] = 1.0 / D(j) - sum;
+        }
+    }
+
+    /// entry (i,j) of the inverse, in the original order, 0 if it is not in the pattern of the factor
+    double operator()(int i, int j) const { return permutedValue(_permutation(i), _permutation(j)); }
+
+  private:
+    double permutedValue(int i, int j) const
+    {
+        if (i == j)
+            return _diagonal[i];
+        const int col = std::min(i, j);
+        const int row = std::max(i, j);
+        const std::vector<int>& rows = _rows[col];
+        const auto it = std::lower_bound(rows.begin(), rows.end(), row);
+        if (it == rows.end() || *it != row)
+            return 0.0;
+        return _values[col][it - rows.begin()];
+    }
+
+    std::vector<std::vector<int>> _rows;
+    std::vector<std::vector<double>> _values;
+    std::vector<double> _diagonal;
+    Eigen::VectorXi _permutation;
+};
+
+}  // namespace
+
+bool computeMarginalCovariances(const Eigen::SparseMatrix<double, Eigen::RowMajor>& jacobian,
+                                const std::vector<std::pair<int, int>>& cameraBlocks,
+                                const std::vector<int>& landmarksColumn,
+                                const std::vector<int>& fixedColumns,
+                                std::vector<Eigen::MatrixXd>& camerasCovariance,
+                                std::vector<Mat3>& landmarksCovariance)
+{
+    const int nbRows = jacobian.rows();
+    const int nbBlocks = cameraBlocks.size();
+    const int nbLandmarks = landmarksColumn.size();
+
+    // parameter of each column
+    std::vector<ColumnInfo> columns(jacobian.cols());
+    for (int a = 0; a < nbBlocks; ++a)
+    {
+        for (int k = 0; k < cameraBlocks[a].second; ++k)
+        {
+            ColumnInfo& column = columns.at(cameraBlocks[a].first + k);
+            column.cameraBlock = a;
+            column.offset = k;
+        }
+    }
+    for (int j = 0; j < nbLandmarks; ++j)
+    {
+        for (int k = 0; k < 3; ++k)
+        {
+            ColumnInfo& column = columns.at(landmarksColumn[j] + k);
+            column.landmark = j;
+            column.offset = k;
+        }
+    }
+
+    // the constant parameters have a null column
+    std::vector<double> columnsSquaredNorm(jacobian.cols(), 0.0);
+    for (int r = 0; r < nbRows; ++r)
+    {
+        for (SparseMatrixRowMajor::InnerIterator it(jacobian, r); it; ++it)
+            columnsSquaredNorm[it.col()] += it.value() * it.value();
+    }
+    std::vector<bool> fixed(jacobian.cols(), false);
+    for (const int c : fixedColumns)
+        fixed.at(c) = true;
+
+    // index of the free camera parameters in the reduced camera system, -1 for the constant and fixed ones
+    std::vector<std::vector<int>> reducedIndexes(nbBlocks);
+    int nbReduced = 0;
+    for (int a = 0; a < nbBlocks; ++a)
+    {
+        reducedIndexes[a].resize(cameraBlocks[a].second, -1);
+        for (int k = 0; k < cameraBlocks[a].second; ++k)
+        {
+            const int c = cameraBlocks[a].first + k;
+            if (!fixed[c] && columnsSquaredNorm[c] > 0.0)
+                reducedIndexes[a][k] = nbReduced++;
+        }
+    }
+
+    // rows of each landmark and of each camera block
+    std::vector<int> rowsLandmark(nbRows, -1);
+    std::vector<std::vector<int>> rowsBlocks(nbRows);
+    bool validRows = true;
+#pragma omp parallel for reduction(&& : validRows)
+    for (int r = 0; r < nbRows; ++r)
+    {
+        RowBlocks row;
+        validRows = validRows && decodeRow(jacobian, r, columns, cameraBlocks, reducedIndexes, row);
+        rowsLandmark[r] = row.landmark;
+        rowsBlocks[r].assign(row.blocks.begin(), row.blocks.begin() + row.nbBlocks);
+    }
+    if (!validRows)
+    {
+        ALICEVISION_LOG_ERROR("Cannot compute the covariances: a residual depends on several landmarks.");
+        return false;
+    }
+
+    std::vector<std::vector<int>> landmarksRows(nbLandmarks);
+    std::vector<std::vector<int>> blocksRows(nbBlocks);
+    for (int r = 0; r < nbRows; ++r)
+    {
+        if (rowsLandmark[r] >= 0)
+            landmarksRows[rowsLandmark[r]].push_back(r);
+        for (const int a : rowsBlocks[r])
+            blocksRows[a].push_back(r);
+    }
+    rowsBlocks.clear();
+    rowsBlocks.shrink_to_fit();
+
+    // inverse of the landmarks normal matrices V and landmark/camera blocks W of the normal matrix
+    std::vector<Mat3> landmarksInverseV(nbLandmarks);
+    std::vector<std::vector<std::pair<int, MatrixX3d>>> landmarksW(nbLandmarks);
+#pragma omp parallel for schedule(dynamic)
+    for (int j = 0; j < nbLandmarks; ++j)
+    {
+        RowBlocks row;
+        Mat3 V = Mat3::Zero();
+        std::vector<std::pair<int, MatrixX3d>>& W = landmarksW[j];
+        for (const int r : landmarksRows[j])
+        {
+            decodeRow(jacobian, r, columns, cameraBlocks, reducedIndexes, row);
+            V += row.landmarkValues * row.landmarkValues.transpose();
+            for (std::size_t i = 0; i < row.nbBlocks; ++i)
+            {
+                auto it = std::find_if(W.begin(), W.end(), [&](const std::pair<int, MatrixX3d>& w) { return w.first == row.blocks[i]; });
+                if (it == W.end())
+                {
+                    W.emplace_back(row.blocks[i], MatrixX3d::Zero(row.values[i].size(), 3));
+                    it = W.end() - 1;
+                }
+                it->second += row.values[i] * row.landmarkValues.transpose();
+            }
+        }
+        landmarksInverseV[j] = pseudoInverse(V);
+    }
+    landmarksRows.clear();
+    landmarksRows.shrink_to_fit();
+
+    // landmarks observed by each camera block, with the index of the block in the landmark W blocks
+    std::vector<std::vector<std::pair<int, int>>> blocksLandmarks(nbBlocks);
+    for (int j = 0; j < nbLandmarks; ++j)
+    {
+        for (std::size_t k = 0; k < landmarksW[j].size(); ++k)
+            blocksLandmarks[landmarksW[j][k].first].emplace_back(j, k);
+    }
+
+    // reduced camera system S = U - W.V^-1.W^T, assembled per block row
+    std::vector<std::vector<Eigen::Triplet<double>>> threadsTriplets(omp_get_max_threads());
+#pragma omp parallel for schedule(dynamic)
+    for (int a = 0; a < nbBlocks; ++a)
+    {
+        std::map<int, Eigen::MatrixXd> blocksRow;
+        const auto getBlock = [&](int b) -> Eigen::MatrixXd& {
+            auto it = blocksRow.find(b);
+            if (it == blocksRow.end())
+                it = blocksRow.emplace(b, Eigen::MatrixXd::Zero(cameraBlocks[a].second, cameraBlocks[b].second)).first;
+            return it->second;
+        };
+
+        RowBlocks row;
+        for (const int r : blocksRows[a])
+        {
+            decodeRow(jacobian, r, columns, cameraBlocks, reducedIndexes, row);
+            const Eigen::VectorXd& va = *row.find(a);
+            for (std::size_t i = 0; i < row.nbBlocks; ++i)
+            {
+                if (row.blocks[i] <= a)
+                    getBlock(row.blocks[i]) += va * row.values[i].transpose();
+            }
+        }
+
+        for (const std::pair<int, int>& landmark : blocksLandmarks[a])
+        {
+            const std::vector<std::pair<int, MatrixX3d>>& W = landmarksW[landmark.first];
+            const MatrixX3d T = W[landmark.second].second * landmarksInverseV[landmark.first];
+            for (const std::pair<int, MatrixX3d>& w : W)
+            {
+                if (w.first <= a)
+                    getBlock(w.first) -= T * w.second.transpose();
+            }
+        }
+
+        std::vector<Eigen::Triplet<double>>& triplets = threadsTriplets[omp_get_thread_num()];
+        for (const auto& block : blocksRow)
+        {
+            const int b = block.first;
+            for (int ka = 0; ka < cameraBlocks[a].second; ++ka)
+            {
+                const int ra = reducedIndexes[a][ka];
+                if (ra < 0)
+                    continue;
+                for (int kb = 0; kb < cameraBlocks[b].second; ++kb)
+                {
+                    const int rb = reducedIndexes[b][kb];
+                    if (rb < 0)
+                        continue;
+                    triplets.emplace_back(ra, rb, block.second(ka, kb));
+                    if (b != a)
+                        triplets.emplace_back(rb, ra, block.second(ka, kb));
+                }
+            }
+        }
+    }
+
+    std::vector<Eigen::Triplet<double>> triplets;
+    for (std::vector<Eigen::Triplet<double>>& threadTriplets : threadsTriplets)
+    {
+        triplets.insert(triplets.end(), threadTriplets.begin(), threadTriplets.end());
+        threadTriplets.clear();
+        threadTriplets.shrink_to_fit();
+    }
+    Eigen::SparseMatrix<double> S(nbReduced, nbReduced);
+    S.setFromTriplets(triplets.begin(), triplets.end());
+    triplets.clear();
+    triplets.shrink_to_fit();
+
+    ALICEVISION_LOG_DEBUG("Reduced camera system: " << nbReduced << " parameters, " << S.nonZeros() << " non-zeros.");
+
+    // factorization and selected inversion of the reduced camera system
+    std::unique_ptr<SelectedInverse> inverseS;
+    if (nbReduced > 0)
+    {
+        const Eigen::SimplicialLDLT<Eigen::SparseMatrix<double>> ldlt(S);
+        if (ldlt.info() != Eigen::Success)
+        {
+            ALICEVISION_LOG_ERROR("Cannot factorize the reduced camera system, the gauge of the reconstruction may not be fixed.");
+            return false;
+        }
+        const double maxD = ldlt.vectorD().cwiseAbs().maxCoeff();
+        if (ldlt.vectorD().minCoeff() <= 1e-12 * maxD)
+        {
+            ALICEVISION_LOG_ERROR("The reduced camera system is singular, the gauge of the reconstruction is not fixed.");
+            return false;
+        }
+        inverseS.reset(new SelectedInverse(ldlt));
+    }
+
+    camerasCovariance.resize(nbBlocks);
+#pragma omp parallel for
+    for (int a = 0; a < nbBlocks; ++a)
+    {
+        const std::vector<int>& reduced = reducedIndexes[a];
+        Eigen::MatrixXd& covariance = camerasCovariance[a];
+        covariance.setZero(reduced.size(), reduced.size());
+        for (std::size_t k = 0; k < reduced.size(); ++k)
+        {
+            for (std::size_t l = 0; l < reduced.size(); ++l)
+            {
+                if (reduced[k] >= 0 && reduced[l] >= 0)
+                    covariance(k, l) = (*inverseS)(reduced[k], reduced[l]);
+            }
+        }
+    }
+
+    // landmark covariance: V^-1 + V^-1.W^T.S^-1.W.V^-1 over the camera blocks observing the landmark
+    landmarksCovariance.resize(nbLandmarks);
+#pragma omp parallel for schedule(dynamic)
+    for (int j = 0; j < nbLandmarks; ++j)
+    {
+        const std::vector<std::pair<int, MatrixX3d>>& W = landmarksW[j];
+        Mat3 M = Mat3::Zero();
+        for (const std::pair<int, MatrixX3d>& wa : W)
+        {
+            for (const std::pair<int, MatrixX3d>& wb : W)
+            {
+                const std::vector<int>& reducedA = reducedIndexes[wa.first];
+                const std::vector<int>& reducedB = reducedIndexes[wb.first];
+                Eigen::MatrixXd covarianceAB = Eigen::MatrixXd::Zero(reducedA.size(), reducedB.size());
+                for (std::size_t k = 0; k < reducedA.size(); ++k)
+                {
+                    for (std::size_t l = 0; l < reducedB.size(); ++l)
+                    {
+                        if (reducedA[k] >= 0 && reducedB[l] >= 0)
+                            covarianceAB(k, l) = (*inverseS)(reducedA[k], reducedB[l]);
+                    }
+                }
+                M += wa.second.transpose() * covarianceAB * wb.second;
+            }
+        }
+        const Mat3& inverseV = landmarksInverseV[j];
+        landmarksCovariance[j] = inverseV + inverseV * M * inverseV;
+    }
+
+    return true;
+}
+
+}  // namespace sfm
+}  // namespace aliceVision
@@ -0,0 +1,48 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <aliceVision/numeric/numeric.hpp>
+
+#include <Eigen/SparseCore>
+
+#include <utility>
+#include <vector>
+
+namespace aliceVision {
+namespace sfm {
+
+/**
+ * @brief Compute the marginal covariances of the parameters of a bundle adjustment from its Jacobian.
+ *
+ * The normal matrix H = J^T.J is never inverted as a whole:
+ *  - the landmarks are eliminated with the Schur complement, the reduced camera system S is assembled per block row in parallel,
+ *  - S is factorized with a sparse LDL^T and only the entries of its inverse in the pattern of the factor are computed
+ *    (selected inversion). They include the diagonal blocks of the cameras and the blocks of the cameras observing a same landmark,
+ *  - the covariance of each landmark is recovered from its camera blocks, in parallel.
+ *
+ * The parameters with a null column in the Jacobian (constant parameters) are ignored.
+ * The gauge freedom of the reconstruction (7 degrees of freedom) must be fixed with fixedColumns,
+ * the covariances are then relative to the fixed parameters.
+ *
+ * @param[in] jacobian the Jacobian of the residuals, one column per parameter
+ * @param[in] cameraBlocks first column and size of each block of camera parameters (poses, intrinsics, rigs)
+ * @param[in] landmarksColumn first column of the 3 parameters of each landmark
+ * @param[in] fixedColumns the columns held constant to fix the gauge
+ * @param[out] camerasCovariance the covariance of each camera block, null for the constant and fixed parameters
+ * @param[out] landmarksCovariance the covariance of each landmark
+ * @return false if the reduced camera system is singular (the gauge is not fixed)
+ */
+bool computeMarginalCovariances(const Eigen::SparseMatrix<double, Eigen::RowMajor>& jacobian,
+                                const std::vector<std::pair<int, int>>& cameraBlocks,
+                                const std::vector<int>& landmarksColumn,
+                                const std::vector<int>& fixedColumns,
+                                std::vector<Eigen::MatrixXd>& camerasCovariance,
+                                std::vector<Mat3>& landmarksCovariance);
+
+}  // namespace sfm
+}  // namespace aliceVision
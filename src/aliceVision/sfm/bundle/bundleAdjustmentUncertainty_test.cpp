@@ -0,0 +1,140 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <aliceVision/sfm/bundle/BundleAdjustmentUncertainty.hpp>
+
+#include <random>
+#include <vector>
+
+#define BOOST_TEST_MODULE bundleAdjustmentUncertainty
+
+#include <boost/test/unit_test.hpp>
+
+using namespace aliceVision;
+using namespace aliceVision::sfm;
+
+// Test summary:
+// - Create a random Jacobian with the structure of a bundle adjustment: pose blocks, a shared intrinsic block
+//   with a constant parameter, landmarks observed by a few poses
+// - Fix the gauge with the first pose
+// - Check the marginal covariances against the inverse of the dense normal matrix
+
+BOOST_AUTO_TEST_CASE(BUNDLE_ADJUSTMENT_UNCERTAINTY_MarginalCovariances)
+{
+    const int nbPoses = 6;
+    const int nbLandmarks = 40;
+    const int intrinsicSize = 4;
+    const int constantIntrinsicParameter = 3;
+    const int observationsPerLandmark = 3;
+
+    // columns: poses, intrinsic, landmarks
+    std::vector<std::pair<int, int>> cameraBlocks;
+    for (int p = 0; p < nbPoses; ++p)
+        cameraBlocks.emplace_back(6 * p, 6);
+    const int intrinsicColumn = 6 * nbPoses;
+    cameraBlocks.emplace_back(intrinsicColumn, intrinsicSize);
+    std::vector<int> landmarksColumn;
+    for (int j = 0; j < nbLandmarks; ++j)
+        landmarksColumn.push_back(intrinsicColumn + intrinsicSize + 3 * j);
+    const int nbColumns = intrinsicColumn + intrinsicSize + 3 * nbLandmarks;
+
+    std::mt19937 generator(42);
+    std::uniform_real_distribution<double> value(-1.0, 1.0);
+    std::uniform_int_distribution<int> pose(0, nbPoses - 1);
+
+    std::vector<Eigen::Triplet<double>> triplets;
+    int nbRows = 0;
+    for (int j = 0; j < nbLandmarks; ++j)
+    {
+        for (int o = 0; o < observationsPerLandmark; ++o)
+        {
+            const int p = (o == 0) ? j % nbPoses : pose(generator);
+            for (int r = 0; r < 2; ++r, ++nbRows)
+            {
+                for (int k = 0; k < 6; ++k)
+                    triplets.emplace_back(nbRows, 6 * p + k, value(generator));
+                for (int k = 0; k < intrinsicSize; ++k)
+                {
+                    if (k != constantIntrinsicParameter)
+                        triplets.emplace_back(nbRows, intrinsicColumn + k, value(generator));
+                }
+                for (int k = 0; k < 3; ++k)
+                    triplets.emplace_back(nbRows, landmarksColumn[j] + k, value(generator));
+            }
+        }
+    }
+    Eigen::SparseMatrix<double, Eigen::RowMajor> jacobian(nbRows, nbColumns);
+    jacobian.setFromTriplets(triplets.begin(), triplets.end());
+
+    const std::vector<int> fixedColumns = {0, 1, 2, 3, 4, 5};
+
+    std::vector<Eigen::MatrixXd> camerasCovariance;
+    std::vector<Mat3> landmarksCovariance;
+    BOOST_REQUIRE(computeMarginalCovariances(jacobian, cameraBlocks, landmarksColumn, fixedColumns, camerasCovariance, landmarksCovariance));
+    BOOST_REQUIRE_EQUAL(camerasCovariance.size(), cameraBlocks.size());
+    BOOST_REQUIRE_EQUAL(landmarksCovariance.size(), nbLandmarks);
+
+    // reference: inverse of the dense normal matrix without the fixed and constant parameters
+    std::vector<int> freeColumns(nbColumns, -1);
+    int nbFree = 0;
+    for (int c = 6; c < nbColumns; ++c)
+    {
+        if (c != intrinsicColumn + constantIntrinsicParameter)
+            freeColumns[c] = nbFree++;
+    }
+    const Eigen::MatrixXd denseJacobian = Eigen::MatrixXd(jacobian);
+    Eigen::MatrixXd freeJacobian(nbRows, nbFree);
+    for (int c = 0; c < nbColumns; ++c)
+    {
+        if (freeColumns[c] >= 0)
+            freeJacobian.col(freeColumns[c]) = denseJacobian.col(c);
+    }
+    const Eigen::MatrixXd covariance = (freeJacobian.transpose() * freeJacobian).inverse();
+
+    const auto expected = [&](int c0, int c1) {
+        return (freeColumns[c0] < 0 || freeColumns[c1] < 0) ? 0.0 : covariance(freeColumns[c0], freeColumns[c1]);
+    };
+
+    for (std::size_t a = 0; a < cameraBlocks.size(); ++a)
+    {
+        const int size = cameraBlocks[a].second;
+        BOOST_REQUIRE_EQUAL(camerasCovariance[a].rows(), size);
+        for (int k = 0; k < size; ++k)
+        {
+            for (int l = 0; l < size; ++l)
+                BOOST_CHECK_SMALL(camerasCovariance[a](k, l) - expected(cameraBlocks[a].first + k, cameraBlocks[a].first + l), 1e-8);
+        }
+    }
+
+    for (int j = 0; j < nbLandmarks; ++j)
+    {
+        for (int k = 0; k < 3; ++k)
+        {
+            for (int l = 0; l < 3; ++l)
+                BOOST_CHECK_SMALL(landmarksCovariance[j](k, l) - expected(landmarksColumn[j] + k, landmarksColumn[j] + l), 1e-8);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(BUNDLE_ADJUSTMENT_UNCERTAINTY_GaugeNotFixed)
+{
+    // two poses observing the same landmarks, without fixed parameters: the normal matrix is singular
+    std::vector<std::pair<int, int>> cameraBlocks = {{0, 2}, {2, 2}};
+    std::vector<int> landmarksColumn = {4};
+    std::vector<Eigen::Triplet<double>> triplets;
+    for (int r = 0; r < 4; ++r)
+    {
+        const int p = r / 2;
+        triplets.emplace_back(r, 2 * p + r % 2, 1.0);
+        triplets.emplace_back(r, 4 + r % 2, -1.0);
+    }
+    Eigen::SparseMatrix<double, Eigen::RowMajor> jacobian(4, 7);
+    jacobian.setFromTriplets(triplets.begin(), triplets.end());
+
+    std::vector<Eigen::MatrixXd> camerasCovariance;
+    std::vector<Mat3> landmarksCovariance;
+    BOOST_CHECK(!computeMarginalCovariances(jacobian, cameraBlocks, landmarksColumn, {}, camerasCovariance, landmarksCovariance));
+}
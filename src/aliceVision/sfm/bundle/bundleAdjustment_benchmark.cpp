@@ -0,0 +1,67 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <aliceVision/sfm/sfm.hpp>
+#include <aliceVision/sfm/utils/syntheticScene.hpp>
+#include <aliceVision/camera/cameraCommon.hpp>
+#include <aliceVision/multiview/NViewDataSet.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <random>
+
+using namespace aliceVision;
+using namespace aliceVision::sfm;
+
+namespace {
+
+/**
+ * @brief Synthetic ring scene with noisy landmarks, so the bundle adjustment has to move them back.
+ */
+sfmData::SfMData createNoisyScene(int nbViews, int nbPoints)
+{
+    const NViewDatasetConfigurator config;
+    const NViewDataSet d = NRealisticCamerasRing(nbViews, nbPoints, config);
+    sfmData::SfMData sfmData = getInputScene(d, config, camera::EINTRINSIC::PINHOLE_CAMERA_RADIAL3);
+
+    std::mt19937 generator(0);
+    std::normal_distribution<double> noise(0.0, 0.01);
+    for (auto& landmarkPair : sfmData.getLandmarks())
+        landmarkPair.second.X += Vec3(noise(generator), noise(generator), noise(generator));
+
+    return sfmData;
+}
+
+/**
+ * @brief Bundle adjustment of state.range(0) views and state.range(1) landmarks seen by all the views.
+ */
+void BM_BundleAdjustmentCeres(benchmark::State& state, bool sparse)
+{
+    const int nbViews = static_cast<int>(state.range(0));
+    const int nbPoints = static_cast<int>(state.range(1));
+
+    // single thread and fixed number of iterations for reproducible timings
+    BundleAdjustmentCeres::CeresOptions options(false, false);
+    if (sparse)
+        options.setSparseBA();
+
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        sfmData::SfMData sfmData = createNoisyScene(nbViews, nbPoints);
+        BundleAdjustmentCeres bundleAdjustment(options);
+        state.ResumeTiming();
+
+        benchmark::DoNotOptimize(bundleAdjustment.adjust(sfmData));
+    }
+
+    state.SetItemsProcessed(state.iterations() * nbViews * nbPoints);
+}
+
+}  // namespace
+
+BENCHMARK_CAPTURE(BM_BundleAdjustmentCeres, dense, false)->Args({8, 500})->Args({16, 1000})->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_BundleAdjustmentCeres, sparse, true)->Args({8, 500})->Args({16, 1000})->Args({64, 2000})->Unit(benchmark::kMillisecond);
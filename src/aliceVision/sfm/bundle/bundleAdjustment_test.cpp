@@ -243,6 +243,141 @@ BOOST_AUTO_TEST_CASE(LOCAL_BUNDLE_ADJUSTMENT_EffectiveMinimization_Pinhole_Camer
     BOOST_CHECK_LT(dResidual_after, dResidual_before);
 }
 
+BOOST_AUTO_TEST_CASE(BUNDLE_ADJUSTMENT_PersistentProblem)
+{
+    const int nviews = 4;
+    const int npoints = 8;
+    const NViewDatasetConfigurator config;
+    const NViewDataSet d = NRealisticCamerasRing(nviews, npoints, config);
+
+    // Translate the input dataset to a SfMData scene
+    SfMData sfmData = getInputScene(d, config, EINTRINSIC::PINHOLE_CAMERA);
+
+    const double dResidual_before = RMSE(sfmData);
+
+    BundleAdjustmentCeres::CeresOptions options;
+    options.usePersistentProblem = true;
+    BundleAdjustmentCeres BA(options);
+
+    BOOST_CHECK(BA.adjust(sfmData));
+    BOOST_CHECK_EQUAL(BA.getStatistics().nbResidualBlocks, 2 * nviews * npoints);
+
+    // remove an outlier observation and a landmark, the problem is updated in place
+    sfmData.getLandmarks().at(0).observations.erase(0);
+    sfmData.getLandmarks().erase(1);
+
+    BOOST_CHECK(BA.adjust(sfmData));
+    BOOST_CHECK_EQUAL(BA.getStatistics().nbResidualBlocks, 2 * (nviews * (npoints - 1) - 1));
+
+    // add back the landmark with its observations
+    Landmark landmark;
+    landmark.X = d._X.col(1);
+    for (int j = 0; j < nviews; ++j)
+        landmark.observations[j] = Observation(d._x[j].col(1), 1, 0.0);
+    sfmData.getLandmarks()[1] = landmark;
+
+    BOOST_CHECK(BA.adjust(sfmData));
+    BOOST_CHECK_EQUAL(BA.getStatistics().nbResidualBlocks, 2 * (nviews * npoints - 1));
+
+    const double dResidual_after = RMSE(sfmData);
+    BOOST_CHECK_LT(dResidual_after, dResidual_before);
+}
+
+BOOST_AUTO_TEST_CASE(BUNDLE_ADJUSTMENT_RigConstantSubPoses)
+{
+    const int nframes = 4;
+    const int npoints = 8;
+    const NViewDatasetConfigurator config;
+    const NViewDataSet d = NRealisticCamerasRing(nframes, npoints, config);
+
+    // a rig of 2 cameras with constant sub-poses, one view per frame and sub-pose
+    SfMData sfmData;
+    Rig rig(2);
+    rig.setSubPose(0, RigSubPose(Pose3(), ERigSubPoseStatus::CONSTANT));
+    rig.setSubPose(1, RigSubPose(Pose3(RotationAroundY(0.1), Vec3(0.1, 0.0, 0.0)), ERigSubPoseStatus::CONSTANT));
+    sfmData.getRigs().emplace(0, rig);
+
+    const unsigned int w = config._cx * 2;
+    const unsigned int h = config._cy * 2;
+    sfmData.getIntrinsics().emplace(0, createIntrinsic(EINTRINSIC::PINHOLE_CAMERA, w, h, config._fx, config._fx, 0, 0));
+
+    for (int f = 0; f < nframes; ++f)
+    {
+        sfmData.getPoses().emplace(f, CameraPose(Pose3(d._R[f], d._C[f])));
+        for (int s = 0; s < 2; ++s)
+        {
+            const IndexT viewId = 2 * f + s;
+            auto view = std::make_shared<View>("", viewId, 0, f, w, h, 0, s);
+            sfmData.getViews().emplace(viewId, view);
+        }
+    }
+
+    for (int i = 0; i < npoints; ++i)
+    {
+        Landmark landmark;
+        landmark.X = d._X.col(i);
+        for (const auto& viewPair : sfmData.getViews())
+        {
+            const View& view = *viewPair.second;
+            const Vec2 pt = sfmData.getIntrinsics().at(0)->project(sfmData.getPose(view).getTransform(), landmark.X.homogeneous());
+            landmark.observations[view.getViewId()] = Observation(pt, i, 0.0);
+        }
+        sfmData.getLandmarks()[i] = landmark;
+    }
+
+    // move the rig poses away from the solution
+    for (int f = 1; f < nframes; ++f)
+    {
+        CameraPose& pose = sfmData.getPoses().at(f);
+        pose.setTransform(Pose3(pose.getTransform().rotation(), pose.getTransform().center() + Vec3(0.05, -0.05, 0.05)));
+    }
+
+    const double dResidual_before = RMSE(sfmData);
+    const Rig rigBefore = sfmData.getRigs().at(0);
+
+    for (const bool usePersistentProblem : {false, true})
+    {
+        SfMData sfmDataAdjusted = sfmData;
+
+        BundleAdjustmentCeres::CeresOptions options;
+        options.usePersistentProblem = usePersistentProblem;
+        BundleAdjustmentCeres BA(options);
+
+        BOOST_CHECK(BA.adjust(sfmDataAdjusted));
+        BOOST_CHECK_EQUAL(BA.getStatistics().nbResidualBlocks, 2 * 2 * nframes * npoints);
+
+        // the constant sub-poses are not modified
+        BOOST_CHECK(sfmDataAdjusted.getRigs().at(0).getSubPose(1).pose.getHomogeneous() == rigBefore.getSubPose(1).pose.getHomogeneous());
+
+        const double dResidual_after = RMSE(sfmDataAdjusted);
+        BOOST_CHECK_LT(dResidual_after, dResidual_before);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(BUNDLE_ADJUSTMENT_Partitioned)
+{
+    const int nviews = 12;
+    const int npoints = 12;
+    const NViewDatasetConfigurator config;
+    const NViewDataSet d = NRealisticCamerasRing(nviews, npoints, config);
+
+    // Translate the input dataset to a SfMData scene
+    SfMData sfmData = getInputScene(d, config, EINTRINSIC::PINHOLE_CAMERA);
+
+    const double dResidual_before = RMSE(sfmData);
+
+    BundleAdjustmentPartitioned::PartitionOptions partitionOptions;
+    partitionOptions.maxNbPosesPerSubmap = 4;
+    partitionOptions.minNbSharedLandmarks = 1;
+
+    BundleAdjustmentPartitioned BA(BundleAdjustmentCeres::CeresOptions(), partitionOptions);
+    BOOST_CHECK(BA.adjust(sfmData));
+    BOOST_CHECK_EQUAL(BA.getNbSubmaps(), 3);
+
+    const double dResidual_after = RMSE(sfmData);
+    BOOST_CHECK_LT(dResidual_after, dResidual_before);
+}
+
 /// Compute the Root Mean Square Error of the residuals
 double RMSE(const SfMData& sfm_data)
 {
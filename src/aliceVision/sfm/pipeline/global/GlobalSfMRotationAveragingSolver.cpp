@@ -18,6 +18,10 @@ namespace sfm {
 
 using namespace aliceVision::rotationAveraging;
 
+/// number of cameras above which the L2 rotation averaging uses the sparse formulation,
+/// the dense eigen decomposition being cubic in the number of cameras
+const std::size_t l2SparseMinNbCameras = 200;
+
 PairSet GlobalSfMRotationAveragingSolver::GetUsedPairs() const { return used_pairs; }
 
 bool GlobalSfMRotationAveragingSolver::Run(ERotationAveragingMethod eRotationAveragingMethod,
@@ -84,7 +88,10 @@ bool GlobalSfMRotationAveragingSolver::Run(ERotationAveragingMethod eRotationAve
         case ROTATION_AVERAGING_L2:
         {
             //- Solve the global rotation estimation problem:
-            bSuccess = rotationAveraging::l2::L2RotationAveraging(_reindexForward.size(), relativeRotations, vec_globalR);
+            if (_reindexForward.size() < l2SparseMinNbCameras)
+                bSuccess = rotationAveraging::l2::L2RotationAveraging(_reindexForward.size(), relativeRotations, vec_globalR);
+            else
+                bSuccess = rotationAveraging::l2::L2RotationAveraging_Sparse(_reindexForward.size(), relativeRotations, vec_globalR);
 
             ALICEVISION_LOG_DEBUG("rotationAveraging::l2::L2RotationAveraging: success: " << bSuccess);
             //- Non linear refinement of the global rotations
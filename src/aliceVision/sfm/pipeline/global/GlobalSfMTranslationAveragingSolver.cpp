@@ -11,7 +11,6 @@
 #include <aliceVision/sfmDataIO/sfmDataIO.hpp>
 #include <aliceVision/sfm/bundle/BundleAdjustmentCeres.hpp>
 #include <aliceVision/sfm/pipeline/global/reindexGlobalSfM.hpp>
-#include <aliceVision/sfm/pipeline/global/MutexSet.hpp>
 #include <aliceVision/matching/IndMatch.hpp>
 #include <aliceVision/multiview/translationAveraging/common.hpp>
 #include <aliceVision/multiview/translationAveraging/solver.hpp>
@@ -31,6 +30,10 @@
 
 #include <aliceVision/utils/Histogram.hpp>
 
+#include <array>
+#include <atomic>
+#include <map>
+
 namespace aliceVision {
 namespace sfm {
 
@@ -289,6 +292,29 @@ void GlobalSfMTranslationAveragingSolver::Compute_translations(const SfMData& sf
       sfmData, map_globalR, normalizedFeaturesPerView, pairwiseMatches, randomNumberGenerator, m_vec_initialRijTijEstimates, tripletWise_matches);
 }
 
+namespace {
+
+/// Matches of the view pairs, grouped by pair of poses (smallest pose id first)
+using MatchesPerPosePair = std::map<Pair, std::vector<const matching::PairwiseMatches::value_type*>>;
+
+/**
+ * @brief List the matches between the views of the triplet poses
+ */
+void getTripletMatches(const MatchesPerPosePair& matchesPerPosePair, const graph::Triplet& triplet, matching::PairwiseMatches& tripletMatches)
+{
+    tripletMatches.clear();
+    for (const Pair& posePair : {Pair(triplet.i, triplet.j), Pair(triplet.i, triplet.k), Pair(triplet.j, triplet.k)})
+    {
+        const auto it = matchesPerPosePair.find(posePair);
+        if (it == matchesPerPosePair.end())
+            continue;
+        for (const matching::PairwiseMatches::value_type* matches : it->second)
+            tripletMatches.insert(*matches);
+    }
+}
+
+}  // namespace
+
 //-- Perform a trifocal estimation of the graph contained in vec_triplets with an
 // edge coverage algorithm. Its complexity is sub-linear in term of edges count.
 void GlobalSfMTranslationAveragingSolver::ComputePutativeTranslation_EdgesCoverage(const SfMData& sfmData,
@@ -309,6 +335,7 @@ void GlobalSfMTranslationAveragingSolver::ComputePutativeTranslation_EdgesCovera
     //   - list all edges that have support in the rotation pose graph
     //
     PairSet rotation_pose_id_graph;
+    MatchesPerPosePair matchesPerPosePair;
     std::set<IndexT> set_pose_ids;
     std::transform(map_globalR.begin(), map_globalR.end(), std::inserter(set_pose_ids, set_pose_ids.begin()), stl::RetrieveKey());
     // List shared correspondences (pairs) between poses
@@ -322,6 +349,7 @@ void GlobalSfMTranslationAveragingSolver::ComputePutativeTranslation_EdgesCovera
           (v1->getPoseId() != v2->getPoseId()) && set_pose_ids.count(v1->getPoseId()) && set_pose_ids.count(v2->getPoseId()))
         {
             rotation_pose_id_graph.insert(std::make_pair(v1->getPoseId(), v2->getPoseId()));
+            matchesPerPosePair[std::minmax(v1->getPoseId(), v2->getPoseId())].push_back(&match_iterator);
         }
     }
     // List putative triplets (from global rotations Ids)
@@ -334,78 +362,82 @@ void GlobalSfMTranslationAveragingSolver::ComputePutativeTranslation_EdgesCovera
         // An estimated triplets of translation mark three edges as estimated.
 
         //-- precompute the number of track per triplet:
-        HashMap<IndexT, IndexT> map_tracksPerTriplets;
+        std::vector<std::size_t> vec_tracksPerTriplets(vec_triplets.size(), 0);
 
 #pragma omp parallel for schedule(dynamic)
         for (int i = 0; i < (int)vec_triplets.size(); ++i)
         {
             // List matches that belong to the triplet of poses
-            const graph::Triplet& triplet = vec_triplets[i];
             matching::PairwiseMatches map_triplet_matches;
-            const std::set<IndexT> set_triplet_pose_ids = {triplet.i, triplet.j, triplet.k};
-            // List shared correspondences (pairs) between the triplet poses
-            for (const auto& match_iterator : pairwiseMatches)
-            {
-                const Pair pair = match_iterator.first;
-                const View* v1 = sfmData.getViews().at(pair.first).get();
-                const View* v2 = sfmData.getViews().at(pair.second).get();
-                if (  // Consider the pair iff it is supported by the triplet graph & 2 different pose id
-                  (v1->getPoseId() != v2->getPoseId()) && set_triplet_pose_ids.count(v1->getPoseId()) && set_triplet_pose_ids.count(v2->getPoseId()))
-                {
-                    map_triplet_matches.insert(match_iterator);
-                }
-            }
-            // Compute tracks:
-            {
-                aliceVision::track::TracksBuilder tracksBuilder;
-                tracksBuilder.build(map_triplet_matches);
-                tracksBuilder.filter(true, 3);
+            getTripletMatches(matchesPerPosePair, vec_triplets[i], map_triplet_matches);
 
-#pragma omp critical
-                map_tracksPerTriplets[i] = tracksBuilder.nbTracks();  // count the # of matches in the UF tree
-            }
+            // Compute tracks:
+            aliceVision::track::TracksBuilder tracksBuilder;
+            tracksBuilder.build(map_triplet_matches);
+            tracksBuilder.filter(true, 3);
+            vec_tracksPerTriplets[i] = tracksBuilder.nbTracks();  // count the # of matches in the UF tree
         }
 
         typedef Pair myEdge;
 
         //-- Alias (list triplet ids used per pose id edges)
-        std::map<myEdge, std::vector<size_t>> map_tripletIds_perEdge;
-        for (size_t i = 0; i < vec_triplets.size(); ++i)
+        std::map<myEdge, std::size_t> map_edgeIndex;
+        for (const graph::Triplet& triplet : vec_triplets)
         {
-            const graph::Triplet& triplet = vec_triplets[i];
-            map_tripletIds_perEdge[std::make_pair(triplet.i, triplet.j)].push_back(i);
-            map_tripletIds_perEdge[std::make_pair(triplet.i, triplet.k)].push_back(i);
-            map_tripletIds_perEdge[std::make_pair(triplet.j, triplet.k)].push_back(i);
+            map_edgeIndex.emplace(myEdge(triplet.i, triplet.j), 0);
+            map_edgeIndex.emplace(myEdge(triplet.i, triplet.k), 0);
+            map_edgeIndex.emplace(myEdge(triplet.j, triplet.k), 0);
         }
 
         // Collect edges that are covered by the triplets
         std::vector<myEdge> vec_edges;
-        std::transform(map_tripletIds_perEdge.begin(), map_tripletIds_perEdge.end(), std::back_inserter(vec_edges), stl::RetrieveKey());
+        vec_edges.reserve(map_edgeIndex.size());
+        for (auto& edgeIndex : map_edgeIndex)
+        {
+            edgeIndex.second = vec_edges.size();
+            vec_edges.push_back(edgeIndex.first);
+        }
 
-        aliceVision::sfm::MutexSet<myEdge> m_mutexSet;
+        std::vector<std::vector<std::size_t>> vec_tripletIds_perEdge(vec_edges.size());
+        std::vector<std::array<std::size_t, 3>> vec_edges_perTriplet(vec_triplets.size());
+        for (std::size_t i = 0; i < vec_triplets.size(); ++i)
+        {
+            const graph::Triplet& triplet = vec_triplets[i];
+            vec_edges_perTriplet[i] = {map_edgeIndex.at(myEdge(triplet.i, triplet.j)),
+                                       map_edgeIndex.at(myEdge(triplet.j, triplet.k)),
+                                       map_edgeIndex.at(myEdge(triplet.i, triplet.k))};
+            for (const std::size_t edgeIndex : vec_edges_perTriplet[i])
+                vec_tripletIds_perEdge[edgeIndex].push_back(i);
+        }
+
+        // Edges already estimated by a triplet (shared between the threads without lock)
+        std::vector<std::atomic<bool>> vec_estimatedEdges(vec_edges.size());
+        std::atomic<std::size_t> nbEstimatedEdges(0);
 
         auto progressDisplay =
           system::createConsoleProgressDisplay(vec_edges.size(), std::cout, "\nRelative translations computation (edge coverage algorithm)\n");
 
-        // set number of threads, 1 if openMP is not enabled
+        // per thread results, merged at the end (1 thread if openMP is not enabled)
         std::vector<translationAveraging::RelativeInfoVec> initial_estimates(omp_get_max_threads());
-        const bool bVerbose = false;
+        std::vector<matching::PairwiseMatches> newpairMatches_perThread(omp_get_max_threads());
+
+        // each triplet estimation has its own random generator, seeded by the triplet index
+        const std::mt19937::result_type seed = randomNumberGenerator();
 
 #pragma omp parallel for schedule(dynamic)
         for (int k = 0; k < vec_edges.size(); ++k)
         {
-            const myEdge& edge = vec_edges[k];
             ++progressDisplay;
-            if (m_mutexSet.count(edge) == 0 && m_mutexSet.size() != vec_edges.size())
+            if (!vec_estimatedEdges[k] && nbEstimatedEdges != vec_edges.size())
             {
                 // Find the triplets that support the given edge
-                const auto& vec_possibleTripletIndexes = map_tripletIds_perEdge.at(edge);
+                const auto& vec_possibleTripletIndexes = vec_tripletIds_perEdge[k];
 
                 //-- Sort the triplets according the number of track they are supporting
                 std::vector<size_t> vec_commonTracksPerTriplets;
                 for (const size_t triplet_index : vec_possibleTripletIndexes)
                 {
-                    vec_commonTracksPerTriplets.push_back(map_tracksPerTriplets[triplet_index]);
+                    vec_commonTracksPerTriplets.push_back(vec_tracksPerTriplets[triplet_index]);
                 }
 
                 using namespace stl::indexed_sort;
@@ -422,10 +454,10 @@ void GlobalSfMTranslationAveragingSolver::ComputePutativeTranslation_EdgesCovera
                 for (const size_t triplet_index : vec_triplet_ordered)
                 {
                     const graph::Triplet& triplet = vec_triplets[triplet_index];
+                    const std::array<std::size_t, 3>& tripletEdges = vec_edges_perTriplet[triplet_index];
 
                     // If the triplet is already estimated by another thread; try the next one
-                    if (m_mutexSet.count(Pair(triplet.i, triplet.j)) && m_mutexSet.count(Pair(triplet.i, triplet.k)) &&
-                        m_mutexSet.count(Pair(triplet.j, triplet.k)))
+                    if (vec_estimatedEdges[tripletEdges[0]] && vec_estimatedEdges[tripletEdges[1]] && vec_estimatedEdges[tripletEdges[2]])
                     {
                         break;
                     }
@@ -439,13 +471,18 @@ void GlobalSfMTranslationAveragingSolver::ComputePutativeTranslation_EdgesCovera
                     std::vector<size_t> vec_inliers;
                     aliceVision::track::TracksMap pose_triplet_tracks;
 
+                    matching::PairwiseMatches map_triplet_matches;
+                    getTripletMatches(matchesPerPosePair, triplet, map_triplet_matches);
+
+                    std::mt19937 tripletRandomNumberGenerator(seed + triplet_index);
+
                     const std::string sOutDirectory = "./";
                     const bool bTriplet_estimation = Estimate_T_triplet(sfmData,
                                                                         map_globalR,
                                                                         normalizedFeaturesPerView,
-                                                                        pairwiseMatches,
+                                                                        map_triplet_matches,
                                                                         triplet,
-                                                                        randomNumberGenerator,
+                                                                        tripletRandomNumberGenerator,
                                                                         vec_tis,
                                                                         dPrecision,
                                                                         vec_inliers,
@@ -455,9 +492,14 @@ void GlobalSfMTranslationAveragingSolver::ComputePutativeTranslation_EdgesCovera
                     if (bTriplet_estimation)
                     {
                         // Since new translation edges have been computed, mark their corresponding edges as estimated
-                        m_mutexSet.insert(std::make_pair(triplet.i, triplet.j));
-                        m_mutexSet.insert(std::make_pair(triplet.j, triplet.k));
-                        m_mutexSet.insert(std::make_pair(triplet.i, triplet.k));
+                        for (const std::size_t edgeIndex : tripletEdges)
+                        {
+                            if (!vec_estimatedEdges[edgeIndex].exchange(true))
+                                ++nbEstimatedEdges;
+                        }
+
+                        // set number of threads, 1 if openMP is not enabled
+                        const int thread_id = omp_get_thread_num();
 
                         // Compute the triplet relative motions (IJ, JK, IK)
                         {
@@ -476,48 +518,41 @@ void GlobalSfMTranslationAveragingSolver::ComputePutativeTranslation_EdgesCovera
                             Vec3 tik;
                             relativeCameraMotion(RI, ti, RK, tk, &Rik, &tik);
 
-                            // set number of threads, 1 if openMP is not enabled
-                            const int thread_id = omp_get_thread_num();
-
                             initial_estimates[thread_id].emplace_back(std::make_pair(triplet.i, triplet.j), std::make_pair(Rij, tij));
                             initial_estimates[thread_id].emplace_back(std::make_pair(triplet.j, triplet.k), std::make_pair(Rjk, tjk));
                             initial_estimates[thread_id].emplace_back(std::make_pair(triplet.i, triplet.k), std::make_pair(Rik, tik));
+                        }
+
+                        // Add inliers as valid pairwise matches
+                        matching::PairwiseMatches& threadPairMatches = newpairMatches_perThread[thread_id];
+                        for (std::vector<size_t>::const_iterator iterInliers = vec_inliers.begin(); iterInliers != vec_inliers.end(); ++iterInliers)
+                        {
+                            using namespace aliceVision::track;
+                            TracksMap::iterator it_tracks = pose_triplet_tracks.begin();
+                            std::advance(it_tracks, *iterInliers);
+                            const Track& track = it_tracks->second;
 
-//--- ATOMIC
-#pragma omp critical
+                            // create pairwise matches from inlier track
+                            for (size_t index_I = 0; index_I < track.featPerView.size(); ++index_I)
                             {
-                                // Add inliers as valid pairwise matches
-                                for (std::vector<size_t>::const_iterator iterInliers = vec_inliers.begin(); iterInliers != vec_inliers.end();
-                                     ++iterInliers)
+                                Track::FeatureIdPerView::const_iterator iter_I = track.featPerView.begin();
+                                std::advance(iter_I, index_I);
+
+                                // extract camera indexes
+                                const size_t id_view_I = iter_I->first;
+                                const size_t id_feat_I = iter_I->second.featureId;
+
+                                // loop on subtracks
+                                for (size_t index_J = index_I + 1; index_J < track.featPerView.size(); ++index_J)
                                 {
-                                    using namespace aliceVision::track;
-                                    TracksMap::iterator it_tracks = pose_triplet_tracks.begin();
-                                    std::advance(it_tracks, *iterInliers);
-                                    const Track& track = it_tracks->second;
-
-                                    // create pairwise matches from inlier track
-                                    for (size_t index_I = 0; index_I < track.featPerView.size(); ++index_I)
-                                    {
-                                        Track::FeatureIdPerView::const_iterator iter_I = track.featPerView.begin();
-                                        std::advance(iter_I, index_I);
-
-                                        // extract camera indexes
-                                        const size_t id_view_I = iter_I->first;
-                                        const size_t id_feat_I = iter_I->second.featureId;
-
-                                        // loop on subtracks
-                                        for (size_t index_J = index_I + 1; index_J < track.featPerView.size(); ++index_J)
-                                        {
-                                            Track::FeatureIdPerView::const_iterator iter_J = track.featPerView.begin();
-                                            std::advance(iter_J, index_J);
-
-                                            // extract camera indexes
-                                            const size_t id_view_J = iter_J->first;
-                                            const size_t id_feat_J = iter_J->second.featureId;
-
-                                            newpairMatches[std::make_pair(id_view_I, id_view_J)][track.descType].emplace_back(id_feat_I, id_feat_J);
-                                        }
-                                    }
+                                    Track::FeatureIdPerView::const_iterator iter_J = track.featPerView.begin();
+                                    std::advance(iter_J, index_J);
+
+                                    // extract camera indexes
+                                    const size_t id_view_J = iter_J->first;
+                                    const size_t id_feat_J = iter_J->second.featureId;
+
+                                    threadPairMatches[std::make_pair(id_view_I, id_view_J)][track.descType].emplace_back(id_feat_I, id_feat_J);
                                 }
                             }
                         }
@@ -529,13 +564,24 @@ void GlobalSfMTranslationAveragingSolver::ComputePutativeTranslation_EdgesCovera
             }
         }
         // Merge thread estimates
-        for (const auto vec : initial_estimates)
+        for (const auto& vec : initial_estimates)
         {
-            for (const auto val : vec)
+            for (const auto& val : vec)
             {
                 vec_initialEstimates.emplace_back(val);
             }
         }
+        for (const matching::PairwiseMatches& threadPairMatches : newpairMatches_perThread)
+        {
+            for (const auto& pairMatches : threadPairMatches)
+            {
+                for (const auto& descMatches : pairMatches.second)
+                {
+                    matching::IndMatches& matches = newpairMatches[pairMatches.first][descMatches.first];
+                    matches.insert(matches.end(), descMatches.second.begin(), descMatches.second.end());
+                }
+            }
+        }
     }
 
     const double timeLP_triplet = timerLP_triplet.elapsed();
@@ -558,7 +604,7 @@ void GlobalSfMTranslationAveragingSolver::ComputePutativeTranslation_EdgesCovera
 bool GlobalSfMTranslationAveragingSolver::Estimate_T_triplet(const SfMData& sfmData,
                                                              const HashMap<IndexT, Mat3>& map_globalR,
                                                              const feature::FeaturesPerView& normalizedFeaturesPerView,
-                                                             const matching::PairwiseMatches& pairwiseMatches,
+                                                             const matching::PairwiseMatches& map_triplet_matches,
                                                              const graph::Triplet& poses_id,
                                                              std::mt19937& randomNumberGenerator,
                                                              std::vector<Vec3>& vec_tis,
@@ -567,22 +613,6 @@ bool GlobalSfMTranslationAveragingSolver::Estimate_T_triplet(const SfMData& sfmD
                                                              aliceVision::track::TracksMap& tracks,
                                                              const std::string& outDirectory) const
 {
-    // List matches that belong to the triplet of poses
-    matching::PairwiseMatches map_triplet_matches;
-    const std::set<IndexT> set_pose_ids = {poses_id.i, poses_id.j, poses_id.k};
-    // List shared correspondences (pairs) between poses
-    for (const auto& match_iterator : pairwiseMatches)
-    {
-        const Pair& pair = match_iterator.first;
-        const View* v1 = sfmData.getViews().at(pair.first).get();
-        const View* v2 = sfmData.getViews().at(pair.second).get();
-        if (  // Consider the pair iff it is supported by the triplet graph & 2 different pose id
-          (v1->getPoseId() != v2->getPoseId()) && set_pose_ids.count(v1->getPoseId()) && set_pose_ids.count(v2->getPoseId()))
-        {
-            map_triplet_matches.insert(match_iterator);
-        }
-    }
-
     aliceVision::track::TracksBuilder tracksBuilder;
     tracksBuilder.build(map_triplet_matches);
     tracksBuilder.filter(true, 3);
@@ -104,11 +104,12 @@ class GlobalSfMTranslationAveragingSolver
 
     /**
      * @brief Robust estimation and refinement of a translation and 3D points of an image triplets.
+     * @param[in] tripletMatches The matches between the views of the triplet poses
      */
     bool Estimate_T_triplet(const sfmData::SfMData& sfmData,
                             const HashMap<IndexT, Mat3>& map_globalR,
                             const feature::FeaturesPerView& normalizedFeaturesPerView,
-                            const matching::PairwiseMatches& pairwiseMatches,
+                            const matching::PairwiseMatches& tripletMatches,
                             const graph::Triplet& poses_id,
                             std::mt19937& randomNumberGenerator,
                             std::vector<Vec3>& vec_tis,
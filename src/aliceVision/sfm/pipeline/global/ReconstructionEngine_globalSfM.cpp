@@ -6,6 +6,7 @@
 // You can obtain one at https://mozilla.org/MPL/2.0/.
 
 #include "ReconstructionEngine_globalSfM.hpp"
+#include <aliceVision/sfm/bundle/BundleAdjustmentPartitioned.hpp>
 #include <aliceVision/sfmData/SfMData.hpp>
 #include <aliceVision/sfmDataIO/sfmDataIO.hpp>
 #include <aliceVision/multiview/triangulation/triangulationDLT.hpp>
@@ -372,10 +373,25 @@ bool ReconstructionEngine_globalSfM::Adjust()
     // refine sfm  scene (in a 3 iteration process (free the parameters regarding their incertainty order)):
     BundleAdjustmentCeres::CeresOptions options;
     options.useParametersOrdering = false;  // disable parameters ordering
+    options.setSolver(_bundleAdjustmentSolver, _sfmData.getPoses().size() > 100);
+    options.useMixedPrecision = _bundleAdjustmentMixedPrecision;
+    options.useGpu = _bundleAdjustmentUseGpu;
+
+    std::unique_ptr<BundleAdjustment> BA;
+    if (_bundleAdjustmentMaxPosesPerSubmap > 0 && _sfmData.getPoses().size() > _bundleAdjustmentMaxPosesPerSubmap)
+    {
+        BundleAdjustmentPartitioned::PartitionOptions partitionOptions;
+        partitionOptions.maxNbPosesPerSubmap = _bundleAdjustmentMaxPosesPerSubmap;
+        partitionOptions.randomSeed = _randomNumberGenerator();
+        BA.reset(new BundleAdjustmentPartitioned(options, partitionOptions));
+    }
+    else
+    {
+        BA.reset(new BundleAdjustmentCeres(options));
+    }
 
-    BundleAdjustmentCeres BA(options);
     // - refine only Structure and translations
-    bool success = BA.adjust(_sfmData, BundleAdjustment::REFINE_TRANSLATION | BundleAdjustment::REFINE_STRUCTURE);
+    bool success = BA->adjust(_sfmData, BundleAdjustment::REFINE_TRANSLATION | BundleAdjustment::REFINE_STRUCTURE);
     if (success)
     {
         if (!_loggingFile.empty())
@@ -384,7 +400,7 @@ bool ReconstructionEngine_globalSfM::Adjust()
                             sfmDataIO::ESfMData(sfmDataIO::EXTRINSICS | sfmDataIO::STRUCTURE));
 
         // refine only structure and rotations & translations
-        success = BA.adjust(_sfmData, BundleAdjustment::REFINE_ROTATION | BundleAdjustment::REFINE_TRANSLATION | BundleAdjustment::REFINE_STRUCTURE);
+        success = BA->adjust(_sfmData, BundleAdjustment::REFINE_ROTATION | BundleAdjustment::REFINE_TRANSLATION | BundleAdjustment::REFINE_STRUCTURE);
 
         if (success && !_loggingFile.empty())
             sfmDataIO::Save(_sfmData,
@@ -395,7 +411,7 @@ bool ReconstructionEngine_globalSfM::Adjust()
     if (success && !_lockAllIntrinsics)
     {
         // refine all: Structure, motion:{rotations, translations} and optics:{intrinsics}
-        success = BA.adjust(_sfmData, BundleAdjustment::REFINE_ALL);
+        success = BA->adjust(_sfmData, BundleAdjustment::REFINE_ALL);
         if (success && !_loggingFile.empty())
             sfmDataIO::Save(_sfmData,
                             (fs::path(_loggingFile).parent_path() / "structure_02_refine_KRT_Xi.ply").string(),
@@ -439,7 +455,7 @@ bool ReconstructionEngine_globalSfM::Adjust()
       BundleAdjustment::REFINE_ROTATION | BundleAdjustment::REFINE_TRANSLATION | BundleAdjustment::REFINE_STRUCTURE;
     if (!_lockAllIntrinsics)
         refineOptions |= BundleAdjustment::REFINE_INTRINSICS_ALL;
-    success = BA.adjust(_sfmData, refineOptions);
+    success = BA->adjust(_sfmData, refineOptions);
 
     if (success && !_loggingFile.empty())
         sfmDataIO::Save(_sfmData,
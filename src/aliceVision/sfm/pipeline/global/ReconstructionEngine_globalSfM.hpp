@@ -8,6 +8,7 @@
 #pragma once
 
 #include <aliceVision/sfm/pipeline/ReconstructionEngine.hpp>
+#include <aliceVision/sfm/bundle/BundleAdjustment.hpp>
 #include <aliceVision/sfm/pipeline/global/GlobalSfMRotationAveragingSolver.hpp>
 #include <aliceVision/sfm/pipeline/global/GlobalSfMTranslationAveragingSolver.hpp>
 
@@ -32,6 +33,10 @@ class ReconstructionEngine_globalSfM : public ReconstructionEngine
     void SetTranslationAveragingMethod(ETranslationAveragingMethod eTranslationAveragingMethod);
 
     void setLockAllIntrinsics(bool v) { _lockAllIntrinsics = v; }
+    void setBundleAdjustmentSolver(EBundleAdjustmentSolver v) { _bundleAdjustmentSolver = v; }
+    void setBundleAdjustmentMixedPrecision(bool v) { _bundleAdjustmentMixedPrecision = v; }
+    void setBundleAdjustmentUseGpu(bool v) { _bundleAdjustmentUseGpu = v; }
+    void setBundleAdjustmentMaxPosesPerSubmap(std::size_t v) { _bundleAdjustmentMaxPosesPerSubmap = v; }
 
     virtual bool process();
 
@@ -60,6 +65,11 @@ class ReconstructionEngine_globalSfM : public ReconstructionEngine
     ERotationAveragingMethod _eRotationAveragingMethod;
     ETranslationAveragingMethod _eTranslationAveragingMethod;
     bool _lockAllIntrinsics = false;
+    EBundleAdjustmentSolver _bundleAdjustmentSolver = EBundleAdjustmentSolver::DENSE_SCHUR;
+    bool _bundleAdjustmentMixedPrecision = false;
+    bool _bundleAdjustmentUseGpu = false;
+    /// partition the bundle adjustment in submaps of this size if the scene is larger, 0 to disable
+    std::size_t _bundleAdjustmentMaxPosesPerSubmap = 0;
     EFeatureConstraint _featureConstraint = EFeatureConstraint::BASIC;
 
     // Data provider
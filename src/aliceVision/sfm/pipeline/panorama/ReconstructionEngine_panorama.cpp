@@ -613,14 +613,38 @@ void ReconstructionEngine_panorama::Compute_Relative_Rotations(rotationAveraging
     sfm::Constraints2D& constraints2d = _sfmData.getConstraints2D();
     std::map<IndexT, size_t> connection_size;
 
+    std::vector<PoseWiseMatches::const_iterator> poseWiseMatchesIts;
+    poseWiseMatchesIts.reserve(poseWiseMatches.size());
+    for (PoseWiseMatches::const_iterator iter = poseWiseMatches.begin(); iter != poseWiseMatches.end(); ++iter)
+        poseWiseMatchesIts.push_back(iter);
+
+    /// result of the relative rotation estimation of a pair of poses
+    struct PoseRelativeRotation
+    {
+        bool valid = false;
+        IndexT I = UndefinedIndexT;
+        IndexT J = UndefinedIndexT;
+        Mat3 rotation;
+        double weight = 1.0;
+        std::size_t nbInliers = 0;
+        sfm::Constraints2D constraints2d;
+    };
+    std::vector<PoseRelativeRotation> poseRelativeRotations(poseWiseMatchesIts.size());
+
+    // the seeds are drawn before the parallel loop, so the results do not depend on the number of threads
+    std::vector<std::mt19937::result_type> seeds(poseWiseMatchesIts.size());
+    for (auto& seed : seeds)
+        seed = _randomNumberGenerator();
+
     ALICEVISION_LOG_INFO("Relative pose computation:");
     // For each pair of matching views, compute the relative pose
-    for (int i = 0; i < poseWiseMatches.size(); ++i)
+#pragma omp parallel for schedule(dynamic)
+    for (int i = 0; i < poseWiseMatchesIts.size(); ++i)
     {
         {
-            PoseWiseMatches::const_iterator iter(poseWiseMatches.begin());
-            std::advance(iter, i);
-            const auto& relative_pose_iterator(*iter);
+            std::mt19937 randomNumberGenerator(seeds[i]);
+            PoseRelativeRotation& poseRelativeRotation = poseRelativeRotations[i];
+            const auto& relative_pose_iterator(*poseWiseMatchesIts[i]);
             const Pair relative_pose_pair = relative_pose_iterator.first;
             const PairSet& match_pairs = relative_pose_iterator.second;
 
@@ -737,7 +761,7 @@ void ReconstructionEngine_panorama::Compute_Relative_Rotations(rotationAveraging
             {
                 case RELATIVE_ROTATION_FROM_E:
                 {
-                    if (!robustRelativeRotation_fromE(K, K, x1, x2, imageSize, imageSize, _randomNumberGenerator, relativePose_info))
+                    if (!robustRelativeRotation_fromE(K, K, x1, x2, imageSize, imageSize, randomNumberGenerator, relativePose_info))
                     {
                         ALICEVISION_LOG_INFO("Relative pose computation: i: " << i << ", (" << I << ", " << J << ") => FAILED");
                         continue;
@@ -750,7 +774,7 @@ void ReconstructionEngine_panorama::Compute_Relative_Rotations(rotationAveraging
                     relativeRotation_info._initialResidualTolerance =
                       std::sqrt(std::sqrt(cam_I->imagePlaneToCameraPlaneError(2.5) * cam_J->imagePlaneToCameraPlaneError(2.5)));
 
-                    if (!robustRelativeRotation_fromH(x1, x2, imageSize, imageSize, _randomNumberGenerator, relativeRotation_info))
+                    if (!robustRelativeRotation_fromH(x1, x2, imageSize, imageSize, randomNumberGenerator, relativeRotation_info))
                     {
                         ALICEVISION_LOG_INFO("Relative pose computation: i: " << i << ", (" << I << ", " << J << ") => FAILED");
                         continue;
@@ -768,7 +792,7 @@ void ReconstructionEngine_panorama::Compute_Relative_Rotations(rotationAveraging
                     relativeRotation_info._initialResidualTolerance =
                       std::sqrt(std::sqrt(cam_I->imagePlaneToCameraPlaneError(2.5) * cam_J->imagePlaneToCameraPlaneError(2.5)));
 
-                    if (!robustRelativeRotation_fromR(x1, x2, imageSize, imageSize, _randomNumberGenerator, relativeRotation_info))
+                    if (!robustRelativeRotation_fromR(x1, x2, imageSize, imageSize, randomNumberGenerator, relativeRotation_info))
                     {
                         ALICEVISION_LOG_INFO("Relative pose computation: i: " << i << ", (" << I << ", " << J << ") => FAILED");
                         ALICEVISION_LOG_INFO("I: " << view_I->getImage().getImagePath() << ", J: " << view_J->getImage().getImagePath());
@@ -808,18 +832,6 @@ void ReconstructionEngine_panorama::Compute_Relative_Rotations(rotationAveraging
                 }
             }
 
-            // Add connection to find best constraints
-            if (connection_size.find(I) == connection_size.end())
-            {
-                connection_size[I] = 0;
-            }
-            connection_size[I] += relativePose_info.vec_inliers.size();
-            if (connection_size.find(J) == connection_size.end())
-            {
-                connection_size[J] = 0;
-            }
-            connection_size[J] += relativePose_info.vec_inliers.size();
-
             // Sort all inliers by increasing ids
             if (!relativePose_info.vec_inliers.empty())
             {
@@ -851,7 +863,7 @@ void ReconstructionEngine_panorama::Compute_Relative_Rotations(rotationAveraging
 
                                 const sfm::Constraint2D constraint(
                                   I, sfm::Observation(pt1, match._i, pI.scale()), J, sfm::Observation(pt2, match._j, pJ.scale()), descType);
-                                constraints2d.push_back(constraint);
+                                poseRelativeRotation.constraints2d.push_back(constraint);
 
                                 ++index_inlier;
                             }
@@ -862,15 +874,33 @@ void ReconstructionEngine_panorama::Compute_Relative_Rotations(rotationAveraging
                 }
             }
 
-            // #pragma omp critical
-            {
-                // Add the relative rotation to the relative 'rotation' pose graph
-                using namespace aliceVision::rotationAveraging;
-                vec_relatives_R.emplace_back(relative_pose_pair.first, relative_pose_pair.second, relativePose_info.relativePose.rotation(), weight);
-            }
+            poseRelativeRotation.valid = true;
+            poseRelativeRotation.I = I;
+            poseRelativeRotation.J = J;
+            poseRelativeRotation.rotation = relativePose_info.relativePose.rotation();
+            poseRelativeRotation.weight = weight;
+            poseRelativeRotation.nbInliers = relativePose_info.vec_inliers.size();
         }
     }  // for all relative pose
 
+    // merge the results in the pairs order
+    for (std::size_t i = 0; i < poseWiseMatchesIts.size(); ++i)
+    {
+        const PoseRelativeRotation& poseRelativeRotation = poseRelativeRotations[i];
+        if (!poseRelativeRotation.valid)
+            continue;
+
+        // Add connection to find best constraints
+        connection_size[poseRelativeRotation.I] += poseRelativeRotation.nbInliers;
+        connection_size[poseRelativeRotation.J] += poseRelativeRotation.nbInliers;
+
+        constraints2d.insert(constraints2d.end(), poseRelativeRotation.constraints2d.begin(), poseRelativeRotation.constraints2d.end());
+
+        // Add the relative rotation to the relative 'rotation' pose graph
+        const Pair& relative_pose_pair = poseWiseMatchesIts[i]->first;
+        vec_relatives_R.emplace_back(relative_pose_pair.first, relative_pose_pair.second, poseRelativeRotation.rotation, poseRelativeRotation.weight);
+    }
+
     // Debug result
     ALICEVISION_LOG_DEBUG("Compute_Relative_Rotations: vec_relatives_R.size(): " << vec_relatives_R.size());
     for (rotationAveraging::RelativeRotation& rotation : vec_relatives_R)
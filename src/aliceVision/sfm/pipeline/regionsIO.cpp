@@ -8,6 +8,7 @@
 #include "regionsIO.hpp"
 
 #include <aliceVision/system/ProgressDisplay.hpp>
+#include <aliceVision/system/Storage.hpp>
 #include <boost/filesystem.hpp>
 
 #include <atomic>
@@ -20,7 +21,10 @@ namespace sfm {
 
 using namespace sfmData;
 
-std::unique_ptr<feature::Regions> loadRegions(const std::vector<std::string>& folders, IndexT viewId, const feature::ImageDescriber& imageDescriber)
+std::unique_ptr<feature::Regions> loadRegions(const std::vector<std::string>& folders,
+                                              IndexT viewId,
+                                              const feature::ImageDescriber& imageDescriber,
+                                              bool memoryMapped)
 {
     assert(!folders.empty());
 
@@ -35,7 +39,7 @@ std::unique_ptr<feature::Regions> loadRegions(const std::vector<std::string>& fo
         const fs::path featPath = fs::path(folder) / std::string(basename + "." + imageDescriberTypeName + ".feat");
         const fs::path descPath = fs::path(folder) / std::string(basename + "." + imageDescriberTypeName + ".desc");
 
-        if (fs::exists(featPath) && fs::exists(descPath))
+        if (system::storageFileExists(featPath.string()) && system::storageFileExists(descPath.string()))
         {
             featFilename = featPath.string();
             descFilename = descPath.string();
@@ -45,6 +49,10 @@ std::unique_ptr<feature::Regions> loadRegions(const std::vector<std::string>& fo
     if (featFilename.empty() || descFilename.empty())
         throw std::runtime_error("Can't find view " + basename + " region files");
 
+    // the remote files are read from their copy in the local cache
+    featFilename = system::getStorageLocalPath(featFilename);
+    descFilename = system::getStorageLocalPath(descFilename);
+
     ALICEVISION_LOG_TRACE("Features filename: " << featFilename);
     ALICEVISION_LOG_TRACE("Descriptors filename: " << descFilename);
 
@@ -53,7 +61,10 @@ std::unique_ptr<feature::Regions> loadRegions(const std::vector<std::string>& fo
 
     try
     {
-        regionsPtr->Load(featFilename, descFilename);
+        if (memoryMapped)
+            regionsPtr->LoadMapped(featFilename, descFilename);
+        else
+            regionsPtr->Load(featFilename, descFilename);
     }
     catch (const std::exception& e)
     {
@@ -84,7 +95,11 @@ std::unique_ptr<feature::Regions> loadFeatures(const std::vector<std::string>& f
     std::set<std::string> foldersSet;
     for (const auto& folder : folders)
     {
-        if (fs::exists(folder))
+        if (system::isRemotePath(folder))
+        {
+            foldersSet.insert(folder);
+        }
+        else if (fs::exists(folder))
         {
             foldersSet.insert(fs::canonical(folder).string());
         }
@@ -93,13 +108,16 @@ std::unique_ptr<feature::Regions> loadFeatures(const std::vector<std::string>& f
     for (const auto& folder : foldersSet)
     {
         const fs::path featPath = fs::path(folder) / std::string(basename + "." + imageDescriberTypeName + ".feat");
-        if (fs::exists(featPath))
+        if (system::storageFileExists(featPath.string()))
             featFilename = featPath.string();
     }
 
     if (featFilename.empty())
         throw std::runtime_error("Can't find view " + basename + " features file");
 
+    // the remote file is read from its copy in the local cache
+    featFilename = system::getStorageLocalPath(featFilename);
+
     ALICEVISION_LOG_DEBUG("Features filename: " << featFilename);
 
     std::unique_ptr<feature::Regions> regionsPtr;
@@ -181,7 +199,8 @@ bool loadRegionsPerView(feature::RegionsPerView& regionsPerView,
                         const SfMData& sfmData,
                         const std::vector<std::string>& folders,
                         const std::vector<feature::EImageDescriberType>& imageDescriberTypes,
-                        const std::set<IndexT>& viewIdFilter)
+                        const std::set<IndexT>& viewIdFilter,
+                        bool memoryMapped)
 {
     std::vector<std::string> featuresFolders = sfmData.getFeaturesFolders();        // add sfm features folders
     featuresFolders.insert(featuresFolders.end(), folders.begin(), folders.end());  // add user features folders
@@ -211,7 +230,7 @@ bool loadRegionsPerView(feature::RegionsPerView& regionsPerView,
                     std::unique_ptr<feature::Regions> regionsPtr;
                     try
                     {
-                        regionsPtr = loadRegions(featuresFolders, iter->second.get()->getViewId(), *(imageDescribers.at(i)));
+                        regionsPtr = loadRegions(featuresFolders, iter->second.get()->getViewId(), *(imageDescribers.at(i)), memoryMapped);
                     }
                     catch (const std::exception&)
                     {
@@ -0,0 +1,50 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <aliceVision/sfm/pipeline/RelativePoseInfo.hpp>
+#include <aliceVision/multiview/NViewDataSet.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <random>
+
+using namespace aliceVision;
+using namespace aliceVision::sfm;
+
+/**
+ * @brief ACRANSAC essential matrix estimation (5 points solver) between two views
+ *        with state.range(0) correspondences and state.range(1) percent of outliers.
+ */
+static void BM_ACRansac_RelativePose(benchmark::State& state)
+{
+    const int nbPoints = static_cast<int>(state.range(0));
+    const double outlierRatio = static_cast<double>(state.range(1)) / 100.0;
+
+    const NViewDatasetConfigurator config;
+    const NViewDataSet d = NRealisticCamerasRing(2, nbPoints, config);
+
+    Mat x1 = d._x[0];
+    Mat x2 = d._x[1];
+
+    // replace a part of the correspondences in the second view by random points
+    std::mt19937 generator(0);
+    std::uniform_real_distribution<double> positionDist(0.0, 2.0 * config._cx);
+    for (int i = 0; i < static_cast<int>(nbPoints * outlierRatio); ++i)
+        x2.col(i) = Vec2(positionDist(generator), positionDist(generator));
+
+    const std::pair<std::size_t, std::size_t> imageSize(2 * config._cx, 2 * config._cy);
+
+    for (auto _ : state)
+    {
+        std::mt19937 randomNumberGenerator(0);
+        RelativePoseInfo relativePoseInfo;
+        benchmark::DoNotOptimize(robustRelativePose(d._K[0], d._K[1], x1, x2, randomNumberGenerator, relativePoseInfo, imageSize, imageSize));
+    }
+
+    state.SetItemsProcessed(state.iterations() * nbPoints);
+}
+
+BENCHMARK(BM_ACRansac_RelativePose)->Args({500, 30})->Args({2000, 30})->Args({2000, 60})->Unit(benchmark::kMillisecond);
@@ -6,6 +6,7 @@
 // You can obtain one at https://mozilla.org/MPL/2.0/.
 
 #include <aliceVision/sfm/pipeline/sequential/ReconstructionEngine_sequentialSfM.hpp>
+#include <aliceVision/config.hpp>
 #include <aliceVision/sfm/pipeline/RelativePoseInfo.hpp>
 #include <aliceVision/sfm/utils/statistics.hpp>
 #include <aliceVision/sfmDataIO/sfmDataIO.hpp>
@@ -25,6 +26,7 @@
 #include <aliceVision/robustEstimation/ScoreEvaluator.hpp>
 #include <aliceVision/stl/stl.hpp>
 #include <aliceVision/system/ProgressDisplay.hpp>
+#include <aliceVision/system/Profiler.hpp>
 #include <aliceVision/system/Timer.hpp>
 #include <aliceVision/system/cpu.hpp>
 #include <aliceVision/system/MemoryInfo.hpp>
@@ -33,12 +35,17 @@
 
 #include <dependencies/htmlDoc/htmlDoc.hpp>
 
+#include <boost/algorithm/string/predicate.hpp>
 #include <boost/format.hpp>
 #include <boost/functional/hash.hpp>
 #include <boost/property_tree/json_parser.hpp>
 
 #include <tuple>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
 #include <iostream>
+#include <sstream>
 #include <algorithm>
 
 #ifdef _MSC_VER
@@ -54,6 +61,72 @@ using namespace aliceVision::geometry;
 using namespace aliceVision::camera;
 using namespace aliceVision::sfmData;
 
+namespace {
+
+/// version of the checkpoint state file, to be incremented when its layout changes
+const std::uint32_t checkpointVersion = 1;
+const std::string checkpointStateFilename = "checkpoint_state.bin";
+const std::string checkpointScenePrefix = "checkpoint_";
+#if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_ALEMBIC)
+const std::string checkpointSceneExtension = ".abc";
+#else
+const std::string checkpointSceneExtension = ".sfm";
+#endif
+
+template<typename T>
+void writeCheckpointValue(std::ostream& stream, const T& value)
+{
+    stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template<typename T>
+bool readCheckpointValue(std::istream& stream, T& value)
+{
+    stream.read(reinterpret_cast<char*>(&value), sizeof(T));
+    return bool(stream);
+}
+
+void writeCheckpointString(std::ostream& stream, const std::string& value)
+{
+    writeCheckpointValue(stream, std::uint64_t(value.size()));
+    stream.write(value.data(), value.size());
+}
+
+bool readCheckpointString(std::istream& stream, std::string& value)
+{
+    std::uint64_t size = 0;
+    if (!readCheckpointValue(stream, size) || size > (1 << 20))
+        return false;
+    value.resize(size);
+    stream.read(&value[0], size);
+    return bool(stream);
+}
+
+void writeCheckpointSet(std::ostream& stream, const std::set<IndexT>& values)
+{
+    writeCheckpointValue(stream, std::uint64_t(values.size()));
+    for (const IndexT value : values)
+        writeCheckpointValue(stream, value);
+}
+
+bool readCheckpointSet(std::istream& stream, std::set<IndexT>& values)
+{
+    std::uint64_t size = 0;
+    if (!readCheckpointValue(stream, size))
+        return false;
+    values.clear();
+    for (std::uint64_t i = 0; i < size; ++i)
+    {
+        IndexT value;
+        if (!readCheckpointValue(stream, value))
+            return false;
+        values.insert(values.end(), value);
+    }
+    return true;
+}
+
+}  // namespace
+
 /**
  * @brief Compute indexes of all features in a fixed size pyramid grid.
  * These precomputed values are useful to the next best view selection for incremental SfM.
@@ -160,6 +233,10 @@ bool ReconstructionEngine_sequentialSfM::process()
 {
     initializePyramidScoring();
 
+    // the scene of the checkpoint replaces the input scene before the tracks are built
+    IncrementalState resumedState;
+    const bool resumed = _params.resumeFromCheckpoint && !_params.checkpointFolder.empty() && loadCheckpoint(resumedState);
+
     if (fuseMatchesIntoTracks() == 0)
     {
         throw std::runtime_error("No valid tracks.");
@@ -187,13 +264,13 @@ bool ReconstructionEngine_sequentialSfM::process()
         }
     }
 
-    // initial pair choice
-    if (_sfmData.getPoses().empty())
+    // initial pair choice, the scene of a checkpoint is already initialized
+    if (!resumed && _sfmData.getPoses().empty())
     {
         std::vector<Pair> initialImagePairCandidates = getInitialImagePairsCandidates();
         createInitialReconstruction(initialImagePairCandidates);
     }
-    else
+    else if (!resumed)
     {
         // If we don't have any landmark, we need to triangulate them from the known poses.
         // But even if we already have landmarks, we need to try to triangulate new points with the current set of parameters.
@@ -208,10 +285,12 @@ bool ReconstructionEngine_sequentialSfM::process()
     }
 
     // reconstruction
-    const double elapsedTime = incrementalReconstruction();
+    const double elapsedTime = incrementalReconstruction(resumed ? &resumedState : nullptr);
 
     exportStatistics(elapsedTime);
 
+    removeCheckpoint();
+
     return !_sfmData.getPoses().empty();
 }
 
@@ -238,6 +317,7 @@ void ReconstructionEngine_sequentialSfM::initializePyramidScoring()
 
 std::size_t ReconstructionEngine_sequentialSfM::fuseMatchesIntoTracks()
 {
+    ALICEVISION_PROFILE_SCOPE("sfm::fuseMatchesIntoTracks");
     // compute tracks from matches
     track::TracksBuilder tracksBuilder;
 
@@ -321,6 +401,7 @@ std::vector<Pair> ReconstructionEngine_sequentialSfM::getInitialImagePairsCandid
 
 void ReconstructionEngine_sequentialSfM::createInitialReconstruction(const std::vector<Pair>& initialImagePairCandidates)
 {
+    ALICEVISION_PROFILE_SCOPE("sfm::createInitialReconstruction");
     // initial pair Essential Matrix and [R|t] estimation.
     for (const auto& initialPairCandidate : initialImagePairCandidates)
     {
@@ -381,6 +462,88 @@ void ReconstructionEngine_sequentialSfM::registerChanges(std::set<IndexT>& linke
             }
         }
     }
+
+    updateReconstructedTracksIndex();
+}
+
+void ReconstructionEngine_sequentialSfM::updateReconstructedTracksIndex()
+{
+    const sfmData::Landmarks& landmarks = _sfmData.getLandmarks();
+
+    // The temporary containers of this update are allocated in an arena released at once at the end.
+    std::pmr::monotonic_buffer_resource arena;
+
+    // tracks added or removed per view since the last update
+    std::pmr::map<IndexT, std::pmr::vector<std::size_t>> addedTracksPerView(&arena);
+    std::pmr::map<IndexT, std::pmr::vector<std::size_t>> removedTracksPerView(&arena);
+
+    const auto registerTrack = [&](std::size_t trackId, std::pmr::map<IndexT, std::pmr::vector<std::size_t>>& tracksPerView) {
+        const auto trackIt = _map_tracks.find(trackId);
+        if (trackIt == _map_tracks.end())
+            return;
+        for (const auto& featPerView : trackIt->second.featPerView)
+            tracksPerView[featPerView.first].push_back(trackId);
+    };
+
+    for (auto it = _indexedLandmarks.begin(); it != _indexedLandmarks.end();)
+    {
+        if (landmarks.count(*it))
+        {
+            ++it;
+            continue;
+        }
+        registerTrack(*it, removedTracksPerView);
+        it = _indexedLandmarks.erase(it);
+    }
+
+    for (const auto& landmarkPair : landmarks)
+    {
+        if (_indexedLandmarks.insert(landmarkPair.first).second)
+            registerTrack(landmarkPair.first, addedTracksPerView);
+    }
+
+    // update the sorted reconstructed tracks of the modified views only
+    std::pmr::set<IndexT> modifiedViews(&arena);
+    for (auto& viewTracks : removedTracksPerView)
+    {
+        std::pmr::vector<std::size_t>& removed = viewTracks.second;
+        std::sort(removed.begin(), removed.end());
+        std::vector<std::size_t>& tracks = _reconstructedTracksPerView[viewTracks.first];
+        std::vector<std::size_t> remaining;
+        remaining.reserve(tracks.size());
+        std::set_difference(tracks.begin(), tracks.end(), removed.begin(), removed.end(), std::back_inserter(remaining));
+        tracks.swap(remaining);
+        modifiedViews.insert(viewTracks.first);
+    }
+    for (auto& viewTracks : addedTracksPerView)
+    {
+        std::pmr::vector<std::size_t>& added = viewTracks.second;
+        std::sort(added.begin(), added.end());
+        std::vector<std::size_t>& tracks = _reconstructedTracksPerView[viewTracks.first];
+        const std::size_t nbTracks = tracks.size();
+        tracks.insert(tracks.end(), added.begin(), added.end());
+        std::inplace_merge(tracks.begin(), tracks.begin() + nbTracks, tracks.end());
+        modifiedViews.insert(viewTracks.first);
+    }
+
+    // update the candidate scores of the modified views
+    const std::pmr::vector<IndexT> modifiedViewsVec(modifiedViews.begin(), modifiedViews.end(), &arena);
+    std::pmr::vector<std::size_t> scores(modifiedViewsVec.size(), 0, &arena);
+
+#pragma omp parallel for schedule(dynamic)
+    for (int i = 0; i < modifiedViewsVec.size(); ++i)
+    {
+        const IndexT viewId = modifiedViewsVec[i];
+        if (!_sfmData.isPoseAndIntrinsicDefined(viewId))
+            scores[i] = computeCandidateImageScore(viewId, _reconstructedTracksPerView.at(viewId));
+    }
+
+    for (std::size_t i = 0; i < modifiedViewsVec.size(); ++i)
+        _candidateScorePerView[modifiedViewsVec[i]] = scores[i];
+
+    ALICEVISION_LOG_DEBUG("Reconstructed tracks index updated:" << std::endl
+                                                                << "\t- # landmarks: " << _indexedLandmarks.size() << std::endl
+                                                                << "\t- # modified views: " << modifiedViewsVec.size());
 }
 
 void ReconstructionEngine_sequentialSfM::remapLandmarkIdsToTrackIds()
@@ -440,36 +603,44 @@ void ReconstructionEngine_sequentialSfM::remapLandmarkIdsToTrackIds()
                                                                  << "\t- # output landmarks: " << _sfmData.getLandmarks().size());
 }
 
-double ReconstructionEngine_sequentialSfM::incrementalReconstruction()
+double ReconstructionEngine_sequentialSfM::incrementalReconstruction(const IncrementalState* resumedState)
 {
-    IndexT resectionId = 0;
+    IncrementalState state;
+    IndexT& resectionId = state.resectionId;
 
     // to be visited views
-    std::set<IndexT> viewsToVisit;
+    std::set<IndexT>& viewsToVisit = state.viewsToVisit;
 
     // Views which are linked to last reconstructed views
     std::set<IndexT> linkedViewIds;
-    std::set<IndexT> potentials;
+    std::set<IndexT>& potentials = state.potentials;
 
     // candidate views
     std::vector<IndexT> bestViewCandidates;
 
-    // get all viewIds and max resection id
-    for (const auto& viewPair : _sfmData.getViews())
+    if (resumedState != nullptr)
     {
-        IndexT viewId = viewPair.second->getViewId();
-        IndexT viewResectionId = viewPair.second->getResectionId();
-
-        // Create a list of remaining views to estimate
-        if (!_sfmData.isPoseAndIntrinsicDefined(viewId))
+        state = *resumedState;
+    }
+    else
+    {
+        // get all viewIds and max resection id
+        for (const auto& viewPair : _sfmData.getViews())
         {
-            viewsToVisit.insert(viewId);
-        }
+            IndexT viewId = viewPair.second->getViewId();
+            IndexT viewResectionId = viewPair.second->getResectionId();
 
-        // Make sure we can use the higher resectionIds
-        if (viewResectionId != UndefinedIndexT && viewResectionId > resectionId)
-        {
-            resectionId = viewResectionId + 1;
+            // Create a list of remaining views to estimate
+            if (!_sfmData.isPoseAndIntrinsicDefined(viewId))
+            {
+                viewsToVisit.insert(viewId);
+            }
+
+            // Make sure we can use the higher resectionIds
+            if (viewResectionId != UndefinedIndexT && viewResectionId > resectionId)
+            {
+                resectionId = viewResectionId + 1;
+            }
         }
     }
 
@@ -493,13 +664,30 @@ double ReconstructionEngine_sequentialSfM::incrementalReconstruction()
     }
 
     aliceVision::system::Timer timer;
-    std::size_t nbValidPoses = 0;
-    std::size_t globalIteration = 0;
+    aliceVision::system::Timer checkpointTimer;
+    std::size_t& nbValidPoses = state.nbValidPoses;
+    std::size_t& globalIteration = state.globalIteration;
+
+    // the first global iteration of a resumed reconstruction is the interrupted one
+    bool resumeGlobalIteration = (resumedState != nullptr);
 
     do
     {
-        // Compute intersection of available views and views with potential changes
-        nbValidPoses = _sfmData.getPoses().size();
+        if (!resumeGlobalIteration)
+        {
+            // Compute intersection of available views and views with potential changes
+            nbValidPoses = _sfmData.getPoses().size();
+
+            for (auto v : potentials)
+            {
+                if (!_sfmData.isPoseAndIntrinsicDefined(v))
+                {
+                    viewsToVisit.insert(v);
+                }
+            }
+            potentials.clear();
+        }
+        resumeGlobalIteration = false;
 
         ALICEVISION_LOG_INFO("Incremental Reconstruction start iteration " << globalIteration << ":" << std::endl
                                                                            << "\t- # number of resection groups: " << resectionId << std::endl
@@ -507,14 +695,8 @@ double ReconstructionEngine_sequentialSfM::incrementalReconstruction()
                                                                            << "\t- # number of landmarks: " << _sfmData.getLandmarks().size()
                                                                            << std::endl);
 
-        for (auto v : potentials)
-        {
-            if (!_sfmData.isPoseAndIntrinsicDefined(v))
-            {
-                viewsToVisit.insert(v);
-            }
-        }
-        potentials.clear();
+        // take the landmarks changes of the initial pair or of the rigs calibration into account
+        updateReconstructedTracksIndex();
 
         // get set of reconstructed views
         std::set<IndexT> prevReconstructedViews = _sfmData.getValidViews();
@@ -585,6 +767,13 @@ double ReconstructionEngine_sequentialSfM::incrementalReconstruction()
             }
 
             ++resectionId;
+
+            // the scene is refined and the next best views are not selected yet: the state can be resumed
+            if (!_params.checkpointFolder.empty() && checkpointTimer.elapsed() >= _params.checkpointInterval)
+            {
+                saveCheckpoint(state);
+                checkpointTimer.reset();
+            }
         }
 
         if (_params.rig.useRigConstraint && !_sfmData.getRigs().empty())
@@ -623,68 +812,222 @@ double ReconstructionEngine_sequentialSfM::incrementalReconstruction()
     return timer.elapsed();
 }
 
+void ReconstructionEngine_sequentialSfM::saveCheckpoint(const IncrementalState& state)
+{
+    ALICEVISION_PROFILE_SCOPE("sfm::saveCheckpoint");
+    const fs::path checkpointFolder(_params.checkpointFolder);
+    if (!fs::exists(checkpointFolder))
+        fs::create_directories(checkpointFolder);
+
+    // each checkpoint has its own scene file, the state file refers to the last complete one
+    std::ostringstream sceneFilename;
+    sceneFilename << checkpointScenePrefix << std::setw(8) << std::setfill('0') << state.resectionId << checkpointSceneExtension;
+    if (!sfmDataIO::Save(_sfmData, (checkpointFolder / sceneFilename.str()).string(), sfmDataIO::ESfMData::ALL))
+    {
+        ALICEVISION_LOG_WARNING("Cannot save the checkpoint scene in '" << checkpointFolder.string() << "'.");
+        return;
+    }
+
+    const fs::path statePath = checkpointFolder / checkpointStateFilename;
+    const fs::path tmpStatePath = fs::path(statePath.string() + ".tmp");
+    {
+        std::ostringstream randomNumberGeneratorState;
+        randomNumberGeneratorState << _randomNumberGenerator;
+
+        std::ofstream stream(tmpStatePath.string(), std::ios::binary);
+        writeCheckpointValue(stream, checkpointVersion);
+        writeCheckpointString(stream, sceneFilename.str());
+        writeCheckpointValue(stream, std::uint64_t(_sfmData.getViews().size()));
+        writeCheckpointValue(stream, state.resectionId);
+        writeCheckpointValue(stream, std::uint64_t(state.globalIteration));
+        writeCheckpointValue(stream, std::uint64_t(state.nbValidPoses));
+        writeCheckpointSet(stream, state.viewsToVisit);
+        writeCheckpointSet(stream, state.potentials);
+        writeCheckpointString(stream, randomNumberGeneratorState.str());
+
+        if (!stream)
+        {
+            ALICEVISION_LOG_WARNING("Cannot write the checkpoint state '" << tmpStatePath.string() << "'.");
+            return;
+        }
+    }
+    fs::rename(tmpStatePath, statePath);
+
+    // remove the scenes of the previous checkpoints
+    for (const fs::directory_entry& entry : fs::directory_iterator(checkpointFolder))
+    {
+        const std::string filename = entry.path().filename().string();
+        if (filename != sceneFilename.str() && boost::algorithm::starts_with(filename, checkpointScenePrefix) &&
+            entry.path().extension() == checkpointSceneExtension)
+            fs::remove(entry.path());
+    }
+
+    ALICEVISION_LOG_INFO("Checkpoint saved:" << std::endl
+                                             << "\t- resection id: " << state.resectionId << std::endl
+                                             << "\t- # poses: " << _sfmData.getPoses().size() << std::endl
+                                             << "\t- # landmarks: " << _sfmData.getLandmarks().size());
+}
+
+bool ReconstructionEngine_sequentialSfM::loadCheckpoint(IncrementalState& state)
+{
+    const fs::path checkpointFolder(_params.checkpointFolder);
+    const fs::path statePath = checkpointFolder / checkpointStateFilename;
+    if (!fs::exists(statePath))
+    {
+        ALICEVISION_LOG_INFO("No checkpoint in '" << checkpointFolder.string() << "', the reconstruction starts from the input scene.");
+        return false;
+    }
+
+    std::ifstream stream(statePath.string(), std::ios::binary);
+    std::uint32_t version = 0;
+    std::string sceneFilename;
+    std::uint64_t nbViews = 0;
+    std::uint64_t globalIteration = 0;
+    std::uint64_t nbValidPoses = 0;
+    std::string randomNumberGeneratorState;
+    IncrementalState loadedState;
+
+    if (!readCheckpointValue(stream, version) || version != checkpointVersion || !readCheckpointString(stream, sceneFilename) ||
+        !readCheckpointValue(stream, nbViews) || !readCheckpointValue(stream, loadedState.resectionId) ||
+        !readCheckpointValue(stream, globalIteration) || !readCheckpointValue(stream, nbValidPoses) ||
+        !readCheckpointSet(stream, loadedState.viewsToVisit) || !readCheckpointSet(stream, loadedState.potentials) ||
+        !readCheckpointString(stream, randomNumberGeneratorState))
+    {
+        ALICEVISION_LOG_WARNING("Invalid checkpoint state '" << statePath.string() << "', the reconstruction starts from the input scene.");
+        return false;
+    }
+    loadedState.globalIteration = globalIteration;
+    loadedState.nbValidPoses = nbValidPoses;
+
+    SfMData sfmData;
+    if (!sfmDataIO::Load(sfmData, (checkpointFolder / sceneFilename).string(), sfmDataIO::ESfMData::ALL))
+    {
+        ALICEVISION_LOG_WARNING("Cannot load the checkpoint scene '" << sceneFilename << "', the reconstruction starts from the input scene.");
+        return false;
+    }
+
+    // the checkpoint must come from a reconstruction of the same views
+    bool sameViews = (sfmData.getViews().size() == nbViews) && (nbViews == _sfmData.getViews().size());
+    for (auto it = _sfmData.getViews().begin(); sameViews && it != _sfmData.getViews().end(); ++it)
+        sameViews = (sfmData.getViews().count(it->first) > 0);
+    if (!sameViews)
+    {
+        ALICEVISION_LOG_WARNING("The checkpoint views do not match the input views, the reconstruction starts from the input scene.");
+        return false;
+    }
+
+    std::istringstream(randomNumberGeneratorState) >> _randomNumberGenerator;
+    _sfmData = sfmData;
+    state = loadedState;
+
+    ALICEVISION_LOG_INFO("Resume the incremental reconstruction from the checkpoint:" << std::endl
+                                                                                       << "\t- resection id: " << state.resectionId << std::endl
+                                                                                       << "\t- # poses: " << _sfmData.getPoses().size() << std::endl
+                                                                                       << "\t- # landmarks: " << _sfmData.getLandmarks().size()
+                                                                                       << std::endl
+                                                                                       << "\t- # images remaining: " << state.viewsToVisit.size());
+    return true;
+}
+
+void ReconstructionEngine_sequentialSfM::removeCheckpoint()
+{
+    const fs::path checkpointFolder(_params.checkpointFolder);
+    if (_params.checkpointFolder.empty() || !fs::exists(checkpointFolder))
+        return;
+
+    boost::system::error_code ec;
+    fs::remove(checkpointFolder / checkpointStateFilename, ec);
+    for (const fs::directory_entry& entry : fs::directory_iterator(checkpointFolder))
+    {
+        if (boost::algorithm::starts_with(entry.path().filename().string(), checkpointScenePrefix) &&
+            entry.path().extension() == checkpointSceneExtension)
+            fs::remove(entry.path(), ec);
+    }
+}
+
+bool ReconstructionEngine_sequentialSfM::isResectionSkipped(IndexT viewId) const
+{
+    const View& view = *_sfmData.getViews().at(viewId);
+
+    if (!view.isPartOfRig())
+        return false;
+
+    // some views can become indirectly localized when the sub-pose becomes defined
+    if (_sfmData.isPoseAndIntrinsicDefined(view.getViewId()))
+    {
+        ALICEVISION_LOG_DEBUG("Resection of view " << viewId << " was skipped." << std::endl
+                                                   << "View indirectly localized, sub-pose and pose already defined." << std::endl
+                                                   << "\t- rig id: " << view.getRigId() << std::endl
+                                                   << "\t- sub-pose id: " << view.getSubPoseId());
+        return true;
+    }
+
+    // we cannot localize a view if it is part of an initialized rig with unknown rig pose and unknown sub-pose
+    const bool knownPose = _sfmData.existsPose(view);
+    const Rig& rig = _sfmData.getRig(view);
+    const RigSubPose& subpose = rig.getSubPose(view.getSubPoseId());
+
+    if (rig.isInitialized() && !knownPose && (subpose.status == ERigSubPoseStatus::UNINITIALIZED))
+    {
+        ALICEVISION_LOG_DEBUG("Resection of view " << viewId << " was skipped." << std::endl
+                                                   << "Rig initialized but unkown pose and sub-pose." << std::endl
+                                                   << "\t- rig id: " << view.getRigId() << std::endl
+                                                   << "\t- sub-pose id: " << view.getSubPoseId());
+        return true;
+    }
+    return false;
+}
+
 std::set<IndexT> ReconstructionEngine_sequentialSfM::resection(IndexT resectionId,
                                                                const std::vector<IndexT>& bestViewIds,
                                                                const std::set<IndexT>& prevReconstructedViews)
 {
+    ALICEVISION_PROFILE_SCOPE("sfm::resection");
     auto chrono_start = std::chrono::steady_clock::now();
 
+    // the resections are computed in parallel against the scene before this group,
+    // then merged in the order of bestViewIds, so the result does not depend on the threads
+    std::vector<ResectionData> resectionsData(bestViewIds.size());
+    std::vector<char> hasResected(bestViewIds.size(), 0);
+
+    // one random generator per view, seeded in a deterministic order
+    std::vector<std::mt19937::result_type> seeds(bestViewIds.size());
+    for (std::size_t i = 0; i < seeds.size(); ++i)
+        seeds[i] = _randomNumberGenerator();
+
     // add images to the 3D reconstruction
-#pragma omp parallel for
+#pragma omp parallel for schedule(dynamic)
     for (int i = 0; i < bestViewIds.size(); ++i)
     {
         const IndexT viewId = bestViewIds.at(i);
-        const View& view = *_sfmData.getViews().at(viewId);
-
-        if (view.isPartOfRig())
-        {
-            // some views can become indirectly localized when the sub-pose becomes defined
-            if (_sfmData.isPoseAndIntrinsicDefined(view.getViewId()))
-            {
-                ALICEVISION_LOG_DEBUG("Resection of image " << i << " was skipped." << std::endl
-                                                            << "View indirectly localized, sub-pose and pose already defined." << std::endl
-                                                            << "\t- view id: " << viewId << std::endl
-                                                            << "\t- rig id: " << view.getRigId() << std::endl
-                                                            << "\t- sub-pose id: " << view.getSubPoseId());
 
-                continue;
-            }
-
-            // we cannot localize a view if it is part of an initialized rig with unknown rig pose and unknown sub-pose
-            const bool knownPose = _sfmData.existsPose(view);
-            const Rig& rig = _sfmData.getRig(view);
-            const RigSubPose& subpose = rig.getSubPose(view.getSubPoseId());
-
-            if (rig.isInitialized() && !knownPose && (subpose.status == ERigSubPoseStatus::UNINITIALIZED))
-            {
-                ALICEVISION_LOG_DEBUG("Resection of image " << i << " was skipped." << std::endl
-                                                            << "Rig initialized but unkown pose and sub-pose." << std::endl
-                                                            << "\t- view id: " << viewId << std::endl
-                                                            << "\t- rig id: " << view.getRigId() << std::endl
-                                                            << "\t- sub-pose id: " << view.getSubPoseId());
-
-                continue;
-            }
-        }
+        if (isResectionSkipped(viewId))
+            continue;
 
-        ResectionData newResectionData;
+        ResectionData& newResectionData = resectionsData[i];
         newResectionData.error_max = _params.localizerEstimatorError;
         newResectionData.max_iteration = _params.localizerEstimatorMaxIterations;
-        const bool hasResected = computeResection(viewId, newResectionData);
+        std::mt19937 randomNumberGenerator(seeds[i]);
+        hasResected[i] = computeResection(viewId, newResectionData, randomNumberGenerator);
+    }
 
-#pragma omp critical
+    for (std::size_t i = 0; i < bestViewIds.size(); ++i)
+    {
+        const IndexT viewId = bestViewIds.at(i);
+
+        if (!hasResected[i])
         {
-            if (hasResected)
-            {
-                updateScene(viewId, newResectionData);
-                ALICEVISION_LOG_DEBUG("Resection of image " << i << " ( view id: " << viewId << " ) succeed.");
-                _sfmData.getViews().at(viewId)->setResectionId(resectionId);
-            }
-            else
-            {
-                ALICEVISION_LOG_DEBUG("Resection of image " << i << " ( view id: " << viewId << " ) was not possible.");
-            }
+            ALICEVISION_LOG_DEBUG("Resection of image " << i << " ( view id: " << viewId << " ) was not possible.");
+            continue;
         }
+
+        // a rig view can be localized by a previous view of the group
+        if (isResectionSkipped(viewId))
+            continue;
+
+        updateScene(viewId, resectionsData[i]);
+        ALICEVISION_LOG_DEBUG("Resection of image " << i << " ( view id: " << viewId << " ) succeed.");
+        _sfmData.getViews().at(viewId)->setResectionId(resectionId);
     }
 
     ALICEVISION_LOG_DEBUG(
@@ -709,6 +1052,7 @@ std::set<IndexT> ReconstructionEngine_sequentialSfM::resection(IndexT resectionI
 
 void ReconstructionEngine_sequentialSfM::triangulate(const std::set<IndexT>& prevReconstructedViews, const std::set<IndexT>& newReconstructedViews)
 {
+    ALICEVISION_PROFILE_SCOPE("sfm::triangulate");
     auto chrono_start = std::chrono::steady_clock::now();
 
     // allow to use to the old triangulatation algorithm (using 2 views only)
@@ -725,10 +1069,13 @@ void ReconstructionEngine_sequentialSfM::triangulate(const std::set<IndexT>& pre
 
 bool ReconstructionEngine_sequentialSfM::bundleAdjustment(std::set<IndexT>& newReconstructedViews, bool isInitialPair)
 {
+    ALICEVISION_PROFILE_SCOPE("sfm::bundleAdjustment");
     ALICEVISION_LOG_INFO("Bundle adjustment start.");
     auto chronoStart = std::chrono::steady_clock::now();
 
     BundleAdjustmentCeres::CeresOptions options;
+    options.useMixedPrecision = _params.bundleAdjustmentMixedPrecision;
+    options.useGpu = _params.bundleAdjustmentUseGpu;
     BundleAdjustment::ERefineOptions refineOptions =
       BundleAdjustment::REFINE_ROTATION | BundleAdjustment::REFINE_TRANSLATION | BundleAdjustment::REFINE_STRUCTURE;
 
@@ -743,13 +1090,13 @@ bool ReconstructionEngine_sequentialSfM::bundleAdjustment(std::set<IndexT>& newR
     // enable Sparse solver and local strategy
     if (_sfmData.getPoses().size() > 100)
     {
-        options.setSparseBA();
+        options.setSolver(_params.bundleAdjustmentSolver, true);
         if (_params.useLocalBundleAdjustment)  // local strategy enable if more than 100 poses
             enableLocalStrategy = true;
     }
     else
     {
-        options.setDenseBA();
+        options.setSolver(_params.bundleAdjustmentSolver, false);
     }
 
     // add the new reconstructed views to the graph
@@ -769,7 +1116,7 @@ bool ReconstructionEngine_sequentialSfM::bundleAdjustment(std::set<IndexT>& newR
 
         // restore the Dense linear solver type if the number of cameras in the solver is <= 20
         if (nbRefinedPoses + nbConstantPoses <= 20)
-            options.setDenseBA();
+            options.setSolver(_params.bundleAdjustmentSolver, false);
 
         // parameters are refined only if the number of cameras to refine is > to the number of newly added cameras.
         // - if they are equal: it means that none of the new cameras is connected to the local BA graph,
@@ -783,11 +1130,29 @@ bool ReconstructionEngine_sequentialSfM::bundleAdjustment(std::set<IndexT>& newR
         }
     }
 
-    BundleAdjustmentCeres BA(options, _params.minNbCamerasToRefinePrincipalPoint);
+    options.usePersistentProblem = _params.bundleAdjustmentPersistentProblem;
+
+    // the persistent problem is kept with its bundle adjustment between the calls
+    std::shared_ptr<BundleAdjustmentCeres> BAPtr = _persistentBundleAdjustment;
+    if (BAPtr == nullptr)
+    {
+        BAPtr = std::make_shared<BundleAdjustmentCeres>(options, _params.minNbCamerasToRefinePrincipalPoint);
+        if (options.usePersistentProblem)
+            _persistentBundleAdjustment = BAPtr;
+    }
+    else
+    {
+        // the residual blocks of the persistent problem use its loss function
+        options.lossFunction = BAPtr->getCeresOptions().lossFunction;
+        BAPtr->setCeresOptions(options);
+    }
+    BundleAdjustmentCeres& BA = *BAPtr;
 
     // give the local strategy graph is local strategy is enable
     if (enableLocalStrategy)
         BA.useLocalStrategyGraph(_localStrategyGraph);
+    else
+        BA.useLocalStrategyGraph(nullptr);
 
     // perform BA until all point are under the given precision
     do
@@ -984,21 +1349,13 @@ bool ReconstructionEngine_sequentialSfM::findConnectedViews(std::vector<ViewConn
     if (remainingViewIds.empty() || _sfmData.getLandmarks().empty())
         return false;
 
-    // Collect tracksIds
-    std::set<size_t> reconstructed_trackId;
-    std::transform(_sfmData.getLandmarks().begin(),
-                   _sfmData.getLandmarks().end(),
-                   std::inserter(reconstructed_trackId, reconstructed_trackId.begin()),
-                   stl::RetrieveKey());
+    assert(_indexedLandmarks.size() == _sfmData.getLandmarks().size());
 
     const std::set<IndexT> reconstructedIntrinsics = _sfmData.getReconstructedIntrinsics();
+    static const std::vector<std::size_t> noTracks;
 
-#pragma omp parallel for
-    for (int i = 0; i < remainingViewIds.size(); ++i)
+    for (const IndexT viewId : remainingViewIds)
     {
-        std::set<IndexT>::const_iterator iter = remainingViewIds.cbegin();
-        std::advance(iter, i);
-        const IndexT viewId = *iter;
         const IndexT intrinsicId = _sfmData.getViews().at(viewId)->getIntrinsicId();
         const bool isIntrinsicsReconstructed = reconstructedIntrinsics.count(intrinsicId);
 
@@ -1031,26 +1388,19 @@ bool ReconstructionEngine_sequentialSfM::findConnectedViews(std::vector<ViewConn
             }
         }
 
-        // Count the common possible putative point
-        //  with the already 3D reconstructed trackId
-        std::vector<std::size_t> vec_trackIdForResection;
-        vec_trackIdForResection.reserve(set_tracksIds.size());
-        std::set_intersection(set_tracksIds.begin(),
-                              set_tracksIds.end(),
-                              reconstructed_trackId.begin(),
-                              reconstructed_trackId.end(),
-                              std::back_inserter(vec_trackIdForResection));
-        // Compute an image score based on the number of matches to the 3D scene
-        // and the repartition of these features in the image.
-        std::size_t score = computeCandidateImageScore(viewId, vec_trackIdForResection);
-#pragma omp critical
-        {
-            out_connectedViews.emplace_back(viewId, vec_trackIdForResection.size(), score, isIntrinsicsReconstructed);
-        }
+        // The common possible putative points with the already 3D reconstructed trackIds
+        // and the image score based on the repartition of these features in the image
+        // are maintained by updateReconstructedTracksIndex.
+        const auto tracksIt = _reconstructedTracksPerView.find(viewId);
+        const std::vector<std::size_t>& vec_trackIdForResection = (tracksIt != _reconstructedTracksPerView.end()) ? tracksIt->second : noTracks;
+        const auto scoreIt = _candidateScorePerView.find(viewId);
+        const std::size_t score = (scoreIt != _candidateScorePerView.end()) ? scoreIt->second : 0;
+
+        out_connectedViews.emplace_back(viewId, vec_trackIdForResection.size(), score, isIntrinsicsReconstructed);
     }
 
-    // Sort by the image score
-    std::sort(out_connectedViews.begin(), out_connectedViews.end(), [](const ViewConnectionScore& t1, const ViewConnectionScore& t2) {
+    // Sort by the image score, the views with the same score stay in the view ids order
+    std::stable_sort(out_connectedViews.begin(), out_connectedViews.end(), [](const ViewConnectionScore& t1, const ViewConnectionScore& t2) {
         return std::get<2>(t1) > std::get<2>(t2);
     });
     return !out_connectedViews.empty();
@@ -1525,25 +1875,19 @@ std::size_t ReconstructionEngine_sequentialSfM::computeCandidateImageScore(Index
  * C. Do the resectioning: compute the camera pose.
  * D. Refine the pose of the found camera
  */
-bool ReconstructionEngine_sequentialSfM::computeResection(const IndexT viewId, ResectionData& resectionData)
+bool ReconstructionEngine_sequentialSfM::computeResection(const IndexT viewId, ResectionData& resectionData, std::mt19937& randomNumberGenerator) const
 {
     // A. Compute 2D/3D matches
     // A1. list tracks ids used by the view
     const aliceVision::track::TrackIdSet& set_tracksIds = _map_tracksPerView.at(viewId);
 
-    // A2. intersects the track list with the reconstructed
-    std::set<std::size_t> reconstructed_trackId;
-    std::transform(_sfmData.getLandmarks().begin(),
-                   _sfmData.getLandmarks().end(),
-                   std::inserter(reconstructed_trackId, reconstructed_trackId.begin()),
-                   stl::RetrieveKey());
-
-    // Get the ids of the already reconstructed tracks
-    std::set_intersection(set_tracksIds.begin(),
-                          set_tracksIds.end(),
-                          reconstructed_trackId.begin(),
-                          reconstructed_trackId.end(),
-                          std::inserter(resectionData.tracksId, resectionData.tracksId.begin()));
+    // A2. get the ids of the already reconstructed tracks, without copying all the landmarks ids
+    const Landmarks& landmarks = _sfmData.getLandmarks();
+    for (const std::size_t trackId : set_tracksIds)
+    {
+        if (landmarks.count(trackId))
+            resectionData.tracksId.insert(resectionData.tracksId.end(), trackId);
+    }
 
     if (resectionData.tracksId.empty())
     {
@@ -1586,28 +1930,32 @@ bool ReconstructionEngine_sequentialSfM::computeResection(const IndexT viewId, R
 
     const bool bResection = sfm::SfMLocalizer::Localize(Pair(view_I->getImage().getWidth(), view_I->getImage().getHeight()),
                                                         intrinsics.get(),
-                                                        _randomNumberGenerator,
+                                                        randomNumberGenerator,
                                                         resectionData,
                                                         resectionData.pose,
                                                         _params.localizerEstimator);
 
     if (!_htmlLogFile.empty())
     {
-        using namespace htmlDocument;
-        std::ostringstream os;
-        os << "Robust resection of view " << viewId << ": <br>";
-        _htmlDocStream->pushInfo(htmlMarkup("h4", os.str()));
+        // the resections are computed in parallel
+#pragma omp critical(htmlLog)
+        {
+            using namespace htmlDocument;
+            std::ostringstream os;
+            os << "Robust resection of view " << viewId << ": <br>";
+            _htmlDocStream->pushInfo(htmlMarkup("h4", os.str()));
 
-        os.str("");
-        os << std::endl
-           << "- Image path: " << view_I->getImage().getImagePath() << "<br>"
-           << "- Threshold (error max): " << resectionData.error_max << "<br>"
-           << "- Resection status: " << (bResection ? "OK" : "FAILED") << "<br>"
-           << "- # points used for Resection: " << resectionData.featuresId.size() << "<br>"
-           << "- # points validated by robust estimation: " << resectionData.vec_inliers.size() << "<br>"
-           << "- % points validated: " << resectionData.vec_inliers.size() / static_cast<float>(resectionData.featuresId.size()) << "<br>";
+            os.str("");
+            os << std::endl
+               << "- Image path: " << view_I->getImage().getImagePath() << "<br>"
+               << "- Threshold (error max): " << resectionData.error_max << "<br>"
+               << "- Resection status: " << (bResection ? "OK" : "FAILED") << "<br>"
+               << "- # points used for Resection: " << resectionData.featuresId.size() << "<br>"
+               << "- # points validated by robust estimation: " << resectionData.vec_inliers.size() << "<br>"
+               << "- % points validated: " << resectionData.vec_inliers.size() / static_cast<float>(resectionData.featuresId.size()) << "<br>";
 
-        _htmlDocStream->pushInfo(os.str());
+            _htmlDocStream->pushInfo(os.str());
+        }
     }
 
     if (!bResection)
@@ -1699,45 +2047,61 @@ bool ReconstructionEngine_sequentialSfM::checkAngles(const Vec3& pt3D, const std
 
 void ReconstructionEngine_sequentialSfM::getTracksToTriangulate(const std::set<IndexT>& previousReconstructedViews,
                                                                 const std::set<IndexT>& newReconstructedViews,
-                                                                std::map<IndexT, std::set<IndexT>>& mapTracksToTriangulate) const
+                                                                std::pmr::map<IndexT, std::pmr::vector<IndexT>>& mapTracksToTriangulate) const
 {
-    std::set<IndexT> allReconstructedViews;
+    // temporary data in the memory resource of the output
+    std::pmr::memory_resource* scratch = mapTracksToTriangulate.get_allocator().resource();
+
+    std::pmr::set<IndexT> allReconstructedViews(scratch);
     allReconstructedViews.insert(previousReconstructedViews.begin(), previousReconstructedViews.end());
     allReconstructedViews.insert(newReconstructedViews.begin(), newReconstructedViews.end());
 
     std::set<IndexT> allTracksInNewViews;
     track::getTracksInImagesFast(newReconstructedViews, _map_tracksPerView, allTracksInNewViews);
 
-    std::set<IndexT>::iterator it;
-#pragma omp parallel private(it)
+    const std::pmr::vector<std::size_t> tracksInNewViews(allTracksInNewViews.begin(), allTracksInNewViews.end(), scratch);
+    const int nbTracks = tracksInNewViews.size();
+
+    // first pass: count the reconstructed views of each track, without allocation
+    std::pmr::vector<std::size_t> nbReconstructedViews(nbTracks, 0, scratch);
+
+#pragma omp parallel for schedule(dynamic, 256)
+    for (int i = 0; i < nbTracks; ++i)
     {
-        for (it = allTracksInNewViews.begin(); it != allTracksInNewViews.end(); ++it)
+        const track::Track& track = _map_tracks.at(tracksInNewViews[i]);
+        for (const auto& featPerView : track.featPerView)
         {
-#pragma omp single nowait
-            {
-                const std::size_t trackId = *it;
-
-                const track::Track& track = _map_tracks.at(trackId);
+            if (allReconstructedViews.count(featPerView.first))
+                ++nbReconstructedViews[i];
+        }
+    }
 
-                std::set<IndexT> allViewsSharingTheTrack;
-                std::transform(track.featPerView.begin(),
-                               track.featPerView.end(),
-                               std::inserter(allViewsSharingTheTrack, allViewsSharingTheTrack.begin()),
-                               stl::RetrieveKey());
+    // allocate the observations of the triangulable tracks, the memory resource is not thread-safe
+    std::pmr::vector<std::pmr::vector<IndexT>*> tracksObservations(nbTracks, nullptr, scratch);
+    for (int i = 0; i < nbTracks; ++i)
+    {
+        if (nbReconstructedViews[i] < _params.minNbObservationsForTriangulation)
+            continue;
+        const auto it = mapTracksToTriangulate.emplace_hint(
+          mapTracksToTriangulate.end(), std::piecewise_construct, std::forward_as_tuple(tracksInNewViews[i]), std::forward_as_tuple());
+        it->second.reserve(nbReconstructedViews[i]);
+        tracksObservations[i] = &it->second;
+    }
 
-                std::set<IndexT> allReconstructedViewsSharingTheTrack;
-                std::set_intersection(allViewsSharingTheTrack.begin(),
-                                      allViewsSharingTheTrack.end(),
-                                      allReconstructedViews.begin(),
-                                      allReconstructedViews.end(),
-                                      std::inserter(allReconstructedViewsSharingTheTrack, allReconstructedViewsSharingTheTrack.begin()));
+    // second pass: fill the reserved observations
+#pragma omp parallel for schedule(dynamic, 256)
+    for (int i = 0; i < nbTracks; ++i)
+    {
+        std::pmr::vector<IndexT>* observations = tracksObservations[i];
+        if (observations == nullptr)
+            continue;
 
-                if (allReconstructedViewsSharingTheTrack.size() >= _params.minNbObservationsForTriangulation)
-                {
-#pragma omp critical
-                    mapTracksToTriangulate[trackId] = allReconstructedViewsSharingTheTrack;
-                }
-            }
+        // featPerView is sorted by view id, so the observations are sorted
+        const track::Track& track = _map_tracks.at(tracksInNewViews[i]);
+        for (const auto& featPerView : track.featPerView)
+        {
+            if (allReconstructedViews.count(featPerView.first))
+                observations->push_back(featPerView.first);
         }
     }
 }
@@ -1789,19 +2153,24 @@ void ReconstructionEngine_sequentialSfM::triangulate_multiViewsLORANSAC(SfMData&
     // -- Identify the track to triangulate :
     // This map contains all the tracks that will be triangulated (for the first time, or not)
     // These tracks are seen by at least one new reconstructed view.
-    std::map<IndexT, std::set<IndexT>> mapTracksToTriangulate;  // <trackId, observations>
+    // The temporary containers of this step are allocated in an arena released at once at the end.
+    std::pmr::monotonic_buffer_resource arena;
+    std::pmr::map<IndexT, std::pmr::vector<IndexT>> mapTracksToTriangulate(&arena);  // <trackId, observations>
     getTracksToTriangulate(previousReconstructedViews, newReconstructedViews, mapTracksToTriangulate);
 
-    std::vector<IndexT> setTracksId;  // <trackId>
-    std::transform(mapTracksToTriangulate.begin(), mapTracksToTriangulate.end(), std::inserter(setTracksId, setTracksId.begin()), stl::RetrieveKey());
+    std::pmr::vector<const std::pair<const IndexT, std::pmr::vector<IndexT>>*> tracksToTriangulate(&arena);
+    tracksToTriangulate.reserve(mapTracksToTriangulate.size());
+    for (const auto& trackObservations : mapTracksToTriangulate)
+        tracksToTriangulate.push_back(&trackObservations);
 
-#pragma omp parallel for
-    for (int i = 0; i < setTracksId.size(); i++)  // each track (already reconstructed or not)
+    // the tracks have very different lengths: balance them dynamically over the threads
+#pragma omp parallel for schedule(dynamic, 64)
+    for (int i = 0; i < tracksToTriangulate.size(); i++)  // each track (already reconstructed or not)
     {
-        const IndexT trackId = setTracksId.at(i);
+        const IndexT trackId = tracksToTriangulate[i]->first;
         bool isValidTrack = true;
         const track::Track& track = _map_tracks.at(trackId);
-        std::set<IndexT>& observations = mapTracksToTriangulate.at(trackId);  // all the posed views possessing the track
+        const std::pmr::vector<IndexT>& observations = tracksToTriangulate[i]->second;  // all the posed views possessing the track, sorted
 
         // The track needs to be seen by a min. number of views to be triangulated
         if (observations.size() < _params.minNbObservationsForTriangulation)
@@ -1816,11 +2185,11 @@ void ReconstructionEngine_sequentialSfM::triangulate_multiViewsLORANSAC(SfMData&
              *    2 observations : triangulation using DLT
              * -------------------------------------------- */
 
-            inliers = observations;
+            inliers.insert(observations.begin(), observations.end());
 
             // -- Prepare:
-            IndexT I = *(observations.begin());
-            IndexT J = *(observations.rbegin());
+            IndexT I = observations.front();
+            IndexT J = observations.back();
 
             const auto oi = getObservationData(scene, _featuresPerView, I, track);
             const auto oj = getObservationData(scene, _featuresPerView, J, track);
@@ -1856,12 +2225,15 @@ void ReconstructionEngine_sequentialSfM::triangulate_multiViewsLORANSAC(SfMData&
              * ------------------------------------------------------- */
 
             // -- Prepare:
-            std::vector<Vec2> features;  // undistorted 2D features (one per pose)
-            std::vector<Mat34> Ps;       // projective matrices (one per pose)
+            std::vector<Vec2> features;   // undistorted 2D features (one per pose)
+            std::vector<Mat34> Ps;        // projective matrices (one per pose)
+            std::vector<IndexT> viewIds;  // view of each feature
+            features.reserve(observations.size());
+            Ps.reserve(observations.size());
+            viewIds.reserve(observations.size());
             {
                 const track::Track& track = _map_tracks.at(trackId);
 
-                int i = 0;
                 for (const IndexT& viewId : observations)
                 {
                     const auto o = getObservationData(scene, _featuresPerView, viewId, track);
@@ -1873,7 +2245,7 @@ void ReconstructionEngine_sequentialSfM::triangulate_multiViewsLORANSAC(SfMData&
 
                     features.push_back(o.xUd);
                     Ps.push_back(o.P);
-                    i++;
+                    viewIds.push_back(viewId);
                 }
             }
 
@@ -1885,9 +2257,9 @@ void ReconstructionEngine_sequentialSfM::triangulate_multiViewsLORANSAC(SfMData&
 
             homogeneousToEuclidean(X_homogeneous, X_euclidean);
 
-            // observations = {350, 380, 442} | inliersIndex = [0, 1] | inliers = {350, 380}
+            // viewIds = {350, 380, 442} | inliersIndex = [0, 1] | inliers = {350, 380}
             for (const auto& id : inliersIndex)
-                inliers.insert(*std::next(observations.begin(), id));
+                inliers.insert(viewIds.at(id));
 
             // -- Check:
             //  - nb of cameras validing the track
@@ -2107,6 +2479,7 @@ void ReconstructionEngine_sequentialSfM::triangulate_2Views(SfMData& scene,
 
 std::size_t ReconstructionEngine_sequentialSfM::removeOutliers()
 {
+    ALICEVISION_PROFILE_SCOPE("sfm::removeOutliers");
     const std::size_t nbOutliersResidualErr = RemoveOutliers_PixelResidualError(_sfmData, _params.featureConstraint, _params.maxReprojectionError, 2);
     const std::size_t nbOutliersAngleErr = RemoveOutliers_AngleError(_sfmData, _params.minAngleForLandmark);
 
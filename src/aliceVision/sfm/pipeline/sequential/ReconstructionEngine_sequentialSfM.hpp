@@ -21,12 +21,17 @@
 #include <boost/filesystem.hpp>
 #include <boost/property_tree/ptree.hpp>
 
+#include <memory_resource>
+#include <unordered_set>
+
 namespace fs = boost::filesystem;
 namespace pt = boost::property_tree;
 
 namespace aliceVision {
 namespace sfm {
 
+class BundleAdjustmentCeres;
+
 /// Image score contains <ImageId, NbPutativeCommonPoint, score, isIntrinsicsReconstructed>
 typedef std::tuple<IndexT, std::size_t, std::size_t, bool> ViewConnectionScore;
 
@@ -92,6 +97,12 @@ class ReconstructionEngine_sequentialSfM : public ReconstructionEngine
         /// If the limit is not met, another BA iteration is performed.
         /// Using a negative value for this threshold will disable BA iterations.
         int bundleAdjustmentMaxOutliers = 50;
+        /// linear solver of the bundle adjustment reduced camera system
+        EBundleAdjustmentSolver bundleAdjustmentSolver = EBundleAdjustmentSolver::AUTO;
+        bool bundleAdjustmentMixedPrecision = false;
+        bool bundleAdjustmentUseGpu = false;
+        /// keep the Ceres problem between the bundle adjustments and only add the changes of the scene
+        bool bundleAdjustmentPersistentProblem = false;
 
         // Local Bundle Adjustment data
 
@@ -104,6 +115,15 @@ class ReconstructionEngine_sequentialSfM : public ReconstructionEngine
         /// filter for the intermediate reconstruction files
         sfmDataIO::ESfMData sfmStepFilter =
           sfmDataIO::ESfMData(sfmDataIO::VIEWS | sfmDataIO::EXTRINSICS | sfmDataIO::INTRINSICS | sfmDataIO::STRUCTURE | sfmDataIO::OBSERVATIONS);
+
+        // Checkpoints
+
+        /// folder of the checkpoints of the incremental reconstruction, disabled if empty
+        std::string checkpointFolder;
+        /// minimum time between two checkpoints, in seconds
+        double checkpointInterval = 600.0;
+        /// resume the incremental reconstruction from the checkpoint of checkpointFolder, if any
+        bool resumeFromCheckpoint = false;
     };
 
   public:
@@ -114,7 +134,7 @@ class ReconstructionEngine_sequentialSfM : public ReconstructionEngine
 
     void setFeatures(feature::FeaturesPerView* featuresPerView) { _featuresPerView = featuresPerView; }
 
-    void setMatches(matching::PairwiseMatches* pairwiseMatches) { _pairwiseMatches = pairwiseMatches; }
+    void setMatches(const matching::PairwiseMatches* pairwiseMatches) { _pairwiseMatches = pairwiseMatches; }
 
     /**
      * @brief Process the entire incremental reconstruction
@@ -151,11 +171,47 @@ class ReconstructionEngine_sequentialSfM : public ReconstructionEngine
      */
     void remapLandmarkIdsToTrackIds();
 
+    /**
+     * @brief State of the incremental reconstruction loop, saved in the checkpoints.
+     * @note The tracks, the pyramid scores and the reconstructed tracks index are not saved,
+     *       they are computed again from the features, the matches and the landmarks.
+     */
+    struct IncrementalState
+    {
+        IndexT resectionId = 0;
+        std::size_t globalIteration = 0;
+        /// number of poses at the beginning of the global iteration
+        std::size_t nbValidPoses = 0;
+        std::set<IndexT> viewsToVisit;
+        std::set<IndexT> potentials;
+    };
+
     /**
      * @brief Loop of reconstruction updates
+     * @param[in] resumedState the state of the loop loaded from a checkpoint, nullptr to start the loop
      * @return the duration of the incremental reconstruction
      */
-    double incrementalReconstruction();
+    double incrementalReconstruction(const IncrementalState* resumedState = nullptr);
+
+    /**
+     * @brief Save the scene, the loop state and the random number generator state in the checkpoint folder.
+     * @note The scene is written first and the state file, which refers to it, is renamed last,
+     *       so an interrupted checkpoint leaves the previous one valid.
+     * @param[in] state the state of the incremental reconstruction loop
+     */
+    void saveCheckpoint(const IncrementalState& state);
+
+    /**
+     * @brief Load the scene, the loop state and the random number generator state from the checkpoint folder.
+     * @param[out] state the state of the incremental reconstruction loop
+     * @return false if there is no valid checkpoint
+     */
+    bool loadCheckpoint(IncrementalState& state);
+
+    /**
+     * @brief Remove the checkpoint of a completed reconstruction, so it is not resumed by a next run.
+     */
+    void removeCheckpoint();
 
     /**
      * @brief Update the reconstruction with a new resection group of images
@@ -262,13 +318,22 @@ class ReconstructionEngine_sequentialSfM : public ReconstructionEngine
      */
     std::size_t computeCandidateImageScore(IndexT viewId, const std::vector<std::size_t>& trackIds) const;
 
+    /**
+     * @brief Check if the resection of a rig view is not needed or not possible.
+     * @param[in] viewId: the view id
+     * @return true if the view should not be resected
+     */
+    bool isResectionSkipped(IndexT viewId) const;
+
     /**
      * @brief Apply the resection on a single view.
+     * @note Does not modify the scene, so the resections of several views can be computed in parallel.
      * @param[in] viewIndex: image index to add to the reconstruction.
      * @param[out] resectionData: contains the result (P) and all the data used during the resection.
+     * @param[in,out] randomNumberGenerator: the random generator of this resection
      * @return false if resection failed
      */
-    bool computeResection(const IndexT viewIndex, ResectionData& resectionData);
+    bool computeResection(const IndexT viewIndex, ResectionData& resectionData, std::mt19937& randomNumberGenerator) const;
 
     /**
      * @brief Update the global scene with the new found camera pose, intrinsic (if not defined) and
@@ -324,11 +389,12 @@ class ReconstructionEngine_sequentialSfM : public ReconstructionEngine
      * view and at least \c _minNbObservationsForTriangulation (new and previous) reconstructed view.
      * @param[in] previousReconstructedViews The old reconstructed views.
      * @param[in] newReconstructedViews The newly reconstructed views.
-     * @param[out] mapTracksToTriangulate A map with the tracks to triangulate and the observations to do it.
+     * @param[out] mapTracksToTriangulate A map with the tracks to triangulate and the observations to do it (sorted view ids).
+     *             Its memory resource is also used for the temporary data.
      */
     void getTracksToTriangulate(const std::set<IndexT>& previousReconstructedViews,
                                 const std::set<IndexT>& newReconstructedViews,
-                                std::map<IndexT, std::set<IndexT>>& mapTracksToTriangulate) const;
+                                std::pmr::map<IndexT, std::pmr::vector<IndexT>>& mapTracksToTriangulate) const;
 
     /**
      * @brief  Loop over the reconstructed views, and for each landmark of the reconstructed views,
@@ -339,6 +405,13 @@ class ReconstructionEngine_sequentialSfM : public ReconstructionEngine
      */
     void registerChanges(std::set<IndexT>& linkedViews, const std::set<IndexT>& newReconstructedViews);
 
+    /**
+     * @brief Update the reconstructed tracks of each view and the candidate scores of the views
+     *        with the landmarks added or removed since the last update.
+     * @note Must be called after any change of the landmarks, before the next best views selection.
+     */
+    void updateReconstructedTracksIndex();
+
     /**
      * @brief Remove observation/tracks that have:
      * - too large residual error
@@ -356,7 +429,7 @@ class ReconstructionEngine_sequentialSfM : public ReconstructionEngine
     // Data providers
 
     feature::FeaturesPerView* _featuresPerView;
-    matching::PairwiseMatches* _pairwiseMatches;
+    const matching::PairwiseMatches* _pairwiseMatches;
 
     // Pyramid scoring
 
@@ -372,6 +445,12 @@ class ReconstructionEngine_sequentialSfM : public ReconstructionEngine
     track::TracksPerView _map_tracksPerView;
     /// Precomputed pyramid index for each trackId of each viewId.
     track::TracksPyramidPerView _map_featsPyramidPerView;
+    /// Landmarks ids known by the reconstructed tracks index
+    std::unordered_set<std::size_t> _indexedLandmarks;
+    /// Reconstructed track ids (with a landmark) of each view, sorted
+    std::map<IndexT, std::vector<std::size_t>> _reconstructedTracksPerView;
+    /// Candidate image score of each view with reconstructed tracks
+    std::map<IndexT, std::size_t> _candidateScorePerView;
     /// Per camera confidence (A contrario estimated threshold error)
     HashMap<IndexT, double> _map_ACThreshold;
 
@@ -379,6 +458,8 @@ class ReconstructionEngine_sequentialSfM : public ReconstructionEngine
 
     /// Contains all the data used by the Local BA approach
     std::shared_ptr<LocalBundleAdjustmentGraph> _localStrategyGraph;
+    /// Bundle adjustment kept between the iterations if the persistent problem is enabled
+    std::shared_ptr<BundleAdjustmentCeres> _persistentBundleAdjustment;
 
     // Log
 
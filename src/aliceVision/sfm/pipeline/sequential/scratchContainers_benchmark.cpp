@@ -0,0 +1,141 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <aliceVision/types.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <map>
+#include <memory_resource>
+#include <random>
+#include <set>
+#include <vector>
+
+using namespace aliceVision;
+
+namespace {
+
+/**
+ * @brief Sorted views of random tracks, with 2 to 8 views per track.
+ */
+std::vector<std::vector<IndexT>> createTracks(int nbTracks, int nbViews)
+{
+    std::mt19937 generator(0);
+    std::uniform_int_distribution<int> lengthDist(2, 8);
+    std::uniform_int_distribution<IndexT> viewDist(0, nbViews - 1);
+
+    std::vector<std::vector<IndexT>> tracks(nbTracks);
+    for (std::vector<IndexT>& track : tracks)
+    {
+        const int length = lengthDist(generator);
+        for (int i = 0; i < length; ++i)
+            track.push_back(viewDist(generator));
+        std::sort(track.begin(), track.end());
+        track.erase(std::unique(track.begin(), track.end()), track.end());
+    }
+    return tracks;
+}
+
+/**
+ * @brief Tracks grouped per view and the set of modified views, as in the update of the reconstructed tracks index.
+ */
+template<class TracksPerView, class ViewSet>
+void groupTracksPerView(const std::vector<std::vector<IndexT>>& tracks, TracksPerView& tracksPerView, ViewSet& modifiedViews)
+{
+    for (std::size_t trackId = 0; trackId < tracks.size(); ++trackId)
+    {
+        for (const IndexT viewId : tracks[trackId])
+            tracksPerView[viewId].push_back(trackId);
+    }
+    for (const auto& viewTracks : tracksPerView)
+        modifiedViews.insert(viewTracks.first);
+}
+
+/**
+ * @brief Group state.range(0) tracks over state.range(1) views with the default allocator.
+ */
+void BM_TracksPerView_std(benchmark::State& state)
+{
+    const std::vector<std::vector<IndexT>> tracks = createTracks(static_cast<int>(state.range(0)), static_cast<int>(state.range(1)));
+
+    for (auto _ : state)
+    {
+        std::map<IndexT, std::vector<std::size_t>> tracksPerView;
+        std::set<IndexT> modifiedViews;
+        groupTracksPerView(tracks, tracksPerView, modifiedViews);
+        benchmark::DoNotOptimize(modifiedViews.size());
+    }
+
+    state.SetItemsProcessed(state.iterations() * tracks.size());
+}
+
+/**
+ * @brief Group state.range(0) tracks over state.range(1) views in a monotonic arena.
+ */
+void BM_TracksPerView_arena(benchmark::State& state)
+{
+    const std::vector<std::vector<IndexT>> tracks = createTracks(static_cast<int>(state.range(0)), static_cast<int>(state.range(1)));
+
+    for (auto _ : state)
+    {
+        std::pmr::monotonic_buffer_resource arena;
+        std::pmr::map<IndexT, std::pmr::vector<std::size_t>> tracksPerView(&arena);
+        std::pmr::set<IndexT> modifiedViews(&arena);
+        groupTracksPerView(tracks, tracksPerView, modifiedViews);
+        benchmark::DoNotOptimize(modifiedViews.size());
+    }
+
+    state.SetItemsProcessed(state.iterations() * tracks.size());
+}
+
+/**
+ * @brief Observations of state.range(0) tracks to triangulate as sets with the default allocator.
+ */
+void BM_TracksToTriangulate_std(benchmark::State& state)
+{
+    const std::vector<std::vector<IndexT>> tracks = createTracks(static_cast<int>(state.range(0)), static_cast<int>(state.range(1)));
+
+    for (auto _ : state)
+    {
+        std::map<IndexT, std::set<IndexT>> tracksToTriangulate;
+        for (std::size_t trackId = 0; trackId < tracks.size(); ++trackId)
+            tracksToTriangulate.emplace_hint(tracksToTriangulate.end(), trackId, std::set<IndexT>(tracks[trackId].begin(), tracks[trackId].end()));
+        benchmark::DoNotOptimize(tracksToTriangulate.size());
+    }
+
+    state.SetItemsProcessed(state.iterations() * tracks.size());
+}
+
+/**
+ * @brief Observations of state.range(0) tracks to triangulate as sorted vectors in a monotonic arena.
+ */
+void BM_TracksToTriangulate_arena(benchmark::State& state)
+{
+    const std::vector<std::vector<IndexT>> tracks = createTracks(static_cast<int>(state.range(0)), static_cast<int>(state.range(1)));
+
+    for (auto _ : state)
+    {
+        std::pmr::monotonic_buffer_resource arena;
+        std::pmr::map<IndexT, std::pmr::vector<IndexT>> tracksToTriangulate(&arena);
+        for (std::size_t trackId = 0; trackId < tracks.size(); ++trackId)
+        {
+            const auto it = tracksToTriangulate.emplace_hint(
+              tracksToTriangulate.end(), std::piecewise_construct, std::forward_as_tuple(trackId), std::forward_as_tuple());
+            it->second.assign(tracks[trackId].begin(), tracks[trackId].end());
+        }
+        benchmark::DoNotOptimize(tracksToTriangulate.size());
+    }
+
+    state.SetItemsProcessed(state.iterations() * tracks.size());
+}
+
+}  // namespace
+
+BENCHMARK(BM_TracksPerView_std)->Args({100000, 500})->Args({1000000, 2000})->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_TracksPerView_arena)->Args({100000, 500})->Args({1000000, 2000})->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_TracksToTriangulate_std)->Args({100000, 500})->Args({1000000, 2000})->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_TracksToTriangulate_arena)->Args({100000, 500})->Args({1000000, 2000})->Unit(benchmark::kMillisecond);
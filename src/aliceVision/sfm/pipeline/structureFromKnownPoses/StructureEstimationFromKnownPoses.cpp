@@ -12,11 +12,13 @@
 #include <aliceVision/multiview/relativePose/FundamentalError.hpp>
 #include <aliceVision/multiview/triangulation/Triangulation.hpp>
 #include <aliceVision/graph/graph.hpp>
-#include <aliceVision/track/TracksBuilder.hpp>
+#include <aliceVision/track/StreamingTracksBuilder.hpp>
 #include <aliceVision/sfm/sfmTriangulation.hpp>
 #include <aliceVision/system/ProgressDisplay.hpp>
 #include <aliceVision/config.hpp>
 
+#include <array>
+
 namespace aliceVision {
 namespace sfm {
 
@@ -76,89 +78,87 @@ void StructureEstimationFromKnownPoses::match(const SfMData& sfmData,
 {
     auto progressDisplay = system::createConsoleProgressDisplay(pairs.size(), std::cout, "Compute pairwise fundamental guided matching:\n");
 
-#pragma omp parallel
-    for (PairSet::const_iterator it = pairs.begin(); it != pairs.end(); ++it)
+    const std::vector<Pair> pairsVec(pairs.begin(), pairs.end());
+    // matches of each pair, written by a single thread and merged after the parallel loop
+    std::vector<matching::MatchesPerDescType> matchesPerPair(pairsVec.size());
+    std::vector<unsigned char> isMatched(pairsVec.size(), 0);
+
+#pragma omp parallel for schedule(dynamic)
+    for (int pairIndex = 0; pairIndex < static_cast<int>(pairsVec.size()); ++pairIndex)
     {
-#pragma omp single nowait
+        const Pair& pair = pairsVec[pairIndex];
+        ++progressDisplay;
+
+        // --
+        // Perform GUIDED MATCHING
+        // --
+        // Use the computed model to check valid correspondences
+        // - by considering geometric error and descriptor distance ratio.
+
+        const View* viewL = sfmData.getViews().at(pair.first).get();
+        const View* viewR = sfmData.getViews().at(pair.second).get();
+        const Intrinsics::const_iterator iterIntrinsicL = sfmData.getIntrinsics().find(viewL->getIntrinsicId());
+        const Intrinsics::const_iterator iterIntrinsicR = sfmData.getIntrinsics().find(viewR->getIntrinsicId());
+
+        if (iterIntrinsicL == sfmData.getIntrinsics().end() || iterIntrinsicR == sfmData.getIntrinsics().end())
+            continue;
+
+        std::shared_ptr<camera::Pinhole> pinHoleCamL = std::dynamic_pointer_cast<camera::Pinhole>(iterIntrinsicL->second);
+        std::shared_ptr<camera::Pinhole> pinHoleCamR = std::dynamic_pointer_cast<camera::Pinhole>(iterIntrinsicR->second);
+        if (!pinHoleCamL || !pinHoleCamR)
         {
-            // --
-            // Perform GUIDED MATCHING
-            // --
-            // Use the computed model to check valid correspondences
-            // - by considering geometric error and descriptor distance ratio.
-
-            const View* viewL = sfmData.getViews().at(it->first).get();
-            const Pose3 poseL = sfmData.getPose(*viewL).getTransform();
-            const Intrinsics::const_iterator iterIntrinsicL = sfmData.getIntrinsics().find(viewL->getIntrinsicId());
-            const View* viewR = sfmData.getViews().at(it->second).get();
-            const Pose3 poseR = sfmData.getPose(*viewR).getTransform();
-            const Intrinsics::const_iterator iterIntrinsicR = sfmData.getIntrinsics().find(viewR->getIntrinsicId());
-
-            if (sfmData.getIntrinsics().count(viewL->getIntrinsicId()) != 0 || sfmData.getIntrinsics().count(viewR->getIntrinsicId()) != 0)
-            {
-                std::shared_ptr<IntrinsicBase> camL = iterIntrinsicL->second;
-                std::shared_ptr<camera::Pinhole> pinHoleCamL = std::dynamic_pointer_cast<camera::Pinhole>(camL);
-                if (!pinHoleCamL)
-                {
-                    ALICEVISION_LOG_ERROR("Camera is not pinhole in match");
-                }
-
-                std::shared_ptr<IntrinsicBase> camR = iterIntrinsicR->second;
-                std::shared_ptr<camera::Pinhole> pinHoleCamR = std::dynamic_pointer_cast<camera::Pinhole>(camR);
-                if (!pinHoleCamL)
-                {
-                    ALICEVISION_LOG_ERROR("Camera is not pinhole in match");
-                }
+            ALICEVISION_LOG_ERROR("Camera is not pinhole in match");
+            continue;
+        }
 
-                const Mat34 P_L = pinHoleCamL->getProjectiveEquivalent(poseL);
-                const Mat34 P_R = pinHoleCamR->getProjectiveEquivalent(poseR);
+        const Pose3 poseL = sfmData.getPose(*viewL).getTransform();
+        const Pose3 poseR = sfmData.getPose(*viewR).getTransform();
+        const Mat34 P_L = pinHoleCamL->getProjectiveEquivalent(poseL);
+        const Mat34 P_R = pinHoleCamR->getProjectiveEquivalent(poseR);
 
-                const Mat3 F_lr = F_from_P(P_L, P_R);
-                std::vector<feature::EImageDescriberType> commonDescTypes = regionsPerView.getCommonDescTypes(*it);
+        const Mat3 F_lr = F_from_P(P_L, P_R);
+        std::vector<feature::EImageDescriberType> commonDescTypes = regionsPerView.getCommonDescTypes(pair);
 
-                matching::MatchesPerDescType allImagePairMatches;
-                for (feature::EImageDescriberType descType : commonDescTypes)
-                {
-                    std::vector<matching::IndMatch> matches;
+        matching::MatchesPerDescType& allImagePairMatches = matchesPerPair[pairIndex];
+        for (feature::EImageDescriberType descType : commonDescTypes)
+        {
+            std::vector<matching::IndMatch>& matches = allImagePairMatches[descType];
 #ifdef ALICEVISION_EXHAUSTIVE_MATCHING
-                    matching::guidedMatching<Mat3, multiview::relativePose::FundamentalEpipolarDistanceError>(
-                      F_lr,
-                      iterIntrinsicL->second.get(),
-                      regionsPerView.getRegions(it->first, descType),
-                      iterIntrinsicR->second.get(),
-                      regionsPerView.getRegions(it->second, descType),
-                      // descType,
-                      Square(thresholdF),
-                      Square(0.8),
-                      matches);
+            matching::guidedMatching<Mat3, multiview::relativePose::FundamentalEpipolarDistanceError>(
+              F_lr,
+              iterIntrinsicL->second.get(),
+              regionsPerView.getRegions(pair.first, descType),
+              iterIntrinsicR->second.get(),
+              regionsPerView.getRegions(pair.second, descType),
+              // descType,
+              Square(geometricErrorMax),
+              Square(0.8),
+              matches);
 #else
-                    const Vec3 epipole2 = epipole_from_P(P_R, poseL);
-
-                    // const feature::Regions& regions = regionsPerView.getRegions(it->first);
-                    matching::guidedMatchingFundamentalFast<multiview::relativePose::FundamentalEpipolarDistanceError>(
-                      F_lr,
-                      epipole2,
-                      iterIntrinsicL->second.get(),
-                      regionsPerView.getRegions(it->first, descType),
-                      iterIntrinsicR->second.get(),
-                      regionsPerView.getRegions(it->second, descType),
-                      iterIntrinsicR->second->w(),
-                      iterIntrinsicR->second->h(),
-                      // descType,
-                      Square(geometricErrorMax),
-                      Square(0.8),
-                      matches);
+            const Vec3 epipole2 = epipole_from_P(P_R, poseL);
+
+            matching::guidedMatchingFundamentalFast<multiview::relativePose::FundamentalEpipolarDistanceError>(
+              F_lr,
+              epipole2,
+              iterIntrinsicL->second.get(),
+              regionsPerView.getRegions(pair.first, descType),
+              iterIntrinsicR->second.get(),
+              regionsPerView.getRegions(pair.second, descType),
+              iterIntrinsicR->second->w(),
+              iterIntrinsicR->second->h(),
+              // descType,
+              Square(geometricErrorMax),
+              Square(0.8),
+              matches);
 #endif
-                    allImagePairMatches[descType] = matches;
-                }
-
-#pragma omp critical
-                {
-                    ++progressDisplay;
-                    _putativeMatches[*it] = allImagePairMatches;
-                }
-            }
         }
+        isMatched[pairIndex] = 1;
+    }
+
+    for (std::size_t pairIndex = 0; pairIndex < pairsVec.size(); ++pairIndex)
+    {
+        if (isMatched[pairIndex])
+            _putativeMatches.emplace_hint(_putativeMatches.end(), pairsVec[pairIndex], std::move(matchesPerPair[pairIndex]));
     }
 }
 
@@ -172,83 +172,97 @@ void StructureEstimationFromKnownPoses::filter(const SfMData& sfmData, const Pai
     typedef std::vector<graph::Triplet> Triplets;
     const Triplets triplets = graph::tripletListing(pairs);
 
+    /// features of a validated 3-view correspondence, in the (I, J, K) views order of the triplet
+    using TripletTrack = std::pair<feature::EImageDescriberType, std::array<IndexT, 3>>;
+    // validated tracks of each triplet, written by a single thread and merged in the triplets order
+    std::vector<std::vector<TripletTrack>> validTracksPerTriplet(triplets.size());
+
     auto progressDisplay =
       system::createConsoleProgressDisplay(triplets.size(), std::cout, "Per triplet tracks validation (discard spurious correspondences):\n");
-#pragma omp parallel
-    for (Triplets::const_iterator it = triplets.begin(); it != triplets.end(); ++it)
+
+#pragma omp parallel for schedule(dynamic)
+    for (int tripletIndex = 0; tripletIndex < static_cast<int>(triplets.size()); ++tripletIndex)
     {
-#pragma omp single nowait
-        {
-            ++progressDisplay;
+        ++progressDisplay;
 
-            const graph::Triplet& triplet = *it;
-            const IndexT I = triplet.i, J = triplet.j, K = triplet.k;
+        const graph::Triplet& triplet = triplets[tripletIndex];
+        const IndexT I = triplet.i, J = triplet.j, K = triplet.k;
 
-            track::TracksMap map_tracksCommon;
-            track::TracksBuilder tracksBuilder;
+        track::TracksMap map_tracksCommon;
+        {
+            matching::PairwiseMatches map_matchesIJK;
+            for (const Pair& pair : {std::make_pair(I, J), std::make_pair(I, K), std::make_pair(J, K)})
             {
-                matching::PairwiseMatches map_matchesIJK;
-                if (_putativeMatches.count(std::make_pair(I, J)))
-                    map_matchesIJK.insert(*_putativeMatches.find(std::make_pair(I, J)));
+                const auto matchesIt = _putativeMatches.find(pair);
+                if (matchesIt != _putativeMatches.end())
+                    map_matchesIJK.insert(*matchesIt);
+            }
 
-                if (_putativeMatches.count(std::make_pair(I, K)))
-                    map_matchesIJK.insert(*_putativeMatches.find(std::make_pair(I, K)));
+            if (map_matchesIJK.size() >= 2)
+            {
+                track::StreamingTracksBuilder tracksBuilder;
+                tracksBuilder.addMatches(map_matchesIJK);
+                tracksBuilder.filter(true, 3, false);
+                tracksBuilder.exportToSTL(map_tracksCommon);
+            }
+        }
 
-                if (_putativeMatches.count(std::make_pair(J, K)))
-                    map_matchesIJK.insert(*_putativeMatches.find(std::make_pair(J, K)));
+        // Triangulate the tracks
+        std::vector<TripletTrack>& validTracks = validTracksPerTriplet[tripletIndex];
+        for (track::TracksMap::const_iterator iterTracks = map_tracksCommon.begin(); iterTracks != map_tracksCommon.end(); ++iterTracks)
+        {
+            const track::Track& subTrack = iterTracks->second;
+            multiview::Triangulation trianObj;
+            for (auto iter = subTrack.featPerView.begin(); iter != subTrack.featPerView.end(); ++iter)
+            {
+                const size_t imaIndex = iter->first;
+                const size_t featIndex = iter->second.featureId;
+                const View* view = sfmData.getViews().at(imaIndex).get();
 
-                if (map_matchesIJK.size() >= 2)
+                std::shared_ptr<camera::IntrinsicBase> cam = sfmData.getIntrinsics().at(view->getIntrinsicId());
+                std::shared_ptr<camera::Pinhole> camPinHole = std::dynamic_pointer_cast<camera::Pinhole>(cam);
+                if (!camPinHole)
                 {
-                    tracksBuilder.build(map_matchesIJK);
-                    tracksBuilder.filter(true, 3, false);
-                    tracksBuilder.exportToSTL(map_tracksCommon);
+                    ALICEVISION_LOG_ERROR("Camera is not pinhole in filter");
+                    continue;
                 }
 
-                // Triangulate the tracks
-                for (track::TracksMap::const_iterator iterTracks = map_tracksCommon.begin(); iterTracks != map_tracksCommon.end(); ++iterTracks)
-                {
-                    {
-                        const track::Track& subTrack = iterTracks->second;
-                        multiview::Triangulation trianObj;
-                        for (auto iter = subTrack.featPerView.begin(); iter != subTrack.featPerView.end(); ++iter)
-                        {
-                            const size_t imaIndex = iter->first;
-                            const size_t featIndex = iter->second.featureId;
-                            const View* view = sfmData.getViews().at(imaIndex).get();
-
-                            std::shared_ptr<camera::IntrinsicBase> cam = sfmData.getIntrinsics().at(view->getIntrinsicId());
-                            std::shared_ptr<camera::Pinhole> camPinHole = std::dynamic_pointer_cast<camera::Pinhole>(cam);
-                            if (!camPinHole)
-                            {
-                                ALICEVISION_LOG_ERROR("Camera is not pinhole in filter");
-                                continue;
-                            }
-
-                            const Pose3 pose = sfmData.getPose(*view).getTransform();
-                            const Vec2 pt = regionsPerView.getRegions(imaIndex, subTrack.descType).GetRegionPosition(featIndex);
-                            trianObj.add(camPinHole->getProjectiveEquivalent(pose), cam->get_ud_pixel(pt));
-                        }
-                        const Vec3 Xs = trianObj.compute();
-                        if (trianObj.minDepth() > 0 && trianObj.error() / (double)trianObj.size() < 4.0)
-                        // TODO: Add an angular check ?
-                        {
-#pragma omp critical
-                            {
-                                track::Track::FeatureIdPerView::const_iterator iterI, iterJ, iterK;
-                                iterI = iterJ = iterK = subTrack.featPerView.begin();
-                                std::advance(iterJ, 1);
-                                std::advance(iterK, 2);
-
-                                _tripletMatches[std::make_pair(I, J)][subTrack.descType].emplace_back(iterI->second.featureId, iterJ->second.featureId);
-                                _tripletMatches[std::make_pair(J, K)][subTrack.descType].emplace_back(iterJ->second.featureId, iterK->second.featureId);
-                                _tripletMatches[std::make_pair(I, K)][subTrack.descType].emplace_back(iterI->second.featureId, iterK->second.featureId);
-                            }
-                        }
-                    }
-                }
+                const Pose3 pose = sfmData.getPose(*view).getTransform();
+                const Vec2 pt = regionsPerView.getRegions(imaIndex, subTrack.descType).GetRegionPosition(featIndex);
+                trianObj.add(camPinHole->getProjectiveEquivalent(pose), cam->get_ud_pixel(pt));
+            }
+            const Vec3 Xs = trianObj.compute();
+            if (trianObj.minDepth() > 0 && trianObj.error() / (double)trianObj.size() < 4.0)
+            // TODO: Add an angular check ?
+            {
+                track::Track::FeatureIdPerView::const_iterator iterI, iterJ, iterK;
+                iterI = iterJ = iterK = subTrack.featPerView.begin();
+                std::advance(iterJ, 1);
+                std::advance(iterK, 2);
+
+                validTracks.emplace_back(subTrack.descType,
+                                         std::array<IndexT, 3>{static_cast<IndexT>(iterI->second.featureId),
+                                                               static_cast<IndexT>(iterJ->second.featureId),
+                                                               static_cast<IndexT>(iterK->second.featureId)});
             }
         }
     }
+
+    for (std::size_t tripletIndex = 0; tripletIndex < triplets.size(); ++tripletIndex)
+    {
+        const graph::Triplet& triplet = triplets[tripletIndex];
+        const IndexT I = triplet.i, J = triplet.j, K = triplet.k;
+
+        for (const TripletTrack& validTrack : validTracksPerTriplet[tripletIndex])
+        {
+            const std::array<IndexT, 3>& featureIds = validTrack.second;
+            _tripletMatches[std::make_pair(I, J)][validTrack.first].emplace_back(featureIds[0], featureIds[1]);
+            _tripletMatches[std::make_pair(J, K)][validTrack.first].emplace_back(featureIds[1], featureIds[2]);
+            _tripletMatches[std::make_pair(I, K)][validTrack.first].emplace_back(featureIds[0], featureIds[2]);
+        }
+        std::vector<TripletTrack>().swap(validTracksPerTriplet[tripletIndex]);
+    }
+
     // Clear putatives matches since they are no longer required
     matching::PairwiseMatches().swap(_putativeMatches);
 }
@@ -259,8 +273,8 @@ void StructureEstimationFromKnownPoses::triangulate(SfMData& sfmData,
                                                     std::mt19937& randomNumberGenerator)
 {
     track::TracksMap map_tracksCommon;
-    track::TracksBuilder tracksBuilder;
-    tracksBuilder.build(_tripletMatches);
+    track::StreamingTracksBuilder tracksBuilder;
+    tracksBuilder.addMatches(_tripletMatches);
     tracksBuilder.filter(true, 3);
     tracksBuilder.exportToSTL(map_tracksCommon);
     matching::PairwiseMatches().swap(_tripletMatches);
@@ -7,56 +7,134 @@
 
 #include "sfmFilters.hpp"
 #include <aliceVision/sfmData/SfMData.hpp>
+#include <aliceVision/sfmData/LandmarksStore.hpp>
+#include <aliceVision/sfmData/ViewsStore.hpp>
 #include <aliceVision/stl/stl.hpp>
 #include <aliceVision/system/Logger.hpp>
 #include <aliceVision/sfm/bundle/BundleAdjustment.hpp>
+#include <aliceVision/sfm/sfmStatistics.hpp>
+
+#include <aliceVision/alicevision_omp.hpp>
 
 #include <iterator>
 
 namespace aliceVision {
 namespace sfm {
 
+namespace {
+
+/**
+ * @brief Iterators on the landmarks, for the parallel passes over the landmarks HashMap.
+ * @param[in] landmarks the SfMData landmarks
+ * @return one iterator per landmark, in the landmarks order
+ */
+std::vector<sfmData::Landmarks::iterator> getLandmarksIterators(sfmData::Landmarks& landmarks)
+{
+    std::vector<sfmData::Landmarks::iterator> iterators;
+    iterators.reserve(landmarks.size());
+    for (auto it = landmarks.begin(); it != landmarks.end(); ++it)
+        iterators.push_back(it);
+    return iterators;
+}
+
+/**
+ * @brief Remove in place the observations of a landmark that are not kept.
+ * @param[in,out] observations the landmark observations
+ * @param[in] keep the keep flag of each observation, in the observations order
+ */
+void compactObservations(sfmData::Observations& observations, const unsigned char* keep)
+{
+    auto itOut = observations.begin();
+    for (auto itObs = observations.begin(); itObs != observations.end(); ++itObs, ++keep)
+    {
+        if (!*keep)
+            continue;
+        if (itOut != itObs)
+            *itOut = std::move(*itObs);
+        ++itOut;
+    }
+    observations.erase(itOut, observations.end());
+}
+
+/**
+ * @brief Erase the flagged landmarks, sequentially as the HashMap is not thread-safe.
+ * @param[in,out] landmarks the SfMData landmarks
+ * @param[in] iterators the iterators on the landmarks
+ * @param[in] toErase the erase flag of each iterator
+ */
+void eraseLandmarks(sfmData::Landmarks& landmarks,
+                    const std::vector<sfmData::Landmarks::iterator>& iterators,
+                    const std::vector<unsigned char>& toErase)
+{
+    for (std::size_t i = 0; i < iterators.size(); ++i)
+    {
+        if (toErase[i])
+            landmarks.erase(iterators[i]);
+    }
+}
+
+}  // namespace
+
 IndexT RemoveOutliers_PixelResidualError(sfmData::SfMData& sfmData,
                                          EFeatureConstraint featureConstraint,
                                          const double dThresholdPixel,
                                          const unsigned int minTrackLength)
 {
+    // residuals and depths of all the observations, projected per view
+    const sfmData::LandmarksStore landmarksStore(sfmData.getLandmarks());
+    std::vector<Vec2> residuals;
+    std::vector<double> depths;
+    computeObservationsResiduals(sfmData, landmarksStore, residuals, &depths);
+
+    sfmData::Landmarks& landmarks = sfmData.getLandmarks();
+    const std::vector<sfmData::Landmarks::iterator> landmarksIterators = getLandmarksIterators(landmarks);
+    const int nbLandmarks = static_cast<int>(landmarksIterators.size());
+
+    // first pass: keep flag of each observation (in the store order) and of each landmark
+    std::vector<unsigned char> keepObservation(landmarksStore.nbObservations());
+    std::vector<unsigned char> eraseLandmark(nbLandmarks, 0);
     IndexT outlier_count = 0;
-    sfmData::Landmarks::iterator iterTracks = sfmData.getLandmarks().begin();
 
-    while (iterTracks != sfmData.getLandmarks().end())
+#pragma omp parallel for schedule(dynamic, 1024) reduction(+ : outlier_count)
+    for (int i = 0; i < nbLandmarks; ++i)
     {
-        sfmData::Observations& observations = iterTracks->second.observations;
-        sfmData::Observations::iterator itObs = observations.begin();
+        // observations are in the same order in the store
+        const sfmData::Observations& observations = landmarksIterators[i]->second.observations;
+        std::size_t obsIndex = landmarksStore.observationOffset(landmarksStore.indexOf(landmarksIterators[i]->first));
 
-        while (itObs != observations.end())
+        std::size_t nbKept = 0;
+        for (const auto& observationPair : observations)
         {
-            const sfmData::View* view = sfmData.getViews().at(itObs->first).get();
-            const geometry::Pose3 pose = sfmData.getPose(*view).getTransform();
-            const camera::IntrinsicBase* intrinsic = sfmData.getIntrinsics().at(view->getIntrinsicId()).get();
-
-            Vec2 residual = intrinsic->residual(pose, iterTracks->second.X.homogeneous(), itObs->second.x);
-            if (featureConstraint == EFeatureConstraint::SCALE && itObs->second.scale > 0.0)
+            Vec2 residual = residuals[obsIndex];
+            if (featureConstraint == EFeatureConstraint::SCALE && observationPair.second.scale > 0.0)
             {
                 // Apply the scale of the feature to get a residual value
                 // relative to the feature precision.
-                residual /= itObs->second.scale;
+                residual /= observationPair.second.scale;
             }
 
-            if ((pose.depth(iterTracks->second.X) < 0) || (residual.norm() > dThresholdPixel))
-            {
-                ++outlier_count;
-                itObs = observations.erase(itObs);
-            }
-            else
-                ++itObs;
+            const bool keep = (depths[obsIndex] >= 0) && (residual.norm() <= dThresholdPixel);
+            keepObservation[obsIndex] = keep;
+            nbKept += keep;
+            ++obsIndex;
         }
+        outlier_count += static_cast<IndexT>(observations.size() - nbKept);
 
-        if (observations.empty() || observations.size() < minTrackLength)
-            iterTracks = sfmData.getLandmarks().erase(iterTracks);
-        else
-            ++iterTracks;
+        if (nbKept == 0 || nbKept < minTrackLength)
+            eraseLandmark[i] = 1;
     }
+
+    // second pass: compact the observations of the remaining landmarks, then erase the others
+#pragma omp parallel for schedule(dynamic, 1024)
+    for (int i = 0; i < nbLandmarks; ++i)
+    {
+        if (eraseLandmark[i])
+            continue;
+        const std::size_t landmarkIndex = landmarksStore.indexOf(landmarksIterators[i]->first);
+        compactObservations(landmarksIterators[i]->second.observations, &keepObservation[landmarksStore.observationOffset(landmarkIndex)]);
+    }
+
+    eraseLandmarks(landmarks, landmarksIterators, eraseLandmark);
     return outlier_count;
 }
 
@@ -65,22 +143,29 @@ IndexT RemoveOutliers_AngleError(sfmData::SfMData& sfmData, const double dMinAcc
     // note that smallest accepted angle => largest accepted cos(angle)
     const double dMaxAcceptedCosAngle = std::cos(degreeToRadian(dMinAcceptedAngle));
 
-    using LandmarksKeysVec = std::vector<sfmData::Landmarks::key_type>;
-    LandmarksKeysVec v_keys;
-    v_keys.reserve(sfmData.getLandmarks().size());
-    std::transform(sfmData.getLandmarks().cbegin(), sfmData.getLandmarks().cend(), std::back_inserter(v_keys), stl::RetrieveKey());
+    // columnar copy of the landmarks: contiguous observations for the parallel read-only pass
+    const sfmData::LandmarksStore landmarksStore(sfmData.getLandmarks());
 
-    LandmarksKeysVec toErase;
+    // dense copy of the views: the pose and the intrinsic of each view are looked up once
+    const sfmData::ViewsStore viewsStore(sfmData.getViews(), sfmData.getIntrinsics());
+    std::vector<geometry::Pose3> viewPoses(viewsStore.nbViews());
+    for (std::size_t viewIndex = 0; viewIndex < viewsStore.nbViews(); ++viewIndex)
+    {
+        if (sfmData.isPoseAndIntrinsicDefined(&viewsStore.view(viewIndex)))
+            viewPoses[viewIndex] = sfmData.getPose(viewsStore.view(viewIndex)).getTransform();
+    }
 
-#pragma omp parallel for
-    for (int landmarkIndex = 0; landmarkIndex < v_keys.size(); ++landmarkIndex)
+    std::vector<IndexT> toErase;
+
+#pragma omp parallel for schedule(dynamic, 64)
+    for (int landmarkIndex = 0; landmarkIndex < landmarksStore.size(); ++landmarkIndex)
     {
-        const sfmData::Observations& observations = sfmData.getLandmarks().at(v_keys[landmarkIndex]).observations;
+        const sfmData::LandmarksStore::ObservationsRange observations = landmarksStore.observations(landmarkIndex);
 
         // create matrix for observation directions from camera to point
         Mat3X viewDirections(3, observations.size());
         Mat3X::Index i;
-        sfmData::Observations::const_iterator itObs;
+        sfmData::LandmarksStore::ObservationsRange::const_iterator itObs;
 
         // Greedy algorithm almost always finds an acceptable angle in 1-5 iterations (if it exists).
         // It works by greedily chasing the first larger view angle found from the current greedy index.
@@ -92,11 +177,10 @@ IndexT RemoveOutliers_AngleError(sfmData::SfMData& sfmData, const double dMinAcc
         // fill matrix, optimistically checking each new entry against col(greedyI)
         for (itObs = observations.begin(), i = 0; itObs != observations.end(); ++itObs, ++i)
         {
-            const sfmData::View* view = sfmData.getViews().at(itObs->first).get();
-            const geometry::Pose3 pose = sfmData.getPose(*view).getTransform();
-            const camera::IntrinsicBase* intrinsic = sfmData.getIntrinsics().at(view->getIntrinsicId()).get();
+            const IndexT viewIndex = viewsStore.viewIndexOf(landmarksStore.observationViewId(itObs.index()));
 
-            viewDirections.col(i) = applyIntrinsicExtrinsic(pose, intrinsic, itObs->second.x);
+            viewDirections.col(i) =
+              applyIntrinsicExtrinsic(viewPoses[viewIndex], viewsStore.viewIntrinsic(viewIndex), landmarksStore.observationX(itObs.index()));
 
             double dCosAngle = viewDirections.col(i).transpose() * viewDirections.col(greedyI);
             if (dCosAngle < dMaxAcceptedCosAngle)
@@ -140,7 +224,7 @@ IndexT RemoveOutliers_AngleError(sfmData::SfMData& sfmData, const double dMinAcc
         if (i == 0)
         {
 #pragma omp critical
-            toErase.push_back(v_keys[landmarkIndex]);
+            toErase.push_back(landmarksStore.landmarkId(landmarkIndex));
         }
     }
 
@@ -164,24 +248,64 @@ bool eraseUnstablePoses(sfmData::SfMData& sfmData, const IndexT min_points_per_p
     for (sfmData::Poses::const_iterator itPoses = sfmData.getPoses().begin(); itPoses != sfmData.getPoses().end(); ++itPoses)
         posesCount[itPoses->first] = 0;
 
-    // Count occurrence of the poses in the Landmark observations
-    for (sfmData::Landmarks::const_iterator itLandmarks = landmarks.begin(); itLandmarks != landmarks.end(); ++itLandmarks)
+    // Dense index of the pose of each view, -1 for the unknown poses
+    HashMap<IndexT, int> poseIndexPerView;
+    std::vector<IndexT> poseIds;
     {
-        const sfmData::Observations& observations = itLandmarks->second.observations;
-        for (sfmData::Observations::const_iterator itObs = observations.begin(); itObs != observations.end(); ++itObs)
+        HashMap<IndexT, int> poseIndexes;
+        for (const auto& poseCount : posesCount)
+        {
+            poseIndexes[poseCount.first] = static_cast<int>(poseIds.size());
+            poseIds.push_back(poseCount.first);
+        }
+        for (const auto& viewPair : sfmData.getViews())
         {
-            const IndexT viewId = itObs->first;
-            const sfmData::View* v = sfmData.getViews().at(viewId).get();
-            const auto poseInfoIt = posesCount.find(v->getPoseId());
-
-            if (poseInfoIt != posesCount.end())
-                poseInfoIt->second++;
-            else  // all pose should be defined in map_PoseId_Count
-                throw std::runtime_error(std::string("eraseUnstablePoses: found unknown pose id referenced by a view.\n\t- view id: ") +
-                                         std::to_string(v->getViewId()) + std::string("\n\t- pose id: ") + std::to_string(v->getPoseId()));
+            const auto poseIndexIt = poseIndexes.find(viewPair.second->getPoseId());
+            poseIndexPerView[viewPair.first] = (poseIndexIt != poseIndexes.end()) ? poseIndexIt->second : -1;
         }
     }
 
+    std::vector<const sfmData::Landmark*> landmarksPtrs;
+    landmarksPtrs.reserve(landmarks.size());
+    for (const auto& landmarkPair : landmarks)
+        landmarksPtrs.push_back(&landmarkPair.second);
+    const int nbLandmarks = static_cast<int>(landmarksPtrs.size());
+
+    // Count occurrence of the poses in the Landmark observations, with a count per thread
+    std::vector<std::vector<IndexT>> posesCountPerThread(omp_get_max_threads(), std::vector<IndexT>(poseIds.size(), 0));
+    IndexT unknownPoseViewId = UndefinedIndexT;
+
+#pragma omp parallel for schedule(dynamic, 1024)
+    for (int i = 0; i < nbLandmarks; ++i)
+    {
+        std::vector<IndexT>& threadPosesCount = posesCountPerThread[omp_get_thread_num()];
+        for (const auto& observationPair : landmarksPtrs[i]->observations)
+        {
+            const int poseIndex = poseIndexPerView.at(observationPair.first);
+            if (poseIndex != -1)
+                threadPosesCount[poseIndex]++;
+            else
+            {
+#pragma omp critical
+                unknownPoseViewId = observationPair.first;
+            }
+        }
+    }
+
+    if (unknownPoseViewId != UndefinedIndexT)
+    {
+        // all pose should be defined in map_PoseId_Count
+        const sfmData::View* v = sfmData.getViews().at(unknownPoseViewId).get();
+        throw std::runtime_error(std::string("eraseUnstablePoses: found unknown pose id referenced by a view.\n\t- view id: ") +
+                                 std::to_string(v->getViewId()) + std::string("\n\t- pose id: ") + std::to_string(v->getPoseId()));
+    }
+
+    for (const std::vector<IndexT>& threadPosesCount : posesCountPerThread)
+    {
+        for (std::size_t poseIndex = 0; poseIndex < poseIds.size(); ++poseIndex)
+            posesCount[poseIds[poseIndex]] += threadPosesCount[poseIndex];
+    }
+
     // If usage count is smaller than the threshold, remove the Pose
     for (HashMap<IndexT, IndexT>::const_iterator it = posesCount.begin(); it != posesCount.end(); ++it)
     {
@@ -215,41 +339,51 @@ bool eraseUnstablePoses(sfmData::SfMData& sfmData, const IndexT min_points_per_p
 
 bool eraseObservationsWithMissingPoses(sfmData::SfMData& sfmData, const IndexT min_points_per_landmark)
 {
-    IndexT removed_elements = 0;
-
     std::set<IndexT> reconstructedPoseIndexes;
     std::transform(sfmData.getPoses().begin(),
                    sfmData.getPoses().end(),
                    std::inserter(reconstructedPoseIndexes, reconstructedPoseIndexes.begin()),
                    stl::RetrieveKey());
 
+    // Views with a reconstructed pose
+    HashMap<IndexT, bool> validViews;
+    for (const auto& viewPair : sfmData.getViews())
+        validViews[viewPair.first] = reconstructedPoseIndexes.count(viewPair.second->getPoseId()) > 0;
+
+    sfmData::Landmarks& landmarks = sfmData.getLandmarks();
+    const std::vector<sfmData::Landmarks::iterator> landmarksIterators = getLandmarksIterators(landmarks);
+    const int nbLandmarks = static_cast<int>(landmarksIterators.size());
+    std::vector<unsigned char> eraseLandmark(nbLandmarks, 0);
+    IndexT removed_elements = 0;
+
     // For each landmark:
     //  - Check if we need to keep the observations & the track
-    sfmData::Landmarks::iterator itLandmarks = sfmData.getLandmarks().begin();
-
-    while (itLandmarks != sfmData.getLandmarks().end())
+#pragma omp parallel for schedule(dynamic, 1024) reduction(+ : removed_elements)
+    for (int i = 0; i < nbLandmarks; ++i)
     {
-        sfmData::Observations& observations = itLandmarks->second.observations;
-        sfmData::Observations::iterator itObs = observations.begin();
+        sfmData::Observations& observations = landmarksIterators[i]->second.observations;
 
-        while (itObs != observations.end())
+        std::vector<unsigned char> keepObservation(observations.size());
+        std::size_t nbKept = 0;
+        std::size_t obsIndex = 0;
+        for (const auto& observationPair : observations)
         {
-            const IndexT ViewId = itObs->first;
-            const sfmData::View* v = sfmData.getViews().at(ViewId).get();
-            if (reconstructedPoseIndexes.count(v->getPoseId()) == 0)
-            {
-                itObs = observations.erase(itObs);
-                ++removed_elements;
-            }
-            else
-                ++itObs;
+            const bool keep = validViews.at(observationPair.first);
+            keepObservation[obsIndex++] = keep;
+            nbKept += keep;
+        }
+
+        if (nbKept != observations.size())
+        {
+            removed_elements += static_cast<IndexT>(observations.size() - nbKept);
+            compactObservations(observations, keepObservation.data());
         }
 
         if (observations.empty() || observations.size() < min_points_per_landmark)
-            itLandmarks = sfmData.getLandmarks().erase(itLandmarks);
-        else
-            ++itLandmarks;
+            eraseLandmark[i] = 1;
     }
+
+    eraseLandmarks(landmarks, landmarksIterators, eraseLandmark);
     return removed_elements > 0;
 }
 
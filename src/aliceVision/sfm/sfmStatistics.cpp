@@ -12,9 +12,91 @@
 #include <aliceVision/sfm/pipeline/pairwiseMatchesIO.hpp>
 #include <aliceVision/track/TracksBuilder.hpp>
 
+#include <limits>
+#include <map>
+
 namespace aliceVision {
 namespace sfm {
 
+void computeObservationsResiduals(const sfmData::SfMData& sfmData,
+                                  const sfmData::LandmarksStore& landmarksStore,
+                                  std::vector<Vec2>& out_residuals,
+                                  std::vector<double>* out_depths)
+{
+    const std::size_t nbObservations = landmarksStore.nbObservations();
+    out_residuals.resize(nbObservations);
+    if (out_depths)
+    {
+        out_depths->resize(nbObservations);
+    }
+
+    // observations of each view
+    std::vector<std::size_t> landmarkPerObservation(nbObservations);
+    std::map<IndexT, std::vector<std::size_t>> observationsPerView;
+    for (std::size_t landmarkIndex = 0; landmarkIndex < landmarksStore.size(); ++landmarkIndex)
+    {
+        for (std::size_t o = landmarksStore.observationOffset(landmarkIndex); o < landmarksStore.observationOffset(landmarkIndex + 1); ++o)
+        {
+            landmarkPerObservation[o] = landmarkIndex;
+            observationsPerView[landmarksStore.observationViewId(o)].push_back(o);
+        }
+    }
+
+    // poses and intrinsics are retrieved sequentially,
+    // the observations of the views without pose or intrinsic get an infinite residual
+    struct ViewBatch
+    {
+        geometry::Pose3 pose;
+        const camera::IntrinsicBase* intrinsic;
+        const std::vector<std::size_t>* observations;
+    };
+
+    std::vector<ViewBatch> viewBatches;
+    viewBatches.reserve(observationsPerView.size());
+    for (const auto& viewObservations : observationsPerView)
+    {
+        const sfmData::View& view = sfmData.getView(viewObservations.first);
+        if (!sfmData.isPoseAndIntrinsicDefined(&view))
+        {
+            for (const std::size_t o : viewObservations.second)
+            {
+                out_residuals[o] = Vec2::Constant(std::numeric_limits<double>::infinity());
+                if (out_depths)
+                {
+                    (*out_depths)[o] = std::numeric_limits<double>::quiet_NaN();
+                }
+            }
+            continue;
+        }
+        viewBatches.push_back({sfmData.getPose(view).getTransform(), sfmData.getIntrinsics().at(view.getIntrinsicId()).get(), &viewObservations.second});
+    }
+
+#pragma omp parallel for schedule(dynamic)
+    for (int batchIndex = 0; batchIndex < viewBatches.size(); ++batchIndex)
+    {
+        const ViewBatch& viewBatch = viewBatches[batchIndex];
+        const std::vector<std::size_t>& observations = *viewBatch.observations;
+
+        std::vector<Vec3> points(observations.size());
+        std::vector<Vec2> projections(observations.size());
+        for (std::size_t i = 0; i < observations.size(); ++i)
+        {
+            points[i] = landmarksStore.position(landmarkPerObservation[observations[i]]);
+        }
+
+        viewBatch.intrinsic->projectBatch(viewBatch.pose, points.data(), projections.data(), observations.size());
+
+        for (std::size_t i = 0; i < observations.size(); ++i)
+        {
+            out_residuals[observations[i]] = landmarksStore.observationX(observations[i]) - projections[i];
+            if (out_depths)
+            {
+                (*out_depths)[observations[i]] = viewBatch.pose.depth(points[i]);
+            }
+        }
+    }
+}
+
 void computeResidualsHistogram(const sfmData::SfMData& sfmData,
                                BoxStats<double>& out_stats,
                                utils::Histogram<double>* out_histogram,
@@ -35,24 +117,20 @@ void computeResidualsHistogram(const sfmData::SfMData& sfmData,
     std::vector<double> vec_residuals;
     vec_residuals.reserve(sfmData.getLandmarks().size());
 
-    for (const auto& track : sfmData.getLandmarks())
+    const sfmData::LandmarksStore landmarksStore(sfmData.getLandmarks());
+    std::vector<Vec2> residuals;
+    computeObservationsResiduals(sfmData, landmarksStore, residuals);
+
+    for (std::size_t o = 0; o < residuals.size(); ++o)
     {
-        const aliceVision::sfmData::Observations& observations = track.second.observations;
-        for (const auto& obs : observations)
+        if (!specificViews.empty())
         {
-            if (!specificViews.empty())
-            {
-                if (specificViews.count(obs.first) == 0)
-                    continue;
-            }
-            const sfmData::View& view = sfmData.getView(obs.first);
-            const aliceVision::geometry::Pose3 pose = sfmData.getPose(view).getTransform();
-            const std::shared_ptr<aliceVision::camera::IntrinsicBase> intrinsic = sfmData.getIntrinsics().find(view.getIntrinsicId())->second;
-            const Vec2 residual = intrinsic->residual(pose, track.second.X.homogeneous(), obs.second.x);
-            vec_residuals.push_back(residual.norm());
-            // ALICEVISION_LOG_INFO("[AliceVision] sfmtstatistics::computeResidualsHistogram track: " << track.first << ", residual: " <<
-            // residual.norm());
+            if (specificViews.count(landmarksStore.observationViewId(o)) == 0)
+                continue;
         }
+        if (!residuals[o].allFinite())
+            continue;
+        vec_residuals.push_back(residuals[o].norm());
     }
 
     // ALICEVISION_LOG_INFO("[AliceVision] sfmtstatistics::computeResidualsHistogram vec_residuals.size(): " << vec_residuals.size());
@@ -332,17 +410,15 @@ void computeResidualsPerView(const sfmData::SfMData& sfmData,
     // Collect residuals (number of residuals per 3D points) of all landmarks visible in each view
     std::map<IndexT, std::vector<double>> residualsPerView;
 
-    for (const auto& landmark : sfmData.getLandmarks())
+    const sfmData::LandmarksStore landmarksStore(sfmData.getLandmarks());
+    std::vector<Vec2> residuals;
+    computeObservationsResiduals(sfmData, landmarksStore, residuals);
+
+    for (std::size_t o = 0; o < residuals.size(); ++o)
     {
-        const aliceVision::sfmData::Observations& observations = landmark.second.observations;
-        for (const auto& obs : observations)
-        {
-            const sfmData::View& view = sfmData.getView(obs.first);
-            const aliceVision::geometry::Pose3 pose = sfmData.getPose(view).getTransform();
-            const std::shared_ptr<aliceVision::camera::IntrinsicBase> intrinsic = sfmData.getIntrinsics().find(view.getIntrinsicId())->second;
-            const Vec2 residual = intrinsic->residual(pose, landmark.second.X.homogeneous(), obs.second.x);
-            residualsPerView[obs.first].push_back(residual.norm());
-        }
+        if (!residuals[o].allFinite())
+            continue;
+        residualsPerView[landmarksStore.observationViewId(o)].push_back(residuals[o].norm());
     }
 
     std::vector<IndexT> viewKeys;
@@ -7,6 +7,7 @@
 #pragma once
 
 #include <aliceVision/sfmData/SfMData.hpp>
+#include <aliceVision/sfmData/LandmarksStore.hpp>
 #include <aliceVision/numeric/numeric.hpp>
 #include <aliceVision/track/Track.hpp>
 #include <aliceVision/track/tracksUtils.hpp>
@@ -17,6 +18,20 @@
 namespace aliceVision {
 namespace sfm {
 
+/**
+ * @brief Compute the residuals between landmarks and features of all the observations.
+ *        The landmarks are projected with a single batch projection per view.
+ * @param[in] sfmData: scene containing the views, the poses and the intrinsics
+ * @param[in] landmarksStore: columnar copy of the scene landmarks
+ * @param[out] out_residuals: residual (feature - projection) of each observation, in the landmarksStore observations order,
+ *                            infinite for the views without pose or intrinsic
+ * @param[out] out_depths: if not null, depth of the landmark in the camera of each observation
+ */
+void computeObservationsResiduals(const sfmData::SfMData& sfmData,
+                                  const sfmData::LandmarksStore& landmarksStore,
+                                  std::vector<Vec2>& out_residuals,
+                                  std::vector<double>* out_depths = nullptr);
+
 /**
  * @brief Compute histogram of residual values between landmarks and features in all the views specified
  * @param[in] sfmData : scene containing the features and the landmarks
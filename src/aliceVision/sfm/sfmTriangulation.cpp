@@ -11,8 +11,9 @@
 #include <aliceVision/system/ProgressDisplay.hpp>
 #include <aliceVision/config.hpp>
 
-#include <deque>
+#include <map>
 #include <memory>
+#include <vector>
 
 namespace aliceVision {
 namespace sfm {
@@ -28,71 +29,107 @@ StructureComputation_blind::StructureComputation_blind(bool verbose)
   : StructureComputation_basis(verbose)
 {}
 
+namespace {
+
+/// Projective matrix and intrinsic of a posed view
+struct ViewProjection
+{
+    Mat34 P;
+    const IntrinsicBase* intrinsic;
+};
+
+/**
+ * @brief Compute once the projective matrix of each posed pinhole view, to share it between all the tracks
+ * @param[in] sfmData The input SfMData
+ * @param[out] projections The projection of each posed pinhole view
+ */
+void computeViewProjections(const sfmData::SfMData& sfmData, std::map<IndexT, ViewProjection>& projections)
+{
+    for (const auto& viewPair : sfmData.getViews())
+    {
+        const sfmData::View& view = *viewPair.second;
+        if (!sfmData.isPoseAndIntrinsicDefined(&view))
+            continue;
+
+        const IntrinsicBase* intrinsic = sfmData.getIntrinsics().at(view.getIntrinsicId()).get();
+        const camera::Pinhole* pinHoleCam = dynamic_cast<const camera::Pinhole*>(intrinsic);
+        if (!pinHoleCam)
+        {
+            ALICEVISION_LOG_ERROR("Camera is not pinhole in triangulate (view id: " << viewPair.first << ")");
+            continue;
+        }
+
+        const Pose3 pose = sfmData.getPose(view).getTransform();
+        projections[viewPair.first] = {pinHoleCam->getProjectiveEquivalent(pose), intrinsic};
+    }
+}
+
+}  // namespace
+
 void StructureComputation_blind::triangulate(sfmData::SfMData& sfmData, std::mt19937& randomNumberGenerator) const
 {
-    std::deque<IndexT> rejectedId;
+    sfmData::Landmarks& landmarks = sfmData.getLandmarks();
+
     system::ProgressDisplay progressDisplay;
     if (_bConsoleVerbose)
-        progressDisplay = system::createConsoleProgressDisplay(sfmData.getLandmarks().size(), std::cout, "Blind triangulation progress:\n");
+        progressDisplay = system::createConsoleProgressDisplay(landmarks.size(), std::cout, "Blind triangulation progress:\n");
+
+    std::map<IndexT, ViewProjection> projections;
+    computeViewProjections(sfmData, projections);
+
+    // flatten the landmarks to distribute them over the threads
+    std::vector<sfmData::Landmarks::iterator> landmarksIts;
+    landmarksIts.reserve(landmarks.size());
+    for (auto it = landmarks.begin(); it != landmarks.end(); ++it)
+        landmarksIts.push_back(it);
+
+    std::vector<char> rejected(landmarksIts.size(), 0);
 
 #pragma omp parallel
-    for (sfmData::Landmarks::iterator iterTracks = sfmData.getLandmarks().begin(); iterTracks != sfmData.getLandmarks().end(); ++iterTracks)
     {
-#pragma omp single nowait
+        // reused for all the tracks of the thread
+        multiview::Triangulation trianObj;
+
+#pragma omp for schedule(dynamic, 256)
+        for (int i = 0; i < static_cast<int>(landmarksIts.size()); ++i)
         {
             if (_bConsoleVerbose)
             {
                 ++(progressDisplay);
             }
+
             // Triangulate each landmark
-            multiview::Triangulation trianObj;
-            const sfmData::Observations& observations = iterTracks->second.observations;
-            for (const auto& itObs : observations)
+            sfmData::Landmark& landmark = landmarksIts[i]->second;
+            trianObj.clear();
+            for (const auto& itObs : landmark.observations)
             {
-                const sfmData::View* view = sfmData.getViews().at(itObs.first).get();
-                if (sfmData.isPoseAndIntrinsicDefined(view))
-                {
-                    std::shared_ptr<IntrinsicBase> cam = sfmData.getIntrinsics().at(view->getIntrinsicId());
-                    std::shared_ptr<camera::Pinhole> pinHoleCam = std::dynamic_pointer_cast<camera::Pinhole>(cam);
-                    if (!pinHoleCam)
-                    {
-                        ALICEVISION_LOG_ERROR("Camera is not pinhole in triangulate");
-                        continue;
-                    }
-
-                    const Pose3 pose = sfmData.getPose(*view).getTransform();
-                    trianObj.add(pinHoleCam->getProjectiveEquivalent(pose), cam->get_ud_pixel(itObs.second.x));
-                }
+                const auto projIt = projections.find(itObs.first);
+                if (projIt == projections.end())
+                    continue;
+
+                trianObj.add(projIt->second.P, projIt->second.intrinsic->get_ud_pixel(itObs.second.x));
             }
+
             if (trianObj.size() < 2)
             {
-#pragma omp critical
-                {
-                    rejectedId.push_front(iterTracks->first);
-                }
+                rejected[i] = 1;
+                continue;
             }
+
+            // Compute the 3D point
+            const Vec3 X = trianObj.compute();
+            if (trianObj.minDepth() > 0)  // Keep the point only if it have a positive depth
+                landmark.X = X;
             else
-            {
-                // Compute the 3D point
-                const Vec3 X = trianObj.compute();
-                if (trianObj.minDepth() > 0)  // Keep the point only if it have a positive depth
-                {
-                    iterTracks->second.X = X;
-                }
-                else
-                {
-#pragma omp critical
-                    {
-                        rejectedId.push_front(iterTracks->first);
-                    }
-                }
-            }
+                rejected[i] = 1;
         }
     }
+
     // Erase the unsuccessful triangulated tracks
-    for (auto& it : rejectedId)
+    for (std::size_t i = 0; i < landmarksIts.size(); ++i)
     {
-        sfmData.getLandmarks().erase(it);
+        if (rejected[i])
+            landmarks.erase(landmarksIts[i]);
     }
 }
 
@@ -110,40 +147,51 @@ void StructureComputation_robust::triangulate(sfmData::SfMData& sfmData, std::mt
 /// Invalid landmark are removed.
 void StructureComputation_robust::robust_triangulation(sfmData::SfMData& sfmData, std::mt19937& randomNumberGenerator) const
 {
-    std::deque<IndexT> rejectedId;
+    sfmData::Landmarks& landmarks = sfmData.getLandmarks();
 
     system::ProgressDisplay progressDisplay;
     if (_bConsoleVerbose)
-        progressDisplay = system::createConsoleProgressDisplay(sfmData.getLandmarks().size(), std::cout, "Robust triangulation progress:\n");
+        progressDisplay = system::createConsoleProgressDisplay(landmarks.size(), std::cout, "Robust triangulation progress:\n");
 
-#pragma omp parallel
-    for (sfmData::Landmarks::iterator iterTracks = sfmData.getLandmarks().begin(); iterTracks != sfmData.getLandmarks().end(); ++iterTracks)
+    // flatten the landmarks to distribute them over the threads
+    std::vector<sfmData::Landmarks::iterator> landmarksIts;
+    landmarksIts.reserve(landmarks.size());
+    for (auto it = landmarks.begin(); it != landmarks.end(); ++it)
+        landmarksIts.push_back(it);
+
+    std::vector<char> rejected(landmarksIts.size(), 0);
+
+    // each track has its own random generator, seeded from the input one:
+    // the threads do not share a generator and the result does not depend on the scheduling
+    const std::mt19937::result_type seed = randomNumberGenerator();
+
+#pragma omp parallel for schedule(dynamic, 64)
+    for (int i = 0; i < static_cast<int>(landmarksIts.size()); ++i)
     {
-#pragma omp single nowait
+        if (_bConsoleVerbose)
         {
-            if (_bConsoleVerbose)
-            {
-                ++(progressDisplay);
-            }
-            Vec3 X;
-            if (robust_triangulation(sfmData, iterTracks->second.observations, randomNumberGenerator, X))
-            {
-                iterTracks->second.X = X;
-            }
-            else
-            {
-                iterTracks->second.X = Vec3::Zero();
-#pragma omp critical
-                {
-                    rejectedId.push_front(iterTracks->first);
-                }
-            }
+            ++(progressDisplay);
+        }
+
+        sfmData::Landmark& landmark = landmarksIts[i]->second;
+        std::mt19937 trackRandomNumberGenerator(seed + static_cast<std::mt19937::result_type>(i));
+        Vec3 X;
+        if (robust_triangulation(sfmData, landmark.observations, trackRandomNumberGenerator, X))
+        {
+            landmark.X = X;
+        }
+        else
+        {
+            landmark.X = Vec3::Zero();
+            rejected[i] = 1;
         }
     }
+
     // Erase the unsuccessful triangulated tracks
-    for (auto& it : rejectedId)
+    for (std::size_t i = 0; i < landmarksIts.size(); ++i)
     {
-        sfmData.getLandmarks().erase(it);
+        if (rejected[i])
+            landmarks.erase(landmarksIts[i]);
     }
 }
 
@@ -248,8 +296,8 @@ Vec3 StructureComputation_robust::track_sample_triangulation(const sfmData::SfMD
         std::advance(itObs, idx);
         const sfmData::View* view = sfmData.getViews().at(itObs->first).get();
 
-        std::shared_ptr<camera::IntrinsicBase> cam = sfmData.getIntrinsics().at(view->getIntrinsicId());
-        std::shared_ptr<camera::Pinhole> camPinHole = std::dynamic_pointer_cast<camera::Pinhole>(cam);
+        const camera::IntrinsicBase* cam = sfmData.getIntrinsics().at(view->getIntrinsicId()).get();
+        const camera::Pinhole* camPinHole = dynamic_cast<const camera::Pinhole*>(cam);
         if (!camPinHole)
         {
             ALICEVISION_LOG_ERROR("Camera is not pinhole in filter");
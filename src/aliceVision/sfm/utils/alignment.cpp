@@ -21,6 +21,8 @@
 #include <algorithm>
 #include <regex>
 #include <numeric>
+#include <unordered_map>
+#include <unordered_set>
 
 #include <aliceVision/numeric/gps.hpp>
 
@@ -200,13 +202,52 @@ bool computeSimilarityFromCommonCameras_poseId(const sfmData::SfMData& sfmDataA,
     return true;
 }
 
-std::map<std::string, IndexT> retrieveMatchingFilepath(const sfmData::SfMData& sfmData, const std::string& filePatternMatching)
+namespace {
+
+/**
+ * @brief Index the views by a key computed in parallel.
+ * @param[in] sfmData the scene
+ * @param[in] getKey the key of a view, must be thread-safe
+ * @return map<key, viewId>, without the keys shared by several views
+ */
+template<typename GetKey>
+std::map<std::string, IndexT> getUniqueViewKeys(const sfmData::SfMData& sfmData, GetKey getKey)
 {
-    std::set<std::string> duplicates;
-    std::map<std::string, IndexT> uniqueFileparts;
-    for (auto& viewIt : sfmData.getViews())
+    std::vector<const sfmData::View*> views;
+    views.reserve(sfmData.getViews().size());
+    for (const auto& viewIt : sfmData.getViews())
+        views.push_back(viewIt.second.get());
+
+    std::vector<std::string> keys(views.size());
+
+#pragma omp parallel for
+    for (int i = 0; i < views.size(); ++i)
+        keys[i] = getKey(*views[i]);
+
+    std::unordered_map<std::string, IndexT> keysIndex;
+    std::unordered_set<std::string> duplicates;
+    keysIndex.reserve(views.size());
+    for (std::size_t i = 0; i < views.size(); ++i)
+    {
+        if (!keysIndex.emplace(keys[i], views[i]->getViewId()).second)
+            duplicates.insert(keys[i]);
+    }
+    for (const std::string& d : duplicates)
     {
-        const std::string& imagePath = viewIt.second->getImage().getImagePath();
+        keysIndex.erase(d);
+    }
+    return std::map<std::string, IndexT>(keysIndex.begin(), keysIndex.end());
+}
+
+}  // namespace
+
+std::map<std::string, IndexT> retrieveMatchingFilepath(const sfmData::SfMData& sfmData, const std::string& filePatternMatching)
+{
+    // the regex is only compiled once, matching it is thread-safe
+    const std::regex re(filePatternMatching.empty() ? std::string(".*") : filePatternMatching);
+
+    return getUniqueViewKeys(sfmData, [&](const sfmData::View& view) {
+        const std::string& imagePath = view.getImage().getImagePath();
         std::string cumulatedValues;
         if (filePatternMatching.empty())
         {
@@ -214,7 +255,6 @@ std::map<std::string, IndexT> retrieveMatchingFilepath(const sfmData::SfMData& s
         }
         else
         {
-            std::regex re(filePatternMatching);
             std::smatch matches;
             if (std::regex_match(imagePath, matches, re))
             {
@@ -226,21 +266,8 @@ std::map<std::string, IndexT> retrieveMatchingFilepath(const sfmData::SfMData& s
             }
         }
         ALICEVISION_LOG_TRACE("retrieveMatchingFilepath: " << imagePath << " -> " << cumulatedValues);
-        auto it = uniqueFileparts.find(cumulatedValues);
-        if (it != uniqueFileparts.end())
-        {
-            duplicates.insert(cumulatedValues);
-        }
-        else
-        {
-            uniqueFileparts[cumulatedValues] = viewIt.first;
-        }
-    }
-    for (const std::string& d : duplicates)
-    {
-        uniqueFileparts.erase(d);
-    }
-    return uniqueFileparts;
+        return cumulatedValues;
+    });
 }
 
 void matchViewsByFilePattern(const sfmData::SfMData& sfmDataA,
@@ -289,11 +316,8 @@ bool computeSimilarityFromCommonCameras_imageFileMatching(const sfmData::SfMData
 
 std::map<std::string, IndexT> retrieveUniqueMetadataValues(const sfmData::SfMData& sfmData, const std::vector<std::string>& metadataList)
 {
-    std::set<std::string> duplicates;
-    std::map<std::string, IndexT> uniqueMetadataValues;
-    for (auto& viewIt : sfmData.getViews())
-    {
-        const std::map<std::string, std::string>& m = viewIt.second->getImage().getMetadata();
+    return getUniqueViewKeys(sfmData, [&](const sfmData::View& view) {
+        const std::map<std::string, std::string>& m = view.getImage().getMetadata();
         std::string cumulatedValues;
         for (const std::string& k : metadataList)
         {
@@ -301,22 +325,9 @@ std::map<std::string, IndexT> retrieveUniqueMetadataValues(const sfmData::SfMDat
             if (mIt != m.end())
                 cumulatedValues += mIt->second;
         }
-        ALICEVISION_LOG_TRACE("retrieveUniqueMetadataValues: " << viewIt.second->getImage().getImagePath() << " -> " << cumulatedValues);
-        auto it = uniqueMetadataValues.find(cumulatedValues);
-        if (it != uniqueMetadataValues.end())
-        {
-            duplicates.insert(cumulatedValues);
-        }
-        else
-        {
-            uniqueMetadataValues[cumulatedValues] = viewIt.first;
-        }
-    }
-    for (const std::string& d : duplicates)
-    {
-        uniqueMetadataValues.erase(d);
-    }
-    return uniqueMetadataValues;
+        ALICEVISION_LOG_TRACE("retrieveUniqueMetadataValues: " << view.getImage().getImagePath() << " -> " << cumulatedValues);
+        return cumulatedValues;
+    });
 }
 
 void matchViewsByMetadataMatching(const sfmData::SfMData& sfmDataA,
@@ -849,19 +860,21 @@ bool computeNewCoordinateSystemFromSpecificMarkers(const sfmData::SfMData& sfmDa
 {
     std::vector<int> landmarksIds(markers.size(), -1);
 
-    int maxLandmarkIdx = 0;
+    // index of the markers by id
+    std::unordered_map<int, std::vector<std::size_t>> markersIndex;
+    for (std::size_t i = 0; i < markers.size(); ++i)
+        markersIndex[markers[i].id].push_back(i);
+
     for (const auto& landmarkIt : sfmData.getLandmarks())
     {
-        if (landmarkIt.first > maxLandmarkIdx)
-            maxLandmarkIdx = landmarkIt.first;
         if (landmarkIt.second.descType != imageDescriberType)
             continue;
-        for (int i = 0; i < markers.size(); ++i)
+        const auto markerIt = markersIndex.find(landmarkIt.second.rgb.r());
+        if (markerIt == markersIndex.end())
+            continue;
+        for (const std::size_t i : markerIt->second)
         {
-            if (landmarkIt.second.rgb.r() == markers[i].id)
-            {
-                landmarksIds[i] = landmarkIt.first;
-            }
+            landmarksIds[i] = landmarkIt.first;
         }
     }
 
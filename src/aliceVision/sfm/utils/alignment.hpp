@@ -145,9 +145,10 @@ inline void applyTransform(sfmData::SfMData& sfmData, const double S, const Mat3
         }
     }
 
+    const Mat3 SR = S * R;
     for (auto& landmark : sfmData.getLandmarks())
     {
-        landmark.second.X = S * R * landmark.second.X + t;
+        landmark.second.X = SR * landmark.second.X + t;
     }
 }
 
@@ -5,6 +5,8 @@
 // v. 2.0. If a copy of the MPL was not distributed with this file,
 // You can obtain one at https://mozilla.org/MPL/2.0/.
 
+#pragma once
+
 #include <aliceVision/types.hpp>
 
 namespace aliceVision {
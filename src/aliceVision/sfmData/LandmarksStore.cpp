@@ -0,0 +1,107 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2023 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "LandmarksStore.hpp"
+
+#include <algorithm>
+
+namespace aliceVision {
+namespace sfmData {
+
+void LandmarksStore::clear()
+{
+    _landmarkIds.clear();
+    _positions.clear();
+    _descTypes.clear();
+    _colors.clear();
+    _obsOffsets.clear();
+    _obsViewIds.clear();
+    _obsFeatureIds.clear();
+    _obsX.clear();
+    _obsScales.clear();
+}
+
+void LandmarksStore::assign(const Landmarks& landmarks)
+{
+    clear();
+
+    const std::size_t nbLandmarks = landmarks.size();
+
+    // sort landmarks by id for deterministic dense indices and binary search in indexOf
+    _landmarkIds.reserve(nbLandmarks);
+    std::size_t nbObs = 0;
+    for (const auto& landmarkPair : landmarks)
+    {
+        _landmarkIds.push_back(landmarkPair.first);
+        nbObs += landmarkPair.second.observations.size();
+    }
+    std::sort(_landmarkIds.begin(), _landmarkIds.end());
+
+    _positions.reserve(nbLandmarks);
+    _descTypes.reserve(nbLandmarks);
+    _colors.reserve(nbLandmarks);
+    _obsOffsets.reserve(nbLandmarks + 1);
+    _obsViewIds.reserve(nbObs);
+    _obsFeatureIds.reserve(nbObs);
+    _obsX.reserve(nbObs);
+    _obsScales.reserve(nbObs);
+
+    _obsOffsets.push_back(0);
+    for (const IndexT landmarkId : _landmarkIds)
+    {
+        const Landmark& landmark = landmarks.at(landmarkId);
+        _positions.push_back(landmark.X);
+        _descTypes.push_back(landmark.descType);
+        _colors.push_back(landmark.rgb);
+
+        // flat_map observations are already sorted by view id
+        for (const auto& observationPair : landmark.observations)
+        {
+            _obsViewIds.push_back(observationPair.first);
+            _obsFeatureIds.push_back(observationPair.second.id_feat);
+            _obsX.push_back(observationPair.second.x);
+            _obsScales.push_back(static_cast<float>(observationPair.second.scale));
+        }
+        _obsOffsets.push_back(_obsViewIds.size());
+    }
+}
+
+Landmark LandmarksStore::landmark(std::size_t i) const
+{
+    Landmark landmark(_positions[i], _descTypes[i], Observations(), _colors[i]);
+    landmark.observations.reserve(nbObservations(i));
+    for (std::size_t o = _obsOffsets[i]; o < _obsOffsets[i + 1]; ++o)
+        landmark.observations.emplace_hint(landmark.observations.end(), _obsViewIds[o], observation(o));
+    return landmark;
+}
+
+void LandmarksStore::exportToLandmarks(Landmarks& landmarks) const
+{
+    landmarks.clear();
+    for (std::size_t i = 0; i < size(); ++i)
+        landmarks.emplace(_landmarkIds[i], landmark(i));
+}
+
+void LandmarksStore::updatePositions(Landmarks& landmarks) const
+{
+    for (std::size_t i = 0; i < size(); ++i)
+    {
+        auto it = landmarks.find(_landmarkIds[i]);
+        if (it != landmarks.end())
+            it->second.X = _positions[i];
+    }
+}
+
+IndexT LandmarksStore::indexOf(IndexT landmarkId) const
+{
+    const auto it = std::lower_bound(_landmarkIds.begin(), _landmarkIds.end(), landmarkId);
+    if (it == _landmarkIds.end() || *it != landmarkId)
+        return UndefinedIndexT;
+    return static_cast<IndexT>(std::distance(_landmarkIds.begin(), it));
+}
+
+}  // namespace sfmData
+}  // namespace aliceVision
@@ -0,0 +1,226 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2023 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <aliceVision/sfmData/Landmark.hpp>
+#include <aliceVision/types.hpp>
+
+#include <cstddef>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+namespace aliceVision {
+namespace sfmData {
+
+/// Landmarks are indexed by their landmark id (same definition as in SfMData.hpp)
+using Landmarks = HashMap<IndexT, Landmark>;
+
+/**
+ * @brief Compact columnar (structure of arrays) copy of the SfMData landmarks.
+ *
+ * Landmark attributes are stored in contiguous arrays indexed by a dense landmark index,
+ * and all the observations are stored in a single CSR table:
+ * the observations of the landmark i are [observationOffset(i), observationOffset(i + 1)[,
+ * sorted by view id like in the Observations flat_map.
+ * The feature scale is stored in single precision.
+ *
+ * It is meant for the read-mostly passes over the whole structure (filtering, bundle setup)
+ * where the per landmark allocations of the HashMap of Landmark are the bottleneck.
+ *
+ * Usage:
+ * @code{.cpp}
+ *  const LandmarksStore store(sfmData.getLandmarks());
+ *  for (std::size_t i = 0; i < store.size(); ++i)
+ *  {
+ *      const Vec3& X = store.position(i);
+ *      for (const auto& observationPair : store.observations(i))  // same as landmark.observations
+ *          ... observationPair.first (view id), observationPair.second.x ...
+ *  }
+ * @endcode
+ */
+class LandmarksStore
+{
+  public:
+    /**
+     * @brief Read-only range over the observations of one landmark.
+     *        Iterating yields std::pair<IndexT, Observation> values (view id, observation),
+     *        so code written for sfmData::Observations can iterate it unchanged.
+     */
+    class ObservationsRange
+    {
+      public:
+        class const_iterator
+        {
+          public:
+            using iterator_category = std::random_access_iterator_tag;
+            using value_type = std::pair<IndexT, Observation>;
+            using difference_type = std::ptrdiff_t;
+            using pointer = void;
+            using reference = value_type;
+
+            const_iterator() = default;
+            const_iterator(const LandmarksStore* store, std::size_t index)
+              : _store(store),
+                _index(index)
+            {}
+
+            value_type operator*() const { return value_type(_store->_obsViewIds[_index], _store->observation(_index)); }
+            value_type operator[](difference_type n) const { return *(*this + n); }
+
+            const_iterator& operator++()
+            {
+                ++_index;
+                return *this;
+            }
+            const_iterator operator++(int)
+            {
+                const_iterator it = *this;
+                ++_index;
+                return it;
+            }
+            const_iterator& operator--()
+            {
+                --_index;
+                return *this;
+            }
+            const_iterator operator--(int)
+            {
+                const_iterator it = *this;
+                --_index;
+                return it;
+            }
+            const_iterator& operator+=(difference_type n)
+            {
+                _index += n;
+                return *this;
+            }
+            const_iterator& operator-=(difference_type n)
+            {
+                _index -= n;
+                return *this;
+            }
+            const_iterator operator+(difference_type n) const { return const_iterator(_store, _index + n); }
+            const_iterator operator-(difference_type n) const { return const_iterator(_store, _index - n); }
+            difference_type operator-(const const_iterator& other) const
+            {
+                return static_cast<difference_type>(_index) - static_cast<difference_type>(other._index);
+            }
+
+            bool operator==(const const_iterator& other) const { return _index == other._index; }
+            bool operator!=(const const_iterator& other) const { return _index != other._index; }
+            bool operator<(const const_iterator& other) const { return _index < other._index; }
+
+            /// Index of the observation in the CSR table of the store
+            std::size_t index() const { return _index; }
+
+          private:
+            const LandmarksStore* _store = nullptr;
+            std::size_t _index = 0;
+        };
+
+        ObservationsRange(const LandmarksStore* store, std::size_t first, std::size_t last)
+          : _store(store),
+            _first(first),
+            _last(last)
+        {}
+
+        const_iterator begin() const { return const_iterator(_store, _first); }
+        const_iterator end() const { return const_iterator(_store, _last); }
+        std::size_t size() const { return _last - _first; }
+        bool empty() const { return _first == _last; }
+
+      private:
+        const LandmarksStore* _store;
+        std::size_t _first;
+        std::size_t _last;
+    };
+
+    LandmarksStore() = default;
+
+    /**
+     * @brief Build the columnar copy of the given landmarks.
+     *        Landmarks are stored by increasing landmark id.
+     * @param[in] landmarks The SfMData landmarks
+     */
+    explicit LandmarksStore(const Landmarks& landmarks) { assign(landmarks); }
+
+    /**
+     * @brief Replace the content of the store by the given landmarks
+     * @param[in] landmarks The SfMData landmarks
+     */
+    void assign(const Landmarks& landmarks);
+
+    /**
+     * @brief Export the store to the SfMData landmarks (the previous content is replaced)
+     * @param[out] landmarks The SfMData landmarks
+     */
+    void exportToLandmarks(Landmarks& landmarks) const;
+
+    /**
+     * @brief Write back the landmark positions to the given landmarks (other attributes are left untouched).
+     *        Landmarks of the store missing from \p landmarks are ignored.
+     * @param[in,out] landmarks The SfMData landmarks
+     */
+    void updatePositions(Landmarks& landmarks) const;
+
+    void clear();
+
+    /// Number of landmarks
+    std::size_t size() const { return _landmarkIds.size(); }
+    bool empty() const { return _landmarkIds.empty(); }
+
+    /// Total number of observations
+    std::size_t nbObservations() const { return _obsViewIds.size(); }
+
+    /// Dense index of a landmark id, or UndefinedIndexT if the landmark is not in the store
+    IndexT indexOf(IndexT landmarkId) const;
+
+    IndexT landmarkId(std::size_t i) const { return _landmarkIds[i]; }
+    const Vec3& position(std::size_t i) const { return _positions[i]; }
+    Vec3& position(std::size_t i) { return _positions[i]; }
+    feature::EImageDescriberType descType(std::size_t i) const { return _descTypes[i]; }
+    const image::RGBColor& color(std::size_t i) const { return _colors[i]; }
+
+    /// Return a copy of the landmark at dense index i
+    Landmark landmark(std::size_t i) const;
+
+    /// CSR accessors: observations of landmark i are in [observationOffset(i), observationOffset(i + 1)[
+    std::size_t observationOffset(std::size_t i) const { return _obsOffsets[i]; }
+    std::size_t nbObservations(std::size_t i) const { return _obsOffsets[i + 1] - _obsOffsets[i]; }
+    ObservationsRange observations(std::size_t i) const { return ObservationsRange(this, _obsOffsets[i], _obsOffsets[i + 1]); }
+
+    /// Per observation accessors (index in the CSR table)
+    IndexT observationViewId(std::size_t o) const { return _obsViewIds[o]; }
+    IndexT observationFeatureId(std::size_t o) const { return _obsFeatureIds[o]; }
+    const Vec2& observationX(std::size_t o) const { return _obsX[o]; }
+    float observationScale(std::size_t o) const { return _obsScales[o]; }
+    Observation observation(std::size_t o) const { return Observation(_obsX[o], _obsFeatureIds[o], _obsScales[o]); }
+
+    /// Raw contiguous arrays
+    const std::vector<Vec3>& positions() const { return _positions; }
+    std::vector<Vec3>& positions() { return _positions; }
+    const std::vector<std::size_t>& observationOffsets() const { return _obsOffsets; }
+    const std::vector<IndexT>& observationViewIds() const { return _obsViewIds; }
+
+  private:
+    // per landmark columns
+    std::vector<IndexT> _landmarkIds;
+    std::vector<Vec3> _positions;
+    std::vector<feature::EImageDescriberType> _descTypes;
+    std::vector<image::RGBColor> _colors;
+
+    // per observation columns (CSR, size of _obsOffsets is size() + 1)
+    std::vector<std::size_t> _obsOffsets;
+    std::vector<IndexT> _obsViewIds;
+    std::vector<IndexT> _obsFeatureIds;
+    std::vector<Vec2> _obsX;
+    std::vector<float> _obsScales;
+};
+
+}  // namespace sfmData
+}  // namespace aliceVision
@@ -0,0 +1,110 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "ViewsStore.hpp"
+
+#include <algorithm>
+#include <iterator>
+
+namespace aliceVision {
+namespace sfmData {
+
+namespace {
+
+IndexT denseIndexOf(const std::vector<IndexT>& sortedIds, IndexT id)
+{
+    const auto it = std::lower_bound(sortedIds.begin(), sortedIds.end(), id);
+    if (it == sortedIds.end() || *it != id)
+        return UndefinedIndexT;
+    return static_cast<IndexT>(std::distance(sortedIds.begin(), it));
+}
+
+}  // namespace
+
+ViewsStore::ViewsStore()
+  : _data(std::make_shared<Data>())
+{}
+
+ViewsStore::ViewsStore(const Views& views, const Intrinsics& intrinsics)
+  : ViewsStore()
+{
+    assign(views, intrinsics);
+}
+
+void ViewsStore::clear() { _data = std::make_shared<Data>(); }
+
+void ViewsStore::assign(const Views& views, const Intrinsics& intrinsics)
+{
+    // new arrays, the stores sharing the previous ones are left untouched
+    auto data = std::make_shared<Data>();
+
+    // sort by id for deterministic dense indices and binary search in indexOf
+    data->intrinsicIds.reserve(intrinsics.size());
+    for (const auto& intrinsicPair : intrinsics)
+        data->intrinsicIds.push_back(intrinsicPair.first);
+    std::sort(data->intrinsicIds.begin(), data->intrinsicIds.end());
+
+    data->intrinsics.reserve(intrinsics.size());
+    for (const IndexT intrinsicId : data->intrinsicIds)
+        data->intrinsics.push_back(intrinsics.at(intrinsicId));
+
+    data->viewIds.reserve(views.size());
+    for (const auto& viewPair : views)
+        data->viewIds.push_back(viewPair.first);
+    std::sort(data->viewIds.begin(), data->viewIds.end());
+
+    data->views.reserve(views.size());
+    data->viewIntrinsicIndexes.reserve(views.size());
+    for (const IndexT viewId : data->viewIds)
+    {
+        const std::shared_ptr<View>& view = views.at(viewId);
+        data->views.push_back(view);
+        data->viewIntrinsicIndexes.push_back(denseIndexOf(data->intrinsicIds, view->getIntrinsicId()));
+    }
+
+    _data = data;
+}
+
+void ViewsStore::exportTo(Views& views, Intrinsics& intrinsics) const
+{
+    views.clear();
+    for (std::size_t i = 0; i < nbViews(); ++i)
+        views.emplace(_data->viewIds[i], _data->views[i]);
+
+    intrinsics.clear();
+    for (std::size_t i = 0; i < nbIntrinsics(); ++i)
+        intrinsics.emplace(_data->intrinsicIds[i], _data->intrinsics[i]);
+}
+
+IndexT ViewsStore::viewIndexOf(IndexT viewId) const { return denseIndexOf(_data->viewIds, viewId); }
+
+IndexT ViewsStore::intrinsicIndexOf(IndexT intrinsicId) const { return denseIndexOf(_data->intrinsicIds, intrinsicId); }
+
+View& ViewsStore::view(std::size_t i)
+{
+    std::shared_ptr<View>& view = detach().views[i];
+    if (view.use_count() > 1)
+        view.reset(view->clone());
+    return *view;
+}
+
+camera::IntrinsicBase& ViewsStore::intrinsic(std::size_t i)
+{
+    std::shared_ptr<camera::IntrinsicBase>& intrinsic = detach().intrinsics[i];
+    if (intrinsic.use_count() > 1)
+        intrinsic.reset(intrinsic->clone());
+    return *intrinsic;
+}
+
+ViewsStore::Data& ViewsStore::detach()
+{
+    if (_data.use_count() > 1)
+        _data = std::make_shared<Data>(*_data);
+    return *_data;
+}
+
+}  // namespace sfmData
+}  // namespace aliceVision
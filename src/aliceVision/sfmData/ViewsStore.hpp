@@ -0,0 +1,130 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <aliceVision/camera/IntrinsicBase.hpp>
+#include <aliceVision/sfmData/HashMapPtr.hpp>
+#include <aliceVision/sfmData/View.hpp>
+#include <aliceVision/types.hpp>
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace aliceVision {
+namespace sfmData {
+
+/// Views are indexed by their view id (same definition as in SfMData.hpp)
+using Views = HashMapPtr<View>;
+
+/// Intrinsics are indexed by their intrinsic id (same definition as in SfMData.hpp)
+using Intrinsics = HashMapPtr<camera::IntrinsicBase>;
+
+/**
+ * @brief Dense copy of the SfMData views and intrinsics.
+ *
+ * The views and the intrinsics are stored in contiguous arrays by increasing id,
+ * and the intrinsic of each view is stored as a dense index,
+ * so the view -> intrinsic lookups of the per observation passes are array accesses.
+ *
+ * The arrays are shared between the copies of a store (copy-on-write): copying a store does not allocate,
+ * the arrays are copied by the first non-const accessor of a store sharing them,
+ * and a view or an intrinsic is cloned by its non-const accessor if it is shared
+ * (with another store or with the SfMData it comes from).
+ *
+ * Usage:
+ * @code{.cpp}
+ *  const ViewsStore store(sfmData.getViews(), sfmData.getIntrinsics());
+ *  const IndexT viewIndex = store.viewIndexOf(viewId);
+ *  const camera::IntrinsicBase* intrinsic = store.viewIntrinsic(viewIndex);
+ * @endcode
+ */
+class ViewsStore
+{
+  public:
+    ViewsStore();
+
+    /**
+     * @brief Build the dense copy of the given views and intrinsics.
+     *        The views and the intrinsics are shared, not cloned.
+     * @param[in] views The SfMData views
+     * @param[in] intrinsics The SfMData intrinsics
+     */
+    ViewsStore(const Views& views, const Intrinsics& intrinsics);
+
+    /**
+     * @brief Replace the content of the store by the given views and intrinsics
+     * @param[in] views The SfMData views
+     * @param[in] intrinsics The SfMData intrinsics
+     */
+    void assign(const Views& views, const Intrinsics& intrinsics);
+
+    /**
+     * @brief Export the store to the SfMData views and intrinsics (the previous content is replaced).
+     *        The views and the intrinsics are shared, not cloned.
+     * @param[out] views The SfMData views
+     * @param[out] intrinsics The SfMData intrinsics
+     */
+    void exportTo(Views& views, Intrinsics& intrinsics) const;
+
+    void clear();
+
+    std::size_t nbViews() const { return _data->viewIds.size(); }
+    std::size_t nbIntrinsics() const { return _data->intrinsicIds.size(); }
+
+    /// Dense index of a view id, or UndefinedIndexT if the view is not in the store
+    IndexT viewIndexOf(IndexT viewId) const;
+
+    /// Dense index of an intrinsic id, or UndefinedIndexT if the intrinsic is not in the store
+    IndexT intrinsicIndexOf(IndexT intrinsicId) const;
+
+    IndexT viewId(std::size_t i) const { return _data->viewIds[i]; }
+    const View& view(std::size_t i) const { return *_data->views[i]; }
+
+    /// Non-const access to the view at dense index i, cloned first if it is shared
+    View& view(std::size_t i);
+
+    IndexT intrinsicId(std::size_t i) const { return _data->intrinsicIds[i]; }
+    const camera::IntrinsicBase& intrinsic(std::size_t i) const { return *_data->intrinsics[i]; }
+
+    /// Non-const access to the intrinsic at dense index i, cloned first if it is shared
+    camera::IntrinsicBase& intrinsic(std::size_t i);
+
+    /// Dense index of the intrinsic of the view at dense index i, or UndefinedIndexT if the view has no valid intrinsic
+    IndexT viewIntrinsicIndex(std::size_t i) const { return _data->viewIntrinsicIndexes[i]; }
+
+    /// Intrinsic of the view at dense index i, or nullptr if the view has no valid intrinsic
+    const camera::IntrinsicBase* viewIntrinsic(std::size_t i) const
+    {
+        const IndexT intrinsicIndex = _data->viewIntrinsicIndexes[i];
+        return (intrinsicIndex == UndefinedIndexT) ? nullptr : _data->intrinsics[intrinsicIndex].get();
+    }
+
+    /// True if the two stores share the same arrays
+    bool sharesDataWith(const ViewsStore& other) const { return _data == other._data; }
+
+  private:
+    struct Data
+    {
+        // per view columns
+        std::vector<IndexT> viewIds;
+        std::vector<std::shared_ptr<View>> views;
+        std::vector<IndexT> viewIntrinsicIndexes;
+
+        // per intrinsic columns
+        std::vector<IndexT> intrinsicIds;
+        std::vector<std::shared_ptr<camera::IntrinsicBase>> intrinsics;
+    };
+
+    /// Copy the arrays if they are shared with another store
+    Data& detach();
+
+    std::shared_ptr<Data> _data;
+};
+
+}  // namespace sfmData
+}  // namespace aliceVision
@@ -13,10 +13,13 @@
 #include <aliceVision/image/io.hpp>
 #include <aliceVision/system/ProgressDisplay.hpp>
 
+#include <algorithm>
+#include <limits>
 #include <map>
+#include <numeric>
 #include <random>
+#include <unordered_map>
 #include <vector>
-#include <functional>
 namespace aliceVision {
 namespace sfmData {
 
@@ -24,11 +27,10 @@ void colorizeTracks(SfMData& sfmData)
 {
     auto progressDisplay = system::createConsoleProgressDisplay(sfmData.getLandmarks().size(), std::cout, "\nCompute scene structure color\n");
 
-    std::vector<std::reference_wrapper<Landmark>> remainingLandmarksToColor;
-    remainingLandmarksToColor.reserve(sfmData.getLandmarks().size());
-
+    std::vector<Landmark*> landmarks;
+    landmarks.reserve(sfmData.getLandmarks().size());
     for (auto& landmarkPair : sfmData.getLandmarks())
-        remainingLandmarksToColor.push_back(landmarkPair.second);
+        landmarks.push_back(&landmarkPair.second);
 
     struct ViewInfo
     {
@@ -39,7 +41,7 @@ void colorizeTracks(SfMData& sfmData)
 
         IndexT viewId;
         std::size_t cardinal;
-        std::vector<std::reference_wrapper<Landmark>> landmarks;
+        std::vector<Landmark*> landmarks;
     };
 
     std::vector<ViewInfo> sortedViewsCardinal;
@@ -47,11 +49,10 @@ void colorizeTracks(SfMData& sfmData)
     {
         // create cardinal per viewId map
         std::map<IndexT, std::size_t> viewsCardinalMap;  // <ViewId, Cardinal>
-        for (const auto& landmarkPair : sfmData.getLandmarks())
+        for (const Landmark* landmark : landmarks)
         {
-            const Observations& observations = landmarkPair.second.observations;
-            for (const auto& observationPair : observations)
-                ++viewsCardinalMap[observationPair.first];  // TODO: 0
+            for (const auto& observationPair : landmark->observations)
+                ++viewsCardinalMap[observationPair.first];
         }
 
         // copy key-value pairs from the map to the vector
@@ -59,33 +60,32 @@ void colorizeTracks(SfMData& sfmData)
             sortedViewsCardinal.push_back(ViewInfo(cardinalPair.first, cardinalPair.second));
 
         // sort the vector, biggest cardinality first
-        std::sort(
+        std::stable_sort(
           sortedViewsCardinal.begin(), sortedViewsCardinal.end(), [](const ViewInfo& l, const ViewInfo& r) { return l.cardinal > r.cardinal; });
     }
 
-    // assign each landmark to a view
-    for (ViewInfo& viewCardinal : sortedViewsCardinal)
+    // assign each landmark to its observing view of biggest cardinality, in a single pass over the landmarks
     {
-        std::vector<std::reference_wrapper<Landmark>> toKeep;
-        const IndexT viewId = viewCardinal.viewId;
+        std::unordered_map<IndexT, int> viewRanks;
+        viewRanks.reserve(sortedViewsCardinal.size());
+        for (int rank = 0; rank < sortedViewsCardinal.size(); ++rank)
+            viewRanks.emplace(sortedViewsCardinal[rank].viewId, rank);
 
-        for (int i = 0; i < remainingLandmarksToColor.size(); ++i)
+        std::vector<int> landmarkRanks(landmarks.size());
+#pragma omp parallel for
+        for (int i = 0; i < landmarks.size(); ++i)
         {
-            Landmark& landmark = remainingLandmarksToColor.at(i);
-            auto it = landmark.observations.find(viewId);
-            if (it != landmark.observations.end())
-            {
-                viewCardinal.landmarks.push_back(landmark);
-            }
-            else
-            {
-                toKeep.push_back(landmark);
-            }
+            int bestRank = std::numeric_limits<int>::max();
+            for (const auto& observationPair : landmarks[i]->observations)
+                bestRank = std::min(bestRank, viewRanks.at(observationPair.first));
+            landmarkRanks[i] = bestRank;
         }
-        std::swap(toKeep, remainingLandmarksToColor);
 
-        if (remainingLandmarksToColor.empty())
-            break;
+        for (int i = 0; i < landmarks.size(); ++i)
+        {
+            if (landmarkRanks[i] != std::numeric_limits<int>::max())
+                sortedViewsCardinal[landmarkRanks[i]].landmarks.push_back(landmarks[i]);
+        }
     }
 
     std::random_device randomDevice;
@@ -96,8 +96,8 @@ void colorizeTracks(SfMData& sfmData)
     std::iota(std::begin(unsortedIndexes), std::end(unsortedIndexes), 0);
     std::shuffle(unsortedIndexes.begin(), unsortedIndexes.end(), rng);
 
-    // landmark colorization
-#pragma omp parallel for
+    // landmark colorization, each image is read once
+#pragma omp parallel for schedule(dynamic)
     for (int i = 0; i < unsortedIndexes.size(); ++i)
     {
         const ViewInfo& viewCardinal = sortedViewsCardinal.at(unsortedIndexes.at(i));
@@ -107,14 +107,14 @@ void colorizeTracks(SfMData& sfmData)
             image::Image<image::RGBColor> image;
             image::readImage(view.getImage().getImagePath(), image, image::EImageColorSpace::SRGB);
 
-            for (Landmark& landmark : viewCardinal.landmarks)
+            for (Landmark* landmark : viewCardinal.landmarks)
             {
                 // color the point
-                Vec2 pt = landmark.observations.at(view.getViewId()).x;
+                Vec2 pt = landmark->observations.at(view.getViewId()).x;
                 // clamp the pixel position if the feature/marker center is outside the image.
                 pt.x() = clamp(pt.x(), 0.0, static_cast<double>(image.Width() - 1));
                 pt.y() = clamp(pt.y(), 0.0, static_cast<double>(image.Height() - 1));
-                landmark.rgb = image(pt.y(), pt.x());
+                landmark->rgb = image(pt.y(), pt.x());
             }
 
             progressDisplay += viewCardinal.landmarks.size();
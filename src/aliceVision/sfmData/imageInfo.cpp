@@ -181,7 +181,7 @@ Vec3 ImageInfo::getGpsPositionWGS84FromMetadata() const
     return {lat, lon, alt};
 }
 
-int ImageInfo::getSensorSize(const std::vector<sensorDB::Datasheet>& sensorDatabase,
+int ImageInfo::getSensorSize(const sensorDB::SensorDatabase& sensorDatabase,
                              double& sensorWidth,
                              double& sensorHeight,
                              double& focalLengthmm,
@@ -207,7 +207,7 @@ int ImageInfo::getSensorSize(const std::vector<sensorDB::Datasheet>& sensorDatab
     {
         intrinsicInitMode = camera::EInitMode::UNKNOWN;
         sensorDB::Datasheet datasheet;
-        if (sensorDB::getInfo(make, model, sensorDatabase, datasheet))
+        if (sensorDatabase.getInfo(make, model, datasheet))
         {
             if (verbose)
             {
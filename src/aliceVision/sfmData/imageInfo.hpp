@@ -13,6 +13,7 @@
 #include <aliceVision/sfmData/exposureSetting.hpp>
 #include <aliceVision/sfmData/exif.hpp>
 #include <aliceVision/sensorDB/Datasheet.hpp>
+#include <aliceVision/sensorDB/SensorDatabase.hpp>
 #include <aliceVision/camera/IntrinsicInitMode.hpp>
 
 #include <regex>
@@ -572,7 +573,7 @@ class ImageInfo
      * @param[in] verbose Enable verbosity
      * @return An Error or Warning code: 1 - Unknown sensor, 2 - No metadata, 3 - Unsure sensor, 4 - Computation from 35mm Focal
      */
-    int getSensorSize(const std::vector<sensorDB::Datasheet>& sensorDatabase,
+    int getSensorSize(const sensorDB::SensorDatabase& sensorDatabase,
                       double& sensorWidth,
                       double& sensorHeight,
                       double& focalLengthmm,
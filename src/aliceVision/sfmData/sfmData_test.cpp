@@ -1,6 +1,9 @@
 
 #include <boost/filesystem.hpp>
 #include <aliceVision/sfmData/SfMData.hpp>
+#include <aliceVision/sfmData/LandmarksStore.hpp>
+#include <aliceVision/sfmData/ViewsStore.hpp>
+#include <aliceVision/camera/Pinhole.hpp>
 
 #define BOOST_TEST_MODULE sfmData
 
@@ -50,3 +53,116 @@ BOOST_AUTO_TEST_CASE(SfMData_InternalFolders)
     BOOST_CHECK_EQUAL(sfmData.getRelativeFeaturesFolders()[0], fs::relative(refFolder, otherFolder));
     BOOST_CHECK_EQUAL(sfmData.getRelativeMatchesFolders()[0], fs::relative(refFolder, otherFolder));
 }
+
+BOOST_AUTO_TEST_CASE(SfMData_LandmarksStore)
+{
+    sfmData::Landmarks landmarks;
+    for (IndexT landmarkId = 0; landmarkId < 20; ++landmarkId)
+    {
+        sfmData::Landmark& landmark = landmarks[landmarkId * 3];
+        landmark.X = Vec3(landmarkId, 2.0 * landmarkId, -1.0);
+        landmark.descType = feature::EImageDescriberType::SIFT;
+        landmark.rgb = image::RGBColor(landmarkId, 0, 255);
+        for (IndexT viewId = 0; viewId < landmarkId % 5 + 2; ++viewId)
+            landmark.observations[viewId * 7] = sfmData::Observation(Vec2(viewId, landmarkId), landmarkId + viewId, 0.5 * viewId);
+    }
+
+    const sfmData::LandmarksStore store(landmarks);
+    BOOST_CHECK_EQUAL(store.size(), landmarks.size());
+
+    std::size_t nbObservations = 0;
+    for (std::size_t i = 0; i < store.size(); ++i)
+    {
+        // landmarks are stored by increasing id
+        BOOST_CHECK_EQUAL(store.landmarkId(i), i * 3);
+        BOOST_CHECK_EQUAL(store.indexOf(store.landmarkId(i)), i);
+
+        const sfmData::Landmark& landmark = landmarks.at(store.landmarkId(i));
+        BOOST_CHECK(store.landmark(i) == landmark);
+        BOOST_CHECK_EQUAL(store.nbObservations(i), landmark.observations.size());
+
+        // iterate the observations as sfmData::Observations
+        auto itRef = landmark.observations.begin();
+        for (const auto& observationPair : store.observations(i))
+        {
+            BOOST_CHECK_EQUAL(observationPair.first, itRef->first);
+            BOOST_CHECK(observationPair.second == itRef->second);
+            BOOST_CHECK_CLOSE(observationPair.second.scale, itRef->second.scale, 1e-5);
+            ++itRef;
+        }
+        nbObservations += landmark.observations.size();
+    }
+    BOOST_CHECK_EQUAL(store.nbObservations(), nbObservations);
+    BOOST_CHECK_EQUAL(store.indexOf(1), UndefinedIndexT);
+
+    sfmData::Landmarks exported;
+    store.exportToLandmarks(exported);
+    BOOST_CHECK(exported == landmarks);
+
+    sfmData::LandmarksStore movedStore(landmarks);
+    movedStore.position(0) = Vec3(10.0, 11.0, 12.0);
+    movedStore.updatePositions(exported);
+    BOOST_CHECK(exported.at(0).X == Vec3(10.0, 11.0, 12.0));
+}
+
+BOOST_AUTO_TEST_CASE(SfMData_ViewsStore)
+{
+    sfmData::SfMData sfmData;
+    for (IndexT intrinsicId = 0; intrinsicId < 3; ++intrinsicId)
+        sfmData.getIntrinsics().emplace(intrinsicId * 10, std::make_shared<camera::Pinhole>(1000, 1000, 1000.0 + intrinsicId, 1000.0, 0.0, 0.0));
+    for (IndexT viewId = 0; viewId < 20; ++viewId)
+    {
+        const IndexT intrinsicId = (viewId % 4 == 3) ? UndefinedIndexT : (viewId % 4) * 10;
+        sfmData.getViews().emplace(viewId * 5, std::make_shared<sfmData::View>("", viewId * 5, intrinsicId, viewId));
+    }
+
+    const sfmData::ViewsStore store(sfmData.getViews(), sfmData.getIntrinsics());
+    BOOST_CHECK_EQUAL(store.nbViews(), 20);
+    BOOST_CHECK_EQUAL(store.nbIntrinsics(), 3);
+
+    for (std::size_t i = 0; i < store.nbViews(); ++i)
+    {
+        // views are stored by increasing id
+        BOOST_CHECK_EQUAL(store.viewId(i), i * 5);
+        BOOST_CHECK_EQUAL(store.viewIndexOf(store.viewId(i)), i);
+        BOOST_CHECK_EQUAL(&store.view(i), sfmData.getViews().at(store.viewId(i)).get());
+
+        const IndexT intrinsicId = store.view(i).getIntrinsicId();
+        if (intrinsicId == UndefinedIndexT)
+        {
+            BOOST_CHECK_EQUAL(store.viewIntrinsicIndex(i), UndefinedIndexT);
+            BOOST_CHECK(store.viewIntrinsic(i) == nullptr);
+        }
+        else
+        {
+            BOOST_CHECK_EQUAL(store.intrinsicId(store.viewIntrinsicIndex(i)), intrinsicId);
+            BOOST_CHECK_EQUAL(store.viewIntrinsic(i), sfmData.getIntrinsics().at(intrinsicId).get());
+        }
+    }
+    BOOST_CHECK_EQUAL(store.viewIndexOf(1), UndefinedIndexT);
+    BOOST_CHECK_EQUAL(store.intrinsicIndexOf(10), 1);
+
+    // copies share the arrays until a non-const access
+    sfmData::ViewsStore copy = store;
+    BOOST_CHECK(copy.sharesDataWith(store));
+
+    copy.view(2).setPoseId(1000);
+    BOOST_CHECK(!copy.sharesDataWith(store));
+    BOOST_CHECK_EQUAL(copy.view(2).getPoseId(), 1000);
+    BOOST_CHECK_EQUAL(store.view(2).getPoseId(), 2);
+    BOOST_CHECK_EQUAL(sfmData.getViews().at(10)->getPoseId(), 2);
+    BOOST_CHECK_EQUAL(&copy.view(3), &store.view(3));
+
+    copy.intrinsic(0).setWidth(500);
+    BOOST_CHECK_EQUAL(copy.intrinsic(0).w(), 500);
+    BOOST_CHECK_EQUAL(store.intrinsic(0).w(), 1000);
+
+    sfmData::Views exportedViews;
+    sfmData::Intrinsics exportedIntrinsics;
+    copy.exportTo(exportedViews, exportedIntrinsics);
+    BOOST_CHECK_EQUAL(exportedViews.size(), 20);
+    BOOST_CHECK_EQUAL(exportedViews.at(10)->getPoseId(), 1000);
+    BOOST_CHECK_EQUAL(exportedViews.at(15).get(), sfmData.getViews().at(15).get());
+    BOOST_CHECK_EQUAL(exportedIntrinsics.size(), 3);
+    BOOST_CHECK_NE(exportedIntrinsics.at(0).get(), sfmData.getIntrinsics().at(0).get());
+}
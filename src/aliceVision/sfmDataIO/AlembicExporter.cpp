@@ -7,6 +7,7 @@
 
 #include "AlembicExporter.hpp"
 #include <aliceVision/version.hpp>
+#include <aliceVision/alicevision_omp.hpp>
 
 #include <Alembic/AbcGeom/All.h>
 #include <Alembic/AbcCoreOgawa/All.h>
@@ -14,6 +15,7 @@
 
 #include <boost/filesystem.hpp>
 
+#include <cstdint>
 #include <numeric>
 
 namespace fs = boost::filesystem;
@@ -423,22 +425,27 @@ void AlembicExporter::addLandmarks(const sfmData::Landmarks& landmarks,
     if (landmarks.empty())
         return;
 
-    // Fill vector with the values taken from AliceVision
-    std::vector<V3f> positions;
-    std::vector<Imath::C3f> colors;
-    std::vector<Alembic::Util::uint32_t> descTypes;
-    positions.reserve(landmarks.size());
-    descTypes.reserve(landmarks.size());
-
-    // For all the 3d points in the hash_map
+    std::vector<const sfmData::Landmark*> landmarksToSave;
+    landmarksToSave.reserve(landmarks.size());
     for (const auto& landmark : landmarks)
+        landmarksToSave.push_back(&landmark.second);
+    const std::int64_t nbLandmarks = static_cast<std::int64_t>(landmarksToSave.size());
+
+    // Fill vector with the values taken from AliceVision, in parallel
+    std::vector<V3f> positions(nbLandmarks);
+    std::vector<Imath::C3f> colors(nbLandmarks);
+    std::vector<Alembic::Util::uint32_t> descTypes(nbLandmarks);
+
+#pragma omp parallel for
+    for (std::int64_t i = 0; i < nbLandmarks; ++i)
     {
-        const Vec3& pt = landmark.second.X;
-        const image::RGBColor& color = landmark.second.rgb;
+        const sfmData::Landmark& landmark = *landmarksToSave[i];
+        const Vec3& pt = landmark.X;
+        const image::RGBColor& color = landmark.rgb;
         // convert position from computer vision convention to computer graphics (opengl-like)
-        positions.emplace_back(pt[0], -pt[1], -pt[2]);
-        colors.emplace_back(color.r() / 255.f, color.g() / 255.f, color.b() / 255.f);
-        descTypes.emplace_back(static_cast<Alembic::Util::uint8_t>(landmark.second.descType));
+        positions[i] = V3f(pt[0], -pt[1], -pt[2]);
+        colors[i] = Imath::C3f(color.r() / 255.f, color.g() / 255.f, color.b() / 255.f);
+        descTypes[i] = static_cast<Alembic::Util::uint8_t>(landmark.descType);
     }
 
     std::vector<Alembic::Util::uint64_t> ids(positions.size());
@@ -464,50 +471,52 @@ void AlembicExporter::addLandmarks(const sfmData::Landmarks& landmarks,
 
     if (withVisibility)
     {
-        std::vector<::uint32_t> visibilitySize;
-        visibilitySize.reserve(positions.size());
-        for (const auto& landmark : landmarks)
+        // offset of the observations of each landmark in the visibility arrays
+        std::vector<::uint32_t> visibilitySize(nbLandmarks);
+        std::vector<std::size_t> visibilityOffsets(nbLandmarks + 1, 0);
+        for (std::int64_t i = 0; i < nbLandmarks; ++i)
         {
-            visibilitySize.emplace_back(landmark.second.observations.size());
+            visibilitySize[i] = landmarksToSave[i]->observations.size();
+            visibilityOffsets[i + 1] = visibilityOffsets[i] + visibilitySize[i];
         }
-        std::size_t nbObservations = std::accumulate(visibilitySize.begin(), visibilitySize.end(), 0);
+        const std::size_t nbObservations = visibilityOffsets.back();
 
         // Use std::vector<::uint32_t> and std::vector<float> instead of std::vector<V2i> and std::vector<V2f>
         // Because Maya don't import them correctly
-        std::vector<::uint32_t> visibilityViewId;
+        std::vector<::uint32_t> visibilityViewId(nbObservations);
         std::vector<::uint32_t> visibilityFeatId;
-        visibilityViewId.reserve(nbObservations);
-
         std::vector<float> featPos2d;
         std::vector<float> featScale;
         if (withFeatures)
         {
-            featPos2d.reserve(nbObservations * 2);
-            visibilityFeatId.reserve(nbObservations);
-            featScale.reserve(nbObservations);
+            visibilityFeatId.resize(nbObservations);
+            featPos2d.resize(nbObservations * 2);
+            featScale.resize(nbObservations);
         }
 
-        for (const auto& landmark : landmarks)
+#pragma omp parallel for
+        for (std::int64_t i = 0; i < nbLandmarks; ++i)
         {
-            const sfmData::Observations& observations = landmark.second.observations;
-            for (const auto& vObs : observations)
+            std::size_t obsIndex = visibilityOffsets[i];
+            for (const auto& vObs : landmarksToSave[i]->observations)
             {
                 const sfmData::Observation& obs = vObs.second;
 
                 // viewId
-                visibilityViewId.emplace_back(vObs.first);
+                visibilityViewId[obsIndex] = vObs.first;
 
                 if (withFeatures)
                 {
                     // featureId
-                    visibilityFeatId.emplace_back(obs.id_feat);
+                    visibilityFeatId[obsIndex] = obs.id_feat;
 
                     // feature 2D position (x, y))
-                    featPos2d.emplace_back(obs.x[0]);
-                    featPos2d.emplace_back(obs.x[1]);
+                    featPos2d[2 * obsIndex] = obs.x[0];
+                    featPos2d[2 * obsIndex + 1] = obs.x[1];
 
-                    featScale.emplace_back(obs.scale);
+                    featScale[obsIndex] = obs.scale;
                 }
+                ++obsIndex;
             }
         }
 
@@ -524,12 +533,11 @@ void AlembicExporter::addLandmarks(const sfmData::Landmarks& landmarks,
     if (!landmarksUncertainty.empty())
     {
         std::vector<V3d> uncertainties;
+        uncertainties.reserve(nbLandmarks);
 
-        std::size_t indexLandmark = 0;
-        for (sfmData::Landmarks::const_iterator itLandmark = landmarks.begin(); itLandmark != landmarks.end(); ++itLandmark, ++indexLandmark)
+        for (const auto& landmark : landmarks)
         {
-            const IndexT idLandmark = itLandmark->first;
-            const Vec3& u = landmarksUncertainty.at(idLandmark);
+            const Vec3& u = landmarksUncertainty.at(landmark.first);
             uncertainties.emplace_back(u[0], u[1], u[2]);
         }
         // Uncertainty eigen values (x,y,z)
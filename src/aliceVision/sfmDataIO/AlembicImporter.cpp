@@ -12,6 +12,10 @@
 #include <Alembic/AbcCoreOgawa/All.h>
 
 #include <aliceVision/version.hpp>
+#include <aliceVision/alicevision_omp.hpp>
+
+#include <cstdint>
+#include <vector>
 
 namespace aliceVision {
 namespace sfmDataIO {
@@ -149,6 +153,19 @@ struct AV_UInt32ArraySamplePtr
     operator bool() const { return _isUnsigned ? bool(_v_uint) : bool(_v_int); }
 };
 
+/**
+ * @brief Offset of the observations of each point in the visibility arrays.
+ * @param[in] sampleVisibilitySize the number of observations of each point
+ * @return the offsets, followed by the total number of observations
+ */
+std::vector<std::size_t> computeVisibilityOffsets(AV_UInt32ArraySamplePtr& sampleVisibilitySize)
+{
+    std::vector<std::size_t> offsets(sampleVisibilitySize.size() + 1, 0);
+    for (std::size_t i = 0; i < sampleVisibilitySize.size(); ++i)
+        offsets[i + 1] = offsets[i] + sampleVisibilitySize[i];
+    return offsets;
+}
+
 bool readPointCloud(const Version& abcVersion, IObject iObj, M44d mat, sfmData::SfMData& sfmdata, ESfMData flags_part)
 {
     using namespace aliceVision::geometry;
@@ -187,11 +204,19 @@ bool readPointCloud(const Version& abcVersion, IObject iObj, M44d mat, sfmData::
 
     // Number of points before adding the Alembic data
     const std::size_t nbPointsInit = sfmdata.getLandmarks().size();
-    for (std::size_t point3d_i = 0; point3d_i < positions->size(); ++point3d_i)
+    const std::int64_t nbPoints = static_cast<std::int64_t>(positions->size());
+
+    // create the landmarks, then decode them in parallel
+    std::vector<sfmData::Landmark*> landmarks(nbPoints);
+    for (std::int64_t point3d_i = 0; point3d_i < nbPoints; ++point3d_i)
+        landmarks[point3d_i] = &sfmdata.getLandmarks()[nbPointsInit + point3d_i];
+
+#pragma omp parallel for
+    for (std::int64_t point3d_i = 0; point3d_i < nbPoints; ++point3d_i)
     {
         const P3fArraySamplePtr::element_type::value_type& pos_i = positions->get()[point3d_i];
 
-        sfmData::Landmark& landmark = sfmdata.getLandmarks()[nbPointsInit + point3d_i];
+        sfmData::Landmark& landmark = *landmarks[point3d_i];
 
         if (abcVersion < Version(1, 2, 3))
         {
@@ -251,13 +276,27 @@ bool readPointCloud(const Version& abcVersion, IObject iObj, M44d mat, sfmData::
             return false;
         }
 
-        std::size_t obsGlobal_i = 0;
-        for (std::size_t point3d_i = 0; point3d_i < positions->size(); ++point3d_i)
+        const std::vector<std::size_t> visibilityOffsets = computeVisibilityOffsets(sampleVisibilitySize);
+        if (2 * visibilityOffsets.back() > sampleVisibilityIds.size())
+        {
+            ALICEVISION_LOG_ERROR("Alembic Error: not enough visibility Ids for the number of observations.\n"
+                                  "# visibility Ids: "
+                                  << sampleVisibilityIds.size()
+                                  << ".\n"
+                                     "# observations: "
+                                  << visibilityOffsets.back() << ".");
+            return false;
+        }
+
+#pragma omp parallel for
+        for (std::int64_t point3d_i = 0; point3d_i < nbPoints; ++point3d_i)
         {
-            sfmData::Landmark& landmark = sfmdata.getLandmarks()[nbPointsInit + point3d_i];
+            sfmData::Landmark& landmark = *landmarks[point3d_i];
             // Number of observation for this 3d point
-            const std::size_t visibilitySize = sampleVisibilitySize[point3d_i];
+            const std::size_t visibilitySize = visibilityOffsets[point3d_i + 1] - visibilityOffsets[point3d_i];
+            landmark.observations.reserve(visibilitySize);
 
+            std::size_t obsGlobal_i = 2 * visibilityOffsets[point3d_i];
             for (std::size_t obs_i = 0; obs_i < visibilitySize * 2; obs_i += 2, obsGlobal_i += 2)
             {
                 const int viewID = sampleVisibilityIds[obsGlobal_i];
@@ -333,15 +372,29 @@ bool readPointCloud(const Version& abcVersion, IObject iObj, M44d mat, sfmData::
 
         const bool hasFeatures = bool(sampleVisibilityFeatId) && (sampleVisibilityFeatId.size() > 0);
 
-        std::size_t obsGlobalIndex = 0;
-        for (std::size_t point3d_i = 0; point3d_i < positions->size(); ++point3d_i)
+        const std::vector<std::size_t> visibilityOffsets = computeVisibilityOffsets(sampleVisibilitySize);
+        if (visibilityOffsets.back() > sampleVisibilityViewId.size())
+        {
+            ALICEVISION_LOG_ERROR("Alembic Error: not enough view Ids for the number of observations.\n"
+                                  "# view Ids: "
+                                  << sampleVisibilityViewId.size()
+                                  << ".\n"
+                                     "# observations: "
+                                  << visibilityOffsets.back() << ".");
+            return false;
+        }
+
+        // decode the observations of each landmark in parallel
+#pragma omp parallel for
+        for (std::int64_t point3d_i = 0; point3d_i < nbPoints; ++point3d_i)
         {
-            const int landmarkId = nbPointsInit + point3d_i;
-            sfmData::Landmark& landmark = sfmdata.getLandmarks()[landmarkId];
+            sfmData::Landmark& landmark = *landmarks[point3d_i];
 
             // Number of observation for this 3d point
-            const std::size_t visibilitySize = sampleVisibilitySize[point3d_i];
+            const std::size_t visibilitySize = visibilityOffsets[point3d_i + 1] - visibilityOffsets[point3d_i];
+            landmark.observations.reserve(visibilitySize);
 
+            std::size_t obsGlobalIndex = visibilityOffsets[point3d_i];
             for (std::size_t obs_i = 0; obs_i < visibilitySize; ++obs_i, ++obsGlobalIndex)
             {
                 const int viewId = sampleVisibilityViewId[obsGlobalIndex];
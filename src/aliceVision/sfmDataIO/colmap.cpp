@@ -10,6 +10,10 @@
 
 #include <boost/filesystem.hpp>
 
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <limits>
 #include <sstream>
 #include <fstream>
 
@@ -27,8 +31,59 @@ ColmapConfig::ColmapConfig(const std::string& basePath)
     _camerasTxtPath = (fs::path(_sparseDirectory) / fs::path("cameras.txt")).string();
     _imagesTxtPath = (fs::path(_sparseDirectory) / fs::path("images.txt")).string();
     _points3DPath = (fs::path(_sparseDirectory) / fs::path("points3D.txt")).string();
+    _camerasBinPath = (fs::path(_sparseDirectory) / fs::path("cameras.bin")).string();
+    _imagesBinPath = (fs::path(_sparseDirectory) / fs::path("images.bin")).string();
+    _points3DBinPath = (fs::path(_sparseDirectory) / fs::path("points3D.bin")).string();
 }
 
+namespace {
+
+/// Colmap camera model IDs (see Colmap's camera_models.h)
+enum EColmapCameraModel : int
+{
+    COLMAP_PINHOLE = 1,
+    COLMAP_OPENCV_FISHEYE = 5,
+    COLMAP_FULL_OPENCV = 6,
+    COLMAP_FOV = 7
+};
+
+/// Colmap's kInvalidPoint3DId, for the 2D points without 3D point
+const std::uint64_t colmapInvalidPoint3DId = std::numeric_limits<std::uint64_t>::max();
+
+/**
+ * @brief Open an output file of the Colmap scene.
+ * @throws std::runtime_error if the file cannot be created.
+ */
+std::ofstream openColmapFile(const std::string& filename, const std::string& description, bool binary)
+{
+    std::ofstream outfile(filename, binary ? std::ios::out | std::ios::binary : std::ios::out);
+    if (!outfile)
+    {
+        ALICEVISION_LOG_ERROR("Unable to create the " << description << " file " << filename);
+        throw std::runtime_error("Unable to create the " + description + " file " + filename);
+    }
+    return outfile;
+}
+
+/// Write a value in a Colmap binary file (little endian, as on all the supported platforms)
+template<typename T>
+void writeBinary(std::ostream& stream, const T& value)
+{
+    stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+/**
+ * @return the index of the 2D point of the view observing the landmark (its POINT2D_IDX in the Colmap files)
+ */
+std::uint32_t getPoint2DIndex(const std::vector<ColmapPoint2D>& points2D, IndexT landmarkId)
+{
+    const auto it = std::lower_bound(
+      points2D.begin(), points2D.end(), landmarkId, [](const ColmapPoint2D& point, IndexT id) { return point.landmarkId < id; });
+    return static_cast<std::uint32_t>(std::distance(points2D.begin(), it));
+}
+
+}  // namespace
+
 const std::set<camera::EINTRINSIC>& colmapCompatibleIntrinsics()
 {
     static const std::set<camera::EINTRINSIC> compatibleIntrinsics{camera::PINHOLE_CAMERA,
@@ -208,6 +263,54 @@ std::string convertIntrinsicsToColmapString(const IndexT intrinsicsID, std::shar
     return intrString.str();
 }
 
+void convertIntrinsicsToColmapModel(const camera::IntrinsicBase& intrinsic, int& modelId, std::vector<double>& params)
+{
+    const camera::EINTRINSIC intrinsicType = intrinsic.getType();
+    if (!isColmapCompatible(intrinsicType))
+    {
+        throw std::invalid_argument("The intrinsics " + EINTRINSIC_enumToString(intrinsicType) + " are not supported in Colmap");
+    }
+
+    // same conversions as convertIntrinsicsToColmapString
+    const camera::Pinhole& pinhole = dynamic_cast<const camera::Pinhole&>(intrinsic);
+    const std::vector<double> intrinsicParams = pinhole.getParams();
+    params = {pinhole.getFocalLengthPixX(), pinhole.getFocalLengthPixY(), pinhole.getPrincipalPoint().x(), pinhole.getPrincipalPoint().y()};
+
+    switch (intrinsicType)
+    {
+        case camera::PINHOLE_CAMERA:
+            // Parameters: fx, fy, cx, cy
+            modelId = COLMAP_PINHOLE;
+            break;
+        case camera::PINHOLE_CAMERA_RADIAL1:
+            // Parameters: fx, fy, cx, cy, k1, k2, p1, p2, k3, k4, k5, k6
+            modelId = COLMAP_FULL_OPENCV;
+            params.insert(params.end(), {intrinsicParams.at(4), 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0});
+            break;
+        case camera::PINHOLE_CAMERA_RADIAL3:
+            modelId = COLMAP_FULL_OPENCV;
+            params.insert(params.end(), {intrinsicParams.at(4), intrinsicParams.at(5), 0.0, 0.0, intrinsicParams.at(6), 0.0, 0.0, 0.0});
+            break;
+        case camera::PINHOLE_CAMERA_BROWN:
+            modelId = COLMAP_FULL_OPENCV;
+            params.insert(params.end(),
+                          {intrinsicParams.at(4), intrinsicParams.at(5), intrinsicParams.at(7), intrinsicParams.at(8), intrinsicParams.at(6), 0.0, 0.0, 0.0});
+            break;
+        case camera::PINHOLE_CAMERA_FISHEYE:
+            // Parameters: fx, fy, cx, cy, k1, k2, k3, k4
+            modelId = COLMAP_OPENCV_FISHEYE;
+            params.insert(params.end(), {intrinsicParams.at(4), intrinsicParams.at(5), intrinsicParams.at(6), intrinsicParams.at(7)});
+            break;
+        case camera::PINHOLE_CAMERA_FISHEYE1:
+            // Parameters: fx, fy, cx, cy, omega
+            modelId = COLMAP_FOV;
+            params.push_back(intrinsicParams.at(4));
+            break;
+        default:
+            throw std::invalid_argument("The intrinsics " + EINTRINSIC_enumToString(intrinsicType) + " are not supported in Colmap");
+    }
+}
+
 void generateColmapCamerasTxtFile(const sfmData::SfMData& sfmData, const std::string& filename)
 {
     // Adapted from Colmap Reconstruction::WriteCamerasText()
@@ -215,13 +318,7 @@ void generateColmapCamerasTxtFile(const sfmData::SfMData& sfmData, const std::st
     static const std::string camerasHeader = "# Camera list with one line of data per camera:\n"
                                              "#   CAMERA_ID, MODEL, WIDTH, HEIGHT, PARAMS[]\n";
 
-    std::ofstream outfile(filename);
-
-    if (!outfile)
-    {
-        ALICEVISION_LOG_ERROR("Unable to create the cameras file " << filename);
-        throw std::runtime_error("Unable to create the cameras file " + filename);
-    }
+    std::ofstream outfile = openColmapFile(filename, "cameras", false);
 
     outfile << camerasHeader;
     outfile << "# Number of cameras: " << sfmData.getIntrinsics().size() << "\n";
@@ -240,9 +337,39 @@ void generateColmapCamerasTxtFile(const sfmData::SfMData& sfmData, const std::st
     }
 }
 
+void generateColmapCamerasBinFile(const sfmData::SfMData& sfmData, const std::string& filename)
+{
+    // Adapted from Colmap Reconstruction::WriteCamerasBinary()
+    std::ofstream outfile = openColmapFile(filename, "cameras", true);
+
+    const std::uint64_t nbCameras = std::count_if(sfmData.getIntrinsics().begin(), sfmData.getIntrinsics().end(), [](const auto& iter) {
+        return isColmapCompatible(iter.second->getType());
+    });
+    writeBinary(outfile, nbCameras);
+
+    int modelId;
+    std::vector<double> params;
+    for (const auto& iter : sfmData.getIntrinsics())
+    {
+        const camera::IntrinsicBase& intrinsic = *iter.second;
+        if (!isColmapCompatible(intrinsic.getType()))
+            continue;
+
+        convertIntrinsicsToColmapModel(intrinsic, modelId, params);
+        writeBinary(outfile, static_cast<std::uint32_t>(iter.first));
+        writeBinary(outfile, static_cast<std::int32_t>(modelId));
+        writeBinary(outfile, static_cast<std::uint64_t>(intrinsic.w()));
+        writeBinary(outfile, static_cast<std::uint64_t>(intrinsic.h()));
+        for (const double param : params)
+            writeBinary(outfile, param);
+    }
+}
+
 PerViewVisibility computePerViewVisibility(const sfmData::SfMData& sfmData, const CompatibleList& viewSelections)
 {
     PerViewVisibility perCameraVisibility;
+    for (const IndexT viewID : viewSelections)
+        perCameraVisibility[viewID];
 
     for (const auto& land : sfmData.getLandmarks())
     {
@@ -251,20 +378,28 @@ PerViewVisibility computePerViewVisibility(const sfmData::SfMData& sfmData, cons
 
         for (const auto& iter : observations)
         {
-            const IndexT viewID = iter.first;
-            const auto& obs = iter.second;
-
-            if (viewSelections.find(viewID) != viewSelections.end())
+            const auto it = perCameraVisibility.find(iter.first);
+            if (it != perCameraVisibility.end())
             {
                 // for the current viewID add the feature point and its associate 3D point's ID
-                perCameraVisibility[viewID][landID] = obs.x;
+                const Vec2& x = iter.second.x;
+                it->second.push_back({x.x(), x.y(), landID});
             }
         }
     }
+
+    // the index of a 2D point in its view is found by binary search on the landmark IDs
+    for (auto& iter : perCameraVisibility)
+    {
+        std::sort(iter.second.begin(), iter.second.end(), [](const ColmapPoint2D& a, const ColmapPoint2D& b) { return a.landmarkId < b.landmarkId; });
+    }
     return perCameraVisibility;
 }
 
-void generateColmapImagesTxtFile(const sfmData::SfMData& sfmData, const CompatibleList& viewSelections, const std::string& filename)
+void generateColmapImagesTxtFile(const sfmData::SfMData& sfmData,
+                                 const CompatibleList& viewSelections,
+                                 const PerViewVisibility& perViewVisibility,
+                                 const std::string& filename)
 {
     // adapted from Colmap's Reconstruction::WriteImagesText()
     // An images.txt file has the following format
@@ -272,21 +407,12 @@ void generateColmapImagesTxtFile(const sfmData::SfMData& sfmData, const Compatib
                                            "#   IMAGE_ID, QW, QX, QY, QZ, TX, TY, TZ, CAMERA_ID, NAME\n"
                                            "#   POINTS2D[] as (X, Y, POINT3D_ID)\n";
 
-    std::ofstream outfile(filename);
+    std::ofstream outfile = openColmapFile(filename, "image", false);
 
-    if (!outfile)
-    {
-        ALICEVISION_LOG_ERROR("Unable to create the image file " << filename);
-        throw std::runtime_error("Unable to create the image file " + filename);
-    }
     // Ensure no loss of precision by storing in text.
     outfile.precision(17);
     outfile << imageHeader;
 
-    // colmap requires per-camera visibility rather per-landmark, so for each camera we need to create the relevant
-    // visibility list
-    const auto perViewVisibility = computePerViewVisibility(sfmData, viewSelections);
-
     // for each view to export add a line with the pose and the intrinsics ID and another with point visibility
     for (const auto& iter : sfmData.getViews())
     {
@@ -312,41 +438,104 @@ void generateColmapImagesTxtFile(const sfmData::SfMData& sfmData, const Compatib
         outfile << viewID << " " << quat.w() << " " << quat.x() << " " << quat.y() << " " << quat.z() << " " << tra[0] << " " << tra[1] << " "
                 << tra[2] << " " << intrID << " " << imageFilename << "\n";
 
-        for (const auto& obs : perViewVisibility.at(viewID))
+        for (const ColmapPoint2D& point : perViewVisibility.at(viewID))
         {
-            const auto& id = obs.first;
-            const auto& pts = obs.second;
-            outfile << pts.x() << " " << pts.y() << " " << id << " ";
+            outfile << point.x << " " << point.y << " " << point.landmarkId << " ";
         }
         outfile << "\n";
     }
 }
 
-void copyImagesFromSfmData(const sfmData::SfMData& sfmData, const std::string& destinationFolder, const CompatibleList selection)
+void generateColmapImagesBinFile(const sfmData::SfMData& sfmData,
+                                 const CompatibleList& viewSelections,
+                                 const PerViewVisibility& perViewVisibility,
+                                 const std::string& filename)
 {
-    for (const auto viewId : selection)
+    // adapted from Colmap's Reconstruction::WriteImagesBinary()
+    std::ofstream outfile = openColmapFile(filename, "image", true);
+
+    const std::uint64_t nbImages = std::count_if(sfmData.getViews().begin(), sfmData.getViews().end(), [&](const auto& iter) {
+        return viewSelections.count(iter.first) > 0;
+    });
+    writeBinary(outfile, nbImages);
+
+    for (const auto& iter : sfmData.getViews())
     {
-        const auto& view = sfmData.getView(viewId);
-        const auto& from = fs::path(view.getImage().getImagePath());
-        const auto& to = fs::path(destinationFolder) / from.filename();
-        fs::copy_file(from, to);
+        const auto view = iter.second.get();
+        const auto viewID = view->getViewId();
+
+        if (viewSelections.find(viewID) == viewSelections.end())
+        {
+            continue;
+        }
+
+        const std::string imageFilename = fs::path(view->getImage().getImagePath()).filename().string();
+        const auto pose = sfmData.getPose(*view).getTransform();
+        const Eigen::Quaterniond quat(pose.rotation());
+        const Vec3 tra = pose.translation();
+
+        writeBinary(outfile, static_cast<std::uint32_t>(viewID));
+        writeBinary(outfile, quat.w());
+        writeBinary(outfile, quat.x());
+        writeBinary(outfile, quat.y());
+        writeBinary(outfile, quat.z());
+        writeBinary(outfile, tra[0]);
+        writeBinary(outfile, tra[1]);
+        writeBinary(outfile, tra[2]);
+        writeBinary(outfile, static_cast<std::uint32_t>(view->getIntrinsicId()));
+        outfile.write(imageFilename.c_str(), imageFilename.size() + 1);  // null terminated
+
+        const std::vector<ColmapPoint2D>& points2D = perViewVisibility.at(viewID);
+        writeBinary(outfile, static_cast<std::uint64_t>(points2D.size()));
+        for (const ColmapPoint2D& point : points2D)
+        {
+            writeBinary(outfile, point.x);
+            writeBinary(outfile, point.y);
+            writeBinary(outfile, point.landmarkId == UndefinedIndexT ? colmapInvalidPoint3DId : static_cast<std::uint64_t>(point.landmarkId));
+        }
     }
 }
 
-void generateColmapPoints3DTxtFile(const sfmData::SfMData& sfmData, const CompatibleList& viewSelections, const std::string& filename)
+void copyImagesFromSfmData(const sfmData::SfMData& sfmData, const std::string& destinationFolder, const CompatibleList& selection, bool symlinkImages)
+{
+    const std::vector<IndexT> viewIds(selection.begin(), selection.end());
+    std::atomic<int> nbErrors{0};
+
+#pragma omp parallel for
+    for (int i = 0; i < static_cast<int>(viewIds.size()); ++i)
+    {
+        const auto& view = sfmData.getView(viewIds[i]);
+        const fs::path from = fs::absolute(view.getImage().getImagePath());
+        const fs::path to = fs::path(destinationFolder) / from.filename();
+
+        boost::system::error_code ec;
+        if (symlinkImages)
+            fs::create_symlink(from, to, ec);
+        else
+            fs::copy_file(from, to, ec);
+
+        if (ec)
+        {
+            ALICEVISION_LOG_ERROR("Unable to " << (symlinkImages ? "link" : "copy") << " the image " << from << " to " << to << ": " << ec.message());
+            ++nbErrors;
+        }
+    }
+
+    if (nbErrors > 0)
+        throw std::runtime_error("Unable to export " + std::to_string(nbErrors) + " images to " + destinationFolder);
+}
+
+void generateColmapPoints3DTxtFile(const sfmData::SfMData& sfmData,
+                                   const CompatibleList& viewSelections,
+                                   const PerViewVisibility& perViewVisibility,
+                                   const std::string& filename)
 {
     // adapted from Colmap's Reconstruction::WritePoints3DText()
     // The points3D.txt file has the following header
     static const std::string points3dHeader = "# 3D point list with one line of data per point:\n"
                                               "#   POINT3D_ID, X, Y, Z, R, G, B, ERROR, TRACK[] as (IMAGE_ID, POINT2D_IDX)\n";
 
-    std::ofstream outfile(filename);
-
-    if (!outfile)
-    {
-        ALICEVISION_LOG_ERROR("Unable to create the 3D point file " << filename);
-        throw std::runtime_error("Unable to create the 3D point file " + filename);
-    }
+    std::ofstream outfile = openColmapFile(filename, "3D point", false);
 
     outfile << points3dHeader;
     // default reprojection error (not used)
@@ -365,22 +554,79 @@ void generateColmapPoints3DTxtFile(const sfmData::SfMData& sfmData, const Compat
         for (const auto& itObs : iter.second.observations)
         {
             const IndexT viewId = itObs.first;
-            const IndexT featId = itObs.second.id_feat;
+            const auto itView = perViewVisibility.find(viewId);
 
-            if (viewSelections.find(viewId) != viewSelections.end())
+            if (itView != perViewVisibility.end())
             {
-                outfile << " " << viewId << " " << featId;
+                // POINT2D_IDX is the index of the observation in the POINTS2D of the image
+                outfile << " " << viewId << " " << getPoint2DIndex(itView->second, id);
             }
         }
         outfile << "\n";
     }
 }
 
-void generateColmapSceneFiles(const sfmData::SfMData& sfmData, const CompatibleList& viewsSelection, const ColmapConfig& colmapParams)
+void generateColmapPoints3DBinFile(const sfmData::SfMData& sfmData,
+                                   const CompatibleList& viewSelections,
+                                   const PerViewVisibility& perViewVisibility,
+                                   const std::string& filename)
 {
+    // adapted from Colmap's Reconstruction::WritePoints3DBinary()
+    std::ofstream outfile = openColmapFile(filename, "3D point", true);
+
+    writeBinary(outfile, static_cast<std::uint64_t>(sfmData.getLandmarks().size()));
+
+    // default reprojection error (not used)
+    const double defaultError{-1.0};
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> track;
+
+    for (const auto& iter : sfmData.getLandmarks())
+    {
+        const IndexT id = iter.first;
+        const Vec3& exportPoint = iter.second.X;
+        const auto& pointColor = iter.second.rgb;
+
+        track.clear();
+        for (const auto& itObs : iter.second.observations)
+        {
+            const auto itView = perViewVisibility.find(itObs.first);
+            if (itView != perViewVisibility.end())
+                track.emplace_back(static_cast<std::uint32_t>(itObs.first), getPoint2DIndex(itView->second, id));
+        }
+
+        writeBinary(outfile, static_cast<std::uint64_t>(id));
+        writeBinary(outfile, exportPoint.x());
+        writeBinary(outfile, exportPoint.y());
+        writeBinary(outfile, exportPoint.z());
+        writeBinary(outfile, static_cast<std::uint8_t>(pointColor.r()));
+        writeBinary(outfile, static_cast<std::uint8_t>(pointColor.g()));
+        writeBinary(outfile, static_cast<std::uint8_t>(pointColor.b()));
+        writeBinary(outfile, defaultError);
+        writeBinary(outfile, static_cast<std::uint64_t>(track.size()));
+        for (const auto& element : track)
+        {
+            writeBinary(outfile, element.first);
+            writeBinary(outfile, element.second);
+        }
+    }
+}
+
+void generateColmapSceneFiles(const sfmData::SfMData& sfmData, const CompatibleList& viewsSelection, const ColmapConfig& colmapParams, bool binary)
+{
+    // colmap requires per-camera visibility rather per-landmark, so for each camera we need to create the relevant
+    // visibility list, shared by the images and the points files
+    const PerViewVisibility perViewVisibility = computePerViewVisibility(sfmData, viewsSelection);
+
     generateColmapCamerasTxtFile(sfmData, colmapParams._camerasTxtPath);
-    generateColmapImagesTxtFile(sfmData, viewsSelection, colmapParams._imagesTxtPath);
-    generateColmapPoints3DTxtFile(sfmData, viewsSelection, colmapParams._points3DPath);
+    generateColmapImagesTxtFile(sfmData, viewsSelection, perViewVisibility, colmapParams._imagesTxtPath);
+    generateColmapPoints3DTxtFile(sfmData, viewsSelection, perViewVisibility, colmapParams._points3DPath);
+
+    if (binary)
+    {
+        generateColmapCamerasBinFile(sfmData, colmapParams._camerasBinPath);
+        generateColmapImagesBinFile(sfmData, viewsSelection, perViewVisibility, colmapParams._imagesBinPath);
+        generateColmapPoints3DBinFile(sfmData, viewsSelection, perViewVisibility, colmapParams._points3DBinPath);
+    }
 }
 
 void create_directories(const std::string& directory)
@@ -393,7 +639,7 @@ void create_directories(const std::string& directory)
     }
 }
 
-void convertToColmapScene(const sfmData::SfMData& sfmData, const std::string& colmapBaseDir, bool copyImages)
+void convertToColmapScene(const sfmData::SfMData& sfmData, const std::string& colmapBaseDir, bool copyImages, bool symlinkImages, bool binary)
 {
     // retrieve the views that are compatible with Colmap and that can be exported
     const auto views2export = getColmapCompatibleViews(sfmData);
@@ -416,12 +662,12 @@ void convertToColmapScene(const sfmData::SfMData& sfmData, const std::string& co
 
     if (copyImages)
     {
-        ALICEVISION_LOG_INFO("Copying source images...");
-        copyImagesFromSfmData(sfmData, colmapParams._imagesDirectory, views2export);
+        ALICEVISION_LOG_INFO((symlinkImages ? "Linking" : "Copying") << " source images...");
+        copyImagesFromSfmData(sfmData, colmapParams._imagesDirectory, views2export, symlinkImages);
     }
 
     ALICEVISION_LOG_INFO("Generating Colmap files...");
-    generateColmapSceneFiles(sfmData, views2export, colmapParams);
+    generateColmapSceneFiles(sfmData, views2export, colmapParams, binary);
 }
 
 }  // namespace sfmDataIO
@@ -10,9 +10,11 @@
 #include <aliceVision/sfmData/SfMData.hpp>
 #include <aliceVision/types.hpp>
 
+#include <map>
 #include <string>
 #include <set>
 #include <unordered_set>
+#include <vector>
 
 namespace aliceVision {
 namespace sfmDataIO {
@@ -44,6 +46,12 @@ struct ColmapConfig
     std::string _imagesTxtPath{};
     /// the full path for the points3d.txt file
     std::string _points3DPath{};
+    /// the full path for the cameras.bin file
+    std::string _camerasBinPath{};
+    /// the full path for the images.bin file
+    std::string _imagesBinPath{};
+    /// the full path for the points3D.bin file
+    std::string _points3DBinPath{};
 };
 
 /**
@@ -82,6 +90,15 @@ CompatibleList getColmapCompatibleViews(const sfmData::SfMData& sfmData);
  */
 std::string convertIntrinsicsToColmapString(const IndexT intrinsicsID, std::shared_ptr<camera::IntrinsicBase> intrinsic);
 
+/**
+ * @brief Convert the given intrinsic to the equivalent Colmap camera model, as stored in a cameras.bin file.
+ * @param[in] intrinsic the intrinsics.
+ * @param[out] modelId the ID of the Colmap camera model.
+ * @param[out] params the parameters of the Colmap camera model.
+ * @throws std::invalid_argument if the intrinsic is not compatible with Colmap.
+ */
+void convertIntrinsicsToColmapModel(const camera::IntrinsicBase& intrinsic, int& modelId, std::vector<double>& params);
+
 /**
  * @brief Given the sfmData it generates the equivalent cameras.txt file with the Colmap compatible cameras.
  * @param[in] sfmData the input sfmData.
@@ -89,8 +106,23 @@ std::string convertIntrinsicsToColmapString(const IndexT intrinsicsID, std::shar
  */
 void generateColmapCamerasTxtFile(const sfmData::SfMData& sfmData, const std::string& filename);
 
-/// map< viewID, map<landmarkID, pt2d>>
-using PerViewVisibility = std::map<IndexT, std::map<IndexT, Vec2>>;
+/**
+ * @brief Given the sfmData it generates the equivalent cameras.bin file with the Colmap compatible cameras.
+ * @param[in] sfmData the input sfmData.
+ * @param[in] filename the filename where to save the Colmap's scene (usually a cameras.bin)
+ */
+void generateColmapCamerasBinFile(const sfmData::SfMData& sfmData, const std::string& filename);
+
+/// 2D point of a view observing a 3D point
+struct ColmapPoint2D
+{
+    double x;
+    double y;
+    IndexT landmarkId;
+};
+
+/// map< viewID, 2D points sorted by landmarkID >, the index of a 2D point is its POINT2D_IDX in the Colmap files
+using PerViewVisibility = std::map<IndexT, std::vector<ColmapPoint2D>>;
 
 /**
  * @brief Given an sfm scene and a selection of its views, it computes the visibility of the 3D points per each view:
@@ -106,27 +138,66 @@ PerViewVisibility computePerViewVisibility(const sfmData::SfMData& sfmData, cons
  * file for Colmap scene.
  * @param[in] sfmData  the input scene.
  * @param[in] viewSelections  a selection of view IDs that have compatible intrinsics with Colmap.
+ * @param[in] perViewVisibility the visibility of the 3D points for each selected view (see computePerViewVisibility)
  * @param[in] filename the filename where to save the scene (usually a images.txt file)
  */
-void generateColmapImagesTxtFile(const sfmData::SfMData& sfmData, const CompatibleList& viewSelections, const std::string& filename);
+void generateColmapImagesTxtFile(const sfmData::SfMData& sfmData,
+                                 const CompatibleList& viewSelections,
+                                 const PerViewVisibility& perViewVisibility,
+                                 const std::string& filename);
+
+/**
+ * @brief Given an sfm scene and a selection of its views that are compatible with Colmap, it generates the images.bin
+ * file for Colmap scene.
+ * @param[in] sfmData  the input scene.
+ * @param[in] viewSelections  a selection of view IDs that have compatible intrinsics with Colmap.
+ * @param[in] perViewVisibility the visibility of the 3D points for each selected view (see computePerViewVisibility)
+ * @param[in] filename the filename where to save the scene (usually a images.bin file)
+ */
+void generateColmapImagesBinFile(const sfmData::SfMData& sfmData,
+                                 const CompatibleList& viewSelections,
+                                 const PerViewVisibility& perViewVisibility,
+                                 const std::string& filename);
 
 /**
  * @brief Given an sfm scene and a selection of its views that are compatible with Colmap, it copies the source images to
- * the given directory.
+ * the given directory. The images are copied in parallel.
  * @param[in] sfmData the input scene.
  * @param[in] destinationFolder the folder where to copy the images.
  * @param[in] selection  a selection of view IDs that have compatible intrinsics with Colmap.
+ * @param[in] symlinkImages create symbolic links to the source images instead of copying them.
+ * @throws std::runtime_error if an image cannot be copied.
  */
-void copyImagesFromSfmData(const sfmData::SfMData& sfmData, const std::string& destinationFolder, const CompatibleList selection);
+void copyImagesFromSfmData(const sfmData::SfMData& sfmData,
+                           const std::string& destinationFolder,
+                           const CompatibleList& selection,
+                           bool symlinkImages = false);
 
 /**
  * @brief Given an sfm scene and a selection of its views that are compatible with Colmap, it generates the points3d.txt
  * file for Colmap scene.
  * @param[in] sfmData the input scene.
  * @param[in] viewSelections a selection of view IDs that have compatible intrinsics with Colmap.
+ * @param[in] perViewVisibility the visibility of the 3D points for each selected view (see computePerViewVisibility)
  * @param[in] filename the filename where to save the points (usually a points3d.txt file)
  */
-void generateColmapPoints3DTxtFile(const sfmData::SfMData& sfmData, const CompatibleList& viewSelections, const std::string& filename);
+void generateColmapPoints3DTxtFile(const sfmData::SfMData& sfmData,
+                                   const CompatibleList& viewSelections,
+                                   const PerViewVisibility& perViewVisibility,
+                                   const std::string& filename);
+
+/**
+ * @brief Given an sfm scene and a selection of its views that are compatible with Colmap, it generates the points3D.bin
+ * file for Colmap scene.
+ * @param[in] sfmData the input scene.
+ * @param[in] viewSelections a selection of view IDs that have compatible intrinsics with Colmap.
+ * @param[in] perViewVisibility the visibility of the 3D points for each selected view (see computePerViewVisibility)
+ * @param[in] filename the filename where to save the points (usually a points3D.bin file)
+ */
+void generateColmapPoints3DBinFile(const sfmData::SfMData& sfmData,
+                                   const CompatibleList& viewSelections,
+                                   const PerViewVisibility& perViewVisibility,
+                                   const std::string& filename);
 
 /**
  * @brief Given an sfm scene and a selection of its views that are compatible with Colmap, it generates all the Colmap
@@ -134,8 +205,12 @@ void generateColmapPoints3DTxtFile(const sfmData::SfMData& sfmData, const Compat
  * @param sfmData the input scene.
  * @param viewsSelection a selection of view IDs that have compatible intrinsics with Colmap.
  * @param colmapParams the configuration data for the Colmap scene.
+ * @param binary also generate the binary files (cameras.bin, images.bin and points3D.bin).
  */
-void generateColmapSceneFiles(const sfmData::SfMData& sfmData, const CompatibleList& viewsSelection, const ColmapConfig& colmapParams);
+void generateColmapSceneFiles(const sfmData::SfMData& sfmData,
+                              const CompatibleList& viewsSelection,
+                              const ColmapConfig& colmapParams,
+                              bool binary = false);
 
 /**
  * @brief iven an sfm scene it generate the folder structure and all the files in Colmap format.
@@ -144,8 +219,14 @@ void generateColmapSceneFiles(const sfmData::SfMData& sfmData, const CompatibleL
  * @param copyImages enable copying the source image into the Colmap scene folder. This can be set to false when the
  * sfmData scene contains images from a single directory: in this case copy can be skipped and the first undistort step
  * of Colmap's MVS process can be called directly on the source folder without copying the images.
+ * @param symlinkImages create symbolic links to the source images instead of copying them (if copyImages is enabled).
+ * @param binary also generate the binary files (cameras.bin, images.bin and points3D.bin).
  */
-void convertToColmapScene(const sfmData::SfMData& sfmData, const std::string& colmapBaseDir, bool copyImages);
+void convertToColmapScene(const sfmData::SfMData& sfmData,
+                          const std::string& colmapBaseDir,
+                          bool copyImages,
+                          bool symlinkImages = false,
+                          bool binary = false);
 
 }  // namespace sfmDataIO
 }  // namespace aliceVision
\ No newline at end of file
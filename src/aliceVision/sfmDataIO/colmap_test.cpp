@@ -149,4 +149,66 @@ BOOST_AUTO_TEST_CASE(colmap_convertIntrinsicsToColmapString)
             BOOST_CHECK(sfmDataIO::isColmapCompatible(sfmTest.getIntrinsics().at(intrID)->getType()));
         }
     }
-}
\ No newline at end of file
+}
+BOOST_AUTO_TEST_CASE(colmap_convertIntrinsicsToColmapModel)
+{
+    int modelId = -1;
+    std::vector<double> params;
+
+    const auto brown = camera::createPinhole(
+      camera::EINTRINSIC::PINHOLE_CAMERA_BROWN, 1920, 1080, 1548.76, 1547.32, 992.36, 549.54, {-0.02078, 0.1705, -0.00714, 0.00134, -0.000542});
+    sfmDataIO::convertIntrinsicsToColmapModel(*brown, modelId, params);
+    // FULL_OPENCV, same parameters as in the text file
+    BOOST_CHECK_EQUAL(modelId, 6);
+    const std::vector<double> brownRef{1548.76, 1547.32, 1952.36, 1089.54, -0.02078, 0.1705, 0.00134, -0.000542, -0.00714, 0, 0, 0};
+    BOOST_REQUIRE_EQUAL(params.size(), brownRef.size());
+    for (std::size_t i = 0; i < params.size(); ++i)
+        BOOST_CHECK_CLOSE(params[i], brownRef[i], 1e-9);
+
+    const auto fisheye1 = camera::createPinhole(camera::EINTRINSIC::PINHOLE_CAMERA_FISHEYE1, 1920, 1080, 1548.76, 1547.32, 992.36, 549.54, {-0.000542});
+    sfmDataIO::convertIntrinsicsToColmapModel(*fisheye1, modelId, params);
+    // FOV
+    BOOST_CHECK_EQUAL(modelId, 7);
+    BOOST_CHECK_EQUAL(params.size(), 5);
+
+    const auto equidistant = camera::createEquidistant(camera::EINTRINSIC::EQUIDISTANT_CAMERA, 1920, 1080, 1548.76, 549.54, -0.02078);
+    BOOST_CHECK_THROW(sfmDataIO::convertIntrinsicsToColmapModel(*equidistant, modelId, params), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(colmap_computePerViewVisibility)
+{
+    sfmData::SfMData sfmTest{};
+    sfmTest.getIntrinsics().emplace(0, camera::createPinhole(camera::EINTRINSIC::PINHOLE_CAMERA, 1920, 1080, 1548.76, 1547.32, 0., 0.));
+    for (IndexT viewId = 0; viewId < 3; ++viewId)
+    {
+        sfmTest.getViews().emplace(viewId, std::make_shared<sfmData::View>("", viewId, 0, viewId));
+        sfmTest.getPoses().emplace(viewId, sfmData::CameraPose());
+    }
+
+    // landmarks observed by views 0 and 1, view 2 observes nothing
+    for (IndexT landmarkId : {7, 3, 5})
+    {
+        sfmData::Landmark landmark;
+        landmark.observations[0] = sfmData::Observation(Vec2(landmarkId, 0.), landmarkId * 10, 1.);
+        if (landmarkId != 5)
+            landmark.observations[1] = sfmData::Observation(Vec2(0., landmarkId), landmarkId * 10, 1.);
+        sfmTest.getLandmarks().emplace(landmarkId, landmark);
+    }
+
+    const auto visibility = sfmDataIO::computePerViewVisibility(sfmTest, {0, 1, 2});
+    BOOST_REQUIRE_EQUAL(visibility.size(), 3);
+    BOOST_CHECK(visibility.at(2).empty());
+
+    // the 2D points are sorted by landmark, their index is the POINT2D_IDX of the Colmap files
+    const std::vector<sfmDataIO::ColmapPoint2D>& points0 = visibility.at(0);
+    BOOST_REQUIRE_EQUAL(points0.size(), 3);
+    BOOST_CHECK_EQUAL(points0[0].landmarkId, 3);
+    BOOST_CHECK_EQUAL(points0[1].landmarkId, 5);
+    BOOST_CHECK_EQUAL(points0[2].landmarkId, 7);
+    BOOST_CHECK_EQUAL(points0[2].x, 7.);
+
+    const std::vector<sfmDataIO::ColmapPoint2D>& points1 = visibility.at(1);
+    BOOST_REQUIRE_EQUAL(points1.size(), 2);
+    BOOST_CHECK_EQUAL(points1[1].landmarkId, 7);
+    BOOST_CHECK_EQUAL(points1[1].y, 7.);
+}
@@ -593,7 +593,8 @@ bool loadJSON(sfmData::SfMData& sfmData,
               ESfMData partFlag,
               bool incompleteViews,
               EViewIdMethod viewIdMethod,
-              const std::string& viewIdRegex)
+              const std::string& viewIdRegex,
+              int maxConcurrentReads)
 {
     Version version;
 
@@ -650,16 +651,14 @@ bool loadJSON(sfmData::SfMData& sfmData,
 
         if (incompleteViews)
         {
-            auto children = fileTree.get_child("views");
-            // update incomplete views
-#pragma omp parallel for
-            for (int index = 0; index < children.size(); index++)
-            {
-                auto it = children.begin();
-                std::advance(it, index);
+            bpt::ptree& viewsTree = fileTree.get_child("views");
+            std::vector<std::shared_ptr<sfmData::View>> incompleteViewsList;
+            incompleteViewsList.reserve(viewsTree.size());
 
+            for (bpt::ptree::value_type& viewNode : viewsTree)
+            {
                 auto view = std::make_shared<sfmData::View>();
-                loadView(*view, it->second);
+                loadView(*view, viewNode.second);
 
                 // if we have the intrinsics and the view has an valid associated intrinsics
                 // update the width and height field of View (they are mirrored)
@@ -678,13 +677,14 @@ bool loadJSON(sfmData::SfMData& sfmData,
                     view->getImage().setWidth(intrinsics->w());
                     view->getImage().setHeight(intrinsics->h());
                 }
-                updateIncompleteView(*view, viewIdMethod, viewIdRegex);
-
-#pragma omp critical
-                {
-                    views.emplace(view->getViewId(), view);
-                }
+                incompleteViewsList.push_back(view);
             }
+
+            // update incomplete views, reading the image headers concurrently
+            updateIncompleteViews(incompleteViewsList, viewIdMethod, viewIdRegex, maxConcurrentReads);
+
+            for (const auto& view : incompleteViewsList)
+                views.emplace(view->getViewId(), view);
         }
         else
         {
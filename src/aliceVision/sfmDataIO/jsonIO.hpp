@@ -228,6 +228,7 @@ bool saveJSON(const sfmData::SfMData& sfmData, const std::string& filename, ESfM
  * @param[in] incompleteViews If true, try to load incomplete views
  * @param[in] viewIdMethod ViewId generation method to use if incompleteViews is true
  * @param[in] viewIdRegex Optional regex used when viewIdMethod is FILENAME
+ * @param[in] maxConcurrentReads Maximum number of image headers read concurrently for the incomplete views, 0 for automatic
  * @return true if completed
  */
 bool loadJSON(sfmData::SfMData& sfmData,
@@ -235,7 +236,8 @@ bool loadJSON(sfmData::SfMData& sfmData,
               ESfMData partFlag,
               bool incompleteViews = false,
               EViewIdMethod viewIdMethod = EViewIdMethod::METADATA,
-              const std::string& viewIdRegex = "");
+              const std::string& viewIdRegex = "",
+              int maxConcurrentReads = 0);
 
 }  // namespace sfmDataIO
 }  // namespace aliceVision
@@ -6,13 +6,62 @@
 // You can obtain one at https://mozilla.org/MPL/2.0/.
 
 #include "plyIO.hpp"
+#include <aliceVision/alicevision_omp.hpp>
 
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
 #include <fstream>
 #include <iostream>
+#include <sstream>
+#include <vector>
 
 namespace aliceVision {
 namespace sfmDataIO {
 
+namespace {
+
+/// number of points encoded by a task
+constexpr std::size_t pointsPerChunk = 1 << 16;
+
+/**
+ * @brief Encode the vertices of a range of landmarks.
+ * @param[out] chunk the encoded vertices
+ * @param[in] landmarks the landmarks to save
+ * @param[in] first the first landmark of the range
+ * @param[in] last the end of the range
+ * @param[in] binary true for the binary_little_endian format, else ASCII
+ */
+void encodePoints(std::string& chunk, const std::vector<const sfmData::Landmark*>& landmarks, std::size_t first, std::size_t last, bool binary)
+{
+    if (binary)
+    {
+        constexpr std::size_t pointSize = sizeof(float) * 3 + sizeof(std::uint8_t) * 3;
+        chunk.resize((last - first) * pointSize);
+        char* data = &chunk[0];
+        for (std::size_t i = first; i < last; ++i)
+        {
+            const sfmData::Landmark& landmark = *landmarks[i];
+            const Vec3f point = landmark.X.cast<float>();
+            std::memcpy(data, point.data(), sizeof(float) * 3);
+            std::memcpy(data + sizeof(float) * 3, &landmark.rgb, sizeof(std::uint8_t) * 3);
+            data += pointSize;
+        }
+        return;
+    }
+
+    std::ostringstream os;
+    for (std::size_t i = first; i < last; ++i)
+    {
+        const sfmData::Landmark& landmark = *landmarks[i];
+        os << landmark.X(0) << " " << landmark.X(1) << " " << landmark.X(2) << " " << (int)landmark.rgb.r() << " " << (int)landmark.rgb.g() << " "
+           << (int)landmark.rgb.b() << "\n";
+    }
+    chunk = os.str();
+}
+
+}  // namespace
+
 bool savePLY(const sfmData::SfMData& sfmData, const std::string& filename, ESfMData partFlag)
 {
     const bool b_structure = (partFlag & STRUCTURE) == STRUCTURE;
@@ -80,21 +129,30 @@ bool savePLY(const sfmData::SfMData& sfmData, const std::string& filename, ESfMD
         {
             const sfmData::Landmarks& landmarks = sfmData.getLandmarks();
 
-            for (sfmData::Landmarks::const_iterator iterLandmarks = landmarks.begin(); iterLandmarks != landmarks.end(); ++iterLandmarks)
+            std::vector<const sfmData::Landmark*> landmarksToSave;
+            landmarksToSave.reserve(landmarks.size());
+            for (const auto& landmarkPair : landmarks)
+                landmarksToSave.push_back(&landmarkPair.second);
+
+            // encode batches of chunks of points in parallel, then write them in order
+            const std::size_t nbChunks = (landmarksToSave.size() + pointsPerChunk - 1) / pointsPerChunk;
+            const std::size_t chunksPerBatch = 4 * static_cast<std::size_t>(std::max(1, omp_get_max_threads()));
+            std::vector<std::string> chunks(std::min(nbChunks, chunksPerBatch));
 
+            for (std::size_t batchFirst = 0; batchFirst < nbChunks && stream.good(); batchFirst += chunksPerBatch)
             {
-                const auto& landmark = iterLandmarks->second;
-                if (b_binary)
-                {
-                    Vec3f point = landmark.X.cast<float>();
-                    stream.write(reinterpret_cast<const char*>(&point), sizeof(float) * 3);
-                    stream.write(reinterpret_cast<const char*>(&landmark.rgb), sizeof(uint8_t) * 3);
-                }
-                else
+                const std::size_t batchSize = std::min(chunksPerBatch, nbChunks - batchFirst);
+
+#pragma omp parallel for schedule(dynamic)
+                for (std::int64_t c = 0; c < static_cast<std::int64_t>(batchSize); ++c)
                 {
-                    stream << landmark.X.transpose() << " " << (int)landmark.rgb.r() << " " << (int)landmark.rgb.g() << " " << (int)landmark.rgb.b()
-                           << "\n";
+                    const std::size_t first = (batchFirst + c) * pointsPerChunk;
+                    const std::size_t last = std::min(first + pointsPerChunk, landmarksToSave.size());
+                    encodePoints(chunks[c], landmarksToSave, first, last, b_binary);
                 }
+
+                for (std::size_t c = 0; c < batchSize; ++c)
+                    stream.write(chunks[c].data(), static_cast<std::streamsize>(chunks[c].size()));
             }
         }
         stream.flush();
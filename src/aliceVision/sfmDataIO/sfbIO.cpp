@@ -0,0 +1,667 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2023 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "sfbIO.hpp"
+#include <aliceVision/sfmDataIO/jsonIO.hpp>
+#include <aliceVision/system/Logger.hpp>
+#include <aliceVision/alicevision_omp.hpp>
+
+#include <boost/property_tree/json_parser.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+namespace aliceVision {
+namespace sfmDataIO {
+
+namespace {
+
+/// File header of the binary SfMData format (followed by the section table)
+struct SfbFileHeader
+{
+    static constexpr char magicValue[8] = {'A', 'V', 'S', 'F', 'M', 'B', '\0', '\0'};
+    static constexpr std::uint32_t currentVersion = 1;
+
+    char magic[8];
+    std::uint32_t formatVersion;
+    std::uint32_t nbSections;
+    std::int32_t sfmDataVersion[3];  //< ALICEVISION_SFMDATAIO_VERSION of the JSON sections
+    std::uint32_t partFlag;          //< ESfMData flags used on save
+};
+static_assert(sizeof(SfbFileHeader) == 32, "Unexpected SFB header size");
+
+constexpr char SfbFileHeader::magicValue[8];
+
+enum class ESfbSection : std::uint32_t
+{
+    FOLDERS = 0,
+    VIEWS = 1,
+    INTRINSICS = 2,
+    POSES = 3,
+    RIGS = 4,
+    STRUCTURE = 5
+};
+
+/// Entry of the section table: offset is relative to the beginning of the file
+struct SfbSectionEntry
+{
+    std::uint32_t type;
+    std::uint32_t reserved;
+    std::uint64_t offset;
+    std::uint64_t size;
+};
+static_assert(sizeof(SfbSectionEntry) == 24, "Unexpected SFB section entry size");
+
+/// Number of landmarks per independently decodable chunk of the structure section
+constexpr std::size_t landmarksPerChunk = 16384;
+
+/// Structure section flags
+constexpr std::uint8_t structureHasObservations = 1;
+constexpr std::uint8_t structureHasFeatures = 2;
+
+using Buffer = std::vector<char>;
+
+template<typename T>
+void writeValue(Buffer& buffer, const T& value)
+{
+    const char* ptr = reinterpret_cast<const char*>(&value);
+    buffer.insert(buffer.end(), ptr, ptr + sizeof(T));
+}
+
+void writeString(Buffer& buffer, const std::string& str)
+{
+    writeValue(buffer, static_cast<std::uint32_t>(str.size()));
+    buffer.insert(buffer.end(), str.begin(), str.end());
+}
+
+/// Bounds-checked reader over a memory buffer
+class BufferReader
+{
+  public:
+    BufferReader(const char* begin, const char* end)
+      : _cur(begin),
+        _end(end)
+    {}
+
+    template<typename T>
+    T read()
+    {
+        T value;
+        readRaw(&value, sizeof(T));
+        return value;
+    }
+
+    std::string readString()
+    {
+        const std::uint32_t size = read<std::uint32_t>();
+        std::string str(size, '\0');
+        readRaw(&str[0], size);
+        return str;
+    }
+
+    void readRaw(void* dst, std::size_t size)
+    {
+        if (static_cast<std::size_t>(_end - _cur) < size)
+            throw std::runtime_error("Corrupted SFB file: unexpected end of section.");
+        std::memcpy(dst, _cur, size);
+        _cur += size;
+    }
+
+  private:
+    const char* _cur;
+    const char* _end;
+};
+
+void writeJsonSection(Buffer& buffer, const bpt::ptree& tree)
+{
+    std::ostringstream os;
+    bpt::write_json(os, tree, false);
+    const std::string str = os.str();
+    buffer.insert(buffer.end(), str.begin(), str.end());
+}
+
+void readJsonSection(const Buffer& buffer, bpt::ptree& tree)
+{
+    std::istringstream is(std::string(buffer.begin(), buffer.end()));
+    bpt::read_json(is, tree);
+}
+
+void encodeLandmarks(Buffer& buffer,
+                     const sfmData::Landmarks& landmarks,
+                     const std::vector<IndexT>& landmarkIds,
+                     std::size_t first,
+                     std::size_t last,
+                     const std::vector<feature::EImageDescriberType>& descTypes,
+                     bool saveObservations,
+                     bool saveFeatures)
+{
+    for (std::size_t i = first; i < last; ++i)
+    {
+        const sfmData::Landmark& landmark = landmarks.at(landmarkIds[i]);
+        const auto descTypeIt = std::find(descTypes.begin(), descTypes.end(), landmark.descType);
+
+        writeValue(buffer, static_cast<std::uint32_t>(landmarkIds[i]));
+        writeValue(buffer, static_cast<std::uint8_t>(std::distance(descTypes.begin(), descTypeIt)));
+        writeValue(buffer, landmark.rgb.r());
+        writeValue(buffer, landmark.rgb.g());
+        writeValue(buffer, landmark.rgb.b());
+        for (int d = 0; d < 3; ++d)
+            writeValue(buffer, landmark.X(d));
+
+        if (!saveObservations)
+            continue;
+
+        writeValue(buffer, static_cast<std::uint32_t>(landmark.observations.size()));
+        for (const auto& obsPair : landmark.observations)
+        {
+            writeValue(buffer, static_cast<std::uint32_t>(obsPair.first));
+            if (saveFeatures)
+            {
+                const sfmData::Observation& observation = obsPair.second;
+                writeValue(buffer, static_cast<std::uint32_t>(observation.id_feat));
+                writeValue(buffer, observation.x(0));
+                writeValue(buffer, observation.x(1));
+                writeValue(buffer, observation.scale);
+            }
+        }
+    }
+}
+
+void decodeLandmarks(BufferReader& reader,
+                     std::size_t nbLandmarks,
+                     const std::vector<feature::EImageDescriberType>& descTypes,
+                     bool hasObservations,
+                     bool hasFeatures,
+                     bool loadObservations,
+                     bool loadFeatures,
+                     std::vector<std::pair<IndexT, sfmData::Landmark>>& out)
+{
+    out.resize(nbLandmarks);
+    for (std::size_t i = 0; i < nbLandmarks; ++i)
+    {
+        IndexT& landmarkId = out[i].first;
+        sfmData::Landmark& landmark = out[i].second;
+
+        landmarkId = reader.read<std::uint32_t>();
+        const std::uint8_t descTypeIndex = reader.read<std::uint8_t>();
+        if (descTypeIndex >= descTypes.size())
+            throw std::runtime_error("Corrupted SFB file: invalid describer type index.");
+        landmark.descType = descTypes[descTypeIndex];
+        landmark.rgb.r() = reader.read<unsigned char>();
+        landmark.rgb.g() = reader.read<unsigned char>();
+        landmark.rgb.b() = reader.read<unsigned char>();
+        for (int d = 0; d < 3; ++d)
+            landmark.X(d) = reader.read<double>();
+
+        if (!hasObservations)
+            continue;
+
+        const std::uint32_t nbObservations = reader.read<std::uint32_t>();
+        if (loadObservations)
+            landmark.observations.reserve(nbObservations);
+
+        for (std::uint32_t o = 0; o < nbObservations; ++o)
+        {
+            const IndexT viewId = reader.read<std::uint32_t>();
+            sfmData::Observation observation;
+            if (hasFeatures)
+            {
+                observation.id_feat = reader.read<std::uint32_t>();
+                observation.x(0) = reader.read<double>();
+                observation.x(1) = reader.read<double>();
+                observation.scale = reader.read<double>();
+            }
+            if (!loadObservations)
+                continue;
+            if (!loadFeatures)
+                observation = sfmData::Observation();
+            // observations are saved by increasing view id
+            landmark.observations.emplace_hint(landmark.observations.end(), viewId, observation);
+        }
+    }
+}
+
+void saveStructureSection(Buffer& buffer, const sfmData::Landmarks& landmarks, bool saveObservations, bool saveFeatures)
+{
+    std::vector<IndexT> landmarkIds;
+    landmarkIds.reserve(landmarks.size());
+    std::vector<feature::EImageDescriberType> descTypes;
+    for (const auto& landmarkPair : landmarks)
+    {
+        landmarkIds.push_back(landmarkPair.first);
+        if (std::find(descTypes.begin(), descTypes.end(), landmarkPair.second.descType) == descTypes.end())
+            descTypes.push_back(landmarkPair.second.descType);
+    }
+    std::sort(landmarkIds.begin(), landmarkIds.end());
+
+    if (descTypes.size() > std::numeric_limits<std::uint8_t>::max())
+        throw std::runtime_error("Too many describer types for the SFB format.");
+
+    // encode chunks of landmarks in parallel
+    const std::size_t nbChunks = (landmarkIds.size() + landmarksPerChunk - 1) / landmarksPerChunk;
+    std::vector<Buffer> chunks(nbChunks);
+
+#pragma omp parallel for schedule(dynamic)
+    for (std::int64_t c = 0; c < static_cast<std::int64_t>(nbChunks); ++c)
+    {
+        const std::size_t first = c * landmarksPerChunk;
+        const std::size_t last = std::min(first + landmarksPerChunk, landmarkIds.size());
+        encodeLandmarks(chunks[c], landmarks, landmarkIds, first, last, descTypes, saveObservations, saveFeatures);
+    }
+
+    // section layout: flags, describer types, chunk table {offset (relative to the section), nbLandmarks}, chunks
+    std::uint8_t flags = 0;
+    if (saveObservations)
+        flags |= structureHasObservations;
+    if (saveFeatures)
+        flags |= structureHasFeatures;
+    writeValue(buffer, flags);
+
+    writeValue(buffer, static_cast<std::uint8_t>(descTypes.size()));
+    for (const feature::EImageDescriberType descType : descTypes)
+        writeString(buffer, feature::EImageDescriberType_enumToString(descType));
+
+    writeValue(buffer, static_cast<std::uint64_t>(landmarkIds.size()));
+    writeValue(buffer, static_cast<std::uint64_t>(nbChunks));
+
+    std::uint64_t chunkOffset = buffer.size() + nbChunks * 2 * sizeof(std::uint64_t);
+    for (std::size_t c = 0; c < nbChunks; ++c)
+    {
+        const std::size_t first = c * landmarksPerChunk;
+        writeValue(buffer, chunkOffset);
+        writeValue(buffer, static_cast<std::uint64_t>(std::min(landmarksPerChunk, landmarkIds.size() - first)));
+        chunkOffset += chunks[c].size();
+    }
+
+    buffer.reserve(chunkOffset);
+    for (Buffer& chunk : chunks)
+    {
+        buffer.insert(buffer.end(), chunk.begin(), chunk.end());
+        Buffer().swap(chunk);
+    }
+}
+
+void loadStructureSection(const Buffer& buffer, sfmData::Landmarks& landmarks, bool loadObservations, bool loadFeatures)
+{
+    BufferReader reader(buffer.data(), buffer.data() + buffer.size());
+
+    const std::uint8_t flags = reader.read<std::uint8_t>();
+    const bool hasObservations = flags & structureHasObservations;
+    const bool hasFeatures = flags & structureHasFeatures;
+
+    std::vector<feature::EImageDescriberType> descTypes(reader.read<std::uint8_t>());
+    for (feature::EImageDescriberType& descType : descTypes)
+        descType = feature::EImageDescriberType_stringToEnum(reader.readString());
+
+    const std::uint64_t nbLandmarks = reader.read<std::uint64_t>();
+    const std::uint64_t nbChunks = reader.read<std::uint64_t>();
+
+    std::vector<std::pair<std::uint64_t, std::uint64_t>> chunkTable(nbChunks);
+    for (auto& chunk : chunkTable)
+    {
+        chunk.first = reader.read<std::uint64_t>();
+        chunk.second = reader.read<std::uint64_t>();
+        if (chunk.first > buffer.size())
+            throw std::runtime_error("Corrupted SFB file: invalid structure chunk offset.");
+    }
+
+    // decode chunks of landmarks in parallel
+    std::vector<std::vector<std::pair<IndexT, sfmData::Landmark>>> decoded(nbChunks);
+    std::string error;
+
+#pragma omp parallel for schedule(dynamic)
+    for (std::int64_t c = 0; c < static_cast<std::int64_t>(nbChunks); ++c)
+    {
+        try
+        {
+            const char* chunkEnd = (c + 1 < nbChunks) ? buffer.data() + chunkTable[c + 1].first : buffer.data() + buffer.size();
+            BufferReader chunkReader(buffer.data() + chunkTable[c].first, chunkEnd);
+            decodeLandmarks(chunkReader, chunkTable[c].second, descTypes, hasObservations, hasFeatures, loadObservations, loadFeatures, decoded[c]);
+        }
+        catch (const std::exception& e)
+        {
+#pragma omp critical
+            error = e.what();
+        }
+    }
+
+    if (!error.empty())
+        throw std::runtime_error(error);
+
+    if (loadObservations && !hasObservations)
+        ALICEVISION_LOG_WARNING("The SFB file has been saved without observations.");
+
+    for (auto& chunk : decoded)
+    {
+        for (auto& landmarkPair : chunk)
+            landmarks.emplace(landmarkPair.first, std::move(landmarkPair.second));
+        chunk.clear();
+        chunk.shrink_to_fit();
+    }
+
+    if (landmarks.size() < nbLandmarks)
+        ALICEVISION_LOG_WARNING("SFB structure: " << nbLandmarks - landmarks.size() << " duplicated landmark ids ignored.");
+}
+
+void savePosesSection(Buffer& buffer, const sfmData::Poses& poses)
+{
+    writeValue(buffer, static_cast<std::uint64_t>(poses.size()));
+    for (const auto& posePair : poses)
+    {
+        const geometry::Pose3& transform = posePair.second.getTransform();
+        writeValue(buffer, static_cast<std::uint32_t>(posePair.first));
+        const Mat3& rotation = transform.rotation();
+        const Vec3 center = transform.center();
+        for (int i = 0; i < 9; ++i)
+            writeValue(buffer, rotation(i));
+        for (int i = 0; i < 3; ++i)
+            writeValue(buffer, center(i));
+        writeValue(buffer, static_cast<std::uint8_t>(posePair.second.isLocked()));
+    }
+}
+
+void loadPosesSection(const Buffer& buffer, sfmData::Poses& poses)
+{
+    BufferReader reader(buffer.data(), buffer.data() + buffer.size());
+    const std::uint64_t nbPoses = reader.read<std::uint64_t>();
+    for (std::uint64_t p = 0; p < nbPoses; ++p)
+    {
+        const IndexT poseId = reader.read<std::uint32_t>();
+        Mat3 rotation;
+        Vec3 center;
+        for (int i = 0; i < 9; ++i)
+            rotation(i) = reader.read<double>();
+        for (int i = 0; i < 3; ++i)
+            center(i) = reader.read<double>();
+        const bool locked = reader.read<std::uint8_t>() != 0;
+        poses.emplace(poseId, sfmData::CameraPose(geometry::Pose3(rotation, center), locked));
+    }
+}
+
+}  // namespace
+
+bool saveSFB(const sfmData::SfMData& sfmData, const std::string& filename, ESfMData partFlag)
+{
+    // save flags
+    const bool saveViews = (partFlag & VIEWS) == VIEWS;
+    const bool saveIntrinsics = (partFlag & INTRINSICS) == INTRINSICS;
+    const bool saveExtrinsics = (partFlag & EXTRINSICS) == EXTRINSICS;
+    const bool saveStructure = (partFlag & STRUCTURE) == STRUCTURE;
+    const bool saveFeatures = (partFlag & OBSERVATIONS_WITH_FEATURES) == OBSERVATIONS_WITH_FEATURES;
+    const bool saveObservations = saveFeatures || ((partFlag & OBSERVATIONS) == OBSERVATIONS);
+
+    std::vector<std::pair<ESfbSection, Buffer>> sections;
+
+    // folders
+    {
+        bpt::ptree foldersTree;
+
+        if (!sfmData.getRelativeFeaturesFolders().empty())
+        {
+            bpt::ptree featureFoldersTree;
+            for (const std::string& featuresFolder : sfmData.getRelativeFeaturesFolders())
+            {
+                bpt::ptree featureFolderTree;
+                featureFolderTree.put("", featuresFolder);
+                featureFoldersTree.push_back(std::make_pair("", featureFolderTree));
+            }
+            foldersTree.add_child("featuresFolders", featureFoldersTree);
+        }
+
+        if (!sfmData.getRelativeMatchesFolders().empty())
+        {
+            bpt::ptree matchingFoldersTree;
+            for (const std::string& matchesFolder : sfmData.getRelativeMatchesFolders())
+            {
+                bpt::ptree matchingFolderTree;
+                matchingFolderTree.put("", matchesFolder);
+                matchingFoldersTree.push_back(std::make_pair("", matchingFolderTree));
+            }
+            foldersTree.add_child("matchesFolders", matchingFoldersTree);
+        }
+
+        if (!foldersTree.empty())
+        {
+            sections.emplace_back(ESfbSection::FOLDERS, Buffer());
+            writeJsonSection(sections.back().second, foldersTree);
+        }
+    }
+
+    // views
+    if (saveViews && !sfmData.getViews().empty())
+    {
+        bpt::ptree viewsTree;
+        for (const auto& viewPair : sfmData.getViews())
+            saveView("", *(viewPair.second), viewsTree);
+
+        bpt::ptree sectionTree;
+        sectionTree.add_child("views", viewsTree);
+        sections.emplace_back(ESfbSection::VIEWS, Buffer());
+        writeJsonSection(sections.back().second, sectionTree);
+    }
+
+    // intrinsics
+    if (saveIntrinsics && !sfmData.getIntrinsics().empty())
+    {
+        bpt::ptree intrinsicsTree;
+        for (const auto& intrinsicPair : sfmData.getIntrinsics())
+            saveIntrinsic("", intrinsicPair.first, intrinsicPair.second, intrinsicsTree);
+
+        bpt::ptree sectionTree;
+        sectionTree.add_child("intrinsics", intrinsicsTree);
+        sections.emplace_back(ESfbSection::INTRINSICS, Buffer());
+        writeJsonSection(sections.back().second, sectionTree);
+    }
+
+    // extrinsics
+    if (saveExtrinsics)
+    {
+        // poses
+        if (!sfmData.getPoses().empty())
+        {
+            sections.emplace_back(ESfbSection::POSES, Buffer());
+            savePosesSection(sections.back().second, sfmData.getPoses());
+        }
+
+        // rigs
+        if (!sfmData.getRigs().empty())
+        {
+            bpt::ptree rigsTree;
+            for (const auto& rigPair : sfmData.getRigs())
+                saveRig("", rigPair.first, rigPair.second, rigsTree);
+
+            bpt::ptree sectionTree;
+            sectionTree.add_child("rigs", rigsTree);
+            sections.emplace_back(ESfbSection::RIGS, Buffer());
+            writeJsonSection(sections.back().second, sectionTree);
+        }
+    }
+
+    // structure
+    if (saveStructure && !sfmData.getLandmarks().empty())
+    {
+        sections.emplace_back(ESfbSection::STRUCTURE, Buffer());
+        saveStructureSection(sections.back().second, sfmData.getLandmarks(), saveObservations, saveFeatures);
+    }
+
+    // header and section table
+    SfbFileHeader header;
+    std::memcpy(header.magic, SfbFileHeader::magicValue, sizeof(header.magic));
+    header.formatVersion = SfbFileHeader::currentVersion;
+    header.nbSections = static_cast<std::uint32_t>(sections.size());
+    header.sfmDataVersion[0] = ALICEVISION_SFMDATAIO_VERSION_MAJOR;
+    header.sfmDataVersion[1] = ALICEVISION_SFMDATAIO_VERSION_MINOR;
+    header.sfmDataVersion[2] = ALICEVISION_SFMDATAIO_VERSION_REVISION;
+    header.partFlag = static_cast<std::uint32_t>(partFlag);
+
+    std::vector<SfbSectionEntry> sectionTable;
+    std::uint64_t offset = sizeof(SfbFileHeader) + sections.size() * sizeof(SfbSectionEntry);
+    for (const auto& section : sections)
+    {
+        sectionTable.push_back({static_cast<std::uint32_t>(section.first), 0, offset, section.second.size()});
+        offset += section.second.size();
+    }
+
+    std::ofstream stream(filename, std::ios::out | std::ios::binary);
+    if (!stream.is_open())
+    {
+        ALICEVISION_LOG_ERROR("Unable to create the SFB file: '" << filename << "'.");
+        return false;
+    }
+
+    stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    if (!sectionTable.empty())
+        stream.write(reinterpret_cast<const char*>(sectionTable.data()), sectionTable.size() * sizeof(SfbSectionEntry));
+    for (const auto& section : sections)
+        stream.write(section.second.data(), section.second.size());
+
+    return stream.good();
+}
+
+bool loadSFB(sfmData::SfMData& sfmData, const std::string& filename, ESfMData partFlag)
+{
+    // load flags
+    const bool loadViews = (partFlag & VIEWS) == VIEWS;
+    const bool loadIntrinsics = (partFlag & INTRINSICS) == INTRINSICS;
+    const bool loadExtrinsics = (partFlag & EXTRINSICS) == EXTRINSICS;
+    const bool loadStructure = (partFlag & STRUCTURE) == STRUCTURE;
+    const bool loadFeatures = (partFlag & OBSERVATIONS_WITH_FEATURES) == OBSERVATIONS_WITH_FEATURES;
+    const bool loadObservations = loadFeatures || ((partFlag & OBSERVATIONS) == OBSERVATIONS);
+
+    std::ifstream stream(filename, std::ios::in | std::ios::binary);
+    if (!stream.is_open())
+    {
+        ALICEVISION_LOG_ERROR("Unable to open the SFB file: '" << filename << "'.");
+        return false;
+    }
+
+    SfbFileHeader header;
+    if (!stream.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+        std::memcmp(header.magic, SfbFileHeader::magicValue, sizeof(header.magic)) != 0)
+    {
+        ALICEVISION_LOG_ERROR("Invalid SFB file: '" << filename << "'.");
+        return false;
+    }
+    if (header.formatVersion > SfbFileHeader::currentVersion)
+    {
+        ALICEVISION_LOG_ERROR("Unsupported SFB file version " << header.formatVersion << ": '" << filename << "'.");
+        return false;
+    }
+
+    const Version version(header.sfmDataVersion[0], header.sfmDataVersion[1], header.sfmDataVersion[2]);
+
+    std::vector<SfbSectionEntry> sectionTable(header.nbSections);
+    if (header.nbSections > 0 && !stream.read(reinterpret_cast<char*>(sectionTable.data()), sectionTable.size() * sizeof(SfbSectionEntry)))
+    {
+        ALICEVISION_LOG_ERROR("Invalid SFB file section table: '" << filename << "'.");
+        return false;
+    }
+
+    const auto readSection = [&](ESfbSection type, Buffer& buffer) -> bool {
+        for (const SfbSectionEntry& entry : sectionTable)
+        {
+            if (entry.type != static_cast<std::uint32_t>(type))
+                continue;
+            buffer.resize(entry.size);
+            stream.seekg(entry.offset);
+            if (!stream.read(buffer.data(), entry.size))
+                throw std::runtime_error("Corrupted SFB file: unable to read section from '" + filename + "'.");
+            return true;
+        }
+        return false;
+    };
+
+    Buffer buffer;
+
+    // folders
+    if (readSection(ESfbSection::FOLDERS, buffer))
+    {
+        bpt::ptree foldersTree;
+        readJsonSection(buffer, foldersTree);
+
+        if (foldersTree.count("featuresFolders"))
+            for (bpt::ptree::value_type& featureFolderNode : foldersTree.get_child("featuresFolders"))
+                sfmData.addFeaturesFolder(featureFolderNode.second.get_value<std::string>());
+
+        if (foldersTree.count("matchesFolders"))
+            for (bpt::ptree::value_type& matchingFolderNode : foldersTree.get_child("matchesFolders"))
+                sfmData.addMatchesFolder(matchingFolderNode.second.get_value<std::string>());
+    }
+
+    // intrinsics
+    if (loadIntrinsics && readSection(ESfbSection::INTRINSICS, buffer))
+    {
+        bpt::ptree sectionTree;
+        readJsonSection(buffer, sectionTree);
+
+        sfmData::Intrinsics& intrinsics = sfmData.getIntrinsics();
+        for (bpt::ptree::value_type& intrinsicNode : sectionTree.get_child("intrinsics"))
+        {
+            IndexT intrinsicId;
+            std::shared_ptr<camera::IntrinsicBase> intrinsic;
+
+            loadIntrinsic(version, intrinsicId, intrinsic, intrinsicNode.second);
+
+            intrinsics.emplace(intrinsicId, intrinsic);
+        }
+    }
+
+    // views
+    if (loadViews && readSection(ESfbSection::VIEWS, buffer))
+    {
+        bpt::ptree sectionTree;
+        readJsonSection(buffer, sectionTree);
+
+        sfmData::Views& views = sfmData.getViews();
+        for (bpt::ptree::value_type& viewNode : sectionTree.get_child("views"))
+        {
+            auto view = std::make_shared<sfmData::View>();
+            loadView(*view, viewNode.second);
+            views.emplace(view->getViewId(), view);
+        }
+    }
+
+    // extrinsics
+    if (loadExtrinsics)
+    {
+        // poses
+        if (readSection(ESfbSection::POSES, buffer))
+            loadPosesSection(buffer, sfmData.getPoses());
+
+        // rigs
+        if (readSection(ESfbSection::RIGS, buffer))
+        {
+            bpt::ptree sectionTree;
+            readJsonSection(buffer, sectionTree);
+
+            sfmData::Rigs& rigs = sfmData.getRigs();
+            for (bpt::ptree::value_type& rigNode : sectionTree.get_child("rigs"))
+            {
+                IndexT rigId;
+                sfmData::Rig rig;
+
+                loadRig(rigId, rig, rigNode.second);
+
+                rigs.emplace(rigId, rig);
+            }
+        }
+    }
+
+    // structure
+    if (loadStructure && readSection(ESfbSection::STRUCTURE, buffer))
+        loadStructureSection(buffer, sfmData.getLandmarks(), loadObservations, loadFeatures);
+
+    return true;
+}
+
+}  // namespace sfmDataIO
+}  // namespace aliceVision
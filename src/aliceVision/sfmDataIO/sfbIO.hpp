@@ -0,0 +1,44 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2023 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <aliceVision/sfmDataIO/sfmDataIO.hpp>
+
+#include <string>
+
+namespace aliceVision {
+namespace sfmDataIO {
+
+/**
+ * @brief Save an SfMData in a binary SFB file.
+ *
+ * The file starts with a header and a table of sections (type, offset, size),
+ * so each part can be loaded without reading the others:
+ * - folders, views, intrinsics and rigs are stored as compact JSON (same content as the .sfm file)
+ * - poses are stored as raw binary values
+ * - structure is stored as raw binary values, split into independent chunks of landmarks
+ *   that are encoded and decoded in parallel
+ *
+ * @param[in] sfmData The input SfMData
+ * @param[in] filename The filename
+ * @param[in] partFlag The ESfMData save flag
+ * @return true if completed
+ */
+bool saveSFB(const sfmData::SfMData& sfmData, const std::string& filename, ESfMData partFlag);
+
+/**
+ * @brief Load a binary SFB SfMData file.
+ *        Only the sections required by \p partFlag are read from the file.
+ * @param[out] sfmData The output SfMData
+ * @param[in] filename The filename
+ * @param[in] partFlag The ESfMData load flag
+ * @return true if completed
+ */
+bool loadSFB(sfmData::SfMData& sfmData, const std::string& filename, ESfMData partFlag);
+
+}  // namespace sfmDataIO
+}  // namespace aliceVision
@@ -8,7 +8,9 @@
 #include "sfmDataIO.hpp"
 #include <aliceVision/config.hpp>
 #include <aliceVision/stl/mapUtils.hpp>
+#include <aliceVision/system/Profiler.hpp>
 #include <aliceVision/sfmDataIO/jsonIO.hpp>
+#include <aliceVision/sfmDataIO/sfbIO.hpp>
 #include <aliceVision/sfmDataIO/plyIO.hpp>
 #include <aliceVision/sfmDataIO/bafIO.hpp>
 #include <aliceVision/sfmDataIO/gtIO.hpp>
@@ -107,6 +109,7 @@ bool ValidIds(const sfmData::SfMData& sfmData, ESfMData partFlag)
 
 bool Load(sfmData::SfMData& sfmData, const std::string& filename, ESfMData partFlag)
 {
+    ALICEVISION_PROFILE_SCOPE("sfmDataIO::Load");
     const std::string extension = fs::extension(filename);
     bool status = false;
 
@@ -114,6 +117,10 @@ bool Load(sfmData::SfMData& sfmData, const std::string& filename, ESfMData partF
     {
         status = loadJSON(sfmData, filename, partFlag);
     }
+    else if (extension == ".sfb")  // Binary SfMData File
+    {
+        status = loadSFB(sfmData, filename, partFlag);
+    }
     else if (extension == ".abc")  // Alembic
     {
 #if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_ALEMBIC)
@@ -145,6 +152,7 @@ bool Load(sfmData::SfMData& sfmData, const std::string& filename, ESfMData partF
 
 bool Save(const sfmData::SfMData& sfmData, const std::string& filename, ESfMData partFlag)
 {
+    ALICEVISION_PROFILE_SCOPE("sfmDataIO::Save");
     const fs::path bPath = fs::path(filename);
     const std::string extension = bPath.extension().string();
     const std::string tmpPath = (bPath.parent_path() / bPath.stem()).string() + "." + fs::unique_path().string() + extension;
@@ -154,6 +162,10 @@ bool Save(const sfmData::SfMData& sfmData, const std::string& filename, ESfMData
     {
         status = saveJSON(sfmData, tmpPath, partFlag);
     }
+    else if (extension == ".sfb")  // Binary SfMData File
+    {
+        status = saveSFB(sfmData, tmpPath, partFlag);
+    }
     else if (extension == ".ply")  // Polygon File
     {
         status = savePLY(sfmData, tmpPath, partFlag);
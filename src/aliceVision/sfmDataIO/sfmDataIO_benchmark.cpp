@@ -0,0 +1,109 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <aliceVision/sfmData/SfMData.hpp>
+#include <aliceVision/sfmDataIO/sfmDataIO.hpp>
+#include <aliceVision/config.hpp>
+
+#include <boost/filesystem.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <sstream>
+#include <string>
+
+using namespace aliceVision;
+using namespace aliceVision::sfmDataIO;
+
+namespace fs = boost::filesystem;
+
+namespace {
+
+/**
+ * @brief Scene of nbViews views with their poses, one shared intrinsic and nbLandmarks landmarks seen by 5 views.
+ */
+sfmData::SfMData createScene(int nbViews, int nbLandmarks)
+{
+    sfmData::SfMData sfmData;
+
+    for (IndexT i = 0; i < static_cast<IndexT>(nbViews); ++i)
+    {
+        std::ostringstream os;
+        os << "dataset/" << i << ".jpg";
+        std::shared_ptr<sfmData::View> view = std::make_shared<sfmData::View>(os.str(), i, 0, i, 6000, 4000);
+        sfmData.getViews().emplace(i, view);
+        sfmData.setPose(*view, sfmData::CameraPose());
+    }
+    sfmData.getIntrinsics().emplace(0, std::make_shared<camera::Pinhole>(6000, 4000, 5000, 5000, 10, -20));
+
+    std::mt19937 generator(0);
+    std::uniform_real_distribution<double> positionDist(0.0, 4000.0);
+    std::uniform_int_distribution<IndexT> viewDist(0, nbViews - 1);
+
+    for (IndexT l = 0; l < static_cast<IndexT>(nbLandmarks); ++l)
+    {
+        sfmData::Landmark& landmark = sfmData.getLandmarks()[l];
+        landmark.X = Vec3(positionDist(generator), positionDist(generator), positionDist(generator));
+        landmark.descType = feature::EImageDescriberType::SIFT;
+        for (int o = 0; o < 5; ++o)
+            landmark.observations[viewDist(generator)] = sfmData::Observation(Vec2(positionDist(generator), positionDist(generator)), l, 1.0);
+    }
+
+    return sfmData;
+}
+
+/**
+ * @brief Save a scene of state.range(0) views and state.range(1) landmarks.
+ */
+void BM_SfMDataIO_save(benchmark::State& state, const std::string& extension)
+{
+    const sfmData::SfMData sfmData = createScene(static_cast<int>(state.range(0)), static_cast<int>(state.range(1)));
+    const std::string filename = (fs::temp_directory_path() / fs::unique_path("%%%%-%%%%." + extension)).string();
+
+    for (auto _ : state)
+    {
+        if (!Save(sfmData, filename, ESfMData::ALL))
+            state.SkipWithError("Cannot save the scene.");
+    }
+
+    state.SetBytesProcessed(state.iterations() * fs::file_size(filename));
+    fs::remove(filename);
+}
+
+/**
+ * @brief Load a scene of state.range(0) views and state.range(1) landmarks.
+ */
+void BM_SfMDataIO_load(benchmark::State& state, const std::string& extension)
+{
+    const std::string filename = (fs::temp_directory_path() / fs::unique_path("%%%%-%%%%." + extension)).string();
+    if (!Save(createScene(static_cast<int>(state.range(0)), static_cast<int>(state.range(1))), filename, ESfMData::ALL))
+    {
+        state.SkipWithError("Cannot save the scene.");
+        return;
+    }
+
+    for (auto _ : state)
+    {
+        sfmData::SfMData sfmData;
+        if (!Load(sfmData, filename, ESfMData::ALL))
+            state.SkipWithError("Cannot load the scene.");
+    }
+
+    state.SetBytesProcessed(state.iterations() * fs::file_size(filename));
+    fs::remove(filename);
+}
+
+}  // namespace
+
+BENCHMARK_CAPTURE(BM_SfMDataIO_save, sfm, std::string("sfm"))->Args({1000, 100000})->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_SfMDataIO_load, sfm, std::string("sfm"))->Args({1000, 100000})->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_SfMDataIO_save, sfb, std::string("sfb"))->Args({1000, 100000})->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_SfMDataIO_load, sfb, std::string("sfb"))->Args({1000, 100000})->Unit(benchmark::kMillisecond);
+#if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_ALEMBIC)
+BENCHMARK_CAPTURE(BM_SfMDataIO_save, abc, std::string("abc"))->Args({1000, 100000})->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_SfMDataIO_load, abc, std::string("abc"))->Args({1000, 100000})->Unit(benchmark::kMillisecond);
+#endif
@@ -71,7 +71,7 @@ sfmData::SfMData createTestScene(std::size_t viewsCount = 2, std::size_t observa
 
 BOOST_AUTO_TEST_CASE(SfMData_IO_SAVE_LOAD)
 {
-    std::vector<std::string> ext_Type = {"sfm", "json"};
+    std::vector<std::string> ext_Type = {"sfm", "json", "sfb"};
 
 #if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_ALEMBIC)
     ext_Type.push_back("abc");
@@ -227,3 +227,40 @@ BOOST_AUTO_TEST_CASE(SfMData_IO_SAVE_PLY)
         BOOST_CHECK(fs::is_regular_file(filename));
     }
 }
+
+BOOST_AUTO_TEST_CASE(SfMData_IO_SFB_STRUCTURE)
+{
+    const std::string filename = "SAVE_LOAD_STRUCTURE.sfb";
+
+    // enough landmarks to be split in several chunks
+    sfmData::SfMData sfmData = createTestScene(3, 3, true);
+    for (IndexT landmarkId = 1; landmarkId < 40000; ++landmarkId)
+    {
+        sfmData::Landmark& landmark = sfmData.getLandmarks()[landmarkId];
+        landmark.X = Vec3(landmarkId, -1.0 * landmarkId, 0.5);
+        landmark.descType = (landmarkId % 2) ? feature::EImageDescriberType::SIFT : feature::EImageDescriberType::AKAZE;
+        landmark.rgb = image::RGBColor(landmarkId % 255, 12, 34);
+        for (IndexT viewId = 0; viewId < 3; ++viewId)
+            landmark.observations[viewId] = sfmData::Observation(Vec2(viewId, landmarkId), landmarkId + viewId, 1.5);
+    }
+    BOOST_CHECK(Save(sfmData, filename, ALL));
+
+    BOOST_TEST_CONTEXT("LOAD (subparts: STRUCTURE | OBSERVATIONS_WITH_FEATURES)")
+    {
+        sfmData::SfMData sfmDataLoad;
+        BOOST_CHECK(Load(sfmDataLoad, filename, ESfMData(STRUCTURE | OBSERVATIONS_WITH_FEATURES)));
+        BOOST_CHECK_EQUAL(sfmDataLoad.getViews().size(), 0);
+        BOOST_CHECK_EQUAL(sfmDataLoad.getPoses().size(), 0);
+        BOOST_CHECK(sfmDataLoad.getLandmarks() == sfmData.getLandmarks());
+        BOOST_CHECK_EQUAL(sfmDataLoad.getLandmarks().at(42).observations.at(2).scale, 1.5);
+    }
+
+    BOOST_TEST_CONTEXT("LOAD (subparts: STRUCTURE without observations)")
+    {
+        sfmData::SfMData sfmDataLoad;
+        BOOST_CHECK(Load(sfmDataLoad, filename, ESfMData::STRUCTURE));
+        BOOST_CHECK_EQUAL(sfmDataLoad.getLandmarks().size(), sfmData.getLandmarks().size());
+        BOOST_CHECK(sfmDataLoad.getLandmarks().at(42).observations.empty());
+        BOOST_CHECK(sfmDataLoad.getLandmarks().at(42).X == sfmData.getLandmarks().at(42).X);
+    }
+}
@@ -12,8 +12,13 @@
 #include <aliceVision/image/io.hpp>
 #include "aliceVision/utils/filesIO.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
 #include <stdexcept>
 #include <regex>
+#include <thread>
 
 namespace fs = boost::filesystem;
 
@@ -108,6 +113,53 @@ void updateIncompleteView(sfmData::View& view, EViewIdMethod viewIdMethod, const
     }
 }
 
+void updateIncompleteViews(const std::vector<std::shared_ptr<sfmData::View>>& views,
+                           EViewIdMethod viewIdMethod,
+                           const std::string& viewIdRegex,
+                           int maxConcurrentReads)
+{
+    if (maxConcurrentReads <= 0)
+    {
+        // the threads mostly wait for the storage
+        maxConcurrentReads = std::max(16, 4 * static_cast<int>(std::thread::hardware_concurrency()));
+    }
+
+    const int nbViews = static_cast<int>(views.size());
+    const int nbReaders = std::min(maxConcurrentReads, nbViews);
+
+    std::atomic<int> nextIndex(0);
+    std::mutex errorMutex;
+    std::exception_ptr error;
+
+    const auto readViews = [&]() {
+        for (int i = nextIndex++; i < nbViews; i = nextIndex++)
+        {
+            try
+            {
+                updateIncompleteView(*views[i], viewIdMethod, viewIdRegex);
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(errorMutex);
+                if (!error)
+                    error = std::current_exception();
+                // skip the remaining views
+                nextIndex = nbViews;
+            }
+        }
+    };
+
+    std::vector<std::thread> readers;
+    readers.reserve(nbReaders);
+    for (int i = 0; i < nbReaders; ++i)
+        readers.emplace_back(readViews);
+    for (std::thread& reader : readers)
+        reader.join();
+
+    if (error)
+        std::rethrow_exception(error);
+}
+
 std::shared_ptr<camera::IntrinsicBase> getViewIntrinsic(const sfmData::View& view,
                                                         double mmFocalLength,
                                                         double sensorWidth,
@@ -14,6 +14,7 @@
 #include <aliceVision/sfmData/uid.hpp>
 
 #include <memory>
+#include <vector>
 
 namespace aliceVision {
 namespace sfmDataIO {
@@ -64,6 +65,20 @@ inline std::istream& operator>>(std::istream& in, EViewIdMethod& s)
  */
 void updateIncompleteView(sfmData::View& view, EViewIdMethod viewIdMethod = EViewIdMethod::METADATA, const std::string& viewIdRegex = "");
 
+/**
+ * @brief update incomplete views, reading the image headers concurrently
+ * @note The image reads are latency-bound on network storages, so there are more
+ *       concurrent reads than hardware threads. Rethrows the first error after all the reads.
+ * @param[in,out] views The given incomplete views, their order is kept
+ * @param[in] viewIdMethod ViewId generation method to use
+ * @param[in] viewIdRegex Optional regex used when viewIdMethod is FILENAME
+ * @param[in] maxConcurrentReads The maximum number of concurrent image reads, 0 for automatic
+ */
+void updateIncompleteViews(const std::vector<std::shared_ptr<sfmData::View>>& views,
+                           EViewIdMethod viewIdMethod = EViewIdMethod::METADATA,
+                           const std::string& viewIdRegex = "",
+                           int maxConcurrentReads = 0);
+
 /**
  * @brief create an intrinsic for the given View
  * @param[in] view The given view
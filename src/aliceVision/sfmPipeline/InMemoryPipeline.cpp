@@ -0,0 +1,124 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "InMemoryPipeline.hpp"
+#include <aliceVision/featureEngine/FeatureExtractor.hpp>
+#include <aliceVision/matching/matchesFiltering.hpp>
+#include <aliceVision/matchingImageCollection/GeometricFilter.hpp>
+#include <aliceVision/matchingImageCollection/matchingCommon.hpp>
+#include <aliceVision/system/Logger.hpp>
+
+namespace aliceVision {
+namespace sfmPipeline {
+
+void extractFeatures(const sfmData::SfMData& sfmData,
+                     const std::vector<std::shared_ptr<feature::ImageDescriber>>& imageDescribers,
+                     const HardwareContext& hContext,
+                     feature::RegionsPerView& out_regionsPerView,
+                     const std::string& outputFolder)
+{
+    featureEngine::FeatureExtractor extractor(sfmData);
+    extractor.setOutputFolder(outputFolder);
+    extractor.setOutputRegions(&out_regionsPerView);
+
+    for (std::shared_ptr<feature::ImageDescriber> imageDescriber : imageDescribers)
+        extractor.addImageDescriber(imageDescriber);
+
+    extractor.process(hContext);
+}
+
+void matchFeatures(const sfmData::SfMData& sfmData,
+                   const feature::RegionsPerView& regionsPerView,
+                   const PairSet& pairs,
+                   const std::vector<feature::EImageDescriberType>& describerTypes,
+                   const FeatureMatchingParams& params,
+                   std::mt19937& randomNumberGenerator,
+                   matching::PairwiseMatches& out_pairwiseMatches)
+{
+    out_pairwiseMatches.clear();
+
+    // photometric matching of the putative pairs
+    const std::unique_ptr<matchingImageCollection::IImageCollectionMatcher> imageCollectionMatcher =
+      matchingImageCollection::createImageCollectionMatcher(params.matcherType, params.distRatio, params.crossMatching);
+
+    matching::PairwiseMatches putativeMatches;
+    imageCollectionMatcher->Match(randomNumberGenerator, regionsPerView, pairs, describerTypes, putativeMatches);
+
+    matching::filterMatchesByMin2DMotion(putativeMatches, regionsPerView, params.minRequired2DMotion);
+
+    ALICEVISION_LOG_INFO(putativeMatches.size() << " putative image pair matches.");
+
+    if (putativeMatches.empty())
+        return;
+
+    // the seeds of the homographies growing are chosen in the putative matches order
+    if (params.geometricFilterType == matchingImageCollection::EGeometricFilterType::HOMOGRAPHY_GROWING)
+    {
+        for (auto& pairMatches : putativeMatches)
+        {
+            for (auto& descMatches : pairMatches.second)
+                matching::sortMatches_byDistanceRatio(descMatches.second);
+        }
+    }
+
+    // geometric filtering of the putative matches
+    matching::PairwiseMatches geometricMatches;
+    matchingImageCollection::geometricFiltering(geometricMatches,
+                                                &sfmData,
+                                                regionsPerView,
+                                                params.geometricFilterType,
+                                                params.geometricErrorMax,
+                                                params.maxIteration,
+                                                params.geometricEstimator,
+                                                putativeMatches,
+                                                randomNumberGenerator,
+                                                params.guidedMatching);
+
+    ALICEVISION_LOG_INFO(geometricMatches.size() << " geometric image pair matches.");
+
+    // grid filtering
+    matching::matchesGridFilteringForAllPairs(
+      geometricMatches, sfmData, regionsPerView, params.useGridSort, params.numMatchesToKeep, out_pairwiseMatches);
+}
+
+void getFeaturesPerView(const feature::RegionsPerView& regionsPerView, feature::FeaturesPerView& out_featuresPerView)
+{
+    for (const auto& viewRegions : regionsPerView.getData())
+    {
+        for (const auto& descRegions : viewRegions.second)
+            out_featuresPerView.addFeatures(viewRegions.first, descRegions.first, descRegions.second->GetRegionsPositions());
+    }
+}
+
+bool reconstruct(const sfmData::SfMData& sfmData,
+                 const feature::RegionsPerView& regionsPerView,
+                 const matching::PairwiseMatches& pairwiseMatches,
+                 const sfm::ReconstructionEngine_sequentialSfM::Params& params,
+                 const std::string& outputFolder,
+                 int randomSeed,
+                 sfmData::SfMData& out_sfmData)
+{
+    feature::FeaturesPerView featuresPerView;
+    getFeaturesPerView(regionsPerView, featuresPerView);
+
+    sfm::ReconstructionEngine_sequentialSfM sfmEngine(sfmData, params, outputFolder);
+    sfmEngine.initRandomSeed(randomSeed);
+    sfmEngine.setFeatures(&featuresPerView);
+    sfmEngine.setMatches(&pairwiseMatches);
+
+    if (!sfmEngine.process())
+    {
+        ALICEVISION_LOG_ERROR("The incremental reconstruction failed.");
+        return false;
+    }
+
+    sfmEngine.colorize();
+    out_sfmData = sfmEngine.getSfMData();
+    return true;
+}
+
+}  // namespace sfmPipeline
+}  // namespace aliceVision
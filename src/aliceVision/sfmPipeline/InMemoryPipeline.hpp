@@ -0,0 +1,122 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <aliceVision/types.hpp>
+#include <aliceVision/feature/FeaturesPerView.hpp>
+#include <aliceVision/feature/ImageDescriber.hpp>
+#include <aliceVision/feature/RegionsPerView.hpp>
+#include <aliceVision/matching/IndMatch.hpp>
+#include <aliceVision/matching/matcherType.hpp>
+#include <aliceVision/matchingImageCollection/GeometricFilterType.hpp>
+#include <aliceVision/robustEstimation/estimators.hpp>
+#include <aliceVision/sfm/pipeline/sequential/ReconstructionEngine_sequentialSfM.hpp>
+#include <aliceVision/sfmData/SfMData.hpp>
+#include <aliceVision/system/hardwareContext.hpp>
+
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace aliceVision {
+namespace sfmPipeline {
+
+/**
+ * In-memory chaining of the structure from motion stages:
+ * feature extraction -> feature matching -> geometric filtering -> incremental reconstruction.
+ *
+ * Each stage takes the in-memory outputs of the previous one (RegionsPerView, PairwiseMatches, SfMData),
+ * so a pipeline embedded in an application does not need any intermediate file.
+ * The outputs can still be written with the usual IO functions (feature::ImageDescriber::Save,
+ * matching::Save, sfmDataIO::Save) if needed.
+ */
+
+/**
+ * @brief Parameters of the feature matching stage, same as the featureMatching software.
+ */
+struct FeatureMatchingParams
+{
+    matching::EMatcherType matcherType = matching::EMatcherType::ANN_L2;
+    float distRatio = 0.8f;
+    bool crossMatching = false;
+    /// minimum 2D motion of the putative matches, disabled if negative
+    double minRequired2DMotion = -1.0;
+    matchingImageCollection::EGeometricFilterType geometricFilterType = matchingImageCollection::EGeometricFilterType::FUNDAMENTAL_MATRIX;
+    robustEstimation::ERobustEstimator geometricEstimator = robustEstimation::ERobustEstimator::ACRANSAC;
+    /// maximum error of the geometric model, 0 for the a contrario estimated threshold
+    double geometricErrorMax = 0.0;
+    int maxIteration = 2048;
+    bool guidedMatching = false;
+    bool useGridSort = true;
+    /// maximum number of matches per image pair and descriptor type, 0 to keep all of them
+    std::size_t numMatchesToKeep = 0;
+};
+
+/**
+ * @brief Extract the features of all the views.
+ * @note The extraction is the same as the featureExtraction software, see featureEngine::FeatureExtractor.
+ * @param[in] sfmData the views to extract
+ * @param[in] imageDescribers the image describers, with their parameters already set
+ * @param[in] hContext the hardware context of the extraction
+ * @param[out] out_regionsPerView the regions of each view and describer type
+ * @param[in] outputFolder the folder where the features are also written, no file is written if empty
+ */
+void extractFeatures(const sfmData::SfMData& sfmData,
+                     const std::vector<std::shared_ptr<feature::ImageDescriber>>& imageDescribers,
+                     const HardwareContext& hContext,
+                     feature::RegionsPerView& out_regionsPerView,
+                     const std::string& outputFolder = "");
+
+/**
+ * @brief Match the features of the given image pairs and keep the geometrically consistent matches.
+ * @note The matching is the same as the featureMatching software with unknown camera poses.
+ * @param[in] sfmData the views and their intrinsics
+ * @param[in] regionsPerView the regions of the views, see extractFeatures
+ * @param[in] pairs the image pairs to match, see matchingImageCollection::exhaustivePairs
+ * @param[in] describerTypes the describer types to match
+ * @param[in] params the matching parameters
+ * @param[in,out] randomNumberGenerator the random number generator of the matching and the robust estimation
+ * @param[out] out_pairwiseMatches the geometric matches of each image pair
+ */
+void matchFeatures(const sfmData::SfMData& sfmData,
+                   const feature::RegionsPerView& regionsPerView,
+                   const PairSet& pairs,
+                   const std::vector<feature::EImageDescriberType>& describerTypes,
+                   const FeatureMatchingParams& params,
+                   std::mt19937& randomNumberGenerator,
+                   matching::PairwiseMatches& out_pairwiseMatches);
+
+/**
+ * @brief Get the features of the regions of each view, without their descriptors.
+ * @param[in] regionsPerView the regions of the views
+ * @param[out] out_featuresPerView the features of the views
+ */
+void getFeaturesPerView(const feature::RegionsPerView& regionsPerView, feature::FeaturesPerView& out_featuresPerView);
+
+/**
+ * @brief Compute the cameras and the landmarks from the matches with the incremental reconstruction.
+ * @note The tracks are built from the matches by the reconstruction engine, see sfm::ReconstructionEngine_sequentialSfM.
+ * @param[in] sfmData the views and their intrinsics
+ * @param[in] regionsPerView the regions of the views, see extractFeatures
+ * @param[in] pairwiseMatches the geometric matches, see matchFeatures
+ * @param[in] params the reconstruction parameters
+ * @param[in] outputFolder the folder of the reconstruction statistics
+ * @param[in] randomSeed the seed of the reconstruction random number generator
+ * @param[out] out_sfmData the reconstruction
+ * @return false if the reconstruction failed
+ */
+bool reconstruct(const sfmData::SfMData& sfmData,
+                 const feature::RegionsPerView& regionsPerView,
+                 const matching::PairwiseMatches& pairwiseMatches,
+                 const sfm::ReconstructionEngine_sequentialSfM::Params& params,
+                 const std::string& outputFolder,
+                 int randomSeed,
+                 sfmData::SfMData& out_sfmData);
+
+}  // namespace sfmPipeline
+}  // namespace aliceVision
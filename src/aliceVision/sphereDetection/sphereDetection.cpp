@@ -7,7 +7,9 @@
 #include <aliceVision/sphereDetection/sphereDetection.hpp>
 
 // Standard libs
+#include <future>
 #include <iostream>
+#include <map>
 #include <numeric>
 
 // AliceVision image library
@@ -103,7 +105,16 @@ void modelExplore(Ort::Session& session)
     }
 }
 
-Prediction predict(Ort::Session& session, const fs::path imagePath, const float minScore)
+/**
+ * @brief Image read and converted to the network input layout (CHW, float in [0, 1])
+ */
+struct PreprocessedImage
+{
+    std::vector<float> tensor;
+    cv::Size size;
+};
+
+PreprocessedImage preprocessImage(const fs::path& imagePath)
 {
     // Read image
     image::Image<image::RGBColor> imageAlice;
@@ -112,27 +123,33 @@ Prediction predict(Ort::Session& session, const fs::path imagePath, const float
     // Eigen -> OpenCV
     cv::Mat imageOpencv;
     cv::eigen2cv(imageAlice.GetMat(), imageOpencv);
-    cv::Size imageOpencvShape = imageOpencv.size();
+
+    PreprocessedImage preprocessed;
+    preprocessed.size = imageOpencv.size();
 
     // uint8 -> float32
     imageOpencv.convertTo(imageOpencv, CV_32FC3, 1 / 255.0);
 
     // HWC to CHW
     cv::dnn::blobFromImage(imageOpencv, imageOpencv);
+    preprocessed.tensor.assign(imageOpencv.begin<float>(), imageOpencv.end<float>());
+
+    return preprocessed;
+}
 
-    // Inference on CPU
-    // TODO: use GPU
+Prediction predict(Ort::Session& session, PreprocessedImage& preprocessed, const float minScore)
+{
+    // The tensor lives in the host memory, ONNXRuntime copies it to the device of the execution provider
     Ort::MemoryInfo memoryInfo = Ort::MemoryInfo::CreateCpu(OrtAllocatorType::OrtArenaAllocator, OrtMemType::OrtMemTypeDefault);
 
     // Initialize input tensor
-    std::vector<int64_t> inputShape = {1, 3, imageAlice.Height(), imageAlice.Width()};
+    std::vector<int64_t> inputShape = {1, 3, preprocessed.size.height, preprocessed.size.width};
     const size_t inputSize = std::accumulate(begin(inputShape), end(inputShape), 1, std::multiplies<size_t>());
-    std::vector<float> inputTensor(inputSize);
-    inputTensor.assign(imageOpencv.begin<float>(), imageOpencv.end<float>());
 
     // Create input data
     std::vector<Ort::Value> inputData;
-    inputData.push_back(Ort::Value::CreateTensor<float>(memoryInfo, inputTensor.data(), inputSize, inputShape.data(), inputShape.size()));
+    inputData.push_back(
+      Ort::Value::CreateTensor<float>(memoryInfo, preprocessed.tensor.data(), inputSize, inputShape.data(), inputShape.size()));
 
     // Select inputs and outputs
     std::vector<const char*> inputNames{"input"};
@@ -172,25 +189,68 @@ Prediction predict(Ort::Session& session, const fs::path imagePath, const float
         }
     }
 
-    return Prediction{bboxes, scores, imageOpencvShape};
+    return Prediction{bboxes, scores, preprocessed.size};
 }
 
-void sphereDetection(const sfmData::SfMData& sfmData, Ort::Session& session, fs::path outputPath, const float minScore)
+void sphereDetection(const sfmData::SfMData& sfmData, Ort::Session& session, fs::path outputPath, const float minScore, bool detectOncePerPose)
 {
-    // Main tree
-    bpt::ptree fileTree;
+    // Views to process, with the view whose detection is used for each of them
+    std::vector<std::pair<IndexT, IndexT>> viewsDetection;
+    // Views on which the detection is run
+    std::vector<IndexT> detectedViews;
+    std::map<IndexT, IndexT> poseDetectedView;
 
-    for (auto& viewID : sfmData.getViews())
+    for (const auto& viewIt : sfmData.getViews())
     {
-        ALICEVISION_LOG_DEBUG("View Id: " << viewID);
-
-        const std::string sphereName = std::to_string(viewID.second->getViewId());
-        const fs::path imagePath = fs::path(sfmData.getView(viewID.second->getViewId()).getImage().getImagePath());
+        const sfmData::View& view = *viewIt.second;
+        const fs::path imagePath = fs::path(view.getImage().getImagePath());
 
         if (boost::algorithm::icontains(imagePath.stem().string(), "ambiant"))
             continue;
 
-        const auto pred = predict(session, imagePath, minScore);
+        IndexT detectedViewId = view.getViewId();
+        if (detectOncePerPose && view.getPoseId() != UndefinedIndexT)
+        {
+            // The camera is fixed for all the views of a pose: the first one is detected and its sphere is propagated
+            const auto poseIt = poseDetectedView.emplace(view.getPoseId(), view.getViewId()).first;
+            detectedViewId = poseIt->second;
+        }
+        if (detectedViewId == view.getViewId())
+            detectedViews.push_back(view.getViewId());
+        viewsDetection.emplace_back(view.getViewId(), detectedViewId);
+    }
+
+    ALICEVISION_LOG_INFO("Sphere detection on " << detectedViews.size() << " of " << viewsDetection.size() << " views.");
+
+    const auto getImagePath = [&sfmData](IndexT viewId) { return fs::path(sfmData.getView(viewId).getImage().getImagePath()); };
+
+    // The next image is read and preprocessed during the inference
+    std::map<IndexT, Prediction> predictions;
+    std::future<PreprocessedImage> nextImage;
+    if (!detectedViews.empty())
+    {
+        nextImage = std::async(std::launch::async, preprocessImage, getImagePath(detectedViews.front()));
+    }
+    for (std::size_t i = 0; i < detectedViews.size(); ++i)
+    {
+        ALICEVISION_LOG_DEBUG("View Id: " << detectedViews[i]);
+
+        PreprocessedImage preprocessed = nextImage.get();
+        if (i + 1 < detectedViews.size())
+        {
+            nextImage = std::async(std::launch::async, preprocessImage, getImagePath(detectedViews[i + 1]));
+        }
+
+        predictions.emplace(detectedViews[i], predict(session, preprocessed, minScore));
+    }
+
+    // Main tree
+    bpt::ptree fileTree;
+
+    for (const auto& viewDetection : viewsDetection)
+    {
+        const std::string sphereName = std::to_string(viewDetection.first);
+        const Prediction& pred = predictions.at(viewDetection.second);
 
         // If there is no bounding box, then no sphere has been detected
         if (pred.bboxes.size() > 0)
@@ -220,7 +280,7 @@ void sphereDetection(const sfmData::SfMData& sfmData, Ort::Session& session, fs:
         }
         else
         {
-            ALICEVISION_LOG_WARNING("No sphere detected for '" << imagePath << "'.");
+            ALICEVISION_LOG_WARNING("No sphere detected for '" << getImagePath(viewDetection.first) << "'.");
         }
     }
     bpt::write_json(outputPath.append("detection.json").string(), fileTree);
@@ -45,8 +45,13 @@ void modelExplore(Ort::Session& session);
  * @param session The ONNXRuntime session
  * @param outputPath The path to write the JSON with the detected spheres to
  * @return minScore The minimum score for the predictions
+ * @param detectOncePerPose Run the detection only on the first view of each pose (fixed camera) and use it for all its views
  */
-void sphereDetection(const sfmData::SfMData& sfmData, Ort::Session& session, fs::path outputPath, const float minScore);
+void sphereDetection(const sfmData::SfMData& sfmData,
+                     Ort::Session& session,
+                     fs::path outputPath,
+                     const float minScore,
+                     bool detectOncePerPose = false);
 
 /**
  * @brief Write JSON for a hand-detected sphere
@@ -0,0 +1,82 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "ChunkClaimer.hpp"
+
+#include <aliceVision/system/Logger.hpp>
+
+#include <boost/filesystem.hpp>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <stdexcept>
+
+namespace fs = boost::filesystem;
+
+namespace aliceVision {
+namespace system {
+
+ChunkClaimer::ChunkClaimer(const std::string& claimFolder, int nbItems, int chunkSize)
+  : _claimFolder(claimFolder),
+    _nbItems(std::max(nbItems, 0)),
+    _chunkSize(chunkSize)
+{
+    if (_chunkSize <= 0)
+        throw std::invalid_argument("ChunkClaimer: invalid chunk size " + std::to_string(chunkSize) + ".");
+
+    // the folder may be created at the same time by another process
+    boost::system::error_code ec;
+    fs::create_directories(_claimFolder, ec);
+
+    if (!fs::is_directory(_claimFolder))
+        throw std::runtime_error("ChunkClaimer: cannot create the claim folder: " + _claimFolder);
+}
+
+int ChunkClaimer::getNbChunks() const { return (_nbItems + _chunkSize - 1) / _chunkSize; }
+
+bool ChunkClaimer::claimNext(int& rangeStart, int& rangeSize)
+{
+    const int nbChunks = getNbChunks();
+
+    while (_nextChunkIndex < nbChunks)
+    {
+        const int chunkIndex = _nextChunkIndex++;
+
+        if (!tryClaim(chunkIndex))
+            continue;  // claimed by another process
+
+        rangeStart = chunkIndex * _chunkSize;
+        rangeSize = std::min(_chunkSize, _nbItems - rangeStart);
+
+        ALICEVISION_LOG_INFO("Claimed chunk " << (chunkIndex + 1) << " / " << nbChunks << " (rangeStart: " << rangeStart
+                                              << ", rangeSize: " << rangeSize << ").");
+        return true;
+    }
+
+    return false;
+}
+
+bool ChunkClaimer::tryClaim(int chunkIndex) const
+{
+    // the chunk size is part of the name, a folder reused with another partitioning does not lock the chunks
+    const fs::path lockPath = fs::path(_claimFolder) / ("chunk_" + std::to_string(chunkIndex) + "_" + std::to_string(_chunkSize) + ".lock");
+
+    // exclusive creation, fails if the file already exists
+    std::FILE* lockFile = std::fopen(lockPath.string().c_str(), "wx");
+    if (lockFile == nullptr)
+    {
+        if (errno != EEXIST)
+            throw std::runtime_error("ChunkClaimer: cannot create the lock file: " + lockPath.string());
+        return false;
+    }
+
+    std::fclose(lockFile);
+    return true;
+}
+
+}  // namespace system
+}  // namespace aliceVision
@@ -0,0 +1,61 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <string>
+
+namespace aliceVision {
+namespace system {
+
+/**
+ * @brief Share the chunks of a range of items between several processes.
+ *
+ * The items are split in the same chunks as the static rangeStart / rangeSize partitioning:
+ * chunk i covers the items [i * chunkSize, (i + 1) * chunkSize).
+ * Each process pulls the next chunk not claimed by another process until none are left.
+ * A chunk is claimed by the exclusive creation of a lock file in a folder shared by the processes,
+ * so the folder should be empty (or new) for each execution.
+ */
+class ChunkClaimer
+{
+  public:
+    /**
+     * @brief ChunkClaimer constructor
+     * @param[in] claimFolder the folder shared by the processes, created if needed
+     * @param[in] nbItems the total number of items
+     * @param[in] chunkSize the number of items per chunk
+     */
+    ChunkClaimer(const std::string& claimFolder, int nbItems, int chunkSize);
+
+    /**
+     * @return the number of chunks
+     */
+    int getNbChunks() const;
+
+    /**
+     * @brief Claim the next chunk not claimed by any process.
+     * @param[out] rangeStart the index of the first item of the claimed chunk
+     * @param[out] rangeSize the number of items of the claimed chunk
+     * @return false if all the chunks have been claimed
+     */
+    bool claimNext(int& rangeStart, int& rangeSize);
+
+  private:
+    /**
+     * @brief Try to create the lock file of a chunk.
+     * @return true if the lock file has been created by this call
+     */
+    bool tryClaim(int chunkIndex) const;
+
+    std::string _claimFolder;
+    int _nbItems;
+    int _chunkSize;
+    int _nextChunkIndex = 0;
+};
+
+}  // namespace system
+}  // namespace aliceVision
@@ -0,0 +1,76 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <aliceVision/system/ChunkClaimer.hpp>
+
+#define BOOST_TEST_MODULE ChunkClaimer
+
+#include <boost/test/unit_test.hpp>
+#include <boost/filesystem.hpp>
+
+#include <vector>
+
+namespace fs = boost::filesystem;
+
+using namespace aliceVision::system;
+
+BOOST_AUTO_TEST_CASE(ChunkClaimer_sameChunksAsStaticRanges)
+{
+    const fs::path claimFolder = fs::temp_directory_path() / fs::unique_path();
+
+    ChunkClaimer claimer(claimFolder.string(), 10, 4);
+    BOOST_CHECK_EQUAL(claimer.getNbChunks(), 3);
+
+    std::vector<std::pair<int, int>> ranges;
+    int rangeStart = -1;
+    int rangeSize = -1;
+    while (claimer.claimNext(rangeStart, rangeSize))
+        ranges.emplace_back(rangeStart, rangeSize);
+
+    const std::vector<std::pair<int, int>> expectedRanges{{0, 4}, {4, 4}, {8, 2}};
+    BOOST_CHECK(ranges == expectedRanges);
+
+    fs::remove_all(claimFolder);
+}
+
+BOOST_AUTO_TEST_CASE(ChunkClaimer_eachChunkClaimedOnce)
+{
+    const fs::path claimFolder = fs::temp_directory_path() / fs::unique_path();
+
+    // two claimers on the same folder, as two processes would
+    ChunkClaimer claimerA(claimFolder.string(), 7, 2);
+    ChunkClaimer claimerB(claimFolder.string(), 7, 2);
+
+    std::vector<int> nbClaimsPerChunk(claimerA.getNbChunks(), 0);
+    int rangeStart = -1;
+    int rangeSize = -1;
+
+    for (bool claimed = true; claimed;)
+    {
+        claimed = false;
+        if (claimerA.claimNext(rangeStart, rangeSize))
+        {
+            nbClaimsPerChunk.at(rangeStart / 2)++;
+            claimed = true;
+        }
+        if (claimerB.claimNext(rangeStart, rangeSize))
+        {
+            nbClaimsPerChunk.at(rangeStart / 2)++;
+            claimed = true;
+        }
+    }
+
+    for (const int nbClaims : nbClaimsPerChunk)
+        BOOST_CHECK_EQUAL(nbClaims, 1);
+
+    fs::remove_all(claimFolder);
+}
+
+BOOST_AUTO_TEST_CASE(ChunkClaimer_invalidChunkSize)
+{
+    const fs::path claimFolder = fs::temp_directory_path() / fs::unique_path();
+    BOOST_CHECK_THROW(ChunkClaimer(claimFolder.string(), 10, 0), std::invalid_argument);
+}
@@ -10,7 +10,9 @@
 #include <boost/log/core.hpp>
 #include <boost/log/trivial.hpp>
 #include <boost/log/expressions.hpp>
+#include <boost/log/sinks/async_frontend.hpp>
 #include <boost/log/sinks/sync_frontend.hpp>
+#include <boost/log/sinks/unbounded_fifo_queue.hpp>
 #include <boost/log/sinks/text_ostream_backend.hpp>
 #include <boost/log/sources/severity_logger.hpp>
 #include <boost/log/sources/record_ostream.hpp>
@@ -87,12 +89,18 @@ std::istream& operator>>(std::istream& in, EVerboseLevel& verboseLevel)
 }
 
 std::shared_ptr<Logger> Logger::_instance = nullptr;
+std::atomic<int> Logger::_minSeverityLevel{static_cast<int>(boost::log::trivial::trace)};
 
-Logger::Logger()
+namespace {
+
+/**
+ * @brief Create a sink writing the log records in std::clog.
+ */
+template<typename SinkT>
+boost::shared_ptr<SinkT> createClogSink()
 {
     namespace expr = boost::log::expressions;
     namespace sinks = boost::log::sinks;
-    using sink_t = sinks::synchronous_sink<boost::log::sinks::text_ostream_backend>;
 
 #if BOOST_VERSION >= 105600
     using boost::null_deleter;
@@ -101,7 +109,7 @@ Logger::Logger()
 #else
     using null_deleter = boost::log::empty_deleter;
 #endif
-    boost::shared_ptr<sink_t> sink;
+    boost::shared_ptr<SinkT> sink;
 
     {
         // create a backend and attach a stream to it
@@ -112,8 +120,8 @@ Logger::Logger()
         // enable auto-flushing after each log record written
         backend->auto_flush(true);
 
-        // wrap it into the frontend and register in the core.
-        sink = boost::make_shared<sink_t>(backend);
+        // wrap it into the frontend
+        sink = boost::make_shared<SinkT>(backend);
     }
 
     sink->reset_formatter();
@@ -122,9 +130,34 @@ Logger::Logger()
     sink->set_formatter(expr::stream << "[" << expr::format_date_time<boost::posix_time::ptime>("TimeStamp", "%H:%M:%S.%f") << "]"
                                      << "[" << boost::log::trivial::severity << "]"
                                      << " " << expr::smessage);
+    return sink;
+}
 
-    // register the sink in the logging core
-    boost::log::core::get()->add_sink(sink);
+}  // namespace
+
+Logger::Logger()
+{
+    namespace sinks = boost::log::sinks;
+
+    const char* envAsync = std::getenv("ALICEVISION_LOG_ASYNC");
+    if (envAsync != NULL && std::string(envAsync) == "0")
+    {
+        // register the sink in the logging core
+        boost::log::core::get()->add_sink(createClogSink<sinks::synchronous_sink<sinks::text_ostream_backend>>());
+    }
+    else
+    {
+        // the records are pushed in a concurrent FIFO, the feeding thread of the sink formats and writes them
+        using async_sink_t = sinks::asynchronous_sink<sinks::text_ostream_backend, sinks::unbounded_fifo_queue>;
+        boost::shared_ptr<async_sink_t> sink = createClogSink<async_sink_t>();
+        boost::log::core::get()->add_sink(sink);
+        // the core is kept alive, the Logger instance may be destroyed after the boost log singletons
+        _stopSink = [core = boost::log::core::get(), sink]() {
+            core->remove_sink(sink);
+            sink->stop();
+            sink->flush();
+        };
+    }
 
     boost::log::add_common_attributes();
 
@@ -136,6 +169,12 @@ Logger::Logger()
         setLogLevel(envLevel);
 }
 
+Logger::~Logger()
+{
+    if (_stopSink)
+        _stopSink();
+}
+
 std::shared_ptr<Logger> Logger::get()
 {
     if (_instance == nullptr)
@@ -143,6 +182,8 @@ std::shared_ptr<Logger> Logger::get()
     return _instance;
 }
 
+void Logger::flush() { boost::log::core::get()->flush(); }
+
 EVerboseLevel Logger::getDefaultVerboseLevel() { return EVerboseLevel::Info; }
 
 void Logger::setLogLevel(const EVerboseLevel level)
@@ -178,6 +219,7 @@ void Logger::setLogLevel(const std::string& level) { setLogLevel(EVerboseLevel_s
 
 void Logger::setLogLevel(const boost::log::trivial::severity_level level)
 {
+    _minSeverityLevel.store(static_cast<int>(level), std::memory_order_relaxed);
     boost::log::core::get()->set_filter(boost::log::trivial::severity >= level);
 }
 
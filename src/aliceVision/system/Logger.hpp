@@ -11,6 +11,11 @@
 
 #include <boost/log/trivial.hpp>
 
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <limits>
 #include <memory>
 #include <iostream>
 
@@ -20,12 +25,37 @@
 #define ALICEVISION_COUT(x) std::cout << x << std::endl
 #define ALICEVISION_CERR(x) std::cerr << x << std::endl
 
-#define ALICEVISION_LOG_TRACE_OBJ BOOST_LOG_TRIVIAL(trace)
-#define ALICEVISION_LOG_DEBUG_OBJ BOOST_LOG_TRIVIAL(debug)
-#define ALICEVISION_LOG_INFO_OBJ BOOST_LOG_TRIVIAL(info)
-#define ALICEVISION_LOG_WARNING_OBJ BOOST_LOG_TRIVIAL(warning)
-#define ALICEVISION_LOG_ERROR_OBJ BOOST_LOG_TRIVIAL(error)
-#define ALICEVISION_LOG_FATAL_OBJ BOOST_LOG_TRIVIAL(fatal)
+// the levels lower than ALICEVISION_LOG_MIN_LEVEL are removed at compile time,
+// the other levels are filtered by a relaxed atomic load before a log record is opened
+#define ALICEVISION_LOG_ENABLED_OBJ(LEVEL)                                                                                                           \
+    for (bool aliceVisionLogEnabled = ::aliceVision::system::Logger::isEnabled(::boost::log::trivial::LEVEL); aliceVisionLogEnabled;               \
+         aliceVisionLogEnabled = false)                                                                                                              \
+    BOOST_LOG_TRIVIAL(LEVEL)
+#define ALICEVISION_LOG_DISABLED_OBJ(LEVEL) while (false) BOOST_LOG_TRIVIAL(LEVEL)
+
+#if ALICEVISION_LOG_MIN_LEVEL() > 0
+    #define ALICEVISION_LOG_TRACE_OBJ ALICEVISION_LOG_DISABLED_OBJ(trace)
+#else
+    #define ALICEVISION_LOG_TRACE_OBJ ALICEVISION_LOG_ENABLED_OBJ(trace)
+#endif
+#if ALICEVISION_LOG_MIN_LEVEL() > 1
+    #define ALICEVISION_LOG_DEBUG_OBJ ALICEVISION_LOG_DISABLED_OBJ(debug)
+#else
+    #define ALICEVISION_LOG_DEBUG_OBJ ALICEVISION_LOG_ENABLED_OBJ(debug)
+#endif
+#if ALICEVISION_LOG_MIN_LEVEL() > 2
+    #define ALICEVISION_LOG_INFO_OBJ ALICEVISION_LOG_DISABLED_OBJ(info)
+#else
+    #define ALICEVISION_LOG_INFO_OBJ ALICEVISION_LOG_ENABLED_OBJ(info)
+#endif
+#if ALICEVISION_LOG_MIN_LEVEL() > 3
+    #define ALICEVISION_LOG_WARNING_OBJ ALICEVISION_LOG_DISABLED_OBJ(warning)
+#else
+    #define ALICEVISION_LOG_WARNING_OBJ ALICEVISION_LOG_ENABLED_OBJ(warning)
+#endif
+// errors and fatal errors are always compiled
+#define ALICEVISION_LOG_ERROR_OBJ ALICEVISION_LOG_ENABLED_OBJ(error)
+#define ALICEVISION_LOG_FATAL_OBJ ALICEVISION_LOG_ENABLED_OBJ(fatal)
 #define ALICEVISION_LOG(MODE, a) MODE << a
 
 #define ALICEVISION_LOG_TRACE(a) ALICEVISION_LOG(ALICEVISION_LOG_TRACE_OBJ, a)
@@ -35,6 +65,38 @@
 #define ALICEVISION_LOG_ERROR(a) ALICEVISION_LOG(ALICEVISION_LOG_ERROR_OBJ, a)
 #define ALICEVISION_LOG_FATAL(a) ALICEVISION_LOG(ALICEVISION_LOG_FATAL_OBJ, a)
 
+// rate-limited logging of per-item messages, typically in parallel loops,
+// e.g. ALICEVISION_LOG_EVERY_N(ALICEVISION_LOG_DEBUG, 1000, "view " << viewId << ": not enough matches.");
+// the counters are shared by all the threads, per call site
+
+/// log the 1st message, then one message every N calls
+#define ALICEVISION_LOG_EVERY_N(LOG_MACRO, N, a)                                                                                                     \
+    do                                                                                                                                               \
+    {                                                                                                                                                \
+        static std::atomic<std::size_t> aliceVisionLogCounter{0};                                                                                    \
+        if (aliceVisionLogCounter.fetch_add(1, std::memory_order_relaxed) % (N) == 0)                                                                \
+            LOG_MACRO(a);                                                                                                                            \
+    } while (false)
+
+/// log only the N first calls
+#define ALICEVISION_LOG_FIRST_N(LOG_MACRO, N, a)                                                                                                     \
+    do                                                                                                                                               \
+    {                                                                                                                                                \
+        static std::atomic<std::size_t> aliceVisionLogCounter{0};                                                                                    \
+        if (aliceVisionLogCounter.load(std::memory_order_relaxed) < static_cast<std::size_t>(N) &&                                                   \
+            aliceVisionLogCounter.fetch_add(1, std::memory_order_relaxed) < static_cast<std::size_t>(N))                                             \
+            LOG_MACRO(a);                                                                                                                            \
+    } while (false)
+
+/// log at most one message per time interval (in milliseconds)
+#define ALICEVISION_LOG_EVERY_MS(LOG_MACRO, MS, a)                                                                                                   \
+    do                                                                                                                                               \
+    {                                                                                                                                                \
+        static ::aliceVision::system::LogRateLimiter aliceVisionLogRateLimiter(std::chrono::milliseconds(MS));                                       \
+        if (aliceVisionLogRateLimiter.tryAcquire())                                                                                                  \
+            LOG_MACRO(a);                                                                                                                            \
+    } while (false)
+
 #define ALICEVISION_THROW(EXCEPTION, x)                                                                                                              \
     {                                                                                                                                                \
         std::stringstream s;                                                                                                                         \
@@ -74,15 +136,63 @@ std::ostream& operator<<(std::ostream& os, EVerboseLevel verboseLevel);
 
 std::istream& operator>>(std::istream& in, EVerboseLevel& verboseLevel);
 
+/**
+ * @brief Lock-free limiter of the rate of a log message, shared by the threads.
+ */
+class LogRateLimiter
+{
+  public:
+    explicit LogRateLimiter(std::chrono::steady_clock::duration interval)
+      : _interval(interval.count())
+    {}
+
+    /**
+     * @return true if the last accepted call is older than the interval
+     */
+    bool tryAcquire()
+    {
+        const std::chrono::steady_clock::rep now = std::chrono::steady_clock::now().time_since_epoch().count();
+        std::chrono::steady_clock::rep next = _next.load(std::memory_order_relaxed);
+        return now >= next && _next.compare_exchange_strong(next, now + _interval, std::memory_order_relaxed);
+    }
+
+  private:
+    const std::chrono::steady_clock::rep _interval;
+    std::atomic<std::chrono::steady_clock::rep> _next{std::numeric_limits<std::chrono::steady_clock::rep>::lowest()};
+};
+
+/**
+ * @brief Configuration of the boost log core.
+ *
+ * The log records are written by an asynchronous sink: the threads only push the records in a queue,
+ * a background thread formats and writes them. The queue is flushed at exit and by flush().
+ * Set the ALICEVISION_LOG_ASYNC environment variable to 0 to write the records synchronously.
+ */
 class Logger
 {
   public:
+    ~Logger();
+
     /**
      * @brief get Logger instance
      * @return instance
      */
     static std::shared_ptr<Logger> get();
 
+    /**
+     * @brief Check if a severity level passes the current log level.
+     * @note Cheaper than the boost log core filter, which is still applied.
+     */
+    static bool isEnabled(boost::log::trivial::severity_level level)
+    {
+        return static_cast<int>(level) >= _minSeverityLevel.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Write all the pending log records.
+     */
+    void flush();
+
     /**
      * @brief get default verbose level
      * @return default verbose level
@@ -114,6 +224,10 @@ class Logger
     void setLogLevel(const boost::log::trivial::severity_level level);
 
     static std::shared_ptr<Logger> _instance;
+    /// all the levels pass before the Logger creation, as the boost log core has no filter
+    static std::atomic<int> _minSeverityLevel;
+    /// stop the feeding thread of the asynchronous sink and write its pending records
+    std::function<void()> _stopSink;
 };
 
 }  // namespace system
@@ -31,3 +31,65 @@ BOOST_AUTO_TEST_CASE(Logger_Enums)
 
     BOOST_CHECK_THROW(EVerboseLevel_stringToEnum("not a level"), std::out_of_range);
 }
+
+namespace {
+
+int countEvaluations(int& nbEvaluations) { return ++nbEvaluations; }
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(Logger_disabledLevelNotEvaluated)
+{
+    using namespace aliceVision::system;
+    Logger::get()->setLogLevel(EVerboseLevel::Warning);
+
+    int nbEvaluations = 0;
+    ALICEVISION_LOG_DEBUG("not evaluated: " << countEvaluations(nbEvaluations));
+    ALICEVISION_LOG_INFO("not evaluated: " << countEvaluations(nbEvaluations));
+    BOOST_CHECK_EQUAL(nbEvaluations, 0);
+    BOOST_CHECK(!Logger::isEnabled(boost::log::trivial::info));
+    BOOST_CHECK(Logger::isEnabled(boost::log::trivial::error));
+
+    ALICEVISION_LOG_WARNING("evaluated: " << countEvaluations(nbEvaluations));
+    BOOST_CHECK_EQUAL(nbEvaluations, 1);
+
+    Logger::get()->setLogLevel(Logger::getDefaultVerboseLevel());
+}
+
+BOOST_AUTO_TEST_CASE(Logger_rateLimited)
+{
+    using namespace aliceVision::system;
+    Logger::get()->setLogLevel(EVerboseLevel::Info);
+
+    int nbEveryN = 0;
+    int nbFirstN = 0;
+    int nbEveryMs = 0;
+
+#pragma omp parallel for
+    for (int i = 0; i < 1000; ++i)
+    {
+        int nbEvaluations = 0;
+        ALICEVISION_LOG_EVERY_N(ALICEVISION_LOG_INFO, 100, "every 100: " << countEvaluations(nbEvaluations));
+        ALICEVISION_LOG_FIRST_N(ALICEVISION_LOG_INFO, 3, "first 3: " << countEvaluations(nbEvaluations));
+#pragma omp atomic
+        nbEveryN += nbEvaluations;
+    }
+
+    for (int i = 0; i < 100; ++i)
+    {
+        ALICEVISION_LOG_FIRST_N(ALICEVISION_LOG_INFO, 3, "first 3: " << countEvaluations(nbFirstN));
+        ALICEVISION_LOG_EVERY_MS(ALICEVISION_LOG_INFO, 60000, "every minute: " << countEvaluations(nbEveryMs));
+    }
+
+    // 10 messages of the first macro, 3 messages of the second one
+    BOOST_CHECK_EQUAL(nbEveryN, 13);
+    BOOST_CHECK_EQUAL(nbFirstN, 3);
+    BOOST_CHECK_EQUAL(nbEveryMs, 1);
+
+    LogRateLimiter limiter(std::chrono::hours(1));
+    BOOST_CHECK(limiter.tryAcquire());
+    BOOST_CHECK(!limiter.tryAcquire());
+
+    Logger::get()->flush();
+    Logger::get()->setLogLevel(Logger::getDefaultVerboseLevel());
+}
@@ -0,0 +1,142 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "MemoryBudget.hpp"
+
+#include <aliceVision/system/Logger.hpp>
+
+#include <algorithm>
+
+namespace aliceVision {
+namespace system {
+
+namespace {
+
+std::size_t toMB(std::size_t bytes) { return bytes / (1024 * 1024); }
+
+}  // namespace
+
+void MemoryBudget::setCapacity(std::size_t bytes)
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _capacity = bytes;
+    }
+    _released.notify_all();
+}
+
+std::size_t MemoryBudget::getCapacity() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _capacity;
+}
+
+std::size_t MemoryBudget::getReservedBytes() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _reservedBytes;
+}
+
+std::size_t MemoryBudget::getAvailableBytes() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return (_capacity > _reservedBytes) ? _capacity - _reservedBytes : 0;
+}
+
+void MemoryBudget::reserve(std::size_t bytes)
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+
+    if (!canReserve(bytes))
+    {
+        _stats.nbWaits++;
+        if (bytes > _capacity)
+        {
+            ALICEVISION_LOG_WARNING("MemoryBudget: the reservation of " << toMB(bytes) << " MB is larger than the capacity of " << toMB(_capacity)
+                                                                        << " MB, it waits for all the other reservations.");
+        }
+        _released.wait(lock, [&] { return canReserve(bytes); });
+    }
+
+    grant(bytes);
+}
+
+bool MemoryBudget::tryReserve(std::size_t bytes)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    if (!canReserve(bytes))
+        return false;
+
+    grant(bytes);
+    return true;
+}
+
+void MemoryBudget::release(std::size_t bytes)
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _reservedBytes -= std::min(bytes, _reservedBytes);
+    }
+    _released.notify_all();
+}
+
+MemoryBudgetStats MemoryBudget::getStats() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _stats;
+}
+
+void MemoryBudget::logStats() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    ALICEVISION_LOG_INFO("Memory budget:" << std::endl
+                                          << "\t- capacity: " << toMB(_capacity) << " MB" << std::endl
+                                          << "\t- high-water mark: " << toMB(_stats.highWaterMark) << " MB" << std::endl
+                                          << "\t- reservations: " << _stats.nbReservations << " (" << _stats.nbWaits << " waited, "
+                                          << _stats.nbOversized << " larger than the capacity)");
+}
+
+bool MemoryBudget::canReserve(std::size_t bytes) const
+{
+    // an oversized reservation is granted alone
+    if (_reservedBytes == 0)
+        return true;
+
+    return bytes <= _capacity && _reservedBytes <= _capacity - bytes;
+}
+
+void MemoryBudget::grant(std::size_t bytes)
+{
+    if (bytes > _capacity)
+        _stats.nbOversized++;
+
+    _reservedBytes += bytes;
+    _stats.nbReservations++;
+    _stats.highWaterMark = std::max(_stats.highWaterMark, _reservedBytes);
+}
+
+MemoryReservation::MemoryReservation(std::size_t bytes)
+  : _bytes(bytes)
+{
+    MemoryBudget::get().reserve(_bytes);
+}
+
+MemoryReservation::MemoryReservation(MemoryReservation&& other) noexcept
+  : _bytes(other._bytes)
+{
+    other._bytes = 0;
+}
+
+MemoryReservation::~MemoryReservation()
+{
+    if (_bytes > 0)
+        MemoryBudget::get().release(_bytes);
+}
+
+}  // namespace system
+}  // namespace aliceVision
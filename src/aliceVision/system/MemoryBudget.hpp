@@ -0,0 +1,154 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+
+namespace aliceVision {
+namespace system {
+
+/**
+ * @brief Memory budget statistics.
+ */
+struct MemoryBudgetStats
+{
+    /// number of granted reservations
+    std::size_t nbReservations = 0;
+    /// number of reservations that waited for memory
+    std::size_t nbWaits = 0;
+    /// number of reservations larger than the capacity
+    std::size_t nbOversized = 0;
+    /// peak reserved bytes
+    std::size_t highWaterMark = 0;
+};
+
+/**
+ * @brief Memory budget shared by the memory-heavy stages of the program.
+ *
+ * The stages reserve their estimated memory before allocating it. A reservation waits
+ * until enough memory is released by the other stages, so concurrent stages share
+ * the capacity instead of running out of memory.
+ * A reservation larger than the capacity is granted once nothing else is reserved,
+ * the stage then runs alone instead of waiting forever.
+ * @note A thread should not wait for a reservation while holding another one.
+ */
+class MemoryBudget
+{
+  public:
+    static MemoryBudget& get()
+    {
+        static MemoryBudget instance;
+        return instance;
+    }
+
+    // Singleton, no copy constructor
+    MemoryBudget(MemoryBudget const&) = delete;
+
+    // Singleton, no copy operator
+    void operator=(MemoryBudget const&) = delete;
+
+    /**
+     * @brief Set the capacity (e.g. with HardwareContext::getMaxMemory at startup).
+     * @param[in] bytes the capacity in bytes
+     */
+    void setCapacity(std::size_t bytes);
+
+    /**
+     * @return the capacity in bytes
+     */
+    std::size_t getCapacity() const;
+
+    /**
+     * @return the reserved bytes
+     */
+    std::size_t getReservedBytes() const;
+
+    /**
+     * @return the bytes not reserved
+     */
+    std::size_t getAvailableBytes() const;
+
+    /**
+     * @brief Reserve memory, wait until enough memory is available.
+     * @param[in] bytes the number of bytes to reserve
+     */
+    void reserve(std::size_t bytes);
+
+    /**
+     * @brief Reserve memory if it is available now.
+     * @param[in] bytes the number of bytes to reserve
+     * @return false if there is not enough memory available
+     */
+    bool tryReserve(std::size_t bytes);
+
+    /**
+     * @brief Release reserved memory.
+     * @param[in] bytes the number of bytes to release
+     */
+    void release(std::size_t bytes);
+
+    /**
+     * @return the statistics
+     */
+    MemoryBudgetStats getStats() const;
+
+    /**
+     * @brief Log the capacity and the statistics.
+     */
+    void logStats() const;
+
+  private:
+    MemoryBudget() = default;
+
+    bool canReserve(std::size_t bytes) const;
+    void grant(std::size_t bytes);
+
+    std::size_t _capacity = static_cast<std::size_t>(-1);
+    std::size_t _reservedBytes = 0;
+    MemoryBudgetStats _stats;
+    mutable std::mutex _mutex;
+    std::condition_variable _released;
+};
+
+/**
+ * @brief Scoped reservation in the MemoryBudget.
+ */
+class MemoryReservation
+{
+  public:
+    /**
+     * @brief Reserve memory, wait until enough memory is available.
+     * @param[in] bytes the number of bytes to reserve
+     */
+    explicit MemoryReservation(std::size_t bytes);
+
+    MemoryReservation(MemoryReservation&& other) noexcept;
+
+    // no copy constructor
+    MemoryReservation(MemoryReservation const&) = delete;
+
+    // no copy operator
+    void operator=(MemoryReservation const&) = delete;
+
+    /**
+     * @brief Release the reserved memory.
+     */
+    ~MemoryReservation();
+
+    /**
+     * @return the reserved bytes
+     */
+    std::size_t getBytes() const { return _bytes; }
+
+  private:
+    std::size_t _bytes;
+};
+
+}  // namespace system
+}  // namespace aliceVision
@@ -0,0 +1,72 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <aliceVision/system/MemoryBudget.hpp>
+
+#define BOOST_TEST_MODULE MemoryBudget
+
+#include <boost/test/unit_test.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+using namespace aliceVision::system;
+
+BOOST_AUTO_TEST_CASE(MemoryBudget_tryReserve)
+{
+    MemoryBudget& budget = MemoryBudget::get();
+    budget.setCapacity(100);
+
+    BOOST_CHECK(budget.tryReserve(60));
+    BOOST_CHECK(!budget.tryReserve(50));
+    BOOST_CHECK(budget.tryReserve(40));
+    BOOST_CHECK_EQUAL(budget.getAvailableBytes(), 0);
+
+    budget.release(100);
+    BOOST_CHECK_EQUAL(budget.getReservedBytes(), 0);
+    BOOST_CHECK_EQUAL(budget.getStats().highWaterMark, 100);
+}
+
+BOOST_AUTO_TEST_CASE(MemoryBudget_oversizedReservationAlone)
+{
+    MemoryBudget& budget = MemoryBudget::get();
+    budget.setCapacity(100);
+
+    BOOST_CHECK(budget.tryReserve(10));
+    BOOST_CHECK(!budget.tryReserve(200));
+    budget.release(10);
+
+    {
+        MemoryReservation reservation(200);
+        BOOST_CHECK_EQUAL(budget.getReservedBytes(), 200);
+        BOOST_CHECK(!budget.tryReserve(1));
+    }
+    BOOST_CHECK_EQUAL(budget.getReservedBytes(), 0);
+    BOOST_CHECK_EQUAL(budget.getStats().nbOversized, 1);
+}
+
+BOOST_AUTO_TEST_CASE(MemoryBudget_reserveWaitsForRelease)
+{
+    MemoryBudget& budget = MemoryBudget::get();
+    budget.setCapacity(100);
+
+    std::atomic<bool> granted(false);
+    budget.reserve(80);
+
+    std::thread waiting([&]() {
+        MemoryReservation reservation(50);
+        granted = true;
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    BOOST_CHECK(!granted);
+
+    budget.release(80);
+    waiting.join();
+    BOOST_CHECK(granted);
+    BOOST_CHECK_EQUAL(budget.getReservedBytes(), 0);
+}
@@ -13,8 +13,10 @@
 
 #if defined(__WINDOWS__)
     #include <windows.h>
+    #include <psapi.h>
 #elif defined(__LINUX__)
     #include <sys/sysinfo.h>
+    #include <sys/resource.h>
     #include <fstream>
     #include <limits>
 #elif defined(__APPLE__)
@@ -24,6 +26,7 @@
     #include <mach/mach_types.h>
     #include <mach/mach_init.h>
     #include <mach/mach_host.h>
+    #include <sys/resource.h>
 #else
     #warning "System unrecognized. Can't found memory infos."
     #include <limits>
@@ -133,6 +136,29 @@ MemoryInfo getMemoryInfo()
     return infos;
 }
 
+std::size_t getPeakMemoryUsage()
+{
+#if defined(__WINDOWS__)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (K32GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        return counters.PeakWorkingSetSize;
+    return 0;
+#elif defined(__LINUX__) || defined(__APPLE__)
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+        return 0;
+    #if defined(__APPLE__)
+    // in bytes on macOS
+    return static_cast<std::size_t>(usage.ru_maxrss);
+    #else
+    // in kB on Linux
+    return static_cast<std::size_t>(usage.ru_maxrss) * 1024;
+    #endif
+#else
+    return 0;
+#endif
+}
+
 std::ostream& operator<<(std::ostream& os, const MemoryInfo& infos)
 {
     const double convertionGb = std::pow(2, 30);
@@ -25,6 +25,12 @@ struct MemoryInfo
 
 MemoryInfo getMemoryInfo();
 
+/**
+ * @brief Get the peak resident memory of the current process since its start.
+ * @return the peak resident memory in bytes, 0 if unknown
+ */
+std::size_t getPeakMemoryUsage();
+
 std::ostream& operator<<(std::ostream& os, const MemoryInfo& infos);
 
 }  // namespace system
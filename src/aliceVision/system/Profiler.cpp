@@ -0,0 +1,195 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "Profiler.hpp"
+
+#include <aliceVision/system/Logger.hpp>
+#include <aliceVision/system/MemoryInfo.hpp>
+#include <aliceVision/system/system.hpp>
+
+#include <boost/filesystem.hpp>
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+#if defined(__WINDOWS__)
+    #include <windows.h>
+#else
+    #include <ctime>
+#endif
+
+namespace aliceVision {
+namespace system {
+
+namespace {
+
+/// maximum number of trace events kept in memory, the aggregated measures are not limited
+constexpr std::size_t maxTraceEvents = 1000000;
+
+std::size_t toMB(std::size_t bytes) { return bytes / (1024 * 1024); }
+
+/// sequential index of the calling thread, used as trace thread id
+std::size_t getThreadIndex()
+{
+    static std::atomic<std::size_t> nextThreadIndex{0};
+    thread_local const std::size_t threadIndex = nextThreadIndex++;
+    return threadIndex;
+}
+
+std::string escapeJson(const std::string& str)
+{
+    std::string escaped;
+    escaped.reserve(str.size());
+    for (const char c : str)
+    {
+        if (c == '"' || c == '\\')
+            escaped += '\\';
+        if (static_cast<unsigned char>(c) < 0x20)
+            escaped += ' ';
+        else
+            escaped += c;
+    }
+    return escaped;
+}
+
+}  // namespace
+
+double getThreadCpuTimeMs()
+{
+#if defined(__WINDOWS__)
+    FILETIME creationTime, exitTime, kernelTime, userTime;
+    if (!GetThreadTimes(GetCurrentThread(), &creationTime, &exitTime, &kernelTime, &userTime))
+        return 0.0;
+    // in 100 ns units
+    const auto toMs = [](const FILETIME& t) { return ((static_cast<unsigned long long>(t.dwHighDateTime) << 32) | t.dwLowDateTime) * 1e-4; };
+    return toMs(kernelTime) + toMs(userTime);
+#else
+    struct timespec t;
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &t) != 0)
+        return 0.0;
+    return t.tv_sec * 1e3 + t.tv_nsec * 1e-6;
+#endif
+}
+
+Profiler::Profiler()
+  : _origin(std::chrono::steady_clock::now())
+{}
+
+void Profiler::addMeasure(const std::string& name, std::chrono::steady_clock::time_point start, double wallTimeMs, double cpuTimeMs)
+{
+    const std::size_t peakMemory = getPeakMemoryUsage();
+    const double startUs = std::chrono::duration<double, std::micro>(start - _origin).count();
+    const std::size_t threadIndex = getThreadIndex();
+
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    ProfileStageStats& stats = _stats[name];
+    stats.count++;
+    stats.wallTimeMs += wallTimeMs;
+    stats.cpuTimeMs += cpuTimeMs;
+    stats.peakMemory = std::max(stats.peakMemory, peakMemory);
+
+    if (_events.size() < maxTraceEvents)
+        _events.push_back({name, startUs, wallTimeMs * 1e3, threadIndex});
+}
+
+std::map<std::string, ProfileStageStats> Profiler::getStats() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _stats;
+}
+
+void Profiler::logStats() const
+{
+    std::ostringstream os;
+    os << "Profiling report:" << std::fixed << std::setprecision(3);
+    for (const auto& [name, stats] : getStats())
+    {
+        os << std::endl
+           << "\t- " << name << ": " << stats.count << " call(s), wall time: " << stats.wallTimeMs / 1000.0
+           << " s, CPU time: " << stats.cpuTimeMs / 1000.0 << " s, peak memory: " << toMB(stats.peakMemory) << " MB";
+    }
+    ALICEVISION_LOG_INFO(os.str());
+}
+
+bool Profiler::writeReport(const std::string& filepath) const
+{
+    std::ofstream file(filepath);
+    if (!file)
+    {
+        ALICEVISION_LOG_ERROR("Cannot write the profiling report: " << filepath);
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    file << std::fixed << std::setprecision(3);
+    file << "{\n  \"stages\": {";
+    bool first = true;
+    for (const auto& [name, stats] : _stats)
+    {
+        file << (first ? "\n" : ",\n") << "    \"" << escapeJson(name) << "\": {\"count\": " << stats.count << ", \"wallTimeMs\": " << stats.wallTimeMs
+             << ", \"cpuTimeMs\": " << stats.cpuTimeMs << ", \"peakMemory\": " << stats.peakMemory << "}";
+        first = false;
+    }
+    file << "\n  },\n  \"peakMemory\": " << getPeakMemoryUsage() << ",\n";
+
+    // Chrome trace complete events, in microseconds
+    file << "  \"displayTimeUnit\": \"ms\",\n  \"traceEvents\": [";
+    first = true;
+    for (const TraceEvent& event : _events)
+    {
+        file << (first ? "\n" : ",\n") << "    {\"name\": \"" << escapeJson(event.name) << "\", \"ph\": \"X\", \"ts\": " << event.startUs
+             << ", \"dur\": " << event.durationUs << ", \"pid\": 0, \"tid\": " << event.threadId << "}";
+        first = false;
+    }
+    file << "\n  ]\n}\n";
+
+    if (_events.size() >= maxTraceEvents)
+        ALICEVISION_LOG_WARNING("The profiling trace is truncated to its first " << maxTraceEvents << " events.");
+
+    return static_cast<bool>(file);
+}
+
+std::string getProfileReportPath(const std::string& output, const std::string& programPath)
+{
+    namespace fs = boost::filesystem;
+
+    if (!fs::is_directory(output))
+        return output;
+    return (fs::path(output) / (fs::path(programPath).stem().string() + ".json")).string();
+}
+
+void Profiler::clear()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _stats.clear();
+    _events.clear();
+}
+
+ProfileScope::ProfileScope(const char* name)
+  : _name(name),
+    _enabled(Profiler::get().isEnabled())
+{
+    if (!_enabled)
+        return;
+    _cpuStartMs = getThreadCpuTimeMs();
+    _start = std::chrono::steady_clock::now();
+}
+
+ProfileScope::~ProfileScope()
+{
+    if (!_enabled)
+        return;
+    const double wallTimeMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - _start).count();
+    const double cpuTimeMs = getThreadCpuTimeMs() - _cpuStartMs;
+    Profiler::get().addMeasure(_name, _start, wallTimeMs, cpuTimeMs);
+}
+
+}  // namespace system
+}  // namespace aliceVision
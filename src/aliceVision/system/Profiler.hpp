@@ -0,0 +1,162 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#define ALICEVISION_PROFILE_CONCAT_IMPL(a, b) a##b
+#define ALICEVISION_PROFILE_CONCAT(a, b) ALICEVISION_PROFILE_CONCAT_IMPL(a, b)
+
+/**
+ * @brief Measure the current scope as the given stage of the profiling report.
+ * @note Nearly free when the profiling is disabled.
+ */
+#define ALICEVISION_PROFILE_SCOPE(name) \
+    const ::aliceVision::system::ProfileScope ALICEVISION_PROFILE_CONCAT(aliceVision_profileScope_, __LINE__)(name)
+
+namespace aliceVision {
+namespace system {
+
+/**
+ * @brief Aggregated measures of a profiled stage.
+ */
+struct ProfileStageStats
+{
+    /// number of calls
+    std::size_t count = 0;
+    /// cumulated wall time in milliseconds
+    double wallTimeMs = 0.0;
+    /// cumulated CPU time of the calling threads in milliseconds
+    double cpuTimeMs = 0.0;
+    /// peak resident memory of the process at the end of the stage in bytes
+    std::size_t peakMemory = 0;
+};
+
+/**
+ * @brief Collect the measures of the ALICEVISION_PROFILE_SCOPE stages.
+ *
+ * The report aggregates the measures per stage name. It is written as a JSON file
+ * that is also a Chrome trace (chrome://tracing, Perfetto) with one event per call.
+ */
+class Profiler
+{
+  public:
+    static Profiler& get()
+    {
+        static Profiler instance;
+        return instance;
+    }
+
+    // Singleton, no copy constructor
+    Profiler(Profiler const&) = delete;
+
+    // Singleton, no copy operator
+    void operator=(Profiler const&) = delete;
+
+    /**
+     * @brief Enable or disable the measures.
+     * @param[in] enabled true to collect the measures
+     */
+    void setEnabled(bool enabled) { _enabled = enabled; }
+
+    /**
+     * @return true if the measures are collected
+     */
+    bool isEnabled() const { return _enabled; }
+
+    /**
+     * @brief Add the measures of a stage call.
+     * @param[in] name the stage name
+     * @param[in] start the start time of the call
+     * @param[in] wallTimeMs the wall time of the call in milliseconds
+     * @param[in] cpuTimeMs the CPU time of the call in milliseconds
+     */
+    void addMeasure(const std::string& name, std::chrono::steady_clock::time_point start, double wallTimeMs, double cpuTimeMs);
+
+    /**
+     * @return the aggregated measures per stage name
+     */
+    std::map<std::string, ProfileStageStats> getStats() const;
+
+    /**
+     * @brief Log the aggregated measures.
+     */
+    void logStats() const;
+
+    /**
+     * @brief Write the aggregated measures and the trace events in a JSON file.
+     * @param[in] filepath the output JSON file path
+     * @return false if the file cannot be written
+     */
+    bool writeReport(const std::string& filepath) const;
+
+    /**
+     * @brief Clear the measures.
+     */
+    void clear();
+
+  private:
+    Profiler();
+
+    struct TraceEvent
+    {
+        std::string name;
+        double startUs;
+        double durationUs;
+        std::size_t threadId;
+    };
+
+    std::atomic<bool> _enabled{false};
+    const std::chrono::steady_clock::time_point _origin;
+    mutable std::mutex _mutex;
+    std::map<std::string, ProfileStageStats> _stats;
+    std::vector<TraceEvent> _events;
+};
+
+/**
+ * @brief Measure the wall time and the CPU time of the thread until the end of the scope.
+ */
+class ProfileScope
+{
+  public:
+    explicit ProfileScope(const char* name);
+    ~ProfileScope();
+
+    // no copy constructor
+    ProfileScope(ProfileScope const&) = delete;
+
+    // no copy operator
+    void operator=(ProfileScope const&) = delete;
+
+  private:
+    const char* _name;
+    bool _enabled;
+    std::chrono::steady_clock::time_point _start;
+    double _cpuStartMs = 0.0;
+};
+
+/**
+ * @return the CPU time of the calling thread in milliseconds
+ */
+double getThreadCpuTimeMs();
+
+/**
+ * @brief Get the profiling report file path of a program.
+ * @param[in] output the report file path, or an existing folder for a report named after the program
+ * @param[in] programPath the program path (argv[0])
+ * @return the report file path
+ */
+std::string getProfileReportPath(const std::string& output, const std::string& programPath);
+
+}  // namespace system
+}  // namespace aliceVision
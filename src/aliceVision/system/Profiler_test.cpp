@@ -0,0 +1,87 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <aliceVision/system/Profiler.hpp>
+
+#include <boost/filesystem.hpp>
+
+#define BOOST_TEST_MODULE Profiler
+
+#include <boost/test/unit_test.hpp>
+
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+using namespace aliceVision::system;
+
+namespace fs = boost::filesystem;
+
+BOOST_AUTO_TEST_CASE(Profiler_disabled)
+{
+    Profiler& profiler = Profiler::get();
+    profiler.clear();
+    profiler.setEnabled(false);
+
+    {
+        ALICEVISION_PROFILE_SCOPE("stage");
+    }
+    BOOST_CHECK(profiler.getStats().empty());
+}
+
+BOOST_AUTO_TEST_CASE(Profiler_aggregateStages)
+{
+    Profiler& profiler = Profiler::get();
+    profiler.clear();
+    profiler.setEnabled(true);
+
+    for (int i = 0; i < 3; ++i)
+    {
+        ALICEVISION_PROFILE_SCOPE("stage");
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    std::thread worker([]() { ALICEVISION_PROFILE_SCOPE("worker"); });
+    worker.join();
+
+    const std::map<std::string, ProfileStageStats> stats = profiler.getStats();
+    BOOST_REQUIRE_EQUAL(stats.size(), 2);
+    BOOST_CHECK_EQUAL(stats.at("stage").count, 3);
+    BOOST_CHECK_GE(stats.at("stage").wallTimeMs, 15.0);
+    // sleeping does not use the CPU
+    BOOST_CHECK_LT(stats.at("stage").cpuTimeMs, stats.at("stage").wallTimeMs);
+    BOOST_CHECK_GT(stats.at("stage").peakMemory, 0);
+    BOOST_CHECK_EQUAL(stats.at("worker").count, 1);
+
+    profiler.setEnabled(false);
+}
+
+BOOST_AUTO_TEST_CASE(Profiler_writeReport)
+{
+    Profiler& profiler = Profiler::get();
+    profiler.clear();
+    profiler.setEnabled(true);
+
+    {
+        ALICEVISION_PROFILE_SCOPE("stage \"quoted\"");
+    }
+    profiler.setEnabled(false);
+
+    const fs::path folder = fs::temp_directory_path() / fs::unique_path();
+    fs::create_directory(folder);
+
+    const std::string filepath = getProfileReportPath(folder.string(), "/usr/bin/aliceVision_test");
+    BOOST_CHECK_EQUAL(fs::path(filepath).filename().string(), "aliceVision_test.json");
+    BOOST_REQUIRE(profiler.writeReport(filepath));
+
+    std::ifstream file(filepath);
+    std::stringstream content;
+    content << file.rdbuf();
+    BOOST_CHECK(content.str().find("\"stage \\\"quoted\\\"\": {\"count\": 1") != std::string::npos);
+    BOOST_CHECK(content.str().find("\"traceEvents\"") != std::string::npos);
+    BOOST_CHECK(content.str().find("\"ph\": \"X\"") != std::string::npos);
+
+    fs::remove_all(folder);
+}
@@ -5,8 +5,27 @@
 // You can obtain one at https://mozilla.org/MPL/2.0/.
 
 #include "ProgressDisplay.hpp"
+
+#include <aliceVision/system/Logger.hpp>
+#include <aliceVision/system/MemoryInfo.hpp>
+#include <aliceVision/system/system.hpp>
+
+#include <boost/filesystem.hpp>
 #include <boost/timer/progress_display.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <map>
 #include <mutex>
+#include <sstream>
+
+#if defined(__WINDOWS__)
+    #include <process.h>
+#else
+    #include <unistd.h>
+#endif
 
 namespace aliceVision {
 namespace system {
@@ -60,13 +79,295 @@ class ProgressDisplayImplBoostProgress : public ProgressDisplayImpl
     boost::timer::progress_display _display;
 };
 
+namespace {
+
+int getProcessId()
+{
+#if defined(__WINDOWS__)
+    return _getpid();
+#else
+    return static_cast<int>(getpid());
+#endif
+}
+
+/// escape a string for a JSON string or a Prometheus label value
+std::string escapeQuoted(const std::string& str)
+{
+    std::string escaped;
+    escaped.reserve(str.size());
+    for (const char c : str)
+    {
+        if (c == '"' || c == '\\')
+            escaped += '\\';
+        if (static_cast<unsigned char>(c) < 0x20)
+            escaped += ' ';
+        else
+            escaped += c;
+    }
+    return escaped;
+}
+
+struct ProgressMetrics
+{
+    std::string stage;
+    unsigned long count = 0;
+    unsigned long expectedCount = 0;
+    double elapsedSeconds = 0.0;
+    double itemsPerSecond = 0.0;
+    /// negative if unknown
+    double etaSeconds = -1.0;
+    std::size_t peakMemory = 0;
+    std::size_t availableMemory = 0;
+};
+
+/**
+ * @brief Writer of the progress metrics of all the displays of the process in the same file.
+ */
+class ProgressMetricsWriter
+{
+  public:
+    explicit ProgressMetricsWriter(const std::string& output)
+    {
+        namespace fs = boost::filesystem;
+
+        _filepath = output;
+        if (fs::is_directory(output))
+            _filepath = (fs::path(output) / ("progress_" + std::to_string(getProcessId()) + ".jsonl")).string();
+        _prometheus = (fs::path(_filepath).extension() == ".prom");
+    }
+
+    /**
+     * @brief Get the writer of an output, shared by all the displays.
+     */
+    static std::shared_ptr<ProgressMetricsWriter> get(const std::string& output)
+    {
+        static std::mutex mutex;
+        static std::map<std::string, std::weak_ptr<ProgressMetricsWriter>> writers;
+
+        std::lock_guard<std::mutex> lock(mutex);
+        std::shared_ptr<ProgressMetricsWriter> writer = writers[output].lock();
+        if (!writer)
+        {
+            writer = std::make_shared<ProgressMetricsWriter>(output);
+            writers[output] = writer;
+        }
+        return writer;
+    }
+
+    void write(std::size_t displayId, const ProgressMetrics& metrics, bool finished)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        if (_prometheus)
+        {
+            if (finished)
+                _latestMetrics.erase(displayId);
+            else
+                _latestMetrics[displayId] = metrics;
+            writePrometheus();
+        }
+        else
+        {
+            writeJsonLine(displayId, metrics, finished);
+        }
+    }
+
+  private:
+    void writeJsonLine(std::size_t displayId, const ProgressMetrics& metrics, bool finished)
+    {
+        const double timestamp = std::chrono::duration<double>(std::chrono::system_clock::now().time_since_epoch()).count();
+
+        // the line is written at once, the processes may append to the same file
+        std::ostringstream line;
+        line.precision(15);
+        line << "{\"timestamp\": " << timestamp << ", \"pid\": " << getProcessId() << ", \"display\": " << displayId << ", \"stage\": \""
+             << escapeQuoted(metrics.stage) << "\", \"count\": " << metrics.count << ", \"expectedCount\": " << metrics.expectedCount
+             << ", \"elapsedSeconds\": " << metrics.elapsedSeconds << ", \"itemsPerSecond\": " << metrics.itemsPerSecond
+             << ", \"etaSeconds\": " << metrics.etaSeconds << ", \"peakMemory\": " << metrics.peakMemory
+             << ", \"availableMemory\": " << metrics.availableMemory << ", \"finished\": " << (finished ? "true" : "false") << "}\n";
+
+        std::ofstream file(_filepath, std::ios::app);
+        file << line.str();
+        if (!file && !_failed)
+        {
+            ALICEVISION_LOG_WARNING("Cannot write the progress metrics in '" << _filepath << "'.");
+            _failed = true;
+        }
+    }
+
+    void writePrometheus()
+    {
+        namespace fs = boost::filesystem;
+
+        const std::string pid = std::to_string(getProcessId());
+        std::ostringstream content;
+        content.precision(15);
+
+        const auto writeMetric = [&](const char* name, const char* help, const auto& getValue) {
+            content << "# HELP aliceVision_progress_" << name << " " << help << "\n";
+            content << "# TYPE aliceVision_progress_" << name << " gauge\n";
+            for (const auto& displayMetrics : _latestMetrics)
+            {
+                content << "aliceVision_progress_" << name << "{pid=\"" << pid << "\",display=\"" << displayMetrics.first << "\",stage=\""
+                        << escapeQuoted(displayMetrics.second.stage) << "\"} " << getValue(displayMetrics.second) << "\n";
+            }
+        };
+
+        writeMetric("items", "Number of processed items of the stage.", [](const ProgressMetrics& m) { return m.count; });
+        writeMetric("expected_items", "Number of items of the stage.", [](const ProgressMetrics& m) { return m.expectedCount; });
+        writeMetric("elapsed_seconds", "Time since the start of the stage.", [](const ProgressMetrics& m) { return m.elapsedSeconds; });
+        writeMetric("items_per_second", "Mean throughput of the stage.", [](const ProgressMetrics& m) { return m.itemsPerSecond; });
+        writeMetric("eta_seconds", "Estimated remaining time of the stage, negative if unknown.", [](const ProgressMetrics& m) {
+            return m.etaSeconds;
+        });
+        writeMetric("peak_memory_bytes", "Peak resident memory of the process.", [](const ProgressMetrics& m) { return m.peakMemory; });
+        writeMetric("available_memory_bytes", "Available memory of the system.", [](const ProgressMetrics& m) { return m.availableMemory; });
+
+        // the file is replaced atomically, a collector never reads a partial file
+        const std::string tmpFilepath = _filepath + "." + fs::unique_path().string() + ".tmp";
+        {
+            std::ofstream file(tmpFilepath);
+            file << content.str();
+        }
+        boost::system::error_code ec;
+        fs::rename(tmpFilepath, _filepath, ec);
+        if (ec)
+        {
+            fs::remove(tmpFilepath, ec);
+            if (!_failed)
+                ALICEVISION_LOG_WARNING("Cannot write the progress metrics in '" << _filepath << "'.");
+            _failed = true;
+        }
+    }
+
+    std::mutex _mutex;
+    std::string _filepath;
+    bool _prometheus = false;
+    /// warn only once if the file cannot be written
+    bool _failed = false;
+    std::map<std::size_t, ProgressMetrics> _latestMetrics;
+};
+
+class ProgressDisplayImplMetrics : public ProgressDisplayImpl
+{
+  public:
+    ProgressDisplayImplMetrics(const std::shared_ptr<ProgressDisplayImpl>& impl, const std::string& stage, const std::string& output, double intervalSeconds)
+      : _impl(impl),
+        _stage(stage),
+        _writer(ProgressMetricsWriter::get(output)),
+        _interval(std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(intervalSeconds)).count()),
+        _displayId(nextDisplayId()),
+        _start(std::chrono::steady_clock::now())
+    {
+        _nextWrite = _start.time_since_epoch().count() + _interval;
+        writeMetrics(false);
+    }
+
+    ~ProgressDisplayImplMetrics() override { writeMetrics(true); }
+
+    void restart(unsigned long expectedCount) override
+    {
+        _impl->restart(expectedCount);
+        {
+            std::lock_guard<std::mutex> lock(_startMutex);
+            _start = std::chrono::steady_clock::now();
+        }
+        writeMetrics(false);
+    }
+
+    void increment(unsigned long count) override
+    {
+        _impl->increment(count);
+
+        // only one thread writes the metrics of an interval
+        const std::chrono::steady_clock::rep now = std::chrono::steady_clock::now().time_since_epoch().count();
+        std::chrono::steady_clock::rep next = _nextWrite.load(std::memory_order_relaxed);
+        if (now >= next && _nextWrite.compare_exchange_strong(next, now + _interval, std::memory_order_relaxed))
+            writeMetrics(false);
+    }
+
+    unsigned long count() override { return _impl->count(); }
+
+    unsigned long expectedCount() override { return _impl->expectedCount(); }
+
+  private:
+    static std::size_t nextDisplayId()
+    {
+        static std::atomic<std::size_t> displayId{0};
+        return displayId++;
+    }
+
+    void writeMetrics(bool finished)
+    {
+        ProgressMetrics metrics;
+        metrics.stage = _stage;
+        metrics.count = _impl->count();
+        metrics.expectedCount = _impl->expectedCount();
+        {
+            std::lock_guard<std::mutex> lock(_startMutex);
+            metrics.elapsedSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - _start).count();
+        }
+        if (metrics.elapsedSeconds > 0.0)
+            metrics.itemsPerSecond = metrics.count / metrics.elapsedSeconds;
+        if (metrics.itemsPerSecond > 0.0 && metrics.expectedCount >= metrics.count)
+            metrics.etaSeconds = (metrics.expectedCount - metrics.count) / metrics.itemsPerSecond;
+        metrics.peakMemory = getPeakMemoryUsage();
+        metrics.availableMemory = getMemoryInfo().availableRam;
+
+        _writer->write(_displayId, metrics, finished);
+    }
+
+    std::shared_ptr<ProgressDisplayImpl> _impl;
+    const std::string _stage;
+    std::shared_ptr<ProgressMetricsWriter> _writer;
+    const std::chrono::steady_clock::rep _interval;
+    const std::size_t _displayId;
+    std::mutex _startMutex;
+    std::chrono::steady_clock::time_point _start;
+    std::atomic<std::chrono::steady_clock::rep> _nextWrite{0};
+};
+
+/// first non-empty line of the leading strings of a console progress display
+std::string getStageName(const std::string& s1, const std::string& s2, const std::string& s3)
+{
+    std::istringstream lines(s1 + "\n" + s2 + "\n" + s3);
+    std::string line;
+    while (std::getline(lines, line))
+    {
+        const std::size_t first = line.find_first_not_of(" \t\r-:");
+        if (first == std::string::npos)
+            continue;
+        const std::size_t last = line.find_last_not_of(" \t\r-:");
+        return line.substr(first, last - first + 1);
+    }
+    return "progress";
+}
+
+}  // namespace
+
+std::shared_ptr<ProgressDisplayImpl> createMetricsProgressDisplayImpl(const std::shared_ptr<ProgressDisplayImpl>& impl,
+                                                                      const std::string& stage,
+                                                                      const std::string& output,
+                                                                      double intervalSeconds)
+{
+    return std::make_shared<ProgressDisplayImplMetrics>(impl, stage, output, intervalSeconds);
+}
+
 ProgressDisplay createConsoleProgressDisplay(unsigned long expectedCount,
                                              std::ostream& os,
                                              const std::string& s1,
                                              const std::string& s2,
                                              const std::string& s3)
 {
-    auto impl = std::make_shared<ProgressDisplayImplBoostProgress>(expectedCount, os, s1, s2, s3);
+    std::shared_ptr<ProgressDisplayImpl> impl = std::make_shared<ProgressDisplayImplBoostProgress>(expectedCount, os, s1, s2, s3);
+
+    const char* metricsOutput = std::getenv("ALICEVISION_PROGRESS_METRICS");
+    if (metricsOutput != nullptr && metricsOutput[0] != '\0')
+    {
+        const char* metricsInterval = std::getenv("ALICEVISION_PROGRESS_METRICS_INTERVAL");
+        const double intervalSeconds = (metricsInterval != nullptr) ? std::atof(metricsInterval) : 1.0;
+        impl = createMetricsProgressDisplayImpl(impl, getStageName(s1, s2, s3), metricsOutput, intervalSeconds);
+    }
     return ProgressDisplay(impl);
 }
 
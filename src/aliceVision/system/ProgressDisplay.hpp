@@ -57,7 +57,34 @@ class ProgressDisplay
     std::shared_ptr<ProgressDisplayImpl> _impl;
 };
 
-/// Creates console-based progress bar
+/**
+ * @brief Add the output of the progress metrics to a progress display.
+ *
+ * The metrics (items, expected items, items per second, ETA, peak memory of the process, available memory)
+ * are written at most once per interval, at each restart and when the display is destroyed:
+ * - in Prometheus text format if the output file extension is ".prom": the file is replaced
+ *   atomically and contains the latest metrics of all the displays of the process,
+ *   to be read by the textfile collector of node_exporter;
+ * - as JSON lines appended to the output file otherwise (one JSON object per line).
+ * If the output is a folder, the file is <folder>/progress_<pid>.jsonl.
+ *
+ * @param[in] impl the progress display implementation to decorate
+ * @param[in] stage the name of the stage
+ * @param[in] output the metrics output file (or folder)
+ * @param[in] intervalSeconds the minimum time between two outputs of the metrics
+ * @return the decorated implementation
+ */
+std::shared_ptr<ProgressDisplayImpl> createMetricsProgressDisplayImpl(const std::shared_ptr<ProgressDisplayImpl>& impl,
+                                                                      const std::string& stage,
+                                                                      const std::string& output,
+                                                                      double intervalSeconds = 1.0);
+
+/**
+ * @brief Creates console-based progress bar
+ * @note If the ALICEVISION_PROGRESS_METRICS environment variable is set, the progress metrics are also written
+ *       in this file (see createMetricsProgressDisplayImpl), every ALICEVISION_PROGRESS_METRICS_INTERVAL seconds (1 by default).
+ *       The stage name is the first non-empty line of the leading strings.
+ */
 ProgressDisplay createConsoleProgressDisplay(unsigned long expectedCount,
                                              std::ostream& os,
                                              const std::string& s1 = "\n",  // leading strings
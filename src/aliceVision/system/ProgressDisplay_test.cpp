@@ -0,0 +1,108 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <aliceVision/system/ProgressDisplay.hpp>
+
+#include <boost/filesystem.hpp>
+
+#define BOOST_TEST_MODULE ProgressDisplay
+
+#include <boost/test/unit_test.hpp>
+
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace aliceVision::system;
+
+namespace fs = boost::filesystem;
+
+namespace {
+
+class ProgressDisplayImplCounter : public ProgressDisplayImpl
+{
+  public:
+    void restart(unsigned long expectedCount) override
+    {
+        _count = 0;
+        _expectedCount = expectedCount;
+    }
+    void increment(unsigned long count) override { _count += count; }
+    unsigned long count() override { return _count; }
+    unsigned long expectedCount() override { return _expectedCount; }
+
+  private:
+    unsigned long _count = 0;
+    unsigned long _expectedCount = 0;
+};
+
+std::vector<std::string> readLines(const std::string& filepath)
+{
+    std::ifstream file(filepath);
+    std::vector<std::string> lines;
+    std::string line;
+    while (std::getline(file, line))
+        lines.push_back(line);
+    return lines;
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(ProgressDisplay_metricsJsonLines)
+{
+    const fs::path folder = fs::temp_directory_path() / fs::unique_path();
+    fs::create_directory(folder);
+    const std::string filepath = (folder / "progress.jsonl").string();
+
+    {
+        ProgressDisplay display(createMetricsProgressDisplayImpl(std::make_shared<ProgressDisplayImplCounter>(), "stage \"quoted\"", filepath, 0.0));
+        display.restart(10);
+        for (int i = 0; i < 10; ++i)
+            ++display;
+        BOOST_CHECK_EQUAL(display.count(), 10);
+    }
+
+    const std::vector<std::string> lines = readLines(filepath);
+    // creation, restart, each increment without interval, destruction
+    BOOST_REQUIRE_EQUAL(lines.size(), 13);
+    BOOST_CHECK(lines.front().find("\"stage\": \"stage \\\"quoted\\\"\"") != std::string::npos);
+    BOOST_CHECK(lines.back().find("\"count\": 10, \"expectedCount\": 10") != std::string::npos);
+    BOOST_CHECK(lines.back().find("\"finished\": true") != std::string::npos);
+    for (const std::string& line : lines)
+        BOOST_CHECK(line.front() == '{' && line.back() == '}');
+
+    fs::remove_all(folder);
+}
+
+BOOST_AUTO_TEST_CASE(ProgressDisplay_metricsPrometheus)
+{
+    const fs::path folder = fs::temp_directory_path() / fs::unique_path();
+    fs::create_directory(folder);
+    const std::string filepath = (folder / "progress.prom").string();
+
+    {
+        ProgressDisplay display(createMetricsProgressDisplayImpl(std::make_shared<ProgressDisplayImplCounter>(), "matching", filepath, 3600.0));
+        display.restart(4);
+        display += 3;
+
+        // written at the restart only, the interval is not elapsed
+        std::ifstream file(filepath);
+        std::stringstream content;
+        content << file.rdbuf();
+        BOOST_CHECK(content.str().find("# TYPE aliceVision_progress_items gauge") != std::string::npos);
+        BOOST_CHECK(content.str().find("stage=\"matching\"} 0\n") != std::string::npos);
+        BOOST_CHECK(content.str().find("aliceVision_progress_expected_items{") != std::string::npos);
+    }
+
+    // the finished displays are removed
+    std::ifstream file(filepath);
+    std::stringstream content;
+    content << file.rdbuf();
+    BOOST_CHECK(content.str().find("stage=\"matching\"") == std::string::npos);
+
+    fs::remove_all(folder);
+}
@@ -0,0 +1,191 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "ResultCache.hpp"
+
+#include <aliceVision/system/Logger.hpp>
+
+#include <boost/filesystem.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+namespace fs = boost::filesystem;
+
+namespace aliceVision {
+namespace system {
+
+ContentHash& ContentHash::addBytes(const void* data, std::size_t size)
+{
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    std::uint64_t hash = _hash;
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        hash ^= bytes[i];
+        hash *= 1099511628211ULL;
+    }
+    _hash = hash;
+    return *this;
+}
+
+ContentHash& ContentHash::addString(const std::string& value)
+{
+    addValue(std::uint64_t(value.size()));
+    return addBytes(value.data(), value.size());
+}
+
+bool ContentHash::addFile(const std::string& filepath)
+{
+    std::ifstream file(filepath, std::ios::binary);
+    if (!file.is_open())
+        return false;
+
+    std::vector<char> buffer(1 << 20);
+    std::uint64_t size = 0;
+    while (file)
+    {
+        file.read(buffer.data(), buffer.size());
+        const std::streamsize nbRead = file.gcount();
+        addBytes(buffer.data(), std::size_t(nbRead));
+        size += std::uint64_t(nbRead);
+    }
+    if (file.bad())
+        return false;
+
+    addValue(size);
+    return true;
+}
+
+std::string ContentHash::toString() const
+{
+    std::ostringstream os;
+    os << std::hex << std::setw(16) << std::setfill('0') << _hash;
+    return os.str();
+}
+
+std::string getCommandLineKey(int argc, char** argv, const std::set<std::string>& excludedOptions)
+{
+    // group the arguments by option: "--name value..." or "--name=value"
+    std::vector<std::vector<std::string>> options;
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string argument(argv[i]);
+        if (argument.size() > 1 && argument[0] == '-' && !std::isdigit(static_cast<unsigned char>(argument[1])) && argument[1] != '.')
+        {
+            const std::string name = argument.substr(argument.find_first_not_of('-'));
+            const std::size_t separator = name.find('=');
+            options.push_back({name.substr(0, separator)});
+            if (separator != std::string::npos)
+                options.back().push_back(name.substr(separator + 1));
+        }
+        else if (!options.empty())
+        {
+            options.back().push_back(argument);
+        }
+    }
+
+    options.erase(std::remove_if(options.begin(), options.end(), [&](const std::vector<std::string>& option) {
+                      return excludedOptions.count(option.front()) > 0;
+                  }),
+                  options.end());
+    std::sort(options.begin(), options.end());
+
+    ContentHash hash;
+    for (const std::vector<std::string>& option : options)
+    {
+        hash.addValue(std::uint64_t(option.size()));
+        for (const std::string& value : option)
+            hash.addString(value);
+    }
+    return hash.toString();
+}
+
+ResultCache::ResultCache(const std::string& cacheFolder)
+  : _cacheFolder(cacheFolder)
+{
+    if (_cacheFolder.empty())
+        return;
+
+    // the folder may be created at the same time by another process
+    boost::system::error_code ec;
+    fs::create_directories(_cacheFolder, ec);
+
+    if (!fs::is_directory(_cacheFolder))
+    {
+        ALICEVISION_LOG_WARNING("Cannot create the results cache folder '" << _cacheFolder << "', the cache is disabled.");
+        _cacheFolder.clear();
+    }
+}
+
+bool ResultCache::restore(const std::string& key, const std::vector<std::string>& filepaths) const
+{
+    if (!isEnabled())
+        return false;
+
+    const fs::path entryFolder = fs::path(_cacheFolder) / key;
+    for (const std::string& filepath : filepaths)
+    {
+        if (!fs::is_regular_file(entryFolder / fs::path(filepath).filename()))
+            return false;
+    }
+
+    // each file is copied next to its destination then renamed, a reader never sees a partial file
+    boost::system::error_code ec;
+    for (const std::string& filepath : filepaths)
+    {
+        const fs::path tmpPath = fs::path(filepath + "." + fs::unique_path().string() + ".tmp");
+        fs::copy_file(entryFolder / fs::path(filepath).filename(), tmpPath, ec);
+        if (!ec)
+            fs::rename(tmpPath, filepath, ec);
+        if (ec)
+        {
+            ALICEVISION_LOG_WARNING("Cannot restore '" << filepath << "' from the results cache: " << ec.message());
+            fs::remove(tmpPath, ec);
+            return false;
+        }
+    }
+    return true;
+}
+
+bool ResultCache::store(const std::string& key, const std::vector<std::string>& filepaths) const
+{
+    if (!isEnabled())
+        return false;
+
+    const fs::path entryFolder = fs::path(_cacheFolder) / key;
+    if (fs::exists(entryFolder))
+        return true;
+
+    // the entry is written in a temporary folder renamed at the end, concurrent writers of the same entry keep the first one
+    const fs::path tmpFolder = fs::path(_cacheFolder) / (key + "." + fs::unique_path().string() + ".tmp");
+    boost::system::error_code ec;
+    fs::create_directory(tmpFolder, ec);
+    for (const std::string& filepath : filepaths)
+    {
+        if (ec)
+            break;
+        fs::copy_file(filepath, tmpFolder / fs::path(filepath).filename(), ec);
+    }
+    if (!ec)
+        fs::rename(tmpFolder, entryFolder, ec);
+
+    if (ec)
+    {
+        boost::system::error_code removeEc;
+        fs::remove_all(tmpFolder, removeEc);
+        if (fs::exists(entryFolder))
+            return true;
+        ALICEVISION_LOG_WARNING("Cannot store the results entry '" << key << "' in the cache: " << ec.message());
+        return false;
+    }
+    return true;
+}
+
+}  // namespace system
+}  // namespace aliceVision
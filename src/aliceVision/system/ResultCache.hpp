@@ -0,0 +1,107 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <set>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace aliceVision {
+namespace system {
+
+/**
+ * @brief Incremental 64-bit FNV-1a hash of the inputs of a result.
+ */
+class ContentHash
+{
+  public:
+    ContentHash& addBytes(const void* data, std::size_t size);
+
+    /// the size is hashed first, so consecutive strings cannot be confused
+    ContentHash& addString(const std::string& value);
+
+    template<typename T>
+    ContentHash& addValue(const T& value)
+    {
+        static_assert(std::is_arithmetic<T>::value, "ContentHash::addValue only hashes arithmetic values.");
+        return addBytes(&value, sizeof(T));
+    }
+
+    /**
+     * @brief Hash the content of a file.
+     * @return false if the file cannot be read
+     */
+    bool addFile(const std::string& filepath);
+
+    std::uint64_t getValue() const { return _hash; }
+
+    /// @return the hash as 16 hexadecimal digits
+    std::string toString() const;
+
+  private:
+    std::uint64_t _hash = 14695981039346656037ULL;
+};
+
+/**
+ * @brief Get the key of the parameters of a software from its command line.
+ * @note The options are sorted, their order does not change the key.
+ *       The options with a default value are not on the command line, the software version should be added to the key.
+ * @param[in] argc the number of arguments
+ * @param[in] argv the arguments
+ * @param[in] excludedOptions the long names of the options that do not change the results
+ *            (inputs and outputs paths, range, log and hardware options)
+ * @return the key as 16 hexadecimal digits
+ */
+std::string getCommandLineKey(int argc, char** argv, const std::set<std::string>& excludedOptions);
+
+/**
+ * @brief Content-addressed cache of result files shared between the runs of a pipeline.
+ *
+ * An entry is a folder named after the key of the inputs of a result (see ContentHash),
+ * containing a copy of the result files. A run restores the entries of its unchanged inputs
+ * instead of computing them again.
+ * An entry is written in a temporary folder which is then renamed, so concurrent processes
+ * never read a partial entry, and an entry is never modified once written.
+ */
+class ResultCache
+{
+  public:
+    /**
+     * @brief ResultCache constructor
+     * @param[in] cacheFolder the folder of the entries, created if needed, disabled if empty
+     */
+    explicit ResultCache(const std::string& cacheFolder = "");
+
+    bool isEnabled() const { return !_cacheFolder.empty(); }
+
+    /**
+     * @brief Copy the files of an entry to the given paths.
+     * @note The entry files are matched by the filenames of the given paths.
+     * @param[in] key the key of the entry
+     * @param[in] filepaths the paths of the result files
+     * @return false if the cache is disabled or if the entry does not contain all the files
+     */
+    bool restore(const std::string& key, const std::vector<std::string>& filepaths) const;
+
+    /**
+     * @brief Copy result files into a new entry.
+     * @note An existing entry is kept as is.
+     * @param[in] key the key of the entry
+     * @param[in] filepaths the paths of the result files
+     * @return false if the cache is disabled or if the entry cannot be written
+     */
+    bool store(const std::string& key, const std::vector<std::string>& filepaths) const;
+
+  private:
+    std::string _cacheFolder;
+};
+
+}  // namespace system
+}  // namespace aliceVision
@@ -0,0 +1,113 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <aliceVision/system/ResultCache.hpp>
+
+#define BOOST_TEST_MODULE ResultCache
+
+#include <boost/test/unit_test.hpp>
+#include <boost/filesystem.hpp>
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace fs = boost::filesystem;
+
+using namespace aliceVision::system;
+
+namespace {
+
+void writeFile(const fs::path& filepath, const std::string& content)
+{
+    std::ofstream file(filepath.string(), std::ios::binary);
+    file << content;
+}
+
+std::string readFile(const fs::path& filepath)
+{
+    std::ifstream file(filepath.string(), std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(ResultCache_contentHash)
+{
+    const fs::path folder = fs::temp_directory_path() / fs::unique_path();
+    fs::create_directories(folder);
+    writeFile(folder / "a.bin", "content");
+    writeFile(folder / "b.bin", "content");
+    writeFile(folder / "c.bin", "other content");
+
+    ContentHash hashA, hashB, hashC;
+    BOOST_CHECK(hashA.addFile((folder / "a.bin").string()));
+    BOOST_CHECK(hashB.addFile((folder / "b.bin").string()));
+    BOOST_CHECK(hashC.addFile((folder / "c.bin").string()));
+    BOOST_CHECK_EQUAL(hashA.toString(), hashB.toString());
+    BOOST_CHECK_NE(hashA.toString(), hashC.toString());
+    BOOST_CHECK_EQUAL(hashA.toString().size(), 16);
+
+    ContentHash hashMissing;
+    BOOST_CHECK(!hashMissing.addFile((folder / "missing.bin").string()));
+
+    // the strings are delimited by their size
+    BOOST_CHECK_NE(ContentHash().addString("ab").addString("c").toString(), ContentHash().addString("a").addString("bc").toString());
+
+    fs::remove_all(folder);
+}
+
+BOOST_AUTO_TEST_CASE(ResultCache_commandLineKey)
+{
+    const char* argvA[] = {"software", "--input", "a.sfm", "--describerPreset", "high", "-o", "outA", "--maxNbFeatures=100"};
+    const char* argvB[] = {"software", "--maxNbFeatures", "100", "--input", "b.sfm", "--output", "outB", "--describerPreset", "high"};
+    const char* argvC[] = {"software", "--input", "a.sfm", "--describerPreset", "ultra", "--output", "outA"};
+    const std::set<std::string> excludedOptions{"input", "i", "output", "o"};
+
+    const std::string keyA = getCommandLineKey(8, const_cast<char**>(argvA), excludedOptions);
+    const std::string keyB = getCommandLineKey(9, const_cast<char**>(argvB), excludedOptions);
+    const std::string keyC = getCommandLineKey(7, const_cast<char**>(argvC), excludedOptions);
+
+    BOOST_CHECK_EQUAL(keyA, keyB);
+    BOOST_CHECK_NE(keyA, keyC);
+}
+
+BOOST_AUTO_TEST_CASE(ResultCache_storeAndRestore)
+{
+    const fs::path folder = fs::temp_directory_path() / fs::unique_path();
+    const fs::path outputFolder = folder / "output";
+    fs::create_directories(outputFolder);
+
+    ResultCache cache((folder / "cache").string());
+    BOOST_CHECK(cache.isEnabled());
+
+    const std::vector<std::string> filepaths{(outputFolder / "1.sift.feat").string(), (outputFolder / "1.sift.desc").string()};
+    BOOST_CHECK(!cache.restore("0123456789abcdef", filepaths));
+
+    writeFile(filepaths[0], "features");
+    writeFile(filepaths[1], "descriptors");
+    BOOST_CHECK(cache.store("0123456789abcdef", filepaths));
+
+    // an existing entry is never modified
+    writeFile(filepaths[0], "modified features");
+    BOOST_CHECK(cache.store("0123456789abcdef", filepaths));
+
+    fs::remove(filepaths[0]);
+    fs::remove(filepaths[1]);
+    BOOST_CHECK(cache.restore("0123456789abcdef", filepaths));
+    BOOST_CHECK_EQUAL(readFile(filepaths[0]), "features");
+    BOOST_CHECK_EQUAL(readFile(filepaths[1]), "descriptors");
+
+    // an entry without all the requested files is a miss
+    BOOST_CHECK(!cache.restore("0123456789abcdef", {(outputFolder / "1.akaze.feat").string()}));
+
+    ResultCache disabledCache;
+    BOOST_CHECK(!disabledCache.isEnabled());
+    BOOST_CHECK(!disabledCache.store("0123456789abcdef", filepaths));
+    BOOST_CHECK(!disabledCache.restore("0123456789abcdef", filepaths));
+
+    fs::remove_all(folder);
+}
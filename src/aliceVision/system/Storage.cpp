@@ -0,0 +1,297 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "Storage.hpp"
+
+#include <aliceVision/system/Logger.hpp>
+#include <aliceVision/system/ResultCache.hpp>
+
+#include <boost/filesystem.hpp>
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdlib>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+
+namespace fs = boost::filesystem;
+
+namespace aliceVision {
+namespace system {
+
+namespace {
+
+const std::string fileSchemePrefix = "file://";
+
+/// size of the range requests of the remote files
+const std::uint64_t rangeRequestSize = 8 * 1024 * 1024;
+
+struct StorageState
+{
+    std::mutex mutex;
+    std::condition_variable requestsCondition;
+    std::map<std::string, std::shared_ptr<StorageBackend>> backends;
+    std::string cacheFolder;
+    int maxRequests = 8;
+    int nbRequests = 0;
+
+    StorageState()
+    {
+        backends["file"] = std::make_shared<FileStorageBackend>();
+
+        const char* cacheFolderEnv = std::getenv("ALICEVISION_STORAGE_CACHE");
+        cacheFolder = (cacheFolderEnv != nullptr && cacheFolderEnv[0] != '\0') ? std::string(cacheFolderEnv)
+                                                                              : (fs::temp_directory_path() / "aliceVision_storage").string();
+
+        const char* maxRequestsEnv = std::getenv("ALICEVISION_STORAGE_MAX_REQUESTS");
+        if (maxRequestsEnv != nullptr && std::atoi(maxRequestsEnv) > 0)
+            maxRequests = std::atoi(maxRequestsEnv);
+    }
+};
+
+StorageState& getStorageState()
+{
+    static StorageState state;
+    return state;
+}
+
+/**
+ * @brief Slot of a request to a backend, waits while the maximum number of concurrent requests is reached.
+ */
+class RequestSlot
+{
+  public:
+    RequestSlot()
+    {
+        StorageState& state = getStorageState();
+        std::unique_lock<std::mutex> lock(state.mutex);
+        state.requestsCondition.wait(lock, [&] { return state.nbRequests < state.maxRequests; });
+        ++state.nbRequests;
+    }
+
+    ~RequestSlot()
+    {
+        StorageState& state = getStorageState();
+        {
+            std::lock_guard<std::mutex> lock(state.mutex);
+            --state.nbRequests;
+        }
+        state.requestsCondition.notify_one();
+    }
+
+    RequestSlot(const RequestSlot&) = delete;
+    RequestSlot& operator=(const RequestSlot&) = delete;
+};
+
+/// @return the backend of the URI scheme of the path, nullptr for a local path
+std::shared_ptr<StorageBackend> getBackend(const std::string& path)
+{
+    const std::size_t schemeEnd = path.find("://");
+    if (schemeEnd == std::string::npos || schemeEnd == 0)
+        return nullptr;
+
+    StorageState& state = getStorageState();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    const auto it = state.backends.find(path.substr(0, schemeEnd));
+    return (it == state.backends.end()) ? nullptr : it->second;
+}
+
+/**
+ * @brief Copy the beginning of a remote file in the local cache.
+ * @param[in] backend the backend of the file
+ * @param[in] uri the file URI
+ * @param[in] maxSize the maximum number of bytes to copy
+ * @return the local path of the copy
+ */
+std::string fetchRemoteFile(StorageBackend& backend, const std::string& uri, std::uint64_t maxSize)
+{
+    std::uint64_t fileSize = 0;
+    bool fileFound = false;
+    {
+        RequestSlot slot;
+        fileFound = backend.getSize(uri, fileSize);
+    }
+    if (!fileFound)
+        throw std::runtime_error("Cannot find the remote file '" + uri + "'.");
+
+    const std::uint64_t fetchSize = std::min(fileSize, maxSize);
+    const std::string key = ContentHash().addString(uri).addValue(fileSize).addValue(fetchSize).toString();
+
+    fs::path cacheFolder;
+    {
+        StorageState& state = getStorageState();
+        std::lock_guard<std::mutex> lock(state.mutex);
+        cacheFolder = state.cacheFolder;
+    }
+
+    // keep the extension, the image readers are chosen from it
+    const fs::path cachePath = cacheFolder / (key + fs::path(uri).extension().string());
+
+    boost::system::error_code ec;
+    if (fs::is_regular_file(cachePath, ec) && fs::file_size(cachePath, ec) == fetchSize)
+        return cachePath.string();
+
+    ALICEVISION_LOG_TRACE("Copy " << fetchSize << " bytes of '" << uri << "' in the storage cache.");
+
+    // the copy is written in a temporary file then renamed, a reader never sees a partial file
+    fs::create_directories(cacheFolder, ec);
+    const fs::path tmpPath = fs::path(cachePath.string() + "." + fs::unique_path().string() + ".tmp");
+    {
+        std::ofstream file(tmpPath.string(), std::ios::binary);
+        std::vector<char> data;
+        for (std::uint64_t offset = 0; offset < fetchSize && file; offset += rangeRequestSize)
+        {
+            const std::uint64_t rangeSize = std::min(rangeRequestSize, fetchSize - offset);
+            bool rangeRead = false;
+            {
+                RequestSlot slot;
+                rangeRead = backend.readRange(uri, offset, rangeSize, data);
+            }
+            if (!rangeRead || data.size() != rangeSize)
+            {
+                file.close();
+                fs::remove(tmpPath, ec);
+                throw std::runtime_error("Cannot read the remote file '" + uri + "'.");
+            }
+            file.write(data.data(), std::streamsize(data.size()));
+        }
+        if (!file)
+        {
+            file.close();
+            fs::remove(tmpPath, ec);
+            throw std::runtime_error("Cannot write the storage cache file '" + tmpPath.string() + "'.");
+        }
+    }
+
+    fs::rename(tmpPath, cachePath, ec);
+    if (ec)
+    {
+        boost::system::error_code removeEc;
+        fs::remove(tmpPath, removeEc);
+        if (!fs::is_regular_file(cachePath))
+            throw std::runtime_error("Cannot write the storage cache file '" + cachePath.string() + "': " + ec.message());
+    }
+    return cachePath.string();
+}
+
+}  // namespace
+
+bool FileStorageBackend::getSize(const std::string& uri, std::uint64_t& size)
+{
+    boost::system::error_code ec;
+    const fs::path path(uri.substr(fileSchemePrefix.size()));
+    if (!fs::is_regular_file(path, ec))
+        return false;
+    size = fs::file_size(path, ec);
+    return !ec;
+}
+
+bool FileStorageBackend::readRange(const std::string& uri, std::uint64_t offset, std::uint64_t size, std::vector<char>& data)
+{
+    std::ifstream file(uri.substr(fileSchemePrefix.size()), std::ios::binary);
+    if (!file.is_open())
+        return false;
+
+    data.resize(size);
+    file.seekg(std::streamoff(offset));
+    file.read(data.data(), std::streamsize(size));
+    return std::uint64_t(file.gcount()) == size;
+}
+
+bool FileStorageBackend::listFolder(const std::string& uri, std::vector<std::string>& uris)
+{
+    boost::system::error_code ec;
+    const fs::path folder(uri.substr(fileSchemePrefix.size()));
+    if (!fs::is_directory(folder, ec))
+        return false;
+
+    for (fs::directory_iterator it(folder, ec), end; !ec && it != end; it.increment(ec))
+    {
+        if (fs::is_regular_file(it->path(), ec))
+            uris.push_back(fileSchemePrefix + it->path().string());
+    }
+    return !ec;
+}
+
+void registerStorageBackend(const std::string& scheme, std::shared_ptr<StorageBackend> backend)
+{
+    StorageState& state = getStorageState();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    if (backend)
+        state.backends[scheme] = backend;
+    else
+        state.backends.erase(scheme);
+}
+
+void setStorageCacheFolder(const std::string& folder)
+{
+    StorageState& state = getStorageState();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    state.cacheFolder = folder;
+}
+
+void setStorageMaxRequests(int maxRequests)
+{
+    StorageState& state = getStorageState();
+    {
+        std::lock_guard<std::mutex> lock(state.mutex);
+        state.maxRequests = std::max(1, maxRequests);
+    }
+    state.requestsCondition.notify_all();
+}
+
+bool isRemotePath(const std::string& path) { return getBackend(path) != nullptr; }
+
+bool storageFileExists(const std::string& path)
+{
+    const std::shared_ptr<StorageBackend> backend = getBackend(path);
+    if (!backend)
+        return fs::exists(path);
+
+    std::uint64_t size = 0;
+    RequestSlot slot;
+    return backend->getSize(path, size);
+}
+
+std::vector<std::string> storageListFolder(const std::string& folder)
+{
+    std::vector<std::string> paths;
+    const std::shared_ptr<StorageBackend> backend = getBackend(folder);
+    if (backend)
+    {
+        RequestSlot slot;
+        if (!backend->listFolder(folder, paths))
+            ALICEVISION_LOG_WARNING("Cannot list the remote folder '" << folder << "'.");
+        return paths;
+    }
+
+    boost::system::error_code ec;
+    for (fs::directory_iterator it(folder, ec), end; !ec && it != end; it.increment(ec))
+        paths.push_back(it->path().string());
+    return paths;
+}
+
+std::string getStorageLocalPath(const std::string& path)
+{
+    const std::shared_ptr<StorageBackend> backend = getBackend(path);
+    if (!backend)
+        return path;
+    return fetchRemoteFile(*backend, path, std::numeric_limits<std::uint64_t>::max());
+}
+
+std::string getStorageLocalHeaderPath(const std::string& path, std::uint64_t headerSize)
+{
+    const std::shared_ptr<StorageBackend> backend = getBackend(path);
+    if (!backend)
+        return path;
+    return fetchRemoteFile(*backend, path, headerSize);
+}
+
+}  // namespace system
+}  // namespace aliceVision
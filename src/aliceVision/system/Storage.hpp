@@ -0,0 +1,127 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace aliceVision {
+namespace system {
+
+/**
+ * @brief Backend of a remote storage, addressed by the scheme of its URIs ("s3://bucket/key", "https://host/path"...).
+ *
+ * The remote files are read with range requests and copied in a local read-through cache,
+ * so the image and feature readers always work on local files.
+ * The backends are called concurrently, the number of concurrent requests is bounded (see setStorageMaxRequests).
+ */
+class StorageBackend
+{
+  public:
+    virtual ~StorageBackend() = default;
+
+    /**
+     * @brief Get the size of a file.
+     * @param[in] uri the file URI
+     * @param[out] size the size of the file in bytes
+     * @return false if the file does not exist or cannot be reached
+     */
+    virtual bool getSize(const std::string& uri, std::uint64_t& size) = 0;
+
+    /**
+     * @brief Read a range of bytes of a file.
+     * @param[in] uri the file URI
+     * @param[in] offset the first byte of the range
+     * @param[in] size the number of bytes of the range
+     * @param[out] data the bytes of the range
+     * @return false if the range cannot be read
+     */
+    virtual bool readRange(const std::string& uri, std::uint64_t offset, std::uint64_t size, std::vector<char>& data) = 0;
+
+    /**
+     * @brief List the files of a folder.
+     * @param[in] uri the folder URI
+     * @param[out] uris the URIs of the files of the folder
+     * @return false if the folder cannot be listed
+     */
+    virtual bool listFolder(const std::string& uri, std::vector<std::string>& uris) = 0;
+};
+
+/**
+ * @brief Backend of the "file://" URIs.
+ * @note Reading a slow mounted file system (network or object storage mount) through "file://" URIs
+ *       copies each file once in the local cache.
+ */
+class FileStorageBackend : public StorageBackend
+{
+  public:
+    bool getSize(const std::string& uri, std::uint64_t& size) override;
+    bool readRange(const std::string& uri, std::uint64_t offset, std::uint64_t size, std::vector<char>& data) override;
+    bool listFolder(const std::string& uri, std::vector<std::string>& uris) override;
+};
+
+/**
+ * @brief Register the backend of a URI scheme.
+ * @note The "file" scheme is registered by default.
+ * @param[in] scheme the URI scheme, without "://"
+ * @param[in] backend the backend, nullptr to unregister the scheme
+ */
+void registerStorageBackend(const std::string& scheme, std::shared_ptr<StorageBackend> backend);
+
+/**
+ * @brief Set the folder of the local read-through cache of the remote files.
+ * @note The default folder is $ALICEVISION_STORAGE_CACHE, or "aliceVision_storage" in the temporary folder.
+ */
+void setStorageCacheFolder(const std::string& folder);
+
+/**
+ * @brief Set the maximum number of concurrent requests to the backends.
+ * @note The default is $ALICEVISION_STORAGE_MAX_REQUESTS, or 8.
+ */
+void setStorageMaxRequests(int maxRequests);
+
+/**
+ * @return true if the path is a URI of a registered backend
+ */
+bool isRemotePath(const std::string& path);
+
+/**
+ * @return true if the local or remote file exists
+ */
+bool storageFileExists(const std::string& path);
+
+/**
+ * @brief List the files of a local or remote folder.
+ * @return the paths of the files, empty if the folder cannot be listed
+ */
+std::vector<std::string> storageListFolder(const std::string& folder);
+
+/**
+ * @brief Get a local path of a file.
+ * @note A local path is returned as is, a remote file is copied in the local cache if needed.
+ *       The cache entries are identified by the URI and the size of the files.
+ * @param[in] path the local path or the URI of the file
+ * @return the local path of the file
+ * @throw std::runtime_error if the remote file cannot be read
+ */
+std::string getStorageLocalPath(const std::string& path);
+
+/**
+ * @brief Get a local path of the beginning of a file, enough to read its header.
+ * @note A local path is returned as is, only the first bytes of a remote file are copied in the local cache.
+ *       The file is complete if it is smaller than headerSize.
+ * @param[in] path the local path or the URI of the file
+ * @param[in] headerSize the number of bytes to copy
+ * @return the local path of the beginning of the file, with the same extension
+ * @throw std::runtime_error if the remote file cannot be read
+ */
+std::string getStorageLocalHeaderPath(const std::string& path, std::uint64_t headerSize);
+
+}  // namespace system
+}  // namespace aliceVision
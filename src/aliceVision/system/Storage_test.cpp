@@ -0,0 +1,178 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <aliceVision/system/Storage.hpp>
+
+#define BOOST_TEST_MODULE Storage
+
+#include <boost/test/unit_test.hpp>
+#include <boost/filesystem.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace fs = boost::filesystem;
+
+using namespace aliceVision::system;
+
+namespace {
+
+std::string readFile(const std::string& filepath)
+{
+    std::ifstream file(filepath, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+/// in-memory backend counting its requests
+class MemoryStorageBackend : public StorageBackend
+{
+  public:
+    std::map<std::string, std::string> files;
+    std::atomic<int> nbRangeRequests{0};
+    std::atomic<int> nbConcurrentRequests{0};
+    std::atomic<int> maxConcurrentRequests{0};
+
+    bool getSize(const std::string& uri, std::uint64_t& size) override
+    {
+        const auto it = files.find(uri);
+        if (it == files.end())
+            return false;
+        size = it->second.size();
+        return true;
+    }
+
+    bool readRange(const std::string& uri, std::uint64_t offset, std::uint64_t size, std::vector<char>& data) override
+    {
+        const int nbRequests = ++nbConcurrentRequests;
+        int maxRequests = maxConcurrentRequests;
+        while (nbRequests > maxRequests && !maxConcurrentRequests.compare_exchange_weak(maxRequests, nbRequests))
+            ;
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        ++nbRangeRequests;
+
+        const std::string& content = files.at(uri);
+        data.assign(content.begin() + offset, content.begin() + offset + size);
+        --nbConcurrentRequests;
+        return true;
+    }
+
+    bool listFolder(const std::string& uri, std::vector<std::string>& uris) override
+    {
+        for (const auto& file : files)
+        {
+            if (file.first.compare(0, uri.size() + 1, uri + "/") == 0)
+                uris.push_back(file.first);
+        }
+        return true;
+    }
+};
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(Storage_remoteFile)
+{
+    const fs::path cacheFolder = fs::temp_directory_path() / fs::unique_path();
+    setStorageCacheFolder(cacheFolder.string());
+
+    auto backend = std::make_shared<MemoryStorageBackend>();
+    backend->files["mem://bucket/a.exr"] = "header and pixels";
+    backend->files["mem://bucket/b.feat"] = "features";
+    registerStorageBackend("mem", backend);
+
+    BOOST_CHECK(isRemotePath("mem://bucket/a.exr"));
+    BOOST_CHECK(!isRemotePath("/local/a.exr"));
+    BOOST_CHECK(!isRemotePath("unknown://bucket/a.exr"));
+
+    BOOST_CHECK(storageFileExists("mem://bucket/a.exr"));
+    BOOST_CHECK(!storageFileExists("mem://bucket/missing.exr"));
+    BOOST_CHECK_THROW(getStorageLocalPath("mem://bucket/missing.exr"), std::runtime_error);
+
+    // the local paths are unchanged
+    BOOST_CHECK_EQUAL(getStorageLocalPath("/local/a.exr"), "/local/a.exr");
+
+    // the remote file is read once
+    const std::string localPath = getStorageLocalPath("mem://bucket/a.exr");
+    BOOST_CHECK_EQUAL(fs::extension(localPath), ".exr");
+    BOOST_CHECK_EQUAL(readFile(localPath), "header and pixels");
+    BOOST_CHECK_EQUAL(getStorageLocalPath("mem://bucket/a.exr"), localPath);
+    BOOST_CHECK_EQUAL(backend->nbRangeRequests, 1);
+
+    // only the beginning of the file is read for the header
+    const std::string headerPath = getStorageLocalHeaderPath("mem://bucket/a.exr", 6);
+    BOOST_CHECK_EQUAL(fs::extension(headerPath), ".exr");
+    BOOST_CHECK_EQUAL(readFile(headerPath), "header");
+    BOOST_CHECK_EQUAL(getStorageLocalHeaderPath("mem://bucket/a.exr", 1000), localPath);
+
+    std::vector<std::string> folderFiles = storageListFolder("mem://bucket");
+    std::sort(folderFiles.begin(), folderFiles.end());
+    BOOST_CHECK(folderFiles == std::vector<std::string>({"mem://bucket/a.exr", "mem://bucket/b.feat"}));
+
+    registerStorageBackend("mem", nullptr);
+    BOOST_CHECK(!isRemotePath("mem://bucket/a.exr"));
+
+    fs::remove_all(cacheFolder);
+}
+
+BOOST_AUTO_TEST_CASE(Storage_maxRequests)
+{
+    const fs::path cacheFolder = fs::temp_directory_path() / fs::unique_path();
+    setStorageCacheFolder(cacheFolder.string());
+    setStorageMaxRequests(2);
+
+    auto backend = std::make_shared<MemoryStorageBackend>();
+    const int nbFiles = 16;
+    for (int i = 0; i < nbFiles; ++i)
+        backend->files["mem://bucket/" + std::to_string(i) + ".bin"] = std::string(100, char('a' + i));
+    registerStorageBackend("mem", backend);
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < nbFiles; ++i)
+    {
+        threads.emplace_back([i] {
+            const std::string localPath = getStorageLocalPath("mem://bucket/" + std::to_string(i) + ".bin");
+            BOOST_CHECK_EQUAL(readFile(localPath), std::string(100, char('a' + i)));
+        });
+    }
+    for (std::thread& thread : threads)
+        thread.join();
+
+    BOOST_CHECK_EQUAL(backend->nbRangeRequests, nbFiles);
+    BOOST_CHECK_LE(backend->maxConcurrentRequests, 2);
+
+    registerStorageBackend("mem", nullptr);
+    setStorageMaxRequests(8);
+    fs::remove_all(cacheFolder);
+}
+
+BOOST_AUTO_TEST_CASE(Storage_fileScheme)
+{
+    const fs::path folder = fs::temp_directory_path() / fs::unique_path();
+    const fs::path cacheFolder = fs::temp_directory_path() / fs::unique_path();
+    fs::create_directories(folder);
+    setStorageCacheFolder(cacheFolder.string());
+    {
+        std::ofstream file((folder / "matches.bin").string(), std::ios::binary);
+        file << "matches";
+    }
+
+    const std::string uri = "file://" + (folder / "matches.bin").string();
+    BOOST_CHECK(isRemotePath(uri));
+    BOOST_CHECK(storageFileExists(uri));
+    BOOST_CHECK(!storageFileExists("file://" + (folder / "missing.bin").string()));
+    BOOST_CHECK_EQUAL(readFile(getStorageLocalPath(uri)), "matches");
+    BOOST_CHECK(fs::path(getStorageLocalPath(uri)).parent_path() == cacheFolder);
+    BOOST_CHECK(storageListFolder("file://" + folder.string()) == std::vector<std::string>({uri}));
+    BOOST_CHECK(storageListFolder(folder.string()) == std::vector<std::string>({(folder / "matches.bin").string()}));
+
+    fs::remove_all(folder);
+    fs::remove_all(cacheFolder);
+}
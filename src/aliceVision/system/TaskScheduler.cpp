@@ -0,0 +1,261 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "TaskScheduler.hpp"
+
+#include <algorithm>
+#include <chrono>
+
+namespace aliceVision {
+namespace system {
+
+namespace {
+
+/// task queue index of the current thread, 0 for the threads that are not workers
+thread_local std::size_t currentQueueIndex = 0;
+
+}  // namespace
+
+TaskScheduler::TaskScheduler() { setNbThreads(0); }
+
+TaskScheduler::~TaskScheduler() { stopWorkers(); }
+
+void TaskScheduler::setNbThreads(unsigned int nbThreads)
+{
+    if (nbThreads == 0)
+        nbThreads = std::max(1u, std::thread::hardware_concurrency());
+
+    if (!_queues.empty() && nbThreads == _nbThreads)
+        return;
+
+    stopWorkers();
+    _nbThreads = nbThreads;
+    // the thread waiting for the tasks is the last one
+    startWorkers(nbThreads - 1);
+}
+
+void TaskScheduler::push(std::function<void()> task)
+{
+    const std::size_t queueIndex = (currentQueueIndex < _queues.size()) ? currentQueueIndex : 0;
+    TaskQueue& queue = *_queues.at(queueIndex);
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.tasks.push_back(std::move(task));
+    }
+    {
+        // lock to not miss a worker going to sleep
+        std::lock_guard<std::mutex> lock(_sleepMutex);
+        ++_nbPendingTasks;
+    }
+    _wakeUp.notify_one();
+}
+
+bool TaskScheduler::runPendingTask()
+{
+    std::function<void()> task;
+    if (!popTask(task))
+        return false;
+    task();
+    return true;
+}
+
+void TaskScheduler::startWorkers(unsigned int nbWorkers)
+{
+    _stopping = false;
+    _queues.clear();
+    for (unsigned int i = 0; i < nbWorkers + 1; ++i)
+        _queues.push_back(std::make_unique<TaskQueue>());
+
+    for (unsigned int i = 0; i < nbWorkers; ++i)
+        _workers.emplace_back(&TaskScheduler::workerLoop, this, i + 1);
+}
+
+void TaskScheduler::stopWorkers()
+{
+    {
+        std::lock_guard<std::mutex> lock(_sleepMutex);
+        _stopping = true;
+    }
+    _wakeUp.notify_all();
+
+    for (std::thread& worker : _workers)
+        worker.join();
+    _workers.clear();
+
+    // execute the tasks left in the calling thread
+    while (runPendingTask())
+    {
+    }
+}
+
+void TaskScheduler::workerLoop(std::size_t queueIndex)
+{
+    currentQueueIndex = queueIndex;
+
+    std::function<void()> task;
+    while (true)
+    {
+        if (popTask(task))
+        {
+            task();
+            task = nullptr;
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(_sleepMutex);
+        _wakeUp.wait(lock, [this] { return _stopping || _nbPendingTasks > 0; });
+        if (_stopping)
+            return;
+    }
+}
+
+bool TaskScheduler::popTask(std::function<void()>& task)
+{
+    if (_nbPendingTasks == 0)
+        return false;
+
+    const std::size_t nbQueues = _queues.size();
+    const std::size_t ownIndex = (currentQueueIndex < nbQueues) ? currentQueueIndex : 0;
+
+    // own queue first, most recent task
+    {
+        TaskQueue& queue = *_queues.at(ownIndex);
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (!queue.tasks.empty())
+        {
+            task = std::move(queue.tasks.back());
+            queue.tasks.pop_back();
+            --_nbPendingTasks;
+            return true;
+        }
+    }
+
+    // steal the oldest task of another queue
+    for (std::size_t i = 1; i < nbQueues; ++i)
+    {
+        TaskQueue& queue = *_queues.at((ownIndex + i) % nbQueues);
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (!queue.tasks.empty())
+        {
+            task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+            --_nbPendingTasks;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+TaskGroup::~TaskGroup() { waitTasks(); }
+
+void TaskGroup::run(std::function<void()> task)
+{
+    ++_nbPendingTasks;
+    TaskScheduler::get().push([this, task = std::move(task)]() {
+        try
+        {
+            task();
+        }
+        catch (...)
+        {
+            std::lock_guard<std::mutex> lock(_errorMutex);
+            if (!_error)
+                _error = std::current_exception();
+        }
+        // last access to the group, it can be destroyed by the waiting thread
+        --_nbPendingTasks;
+    });
+}
+
+void TaskGroup::wait()
+{
+    waitTasks();
+
+    std::exception_ptr error;
+    {
+        std::lock_guard<std::mutex> lock(_errorMutex);
+        std::swap(error, _error);
+    }
+    if (error)
+        std::rethrow_exception(error);
+}
+
+void TaskGroup::waitTasks()
+{
+    TaskScheduler& scheduler = TaskScheduler::get();
+    int nbIdleIterations = 0;
+
+    while (_nbPendingTasks > 0)
+    {
+        if (scheduler.runPendingTask())
+        {
+            nbIdleIterations = 0;
+        }
+        else if (++nbIdleIterations < 64)
+        {
+            std::this_thread::yield();
+        }
+        else
+        {
+            // the remaining tasks are running in other threads
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+    }
+}
+
+void parallelFor(int begin, int end, const std::function<void(int)>& func, int maxConcurrency)
+{
+    if (end <= begin)
+        return;
+
+    const int nbItems = end - begin;
+    int nbTasks = static_cast<int>(TaskScheduler::get().getNbThreads());
+    if (maxConcurrency > 0)
+        nbTasks = std::min(nbTasks, maxConcurrency);
+    nbTasks = std::min(nbTasks, nbItems);
+
+    if (nbTasks <= 1)
+    {
+        for (int i = begin; i < end; ++i)
+            func(i);
+        return;
+    }
+
+    // several chunks per task to balance the load
+    const int chunkSize = std::max(1, nbItems / (nbTasks * 8));
+    std::atomic<int> nextIndex(begin);
+
+    TaskGroup group;
+    for (int t = 0; t < nbTasks; ++t)
+    {
+        group.run([&]() {
+            try
+            {
+                while (true)
+                {
+                    const int chunkBegin = nextIndex.fetch_add(chunkSize);
+                    if (chunkBegin >= end)
+                        break;
+
+                    const int chunkEnd = std::min(end, chunkBegin + chunkSize);
+                    for (int i = chunkBegin; i < chunkEnd; ++i)
+                        func(i);
+                }
+            }
+            catch (...)
+            {
+                // skip the remaining indices
+                nextIndex = end;
+                throw;
+            }
+        });
+    }
+    group.wait();
+}
+
+}  // namespace system
+}  // namespace aliceVision
@@ -0,0 +1,147 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace aliceVision {
+namespace system {
+
+/**
+ * @brief Work-stealing task scheduler shared by the whole program.
+ *
+ * A fixed pool of worker threads executes the tasks. Each worker has its own task queue:
+ * it executes its most recently pushed task first and steals the oldest task of another queue
+ * when its own queue is empty. The threads waiting for a TaskGroup execute pending tasks meanwhile,
+ * so nested parallel loops share the same threads instead of oversubscribing the cores.
+ */
+class TaskScheduler
+{
+  public:
+    static TaskScheduler& get()
+    {
+        static TaskScheduler instance;
+        return instance;
+    }
+
+    // Singleton, no copy constructor
+    TaskScheduler(TaskScheduler const&) = delete;
+
+    // Singleton, no copy operator
+    void operator=(TaskScheduler const&) = delete;
+
+    /**
+     * @brief Set the number of threads executing the tasks, the waiting thread included.
+     * @note Should be called when no task is running (e.g. with HardwareContext::getMaxThreads at startup).
+     * @param[in] nbThreads the number of threads, 0 for the number of hardware threads
+     */
+    void setNbThreads(unsigned int nbThreads);
+
+    /**
+     * @return the number of threads executing the tasks, the waiting thread included
+     */
+    unsigned int getNbThreads() const { return _nbThreads; }
+
+    /**
+     * @brief Push a task in the queue of the calling thread.
+     * @note The task should not throw, use a TaskGroup to propagate the exceptions.
+     * @param[in] task the task to execute
+     */
+    void push(std::function<void()> task);
+
+    /**
+     * @brief Execute one pending task in the calling thread.
+     * @return false if there is no pending task
+     */
+    bool runPendingTask();
+
+  private:
+    TaskScheduler();
+    ~TaskScheduler();
+
+    struct TaskQueue
+    {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    void startWorkers(unsigned int nbWorkers);
+    void stopWorkers();
+    void workerLoop(std::size_t queueIndex);
+    bool popTask(std::function<void()>& task);
+
+    /// task queues, index 0 is shared by the threads that are not workers
+    std::vector<std::unique_ptr<TaskQueue>> _queues;
+    std::vector<std::thread> _workers;
+    std::atomic<std::size_t> _nbPendingTasks{0};
+    std::mutex _sleepMutex;
+    std::condition_variable _wakeUp;
+    bool _stopping = false;
+    unsigned int _nbThreads = 1;
+};
+
+/**
+ * @brief Group of tasks executed by the TaskScheduler.
+ */
+class TaskGroup
+{
+  public:
+    TaskGroup() = default;
+
+    // no copy constructor
+    TaskGroup(TaskGroup const&) = delete;
+
+    // no copy operator
+    void operator=(TaskGroup const&) = delete;
+
+    /**
+     * @brief Wait for the remaining tasks, their exceptions are ignored.
+     */
+    ~TaskGroup();
+
+    /**
+     * @brief Schedule a task of the group.
+     * @param[in] task the task to execute
+     */
+    void run(std::function<void()> task);
+
+    /**
+     * @brief Wait for all the tasks of the group, executing pending tasks meanwhile.
+     * @note Rethrows the first exception thrown by a task of the group.
+     */
+    void wait();
+
+  private:
+    void waitTasks();
+
+    std::atomic<std::size_t> _nbPendingTasks{0};
+    std::mutex _errorMutex;
+    std::exception_ptr _error;
+};
+
+/**
+ * @brief Execute func(i) for each i in [begin, end) with the TaskScheduler threads.
+ * @note The indices are pulled by chunks, so the load is balanced between the threads.
+ *       Rethrows the first exception thrown by func, the remaining indices are skipped.
+ * @param[in] begin the first index
+ * @param[in] end the index after the last one
+ * @param[in] func the function to execute for each index
+ * @param[in] maxConcurrency the maximum number of concurrent calls (e.g. for memory usage), 0 for no limit
+ */
+void parallelFor(int begin, int end, const std::function<void(int)>& func, int maxConcurrency = 0);
+
+}  // namespace system
+}  // namespace aliceVision
@@ -0,0 +1,84 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <aliceVision/system/TaskScheduler.hpp>
+
+#define BOOST_TEST_MODULE TaskScheduler
+
+#include <boost/test/unit_test.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace aliceVision::system;
+
+BOOST_AUTO_TEST_CASE(TaskScheduler_parallelForAllIndices)
+{
+    TaskScheduler::get().setNbThreads(4);
+
+    std::vector<int> visits(1000, 0);
+    parallelFor(0, static_cast<int>(visits.size()), [&](int i) { visits.at(i)++; });
+
+    for (int v : visits)
+        BOOST_CHECK_EQUAL(v, 1);
+}
+
+BOOST_AUTO_TEST_CASE(TaskScheduler_nestedParallelFor)
+{
+    TaskScheduler::get().setNbThreads(4);
+
+    std::atomic<int> sum(0);
+    parallelFor(0, 16, [&](int) { parallelFor(0, 100, [&](int j) { sum += j; }); });
+
+    BOOST_CHECK_EQUAL(sum, 16 * 4950);
+}
+
+BOOST_AUTO_TEST_CASE(TaskScheduler_maxConcurrency)
+{
+    TaskScheduler::get().setNbThreads(8);
+
+    std::atomic<int> running(0);
+    std::atomic<int> maxRunning(0);
+    parallelFor(
+      0,
+      64,
+      [&](int) {
+          const int r = ++running;
+          int m = maxRunning;
+          while (r > m && !maxRunning.compare_exchange_weak(m, r))
+          {
+          }
+          std::this_thread::sleep_for(std::chrono::milliseconds(1));
+          --running;
+      },
+      2);
+
+    BOOST_CHECK_LE(maxRunning, 2);
+}
+
+BOOST_AUTO_TEST_CASE(TaskScheduler_taskGroupException)
+{
+    TaskScheduler::get().setNbThreads(4);
+
+    TaskGroup group;
+    std::atomic<int> nbDone(0);
+    for (int i = 0; i < 10; ++i)
+    {
+        group.run([&, i]() {
+            if (i == 5)
+                throw std::runtime_error("task error");
+            ++nbDone;
+        });
+    }
+
+    BOOST_CHECK_THROW(group.wait(), std::runtime_error);
+    BOOST_CHECK_EQUAL(nbDone, 9);
+
+    BOOST_CHECK_THROW(parallelFor(0, 100, [](int i) { if (i == 42) throw std::runtime_error("index error"); }), std::runtime_error);
+}
@@ -0,0 +1,25 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+// Entry point of the benchmarks added with alicevision_add_benchmark (not part of the system library).
+
+#include <aliceVision/system/Logger.hpp>
+
+#include <benchmark/benchmark.h>
+
+int main(int argc, char** argv)
+{
+    // keep the logs of the benchmarked code out of the timings
+    aliceVision::system::Logger::get()->setLogLevel(aliceVision::system::EVerboseLevel::Warning);
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv))
+        return 1;
+
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
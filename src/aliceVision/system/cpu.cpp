@@ -171,3 +171,68 @@ int get_total_cpus(void) { return 1; }
 }  // namespace aliceVision
 
 #endif /* GET_TOTAL_CPUS_DEFINED */
+
+/* get_cpu_features() system specific code: uses the cpuid instruction on x86 */
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    #include <intrin.h>
+    #include <immintrin.h>
+#endif
+
+namespace aliceVision {
+namespace system {
+
+namespace {
+
+CpuFeatures detect_cpu_features()
+{
+    CpuFeatures features;
+#if defined(__aarch64__) || defined(__ARM_NEON) || defined(__ARM_NEON__)
+    features.neon = true;
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+    __builtin_cpu_init();
+    features.popcnt = __builtin_cpu_supports("popcnt");
+    features.avx2 = __builtin_cpu_supports("avx2");
+    features.fma = __builtin_cpu_supports("fma");
+    features.avx512f = __builtin_cpu_supports("avx512f");
+    features.avx512bw = __builtin_cpu_supports("avx512bw");
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    int info[4];
+    __cpuid(info, 0);
+    const int nbIds = info[0];
+    if (nbIds < 1)
+        return features;
+
+    __cpuid(info, 1);
+    features.popcnt = (info[2] & (1 << 23)) != 0;
+    features.fma = (info[2] & (1 << 12)) != 0;
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    const bool avx = (info[2] & (1 << 28)) != 0;
+    if (!osxsave || !avx)
+        return features;
+
+    // the OS must save the YMM (and ZMM) registers on context switches
+    const unsigned long long xcr0 = _xgetbv(0);
+    const bool osYmm = (xcr0 & 0x6) == 0x6;
+    const bool osZmm = (xcr0 & 0xe6) == 0xe6;
+    features.fma = features.fma && osYmm;
+    if (nbIds >= 7)
+    {
+        __cpuidex(info, 7, 0);
+        features.avx2 = osYmm && (info[1] & (1 << 5)) != 0;
+        features.avx512f = osZmm && (info[1] & (1 << 16)) != 0;
+        features.avx512bw = osZmm && (info[1] & (1 << 30)) != 0;
+    }
+#endif
+    return features;
+}
+
+}  // namespace
+
+const CpuFeatures& get_cpu_features()
+{
+    static const CpuFeatures features = detect_cpu_features();
+    return features;
+}
+
+}  // namespace system
+}  // namespace aliceVision
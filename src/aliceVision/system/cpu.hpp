@@ -22,5 +22,24 @@ int cpu_clock_by_os();
  */
 int get_total_cpus();
 
+/**
+ * @brief Instruction set extensions supported by the CPU running the program.
+ */
+struct CpuFeatures
+{
+    bool popcnt = false;
+    bool avx2 = false;
+    bool fma = false;
+    bool avx512f = false;
+    bool avx512bw = false;
+    bool neon = false;
+};
+
+/**
+ * @brief Returns the instruction set extensions of the CPU, detected once at the first call.
+ * @note The AVX extensions are only reported if the OS saves the extended registers.
+ */
+const CpuFeatures& get_cpu_features();
+
 }  // namespace system
 }  // namespace aliceVision
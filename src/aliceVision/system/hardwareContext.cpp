@@ -2,6 +2,7 @@
 
 #include "cpu.hpp"
 #include "MemoryInfo.hpp"
+#include "TaskScheduler.hpp"
 #include <aliceVision/alicevision_omp.hpp>
 
 namespace aliceVision {
@@ -18,6 +19,7 @@ void HardwareContext::displayHardware()
     }
 
     std::cout << "\tOpenMP will use " << omp_get_max_threads() << " cores" << std::endl;
+    std::cout << "\tTask scheduler will use " << system::TaskScheduler::get().getNbThreads() << " threads" << std::endl;
 
     auto meminfo = system::getMemoryInfo();
 
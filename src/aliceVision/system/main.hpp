@@ -14,10 +14,15 @@
  * To use this wrapper you need to change your source file containing \c main() as such:
  * 1. Include this header
  * 2. Rename \c main() to \c aliceVision_main()
+ *
+ * If the ALICEVISION_PROFILE_OUTPUT environment variable is set, the ALICEVISION_PROFILE_SCOPE
+ * measures are logged and written in this JSON file (or in <folder>/<program>.json if it is a folder).
  */
 
 #include "Logger.hpp"
+#include "Profiler.hpp"
 
+#include <cstdlib>
 #include <stdexcept>
 
 /**
@@ -32,9 +37,14 @@ int aliceVision_main(int argc, char* argv[]);
  * find out, something this main() function avoids. */
 int main(int argc, char* argv[])
 {
+    const char* profileOutput = std::getenv("ALICEVISION_PROFILE_OUTPUT");
+    aliceVision::system::Profiler::get().setEnabled(profileOutput != nullptr && profileOutput[0] != '\0');
+
+    int result = EXIT_FAILURE;
     try
     {
-        return aliceVision_main(argc, argv);
+        ALICEVISION_PROFILE_SCOPE("main");
+        result = aliceVision_main(argc, argv);
     }
     catch (const std::exception& e)
     {
@@ -44,5 +54,12 @@ int main(int argc, char* argv[])
     {
         ALICEVISION_LOG_FATAL("Unknown exception");
     }
-    return EXIT_FAILURE;
+
+    aliceVision::system::Profiler& profiler = aliceVision::system::Profiler::get();
+    if (profiler.isEnabled())
+    {
+        profiler.logStats();
+        profiler.writeReport(aliceVision::system::getProfileReportPath(profileOutput, argv[0]));
+    }
+    return result;
 }
@@ -0,0 +1,319 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2023 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "StreamingTracksBuilder.hpp"
+
+#include <aliceVision/matching/io.hpp>
+#include <aliceVision/track/trackIO.hpp>
+#include <aliceVision/system/Logger.hpp>
+
+#include <boost/json.hpp>
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+namespace aliceVision {
+namespace track {
+
+namespace {
+
+constexpr std::uint32_t undefinedNode = std::numeric_limits<std::uint32_t>::max();
+
+}  // namespace
+
+std::uint32_t StreamingTracksBuilder::getOrCreateNode(std::vector<std::uint32_t>& nodePerFeature,
+                                                      IndexT viewId,
+                                                      feature::EImageDescriberType descType,
+                                                      IndexT featureId)
+{
+    if (featureId >= nodePerFeature.size())
+        nodePerFeature.resize(featureId + 1, undefinedNode);
+
+    std::uint32_t& node = nodePerFeature[featureId];
+    if (node == undefinedNode)
+    {
+        if (_parent.size() >= undefinedNode)
+            throw std::runtime_error("Too many features referenced by the matches for the streaming tracks builder.");
+
+        node = static_cast<std::uint32_t>(_parent.size());
+        _nodes.push_back({viewId, featureId, descType});
+        _parent.push_back(node);
+        _rank.push_back(0);
+        _removed.push_back(false);
+    }
+    return node;
+}
+
+std::uint32_t StreamingTracksBuilder::find(std::uint32_t node)
+{
+    while (_parent[node] != node)
+    {
+        _parent[node] = _parent[_parent[node]];
+        node = _parent[node];
+    }
+    return node;
+}
+
+void StreamingTracksBuilder::join(std::uint32_t nodeA, std::uint32_t nodeB)
+{
+    std::uint32_t rootA = find(nodeA);
+    std::uint32_t rootB = find(nodeB);
+    if (rootA == rootB)
+        return;
+
+    if (_rank[rootA] < _rank[rootB])
+        std::swap(rootA, rootB);
+
+    _parent[rootB] = rootA;
+    if (_rank[rootA] == _rank[rootB])
+        ++_rank[rootA];
+}
+
+void StreamingTracksBuilder::addMatches(const Pair& pair, const MatchesPerDescType& matchesPerDesc)
+{
+    const IndexT I = pair.first;
+    const IndexT J = pair.second;
+
+    for (const auto& matchesIt : matchesPerDesc)
+    {
+        const feature::EImageDescriberType descType = matchesIt.first;
+        const IndMatches& matches = matchesIt.second;
+        if (matches.empty())
+            continue;
+
+        // std::map references remain valid on insertion
+        std::vector<std::uint32_t>& nodePerFeatureI = _nodePerFeature[std::make_pair(I, descType)];
+        std::vector<std::uint32_t>& nodePerFeatureJ = _nodePerFeature[std::make_pair(J, descType)];
+
+        // we have correspondences between I and J image index.
+        for (const IndMatch& m : matches)
+        {
+            const std::uint32_t nodeI = getOrCreateNode(nodePerFeatureI, I, descType, m._i);
+            const std::uint32_t nodeJ = getOrCreateNode(nodePerFeatureJ, J, descType, m._j);
+            join(nodeI, nodeJ);
+        }
+    }
+    _tracksUpToDate = false;
+}
+
+void StreamingTracksBuilder::addMatches(const PairwiseMatches& pairwiseMatches)
+{
+    for (const auto& matchesPerDescIt : pairwiseMatches)
+        addMatches(matchesPerDescIt.first, matchesPerDescIt.second);
+}
+
+std::size_t StreamingTracksBuilder::addMatchFiles(const std::vector<std::string>& matchFiles,
+                                                  const std::set<IndexT>& viewsKeysFilter,
+                                                  const std::vector<feature::EImageDescriberType>& descTypesFilter,
+                                                  int maxNbMatches,
+                                                  int minNbMatches)
+{
+    if (maxNbMatches > 0 && minNbMatches > maxNbMatches)
+        throw std::runtime_error("The minimum number of matches is higher than the maximum.");
+
+    const auto visitor = [&](const Pair& pair, MatchesPerDescType& matchesPerDesc) {
+        if (!viewsKeysFilter.empty() && (viewsKeysFilter.count(pair.first) == 0 || viewsKeysFilter.count(pair.second) == 0))
+            return;
+
+        for (auto it = matchesPerDesc.begin(); it != matchesPerDesc.end();)
+        {
+            IndMatches& m = it->second;
+            if (!descTypesFilter.empty() && std::find(descTypesFilter.begin(), descTypesFilter.end(), it->first) == descTypesFilter.end())
+                it = matchesPerDesc.erase(it);
+            else
+            {
+                if (minNbMatches > 0 && m.size() < minNbMatches)
+                    m.clear();
+                else if (maxNbMatches > 0 && m.size() > maxNbMatches)
+                    m.erase(m.begin() + maxNbMatches, m.end());
+                ++it;
+            }
+        }
+        addMatches(pair, matchesPerDesc);
+    };
+
+    std::size_t nbLoadedMatchFiles = 0;
+    for (const std::string& matchFile : matchFiles)
+    {
+        ALICEVISION_LOG_DEBUG("Streaming match file: " << matchFile);
+        if (!matching::VisitMatchFile(matchFile, visitor))
+        {
+            ALICEVISION_LOG_WARNING("Unable to load match file: " << matchFile);
+            continue;
+        }
+        ++nbLoadedMatchFiles;
+    }
+
+    ALICEVISION_LOG_DEBUG("Streaming tracks builder: " << nbNodes() << " features referenced by the matches.");
+    return nbLoadedMatchFiles;
+}
+
+void StreamingTracksBuilder::updateTracks()
+{
+    if (_tracksUpToDate)
+        return;
+
+    const std::size_t nbNodes = _parent.size();
+
+    // assign a track index to each valid root, in order of first appearance
+    std::vector<std::uint32_t> trackPerNode(nbNodes, undefinedNode);
+    std::vector<std::uint32_t> trackPerRoot(nbNodes, undefinedNode);
+    std::uint32_t nbTracks = 0;
+    for (std::uint32_t node = 0; node < nbNodes; ++node)
+    {
+        const std::uint32_t root = find(node);
+        if (_removed[root])
+            continue;
+        if (trackPerRoot[root] == undefinedNode)
+            trackPerRoot[root] = nbTracks++;
+        trackPerNode[node] = trackPerRoot[root];
+    }
+    trackPerRoot.clear();
+    trackPerRoot.shrink_to_fit();
+
+    // counting sort of the nodes per track
+    _trackOffsets.assign(nbTracks + 1, 0);
+    for (std::uint32_t node = 0; node < nbNodes; ++node)
+    {
+        if (trackPerNode[node] != undefinedNode)
+            ++_trackOffsets[trackPerNode[node] + 1];
+    }
+    for (std::uint32_t t = 0; t < nbTracks; ++t)
+        _trackOffsets[t + 1] += _trackOffsets[t];
+
+    _trackNodes.resize(_trackOffsets.back());
+    {
+        std::vector<std::uint32_t> insertPos(_trackOffsets.begin(), _trackOffsets.end() - 1);
+        for (std::uint32_t node = 0; node < nbNodes; ++node)
+        {
+            if (trackPerNode[node] != undefinedNode)
+                _trackNodes[insertPos[trackPerNode[node]]++] = node;
+        }
+    }
+
+    // sort the nodes of each track by view
+#pragma omp parallel for schedule(dynamic, 1024)
+    for (std::int64_t t = 0; t < static_cast<std::int64_t>(nbTracks); ++t)
+    {
+        std::sort(_trackNodes.begin() + _trackOffsets[t], _trackNodes.begin() + _trackOffsets[t + 1], [&](std::uint32_t a, std::uint32_t b) {
+            if (_nodes[a].viewId == _nodes[b].viewId)
+                return _nodes[a].featureId < _nodes[b].featureId;
+            return _nodes[a].viewId < _nodes[b].viewId;
+        });
+    }
+
+    _tracksUpToDate = true;
+}
+
+template<class Visitor>
+void StreamingTracksBuilder::visitTracks(Visitor visitor)
+{
+    updateTracks();
+    const std::size_t nbTracks = _trackOffsets.empty() ? 0 : _trackOffsets.size() - 1;
+    for (std::size_t t = 0; t < nbTracks; ++t)
+        visitor(t, _trackNodes.data() + _trackOffsets[t], _trackNodes.data() + _trackOffsets[t + 1]);
+}
+
+void StreamingTracksBuilder::filter(bool clearForks, std::size_t minTrackLength, bool multithreaded)
+{
+    // remove bad tracks:
+    // - track that are too short,
+    // - track with id conflicts (many times the same image index)
+    if (!clearForks && minTrackLength == 0)
+        return;
+
+    updateTracks();
+
+    const std::int64_t nbTracks = _trackOffsets.empty() ? 0 : _trackOffsets.size() - 1;
+    std::vector<std::uint8_t> toRemove(nbTracks, 0);
+
+#pragma omp parallel for if (multithreaded) schedule(dynamic, 1024)
+    for (std::int64_t t = 0; t < nbTracks; ++t)
+    {
+        const std::uint32_t* first = _trackNodes.data() + _trackOffsets[t];
+        const std::uint32_t* last = _trackNodes.data() + _trackOffsets[t + 1];
+
+        // nodes are sorted by view: count the distinct views
+        std::size_t nbViews = 0;
+        for (const std::uint32_t* it = first; it != last; ++it)
+        {
+            if (it == first || _nodes[*it].viewId != _nodes[*(it - 1)].viewId)
+                ++nbViews;
+        }
+        const std::size_t trackLength = last - first;
+        if ((clearForks && nbViews != trackLength) || nbViews < minTrackLength)
+            toRemove[t] = 1;
+    }
+
+    for (std::int64_t t = 0; t < nbTracks; ++t)
+    {
+        if (toRemove[t])
+            _removed[find(_trackNodes[_trackOffsets[t]])] = true;
+    }
+    _tracksUpToDate = false;
+}
+
+bool StreamingTracksBuilder::exportToStream(std::ostream& os)
+{
+    visitTracks([&](std::size_t trackIndex, const std::uint32_t* first, const std::uint32_t* last) {
+        os << "Class: " << trackIndex << std::endl;
+        os << "\t"
+           << "track length: " << (last - first) << std::endl;
+
+        for (const std::uint32_t* it = first; it != last; ++it)
+        {
+            const Node& node = _nodes[*it];
+            os << node.viewId << "  " << KeypointId(node.descType, node.featureId) << std::endl;
+        }
+    });
+    return os.good();
+}
+
+bool StreamingTracksBuilder::exportToJsonStream(std::ostream& os)
+{
+    os << "[";
+    visitTracks([&](std::size_t trackIndex, const std::uint32_t* first, const std::uint32_t* last) {
+        Track track;
+        track.descType = _nodes[*first].descType;
+        track.featPerView.reserve(last - first);
+        for (const std::uint32_t* it = first; it != last; ++it)
+            track.featPerView[_nodes[*it].viewId].featureId = _nodes[*it].featureId;
+
+        if (trackIndex > 0)
+            os << ",";
+        os << "[" << trackIndex << "," << boost::json::serialize(boost::json::value_from(track)) << "]";
+    });
+    os << "]";
+    return os.good();
+}
+
+void StreamingTracksBuilder::exportToSTL(TracksMap& allTracks)
+{
+    allTracks.clear();
+    allTracks.reserve(nbTracks());
+
+    visitTracks([&](std::size_t trackIndex, const std::uint32_t* first, const std::uint32_t* last) {
+        Track& outTrack = allTracks.emplace_hint(allTracks.end(), trackIndex, Track())->second;
+        outTrack.featPerView.reserve(last - first);
+        for (const std::uint32_t* it = first; it != last; ++it)
+        {
+            const Node& node = _nodes[*it];
+            // all descType inside the track will be the same
+            outTrack.descType = node.descType;
+            outTrack.featPerView[node.viewId].featureId = node.featureId;
+        }
+    });
+}
+
+std::size_t StreamingTracksBuilder::nbTracks()
+{
+    updateTracks();
+    return _trackOffsets.empty() ? 0 : _trackOffsets.size() - 1;
+}
+
+}  // namespace track
+}  // namespace aliceVision
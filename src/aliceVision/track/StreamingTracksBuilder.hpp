@@ -0,0 +1,148 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2023 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <aliceVision/track/Track.hpp>
+
+#include <cstdint>
+#include <map>
+#include <ostream>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace aliceVision {
+namespace track {
+
+/**
+ * @brief Out-of-core alternative to TracksBuilder for very large match graphs.
+ *
+ * Matches are consumed pair by pair (from memory or directly from the match files)
+ * and merged into a compact union-find arena with 32-bit node indices:
+ * only the features referenced by at least one match are stored, and the matches
+ * themselves are never kept in memory.
+ *
+ * Usage:
+ * @code{.cpp}
+ *  StreamingTracksBuilder tracksBuilder;
+ *  tracksBuilder.addMatchFiles(matching::ListMatchFiles(matchesFolders), viewsKeys, descTypes);
+ *  tracksBuilder.filter();                    // filter: Remove track that have conflict
+ *  tracksBuilder.exportToJsonStream(stream);  // write tracks incrementally
+ * @endcode
+ */
+class StreamingTracksBuilder
+{
+  public:
+    /**
+     * @brief Merge the matches of one image pair into the tracks
+     * @param[in] pair The image pair
+     * @param[in] matchesPerDesc The matches of the image pair per describer type
+     */
+    void addMatches(const Pair& pair, const MatchesPerDescType& matchesPerDesc);
+
+    /**
+     * @brief Merge a series of pairWise matches into the tracks
+     * @param[in] pairwiseMatches PairWise matches
+     */
+    void addMatches(const PairwiseMatches& pairwiseMatches);
+
+    /**
+     * @brief Stream the given match files pair by pair and merge their matches into the tracks
+     * @param[in] matchFiles The match files to read
+     * @param[in] viewsKeysFilter Restrict the matches to these views (empty keeps all views)
+     * @param[in] descTypesFilter Restrict the matches to these types of descriptors (empty keeps all types)
+     * @param[in] maxNbMatches keep at most \p maxNbMatches matches per pair and describer type (0 takes all matches)
+     * @param[in] minNbMatches discard the pairs with less than \p minNbMatches per describer type (0 takes all pairs)
+     * @return the number of match files read
+     */
+    std::size_t addMatchFiles(const std::vector<std::string>& matchFiles,
+                              const std::set<IndexT>& viewsKeysFilter,
+                              const std::vector<feature::EImageDescriberType>& descTypesFilter,
+                              int maxNbMatches = 0,
+                              int minNbMatches = 0);
+
+    /**
+     * @brief Remove bad tracks (too short or track with ids collision)
+     * @param[in] clearForks: remove tracks with multiple observation in a single image
+     * @param[in] minTrackLength: minimal number of observations to keep the track
+     * @param[in] multithreaded Is multithreaded
+     */
+    void filter(bool clearForks = true, std::size_t minTrackLength = 2, bool multithreaded = true);
+
+    /**
+     * @brief Export data of tracks to stream (same format as TracksBuilder::exportToStream)
+     * @param[out] os char output stream
+     * @return true if no error flag are set
+     */
+    bool exportToStream(std::ostream& os);
+
+    /**
+     * @brief Write the tracks to a JSON stream, track by track, without building a TracksMap.
+     *        The output is identical to the serialization of the TracksMap returned by exportToSTL.
+     * @param[out] os char output stream
+     * @return true if no error flag are set
+     */
+    bool exportToJsonStream(std::ostream& os);
+
+    /**
+     * @brief Export tracks as a map (each entry is a sequence of imageId and keypointId):
+     *        {TrackIndex => {(imageIndex, keypointId), ... ,(imageIndex, keypointId)}
+     */
+    void exportToSTL(TracksMap& allTracks);
+
+    /**
+     * @brief Return the number of tracks
+     */
+    std::size_t nbTracks();
+
+    /**
+     * @brief Return the number of features (union-find nodes) referenced by the matches
+     */
+    std::size_t nbNodes() const { return _parent.size(); }
+
+  private:
+    /// Feature of a view referenced by a union-find node
+    struct Node
+    {
+        IndexT viewId;
+        std::uint32_t featureId;
+        feature::EImageDescriberType descType;
+    };
+
+    /// Return (and create if needed) the node index of a feature
+    std::uint32_t getOrCreateNode(std::vector<std::uint32_t>& nodePerFeature, IndexT viewId, feature::EImageDescriberType descType, IndexT featureId);
+
+    /// Return the root node of the given node (with path halving)
+    std::uint32_t find(std::uint32_t node);
+
+    /// Merge the sets of the two given nodes (union by rank)
+    void join(std::uint32_t nodeA, std::uint32_t nodeB);
+
+    /// Group the nodes per track (CSR layout) if the union-find has changed
+    void updateTracks();
+
+    /// Call \p visitor(trackIndex, firstNode, lastNode) for each track with sorted node ranges
+    template<class Visitor>
+    void visitTracks(Visitor visitor);
+
+    /// node index per feature id for each (view, describer type)
+    std::map<std::pair<IndexT, feature::EImageDescriberType>, std::vector<std::uint32_t>> _nodePerFeature;
+    /// union-find arena
+    std::vector<Node> _nodes;
+    std::vector<std::uint32_t> _parent;
+    std::vector<std::uint8_t> _rank;
+    /// removed tracks (flagged on their root node)
+    std::vector<bool> _removed;
+
+    /// tracks in CSR layout: nodes of track t are _trackNodes[_trackOffsets[t] .. _trackOffsets[t + 1]]
+    std::vector<std::uint32_t> _trackOffsets;
+    std::vector<std::uint32_t> _trackNodes;
+    bool _tracksUpToDate = false;
+};
+
+}  // namespace track
+}  // namespace aliceVision
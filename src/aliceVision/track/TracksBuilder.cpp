@@ -7,6 +7,9 @@
 
 #include "TracksBuilder.hpp"
 
+#include <aliceVision/system/TaskScheduler.hpp>
+#include <aliceVision/stl/DynamicBitset.hpp>
+
 #include <lemon/list_graph.h>
 #include <lemon/unionfind.h>
 
@@ -21,21 +24,24 @@ using IndexedFeaturePair = std::pair<std::size_t, KeypointId>;
 using IndexMap = lemon::ListDigraph::NodeMap<std::size_t>;
 using UnionFindObject = lemon::UnionFindEnum<IndexMap>;
 
-using MapNodeToIndex = stl::flat_map<lemon::ListDigraph::Node, IndexedFeaturePair>;
 using MapIndexToNode = stl::flat_map<IndexedFeaturePair, lemon::ListDigraph::Node>;
 
 struct TracksBuilderData
 {
     /// graph container to create the node
     lemon::ListDigraph graph;
-    /// node to index map
-    MapNodeToIndex map_nodeToIndex;
+    /// feature of each node, indexed by the node id (the nodes are never erased)
+    std::vector<IndexedFeaturePair> featurePerNode;
+    /// dense index of the view of each node, indexed by the node id
+    std::vector<std::size_t> viewIndexPerNode;
+    /// number of views referenced by the features
+    std::size_t nbViews = 0;
     std::unique_ptr<IndexMap> index;
     std::unique_ptr<UnionFindObject> tracksUF;
 
     const UnionFindObject& getUnionFindEnum() const { return *tracksUF; }
 
-    const MapNodeToIndex& getReverseMap() const { return map_nodeToIndex; }
+    inline const IndexedFeaturePair& getFeature(const lemon::ListDigraph::Node& node) const { return featurePerNode[lemon::ListDigraph::id(node)]; }
 };
 
 TracksBuilder::TracksBuilder() { _d.reset(new TracksBuilderData()); }
@@ -74,13 +80,21 @@ void TracksBuilder::build(const PairwiseMatches& pairwiseMatches)
     // build the node indirection for each referenced feature
     MapIndexToNode map_indexToNode;
     map_indexToNode.reserve(allFeatures.size());
-    _d->map_nodeToIndex.reserve(allFeatures.size());
+    _d->featurePerNode.reserve(allFeatures.size());
+    _d->viewIndexPerNode.reserve(allFeatures.size());
+    _d->nbViews = 0;
 
+    // the features are sorted by view: the dense view index changes with the view id
     for (const IndexedFeaturePair& featPair : allFeatures)
     {
+        if (_d->featurePerNode.empty() || _d->featurePerNode.back().first != featPair.first)
+            ++_d->nbViews;
+
         lemon::ListDigraph::Node node = _d->graph.addNode();
-        map_indexToNode.insert(std::make_pair(featPair, node));
-        _d->map_nodeToIndex.insert(std::make_pair(node, featPair));
+        assert(lemon::ListDigraph::id(node) == static_cast<int>(_d->featurePerNode.size()));
+        map_indexToNode.insert(map_indexToNode.end(), std::make_pair(featPair, node));
+        _d->featurePerNode.push_back(featPair);
+        _d->viewIndexPerNode.push_back(_d->nbViews - 1);
     }
 
     // add the element of myset to the UnionFind insert method.
@@ -122,29 +136,61 @@ void TracksBuilder::filter(bool clearForks, std::size_t minTrackLength, bool mul
     if (!clearForks && minTrackLength == 0)
         return;
 
-    std::set<int> set_classToErase;
-
-#pragma omp parallel if (multithreaded)
+    std::vector<int> classes;
     for (lemon::UnionFindEnum<IndexMap>::ClassIt cit(*_d->tracksUF); cit != INVALID; ++cit)
-    {
-#pragma omp single nowait
+        classes.push_back(cit.operator int());
+
+    std::vector<char> classToErase(classes.size(), 0);
+
+    // the classes are checked by chunks, each with its own bitset of the views of the current track
+    const int chunkSize = 4096;
+    const int nbClasses = static_cast<int>(classes.size());
+    const int nbChunks = (nbClasses + chunkSize - 1) / chunkSize;
+
+    const auto checkClasses = [&](int chunk) {
+        stl::dynamic_bitset viewInTrack(_d->nbViews);
+        std::vector<std::size_t> trackViews;
+
+        const int end = std::min(nbClasses, (chunk + 1) * chunkSize);
+        for (int i = chunk * chunkSize; i < end; ++i)
         {
-            std::size_t cpt = 0;
-            std::set<std::size_t> myset;
-            for (lemon::UnionFindEnum<IndexMap>::ItemIt iit(*_d->tracksUF, cit); iit != INVALID; ++iit)
+            bool hasFork = false;
+            for (lemon::UnionFindEnum<IndexMap>::ItemIt iit(*_d->tracksUF, classes[i]); iit != INVALID; ++iit)
             {
-                myset.insert(_d->map_nodeToIndex[iit].first);
-                ++cpt;
-            }
-            if ((clearForks && myset.size() != cpt) || myset.size() < minTrackLength)
-            {
-#pragma omp critical
-                set_classToErase.insert(cit.operator int());
+                const std::size_t viewIndex = _d->viewIndexPerNode[lemon::ListDigraph::id(iit)];
+                if (viewInTrack[viewIndex])
+                {
+                    hasFork = true;
+                    // the track is erased whatever its length
+                    if (clearForks)
+                        break;
+                    continue;
+                }
+                viewInTrack[viewIndex] = true;
+                trackViews.push_back(viewIndex);
             }
+
+            if ((clearForks && hasFork) || trackViews.size() < minTrackLength)
+                classToErase[i] = 1;
+
+            // reset the bitset for the next track
+            for (const std::size_t viewIndex : trackViews)
+                viewInTrack[viewIndex] = false;
+            trackViews.clear();
         }
-    }
+    };
+
+    if (multithreaded)
+        system::parallelFor(0, nbChunks, checkClasses);
+    else
+        for (int chunk = 0; chunk < nbChunks; ++chunk)
+            checkClasses(chunk);
 
-    std::for_each(set_classToErase.begin(), set_classToErase.end(), [&](int toErase) { _d->tracksUF->eraseClass(toErase); });
+    for (std::size_t i = 0; i < classes.size(); ++i)
+    {
+        if (classToErase[i])
+            _d->tracksUF->eraseClass(classes[i]);
+    }
 }
 
 bool TracksBuilder::exportToStream(std::ostream& os)
@@ -163,7 +209,8 @@ bool TracksBuilder::exportToStream(std::ostream& os)
 
         for (lemon::UnionFindEnum<IndexMap>::ItemIt iit(*_d->tracksUF, cit); iit != INVALID; ++iit)
         {
-            os << _d->map_nodeToIndex[iit].first << "  " << _d->map_nodeToIndex[iit].second << std::endl;
+            const IndexedFeaturePair& currentPair = _d->getFeature(iit);
+            os << currentPair.first << "  " << currentPair.second << std::endl;
         }
     }
     return os.good();
@@ -183,7 +230,7 @@ void TracksBuilder::exportToSTL(TracksMap& allTracks) const
 
         for (lemon::UnionFindEnum<IndexMap>::ItemIt iit(*_d->tracksUF, cit); iit != INVALID; ++iit)
         {
-            const IndexedFeaturePair& currentPair = _d->map_nodeToIndex.at(iit);
+            const IndexedFeaturePair& currentPair = _d->getFeature(iit);
             // all descType inside the track will be the same
             outTrack.descType = currentPair.second.descType;
             outTrack.featPerView[currentPair.first].featureId = currentPair.second.featIndex;
@@ -6,9 +6,141 @@
 
 #include "trackIO.hpp"
 
+#include <aliceVision/track/tracksUtils.hpp>
+#include <aliceVision/system/Logger.hpp>
+#include <aliceVision/alicevision_omp.hpp>
+
+#include <boost/algorithm/string/case_conv.hpp>
+#include <boost/filesystem.hpp>
+
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <vector>
+
 namespace aliceVision {
 namespace track {
 
+namespace {
+
+constexpr char fileMagic[8] = {'A', 'V', 'T', 'R', 'A', 'C', 'K', 'S'};
+constexpr std::uint32_t fileVersion = 1;
+constexpr std::uint64_t sectionAlignment = 64;
+
+struct FileHeader
+{
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t nbSections;
+    char reserved[16];
+};
+
+struct SectionEntry
+{
+    std::uint32_t type;
+    std::uint32_t elementSize;
+    std::uint64_t nbElements;
+    std::uint64_t offset;
+    std::uint64_t reserved;
+};
+
+/// observation of a track, element of the OBSERVATIONS section
+struct Observation
+{
+    std::uint32_t viewId;
+    std::uint32_t featureId;
+};
+
+static_assert(sizeof(FileHeader) == 32, "Unexpected binary tracks header size");
+static_assert(sizeof(SectionEntry) == 32, "Unexpected binary tracks section entry size");
+static_assert(sizeof(Observation) == 2 * sizeof(std::uint32_t), "Observation is not packed");
+
+/// contiguous array to write in a section
+struct SectionData
+{
+    EBinaryTracksSection type;
+    std::uint32_t elementSize;
+    std::uint64_t nbElements;
+    const void* data;
+};
+
+template<class T>
+SectionData makeSection(EBinaryTracksSection type, const std::vector<T>& values)
+{
+    return {type, static_cast<std::uint32_t>(sizeof(T)), values.size(), values.data()};
+}
+
+std::uint64_t alignOffset(std::uint64_t offset) { return (offset + sectionAlignment - 1) / sectionAlignment * sectionAlignment; }
+
+void checkByteOrder()
+{
+    const std::uint16_t value = 1;
+    unsigned char firstByte;
+    std::memcpy(&firstByte, &value, 1);
+    if (firstByte != 1)
+        ALICEVISION_THROW_ERROR("The binary tracks format is only supported on little-endian platforms.");
+}
+
+const SectionEntry* findSection(const std::vector<SectionEntry>& sections, EBinaryTracksSection type)
+{
+    for (const SectionEntry& section : sections)
+    {
+        if (section.type == static_cast<std::uint32_t>(type))
+            return &section;
+    }
+    return nullptr;
+}
+
+template<class T>
+void readSection(std::ifstream& file, const SectionEntry& section, std::vector<T>& values, const std::string& filepath)
+{
+    if (section.elementSize != sizeof(T))
+    {
+        ALICEVISION_THROW_ERROR("Invalid element size (" << section.elementSize << ") of the section " << section.type
+                                                         << " in the binary tracks file: " << filepath);
+    }
+    values.resize(section.nbElements);
+    file.seekg(section.offset);
+    file.read(reinterpret_cast<char*>(values.data()), static_cast<std::streamsize>(section.nbElements * sizeof(T)));
+    if (!file)
+        ALICEVISION_THROW_ERROR("Cannot read the section " << section.type << " of the binary tracks file: " << filepath);
+}
+
+/// read a required section
+template<class T>
+void readSection(std::ifstream& file,
+                 const std::vector<SectionEntry>& sections,
+                 EBinaryTracksSection type,
+                 std::vector<T>& values,
+                 const std::string& filepath)
+{
+    const SectionEntry* section = findSection(sections, type);
+    if (section == nullptr)
+        ALICEVISION_THROW_ERROR("Missing section " << static_cast<std::uint32_t>(type) << " in the binary tracks file: " << filepath);
+    readSection(file, *section, values, filepath);
+}
+
+/**
+ * @brief Check compressed row offsets.
+ * @return true if there is one offset per row + 1, starting at 0, increasing and ending at the number of elements
+ */
+bool validOffsets(const std::vector<std::uint64_t>& offsets, std::size_t nbRows, std::size_t nbElements)
+{
+    if (offsets.size() != nbRows + 1 || offsets.front() != 0 || offsets.back() != nbElements)
+        return false;
+    for (std::size_t i = 0; i < nbRows; ++i)
+    {
+        if (offsets[i] > offsets[i + 1])
+            return false;
+    }
+    return true;
+}
+
+}  // namespace
+
 void tag_invoke(const boost::json::value_from_tag&, boost::json::value& jv, aliceVision::track::TrackItem const& input)
 {
     jv = {{"featureId", boost::json::value_from(input.featureId)}};
@@ -40,5 +172,268 @@ aliceVision::track::Track tag_invoke(boost::json::value_to_tag<aliceVision::trac
     return ret;
 }
 
+bool isBinaryTracksFile(const std::string& filepath)
+{
+    return boost::algorithm::to_lower_copy(boost::filesystem::path(filepath).extension().string()) == binaryTracksExtension;
+}
+
+void saveBinaryTracks(const TracksMap& tracks, const std::string& filepath)
+{
+    checkByteOrder();
+
+    const int nbTracks = tracks.size();
+
+    std::vector<std::uint64_t> trackIds(nbTracks);
+    std::vector<std::uint32_t> trackDescTypes(nbTracks);
+    std::vector<std::uint64_t> trackOffsets(nbTracks + 1, 0);
+    for (int i = 0; i < nbTracks; ++i)
+    {
+        const auto trackIt = tracks.begin() + i;
+        trackIds[i] = trackIt->first;
+        trackDescTypes[i] = static_cast<std::uint32_t>(trackIt->second.descType);
+        trackOffsets[i + 1] = trackOffsets[i] + trackIt->second.featPerView.size();
+    }
+
+    // the observations of all the tracks in a single array
+    std::vector<Observation> observations(trackOffsets.back());
+    bool validIds = true;
+#pragma omp parallel for reduction(&& : validIds)
+    for (int i = 0; i < nbTracks; ++i)
+    {
+        std::uint64_t o = trackOffsets[i];
+        for (const auto& featIt : (tracks.begin() + i)->second.featPerView)
+        {
+            validIds = validIds && featIt.first <= std::numeric_limits<std::uint32_t>::max() &&
+                       featIt.second.featureId <= std::numeric_limits<std::uint32_t>::max();
+            observations[o++] = {static_cast<std::uint32_t>(featIt.first), static_cast<std::uint32_t>(featIt.second.featureId)};
+        }
+    }
+    if (!validIds)
+        ALICEVISION_THROW_ERROR("View or feature id out of the 32-bit range, cannot save the binary tracks file: " << filepath);
+
+    // the tracks per view index in the same layout
+    TracksPerView tracksPerView;
+    computeTracksPerView(tracks, tracksPerView);
+
+    const int nbViews = tracksPerView.size();
+    std::vector<std::uint32_t> viewIds(nbViews);
+    std::vector<std::uint64_t> viewOffsets(nbViews + 1, 0);
+    for (int i = 0; i < nbViews; ++i)
+    {
+        const auto viewIt = tracksPerView.begin() + i;
+        viewIds[i] = static_cast<std::uint32_t>(viewIt->first);
+        viewOffsets[i + 1] = viewOffsets[i] + viewIt->second.size();
+    }
+
+    std::vector<std::uint64_t> viewTrackIds(viewOffsets.back());
+#pragma omp parallel for
+    for (int i = 0; i < nbViews; ++i)
+    {
+        const TrackIdSet& viewTracks = (tracksPerView.begin() + i)->second;
+        std::copy(viewTracks.begin(), viewTracks.end(), viewTrackIds.begin() + viewOffsets[i]);
+    }
+
+    const std::vector<SectionData> sections = {makeSection(EBinaryTracksSection::TRACK_IDS, trackIds),
+                                               makeSection(EBinaryTracksSection::TRACK_DESC_TYPES, trackDescTypes),
+                                               makeSection(EBinaryTracksSection::TRACK_OFFSETS, trackOffsets),
+                                               makeSection(EBinaryTracksSection::OBSERVATIONS, observations),
+                                               makeSection(EBinaryTracksSection::VIEW_IDS, viewIds),
+                                               makeSection(EBinaryTracksSection::VIEW_OFFSETS, viewOffsets),
+                                               makeSection(EBinaryTracksSection::VIEW_TRACK_IDS, viewTrackIds)};
+
+    FileHeader header{};
+    std::memcpy(header.magic, fileMagic, sizeof(fileMagic));
+    header.version = fileVersion;
+    header.nbSections = static_cast<std::uint32_t>(sections.size());
+
+    std::vector<SectionEntry> entries(sections.size());
+    std::uint64_t offset = alignOffset(sizeof(FileHeader) + sections.size() * sizeof(SectionEntry));
+    for (std::size_t i = 0; i < sections.size(); ++i)
+    {
+        entries[i] = {static_cast<std::uint32_t>(sections[i].type), sections[i].elementSize, sections[i].nbElements, offset, 0};
+        offset = alignOffset(offset + sections[i].elementSize * sections[i].nbElements);
+    }
+
+    std::ofstream file(filepath, std::ios::binary);
+    if (!file)
+        ALICEVISION_THROW_ERROR("Cannot open the binary tracks file: " << filepath);
+
+    file.write(reinterpret_cast<const char*>(&header), sizeof(FileHeader));
+    file.write(reinterpret_cast<const char*>(entries.data()), static_cast<std::streamsize>(entries.size() * sizeof(SectionEntry)));
+
+    std::uint64_t position = sizeof(FileHeader) + entries.size() * sizeof(SectionEntry);
+    const char padding[sectionAlignment] = {};
+    for (std::size_t i = 0; i < sections.size(); ++i)
+    {
+        file.write(padding, static_cast<std::streamsize>(entries[i].offset - position));
+        const std::uint64_t size = sections[i].elementSize * sections[i].nbElements;
+        file.write(static_cast<const char*>(sections[i].data), static_cast<std::streamsize>(size));
+        position = entries[i].offset + size;
+    }
+
+    if (!file)
+        ALICEVISION_THROW_ERROR("Cannot write the binary tracks file: " << filepath);
+
+    ALICEVISION_LOG_DEBUG("Binary tracks saved: " << filepath << " (" << nbTracks << " tracks, " << observations.size() << " observations).");
+}
+
+void loadBinaryTracks(TracksMap& tracks, TracksPerView* tracksPerView, const std::string& filepath)
+{
+    checkByteOrder();
+
+    std::ifstream file(filepath, std::ios::binary | std::ios::ate);
+    if (!file)
+        ALICEVISION_THROW_ERROR("Cannot open the binary tracks file: " << filepath);
+    const std::uint64_t fileSize = static_cast<std::uint64_t>(file.tellg());
+    file.seekg(0);
+
+    FileHeader header;
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(FileHeader)) || std::memcmp(header.magic, fileMagic, sizeof(fileMagic)) != 0)
+        ALICEVISION_THROW_ERROR("Invalid binary tracks file: " << filepath);
+    if (header.version != fileVersion)
+        ALICEVISION_THROW_ERROR("Unsupported binary tracks version " << header.version << " in file: " << filepath);
+
+    std::vector<SectionEntry> sections(header.nbSections);
+    if (sizeof(FileHeader) + sections.size() * sizeof(SectionEntry) > fileSize ||
+        !file.read(reinterpret_cast<char*>(sections.data()), static_cast<std::streamsize>(sections.size() * sizeof(SectionEntry))))
+    {
+        ALICEVISION_THROW_ERROR("Cannot read the section table of the binary tracks file: " << filepath);
+    }
+    for (const SectionEntry& section : sections)
+    {
+        if (section.elementSize == 0 || section.offset > fileSize || section.nbElements > (fileSize - section.offset) / section.elementSize)
+            ALICEVISION_THROW_ERROR("The section " << section.type << " is out of the binary tracks file: " << filepath);
+    }
+
+    std::vector<std::uint64_t> trackIds;
+    std::vector<std::uint32_t> trackDescTypes;
+    std::vector<std::uint64_t> trackOffsets;
+    std::vector<Observation> observations;
+    readSection(file, sections, EBinaryTracksSection::TRACK_IDS, trackIds, filepath);
+    readSection(file, sections, EBinaryTracksSection::TRACK_DESC_TYPES, trackDescTypes, filepath);
+    readSection(file, sections, EBinaryTracksSection::TRACK_OFFSETS, trackOffsets, filepath);
+    readSection(file, sections, EBinaryTracksSection::OBSERVATIONS, observations, filepath);
+
+    const int nbTracks = trackIds.size();
+    if (trackDescTypes.size() != trackIds.size() || !validOffsets(trackOffsets, trackIds.size(), observations.size()))
+        ALICEVISION_THROW_ERROR("Inconsistent track sections in the binary tracks file: " << filepath);
+    for (int i = 1; i < nbTracks; ++i)
+    {
+        if (trackIds[i - 1] >= trackIds[i])
+            ALICEVISION_THROW_ERROR("The track ids are not sorted in the binary tracks file: " << filepath);
+    }
+
+    // the sorted keys are appended, then the tracks are filled in parallel
+    tracks.clear();
+    tracks.reserve(nbTracks);
+    for (int i = 0; i < nbTracks; ++i)
+        tracks.emplace_hint(tracks.end(), trackIds[i], Track());
+
+    bool validObservations = true;
+#pragma omp parallel for reduction(&& : validObservations)
+    for (int i = 0; i < nbTracks; ++i)
+    {
+        Track& track = (tracks.begin() + i)->second;
+        track.descType = static_cast<feature::EImageDescriberType>(trackDescTypes[i]);
+        track.featPerView.reserve(trackOffsets[i + 1] - trackOffsets[i]);
+        for (std::uint64_t o = trackOffsets[i]; o < trackOffsets[i + 1]; ++o)
+        {
+            validObservations = validObservations && (o == trackOffsets[i] || observations[o - 1].viewId < observations[o].viewId);
+            track.featPerView.emplace_hint(track.featPerView.end(), observations[o].viewId, TrackItem{observations[o].featureId});
+        }
+    }
+    if (!validObservations)
+        ALICEVISION_THROW_ERROR("The observations are not sorted by view in the binary tracks file: " << filepath);
+
+    if (tracksPerView == nullptr)
+        return;
+
+    std::vector<std::uint32_t> viewIds;
+    std::vector<std::uint64_t> viewOffsets;
+    std::vector<std::uint64_t> viewTrackIds;
+    readSection(file, sections, EBinaryTracksSection::VIEW_IDS, viewIds, filepath);
+    readSection(file, sections, EBinaryTracksSection::VIEW_OFFSETS, viewOffsets, filepath);
+    readSection(file, sections, EBinaryTracksSection::VIEW_TRACK_IDS, viewTrackIds, filepath);
+
+    const int nbViews = viewIds.size();
+    if (viewTrackIds.size() != observations.size() || !validOffsets(viewOffsets, viewIds.size(), viewTrackIds.size()))
+        ALICEVISION_THROW_ERROR("Inconsistent tracks per view sections in the binary tracks file: " << filepath);
+    for (int i = 1; i < nbViews; ++i)
+    {
+        if (viewIds[i - 1] >= viewIds[i])
+            ALICEVISION_THROW_ERROR("The view ids are not sorted in the binary tracks file: " << filepath);
+    }
+
+    tracksPerView->clear();
+    tracksPerView->reserve(nbViews);
+    for (int i = 0; i < nbViews; ++i)
+        tracksPerView->emplace_hint(tracksPerView->end(), viewIds[i], TrackIdSet());
+
+#pragma omp parallel for
+    for (int i = 0; i < nbViews; ++i)
+    {
+        (tracksPerView->begin() + i)->second.assign(viewTrackIds.begin() + viewOffsets[i], viewTrackIds.begin() + viewOffsets[i + 1]);
+    }
+
+    ALICEVISION_LOG_DEBUG("Binary tracks loaded: " << filepath << " (" << nbTracks << " tracks, " << observations.size() << " observations).");
+}
+
+bool saveTracks(const TracksMap& tracks, const std::string& filepath)
+{
+    if (isBinaryTracksFile(filepath))
+    {
+        try
+        {
+            saveBinaryTracks(tracks, filepath);
+        }
+        catch (const std::exception& e)
+        {
+            ALICEVISION_LOG_ERROR(e.what());
+            return false;
+        }
+        return true;
+    }
+
+    std::ofstream file(filepath);
+    if (!file.is_open())
+    {
+        ALICEVISION_LOG_ERROR("Unable to write the tracks file: " << filepath);
+        return false;
+    }
+    file << boost::json::serialize(boost::json::value_from(tracks));
+    return static_cast<bool>(file);
+}
+
+bool loadTracks(TracksMap& tracks, TracksPerView& tracksPerView, const std::string& filepath)
+{
+    if (isBinaryTracksFile(filepath))
+    {
+        try
+        {
+            loadBinaryTracks(tracks, &tracksPerView, filepath);
+        }
+        catch (const std::exception& e)
+        {
+            ALICEVISION_LOG_ERROR(e.what());
+            return false;
+        }
+        return true;
+    }
+
+    std::ifstream file(filepath);
+    if (!file.is_open())
+    {
+        ALICEVISION_LOG_ERROR("The input tracks file '" + filepath + "' cannot be read.");
+        return false;
+    }
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    tracks = flat_map_value_to<Track>(boost::json::parse(buffer.str()));
+
+    tracksPerView.clear();
+    computeTracksPerView(tracks, tracksPerView);
+    return true;
+}
+
 }  // namespace track
 }  // namespace aliceVision
@@ -10,6 +10,8 @@
 
 #include <boost/json.hpp>
 
+#include <string>
+
 namespace aliceVision {
 namespace track {
 
@@ -39,5 +41,73 @@ void tag_invoke(const boost::json::value_from_tag&, boost::json::value& jv, alic
  */
 aliceVision::track::Track tag_invoke(boost::json::value_to_tag<aliceVision::track::Track>, boost::json::value const& jv);
 
+/**
+ * @brief Binary tracks format (.avtracks), alternative to the JSON tracks file for large scenes.
+ *
+ * All the values are little-endian, the sections are raw arrays that can be read or memory-mapped as is.
+ * The tracks are stored in compressed rows: the observations of all the tracks in a single array
+ * and the offset of the first observation of each track. The tracks per view inverted index is stored
+ * the same way, so the readers do not have to compute it.
+ *
+ * Layout:
+ * - header (32 bytes): magic "AVTRACKS", uint32 version, uint32 number of sections, 16 reserved bytes,
+ * - section table (32 bytes per section): uint32 section type, uint32 element size, uint64 number of elements,
+ *   uint64 offset of the section data from the beginning of the file, 8 reserved bytes,
+ * - section data, each section aligned on 64 bytes.
+ *
+ * The section types are listed in EBinaryTracksSection, unknown sections are ignored by the reader.
+ */
+enum class EBinaryTracksSection : unsigned int
+{
+    TRACK_IDS = 1,          //< uint64 per track, sorted
+    TRACK_DESC_TYPES = 2,   //< uint32 EImageDescriberType per track
+    TRACK_OFFSETS = 3,      //< uint64 per track + 1, offset of the observations of each track
+    OBSERVATIONS = 4,       //< uint32[2] (viewId, featureId) per observation, sorted by view id in each track
+    VIEW_IDS = 5,           //< uint32 per view with observations, sorted
+    VIEW_OFFSETS = 6,       //< uint64 per view + 1, offset of the track ids of each view
+    VIEW_TRACK_IDS = 7      //< uint64 track id per view observation, sorted in each view
+};
+
+/// file extension of the binary tracks format
+constexpr const char* binaryTracksExtension = ".avtracks";
+
+/**
+ * @param[in] filepath the tracks file path
+ * @return true if the file path has the binary tracks format extension
+ */
+bool isBinaryTracksFile(const std::string& filepath);
+
+/**
+ * @brief Save tracks in the binary tracks format, with their tracks per view index.
+ * @param[in] tracks the tracks to save
+ * @param[in] filepath the output .avtracks file path
+ */
+void saveBinaryTracks(const TracksMap& tracks, const std::string& filepath);
+
+/**
+ * @brief Load tracks in the binary tracks format.
+ * @param[out] tracks the loaded tracks
+ * @param[out] tracksPerView the stored tracks per view index, not read if nullptr
+ * @param[in] filepath the input .avtracks file path
+ */
+void loadBinaryTracks(TracksMap& tracks, TracksPerView* tracksPerView, const std::string& filepath);
+
+/**
+ * @brief Save tracks in a JSON or binary tracks file, depending on the file extension.
+ * @param[in] tracks the tracks to save
+ * @param[in] filepath the output tracks file path
+ * @return false if the file cannot be saved
+ */
+bool saveTracks(const TracksMap& tracks, const std::string& filepath);
+
+/**
+ * @brief Load tracks from a JSON or binary tracks file, depending on the file extension.
+ * @param[out] tracks the loaded tracks
+ * @param[out] tracksPerView the tracks per view, read from a binary file or computed from the tracks
+ * @param[in] filepath the input tracks file path
+ * @return false if the file cannot be loaded
+ */
+bool loadTracks(TracksMap& tracks, TracksPerView& tracksPerView, const std::string& filepath);
+
 }  // namespace track
 }  // namespace aliceVision
@@ -0,0 +1,80 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <aliceVision/track/TracksBuilder.hpp>
+#include <aliceVision/matching/IndMatch.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <vector>
+
+using namespace aliceVision;
+using namespace aliceVision::feature;
+using namespace aliceVision::matching;
+using namespace aliceVision::track;
+
+namespace {
+
+/**
+ * @brief Matches between each view and its next views, the features are shuffled so the tracks span several views.
+ */
+PairwiseMatches createPairwiseMatches(int nbViews, int nbFeatures, int nbNeighborViews)
+{
+    std::mt19937 generator(0);
+    std::uniform_real_distribution<double> keepDist(0.0, 1.0);
+
+    PairwiseMatches pairwiseMatches;
+    for (int i = 0; i < nbViews; ++i)
+    {
+        for (int j = i + 1; j < std::min(nbViews, i + 1 + nbNeighborViews); ++j)
+        {
+            std::vector<IndexT> featuresJ(nbFeatures);
+            std::iota(featuresJ.begin(), featuresJ.end(), 0);
+            // a few features are matched to another feature, creating conflicting tracks
+            std::shuffle(featuresJ.begin(), featuresJ.begin() + nbFeatures / 20, generator);
+
+            IndMatches& matches = pairwiseMatches[std::make_pair(i, j)][EImageDescriberType::UNKNOWN];
+            matches.reserve(nbFeatures);
+            for (int f = 0; f < nbFeatures; ++f)
+            {
+                if (keepDist(generator) < 0.7)
+                    matches.emplace_back(f, featuresJ[f]);
+            }
+        }
+    }
+    return pairwiseMatches;
+}
+
+/**
+ * @brief Build and filter the tracks of state.range(0) views with state.range(1) features per view.
+ */
+void BM_TracksBuilder(benchmark::State& state)
+{
+    const int nbViews = static_cast<int>(state.range(0));
+    const int nbFeatures = static_cast<int>(state.range(1));
+    const PairwiseMatches pairwiseMatches = createPairwiseMatches(nbViews, nbFeatures, 4);
+
+    std::size_t nbMatches = 0;
+    for (const auto& matchesPair : pairwiseMatches)
+        nbMatches += matchesPair.second.getNbAllMatches();
+
+    for (auto _ : state)
+    {
+        TracksBuilder tracksBuilder;
+        tracksBuilder.build(pairwiseMatches);
+        tracksBuilder.filter(true, 2, false);
+        benchmark::DoNotOptimize(tracksBuilder.nbTracks());
+    }
+
+    state.SetItemsProcessed(state.iterations() * nbMatches);
+}
+
+}  // namespace
+
+BENCHMARK(BM_TracksBuilder)->Args({20, 5000})->Args({100, 5000})->Args({100, 20000})->Unit(benchmark::kMillisecond);
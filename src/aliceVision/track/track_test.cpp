@@ -6,9 +6,14 @@
 // You can obtain one at https://mozilla.org/MPL/2.0/.
 
 #include "aliceVision/track/TracksBuilder.hpp"
+#include "aliceVision/track/StreamingTracksBuilder.hpp"
 #include "aliceVision/track/tracksUtils.hpp"
+#include "aliceVision/track/trackIO.hpp"
 #include "aliceVision/matching/IndMatch.hpp"
 
+#include <boost/filesystem.hpp>
+
+#include <sstream>
 #include <vector>
 #include <utility>
 
@@ -179,6 +184,95 @@ BOOST_AUTO_TEST_CASE(Track_Conflict)
     }
 }
 
+BOOST_AUTO_TEST_CASE(Track_Streaming_Conflict)
+{
+    // Same configuration as Track_Conflict, built with the streaming tracks builder
+    const IndMatch testAB[] = {IndMatch(0, 0), IndMatch(1, 1), IndMatch(2, 3)};
+    const IndMatch testBC[] = {IndMatch(0, 0), IndMatch(1, 6), IndMatch(3, 2), IndMatch(3, 8)};
+
+    MatchesPerDescType matchesAB;
+    MatchesPerDescType matchesBC;
+    matchesAB[EImageDescriberType::UNKNOWN] = std::vector<IndMatch>(testAB, testAB + 3);
+    matchesBC[EImageDescriberType::UNKNOWN] = std::vector<IndMatch>(testBC, testBC + 4);
+
+    // stream the pairs one by one
+    StreamingTracksBuilder trackBuilder;
+    trackBuilder.addMatches(std::make_pair(0, 1), matchesAB);
+    trackBuilder.addMatches(std::make_pair(1, 2), matchesBC);
+
+    BOOST_CHECK_EQUAL(10, trackBuilder.nbNodes());
+    BOOST_CHECK_EQUAL(3, trackBuilder.nbTracks());
+    trackBuilder.filter(true, 2);  // Key feature tested here to kill the conflicted track
+    BOOST_CHECK_EQUAL(2, trackBuilder.nbTracks());
+
+    TracksMap map_tracks;
+    trackBuilder.exportToSTL(map_tracks);
+
+    // 0, {(0,0) (1,0) (2,0)}
+    // 1, {(0,1) (1,1) (2,6)}
+    const std::pair<std::size_t, std::size_t> GT_Tracks[] = {
+      std::make_pair(0, 0), std::make_pair(1, 0), std::make_pair(2, 0), std::make_pair(0, 1), std::make_pair(1, 1), std::make_pair(2, 6)};
+
+    BOOST_CHECK_EQUAL(2, map_tracks.size());
+    std::size_t cpt = 0, i = 0;
+    for (TracksMap::const_iterator iterT = map_tracks.begin(); iterT != map_tracks.end(); ++iterT, ++i)
+    {
+        BOOST_CHECK_EQUAL(i, iterT->first);
+        for (auto iter = iterT->second.featPerView.begin(); iter != iterT->second.featPerView.end(); ++iter)
+        {
+            BOOST_CHECK(GT_Tracks[cpt].first == iter->first);
+            BOOST_CHECK(GT_Tracks[cpt].second == iter->second.featureId);
+            ++cpt;
+        }
+    }
+
+    // the incremental JSON export must match the serialization of the TracksMap
+    std::stringstream ss;
+    BOOST_CHECK(trackBuilder.exportToJsonStream(ss));
+    BOOST_CHECK_EQUAL(boost::json::serialize(boost::json::value_from(map_tracks)), ss.str());
+}
+
+BOOST_AUTO_TEST_CASE(Track_BinaryIO)
+{
+    TracksMap tracks;
+    tracks[3].descType = EImageDescriberType::SIFT;
+    tracks[3].featPerView[0].featureId = 10;
+    tracks[3].featPerView[2].featureId = 11;
+    tracks[7].descType = EImageDescriberType::AKAZE;
+    tracks[7].featPerView[1].featureId = 20;
+    tracks[7].featPerView[2].featureId = 21;
+    tracks[7].featPerView[5].featureId = 22;
+
+    const std::string filepath =
+      (boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("%%%%-%%%%.avtracks")).string();
+    BOOST_CHECK(isBinaryTracksFile(filepath));
+    BOOST_CHECK(saveTracks(tracks, filepath));
+
+    TracksMap loadedTracks;
+    TracksPerView loadedTracksPerView;
+    BOOST_CHECK(loadTracks(loadedTracks, loadedTracksPerView, filepath));
+    boost::filesystem::remove(filepath);
+
+    BOOST_CHECK_EQUAL(tracks.size(), loadedTracks.size());
+    for (const auto& trackIt : tracks)
+    {
+        const auto loadedIt = loadedTracks.find(trackIt.first);
+        BOOST_REQUIRE(loadedIt != loadedTracks.end());
+        BOOST_CHECK(trackIt.second.descType == loadedIt->second.descType);
+        BOOST_CHECK_EQUAL(trackIt.second.featPerView.size(), loadedIt->second.featPerView.size());
+        for (const auto& featIt : trackIt.second.featPerView)
+        {
+            BOOST_REQUIRE(loadedIt->second.featPerView.count(featIt.first));
+            BOOST_CHECK_EQUAL(featIt.second.featureId, loadedIt->second.featPerView.at(featIt.first).featureId);
+        }
+    }
+
+    // the stored index must match the one computed from the tracks
+    TracksPerView tracksPerView;
+    computeTracksPerView(tracks, tracksPerView);
+    BOOST_CHECK(tracksPerView == loadedTracksPerView);
+}
+
 BOOST_AUTO_TEST_CASE(Track_GetCommonTracksInImages)
 {
     {
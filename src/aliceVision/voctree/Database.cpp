@@ -8,9 +8,11 @@
 #include <aliceVision/system/ProgressDisplay.hpp>
 #include <boost/accumulators/accumulators.hpp>
 #include <boost/accumulators/statistics/tail.hpp>
+#include <algorithm>
 #include <cmath>
 #include <fstream>
 #include <stdexcept>
+#include <unordered_map>
 #include <boost/format.hpp>
 
 namespace aliceVision {
@@ -60,6 +62,13 @@ DocId Database::insert(DocId doc_id, const SparseHistogram& document)
 
     database_[doc_id] = document;
 
+    std::size_t documentSize = 0;
+    for (const auto& word : document)
+    {
+        documentSize += word.second.size();
+    }
+    documentsSize_[doc_id] = documentSize;
+
     return doc_id;
 }
 
@@ -83,13 +92,19 @@ void Database::sanityCheck(std::size_t N, std::map<std::size_t, DocMatches>& mat
     // query allocate the whole memory
     auto display = system::createConsoleProgressDisplay(database_.size(), std::cout);
 
-    // #pragma omp parallel for default(none) shared(database_)
+    std::vector<std::pair<const SparseHistogram*, DocMatches*>> queries;
+    queries.reserve(database_.size());
     for (const auto& doc : database_)
     {
-        std::vector<DocMatch> m;
-        find(doc.second, N, m);
-        //		matches.emplace_back( m );
-        matches[doc.first] = m;
+        queries.emplace_back(&doc.second, &matches[doc.first]);
+    }
+
+#pragma omp parallel for schedule(dynamic)
+    for (ptrdiff_t i = 0; i < static_cast<ptrdiff_t>(queries.size()); ++i)
+    {
+        find(*queries[i].first, N, *queries[i].second);
+
+#pragma omp critical(databaseSanityCheck)
         ++display;
     }
 }
@@ -124,18 +139,90 @@ void Database::find(const SparseHistogram& query, std::size_t N, std::vector<Doc
 {
     matches.clear();
     matches.reserve(database_.size());
-    for (const auto& document : database_)
+    if (!scoreFromInvertedFiles(query, distanceMethod, matches))
     {
-        // for each document/image in the database compute the distance between the
-        // histograms of the query image and the others
-        const float distance = sparseDistance(query, document.second, distanceMethod, word_weights_);
-        matches.emplace_back(document.first, distance);
+        for (const auto& document : database_)
+        {
+            // for each document/image in the database compute the distance between the
+            // histograms of the query image and the others
+            const float distance = sparseDistance(query, document.second, distanceMethod, word_weights_);
+            matches.emplace_back(document.first, distance);
+        }
     }
     const std::size_t nMatches = std::min(N, matches.size());
     std::partial_sort(matches.begin(), matches.begin() + nMatches, matches.end());
     matches.resize(nMatches);
 }
 
+void Database::findBatch(const std::vector<SparseHistogram>& queries,
+                         std::size_t N,
+                         std::vector<std::vector<DocMatch>>& matches,
+                         const std::string& distanceMethod) const
+{
+    matches.resize(queries.size());
+
+#pragma omp parallel for schedule(dynamic)
+    for (int i = 0; i < static_cast<int>(queries.size()); ++i)
+    {
+        find(queries[i], N, matches[i], distanceMethod);
+    }
+}
+
+bool Database::scoreFromInvertedFiles(const SparseHistogram& query, const std::string& distanceMethod, std::vector<DocMatch>& matches) const
+{
+    // classic: sum of |c1 - c2| over all the words = N1 + N2 - 2 * sum of min(c1, c2) over the common words
+    // commonPoints: - sum of min(c1, c2) over the common words
+    // strongCommonPoints: - number of common words seen once in both documents
+    const bool classic = (distanceMethod == "classic");
+    const bool strong = (distanceMethod == "strongCommonPoints");
+    if (!classic && !strong && distanceMethod != "commonPoints")
+    {
+        return false;
+    }
+
+    std::unordered_map<DocId, std::size_t> commonCounts;
+    std::size_t querySize = 0;
+    for (const auto& word : query)
+    {
+        const std::size_t queryCount = word.second.size();
+        querySize += queryCount;
+
+        if (word.first < 0 || word.first >= static_cast<Word>(word_files_.size()) || (strong && queryCount != 1))
+        {
+            continue;
+        }
+
+        for (const WordFrequency& posting : word_files_[word.first])
+        {
+            if (strong && posting.count != 1)
+            {
+                continue;
+            }
+            commonCounts[posting.id] += std::min<std::size_t>(queryCount, posting.count);
+        }
+    }
+
+    for (const auto& documentSize : documentsSize_)
+    {
+        const auto common = commonCounts.find(documentSize.first);
+        const std::size_t commonCount = (common == commonCounts.end()) ? 0 : common->second;
+
+        float distance;
+        if (classic)
+        {
+            distance = static_cast<float>(querySize + documentSize.second - 2 * commonCount);
+        }
+        else
+        {
+            const float score = static_cast<float>(commonCount);
+            distance = -score;
+        }
+        matches.emplace_back(documentSize.first, distance);
+    }
+
+    return true;
+}
+
 /**
  * @brief Compute the TF-IDF weights of all the words. To be called after inserting a corpus of
  * training examples into the database.
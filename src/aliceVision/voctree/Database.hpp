@@ -102,6 +102,19 @@ class Database
               std::vector<DocMatch>& matches,
               const std::string& distanceMethod = "strongCommonPoints") const;
 
+    /**
+     * @brief Find the top N matches in the database for each query document, the queries are processed in parallel.
+     *
+     * @param[in] queries The query documents, normalized sets of quantized words.
+     * @param[in] N The number of matches to return for each query.
+     * @param[in] distanceMethod distance method (norm L1, etc.)
+     * @param[out] matches IDs and scores for the top N matching database documents of each query.
+     */
+    void findBatch(const std::vector<SparseHistogram>& queries,
+                   std::size_t N,
+                   std::vector<std::vector<DocMatch>>& matches,
+                   const std::string& distanceMethod = "strongCommonPoints") const;
+
     /**
      * @brief Compute the TF-IDF weights of all the words. To be called after inserting a corpus of
      * training examples into the database.
@@ -151,6 +164,18 @@ class Database
     std::vector<InvertedFile> word_files_;
     std::vector<float> word_weights_;
     SparseHistogramPerImage database_;  // Precomputed for inserted documents
+    std::map<DocId, std::size_t> documentsSize_;  // Number of features of the inserted documents
+
+    /**
+     * @brief Score the query against all the documents from the inverted files of its words.
+     *        Only the distances that are sums over the common words can be computed this way,
+     *        the documents without common words are not visited.
+     * @param[in] query The query document
+     * @param[in] distanceMethod distance method
+     * @param[out] matches IDs and scores of all the database documents, in the order of the database
+     * @return false if the distance method cannot be computed from the inverted files
+     */
+    bool scoreFromInvertedFiles(const SparseHistogram& query, const std::string& distanceMethod, std::vector<DocMatch>& matches) const;
 
     /**
      * Normalize a document vector representing the histogram of visual words for a given image
@@ -330,6 +330,15 @@ class SimpleKmeans
 
     void setVerbose(const int verboseLevel) { verbose_ = verboseLevel; }
 
+    std::size_t getMiniBatchSize() const { return mini_batch_size_; }
+
+    /**
+     * @brief Set the number of features drawn at each iteration by the mini-batch k-means.
+     *        The subsets larger than this size are clustered with mini-batches (Sculley, "Web-scale k-means clustering", 2010),
+     *        the centers being initialized on a random sample of the same size. 0 always uses the standard Lloyd's algorithm.
+     */
+    void setMiniBatchSize(std::size_t miniBatchSize) { mini_batch_size_ = miniBatchSize; }
+
     /**
      * @brief Partition a set of features into k clusters.
      *
@@ -365,11 +374,22 @@ class SimpleKmeans
                                       std::vector<Feature, FeatureAllocator>& centers,
                                       std::vector<unsigned int>& membership) const;
 
+    squared_distance_type clusterMiniBatch(const std::vector<Feature*>& features,
+                                           std::size_t k,
+                                           std::vector<Feature, FeatureAllocator>& centers,
+                                           std::vector<unsigned int>& membership) const;
+
+    unsigned int nearestCenter(const Feature& feature,
+                               std::size_t k,
+                               const std::vector<Feature, FeatureAllocator>& centers,
+                               squared_distance_type& d_min) const;
+
     Feature zero_;
     Distance distance_;
     Initializer choose_centers_;
     std::size_t max_iterations_;
     std::size_t restarts_;
+    std::size_t mini_batch_size_;
     int verbose_;
 };
 
@@ -381,7 +401,8 @@ SimpleKmeans<Feature, Distance, FeatureAllocator>::SimpleKmeans(const Feature& z
     choose_centers_(InitKmeanspp()),
     max_iterations_(100),
     verbose_(verbose),
-    restarts_(1)
+    restarts_(1),
+    mini_batch_size_(0)
 {}
 
 template<class Feature, class Distance, class FeatureAllocator>
@@ -409,14 +430,38 @@ typename SimpleKmeans<Feature, Distance, FeatureAllocator>::squared_distance_typ
     new_centers.resize(k);
     std::vector<unsigned int> new_membership(features.size());
 
+    const bool miniBatch = (mini_batch_size_ > 0) && (features.size() > std::max(mini_batch_size_, k));
+
     squared_distance_type least_sse = std::numeric_limits<squared_distance_type>::max();
     assert(restarts_ > 0);
     for (std::size_t starts = 0; starts < restarts_; ++starts)
     {
         if (verbose_ > 0)
             ALICEVISION_LOG_DEBUG("Trial " << starts + 1 << "/" << restarts_);
-        choose_centers_(features, k, new_centers, distance_, verbose_);
-        squared_distance_type sse = clusterOnce(features, k, new_centers, new_membership);
+        squared_distance_type sse;
+        if (miniBatch)
+        {
+            // Initialize the centers with a full clustering of a random sample,
+            // the mini-batch updates cannot recover from a poor seeding
+            std::vector<Feature*> sample = features;
+            const std::size_t sampleSize = std::max(mini_batch_size_, k);
+            for (std::size_t i = 0; i < sampleSize; ++i)
+            {
+                const std::size_t j = i + rand() % (sample.size() - i);
+                std::swap(sample[i], sample[j]);
+            }
+            sample.resize(sampleSize);
+
+            std::vector<unsigned int> sampleMembership(sampleSize);
+            choose_centers_(sample, k, new_centers, distance_, verbose_);
+            clusterOnce(sample, k, new_centers, sampleMembership);
+            sse = clusterMiniBatch(features, k, new_centers, new_membership);
+        }
+        else
+        {
+            choose_centers_(features, k, new_centers, distance_, verbose_);
+            sse = clusterOnce(features, k, new_centers, new_membership);
+        }
         if (verbose_ > 0)
             ALICEVISION_LOG_DEBUG("End of Trial " << starts + 1 << "/" << restarts_);
         if (sse < least_sse)
@@ -444,9 +489,19 @@ typename SimpleKmeans<Feature, Distance, FeatureAllocator>::squared_distance_typ
 
     std::vector<std::size_t> new_center_counts(k);
     std::vector<Feature, FeatureAllocator> new_centers(k);
-    std::vector<std::mutex> centersLocks(k);
     squared_distance_type max_center_shift = std::numeric_limits<squared_distance_type>::max();
 
+    // On small problems enabling multithreading does much more harm than good because thread
+    // creation is relatively expensive.
+    // TODO: Ideally a thread pool would be created before the first iteration and the iterations
+    // would reuse the existing threads.
+    const bool enableMultithreading = features.size() * k > 1000000;
+
+    // Each thread accumulates its own centers, they are summed after the assignment
+    const int threadCount = enableMultithreading ? omp_get_max_threads() : 1;
+    std::vector<std::vector<Feature, FeatureAllocator>> threadCenters(threadCount, std::vector<Feature, FeatureAllocator>(k));
+    std::vector<std::vector<std::size_t>> threadCenterCounts(threadCount, std::vector<std::size_t>(k));
+
     if (verbose_ > 0)
         ALICEVISION_LOG_DEBUG("Iterations");
     for (std::size_t iter = 0; iter < max_iterations_; ++iter)
@@ -461,38 +516,19 @@ typename SimpleKmeans<Feature, Distance, FeatureAllocator>::squared_distance_typ
         assert(checkVectorElements(new_centers, "newcenters init"));
         bool is_stable = true;
 
-        // On small problems enabling multithreading does much more harm than good because thread
-        // creation is relatively expensive.
-        // TODO: Ideally a thread pool would be created before the first iteration and the iterations
-        // would reuse the existing threads.
-        bool enableMultithreading = features.size() * k > 1000000;
+        for (int t = 0; t < threadCount; ++t)
+        {
+            std::fill(threadCenters[t].begin(), threadCenters[t].end(), zero_);
+            std::fill(threadCenterCounts[t].begin(), threadCenterCounts[t].end(), 0);
+        }
 
 // Assign data objects to current centers
-#pragma omp parallel for shared(new_centers, new_center_counts, features, centers, membership) if (enableMultithreading)
+#pragma omp parallel for reduction(&& : is_stable) num_threads(threadCount) if (enableMultithreading)
         for (ptrdiff_t i = 0; i < static_cast<ptrdiff_t>(features.size()); ++i)
         {
-            squared_distance_type d_min = std::numeric_limits<squared_distance_type>::max();
-            unsigned int nearest = 0;
-            bool found = false;
+            squared_distance_type d_min;
+            const unsigned int nearest = nearestCenter(*features[i], k, centers, d_min);
 
-            // @todo if k is large, let's say k>100 use FLAAN to retrieve the
-            // cluster center
-
-            // Find the nearest cluster center to feature i
-            for (unsigned int j = 0; j < k; ++j)
-            {
-                squared_distance_type distance = distance_(*features[i], centers[j]);
-                //		printf("\t\tdistance %f\n", (float)distance);
-                //		PrintFeat(*features[i] );
-                if (distance < d_min)
-                {
-                    d_min = distance;
-                    nearest = j;
-                    found = true;
-                }
-                //		 printf("\t distance %f %f\n", (double)distance, (double)d_min);
-            }
-            assert(found);
             // Assign feature i to the cluster it is nearest to
             if (membership[i] != nearest)
             {
@@ -500,17 +536,19 @@ typename SimpleKmeans<Feature, Distance, FeatureAllocator>::squared_distance_typ
                 membership[i] = nearest;
             }
             // Accumulate the cluster center and its membership count
-            //	  printf("\t nearest %d\n", nearest);
-            //			checkElements(*features[i], "feat");
+            const int t = omp_get_thread_num();
+            threadCenters[t][nearest] += *features[i];
+            ++threadCenterCounts[t][nearest];
+        }  // for
+
+        for (int t = 0; t < threadCount; ++t)
+        {
+            for (std::size_t i = 0; i < k; ++i)
             {
-                std::lock_guard<std::mutex> lock{centersLocks[nearest]};
-                new_centers[nearest] += *features[i];
-                //			checkElements(new_centers[nearest], "sum");
-                //	  printf("\t new_centers[nearest] += *features[i];\n");
-                ++new_center_counts[nearest];
-                //	  printf("\taccumulate\n");
+                new_centers[i] += threadCenters[t][i];
+                new_center_counts[i] += threadCenterCounts[t][i];
             }
-        }  // for
+        }
 
         if (is_stable)
             break;
@@ -563,5 +601,97 @@ typename SimpleKmeans<Feature, Distance, FeatureAllocator>::squared_distance_typ
     return sse;
 }
 
+template<class Feature, class Distance, class FeatureAllocator>
+typename SimpleKmeans<Feature, Distance, FeatureAllocator>::squared_distance_type SimpleKmeans<Feature, Distance, FeatureAllocator>::clusterMiniBatch(
+  const std::vector<Feature*>& features,
+  std::size_t k,
+  std::vector<Feature, FeatureAllocator>& centers,
+  std::vector<unsigned int>& membership) const
+{
+    // Each center is the mean of all the features assigned to it in the previous batches,
+    // which is the per-center learning rate 1/count of the mini-batch k-means.
+    std::vector<Feature, FeatureAllocator> center_sums(k, zero_);
+    std::vector<std::size_t> center_counts(k, 0);
+
+    const std::size_t batchSize = mini_batch_size_;
+    std::vector<Feature*> batch(batchSize);
+    std::vector<unsigned int> batchMembership(batchSize);
+    const bool enableBatchMultithreading = batchSize * k > 1000000;
+
+    if (verbose_ > 0)
+        ALICEVISION_LOG_DEBUG("Mini-batch iterations");
+    for (std::size_t iter = 0; iter < max_iterations_; ++iter)
+    {
+        for (std::size_t i = 0; i < batchSize; ++i)
+        {
+            batch[i] = features[rand() % features.size()];
+        }
+
+#pragma omp parallel for if (enableBatchMultithreading)
+        for (ptrdiff_t i = 0; i < static_cast<ptrdiff_t>(batchSize); ++i)
+        {
+            squared_distance_type d_min;
+            batchMembership[i] = nearestCenter(*batch[i], k, centers, d_min);
+        }
+
+        for (std::size_t i = 0; i < batchSize; ++i)
+        {
+            center_sums[batchMembership[i]] += *batch[i];
+            ++center_counts[batchMembership[i]];
+        }
+
+        squared_distance_type max_center_shift = 0;
+        for (std::size_t i = 0; i < k; ++i)
+        {
+            if (center_counts[i] == 0)
+                continue;
+
+            const Feature new_center = center_sums[i] / center_counts[i];
+            max_center_shift = std::max(max_center_shift, distance_(new_center, centers[i]));
+            centers[i] = new_center;
+        }
+        if (max_center_shift <= 10e-10)
+            break;
+    }
+
+    // Assign all the features to the final centers and return the sum squared error
+    squared_distance_type sse = squared_distance_type(0);
+    assert(features.size() > 0);
+#pragma omp parallel for reduction(+ : sse) if (features.size() * k > 1000000)
+    for (ptrdiff_t i = 0; i < static_cast<ptrdiff_t>(features.size()); ++i)
+    {
+        squared_distance_type d_min;
+        membership[i] = nearestCenter(*features[i], k, centers, d_min);
+        sse += d_min;
+    }
+    return sse;
+}
+
+template<class Feature, class Distance, class FeatureAllocator>
+unsigned int SimpleKmeans<Feature, Distance, FeatureAllocator>::nearestCenter(const Feature& feature,
+                                                                             std::size_t k,
+                                                                             const std::vector<Feature, FeatureAllocator>& centers,
+                                                                             squared_distance_type& d_min) const
+{
+    d_min = std::numeric_limits<squared_distance_type>::max();
+    unsigned int nearest = 0;
+    bool found = false;
+
+    // @todo if k is large, let's say k>100 use FLAAN to retrieve the
+    // cluster center
+    for (unsigned int j = 0; j < k; ++j)
+    {
+        const squared_distance_type distance = distance_(feature, centers[j]);
+        if (distance < d_min)
+        {
+            d_min = distance;
+            nearest = j;
+            found = true;
+        }
+    }
+    assert(found);
+    return nearest;
+}
+
 }  // namespace voctree
 }  // namespace aliceVision
@@ -7,6 +7,7 @@
 #include "VocabularyTree.hpp"
 
 #include <algorithm>
+#include <cstring>
 
 namespace aliceVision {
 namespace voctree {
@@ -22,6 +23,18 @@ std::ostream& operator<<(std::ostream& os, const Document& doc)
     return os;
 }
 
+uint64_t hashBytes(const void* data, std::size_t size, uint64_t seed)
+{
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    uint64_t h = seed;
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        h ^= bytes[i];
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
 float sparseDistance(const SparseHistogram& v1, const SparseHistogram& v2, const std::string& distanceMethod, const std::vector<float>& word_weights)
 {
     float distance{0.0f};
@@ -48,7 +61,10 @@ float sparseDistance(const SparseHistogram& v1, const SparseHistogram& v2, const
             }
             else
             {
-                const auto val = std::minmax(i1->second.size(), i2->second.size());
+                // minmax returns references, the sizes must outlive the pair
+                const std::size_t size1 = i1->second.size();
+                const std::size_t size2 = i2->second.size();
+                const auto val = std::minmax(size1, size2);
                 distance += static_cast<float>(val.second - val.first);
                 ++i1;
                 ++i2;
@@ -254,5 +270,95 @@ float sparseDistance(const SparseHistogram& v1, const SparseHistogram& v2, const
     return distance;
 }
 
+namespace {
+
+/// magic number of the sparse histogram files
+const char sparseHistogramMagic[8] = {'A', 'V', 'B', 'O', 'W', '0', '0', '1'};
+
+}  // namespace
+
+bool saveSparseHistogram(const std::string& filepath, const SparseHistogram& histogram, uint64_t treeHash, std::size_t nbMaxDescriptors)
+{
+    std::ofstream out(filepath, std::ios::binary);
+    if (!out.is_open())
+    {
+        ALICEVISION_LOG_ERROR("Unable to create the sparse histogram file: " << filepath);
+        return false;
+    }
+
+    const uint64_t nbMax = nbMaxDescriptors;
+    const uint64_t nbWords = histogram.size();
+    out.write(sparseHistogramMagic, sizeof(sparseHistogramMagic));
+    out.write(reinterpret_cast<const char*>(&treeHash), sizeof(treeHash));
+    out.write(reinterpret_cast<const char*>(&nbMax), sizeof(nbMax));
+    out.write(reinterpret_cast<const char*>(&nbWords), sizeof(nbWords));
+
+    for (const auto& word : histogram)
+    {
+        const uint32_t count = static_cast<uint32_t>(word.second.size());
+        out.write(reinterpret_cast<const char*>(&word.first), sizeof(Word));
+        out.write(reinterpret_cast<const char*>(&count), sizeof(count));
+        out.write(reinterpret_cast<const char*>(word.second.data()), count * sizeof(IndexT));
+    }
+
+    if (!out.good())
+    {
+        ALICEVISION_LOG_ERROR("Unable to write the sparse histogram file: " << filepath);
+        return false;
+    }
+    return true;
+}
+
+bool loadSparseHistogram(const std::string& filepath, uint64_t treeHash, std::size_t nbMaxDescriptors, SparseHistogram& histogram)
+{
+    std::ifstream in(filepath, std::ios::binary | std::ios::ate);
+    if (!in.is_open())
+    {
+        return false;
+    }
+    const std::streamoff fileSize = in.tellg();
+    in.seekg(0);
+
+    char magic[sizeof(sparseHistogramMagic)];
+    uint64_t fileTreeHash = 0;
+    uint64_t fileNbMax = 0;
+    uint64_t nbWords = 0;
+    in.read(magic, sizeof(magic));
+    in.read(reinterpret_cast<char*>(&fileTreeHash), sizeof(fileTreeHash));
+    in.read(reinterpret_cast<char*>(&fileNbMax), sizeof(fileNbMax));
+    in.read(reinterpret_cast<char*>(&nbWords), sizeof(nbWords));
+
+    if (!in.good() || std::memcmp(magic, sparseHistogramMagic, sizeof(magic)) != 0 || fileTreeHash != treeHash || fileNbMax != nbMaxDescriptors)
+    {
+        return false;
+    }
+
+    histogram.clear();
+    for (uint64_t i = 0; i < nbWords; ++i)
+    {
+        Word word;
+        uint32_t count = 0;
+        in.read(reinterpret_cast<char*>(&word), sizeof(word));
+        in.read(reinterpret_cast<char*>(&count), sizeof(count));
+        if (!in.good() || count > (fileSize - in.tellg()) / static_cast<std::streamoff>(sizeof(IndexT)))
+        {
+            in.setstate(std::ios::failbit);
+            break;
+        }
+
+        std::vector<IndexT>& features = histogram.emplace_hint(histogram.end(), word, std::vector<IndexT>())->second;
+        features.resize(count);
+        in.read(reinterpret_cast<char*>(features.data()), count * sizeof(IndexT));
+    }
+
+    if (!in.good())
+    {
+        ALICEVISION_LOG_WARNING("Invalid sparse histogram file: " << filepath);
+        histogram.clear();
+        return false;
+    }
+    return true;
+}
+
 }  // namespace voctree
 }  // namespace aliceVision
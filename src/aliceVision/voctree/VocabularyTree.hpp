@@ -38,6 +38,15 @@ typedef std::map<DocId, SparseHistogram> SparseHistogramPerImage;
 
 std::ostream& operator<<(std::ostream& os, const Document& doc);
 
+/**
+ * @brief FNV-1a hash of a buffer
+ * @param[in] data the buffer
+ * @param[in] size the size of the buffer in bytes
+ * @param[in] seed the hash of the previous buffers
+ * @return the hash
+ */
+uint64_t hashBytes(const void* data, std::size_t size, uint64_t seed = 14695981039346656037ull);
+
 /**
  * Given a list of visual words associated to the features of a document it computes the
  * vector of unique weighted visual words
@@ -147,6 +156,9 @@ class VocabularyTree : public IVocabularyTree
     /// Load vocabulary from a file.
     void load(const std::string& file) override;
 
+    /// Get a hash of the tree content, to check that some data has been computed with this tree.
+    uint64_t hash() const;
+
     bool operator==(const VocabularyTree& other) const
     {
         return (centers_ == other.centers_) && (valid_centers_ == other.valid_centers_) && (k_ == other.k_) && (levels_ == other.levels_) &&
@@ -319,6 +331,15 @@ void VocabularyTree<Feature, Distance, FeatureAllocator>::load(const std::string
     assert(size == num_words_ + word_start_);
 }
 
+template<class Feature, template<typename, typename> class Distance, class FeatureAllocator>
+uint64_t VocabularyTree<Feature, Distance, FeatureAllocator>::hash() const
+{
+    uint64_t h = hashBytes(&k_, sizeof(k_));
+    h = hashBytes(&levels_, sizeof(levels_), h);
+    h = hashBytes(valid_centers_.data(), valid_centers_.size(), h);
+    return hashBytes(centers_.data(), centers_.size() * sizeof(Feature), h);
+}
+
 template<class Feature, template<typename, typename> class Distance, class FeatureAllocator>
 void VocabularyTree<Feature, Distance, FeatureAllocator>::setNodeCounts()
 {
@@ -345,6 +366,28 @@ float sparseDistance(const SparseHistogram& v1,
                      const std::string& distanceMethod = "classic",
                      const std::vector<float>& word_weights = std::vector<float>());
 
+/**
+ * @brief Save the sparse histogram of a document, to reuse it instead of quantizing the descriptors again.
+ *
+ * @param[in] filepath the output file path
+ * @param[in] histogram the sparse histogram
+ * @param[in] treeHash the hash of the vocabulary tree used for the quantization
+ * @param[in] nbMaxDescriptors the maximum number of descriptors quantized (0 for all)
+ * @return true if the file has been written
+ */
+bool saveSparseHistogram(const std::string& filepath, const SparseHistogram& histogram, uint64_t treeHash, std::size_t nbMaxDescriptors);
+
+/**
+ * @brief Load the sparse histogram of a document saved by saveSparseHistogram.
+ *
+ * @param[in] filepath the input file path
+ * @param[in] treeHash the hash of the current vocabulary tree
+ * @param[in] nbMaxDescriptors the current maximum number of descriptors quantized (0 for all)
+ * @param[out] histogram the sparse histogram
+ * @return false if the file is missing, invalid or has been computed with another tree or descriptors limit
+ */
+bool loadSparseHistogram(const std::string& filepath, uint64_t treeHash, std::size_t nbMaxDescriptors, SparseHistogram& histogram);
+
 inline std::unique_ptr<IVocabularyTree> createVoctreeForDescriberType(feature::EImageDescriberType imageDescriberType)
 {
     using namespace aliceVision::feature;
@@ -20,6 +20,27 @@ class SfMData;
 
 namespace voctree {
 
+/**
+ * @brief Load the descriptors of a file and quantize them into a sparse histogram.
+ *        If a sparse histogram folder is given, the histogram saved there is reused when it has been computed
+ *        with the same tree and descriptors limit after the last change of the descriptors, otherwise it is saved there.
+ *
+ * @param[in] descriptorsFile The .desc filename
+ * @param[in] tree The vocabulary tree to be used for feature quantization
+ * @param[in] treeHash The hash of the vocabulary tree
+ * @param[in] histogramsFolder The folder of the sparse histogram files, empty to always quantize the descriptors
+ * @param[in] Nmax The maximum number of features loaded in the desc file. For Nmax = 0, all the descriptors are loaded.
+ * @param[out] histogram The sparse histogram of the descriptors
+ * @return the number of features of the histogram
+ */
+template<class DescriptorT, class VocDescriptorT>
+std::size_t quantizeDescriptorsFile(const std::string& descriptorsFile,
+                                    const VocabularyTree<VocDescriptorT>& tree,
+                                    uint64_t treeHash,
+                                    const std::string& histogramsFolder,
+                                    const int Nmax,
+                                    SparseHistogram& histogram);
+
 /**
  * @brief Given a vocabulary tree and a set of features it builds a database
  *
@@ -29,6 +50,7 @@ namespace voctree {
  * @param[out] db The built database
  * @param[out] documents A map containing for each image the list of associated visual words
  * @param[in] Nmax The maximum number of features loaded in each desc file. For Nmax = 0 (default), all the descriptors are loaded.
+ * @param[in] histogramsFolder The folder where the sparse histograms are reused and saved, empty to always quantize the descriptors
  * @return the number of overall features read
  */
 template<class DescriptorT, class VocDescriptorT>
@@ -36,7 +58,8 @@ std::size_t populateDatabase(const sfmData::SfMData& sfmData,
                              const std::vector<std::string>& featuresFolders,
                              const VocabularyTree<VocDescriptorT>& tree,
                              Database& db,
-                             const int Nmax = 0);
+                             const int Nmax = 0,
+                             const std::string& histogramsFolder = "");
 
 /**
  * @brief Given an non empty database, it queries the database with a set of images
@@ -10,10 +10,12 @@
 #include <aliceVision/system/ProgressDisplay.hpp>
 #include <aliceVision/sfmDataIO/sfmDataIO.hpp>
 #include <aliceVision/config.hpp>
+#include <aliceVision/alicevision_omp.hpp>
 
 #include <boost/filesystem.hpp>
 #include <boost/algorithm/string/case_conv.hpp>
 
+#include <algorithm>
 #include <exception>
 #include <iostream>
 #include <fstream>
@@ -21,40 +23,93 @@
 namespace aliceVision {
 namespace voctree {
 
+template<class DescriptorT, class VocDescriptorT>
+std::size_t quantizeDescriptorsFile(const std::string& descriptorsFile,
+                                    const VocabularyTree<VocDescriptorT>& tree,
+                                    uint64_t treeHash,
+                                    const std::string& histogramsFolder,
+                                    const int Nmax,
+                                    SparseHistogram& histogram)
+{
+  namespace bfs = boost::filesystem;
+
+  std::string histogramFile;
+  if(!histogramsFolder.empty())
+  {
+    histogramFile = getSparseHistogramFile(histogramsFolder, descriptorsFile);
+
+    // reuse the saved histogram if it is more recent than the descriptors
+    boost::system::error_code ec;
+    const std::time_t histogramTime = bfs::last_write_time(histogramFile, ec);
+    if(!ec && histogramTime >= bfs::last_write_time(descriptorsFile) &&
+       loadSparseHistogram(histogramFile, treeHash, Nmax, histogram))
+    {
+      std::size_t numDescriptors = 0;
+      for(const auto& word : histogram)
+        numDescriptors += word.second.size();
+      return numDescriptors;
+    }
+  }
+
+  std::vector<DescriptorT> descriptors;
+  loadDescsFromBinFile(descriptorsFile, descriptors, false, Nmax);
+  histogram = tree.quantizeToSparse(descriptors);
+
+  if(!histogramFile.empty())
+    saveSparseHistogram(histogramFile, histogram, treeHash, Nmax);
+
+  return descriptors.size();
+}
+
 template<class DescriptorT, class VocDescriptorT>
 std::size_t populateDatabase(const sfmData::SfMData& sfmData,
                              const std::vector<std::string>& featuresFolders,
                              const VocabularyTree<VocDescriptorT>& tree,
                              Database& db,
-                             const int Nmax)
+                             const int Nmax,
+                             const std::string& histogramsFolder)
 {
   std::map<IndexT, std::string> descriptorsFiles;
   getListOfDescriptorFiles(sfmData, featuresFolders, descriptorsFiles);
   std::size_t numDescriptors = 0;
+
+  // the saved histograms are only valid for the same tree
+  const uint64_t treeHash = histogramsFolder.empty() ? 0 : tree.hash();
+  if(!histogramsFolder.empty())
+    boost::filesystem::create_directories(histogramsFolder);
   
   // Read the descriptors
   ALICEVISION_LOG_DEBUG("Reading the descriptors from " << descriptorsFiles.size() <<" files...");
   auto display = system::createConsoleProgressDisplay(descriptorsFiles.size(), std::cout);
 
-  // Run through the path vector and read the descriptors
-  for(const auto &currentFile : descriptorsFiles)
+  // Read and quantize the descriptors of several files concurrently,
+  // the documents are inserted in the database in the files order
+  const std::vector<std::pair<IndexT, std::string>> files(descriptorsFiles.begin(), descriptorsFiles.end());
+  const std::size_t batchSize = 4 * omp_get_max_threads();
+
+  for(std::size_t batchStart = 0; batchStart < files.size(); batchStart += batchSize)
   {
-    
-    std::vector<DescriptorT> descriptors;
+    const std::size_t batchEnd = std::min(files.size(), batchStart + batchSize);
+    std::vector<SparseHistogram> newDocs(batchEnd - batchStart);
+    std::vector<std::size_t> results(batchEnd - batchStart);
 
-    // Read the descriptors
-    loadDescsFromBinFile(currentFile.second, descriptors, false, Nmax);
-    size_t result = descriptors.size();
-    
-    SparseHistogram newDoc =  tree.quantizeToSparse(descriptors);
+    #pragma omp parallel for schedule(dynamic)
+    for(ptrdiff_t i = batchStart; i < static_cast<ptrdiff_t>(batchEnd); ++i)
+    {
+      // Read and quantize the descriptors, or reuse their saved histogram
+      results[i - batchStart] = quantizeDescriptorsFile<DescriptorT>(files[i].second, tree, treeHash, histogramsFolder, Nmax, newDocs[i - batchStart]);
+    }
 
-    // Insert document in database
-    db.insert(currentFile.first, newDoc);
+    for(std::size_t i = batchStart; i < batchEnd; ++i)
+    {
+      // Insert document in database
+      db.insert(files[i].first, newDocs[i - batchStart]);
 
-    // Update the overall counter
-    numDescriptors += result;
-    
-    ++display;
+      // Update the overall counter
+      numDescriptors += results[i - batchStart];
+
+      ++display;
+    }
   }
 
   // Return the result
@@ -77,26 +132,42 @@ std::size_t populateDatabase(const sfmData::SfMData& sfmData,
   ALICEVISION_LOG_DEBUG("Reading the descriptors from " << descriptorsFiles.size() <<" files...");
   auto display = system::createConsoleProgressDisplay(descriptorsFiles.size(), std::cout);
 
-  // Run through the path vector and read the descriptors
-  for(const auto &currentFile : descriptorsFiles)
+  // Read and quantize the descriptors of several files concurrently,
+  // the documents are inserted in the database in the files order
+  const std::vector<std::pair<IndexT, std::string>> files(descriptorsFiles.begin(), descriptorsFiles.end());
+  const std::size_t batchSize = 4 * omp_get_max_threads();
+
+  for(std::size_t batchStart = 0; batchStart < files.size(); batchStart += batchSize)
   {
-    std::vector<DescriptorT> descriptors;
+    const std::size_t batchEnd = std::min(files.size(), batchStart + batchSize);
+    std::vector<SparseHistogram> newDocs(batchEnd - batchStart);
+    std::vector<std::vector<DescriptorT>> batchDescriptors(batchEnd - batchStart);
 
-    // Read the descriptors
-    loadDescsFromBinFile(currentFile.second, descriptors, false, Nmax);
-    size_t result = descriptors.size();
-    
-    allDescriptors[currentFile.first] = descriptors;
-    
-    SparseHistogram newDoc = tree.quantizeToSparse(descriptors);
-    
-    // Insert document in database
-    db.insert(currentFile.first, newDoc);
+    #pragma omp parallel for schedule(dynamic)
+    for(ptrdiff_t i = batchStart; i < static_cast<ptrdiff_t>(batchEnd); ++i)
+    {
+      std::vector<DescriptorT>& descriptors = batchDescriptors[i - batchStart];
+
+      // Read the descriptors
+      loadDescsFromBinFile(files[i].second, descriptors, false, Nmax);
 
-    // Update the overall counter
-    numDescriptors += result;
+      newDocs[i - batchStart] = tree.quantizeToSparse(descriptors);
+    }
+
+    for(std::size_t i = batchStart; i < batchEnd; ++i)
+    {
+      std::vector<DescriptorT>& descriptors = batchDescriptors[i - batchStart];
 
-    ++display;
+      // Update the overall counter
+      numDescriptors += descriptors.size();
+
+      allDescriptors[files[i].first] = std::move(descriptors);
+
+      // Insert document in database
+      db.insert(files[i].first, newDocs[i - batchStart]);
+
+      ++display;
+    }
   }
 
   // Return the result
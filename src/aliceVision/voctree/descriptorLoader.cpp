@@ -115,5 +115,13 @@ void getListOfDescriptorFiles(const sfmData::SfMData& sfmData,
     }
 }
 
+std::string getSparseHistogramFile(const std::string& histogramsFolder, const std::string& descriptorsFile)
+{
+    namespace bfs = boost::filesystem;
+
+    // <viewId>.<describerType>.desc -> <viewId>.<describerType>.bow
+    return (bfs::path(histogramsFolder) / bfs::path(descriptorsFile).filename().replace_extension(".bow")).string();
+}
+
 }  // namespace voctree
 }  // namespace aliceVision
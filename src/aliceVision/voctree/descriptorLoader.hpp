@@ -37,6 +37,14 @@ void getListOfDescriptorFiles(const sfmData::SfMData& sfmData,
                               const std::vector<std::string>& featuresFolders,
                               std::map<IndexT, std::string>& descriptorsFiles);
 
+/**
+ * @brief Get the path of the sparse histogram file of a descriptor file, <viewId>.<describerType>.bow
+ * @param[in] histogramsFolder The folder containing the sparse histogram files
+ * @param[in] descriptorsFile The .desc filename
+ * @return the sparse histogram filename
+ */
+std::string getSparseHistogramFile(const std::string& histogramsFolder, const std::string& descriptorsFile);
+
 /**
  * @brief Read a set of descriptors from a file containing the path to the descriptor files.
  * @param[in] sfmDataPath The input sfmData
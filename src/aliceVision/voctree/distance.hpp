@@ -12,6 +12,33 @@
 namespace aliceVision {
 namespace voctree {
 
+namespace detail {
+
+/**
+ * @brief Accumulation type of the squared differences between two descriptor types.
+ *        8-bit integer descriptors (SIFT, AKAZE_MLDB) are accumulated in int32: the sum is exact and
+ *        the loop vectorizes, as long as the descriptors have less than 33025 components.
+ */
+template<class ValueA, class ValueB>
+struct L2Accumulator
+{
+    typedef double type;
+};
+
+template<>
+struct L2Accumulator<unsigned char, unsigned char>
+{
+    typedef int32_t type;
+};
+
+template<>
+struct L2Accumulator<signed char, signed char>
+{
+    typedef int32_t type;
+};
+
+}  // namespace detail
+
 /**
  * \brief Default implementation of L2 distance metric.
  *
@@ -26,13 +53,15 @@ struct L2
 
     result_type operator()(const DescriptorA& a, const DescriptorB& b) const
     {
-        result_type result = result_type(0);
+        typedef typename detail::L2Accumulator<typename DescriptorA::value_type, typename DescriptorB::value_type>::type accumulator_type;
+
+        accumulator_type result = accumulator_type(0);
         for (std::size_t i = 0; i < a.size(); ++i)
         {
-            result_type diff = (result_type)a[i] - (result_type)b[i];
+            const accumulator_type diff = (accumulator_type)a[i] - (accumulator_type)b[i];
             result += diff * diff;
         }
-        return result;
+        return result_type(result);
     }
 };
 
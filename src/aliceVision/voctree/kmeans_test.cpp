@@ -306,3 +306,63 @@ BOOST_AUTO_TEST_CASE(kmeanVarying)
         }
     }
 }
+
+BOOST_AUTO_TEST_CASE(kmeanMiniBatch)
+{
+    using namespace aliceVision;
+    ALICEVISION_LOG_DEBUG("Testing mini-batch kmeans...");
+
+    makeRandomOperationsReproducible();
+
+    const std::size_t DIMENSION = 16;
+    const std::size_t FEATURENUMBER = 2000;
+    const std::size_t K = 10;
+    const std::size_t STEP = 5 * K;
+
+    typedef Eigen::RowVectorXf FeatureFloat;
+    typedef std::vector<FeatureFloat, Eigen::aligned_allocator<FeatureFloat>> FeatureFloatVector;
+
+    FeatureFloatVector features;
+    FeatureFloatVector centers;
+    std::vector<unsigned int> membership;
+
+    voctree::SimpleKmeans<FeatureFloat> kmeans(FeatureFloat::Zero(DIMENSION));
+    kmeans.setVerbose(0);
+    kmeans.setRestarts(3);
+    kmeans.setMiniBatchSize(1000);
+
+    // generate k clusters well far away
+    features.reserve(FEATURENUMBER * K);
+    for (std::size_t i = 0; i < K; ++i)
+    {
+        for (std::size_t j = 0; j < FEATURENUMBER; ++j)
+        {
+            features.push_back((FeatureFloat::Random(DIMENSION) + FeatureFloat::Constant(DIMENSION, STEP * i) -
+                                FeatureFloat::Constant(DIMENSION, STEP * (K - 1) / 2)) /
+                               ((STEP * (K - 1) / 2) * sqrt(DIMENSION)));
+        }
+    }
+
+    kmeans.cluster(features, K, centers, membership);
+    BOOST_REQUIRE_EQUAL(centers.size(), K);
+    BOOST_REQUIRE_EQUAL(membership.size(), features.size());
+
+    // each cluster is retrieved as a whole
+    for (std::size_t i = 0; i < K; ++i)
+    {
+        for (std::size_t j = 1; j < FEATURENUMBER; ++j)
+        {
+            BOOST_CHECK_EQUAL(membership[i * FEATURENUMBER + j], membership[i * FEATURENUMBER]);
+        }
+    }
+
+    std::vector<size_t> h(K, 0);
+    for (size_t i = 0; i < membership.size(); ++i)
+    {
+        ++h[membership[i]];
+    }
+    for (size_t i = 0; i < h.size(); ++i)
+    {
+        BOOST_CHECK_EQUAL(h[i], FEATURENUMBER);
+    }
+}
@@ -0,0 +1,115 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <aliceVision/voctree/TreeBuilder.hpp>
+#include <aliceVision/voctree/Database.hpp>
+#include <aliceVision/feature/Descriptor.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <vector>
+
+using namespace aliceVision;
+using namespace aliceVision::voctree;
+
+namespace {
+
+using DescriptorFloat = feature::Descriptor<float, 128>;
+using DescriptorUChar = feature::Descriptor<unsigned char, 128>;
+using Tree = TreeBuilder<DescriptorFloat>::Tree;
+
+/**
+ * @brief Random SIFT-like descriptors, drawn around a few centers so the k-means converges.
+ */
+std::vector<DescriptorUChar> createRandomDescriptors(std::size_t nbDescriptors, unsigned int seed)
+{
+    std::mt19937 generator(seed);
+    std::uniform_int_distribution<int> centerDist(0, 63);
+    std::uniform_int_distribution<int> valueDist(0, 255);
+    std::normal_distribution<float> noise(0.0f, 10.0f);
+
+    std::vector<DescriptorUChar> centers(64);
+    for (DescriptorUChar& center : centers)
+        for (std::size_t i = 0; i < DescriptorUChar::static_size; ++i)
+            center[i] = static_cast<unsigned char>(valueDist(generator));
+
+    std::vector<DescriptorUChar> descriptors(nbDescriptors);
+    for (DescriptorUChar& descriptor : descriptors)
+    {
+        const DescriptorUChar& center = centers[centerDist(generator)];
+        for (std::size_t i = 0; i < DescriptorUChar::static_size; ++i)
+            descriptor[i] = static_cast<unsigned char>(std::min(255.0f, std::max(0.0f, center[i] + noise(generator))));
+    }
+    return descriptors;
+}
+
+/**
+ * @brief Vocabulary tree of 10^3 words, built once for all the benchmarks.
+ */
+const Tree& getTree()
+{
+    static const Tree tree = [] {
+        const std::vector<DescriptorUChar> descriptors = createRandomDescriptors(10000, 0);
+        TreeBuilder<DescriptorFloat>::FeatureVector trainingFeatures(descriptors.size());
+        for (std::size_t d = 0; d < descriptors.size(); ++d)
+            for (std::size_t i = 0; i < DescriptorFloat::static_size; ++i)
+                trainingFeatures[d][i] = descriptors[d][i];
+
+        TreeBuilder<DescriptorFloat> builder(DescriptorFloat(0.0f));
+        builder.kmeans().setRestarts(1);
+        builder.build(trainingFeatures, 10, 3);
+        return builder.tree();
+    }();
+    return tree;
+}
+
+/**
+ * @brief Quantize state.range(0) descriptors into visual words.
+ */
+void BM_VocabularyTree_quantize(benchmark::State& state)
+{
+    const Tree& tree = getTree();
+    const std::vector<DescriptorUChar> descriptors = createRandomDescriptors(static_cast<std::size_t>(state.range(0)), 1);
+
+    for (auto _ : state)
+    {
+        const std::vector<Word> words = tree.quantize(descriptors);
+        benchmark::DoNotOptimize(words.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * descriptors.size());
+}
+
+/**
+ * @brief Find the 50 nearest documents of a query in a database of state.range(0) documents.
+ */
+void BM_Database_find(benchmark::State& state)
+{
+    const Tree& tree = getTree();
+    const int nbDocuments = static_cast<int>(state.range(0));
+
+    Database db(tree.words());
+    for (int i = 0; i < nbDocuments; ++i)
+        db.insert(i, tree.quantizeToSparse(createRandomDescriptors(500, 100 + i)));
+    db.computeTfIdfWeights();
+
+    const SparseHistogram query = tree.quantizeToSparse(createRandomDescriptors(500, 2));
+
+    for (auto _ : state)
+    {
+        std::vector<DocMatch> matches;
+        db.find(query, 50, matches);
+        benchmark::DoNotOptimize(matches.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * nbDocuments);
+}
+
+}  // namespace
+
+BENCHMARK(BM_VocabularyTree_quantize)->Arg(10000)->Arg(50000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_Database_find)->Arg(100)->Arg(1000)->Unit(benchmark::kMicrosecond);
@@ -5,9 +5,13 @@
 // You can obtain one at https://mozilla.org/MPL/2.0/.
 
 #include <aliceVision/voctree/Database.hpp>
+#include <aliceVision/voctree/distance.hpp>
 
 #include <iostream>
+#include <array>
+#include <cstdio>
 #include <fstream>
+#include <random>
 #include <vector>
 
 #define BOOST_TEST_MODULE vocabularyTree
@@ -57,3 +61,109 @@ BOOST_AUTO_TEST_CASE(database)
         BOOST_CHECK_SMALL(static_cast<double>(match[0].score), 0.001);
     }
 }
+
+BOOST_AUTO_TEST_CASE(distanceL2)
+{
+    typedef std::array<unsigned char, 128> DescriptorUChar;
+    typedef std::array<float, 128> DescriptorFloat;
+
+    std::mt19937 generator(0);
+    std::uniform_int_distribution<int> distribution(0, 255);
+
+    for (int n = 0; n < 100; ++n)
+    {
+        DescriptorUChar a;
+        DescriptorUChar b;
+        DescriptorFloat fa;
+        DescriptorFloat fb;
+        for (std::size_t i = 0; i < a.size(); ++i)
+        {
+            a[i] = distribution(generator);
+            b[i] = (n == 0) ? 255 - a[i] : distribution(generator);
+            fa[i] = a[i];
+            fb[i] = b[i];
+        }
+
+        // the integer accumulation of 8-bit descriptors is exact
+        BOOST_CHECK_EQUAL(L2<DescriptorUChar>()(a, b), L2<DescriptorFloat>()(fa, fb));
+        BOOST_CHECK_EQUAL(L2<DescriptorUChar>()(a, a), 0.0);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(databaseInvertedFiles)
+{
+    const int cardDocuments = 50;
+    const int cardWords = 200;
+
+    std::mt19937 generator(0);
+    std::uniform_int_distribution<int> wordDistribution(0, cardWords - 1);
+    std::uniform_int_distribution<int> sizeDistribution(0, 100);
+
+    Database db(cardWords);
+    std::vector<SparseHistogram> documents(cardDocuments);
+    for (int i = 0; i < cardDocuments; ++i)
+    {
+        std::vector<Word> document(sizeDistribution(generator));
+        for (Word& word : document)
+        {
+            word = wordDistribution(generator);
+        }
+        computeSparseHistogram(document, documents[i]);
+        db.insert(i, documents[i]);
+    }
+
+    // the scores from the inverted files are the same as the brute force distances
+    for (const std::string distanceMethod : {"classic", "commonPoints", "strongCommonPoints"})
+    {
+        for (int i = 0; i < cardDocuments; ++i)
+        {
+            std::vector<DocMatch> matches;
+            db.find(documents[i], cardDocuments, matches, distanceMethod);
+            BOOST_REQUIRE_EQUAL(matches.size(), cardDocuments);
+
+            for (const DocMatch& match : matches)
+            {
+                BOOST_CHECK_EQUAL(match.score, sparseDistance(documents[i], documents[match.id], distanceMethod));
+            }
+            for (std::size_t j = 1; j < matches.size(); ++j)
+            {
+                BOOST_CHECK(!(matches[j] < matches[j - 1]));
+            }
+        }
+    }
+
+    // the batched queries give the same matches
+    std::vector<std::vector<DocMatch>> batchMatches;
+    db.findBatch(documents, 10, batchMatches);
+    BOOST_REQUIRE_EQUAL(batchMatches.size(), cardDocuments);
+    for (int i = 0; i < cardDocuments; ++i)
+    {
+        std::vector<DocMatch> matches;
+        db.find(documents[i], 10, matches);
+        BOOST_REQUIRE_EQUAL(batchMatches[i].size(), matches.size());
+        for (std::size_t j = 0; j < matches.size(); ++j)
+        {
+            BOOST_CHECK_EQUAL(batchMatches[i][j].score, matches[j].score);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(sparseHistogramIO)
+{
+    SparseHistogram histogram;
+    computeSparseHistogram({3, 17, 3, 100000, 17, 3}, histogram);
+
+    const std::string filepath = "sparseHistogramIO_test.bow";
+    BOOST_CHECK(saveSparseHistogram(filepath, histogram, 42, 0));
+
+    SparseHistogram loaded;
+    BOOST_CHECK(loadSparseHistogram(filepath, 42, 0, loaded));
+    BOOST_CHECK(loaded == histogram);
+
+    // the histogram is invalidated by another tree or descriptors limit
+    BOOST_CHECK(!loadSparseHistogram(filepath, 43, 0, loaded));
+    BOOST_CHECK(!loadSparseHistogram(filepath, 42, 1000, loaded));
+    BOOST_CHECK(!loadSparseHistogram("missing_test.bow", 42, 0, loaded));
+
+    std::remove(filepath.c_str());
+}
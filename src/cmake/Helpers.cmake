@@ -251,3 +251,72 @@ function(alicevision_add_test test_file)
   endif()
 
 endfunction()
+
+# Add a benchmark executable, built only if ALICEVISION_BUILD_BENCHMARKS is ON
+#
+# alicevision_add_benchmark(file.cpp NAME "name" LINKS aliceVision_xxx)
+#
+# The benchmark file uses the Google Benchmark macros, the main function is shared by all the benchmarks.
+function(alicevision_add_benchmark benchmark_file)
+  set(options "")
+  set(singleValues NAME)
+  set(multipleValues LINKS INCLUDE_DIRS)
+
+  cmake_parse_arguments(BENCHMARK "${options}" "${singleValues}" "${multipleValues}" ${ARGN})
+
+  if(NOT benchmark_file)
+    message(FATAL_ERROR "You must provide the benchmark file in 'alicevision_add_benchmark'")
+  endif()
+
+  if(NOT BENCHMARK_NAME)
+    message(FATAL_ERROR "You must provide the NAME in 'alicevision_add_benchmark'")
+  endif()
+
+  if(NOT ALICEVISION_BUILD_BENCHMARKS)
+    return()
+  endif()
+
+  set(BENCHMARK_EXECUTABLE_NAME "aliceVision_benchmark_${BENCHMARK_NAME}")
+
+  add_executable(${BENCHMARK_EXECUTABLE_NAME} ${benchmark_file} ${PROJECT_SOURCE_DIR}/aliceVision/system/benchmarkMain.cpp)
+
+  target_link_libraries(${BENCHMARK_EXECUTABLE_NAME}
+    PUBLIC ${BENCHMARK_LINKS}
+           ${ALICEVISION_LIBRARY_DEPENDENCIES}
+           aliceVision_system
+           benchmark::benchmark
+  )
+
+  target_include_directories(${BENCHMARK_EXECUTABLE_NAME}
+    PUBLIC ${BENCHMARK_INCLUDE_DIRS}
+  )
+
+  set_property(TARGET ${BENCHMARK_EXECUTABLE_NAME}
+    PROPERTY FOLDER Benchmark
+  )
+
+  set_property(GLOBAL APPEND PROPERTY ALICEVISION_BENCHMARK_TARGETS ${BENCHMARK_EXECUTABLE_NAME})
+endfunction()
+
+# Add a target running all the benchmarks added by alicevision_add_benchmark,
+# each benchmark writes its results in <output_dir>/<benchmark>.json
+function(alicevision_add_benchmarks_run_target target_name output_dir)
+  get_property(BENCHMARK_TARGETS GLOBAL PROPERTY ALICEVISION_BENCHMARK_TARGETS)
+
+  set(BENCHMARK_COMMANDS COMMAND ${CMAKE_COMMAND} -E make_directory ${output_dir})
+  foreach(BENCHMARK_TARGET ${BENCHMARK_TARGETS})
+    list(APPEND BENCHMARK_COMMANDS
+      COMMAND $<TARGET_FILE:${BENCHMARK_TARGET}>
+              --benchmark_out=${output_dir}/${BENCHMARK_TARGET}.json
+              --benchmark_out_format=json
+    )
+  endforeach()
+
+  add_custom_target(${target_name}
+    ${BENCHMARK_COMMANDS}
+    DEPENDS ${BENCHMARK_TARGETS}
+    WORKING_DIRECTORY ${CMAKE_RUNTIME_OUTPUT_DIRECTORY}
+    COMMENT "Running the AliceVision benchmarks"
+    VERBATIM
+  )
+endfunction()
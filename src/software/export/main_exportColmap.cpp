@@ -20,7 +20,7 @@
 // These constants define the current software version.
 // They must be updated when the command line is changed.
 #define ALICEVISION_SOFTWARE_VERSION_MAJOR 1
-#define ALICEVISION_SOFTWARE_VERSION_MINOR 0
+#define ALICEVISION_SOFTWARE_VERSION_MINOR 1
 
 using namespace aliceVision;
 
@@ -33,6 +33,8 @@ int aliceVision_main(int argc, char* argv[])
     std::string sfmDataFilename;
     std::string outDirectory;
     bool copyImages{false};
+    bool symlinkImages{false};
+    bool binary{false};
 
 
     po::options_description requiredParams("Required parameters");
@@ -45,10 +47,19 @@ int aliceVision_main(int argc, char* argv[])
              "Copy original images to colmap folder. This is required if your images are not all in the same "
              "folder.");
 
+    po::options_description optionalParams("Optional parameters");
+    optionalParams.add_options()
+        ("symlinkImages", po::value<bool>(&symlinkImages)->default_value(symlinkImages),
+             "Create symbolic links to the original images instead of copying them (with copyImages).")
+        ("binary", po::value<bool>(&binary)->default_value(binary),
+             "Also write the scene in the Colmap binary format (cameras.bin, images.bin and points3D.bin), "
+             "faster to load for large scenes.");
+
     CmdLine cmdline("Export an AV sfmdata to a Colmap scene, creating the folder structure and "
                     "the scene files that can be used for running a MVS step.\n"
                     "AliceVision exportColmap");
     cmdline.add(requiredParams);
+    cmdline.add(optionalParams);
     if (!cmdline.execute(argc, argv))
     {
         return EXIT_FAILURE;
@@ -67,7 +78,7 @@ int aliceVision_main(int argc, char* argv[])
         return EXIT_FAILURE;
     }
 
-    sfmDataIO::convertToColmapScene(sfmData, outDirectory, copyImages);
+    sfmDataIO::convertToColmapScene(sfmData, outDirectory, copyImages, symlinkImages, binary);
 
     return EXIT_SUCCESS;
 }
\ No newline at end of file
@@ -8,17 +8,20 @@
 #include <aliceVision/sfmData/SfMData.hpp>
 #include <aliceVision/sfmDataIO/sfmDataIO.hpp>
 #include <aliceVision/image/all.hpp>
+#include <aliceVision/system/Logger.hpp>
 #include <aliceVision/system/main.hpp>
 #include <aliceVision/cmdline/cmdline.hpp>
 #include <boost/program_options.hpp>
 #include <boost/filesystem.hpp>
 
+#include <atomic>
 #include <fstream>
+#include <vector>
 
 // These constants define the current software version.
 // They must be updated when the command line is changed.
 #define ALICEVISION_SOFTWARE_VERSION_MAJOR 1
-#define ALICEVISION_SOFTWARE_VERSION_MINOR 0
+#define ALICEVISION_SOFTWARE_VERSION_MINOR 1
 
 using namespace aliceVision;
 using namespace aliceVision::camera;
@@ -33,6 +36,7 @@ int aliceVision_main(int argc, char **argv)
   // command-line parameters
   std::string sfmDataFilename;
   std::string outDirectory;
+  bool exportImages = false;
 
   po::options_description requiredParams("Required parameters");
   requiredParams.add_options()
@@ -41,16 +45,21 @@ int aliceVision_main(int argc, char **argv)
     ("output,o", po::value<std::string>(&outDirectory)->required(),
       "Output folder.");
 
+  po::options_description optionalParams("Optional parameters");
+  optionalParams.add_options()
+    ("exportImages", po::value<bool>(&exportImages)->default_value(exportImages),
+      "Export the images next to the .cam files: the images with distortion are undistorted, "
+      "the others are symbolic links to the original images.");
+
   CmdLine cmdline("AliceVision exportMVSTexturing");
   cmdline.add(requiredParams);
+  cmdline.add(optionalParams);
   if (!cmdline.execute(argc, argv))
   {
       return EXIT_FAILURE;
   }
 
 
-  bool bOneHaveDisto = false;
-  
   // Create output dir
   if (!fs::exists(outDirectory))
     fs::create_directory(outDirectory);
@@ -64,20 +73,26 @@ int aliceVision_main(int argc, char **argv)
     return EXIT_FAILURE;
   }
 
-  for(Views::const_iterator iter = sfm_data.getViews().begin();
-      iter != sfm_data.getViews().end(); ++iter)
+  std::vector<const View*> views;
+  for (const auto& viewPair : sfm_data.getViews())
   {
-    const View * view = iter->second.get();
-    if (!sfm_data.isPoseAndIntrinsicDefined(view))
-        continue;
-    
+    const View * view = viewPair.second.get();
+    if (sfm_data.isPoseAndIntrinsicDefined(view) && camera::isPinhole(sfm_data.getIntrinsicPtr(view->getIntrinsicId())->getType()))
+      views.push_back(view);
+  }
+
+  std::atomic<bool> bOneHaveDisto{false};
+  std::atomic<int> nbImageErrors{0};
+
+  // the views are independent: the .cam files and the images are exported in parallel
+  #pragma omp parallel for schedule(dynamic)
+  for (int i = 0; i < static_cast<int>(views.size()); ++i)
+  {
+    const View * view = views[i];
+
     // Valid view, we can ask a pose & intrinsic data
     const Pose3 pose = sfm_data.getPose(*view).getTransform();
-    Intrinsics::const_iterator iterIntrinsic = sfm_data.getIntrinsics().find(view->getIntrinsicId());
-    const IntrinsicBase * cam = iterIntrinsic->second.get();
-    
-    if (!camera::isPinhole(cam->getType()))
-        continue;
+    const IntrinsicBase * cam = sfm_data.getIntrinsicPtr(view->getIntrinsicId());
 
     const Pinhole * pinhole_cam = static_cast<const Pinhole *>(cam);
     
@@ -94,7 +109,8 @@ int aliceVision_main(int argc, char **argv)
     const int h = pinhole_cam->h();
     
     // We can now create the .cam file for the View in the output dir 
-    std::ofstream outfile((fs::path(outDirectory) / (fs::path(view->getImage().getImagePath()).stem().string() + ".cam")).string());
+    const fs::path srcImage(view->getImage().getImagePath());
+    std::ofstream outfile((fs::path(outDirectory) / (srcImage.stem().string() + ".cam")).string());
     // See https://github.com/nmoehrle/mvs-texturing/blob/master/Arguments.cpp
     // for full specs
     const int largerDim = w > h ? w : h;
@@ -107,8 +123,40 @@ int aliceVision_main(int argc, char **argv)
     
     if(cam->hasDistortion())
       bOneHaveDisto = true;
+
+    if (!exportImages)
+      continue;
+
+    const fs::path dstImage = fs::path(outDirectory) / srcImage.filename();
+    if (cam->hasDistortion())
+    {
+      image::Image<image::RGBColor> imageIn, imageUd;
+      image::readImage(srcImage.string(), imageIn, image::EImageColorSpace::NO_CONVERSION);
+      camera::UndistortImage(imageIn, cam, imageUd, image::BLACK);
+      image::writeImage(dstImage.string(), imageUd, image::ImageWriteOptions().toColorSpace(image::EImageColorSpace::NO_CONVERSION));
+    }
+    else
+    {
+      boost::system::error_code ec;
+      fs::create_symlink(fs::absolute(srcImage), dstImage, ec);
+      if (ec)
+      {
+        ALICEVISION_LOG_ERROR("Unable to link the image " << srcImage << " to " << dstImage << ": " << ec.message());
+        ++nbImageErrors;
+      }
+    }
+  }
+
+  if (nbImageErrors > 0)
+    return EXIT_FAILURE;
+
+  if (exportImages)
+  {
+    std::cout << "Your SfMData file was succesfully converted!\n"
+              << "Now you can run MVS Texturing on the \"" << outDirectory << "\" folder" << std::endl;
+    return EXIT_SUCCESS;
   }
-  
+
   const std::string sUndistMsg = bOneHaveDisto ? "undistorded" : "";
   const std::string sQuitMsg = std::string("Your SfMData file was succesfully converted!\n") +
     "Now you can copy your " + sUndistMsg + " images in the \"" + outDirectory + "\" folder and run MVS Texturing";
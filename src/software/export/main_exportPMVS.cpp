@@ -107,20 +107,29 @@ bool exportToPMVSFormat(
     }
 
     // Export (calibrated) views as undistorted images
-    Image<RGBColor> image, image_ud;
-    for(Views::const_iterator iter = sfm_data.getViews().begin();
-      iter != sfm_data.getViews().end(); ++iter, ++progressDisplay)
+    // the views are independent: they are read, undistorted and written in parallel
+    std::vector<const View*> views;
+    views.reserve(sfm_data.getViews().size());
+    for (const auto& viewPair : sfm_data.getViews())
     {
-      const View * view = iter->second.get();
-      if (!sfm_data.isPoseAndIntrinsicDefined(view))
-        continue;
+      if (sfm_data.isPoseAndIntrinsicDefined(viewPair.second.get()))
+        views.push_back(viewPair.second.get());
+      else
+        ++progressDisplay;
+    }
+
+    #pragma omp parallel for schedule(dynamic)
+    for (int i = 0; i < static_cast<int>(views.size()); ++i)
+    {
+      const View * view = views[i];
+      Image<RGBColor> image, image_ud;
 
       Intrinsics::const_iterator iterIntrinsic = sfm_data.getIntrinsics().find(view->getIntrinsicId());
 
       // We have a valid view with a corresponding camera & pose
       const std::string srcImage = view->getImage().getImagePath();
       std::ostringstream os;
-      os << std::setw(8) << std::setfill('0') << map_viewIdToContiguous[view->getViewId()];
+      os << std::setw(8) << std::setfill('0') << map_viewIdToContiguous.at(view->getViewId());
       const std::string dstImage = (fs::path(sOutDirectory) / std::string("visualize") / (os.str() + ".jpg")).string();
       const IntrinsicBase * cam = iterIntrinsic->second.get();
       if (cam->isValid() && cam->hasDistortion())
@@ -146,6 +155,7 @@ bool exportToPMVSFormat(
                      image::ImageWriteOptions().toColorSpace(image::EImageColorSpace::NO_CONVERSION));
         }
       }
+      ++progressDisplay;
     }
 
     //pmvs_options.txt
@@ -188,8 +198,8 @@ bool exportToPMVSFormat(
           }
         }
       }
-      // Export the vis.dat file
-      std::ostringstream osVisData;
+      // Export the vis.dat file, streamed to the file (no copy of the whole content in memory)
+      std::ofstream osVisData((fs::path(sOutDirectory) / "vis.dat").string());
       osVisData
         << "VISDATA" << os.widen('\n')
         << view_shared.size() << os.widen('\n'); // #images
@@ -206,9 +216,7 @@ bool exportToPMVSFormat(
         }
         osVisData << os.widen('\n');
       }
-      std::ofstream file((fs::path(sOutDirectory) / "vis.dat").string());
-      file << osVisData.str();
-      file.close();
+      osVisData.close();
     }
 
     std::ofstream file((fs::path(sOutDirectory) / "pmvs_options.txt").string());
@@ -33,6 +33,7 @@
 
 #include <sstream>
 
+#include <atomic>
 #include <fstream>
 #include <map>
 
@@ -316,38 +317,45 @@ int aliceVision_main(int argc, char** argv)
                 groupedExposures.push_back(getExposures(exposuresSetting));
             }
 
-            std::size_t group_pos = 0;
-            hdr::Sampling sampling;
+            // Read the samples of all the groups concurrently, they are used by both the analysis and the extraction
+            std::vector<std::vector<hdr::ImageSample>> groupedSamples(groupedViews.size());
+            std::atomic<bool> samplesRead(true);
 
-            ALICEVISION_LOG_INFO("Analyzing samples for each group.");
-            for (auto& group : groupedViews)
+#pragma omp parallel for schedule(dynamic)
+            for (int i = 0; i < groupedViews.size(); ++i)
             {
-                if (group.size() == 0)
+                if (groupedViews[i].size() == 0)
                 {
                     continue;
                 }
 
-                bool first = true;
-                IndexT firstViewId = group.begin()->get()->getViewId();
-
-                // Read from file
+                const IndexT firstViewId = groupedViews[i].begin()->get()->getViewId();
                 const std::string samplesFilepath = (fs::path(samplesFolder) / (std::to_string(firstViewId) + "_samples.dat")).string();
-                std::ifstream fileSamples(samplesFilepath, std::ios::binary);
-                if (!fileSamples.is_open())
+                if (!hdr::readSamples(samplesFilepath, groupedSamples[i]))
                 {
-                    ALICEVISION_LOG_ERROR("Cannot read samples from file " << samplesFilepath << ".");
-                    return EXIT_FAILURE;
+                    samplesRead = false;
                 }
+            }
+
+            if (!samplesRead)
+            {
+                return EXIT_FAILURE;
+            }
 
-                std::size_t size;
-                fileSamples.read((char*)&size, sizeof(size));
+            std::size_t group_pos = 0;
+            hdr::Sampling sampling;
 
-                std::vector<hdr::ImageSample> samples(size);
-                for (std::size_t i = 0; i < size; ++i)
+            ALICEVISION_LOG_INFO("Analyzing samples for each group.");
+            for (std::size_t i = 0; i < groupedViews.size(); ++i)
+            {
+                const auto& group = groupedViews[i];
+                if (group.size() == 0)
                 {
-                    fileSamples >> samples[i];
+                    continue;
                 }
 
+                std::vector<hdr::ImageSample>& samples = groupedSamples[i];
+
                 sampling.analyzeSource(samples, channelQuantization, group_pos);
 
                 std::map<int, luminanceInfo> luminanceInfos;
@@ -378,16 +386,14 @@ int aliceVision_main(int argc, char** argv)
                 group_pos = 0;
 
                 std::size_t total = 0;
-                for (auto& group : groupedViews)
+                for (std::size_t i = 0; i < groupedViews.size(); ++i)
                 {
+                    const auto& group = groupedViews[i];
                     if (group.size() == 0)
                     {
                         continue;
                     }
 
-                    bool first = true;
-                    IndexT firstViewId = group.begin()->get()->getViewId();
-
                     if (calibrationMethod == ECalibrationMethod::AUTO)
                     {
                         const bool isRAW = image::isRawFormat(group.begin()->get()->getImage().getImagePath());
@@ -396,23 +402,7 @@ int aliceVision_main(int argc, char** argv)
                         ALICEVISION_LOG_INFO("Calibration method automatically set to " << calibrationMethod << ".");
                     }
 
-                    // Read from file
-                    const std::string samplesFilepath = (fs::path(samplesFolder) / (std::to_string(firstViewId) + "_samples.dat")).string();
-                    std::ifstream fileSamples(samplesFilepath, std::ios::binary);
-                    if (!fileSamples.is_open())
-                    {
-                        ALICEVISION_LOG_ERROR("Cannot read samples from file " << samplesFilepath << ".");
-                        return EXIT_FAILURE;
-                    }
-
-                    std::size_t size = 0;
-                    fileSamples.read((char*)&size, sizeof(size));
-
-                    std::vector<hdr::ImageSample> samples(size);
-                    for (int i = 0; i < size; ++i)
-                    {
-                        fileSamples >> samples[i];
-                    }
+                    const std::vector<hdr::ImageSample>& samples = groupedSamples[i];
 
                     std::vector<hdr::ImageSample> out_samples;
                     sampling.extractUsefulSamples(out_samples, samples, group_pos);
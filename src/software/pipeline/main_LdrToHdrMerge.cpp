@@ -9,6 +9,8 @@
 #include <aliceVision/system/Logger.hpp>
 #include <aliceVision/cmdline/cmdline.hpp>
 #include <aliceVision/system/main.hpp>
+#include <aliceVision/system/ChunkClaimer.hpp>
+#include <aliceVision/system/MemoryBudget.hpp>
 #include <OpenImageIO/imageio.h>
 #include <OpenImageIO/imagebufalgo.h>
 
@@ -24,13 +26,15 @@
 // Command line parameters
 #include <boost/program_options.hpp>
 #include <boost/filesystem.hpp>
+#include <atomic>
+#include <memory>
 #include <sstream>
 #include <iomanip>
 
 // These constants define the current software version.
 // They must be updated when the command line is changed.
 #define ALICEVISION_SOFTWARE_VERSION_MAJOR 0
-#define ALICEVISION_SOFTWARE_VERSION_MINOR 1
+#define ALICEVISION_SOFTWARE_VERSION_MINOR 2
 
 using namespace aliceVision;
 
@@ -96,6 +100,7 @@ int aliceVision_main(int argc, char** argv)
 
     int rangeStart = -1;
     int rangeSize = 1;
+    std::string rangeClaimFolder;
 
     // Command line parameters
     po::options_description requiredParams("Required parameters");
@@ -144,7 +149,10 @@ int aliceVision_main(int argc, char** argv)
         ("rangeStart", po::value<int>(&rangeStart)->default_value(rangeStart),
          "Range image index start.")
         ("rangeSize", po::value<int>(&rangeSize)->default_value(rangeSize),
-         "Range size.");
+         "Range size.")
+        ("rangeClaimFolder", po::value<std::string>(&rangeClaimFolder)->default_value(rangeClaimFolder),
+         "Folder shared by the processes of the node (empty for each execution): instead of the rangeStart chunk, "
+         "each process computes the next chunks of rangeSize groups not claimed by another process.");
 
     CmdLine cmdline("This program merges LDR images into HDR images.\n"
                     "AliceVision LdrToHdrMerge");
@@ -312,7 +320,26 @@ int aliceVision_main(int argc, char** argv)
     }
 
     // Define range to compute
-    if (rangeStart != -1)
+    std::unique_ptr<system::ChunkClaimer> chunkClaimer;
+    bool hasRange = true;
+    if (!rangeClaimFolder.empty())
+    {
+        if (rangeSize <= 0)
+        {
+            ALICEVISION_LOG_ERROR("Range size should be positive to claim the chunks.");
+            return EXIT_FAILURE;
+        }
+
+        // the process claiming the first chunk exports the output SfMData
+        chunkClaimer.reset(new system::ChunkClaimer(rangeClaimFolder, int(groupedViews.size()), rangeSize));
+        hasRange = chunkClaimer->claimNext(rangeStart, rangeSize);
+        if (!hasRange)
+        {
+            ALICEVISION_LOG_INFO("All the chunks are claimed, nothing to compute.");
+            return EXIT_SUCCESS;
+        }
+    }
+    else if (rangeStart != -1)
     {
         if (rangeStart < 0 || rangeSize < 0 || rangeStart > groupedViews.size())
         {
@@ -391,16 +418,14 @@ int aliceVision_main(int argc, char** argv)
         return EXIT_SUCCESS;
     }
 
-    int rangeEnd = rangeStart + rangeSize;
+    // Load the response and fusion weight curves of each intrinsic
+    std::map<IndexT, hdr::rgbCurve> fusionWeightPerIntrinsics;
+    std::map<IndexT, hdr::rgbCurve> responsePerIntrinsics;
 
-    int pos = 0;
     for (const auto & pGroupedViews : groupedViewsPerIntrinsics)
     {
         IndexT intrinsicId = pGroupedViews.first;
 
-        const auto & groupedViews = pGroupedViews.second;
-        const auto & targetViews = targetViewsPerIntrinsics.at(intrinsicId);
-
         hdr::rgbCurve fusionWeight(channelQuantization);
         fusionWeight.setFunction(fusionWeightFunction);
         hdr::rgbCurve response(channelQuantization);
@@ -412,129 +437,214 @@ int aliceVision_main(int argc, char** argv)
         ALICEVISION_LOG_DEBUG("inputResponsePath: " << intrinsicInputResponsePath);
         response.read(intrinsicInputResponsePath);
 
-        for (std::size_t g = 0; g < groupedViews.size(); ++g, ++pos)
-        {
-            if (pos < rangeStart || pos >= rangeEnd)
-            {
-                continue;
-            }
+        fusionWeightPerIntrinsics.emplace(intrinsicId, fusionWeight);
+        responsePerIntrinsics.emplace(intrinsicId, response);
+    }
+
+    // Merge concurrently as many groups as fit in the memory budget.
+    // A single group is merged alone, with its pixels processed in parallel.
+    const std::size_t maxConcurrentGroups = std::max<std::size_t>(1, hwc.getMaxThreads());
+    std::atomic<bool> succeeded(true);
 
-            const std::vector<std::shared_ptr<sfmData::View>> & group = groupedViews[g];
+    // Compute the static range, or each chunk claimed by this process
+    while (hasRange)
+    {
+        const int rangeEnd = rangeStart + rangeSize;
+
+        // List the groups to compute
+        std::vector<IndexT> groupsIntrinsic;
+        std::vector<std::size_t> groupsIndex;
+        std::vector<int> groupsPos;
+        std::vector<std::size_t> estimatedMemories;
 
-            std::vector<image::Image<image::RGBfColor>> images(group.size());
-            std::shared_ptr<sfmData::View> targetView = targetViews[g];
-            std::vector<sfmData::ExposureSetting> exposuresSetting(group.size());
+        int pos = 0;
+        for (const auto & pGroupedViews : groupedViewsPerIntrinsics)
+        {
+            IndexT intrinsicId = pGroupedViews.first;
 
-            // Load all images of the group
-            for(std::size_t i = 0; i < group.size(); ++i)
+            const auto & groupedViews = pGroupedViews.second;
+
+            for (std::size_t g = 0; g < groupedViews.size(); ++g, ++pos)
             {
-                const std::string filepath = group[i]->getImage().getImagePath();
-                ALICEVISION_LOG_INFO("Load " << filepath);
-
-                image::ImageReadOptions options;
-                options.workingColorSpace = workingColorSpace;
-                options.rawColorInterpretation = image::ERawColorInterpretation_stringToEnum(group[i]->getImage().getRawColorInterpretation());
-                options.colorProfileFileName = group[i]->getImage().getColorProfileFileName();
-
-                // Whatever the raw color interpretation mode, the default read processing for raw images is to apply
-                // white balancing in libRaw, before demosaicing.
-                // The DcpMetadata mode allows to not apply color management after demosaicing.
-                // Because if requested after demosaicing, white balancing is done at color management stage, we can
-                // set this option to true to get real raw data, without any white balancing, when the DcpMetadata mode
-                // is selected.
-                if (options.rawColorInterpretation == image::ERawColorInterpretation::DcpMetadata)
+                if (pos < rangeStart || pos >= rangeEnd)
                 {
-                    options.doWBAfterDemosaicing = true;
+                    continue;
                 }
-                
-                image::readImage(filepath, images[i], options);
 
-                exposuresSetting[i] = group[i]->getImage().getCameraExposureSetting();
+                // the brackets, the merged image and the light masks are in memory at the same time
+                int width = 0;
+                int height = 0;
+                image::readImageSize(groupedViews[g][0]->getImage().getImagePath(), width, height);
+
+                groupsIntrinsic.push_back(intrinsicId);
+                groupsIndex.push_back(g);
+                groupsPos.push_back(pos);
+                estimatedMemories.push_back(std::size_t(width) * std::size_t(height) * (groupedViews[g].size() + 4) * sizeof(image::RGBfColor));
             }
+        }
 
-            if (!sfmData::hasComparableExposures(exposuresSetting))
+        std::size_t posStart = 0;
+        while (posStart < groupsIndex.size())
+        {
+            const std::size_t maxMemory = system::MemoryBudget::get().getAvailableBytes();
+            std::size_t posEnd = posStart;
+            std::size_t batchMemory = 0;
+            while (posEnd < groupsIndex.size() && posEnd - posStart < maxConcurrentGroups &&
+                   (posEnd == posStart || batchMemory + estimatedMemories[posEnd] <= maxMemory))
             {
-                ALICEVISION_THROW_ERROR("Camera exposure settings are inconsistent.");
+                batchMemory += estimatedMemories[posEnd];
+                posEnd++;
             }
 
-            std::vector<double> exposures = getExposures(exposuresSetting);
+            ALICEVISION_LOG_INFO("Merging groups " << posStart + 1 << " to " << posEnd << "/" << groupsIndex.size()
+                                 << " (estimated memory: " << batchMemory / (1024 * 1024) << " MB)");
 
-            // Merge HDR images
-            image::Image<image::RGBfColor> HDRimage;
-            image::Image<image::RGBfColor> lowLightMask;
-            image::Image<image::RGBfColor> highLightMask;
-            image::Image<image::RGBfColor> noMidLightMask;
-            if (images.size() > 1)
+            // wait for the memory reserved by the other stages
+            const system::MemoryReservation batchReservation(batchMemory);
+
+#pragma omp parallel for schedule(dynamic) if(posEnd - posStart > 1)
+            for (int posGroup = int(posStart); posGroup < int(posEnd); ++posGroup)
             {
-                hdr::hdrMerge merge;
-                sfmData::ExposureSetting targetCameraSetting = targetView->getImage().getCameraExposureSetting();
-                hdr::MergingParams mergingParams;
-                mergingParams.targetCameraExposure = targetCameraSetting.getExposure();
-                mergingParams.refImageIndex = targetIndexPerIntrinsics[intrinsicId];
-                mergingParams.minSignificantValue = minSignificantValue;
-                mergingParams.maxSignificantValue = maxSignificantValue;
-                mergingParams.computeLightMasks = computeLightMasks;
-               
-                merge.process(images, exposures, fusionWeight, response, HDRimage, lowLightMask, highLightMask,
-                              noMidLightMask, mergingParams);
-                if (highlightCorrectionFactor > 0.0f)
+                const IndexT intrinsicId = groupsIntrinsic[posGroup];
+                const std::size_t g = groupsIndex[posGroup];
+                const int pos = groupsPos[posGroup];
+
+                const auto & groupedViews = groupedViewsPerIntrinsics.at(intrinsicId);
+                const auto & targetViews = targetViewsPerIntrinsics.at(intrinsicId);
+                const hdr::rgbCurve & fusionWeight = fusionWeightPerIntrinsics.at(intrinsicId);
+                const hdr::rgbCurve & response = responsePerIntrinsics.at(intrinsicId);
+
+                const std::vector<std::shared_ptr<sfmData::View>> & group = groupedViews[g];
+
+                std::vector<image::Image<image::RGBfColor>> images(group.size());
+                std::shared_ptr<sfmData::View> targetView = targetViews[g];
+                std::vector<sfmData::ExposureSetting> exposuresSetting(group.size());
+
+                // Load all images of the group
+                for(std::size_t i = 0; i < group.size(); ++i)
                 {
-                    merge.postProcessHighlight(images, exposures, fusionWeight, response, HDRimage,
-                                               targetCameraSetting.getExposure(), highlightCorrectionFactor,
-                                               highlightTargetLux);
+                    const std::string filepath = group[i]->getImage().getImagePath();
+                    ALICEVISION_LOG_INFO("Load " << filepath);
+
+                    image::ImageReadOptions options;
+                    options.workingColorSpace = workingColorSpace;
+                    options.rawColorInterpretation = image::ERawColorInterpretation_stringToEnum(group[i]->getImage().getRawColorInterpretation());
+                    options.colorProfileFileName = group[i]->getImage().getColorProfileFileName();
+
+                    // Whatever the raw color interpretation mode, the default read processing for raw images is to apply
+                    // white balancing in libRaw, before demosaicing.
+                    // The DcpMetadata mode allows to not apply color management after demosaicing.
+                    // Because if requested after demosaicing, white balancing is done at color management stage, we can
+                    // set this option to true to get real raw data, without any white balancing, when the DcpMetadata mode
+                    // is selected.
+                    if (options.rawColorInterpretation == image::ERawColorInterpretation::DcpMetadata)
+                    {
+                        options.doWBAfterDemosaicing = true;
+                    }
+                
+                    image::readImage(filepath, images[i], options);
+
+                    exposuresSetting[i] = group[i]->getImage().getCameraExposureSetting();
                 }
-            }
-            else if (images.size() == 1)
-            {
-                // Nothing to do
-                HDRimage = images[0];
-            }
 
-            boost::filesystem::path p(targetView->getImage().getImagePath());
-            const std::string hdrImagePath = getHdrImagePath(outputPath, pos, keepSourceImageName ? p.stem().string() : "");
+                if (!sfmData::hasComparableExposures(exposuresSetting))
+                {
+                    ALICEVISION_LOG_ERROR("Camera exposure settings are inconsistent.");
+                    succeeded = false;
+                    continue;
+                }
 
-            // Write an image with parameters from the target view
-            std::map<std::string, std::string> viewMetadata = targetView->getImage().getMetadata();
+                std::vector<double> exposures = getExposures(exposuresSetting);
 
-            oiio::ParamValueList targetMetadata;
-            for (const auto& meta : viewMetadata)
-            {
-                if (meta.first.compare(0, 3, "raw") == 0)
+                // Merge HDR images
+                image::Image<image::RGBfColor> HDRimage;
+                image::Image<image::RGBfColor> lowLightMask;
+                image::Image<image::RGBfColor> highLightMask;
+                image::Image<image::RGBfColor> noMidLightMask;
+                if (images.size() > 1)
                 {
-                    targetMetadata.add_or_replace(oiio::ParamValue("AliceVision:" + meta.first, meta.second));
+                    hdr::hdrMerge merge;
+                    sfmData::ExposureSetting targetCameraSetting = targetView->getImage().getCameraExposureSetting();
+                    hdr::MergingParams mergingParams;
+                    mergingParams.targetCameraExposure = targetCameraSetting.getExposure();
+                    mergingParams.refImageIndex = targetIndexPerIntrinsics.at(intrinsicId);
+                    mergingParams.minSignificantValue = minSignificantValue;
+                    mergingParams.maxSignificantValue = maxSignificantValue;
+                    mergingParams.computeLightMasks = computeLightMasks;
+               
+                    merge.process(images, exposures, fusionWeight, response, HDRimage, lowLightMask, highLightMask,
+                                  noMidLightMask, mergingParams);
+                    if (highlightCorrectionFactor > 0.0f)
+                    {
+                        merge.postProcessHighlight(images, exposures, fusionWeight, response, HDRimage,
+                                                   targetCameraSetting.getExposure(), highlightCorrectionFactor,
+                                                   highlightTargetLux);
+                    }
                 }
-                else
+                else if (images.size() == 1)
                 {
-                    targetMetadata.add_or_replace(oiio::ParamValue(meta.first, meta.second));
+                    // Nothing to do
+                    HDRimage = images[0];
                 }
-            }
 
-            targetMetadata.add_or_replace(oiio::ParamValue("AliceVision:ColorSpace", image::EImageColorSpace_enumToString(mergedColorSpace)));
+                boost::filesystem::path p(targetView->getImage().getImagePath());
+                const std::string hdrImagePath = getHdrImagePath(outputPath, pos, keepSourceImageName ? p.stem().string() : "");
 
-            image::ImageWriteOptions writeOptions;
-            writeOptions.fromColorSpace(mergedColorSpace);
-            writeOptions.toColorSpace(mergedColorSpace);
-            writeOptions.storageDataType(storageDataType);
+                // Write an image with parameters from the target view
+                std::map<std::string, std::string> viewMetadata = targetView->getImage().getMetadata();
 
-            image::writeImage(hdrImagePath, HDRimage, writeOptions, targetMetadata);
+                oiio::ParamValueList targetMetadata;
+                for (const auto& meta : viewMetadata)
+                {
+                    if (meta.first.compare(0, 3, "raw") == 0)
+                    {
+                        targetMetadata.add_or_replace(oiio::ParamValue("AliceVision:" + meta.first, meta.second));
+                    }
+                    else
+                    {
+                        targetMetadata.add_or_replace(oiio::ParamValue(meta.first, meta.second));
+                    }
+                }
 
-            if (computeLightMasks)
-            {
-                const std::string hdrMaskLowLightPath =
-                    getHdrMaskPath(outputPath, pos, "lowLight", keepSourceImageName ? p.stem().string() : "");
-                const std::string hdrMaskHighLightPath =
-                    getHdrMaskPath(outputPath, pos, "highLight", keepSourceImageName ? p.stem().string() : "");
-                const std::string hdrMaskNoMidLightPath =
-                    getHdrMaskPath(outputPath, pos, "noMidLight", keepSourceImageName ? p.stem().string() : "");
-
-                image::ImageWriteOptions maskWriteOptions;
-                maskWriteOptions.exrCompressionMethod(image::EImageExrCompression::None);
-
-                image::writeImage(hdrMaskLowLightPath, lowLightMask, maskWriteOptions);
-                image::writeImage(hdrMaskHighLightPath, highLightMask, maskWriteOptions);
-                image::writeImage(hdrMaskNoMidLightPath, noMidLightMask, maskWriteOptions);
+                targetMetadata.add_or_replace(oiio::ParamValue("AliceVision:ColorSpace", image::EImageColorSpace_enumToString(mergedColorSpace)));
+
+                image::ImageWriteOptions writeOptions;
+                writeOptions.fromColorSpace(mergedColorSpace);
+                writeOptions.toColorSpace(mergedColorSpace);
+                writeOptions.storageDataType(storageDataType);
+
+                image::writeImage(hdrImagePath, HDRimage, writeOptions, targetMetadata);
+
+                if (computeLightMasks)
+                {
+                    const std::string hdrMaskLowLightPath =
+                        getHdrMaskPath(outputPath, pos, "lowLight", keepSourceImageName ? p.stem().string() : "");
+                    const std::string hdrMaskHighLightPath =
+                        getHdrMaskPath(outputPath, pos, "highLight", keepSourceImageName ? p.stem().string() : "");
+                    const std::string hdrMaskNoMidLightPath =
+                        getHdrMaskPath(outputPath, pos, "noMidLight", keepSourceImageName ? p.stem().string() : "");
+
+                    image::ImageWriteOptions maskWriteOptions;
+                    maskWriteOptions.exrCompressionMethod(image::EImageExrCompression::None);
+
+                    image::writeImage(hdrMaskLowLightPath, lowLightMask, maskWriteOptions);
+                    image::writeImage(hdrMaskHighLightPath, highLightMask, maskWriteOptions);
+                    image::writeImage(hdrMaskNoMidLightPath, noMidLightMask, maskWriteOptions);
+                }
             }
+
+            posStart = posEnd;
         }
+
+        // Next chunk claimed by this process
+        hasRange = chunkClaimer && chunkClaimer->claimNext(rangeStart, rangeSize);
+    }
+
+    system::MemoryBudget::get().logStats();
+
+    if (!succeeded)
+    {
+        return EXIT_FAILURE;
     }
 
     return EXIT_SUCCESS;
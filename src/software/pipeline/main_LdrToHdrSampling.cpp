@@ -333,20 +333,11 @@ int aliceVision_main(int argc, char** argv)
 
             // Store to file
             const std::string samplesFilepath = (fs::path(outputFolder) / (std::to_string(firstViewId) + "_samples.dat")).string();
-            std::ofstream fileSamples(samplesFilepath, std::ios::binary);
-            if (!fileSamples.is_open())
+            if (!hdr::writeSamples(samplesFilepath, out_samples))
             {
                 ALICEVISION_LOG_ERROR("Cannot write samples.");
                 return EXIT_FAILURE;
             }
-
-            const std::size_t size = out_samples.size();
-            fileSamples.write((const char *)&size, sizeof(size));
-
-            for(std::size_t i = 0; i < out_samples.size(); ++i)
-            {
-                fileSamples << out_samples[i];
-            }
         }
     }
 
@@ -8,7 +8,7 @@
 #include <aliceVision/sfmData/SfMData.hpp>
 #include <aliceVision/sfmDataIO/jsonIO.hpp>
 #include <aliceVision/sfmDataIO/viewIO.hpp>
-#include <aliceVision/sensorDB/parseDatabase.hpp>
+#include <aliceVision/sensorDB/SensorDatabase.hpp>
 #include <aliceVision/lensCorrectionProfile/lcp.hpp>
 #include <aliceVision/system/Logger.hpp>
 #include <aliceVision/system/main.hpp>
@@ -38,7 +38,7 @@
 // These constants define the current software version.
 // They must be updated when the command line is changed.
 #define ALICEVISION_SOFTWARE_VERSION_MAJOR 2
-#define ALICEVISION_SOFTWARE_VERSION_MINOR 0
+#define ALICEVISION_SOFTWARE_VERSION_MINOR 1
 
 using namespace aliceVision;
 using namespace aliceVision::sfmDataIO;
@@ -189,7 +189,7 @@ int aliceVision_main(int argc, char **argv)
   bool errorOnMissingColorProfile = true;
   image::ERawColorInterpretation rawColorInterpretation = image::ERawColorInterpretation::LibRawWhiteBalancing;
   bool lensCorrectionProfileSearchIgnoreCameraModel = true;
-
+  int maxConcurrentReads = 0;
 
   po::options_description requiredParams("Required parameters");
   requiredParams.add_options()
@@ -236,6 +236,9 @@ int aliceVision_main(int argc, char **argv)
       " * " + EViewIdMethod_enumToString(EViewIdMethod::FILENAME) + ": Generate viewId from file names using regex.") .c_str())
     ("viewIdRegex", po::value<std::string>(&viewIdRegex)->default_value(viewIdRegex),
       "Regex used to catch number used as viewId in filename.")
+    ("maxConcurrentReads", po::value<int>(&maxConcurrentReads)->default_value(maxConcurrentReads),
+      "Maximum number of image headers read concurrently (0 for automatic). "
+      "Increase it for images on a network storage, where the reads are latency-bound.")
     ("rawColorInterpretation", po::value<image::ERawColorInterpretation>(&rawColorInterpretation)->default_value(rawColorInterpretation),
       ("RAW color interpretation: " + image::ERawColorInterpretation_informations()).c_str())
     ("errorOnMissingColorProfile", po::value<bool>(&errorOnMissingColorProfile)->default_value(errorOnMissingColorProfile),
@@ -319,7 +322,7 @@ int aliceVision_main(int argc, char **argv)
   }
 
   // check sensor database
-  std::vector<sensorDB::Datasheet> sensorDatabase;
+  sensorDB::SensorDatabase sensorDatabase;
   if (sensorDatabasePath.empty())
   {
       const auto root = image::getAliceVisionRoot();
@@ -333,7 +336,7 @@ int aliceVision_main(int argc, char **argv)
       }
   }
 
-  if(!sensorDatabasePath.empty() && !sensorDB::parseDatabase(sensorDatabasePath, sensorDatabase))
+  if(!sensorDatabasePath.empty() && !sensorDatabase.load(sensorDatabasePath))
   {
       ALICEVISION_LOG_ERROR("Invalid input sensor database '" << sensorDatabasePath << "', please specify a valid file.");
       return EXIT_FAILURE;
@@ -366,7 +369,7 @@ int aliceVision_main(int argc, char **argv)
   if(imageFolder.empty())
   {
     // fill SfMData from the JSON file
-    loadJSON(sfmData, sfmFilePath, ESfMData(VIEWS|INTRINSICS|EXTRINSICS), true, viewIdMethod, viewIdRegex);
+    loadJSON(sfmData, sfmFilePath, ESfMData(VIEWS|INTRINSICS|EXTRINSICS), true, viewIdMethod, viewIdRegex, maxConcurrentReads);
   }
   else
   {
@@ -376,17 +379,16 @@ int aliceVision_main(int argc, char **argv)
 
     if(listFiles(imageFolder, image::getSupportedExtensions(), imagePaths))
     {
-      #pragma omp parallel for
-      for(int i = 0; i < imagePaths.size(); ++i)
-      {
-        auto view = std::make_shared<sfmData::View>(imagePaths.at(i).string());
-        updateIncompleteView(*view, viewIdMethod, viewIdRegex);
+      std::vector<std::shared_ptr<sfmData::View>> incompleteViews;
+      incompleteViews.reserve(imagePaths.size());
+      for(const fs::path& imagePath : imagePaths)
+        incompleteViews.push_back(std::make_shared<sfmData::View>(imagePath.string()));
 
-        #pragma omp critical
-        {
-            views.emplace(view->getViewId(), view);
-        }
-      }
+      // read the image headers concurrently, the views are added in the order of the files
+      updateIncompleteViews(incompleteViews, viewIdMethod, viewIdRegex, maxConcurrentReads);
+
+      for(const auto& view : incompleteViews)
+        views.emplace(view->getViewId(), view);
     }
     else {
       return EXIT_FAILURE;
@@ -584,7 +586,7 @@ int aliceVision_main(int argc, char **argv)
     else if (errCode == 3)
     {
       sensorDB::Datasheet datasheet;
-      sensorDB::getInfo(make, model, sensorDatabase, datasheet);
+      sensorDatabase.getInfo(make, model, datasheet);
       #pragma omp critical(unsureSensors)
       unsureSensors.emplace(std::make_pair(make, model), std::make_pair(view.getImage().getImagePath(), datasheet));
     }
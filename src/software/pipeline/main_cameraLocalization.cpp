@@ -10,6 +10,7 @@
 #if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_CCTAG)
 #include <aliceVision/localization/CCTagLocalizer.hpp>
 #endif
+#include <aliceVision/localization/LocalizationPipeline.hpp>
 #include <aliceVision/localization/LocalizationResult.hpp>
 #include <aliceVision/localization/optimization.hpp>
 #include <aliceVision/image/io.hpp>
@@ -46,7 +47,7 @@
 // These constants define the current software version.
 // They must be updated when the command line is changed.
 #define ALICEVISION_SOFTWARE_VERSION_MAJOR 1
-#define ALICEVISION_SOFTWARE_VERSION_MINOR 0
+#define ALICEVISION_SOFTWARE_VERSION_MINOR 2
 
 using namespace aliceVision;
 
@@ -102,6 +103,12 @@ int aliceVision_main(int argc, char** argv)
   /// enable/disable the robust matching (geometric validation) when matching query image
   /// and databases images
   bool robustMatching = true;
+  /// match first the images seen by the last localized frames, query the voctree only if it fails
+  bool useTracking = false;
+  /// number of last localized frames used for the tracking
+  std::size_t trackingNbPoses = 3;
+  /// minimum number of inliers to accept a tracked pose
+  std::size_t trackingMinInliers = 20;
   
   /// the Alembic export file
   std::string exportAlembicFile = "trackedcameras.abc";
@@ -125,6 +132,8 @@ int aliceVision_main(int argc, char** argv)
   
   /// whether to save visual debug info
   std::string visualDebug = "";
+  /// read the frames and extract their features while the previous frames are localized
+  bool pipelineFrames = false;
   int randomSeed = std::mt19937::default_seed;
 
 
@@ -161,6 +170,8 @@ int aliceVision_main(int argc, char** argv)
           "to 0 it lets the ACRansac select an optimal value.")
       ("randomSeed", po::value<int>(&randomSeed)->default_value(randomSeed),
           "This seed value will generate a sequence using a linear random generator. Set -1 to use a random seed.")
+      ("pipeline", po::value<bool>(&pipelineFrames)->default_value(pipelineFrames),
+          "Read the next frames and extract their features in other threads while the current frame is localized.")
           ;
   
 // voctree specific options
@@ -190,6 +201,13 @@ int aliceVision_main(int argc, char** argv)
       ("robustMatching", po::value<bool>(&robustMatching)->default_value(robustMatching), 
           "[voctree] Enable/Disable the robust matching between query and database images, "
           "all putative matches will be considered.")
+      ("tracking", po::value<bool>(&useTracking)->default_value(useTracking),
+          "[voctree] Match first the images seen by the last localized frames and "
+          "query the vocabulary tree only if the localization fails (AllResults algorithm only).")
+      ("trackingNbPoses", po::value<std::size_t>(&trackingNbPoses)->default_value(trackingNbPoses),
+          "[voctree] Number of last localized frames used to select the images to match when tracking.")
+      ("trackingMinInliers", po::value<std::size_t>(&trackingMinInliers)->default_value(trackingMinInliers),
+          "[voctree] Minimum number of inliers to accept the pose estimated when tracking.")
 // cctag specific options
 #if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_CCTAG)
       ("nNearestKeyFrames", po::value<size_t>(&nNearestKeyFrames)->default_value(nNearestKeyFrames), 
@@ -335,6 +353,9 @@ int aliceVision_main(int argc, char** argv)
     tmpParam->_matchingError = matchingErrorMax;
     tmpParam->_nbFrameBufferMatching = nbFrameBufferMatching;
     tmpParam->_useRobustMatching = robustMatching;
+    tmpParam->_useTracking = useTracking;
+    tmpParam->_trackingNbPoses = trackingNbPoses;
+    tmpParam->_trackingMinInliers = trackingMinInliers;
   }
   
   assert(localizer);
@@ -388,24 +409,14 @@ int aliceVision_main(int argc, char** argv)
   
   std::vector<localization::LocalizationResult> vec_localizationResults;
   
-  while(feed.readImage(imageGrey, queryIntrinsics, currentImgName, hasIntrinsics))
+  // save the result of a frame
+  const auto saveFrame = [&](const localization::LocalizationResult& localizationResult,
+                             const camera::Pinhole& intrinsics,
+                             const std::string& imgName,
+                             double localizationTime)
   {
-    ALICEVISION_COUT("******************************");
-    ALICEVISION_COUT("FRAME " << utils::toStringZeroPadded(frameCounter, 4));
-    ALICEVISION_COUT("******************************");
-    localization::LocalizationResult localizationResult;
-    auto detect_start = std::chrono::steady_clock::now();
-    localizer->localize(imageGrey, 
-                       param.get(),
-                       generator,
-                       hasIntrinsics /*useInputIntrinsics*/,
-                       queryIntrinsics,
-                       localizationResult,
-                       currentImgName);
-    auto detect_end = std::chrono::steady_clock::now();
-    auto detect_elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(detect_end - detect_start);
-    ALICEVISION_COUT("\nLocalization took  " << detect_elapsed.count() << " [ms]");
-    stats(detect_elapsed.count());
+    ALICEVISION_COUT("\nLocalization took  " << localizationTime << " [ms]");
+    stats(localizationTime);
     
     vec_localizationResults.emplace_back(localizationResult);
 
@@ -413,21 +424,62 @@ int aliceVision_main(int argc, char** argv)
     if(localizationResult.isValid())
     {
 #if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_ALEMBIC)
-      exporter.addCameraKeyframe(localizationResult.getPose(), &queryIntrinsics, currentImgName, frameCounter, frameCounter);
+      exporter.addCameraKeyframe(localizationResult.getPose(), &intrinsics, imgName, frameCounter, frameCounter);
 #endif
       
       goodFrameCounter++;
-      goodFrameList.push_back(currentImgName + " : " + std::to_string(localizationResult.getIndMatch3D2D().size()) );
+      goodFrameList.push_back(imgName + " : " + std::to_string(localizationResult.getIndMatch3D2D().size()) );
     }
     else
     {
       ALICEVISION_CERR("Unable to localize frame " << frameCounter);
 #if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_ALEMBIC)
-      exporter.jumpKeyframe(currentImgName);
+      exporter.jumpKeyframe(imgName);
 #endif
     }
     ++frameCounter;
-    feed.goToNextFrame();
+  };
+
+  if(pipelineFrames)
+  {
+    localization::LocalizationPipeline pipeline(*localizer, param.get());
+    const bool pipelineResult = pipeline.run(feed, generator, [&](localization::LocalizedFrame& frame)
+    {
+      ALICEVISION_COUT("******************************");
+      ALICEVISION_COUT("FRAME " << utils::toStringZeroPadded(frame.index, 4));
+      ALICEVISION_COUT("******************************");
+      ALICEVISION_COUT("Read: " << frame.readTime << " [ms], extraction: " << frame.extractionTime
+                       << " [ms], latency: " << frame.latency << " [ms]");
+      // only the localization is accounted, the reading and the extraction are overlapped with it
+      saveFrame(frame.result, frame.intrinsics, frame.name, frame.localizationTime);
+    });
+    if(!pipelineResult)
+    {
+      ALICEVISION_CERR("ERROR while localizing the frames of the feed!");
+      return EXIT_FAILURE;
+    }
+  }
+  else
+  {
+    while(feed.readImage(imageGrey, queryIntrinsics, currentImgName, hasIntrinsics))
+    {
+      ALICEVISION_COUT("******************************");
+      ALICEVISION_COUT("FRAME " << utils::toStringZeroPadded(frameCounter, 4));
+      ALICEVISION_COUT("******************************");
+      localization::LocalizationResult localizationResult;
+      auto detect_start = std::chrono::steady_clock::now();
+      localizer->localize(imageGrey, 
+                         param.get(),
+                         generator,
+                         hasIntrinsics /*useInputIntrinsics*/,
+                         queryIntrinsics,
+                         localizationResult,
+                         currentImgName);
+      auto detect_end = std::chrono::steady_clock::now();
+      auto detect_elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(detect_end - detect_start);
+      saveFrame(localizationResult, queryIntrinsics, currentImgName, detect_elapsed.count());
+      feed.goToNextFrame();
+    }
   }
 
   if(wantsJsonOutput)
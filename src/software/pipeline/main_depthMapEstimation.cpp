@@ -4,26 +4,39 @@
 // v. 2.0. If a copy of the MPL was not distributed with this file,
 // You can obtain one at https://mozilla.org/MPL/2.0/.
 
+#include <aliceVision/config.hpp>
 #include <aliceVision/system/Logger.hpp>
 #include <aliceVision/cmdline/cmdline.hpp>
 #include <aliceVision/system/main.hpp>
+#include <aliceVision/system/ChunkClaimer.hpp>
+#include <aliceVision/system/ResultCache.hpp>
 #include <aliceVision/sfmData/SfMData.hpp>
 #include <aliceVision/sfmDataIO/sfmDataIO.hpp>
 #include <aliceVision/mvsUtils/MultiViewParams.hpp>
-#include <aliceVision/depthMap/computeOnMultiGPUs.hpp>
-#include <aliceVision/depthMap/DepthMapEstimator.hpp>
+#include <aliceVision/mvsUtils/fileIO.hpp>
+#include <aliceVision/depthMap/ComputeEngine.hpp>
+#include <aliceVision/depthMap/DepthMapEstimatorCpu.hpp>
+#include <aliceVision/depthMap/DepthMapFilterParams.hpp>
 #include <aliceVision/depthMap/DepthMapParams.hpp>
 #include <aliceVision/depthMap/SgmParams.hpp>
 #include <aliceVision/depthMap/RefineParams.hpp>
 #include <aliceVision/gpu/gpu.hpp>
 
+#if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_CUDA)
+#include <aliceVision/depthMap/computeOnMultiGPUs.hpp>
+#include <aliceVision/depthMap/DepthMapEstimator.hpp>
+#include <aliceVision/depthMap/DepthMapFilter.hpp>
+#include <aliceVision/depthMap/DepthSimMapsStore.hpp>
+#include <aliceVision/depthMap/cuda/host/DeviceProfiler.hpp>
+#endif
+
 #include <boost/program_options.hpp>
 #include <boost/filesystem.hpp>
 
 // These constants define the current software version.
 // They must be updated when the command line is changed.
 #define ALICEVISION_SOFTWARE_VERSION_MAJOR 4
-#define ALICEVISION_SOFTWARE_VERSION_MINOR 0
+#define ALICEVISION_SOFTWARE_VERSION_MINOR 8
 
 using namespace aliceVision;
 
@@ -48,6 +61,91 @@ int computeDownscale(const mvsUtils::MultiViewParams& mp, int scale, int maxWidt
     return downscale;
 }
 
+/**
+ * @brief Keys of the inputs of the depth maps in the results cache.
+ *
+ * The depth map of a camera depends on the parameters, on the image and the projection matrix
+ * of the camera and of its T cameras, and on the landmarks observed by the camera (depth range).
+ */
+class DepthMapCacheKeys
+{
+  public:
+    DepthMapCacheKeys(const mvsUtils::MultiViewParams& mp, const std::string& parametersKey)
+      : _mp(mp),
+        _parametersKey(parametersKey),
+        _landmarksHash(mp.ncams)
+    {
+        std::map<IndexT, int> camPerViewId;
+        for(int c = 0; c < mp.ncams; ++c)
+            camPerViewId[mp.getViewId(c)] = c;
+
+        for(const auto& landmarkPair : mp.getInputSfMData().getLandmarks())
+        {
+            const sfmData::Landmark& landmark = landmarkPair.second;
+            for(const auto& observationPair : landmark.observations)
+            {
+                const auto it = camPerViewId.find(observationPair.first);
+                if(it == camPerViewId.end())
+                    continue;
+
+                system::ContentHash& hash = _landmarksHash.at(it->second);
+                for(int i = 0; i < 3; ++i)
+                    hash.addValue(landmark.X(i));
+                hash.addValue(observationPair.second.x(0));
+                hash.addValue(observationPair.second.x(1));
+            }
+        }
+    }
+
+    /**
+     * @return the key of the depth map of a camera, empty if an image cannot be read
+     */
+    std::string getKey(int rc, const StaticVector<int>& tcams)
+    {
+        system::ContentHash hash;
+        hash.addString(_parametersKey);
+
+        const std::string& rcKey = getCameraKey(rc);
+        if(rcKey.empty())
+            return std::string();
+        hash.addString(rcKey);
+
+        for(const int tc : tcams)
+        {
+            const std::string& tcKey = getCameraKey(tc);
+            if(tcKey.empty())
+                return std::string();
+            hash.addString(tcKey);
+        }
+        return hash.toString();
+    }
+
+  private:
+    /// the images are only read for the cameras of the processed ranges
+    const std::string& getCameraKey(int c)
+    {
+        const auto it = _camerasKey.find(c);
+        if(it != _camerasKey.end())
+            return it->second;
+
+        system::ContentHash hash = _landmarksHash.at(c);
+        std::string key;
+        if(hash.addFile(_mp.getImagePath(c)))
+        {
+            hash.addBytes(_mp.camArr.at(c).m, sizeof(_mp.camArr.at(c).m));
+            hash.addValue(_mp.getWidth(c));
+            hash.addValue(_mp.getHeight(c));
+            key = hash.toString();
+        }
+        return _camerasKey.emplace(c, key).first->second;
+    }
+
+    const mvsUtils::MultiViewParams& _mp;
+    const std::string _parametersKey;
+    std::vector<system::ContentHash> _landmarksHash;
+    std::map<int, std::string> _camerasKey;
+};
+
 int aliceVision_main(int argc, char* argv[])
 {
     ALICEVISION_COMMANDLINE_START
@@ -59,6 +157,10 @@ int aliceVision_main(int argc, char* argv[])
     // program range
     int rangeStart = -1;
     int rangeSize = -1;
+    std::string rangeClaimFolder;
+
+    // results cache shared by the pipeline runs
+    std::string resultsCacheFolder;
 
     // global image downscale factor
     int downscale = 2;
@@ -87,9 +189,21 @@ int aliceVision_main(int argc, char* argv[])
     bool exportIntermediateTopographicCutVolumes = false;
     bool exportIntermediateVolume9pCsv = false;
 
+    // combined depth map filtering
+    bool filterDepthMaps = false;
+    depthMap::DepthMapFilterParams filterParams;
+    int filterCamsPerBatch = 16;
+    bool filterComputeNormalMaps = false;
+
     // number of GPUs to use (0 means use all GPUs)
     int nbGPUs = 0;
 
+    // GPU time per stage and per camera JSON report (empty means no report)
+    std::string gpuTimingReportFilename;
+
+    // depth map compute engine
+    depthMap::EComputeEngine computeEngine = depthMap::EComputeEngine::AUTO;
+
     po::options_description requiredParams("Required parameters");
     requiredParams.add_options()
         ("input,i", po::value<std::string>(&sfmDataFilename)->required(),
@@ -105,6 +219,13 @@ int aliceVision_main(int argc, char* argv[])
             "Compute a sub-range of images from index rangeStart to rangeStart+rangeSize.")
         ("rangeSize", po::value<int>(&rangeSize)->default_value(rangeSize),
             "Compute a sub-range of N images (N=rangeSize).")
+        ("rangeClaimFolder", po::value<std::string>(&rangeClaimFolder)->default_value(rangeClaimFolder),
+            "Folder shared by the processes of the node (empty for each execution): instead of the rangeStart sub-range, "
+            "each process computes the next sub-ranges of rangeSize images not claimed by another process.")
+        ("resultsCacheFolder", po::value<std::string>(&resultsCacheFolder)->default_value(resultsCacheFolder),
+            "Folder of the results cache shared by the pipeline runs: the depth map of a camera is reused if the parameters, "
+            "the images and cameras of the camera and of its T cameras and its landmarks did not change. "
+            "Only the depth and similarity maps are cached. Not used with the combined depth map filtering. Disabled if empty.")
         ("downscale", po::value<int>(&downscale)->default_value(downscale),
             "Downscale the input images to compute the depth map. "
             "Full resolution (downscale=1) gives the best result, "
@@ -158,6 +279,13 @@ int aliceVision_main(int argc, char* argv[])
             "Semi Global Matching: Define axes for the filtering of the similarity volume.")
         ("sgmDepthListPerTile", po::value<bool>(&sgmParams.depthListPerTile)->default_value(sgmParams.depthListPerTile),
             "Semi Global Matching: Select the list of depth planes per tile or globally to the image.")
+        ("sgmAdaptiveDepths", po::value<bool>(&sgmParams.adaptiveDepths)->default_value(sgmParams.adaptiveDepths),
+            "Semi Global Matching: Adapt the number of depth planes of each camera to its depth range and pixel size, "
+            "sgmMaxDepths remains the upper bound.")
+        ("sgmUseCoarseToFine", po::value<bool>(&sgmParams.useCoarseToFine)->default_value(sgmParams.useCoarseToFine),
+            "Semi Global Matching: Run a coarse Semi Global Matching first, then only sweep a band of depths around the coarse result for each pixel.")
+        ("sgmCoarseToFineBandHalfSize", po::value<int>(&sgmParams.coarseToFineBandHalfSize)->default_value(sgmParams.coarseToFineBandHalfSize),
+            "Semi Global Matching: Number of depth planes swept on each side of the coarse depths range of a pixel (if sgmUseCoarseToFine).")
         ("sgmUseConsistentScale", po::value<bool>(&sgmParams.useConsistentScale)->default_value(sgmParams.useConsistentScale),
             "Semi Global Matching: Compare patch with consistent scale for similarity volume computation.")
         ("sgmUseCustomPatchPattern", po::value<bool>(&sgmParams.useCustomPatchPattern)->default_value(sgmParams.useCustomPatchPattern),
@@ -214,8 +342,34 @@ int aliceVision_main(int argc, char* argv[])
             "Export intermediate volumes 9 points from the SGM and Refine steps in CSV files.")
         ("exportTilePattern", po::value<bool>(&depthMapParams.exportTilePattern)->default_value(depthMapParams.exportTilePattern),
             "Export workflow tile pattern.")
+        ("filterDepthMaps", po::value<bool>(&filterDepthMaps)->default_value(filterDepthMaps),
+            "Filter the depth maps on the GPU as soon as the depth maps of their neighbour cameras are estimated. "
+            "Only the filtered depth maps are written in the output folder (requires the CUDA compute engine).")
+        ("filterMinNumOfConsistentCams", po::value<int>(&filterParams.minNumOfConsistentCams)->default_value(filterParams.minNumOfConsistentCams),
+            "Filtering: Minimal number of consistent cameras to consider the pixel.")
+        ("filterMinNumOfConsistentCamsWithLowSimilarity", po::value<int>(&filterParams.minNumOfConsistentCamsWithLowSimilarity)->default_value(filterParams.minNumOfConsistentCamsWithLowSimilarity),
+            "Filtering: Minimal number of consistent cameras to consider the pixel when the similarity is weak or ambiguous.")
+        ("filterPixToleranceFactor", po::value<float>(&filterParams.pixToleranceFactor)->default_value(filterParams.pixToleranceFactor),
+            "Filtering: Filtering tolerance size factor (in px).")
+        ("filterPixSizeBall", po::value<int>(&filterParams.pixSizeBall)->default_value(filterParams.pixSizeBall),
+            "Filtering: Filter ball size (in px).")
+        ("filterPixSizeBallWithLowSimilarity", po::value<int>(&filterParams.pixSizeBallWithLowSimilarity)->default_value(filterParams.pixSizeBallWithLowSimilarity),
+            "Filtering: Filter ball size (in px) when the similarity is weak or ambiguous.")
+        ("filterNNearestCams", po::value<int>(&filterParams.nNearestCams)->default_value(filterParams.nNearestCams),
+            "Filtering: Number of nearest cameras.")
+        ("filterCamsPerBatch", po::value<int>(&filterCamsPerBatch)->default_value(filterCamsPerBatch),
+            "Filtering: Number of cameras estimated between two filtering steps.")
+        ("filterComputeNormalMaps", po::value<bool>(&filterComputeNormalMaps)->default_value(filterComputeNormalMaps),
+            "Filtering: Compute the normal maps of the filtered depth maps on the GPU, from the depth maps in memory.")
         ("nbGPUs", po::value<int>(&nbGPUs)->default_value(nbGPUs),
-            "Number of GPUs to use (0 means use all GPUs).");
+            "Number of GPUs to use (0 means use all GPUs).")
+        ("gpuTimingReport", po::value<std::string>(&gpuTimingReportFilename)->default_value(gpuTimingReportFilename),
+            "Write the GPU time per stage and per camera in this JSON file (requires the CUDA compute engine).")
+        ("computeEngine", po::value<depthMap::EComputeEngine>(&computeEngine)->default_value(computeEngine),
+            "Depth map compute engine:\n"
+            "* auto: CUDA if a CUDA-enabled GPU is available, CPU otherwise\n"
+            "* cuda: CUDA-enabled GPU(s)\n"
+            "* cpu: multi-threaded CPU (no color optimization, no custom patch pattern)");
 
     CmdLine cmdline("Dense Reconstruction.\n"
                     "This program estimate a depth map for each input calibrated camera using Plane Sweeping, a multi-view stereo algorithm notable for its efficiency on modern graphics hardware (GPU).\n"
@@ -241,14 +395,45 @@ int aliceVision_main(int argc, char* argv[])
     refineParams.exportIntermediateTopographicCutVolumes = exportIntermediateTopographicCutVolumes;
     refineParams.exportIntermediateVolume9pCsv = exportIntermediateVolume9pCsv;
 
-    // print GPU Information
-    ALICEVISION_LOG_INFO(gpu::gpuInformationCUDA());
+    // select the compute engine
+    if(computeEngine != depthMap::EComputeEngine::CPU)
+    {
+      // print GPU Information
+      ALICEVISION_LOG_INFO(gpu::gpuInformationCUDA());
 
-    // check if the gpu suppport CUDA compute capability 2.0
-    if(!gpu::gpuSupportCUDA(2,0))
+      // check if the gpu suppport CUDA compute capability 2.0
+      if(!gpu::gpuSupportCUDA(2,0))
+      {
+        if(computeEngine == depthMap::EComputeEngine::CUDA)
+        {
+          ALICEVISION_LOG_ERROR("This program needs a CUDA-Enabled GPU (with at least compute capability 2.0) with the CUDA compute engine.");
+          return EXIT_FAILURE;
+        }
+        ALICEVISION_LOG_WARNING("No CUDA-Enabled GPU (with at least compute capability 2.0) available, use the CPU compute engine.");
+        computeEngine = depthMap::EComputeEngine::CPU;
+      }
+      else
+      {
+        computeEngine = depthMap::EComputeEngine::CUDA;
+      }
+    }
+
+    ALICEVISION_LOG_INFO("Depth map compute engine: " << computeEngine);
+
+    // check combined depth map filtering
+    if(filterDepthMaps)
     {
-      ALICEVISION_LOG_ERROR("This program needs a CUDA-Enabled GPU (with at least compute capability 2.0).");
-      return EXIT_FAILURE;
+      if(computeEngine != depthMap::EComputeEngine::CUDA)
+      {
+        ALICEVISION_LOG_ERROR("Depth map filtering requires the CUDA compute engine.");
+        return EXIT_FAILURE;
+      }
+
+      if(rangeSize != -1)
+      {
+        ALICEVISION_LOG_ERROR("Depth map filtering needs the depth maps of all the cameras, it cannot be used with a sub-range of cameras.");
+        return EXIT_FAILURE;
+      }
     }
 
     // check if the scale is correct
@@ -295,7 +480,8 @@ int aliceVision_main(int argc, char* argv[])
     }
 
     // MultiViewParams initialization
-    mvsUtils::MultiViewParams mp(sfmData, imagesFolder, outputFolder, "", false, downscale);
+    // note: with the combined depth map filtering, only the filtered depth maps are written in the output folder
+    mvsUtils::MultiViewParams mp(sfmData, imagesFolder, outputFolder, (filterDepthMaps ? outputFolder : ""), false, downscale);
 
     // set MultiViewParams min/max view angle
     mp.setMinViewAngle(minViewAngle);
@@ -399,36 +585,157 @@ int aliceVision_main(int argc, char* argv[])
       tileParams.padding = padding;
     }
 
-    // camera list
-    std::vector<int> cams;
-    cams.reserve(mp.ncams);
-
-    if(rangeSize == -1)
+    // results cache, the combined depth map filtering needs the depth maps of the T cameras in memory
+    const system::ResultCache resultsCache(filterDepthMaps ? std::string() : resultsCacheFolder);
+    std::unique_ptr<DepthMapCacheKeys> depthMapCacheKeys;
+    if(filterDepthMaps && !resultsCacheFolder.empty())
+      ALICEVISION_LOG_WARNING("The results cache is not used with the combined depth map filtering.");
+    if(resultsCache.isEnabled())
     {
-      for(int rc = 0; rc < mp.ncams; ++rc) // process all cameras
-        cams.push_back(rc);
+      // the options which do not change the depth maps are not part of the key
+      std::stringstream parametersKey;
+      parametersKey << "depthMapEstimation." << ALICEVISION_SOFTWARE_VERSION_MAJOR << "." << ALICEVISION_SOFTWARE_VERSION_MINOR << "."
+                    << computeEngine << "."
+                    << system::getCommandLineKey(argc, argv,
+                         {"input", "i", "imagesFolder", "output", "o", "rangeStart", "rangeSize", "rangeClaimFolder", "resultsCacheFolder",
+                          "exportIntermediateDepthSimMaps", "exportIntermediateNormalMaps", "exportIntermediateVolumes",
+                          "exportIntermediateCrossVolumes", "exportIntermediateTopographicCutVolumes", "exportIntermediateVolume9pCsv",
+                          "exportTilePattern", "nbGPUs", "gpuTimingReport", "verboseLevel", "v", "maxMemoryAvailable", "maxCoresAvailable"});
+      depthMapCacheKeys.reset(new DepthMapCacheKeys(mp, parametersKey.str()));
     }
-    else
+
+    // compute the static range, or each chunk claimed by this process
+    std::unique_ptr<system::ChunkClaimer> chunkClaimer;
+    if(!rangeClaimFolder.empty())
     {
-      if(rangeStart < 0)
+      if(rangeSize <= 0)
       {
-        ALICEVISION_LOG_ERROR("invalid subrange of cameras to process.");
+        ALICEVISION_LOG_ERROR("Range size should be positive to claim the chunks.");
         return EXIT_FAILURE;
       }
-      for(int rc = rangeStart; rc < std::min(rangeStart + rangeSize, mp.ncams); ++rc)
-        cams.push_back(rc);
+      chunkClaimer.reset(new system::ChunkClaimer(rangeClaimFolder, mp.ncams, rangeSize));
+    }
+
+    bool hasRange = chunkClaimer ? chunkClaimer->claimNext(rangeStart, rangeSize) : true;
+    while(hasRange)
+    {
+      // camera list
+      std::vector<int> cams;
+      cams.reserve(mp.ncams);
+
+      if(rangeSize == -1)
+      {
+        for(int rc = 0; rc < mp.ncams; ++rc) // process all cameras
+          cams.push_back(rc);
+      }
+      else
+      {
+        if(rangeStart < 0)
+        {
+          ALICEVISION_LOG_ERROR("invalid subrange of cameras to process.");
+          return EXIT_FAILURE;
+        }
+        for(int rc = rangeStart; rc < std::min(rangeStart + rangeSize, mp.ncams); ++rc)
+          cams.push_back(rc);
+        if(cams.empty())
+        {
+          ALICEVISION_LOG_INFO("No camera to process.");
+          return EXIT_SUCCESS;
+        }
+      }
+
+      // restore the depth maps of the cameras with unchanged inputs from the results cache
+      std::map<int, std::string> camsCacheKey;
+      if(resultsCache.isEnabled())
+      {
+        std::vector<int> camsToCompute;
+        for(const int rc : cams)
+        {
+          const std::string key = depthMapCacheKeys->getKey(rc, mp.findNearestCamsFromLandmarks(rc, depthMapParams.maxTCams));
+          const std::vector<std::string> filepaths = {mvsUtils::getFileNameFromIndex(mp, rc, mvsUtils::EFileType::depthMap),
+                                                      mvsUtils::getFileNameFromIndex(mp, rc, mvsUtils::EFileType::simMap)};
+          if(!key.empty() && resultsCache.restore(key, filepaths))
+            continue;
+          camsToCompute.push_back(rc);
+          if(!key.empty())
+            camsCacheKey[rc] = key;
+        }
+        ALICEVISION_LOG_INFO("Results cache: " << (cams.size() - camsToCompute.size()) << " / " << cams.size() << " depth maps restored.");
+        cams.swap(camsToCompute);
+      }
+
       if(cams.empty())
       {
-        ALICEVISION_LOG_INFO("No camera to process.");
-        return EXIT_SUCCESS;
+        hasRange = chunkClaimer && chunkClaimer->claimNext(rangeStart, rangeSize);
+        continue;
       }
-    }
 
-    // initialize depth map estimator
-    depthMap::DepthMapEstimator depthMapEstimator(mp, tileParams, depthMapParams, sgmParams, refineParams);
+#if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_CUDA)
+      if(computeEngine == depthMap::EComputeEngine::CUDA)
+      {
+        // time the GPU stages with CUDA events if a report is requested
+        depthMap::DeviceProfiler::getInstance().setEnabled(!gpuTimingReportFilename.empty());
+
+        // initialize depth map estimator
+        depthMap::DepthMapEstimator depthMapEstimator(mp, tileParams, depthMapParams, sgmParams, refineParams);
+
+        if(filterDepthMaps)
+        {
+          // depth/sim maps resolution
+          const int scale = depthMapParams.useRefine ? refineParams.scale : sgmParams.scale;
+          const int stepXY = depthMapParams.useRefine ? refineParams.stepXY : sgmParams.stepXY;
+
+          // depth/sim maps are kept in host memory between the estimation and the filtering
+          depthMap::DepthSimMapsStore depthSimMapsStore;
+
+          // initialize depth map filter
+          depthMap::DepthMapFilter depthMapFilter(mp, filterParams);
+
+          depthMapEstimator.setDepthSimMapsStore(&depthSimMapsStore);
+          depthMapFilter.setDepthSimMapsStore(&depthSimMapsStore, scale, stepXY);
+          depthMapFilter.setComputeNormalMaps(filterComputeNormalMaps);
+
+          // estimate and filter depth maps
+          depthMap::estimateAndFilterOnMultiGPUs(cams, depthMapEstimator, depthMapFilter, depthSimMapsStore, filterCamsPerBatch, nbGPUs);
+        }
+        else
+        {
+          // neighbour-coherent order: consecutive R cameras share most of their T cameras,
+          // their images are kept in the device cache between batches
+          std::map<int, std::vector<int>> tcamsPerCam;
+          for(const int rc : cams)
+            tcamsPerCam[rc] = depthMapEstimator.getTCams(rc).getData();
+
+          std::vector<int> orderedCams;
+          depthMap::getNeighbourCoherentOrder(cams, tcamsPerCam, orderedCams);
 
-    // estimate depth maps
-    depthMap::computeOnMultiGPUs(cams, depthMapEstimator, nbGPUs);
+          // estimate depth maps
+          depthMap::computeOnMultiGPUs(orderedCams, depthMapEstimator, nbGPUs);
+        }
+
+        // write the GPU timing report
+        if(!gpuTimingReportFilename.empty() && !depthMap::DeviceProfiler::getInstance().writeReport(gpuTimingReportFilename, mp))
+          return EXIT_FAILURE;
+      }
+      else
+#endif
+      {
+        // initialize CPU depth map estimator
+        depthMap::DepthMapEstimatorCpu depthMapEstimator(mp, tileParams, depthMapParams, sgmParams, refineParams);
+
+        // estimate depth maps
+        depthMapEstimator.compute(cams);
+      }
+
+      for(const auto& camCacheKey : camsCacheKey)
+      {
+        resultsCache.store(camCacheKey.second, {mvsUtils::getFileNameFromIndex(mp, camCacheKey.first, mvsUtils::EFileType::depthMap),
+                                                mvsUtils::getFileNameFromIndex(mp, camCacheKey.first, mvsUtils::EFileType::simMap)});
+      }
+
+      // next chunk claimed by this process
+      hasRange = chunkClaimer && chunkClaimer->claimNext(rangeStart, rangeSize);
+    }
 
     ALICEVISION_COMMANDLINE_END
 }
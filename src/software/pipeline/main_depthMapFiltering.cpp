@@ -16,6 +16,7 @@
 #include <aliceVision/system/Timer.hpp>
 
 #include <aliceVision/depthMap/computeOnMultiGPUs.hpp>
+#include <aliceVision/depthMap/DepthMapFilter.hpp>
 #include <aliceVision/depthMap/NormalMapEstimator.hpp>
 
 #include <boost/program_options.hpp>
@@ -24,7 +25,7 @@
 // These constants define the current software version.
 // They must be updated when the command line is changed.
 #define ALICEVISION_SOFTWARE_VERSION_MAJOR 2
-#define ALICEVISION_SOFTWARE_VERSION_MINOR 0
+#define ALICEVISION_SOFTWARE_VERSION_MINOR 1
 
 using namespace aliceVision;
 
@@ -53,6 +54,8 @@ int aliceVision_main(int argc, char* argv[])
     int pixSizeBallWithLowSimilarity = 0;
     int nNearestCams = 10;
     bool computeNormalMaps = false;
+    bool useGpu = false;
+    int nbGPUs = 0;
 
     po::options_description requiredParams("Required parameters");
     requiredParams.add_options()
@@ -86,7 +89,11 @@ int aliceVision_main(int argc, char* argv[])
         ("nNearestCams", po::value<int>(&nNearestCams)->default_value(nNearestCams),
             "Number of nearest cameras.")
         ("computeNormalMaps", po::value<bool>(&computeNormalMaps)->default_value(computeNormalMaps),
-            "Compute normal maps per depth map");
+            "Compute normal maps per depth map")
+        ("useGpu", po::value<bool>(&useGpu)->default_value(useGpu),
+            "Filter the depth maps on the GPU (requires a CUDA-Enabled GPU).")
+        ("nbGPUs", po::value<int>(&nbGPUs)->default_value(nbGPUs),
+            "Number of GPUs to use (0 means use all GPUs).");
 
     CmdLine cmdline("This program filters depth maps to remove values that are not consistent with other depth maps.\n"
                     "AliceVision depthMapFiltering");
@@ -137,17 +144,36 @@ int aliceVision_main(int argc, char* argv[])
 
     ALICEVISION_LOG_INFO("Filter depth maps.");
 
+    if(useGpu)
+    {
+        depthMap::DepthMapFilterParams filterParams;
+        filterParams.pixToleranceFactor = pixToleranceFactor;
+        filterParams.pixSizeBall = pixSizeBall;
+        filterParams.pixSizeBallWithLowSimilarity = pixSizeBallWithLowSimilarity;
+        filterParams.nNearestCams = nNearestCams;
+        filterParams.minNumOfConsistentCams = minNumOfConsistentCams;
+        filterParams.minNumOfConsistentCamsWithLowSimilarity = minNumOfConsistentCamsWithLowSimilarity;
+
+        // initialize depth map filter
+        depthMap::DepthMapFilter depthMapFilter(mp, filterParams);
+
+        // normal maps are computed from the filtered depth maps in device memory
+        depthMapFilter.setComputeNormalMaps(computeNormalMaps);
+
+        // filter depth maps
+        depthMap::computeOnMultiGPUs(cams, depthMapFilter, nbGPUs);
+    }
+    else
     {
         fuseCut::Fuser fs(mp);
         fs.filterGroups(cams, pixToleranceFactor, pixSizeBall, pixSizeBallWithLowSimilarity, nNearestCams);
         fs.filterDepthMaps(cams, minNumOfConsistentCams, minNumOfConsistentCamsWithLowSimilarity);
     }
 
-    if(computeNormalMaps)
+    // with the GPU filtering, the normal maps are already computed
+    if(computeNormalMaps && !useGpu)
     {
-        int nbGPUs = 0;
-
-        // initialize depth map estimator
+        // initialize normal map estimator
         depthMap::NormalMapEstimator normalMapEstimator(mp);
 
         // estimate normal maps
@@ -18,6 +18,7 @@
 // This algorithms groups the corners by lines and minimize a distance between corners and lines using distortion.
 
 
+#include <aliceVision/alicevision_omp.hpp>
 #include <aliceVision/cmdline/cmdline.hpp>
 #include <aliceVision/system/Logger.hpp>
 #include <aliceVision/system/main.hpp>
@@ -35,7 +36,10 @@
 #include <boost/property_tree/json_parser.hpp>
 #include <boost/math/constants/constants.hpp>
 
+#include <algorithm>
+#include <atomic>
 #include <fstream>
+#include <vector>
 
 // These constants define the current software version.
 // They must be updated when the command line is changed.
@@ -120,21 +124,14 @@ bool retrieveLines(std::vector<calibration::LineWithPoints>& lineWithPoints, con
 bool estimateDistortionMultiStep(std::shared_ptr<camera::Undistortion> undistortion,
                                  calibration::Statistics& statistics,
                                  std::vector<calibration::LineWithPoints>& lines,
-                                 std::vector<double> initialParams,
-                                 std::vector<std::vector<bool>> lockSteps)
+                                 const std::vector<double>& initialParams,
+                                 const std::vector<std::vector<bool>>& lockSteps,
+                                 int nbThreads)
 {
     undistortion->setParameters(initialParams);
 
-    for (std::size_t i = 0; i < lockSteps.size(); ++i)
-    {
-        if (!calibration::estimate(undistortion, statistics, lines, true, lockSteps[i]))
-        {
-            ALICEVISION_LOG_ERROR("Failed to calibrate at step " << i);
-            return false;
-        }
-    }
-
-    return true;
+    // the problem is built once, each step starts from the result of the previous one
+    return calibration::estimate(undistortion, statistics, lines, true, lockSteps, nbThreads);
 }
 
 int aliceVision_main(int argc, char* argv[]) 
@@ -176,11 +173,19 @@ int aliceVision_main(int argc, char* argv[])
         return EXIT_FAILURE;
     }
 
-    // Load the checkerboards
-    std::map < IndexT, calibration::CheckerDetector> boardsAllImages;
-    for (auto& pv : sfmData.getViews())
+    // Load the checkerboards and transform them to lines with points, in parallel over the views
+    std::vector<IndexT> viewIds;
+    for (const auto& pv : sfmData.getViews())
+    {
+        viewIds.push_back(pv.first);
+    }
+
+    std::vector<std::vector<calibration::LineWithPoints>> linesPerView(viewIds.size());
+
+    #pragma omp parallel for schedule(dynamic)
+    for (int i = 0; i < static_cast<int>(viewIds.size()); ++i)
     {
-        IndexT viewId = pv.first;
+        const IndexT viewId = viewIds[i];
 
         // Read the json file
         std::stringstream ss;
@@ -192,17 +197,40 @@ int aliceVision_main(int argc, char* argv[])
         buffer << inputfile.rdbuf();
         boost::json::value jv = boost::json::parse(buffer.str());
 
-        // Store the checkerboard
-        calibration::CheckerDetector detector(boost::json::value_to<calibration::CheckerDetector>(jv));
-        boardsAllImages[viewId] = detector;
+        const calibration::CheckerDetector detector(boost::json::value_to<calibration::CheckerDetector>(jv));
+
+        std::vector<calibration::LineWithPoints> linesWithPoints;
+        if (retrieveLines(linesWithPoints, detector))
+        {
+            linesPerView[i] = std::move(linesWithPoints);
+        }
     }
 
     // Retrieve camera model
     camera::EINTRINSIC cameraModel = camera::EINTRINSIC_stringToEnum(cameraModelName);
 
-    // Calibrate each intrinsic independently
+    // Calibrate each intrinsic independently, in parallel
+    // the threads left are used by the solver of each intrinsic
+    std::vector<std::pair<IndexT, std::shared_ptr<camera::IntrinsicBase>*>> intrinsics;
     for (auto& [intrinsicId, intrinsicPtr] : sfmData.getIntrinsics())
     {
+        intrinsics.emplace_back(intrinsicId, &intrinsicPtr);
+    }
+
+    const int nbSolverThreads = std::max(1, omp_get_max_threads() / std::max(1, static_cast<int>(intrinsics.size())));
+    std::atomic<bool> calibrationFailed{false};
+
+    #pragma omp parallel for schedule(dynamic)
+    for (int i = 0; i < static_cast<int>(intrinsics.size()); ++i)
+    {
+        if (calibrationFailed)
+        {
+            continue;
+        }
+
+        const IndexT intrinsicId = intrinsics[i].first;
+        std::shared_ptr<camera::IntrinsicBase>& intrinsicPtr = *intrinsics[i].second;
+
         // Convert to pinhole
         std::shared_ptr<camera::Pinhole> cameraIn
             = std::dynamic_pointer_cast<camera::Pinhole>(intrinsicPtr);
@@ -215,7 +243,8 @@ int aliceVision_main(int argc, char* argv[])
         if (!cameraIn || !cameraOut)
         {
             ALICEVISION_LOG_ERROR("Only work for pinhole cameras");
-            return EXIT_FAILURE;
+            calibrationFailed = true;
+            continue;
         }
 
         ALICEVISION_LOG_INFO("Processing Intrinsic " << intrinsicId);
@@ -238,24 +267,20 @@ int aliceVision_main(int argc, char* argv[])
         if (!undistortion)
         {
             ALICEVISION_LOG_ERROR("Only work for cameras that support undistortion");
-            return EXIT_FAILURE;
+            calibrationFailed = true;
+            continue;
         }
 
-        // Transform checkerboards to line With points
+        // Gather the lines with points of the views of the intrinsic
         std::vector<calibration::LineWithPoints> allLinesWithPoints;
-        for (auto& pv : sfmData.getViews())
+        for (std::size_t idView = 0; idView < viewIds.size(); ++idView)
         {
-            if (pv.second->getIntrinsicId() != intrinsicId)
-            {
-                continue;
-            }
-
-            std::vector<calibration::LineWithPoints> linesWithPoints;
-            if (!retrieveLines(linesWithPoints, boardsAllImages[pv.first]))
+            if (sfmData.getView(viewIds[idView]).getIntrinsicId() != intrinsicId)
             {
                 continue;
             }
 
+            const std::vector<calibration::LineWithPoints>& linesWithPoints = linesPerView[idView];
             allLinesWithPoints.insert(allLinesWithPoints.end(), linesWithPoints.begin(), linesWithPoints.end());
         }
 
@@ -277,21 +302,28 @@ int aliceVision_main(int argc, char* argv[])
         else
         {
             ALICEVISION_LOG_ERROR("Unsupported camera model for undistortion.");
-            return EXIT_FAILURE;
+            calibrationFailed = true;
+            continue;
         }
 
-        if (!estimateDistortionMultiStep(undistortion, statistics, allLinesWithPoints, initialParams, lockSteps))
+        if (!estimateDistortionMultiStep(undistortion, statistics, allLinesWithPoints, initialParams, lockSteps, nbSolverThreads))
         {
-            ALICEVISION_LOG_ERROR("Error estimating distortion");
-            return EXIT_FAILURE;
+            ALICEVISION_LOG_ERROR("Error estimating distortion of intrinsic " << intrinsicId);
+            calibrationFailed = true;
+            continue;
         }
 
         // Override input intrinsic with output camera
         intrinsicPtr = cameraOut;
 
-        ALICEVISION_LOG_INFO("Result quality of calibration: ");
-        ALICEVISION_LOG_INFO("Mean of error (stddev): " << statistics.mean << "(" << statistics.stddev << ")");
-        ALICEVISION_LOG_INFO("Median of error: " << statistics.median);
+        ALICEVISION_LOG_INFO("Result quality of calibration of intrinsic " << intrinsicId << ": " << std::endl
+                             << "\t- mean of error (stddev): " << statistics.mean << " (" << statistics.stddev << ")" << std::endl
+                             << "\t- median of error: " << statistics.median);
+    }
+
+    if (calibrationFailed)
+    {
+        return EXIT_FAILURE;
     }
 
     // Save sfmData to disk
@@ -16,6 +16,10 @@
 #define ALICEVISION_HAVE_GPU_FEATURES
 #include <aliceVision/gpu/gpu.hpp>
 #endif
+#include <aliceVision/system/ChunkClaimer.hpp>
+#include <aliceVision/system/MemoryBudget.hpp>
+#include <aliceVision/system/ResultCache.hpp>
+#include <aliceVision/system/TaskScheduler.hpp>
 #include <aliceVision/system/Timer.hpp>
 #include <aliceVision/system/Logger.hpp>
 #include <aliceVision/system/main.hpp>
@@ -32,7 +36,7 @@
 // These constants define the current software version.
 // They must be updated when the command line is changed.
 #define ALICEVISION_SOFTWARE_VERSION_MAJOR 1
-#define ALICEVISION_SOFTWARE_VERSION_MINOR 2
+#define ALICEVISION_SOFTWARE_VERSION_MINOR 5
 
 using namespace aliceVision;
 
@@ -54,8 +58,11 @@ int aliceVision_main(int argc, char **argv)
     feature::ConfigurationPreset featDescConfig;
     int rangeStart = -1;
     int rangeSize = 1;
+    std::string rangeClaimFolder;
+    std::string resultsCacheFolder;
     int maxThreads = 0;
     bool forceCpuExtraction = false;
+    int gpuBatchSize = 1;
     image::EImageColorSpace workingColorSpace = image::EImageColorSpace::SRGB;
     std::string maskExtension = "png";
     bool maskInvert = false;
@@ -88,6 +95,8 @@ int aliceVision_main(int argc, char **argv)
          ("Working color space: " + image::EImageColorSpace_informations()).c_str())
         ("forceCpuExtraction", po::value<bool>(&forceCpuExtraction)->default_value(forceCpuExtraction),
          "Use only CPU feature extraction methods.")
+        ("gpuBatchSize", po::value<int>(&gpuBatchSize)->default_value(gpuBatchSize),
+         "Number of images extracted together by the GPU feature extraction methods, to keep the GPU busy on small images.")
         ("masksFolder", po::value<std::string>(&masksFolder),
          "Masks folder.")
         ("maskExtension", po::value<std::string>(&maskExtension)->default_value(maskExtension),
@@ -98,6 +107,12 @@ int aliceVision_main(int argc, char **argv)
          "Range image index start.")
         ("rangeSize", po::value<int>(&rangeSize)->default_value(rangeSize),
          "Range size.")
+        ("rangeClaimFolder", po::value<std::string>(&rangeClaimFolder)->default_value(rangeClaimFolder),
+         "Folder shared by the processes of the node (empty for each execution): instead of the rangeStart chunk, "
+         "each process computes the next chunks of rangeSize views not claimed by another process.")
+        ("resultsCacheFolder", po::value<std::string>(&resultsCacheFolder)->default_value(resultsCacheFolder),
+         "Folder of the results cache shared by the pipeline runs: the features of a view are reused if its image, "
+         "its mask and the extraction parameters did not change. Disabled if empty.")
         ("maxThreads", po::value<int>(&maxThreads)->default_value(maxThreads),
          "Specifies the maximum number of threads to run simultaneously (0 for automatic mode).");
 
@@ -143,13 +158,31 @@ int aliceVision_main(int argc, char **argv)
     featureEngine::FeatureExtractor extractor(sfmData);
     extractor.setMasksFolder(masksFolder, maskExtension, maskInvert);
     extractor.setOutputFolder(outputFolder);
+    extractor.setGpuBatchSize(gpuBatchSize);
+
+    if(!resultsCacheFolder.empty())
+    {
+        // the options which do not change the features are not part of the key
+        const std::string parametersKey = system::getCommandLineKey(argc, argv,
+          {"input", "i", "output", "o", "masksFolder", "rangeStart", "rangeSize", "rangeClaimFolder", "resultsCacheFolder",
+           "gpuBatchSize", "maxThreads", "verboseLevel", "v", "maxMemoryAvailable", "maxCoresAvailable"});
+        extractor.setResultsCache(resultsCacheFolder, "featureExtraction." + std::to_string(ALICEVISION_SOFTWARE_VERSION_MAJOR) + "." +
+                                                        std::to_string(ALICEVISION_SOFTWARE_VERSION_MINOR) + "." + parametersKey);
+    }
 
     // set maxThreads
     HardwareContext hwc = cmdline.getHardwareContext();
     hwc.setUserCoresLimit(maxThreads);
+    system::TaskScheduler::get().setNbThreads(hwc.getMaxThreads());
+
+    if(!rangeClaimFolder.empty() && rangeSize <= 0)
+    {
+        ALICEVISION_LOG_ERROR("Range size should be positive to claim the chunks.");
+        return EXIT_FAILURE;
+    }
 
     // set extraction range
-    if(rangeStart != -1)
+    if(rangeStart != -1 && rangeClaimFolder.empty())
     {
         if(rangeStart < 0 || rangeSize < 0)
         {
@@ -191,8 +224,25 @@ int aliceVision_main(int argc, char **argv)
     {
         system::Timer timer;
 
-        extractor.process(hwc, workingColorSpace);
+        if(rangeClaimFolder.empty())
+        {
+            extractor.process(hwc, workingColorSpace);
+        }
+        else
+        {
+            // compute the chunks of views not claimed by another process
+            system::ChunkClaimer chunkClaimer(rangeClaimFolder, int(sfmData.getViews().size()), rangeSize);
+            int chunkRangeStart = 0;
+            int chunkRangeSize = 0;
+
+            while(chunkClaimer.claimNext(chunkRangeStart, chunkRangeSize))
+            {
+                extractor.setRange(chunkRangeStart, chunkRangeSize);
+                extractor.process(hwc, workingColorSpace);
+            }
+        }
 
+        system::MemoryBudget::get().logStats();
         ALICEVISION_LOG_INFO("Task done in (s): " + std::to_string(timer.elapsed()));
     }
     return EXIT_SUCCESS;
@@ -19,15 +19,12 @@
 #include <aliceVision/matchingImageCollection/ImageCollectionMatcher_generic.hpp>
 #include <aliceVision/matchingImageCollection/ImageCollectionMatcher_cascadeHashing.hpp>
 #include <aliceVision/matchingImageCollection/GeometricFilter.hpp>
-#include <aliceVision/matchingImageCollection/GeometricFilterMatrix_F_AC.hpp>
-#include <aliceVision/matchingImageCollection/GeometricFilterMatrix_E_AC.hpp>
-#include <aliceVision/matchingImageCollection/GeometricFilterMatrix_H_AC.hpp>
-#include <aliceVision/matchingImageCollection/GeometricFilterMatrix_HGrowing.hpp>
 #include <aliceVision/matchingImageCollection/GeometricFilterType.hpp>
 #include <aliceVision/matchingImageCollection/ImagePairListIO.hpp>
 #include <aliceVision/matching/pairwiseAdjacencyDisplay.hpp>
 #include <aliceVision/matching/io.hpp>
 #include <aliceVision/system/main.hpp>
+#include <aliceVision/system/ResultCache.hpp>
 #include <aliceVision/system/Timer.hpp>
 #include <aliceVision/cmdline/cmdline.hpp>
 #include <aliceVision/graph/graph.hpp>
@@ -43,7 +40,7 @@
 // These constants define the current software version.
 // They must be updated when the command line is changed.
 #define ALICEVISION_SOFTWARE_VERSION_MAJOR 2
-#define ALICEVISION_SOFTWARE_VERSION_MINOR 0
+#define ALICEVISION_SOFTWARE_VERSION_MINOR 7
 
 using namespace aliceVision;
 using namespace aliceVision::camera;
@@ -82,6 +79,63 @@ void getStatsMap(const PairwiseMatches& map)
 #endif
 }
 
+/**
+ * @brief Get the key of the inputs of a view in the results cache: its features and descriptors files,
+ *        its intrinsic and, if the matching uses the known poses, its pose.
+ * @return the key, empty if the features of the view cannot be found
+ */
+std::string getViewCacheKey(const SfMData& sfmData,
+                            IndexT viewId,
+                            const std::vector<std::string>& featuresFolders,
+                            const std::vector<feature::EImageDescriberType>& describerTypes,
+                            bool usePose)
+{
+  system::ContentHash hash;
+  const std::string basename = std::to_string(viewId);
+
+  for(const feature::EImageDescriberType describerType : describerTypes)
+  {
+    const std::string describerTypeName = feature::EImageDescriberType_enumToString(describerType);
+
+    // the last folder containing the files is used, as in sfm::loadRegions
+    std::string featPath;
+    std::string descPath;
+    for(const std::string& folder : featuresFolders)
+    {
+      const fs::path folderFeatPath = fs::path(folder) / (basename + "." + describerTypeName + ".feat");
+      const fs::path folderDescPath = fs::path(folder) / (basename + "." + describerTypeName + ".desc");
+      if(fs::exists(folderFeatPath) && fs::exists(folderDescPath))
+      {
+        featPath = folderFeatPath.string();
+        descPath = folderDescPath.string();
+      }
+    }
+    if(featPath.empty() || !hash.addFile(featPath) || !hash.addFile(descPath))
+      return std::string();
+  }
+
+  const View& view = sfmData.getView(viewId);
+  const camera::IntrinsicBase* intrinsic = sfmData.getIntrinsicPtr(view.getIntrinsicId());
+  hash.addValue(std::uint8_t(intrinsic != nullptr));
+  if(intrinsic != nullptr)
+  {
+    hash.addValue(int(intrinsic->getType()));
+    hash.addValue(intrinsic->w());
+    hash.addValue(intrinsic->h());
+    for(const double param : intrinsic->getParams())
+      hash.addValue(param);
+  }
+
+  if(usePose && sfmData.isPoseAndIntrinsicDefined(viewId))
+  {
+    const Mat4& pose = sfmData.getPose(view).getTransform().getHomogeneous();
+    for(int i = 0; i < pose.size(); ++i)
+      hash.addValue(pose(i));
+  }
+
+  return hash.toString();
+}
+
 /// Compute corresponding features between a series of views:
 /// - Load view images description (regions: features & descriptors)
 /// - Compute putative local feature matches (descriptors matching)
@@ -115,7 +169,12 @@ int aliceVision_main(int argc, char **argv)
   bool useGridSort = true;
   bool exportDebugFiles = false;
   bool matchFromKnownCameraPoses = false;
-  const std::string fileExtension = "txt";
+  bool memoryMappedDescriptors = false;
+  std::string cascadeHashingCacheFolder;
+  std::string kdTreeIndexCacheFolder;
+  std::string resultsCacheFolder;
+  std::vector<std::string> existingMatchesFolders;
+  std::string fileExtension = "txt";
   int randomSeed = std::mt19937::default_seed;
   double minRequired2DMotion = -1.0;
 
@@ -139,10 +198,14 @@ int aliceVision_main(int argc, char **argv)
     ("photometricMatchingMethod,p", po::value<std::string>(&nearestMatchingMethod)->default_value(nearestMatchingMethod),
       "For Scalar based regions descriptor:\n"
       "* BRUTE_FORCE_L2: L2 BruteForce matching\n"
+      "* BLOCKED_BRUTE_FORCE_L2: L2 BruteForce matching computing the distances by blocks of descriptors\n"
+      "(same matches as BRUTE_FORCE_L2, a lot faster)\n"
       "* ANN_L2: L2 Approximate Nearest Neighbor matching\n"
       "* CASCADE_HASHING_L2: L2 Cascade Hashing matching\n"
       "* FAST_CASCADE_HASHING_L2: L2 Cascade Hashing with precomputed hashed regions\n"
       "(faster than CASCADE_HASHING_L2 but use more memory)\n"
+      "* PRODUCT_QUANTIZATION_L2: L2 Approximate Nearest Neighbor matching on product quantized descriptors\n"
+      "with exact re-ranking of the candidates (16 bytes per database descriptor)\n"
       "For Binary based descriptor:\n"
       "* BRUTE_FORCE_HAMMING: BruteForce Hamming matching")
     ("geometricEstimator", po::value<robustEstimation::ERobustEstimator>(&geometricEstimator)->default_value(geometricEstimator),
@@ -166,6 +229,10 @@ int aliceVision_main(int argc, char **argv)
       "Make sure that the matching process is symmetric (same matches for I->J than fo J->I).")
     ("matchFilePerImage", po::value<bool>(&matchFilePerImage)->default_value(matchFilePerImage),
       "Save matches in a separate file per image.")
+    ("matchesFileFormat", po::value<std::string>(&fileExtension)->default_value(fileExtension),
+      "Matches file format:\n"
+      "* txt: text file format\n"
+      "* bin: compact binary file format with a per-pair index (faster to load)")
     ("distanceRatio", po::value<float>(&distRatio)->default_value(distRatio),
       "Distance ratio to discard non meaningful matches.")
     ("maxIteration", po::value<int>(&maxIteration)->default_value(maxIteration),
@@ -174,6 +241,23 @@ int aliceVision_main(int argc, char **argv)
       "Use matching grid sort.")
     ("minRequired2DMotion", po::value<double>(&minRequired2DMotion)->default_value(minRequired2DMotion),
       "A match is invalid if the 2d motion between the 2 points is less than a threshold (or -1 to disable this filter).")
+    ("memoryMappedDescriptors", po::value<bool>(&memoryMappedDescriptors)->default_value(memoryMappedDescriptors),
+      "Memory map the descriptors files instead of loading them in memory. "
+      "Pages are shared between matching processes on the same node and can be evicted by the OS.")
+    ("cascadeHashingCacheFolder", po::value<std::string>(&cascadeHashingCacheFolder)->default_value(cascadeHashingCacheFolder),
+      "Folder in which the hashed descriptions of FAST_CASCADE_HASHING_L2 are saved and reused by the next runs, "
+      "for instance the features folder to keep them next to the .desc files. "
+      "The hashes of an image are recomputed only if its descriptors change. Disabled if empty.")
+    ("kdTreeIndexCacheFolder", po::value<std::string>(&kdTreeIndexCacheFolder)->default_value(kdTreeIndexCacheFolder),
+      "Folder in which the kd-tree indexes of ANN_L2 are saved and reused by the next runs, "
+      "for instance the features folder to keep them next to the .desc files. "
+      "The index of an image is rebuilt only if its descriptors change. Disabled if empty.")
+    ("resultsCacheFolder", po::value<std::string>(&resultsCacheFolder)->default_value(resultsCacheFolder),
+      "Folder of the results cache shared by the pipeline runs: the matches of an image pair are reused if the features "
+      "and the intrinsics of its views and the matching parameters did not change. Disabled if empty.")
+    ("existingMatchesFolders", po::value<std::vector<std::string>>(&existingMatchesFolders)->multitoken(),
+      "Folder(s) containing the matches of a previous run, for an incremental matching: "
+      "the image pairs already matched are skipped and, without range, the existing matches are merged with the new ones in the output files.")
     ("exportDebugFiles", po::value<bool>(&exportDebugFiles)->default_value(exportDebugFiles),
       "Export debug files (svg, dot).")
     ("maxMatches", po::value<std::size_t>(&numMatchesToKeep)->default_value(numMatchesToKeep),
@@ -261,11 +345,141 @@ int aliceVision_main(int argc, char **argv)
     }
   }
 
+  // when a range is specified, generate a file prefix to reflect the current iteration (rangeStart/rangeSize)
+  // => with matchFilePerImage: avoids overwriting files if a view is present in several iterations
+  // => without matchFilePerImage: avoids overwriting the unique resulting file
+  const std::string filePrefix = rangeSize > 0 ? std::to_string(rangeStart/rangeSize) + "." : "";
+
+  // incremental matching: skip the image pairs already matched by a previous run
+  PairwiseMatches existingMatches;
+  if(!existingMatchesFolders.empty())
+  {
+    if(!matching::Load(existingMatches, std::set<IndexT>(), existingMatchesFolders, std::vector<feature::EImageDescriberType>()))
+      ALICEVISION_LOG_WARNING("No existing matches in the given folders.");
+
+    std::size_t nbExistingPairs = 0;
+    for(auto it = pairs.begin(); it != pairs.end();)
+    {
+      if(existingMatches.count(*it) || existingMatches.count(std::make_pair(it->second, it->first)))
+      {
+        it = pairs.erase(it);
+        ++nbExistingPairs;
+      }
+      else
+        ++it;
+    }
+    ALICEVISION_LOG_INFO("Incremental matching: " << nbExistingPairs << " image pairs already matched are skipped.");
+
+    // each range only exports its new matches, they are merged when the folders are loaded
+    if(rangeSize > 0)
+      existingMatches.clear();
+  }
+
+  // results cache: the image pairs with unchanged inputs reuse their cached matches,
+  // they are merged in the output files as the existing matches
+  const system::ResultCache resultsCache(resultsCacheFolder);
+  const fs::path resultsCacheTmpFolder = fs::temp_directory_path() / fs::unique_path();
+  std::map<Pair, std::string> pairsCacheKey;
+  if(resultsCache.isEnabled())
+  {
+    // the options which do not change the matches are not part of the key
+    const std::string parametersKey = "featureMatching." + std::to_string(ALICEVISION_SOFTWARE_VERSION_MAJOR) + "." +
+      std::to_string(ALICEVISION_SOFTWARE_VERSION_MINOR) + "." +
+      system::getCommandLineKey(argc, argv,
+        {"input", "i", "output", "o", "featuresFolders", "f", "imagePairsList", "l", "rangeStart", "rangeSize",
+         "existingMatchesFolders", "resultsCacheFolder", "cascadeHashingCacheFolder", "kdTreeIndexCacheFolder", "memoryMappedDescriptors",
+         "savePutativeMatches", "matchFilePerImage", "exportDebugFiles", "fileExtension",
+         "verboseLevel", "v", "maxMemoryAvailable", "maxCoresAvailable"});
+
+    std::vector<std::string> allFeaturesFolders = sfmData.getFeaturesFolders();
+    allFeaturesFolders.insert(allFeaturesFolders.end(), featuresFolders.begin(), featuresFolders.end());
+    const std::vector<feature::EImageDescriberType> cacheDescriberTypes = feature::EImageDescriberType_stringToEnums(describerTypesName);
+
+    std::set<IndexT> pairsViewsSet;
+    for(const auto& pair : pairs)
+    {
+      pairsViewsSet.insert(pair.first);
+      pairsViewsSet.insert(pair.second);
+    }
+    const std::vector<IndexT> pairsViews(pairsViewsSet.begin(), pairsViewsSet.end());
+    std::vector<std::string> viewsKey(pairsViews.size());
+
+    #pragma omp parallel for schedule(dynamic)
+    for(int i = 0; i < pairsViews.size(); ++i)
+      viewsKey[i] = getViewCacheKey(sfmData, pairsViews[i], allFeaturesFolders, cacheDescriberTypes, matchFromKnownCameraPoses);
+
+    fs::create_directories(resultsCacheTmpFolder);
+    const std::string cacheMatchesPath = (resultsCacheTmpFolder / "matches.txt").string();
+
+    std::size_t nbRestoredPairs = 0;
+    for(auto it = pairs.begin(); it != pairs.end();)
+    {
+      const std::string& viewKeyI = viewsKey[std::lower_bound(pairsViews.begin(), pairsViews.end(), it->first) - pairsViews.begin()];
+      const std::string& viewKeyJ = viewsKey[std::lower_bound(pairsViews.begin(), pairsViews.end(), it->second) - pairsViews.begin()];
+      if(viewKeyI.empty() || viewKeyJ.empty())
+      {
+        ++it;
+        continue;
+      }
+
+      const std::string key = system::ContentHash().addString(parametersKey).addString(viewKeyI).addString(viewKeyJ).toString();
+
+      // the cached matches may come from views with other ids
+      PairwiseMatches cachedMatches;
+      if(resultsCache.restore(key, {cacheMatchesPath}) && LoadMatchFile(cachedMatches, cacheMatchesPath))
+      {
+        if(!cachedMatches.empty())
+          existingMatches[*it] = cachedMatches.begin()->second;
+        it = pairs.erase(it);
+        ++nbRestoredPairs;
+      }
+      else
+      {
+        pairsCacheKey[*it] = key;
+        ++it;
+      }
+    }
+    fs::remove_all(resultsCacheTmpFolder);
+    ALICEVISION_LOG_INFO("Results cache: " << nbRestoredPairs << " image pairs restored.");
+  }
+
+  // store the matches of the computed image pairs in the results cache, without matches if they are filtered out
+  const auto storeInResultsCache = [&](const PairwiseMatches& newMatches)
+  {
+    if(pairsCacheKey.empty())
+      return;
+    fs::create_directories(resultsCacheTmpFolder);
+    for(const auto& pairKey : pairsCacheKey)
+    {
+      PairwiseMatches pairMatches;
+      const auto it = newMatches.find(pairKey.first);
+      if(it != newMatches.end())
+        pairMatches.insert(*it);
+      Save(pairMatches, resultsCacheTmpFolder.string(), "txt", false);
+      resultsCache.store(pairKey.second, {(resultsCacheTmpFolder / "matches.txt").string()});
+    }
+    fs::remove_all(resultsCacheTmpFolder);
+  };
+
+  // the output files contain the existing matches and the new ones, each file is replaced atomically
+  const auto saveMergedMatches = [&](PairwiseMatches& newMatches)
+  {
+    storeInResultsCache(newMatches);
+    newMatches.insert(existingMatches.begin(), existingMatches.end());
+    Save(newMatches, matchesFolder, fileExtension, matchFilePerImage, filePrefix);
+  };
+
   if(pairs.empty())
   {
     ALICEVISION_LOG_INFO("No image pair to match.");
+    if(!existingMatches.empty())
+    {
+      PairwiseMatches noMatches;
+      saveMergedMatches(noMatches);
+      return EXIT_SUCCESS;
+    }
     // if we only compute a selection of matches, we may have no match.
-    return rangeSize ? EXIT_SUCCESS : EXIT_FAILURE;
+    return rangeSize || !existingMatchesFolders.empty() ? EXIT_SUCCESS : EXIT_FAILURE;
   }
 
   ALICEVISION_LOG_INFO("Number of pairs: " << pairs.size());
@@ -281,7 +495,7 @@ int aliceVision_main(int argc, char **argv)
 
   // allocate the right Matcher according the Matching requested method
   EMatcherType collectionMatcherType = EMatcherType_stringToEnum(nearestMatchingMethod);
-  std::unique_ptr<IImageCollectionMatcher> imageCollectionMatcher = createImageCollectionMatcher(collectionMatcherType, distRatio, crossMatching);
+  std::unique_ptr<IImageCollectionMatcher> imageCollectionMatcher = createImageCollectionMatcher(collectionMatcherType, distRatio, crossMatching, cascadeHashingCacheFolder, kdTreeIndexCacheFolder);
 
   const std::vector<feature::EImageDescriberType> describerTypes = feature::EImageDescriberType_stringToEnums(describerTypesName);
 
@@ -291,7 +505,7 @@ int aliceVision_main(int argc, char **argv)
 
   // load the corresponding view regions
   RegionsPerView regionPerView;
-  if(!sfm::loadRegionsPerView(regionPerView, sfmData, featuresFolders, describerTypes, filter))
+  if(!sfm::loadRegionsPerView(regionPerView, sfmData, featuresFolders, describerTypes, filter, memoryMappedDescriptors))
   {
     ALICEVISION_LOG_ERROR("Invalid regions in '" + sfmDataFilename + "'");
     return EXIT_FAILURE;
@@ -340,13 +554,13 @@ int aliceVision_main(int argc, char **argv)
       {
         assert(descType != feature::EImageDescriberType::UNINITIALIZED);
         ALICEVISION_LOG_INFO(EImageDescriberType_enumToString(descType) + " Regions Matching");
+      }
 
-        // photometric matching of putative pairs
-        imageCollectionMatcher->Match(randomNumberGenerator, regionPerView, pairsPoseUnknown, descType, mapPutativesMatches);
+      // photometric matching of putative pairs, all the describer types are matched together
+      imageCollectionMatcher->Match(randomNumberGenerator, regionPerView, pairsPoseUnknown, describerTypes, mapPutativesMatches);
 
-        // TODO: DELI
-        // if(!guided_matching) regionPerView.clearDescriptors()
-      }
+      // TODO: DELI
+      // if(!guided_matching) regionPerView.clearDescriptors()
 
   }
 
@@ -355,8 +569,13 @@ int aliceVision_main(int argc, char **argv)
   if(mapPutativesMatches.empty())
   {
     ALICEVISION_LOG_INFO("No putative feature matches.");
+    if(!existingMatches.empty())
+    {
+      saveMergedMatches(mapPutativesMatches);
+      return EXIT_SUCCESS;
+    }
     // If we only compute a selection of matches, we may have no match.
-    return rangeSize ? EXIT_SUCCESS : EXIT_FAILURE;
+    return rangeSize || !existingMatchesFolders.empty() ? EXIT_SUCCESS : EXIT_FAILURE;
   }
 
   if(geometricFilterType == EGeometricFilterType::HOMOGRAPHY_GROWING)
@@ -374,11 +593,6 @@ int aliceVision_main(int argc, char **argv)
     }
   }
 
-  // when a range is specified, generate a file prefix to reflect the current iteration (rangeStart/rangeSize)
-  // => with matchFilePerImage: avoids overwriting files if a view is present in several iterations
-  // => without matchFilePerImage: avoids overwriting the unique resulting file
-  const std::string filePrefix = rangeSize > 0 ? std::to_string(rangeStart/rangeSize) + "." : "";
-
   ALICEVISION_LOG_INFO(std::to_string(mapPutativesMatches.size()) << " putative image pair matches");
 
   for(const auto& imageMatch: mapPutativesMatches)
@@ -432,75 +646,16 @@ int aliceVision_main(int argc, char **argv)
 
   ALICEVISION_LOG_INFO("Geometric filtering: using " << matchingImageCollection::EGeometricFilterType_enumToString(geometricFilterType));
 
-  switch(geometricFilterType)
-  {
-
-    case EGeometricFilterType::NO_FILTERING:
-      geometricMatches = mapPutativesMatches;
-    break;
-
-    case EGeometricFilterType::FUNDAMENTAL_MATRIX:
-    {
-      matchingImageCollection::robustModelEstimation(geometricMatches,
-        &sfmData,
-        regionPerView,
-        GeometricFilterMatrix_F_AC(geometricErrorMax, maxIteration, geometricEstimator),
-        mapPutativesMatches,
-        randomNumberGenerator,
-        guidedMatching);
-    }
-    break;
-
-  case EGeometricFilterType::FUNDAMENTAL_WITH_DISTORTION:
-  {
-    matchingImageCollection::robustModelEstimation(geometricMatches,
-      &sfmData,
-      regionPerView,
-      GeometricFilterMatrix_F_AC(geometricErrorMax, maxIteration, geometricEstimator, true),
-      mapPutativesMatches,
-      randomNumberGenerator,
-      guidedMatching);
-  }
-  break;
-
-    case EGeometricFilterType::ESSENTIAL_MATRIX:
-    {
-      matchingImageCollection::robustModelEstimation(geometricMatches,
-        &sfmData,
-        regionPerView,
-        GeometricFilterMatrix_E_AC(geometricErrorMax, maxIteration),
-        mapPutativesMatches,
-        randomNumberGenerator,
-        guidedMatching);
-
-      removePoorlyOverlappingImagePairs(geometricMatches, mapPutativesMatches, 0.3f, 50);
-    }
-    break;
-
-    case EGeometricFilterType::HOMOGRAPHY_MATRIX:
-    {
-      const bool onlyGuidedMatching = true;
-      matchingImageCollection::robustModelEstimation(geometricMatches,
-        &sfmData,
-        regionPerView,
-        GeometricFilterMatrix_H_AC(geometricErrorMax, maxIteration),
-        mapPutativesMatches, randomNumberGenerator, guidedMatching,
-        onlyGuidedMatching ? -1.0 : 0.6);
-    }
-    break;
-
-    case EGeometricFilterType::HOMOGRAPHY_GROWING:
-    {
-      matchingImageCollection::robustModelEstimation(geometricMatches,
-        &sfmData,
-        regionPerView,
-        GeometricFilterMatrix_HGrowing(geometricErrorMax, maxIteration),
-        mapPutativesMatches,
-        randomNumberGenerator,
-        guidedMatching);
-    }
-    break;
-  }
+  matchingImageCollection::geometricFiltering(geometricMatches,
+                                              &sfmData,
+                                              regionPerView,
+                                              geometricFilterType,
+                                              geometricErrorMax,
+                                              maxIteration,
+                                              geometricEstimator,
+                                              mapPutativesMatches,
+                                              randomNumberGenerator,
+                                              guidedMatching);
 
   ALICEVISION_LOG_INFO(std::to_string(geometricMatches.size()) + " geometric image pair matches:");
   for(const auto& matchGeo: geometricMatches)
@@ -524,7 +679,7 @@ int aliceVision_main(int argc, char **argv)
 
   // export geometric filtered matches
   ALICEVISION_LOG_INFO("Save geometric matches.");
-  Save(finalMatches, matchesFolder, fileExtension, matchFilePerImage, filePrefix);
+  saveMergedMatches(finalMatches);
   ALICEVISION_LOG_INFO("Task done in (s): " + std::to_string(timer.elapsed()));
 
   // d. Export some statistics
@@ -9,6 +9,7 @@
 #include <aliceVision/sfmDataIO/sfmDataIO.hpp>
 #include <aliceVision/sfm/pipeline/regionsIO.hpp>
 #include <aliceVision/feature/imageDescriberCommon.hpp>
+#include <aliceVision/matching/viewGraphSparsification.hpp>
 #include <aliceVision/sfm/pipeline/global/ReconstructionEngine_globalSfM.hpp>
 #include <aliceVision/system/Timer.hpp>
 #include <aliceVision/system/Logger.hpp>
@@ -23,7 +24,7 @@
 // These constants define the current software version.
 // They must be updated when the command line is changed.
 #define ALICEVISION_SOFTWARE_VERSION_MAJOR 1
-#define ALICEVISION_SOFTWARE_VERSION_MINOR 0
+#define ALICEVISION_SOFTWARE_VERSION_MINOR 3
 
 using namespace aliceVision;
 
@@ -46,6 +47,11 @@ int aliceVision_main(int argc, char **argv)
   sfm::ERotationAveragingMethod rotationAveragingMethod = sfm::ROTATION_AVERAGING_L2;
   sfm::ETranslationAveragingMethod translationAveragingMethod = sfm::TRANSLATION_AVERAGING_SOFTL1;
   bool lockAllIntrinsics = false;
+  sfm::EBundleAdjustmentSolver bundleAdjustmentSolver = sfm::EBundleAdjustmentSolver::DENSE_SCHUR;
+  bool bundleAdjustmentMixedPrecision = false;
+  bool bundleAdjustmentUseGpu = false;
+  std::size_t bundleAdjustmentMaxPosesPerSubmap = 0;
+  std::size_t viewGraphNeighbours = 0;
   int randomSeed = std::mt19937::default_seed;
 
   po::options_description requiredParams("Required parameters");
@@ -77,6 +83,23 @@ int aliceVision_main(int argc, char **argv)
       "* 3: L1 soft minimization")
     ("lockAllIntrinsics", po::value<bool>(&lockAllIntrinsics)->default_value(lockAllIntrinsics),
       "Force lock of all camera intrinsic parameters, so they will not be refined during Bundle Adjustment.")
+    ("bundleAdjustmentSolver", po::value<sfm::EBundleAdjustmentSolver>(&bundleAdjustmentSolver)->default_value(bundleAdjustmentSolver),
+      "Linear solver of the bundle adjustment reduced camera system:\n"
+      "* auto: dense for small problems, sparse for large ones\n"
+      "* denseSchur: dense factorization\n"
+      "* sparseSchur: sparse factorization\n"
+      "* iterativeSchur: preconditioned conjugate gradient, for very large scenes")
+    ("bundleAdjustmentMixedPrecision", po::value<bool>(&bundleAdjustmentMixedPrecision)->default_value(bundleAdjustmentMixedPrecision),
+      "Solve the bundle adjustment linear systems in single precision with double precision refinement.")
+    ("bundleAdjustmentUseGpu", po::value<bool>(&bundleAdjustmentUseGpu)->default_value(bundleAdjustmentUseGpu),
+      "Factorize the dense reduced camera system on the GPU (requires Ceres built with CUDA).")
+    ("bundleAdjustmentMaxPosesPerSubmap", po::value<std::size_t>(&bundleAdjustmentMaxPosesPerSubmap)->default_value(bundleAdjustmentMaxPosesPerSubmap),
+      "Partition the bundle adjustment of the scenes with more poses in overlapping submaps of this size, "
+      "adjusted in parallel and merged through their separator cameras. 0 to disable.")
+    ("viewGraphNeighbours", po::value<std::size_t>(&viewGraphNeighbours)->default_value(viewGraphNeighbours),
+      "Sparsify the view graph before the SfM: keep a maximum spanning tree of the image pairs (weighted by their number of matches) "
+      "and the N best pairs of each image. The matches of the other pairs stay in the matches folders for the retriangulation "
+      "of the final structure (computeStructureFromKnownPoses). 0 to use all the pairs.")
     ("randomSeed", po::value<int>(&randomSeed)->default_value(randomSeed),
       "This seed value will generate a sequence using a linear random generator. Set -1 to use a random seed.")
     ;
@@ -147,6 +170,7 @@ int aliceVision_main(int argc, char **argv)
     ALICEVISION_LOG_ERROR("Unable to load matches files from: " << matchesFolders);
     return EXIT_FAILURE;
   }
+  matching::sparsifyViewGraph(pairwiseMatches, viewGraphNeighbours);
 
   if(extraInfoFolder.empty())
     extraInfoFolder = fs::path(outSfMDataFilepath).parent_path().string();
@@ -169,6 +193,10 @@ int aliceVision_main(int argc, char **argv)
 
   // configure reconstruction parameters
   sfmEngine.setLockAllIntrinsics(lockAllIntrinsics); // TODO: rename param
+  sfmEngine.setBundleAdjustmentSolver(bundleAdjustmentSolver);
+  sfmEngine.setBundleAdjustmentMixedPrecision(bundleAdjustmentMixedPrecision);
+  sfmEngine.setBundleAdjustmentUseGpu(bundleAdjustmentUseGpu);
+  sfmEngine.setBundleAdjustmentMaxPosesPerSubmap(bundleAdjustmentMaxPosesPerSubmap);
 
   // configure motion averaging method
   sfmEngine.SetRotationAveragingMethod(sfm::ERotationAveragingMethod(rotationAveragingMethod));
@@ -20,6 +20,8 @@
 #include <boost/filesystem.hpp>
 #include <boost/algorithm/string/case_conv.hpp> 
 
+#include <atomic>
+
 // These constants define the current software version.
 // They must be updated when the command line is changed.
 #define ALICEVISION_SOFTWARE_VERSION_MAJOR 1
@@ -261,9 +263,15 @@ int main(int argc, char **argv)
 
     bool useDepthMap = !depthMapExp.empty() || !depthMapFolder.empty();
 
-    // #pragma omp parallel for
+    // the masks are independent, the views are processed in parallel
+    std::atomic<bool> hasError(false);
+
+    #pragma omp parallel for schedule(dynamic)
     for(int i = 0; i < size; ++i)
     {
+        if(hasError)
+            continue;
+
         const auto& item = std::next(viewPairItBegin, rangeStart + i);
         const IndexT& index = item->first;
         const sfmData::View& view = *item->second;
@@ -329,53 +337,64 @@ int main(int argc, char **argv)
             }
         }
 
-        const std::string p = useDepthMap ? depthMapPath : imgPath;
-        image::Image<unsigned char> result;
-        process(result, p);
-
-        if(invert)
-        {
-            imageMasking::postprocess_invert(result);
-        }
-        if(growRadius > 0)
+        try
         {
-            imageMasking::postprocess_dilate(result, growRadius);
-        }
-        if(shrinkRadius > 0)
-        {
-            imageMasking::postprocess_erode(result, shrinkRadius);
-        }
+            const std::string p = useDepthMap ? depthMapPath : imgPath;
+            image::Image<unsigned char> result;
+            process(result, p);
 
-        if(useDepthMap)
-        {
-            bool viewHorizontal = view.getImage().getWidth() > view.getImage().getHeight();
-            bool depthMapHorizontal = result.Width() > result.Height();
-            if(viewHorizontal != depthMapHorizontal)
+            if(invert)
+            {
+                imageMasking::postprocess_invert(result);
+            }
+            if(growRadius > 0)
             {
-                ALICEVISION_LOG_ERROR("Image " << imgPath << " : " << view.getImage().getWidth() << "x" << view.getImage().getHeight());
-                ALICEVISION_LOG_ERROR("Depth Map " << depthMapPath << " : " << result.Width() << "x" << result.Height());
-                throw std::runtime_error("Depth map orientation is not aligned with source image.");
+                imageMasking::postprocess_dilate(result, growRadius);
             }
-            if(view.getImage().getWidth() != result.Width())
+            if(shrinkRadius > 0)
             {
-                ALICEVISION_LOG_DEBUG("Rescale depth map \"" << imgPath << "\" from: " << result.Width() << "x" << result.Height() << ", to: " << view.getImage().getWidth() << "x" << view.getImage().getHeight());
+                imageMasking::postprocess_erode(result, shrinkRadius);
+            }
+
+            if(useDepthMap)
+            {
+                bool viewHorizontal = view.getImage().getWidth() > view.getImage().getHeight();
+                bool depthMapHorizontal = result.Width() > result.Height();
+                if(viewHorizontal != depthMapHorizontal)
+                {
+                    ALICEVISION_LOG_ERROR("Image " << imgPath << " : " << view.getImage().getWidth() << "x" << view.getImage().getHeight());
+                    ALICEVISION_LOG_ERROR("Depth Map " << depthMapPath << " : " << result.Width() << "x" << result.Height());
+                    throw std::runtime_error("Depth map orientation is not aligned with source image.");
+                }
+                if(view.getImage().getWidth() != result.Width())
+                {
+                    ALICEVISION_LOG_DEBUG("Rescale depth map \"" << imgPath << "\" from: " << result.Width() << "x" << result.Height() << ", to: " << view.getImage().getWidth() << "x" << view.getImage().getHeight());
 
-                image::Image<unsigned char> rescaled(view.getImage().getWidth(), view.getImage().getHeight());
+                    image::Image<unsigned char> rescaled(view.getImage().getWidth(), view.getImage().getHeight());
 
-                const oiio::ImageBuf inBuf(oiio::ImageSpec(result.Width(), result.Height(), 1, oiio::TypeDesc::UINT8), result.data());
-                oiio::ImageBuf outBuf(oiio::ImageSpec(rescaled.Width(), rescaled.Height(), 1, oiio::TypeDesc::UINT8), rescaled.data());
+                    const oiio::ImageBuf inBuf(oiio::ImageSpec(result.Width(), result.Height(), 1, oiio::TypeDesc::UINT8), result.data());
+                    oiio::ImageBuf outBuf(oiio::ImageSpec(rescaled.Width(), rescaled.Height(), 1, oiio::TypeDesc::UINT8), rescaled.data());
 
-                oiio::ImageBufAlgo::resize(outBuf, inBuf);
+                    oiio::ImageBufAlgo::resize(outBuf, inBuf);
 
-                result.swap(rescaled);
+                    result.swap(rescaled);
+                }
             }
+            const auto resultFilename = fs::path(std::to_string(index)).replace_extension("png");
+            const std::string resultPath = (fs::path(outputFilePath) / resultFilename).string();
+            image::writeImage(resultPath, result,
+                              image::ImageWriteOptions().toColorSpace(image::EImageColorSpace::LINEAR));
+        }
+        catch(const std::exception& e)
+        {
+            ALICEVISION_LOG_ERROR("Failed to compute the mask of the view '" << index << "': " << e.what());
+            hasError = true;
         }
-        const auto resultFilename = fs::path(std::to_string(index)).replace_extension("png");
-        const std::string resultPath = (fs::path(outputFilePath) / resultFilename).string();
-        image::writeImage(resultPath, result,
-                          image::ImageWriteOptions().toColorSpace(image::EImageColorSpace::LINEAR));
     }
 
+    if(hasError)
+        return EXIT_FAILURE;
+
     ALICEVISION_LOG_INFO("Task done in (s): " + std::to_string(timer.elapsed()));
     return EXIT_SUCCESS;
 }
@@ -7,6 +7,7 @@
 #include <aliceVision/sfmData/SfMData.hpp>
 #include <aliceVision/sfmDataIO/sfmDataIO.hpp>
 #include <aliceVision/matchingImageCollection/ImagePairListIO.hpp>
+#include <aliceVision/matchingImageCollection/pairBuilder.hpp>
 #include <aliceVision/imageMatching/ImageMatching.hpp>
 #include <aliceVision/voctree/descriptorLoader.hpp>
 #include <aliceVision/sfm/FrustumFilter.hpp>
@@ -30,7 +31,7 @@
 // These constants define the current software version.
 // They must be updated when the command line is changed.
 #define ALICEVISION_SOFTWARE_VERSION_MAJOR 1
-#define ALICEVISION_SOFTWARE_VERSION_MINOR 0
+#define ALICEVISION_SOFTWARE_VERSION_MINOR 3
 
 using namespace aliceVision;
 using namespace aliceVision::voctree;
@@ -65,6 +66,12 @@ int aliceVision_main(int argc, char** argv)
   std::string weightsFilepath;
   /// flag for the optional weights file
   bool withWeights = false;
+  /// the pair list of a previous run, for an incremental matching
+  std::string existingPairsFile;
+  /// the folder of the saved sparse histograms
+  std::string histogramsFolder;
+  /// the parameters of the spatial matching
+  SpatialMatchingParams spatialParams;
 
 
   // multiple SfM parameters
@@ -94,7 +101,9 @@ int aliceVision_main(int argc, char** argv)
       " * SequentialAndVocabularyTree: combine both previous approaches\n"
       " * Exhaustive: all images combinations\n"
       " * Frustum: images with camera frustum intersection (only for cameras with known poses)\n"
-      " * FrustumOrVocTree: frustum intersection if cameras with known poses else use VocTree.\n")
+      " * FrustumOrVocTree: frustum intersection if cameras with known poses else use VocTree.\n"
+      " * Spatial: nearest cameras from the known poses or else from the GPS positions\n"
+      " * SpatialVocabularyTree: VocabularyTree pairs restricted to the Spatial pairs.\n")
     ("minNbImages", po::value<std::size_t>(&minNbImages)->default_value(minNbImages),
       "Minimal number of images to use the vocabulary tree. If we have less images than this threshold, we will compute all matching combinations.")
     ("maxDescriptors", po::value<std::size_t>(&nbMaxDescriptors)->default_value(nbMaxDescriptors),
@@ -103,13 +112,24 @@ int aliceVision_main(int argc, char** argv)
       "The number of matches to retrieve for each image (If 0 it will "
       "retrieve all the matches).")
     ("nbNeighbors", po::value<std::size_t>(&numImageQuerySequential)->default_value(numImageQuerySequential),
-      "The number of neighbors to retrieve for each image (If 0 it will "
+      "The number of neighbors to retrieve for each image in Sequential and Spatial modes (If 0 it will "
       "retrieve all the neighbors).")
+    ("spatialMaxDistance", po::value<double>(&spatialParams.maxDistance)->default_value(spatialParams.maxDistance),
+      "Maximum distance between the cameras of an image pair in Spatial modes, in the unit of the poses or in meters "
+      "for the GPS positions (If 0 there is no limit).")
+    ("spatialMaxAngle", po::value<double>(&spatialParams.maxAngle)->default_value(spatialParams.maxAngle),
+      "Maximum angle in degrees between the viewing directions of the cameras of an image pair in Spatial modes, "
+      "only used with known poses.")
     ("tree,t", po::value<std::string>(&treeFilepath)->default_value(treeFilepath),
       "Input file path of the vocabulary tree. This file can be generated by 'createVoctree'. "
       "This software is intended to be used with a generic, pre-trained vocabulary tree.")
     ("weights,w", po::value<std::string>(&weightsFilepath)->default_value(weightsFilepath),
-      "Input name for the vocabulary tree weight file, if not provided all voctree leaves will have the same weight.");
+      "Input name for the vocabulary tree weight file, if not provided all voctree leaves will have the same weight.")
+    ("existingPairsList", po::value<std::string>(&existingPairsFile)->default_value(existingPairsFile),
+      "Pair list of a previous run, for an incremental matching: only the pairs involving views missing from this list are exported.")
+    ("histogramsFolder", po::value<std::string>(&histogramsFolder)->default_value(histogramsFolder),
+      "Folder where the vocabulary tree histograms of the views are saved (<viewId>.<describerType>.bow) and reused by the next runs "
+      "with the same tree and maxDescriptors, instead of quantizing the descriptors again.");
 
   po::options_description multiSfMParams("Multiple SfM");
   multiSfMParams.add_options()
@@ -207,7 +227,7 @@ int aliceVision_main(int argc, char** argv)
     {
       ALICEVISION_LOG_INFO("Use VOCABULARYTREE matching.");
       conditionVocTree(treeFilepath, withWeights, weightsFilepath, matchingMode,featuresFolders, sfmDataA, nbMaxDescriptors, sfmDataFilenameA, sfmDataB,
-                       sfmDataFilenameB, useMultiSfM, descriptorsFilesA,  numImageQuery, selectedPairs);
+                       sfmDataFilenameB, useMultiSfM, descriptorsFilesA,  numImageQuery, selectedPairs, histogramsFolder);
       break;
     }
     case EImageMatchingMethod::SEQUENTIAL:
@@ -221,7 +241,7 @@ int aliceVision_main(int argc, char** argv)
       ALICEVISION_LOG_INFO("Use SEQUENTIAL and VOCABULARYTREE matching.");
       generateSequentialMatches(sfmDataA, numImageQuerySequential, selectedPairs);
       conditionVocTree(treeFilepath, withWeights, weightsFilepath, matchingMode,featuresFolders, sfmDataA, nbMaxDescriptors, sfmDataFilenameA, sfmDataB,
-                       sfmDataFilenameB, useMultiSfM, descriptorsFilesA,  numImageQuery, selectedPairs);
+                       sfmDataFilenameB, useMultiSfM, descriptorsFilesA,  numImageQuery, selectedPairs, histogramsFolder);
       break;
     }
     case EImageMatchingMethod::FRUSTUM:
@@ -240,6 +260,31 @@ int aliceVision_main(int argc, char** argv)
       }
       break;
     }
+    case EImageMatchingMethod::SPATIAL:
+    {
+      ALICEVISION_LOG_INFO("Use SPATIAL matching.");
+      spatialParams.nbNeighbors = numImageQuerySequential;
+      if(!generateSpatialMatches(sfmDataA, spatialParams, selectedPairs))
+        return EXIT_FAILURE;
+      break;
+    }
+    case EImageMatchingMethod::SPATIAL_VOCABULARYTREE:
+    {
+      ALICEVISION_LOG_INFO("Use VOCABULARYTREE matching restricted to SPATIAL neighbors.");
+      if(useMultiSfM)
+      {
+        ALICEVISION_LOG_ERROR("SPATIAL_VOCABULARYTREE matching is not available with multiple SfMData.");
+        return EXIT_FAILURE;
+      }
+      OrderedPairList spatialPairs;
+      spatialParams.nbNeighbors = numImageQuerySequential;
+      if(!generateSpatialMatches(sfmDataA, spatialParams, spatialPairs))
+        return EXIT_FAILURE;
+      conditionVocTree(treeFilepath, withWeights, weightsFilepath, matchingMode,featuresFolders, sfmDataA, nbMaxDescriptors, sfmDataFilenameA, sfmDataB,
+                       sfmDataFilenameB, useMultiSfM, descriptorsFilesA,  numImageQuery, selectedPairs, histogramsFolder);
+      intersectPairLists(selectedPairs, spatialPairs);
+      break;
+    }
     case EImageMatchingMethod::FRUSTUM_OR_VOCABULARYTREE:
     {
         throw std::runtime_error("FRUSTUM_OR_VOCABULARYTREE should have been decided before.");
@@ -272,6 +317,19 @@ int aliceVision_main(int argc, char** argv)
           selectedPairsSet.emplace(imagePairs.first, index);
       }
   }
+
+  if(!existingPairsFile.empty())
+  {
+    PairSet existingPairs;
+    if(!matchingImageCollection::loadPairsFromFile(existingPairsFile, existingPairs))
+    {
+      ALICEVISION_LOG_ERROR("Unable to load the existing pair list: " << existingPairsFile);
+      return EXIT_FAILURE;
+    }
+    selectedPairsSet = getNewViewsPairs(selectedPairsSet, existingPairs);
+    ALICEVISION_LOG_INFO("Incremental matching: " << selectedPairsSet.size() << " image pairs involving new views (" << existingPairs.size() << " existing image pairs).");
+  }
+
   matchingImageCollection::savePairsToFile(outputFile, selectedPairsSet);
 
   ALICEVISION_LOG_INFO("pairList exported in: " << outputFile);
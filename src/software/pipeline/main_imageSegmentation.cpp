@@ -25,6 +25,8 @@
 // IO
 #include <fstream>
 #include <algorithm>
+#include <deque>
+#include <future>
 #include <memory>
 #include <string>
 
@@ -34,7 +36,7 @@
 // These constants define the current software version.
 // They must be updated when the command line is changed.
 #define ALICEVISION_SOFTWARE_VERSION_MAJOR 1
-#define ALICEVISION_SOFTWARE_VERSION_MINOR 1
+#define ALICEVISION_SOFTWARE_VERSION_MINOR 2
 
 using namespace aliceVision;
 
@@ -90,6 +92,8 @@ int aliceVision_main(int argc, char** argv)
     bool maskInvert = false;
     int rangeStart = -1;
     int rangeSize = 1;
+    int batchSize = 1;
+    int maxPendingWrites = 4;
     
     // Description of mandatory parameters
     po::options_description requiredParams("Required parameters");
@@ -107,7 +111,11 @@ int aliceVision_main(int argc, char** argv)
         ("rangeStart", po::value<int>(&rangeStart)->default_value(rangeStart), 
         "Range start for processing views (ordered by image filepath). Set to -1 to process all images.")
         ("rangeSize", po::value<int>(&rangeSize)->default_value(rangeSize), 
-        "Range size for processing views (ordered by image filepath).");
+        "Range size for processing views (ordered by image filepath).")
+        ("batchSize", po::value<int>(&batchSize)->default_value(batchSize),
+         "Number of tiles processed per inference run. Ignored if the model has a fixed batch size.")
+        ("maxPendingWrites", po::value<int>(&maxPendingWrites)->default_value(maxPendingWrites),
+         "Maximum number of masks waiting to be written while the next images are processed.");
 
     CmdLine cmdline("AliceVision imageSegmentation");
     cmdline.add(requiredParams);
@@ -178,6 +186,7 @@ int aliceVision_main(int argc, char** argv)
     parameters.modelWidth = 1280;
     parameters.modelHeight = 720;
     parameters.overlapRatio = 0.3;
+    parameters.batchSize = batchSize;
 
     aliceVision::segmentation::Segmentation seg(parameters);
 
@@ -204,25 +213,30 @@ int aliceVision_main(int argc, char** argv)
         }
     }
 
-    for (int itemidx = 0; itemidx < rangeSize; itemidx++)
+    // Input image read and preprocessed for the model, in a worker thread
+    struct PreprocessedImage
     {
-        const auto& view = viewsOrderedByName[rangeStart + itemidx];
+        image::Image<image::RGBfColor> image;
+        int width = 0;
+        int height = 0;
+        double pixelRatio = 1.0;
+        bool valid = false;
+    };
 
-        std::string path = view->getImage().getImagePath();
-        ALICEVISION_LOG_INFO("processing " << path);
+    const auto preprocessView = [&seg](const sfmData::View& view) {
+        PreprocessedImage preprocessed;
 
         image::Image<image::RGBfColor> image;
-        image::readImage(path, image, image::EImageColorSpace::SRGB);
+        image::readImage(view.getImage().getImagePath(), image, image::EImageColorSpace::SRGB);
 
-        double pixelRatio = 1.0;
-        view->getImage().getDoubleMetadata({"PixelAspectRatio"}, pixelRatio);
-        if (pixelRatio != 1.0)
+        view.getImage().getDoubleMetadata({"PixelAspectRatio"}, preprocessed.pixelRatio);
+        if (preprocessed.pixelRatio != 1.0)
         {
             // Resample input image in order to work with square pixels
             const int w = image.Width();
             const int h = image.Height();
 
-            const int nw = static_cast<int>(static_cast<double>(w) * pixelRatio);
+            const int nw = static_cast<int>(static_cast<double>(w) * preprocessed.pixelRatio);
             const int nh = h;
 
             image::Image<image::RGBfColor> resizedInput;
@@ -230,13 +244,14 @@ int aliceVision_main(int argc, char** argv)
             image.swap(resizedInput);
         }
 
-        image::Image<IndexT> labels;
-        if (!seg.processImage(labels, image))
-        {
-            ALICEVISION_LOG_INFO("Failed to segment image " << path);
-        }
-
+        preprocessed.width = image.Width();
+        preprocessed.height = image.Height();
+        preprocessed.valid = seg.preprocessImage(preprocessed.image, image);
+        return preprocessed;
+    };
 
+    // Mask computed from the labels and written, in a worker thread
+    const auto writeMask = [&](image::Image<IndexT> labels, double pixelRatio, IndexT viewId) {
         image::Image<unsigned char> mask(labels.Width(), labels.Height());
         labelsToMask(mask, labels, validClassesIndices, maskInvert);
 
@@ -256,8 +271,48 @@ int aliceVision_main(int argc, char** argv)
 
         // Store image
         std::stringstream ss;
-        ss << outputPath << "/" << view->getViewId() << ".exr";
+        ss << outputPath << "/" << viewId << ".exr";
         image::writeImage(ss.str(), mask, image::ImageWriteOptions());
+    };
+
+    // The next image is preprocessed and the previous masks are written during the inference
+    std::future<PreprocessedImage> nextImage;
+    if (rangeSize > 0)
+    {
+        nextImage = std::async(std::launch::async, preprocessView, std::cref(*viewsOrderedByName[rangeStart]));
+    }
+    std::deque<std::future<void>> pendingWrites;
+
+    for (int itemidx = 0; itemidx < rangeSize; itemidx++)
+    {
+        const auto& view = viewsOrderedByName[rangeStart + itemidx];
+
+        std::string path = view->getImage().getImagePath();
+        ALICEVISION_LOG_INFO("processing " << path);
+
+        PreprocessedImage preprocessed = nextImage.get();
+        if (itemidx + 1 < rangeSize)
+        {
+            nextImage = std::async(std::launch::async, preprocessView, std::cref(*viewsOrderedByName[rangeStart + itemidx + 1]));
+        }
+
+        image::Image<IndexT> labels;
+        if (!preprocessed.valid || !seg.processPreprocessedImage(labels, preprocessed.image, preprocessed.width, preprocessed.height))
+        {
+            ALICEVISION_LOG_INFO("Failed to segment image " << path);
+        }
+
+        pendingWrites.push_back(std::async(std::launch::async, writeMask, std::move(labels), preprocessed.pixelRatio, view->getViewId()));
+        while (pendingWrites.size() > static_cast<std::size_t>(std::max(0, maxPendingWrites)))
+        {
+            pendingWrites.front().get();
+            pendingWrites.pop_front();
+        }
+    }
+
+    for (auto& pendingWrite : pendingWrites)
+    {
+        pendingWrite.get();
     }
 
    
@@ -10,6 +10,7 @@
 #include <aliceVision/sfm/sfm.hpp>
 #include <aliceVision/sfm/pipeline/regionsIO.hpp>
 #include <aliceVision/feature/imageDescriberCommon.hpp>
+#include <aliceVision/matching/viewGraphSparsification.hpp>
 #include <aliceVision/system/Timer.hpp>
 #include <aliceVision/system/Logger.hpp>
 #include <aliceVision/system/main.hpp>
@@ -28,7 +29,7 @@
 // These constants define the current software version.
 // They must be updated when the command line is changed.
 #define ALICEVISION_SOFTWARE_VERSION_MAJOR 2
-#define ALICEVISION_SOFTWARE_VERSION_MINOR 4
+#define ALICEVISION_SOFTWARE_VERSION_MINOR 8
 
 using namespace aliceVision;
 
@@ -92,6 +93,7 @@ int aliceVision_main(int argc, char **argv)
   int maxNbMatches = 0;
   int minNbMatches = 0;
   bool useOnlyMatchesFromInputFolder = false;
+  std::size_t viewGraphNeighbours = 0;
   bool computeStructureColor = true;
 
   int randomSeed = std::mt19937::default_seed;
@@ -166,6 +168,19 @@ int aliceVision_main(int argc, char **argv)
     ("bundleAdjustmentMaxOutliers", po::value<int>(&sfmParams.bundleAdjustmentMaxOutliers)->default_value(sfmParams.bundleAdjustmentMaxOutliers),
       "Threshold for the maximum number of outliers allowed at the end of a bundle adjustment iteration."
       "Using a negative value for this threshold will disable BA iterations.")
+    ("bundleAdjustmentSolver", po::value<sfm::EBundleAdjustmentSolver>(&sfmParams.bundleAdjustmentSolver)->default_value(sfmParams.bundleAdjustmentSolver),
+      "Linear solver of the bundle adjustment reduced camera system:\n"
+      "* auto: dense for small problems, sparse for large ones\n"
+      "* denseSchur: dense factorization\n"
+      "* sparseSchur: sparse factorization\n"
+      "* iterativeSchur: preconditioned conjugate gradient, for very large scenes")
+    ("bundleAdjustmentMixedPrecision", po::value<bool>(&sfmParams.bundleAdjustmentMixedPrecision)->default_value(sfmParams.bundleAdjustmentMixedPrecision),
+      "Solve the bundle adjustment linear systems in single precision with double precision refinement.")
+    ("bundleAdjustmentUseGpu", po::value<bool>(&sfmParams.bundleAdjustmentUseGpu)->default_value(sfmParams.bundleAdjustmentUseGpu),
+      "Factorize the dense reduced camera system on the GPU (requires Ceres built with CUDA).")
+    ("bundleAdjustmentPersistentProblem", po::value<bool>(&sfmParams.bundleAdjustmentPersistentProblem)->default_value(sfmParams.bundleAdjustmentPersistentProblem),
+      "Keep the bundle adjustment problem between the iterations and only add the new cameras, points and observations, "
+      "instead of rebuilding it at each bundle adjustment.")
     ("localizerEstimator", po::value<robustEstimation::ERobustEstimator>(&sfmParams.localizerEstimator)->default_value(sfmParams.localizerEstimator),
       "Estimator type used to localize cameras (acransac (default), ransac, lsmeds, loransac, maxconsensus)")
     ("localizerEstimatorError", po::value<double>(&sfmParams.localizerEstimatorError)->default_value(0.0),
@@ -175,6 +190,10 @@ int aliceVision_main(int argc, char **argv)
     ("useOnlyMatchesFromInputFolder", po::value<bool>(&useOnlyMatchesFromInputFolder)->default_value(useOnlyMatchesFromInputFolder),
       "Use only matches from the input matchesFolder parameter.\n"
       "Matches folders previously added to the SfMData file will be ignored.")
+    ("viewGraphNeighbours", po::value<std::size_t>(&viewGraphNeighbours)->default_value(viewGraphNeighbours),
+      "Sparsify the view graph before the SfM: keep a maximum spanning tree of the image pairs (weighted by their number of matches) "
+      "and the N best pairs of each image. The matches of the other pairs stay in the matches folders for the retriangulation "
+      "of the final structure (computeStructureFromKnownPoses). 0 to use all the pairs.")
     ("filterTrackForks", po::value<bool>(&sfmParams.filterTrackForks)->default_value(sfmParams.filterTrackForks),
       "Enable/Disable the track forks removal. A track contains a fork when incoherent matches leads to multiple features in the same image for a single track.\n")
     ("useRigConstraint", po::value<bool>(&sfmParams.rig.useRigConstraint)->default_value(sfmParams.rig.useRigConstraint),
@@ -193,6 +212,14 @@ int aliceVision_main(int argc, char **argv)
       "This seed value will generate a sequence using a linear random generator. Set -1 to use a random seed.")
     ("logIntermediateSteps", po::value<bool>(&sfmParams.logIntermediateSteps)->default_value(logIntermediateSteps),
       "If set to true, the current state of the scene will be dumped as an SfMData file every 3 resections.")
+    ("checkpointFolder", po::value<std::string>(&sfmParams.checkpointFolder)->default_value(sfmParams.checkpointFolder),
+      "Folder of the checkpoints of the incremental reconstruction, written periodically and removed once the reconstruction is done. "
+      "Disabled if empty.")
+    ("checkpointInterval", po::value<double>(&sfmParams.checkpointInterval)->default_value(sfmParams.checkpointInterval),
+      "Minimum time between two checkpoints, in seconds.")
+    ("resumeFromCheckpoint", po::value<bool>(&sfmParams.resumeFromCheckpoint)->default_value(sfmParams.resumeFromCheckpoint),
+      "Resume the incremental reconstruction from the checkpoint of the checkpoint folder, if any, "
+      "instead of starting from the input scene. The features, matches and parameters must be the same as the interrupted run.")
     ;
 
   CmdLine cmdline("Sequential/Incremental reconstruction.\n"
@@ -258,6 +285,7 @@ int aliceVision_main(int argc, char **argv)
     ALICEVISION_LOG_ERROR("Unable to load matches.");
     return EXIT_FAILURE;
   }
+  matching::sparsifyViewGraph(pairwiseMatches, viewGraphNeighbours);
 
   if(extraInfoFolder.empty())
     extraInfoFolder = fs::path(outputSfM).parent_path().string();
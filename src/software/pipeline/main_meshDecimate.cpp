@@ -9,6 +9,8 @@
 #include <aliceVision/system/main.hpp>
 #include <aliceVision/system/Timer.hpp>
 #include <aliceVision/mvsUtils/common.hpp>
+#include <aliceVision/mesh/meshBinaryIO.hpp>
+#include <aliceVision/alicevision_omp.hpp>
 
 #include <OpenMesh/Core/IO/reader/OBJReader.hh>
 #include <OpenMesh/Core/IO/writer/OBJWriter.hh>
@@ -21,16 +23,220 @@
 #include <boost/program_options.hpp>
 #include <boost/filesystem.hpp>
 
+#include <algorithm>
+#include <cmath>
+#include <unordered_map>
+#include <vector>
+
 // These constants define the current software version.
 // They must be updated when the command line is changed.
 #define ALICEVISION_SOFTWARE_VERSION_MAJOR 1
-#define ALICEVISION_SOFTWARE_VERSION_MINOR 0
+#define ALICEVISION_SOFTWARE_VERSION_MINOR 1
 
 using namespace aliceVision;
 
 namespace bfs = boost::filesystem;
 namespace po = boost::program_options;
 
+namespace {
+
+// Mesh type
+typedef OpenMesh::TriMesh_ArrayKernelT<> Mesh;
+// Decimater type
+typedef OpenMesh::Decimater::DecimaterT<Mesh> Decimater;
+// Decimation Module Handle type
+typedef OpenMesh::Decimater::ModQuadricT<Mesh>::Handle HModQuadric;
+
+/**
+ * @brief Quadric decimation of a mesh, the locked vertices are kept.
+ * @param[in,out] mesh the mesh to decimate
+ * @param[in] nbOutputVertices the target number of vertices
+ */
+void decimate(Mesh& mesh, std::size_t nbOutputVertices)
+{
+    // a decimater object, connected to a mesh
+    Decimater decimater(mesh);
+    // use a quadric module
+    HModQuadric hModQuadric;
+    // register module at the decimater
+    decimater.add(hModQuadric);
+
+    /*
+     * since we need exactly one priority module (non-binary)
+     * we have to call set_binary(false) for our priority module
+     * in the case of HModQuadric, unset_max_err() calls set_binary(false) internally
+     */
+    decimater.module(hModQuadric).unset_max_err();
+    // let the decimater initialize the mesh and the modules
+    decimater.initialize();
+    // do decimation
+    decimater.decimate_to(nbOutputVertices);
+    decimater.mesh().garbage_collection();
+}
+
+/**
+ * @brief Decimate a large mesh by spatial clusters in parallel, then the whole mesh.
+ *
+ * The faces are partitioned in a regular grid by their barycenter. Each cluster is decimated
+ * concurrently with the same ratio as the whole mesh, with its vertices shared with other
+ * clusters locked so the clusters can be merged back. A final pass on the merged mesh
+ * (much smaller than the input) reaches the target and decimates the cluster boundaries.
+ *
+ * @param[in,out] mesh the mesh to decimate
+ * @param[in] nbOutputVertices the target number of vertices
+ * @param[in] nbFacesPerCluster the approximate number of faces per cluster
+ */
+void decimateByClusters(Mesh& mesh, std::size_t nbOutputVertices, int nbFacesPerCluster)
+{
+    const Mesh& inputMesh = mesh;
+    const int nbInputVertices = static_cast<int>(inputMesh.n_vertices());
+    const int nbInputFaces = static_cast<int>(inputMesh.n_faces());
+    const int nbCellsPerAxis = std::max(1, static_cast<int>(std::ceil(std::cbrt(static_cast<double>(nbInputFaces) / nbFacesPerCluster))));
+    const int nbClusters = nbCellsPerAxis * nbCellsPerAxis * nbCellsPerAxis;
+
+    ALICEVISION_LOG_INFO("Decimate the mesh by " << nbClusters << " clusters (" << nbCellsPerAxis << " per axis).");
+
+    Mesh::Point bbMin = inputMesh.point(inputMesh.vertex_handle(0));
+    Mesh::Point bbMax = bbMin;
+    for (const auto vh : inputMesh.vertices())
+    {
+        bbMin.minimize(inputMesh.point(vh));
+        bbMax.maximize(inputMesh.point(vh));
+    }
+    const Mesh::Point bbSize = bbMax - bbMin;
+
+    const auto getCell = [&](float value, int axis) {
+        if (bbSize[axis] <= 0.f)
+            return 0;
+        const int cell = static_cast<int>((value - bbMin[axis]) / bbSize[axis] * nbCellsPerAxis);
+        return std::clamp(cell, 0, nbCellsPerAxis - 1);
+    };
+
+    // faces of each cluster and vertices shared between clusters
+    std::vector<std::vector<int>> clustersFaces(nbClusters);
+    std::vector<int> vertexCluster(nbInputVertices, -1);
+    std::vector<char> isSharedVertex(nbInputVertices, 0);
+
+    for (const auto fh : inputMesh.faces())
+    {
+        Mesh::Point barycenter(0.f, 0.f, 0.f);
+        int nbFaceVertices = 0;
+        for (const auto vh : inputMesh.fv_range(fh))
+        {
+            barycenter += inputMesh.point(vh);
+            ++nbFaceVertices;
+        }
+        barycenter /= static_cast<float>(std::max(1, nbFaceVertices));
+
+        const int cluster = (getCell(barycenter[2], 2) * nbCellsPerAxis + getCell(barycenter[1], 1)) * nbCellsPerAxis + getCell(barycenter[0], 0);
+        clustersFaces[cluster].push_back(fh.idx());
+
+        for (const auto vh : inputMesh.fv_range(fh))
+        {
+            int& currentCluster = vertexCluster[vh.idx()];
+            if (currentCluster == -1)
+                currentCluster = cluster;
+            else if (currentCluster != cluster)
+                isSharedVertex[vh.idx()] = 1;
+        }
+    }
+    vertexCluster.clear();
+
+    const double ratio = static_cast<double>(nbOutputVertices) / static_cast<double>(nbInputVertices);
+
+    // decimate the clusters concurrently, the shared vertices keep their input index
+    std::vector<Mesh> clustersMeshes(nbClusters);
+    std::vector<OpenMesh::VPropHandleT<int>> inputIndexProperties(nbClusters);
+
+#pragma omp parallel for schedule(dynamic)
+    for (int c = 0; c < nbClusters; ++c)
+    {
+        if (clustersFaces[c].empty())
+            continue;
+
+        Mesh& clusterMesh = clustersMeshes[c];
+        const OpenMesh::VPropHandleT<int>& inputIndexProperty = inputIndexProperties[c];
+        clusterMesh.add_property(inputIndexProperties[c]);
+        clusterMesh.request_vertex_status();
+
+        std::unordered_map<int, Mesh::VertexHandle> clusterVertices;
+        std::vector<Mesh::VertexHandle> faceVertices;
+        std::size_t nbLockedVertices = 0;
+
+        for (const int faceIndex : clustersFaces[c])
+        {
+            faceVertices.clear();
+            for (const auto vh : inputMesh.fv_range(inputMesh.face_handle(faceIndex)))
+            {
+                auto it = clusterVertices.find(vh.idx());
+                if (it == clusterVertices.end())
+                {
+                    const Mesh::VertexHandle clusterVh = clusterMesh.add_vertex(inputMesh.point(vh));
+                    const bool isShared = isSharedVertex[vh.idx()];
+                    clusterMesh.property(inputIndexProperty, clusterVh) = isShared ? vh.idx() : -1;
+                    if (isShared)
+                    {
+                        clusterMesh.status(clusterVh).set_locked(true);
+                        ++nbLockedVertices;
+                    }
+                    it = clusterVertices.emplace(vh.idx(), clusterVh).first;
+                }
+                faceVertices.push_back(it->second);
+            }
+            clusterMesh.add_face(faceVertices);
+        }
+        clustersFaces[c].clear();
+        clustersFaces[c].shrink_to_fit();
+
+        decimate(clusterMesh, std::max(nbLockedVertices, static_cast<std::size_t>(clusterMesh.n_vertices() * ratio)));
+    }
+
+    // merge the clusters in a deterministic order, the shared vertices are welded
+    Mesh mergedMesh;
+    std::unordered_map<int, Mesh::VertexHandle> sharedVertices;
+    std::vector<Mesh::VertexHandle> faceVertices;
+
+    for (int c = 0; c < nbClusters; ++c)
+    {
+        Mesh& clusterMesh = clustersMeshes[c];
+        if (clusterMesh.n_faces() == 0)
+            continue;
+
+        std::vector<Mesh::VertexHandle> mergedVertices(clusterMesh.n_vertices());
+        for (const auto vh : clusterMesh.vertices())
+        {
+            const int inputIndex = clusterMesh.property(inputIndexProperties[c], vh);
+            if (inputIndex < 0)
+            {
+                mergedVertices[vh.idx()] = mergedMesh.add_vertex(clusterMesh.point(vh));
+                continue;
+            }
+            auto it = sharedVertices.find(inputIndex);
+            if (it == sharedVertices.end())
+                it = sharedVertices.emplace(inputIndex, mergedMesh.add_vertex(clusterMesh.point(vh))).first;
+            mergedVertices[vh.idx()] = it->second;
+        }
+
+        for (const auto fh : clusterMesh.faces())
+        {
+            faceVertices.clear();
+            for (const auto vh : clusterMesh.fv_range(fh))
+                faceVertices.push_back(mergedVertices[vh.idx()]);
+            mergedMesh.add_face(faceVertices);
+        }
+
+        // release the memory of the cluster
+        clusterMesh.clear();
+    }
+
+    ALICEVISION_LOG_INFO("Merged clusters: " << mergedMesh.n_vertices() << " vertices and " << mergedMesh.n_faces() << " facets.");
+
+    mesh = mergedMesh;
+    decimate(mesh, nbOutputVertices);
+}
+
+}  // namespace
+
 int aliceVision_main(int argc, char* argv[])
 {
     system::Timer timer;
@@ -42,13 +248,14 @@ int aliceVision_main(int argc, char* argv[])
     int minVertices = 0;
     int maxVertices = 0;
     bool flipNormals = false;
+    int nbFacesPerCluster = 2000000;
 
     po::options_description requiredParams("Required parameters");
     requiredParams.add_options()
         ("input,i", po::value<std::string>(&inputMeshPath)->required(),
-            "Input Mesh (OBJ file format).")
+            "Input Mesh (OBJ or binary .avmesh file format).")
         ("output,o", po::value<std::string>(&outputMeshPath)->required(),
-            "Output mesh (OBJ file format).");
+            "Output mesh (OBJ or binary .avmesh file format).");
 
     po::options_description optionalParams("Optional parameters");
     optionalParams.add_options()
@@ -61,7 +268,10 @@ int aliceVision_main(int argc, char* argv[])
         ("maxVertices", po::value<int>(&maxVertices)->default_value(maxVertices),
             "Max number of output vertices.")
         ("flipNormals", po::value<bool>(&flipNormals)->default_value(flipNormals),
-            "Option to flip face normals. It can be needed as it depends on the vertices order in triangles and the convention change from one software to another.");
+            "Option to flip face normals. It can be needed as it depends on the vertices order in triangles and the convention change from one software to another.")
+        ("nbFacesPerCluster", po::value<int>(&nbFacesPerCluster)->default_value(nbFacesPerCluster),
+            "Approximate number of faces per spatial cluster. The meshes with more faces are decimated by clusters in parallel "
+            "before a final pass on the whole mesh (0 to disable).");
 
     CmdLine cmdline("AliceVision meshDecimate");
                   
@@ -77,15 +287,10 @@ int aliceVision_main(int argc, char* argv[])
     if(!bfs::is_directory(outDirectory))
         bfs::create_directory(outDirectory);
 
-    // Mesh type
-    typedef OpenMesh::TriMesh_ArrayKernelT<>                      Mesh;
-    // Decimater type
-    typedef OpenMesh::Decimater::DecimaterT< Mesh >               Decimater;
-    // Decimation Module Handle type
-    typedef OpenMesh::Decimater::ModQuadricT< Mesh >::Handle HModQuadric;
-
     Mesh mesh;
-    if(!OpenMesh::IO::read_mesh(mesh, inputMeshPath))
+    const bool loaded = aliceVision::mesh::isBinaryMeshFile(inputMeshPath) ? aliceVision::mesh::loadBinaryOpenMesh(mesh, inputMeshPath)
+                                                                           : OpenMesh::IO::read_mesh(mesh, inputMeshPath);
+    if(!loaded)
     {
         ALICEVISION_LOG_ERROR("Unable to read input mesh from the file: " << inputMeshPath);
         return EXIT_FAILURE;
@@ -120,28 +325,13 @@ int aliceVision_main(int argc, char* argv[])
     ALICEVISION_LOG_INFO("Input mesh: " << nbInputPoints << " vertices and " << mesh.n_faces() << " facets.");
     ALICEVISION_LOG_INFO("Target output mesh: " << nbOutputPoints << " vertices.");
 
+    if(nbFacesPerCluster > 0 && nbOutputPoints > 0 && nbOutputPoints < nbInputPoints && mesh.n_faces() > 2 * static_cast<std::size_t>(nbFacesPerCluster))
+    {
+        decimateByClusters(mesh, nbOutputPoints, nbFacesPerCluster);
+    }
+    else
     {
-        // a decimater object, connected to a mesh
-        Decimater   decimater(mesh);
-        // use a quadric module
-        HModQuadric hModQuadric;
-        // register module at the decimater
-        decimater.add(hModQuadric);
-
-        // the way to access the module
-        std::cout << decimater.module(hModQuadric).name() << std::endl;
-
-        /*
-         * since we need exactly one priority module (non-binary)
-         * we have to call set_binary(false) for our priority module
-         * in the case of HModQuadric, unset_max_err() calls set_binary(false) internally
-         */
-        decimater.module(hModQuadric).unset_max_err();
-        // let the decimater initialize the mesh and the modules
-        decimater.initialize();
-        // do decimation
-        size_t removedVertices = decimater.decimate_to(nbOutputPoints);
-        decimater.mesh().garbage_collection();
+        decimate(mesh, nbOutputPoints);
     }
     ALICEVISION_LOG_INFO("Output mesh: " << mesh.n_vertices() << " vertices and " << mesh.n_faces() << " facets.");
 
@@ -153,7 +343,9 @@ int aliceVision_main(int argc, char* argv[])
 
     ALICEVISION_LOG_INFO("Save mesh.");
     // Save output mesh
-    if(!OpenMesh::IO::write_mesh(mesh, outputMeshPath))
+    const bool saved = aliceVision::mesh::isBinaryMeshFile(outputMeshPath) ? aliceVision::mesh::saveBinaryOpenMesh(mesh, outputMeshPath)
+                                                                           : OpenMesh::IO::write_mesh(mesh, outputMeshPath);
+    if(!saved)
     {
         ALICEVISION_LOG_ERROR("Failed to save mesh \"" << outputMeshPath << "\".");
         return EXIT_FAILURE;
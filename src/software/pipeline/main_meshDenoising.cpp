@@ -9,6 +9,7 @@
 #include <aliceVision/system/main.hpp>
 #include <aliceVision/system/Timer.hpp>
 #include <aliceVision/mvsUtils/common.hpp>
+#include <aliceVision/mesh/meshBinaryIO.hpp>
 
 #include <EigenTypes.h>
 #include <MeshTypes.h>
@@ -51,9 +52,9 @@ int aliceVision_main(int argc, char* argv[])
     po::options_description requiredParams("Required parameters");
     requiredParams.add_options()
         ("input,i", po::value<std::string>(&inputMeshPath)->required(),
-            "Input Mesh (OBJ file format).")
+            "Input Mesh (OBJ or binary .avmesh file format).")
         ("output,o", po::value<std::string>(&outputMeshPath)->required(),
-            "Output mesh (OBJ file format).");
+            "Output mesh (OBJ or binary .avmesh file format).");
 
     po::options_description optionalParams("Optional parameters");
     optionalParams.add_options()
@@ -89,7 +90,9 @@ int aliceVision_main(int argc, char* argv[])
 
 
     TriMesh inMesh;
-    if(!OpenMesh::IO::read_mesh(inMesh, inputMeshPath))
+    const bool loaded = mesh::isBinaryMeshFile(inputMeshPath) ? mesh::loadBinaryOpenMesh(inMesh, inputMeshPath)
+                                                              : OpenMesh::IO::read_mesh(inMesh, inputMeshPath);
+    if(!loaded)
     {
         ALICEVISION_LOG_ERROR("Unable to read input mesh from the file: " << inputMeshPath);
         return EXIT_FAILURE;
@@ -170,7 +173,9 @@ int aliceVision_main(int argc, char* argv[])
 
     ALICEVISION_LOG_INFO("Save mesh.");
     // Save output mesh
-    if(!OpenMesh::IO::write_mesh(outMesh, outputMeshPath))
+    const bool saved = mesh::isBinaryMeshFile(outputMeshPath) ? mesh::saveBinaryOpenMesh(outMesh, outputMeshPath)
+                                                              : OpenMesh::IO::write_mesh(outMesh, outputMeshPath);
+    if(!saved)
     {
         ALICEVISION_LOG_ERROR("Failed to save mesh file: \"" << outputMeshPath << "\".");
         return EXIT_FAILURE;
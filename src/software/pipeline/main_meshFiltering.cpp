@@ -119,9 +119,9 @@ int aliceVision_main(int argc, char* argv[])
     po::options_description requiredParams("Required parameters");
     requiredParams.add_options()
         ("inputMesh,i", po::value<std::string>(&inputMeshPath)->required(),
-            "Input Mesh")
+            "Input Mesh (OBJ or binary .avmesh file format).")
         ("outputMesh,o", po::value<std::string>(&outputMeshPath)->required(),
-            "Output mesh");
+            "Output mesh (OBJ or binary .avmesh file format).");
 
     po::options_description optionalParams("Optional parameters");
     optionalParams.add_options()
@@ -11,6 +11,7 @@
 #include <aliceVision/fuseCut/LargeScale.hpp>
 #include <aliceVision/fuseCut/ReconstructionPlan.hpp>
 #include <aliceVision/fuseCut/DelaunayGraphCut.hpp>
+#include <aliceVision/fuseCut/MaxFlowSolver.hpp>
 #include <aliceVision/mesh/meshPostProcessing.hpp>
 #include <aliceVision/mvsData/Point3d.hpp>
 #include <aliceVision/mvsData/StaticVector.hpp>
@@ -28,11 +29,12 @@
 #include <boost/filesystem.hpp>
 
 #include <cmath>
+#include <memory>
 
 // These constants define the current software version.
 // They must be updated when the command line is changed.
 #define ALICEVISION_SOFTWARE_VERSION_MAJOR 4
-#define ALICEVISION_SOFTWARE_VERSION_MINOR 0
+#define ALICEVISION_SOFTWARE_VERSION_MINOR 5
 
 using namespace aliceVision;
 
@@ -310,7 +312,14 @@ int aliceVision_main(int argc, char* argv[])
     double minSolidAngleRatio = 0.2;
     int nbSolidAngleFilteringIterations = 2;
     unsigned int seed = 0;
+    bool parallelDelaunay = true;
+    fuseCut::EMaxFlowSolver maxflowSolver = fuseCut::EMaxFlowSolver::BOYKOV_KOLMOGOROV;
     BoundingBox boundingBox;
+    int nbTiles = 8;
+    double tileOverlap = 0.1;
+    int rangeStart = -1;
+    int rangeSize = 1;
+    bool mergeTilesOnly = false;
 
     fuseCut::FuseParams fuseParams;
 
@@ -330,7 +339,7 @@ int aliceVision_main(int argc, char* argv[])
         ("output,o", po::value<std::string>(&outputDensePointCloud)->required(),
           "Output Dense SfMData file.")
         ("outputMesh,o", po::value<std::string>(&outputMesh)->required(),
-          "Output mesh");
+          "Output mesh (OBJ, or binary .avmesh to keep it as an intermediate file for the next mesh tools).");
 
     po::options_description optionalParams("Optional parameters");
     optionalParams.add_options()
@@ -354,7 +363,18 @@ int aliceVision_main(int argc, char* argv[])
         ("minVis", po::value<int>(&fuseParams.minVis)->default_value(fuseParams.minVis),
             "Filter points based on their number of observations")
         ("partitioning", po::value<EPartitioningMode>(&partitioningMode)->default_value(partitioningMode),
-            "Partitioning: 'singleBlock' or 'auto'.")
+            "Partitioning: 'singleBlock' or 'auto' (tiled meshing, memory bounded by the tile size).")
+        ("nbTiles", po::value<int>(&nbTiles)->default_value(nbTiles),
+            "Partitioning 'auto': minimum number of tiles, the bounding box longest sides are divided first.")
+        ("tileOverlap", po::value<double>(&tileOverlap)->default_value(tileOverlap),
+            "Partitioning 'auto': overlap on each side of a tile, as a ratio of the tile size.")
+        ("rangeStart", po::value<int>(&rangeStart)->default_value(rangeStart),
+            "Partitioning 'auto': compute only a range of tiles (to distribute the tiles on several processes or nodes), "
+            "the tiles are then merged with --mergeTilesOnly. Tile index of the range start, -1 to compute and merge all tiles.")
+        ("rangeSize", po::value<int>(&rangeSize)->default_value(rangeSize),
+            "Partitioning 'auto': number of tiles of the range.")
+        ("mergeTilesOnly", po::value<bool>(&mergeTilesOnly)->default_value(mergeTilesOnly),
+            "Partitioning 'auto': only merge the tiles previously computed with --rangeStart/--rangeSize.")
         ("repartition", po::value<ERepartitionMode>(&repartitionMode)->default_value(repartitionMode),
             "Repartition: 'multiResolution' or 'regularGrid'.")
         ("estimateSpaceFromSfM", po::value<bool>(&estimateSpaceFromSfM)->default_value(estimateSpaceFromSfM),
@@ -388,6 +408,11 @@ int aliceVision_main(int argc, char* argv[])
             "minAngleThreshold")
         ("refineFuse", po::value<bool>(&fuseParams.refineFuse)->default_value(fuseParams.refineFuse),
             "refineFuse")
+        ("maxNbCachedDepthMaps", po::value<int>(&fuseParams.maxNbCachedDepthMaps)->default_value(fuseParams.maxNbCachedDepthMaps),
+            "Max number of cameras depth maps kept in memory during the depth maps fusion.")
+        ("fusedPointsFile", po::value<std::string>(&fuseParams.fusedPointsFilepath)->default_value(fuseParams.fusedPointsFilepath),
+            "Binary file of the fused points. If it exists, the points are read from it instead of fusing the depth maps, "
+            "else the fusion result is written in it. Not used with the 'auto' partitioning.")
         ("helperPointsGridSize", po::value<int>(&helperPointsGridSize)->default_value(helperPointsGridSize),
             "Helper points grid size.")
         ("densifyNbFront", po::value<int>(&densifyNbFront)->default_value(densifyNbFront),
@@ -418,6 +443,11 @@ int aliceVision_main(int argc, char* argv[])
             "Maximum number of connected helper points before we remove them.")
         ("exportDebugTetrahedralization", po::value<bool>(&exportDebugTetrahedralization)->default_value(exportDebugTetrahedralization),
             "Export debug cells score as tetrahedral mesh. WARNING: could create huge meshes, only use on very small datasets.")        
+        ("parallelDelaunay", po::value<bool>(&parallelDelaunay)->default_value(parallelDelaunay),
+            "Use the multi-threaded Delaunay tetrahedralization (the cells order is not deterministic).")
+        ("maxflowSolver", po::value<fuseCut::EMaxFlowSolver>(&maxflowSolver)->default_value(maxflowSolver),
+            "Max-flow solver of the graph cut: 'boykovKolmogorov' (single-threaded), "
+            "'boykovKolmogorovCSR' (single-threaded, compact graph with a lower memory peak) or 'pushRelabel' (multi-threaded).")
         ("seed", po::value<unsigned int>(&seed)->default_value(seed),
             "Seed used in random processes. (0 to use a random seed).");
 
@@ -467,6 +497,8 @@ int aliceVision_main(int argc, char* argv[])
     mp.userParams.put("LargeScale.densifyScale", densifyScale);
 
     mp.userParams.put("delaunaycut.seed", seed);
+    mp.userParams.put("delaunaycut.parallelDelaunay", parallelDelaunay);
+    mp.userParams.put("delaunaycut.maxflowSolver", fuseCut::EMaxFlowSolver_enumToString(maxflowSolver));
     mp.userParams.put("delaunaycut.nPixelSizeBehind", nPixelSizeBehind);
     mp.userParams.put("delaunaycut.fullWeight", fullWeight);
     mp.userParams.put("delaunaycut.voteFilteringForWeaklySupportedSurfaces", voteFilteringForWeaklySupportedSurfaces);
@@ -493,47 +525,183 @@ int aliceVision_main(int argc, char* argv[])
     {
         case eRepartitionMultiResolution:
         {
-            switch(partitioningMode)
+            std::array<Point3d, 8> hexah;
+
+            float minPixSize;
+            fuseCut::Fuser fs(mp);
+
+            if (boundingBox.isInitialized())
+                boundingBox.toHexahedron(&hexah[0]);
+            else if(meshingFromDepthMaps && (!estimateSpaceFromSfM || sfmData.getLandmarks().empty()))
+              fs.divideSpaceFromDepthMaps(&hexah[0], minPixSize);
+            else
+              fs.divideSpaceFromSfM(sfmData, &hexah[0], estimateSpaceMinObservations, estimateSpaceMinObservationAngle);
+
             {
-                case ePartitioningAuto:
+                const double length = hexah[0].x - hexah[1].x;
+                const double width = hexah[0].y - hexah[3].y;
+                const double height = hexah[0].z - hexah[4].z;
+
+                ALICEVISION_LOG_INFO("bounding Box : length: " << length << ", width: " << width << ", height: " << height);
+
+                // Save bounding box
+                BoundingBox bbox = BoundingBox::fromHexahedron(&hexah[0]);
+                std::string filename = (outDirectory / "boundingBox.txt").string();
+                std::ofstream fs(filename, std::ios::out);
+                if(!fs.is_open())
                 {
-                    throw std::invalid_argument("Meshing mode: 'multiResolution', partitioning: 'auto' is not yet implemented.");
+                    ALICEVISION_LOG_WARNING("Unable to create the bounding box file " << filename);
                 }
-                case ePartitioningSingleBlock:
+                fs << bbox.translation << std::endl;
+                fs << bbox.rotation << std::endl;
+                fs << bbox.scale << std::endl;
+                fs.close();
+            }
+
+            // mesh the given hexahedron from the given cameras
+            const auto meshHexahedron = [&](Point3d* meshHexah, const StaticVector<int>& cams, const fs::path& folder, StaticVector<StaticVector<int>>& out_ptsCams)
+            {
+                fuseCut::DelaunayGraphCut delaunayGC(mp);
+                delaunayGC.createDensePointCloud(meshHexah, cams, addLandmarksToTheDensePointCloud ? &sfmData : nullptr, meshingFromDepthMaps ? &fuseParams : nullptr);
+                if(saveRawDensePointCloud)
                 {
-                    ALICEVISION_LOG_INFO("Meshing mode: multi-resolution, partitioning: single block.");
-                    std::array<Point3d, 8> hexah;
+                  ALICEVISION_LOG_INFO("Save dense point cloud before cut and filtering.");
+                  StaticVector<StaticVector<int>> ptsCams;
+                  delaunayGC.createPtsCams(ptsCams);
+                  sfmData::SfMData densePointCloud;
+                  createDenseSfMData(sfmData, mp, delaunayGC._verticesCoords, ptsCams, densePointCloud);
+                  removeLandmarksWithoutObservations(densePointCloud);
+                  if(colorizeOutput)
+                    sfmData::colorizeTracks(densePointCloud);
+                  sfmDataIO::Save(densePointCloud, (folder/"densePointCloud_raw.abc").string(), sfmDataIO::ESfMData::ALL_DENSE);
+                }
 
-                    float minPixSize;
-                    fuseCut::Fuser fs(mp);
+                delaunayGC.createGraphCut(meshHexah, cams, folder.string() + "/",
+                                          folder.string() + "/SpaceCamsTracks/", false,
+                                          exportDebugTetrahedralization);
 
-                    if (boundingBox.isInitialized())
-                        boundingBox.toHexahedron(&hexah[0]);
-                    else if(meshingFromDepthMaps && (!estimateSpaceFromSfM || sfmData.getLandmarks().empty()))
-                      fs.divideSpaceFromDepthMaps(&hexah[0], minPixSize);
-                    else
-                      fs.divideSpaceFromSfM(sfmData, &hexah[0], estimateSpaceMinObservations, estimateSpaceMinObservationAngle);
+                delaunayGC.graphCutPostProcessing(meshHexah, folder.string()+"/");
+
+                mesh::Mesh* outMesh = delaunayGC.createMesh(maxNbConnectedHelperPoints);
+                delaunayGC.createPtsCams(out_ptsCams);
+                mesh::meshPostProcessing(outMesh, out_ptsCams, mp, folder.string()+"/", nullptr, meshHexah);
+                return outMesh;
+            };
+
+            switch(partitioningMode)
+            {
+                case ePartitioningAuto:
+                {
+                    ALICEVISION_LOG_INFO("Meshing mode: multi-resolution, partitioning: auto (tiles).");
+
+                    if(!meshingFromDepthMaps)
+                        throw std::invalid_argument("Meshing mode: 'multiResolution', partitioning: 'auto' requires depth maps.");
+
+                    if(!fuseParams.fusedPointsFilepath.empty())
+                    {
+                        ALICEVISION_LOG_WARNING("The fused points file is not used with the 'auto' partitioning, each tile fuses its own points.");
+                        fuseParams.fusedPointsFilepath.clear();
+                    }
+
+                    // regular grid of tiles over the bounding box, each tile is meshed independently (memory bounded by the tile size)
+                    const Voxel tilesGridDimensions = fuseCut::computeTilesGridDimensions(&hexah[0], nbTiles);
+                    std::unique_ptr<StaticVector<Point3d>> tilesHexahs(mvsUtils::computeVoxels(&hexah[0], tilesGridDimensions));
+                    const int nbGridTiles = tilesHexahs->size() / 8;
+
+                    ALICEVISION_LOG_INFO("Tiles grid: " << tilesGridDimensions.x << "x" << tilesGridDimensions.y << "x" << tilesGridDimensions.z
+                                                        << " (" << nbGridTiles << " tiles), overlap: " << tileOverlap);
 
+                    const fs::path tilesDirectory = outDirectory / "tiles";
+                    const auto getTileDirectory = [&](int tileIndex) { return tilesDirectory / ("tile_" + mvsUtils::num2strFourDecimal(tileIndex)); };
+
+                    int tileRangeStart = 0;
+                    int tileRangeSize = nbGridTiles;
+                    if(rangeStart != -1)
+                    {
+                        if(rangeStart < 0 || rangeSize < 0 || rangeStart >= nbGridTiles)
+                        {
+                            ALICEVISION_LOG_ERROR("Range is incorrect (" << nbGridTiles << " tiles).");
+                            return EXIT_FAILURE;
+                        }
+                        tileRangeStart = rangeStart;
+                        tileRangeSize = std::min(rangeSize, nbGridTiles - rangeStart);
+                    }
+
+                    if(!mergeTilesOnly)
+                    {
+                        for(int t = tileRangeStart; t < tileRangeStart + tileRangeSize; ++t)
+                        {
+                            const fs::path tileDirectory = getTileDirectory(t);
+                            fs::create_directories(tileDirectory);
+
+                            // overlapping tile, the mesh borders are removed during the merge
+                            Point3d tileHexah[8];
+                            mvsUtils::inflateHexahedron(&(*tilesHexahs)[t * 8], tileHexah, float(1.0 + 2.0 * tileOverlap));
+
+                            const StaticVector<int> cams = mp.findCamsWhichIntersectsHexahedron(tileHexah);
+                            ALICEVISION_LOG_INFO("Tile " << t + 1 << "/" << nbGridTiles << ": " << cams.size() << " cameras.");
+
+                            fs::remove(tileDirectory / "mesh.bin");
+                            if(cams.empty())
+                                continue;
+
+                            StaticVector<StaticVector<int>> tilePtsCams;
+                            std::unique_ptr<mesh::Mesh> tileMesh(meshHexahedron(tileHexah, cams, tileDirectory, tilePtsCams));
+                            if(tileMesh == nullptr || tileMesh->tris.empty())
+                            {
+                                ALICEVISION_LOG_WARNING("Tile " << t + 1 << "/" << nbGridTiles << ": empty mesh.");
+                                continue;
+                            }
+
+                            saveArrayOfArraysToFile<int>((tileDirectory / "meshPtsCamsFromDGC.bin").string(), tilePtsCams);
+                            tileMesh->saveToBin((tileDirectory / "mesh.bin").string());
+                        }
+
+                        if(rangeStart != -1)
+                        {
+                            ALICEVISION_LOG_INFO("Tiles " << tileRangeStart << " to " << tileRangeStart + tileRangeSize - 1 << " done, "
+                                                 "use --mergeTilesOnly to merge all tiles.");
+                            ALICEVISION_LOG_INFO("Task done in (s): " + std::to_string(timer.elapsed()));
+                            return EXIT_SUCCESS;
+                        }
+                    }
+
+                    // merge the tiles, each tile mesh is cut by its tile (without overlap)
+                    std::vector<std::string> tilesDirs;
+                    StaticVector<Point3d> meshedTilesHexahs;
+                    for(int t = 0; t < nbGridTiles; ++t)
                     {
-                        const double length = hexah[0].x - hexah[1].x;
-                        const double width = hexah[0].y - hexah[3].y;
-                        const double height = hexah[0].z - hexah[4].z;
+                        const fs::path tileDirectory = getTileDirectory(t);
+                        if(!fs::exists(tileDirectory / "mesh.bin"))
+                            continue;
+                        tilesDirs.push_back(tileDirectory.string() + "/");
+                        for(int k = 0; k < 8; ++k)
+                            meshedTilesHexahs.push_back((*tilesHexahs)[t * 8 + k]);
+                    }
+                    ALICEVISION_LOG_INFO("Merge " << tilesDirs.size() << " tiles.");
 
-                        ALICEVISION_LOG_INFO("bounding Box : length: " << length << ", width: " << width << ", height: " << height);
+                    mesh = fuseCut::joinMeshes(tilesDirs, &meshedTilesHexahs, 1.0f);
+                    fuseCut::loadLargeScalePtsCams(tilesDirs, ptsCams);
+
+                    // remove the vertices of the triangles cut by the tiles borders
+                    {
+                        StaticVector<int> ptIdToNewPtId;
+                        mesh->removeFreePointsFromMesh(ptIdToNewPtId);
 
-                        // Save bounding box
-                        BoundingBox bbox = BoundingBox::fromHexahedron(&hexah[0]);
-                        std::string filename = (outDirectory / "boundingBox.txt").string();
-                        std::ofstream fs(filename, std::ios::out);
-                        if(!fs.is_open())
+                        StaticVector<StaticVector<int>> ptsCamsOld;
+                        std::swap(ptsCamsOld, ptsCams);
+                        ptsCams.resize(mesh->pts.size());
+                        for(int i = 0; i < ptIdToNewPtId.size(); ++i)
                         {
-                            ALICEVISION_LOG_WARNING("Unable to create the bounding box file " << filename);
+                            if(ptIdToNewPtId[i] > -1)
+                                std::swap(ptsCams[ptIdToNewPtId[i]], ptsCamsOld[i]);
                         }
-                        fs << bbox.translation << std::endl;
-                        fs << bbox.rotation << std::endl;
-                        fs << bbox.scale << std::endl;
-                        fs.close();
                     }
+                    break;
+                }
+                case ePartitioningSingleBlock:
+                {
+                    ALICEVISION_LOG_INFO("Meshing mode: multi-resolution, partitioning: single block.");
 
                     StaticVector<int> cams;
                     if(meshingFromDepthMaps)
@@ -549,31 +717,8 @@ int aliceVision_main(int argc, char* argv[])
 
                     if(cams.empty())
                         throw std::logic_error("No camera to make the reconstruction");
-                    
-                    fuseCut::DelaunayGraphCut delaunayGC(mp);
-                    delaunayGC.createDensePointCloud(&hexah[0], cams, addLandmarksToTheDensePointCloud ? &sfmData : nullptr, meshingFromDepthMaps ? &fuseParams : nullptr);
-                    if(saveRawDensePointCloud)
-                    {
-                      ALICEVISION_LOG_INFO("Save dense point cloud before cut and filtering.");
-                      StaticVector<StaticVector<int>> ptsCams;
-                      delaunayGC.createPtsCams(ptsCams);
-                      sfmData::SfMData densePointCloud;
-                      createDenseSfMData(sfmData, mp, delaunayGC._verticesCoords, ptsCams, densePointCloud);
-                      removeLandmarksWithoutObservations(densePointCloud);
-                      if(colorizeOutput)
-                        sfmData::colorizeTracks(densePointCloud);
-                      sfmDataIO::Save(densePointCloud, (outDirectory/"densePointCloud_raw.abc").string(), sfmDataIO::ESfMData::ALL_DENSE);
-                    }
-
-                    delaunayGC.createGraphCut(&hexah[0], cams, outDirectory.string() + "/",
-                                              outDirectory.string() + "/SpaceCamsTracks/", false,
-                                              exportDebugTetrahedralization);
-
-                    delaunayGC.graphCutPostProcessing(&hexah[0], outDirectory.string()+"/");
 
-                    mesh = delaunayGC.createMesh(maxNbConnectedHelperPoints);
-                    delaunayGC.createPtsCams(ptsCams);
-                    mesh::meshPostProcessing(mesh, ptsCams, mp, outDirectory.string()+"/", nullptr, &hexah[0]);
+                    mesh = meshHexahedron(&hexah[0], cams, outDirectory, ptsCams);
 
                     break;
                 }
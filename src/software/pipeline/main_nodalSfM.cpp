@@ -6,6 +6,7 @@
 
 #include <aliceVision/types.hpp>
 #include <aliceVision/config.hpp>
+#include <aliceVision/alicevision_omp.hpp>
 
 #include <aliceVision/system/Timer.hpp>
 #include <aliceVision/system/Logger.hpp>
@@ -32,6 +33,7 @@
 #include <aliceVision/stl/mapUtils.hpp>
 #include <aliceVision/geometry/lie.hpp>
 #include <aliceVision/sfm/bundle/BundleAdjustmentSymbolicCeres.hpp>
+#include <aliceVision/sfm/LocalBundleAdjustmentGraph.hpp>
 
 #include <cstdlib>
 #include <random>
@@ -45,7 +47,7 @@
 // These constants define the current software version.
 // They must be updated when the command line is changed.
 #define ALICEVISION_SOFTWARE_VERSION_MAJOR 1
-#define ALICEVISION_SOFTWARE_VERSION_MINOR 0
+#define ALICEVISION_SOFTWARE_VERSION_MINOR 1
 
 using namespace aliceVision;
 
@@ -186,16 +188,44 @@ void buildInitialWorld(sfmData::SfMData& sfmData, const feature::FeaturesPerView
     }
 }
 
-IndexT findBestNext(sfmData::SfMData& sfmData, const feature::FeaturesPerView & featuresPerView, const track::TracksPerView & tracksPerView, const track::TracksMap & trackMap, const std::set<IndexT> & visitedViews)
+/**
+ * @brief Result of the rotation-only resection of a view
+ */
+struct RotationResection
 {
-    //Retrieve the set of tracks with an associated landmark
-    std::set<size_t> tracksWithPoint;
-    std::transform(sfmData.getLandmarks().begin(), sfmData.getLandmarks().end(), std::inserter(tracksWithPoint, tracksWithPoint.begin()), stl::RetrieveKey());
-
-    //Find the view with most observed landmarks
-    size_t bestCount = 0;
-    IndexT bestId = UndefinedIndexT;
-    for (const auto & pV : sfmData.getViews())
+    Mat3 R;
+    /// the reconstructed tracks inliers of the rotation
+    std::vector<IndexT> inlierTracks;
+};
+
+/**
+ * @return the sorted ids of the tracks with an associated landmark
+ */
+std::vector<IndexT> getReconstructedTracks(const sfmData::SfMData& sfmData)
+{
+    std::vector<IndexT> reconstructedTracks;
+    reconstructedTracks.reserve(sfmData.getLandmarks().size());
+    std::transform(sfmData.getLandmarks().begin(), sfmData.getLandmarks().end(), std::back_inserter(reconstructedTracks), stl::RetrieveKey());
+    std::sort(reconstructedTracks.begin(), reconstructedTracks.end());
+    return reconstructedTracks;
+}
+
+/**
+ * @brief Select the next group of views to localize: the views observing the most reconstructed tracks.
+ * @param[in] maxViewsPerGroup the maximum number of views of the group
+ * @return the views of the group, empty if no view can be localized
+ */
+std::vector<IndexT> findBestNextViews(const sfmData::SfMData& sfmData,
+                                      const track::TracksPerView& tracksPerView,
+                                      const std::vector<IndexT>& reconstructedTracks,
+                                      const std::set<IndexT>& visitedViews,
+                                      std::size_t maxViewsPerGroup)
+{
+    // the views of a group observe at least this ratio of the observations of the best view
+    const double minScoreRatio = 0.75;
+
+    std::vector<IndexT> candidates;
+    for (const auto& pV : sfmData.getViews())
     {
         if (sfmData.isPoseAndIntrinsicDefined(pV.first))
         {
@@ -207,36 +237,65 @@ IndexT findBestNext(sfmData::SfMData& sfmData, const feature::FeaturesPerView &
             continue;
         }
 
-        std::vector<size_t> nextTracks = tracksPerView.at(pV.first);
+        candidates.push_back(pV.first);
+    }
+
+    // count the reconstructed tracks observed by each candidate view
+    std::vector<std::pair<std::size_t, IndexT>> scores(candidates.size());
+
+#pragma omp parallel for schedule(dynamic)
+    for (int i = 0; i < static_cast<int>(candidates.size()); ++i)
+    {
+        const std::vector<size_t>& nextTracks = tracksPerView.at(candidates[i]);
 
         std::vector<IndexT> observedTracks;
-        std::set_intersection(tracksWithPoint.begin(), tracksWithPoint.end(), nextTracks.begin(), nextTracks.end(), std::back_inserter(observedTracks));
-        
-        if (observedTracks.size() > bestCount)
+        std::set_intersection(
+          reconstructedTracks.begin(), reconstructedTracks.end(), nextTracks.begin(), nextTracks.end(), std::back_inserter(observedTracks));
+
+        scores[i] = std::make_pair(observedTracks.size(), candidates[i]);
+    }
+
+    // best views first, by view id for equal scores
+    std::sort(scores.begin(), scores.end(), [](const std::pair<std::size_t, IndexT>& a, const std::pair<std::size_t, IndexT>& b) {
+        return (a.first != b.first) ? (a.first > b.first) : (a.second < b.second);
+    });
+
+    std::vector<IndexT> bestViews;
+    for (const auto& score : scores)
+    {
+        if (score.first == 0 || bestViews.size() >= maxViewsPerGroup || score.first < minScoreRatio * scores.front().first)
         {
-            bestCount = observedTracks.size();
-            bestId = pV.first;
+            break;
         }
+
+        bestViews.push_back(score.second);
     }
 
-    return bestId;
+    return bestViews;
 }
 
-bool localizeNext(sfmData::SfMData& sfmData, const feature::FeaturesPerView & featuresPerView, const track::TracksPerView & tracksPerView, const track::TracksMap & trackMap, const IndexT newViewId)
+/**
+ * @brief Estimate the rotation of a view from its observations of the reconstructed tracks.
+ * @note The SfMData is not modified: the views of a group are localized in parallel.
+ * @return false if the rotation cannot be estimated
+ */
+bool localizeNext(const sfmData::SfMData& sfmData,
+                  const feature::FeaturesPerView& featuresPerView,
+                  const track::TracksPerView& tracksPerView,
+                  const track::TracksMap& trackMap,
+                  const std::vector<IndexT>& reconstructedTracks,
+                  const IndexT newViewId,
+                  RotationResection& resection)
 {
-     //Retrieve the set of tracks with an associated landmark
-    std::set<size_t> tracksWithPoint;
-    std::transform(sfmData.getLandmarks().begin(), sfmData.getLandmarks().end(), std::inserter(tracksWithPoint, tracksWithPoint.begin()), stl::RetrieveKey());
-
-    std::vector<size_t> nextTracks = tracksPerView.at(newViewId);
+    const std::vector<size_t>& nextTracks = tracksPerView.at(newViewId);
     std::vector<IndexT> observedTracks;
-    std::set_intersection(tracksWithPoint.begin(), tracksWithPoint.end(), nextTracks.begin(), nextTracks.end(), std::back_inserter(observedTracks));
-  
+    std::set_intersection(
+      reconstructedTracks.begin(), reconstructedTracks.end(), nextTracks.begin(), nextTracks.end(), std::back_inserter(observedTracks));
 
-    sfmData::Landmarks & landmarks = sfmData.getLandmarks();
+    const sfmData::Landmarks& landmarks = sfmData.getLandmarks();
 
     const sfmData::View& newView = sfmData.getView(newViewId);
-    std::shared_ptr<camera::IntrinsicBase> newViewIntrinsics = sfmData.getIntrinsicsharedPtr(newView.getIntrinsicId());
+    const camera::IntrinsicBase* newViewIntrinsics = sfmData.getIntrinsicPtr(newView.getIntrinsicId());
     const feature::MapFeaturesPerDesc& newViewFeaturesPerDesc = featuresPerView.getFeaturesPerDesc(newViewId);
 
     Mat refX(3, observedTracks.size());
@@ -245,99 +304,131 @@ bool localizeNext(sfmData::SfMData& sfmData, const feature::FeaturesPerView & fe
     int pos = 0;
     for (IndexT trackId : observedTracks)
     {
-        const track::Track & track = trackMap.at(trackId);
+        const track::Track& track = trackMap.at(trackId);
 
         const feature::PointFeatures& newViewFeatures = newViewFeaturesPerDesc.at(track.descType);
         IndexT newViewFeatureId = track.featPerView.at(newViewId).featureId;
         Vec2 nvV = newViewFeatures[newViewFeatureId].coords().cast<double>();
         Vec3 camP = newViewIntrinsics->toUnitSphere(newViewIntrinsics->ima2cam(newViewIntrinsics->get_ud_pixel(nvV)));
-    
+
         refX.col(pos) = landmarks.at(trackId).X;
         newX.col(pos) = camP;
 
         pos++;
     }
 
-    Mat3 R;
     std::vector<size_t> vecInliers;
     const size_t minInliers = 35;
     std::mt19937 randomNumberGenerator(0);
-    const bool relativeSuccess = robustRotation(R, vecInliers, refX, newX, randomNumberGenerator, 1024, minInliers);
-    if(!relativeSuccess)
+    const bool relativeSuccess = robustRotation(resection.R, vecInliers, refX, newX, randomNumberGenerator, 1024, minInliers);
+    if (!relativeSuccess)
     {
         return false;
     }
 
-    //Assign pose
-    sfmData.setPose(newView, sfmData::CameraPose(geometry::Pose3(R,Vec3::Zero())));
+    ALICEVISION_LOG_DEBUG("View " << newViewId << " localized with " << vecInliers.size() << " inliers.");
+
+    resection.inlierTracks.clear();
+    for (size_t inlier : vecInliers)
+    {
+        resection.inlierTracks.push_back(observedTracks[inlier]);
+    }
 
-    std::cout << vecInliers.size() << std::endl;
+    return true;
+}
+
+/**
+ * @brief Set the pose of a localized view and add its inlier observations to the landmarks.
+ */
+void addLocalizedView(sfmData::SfMData& sfmData,
+                      const feature::FeaturesPerView& featuresPerView,
+                      const track::TracksMap& trackMap,
+                      const IndexT newViewId,
+                      const RotationResection& resection)
+{
+    const sfmData::View& newView = sfmData.getView(newViewId);
+    const feature::MapFeaturesPerDesc& newViewFeaturesPerDesc = featuresPerView.getFeaturesPerDesc(newViewId);
+    sfmData::Landmarks& landmarks = sfmData.getLandmarks();
 
-    //Add observations
-    for (size_t pos : vecInliers)
+    // Assign pose
+    sfmData.setPose(newView, sfmData::CameraPose(geometry::Pose3(resection.R, Vec3::Zero())));
+
+    // Add observations
+    for (IndexT trackId : resection.inlierTracks)
     {
-        IndexT trackId = observedTracks[pos];
-        const track::Track & track = trackMap.at(trackId);
+        const track::Track& track = trackMap.at(trackId);
         const feature::PointFeatures& newViewFeatures = newViewFeaturesPerDesc.at(track.descType);
         IndexT newViewFeatureId = track.featPerView.at(newViewId).featureId;
-        auto & feat = newViewFeatures[newViewFeatureId];
+        auto& feat = newViewFeatures[newViewFeatureId];
         landmarks[trackId].observations[newViewId] = sfmData::Observation(feat.coords().cast<double>(), newViewFeatureId, feat.scale());
     }
-
-    return true;
 }
 
-bool addPoints(sfmData::SfMData& sfmData, const feature::FeaturesPerView & featuresPerView, const track::TracksPerView & tracksPerView, const track::TracksMap & trackMap, const IndexT newViewId)
+bool addPoints(sfmData::SfMData& sfmData,
+               const feature::FeaturesPerView& featuresPerView,
+               const track::TracksPerView& tracksPerView,
+               const track::TracksMap& trackMap,
+               const IndexT newViewId)
 {
-    sfmData::Landmarks & landmarks = sfmData.getLandmarks();
+    sfmData::Landmarks& landmarks = sfmData.getLandmarks();
 
-    std::set<size_t> tracksWithPoint;
-    std::transform(landmarks.begin(), landmarks.end(), std::inserter(tracksWithPoint, tracksWithPoint.begin()), stl::RetrieveKey());
+    const std::vector<IndexT> tracksWithPoint = getReconstructedTracks(sfmData);
 
-    std::vector<size_t> nextTracks = tracksPerView.at(newViewId);
+    const std::vector<size_t>& nextTracks = tracksPerView.at(newViewId);
     std::vector<size_t> nextTracksNotReconstructed;
 
-    std::set_difference(nextTracks.begin(), nextTracks.end(), tracksWithPoint.begin(), tracksWithPoint.end(), std::back_inserter(nextTracksNotReconstructed));
+    std::set_difference(
+      nextTracks.begin(), nextTracks.end(), tracksWithPoint.begin(), tracksWithPoint.end(), std::back_inserter(nextTracksNotReconstructed));
 
     const sfmData::View& newView = sfmData.getView(newViewId);
-    std::shared_ptr<camera::IntrinsicBase> newViewIntrinsics = sfmData.getIntrinsicsharedPtr(newView.getIntrinsicId());
+    const camera::IntrinsicBase* newViewIntrinsics = sfmData.getIntrinsicPtr(newView.getIntrinsicId());
     const feature::MapFeaturesPerDesc& newViewFeaturesPerDesc = featuresPerView.getFeaturesPerDesc(newViewId);
     const Eigen::Matrix3d new_R_world = sfmData.getPose(newView).getTransform().rotation();
 
-    //For all reconstructed views
-    for (auto & pV : sfmData.getViews())
+    std::vector<IndexT> reconstructedViews;
+    for (const auto& pV : sfmData.getViews())
     {
-        if (!sfmData.isPoseAndIntrinsicDefined(pV.first))
+        if (sfmData.isPoseAndIntrinsicDefined(pV.first))
         {
-            continue;
+            reconstructedViews.push_back(pV.first);
         }
+    }
 
-        std::vector<size_t> refTracks = tracksPerView.at(pV.first);
+    // the new landmarks are created in parallel for each reconstructed view,
+    // then added in the order of the views (a landmark seen by several views is the one of the last view)
+    std::vector<std::vector<std::pair<IndexT, sfmData::Landmark>>> newLandmarksPerView(reconstructedViews.size());
+
+#pragma omp parallel for schedule(dynamic)
+    for (int i = 0; i < static_cast<int>(reconstructedViews.size()); ++i)
+    {
+        const IndexT refViewId = reconstructedViews[i];
+        const std::vector<size_t>& refTracks = tracksPerView.at(refViewId);
 
         std::vector<IndexT> observedTracks;
-        std::set_intersection(refTracks.begin(), refTracks.end(), nextTracksNotReconstructed.begin(), nextTracksNotReconstructed.end(), std::back_inserter(observedTracks));
+        std::set_intersection(
+          refTracks.begin(), refTracks.end(), nextTracksNotReconstructed.begin(), nextTracksNotReconstructed.end(), std::back_inserter(observedTracks));
 
-        const sfmData::View& refView = sfmData.getView(pV.first);
+        const sfmData::View& refView = sfmData.getView(refViewId);
 
         const Eigen::Matrix3d ref_R_world = sfmData.getPose(refView).getTransform().rotation();
-        std::shared_ptr<camera::IntrinsicBase> refViewIntrinsics = sfmData.getIntrinsicsharedPtr(refView.getIntrinsicId());
-        const feature::MapFeaturesPerDesc& refViewFeaturesPerDesc = featuresPerView.getFeaturesPerDesc(pV.first);
-        
+        const camera::IntrinsicBase* refViewIntrinsics = sfmData.getIntrinsicPtr(refView.getIntrinsicId());
+        const feature::MapFeaturesPerDesc& refViewFeaturesPerDesc = featuresPerView.getFeaturesPerDesc(refViewId);
+
         Eigen::Matrix3d world_R_new = new_R_world.transpose();
         Eigen::Matrix3d ref_R_new = ref_R_world * world_R_new;
 
         for (IndexT trackId : observedTracks)
         {
-            const track::Track & track = trackMap.at(trackId);
+            const track::Track& track = trackMap.at(trackId);
 
             const feature::PointFeatures& newViewFeatures = newViewFeaturesPerDesc.at(track.descType);
             const feature::PointFeatures& refViewFeatures = refViewFeaturesPerDesc.at(track.descType);
 
             IndexT newViewFeatureId = track.featPerView.at(newViewId).featureId;
-            IndexT refViewFeatureId = track.featPerView.at(pV.first).featureId;
+            IndexT refViewFeatureId = track.featPerView.at(refViewId).featureId;
 
-            auto & newFeat = newViewFeatures[newViewFeatureId];
-            auto & refFeat = refViewFeatures[refViewFeatureId];
+            auto& newFeat = newViewFeatures[newViewFeatureId];
+            auto& refFeat = refViewFeatures[refViewFeatureId];
 
             Vec2 newV = newFeat.coords().cast<double>();
             Vec2 refV = refFeat.coords().cast<double>();
@@ -347,7 +438,7 @@ bool addPoints(sfmData::SfMData& sfmData, const feature::FeaturesPerView & featu
 
             Vec2 newPix = refViewIntrinsics->cam2ima(refP.head(2) / refP(2));
             Vec2 refPix = refViewIntrinsics->get_ud_pixel(refV);
-            double dist = (newPix - newPix).norm();
+            double dist = (newPix - refPix).norm();
             if (dist > 4.0)
             {
                 continue;
@@ -355,16 +446,54 @@ bool addPoints(sfmData::SfMData& sfmData, const feature::FeaturesPerView & featu
 
             sfmData::Landmark l(track.descType);
             l.X = world_R_new * newP;
-            l.observations[newViewId] = sfmData::Observation(newV, newViewFeatureId, refViewFeatures[refViewFeatureId].scale());
-            l.observations[pV.first] = sfmData::Observation(refV, refViewFeatureId, newViewFeatures[newViewFeatureId].scale());
-            
-            landmarks[trackId] = l;
+            l.observations[newViewId] = sfmData::Observation(newV, newViewFeatureId, newFeat.scale());
+            l.observations[refViewId] = sfmData::Observation(refV, refViewFeatureId, refFeat.scale());
+
+            newLandmarksPerView[i].emplace_back(trackId, l);
+        }
+    }
+
+    for (const auto& newLandmarks : newLandmarksPerView)
+    {
+        for (const auto& newLandmark : newLandmarks)
+        {
+            landmarks[newLandmark.first] = newLandmark.second;
         }
     }
 
     return true;
 }
 
+/**
+ * @brief Rotation-only bundle adjustment of the neighbourhood of the new views.
+ * @note The local strategy is enabled above 100 poses, as in the sequential SfM.
+ */
+void localBundleAdjustment(sfmData::SfMData& sfmData,
+                           const std::shared_ptr<sfm::LocalBundleAdjustmentGraph>& localGraph,
+                           const track::TracksPerView& tracksPerView,
+                           const std::set<IndexT>& newViews)
+{
+    localGraph->updateGraphWithNewViews(sfmData, tracksPerView, newViews);
+
+    sfm::BundleAdjustmentSymbolicCeres::CeresOptions options(false);
+    const sfm::BundleAdjustment::ERefineOptions refineOptions =
+      sfm::BundleAdjustment::REFINE_ROTATION | sfm::BundleAdjustment::REFINE_STRUCTURE | sfm::BundleAdjustment::REFINE_STRUCTURE_AS_NORMALS;
+
+    sfm::BundleAdjustmentSymbolicCeres BA(options, 3);
+
+    if (sfmData.getPoses().size() > 100)
+    {
+        localGraph->computeGraphDistances(sfmData, newViews);
+        localGraph->convertDistancesToStates(sfmData);
+        BA.useLocalStrategyGraph(localGraph);
+    }
+
+    if (!BA.adjust(sfmData, refineOptions))
+    {
+        ALICEVISION_LOG_WARNING("Local bundle adjustment failed.");
+    }
+}
+
 int aliceVision_main(int argc, char** argv)
 {
     // command-line parameters
@@ -383,6 +512,9 @@ int aliceVision_main(int argc, char** argv)
 
     int randomSeed = std::mt19937::default_seed;
 
+    std::size_t maxViewsPerGroup = 16;
+    std::size_t localBAGraphDistanceLimit = 1;
+
     po::options_description requiredParams("Required parameters");
     requiredParams.add_options()
     ("input,i", po::value<std::string>(&sfmDataFilename)->required(), "SfMData file.")
@@ -392,9 +524,17 @@ int aliceVision_main(int argc, char** argv)
     ("featuresFolders,f", po::value<std::vector<std::string>>(&featuresFolders)->multitoken(), "Path to folder(s) containing the extracted features.")
     ("describerTypes,d", po::value<std::string>(&describerTypesName)->default_value(describerTypesName),feature::EImageDescriberType_informations().c_str());
 
+    po::options_description optionalParams("Optional parameters");
+    optionalParams.add_options()
+    ("maxViewsPerGroup", po::value<std::size_t>(&maxViewsPerGroup)->default_value(maxViewsPerGroup),
+     "Maximum number of views localized in parallel at each iteration.")
+    ("localBAGraphDistanceLimit", po::value<std::size_t>(&localBAGraphDistanceLimit)->default_value(localBAGraphDistanceLimit),
+     "Graph-distance limit of the views refined by the local bundle adjustment after each group of views.");
+
     CmdLine cmdline("AliceVision Nodal SfM");
 
     cmdline.add(requiredParams);
+    cmdline.add(optionalParams);
     if(!cmdline.execute(argc, argv))
     {
         return EXIT_FAILURE;
@@ -428,28 +568,23 @@ int aliceVision_main(int argc, char** argv)
 
     // Load tracks
     ALICEVISION_LOG_INFO("Load tracks");
-    std::ifstream tracksFile(tracksFilename);
-    if(tracksFile.is_open() == false)
+    // the tracks per view are read from a binary tracks file, computed for a JSON one
+    track::TracksMap mapTracks;
+    track::TracksPerView mapTracksPerView;
+    if(!track::loadTracks(mapTracks, mapTracksPerView, tracksFilename))
     {
         ALICEVISION_LOG_ERROR("The input tracks file '" + tracksFilename + "' cannot be read.");
         return EXIT_FAILURE;
     }
-    std::stringstream buffer;
-    buffer << tracksFile.rdbuf();
-    boost::json::value jv = boost::json::parse(buffer.str());
-    track::TracksMap mapTracks(track::flat_map_value_to<track::Track>(jv));
 
     // We have loaded a list of tracks
     // A track is a list of observations per view of (we think) a same point.
-    // For easier access, and for eah view we build a list of tracks observed in this view
-    ALICEVISION_LOG_INFO("Estimate tracks per view");
-    track::TracksPerView mapTracksPerView;
+    // For easier access, and for eah view we have a list of tracks observed in this view
     for(const auto& viewIt : sfmData.getViews())
     {
-        // create an entry in the map
+        // create an entry in the map for the views without tracks
         mapTracksPerView[viewIt.first];
     }
-    track::computeTracksPerView(mapTracks, mapTracksPerView);
 
 
     // Because the reconstructed pairs information was processed in chunks
@@ -494,28 +629,66 @@ int aliceVision_main(int argc, char** argv)
     //Using two views, create an initial map and pair of cameras
     buildInitialWorld(sfmData, featuresPerView, reconstructedPairs[0], mapTracksPerView, mapTracks);
 
+    // Graph of the local bundle adjustments, initialized with the two views of the initial map
+    std::shared_ptr<sfm::LocalBundleAdjustmentGraph> localGraph = std::make_shared<sfm::LocalBundleAdjustmentGraph>(sfmData);
+    localGraph->setGraphDistanceLimit(localBAGraphDistanceLimit);
+    localGraph->updateGraphWithNewViews(sfmData, mapTracksPerView, {reconstructedPairs[0].reference, reconstructedPairs[0].next});
+
     //Loop until termination of the process using the current boostrapped map
+    //The views which cannot be localized are retried once the map has been extended by other views
     std::set<IndexT> visited;
-    while (1)
+    while (true)
     {
-        //Find the optimal next view to localize
-        IndexT next = findBestNext(sfmData, featuresPerView, mapTracksPerView, mapTracks, visited);
-        if (next == UndefinedIndexT)
+        const std::vector<IndexT> reconstructedTracks = getReconstructedTracks(sfmData);
+
+        //Find the optimal next views to localize
+        const std::vector<IndexT> nextViews = findBestNextViews(sfmData, mapTracksPerView, reconstructedTracks, visited, maxViewsPerGroup);
+        if (nextViews.empty())
         {
             break;
         }
 
-        //Localize the selected view
-        if (!localizeNext(sfmData, featuresPerView, mapTracksPerView, mapTracks, next))
+        //Localize the selected views in parallel, with respect to the current map
+        std::vector<RotationResection> resections(nextViews.size());
+        std::vector<char> localized(nextViews.size(), 0);
+
+#pragma omp parallel for schedule(dynamic)
+        for (int i = 0; i < static_cast<int>(nextViews.size()); ++i)
         {
-            break;
+            localized[i] = localizeNext(sfmData, featuresPerView, mapTracksPerView, mapTracks, reconstructedTracks, nextViews[i], resections[i]);
+        }
+
+        std::set<IndexT> newViews;
+        for (std::size_t i = 0; i < nextViews.size(); ++i)
+        {
+            if (!localized[i])
+            {
+                visited.insert(nextViews[i]);
+                continue;
+            }
+
+            addLocalizedView(sfmData, featuresPerView, mapTracks, nextViews[i], resections[i]);
+            newViews.insert(nextViews[i]);
+        }
+
+        if (newViews.empty())
+        {
+            continue;
         }
 
         //Add points to the map in the frame of the first bootstrapping camera
-        if (!addPoints(sfmData, featuresPerView, mapTracksPerView, mapTracks, next))
+        for (IndexT newViewId : newViews)
         {
-            break;
+            addPoints(sfmData, featuresPerView, mapTracksPerView, mapTracks, newViewId);
         }
+
+        //Refine the rotations around the new views
+        localBundleAdjustment(sfmData, localGraph, mapTracksPerView, newViews);
+
+        ALICEVISION_LOG_INFO(newViews.size() << " new views localized (" << sfmData.getPoses().size() << "/" << sfmData.getViews().size()
+                                             << " views, " << sfmData.getLandmarks().size() << " landmarks).");
+
+        visited.clear();
     }
 
 
@@ -534,7 +707,7 @@ int aliceVision_main(int argc, char** argv)
         sfm::BundleAdjustmentSymbolicCeres BA(options, 3);
         const bool success = BA.adjust(sfmData, refineOptions);
         countRemoved = sfm::RemoveOutliers_PixelResidualError(sfmData, sfm::EFeatureConstraint::SCALE, 2.0, 2);
-        std::cout << countRemoved << std::endl;
+        ALICEVISION_LOG_INFO(countRemoved << " outliers removed.");
     }
     while (countRemoved > 0);
 
@@ -8,9 +8,13 @@
 #include <aliceVision/panorama/compositer.hpp>
 #include <aliceVision/panorama/alphaCompositer.hpp>
 #include <aliceVision/panorama/laplacianCompositer.hpp>
+#include <aliceVision/panorama/remapBbox.hpp>
+#include <aliceVision/panorama/warper.hpp>
+#include <aliceVision/panorama/seams.hpp>
 
 // Input and geometry
 #include <aliceVision/sfmData/SfMData.hpp>
+#include <aliceVision/sfmData/uid.hpp>
 #include <aliceVision/sfmDataIO/sfmDataIO.hpp>
 
 // Image
@@ -19,6 +23,8 @@
 
 // System
 #include <aliceVision/system/Logger.hpp>
+#include <aliceVision/system/MemoryBudget.hpp>
+#include <aliceVision/gpu/gpu.hpp>
 
 // Reading command line options
 #include <boost/program_options.hpp>
@@ -31,6 +37,7 @@
 // IO
 #include <fstream>
 #include <algorithm>
+#include <atomic>
 #include <boost/property_tree/ptree.hpp>
 #include <boost/property_tree/json_parser.hpp>
 #include <boost/filesystem.hpp>
@@ -38,7 +45,7 @@
 // These constants define the current software version.
 // They must be updated when the command line is changed.
 #define ALICEVISION_SOFTWARE_VERSION_MAJOR 1
-#define ALICEVISION_SOFTWARE_VERSION_MINOR 0
+#define ALICEVISION_SOFTWARE_VERSION_MINOR 2
 
 using namespace aliceVision;
 
@@ -75,7 +82,301 @@ size_t getCompositingOptimalScale(int width, int height)
     return optimal_scale;
 }
 
-std::unique_ptr<PanoramaMap> buildMap(const sfmData::SfMData& sfmData, const std::string& inputPath,
+/**
+ * @brief Warped inputs of the compositing: the warped colors, mask and weights of each view and their place in the panorama
+ */
+class WarpedInputs
+{
+  public:
+    virtual ~WarpedInputs() = default;
+
+    /**
+     * @brief Get the place of a warped view in the panorama
+     * @param[out] bbox the bounding box of the warped view
+     * @param[out] panoramaSize the size of the panorama
+     */
+    virtual bool getBoundingBox(BoundingBox& bbox, std::pair<int, int>& panoramaSize, IndexT viewId) const = 0;
+
+    /**
+     * @brief Get the warped images of a view
+     * @param[out] colors the warped colors, not computed if nullptr
+     * @param[out] mask the valid pixels
+     * @param[out] weights the weights of the pixels, not computed if nullptr
+     */
+    virtual bool load(IndexT viewId, image::Image<image::RGBfColor>* colors, image::Image<unsigned char>& mask, image::Image<float>* weights) const = 0;
+
+    /**
+     * @brief Get the metadata of the warped colors of a view
+     */
+    virtual oiio::ParamValueList getMetadata(IndexT viewId) const = 0;
+};
+
+/**
+ * @brief Warped images written by panoramaWarping
+ */
+class WarpedFiles : public WarpedInputs
+{
+  public:
+    WarpedFiles(const sfmData::SfMData& sfmData, const std::string& warpingFolder)
+      : _sfmData(sfmData),
+        _warpingFolder(warpingFolder)
+    {}
+
+    bool getBoundingBox(BoundingBox& bbox, std::pair<int, int>& panoramaSize, IndexT viewId) const override
+    {
+        const std::string maskPath = getPath(viewId, "_mask.exr");
+        ALICEVISION_LOG_TRACE("Load metadata of mask with path " << maskPath);
+
+        int width = 0;
+        int height = 0;
+        oiio::ParamValueList metadata = image::readImageMetadata(maskPath, width, height);
+
+        bbox.left = metadata.find("AliceVision:offsetX")->get_int();
+        bbox.top = metadata.find("AliceVision:offsetY")->get_int();
+        bbox.width = width;
+        bbox.height = height;
+        panoramaSize.first = metadata.find("AliceVision:panoramaWidth")->get_int();
+        panoramaSize.second = metadata.find("AliceVision:panoramaHeight")->get_int();
+
+        return true;
+    }
+
+    bool load(IndexT viewId, image::Image<image::RGBfColor>* colors, image::Image<unsigned char>& mask, image::Image<float>* weights) const override
+    {
+        if(colors)
+        {
+            const std::string imagePath = getPath(viewId, ".exr");
+            ALICEVISION_LOG_TRACE("Load image with path " << imagePath);
+            image::readImage(imagePath, *colors, image::EImageColorSpace::NO_CONVERSION);
+        }
+
+        const std::string maskPath = getPath(viewId, "_mask.exr");
+        ALICEVISION_LOG_TRACE("Load mask with path " << maskPath);
+        image::readImageDirect(maskPath, mask);
+
+        if(weights)
+        {
+            const std::string weightsPath = getPath(viewId, "_weight.exr");
+            ALICEVISION_LOG_TRACE("Load weights with path " << weightsPath);
+            image::readImage(weightsPath, *weights, image::EImageColorSpace::NO_CONVERSION);
+        }
+
+        return true;
+    }
+
+    oiio::ParamValueList getMetadata(IndexT viewId) const override { return image::readImageMetadata(getPath(viewId, ".exr")); }
+
+  private:
+    std::string getPath(IndexT viewId, const std::string& suffix) const
+    {
+        const std::string warpedPath = _sfmData.getViews().at(viewId)->getImage().getMetadata().at("AliceVision:warpedPath");
+        return (fs::path(_warpingFolder) / (warpedPath + suffix)).string();
+    }
+
+    const sfmData::SfMData& _sfmData;
+    const std::string _warpingFolder;
+};
+
+/**
+ * @brief Views warped in memory from the source images when they are needed, same images as panoramaWarping
+ */
+class FusedWarping : public WarpedInputs
+{
+  public:
+    FusedWarping(const sfmData::SfMData& sfmData,
+                 const std::map<IndexT, BoundingBox>& boxes,
+                 const std::pair<int, int>& panoramaSize,
+                 int tileSize,
+                 image::EImageColorSpace workingColorSpace,
+                 bool clampHalf)
+      : _sfmData(sfmData),
+        _boxes(boxes),
+        _panoramaSize(panoramaSize),
+        _tileSize(tileSize),
+        _workingColorSpace(workingColorSpace),
+        _clampHalf(clampHalf)
+    {}
+
+    bool getBoundingBox(BoundingBox& bbox, std::pair<int, int>& panoramaSize, IndexT viewId) const override
+    {
+        bbox = _boxes.at(viewId);
+        panoramaSize = _panoramaSize;
+
+        return true;
+    }
+
+    bool load(IndexT viewId, image::Image<image::RGBfColor>* colors, image::Image<unsigned char>& mask, image::Image<float>* weights) const override
+    {
+        const sfmData::View& view = *_sfmData.getViews().at(viewId);
+        const geometry::Pose3 camPose = _sfmData.getPose(view).getTransform();
+        const camera::IntrinsicBase& intrinsic = *_sfmData.getIntrinsicPtr(view.getIntrinsicId());
+
+        // The source pyramid is only needed for the colors
+        std::unique_ptr<GaussianPyramidNoMask> pyramid;
+        if(colors)
+        {
+            const std::string imagePath = view.getImage().getImagePath();
+            ALICEVISION_LOG_TRACE("Load image with path " << imagePath);
+            image::Image<image::RGBfColor> source;
+            image::readImage(imagePath, source, _workingColorSpace);
+
+            pyramid.reset(new GaussianPyramidNoMask(source.Width(), source.Height()));
+            if(!pyramid->process(std::move(source)))
+            {
+                ALICEVISION_LOG_ERROR("Problem creating pyramid.");
+                return false;
+            }
+        }
+
+        image::Image<image::RGBfColor> unusedColors;
+        image::Image<float> unusedWeights;
+
+        return warpRegion(colors ? *colors : unusedColors,
+                          mask,
+                          weights ? *weights : unusedWeights,
+                          pyramid.get(),
+                          _boxes.at(viewId),
+                          _panoramaSize,
+                          camPose,
+                          intrinsic,
+                          _tileSize,
+                          _clampHalf);
+    }
+
+    oiio::ParamValueList getMetadata(IndexT viewId) const override
+    {
+        const sfmData::View& view = *_sfmData.getViews().at(viewId);
+        const BoundingBox& bbox = _boxes.at(viewId);
+
+        // Same metadata as the warped images of panoramaWarping
+        oiio::ParamValueList metadata = image::readImageMetadata(view.getImage().getImagePath());
+        metadata.push_back(oiio::ParamValue("AliceVision:offsetX", bbox.left));
+        metadata.push_back(oiio::ParamValue("AliceVision:offsetY", bbox.top));
+        metadata.push_back(oiio::ParamValue("AliceVision:panoramaWidth", _panoramaSize.first));
+        metadata.push_back(oiio::ParamValue("AliceVision:panoramaHeight", _panoramaSize.second));
+        metadata.push_back(oiio::ParamValue("AliceVision:tileSize", _tileSize));
+        if(_workingColorSpace != image::EImageColorSpace::NO_CONVERSION)
+        {
+            metadata.add_or_replace(oiio::ParamValue("AliceVision:ColorSpace", image::EImageColorSpace_enumToString(_workingColorSpace)));
+        }
+        metadata.remove("Orientation");
+        metadata.remove("orientation");
+
+        return metadata;
+    }
+
+  private:
+    const sfmData::SfMData& _sfmData;
+    const std::map<IndexT, BoundingBox> _boxes;
+    const std::pair<int, int> _panoramaSize;
+    const int _tileSize;
+    const image::EImageColorSpace _workingColorSpace;
+    const bool _clampHalf;
+};
+
+/**
+ * @brief Replace the views by one view per warped image, with the same ids and metadata as the views created by panoramaSeams
+ * @param[in,out] sfmData the scene
+ * @param[out] boxes the bounding box of each new view in the panorama
+ */
+void buildFusedViews(sfmData::SfMData& sfmData, std::map<IndexT, BoundingBox>& boxes, const std::pair<int, int>& panoramaSize, int tileSize)
+{
+    boxes.clear();
+
+    auto copyviews = sfmData.getViews();
+    sfmData.getViews().clear();
+
+    for(const auto& pv : copyviews)
+    {
+        if(!sfmData.isPoseAndIntrinsicDefined(pv.second.get()))
+        {
+            continue;
+        }
+
+        const geometry::Pose3 camPose = sfmData.getPose(*pv.second).getTransform();
+        const camera::IntrinsicBase& intrinsic = *sfmData.getIntrinsicPtr(pv.second->getIntrinsicId());
+
+        std::vector<BoundingBox> warpedBoxes;
+        if(!computeWarpedBoundingBoxes(warpedBoxes, panoramaSize, camPose, intrinsic, tileSize))
+        {
+            continue;
+        }
+
+        for(int idx = 0; idx < warpedBoxes.size(); idx++)
+        {
+            std::shared_ptr<sfmData::View> newView(pv.second->clone());
+
+            newView->getImage().addMetadata("AliceVision:previousViewId", std::to_string(pv.first));
+            newView->getImage().addMetadata("AliceVision:imageCounter", std::to_string(idx));
+            newView->getImage().addMetadata("AliceVision:warpedPath", std::to_string(pv.first) + "_" + std::to_string(idx));
+            const IndexT newIndex = sfmData::computeViewUID(*newView);
+
+            newView->setViewId(newIndex);
+            sfmData.getViews().emplace(newIndex, newView);
+            boxes[newIndex] = warpedBoxes[idx];
+        }
+    }
+}
+
+/**
+ * @brief Compute the winner-take-all labels of the views, as panoramaSeams without graphcut
+ */
+bool computeWTALabels(image::Image<IndexT>& labels, const sfmData::SfMData& sfmData, const WarpedInputs& inputs, int maxPanoramaWidth)
+{
+    ALICEVISION_LOG_INFO("Estimating initial labels for panorama");
+
+    std::unique_ptr<WTASeams> seams;
+    int downscale = 1;
+
+    for(const auto& viewIt : sfmData.getViews())
+    {
+        const IndexT viewId = viewIt.first;
+        if(!sfmData.isPoseAndIntrinsicDefined(viewId))
+            continue;
+
+        BoundingBox bbox;
+        std::pair<int, int> panoramaSize;
+        if(!inputs.getBoundingBox(bbox, panoramaSize, viewId))
+        {
+            return false;
+        }
+
+        if(!seams)
+        {
+            downscale = divideRoundUp(panoramaSize.first, maxPanoramaWidth);
+            seams.reset(new WTASeams(panoramaSize.first / downscale, panoramaSize.second / downscale));
+        }
+
+        image::Image<unsigned char> mask;
+        image::Image<float> weights;
+        if(!inputs.load(viewId, nullptr, mask, &weights))
+        {
+            return false;
+        }
+
+        if(downscale > 1)
+        {
+            imageAlgo::resizeImage(downscale, mask);
+            imageAlgo::resizeImage(downscale, weights);
+        }
+
+        if(!seams->appendWithLoop(mask, weights, viewId, bbox.left / downscale, bbox.top / downscale))
+        {
+            return false;
+        }
+    }
+
+    if(!seams)
+    {
+        return false;
+    }
+
+    labels = seams->getLabels();
+
+    return true;
+}
+
+std::unique_ptr<PanoramaMap> buildMap(const sfmData::SfMData& sfmData, const WarpedInputs& inputs,
                                       const size_t borderSize, size_t forceMinPyramidLevels)
 {
     if(sfmData.getViews().empty())
@@ -85,38 +386,22 @@ std::unique_ptr<PanoramaMap> buildMap(const sfmData::SfMData& sfmData, const std
 
     size_t max_scale = 0;
     std::vector<std::pair<IndexT, BoundingBox>> listBoundingBox;
-    std::pair<std::size_t, std::size_t> panoramaSize;
+    std::pair<int, int> panoramaSize;
 
     for(const auto& viewIt : sfmData.getViews())
     {
         if(!sfmData.isPoseAndIntrinsicDefined(viewIt.first))
             continue;
 
-        const std::string warpedPath = viewIt.second->getImage().getMetadata().at("AliceVision:warpedPath");
-
-        // Load mask
-        const std::string maskPath = (fs::path(inputPath) / (warpedPath + "_mask.exr")).string();
-        ALICEVISION_LOG_TRACE("Load metadata of mask with path " << maskPath);
-
-        int width = 0;
-        int height = 0;
-        oiio::ParamValueList metadata = image::readImageMetadata(maskPath, width, height);
-        const int offsetX = metadata.find("AliceVision:offsetX")->get_int();
-        const int offsetY = metadata.find("AliceVision:offsetY")->get_int();
-        panoramaSize.first = metadata.find("AliceVision:panoramaWidth")->get_int();
-        panoramaSize.second = metadata.find("AliceVision:panoramaHeight")->get_int();
-
         BoundingBox bb;
-        bb.left = offsetX;
-        bb.top = offsetY;
-        bb.width = width;
-        bb.height = height;
+        if(!inputs.getBoundingBox(bb, panoramaSize, viewIt.first))
+            continue;
 
         if(viewIt.first == 0)
             continue;
 
         listBoundingBox.push_back(std::make_pair(viewIt.first, bb));
-        size_t scale = getCompositingOptimalScale(width, height);
+        size_t scale = getCompositingOptimalScale(bb.width, bb.height);
         if(scale > max_scale)
         {
             max_scale = scale;
@@ -140,10 +425,57 @@ std::unique_ptr<PanoramaMap> buildMap(const sfmData::SfMData& sfmData, const std
     return ret;
 }
 
+/**
+ * @brief Estimate the memory used by processImage for one output region, from its overlaps in the panorama map
+ */
+size_t estimateProcessImageMemory(const PanoramaMap& panoramaMap, const std::string& compositerType, const BoundingBox& referenceBoundingBox)
+{
+    // Compositer buffers
+    size_t memory = size_t(referenceBoundingBox.area()) * sizeof(image::RGBAfColor);
+    if(compositerType == "multiband")
+    {
+        // Same enlarged bounding box as processImage
+        BoundingBox panoramaBoundingBox = referenceBoundingBox.divide(panoramaMap.getScale())
+                                              .dilate(panoramaMap.getBorderSize())
+                                              .multiply(panoramaMap.getScale());
+        panoramaBoundingBox.clampTop();
+        panoramaBoundingBox.clampBottom(panoramaMap.getHeight());
+
+        // All the levels of the pyramid (4/3 of the base level) with their weights
+        memory += size_t(panoramaBoundingBox.area()) * (sizeof(image::RGBfColor) + sizeof(float)) * 4 / 3;
+    }
+    else if(compositerType == "alpha")
+    {
+        memory += size_t(referenceBoundingBox.area()) * sizeof(image::RGBAfColor);
+    }
+
+    // Visibility map and seams labels
+    memory += size_t(referenceBoundingBox.area()) * (sizeof(std::vector<IndexT>) + 2 * sizeof(IndexT));
+
+    // Largest input loaded with its cropped copy
+    std::vector<IndexT> overlappingViews;
+    if(panoramaMap.getOverlaps(overlappingViews, referenceBoundingBox))
+    {
+        size_t maxInputArea = 0;
+        for(IndexT viewCurrent : overlappingViews)
+        {
+            BoundingBox bbox;
+            if(panoramaMap.getBoundingBox(bbox, viewCurrent))
+            {
+                maxInputArea = std::max(maxInputArea, size_t(bbox.area()));
+            }
+        }
+
+        memory += maxInputArea * (sizeof(image::RGBfColor) + sizeof(unsigned char) + sizeof(float)) * 2;
+    }
+
+    return memory;
+}
+
 bool processImage(const PanoramaMap& panoramaMap, const sfmData::SfMData& sfmData, const std::string& compositerType,
-                  const std::string& warpingFolder, const std::string& labelsFilePath, const std::string& outputFolder,
+                  const WarpedInputs& inputs, const image::Image<IndexT>& panoramaLabels, const std::string& outputFolder,
                   const image::EStorageDataType& storageDataType, IndexT viewReference,
-                  const BoundingBox& referenceBoundingBox, bool showBorders, bool showSeams)
+                  const BoundingBox& referenceBoundingBox, bool showBorders, bool showSeams, bool useGpu)
 {
     // The laplacian pyramid must also contains some pixels outside of the bounding box to make sure
     // there is a continuity between all the "views" of the panorama.
@@ -167,7 +499,7 @@ bool processImage(const PanoramaMap& panoramaMap, const sfmData::SfMData& sfmDat
         panoramaBoundingBox.clampBottom(panoramaMap.getHeight());
 
         compositer = std::unique_ptr<Compositer>(
-            new LaplacianCompositer(panoramaBoundingBox.width, panoramaBoundingBox.height, panoramaMap.getScale()));
+            new LaplacianCompositer(panoramaBoundingBox.width, panoramaBoundingBox.height, panoramaMap.getScale(), useGpu));
     }
     else if(compositerType == "alpha")
     {
@@ -217,13 +549,13 @@ bool processImage(const PanoramaMap& panoramaMap, const sfmData::SfMData& sfmDat
     image::Image<std::vector<IndexT>> visiblePixels(globalUnionBoundingBox.width, globalUnionBoundingBox.height, true);
     for(IndexT viewCurrent : overlappingViews)
     {
-        const std::string warpedPath = sfmData.getViews().at(viewCurrent)->getImage().getMetadata().at("AliceVision:warpedPath");
-
         // Load mask
-        const std::string maskPath = (fs::path(warpingFolder) / (warpedPath + "_mask.exr")).string();
-        ALICEVISION_LOG_TRACE("Load mask with path " << maskPath);
         image::Image<unsigned char> mask;
-        image::readImageDirect(maskPath, mask);
+        if(!inputs.load(viewCurrent, nullptr, mask, nullptr))
+        {
+            ALICEVISION_LOG_ERROR("Error loading mask");
+            return false;
+        }
 
         // Compute list of intersection between this view and the reference view
         std::vector<BoundingBox> intersections;
@@ -271,9 +603,6 @@ bool processImage(const PanoramaMap& panoramaMap, const sfmData::SfMData& sfmDat
     image::Image<IndexT> referenceLabels;
     if(needSeams)
     {
-        image::Image<IndexT> panoramaLabels;
-        image::readImageDirect(labelsFilePath, panoramaLabels);
-
         const double scaleX = double(panoramaLabels.Width()) / double(panoramaMap.getWidth());
         const double scaleY = double(panoramaLabels.Height()) / double(panoramaMap.getHeight());
 
@@ -396,10 +725,7 @@ bool processImage(const PanoramaMap& panoramaMap, const sfmData::SfMData& sfmDat
     oiio::ParamValueList srcMetadata;
     if(!overlappingViews.empty())
     {
-        const std::string warpedPath =
-            sfmData.getViews().at(overlappingViews[0])->getImage().getMetadata().at("AliceVision:warpedPath");
-        const std::string firstImagePath = (fs::path(warpingFolder) / (warpedPath + ".exr")).string();
-        srcMetadata = image::readImageMetadata(firstImagePath);
+        srcMetadata = inputs.getMetadata(overlappingViews[0]);
         colorSpace = srcMetadata.get_string("AliceVision:ColorSpace", "Linear");
     }
 
@@ -412,8 +738,6 @@ bool processImage(const PanoramaMap& panoramaMap, const sfmData::SfMData& sfmDat
             continue;
         }
 
-        const std::string warpedPath = sfmData.getViews().at(viewCurrent)->getImage().getMetadata().at("AliceVision:warpedPath");
-
         ALICEVISION_LOG_INFO("Processing input " << posCurrent << "/" << overlappingViews.size());
 
         // Compute list of intersection between this view and the reference view
@@ -440,25 +764,15 @@ bool processImage(const PanoramaMap& panoramaMap, const sfmData::SfMData& sfmDat
             const BoundingBox& bbox = currentBoundingBoxes[indexIntersection];
             const BoundingBox& bboxIntersect = intersections[indexIntersection];
 
-            // Load image
-            const std::string imagePath = (fs::path(warpingFolder) / (warpedPath + ".exr")).string();
-            ALICEVISION_LOG_TRACE("Load image with path " << imagePath);
+            // Load image, mask and weights image if needed
             image::Image<image::RGBfColor> source;
-            image::readImage(imagePath, source, image::EImageColorSpace::NO_CONVERSION);
-
-            // Load mask
-            const std::string maskPath = (fs::path(warpingFolder) / (warpedPath + "_mask.exr")).string();
-            ALICEVISION_LOG_TRACE("Load mask with path " << maskPath);
             image::Image<unsigned char> mask;
-            image::readImageDirect(maskPath, mask);
-
-            // Load weights image if needed
             image::Image<float> weights;
-            if(needWeights)
+            if(!inputs.load(viewCurrent, &source, mask, needWeights ? &weights : nullptr))
             {
-                const std::string weightsPath = (fs::path(warpingFolder) / (warpedPath + "_weight.exr")).string();
-                ALICEVISION_LOG_TRACE("Load weights with path " << weightsPath);
-                image::readImage(weightsPath, weights, image::EImageColorSpace::NO_CONVERSION);
+                ALICEVISION_LOG_ERROR("Error loading input");
+                hasFailed = true;
+                continue;
             }
 
             if(needSeams)
@@ -569,12 +883,11 @@ bool processImage(const PanoramaMap& panoramaMap, const sfmData::SfMData& sfmDat
             }
 
             // Load mask
-            const std::string warpedPath =
-                sfmData.getViews().at(viewCurrent)->getImage().getMetadata().at("AliceVision:warpedPath");
-            const std::string maskPath = (fs::path(warpingFolder) / (warpedPath + "_mask.exr")).string();
-            ALICEVISION_LOG_TRACE("Load mask with path " << maskPath);
             image::Image<unsigned char> mask;
-            image::readImageDirect(maskPath, mask);
+            if(!inputs.load(viewCurrent, nullptr, mask, nullptr))
+            {
+                continue;
+            }
 
             for(int indexIntersection = 0; indexIntersection < intersections.size(); indexIntersection++)
             {
@@ -642,13 +955,19 @@ int aliceVision_main(int argc, char** argv)
     bool showBorders = false;
     bool showSeams = false;
     bool useTiling = true;
+    bool useGpu = false;
+    bool fusedWarping = false;
+    int panoramaWidth = 0;
+    int tileSize = 256;
+    std::string outputSfmFilepath;
+    std::string warpedOutputFolder;
 
     image::EStorageDataType storageDataType = image::EStorageDataType::Float;
+    image::EImageColorSpace workingColorSpace = image::EImageColorSpace::LINEAR;
 
     // Description of mandatory parameters
     po::options_description requiredParams("Required parameters");
     requiredParams.add_options()("input,i", po::value<std::string>(&sfmDataFilepath)->required(), "Input sfmData.")(
-        "warpingFolder,w", po::value<std::string>(&warpingFolder)->required(), "Folder with warped images.")(
         "output,o", po::value<std::string>(&outputFolder)->required(), "Path of the output panorama.");
 
     // Description of optional parameters
@@ -662,8 +981,21 @@ int aliceVision_main(int argc, char** argv)
         ("rangeIteration", po::value<int>(&rangeIteration)->default_value(rangeIteration), "Range chunk id.")
         ("rangeSize", po::value<int>(&rangeSize)->default_value(rangeSize), "Range size.")
         ("maxThreads", po::value<int>(&maxThreads)->default_value(maxThreads), "max number of threads to use.")
-        ("labels,l", po::value<std::string>(&labelsFilepath)->required(), "Labels image from seams estimation.")
-        ("useTiling,n", po::value<bool>(&useTiling)->default_value(useTiling), "use tiling for compositing.");
+        ("warpingFolder,w", po::value<std::string>(&warpingFolder)->default_value(warpingFolder), "Folder with warped images (not used with fused warping).")
+        ("labels,l", po::value<std::string>(&labelsFilepath)->default_value(labelsFilepath), "Labels image from seams estimation (not used with fused warping).")
+        ("useTiling,n", po::value<bool>(&useTiling)->default_value(useTiling), "use tiling for compositing.")
+        ("useGpu", po::value<bool>(&useGpu)->default_value(useGpu), "For multiband compositer, build and collapse the pyramids on the GPU (requires a CUDA-Enabled GPU).")
+        ("fusedWarping", po::value<bool>(&fusedWarping)->default_value(fusedWarping),
+         "Warp the input images in memory instead of reading the images of the warping folder. "
+         "The input sfmData is then the input of the warping, and the multiband seams are the initial seams of the seams estimation (without graphcut).")
+        ("panoramaWidth", po::value<int>(&panoramaWidth)->default_value(panoramaWidth), "For fused warping, panorama width in pixels.")
+        ("tileSize", po::value<int>(&tileSize)->default_value(tileSize), "For fused warping, size of the warping tiles.")
+        ("workingColorSpace", po::value<image::EImageColorSpace>(&workingColorSpace)->default_value(workingColorSpace),
+         ("For fused warping, color space of the input images: " + image::EImageColorSpace_informations()).c_str())
+        ("outputSfm", po::value<std::string>(&outputSfmFilepath)->default_value(outputSfmFilepath),
+         "For fused warping, path of the output SfMData file with one view per composited image (input of the merging).")
+        ("warpedOutputFolder", po::value<std::string>(&warpedOutputFolder)->default_value(warpedOutputFolder),
+         "For fused warping, also write the warped images in this folder, for debugging.");
 
     CmdLine cmdline(
         "Performs the panorama stiching of warped images, with an option to use constraints from precomputed seams maps.\n"
@@ -684,6 +1016,12 @@ int aliceVision_main(int argc, char** argv)
     oiio::attribute("exr_threads", static_cast<int>(hwc.getMaxThreads()));
 
 
+    if(useGpu && compositerType == "multiband" && !gpu::gpuSupportCUDA(3, 0))
+    {
+        ALICEVISION_LOG_WARNING("No supported CUDA-Enabled GPU, the panorama is composited on the CPU.");
+        useGpu = false;
+    }
+
     if(overlayType == "borders" || overlayType == "all")
     {
         showBorders = true;
@@ -700,6 +1038,29 @@ int aliceVision_main(int argc, char** argv)
         return EXIT_FAILURE;
     }
 
+    if(fusedWarping)
+    {
+        if(panoramaWidth <= 0 || tileSize <= 0)
+        {
+            ALICEVISION_LOG_ERROR("Fused warping requires the panorama width and the tile size.");
+            return EXIT_FAILURE;
+        }
+    }
+    else
+    {
+        if(warpingFolder.empty())
+        {
+            ALICEVISION_LOG_ERROR("The folder with warped images is required.");
+            return EXIT_FAILURE;
+        }
+
+        if(compositerType == "multiband" && labelsFilepath.empty())
+        {
+            ALICEVISION_LOG_ERROR("The labels image is required by the multiband compositer.");
+            return EXIT_FAILURE;
+        }
+    }
+
     // load input scene
     sfmData::SfMData sfmData;
     if(!sfmDataIO::Load(sfmData, sfmDataFilepath,
@@ -711,6 +1072,19 @@ int aliceVision_main(int argc, char** argv)
 
     ALICEVISION_LOG_TRACE("Sfm data loaded");
 
+    // With fused warping, the warped views are built here, as the seams estimation does with the warped images
+    const std::pair<int, int> panoramaSize(panoramaWidth, panoramaWidth / 2);
+    std::map<IndexT, BoundingBox> fusedBoxes;
+    if(fusedWarping)
+    {
+        buildFusedViews(sfmData, fusedBoxes, panoramaSize, tileSize);
+
+        if(!outputSfmFilepath.empty() && rangeIteration <= 0)
+        {
+            sfmDataIO::Save(sfmData, outputSfmFilepath, sfmDataIO::ESfMData::ALL);
+        }
+    }
+
     std::set<std::string> uniquePreviousId;
     for(const auto pv : sfmData.getViews())
     {
@@ -772,9 +1146,20 @@ int aliceVision_main(int argc, char** argv)
         borderSize = 0;
     }
 
+    std::unique_ptr<WarpedInputs> inputs;
+    if(fusedWarping)
+    {
+        const bool clampHalf = (storageDataType == image::EStorageDataType::HalfFinite);
+        inputs.reset(new FusedWarping(sfmData, fusedBoxes, panoramaSize, tileSize, workingColorSpace, clampHalf));
+    }
+    else
+    {
+        inputs.reset(new WarpedFiles(sfmData, warpingFolder));
+    }
+
     // Build the map of inputs in the final panorama
     // This is mostly meant to compute overlaps between inputs
-    std::unique_ptr<PanoramaMap> panoramaMap = buildMap(sfmData, warpingFolder, borderSize, forceMinPyramidLevels);
+    std::unique_ptr<PanoramaMap> panoramaMap = buildMap(sfmData, *inputs, borderSize, forceMinPyramidLevels);
     if(viewsCount == 0)
     {
         ALICEVISION_LOG_ERROR("No valid views");
@@ -797,15 +1182,60 @@ int aliceVision_main(int argc, char** argv)
 
     const std::vector<IndexT>& chunk = chunks[rangeIteration];
 
-    bool succeeded = true;
+    if(fusedWarping && !warpedOutputFolder.empty())
+    {
+        ALICEVISION_LOG_INFO("Write the warped images of this chunk");
+        for(const IndexT viewId : chunk)
+        {
+            image::Image<image::RGBfColor> colors;
+            image::Image<unsigned char> mask;
+            image::Image<float> weights;
+            if(!inputs->load(viewId, &colors, mask, &weights))
+            {
+                ALICEVISION_LOG_ERROR("Error warping view " << viewId);
+                return EXIT_FAILURE;
+            }
+
+            const std::string warpedPath = sfmData.getViews().at(viewId)->getImage().getMetadata().at("AliceVision:warpedPath");
+            const oiio::ParamValueList metadata = inputs->getMetadata(viewId);
+            const image::ImageWriteOptions options = image::ImageWriteOptions().toColorSpace(image::EImageColorSpace::NO_CONVERSION);
 
-    if (useTiling)
+            image::writeImage((fs::path(warpedOutputFolder) / (warpedPath + ".exr")).string(), colors,
+                              image::ImageWriteOptions(options).storageDataType(storageDataType), metadata);
+            image::writeImage((fs::path(warpedOutputFolder) / (warpedPath + "_mask.exr")).string(), mask, options, metadata);
+            image::writeImage((fs::path(warpedOutputFolder) / (warpedPath + "_weight.exr")).string(), weights,
+                              image::ImageWriteOptions(options).storageDataType(image::EStorageDataType::Half), metadata);
+        }
+    }
+
+    // Seams of the multiband compositer
+    image::Image<IndexT> panoramaLabels;
+    if(compositerType == "multiband")
     {
-        for(std::size_t posReference = 0; posReference < chunk.size(); posReference++)
+        if(fusedWarping)
         {
-            ALICEVISION_LOG_INFO("processing input region " << posReference + 1 << "/" << chunk.size());
+            // Same resolution as the labels of the seams estimation
+            if(!computeWTALabels(panoramaLabels, sfmData, *inputs, 3000))
+            {
+                ALICEVISION_LOG_ERROR("Error computing initial labels");
+                return EXIT_FAILURE;
+            }
+        }
+        else
+        {
+            image::readImageDirect(labelsFilepath, panoramaLabels);
+        }
+    }
+
+    std::atomic<bool> succeeded(true);
 
-            const IndexT viewReference = chunk[posReference];
+    if (useTiling)
+    {
+        std::vector<IndexT> viewsReference;
+        std::vector<BoundingBox> referenceBoundingBoxes;
+        std::vector<size_t> estimatedMemories;
+        for(const IndexT viewReference : chunk)
+        {
             if(!sfmData.isPoseAndIntrinsicDefined(viewReference))
                 continue;
 
@@ -816,12 +1246,46 @@ int aliceVision_main(int argc, char** argv)
                 return EXIT_FAILURE;
             }
 
-            if(!processImage(*panoramaMap, sfmData, compositerType, warpingFolder, labelsFilepath, outputFolder,
-                            storageDataType, viewReference, referenceBoundingBox, showBorders, showSeams))
+            viewsReference.push_back(viewReference);
+            referenceBoundingBoxes.push_back(referenceBoundingBox);
+            estimatedMemories.push_back(estimateProcessImageMemory(*panoramaMap, compositerType, referenceBoundingBox));
+        }
+
+        // Process concurrently as many consecutive input regions as fit in the memory budget.
+        // A single region is processed alone, with its inputs appended in parallel.
+        const size_t maxConcurrentRegions = std::max<size_t>(1, hwc.getMaxThreads());
+
+        size_t posStart = 0;
+        while(posStart < viewsReference.size())
+        {
+            const size_t maxMemory = system::MemoryBudget::get().getAvailableBytes();
+            size_t posEnd = posStart;
+            size_t batchMemory = 0;
+            while(posEnd < viewsReference.size() && posEnd - posStart < maxConcurrentRegions &&
+                  (posEnd == posStart || batchMemory + estimatedMemories[posEnd] <= maxMemory))
             {
-                succeeded = false;
-                continue;
+                batchMemory += estimatedMemories[posEnd];
+                posEnd++;
+            }
+
+            ALICEVISION_LOG_INFO("processing input regions " << posStart + 1 << " to " << posEnd << "/" << viewsReference.size()
+                                 << " (estimated memory: " << batchMemory / (1024 * 1024) << " MB)");
+
+            // wait for the memory reserved by the other stages
+            const system::MemoryReservation batchReservation(batchMemory);
+
+#pragma omp parallel for schedule(dynamic) if(posEnd - posStart > 1)
+            for(int posReference = int(posStart); posReference < int(posEnd); posReference++)
+            {
+                if(!processImage(*panoramaMap, sfmData, compositerType, *inputs, panoramaLabels, outputFolder,
+                                 storageDataType, viewsReference[posReference], referenceBoundingBoxes[posReference],
+                                 showBorders, showSeams, useGpu))
+                {
+                    succeeded = false;
+                }
             }
+
+            posStart = posEnd;
         }
     }
     else 
@@ -832,13 +1296,15 @@ int aliceVision_main(int argc, char** argv)
         referenceBoundingBox.width = panoramaMap->getWidth();
         referenceBoundingBox.height = panoramaMap->getHeight();
         
-        if(!processImage(*panoramaMap, sfmData, compositerType, warpingFolder, labelsFilepath, outputFolder,
-                            storageDataType, UndefinedIndexT, referenceBoundingBox, showBorders, showSeams))
+        if(!processImage(*panoramaMap, sfmData, compositerType, *inputs, panoramaLabels, outputFolder,
+                            storageDataType, UndefinedIndexT, referenceBoundingBox, showBorders, showSeams, useGpu))
         {
             succeeded = false;
         }
     }
 
+    system::MemoryBudget::get().logStats();
+
     if(!succeeded)
     {
         return EXIT_FAILURE;
@@ -17,8 +17,11 @@
 #include <aliceVision/system/main.hpp>
 
 #include <aliceVision/stl/mapUtils.hpp>
+#include <aliceVision/alicevision_omp.hpp>
 
+#include <array>
 #include <fstream>
+#include <future>
 #include <algorithm>
 #include <boost/property_tree/ptree.hpp>
 #include <boost/property_tree/json_parser.hpp>
@@ -192,6 +195,31 @@ bool readFullTile(image::Image<image::RGBAfColor> & output, std::unique_ptr<oiio
     return true;
 }
 
+/**
+ * @brief Read a full row of tiles, with one wrapped tile on each side.
+ * @param[out] output the row of tiles, of size (rowSize * tileSize) x tileSize
+ * @param[in] inputs the panorama inputs, one per thread, so the tiles are decoded in parallel
+ * @param[in] rowSize the number of tiles of the row (tiles count + 2)
+ * @param[in] ty the tile row index
+ */
+void readTileRow(image::Image<image::RGBAfColor>& output, std::vector<std::unique_ptr<oiio::ImageInput>>& inputs, int rowSize, int ty)
+{
+    const int tileSize = inputs.front()->spec().tile_width;
+
+    #pragma omp parallel for
+    for (int rx = 0; rx < rowSize; rx++)
+    {
+        image::Image<image::RGBAfColor> tile(tileSize, tileSize);
+        if (!readFullTile(tile, inputs[omp_get_thread_num()], rx - 1, ty))
+        {
+            ALICEVISION_LOG_ERROR("Invalid tile");
+            continue;
+        }
+
+        output.block(0, rx * tileSize, tileSize, tileSize) = tile;
+    }
+}
+
 void colorSpaceTransform(image::Image<image::RGBAfColor>& inputImage, image::EImageColorSpace fromColorSpace, image::EImageColorSpace toColorSpace, image::DCPProfile dcpProf, image::DCPProfile::Triple neutral)
 {
     const int width = inputImage.Width();
@@ -304,6 +332,19 @@ int aliceVision_main(int argc, char** argv)
         return EXIT_FAILURE;
     }
 
+    // one input per thread, the tiles are decoded in parallel
+    std::vector<std::unique_ptr<oiio::ImageInput>> panoramaInputs;
+    panoramaInputs.push_back(std::move(panoramaInput));
+    for (int threadIdx = 1; threadIdx < omp_get_max_threads(); ++threadIdx)
+    {
+        panoramaInputs.push_back(oiio::ImageInput::open(inputPanoramaPath));
+        if (!panoramaInputs.back())
+        {
+            ALICEVISION_LOG_ERROR("Impossible to open the input panorama");
+            return EXIT_FAILURE;
+        }
+    }
+
     int tmpWidth, tmpHeight;
     std::map<std::string, std::string> imageMetadata = image::getMapFromMetadata(image::readImageMetadata(inputPanoramaPath, tmpWidth, tmpHeight));
 
@@ -419,6 +460,54 @@ int aliceVision_main(int argc, char** argv)
         }
     }
 
+    // rolling window of the rows of tiles (ty - 1, ty, ty + 1), each row of tiles is read only once
+    std::array<image::Image<image::RGBAfColor>, 3> tileRows;
+    for (image::Image<image::RGBAfColor>& tileRow : tileRows)
+    {
+        tileRow = image::Image<image::RGBAfColor>(rowSize * tileSize, tileSize, true, image::RGBAfColor(0.0f, 0.0f, 0.0f, 0.0f));
+    }
+    readTileRow(tileRows[2], panoramaInputs, rowSize, 0);
+
+    const auto nextTileRows = [&](int ty) {
+        std::swap(tileRows[0], tileRows[1]);
+        std::swap(tileRows[1], tileRows[2]);
+        readTileRow(tileRows[2], panoramaInputs, rowSize, ty + 1);
+    };
+
+    // the rows are converted and written in order by a single task, during the computation of the next row
+    std::future<void> rowWriting;
+
+    const auto writeRowAsync = [&](int ty, image::Image<image::RGBAfColor>&& final, const std::vector<image::Image<image::RGBAfColor>>& pyramid) {
+        std::vector<image::Image<image::RGBAfColor>> levels;
+        for (int levelIdx = 1; levelIdx <= nbLevels; ++levelIdx)
+        {
+            const image::Image<image::RGBAfColor> & levelTile = pyramid[levelIdx];
+            const int levelTileSize = tileSize / (1 << levelIdx);
+            const int levelWidth = width / (1 << levelIdx);
+            image::Image<image::RGBAfColor> level(levelWidth, levelTileSize);
+            level.block(0, 0, levelTileSize, levelWidth) = levelTile.block(levelTileSize, levelTileSize, levelTileSize, levelWidth);
+            levels.push_back(std::move(level));
+        }
+
+        if (rowWriting.valid())
+        {
+            rowWriting.get();
+        }
+
+        rowWriting = std::async(std::launch::async, [&, ty, final = std::move(final), levels = std::move(levels)]() mutable {
+            colorSpaceTransform(final, fromColorSpace, outputColorSpace, dcpProf, neutral);
+            panoramaOutput->write_scanlines(ty * tileSize, (ty + 1) * tileSize, 0, oiio::TypeDesc::FLOAT, final.data());
+
+            for (int levelIdx = 1; levelIdx <= nbLevels; ++levelIdx)
+            {
+                image::Image<image::RGBAfColor> & level = levels[levelIdx - 1];
+                const int levelTileSize = tileSize / (1 << levelIdx);
+                colorSpaceTransform(level, fromColorSpace, outputColorSpace, dcpProf, neutral);
+                levelOutputs[levelIdx-1]->write_scanlines(ty * levelTileSize, (ty + 1) * levelTileSize, 0, oiio::TypeDesc::FLOAT, level.data());
+            }
+        });
+    };
+
     if (fillHoles)
     {
         ALICEVISION_LOG_INFO("Reduce image (" << width << "x" << height << ")");
@@ -442,7 +531,7 @@ int aliceVision_main(int argc, char** argv)
                 {
                     int dx = rx - 1;
 
-                    if (!readFullTile(tile, panoramaInput, dx, ty + dy)) 
+                    if (!readFullTile(tile, panoramaInputs[omp_get_thread_num()], dx, ty + dy))
                     {
                         ALICEVISION_LOG_ERROR("Invalid tile");
                         error = true;
@@ -505,31 +594,23 @@ int aliceVision_main(int argc, char** argv)
             image::Image<image::RGBAfColor> subFiled(rowSize, 3, true, image::RGBAfColor(0.0f, 0.0f, 0.0f, 0.0f));
             image::Image<image::RGBAfColor> final(width, tileSize, true, image::RGBAfColor(0.0f, 0.0f, 0.0f, 0.0f));
                 
-            //Build a region           
+            //Build a region
+            nextTileRows(ty);
             for (int ry = 0; ry < 3; ry++)
             {
                 int dy = ry - 1;
                 int cy = ty + dy;
-                
-                #pragma omp parallel for
-                for (int rx = 0; rx < rowSize; rx++)
-                {
-                    int dx = rx - 1;
-                    int cx = dx;
 
-                    image::Image<image::RGBAfColor> tile(tileSize, tileSize);
-                    if (!readFullTile(tile, panoramaInput, cx, cy))
-                    {
-                        ALICEVISION_LOG_ERROR("Invalid tile");
-                        continue;
-                    }
+                region.block(ry * tileSize, 0, tileSize, rowSize * tileSize) = tileRows[ry];
 
-                    region.block(ry * tileSize, rx * tileSize, tileSize, tileSize) = tile;
+                if (cy < 0 || cy >= smallFiled.Height())
+                {
+                    continue;
+                }
 
-                    if (cy < 0 || cy >= smallFiled.Height())
-                    {
-                        continue;
-                    }
+                for (int rx = 0; rx < rowSize; rx++)
+                {
+                    int cx = rx - 1;
 
                     if (cx < 0)
                     {
@@ -644,21 +725,8 @@ int aliceVision_main(int argc, char** argv)
                 previewCurrentRow++;
             }
 
-            // Write panorama output
-            colorSpaceTransform(final, fromColorSpace, outputColorSpace, dcpProf, neutral);
-            panoramaOutput->write_scanlines(ty * tileSize, (ty + 1) * tileSize, 0, oiio::TypeDesc::FLOAT, final.data());
-
-            // Write downscaled panorama levels
-            for (int levelIdx = 1; levelIdx <= nbLevels; ++levelIdx)
-            {
-                image::Image<image::RGBAfColor> & levelTile = pyramid[levelIdx];
-                const int levelTileSize = tileSize / (1 << levelIdx);
-                const int levelWidth = width / (1 << levelIdx);
-                image::Image<image::RGBAfColor> level(levelWidth, levelTileSize);
-                level.block(0, 0, levelTileSize, levelWidth) = levelTile.block(levelTileSize, levelTileSize, levelTileSize, levelWidth);
-                colorSpaceTransform(level, fromColorSpace, outputColorSpace, dcpProf, neutral);
-                levelOutputs[levelIdx-1]->write_scanlines(ty * levelTileSize, (ty + 1) * levelTileSize, 0, oiio::TypeDesc::FLOAT, level.data());
-            }
+            // Write panorama output and downscaled panorama levels
+            writeRowAsync(ty, std::move(final), pyramid);
         }
     }
     else 
@@ -673,27 +741,11 @@ int aliceVision_main(int argc, char** argv)
             image::Image<image::RGBAfColor> region(tileSize * rowSize, tileSize * 3);
             image::Image<image::RGBAfColor> final(width, tileSize, true, image::RGBAfColor(0.0f, 0.0f, 0.0f, 0.0f));
 
-            //Build a region           
+            //Build a region
+            nextTileRows(ty);
             for (int ry = 0; ry < 3; ry++)
             {
-                int dy = ry - 1;
-                int cy = ty + dy;
-                
-                #pragma omp parallel for
-                for (int rx = 0; rx < rowSize; rx++)
-                {
-                    int dx = rx - 1;
-                    int cx = dx;
-
-                    image::Image<image::RGBAfColor> tile(tileSize, tileSize);
-                    if (!readFullTile(tile, panoramaInput, cx, cy))
-                    {
-                        ALICEVISION_LOG_ERROR("Invalid tile");
-                        continue;
-                    }
-
-                    region.block(ry * tileSize, rx * tileSize, tileSize, tileSize) = tile;
-                }
+                region.block(ry * tileSize, 0, tileSize, rowSize * tileSize) = tileRows[ry];
             }
 
             //First level is original image
@@ -734,25 +786,20 @@ int aliceVision_main(int argc, char** argv)
                 previewCurrentRow++;
             }
 
-            // Write panorama output
-            colorSpaceTransform(final, fromColorSpace, outputColorSpace, dcpProf, neutral);
-            panoramaOutput->write_scanlines(ty * tileSize, (ty + 1) * tileSize, 0, oiio::TypeDesc::FLOAT, final.data());
-
-            // Write downscaled panorama levels
-            for (int levelIdx = 1; levelIdx <= nbLevels; ++levelIdx)
-            {
-                image::Image<image::RGBAfColor> & levelTile = pyramid[levelIdx];
-                const int levelTileSize = tileSize / (1 << levelIdx);
-                const int levelWidth = width / (1 << levelIdx);
-                image::Image<image::RGBAfColor> level(levelWidth, levelTileSize);
-                level.block(0, 0, levelTileSize, levelWidth) = levelTile.block(levelTileSize, levelTileSize, levelTileSize, levelWidth);
-                colorSpaceTransform(level, fromColorSpace, outputColorSpace, dcpProf, neutral);
-                levelOutputs[levelIdx-1]->write_scanlines(ty * levelTileSize, (ty + 1) * levelTileSize, 0, oiio::TypeDesc::FLOAT, level.data());
-            }
+            // Write panorama output and downscaled panorama levels
+            writeRowAsync(ty, std::move(final), pyramid);
         }
     }
 
-    panoramaInput->close();
+    if (rowWriting.valid())
+    {
+        rowWriting.get();
+    }
+
+    for (std::unique_ptr<oiio::ImageInput>& input : panoramaInputs)
+    {
+        input->close();
+    }
     panoramaOutput->close();
     for (int levelIdx = 1; levelIdx <= nbLevels; ++levelIdx)
     {
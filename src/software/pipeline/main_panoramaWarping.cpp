@@ -9,6 +9,9 @@
 #include <boost/filesystem.hpp>
 #include <aliceVision/cmdline/cmdline.hpp>
 #include <aliceVision/system/main.hpp>
+#include <aliceVision/system/ChunkClaimer.hpp>
+#include <aliceVision/config.hpp>
+#include <aliceVision/gpu/gpu.hpp>
 
 // Image related
 #include <aliceVision/image/all.hpp>
@@ -20,13 +23,14 @@
 // Internal functions
 #include <aliceVision/panorama/coordinatesMap.hpp>
 #include <aliceVision/panorama/remapBbox.hpp>
+#include <aliceVision/panorama/coordinatesMapCache.hpp>
 #include <aliceVision/panorama/warper.hpp>
 #include <aliceVision/panorama/distance.hpp>
 
 // These constants define the current software version.
 // They must be updated when the command line is changed.
 #define ALICEVISION_SOFTWARE_VERSION_MAJOR 1
-#define ALICEVISION_SOFTWARE_VERSION_MINOR 1
+#define ALICEVISION_SOFTWARE_VERSION_MINOR 3
 
 using namespace aliceVision;
 
@@ -103,12 +107,14 @@ int aliceVision_main(int argc, char** argv)
     int percentUpscale = 50;
     int tileSize = 256;
     int maxPanoramaWidth = 0;
+    bool useGpu = false;
 
     image::EStorageDataType storageDataType = image::EStorageDataType::Float;
     image::EImageColorSpace workingColorSpace = image::EImageColorSpace::LINEAR;
 
     int rangeStart = -1;
     int rangeSize = 1;
+    std::string rangeClaimFolder;
 
     // Program description
     // Description of mandatory parameters
@@ -130,7 +136,12 @@ int aliceVision_main(int argc, char** argv)
         "storageDataType", po::value<image::EStorageDataType>(&storageDataType)->default_value(storageDataType),
         ("Storage data type: " + image::EStorageDataType_informations()).c_str())(
         "rangeStart", po::value<int>(&rangeStart)->default_value(rangeStart),
-        "Range image index start.")("rangeSize", po::value<int>(&rangeSize)->default_value(rangeSize), "Range size.");
+        "Range image index start.")("rangeSize", po::value<int>(&rangeSize)->default_value(rangeSize), "Range size.")(
+        "rangeClaimFolder", po::value<std::string>(&rangeClaimFolder)->default_value(rangeClaimFolder),
+        "Folder shared by the processes of the node (empty for each execution): instead of the rangeStart chunk, "
+        "each process computes the next chunks of rangeSize views not claimed by another process.")(
+        "useGpu", po::value<bool>(&useGpu)->default_value(useGpu),
+        "Build the source pyramids and warp the tiles on the GPU (requires a CUDA-Enabled GPU).");
 
     CmdLine cmdline("Warps the input images in the panorama coordinate system.\n"
                     "AliceVision panoramaWarping");
@@ -145,6 +156,12 @@ int aliceVision_main(int argc, char** argv)
     HardwareContext hwc = cmdline.getHardwareContext();
     omp_set_num_threads(hwc.getMaxThreads());
 
+    if(useGpu && !gpu::gpuSupportCUDA(3, 0))
+    {
+        ALICEVISION_LOG_WARNING("No supported CUDA-Enabled GPU, the images are warped on the CPU.");
+        useGpu = false;
+    }
+
     bool clampHalf = false;
     oiio::TypeDesc typeColor = oiio::TypeDesc::FLOAT;
     if(storageDataType == image::EStorageDataType::Half || storageDataType == image::EStorageDataType::HalfFinite)
@@ -183,7 +200,15 @@ int aliceVision_main(int argc, char** argv)
               });
 
     // Define range to compute
-    if(rangeStart != -1)
+    if(!rangeClaimFolder.empty())
+    {
+        if(rangeSize <= 0)
+        {
+            ALICEVISION_LOG_ERROR("Range size should be positive to claim the chunks.");
+            return EXIT_FAILURE;
+        }
+    }
+    else if(rangeStart != -1)
     {
         if(rangeStart < 0 || rangeSize < 0 || std::size_t(rangeStart) > viewsOrderedByName.size())
         {
@@ -237,395 +262,221 @@ int aliceVision_main(int argc, char** argv)
     std::memset(empty_float.get(), 0, tileSize * tileSize * 3 * sizeof(float));
     std::memset(empty_char.get(), 0, tileSize * tileSize * sizeof(char));
 
-    // Preprocessing per view
-    for(std::size_t i = std::size_t(rangeStart); i < std::size_t(rangeStart + rangeSize); ++i)
+    // Compute the static range, or each chunk claimed by this process
+    std::unique_ptr<system::ChunkClaimer> chunkClaimer;
+    if(!rangeClaimFolder.empty())
     {
-        const std::shared_ptr<sfmData::View>& viewIt = viewsOrderedByName[i];
-
-        // Retrieve view
-        const sfmData::View& view = *viewIt;
-        if(!sfmData.isPoseAndIntrinsicDefined(&view))
-        {
-            continue;
-        }
-
-        ALICEVISION_LOG_INFO("[" << int(i) + 1 - rangeStart << "/" << rangeSize << "] Processing view "
-                                 << view.getViewId() << " (" << i + 1 << "/" << viewsOrderedByName.size() << ")");
-
-        // Get intrinsics and extrinsics
-        geometry::Pose3 camPose = sfmData.getPose(view).getTransform();
-        std::shared_ptr<camera::IntrinsicBase> intrinsic = sfmData.getIntrinsicsharedPtr(view.getIntrinsicId());
+        chunkClaimer.reset(new system::ChunkClaimer(rangeClaimFolder, int(viewsOrderedByName.size()), rangeSize));
+    }
 
-        // Compute coarse bounding box to make computations faster
-        BoundingBox coarseBboxInitial;
-        if(!computeCoarseBB(coarseBboxInitial, panoramaSize, camPose, *(intrinsic.get())))
+    bool hasRange = chunkClaimer ? chunkClaimer->claimNext(rangeStart, rangeSize) : true;
+    while(hasRange)
+    {
+        // Views of the same camera (brackets, rig) share their warped geometry,
+        // it is kept while the next views use the same camera
+        std::map<std::pair<IndexT, IndexT>, int> cameraViewsCount;
+        for(std::size_t i = std::size_t(rangeStart); i < std::size_t(rangeStart + rangeSize); ++i)
         {
-            continue;
+            const sfmData::View& view = *viewsOrderedByName[i];
+            cameraViewsCount[std::make_pair(view.getIntrinsicId(), view.getPoseId())]++;
         }
+        CoordinatesMapCache mapsCache(panoramaSize, tileSize);
 
-        std::vector<BoundingBox> coarsesBbox;
-        if(coarseBboxInitial.width > coarseBboxInitial.height * 2.0)
+        // Preprocessing per view
+        for(std::size_t i = std::size_t(rangeStart); i < std::size_t(rangeStart + rangeSize); ++i)
         {
-            const int count = int(double(coarseBboxInitial.width) / double(coarseBboxInitial.height));
-            const int width = coarseBboxInitial.width / count;
+            const std::shared_ptr<sfmData::View>& viewIt = viewsOrderedByName[i];
 
-            int pos = 0;
-            for(int id = 0; id < count; id++)
+            // Retrieve view
+            const sfmData::View& view = *viewIt;
+            if(!sfmData.isPoseAndIntrinsicDefined(&view))
             {
-                BoundingBox subCoarseBbox;
-                subCoarseBbox.left = coarseBboxInitial.left + pos;
-                subCoarseBbox.top = coarseBboxInitial.top;
-                subCoarseBbox.width = width;
-                subCoarseBbox.height = coarseBboxInitial.height;
-
-                coarsesBbox.push_back(subCoarseBbox);
-                pos += width;
+                continue;
             }
-        }
-        else
-        {
-            coarsesBbox.push_back(coarseBboxInitial);
-        }
 
-        // Load image and convert it to linear colorspace
-        const std::string imagePath = view.getImage().getImagePath();
-        ALICEVISION_LOG_INFO("Load image with path " << imagePath);
-        image::Image<image::RGBfColor> source;
-        image::readImage(imagePath, source, workingColorSpace);
+            ALICEVISION_LOG_INFO("[" << int(i) + 1 - rangeStart << "/" << rangeSize << "] Processing view "
+                                     << view.getViewId() << " (" << i + 1 << "/" << viewsOrderedByName.size() << ")");
 
-        for(int idsub = 0; idsub < coarsesBbox.size(); idsub++)
-        {
-            const auto coarseBbox = coarsesBbox[idsub];
-
-            // round to the closest tiles
-            BoundingBox snappedCoarseBbox;
-            snappedCoarseBbox = coarseBbox;
-            snappedCoarseBbox.snapToGrid(tileSize);
+            // Get intrinsics and extrinsics
+            geometry::Pose3 camPose = sfmData.getPose(view).getTransform();
+            std::shared_ptr<camera::IntrinsicBase> intrinsic = sfmData.getIntrinsicsharedPtr(view.getIntrinsicId());
 
-            // Initialize bouding box for image
-            BoundingBox globalBbox;
+            mapsCache.selectCamera(view.getIntrinsicId(), view.getPoseId(),
+                                   cameraViewsCount[std::make_pair(view.getIntrinsicId(), view.getPoseId())] > 1);
 
+            // Compute the bounding boxes of the warped images of this view
+            std::vector<BoundingBox> warpedBoxes;
+            if(!mapsCache.getWarpedBoundingBoxes(warpedBoxes, camPose, *(intrinsic.get())))
             {
-                // Search for first non empty box starting from the top
-                bool found = false;
-
-                for(int y = 0; y < snappedCoarseBbox.height; y += tileSize)
-                {
-#pragma omp parallel for
-                    for(int x = 0; x < snappedCoarseBbox.width; x += tileSize)
-                    {
-                        if(found)
-                        {
-                            continue;
-                        }
-
-                        BoundingBox localBbox;
-                        localBbox.left = x + snappedCoarseBbox.left;
-                        localBbox.top = y + snappedCoarseBbox.top;
-                        localBbox.width = tileSize;
-                        localBbox.height = tileSize;
-
-                        localBbox.clampRight(snappedCoarseBbox.getRight());
-                        localBbox.clampBottom(snappedCoarseBbox.getBottom());
+                continue;
+            }
 
-                        // Prepare coordinates map
-                        CoordinatesMap map;
-                        if(!map.build(panoramaSize, camPose, *(intrinsic.get()), localBbox))
-                        {
-                            continue;
-                        }
+            // Load image and convert it to linear colorspace
+            const std::string imagePath = view.getImage().getImagePath();
+            ALICEVISION_LOG_INFO("Load image with path " << imagePath);
+            image::Image<image::RGBfColor> source;
+            image::readImage(imagePath, source, workingColorSpace);
 
-#pragma omp critical
-                        {
-                            if(!map.getBoundingBox().isEmpty())
-                            {
-                                globalBbox = globalBbox.unionWith(map.getBoundingBox());
-                                found = true;
-                            }
-                        }
-                    }
+            for(int idsub = 0; idsub < warpedBoxes.size(); idsub++)
+            {
+                const BoundingBox& globalBbox = warpedBoxes[idsub];
+
+                // Load metadata and update for output
+                oiio::ParamValueList metadata = image::readImageMetadata(imagePath);
+                metadata.push_back(oiio::ParamValue("AliceVision:offsetX", globalBbox.left));
+                metadata.push_back(oiio::ParamValue("AliceVision:offsetY", globalBbox.top));
+                metadata.push_back(oiio::ParamValue("AliceVision:panoramaWidth", panoramaSize.first));
+                metadata.push_back(oiio::ParamValue("AliceVision:panoramaHeight", panoramaSize.second));
+                metadata.push_back(oiio::ParamValue("AliceVision:tileSize", tileSize));
+                if (workingColorSpace != image::EImageColorSpace::NO_CONVERSION)
+                {
+                    metadata.add_or_replace(oiio::ParamValue("AliceVision:ColorSpace", image::EImageColorSpace_enumToString(workingColorSpace)));
+                }
 
-                    if(found)
+                // Images will be converted in Panorama coordinate system, so there will be no more extra orientation.
+                metadata.remove("Orientation");
+                metadata.remove("orientation");
+
+                // Define output paths
+                const std::string viewIdStr = std::to_string(view.getViewId());
+                const std::string subIdStr = std::to_string(idsub);
+                const std::string viewFilepath =
+                    (fs::path(outputDirectory) / (viewIdStr + "_" + subIdStr + ".exr")).string();
+                const std::string maskFilepath =
+                    (fs::path(outputDirectory) / (viewIdStr + "_" + subIdStr + "_mask.exr")).string();
+                const std::string weightFilepath =
+                    (fs::path(outputDirectory) / (viewIdStr + "_" + subIdStr + "_weight.exr")).string();
+
+                // Create output images
+                std::unique_ptr<oiio::ImageOutput> out_view = oiio::ImageOutput::create(viewFilepath);
+                std::unique_ptr<oiio::ImageOutput> out_mask = oiio::ImageOutput::create(maskFilepath);
+                std::unique_ptr<oiio::ImageOutput> out_weights = oiio::ImageOutput::create(weightFilepath);
+
+                // Define output properties
+                oiio::ImageSpec spec_view(globalBbox.width, globalBbox.height, 3, typeColor);
+                oiio::ImageSpec spec_mask(globalBbox.width, globalBbox.height, 1, oiio::TypeDesc::UCHAR);
+                oiio::ImageSpec spec_weights(globalBbox.width, globalBbox.height, 1, oiio::TypeDesc::HALF);
+
+                spec_view.tile_width = tileSize;
+                spec_view.tile_height = tileSize;
+                spec_mask.tile_width = tileSize;
+                spec_mask.tile_height = tileSize;
+                spec_weights.tile_width = tileSize;
+                spec_weights.tile_height = tileSize;
+                spec_view.attribute("compression", "zip");
+                spec_weights.attribute("compression", "zip");
+                spec_mask.attribute("compression", "zip");
+                spec_view.extra_attribs = metadata;
+                spec_mask.extra_attribs = metadata;
+                spec_weights.extra_attribs = metadata;
+
+                out_view->open(viewFilepath, spec_view);
+                out_mask->open(maskFilepath, spec_mask);
+                out_weights->open(weightFilepath, spec_weights);
+
+                // Source pyramid, shared by all the tiles
+                std::unique_ptr<GaussianPyramidNoMask> pyramid;
+#if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_CUDA)
+                std::unique_ptr<DeviceGaussianPyramid> devicePyramid;
+                if(useGpu)
+                {
+                    devicePyramid.reset(new DeviceGaussianPyramid(
+                        source, GaussianPyramidNoMask::computeScalesCount(source.Width(), source.Height())));
+                }
+                else
+#endif
+                {
+                    pyramid.reset(new GaussianPyramidNoMask(source.Width(), source.Height()));
+                    if(!pyramid->process(std::move(source)))
                     {
-                        break;
+                        ALICEVISION_LOG_ERROR("Problem creating pyramid.");
+                        continue;
                     }
                 }
-            }
 
-            {
-                // Search for first non empty box starting from the bottom
-                bool found = false;
-                for(int y = snappedCoarseBbox.height - 1; y >= 0; y -= tileSize)
+                std::vector<BoundingBox> boxes;
+                for(int y = 0; y < globalBbox.height; y += tileSize)
                 {
-#pragma omp parallel for
-                    for(int x = 0; x < snappedCoarseBbox.width; x += tileSize)
+                    for(int x = 0; x < globalBbox.width; x += tileSize)
                     {
-                        if(found)
-                        {
-                            continue;
-                        }
-
                         BoundingBox localBbox;
-                        localBbox.left = x + snappedCoarseBbox.left;
-                        localBbox.top = y + snappedCoarseBbox.top;
+                        localBbox.left = x + globalBbox.left;
+                        localBbox.top = y + globalBbox.top;
                         localBbox.width = tileSize;
                         localBbox.height = tileSize;
+                        boxes.push_back(localBbox);
+                    }
+                }
 
-                        localBbox.clampRight(snappedCoarseBbox.getRight());
-                        localBbox.clampBottom(snappedCoarseBbox.getBottom());
+#pragma omp parallel for
+                for(int boxId = 0; boxId < boxes.size(); boxId++)
+                {
+                    BoundingBox localBbox = boxes[boxId];
 
-                        // Prepare coordinates map
-                        CoordinatesMap map;
-                        if(!map.build(panoramaSize, camPose, *(intrinsic.get()), localBbox))
-                        {
-                            continue;
-                        }
+                    int x = localBbox.left - globalBbox.left;
+                    int y = localBbox.top - globalBbox.top;
 
-#pragma omp critical
-                        {
-                            if(!map.getBoundingBox().isEmpty())
-                            {
-                                globalBbox = globalBbox.unionWith(map.getBoundingBox());
-                                found = true;
-                            }
-                        }
+                    // Prepare coordinates map
+                    CoordinatesMap map;
+                    if(!mapsCache.getMap(map, camPose, *(intrinsic.get()), localBbox))
+                    {
+                        continue;
                     }
 
-                    if(found)
+                    // Warp image
+                    GaussianWarper warper;
+                    bool warped = false;
+#if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_CUDA)
+                    if(devicePyramid)
                     {
-                        break;
+                        warped = warper.warp(map, *devicePyramid, clampHalf);
                     }
-                }
-            }
-
-            {
-                // Search for first non empty box starting from the left
-                bool found = false;
-                for(int x = 0; x < snappedCoarseBbox.width; x += tileSize)
-                {
-#pragma omp parallel for
-                    for(int y = 0; y < snappedCoarseBbox.height; y += tileSize)
+#endif
+                    if(pyramid)
                     {
-                        if(found)
-                        {
-                            continue;
-                        }
-
-                        BoundingBox localBbox;
-                        localBbox.left = x + snappedCoarseBbox.left;
-                        localBbox.top = y + snappedCoarseBbox.top;
-                        localBbox.width = tileSize;
-                        localBbox.height = tileSize;
-
-                        localBbox.clampRight(snappedCoarseBbox.getRight());
-                        localBbox.clampBottom(snappedCoarseBbox.getBottom());
-
-                        // Prepare coordinates map
-                        CoordinatesMap map;
-                        if(!map.build(panoramaSize, camPose, *(intrinsic.get()), localBbox))
-                        {
-                            continue;
-                        }
-
-#pragma omp critical
-                        {
-                            if(!map.getBoundingBox().isEmpty())
-                            {
-                                globalBbox = globalBbox.unionWith(map.getBoundingBox());
-                                found = true;
-                            }
-                        }
+                        warped = warper.warp(map, *pyramid, clampHalf);
                     }
 
-                    if(found)
+                    if(!warped)
                     {
-                        break;
+                        continue;
                     }
-                }
-            }
 
-            {
-                // Search for first non empty box starting from the left
-                bool found = false;
-                for(int x = snappedCoarseBbox.width - 1; x >= 0; x -= tileSize)
-                {
-#pragma omp parallel for
-                    for(int y = 0; y < snappedCoarseBbox.height; y += tileSize)
+                    // Alpha mask
+                    aliceVision::image::Image<float> weights;
+                    if(!distanceToCenter(weights, map, intrinsic->w(), intrinsic->h()))
                     {
-                        if(found)
-                        {
-                            continue;
-                        }
-
-                        BoundingBox localBbox;
-                        localBbox.left = x + snappedCoarseBbox.left;
-                        localBbox.top = y + snappedCoarseBbox.top;
-                        localBbox.width = tileSize;
-                        localBbox.height = tileSize;
-
-                        localBbox.clampRight(snappedCoarseBbox.getRight());
-                        localBbox.clampBottom(snappedCoarseBbox.getBottom());
-
-                        // Prepare coordinates map
-                        CoordinatesMap map;
-                        if(!map.build(panoramaSize, camPose, *(intrinsic.get()), localBbox))
-                        {
-                            continue;
-                        }
-
-#pragma omp critical
-                        {
-                            if(!map.getBoundingBox().isEmpty())
-                            {
-                                globalBbox = globalBbox.unionWith(map.getBoundingBox());
-                                found = true;
-                            }
-                        }
+                        continue;
                     }
 
-                    if(found)
+    // Store
+#pragma omp critical
                     {
-                        break;
+                        out_view->write_tile(x, y, 0, oiio::TypeDesc::FLOAT, warper.getColor().data());
                     }
-                }
-            }
-
-            // Rare case ... When all boxes valid are after the loop
-            if(globalBbox.left >= panoramaSize.first)
-            {
-                globalBbox.left -= panoramaSize.first;
-            }
 
-            globalBbox.width = std::min(globalBbox.width, panoramaSize.first);
-            globalBbox.height = std::min(globalBbox.height, panoramaSize.second);
-
-            // Load metadata and update for output
-            oiio::ParamValueList metadata = image::readImageMetadata(imagePath);
-            metadata.push_back(oiio::ParamValue("AliceVision:offsetX", globalBbox.left));
-            metadata.push_back(oiio::ParamValue("AliceVision:offsetY", globalBbox.top));
-            metadata.push_back(oiio::ParamValue("AliceVision:panoramaWidth", panoramaSize.first));
-            metadata.push_back(oiio::ParamValue("AliceVision:panoramaHeight", panoramaSize.second));
-            metadata.push_back(oiio::ParamValue("AliceVision:tileSize", tileSize));
-            if (workingColorSpace != image::EImageColorSpace::NO_CONVERSION)
-            {
-                metadata.add_or_replace(oiio::ParamValue("AliceVision:ColorSpace", image::EImageColorSpace_enumToString(workingColorSpace)));
-            }
-
-            // Images will be converted in Panorama coordinate system, so there will be no more extra orientation.
-            metadata.remove("Orientation");
-            metadata.remove("orientation");
-
-            // Define output paths
-            const std::string viewIdStr = std::to_string(view.getViewId());
-            const std::string subIdStr = std::to_string(idsub);
-            const std::string viewFilepath =
-                (fs::path(outputDirectory) / (viewIdStr + "_" + subIdStr + ".exr")).string();
-            const std::string maskFilepath =
-                (fs::path(outputDirectory) / (viewIdStr + "_" + subIdStr + "_mask.exr")).string();
-            const std::string weightFilepath =
-                (fs::path(outputDirectory) / (viewIdStr + "_" + subIdStr + "_weight.exr")).string();
-
-            // Create output images
-            std::unique_ptr<oiio::ImageOutput> out_view = oiio::ImageOutput::create(viewFilepath);
-            std::unique_ptr<oiio::ImageOutput> out_mask = oiio::ImageOutput::create(maskFilepath);
-            std::unique_ptr<oiio::ImageOutput> out_weights = oiio::ImageOutput::create(weightFilepath);
-
-            // Define output properties
-            oiio::ImageSpec spec_view(globalBbox.width, globalBbox.height, 3, typeColor);
-            oiio::ImageSpec spec_mask(globalBbox.width, globalBbox.height, 1, oiio::TypeDesc::UCHAR);
-            oiio::ImageSpec spec_weights(globalBbox.width, globalBbox.height, 1, oiio::TypeDesc::HALF);
-
-            spec_view.tile_width = tileSize;
-            spec_view.tile_height = tileSize;
-            spec_mask.tile_width = tileSize;
-            spec_mask.tile_height = tileSize;
-            spec_weights.tile_width = tileSize;
-            spec_weights.tile_height = tileSize;
-            spec_view.attribute("compression", "zip");
-            spec_weights.attribute("compression", "zip");
-            spec_mask.attribute("compression", "zip");
-            spec_view.extra_attribs = metadata;
-            spec_mask.extra_attribs = metadata;
-            spec_weights.extra_attribs = metadata;
-
-            out_view->open(viewFilepath, spec_view);
-            out_mask->open(maskFilepath, spec_mask);
-            out_weights->open(weightFilepath, spec_weights);
-
-            GaussianPyramidNoMask pyramid(source.Width(), source.Height());
-            if(!pyramid.process(source))
-            {
-                ALICEVISION_LOG_ERROR("Problem creating pyramid.");
-                continue;
-            }
-
-            std::vector<BoundingBox> boxes;
-            for(int y = 0; y < globalBbox.height; y += tileSize)
-            {
-                for(int x = 0; x < globalBbox.width; x += tileSize)
-                {
-                    BoundingBox localBbox;
-                    localBbox.left = x + globalBbox.left;
-                    localBbox.top = y + globalBbox.top;
-                    localBbox.width = tileSize;
-                    localBbox.height = tileSize;
-                    boxes.push_back(localBbox);
-                }
-            }
-
-#pragma omp parallel for
-            for(int boxId = 0; boxId < boxes.size(); boxId++)
-            {
-                BoundingBox localBbox = boxes[boxId];
-
-                int x = localBbox.left - globalBbox.left;
-                int y = localBbox.top - globalBbox.top;
-
-                // Prepare coordinates map
-                CoordinatesMap map;
-                if(!map.build(panoramaSize, camPose, *(intrinsic.get()), localBbox))
-                {
-                    continue;
-                }
-
-                // Warp image
-                GaussianWarper warper;
-                if(!warper.warp(map, pyramid, clampHalf))
-                {
-                    continue;
-                }
-
-                // Alpha mask
-                aliceVision::image::Image<float> weights;
-                if(!distanceToCenter(weights, map, intrinsic->w(), intrinsic->h()))
-                {
-                    continue;
-                }
-
-// Store
+    // Store
 #pragma omp critical
-                {
-                    out_view->write_tile(x, y, 0, oiio::TypeDesc::FLOAT, warper.getColor().data());
-                }
+                    {
+                        out_mask->write_tile(x, y, 0, oiio::TypeDesc::UCHAR, warper.getMask().data());
+                    }
 
-// Store
+    // Store
 #pragma omp critical
-                {
-                    out_mask->write_tile(x, y, 0, oiio::TypeDesc::UCHAR, warper.getMask().data());
+                    {
+                        out_weights->write_tile(x, y, 0, oiio::TypeDesc::FLOAT, weights.data());
+                    }
                 }
 
-// Store
-#pragma omp critical
-                {
-                    out_weights->write_tile(x, y, 0, oiio::TypeDesc::FLOAT, weights.data());
-                }
+                out_view->close();
+                out_mask->close();
+                out_weights->close();
             }
-
-            out_view->close();
-            out_mask->close();
-            out_weights->close();
         }
-    }
 
+
+        // Next chunk claimed by this process
+        hasRange = chunkClaimer && chunkClaimer->claimNext(rangeStart, rangeSize);
+    }
     return EXIT_SUCCESS;
 }
@@ -19,7 +19,10 @@
 
 #include <stdlib.h>
 #include <stdio.h>
+#include <algorithm>
 #include <cmath>
+#include <deque>
+#include <future>
 #include <vector>
 #include <set>
 #include <iterator>
@@ -29,7 +32,7 @@
 // These constants define the current software version.
 // They must be updated when the command line is changed.
 #define ALICEVISION_SOFTWARE_VERSION_MAJOR 2
-#define ALICEVISION_SOFTWARE_VERSION_MINOR 1
+#define ALICEVISION_SOFTWARE_VERSION_MINOR 2
 
 using namespace aliceVision;
 using namespace aliceVision::camera;
@@ -41,10 +44,150 @@ using namespace aliceVision::sfmDataIO;
 namespace po = boost::program_options;
 namespace fs = boost::filesystem;
 
-template <class ImageT, class MaskFuncT>
-void process(const std::string &dstColorImage, const IntrinsicBase* cam, const oiio::ParamValueList & metadata, const std::string & srcImage, bool evCorrection, float exposureCompensation, MaskFuncT && maskFunc)
+/// Source image of a view read and prepared for the undistortion, with its output path and metadata
+struct PreparedImage
 {
-    ImageT image, image_ud;
+    Image<RGBAfColor> image;
+    oiio::ParamValueList metadata;
+    std::string dstColorImage;
+    const IntrinsicBase* cam = nullptr;
+    bool valid = false;
+};
+
+/**
+ * @brief Export the camera of a view and read its source image with the exposure correction and the mask.
+ * @return the prepared image, not valid if the view cannot be exported
+ */
+PreparedImage prepareView(const SfMData& sfmData,
+                          IndexT viewId,
+                          const std::vector<std::string>& imagesFolders,
+                          const std::vector<std::string>& masksFolders,
+                          const std::string& maskExtension,
+                          const std::string& outFolder,
+                          image::EImageFileType outputFileType,
+                          bool saveMetadata,
+                          bool saveMatricesFiles,
+                          bool evCorrection,
+                          double medianCameraExposure)
+{
+    PreparedImage prepared;
+
+    const View* view = sfmData.getViews().at(viewId).get();
+
+    Intrinsics::const_iterator iterIntrinsic = sfmData.getIntrinsics().find(view->getIntrinsicId());
+
+    // we have a valid view with a corresponding camera & pose
+    const std::string baseFilename = std::to_string(viewId);
+
+    // get metadata from source image to be sure we get all metadata. We don't use the metadatas from the Views inside the SfMData to avoid type conversion problems with string maps.
+    std::string srcImage = view->getImage().getImagePath();
+    oiio::ParamValueList& metadata = prepared.metadata;
+    metadata = image::readImageMetadata(srcImage);
+
+    // export camera
+    if(saveMetadata || saveMatricesFiles)
+    {
+        // get camera pose / projection
+        const Pose3 pose = sfmData.getPose(*view).getTransform();
+
+        std::shared_ptr<camera::IntrinsicBase> cam = iterIntrinsic->second;
+        std::shared_ptr<camera::Pinhole> camPinHole = std::dynamic_pointer_cast<camera::Pinhole>(cam);
+        if (!camPinHole) {
+            ALICEVISION_LOG_ERROR("Camera is not pinhole in filter");
+            return prepared;
+        }
+
+        Mat34 P = camPinHole->getProjectiveEquivalent(pose);
+
+        // get camera intrinsics matrices
+        const Mat3 K = camPinHole->K();
+        const Mat3& R = pose.rotation();
+        const Vec3& t = pose.translation();
+
+        if(saveMatricesFiles)
+        {
+            std::ofstream fileP((fs::path(outFolder) / (baseFilename + "_P.txt")).string());
+            fileP << std::setprecision(10)
+                    << P(0, 0) << " " << P(0, 1) << " " << P(0, 2) << " " << P(0, 3) << "\n"
+                    << P(1, 0) << " " << P(1, 1) << " " << P(1, 2) << " " << P(1, 3) << "\n"
+                    << P(2, 0) << " " << P(2, 1) << " " << P(2, 2) << " " << P(2, 3) << "\n";
+            fileP.close();
+
+            std::ofstream fileKRt((fs::path(outFolder) / (baseFilename + "_KRt.txt")).string());
+            fileKRt << std::setprecision(10)
+                    << K(0, 0) << " " << K(0, 1) << " " << K(0, 2) << "\n"
+                    << K(1, 0) << " " << K(1, 1) << " " << K(1, 2) << "\n"
+                    << K(2, 0) << " " << K(2, 1) << " " << K(2, 2) << "\n"
+                    << "\n"
+                    << R(0, 0) << " " << R(0, 1) << " " << R(0, 2) << "\n"
+                    << R(1, 0) << " " << R(1, 1) << " " << R(1, 2) << "\n"
+                    << R(2, 0) << " " << R(2, 1) << " " << R(2, 2) << "\n"
+                    << "\n"
+                    << t(0) << " " << t(1) << " " << t(2) << "\n";
+            fileKRt.close();
+        }
+
+        if(saveMetadata)
+        {
+            // convert to 44 matix
+            Mat4 projectionMatrix;
+            projectionMatrix << P(0, 0), P(0, 1), P(0, 2), P(0, 3),
+                                P(1, 0), P(1, 1), P(1, 2), P(1, 3),
+                                P(2, 0), P(2, 1), P(2, 2), P(2, 3),
+                                     0,       0,       0,       1;
+
+            // convert matrices to rowMajor
+            std::vector<double> vP(projectionMatrix.size());
+            std::vector<double> vK(K.size());
+            std::vector<double> vR(R.size());
+
+            typedef Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> RowMatrixXd;
+            Eigen::Map<RowMatrixXd>(vP.data(), projectionMatrix.rows(), projectionMatrix.cols()) = projectionMatrix;
+            Eigen::Map<RowMatrixXd>(vK.data(), K.rows(), K.cols()) = K;
+            Eigen::Map<RowMatrixXd>(vR.data(), R.rows(), R.cols()) = R;
+
+            // add metadata
+            metadata.push_back(oiio::ParamValue("AliceVision:downscale", 1));
+            metadata.push_back(oiio::ParamValue("AliceVision:P", oiio::TypeDesc(oiio::TypeDesc::DOUBLE, oiio::TypeDesc::MATRIX44), 1, vP.data()));
+            metadata.push_back(oiio::ParamValue("AliceVision:K", oiio::TypeDesc(oiio::TypeDesc::DOUBLE, oiio::TypeDesc::MATRIX33), 1, vK.data()));
+            metadata.push_back(oiio::ParamValue("AliceVision:R", oiio::TypeDesc(oiio::TypeDesc::DOUBLE, oiio::TypeDesc::MATRIX33), 1, vR.data()));
+            metadata.push_back(oiio::ParamValue("AliceVision:t", oiio::TypeDesc(oiio::TypeDesc::DOUBLE, oiio::TypeDesc::VEC3), 1, t.data()));
+        }
+    }
+
+    if(!imagesFolders.empty())
+    {
+        std::vector<std::string> paths = sfmDataIO::viewPathsFromFolders(*view, imagesFolders);
+
+        // if path was not found
+        if(paths.empty())
+        {
+            throw std::runtime_error("Cannot find view '" + std::to_string(view->getViewId()) + "' image file in given folder(s)");
+        }
+        else if(paths.size() > 1)
+        {
+            throw std::runtime_error( "Ambiguous case: Multiple source image files found in given folder(s) for the view '" + 
+                std::to_string(view->getViewId()) + "'.");
+        }
+
+        srcImage = paths[0];
+    }
+    prepared.dstColorImage = (fs::path(outFolder) / (baseFilename + "." + image::EImageFileType_enumToString(outputFileType))).string();
+    prepared.cam = iterIntrinsic->second.get();
+
+    // add exposure values to images metadata
+    const double cameraExposure = view->getImage().getCameraExposureSetting().getExposure();
+    const double ev = std::log2(1.0 / cameraExposure);
+    const float exposureCompensation = float(medianCameraExposure / cameraExposure);
+    metadata.push_back(oiio::ParamValue("AliceVision:EV", float(ev)));
+    metadata.push_back(oiio::ParamValue("AliceVision:EVComp", exposureCompensation));
+
+    if(evCorrection)
+    {
+        ALICEVISION_LOG_INFO("image " << viewId << ", exposure: " << cameraExposure << ", Ev " << ev << " Ev compensation: " + std::to_string(exposureCompensation));
+    }
+
+    Image<RGBAfColor>& image = prepared.image;
     readImage(srcImage, image, image::EImageColorSpace::LINEAR);
 
     // exposure correction
@@ -59,21 +202,25 @@ void process(const std::string &dstColorImage, const IntrinsicBase* cam, const o
     }
 
     // mask
-    maskFunc(image);
-
-    // undistort
-    if(cam->isValid() && cam->hasDistortion())
-    {
-        // undistort the image and save it
-        using Pix = typename ImageT::Tpixel;
-        Pix pixZero(Pix::Zero());
-        UndistortImage(image, cam, image_ud, pixZero);
-        writeImage(dstColorImage, image_ud, image::ImageWriteOptions(), metadata);
-    }
-    else
+    image::Image<unsigned char> mask;
+    if(tryLoadMask(&mask, masksFolders, viewId, srcImage, maskExtension))
     {
-        writeImage(dstColorImage, image, image::ImageWriteOptions(), metadata);
+        if(image.Width() * image.Height() != mask.Width() * mask.Height())
+        {
+            ALICEVISION_LOG_WARNING("Invalid image mask size: mask is ignored.");
+        }
+        else
+        {
+            for(int pix = 0; pix < image.Width() * image.Height(); ++pix)
+            {
+                const bool masked = (mask(pix) == 0);
+                image(pix).a() = masked ? 0.f : 1.f;
+            }
+        }
     }
+
+    prepared.valid = true;
+    return prepared;
 }
 
 bool prepareDenseScene(const SfMData& sfmData,
@@ -84,12 +231,14 @@ bool prepareDenseScene(const SfMData& sfmData,
                        int endIndex,
                        const std::string& outFolder,
                        image::EImageFileType outputFileType,
+                       const image::ImageWriteOptions& writeOptions,
                        bool saveMetadata,
                        bool saveMatricesFiles,
-                       bool evCorrection)
+                       bool evCorrection,
+                       int maxPendingWrites)
 {
     // defined view Ids
-    std::set<IndexT> viewIds;
+    std::vector<IndexT> viewIds;
 
     sfmData::Views::const_iterator itViewBegin = sfmData.getViews().begin();
     sfmData::Views::const_iterator itViewEnd = sfmData.getViews().end();
@@ -108,8 +257,9 @@ bool prepareDenseScene(const SfMData& sfmData,
         const View* view = it->second.get();
         if (!sfmData.isPoseAndIntrinsicDefined(view))
             continue;
-        viewIds.insert(view->getViewId());
+        viewIds.push_back(view->getViewId());
     }
+    std::sort(viewIds.begin(), viewIds.end());
 
     if((outputFileType != image::EImageFileType::EXR) && saveMetadata)
         ALICEVISION_LOG_WARNING("Cannot save informations in images metadata.\n"
@@ -123,157 +273,56 @@ bool prepareDenseScene(const SfMData& sfmData,
     const double medianCameraExposure = sfmData.getMedianCameraExposureSetting().getExposure();
     ALICEVISION_LOG_INFO("Median Camera Exposure: " << medianCameraExposure << ", Median EV: " << std::log2(1.0/medianCameraExposure));
 
-    #pragma omp parallel for num_threads(3)
-    for(int i = 0; i < viewIds.size(); ++i)
+    const auto prepareViewAsync = [&](IndexT viewId) {
+        return std::async(std::launch::async, [&, viewId]() {
+            return prepareView(sfmData, viewId, imagesFolders, masksFolders, maskExtension, outFolder, outputFileType,
+                               saveMetadata, saveMatricesFiles, evCorrection, medianCameraExposure);
+        });
+    };
+
+    // The next image is read in a worker thread and the previous images are written during the undistortion,
+    // which is parallelized over the image rows
+    std::future<PreparedImage> nextImage;
+    if(!viewIds.empty())
+        nextImage = prepareViewAsync(viewIds.front());
+    std::deque<std::future<void>> pendingWrites;
+
+    for(std::size_t i = 0; i < viewIds.size(); ++i)
     {
-        auto itView = viewIds.begin();
-        std::advance(itView, i);
-
-        const IndexT viewId = *itView;
-        const View* view = sfmData.getViews().at(viewId).get();
-
-        Intrinsics::const_iterator iterIntrinsic = sfmData.getIntrinsics().find(view->getIntrinsicId());
+        PreparedImage prepared = nextImage.get();
+        if(i + 1 < viewIds.size())
+            nextImage = prepareViewAsync(viewIds[i + 1]);
 
-        // we have a valid view with a corresponding camera & pose
-        const std::string baseFilename = std::to_string(viewId);
-
-        // get metadata from source image to be sure we get all metadata. We don't use the metadatas from the Views inside the SfMData to avoid type conversion problems with string maps.
-        std::string srcImage = view->getImage().getImagePath();
-        oiio::ParamValueList metadata = image::readImageMetadata(srcImage);
-
-        // export camera
-        if(saveMetadata || saveMatricesFiles)
+        if(!prepared.valid)
         {
-            // get camera pose / projection
-            const Pose3 pose = sfmData.getPose(*view).getTransform();
-
-            std::shared_ptr<camera::IntrinsicBase> cam = iterIntrinsic->second;
-            std::shared_ptr<camera::Pinhole> camPinHole = std::dynamic_pointer_cast<camera::Pinhole>(cam);
-            if (!camPinHole) {
-                ALICEVISION_LOG_ERROR("Camera is not pinhole in filter");
-                continue;
-            }
-
-            Mat34 P = camPinHole->getProjectiveEquivalent(pose);
-
-            // get camera intrinsics matrices
-            const Mat3 K = dynamic_cast<const Pinhole*>(sfmData.getIntrinsicPtr(view->getIntrinsicId()))->K();
-            const Mat3& R = pose.rotation();
-            const Vec3& t = pose.translation();
-
-            if(saveMatricesFiles)
-            {
-                std::ofstream fileP((fs::path(outFolder) / (baseFilename + "_P.txt")).string());
-                fileP << std::setprecision(10)
-                        << P(0, 0) << " " << P(0, 1) << " " << P(0, 2) << " " << P(0, 3) << "\n"
-                        << P(1, 0) << " " << P(1, 1) << " " << P(1, 2) << " " << P(1, 3) << "\n"
-                        << P(2, 0) << " " << P(2, 1) << " " << P(2, 2) << " " << P(2, 3) << "\n";
-                fileP.close();
-
-                std::ofstream fileKRt((fs::path(outFolder) / (baseFilename + "_KRt.txt")).string());
-                fileKRt << std::setprecision(10)
-                        << K(0, 0) << " " << K(0, 1) << " " << K(0, 2) << "\n"
-                        << K(1, 0) << " " << K(1, 1) << " " << K(1, 2) << "\n"
-                        << K(2, 0) << " " << K(2, 1) << " " << K(2, 2) << "\n"
-                        << "\n"
-                        << R(0, 0) << " " << R(0, 1) << " " << R(0, 2) << "\n"
-                        << R(1, 0) << " " << R(1, 1) << " " << R(1, 2) << "\n"
-                        << R(2, 0) << " " << R(2, 1) << " " << R(2, 2) << "\n"
-                        << "\n"
-                        << t(0) << " " << t(1) << " " << t(2) << "\n";
-                fileKRt.close();
-            }
-
-            if(saveMetadata)
-            {
-                // convert to 44 matix
-                Mat4 projectionMatrix;
-                projectionMatrix << P(0, 0), P(0, 1), P(0, 2), P(0, 3),
-                                    P(1, 0), P(1, 1), P(1, 2), P(1, 3),
-                                    P(2, 0), P(2, 1), P(2, 2), P(2, 3),
-                                         0,       0,       0,       1;
-
-                // convert matrices to rowMajor
-                std::vector<double> vP(projectionMatrix.size());
-                std::vector<double> vK(K.size());
-                std::vector<double> vR(R.size());
-
-                typedef Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> RowMatrixXd;
-                Eigen::Map<RowMatrixXd>(vP.data(), projectionMatrix.rows(), projectionMatrix.cols()) = projectionMatrix;
-                Eigen::Map<RowMatrixXd>(vK.data(), K.rows(), K.cols()) = K;
-                Eigen::Map<RowMatrixXd>(vR.data(), R.rows(), R.cols()) = R;
-
-                // add metadata
-                metadata.push_back(oiio::ParamValue("AliceVision:downscale", 1));
-                metadata.push_back(oiio::ParamValue("AliceVision:P", oiio::TypeDesc(oiio::TypeDesc::DOUBLE, oiio::TypeDesc::MATRIX44), 1, vP.data()));
-                metadata.push_back(oiio::ParamValue("AliceVision:K", oiio::TypeDesc(oiio::TypeDesc::DOUBLE, oiio::TypeDesc::MATRIX33), 1, vK.data()));
-                metadata.push_back(oiio::ParamValue("AliceVision:R", oiio::TypeDesc(oiio::TypeDesc::DOUBLE, oiio::TypeDesc::MATRIX33), 1, vR.data()));
-                metadata.push_back(oiio::ParamValue("AliceVision:t", oiio::TypeDesc(oiio::TypeDesc::DOUBLE, oiio::TypeDesc::VEC3), 1, t.data()));
-            }
+            ++progressDisplay;
+            continue;
         }
 
-        // export undistort image
-        {      
-            if(!imagesFolders.empty())
-            {
-                std::vector<std::string> paths = sfmDataIO::viewPathsFromFolders(*view, imagesFolders);
-
-                // if path was not found
-                if(paths.empty())
-                {
-                    throw std::runtime_error("Cannot find view '" + std::to_string(view->getViewId()) + "' image file in given folder(s)");
-                }
-                else if(paths.size() > 1)
-                {
-                    throw std::runtime_error( "Ambiguous case: Multiple source image files found in given folder(s) for the view '" + 
-                        std::to_string(view->getViewId()) + "'.");
-                }
-
-                srcImage = paths[0];
-            }
-            const std::string dstColorImage = (fs::path(outFolder) / (baseFilename + "." + image::EImageFileType_enumToString(outputFileType))).string();
-            const IntrinsicBase* cam = iterIntrinsic->second.get();
-
-            // add exposure values to images metadata
-            const double cameraExposure = view->getImage().getCameraExposureSetting().getExposure();
-            const double ev = std::log2(1.0 / cameraExposure);
-            const float exposureCompensation = float(medianCameraExposure / cameraExposure);
-            metadata.push_back(oiio::ParamValue("AliceVision:EV", float(ev)));
-            metadata.push_back(oiio::ParamValue("AliceVision:EVComp", exposureCompensation));
-
-            if(evCorrection)
-            {
-                ALICEVISION_LOG_INFO("image " << viewId << ", exposure: " << cameraExposure << ", Ev " << ev << " Ev compensation: " + std::to_string(exposureCompensation));
-            }
+        // undistort
+        if(prepared.cam->isValid() && prepared.cam->hasDistortion())
+        {
+            Image<RGBAfColor> image_ud;
+            const RGBAfColor pixZero(RGBAfColor::Zero());
+            UndistortImage(prepared.image, prepared.cam, image_ud, pixZero);
+            prepared.image.swap(image_ud);
+        }
 
-            image::Image<unsigned char> mask;
-            if(tryLoadMask(&mask, masksFolders, viewId, srcImage, maskExtension))
-            {
-                process<Image<RGBAfColor>>(dstColorImage, cam, metadata, srcImage, evCorrection, exposureCompensation, [&mask] (Image<RGBAfColor> & image)
-                {
-                    if(image.Width() * image.Height() != mask.Width() * mask.Height())
-                    {
-                        ALICEVISION_LOG_WARNING("Invalid image mask size: mask is ignored.");
-                        return;
-                    }
-
-                    for(int pix = 0; pix < image.Width() * image.Height(); ++pix)
-                    {
-                        const bool masked = (mask(pix) == 0);
-                        image(pix).a() = masked ? 0.f : 1.f;
-                    }
-                });
-            }
-            else
-            {
-                const auto noMaskingFunc = [] (Image<RGBAfColor> & image) {};
-                process<Image<RGBAfColor>>(dstColorImage, cam, metadata, srcImage, evCorrection, exposureCompensation, noMaskingFunc);
-            }
+        pendingWrites.push_back(std::async(std::launch::async, [&writeOptions](PreparedImage toWrite) {
+            writeImage(toWrite.dstColorImage, toWrite.image, writeOptions, toWrite.metadata);
+        }, std::move(prepared)));
+        while(pendingWrites.size() > static_cast<std::size_t>(std::max(0, maxPendingWrites)))
+        {
+            pendingWrites.front().get();
+            pendingWrites.pop_front();
         }
 
         ++progressDisplay;
     }
 
+    for(auto& pendingWrite : pendingWrites)
+        pendingWrite.get();
+
     return true;
 }
 
@@ -293,6 +342,9 @@ int aliceVision_main(int argc, char *argv[])
     bool saveMetadata = true;
     bool saveMatricesTxtFiles = false;
     bool evCorrection = false;
+    image::EImageExrCompression exrCompressionMethod = image::EImageExrCompression::Auto;
+    int exrCompressionLevel = 0;
+    int maxPendingWrites = 4;
 
     po::options_description requiredParams("Required parameters");
     requiredParams.add_options()
@@ -322,7 +374,16 @@ int aliceVision_main(int argc, char *argv[])
         ("rangeSize", po::value<int>(&rangeSize)->default_value(rangeSize),
          "Range size.")
         ("evCorrection", po::value<bool>(&evCorrection)->default_value(evCorrection),
-         "Correct exposure value.");
+         "Correct exposure value.")
+        ("exrCompressionMethod", po::value<image::EImageExrCompression>(&exrCompressionMethod)->default_value(exrCompressionMethod),
+         ("Compression method for EXR images: " + image::EImageExrCompression_informations()).c_str())
+        ("exrCompressionLevel", po::value<int>(&exrCompressionLevel)->default_value(exrCompressionLevel),
+         "Compression Level for EXR images.\n"
+         "Only dwaa, dwab, zip and zips compression methods are concerned.\n"
+         "dwaa/dwab: value must be strictly positive.\n"
+         "zip/zips: value must be between 1 and 9.")
+        ("maxPendingWrites", po::value<int>(&maxPendingWrites)->default_value(maxPendingWrites),
+         "Maximum number of undistorted images waiting to be written while the next images are processed.");
 
     CmdLine cmdline("AliceVision prepareDenseScene");
     cmdline.add(requiredParams);
@@ -374,9 +435,14 @@ int aliceVision_main(int argc, char *argv[])
         rangeStart = 0;
     }
 
+    image::ImageWriteOptions writeOptions;
+    writeOptions.exrCompressionMethod(exrCompressionMethod);
+    writeOptions.exrCompressionLevel(exrCompressionLevel);
+
     // export
     if(prepareDenseScene(sfmData, imagesFolders, masksFolders, maskExtension, rangeStart, rangeEnd,
-                         outFolder, outputFileType, saveMetadata, saveMatricesTxtFiles, evCorrection))
+                         outFolder, outputFileType, writeOptions, saveMetadata, saveMatricesTxtFiles, evCorrection,
+                         maxPendingWrites))
         return EXIT_SUCCESS;
 
     return EXIT_FAILURE;
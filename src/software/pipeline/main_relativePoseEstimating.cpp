@@ -40,12 +40,16 @@
 
 #include <aliceVision/sfm/pipeline/relativePoses.hpp>
 
+#include <algorithm>
 #include <cstdlib>
+#include <map>
+#include <random>
+#include <vector>
 
 // These constants define the current software version.
 // They must be updated when the command line is changed.
 #define ALICEVISION_SOFTWARE_VERSION_MAJOR 1
-#define ALICEVISION_SOFTWARE_VERSION_MINOR 0
+#define ALICEVISION_SOFTWARE_VERSION_MINOR 1
 
 using namespace aliceVision;
 
@@ -192,19 +196,72 @@ void computeCovisibility(std::map<Pair, unsigned int>& covisibility, const track
             {
                 p.second = next->first;
 
-                if(covisibility.find(p) == covisibility.end())
-                {
-                    covisibility[p] = 0;
-                }
-                else
-                {
-                    covisibility[p]++;
-                }
+                covisibility[p]++;
             }
         }
     }
 }
 
+/**
+ * @brief Select the pairs of a chunk worth a robust estimation, from the most to the least co-visible.
+ * The selection is a cheap pre-scoring on the number of common tracks, so the robust estimations
+ * are only run on the promising pairs.
+ * @param[in] covisiblePairs all the co-visible pairs with their number of common tracks
+ * @param[in] chunkStart first pair index of the chunk
+ * @param[in] chunkEnd last pair index of the chunk (excluded)
+ * @param[in] minInliers the pairs with fewer common tracks cannot have enough inliers
+ * @param[in] maxPairsPerView if > 0, only the pairs among the maxPairsPerView most co-visible pairs of one of their views are kept
+ * @return the selected pairs, sorted by decreasing number of common tracks
+ */
+std::vector<std::pair<Pair, unsigned int>> selectCandidatePairs(const std::vector<std::pair<Pair, unsigned int>>& covisiblePairs,
+                                                                int chunkStart, int chunkEnd, std::size_t minInliers, int maxPairsPerView)
+{
+    const auto isMoreCovisible = [&](std::size_t a, std::size_t b) {
+        return covisiblePairs[a].second > covisiblePairs[b].second || (covisiblePairs[a].second == covisiblePairs[b].second && a < b);
+    };
+
+    // the best pairs of each view are computed on all the pairs, so the selection does not depend on the chunks
+    std::vector<bool> keep(covisiblePairs.size(), maxPairsPerView <= 0);
+    if(maxPairsPerView > 0)
+    {
+        std::map<IndexT, std::vector<std::size_t>> pairsPerView;
+        for(std::size_t i = 0; i < covisiblePairs.size(); ++i)
+        {
+            pairsPerView[covisiblePairs[i].first.first].push_back(i);
+            pairsPerView[covisiblePairs[i].first.second].push_back(i);
+        }
+
+        for(auto& viewPairs : pairsPerView)
+        {
+            std::vector<std::size_t>& indices = viewPairs.second;
+            const std::size_t nbBest = std::min(indices.size(), static_cast<std::size_t>(maxPairsPerView));
+            std::partial_sort(indices.begin(), indices.begin() + nbBest, indices.end(), isMoreCovisible);
+            for(std::size_t k = 0; k < nbBest; ++k)
+            {
+                keep[indices[k]] = true;
+            }
+        }
+    }
+
+    std::vector<std::size_t> selected;
+    for(int i = chunkStart; i < chunkEnd; ++i)
+    {
+        if(keep[i] && covisiblePairs[i].second >= minInliers)
+        {
+            selected.push_back(i);
+        }
+    }
+    std::sort(selected.begin(), selected.end(), isMoreCovisible);
+
+    std::vector<std::pair<Pair, unsigned int>> candidatePairs;
+    candidatePairs.reserve(selected.size());
+    for(const std::size_t i : selected)
+    {
+        candidatePairs.push_back(covisiblePairs[i]);
+    }
+    return candidatePairs;
+}
+
 double computeAreaScore(
     const std::vector<Eigen::Vector2d> & refPts,
     const std::vector<Eigen::Vector2d> & nextPts,
@@ -249,6 +306,7 @@ int aliceVision_main(int argc, char** argv)
     int rangeSize = 1;
     const size_t minInliers = 35;
     bool enforcePureRotation = false;
+    int maxPairsPerView = 0;
 
     // user optional parameters
     std::string describerTypesName = feature::EImageDescriberType_enumToString(feature::EImageDescriberType::SIFT);
@@ -267,6 +325,7 @@ int aliceVision_main(int argc, char** argv)
     ("featuresFolders,f", po::value<std::vector<std::string>>(&featuresFolders)->multitoken(), "Path to folder(s) containing the extracted features.")
     ("describerTypes,d", po::value<std::string>(&describerTypesName)->default_value(describerTypesName),feature::EImageDescriberType_informations().c_str())
     ("enforcePureRotation,e", po::value<bool>(&enforcePureRotation)->default_value(enforcePureRotation), "Enforce pure rotation in estimation.")
+    ("maxPairsPerView", po::value<int>(&maxPairsPerView)->default_value(maxPairsPerView), "Only estimate the relative pose of the pairs among the N pairs with the most common tracks of one of their views. 0 means no limit.")
     ("rangeStart", po::value<int>(&rangeStart)->default_value(rangeStart), "Range image index start.")
     ("rangeSize", po::value<int>(&rangeSize)->default_value(rangeSize), "Range size.");
 
@@ -282,8 +341,6 @@ int aliceVision_main(int argc, char** argv)
     // set maxThreads
     HardwareContext hwc = cmdline.getHardwareContext();
     omp_set_num_threads(hwc.getMaxThreads());
-    
-    std::mt19937 randomNumberGenerator(randomSeed);
 
     // load input SfMData scene
     sfmData::SfMData sfmData;
@@ -332,26 +389,21 @@ int aliceVision_main(int argc, char** argv)
 
     // Load tracks
     ALICEVISION_LOG_INFO("Load tracks");
-    std::ifstream tracksFile(tracksFilename);
-    if(tracksFile.is_open() == false)
+    // the tracks per view are read from a binary tracks file, computed for a JSON one
+    track::TracksMap mapTracks;
+    track::TracksPerView mapTracksPerView;
+    if(!track::loadTracks(mapTracks, mapTracksPerView, tracksFilename))
     {
         ALICEVISION_LOG_ERROR("The input tracks file '" + tracksFilename + "' cannot be read.");
         return EXIT_FAILURE;
     }
-    std::stringstream buffer;
-    buffer << tracksFile.rdbuf();
-    boost::json::value jv = boost::json::parse(buffer.str());
-    track::TracksMap mapTracks(track::flat_map_value_to<track::Track>(jv));
 
-    // Compute tracks per view
-    ALICEVISION_LOG_INFO("Estimate tracks per view");
-    track::TracksPerView mapTracksPerView;
+    // Tracks per view
     for(const auto& viewIt : sfmData.getViews())
     {
-        // create an entry in the map
+        // create an entry in the map for the views without tracks
         mapTracksPerView[viewIt.first];
     }
-    track::computeTracksPerView(mapTracks, mapTracksPerView);
 
     ALICEVISION_LOG_INFO("Compute co-visibility");
     std::map<Pair, unsigned int> covisibility;
@@ -363,22 +415,31 @@ int aliceVision_main(int argc, char** argv)
     ss << outputDirectory << "/pairs_" << rangeStart << ".json";
     std::ofstream of(ss.str());
 
-    std::vector<sfm::ReconstructedPair> reconstructedPairs;
+    const std::vector<std::pair<Pair, unsigned int>> covisiblePairs(covisibility.begin(), covisibility.end());
 
-    double ratioChunk = double(covisibility.size()) / double(sfmData.getViews().size());
+    double ratioChunk = double(covisiblePairs.size()) / double(sfmData.getViews().size());
     int chunkStart = int(double(rangeStart) * ratioChunk);
     int chunkEnd = int(double(rangeStart + rangeSize) * ratioChunk);
 
-    //For each covisible pair
-#pragma omp parallel for
-    for(int posPairs = chunkStart; posPairs < chunkEnd; posPairs++)
-    {
-        auto iterPairs = covisibility.begin();
-        std::advance(iterPairs, posPairs);
+    const std::vector<std::pair<Pair, unsigned int>> candidatePairs =
+        selectCandidatePairs(covisiblePairs, chunkStart, chunkEnd, minInliers, maxPairsPerView);
+    ALICEVISION_LOG_INFO(candidatePairs.size() << " candidate pairs out of " << (chunkEnd - chunkStart) << " co-visible pairs in the chunk.");
+
+    const int nbCandidatePairs = candidatePairs.size();
+    std::vector<sfm::ReconstructedPair> estimatedPairs(nbCandidatePairs);
+    std::vector<unsigned char> estimated(nbCandidatePairs, 0);
 
+    //For each candidate pair, the most co-visible ones first
+#pragma omp parallel for schedule(dynamic)
+    for(int posPairs = 0; posPairs < nbCandidatePairs; posPairs++)
+    {
         //Retrieve pair information
-        IndexT refImage = iterPairs->first.first;
-        IndexT nextImage = iterPairs->first.second;
+        IndexT refImage = candidatePairs[posPairs].first.first;
+        IndexT nextImage = candidatePairs[posPairs].first.second;
+
+        // the random generator of a pair only depends on the pair, the results do not depend on the threads
+        std::seed_seq seed{static_cast<IndexT>(randomSeed), refImage, nextImage};
+        std::mt19937 randomNumberGenerator(seed);
 
         const sfmData::View& refView = sfmData.getView(refImage);
         const sfmData::View& nextView = sfmData.getView(nextImage);
@@ -388,6 +449,10 @@ int aliceVision_main(int argc, char** argv)
             sfmData.getIntrinsicsharedPtr(nextView.getIntrinsicId());
         std::shared_ptr<camera::Pinhole> refPinhole = std::dynamic_pointer_cast<camera::Pinhole>(refIntrinsics);
         std::shared_ptr<camera::Pinhole> nextPinhole = std::dynamic_pointer_cast<camera::Pinhole>(nextIntrinsics);
+        if(!enforcePureRotation && (refPinhole == nullptr || nextPinhole == nullptr))
+        {
+            continue;
+        }
 
         aliceVision::track::TracksMap mapTracksCommon;
         track::getCommonTracksInImagesFast({refImage, nextImage}, mapTracks, mapTracksPerView, mapTracksCommon);
@@ -480,8 +545,8 @@ int aliceVision_main(int argc, char** argv)
         }
 
         //Compute matched points coverage of image
-        double areaRef = refPinhole->w() * refPinhole->h();
-        double areaNext = nextPinhole->w() * nextPinhole->h();
+        double areaRef = refIntrinsics->w() * refIntrinsics->h();
+        double areaNext = nextIntrinsics->w() * nextIntrinsics->h();
         double areaScore = computeAreaScore(refpts, nextpts, areaRef, areaNext);
 
         //Compute ratio of matched points
@@ -491,19 +556,19 @@ int aliceVision_main(int argc, char** argv)
         reconstructed.score = 0.5 * score + 0.5 * areaScore;
 
 
-        //Buffered output to avoid lo
-        #pragma omp critical
-        {
-            reconstructedPairs.push_back(reconstructed);
+        estimatedPairs[posPairs] = reconstructed;
+        estimated[posPairs] = 1;
+    }
 
-            if(reconstructedPairs.size() > 1000)
-            {
-                boost::json::value jv = boost::json::value_from(reconstructedPairs);
-                of << boost::json::serialize(jv);
-                reconstructedPairs.clear();
-            }
+    std::vector<sfm::ReconstructedPair> reconstructedPairs;
+    for(int posPairs = 0; posPairs < nbCandidatePairs; posPairs++)
+    {
+        if(estimated[posPairs])
+        {
+            reconstructedPairs.push_back(estimatedPairs[posPairs]);
         }
     }
+    ALICEVISION_LOG_INFO(reconstructedPairs.size() << " relative poses estimated.");
 
     //Serialize last pairs
     {
@@ -27,14 +27,16 @@
 
 #include <aliceVision/multiview/triangulation/triangulationDLT.hpp>
 
+#include <algorithm>
 #include <cstdlib>
+#include <numeric>
 #include <random>
 #include <regex>
 
 // These constants define the current software version.
 // They must be updated when the command line is changed.
 #define ALICEVISION_SOFTWARE_VERSION_MAJOR 1
-#define ALICEVISION_SOFTWARE_VERSION_MINOR 0
+#define ALICEVISION_SOFTWARE_VERSION_MINOR 1
 
 using namespace aliceVision;
 
@@ -163,6 +165,11 @@ bool estimatePairAngle(const sfmData::SfMData & sfmData, const sfm::Reconstructe
         usedTracks.push_back(commonItem.first);
     }
 
+    if (angles.empty())
+    {
+        return false;
+    }
+
     const unsigned medianIndex = angles.size() / 2;
     std::nth_element(angles.begin(), angles.begin() + medianIndex, angles.end());
     resultAngle = angles[medianIndex];
@@ -303,6 +310,7 @@ int aliceVision_main(int argc, char** argv)
     const double minAngle = 5.0;
 
     int randomSeed = std::mt19937::default_seed;
+    int maxCandidatePairs = 0;
 
     po::options_description requiredParams("Required parameters");
     requiredParams.add_options()
@@ -313,9 +321,14 @@ int aliceVision_main(int argc, char** argv)
     ("featuresFolders,f", po::value<std::vector<std::string>>(&featuresFolders)->multitoken(), "Path to folder(s) containing the extracted features.")
     ("describerTypes,d", po::value<std::string>(&describerTypesName)->default_value(describerTypesName),feature::EImageDescriberType_informations().c_str());
 
+    po::options_description optionalParams("Optional parameters");
+    optionalParams.add_options()
+    ("maxCandidatePairs", po::value<int>(&maxCandidatePairs)->default_value(maxCandidatePairs), "Only score the N estimated pairs with the best relative pose score as initial pair candidates. 0 means no limit.");
+
     CmdLine cmdline("AliceVision SfM Bootstraping");
 
     cmdline.add(requiredParams);
+    cmdline.add(optionalParams);
     if(!cmdline.execute(argc, argv))
     {
         return EXIT_FAILURE;
@@ -357,26 +370,21 @@ int aliceVision_main(int argc, char** argv)
 
     // Load tracks
     ALICEVISION_LOG_INFO("Load tracks");
-    std::ifstream tracksFile(tracksFilename);
-    if(tracksFile.is_open() == false)
+    // the tracks per view are read from a binary tracks file, computed for a JSON one
+    track::TracksMap mapTracks;
+    track::TracksPerView mapTracksPerView;
+    if(!track::loadTracks(mapTracks, mapTracksPerView, tracksFilename))
     {
         ALICEVISION_LOG_ERROR("The input tracks file '" + tracksFilename + "' cannot be read.");
         return EXIT_FAILURE;
     }
-    std::stringstream buffer;
-    buffer << tracksFile.rdbuf();
-    boost::json::value jv = boost::json::parse(buffer.str());
-    track::TracksMap mapTracks(track::flat_map_value_to<track::Track>(jv));
 
-    // Compute tracks per view
-    ALICEVISION_LOG_INFO("Estimate tracks per view");
-    track::TracksPerView mapTracksPerView;
+    // Tracks per view
     for(const auto& viewIt : sfmData.getViews())
     {
-        // create an entry in the map
+        // create an entry in the map for the views without tracks
         mapTracksPerView[viewIt.first];
     }
-    track::computeTracksPerView(mapTracks, mapTracksPerView);
 
 
     //Result of pair estimations are stored in multiple files
@@ -401,16 +409,27 @@ int aliceVision_main(int argc, char** argv)
     }
 
 
-    //Check all pairs
-    ALICEVISION_LOG_INFO("Give a score to all pairs");
-    int count = 0;
+    // The pairs with the best relative pose score (inliers ratio and coverage) are scored first
+    std::vector<int> pairsOrder(reconstructedPairs.size());
+    std::iota(pairsOrder.begin(), pairsOrder.end(), 0);
+    std::stable_sort(pairsOrder.begin(), pairsOrder.end(), [&](int a, int b) {
+        return reconstructedPairs[a].score > reconstructedPairs[b].score;
+    });
+    if (maxCandidatePairs > 0 && pairsOrder.size() > static_cast<std::size_t>(maxCandidatePairs))
+    {
+        pairsOrder.resize(maxCandidatePairs);
+    }
 
-    double bestScore = 0.0;
-    sfm::ReconstructedPair bestPair;
-    std::vector<IndexT> bestUsedTracks;
+    //Check the candidate pairs
+    ALICEVISION_LOG_INFO("Give a score to " << pairsOrder.size() << " pairs out of " << reconstructedPairs.size());
+    const int nbCandidates = pairsOrder.size();
+    std::vector<double> pairsScore(nbCandidates, 0.0);
 
-    for (const sfm::ReconstructedPair & pair: reconstructedPairs)
+#pragma omp parallel for schedule(dynamic)
+    for (int i = 0; i < nbCandidates; ++i)
     {
+        const sfm::ReconstructedPair & pair = reconstructedPairs[pairsOrder[i]];
+
         std::vector<IndexT> usedTracks;
         double angle = 0.0;
         if (!estimatePairAngle(sfmData, pair, mapTracks, mapTracksPerView, featuresPerView, maxEpipolarDistance, angle, usedTracks))
@@ -426,16 +445,23 @@ int aliceVision_main(int argc, char** argv)
         double refScore = computeScore(featuresPerView, mapTracks, usedTracks, pair.reference, 16);
         double nextScore = computeScore(featuresPerView, mapTracks, usedTracks, pair.next, 16);
 
-        double score = std::min(refScore, nextScore) * radianToDegree(angle);
+        pairsScore[i] = std::min(refScore, nextScore) * radianToDegree(angle);
+    }
 
-        if (score > bestScore)
-        {
-            bestPair = pair;
-            bestScore = score;
-            bestUsedTracks = usedTracks;
-        }
+    // the first best candidate, the used tracks are only recomputed for this one
+    const int bestCandidate = std::distance(pairsScore.begin(), std::max_element(pairsScore.begin(), pairsScore.end()));
+    if (nbCandidates == 0 || pairsScore[bestCandidate] <= 0.0)
+    {
+        ALICEVISION_LOG_ERROR("No valid initial pair found.");
+        return EXIT_FAILURE;
     }
 
+    const sfm::ReconstructedPair & bestPair = reconstructedPairs[pairsOrder[bestCandidate]];
+    std::vector<IndexT> bestUsedTracks;
+    double bestAngle = 0.0;
+    estimatePairAngle(sfmData, bestPair, mapTracks, mapTracksPerView, featuresPerView, maxEpipolarDistance, bestAngle, bestUsedTracks);
+    ALICEVISION_LOG_INFO("Initial pair: " << bestPair.reference << ", " << bestPair.next << " (score: " << pairsScore[bestCandidate] << ").");
+
     if (!buildSfmData(sfmData, bestPair, mapTracks, featuresPerView, bestUsedTracks))
     {
         return EXIT_FAILURE;
@@ -8,6 +8,7 @@
 #include <aliceVision/cmdline/cmdline.hpp>
 #include <aliceVision/system/main.hpp>
 #include <aliceVision/system/Logger.hpp>
+#include <aliceVision/config.hpp>
 
 #include <aliceVision/sphereDetection/sphereDetection.hpp>
 
@@ -30,7 +31,7 @@
 #include <onnxruntime_cxx_api.h>
 
 #define ALICEVISION_SOFTWARE_VERSION_MAJOR 1
-#define ALICEVISION_SOFTWARE_VERSION_MINOR 0
+#define ALICEVISION_SOFTWARE_VERSION_MINOR 1
 
 namespace fs = boost::filesystem;
 namespace po = boost::program_options;
@@ -49,6 +50,8 @@ int aliceVision_main(int argc, char** argv)
     bool autoDetect;
     Eigen::Vector2f sphereCenterOffset(0, 0);
     double sphereRadius = 1.0;
+    bool detectOncePerPose = false;
+    bool useGpu = true;
 
     po::options_description requiredParams("Required parameters");
     requiredParams.add_options()
@@ -70,7 +73,11 @@ int aliceVision_main(int argc, char** argv)
         ("y,y", po::value<float>(&sphereCenterOffset(1))->default_value(0.0),
          "Sphere's center offset Y (pixels).")
         ("sphereRadius,r", po::value<double>(&sphereRadius)->default_value(1.0),
-         "Sphere's radius (pixels).");
+         "Sphere's radius (pixels).")
+        ("detectOncePerPose", po::value<bool>(&detectOncePerPose)->default_value(detectOncePerPose),
+         "Detect the sphere only on the first view of each pose and use it for all the views sharing this pose (fixed camera).")
+        ("useGpu", po::value<bool>(&useGpu)->default_value(useGpu),
+         "Run the inference on the GPU if AliceVision has been built with CUDA.");
 
     CmdLine cmdline("AliceVision sphereDetection");
     cmdline.add(requiredParams);
@@ -97,6 +104,16 @@ int aliceVision_main(int argc, char** argv)
         // ONNXRuntime session setup
         Ort::Env env(ORT_LOGGING_LEVEL_WARNING, "Sphere detector ONNX model environment");
         Ort::SessionOptions sessionOptions;
+#if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_CUDA)
+        if (useGpu)
+        {
+            const auto& api = Ort::GetApi();
+            OrtCUDAProviderOptionsV2* cudaOptions = nullptr;
+            api.CreateCUDAProviderOptions(&cudaOptions);
+            api.SessionOptionsAppendExecutionProvider_CUDA_V2(static_cast<OrtSessionOptions*>(sessionOptions), cudaOptions);
+            api.ReleaseCUDAProviderOptions(cudaOptions);
+        }
+#endif
 #if defined(_WIN32) || defined(_WIN64)
         std::wstring modelPath(inputModelPath.begin(), inputModelPath.end());
         Ort::Session session(env, modelPath.c_str(), sessionOptions);
@@ -107,7 +124,7 @@ int aliceVision_main(int argc, char** argv)
         sphereDetection::modelExplore(session);
 
         // Neural network magic
-        sphereDetection::sphereDetection(sfmData, session, fsOutputPath, inputMinScore);
+        sphereDetection::sphereDetection(sfmData, session, fsOutputPath, inputMinScore, detectOncePerPose);
     }
     else
     {
@@ -11,6 +11,7 @@
 #include <aliceVision/mesh/meshVisibility.hpp>
 #include <aliceVision/mesh/meshPostProcessing.hpp>
 #include <aliceVision/image/io.hpp>
+#include <aliceVision/image/ImageCache.hpp>
 #include <aliceVision/mvsUtils/common.hpp>
 #include <aliceVision/mvsUtils/MultiViewParams.hpp>
 #include <aliceVision/mvsUtils/ImagesCache.hpp>
@@ -28,7 +29,7 @@
 // These constants define the current software version.
 // They must be updated when the command line is changed.
 #define ALICEVISION_SOFTWARE_VERSION_MAJOR 3
-#define ALICEVISION_SOFTWARE_VERSION_MINOR 0
+#define ALICEVISION_SOFTWARE_VERSION_MINOR 2
 
 using namespace aliceVision;
 
@@ -70,7 +71,7 @@ int aliceVision_main(int argc, char* argv[])
         ("input,i", po::value<std::string>(&sfmDataFilename)->required(),
           "Dense point cloud SfMData file.")
         ("inputMesh", po::value<std::string>(&inputMeshFilepath)->required(),
-            "Input mesh to texture.")
+            "Input mesh to texture (OBJ or binary .avmesh file format).")
         ("output,o", po::value<std::string>(&outputFolder)->required(),
             "Folder for output mesh");
 
@@ -133,6 +134,12 @@ int aliceVision_main(int argc, char* argv[])
             " * Pull: For each vertex of the input mesh, pull the visibilities from the closest vertex in the reconstruction.\n"
             " * Push: For each vertex of the reconstruction, push the visibilities to the closest triangle in the input mesh.\n"
             " * PullPush: Combine results from Pull and Push results.'")
+        ("useRasterizedVisibility", po::value<bool>(&texParams.useRasterizedVisibility)->default_value(texParams.useRasterizedVisibility),
+            "Compute the triangles visibility by rendering the mesh from each camera, instead of using the vertices visibilities.")
+        ("rasterizationDownscale", po::value<unsigned int>(&texParams.rasterizationDownscale)->default_value(texParams.rasterizationDownscale),
+            "Downscale factor of the images used to render the mesh for the rasterized visibility.")
+        ("tiledAccumulation", po::value<bool>(&texParams.tiledAccumulation)->default_value(texParams.tiledAccumulation),
+            "Read each image once and accumulate all texture atlases in tiles stored on disk when they do not fit in memory.")
         ("subdivisionTargetRatio", po::value<float>(&texParams.subdivisionTargetRatio)->default_value(texParams.subdivisionTargetRatio),
             "Percentage of the density of the reconstruction as the target for the subdivision (0: disable subdivision, 0.5: half density of the reconstruction, 1: full density of the reconstruction).");
 
@@ -150,6 +157,7 @@ int aliceVision_main(int argc, char* argv[])
     omp_set_num_threads(hwc.getMaxThreads());
     oiio::attribute("threads", std::min(4, static_cast<int>(hwc.getMaxThreads())));
     oiio::attribute("exr_threads", std::min(4, static_cast<int>(hwc.getMaxThreads())));
+    image::ImageCache::configureShared(hwc);
 
     // set bump mapping file type
     bumpMappingParams.bumpMappingFileType = (bumpMappingParams.bumpType == mesh::EBumpMappingType::Normal) ? normalFileType : heightFileType;
@@ -18,6 +18,8 @@
 #include <aliceVision/config.hpp>
 
 #include <aliceVision/track/TracksBuilder.hpp>
+#include <aliceVision/track/StreamingTracksBuilder.hpp>
+#include <aliceVision/matching/io.hpp>
 #include <aliceVision/track/trackIO.hpp>
 
 #include <boost/program_options.hpp>
@@ -28,7 +30,7 @@
 // These constants define the current software version.
 // They must be updated when the command line is changed.
 #define ALICEVISION_SOFTWARE_VERSION_MAJOR 1
-#define ALICEVISION_SOFTWARE_VERSION_MINOR 0
+#define ALICEVISION_SOFTWARE_VERSION_MINOR 1
 
 using namespace aliceVision;
 
@@ -48,13 +50,14 @@ int aliceVision_main(int argc, char** argv)
     int minInputTrackLength = 2;
     bool filterTrackForks = true;
     bool useOnlyMatchesFromInputFolder = false;
+    bool streamMatches = false;
 
     // user optional parameters
     std::string describerTypesName = feature::EImageDescriberType_enumToString(feature::EImageDescriberType::SIFT);
 
     po::options_description requiredParams("Required parameters");
     requiredParams.add_options()("input,i", po::value<std::string>(&sfmDataFilename)->required(), "SfMData file.")(
-        "output,o", po::value<std::string>(&tracksFilename)->required(), "Path to the tracks file.");
+        "output,o", po::value<std::string>(&tracksFilename)->required(), "Path to the tracks file (.json, or .avtracks for the binary tracks format).");
 
     po::options_description optionalParams("Optional parameters");
     optionalParams.add_options()
@@ -66,7 +69,9 @@ int aliceVision_main(int argc, char** argv)
         ("minInputTrackLength", po::value<int>(&minInputTrackLength)->default_value(minInputTrackLength), "Minimum track length in input of SfM.")
         ("useOnlyMatchesFromInputFolder", po::value<bool>(&useOnlyMatchesFromInputFolder)->default_value(useOnlyMatchesFromInputFolder), "Use only matches from the input matchesFolder parameter.\n"
         "Matches folders previously added to the SfMData file will be ignored.")
-        ("filterTrackForks", po::value<bool>(&filterTrackForks)->default_value(filterTrackForks), "Enable/Disable the track forks removal. A track contains a fork when incoherent matches leads to multiple features in the same image for a single track.\n");
+        ("filterTrackForks", po::value<bool>(&filterTrackForks)->default_value(filterTrackForks), "Enable/Disable the track forks removal. A track contains a fork when incoherent matches leads to multiple features in the same image for a single track.\n")
+        ("streamMatches", po::value<bool>(&streamMatches)->default_value(streamMatches), "Read the match files pair by pair and build the tracks out-of-core, without loading all the matches in memory.\n"
+        "Recommended for very large match graphs.");
 
     CmdLine cmdline("AliceVision tracksBuilding");
 
@@ -102,6 +107,41 @@ int aliceVision_main(int argc, char** argv)
         return EXIT_FAILURE;
     }
 
+    if(streamMatches)
+    {
+        std::vector<std::string> allMatchesFolders;
+        if(!useOnlyMatchesFromInputFolder)
+            allMatchesFolders = sfmData.getMatchesFolders();
+        allMatchesFolders.insert(allMatchesFolders.end(), matchesFolders.begin(), matchesFolders.end());
+
+        track::StreamingTracksBuilder tracksBuilder;
+        ALICEVISION_LOG_INFO("Track building from streamed matches");
+        if(!tracksBuilder.addMatchFiles(matching::ListMatchFiles(allMatchesFolders), sfmData.getViewsKeys(), describerTypes, maxNbMatches, minNbMatches))
+        {
+            ALICEVISION_LOG_ERROR("Unable to load matches.");
+            return EXIT_FAILURE;
+        }
+
+        ALICEVISION_LOG_INFO("Track filtering");
+        tracksBuilder.filter(filterTrackForks, minInputTrackLength);
+
+        ALICEVISION_LOG_INFO("Export " << tracksBuilder.nbTracks() << " tracks to file");
+        if(track::isBinaryTracksFile(tracksFilename))
+        {
+            track::TracksMap mapTracks;
+            tracksBuilder.exportToSTL(mapTracks);
+            return track::saveTracks(mapTracks, tracksFilename) ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+
+        std::ofstream of(tracksFilename);
+        if(!tracksBuilder.exportToJsonStream(of))
+        {
+            ALICEVISION_LOG_ERROR("Unable to write the tracks file: " << tracksFilename);
+            return EXIT_FAILURE;
+        }
+        return EXIT_SUCCESS;
+    }
+
     // matches reading
     matching::PairwiseMatches pairwiseMatches;
     ALICEVISION_LOG_INFO("Load features matches");
@@ -123,14 +163,10 @@ int aliceVision_main(int argc, char** argv)
     track::TracksMap mapTracks;
     tracksBuilder.exportToSTL(mapTracks);
 
-    // write the json file with the tree
+    // write the json or binary tracks file
     ALICEVISION_LOG_INFO("Export to file");
-    std::stringstream ss;
-
-    boost::json::value jv = boost::json::value_from(mapTracks);
-    std::ofstream of(tracksFilename);
-    of << boost::json::serialize(jv);
-    of.close();
+    if(!track::saveTracks(mapTracks, tracksFilename))
+        return EXIT_FAILURE;
 
     return EXIT_SUCCESS;
 }
@@ -0,0 +1,52 @@
+#include <aliceVision/matchingImageCollection/pairBuilder.hpp>
+#include <aliceVision/sfmDataIO/sfmDataIO.hpp>
+#include <aliceVision/sfmPipeline/InMemoryPipeline.hpp>
+
+#include <iostream>
+
+using namespace aliceVision;
+
+// Structure from motion of the views of an SfMData file, without any intermediate file:
+// testAV3rdSfM <input sfmData> <output sfmData> <output folder of the reconstruction statistics>
+int main(int argc, char** argv)
+{
+    if (argc != 4)
+    {
+        std::cerr << "Usage: " << argv[0] << " <input sfmData> <output sfmData> <output folder>" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    sfmData::SfMData sfmData;
+    if (!sfmDataIO::Load(sfmData, argv[1], sfmDataIO::ESfMData::ALL))
+        return EXIT_FAILURE;
+
+    const std::vector<feature::EImageDescriberType> describerTypes = {feature::EImageDescriberType::SIFT};
+    std::vector<std::shared_ptr<feature::ImageDescriber>> imageDescribers;
+    for (const feature::EImageDescriberType describerType : describerTypes)
+        imageDescribers.push_back(feature::createImageDescriber(describerType));
+
+    feature::RegionsPerView regionsPerView;
+    sfmPipeline::extractFeatures(sfmData, imageDescribers, HardwareContext(), regionsPerView);
+
+    std::mt19937 randomNumberGenerator(std::mt19937::default_seed);
+    matching::PairwiseMatches pairwiseMatches;
+    sfmPipeline::matchFeatures(sfmData,
+                               regionsPerView,
+                               exhaustivePairs(sfmData.getViews()),
+                               describerTypes,
+                               sfmPipeline::FeatureMatchingParams(),
+                               randomNumberGenerator,
+                               pairwiseMatches);
+
+    sfmData::SfMData reconstruction;
+    if (!sfmPipeline::reconstruct(sfmData,
+                                  regionsPerView,
+                                  pairwiseMatches,
+                                  sfm::ReconstructionEngine_sequentialSfM::Params(),
+                                  argv[3],
+                                  std::mt19937::default_seed,
+                                  reconstruction))
+        return EXIT_FAILURE;
+
+    return sfmDataIO::Save(reconstruction, argv[2], sfmDataIO::ESfMData::ALL) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -13,6 +13,8 @@
 #include <aliceVision/config.hpp>
 #include <aliceVision/utils/filesIO.hpp>
 #include <aliceVision/utils/regexFilter.hpp>
+#include <aliceVision/system/MemoryInfo.hpp>
+#include <aliceVision/alicevision_omp.hpp>
 
 #include <dependencies/vectorGraphics/svgDrawer.hpp>
 
@@ -26,6 +28,9 @@
 #include <opencv2/imgcodecs.hpp>
 #include <opencv2/mcc.hpp>
 
+#include <algorithm>
+#include <atomic>
+#include <cmath>
 #include <string>
 #include <fstream>
 #include <vector>
@@ -34,7 +39,7 @@
 // These constants define the current software version.
 // They must be updated when the command line is changed.
 #define ALICEVISION_SOFTWARE_VERSION_MAJOR 1
-#define ALICEVISION_SOFTWARE_VERSION_MINOR 0
+#define ALICEVISION_SOFTWARE_VERSION_MINOR 1
 
 using namespace aliceVision;
 
@@ -143,6 +148,8 @@ struct ImageOptions {
 struct CCheckerDetectionSettings {
     cv::mcc::TYPECHART typechart;
     unsigned int maxCountByImage;
+    /// maximum dimension of the image for the coarse detection, 0 to detect on the full resolution image only
+    int coarseDetectionSize;
     std::string outputData;
     bool debug;
 };
@@ -338,10 +345,18 @@ struct MacbethCCheckerQuad : Quad {
 };
 
 
-void detectColorChecker(
+/**
+ * @brief Detect the color checkers of the image with the given detector.
+ *
+ * If coarseDetectionSize is set, the checkers are first detected on a downscaled image and then refined
+ * on the full resolution image, only in a region around each of them.
+ * The full resolution image is entirely processed if nothing is found this way.
+ */
+bool detectColorChecker(
     std::vector<MacbethCCheckerQuad> &detectedCCheckers,
-    ImageOptions& imgOpt,
-    CCheckerDetectionSettings &settings)
+    const ImageOptions& imgOpt,
+    const CCheckerDetectionSettings &settings,
+    cv::mcc::CCheckerDetector& detector)
 {
     const std::string outputFolder = fs::path(settings.outputData).parent_path().string() + "/";
     const std::string imgSrcPath = imgOpt.imgFsPath.string();
@@ -356,20 +371,60 @@ void detectColorChecker(
     if(imgBGR.cols == 0 || imgBGR.rows == 0)
     {
         ALICEVISION_LOG_ERROR("Image at: '" << imgSrcPath << "'.\n" << "is empty.");
-        exit(EXIT_FAILURE);
+        return false;
     }
 
-    cv::Ptr<cv::mcc::CCheckerDetector> detector = cv::mcc::CCheckerDetector::create();
+    std::vector<cv::Ptr<cv::mcc::CChecker>> cccheckers;
 
-    if(!detector->process(imgBGR, settings.typechart, settings.maxCountByImage))
+    const int maxSize = std::max(imgBGR.cols, imgBGR.rows);
+    if(settings.coarseDetectionSize > 0 && maxSize > settings.coarseDetectionSize)
     {
-        ALICEVISION_LOG_INFO("Checker not detected in image at: '" << imgSrcPath << "'");
-        return;
+        // Coarse detection on the downscaled image
+        const double scale = static_cast<double>(settings.coarseDetectionSize) / maxSize;
+        cv::Mat coarseBGR;
+        cv::resize(imgBGR, coarseBGR, cv::Size(), scale, scale, cv::INTER_AREA);
+
+        std::vector<cv::Rect> regions;
+        if(detector.process(coarseBGR, settings.typechart, settings.maxCountByImage))
+        {
+            const cv::Rect imageRect(0, 0, imgBGR.cols, imgBGR.rows);
+            for(const cv::Ptr<cv::mcc::CChecker>& coarseChecker : detector.getListColorChecker())
+            {
+                std::vector<cv::Point2f> box = coarseChecker->getBox();
+                for(auto& p : box)
+                    p /= scale;
+
+                // Region around the checker, with a margin for the inaccuracy of the coarse detection
+                const cv::Rect boxRect = cv::boundingRect(box);
+                const int margin = std::max(boxRect.width, boxRect.height) / 4 + static_cast<int>(std::ceil(1.0 / scale));
+                regions.push_back(cv::Rect(boxRect.x - margin, boxRect.y - margin, boxRect.width + 2 * margin, boxRect.height + 2 * margin) & imageRect);
+            }
+        }
+
+        // Refinement on the full resolution image
+        for(const cv::Rect& region : regions)
+        {
+            if(detector.process(imgBGR, settings.typechart, std::vector<cv::Rect>{region}, 1))
+            {
+                for(const cv::Ptr<cv::mcc::CChecker>& cchecker : detector.getListColorChecker())
+                    cccheckers.push_back(cchecker);
+            }
+        }
+    }
+
+    if(cccheckers.empty())
+    {
+        if(!detector.process(imgBGR, settings.typechart, settings.maxCountByImage))
+        {
+            ALICEVISION_LOG_INFO("Checker not detected in image at: '" << imgSrcPath << "'");
+            return true;
+        }
+        cccheckers = detector.getListColorChecker();
     }
 
     int counter = 0;
 
-    for(const cv::Ptr<cv::mcc::CChecker> cchecker : detector->getListColorChecker())
+    for(const cv::Ptr<cv::mcc::CChecker> cchecker : cccheckers)
     {
         const std::string counterStr = "_" + std::to_string(++counter);
 
@@ -394,6 +449,7 @@ void detectColorChecker(
                 cv::imwrite(masksFolder + imgDestStem + counterStr + "_" + std::to_string(i) + ".jpg", ccq._cellMasks[i]);
         }
     }
+    return true;
 }
 
 
@@ -406,6 +462,8 @@ int aliceVision_main(int argc, char** argv)
     // user optional parameters
     bool debug = false;
     unsigned int maxCountByImage = 1;
+    int coarseDetectionSize = 2048;
+    int maxParallelImages = 0;
 
     po::options_description inputParams("Required parameters");
     inputParams.add_options()
@@ -419,7 +477,12 @@ int aliceVision_main(int argc, char** argv)
         ("debug", po::value<bool>(&debug),
          "Output debug data.")
         ("maxCount", po::value<unsigned int>(&maxCountByImage),
-         "Maximum color charts count to detect in a single image.");
+         "Maximum color charts count to detect in a single image.")
+        ("coarseDetectionSize", po::value<int>(&coarseDetectionSize)->default_value(coarseDetectionSize),
+         "Maximum dimension of the downscaled image used for a first detection, refined in the full resolution image around the detected charts. "
+         "If 0, the detection is done on the full resolution image only.")
+        ("maxParallelImages", po::value<int>(&maxParallelImages)->default_value(maxParallelImages),
+         "Maximum number of images processed at the same time. If 0, it is bounded by the number of cores and the available memory.");
 
     CmdLine cmdline("This program is used to perform Macbeth color checker chart detection.\n"
                     "AliceVision colorCheckerDetection");
@@ -433,10 +496,13 @@ int aliceVision_main(int argc, char** argv)
     CCheckerDetectionSettings settings;
     settings.typechart = cv::mcc::TYPECHART::MCC24;
     settings.maxCountByImage = maxCountByImage;
+    settings.coarseDetectionSize = coarseDetectionSize;
     settings.outputData = outputData;
     settings.debug = debug;
 
     std::vector< MacbethCCheckerQuad > detectedCCheckers;
+    std::vector< ImageOptions > imagesOptions;
+    std::size_t maxImagePixels = 0;
 
     // Check if inputExpression is recognized as sfm data file
     const std::string inputExt = boost::to_lower_copy(fs::path(inputExpression).extension().string());
@@ -451,14 +517,10 @@ int aliceVision_main(int argc, char** argv)
             return EXIT_FAILURE;
         }
 
-        int counter = 0;
-
-        // Detect color checker for each images
         for(const auto& viewIt : sfmData.getViews())
         {
             const sfmData::View& view = *(viewIt.second);
 
-            ALICEVISION_LOG_INFO(++counter << "/" << sfmData.getViews().size() << " - Process image at: '" << view.getImage().getImagePath() << "'.");
             ImageOptions imgOpt = {
                 view.getImage().getImagePath(),
                 std::to_string(view.getViewId()),
@@ -466,7 +528,8 @@ int aliceVision_main(int argc, char** argv)
                 view.getImage().getMetadataLensSerialNumber() };
             imgOpt.readOptions.workingColorSpace = image::EImageColorSpace::SRGB;
             imgOpt.readOptions.rawColorInterpretation = image::ERawColorInterpretation_stringToEnum(view.getImage().getRawColorInterpretation());
-            detectColorChecker(detectedCCheckers, imgOpt, settings);
+            imagesOptions.push_back(imgOpt);
+            maxImagePixels = std::max(maxImagePixels, static_cast<std::size_t>(view.getImage().getWidth()) * view.getImage().getHeight());
         }
 
     }
@@ -506,18 +569,65 @@ int aliceVision_main(int argc, char** argv)
             ALICEVISION_LOG_INFO(size << " images found.");
         }
 
-        int counter = 0;
         for(const std::string& imgSrcPath : filesStrPaths)
         {
-            ALICEVISION_LOG_INFO(++counter << "/" << size << " - Process image at: '" << imgSrcPath << "'.");
             ImageOptions imgOpt;
             imgOpt.imgFsPath = imgSrcPath;
             imgOpt.readOptions.workingColorSpace = image::EImageColorSpace::SRGB;
-            detectColorChecker(detectedCCheckers, imgOpt, settings);
+            imagesOptions.push_back(imgOpt);
+
+            int width = 0, height = 0;
+            image::readImageSize(imgSrcPath, width, height);
+            maxImagePixels = std::max(maxImagePixels, static_cast<std::size_t>(width) * height);
         }
 
     }
 
+    // Number of images processed at the same time:
+    // each of them needs the float RGBA image, its 8 bits BGR conversion and the detector buffers
+    int nbParallelImages = maxParallelImages;
+    if(nbParallelImages <= 0)
+    {
+        const std::size_t imageMemory = std::max<std::size_t>(maxImagePixels, 1) * (sizeof(image::RGBAfColor) + 4 * 3);
+        const system::MemoryInfo memoryInfo = system::getMemoryInfo();
+        nbParallelImages = omp_get_max_threads();
+        if(memoryInfo.availableRam > 0)
+            nbParallelImages = std::min<int>(nbParallelImages, static_cast<int>(memoryInfo.availableRam / 2 / imageMemory));
+        nbParallelImages = std::max(1, nbParallelImages);
+    }
+    nbParallelImages = std::min<int>(nbParallelImages, std::max<std::size_t>(imagesOptions.size(), 1));
+
+    // One detector per thread, reused for all its images
+    std::vector<cv::Ptr<cv::mcc::CCheckerDetector>> detectors(nbParallelImages);
+    for(auto& detector : detectors)
+        detector = cv::mcc::CCheckerDetector::create();
+
+    // Detected checkers per image, gathered in the images order
+    std::vector<std::vector<MacbethCCheckerQuad>> imagesCCheckers(imagesOptions.size());
+    std::atomic<bool> hasError(false);
+    int counter = 0;
+
+    #pragma omp parallel for num_threads(nbParallelImages) schedule(dynamic) if(nbParallelImages > 1)
+    for(int i = 0; i < static_cast<int>(imagesOptions.size()); ++i)
+    {
+        if(hasError)
+            continue;
+
+        int imageIndex;
+        #pragma omp atomic capture
+        imageIndex = ++counter;
+        ALICEVISION_LOG_INFO(imageIndex << "/" << imagesOptions.size() << " - Process image at: '" << imagesOptions[i].imgFsPath.string() << "'.");
+
+        if(!detectColorChecker(imagesCCheckers[i], imagesOptions[i], settings, *detectors[omp_get_thread_num()]))
+            hasError = true;
+    }
+
+    if(hasError)
+        return EXIT_FAILURE;
+
+    for(const auto& imageCCheckers : imagesCCheckers)
+        detectedCCheckers.insert(detectedCCheckers.end(), imageCCheckers.begin(), imageCCheckers.end());
+
     if (detectedCCheckers.empty())
     {
         ALICEVISION_LOG_INFO("Could not find any macbeth color checker in the input images.");
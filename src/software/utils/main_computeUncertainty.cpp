@@ -5,24 +5,24 @@
 
 #include <aliceVision/sfm/sfm.hpp>
 #include <aliceVision/sfm/bundle/BundleAdjustmentCeres.hpp>
+#include <aliceVision/sfm/bundle/BundleAdjustmentUncertainty.hpp>
 #include <aliceVision/sfmData/SfMData.hpp>
 #include <aliceVision/sfmDataIO/sfmDataIO.hpp>
+#include <aliceVision/system/Logger.hpp>
+#include <aliceVision/system/Timer.hpp>
 #include <aliceVision/cmdline/cmdline.hpp>
 #include <aliceVision/system/main.hpp>
 #include <aliceVision/config.hpp>
 
-#include <uncertaintyTE/uncertainty.h>
-#include <uncertaintyTE/IO.h>
-
 #include <boost/program_options.hpp>
 
+#include <fstream>
 #include <string>
-#include <sstream>
 #include <vector>
 
 // These constants define the current software version.
 // They must be updated when the command line is changed.
-#define ALICEVISION_SOFTWARE_VERSION_MAJOR 1
+#define ALICEVISION_SOFTWARE_VERSION_MAJOR 2
 #define ALICEVISION_SOFTWARE_VERSION_MINOR 0
 
 using namespace aliceVision;
@@ -31,128 +31,201 @@ using namespace aliceVision::sfmData;
 using namespace aliceVision::sfmDataIO;
 namespace po = boost::program_options;
 
+/**
+ * @brief Choose the Jacobian columns fixing the gauge of the reconstruction (7 degrees of freedom).
+ *
+ * The 6 parameters of a reference pose are fixed (the first locked pose if any) and, if there is no other locked pose,
+ * the scale is fixed with the translation coordinate of the farthest pose that varies the most with the scale.
+ */
+std::vector<int> getGaugeColumns(const SfMData& sfmData, const BundleAdjustmentCeres::JacobianLayout& layout)
+{
+    std::vector<int> fixedColumns;
+    if (layout.posesBlock.empty())
+        return fixedColumns;
+
+    std::vector<IndexT> lockedPoses;
+    IndexT referencePoseId = UndefinedIndexT;
+    for (const auto& posePair : sfmData.getPoses())
+    {
+        if (layout.posesBlock.count(posePair.first) == 0)
+            continue;
+        if (posePair.second.isLocked())
+            lockedPoses.push_back(posePair.first);
+        else if (referencePoseId == UndefinedIndexT)
+            referencePoseId = posePair.first;
+    }
+    if (!lockedPoses.empty())
+        referencePoseId = lockedPoses.front();
+    if (referencePoseId == UndefinedIndexT)
+        return fixedColumns;
+
+    const std::pair<int, int>& referenceBlock = layout.blocks.at(layout.posesBlock.at(referencePoseId));
+    for (int k = 0; k < referenceBlock.second; ++k)
+        fixedColumns.push_back(referenceBlock.first + k);
+
+    if (lockedPoses.size() > 1)
+        return fixedColumns;
+
+    // scale: the translation of a pose varies with -R.(C - C_ref)
+    const Vec3 referenceCenter = sfmData.getAbsolutePose(referencePoseId).getTransform().center();
+    IndexT farthestPoseId = UndefinedIndexT;
+    double farthestDistance = 0.0;
+    for (const auto& posePair : sfmData.getPoses())
+    {
+        if (layout.posesBlock.count(posePair.first) == 0 || layout.blocks.at(layout.posesBlock.at(posePair.first)).second != 6)
+            continue;
+        const double distance = (posePair.second.getTransform().center() - referenceCenter).norm();
+        if (distance > farthestDistance)
+        {
+            farthestDistance = distance;
+            farthestPoseId = posePair.first;
+        }
+    }
+    if (farthestPoseId == UndefinedIndexT)
+        return fixedColumns;
+
+    const geometry::Pose3& farthestPose = sfmData.getAbsolutePose(farthestPoseId).getTransform();
+    const Vec3 scaleDirection = farthestPose.rotation() * (farthestPose.center() - referenceCenter);
+    int scaleCoordinate;
+    scaleDirection.cwiseAbs().maxCoeff(&scaleCoordinate);
+    fixedColumns.push_back(layout.blocks.at(layout.posesBlock.at(farthestPoseId)).first + 3 + scaleCoordinate);
 
-int aliceVision_main(int argc, char **argv)
+    return fixedColumns;
+}
+
+int aliceVision_main(int argc, char** argv)
 {
-  // command-line parameters
-  std::string sfmDataFilename;
-  std::string outSfMDataFilename;
-  std::string outputStats;
-  std::string algorithm = cov::EAlgorithm_enumToString(cov::eAlgorithmSvdTaylorExpansion);
-  bool debug = false;
-
-  params.add_options()
-    ("input,i", po::value<std::string>(&sfmDataFilename)->required(),
-      "SfMData file to align.")
-  ("output,o", po::value<std::string>(&outSfMDataFilename)->required(),
-    "Output SfMData scene.")
-  ("outputCov,c", po::value<std::string>(&outputStats),
-    "Output covariances file.")
-  ("algorithm,a", po::value<std::string>(&algorithm)->default_value(algorithm),
-    "Algorithm.")
-  ("debug,d", po::value<bool>(&debug)->default_value(debug),
-    "Enable creation of debug files in the current folder.")
-    ("verboseLevel,v", po::value<std::string>(&verboseLevel)->default_value(verboseLevel),
-      "verbosity level (fatal,  error, warning, info, debug, trace).");
-
-  CmdLine cmdline("AliceVision computeUncertainty");
-  cmdline.add(params);
-  if (!cmdline.execute(argc, argv))
-  {
-      return EXIT_FAILURE;
-  }
-  
-  if (sfmDataFilename.empty() ||
-      outSfMDataFilename.empty())
-  {
-    std::cerr << "Invalid input or output filename." << std::endl;
-    return EXIT_FAILURE;
-  }
-
-  // Load input scene
-  SfMData sfmData;
-  if (!Load(sfmData, sfmDataFilename, ESfMData(ALL)))
-  {
-    std::cerr << std::endl
-      << "The input SfMData file \"" << sfmDataFilename << "\" cannot be read." << std::endl;
-    return EXIT_FAILURE;
-  }
-
-  ceres::CRSMatrix jacobian;
-  {
-    BundleAdjustmentCeres bundleAdjustmentObj;
-    BundleAdjustment::ERefineOptions refineOptions = BundleAdjustment::REFINE_ROTATION | BundleAdjustment::REFINE_TRANSLATION | BundleAdjustment::REFINE_STRUCTURE;
-    bundleAdjustmentObj.createJacobian(sfmData, refineOptions, jacobian);
-  }
-
-  {
-    cov::Options options;
-    // Configure covariance engine (find the indexes of the most distatnt points etc.)
-    // setPts2Fix(opt, mutable_points.size() / 3, mutable_points.data());
-    options._numCams = sfmData.getValidViews().size();
-    options._camParams = 6;
-    options._numPoints = sfmData.getLandmarks().size();
-    options._numObs = jacobian.num_rows / 2;
-    options._algorithm = cov::EAlgorithm_stringToEnum(algorithm);
-    options._epsilon = 1e-10;
-    options._lambda = -1;
-    options._svdRemoveN = -1;
-    options._maxIterTE = -1;
-    options._debug = debug;
-
-    cov::Statistic statistic;
-    std::vector<double> points3D;
-    points3D.reserve(sfmData.getLandmarks().size() * 3);
-    for(auto& landmarkIt: sfmData.getLandmarks())
+    // command-line parameters
+    std::string sfmDataFilename;
+    std::string outSfMDataFilename;
+    std::string outputStats;
+
+    po::options_description requiredParams("Required parameters");
+    requiredParams.add_options()
+        ("input,i", po::value<std::string>(&sfmDataFilename)->required(),
+         "SfMData file.")
+        ("output,o", po::value<std::string>(&outSfMDataFilename)->required(),
+         "Output SfMData scene.");
+
+    po::options_description optionalParams("Optional parameters");
+    optionalParams.add_options()
+        ("outputCov,c", po::value<std::string>(&outputStats),
+         "Output covariances file: one line per pose and per landmark with its id and its covariance matrix (row-major).");
+
+    CmdLine cmdline("AliceVision computeUncertainty");
+    cmdline.add(requiredParams);
+    cmdline.add(optionalParams);
+    if (!cmdline.execute(argc, argv))
+    {
+        return EXIT_FAILURE;
+    }
+
+    // Load input scene
+    SfMData sfmData;
+    if (!Load(sfmData, sfmDataFilename, ESfMData(ALL)))
+    {
+        ALICEVISION_LOG_ERROR("The input SfMData file '" << sfmDataFilename << "' cannot be read.");
+        return EXIT_FAILURE;
+    }
+
+    system::Timer timer;
+
+    ceres::CRSMatrix crsJacobian;
+    BundleAdjustmentCeres::JacobianLayout layout;
+    {
+        BundleAdjustmentCeres bundleAdjustmentObj;
+        BundleAdjustment::ERefineOptions refineOptions =
+          BundleAdjustment::REFINE_ROTATION | BundleAdjustment::REFINE_TRANSLATION | BundleAdjustment::REFINE_STRUCTURE;
+        bundleAdjustmentObj.createJacobian(sfmData, refineOptions, crsJacobian, layout);
+    }
+    const Eigen::SparseMatrix<double, Eigen::RowMajor> jacobian = Eigen::Map<const Eigen::SparseMatrix<double, Eigen::RowMajor>>(
+      crsJacobian.num_rows, crsJacobian.num_cols, crsJacobian.values.size(), crsJacobian.rows.data(), crsJacobian.cols.data(), crsJacobian.values.data());
+    crsJacobian = ceres::CRSMatrix();
+
+    ALICEVISION_LOG_INFO("Jacobian: " << jacobian.rows() << " residuals, " << jacobian.cols() << " parameters (" << timer.elapsed() << " s).");
+
+    // landmarks and camera parameter blocks (poses, rigs, intrinsics)
+    std::vector<int> blocksCamera(layout.blocks.size(), -1);
+    std::vector<IndexT> landmarksId;
+    std::vector<int> landmarksColumn;
+    for (const auto& landmarkPair : sfmData.getLandmarks())
+    {
+        const auto it = layout.landmarksBlock.find(landmarkPair.first);
+        if (it == layout.landmarksBlock.end())
+            continue;
+        landmarksId.push_back(landmarkPair.first);
+        landmarksColumn.push_back(layout.blocks.at(it->second).first);
+        blocksCamera[it->second] = -2;
+    }
+    std::vector<std::pair<int, int>> cameraBlocks;
+    for (std::size_t b = 0; b < layout.blocks.size(); ++b)
     {
-      double* p = landmarkIt.second.X.data();
-      points3D.push_back(p[0]);
-      points3D.push_back(p[1]);
-      points3D.push_back(p[2]);
+        if (blocksCamera[b] == -2)
+            continue;
+        blocksCamera[b] = cameraBlocks.size();
+        cameraBlocks.push_back(layout.blocks[b]);
     }
 
-    cov::Uncertainty uncertainty;
+    const std::vector<int> fixedColumns = getGaugeColumns(sfmData, layout);
 
-    getCovariances(options, statistic, jacobian, &points3D[0], uncertainty);
+    std::vector<Eigen::MatrixXd> camerasCovariance;
+    std::vector<Mat3> landmarksCovariance;
+    if (!computeMarginalCovariances(jacobian, cameraBlocks, landmarksColumn, fixedColumns, camerasCovariance, landmarksCovariance))
+    {
+        ALICEVISION_LOG_ERROR("Failed to compute the covariances.");
+        return EXIT_FAILURE;
+    }
 
-    if(!outputStats.empty())
-      saveResults(outputStats, options, statistic, uncertainty);
+    ALICEVISION_LOG_INFO("Covariances computed in " << timer.elapsed() << " s.");
 
+    std::ofstream statsFile;
+    if (!outputStats.empty())
+    {
+        statsFile.open(outputStats);
+        if (!statsFile.is_open())
+        {
+            ALICEVISION_LOG_ERROR("Cannot open the output covariances file '" << outputStats << "'.");
+            return EXIT_FAILURE;
+        }
+        statsFile.precision(12);
+    }
+    const auto writeCovariance = [&statsFile](const std::string& type, IndexT id, const Eigen::MatrixXd& covariance) {
+        statsFile << type << " " << id;
+        for (int r = 0; r < covariance.rows(); ++r)
+        {
+            for (int c = 0; c < covariance.cols(); ++c)
+                statsFile << " " << covariance(r, c);
+        }
+        statsFile << "\n";
+    };
+
+    // the uncertainties are the eigenvalues of the covariances
+    for (const auto& poseBlockPair : layout.posesBlock)
+    {
+        const Eigen::MatrixXd& covariance = camerasCovariance[blocksCamera[poseBlockPair.second]];
+        if (covariance.rows() != 6)
+            continue;
+        const Eigen::SelfAdjointEigenSolver<Mat> solver(covariance, Eigen::EigenvaluesOnly);
+        sfmData._posesUncertainty[poseBlockPair.first] = solver.eigenvalues();
+        if (statsFile.is_open())
+            writeCovariance("pose", poseBlockPair.first, covariance);
+    }
+    for (std::size_t j = 0; j < landmarksId.size(); ++j)
     {
-      const std::vector<double> posesUncertainty = uncertainty.getCamerasUncEigenValues();
-
-      std::size_t indexPose = 0;
-      for (Poses::const_iterator itPose = sfmData.getPoses().begin(); itPose != sfmData.getPoses().end(); ++itPose, ++indexPose)
-      {
-        const IndexT idPose = itPose->first;
-        Vec6& u = sfmData._posesUncertainty[idPose]; // create uncertainty entry
-        const double* uIn = &posesUncertainty[indexPose*6];
-        u << uIn[0],  uIn[1],  uIn[2],  uIn[3],  uIn[4],  uIn[5];
-      }
+        const Eigen::SelfAdjointEigenSolver<Mat3> solver(landmarksCovariance[j], Eigen::EigenvaluesOnly);
+        sfmData._landmarksUncertainty[landmarksId[j]] = solver.eigenvalues();
+        if (statsFile.is_open())
+            writeCovariance("landmark", landmarksId[j], landmarksCovariance[j]);
     }
+
+    ALICEVISION_LOG_INFO("Save into '" << outSfMDataFilename << "'.");
+
+    // Export the SfMData scene in the expected format
+    if (!Save(sfmData, outSfMDataFilename, ESfMData(ALL)))
     {
-      const std::vector<double> landmarksUncertainty = uncertainty.getPointsUncEigenValues();
-
-      std::size_t indexLandmark = 0;
-      for (Landmarks::const_iterator itLandmark = sfmData.getLandmarks().begin(); itLandmark != sfmData.getLandmarks().end(); ++itLandmark, ++indexLandmark)
-      {
-        const IndexT idLandmark = itLandmark->first;
-        Vec3& u = sfmData._landmarksUncertainty[idLandmark]; // create uncertainty entry
-        const double* uIn = &landmarksUncertainty[indexLandmark*3];
-        u << uIn[0],  uIn[1],  uIn[2];
-      }
+        ALICEVISION_LOG_ERROR("An error occurred while trying to save '" << outSfMDataFilename << "'.");
+        return EXIT_FAILURE;
     }
-  }
-
-  std::cout << "Save into \"" << outSfMDataFilename << "\"" << std::endl;
-  
-  // Export the SfMData scene in the expected format
-  if (!Save(sfmData, outSfMDataFilename, ESfMData(ALL)))
-  {
-    std::cerr << std::endl
-      << "An error occurred while trying to save \"" << outSfMDataFilename << "\"." << std::endl;
-    return EXIT_FAILURE;
-  }
-
-  return EXIT_SUCCESS;
+
+    return EXIT_SUCCESS;
 }
@@ -21,7 +21,7 @@
 // These constants define the current software version.
 // They must be updated when the command line is changed.
 #define ALICEVISION_SOFTWARE_VERSION_MAJOR 1
-#define ALICEVISION_SOFTWARE_VERSION_MINOR 0
+#define ALICEVISION_SOFTWARE_VERSION_MINOR 1
 
 using namespace aliceVision;
 
@@ -31,7 +31,17 @@ namespace po = boost::program_options;
 int aliceVision_main(int argc, char **argv)
 {
   // command-line parameters
+  std::string gpuProfileFilepath;
+
+  po::options_description optionalParams("Optional parameters");
+  optionalParams.add_options()
+    ("gpuProfile", po::value<std::string>(&gpuProfileFilepath)->default_value(gpuProfileFilepath),
+      "Run a short calibration benchmark on each CUDA device and write the GPU profiles in this JSON file. "
+      "The GPU computations read it from the ALICEVISION_GPU_PROFILE environment variable to size their buffers. "
+      "The benchmark allocates most of the available device memory for a moment.");
+
   CmdLine cmdline("AliceVision hardwareResources");
+  cmdline.add(optionalParams);
   if (!cmdline.execute(argc, argv))
   {
     return EXIT_FAILURE;
@@ -40,6 +50,21 @@ int aliceVision_main(int argc, char **argv)
   // print GPU Information
   ALICEVISION_LOG_INFO(gpu::gpuInformationCUDA());
 
+  // GPU calibration benchmark
+  if(!gpuProfileFilepath.empty())
+  {
+    std::vector<gpu::GpuProfile> gpuProfiles;
+    if(!gpu::measureGpuProfilesCUDA(gpuProfiles))
+    {
+      ALICEVISION_LOG_ERROR("Cannot profile any CUDA device.");
+      return EXIT_FAILURE;
+    }
+    if(!gpu::writeGpuProfiles(gpuProfileFilepath, gpuProfiles))
+      return EXIT_FAILURE;
+
+    ALICEVISION_LOG_INFO(gpuProfiles.size() << " GPU profile(s) written in '" << gpuProfileFilepath << "'.");
+  }
+
   system::MemoryInfo memoryInformation = system::getMemoryInfo();
 
   ALICEVISION_LOG_INFO("Memory information: " << std::endl << memoryInformation);
@@ -8,11 +8,13 @@
 #include <aliceVision/cmdline/cmdline.hpp>
 #include <aliceVision/system/Logger.hpp>
 #include <aliceVision/system/main.hpp>
+#include <aliceVision/system/MemoryInfo.hpp>
+#include <aliceVision/alicevision_omp.hpp>
 #include <aliceVision/numeric/numeric.hpp>
 #include <aliceVision/sfmData/SfMData.hpp>
 #include <aliceVision/sfmDataIO/sfmDataIO.hpp>
 #include <aliceVision/sfmDataIO/viewIO.hpp>
-#include <aliceVision/sensorDB/parseDatabase.hpp>
+#include <aliceVision/sensorDB/SensorDatabase.hpp>
 #include <aliceVision/config.hpp>
 #include <aliceVision/utils/regexFilter.hpp>
 #include <aliceVision/utils/filesIO.hpp>
@@ -40,12 +42,13 @@
 #include <map>
 #include <iostream>
 #include <algorithm>
+#include <atomic>
 
 
 // These constants define the current software version.
 // They must be updated when the command line is changed.
 #define ALICEVISION_SOFTWARE_VERSION_MAJOR 3
-#define ALICEVISION_SOFTWARE_VERSION_MINOR 3
+#define ALICEVISION_SOFTWARE_VERSION_MINOR 4
 
 using namespace aliceVision;
 namespace po = boost::program_options;
@@ -316,6 +319,7 @@ struct ProcessingParams
     bool reconstructedViewsOnly = false;
     bool keepImageFilename = false;
     bool exposureCompensation = false;
+    float exposureCompensationFactor = 1.0f;
     bool rawAutoBright = false;
     float rawExposureAdjust = 0.0;
     EImageFormat outputFormat = EImageFormat::RGBA;
@@ -381,7 +385,13 @@ struct ProcessingParams
     };
 };
 
-void undistortVignetting(aliceVision::image::Image<aliceVision::image::RGBAfColor>& img, const std::vector<float>& vparam)
+/**
+ * @brief Correct the vignetting of an image.
+ * @param[in,out] img the image
+ * @param[in] vparam the vignetting model parameters
+ * @param[in] colorGain gain applied on the color channels in the same pass (exposure compensation)
+ */
+void undistortVignetting(aliceVision::image::Image<aliceVision::image::RGBAfColor>& img, const std::vector<float>& vparam, float colorGain = 1.0f)
 {
     if (vparam.size() >= 7)
     {
@@ -397,18 +407,33 @@ void undistortVignetting(aliceVision::image::Image<aliceVision::image::RGBAfColo
 
         #pragma omp parallel for
         for (int j = 0; j < img.Height(); ++j)
+        {
+            const double npy = ((static_cast<double>(j) / img.Height()) - imageYCenter) / focY;
             for (int i = 0; i < img.Width(); ++i)
             {
-                const aliceVision::Vec2 p(i, j);
-
-                aliceVision::Vec2 np;
-                np(0) = ((p(0) / img.Width()) - imageXCenter) / focX;
-                np(1) = ((p(1) / img.Height()) - imageYCenter) / focY;
+                const double npx = ((static_cast<double>(i) / img.Width()) - imageXCenter) / focX;
 
-                const float rsqr = np(0) * np(0) + np(1) * np(1);
+                const float rsqr = npx * npx + npy * npy;
                 const float gain = 1.f + p1 * rsqr + p2 * rsqr * rsqr + p3 * rsqr * rsqr * rsqr + p4 * rsqr * rsqr * rsqr * rsqr;
 
-                img(j, i) *= gain;
+                image::RGBAfColor& pixel = img(j, i);
+                pixel.r() *= gain * colorGain;
+                pixel.g() *= gain * colorGain;
+                pixel.b() *= gain * colorGain;
+                pixel.a() *= gain;
+            }
+        }
+    }
+    else if (colorGain != 1.0f)
+    {
+        #pragma omp parallel for
+        for (int j = 0; j < img.Height(); ++j)
+            for (int i = 0; i < img.Width(); ++i)
+            {
+                image::RGBAfColor& pixel = img(j, i);
+                pixel.r() *= colorGain;
+                pixel.g() *= colorGain;
+                pixel.b() *= colorGain;
             }
     }
 }
@@ -530,13 +555,16 @@ void processImage(image::Image<image::RGBAfColor>& image, ProcessingParams& pPar
         ALICEVISION_LOG_INFO("Fixed " << pixelsFixed << " non-finite pixels.");
     }
 
+    // Pixel-wise gains (vignetting and exposure compensation) are applied in a single pass
+    const bool correctVignetting = pParams.lensCorrection.enabled && pParams.lensCorrection.vignetting && !pParams.lensCorrection.vParams.empty();
+    if (correctVignetting || pParams.exposureCompensationFactor != 1.0f)
+    {
+        undistortVignetting(image, correctVignetting ? pParams.lensCorrection.vParams : std::vector<float>(), pParams.exposureCompensationFactor);
+    }
+
     if (pParams.lensCorrection.enabled)
     {
-        if (pParams.lensCorrection.vignetting && !pParams.lensCorrection.vParams.empty())
-        {
-            undistortVignetting(image, pParams.lensCorrection.vParams);
-        }
-        else if (pParams.lensCorrection.vignetting && pParams.lensCorrection.vParams.empty())
+        if (pParams.lensCorrection.vignetting && pParams.lensCorrection.vParams.empty())
         {
             ALICEVISION_LOG_WARNING("No distortion model available for lens vignetting correction.");
         }
@@ -547,7 +575,7 @@ void processImage(image::Image<image::RGBAfColor>& image, ProcessingParams& pPar
             image::Image<image::RGBAfColor> image_ud;
             undistortChromaticAberrations(image, pParams.lensCorrection.caGModel, pParams.lensCorrection.caBGModel,
                                             pParams.lensCorrection.caRGModel, image_ud, FBLACK_A, false);
-            image = image_ud;
+            image.swap(image_ud);
         }
         else if(pParams.lensCorrection.chromaticAberration && pParams.lensCorrection.caGModel.isEmpty)
         {
@@ -564,7 +592,7 @@ void processImage(image::Image<image::RGBAfColor>& image, ProcessingParams& pPar
 
             camera::UndistortImage(image, cam.get(), image_ud, FBLACK_A);
 
-            image = image_ud;
+            image.swap(image_ud);
         }
         else if (pParams.lensCorrection.geometry && cam != NULL && !cam->hasDistortion())
         {
@@ -934,6 +962,29 @@ void saveImage(image::Image<image::RGBAfColor>& image, const std::string& inputP
     }
 }
 
+/**
+ * @brief Get the number of images processed at the same time.
+ * @param[in] maxParallelImages the user limit, 0 for automatic
+ * @param[in] maxImagePixels the number of pixels of the largest image
+ * @return the number of cores bounded by the available memory in automatic mode, the user limit otherwise
+ */
+int getNbParallelImages(int maxParallelImages, std::size_t maxImagePixels)
+{
+    if (maxParallelImages > 0)
+        return maxParallelImages;
+
+    // each processed image needs a few RGBA float buffers (input, filtered copy, output conversion)
+    const std::size_t imageMemory = std::max<std::size_t>(maxImagePixels, 1) * sizeof(image::RGBAfColor) * 4;
+    const system::MemoryInfo memoryInfo = system::getMemoryInfo();
+    int nbParallelImages = omp_get_max_threads();
+    if (memoryInfo.availableRam > 0)
+    {
+        // keep half of the available memory for the image reader caches and the other processes
+        nbParallelImages = std::min<int>(nbParallelImages, static_cast<int>(memoryInfo.availableRam / 2 / imageMemory));
+    }
+    return std::max(1, nbParallelImages);
+}
+
 int aliceVision_main(int argc, char * argv[])
 {
     std::string inputExpression;
@@ -961,6 +1012,7 @@ int aliceVision_main(int argc, char * argv[])
     std::string lensCorrectionProfileInfo;
     bool lensCorrectionProfileSearchIgnoreCameraModel = true;
     std::string sensorDatabasePath;
+    int maxParallelImages = 0;
 
     ProcessingParams pParams;
 
@@ -1135,6 +1187,10 @@ int aliceVision_main(int argc, char * argv[])
 
         ("extension", po::value<std::string>(&extension)->default_value(extension),
          "Output image extension (like exr, or empty to keep the source file format.")
+
+        ("maxParallelImages", po::value<int>(&maxParallelImages)->default_value(maxParallelImages),
+         "Maximum number of images processed at the same time, while the previous ones are written. "
+         "If 0, it is bounded by the number of cores and the available memory.")
         ;
 
     CmdLine cmdline("AliceVision imageProcessing");
@@ -1222,14 +1278,34 @@ int aliceVision_main(int argc, char * argv[])
             }
         }
 
-        const int size = ViewPaths.size();
+        // Views processed in parallel, each one with its own copy of the parameters
+        const std::vector<std::pair<IndexT, std::string>> viewPaths(ViewPaths.begin(), ViewPaths.end());
+        const int size = viewPaths.size();
         int i = 0;
 
-        for(auto& viewIt : ViewPaths)
+        std::size_t maxImagePixels = 0;
+        for (const auto& viewPath : viewPaths)
+        {
+            const sfmData::View& view = sfmData.getView(viewPath.first);
+            maxImagePixels = std::max(maxImagePixels, static_cast<std::size_t>(view.getImage().getWidth()) * view.getImage().getHeight());
+        }
+        const int nbParallelImages = getNbParallelImages(maxParallelImages, maxImagePixels);
+        ALICEVISION_LOG_INFO("Process " << size << " views, " << nbParallelImages << " at the same time.");
+
+        const double medianCameraExposure = pParams.exposureCompensation ? sfmData.getMedianCameraExposureSetting().getExposure() : 0.0;
+        std::atomic<bool> hasError(false);
+
+        #pragma omp parallel for num_threads(nbParallelImages) schedule(dynamic) if(nbParallelImages > 1)
+        for (int v = 0; v < size; ++v)
         {
-            const IndexT viewId = viewIt.first;
-            const std::string viewPath = viewIt.second;
+            if (hasError)
+                continue;
+
+            const IndexT viewId = viewPaths[v].first;
+            const std::string& viewPath = viewPaths[v].second;
             sfmData::View& view = sfmData.getView(viewId);
+            ProcessingParams viewParams = pParams;
+            image::EImageColorSpace viewWorkingColorSpace = workingColorSpace;
 
             const bool isRAW = image::isRawFormat(viewPath);
 
@@ -1237,19 +1313,22 @@ int aliceVision_main(int argc, char * argv[])
             const std::string fileName = fsPath.stem().string();
             const std::string fileExt = fsPath.extension().string();
             const std::string outputExt = extension.empty() ? (isRAW ? ".exr" : fileExt) : (std::string(".") + extension);
-            const std::string outputfilePath = (fs::path(outputPath) / ((pParams.keepImageFilename ? fileName : std::to_string(viewId)) + outputExt)).generic_string();
+            const std::string outputfilePath = (fs::path(outputPath) / ((viewParams.keepImageFilename ? fileName : std::to_string(viewId)) + outputExt)).generic_string();
 
-            ALICEVISION_LOG_INFO(++i << "/" << size << " - Process view '" << viewId << "'.");
+            int imageIndex;
+            #pragma omp atomic capture
+            imageIndex = ++i;
+            ALICEVISION_LOG_INFO(imageIndex << "/" << size << " - Process view '" << viewId << "'.");
 
             auto metadata = view.getImage().getMetadata();
 
-            if (pParams.applyDcpMetadata && metadata["AliceVision:ColorSpace"] != "no_conversion")
+            if (viewParams.applyDcpMetadata && metadata["AliceVision:ColorSpace"] != "no_conversion")
             {
                 ALICEVISION_LOG_WARNING("A dcp profile will be applied on an image containing non raw data!");
             }
 
             image::ImageReadOptions options;
-            options.workingColorSpace = pParams.applyDcpMetadata ? image::EImageColorSpace::NO_CONVERSION : workingColorSpace;
+            options.workingColorSpace = viewParams.applyDcpMetadata ? image::EImageColorSpace::NO_CONVERSION : viewWorkingColorSpace;
 
             if (isRAW)
             {
@@ -1276,76 +1355,64 @@ int aliceVision_main(int argc, char * argv[])
                 options.colorProfileFileName = view.getImage().getColorProfileFileName();
                 options.demosaicingAlgo = demosaicingAlgo;
                 options.highlightMode = highlightMode;
-                options.rawExposureAdjustment = std::pow(2.f, pParams.rawExposureAdjust);
-                options.rawAutoBright = pParams.rawAutoBright;
+                options.rawExposureAdjustment = std::pow(2.f, viewParams.rawExposureAdjust);
+                options.rawAutoBright = viewParams.rawAutoBright;
                 options.correlatedColorTemperature = correlatedColorTemperature;
-                pParams.correlatedColorTemperature = correlatedColorTemperature;
-                pParams.enableColorTempProcessing = options.rawColorInterpretation == image::ERawColorInterpretation::DcpLinearProcessing;
+                viewParams.correlatedColorTemperature = correlatedColorTemperature;
+                viewParams.enableColorTempProcessing = options.rawColorInterpretation == image::ERawColorInterpretation::DcpLinearProcessing;
             }
             else
             {
                 options.inputColorSpace = inputColorSpace;
             }
 
-            if (pParams.lensCorrection.enabled && pParams.lensCorrection.vignetting)
+            if (viewParams.lensCorrection.enabled && viewParams.lensCorrection.vignetting)
             {
-                if (!view.getImage().getVignettingParams(pParams.lensCorrection.vParams))
+                if (!view.getImage().getVignettingParams(viewParams.lensCorrection.vParams))
                 {
-                    pParams.lensCorrection.vParams.clear();
+                    viewParams.lensCorrection.vParams.clear();
                 }
             }
 
-            if (pParams.lensCorrection.enabled && pParams.lensCorrection.chromaticAberration)
+            if (viewParams.lensCorrection.enabled && viewParams.lensCorrection.chromaticAberration)
             {
                 std::vector<float> caGParams, caBGParams, caRGParams;
                 view.getImage().getChromaticAberrationParams(caGParams,caBGParams,caRGParams);
 
-                pParams.lensCorrection.caGModel.init3(caGParams);
-                pParams.lensCorrection.caBGModel.init3(caBGParams);
-                pParams.lensCorrection.caRGModel.init3(caRGParams);
+                viewParams.lensCorrection.caGModel.init3(caGParams);
+                viewParams.lensCorrection.caBGModel.init3(caBGParams);
+                viewParams.lensCorrection.caRGModel.init3(caRGParams);
 
-                if(pParams.lensCorrection.caGModel.FocalLengthX == 0.0)
+                if(viewParams.lensCorrection.caGModel.FocalLengthX == 0.0)
                 {
                     float sensorWidth = view.getImage().getSensorWidth();
-                    pParams.lensCorrection.caGModel.FocalLengthX = view.getImage().getWidth() * view.getImage().getMetadataFocalLength() /
+                    viewParams.lensCorrection.caGModel.FocalLengthX = view.getImage().getWidth() * view.getImage().getMetadataFocalLength() /
                                                                    sensorWidth / std::max(view.getImage().getWidth(), view.getImage().getHeight());
                 }
-                if(pParams.lensCorrection.caGModel.FocalLengthY == 0.0)
+                if(viewParams.lensCorrection.caGModel.FocalLengthY == 0.0)
                 {
                     float sensorHeight = view.getImage().getSensorHeight();
-                    pParams.lensCorrection.caGModel.FocalLengthY = view.getImage().getHeight() * view.getImage().getMetadataFocalLength() /
+                    viewParams.lensCorrection.caGModel.FocalLengthY = view.getImage().getHeight() * view.getImage().getMetadataFocalLength() /
                                                                    sensorHeight / std::max(view.getImage().getWidth(), view.getImage().getHeight());
                 }
 
-                if((pParams.lensCorrection.caGModel.FocalLengthX <= 0.0) ||
-                   (pParams.lensCorrection.caGModel.FocalLengthY <= 0.0))
+                if((viewParams.lensCorrection.caGModel.FocalLengthX <= 0.0) ||
+                   (viewParams.lensCorrection.caGModel.FocalLengthY <= 0.0))
                 {
-                    pParams.lensCorrection.caGModel.reset();
-                    pParams.lensCorrection.caBGModel.reset();
-                    pParams.lensCorrection.caRGModel.reset();
+                    viewParams.lensCorrection.caGModel.reset();
+                    viewParams.lensCorrection.caBGModel.reset();
+                    viewParams.lensCorrection.caRGModel.reset();
                 }
             }
 
-            // Read original image
-            image::Image<image::RGBAfColor> image;
-            image::readImage(viewPath, image, options);
-
-            // If exposureCompensation is needed for sfmData files
-            if (pParams.exposureCompensation)
+            // If exposureCompensation is needed for sfmData files, it is applied with the other pixel-wise gains
+            if (viewParams.exposureCompensation)
             {
-                const double medianCameraExposure = sfmData.getMedianCameraExposureSetting().getExposure();
                 const double cameraExposure = view.getImage().getCameraExposureSetting().getExposure();
                 const double ev = std::log2(1.0 / cameraExposure);
-                const float compensationFactor = static_cast<float>(medianCameraExposure / cameraExposure);
+                viewParams.exposureCompensationFactor = static_cast<float>(medianCameraExposure / cameraExposure);
 
-                ALICEVISION_LOG_INFO("View: " << viewId << ", Ev: " << ev << ", Ev compensation: " << compensationFactor);
-
-                for (int i = 0; i < image.Width() * image.Height(); ++i)
-                {
-                    image(i)[0] *= compensationFactor;
-                    image(i)[1] *= compensationFactor;
-                    image(i)[2] *= compensationFactor;
-                }
+                ALICEVISION_LOG_INFO("View: " << viewId << ", Ev: " << ev << ", Ev compensation: " << viewParams.exposureCompensationFactor);
             }
 
             sfmData::Intrinsics::const_iterator iterIntrinsic = sfmData.getIntrinsics().find(view.getIntrinsicId());
@@ -1353,32 +1420,45 @@ int aliceVision_main(int argc, char * argv[])
 
             std::map<std::string, std::string> viewMetadata = view.getImage().getMetadata();
 
-            // Image processing
-            processImage(image, pParams, viewMetadata, cam);
-
-            if (pParams.applyDcpMetadata)
+            image::Image<image::RGBAfColor> image;
+            try
             {
-                workingColorSpace = image::EImageColorSpace::ACES2065_1;
-            }
+                // Read original image
+                image::readImage(viewPath, image, options);
+
+                // Image processing
+                processImage(image, viewParams, viewMetadata, cam);
+
+                if (viewParams.applyDcpMetadata)
+                {
+                    viewWorkingColorSpace = image::EImageColorSpace::ACES2065_1;
+                }
 
-            image::ImageWriteOptions writeOptions;
+                image::ImageWriteOptions writeOptions;
 
-            writeOptions.fromColorSpace(workingColorSpace);
-            writeOptions.toColorSpace(outputColorSpace);
-            writeOptions.exrCompressionMethod(exrCompressionMethod);
-            writeOptions.exrCompressionLevel(exrCompressionLevel);
-            writeOptions.jpegCompress(jpegCompress);
-            writeOptions.jpegQuality(jpegQuality);
+                writeOptions.fromColorSpace(viewWorkingColorSpace);
+                writeOptions.toColorSpace(outputColorSpace);
+                writeOptions.exrCompressionMethod(exrCompressionMethod);
+                writeOptions.exrCompressionLevel(exrCompressionLevel);
+                writeOptions.jpegCompress(jpegCompress);
+                writeOptions.jpegQuality(jpegQuality);
+
+                if (boost::to_lower_copy(fs::path(outputPath).extension().string()) == ".exr")
+                {
+                    // Select storage data type
+                    writeOptions.storageDataType(storageDataType);
+                }
 
-            if (boost::to_lower_copy(fs::path(outputPath).extension().string()) == ".exr")
+                // Save the image
+                saveImage(image, viewPath, outputfilePath, viewMetadata, metadataFolders, outputFormat, writeOptions);
+            }
+            catch (const std::exception& e)
             {
-                // Select storage data type
-                writeOptions.storageDataType(storageDataType);
+                ALICEVISION_LOG_ERROR("Failed to process the view '" << viewId << "': " << e.what());
+                hasError = true;
+                continue;
             }
 
-            // Save the image
-            saveImage(image, viewPath, outputfilePath, viewMetadata, metadataFolders, outputFormat, writeOptions);
-
             // Update view for this modification
             view.getImage().setImagePath(outputfilePath);
             view.getImage().setWidth(image.Width());
@@ -1387,6 +1467,11 @@ int aliceVision_main(int argc, char * argv[])
             view.getImage().addMetadata("Orientation", viewMetadata.at("Orientation"));
         }
 
+        if (hasError)
+        {
+            return EXIT_FAILURE;
+        }
+
         if (pParams.scaleFactor != 1.0f)
         {
             for (auto & i : sfmData.getIntrinsics())
@@ -1459,7 +1544,7 @@ int aliceVision_main(int argc, char * argv[])
         LCPdatabase lcpStore(lensCorrectionProfileInfo, lensCorrectionProfileSearchIgnoreCameraModel);
 
         // check sensor database
-        std::vector<sensorDB::Datasheet> sensorDatabase;
+        sensorDB::SensorDatabase sensorDatabase;
         if (pParams.lensCorrection.enabled && (pParams.lensCorrection.geometry || pParams.lensCorrection.chromaticAberration))
         {
             if (sensorDatabasePath.empty())
@@ -1475,7 +1560,7 @@ int aliceVision_main(int argc, char * argv[])
                     sensorDatabasePath = root + "/share/aliceVision/cameraSensors.db";
                 }
             }
-            if (!sensorDatabasePath.empty() && !sensorDB::parseDatabase(sensorDatabasePath, sensorDatabase))
+            if (!sensorDatabasePath.empty() && !sensorDatabase.load(sensorDatabasePath))
             {
                 ALICEVISION_LOG_ERROR("Invalid input sensor database '" << sensorDatabasePath
                                                                         << "', please specify a valid file.");
@@ -1483,9 +1568,25 @@ int aliceVision_main(int argc, char * argv[])
             }
         }
 
+        // Images processed in parallel, each one with its own copy of the parameters
+        int firstWidth = 0, firstHeight = 0;
+        image::readImageMetadata(filesStrPaths.front(), firstWidth, firstHeight);
+        const int nbParallelImages = getNbParallelImages(maxParallelImages, static_cast<std::size_t>(firstWidth) * firstHeight);
+        ALICEVISION_LOG_INFO("Process " << nbParallelImages << " images at the same time.");
+
+        std::atomic<bool> hasError(false);
         int i = 0;
-        for (const std::string& inputFilePath : filesStrPaths)
+
+        #pragma omp parallel for num_threads(nbParallelImages) schedule(dynamic) if(nbParallelImages > 1)
+        for (int f = 0; f < size; ++f)
         {
+            if (hasError)
+                continue;
+
+            const std::string& inputFilePath = filesStrPaths[f];
+            ProcessingParams viewParams = pParams;
+            image::EImageColorSpace viewWorkingColorSpace = workingColorSpace;
+
             const bool isRAW = image::isRawFormat(inputFilePath);
 
             const fs::path path = fs::path(inputFilePath);
@@ -1493,7 +1594,10 @@ int aliceVision_main(int argc, char * argv[])
             const std::string fileExt = path.extension().string();
             const std::string outputExt = extension.empty() ? (isRAW ? ".exr" : fileExt) : (std::string(".") + extension);
 
-            ALICEVISION_LOG_INFO(++i << "/" << size << " - Process image '" << filename << fileExt << "'.");
+            int imageIndex;
+            #pragma omp atomic capture
+            imageIndex = ++i;
+            ALICEVISION_LOG_INFO(imageIndex << "/" << size << " - Process image '" << filename << fileExt << "'.");
 
             const std::string userExt = fs::path(outputPath).extension().string();
             std::string outputFilePath;
@@ -1531,16 +1635,22 @@ int aliceVision_main(int argc, char * argv[])
             if (isRAW && (rawColorInterpretation == image::ERawColorInterpretation::DcpLinearProcessing ||
                           rawColorInterpretation == image::ERawColorInterpretation::DcpMetadata))
             {
-                // Load DCP color profiles database if not already loaded
-                dcpDatabase.load(colorProfileDatabaseDirPath.empty() ? getColorProfileDatabaseFolder() : colorProfileDatabaseDirPath, false);
+                bool dcpFound;
+                #pragma omp critical(dcp)
+                {
+                    // Load DCP color profiles database if not already loaded
+                    dcpDatabase.load(colorProfileDatabaseDirPath.empty() ? getColorProfileDatabaseFolder() : colorProfileDatabaseDirPath, false);
 
-                // Get DCP profile
-                if (!dcpDatabase.retrieveDcpForCamera(make, model, dcpProf))
+                    // Get DCP profile
+                    dcpFound = dcpDatabase.retrieveDcpForCamera(make, model, dcpProf);
+                }
+                if (!dcpFound)
                 {
                     if (errorOnMissingColorProfile)
                     {
                         ALICEVISION_LOG_ERROR("The specified DCP database does not contain an appropriate profil for DSLR " << make << " " << model);
-                        return EXIT_FAILURE;
+                        hasError = true;
+                        continue;
                     }
                     else
                     {
@@ -1552,13 +1662,14 @@ int aliceVision_main(int argc, char * argv[])
                 view.getImage().addDCPMetadata(dcpProf);
             }
 
-            if(isRAW && pParams.lensCorrection.enabled &&
-                (pParams.lensCorrection.geometry || pParams.lensCorrection.vignetting || pParams.lensCorrection.chromaticAberration))
+            if(isRAW && viewParams.lensCorrection.enabled &&
+                (viewParams.lensCorrection.geometry || viewParams.lensCorrection.vignetting || viewParams.lensCorrection.chromaticAberration))
             {
                 // try to find an appropriate Lens Correction Profile
                 LCPinfo* lcpData = nullptr;
                 if (lcpStore.size() == 1)
                 {
+                    #pragma omp critical(lcp)
                     lcpData = lcpStore.retrieveLCP();
                 }
                 else if (!lcpStore.empty())
@@ -1591,7 +1702,7 @@ int aliceVision_main(int argc, char * argv[])
                     camera::EInitMode intrinsicInitMode = camera::EInitMode::UNKNOWN;
                     view.getImage().getSensorSize(sensorDatabase, sensorWidth, sensorHeight, focalLengthmm, intrinsicInitMode, true);
 
-                    if (lensParam.hasVignetteParams() && !lensParam.vignParams.isEmpty && pParams.lensCorrection.vignetting)
+                    if (lensParam.hasVignetteParams() && !lensParam.vignParams.isEmpty && viewParams.lensCorrection.vignetting)
                     {
                         float FocX = lensParam.vignParams.FocalLengthX != 0.0
                                          ? lensParam.vignParams.FocalLengthX
@@ -1600,7 +1711,7 @@ int aliceVision_main(int argc, char * argv[])
                                          ? lensParam.vignParams.FocalLengthY
                                          : height * focalLengthmm / sensorHeight / std::max(width, height);
 
-                        pParams.lensCorrection.vParams.clear();
+                        viewParams.lensCorrection.vParams.clear();
 
                         if (FocX == 0.0 || FocY == 0.0)
                         {
@@ -1608,17 +1719,17 @@ int aliceVision_main(int argc, char * argv[])
                         }
                         else
                         {
-                            pParams.lensCorrection.vParams.push_back(FocX);
-                            pParams.lensCorrection.vParams.push_back(FocY);
-                            pParams.lensCorrection.vParams.push_back(lensParam.vignParams.ImageXCenter);
-                            pParams.lensCorrection.vParams.push_back(lensParam.vignParams.ImageYCenter);
-                            pParams.lensCorrection.vParams.push_back(lensParam.vignParams.VignetteModelParam1);
-                            pParams.lensCorrection.vParams.push_back(lensParam.vignParams.VignetteModelParam2);
-                            pParams.lensCorrection.vParams.push_back(lensParam.vignParams.VignetteModelParam3);
+                            viewParams.lensCorrection.vParams.push_back(FocX);
+                            viewParams.lensCorrection.vParams.push_back(FocY);
+                            viewParams.lensCorrection.vParams.push_back(lensParam.vignParams.ImageXCenter);
+                            viewParams.lensCorrection.vParams.push_back(lensParam.vignParams.ImageYCenter);
+                            viewParams.lensCorrection.vParams.push_back(lensParam.vignParams.VignetteModelParam1);
+                            viewParams.lensCorrection.vParams.push_back(lensParam.vignParams.VignetteModelParam2);
+                            viewParams.lensCorrection.vParams.push_back(lensParam.vignParams.VignetteModelParam3);
                         }
                     }
 
-                    if (pParams.lensCorrection.chromaticAberration && lensParam.hasChromaticParams() && !lensParam.ChromaticGreenParams.isEmpty)
+                    if (viewParams.lensCorrection.chromaticAberration && lensParam.hasChromaticParams() && !lensParam.ChromaticGreenParams.isEmpty)
                     {
                         if (lensParam.ChromaticGreenParams.FocalLengthX == 0.0)
                         {
@@ -1634,22 +1745,22 @@ int aliceVision_main(int argc, char * argv[])
                         if(lensParam.ChromaticGreenParams.FocalLengthX == 0.0 ||
                            lensParam.ChromaticGreenParams.FocalLengthY == 0.0)
                         {
-                            pParams.lensCorrection.caGModel.reset();
-                            pParams.lensCorrection.caBGModel.reset();
-                            pParams.lensCorrection.caRGModel.reset();
+                            viewParams.lensCorrection.caGModel.reset();
+                            viewParams.lensCorrection.caBGModel.reset();
+                            viewParams.lensCorrection.caRGModel.reset();
 
                             ALICEVISION_LOG_WARNING(
                                 "Chromatic Aberration correction is requested but cannot be applied due to missing info.");
                         }
                         else
                         {
-                            pParams.lensCorrection.caGModel = lensParam.ChromaticGreenParams;
-                            pParams.lensCorrection.caBGModel = lensParam.ChromaticBlueGreenParams;
-                            pParams.lensCorrection.caRGModel = lensParam.ChromaticRedGreenParams;
+                            viewParams.lensCorrection.caGModel = lensParam.ChromaticGreenParams;
+                            viewParams.lensCorrection.caBGModel = lensParam.ChromaticBlueGreenParams;
+                            viewParams.lensCorrection.caRGModel = lensParam.ChromaticRedGreenParams;
                         }
                     }
 
-                    if (pParams.lensCorrection.geometry)
+                    if (viewParams.lensCorrection.geometry)
                     {
                         // build intrinsic
                         const camera::EINTRINSIC defaultCameraModel = camera::EINTRINSIC::PINHOLE_CAMERA_RADIAL3;
@@ -1663,7 +1774,7 @@ int aliceVision_main(int argc, char * argv[])
                             view, focalLengthmm, sensorWidth, defaultFocalLength, defaultFieldOfView, defaultFocalRatio,
                             defaultOffsetX, defaultOffsetY, &lensParam, defaultCameraModel, allowedCameraModels);
 
-                        pParams.lensCorrection.geometryModel = lensParam.perspParams;
+                        viewParams.lensCorrection.geometryModel = lensParam.perspParams;
                     }
                 }
                 else
@@ -1693,7 +1804,7 @@ int aliceVision_main(int argc, char * argv[])
                     readOptions.rawColorInterpretation = rawColorInterpretation;
                 }
 
-                if (pParams.applyDcpMetadata && md["AliceVision::ColorSpace"] != "no_conversion")
+                if (viewParams.applyDcpMetadata && md["AliceVision::ColorSpace"] != "no_conversion")
                 {
                     ALICEVISION_LOG_WARNING("A dcp profile will be applied on an image containing non raw data!");
                 }
@@ -1702,16 +1813,16 @@ int aliceVision_main(int argc, char * argv[])
                 readOptions.doWBAfterDemosaicing = doWBAfterDemosaicing;
                 readOptions.demosaicingAlgo = demosaicingAlgo;
                 readOptions.highlightMode = highlightMode;
-                readOptions.rawExposureAdjustment = std::pow(2.f, pParams.rawExposureAdjust);
-                readOptions.rawAutoBright = pParams.rawAutoBright;
+                readOptions.rawExposureAdjustment = std::pow(2.f, viewParams.rawExposureAdjust);
+                readOptions.rawAutoBright = viewParams.rawAutoBright;
                 readOptions.correlatedColorTemperature = correlatedColorTemperature;
-                pParams.correlatedColorTemperature = correlatedColorTemperature;
-                pParams.enableColorTempProcessing = readOptions.rawColorInterpretation == image::ERawColorInterpretation::DcpLinearProcessing;
+                viewParams.correlatedColorTemperature = correlatedColorTemperature;
+                viewParams.enableColorTempProcessing = readOptions.rawColorInterpretation == image::ERawColorInterpretation::DcpLinearProcessing;
 
-                pParams.useDCPColorMatrixOnly = useDCPColorMatrixOnly;
-                if (pParams.applyDcpMetadata)
+                viewParams.useDCPColorMatrixOnly = useDCPColorMatrixOnly;
+                if (viewParams.applyDcpMetadata)
                 {
-                    workingColorSpace = image::EImageColorSpace::ACES2065_1;
+                    viewWorkingColorSpace = image::EImageColorSpace::ACES2065_1;
                 }
             }
             else
@@ -1719,30 +1830,43 @@ int aliceVision_main(int argc, char * argv[])
                 readOptions.inputColorSpace = inputColorSpace;
             }
 
-            readOptions.workingColorSpace = pParams.applyDcpMetadata ? image::EImageColorSpace::NO_CONVERSION : workingColorSpace;
+            readOptions.workingColorSpace = viewParams.applyDcpMetadata ? image::EImageColorSpace::NO_CONVERSION : viewWorkingColorSpace;
 
-            // Read original image
-            image::Image<image::RGBAfColor> image;
-            image::readImage(inputFilePath, image, readOptions);
+            try
+            {
+                // Read original image
+                image::Image<image::RGBAfColor> image;
+                image::readImage(inputFilePath, image, readOptions);
+
+                // Image processing
+                processImage(image, viewParams, md, intrinsicBase);
 
-            // Image processing
-            processImage(image, pParams, md, intrinsicBase);
+                image::ImageWriteOptions writeOptions;
 
-            image::ImageWriteOptions writeOptions;
+                writeOptions.fromColorSpace(viewWorkingColorSpace);
+                writeOptions.toColorSpace(outputColorSpace);
+                writeOptions.exrCompressionMethod(exrCompressionMethod);
+                writeOptions.exrCompressionLevel(exrCompressionLevel);
 
-            writeOptions.fromColorSpace(workingColorSpace);
-            writeOptions.toColorSpace(outputColorSpace);
-            writeOptions.exrCompressionMethod(exrCompressionMethod);
-            writeOptions.exrCompressionLevel(exrCompressionLevel);
+                if (boost::to_lower_copy(fs::path(outputPath).extension().string()) == ".exr")
+                {
+                    // Select storage data type
+                    writeOptions.storageDataType(storageDataType);
+                }
 
-            if (boost::to_lower_copy(fs::path(outputPath).extension().string()) == ".exr")
+                // Save the image
+                saveImage(image, inputFilePath, outputFilePath, md, metadataFolders, outputFormat, writeOptions);
+            }
+            catch (const std::exception& e)
             {
-                // Select storage data type
-                writeOptions.storageDataType(storageDataType);
+                ALICEVISION_LOG_ERROR("Failed to process the image '" << inputFilePath << "': " << e.what());
+                hasError = true;
             }
+        }
 
-            // Save the image
-            saveImage(image, inputFilePath, outputFilePath, md, metadataFolders, outputFormat, writeOptions);
+        if (hasError)
+        {
+            return EXIT_FAILURE;
         }
     }
 
@@ -5,6 +5,8 @@
 // You can obtain one at https://mozilla.org/MPL/2.0/.
 
 #include <aliceVision/system/Logger.hpp>
+#include <aliceVision/system/MemoryInfo.hpp>
+#include <aliceVision/alicevision_omp.hpp>
 #include <aliceVision/cmdline/cmdline.hpp>
 #include <aliceVision/system/Timer.hpp>
 #include <aliceVision/sfmData/SfMData.hpp>
@@ -20,6 +22,7 @@
 #include <boost/program_options.hpp> 
 #include <boost/filesystem.hpp>
 
+#include <algorithm>
 #include <string>
 #include <vector>
 
@@ -320,11 +323,34 @@ int main(int argc, char** argv)
   // initialization
   mvsUtils::MultiViewParams mp(sfmData, imagesFolder, "", depthMapsFilterFolder, false);
 
-  lightingEstimation::LighthingEstimator estimator;
+  lightingEstimation::LighthingEstimator globalEstimator;
 
+  std::vector<IndexT> viewIds;
+  std::size_t maxImagePixels = 0;
   for(const auto& viewPair : sfmData.getViews())
   {
-    const IndexT viewId = viewPair.first;
+    viewIds.push_back(viewPair.first);
+    maxImagePixels = std::max<std::size_t>(maxImagePixels, std::size_t(viewPair.second->getImage().getWidth()) * viewPair.second->getImage().getHeight());
+  }
+
+  // each view needs its normals, picture and albedo images (and the albedo filtering buffer) in memory
+  int nbParallelViews = omp_get_max_threads();
+  {
+    const std::size_t viewMemory = std::max<std::size_t>(maxImagePixels, 1) * sizeof(image::RGBfColor) * 4;
+    const system::MemoryInfo memoryInfo = system::getMemoryInfo();
+    if(memoryInfo.availableRam > 0)
+      nbParallelViews = std::max(1, std::min<int>(nbParallelViews, static_cast<int>(memoryInfo.availableRam / 2 / viewMemory)));
+  }
+
+  // the estimators only accumulate the normal equations of the images, the views can be added in parallel
+  #pragma omp parallel for num_threads(nbParallelViews) schedule(dynamic) if(nbParallelViews > 1)
+  for(int i = 0; i < static_cast<int>(viewIds.size()); ++i)
+  {
+    const IndexT viewId = viewIds[i];
+
+    // per image estimation uses its own estimator
+    lightingEstimation::LighthingEstimator viewEstimator;
+    lightingEstimation::LighthingEstimator& estimator = (lightEstimationMode == ELightingEstimationMode::PER_IMAGE) ? viewEstimator : globalEstimator;
 
     const std::string picturePath = mp.getImagePath(mp.getIndexFromViewId(viewId));
     const std::string normalsPath = mvsUtils::getFileNameFromViewId(mp, viewId, mvsUtils::EFileType::normalMapFiltered);
@@ -372,7 +398,7 @@ int main(int argc, char** argv)
   {
     ALICEVISION_LOG_INFO("Solving global scene lighting estimation...");
     lightingEstimation::LightingVector shl;
-    estimator.estimateLigthing(shl);
+    globalEstimator.estimateLigthing(shl);
 
     std::ofstream file((fs::path(outputFolder) / ("global.shl")).string());
     if(file.is_open())
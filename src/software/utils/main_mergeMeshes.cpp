@@ -8,6 +8,7 @@
 #include <aliceVision/cmdline/cmdline.hpp>
 #include <aliceVision/system/main.hpp>
 #include <aliceVision/system/Timer.hpp>
+#include <aliceVision/alicevision_omp.hpp>
 
 #include <boost/program_options.hpp>
 #include <boost/filesystem.hpp>
@@ -22,15 +23,23 @@
 #include <geogram/basic/command_line.h>
 #include <geogram/basic/command_line_args.h>
 
+#include <algorithm>
+#include <array>
 #include <iostream>
 #include <fstream>
+#include <limits>
+#include <map>
+#include <memory>
+#include <numeric>
 #include <ostream>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 // These constants define the current software version.
 // They must be updated when the command line is changed.
 #define ALICEVISION_SOFTWARE_VERSION_MAJOR 1
-#define ALICEVISION_SOFTWARE_VERSION_MINOR 0
+#define ALICEVISION_SOFTWARE_VERSION_MINOR 1
 
 using namespace aliceVision;
 
@@ -116,6 +125,303 @@ void fixMeshForBooleanOperations(GEO::Mesh& m)
     GEO::mesh_remove_intersections(m);
 }
 
+/**
+ * @brief Apply a boolean operation on two meshes.
+ */
+void applyOperation(EOperationType operationType, GEO::Mesh& outputMesh, GEO::Mesh& firstMesh, GEO::Mesh& secondMesh)
+{
+    switch(operationType)
+    {
+        case EOperationType::BOOLEAN_UNION:         GEO::mesh_union(outputMesh, firstMesh, secondMesh);        break;
+        case EOperationType::BOOLEAN_INTERSECTION:  GEO::mesh_intersection(outputMesh, firstMesh, secondMesh); break;
+        case EOperationType::BOOLEAN_DIFFERENCE:    GEO::mesh_difference(outputMesh, firstMesh, secondMesh);   break;
+    }
+}
+
+/**
+ * @brief Union-find of indexes, with path halving.
+ */
+struct DisjointSets
+{
+    std::vector<std::size_t> parents;
+
+    explicit DisjointSets(std::size_t size)
+      : parents(size)
+    {
+        std::iota(parents.begin(), parents.end(), 0);
+    }
+
+    std::size_t find(std::size_t i)
+    {
+        while(parents[i] != i)
+        {
+            parents[i] = parents[parents[i]];
+            i = parents[i];
+        }
+        return i;
+    }
+
+    void unite(std::size_t i, std::size_t j)
+    {
+        i = find(i);
+        j = find(j);
+        // the smallest index is the root, the sets do not depend on the order of the unions
+        if(i < j)
+            parents[j] = i;
+        else if(j < i)
+            parents[i] = j;
+    }
+};
+
+/**
+ * @brief Axis-aligned bounding box of a connected component of a mesh.
+ */
+struct ComponentBounds
+{
+    std::array<double, 3> min{{std::numeric_limits<double>::max(), std::numeric_limits<double>::max(), std::numeric_limits<double>::max()}};
+    std::array<double, 3> max{{std::numeric_limits<double>::lowest(), std::numeric_limits<double>::lowest(), std::numeric_limits<double>::lowest()}};
+
+    void add(const GEO::vec3& point)
+    {
+        for(int i = 0; i < 3; ++i)
+        {
+            min[i] = std::min(min[i], point[i]);
+            max[i] = std::max(max[i], point[i]);
+        }
+    }
+
+    bool overlaps(const ComponentBounds& other, double margin) const
+    {
+        for(int i = 0; i < 3; ++i)
+        {
+            if(min[i] > other.max[i] + margin || other.min[i] > max[i] + margin)
+                return false;
+        }
+        return true;
+    }
+};
+
+/**
+ * @brief Get the connected components of the facets of a mesh.
+ * @note The vertices at the same position are connected, as the mesh may not be repaired.
+ * @param[in] mesh the mesh
+ * @param[out] out_componentsFacets the facets of each component, ordered by their first facet
+ * @param[out] out_componentsBounds the bounding box of each component
+ */
+void getConnectedComponents(const GEO::Mesh& mesh,
+                            std::vector<std::vector<GEO::index_t>>& out_componentsFacets,
+                            std::vector<ComponentBounds>& out_componentsBounds)
+{
+    DisjointSets vertexSets(mesh.vertices.nb());
+
+    {
+        std::map<std::array<double, 3>, GEO::index_t> colocatedVertices;
+        for(GEO::index_t v = 0; v < mesh.vertices.nb(); ++v)
+        {
+            const GEO::vec3& point = mesh.vertices.point(v);
+            const auto it = colocatedVertices.emplace(std::array<double, 3>{{point.x, point.y, point.z}}, v).first;
+            vertexSets.unite(it->second, v);
+        }
+    }
+
+    for(GEO::index_t f = 0; f < mesh.facets.nb(); ++f)
+    {
+        for(GEO::index_t lv = 1; lv < mesh.facets.nb_vertices(f); ++lv)
+            vertexSets.unite(mesh.facets.vertex(f, 0), mesh.facets.vertex(f, lv));
+    }
+
+    out_componentsFacets.clear();
+    out_componentsBounds.clear();
+
+    std::unordered_map<std::size_t, std::size_t> componentIndexPerRoot;
+    for(GEO::index_t f = 0; f < mesh.facets.nb(); ++f)
+    {
+        const std::size_t root = vertexSets.find(mesh.facets.vertex(f, 0));
+        const auto it = componentIndexPerRoot.emplace(root, out_componentsFacets.size()).first;
+        if(it->second == out_componentsFacets.size())
+        {
+            out_componentsFacets.emplace_back();
+            out_componentsBounds.emplace_back();
+        }
+        out_componentsFacets[it->second].push_back(f);
+        for(GEO::index_t lv = 0; lv < mesh.facets.nb_vertices(f); ++lv)
+            out_componentsBounds[it->second].add(mesh.vertices.point(mesh.facets.vertex(f, lv)));
+    }
+}
+
+/**
+ * @brief Append some facets of a mesh, and their vertices, to another mesh.
+ * @param[in] mesh the source mesh
+ * @param[in] facets the facets to append
+ * @param[in,out] out_mesh the destination mesh
+ */
+void appendFacets(const GEO::Mesh& mesh, const std::vector<GEO::index_t>& facets, GEO::Mesh& out_mesh)
+{
+    std::unordered_map<GEO::index_t, GEO::index_t> newVertexIndexes;
+    for(const GEO::index_t f : facets)
+    {
+        const GEO::index_t nbVertices = mesh.facets.nb_vertices(f);
+        const GEO::index_t newFacet = out_mesh.facets.create_polygon(nbVertices);
+        for(GEO::index_t lv = 0; lv < nbVertices; ++lv)
+        {
+            const GEO::index_t v = mesh.facets.vertex(f, lv);
+            auto it = newVertexIndexes.find(v);
+            if(it == newVertexIndexes.end())
+            {
+                const GEO::index_t newVertex = out_mesh.vertices.create_vertex();
+                out_mesh.vertices.point(newVertex) = mesh.vertices.point(v);
+                it = newVertexIndexes.emplace(v, newVertex).first;
+            }
+            out_mesh.facets.set_vertex(newFacet, lv, it->second);
+        }
+    }
+}
+
+/**
+ * @brief Append all the facets of a mesh to another mesh.
+ */
+void appendMesh(const GEO::Mesh& mesh, GEO::Mesh& out_mesh)
+{
+    std::vector<GEO::index_t> facets(mesh.facets.nb());
+    std::iota(facets.begin(), facets.end(), 0);
+    appendFacets(mesh, facets, out_mesh);
+}
+
+/**
+ * @brief Merge two meshes by groups of overlapping connected components.
+ *
+ * The connected components of both meshes are grouped by their overlapping bounding boxes.
+ * A component whose bounding box does not overlap any component of the other mesh is outside
+ * of its volume, so it is copied to the output (or dropped, depending on the operation) without
+ * any geometric processing. Only the groups with components of both meshes need a boolean operation,
+ * they are independent and processed in parallel.
+ *
+ * @param[in] operationType the boolean operation
+ * @param[in] firstMesh the first mesh
+ * @param[in] secondMesh the second mesh
+ * @param[in] preProcess pre-process the overlapping components before the boolean operation
+ * @param[in] postProcess post-process the result of each boolean operation
+ * @param[out] outputMesh the merged mesh
+ */
+void partitionedMerge(EOperationType operationType,
+                      const GEO::Mesh& firstMesh,
+                      const GEO::Mesh& secondMesh,
+                      bool preProcess,
+                      bool postProcess,
+                      GEO::Mesh& outputMesh)
+{
+    std::vector<std::vector<GEO::index_t>> firstComponents, secondComponents;
+    std::vector<ComponentBounds> firstBounds, secondBounds;
+    getConnectedComponents(firstMesh, firstComponents, firstBounds);
+    getConnectedComponents(secondMesh, secondComponents, secondBounds);
+
+    ALICEVISION_LOG_INFO("Connected components: " << firstComponents.size() << " in the first mesh, "
+                                                  << secondComponents.size() << " in the second mesh.");
+
+    // the pre-processing may move the vertices, the bounding boxes are compared with a margin
+    const double margin = 1e-2 * std::max(firstMesh.facets.nb() > 0 ? GEO::surface_average_edge_length(firstMesh) : 0.0,
+                                          secondMesh.facets.nb() > 0 ? GEO::surface_average_edge_length(secondMesh) : 0.0);
+
+    // components of the first mesh first, then components of the second mesh
+    const std::size_t nbFirstComponents = firstComponents.size();
+    const std::size_t nbComponents = nbFirstComponents + secondComponents.size();
+    const auto getBounds = [&](std::size_t c) -> const ComponentBounds& {
+        return (c < nbFirstComponents) ? firstBounds[c] : secondBounds[c - nbFirstComponents];
+    };
+
+    // sweep along x to find the overlapping components of both meshes
+    std::vector<std::size_t> sortedComponents(nbComponents);
+    std::iota(sortedComponents.begin(), sortedComponents.end(), 0);
+    std::sort(sortedComponents.begin(), sortedComponents.end(), [&](std::size_t a, std::size_t b) {
+        return getBounds(a).min[0] < getBounds(b).min[0];
+    });
+
+    DisjointSets componentSets(nbComponents);
+    std::vector<bool> isOverlapping(nbComponents, false);
+    for(std::size_t i = 0; i < nbComponents; ++i)
+    {
+        const std::size_t a = sortedComponents[i];
+        const ComponentBounds& boundsA = getBounds(a);
+        for(std::size_t j = i + 1; j < nbComponents && getBounds(sortedComponents[j]).min[0] <= boundsA.max[0] + margin; ++j)
+        {
+            const std::size_t b = sortedComponents[j];
+            if((a < nbFirstComponents) != (b < nbFirstComponents) && boundsA.overlaps(getBounds(b), margin))
+            {
+                componentSets.unite(a, b);
+                isOverlapping[a] = true;
+                isOverlapping[b] = true;
+            }
+        }
+    }
+
+    // groups of overlapping components, ordered by their first component
+    std::vector<std::pair<std::vector<std::size_t>, std::vector<std::size_t>>> groups;
+    {
+        std::unordered_map<std::size_t, std::size_t> groupIndexPerRoot;
+        for(std::size_t c = 0; c < nbComponents; ++c)
+        {
+            if(!isOverlapping[c])
+                continue;
+            const auto it = groupIndexPerRoot.emplace(componentSets.find(c), groups.size()).first;
+            if(it->second == groups.size())
+                groups.emplace_back();
+            if(c < nbFirstComponents)
+                groups[it->second].first.push_back(c);
+            else
+                groups[it->second].second.push_back(c - nbFirstComponents);
+        }
+    }
+
+    // the components outside of the volume of the other mesh are copied as is
+    const bool keepFirstOutside = (operationType != EOperationType::BOOLEAN_INTERSECTION);
+    const bool keepSecondOutside = (operationType == EOperationType::BOOLEAN_UNION);
+
+    std::size_t nbCopiedComponents = 0;
+    for(std::size_t c = 0; c < nbComponents; ++c)
+    {
+        if(isOverlapping[c])
+            continue;
+        if(c < nbFirstComponents && keepFirstOutside)
+            appendFacets(firstMesh, firstComponents[c], outputMesh);
+        else if(c >= nbFirstComponents && keepSecondOutside)
+            appendFacets(secondMesh, secondComponents[c - nbFirstComponents], outputMesh);
+        else
+            continue;
+        ++nbCopiedComponents;
+    }
+
+    ALICEVISION_LOG_INFO(nbCopiedComponents << " components copied without boolean operation, "
+                         << groups.size() << " groups of overlapping components to merge.");
+
+    std::vector<std::unique_ptr<GEO::Mesh>> groupMeshes(groups.size());
+
+#pragma omp parallel for schedule(dynamic)
+    for(int g = 0; g < static_cast<int>(groups.size()); ++g)
+    {
+        GEO::Mesh groupFirstMesh, groupSecondMesh;
+        for(const std::size_t c : groups[g].first)
+            appendFacets(firstMesh, firstComponents[c], groupFirstMesh);
+        for(const std::size_t c : groups[g].second)
+            appendFacets(secondMesh, secondComponents[c], groupSecondMesh);
+
+        if(preProcess)
+        {
+            fixMeshForBooleanOperations(groupFirstMesh);
+            fixMeshForBooleanOperations(groupSecondMesh);
+        }
+
+        groupMeshes[g] = std::make_unique<GEO::Mesh>();
+        applyOperation(operationType, *groupMeshes[g], groupFirstMesh, groupSecondMesh);
+
+        if(postProcess)
+            fixMeshForBooleanOperations(*groupMeshes[g]);
+    }
+
+    // deterministic output, the groups are appended in order
+    for(const std::unique_ptr<GEO::Mesh>& groupMesh : groupMeshes)
+        appendMesh(*groupMesh, outputMesh);
+}
+
 /**
  * @brief Merge two meshes
  */
@@ -133,6 +439,7 @@ int aliceVision_main(int argc, char** argv)
 
     bool preProcess = true;
     bool postProcess = true;
+    bool partitioning = true;
 
     po::options_description requiredParams("Required parameters");
     requiredParams.add_options()
@@ -150,7 +457,10 @@ int aliceVision_main(int argc, char** argv)
       ("preProcess", po::value<bool>(&preProcess)->default_value(preProcess),
         "Pre-process input meshes in order to avoid geometric errors in the merging process")
       ("postProcess", po::value<bool>(&postProcess)->default_value(postProcess),
-        "Post-process output mesh in order to avoid future geometric errors");
+        "Post-process output mesh in order to avoid future geometric errors")
+      ("partitioning", po::value<bool>(&partitioning)->default_value(partitioning),
+        "Only apply the boolean operation on the connected components of the meshes with overlapping bounding boxes, "
+        "in parallel. The other components are copied to the output (or dropped, depending on the operation) without any processing.");
 
     CmdLine cmdline("The program takes two meshes and applies a boolean operation on them.\n"
                     "AliceVision mergeMeshes");
@@ -221,43 +531,32 @@ int aliceVision_main(int argc, char** argv)
         return EXIT_FAILURE;
     }
     
-    // pre-process input meshes
-    if(preProcess)
+    if(partitioning)
     {
-        ALICEVISION_LOG_INFO("Pre-process input meshes...");
-        fixMeshForBooleanOperations(inputFirstMesh);
-        fixMeshForBooleanOperations(inputSecondMesh);
+        // pre-process and post-process only the overlapping components
+        ALICEVISION_LOG_INFO("Merging meshes (" << operationType << ") by groups of overlapping components...");
+        partitionedMerge(operationType, inputFirstMesh, inputSecondMesh, preProcess, postProcess, outputMesh);
     }
-
-    // merge mesh
-    ALICEVISION_LOG_INFO("Merging meshes...");
-    switch(operationType)
+    else
     {
-        case EOperationType::BOOLEAN_UNION:
+        // pre-process input meshes
+        if(preProcess)
         {
-          ALICEVISION_LOG_INFO("BOOLEAN_UNION");
-          GEO::mesh_union(outputMesh, inputFirstMesh, inputSecondMesh);
+            ALICEVISION_LOG_INFO("Pre-process input meshes...");
+            fixMeshForBooleanOperations(inputFirstMesh);
+            fixMeshForBooleanOperations(inputSecondMesh);
         }
-        break;
-        case EOperationType::BOOLEAN_INTERSECTION:
-        {
-          ALICEVISION_LOG_INFO("BOOLEAN_INTERSECTION");
-          GEO::mesh_intersection(outputMesh, inputFirstMesh, inputSecondMesh);
-        }
-        break;
-        case EOperationType::BOOLEAN_DIFFERENCE:
+
+        // merge mesh
+        ALICEVISION_LOG_INFO("Merging meshes (" << operationType << ")...");
+        applyOperation(operationType, outputMesh, inputFirstMesh, inputSecondMesh);
+
+        // post-process final mesh
+        if(postProcess)
         {
-          ALICEVISION_LOG_INFO("BOOLEAN_DIFFERENCE");
-          GEO::mesh_difference(outputMesh, inputFirstMesh, inputSecondMesh);
+            ALICEVISION_LOG_INFO("Post-process final mesh...");
+            fixMeshForBooleanOperations(outputMesh);
         }
-        break;
-    }
-
-    // post-process final mesh
-    if(postProcess)
-    {
-        ALICEVISION_LOG_INFO("Post-process final mesh...");
-        fixMeshForBooleanOperations(outputMesh);
     }
 
     // save output mesh
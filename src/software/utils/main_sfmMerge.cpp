@@ -25,6 +25,32 @@ using namespace aliceVision;
 
 namespace po = boost::program_options;
 
+/**
+ * @brief Move the elements of a container of the second scene into the same container of the first scene.
+ * @param[in,out] elements1 the elements of the first scene
+ * @param[in,out] elements2 the elements of the second scene, moved
+ * @param[in] name the name of the elements
+ * @return false if an element id is used in both scenes
+ */
+template<typename Container>
+bool mergeElements(Container& elements1, Container& elements2, const std::string& name)
+{
+    // check the ids before modifying the first scene
+    for (const auto& element : elements2)
+    {
+        if (elements1.count(element.first))
+        {
+            ALICEVISION_LOG_ERROR("Unhandled error: common " << name << " ID between both SfMData");
+            return false;
+        }
+    }
+
+    for (auto& element : elements2)
+        elements1.emplace(element.first, std::move(element.second));
+    elements2.clear();
+    return true;
+}
+
 
 int aliceVision_main(int argc, char **argv)
 {
@@ -60,57 +86,15 @@ int aliceVision_main(int argc, char **argv)
         return EXIT_FAILURE;
     }
     
-    {
-        auto & views1 = sfmData1.getViews();
-        auto & views2 = sfmData2.getViews();
-        const size_t totalSize = views1.size() + views2.size();
-
-        views1.insert(views2.begin(), views2.end());
-        if (views1.size() < totalSize)
-        {
-            ALICEVISION_LOG_ERROR("Unhandled error: common view ID between both SfMData");
-            return EXIT_FAILURE;
-        }
-    }
-
-    {
-        auto & intrinsics1 = sfmData1.getIntrinsics();
-        auto & intrinsics2 = sfmData2.getIntrinsics();
-        const size_t totalSize = intrinsics1.size() + intrinsics2.size();
-
-        intrinsics1.insert(intrinsics2.begin(), intrinsics2.end());
-        if (intrinsics1.size() < totalSize)
-        {
-            ALICEVISION_LOG_ERROR("Unhandled error: common intrinsics ID between both SfMData");
-            return EXIT_FAILURE;
-        }
-    }
-
-    {
-        auto & rigs1 = sfmData1.getRigs();
-        auto & rigs2 = sfmData2.getRigs();
-        const size_t totalSize = rigs1.size() + rigs2.size();
-
-        rigs1.insert(rigs2.begin(), rigs2.end());
-        if (rigs1.size() < totalSize)
-        {
-            ALICEVISION_LOG_ERROR("Unhandled error: common rigs ID between both SfMData");
-            return EXIT_FAILURE;
-        }
-    }
-
-    {
-        auto & landmarks1 = sfmData1.getLandmarks();
-        auto & landmarks2 = sfmData2.getLandmarks();
-        const size_t totalSize = landmarks1.size() + landmarks2.size();
-
-        landmarks1.insert(landmarks2.begin(), landmarks2.end());
-        if (landmarks1.size() < totalSize)
-        {
-            ALICEVISION_LOG_ERROR("Unhandled error: common rigs landmarks between both SfMData");
-            return EXIT_FAILURE;
-        }
-    }
+    // the elements of the second scene are moved into the first one, the scenes are never copied
+    if (!mergeElements(sfmData1.getViews(), sfmData2.getViews(), "views"))
+        return EXIT_FAILURE;
+    if (!mergeElements(sfmData1.getIntrinsics(), sfmData2.getIntrinsics(), "intrinsics"))
+        return EXIT_FAILURE;
+    if (!mergeElements(sfmData1.getRigs(), sfmData2.getRigs(), "rigs"))
+        return EXIT_FAILURE;
+    if (!mergeElements(sfmData1.getLandmarks(), sfmData2.getLandmarks(), "landmarks"))
+        return EXIT_FAILURE;
 
     sfmData1.addFeaturesFolders(sfmData2.getRelativeFeaturesFolders());
     sfmData1.addMatchesFolders(sfmData2.getRelativeMatchesFolders());
@@ -7,7 +7,6 @@
 
 #include <aliceVision/numeric/numeric.hpp>
 #include <aliceVision/image/io.hpp>
-#include <aliceVision/image/Sampler.hpp>
 #include <aliceVision/sfmData/SfMData.hpp>
 #include <aliceVision/sfmDataIO/sfmDataIO.hpp>
 #include <aliceVision/camera/camera.hpp>
@@ -26,6 +25,10 @@
 #include <OpenImageIO/imagebuf.h>
 #include <OpenImageIO/imagebufalgo.h>
 
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <map>
 #include <string>
 #include <iostream>
 #include <iterator>
@@ -58,11 +61,12 @@ public:
     _K << focal,   0,  width/2.0,
             0, focal, height/2.0,
             0,     0,          1;
+    _Kinv = _K.inverse();
     }
 
     Vec3 getLocalRay(double x, double y) const
     {
-        return (_K.inverse() * Vec3(x, y, 1.0)).normalized();
+        return (_Kinv * Vec3(x, y, 1.0)).normalized();
     }
 
     Vec3 getRay(double x, double y) const
@@ -76,9 +80,149 @@ private:
     Mat3 _R;
     /// Intrinsic matrix
     Mat3 _K;
+    /// Inverse of the intrinsic matrix
+    Mat3 _Kinv;
 
 };
 
+/**
+ * @brief Bilinear sampling of the equirectangular image precomputed for each pixel of the split images
+ * It only depends on the input resolution and on the split parameters, so it is shared by all the inputs of the same size.
+ */
+struct EquirectangularRemap
+{
+    /// indices of the neighboring input pixels, for each pixel of each split image (split after split)
+    std::vector<std::array<int, 4>> indices;
+    /// normalized weights of the neighboring input pixels (0 for the unused ones)
+    std::vector<std::array<float, 4>> weights;
+};
+
+/**
+ * @brief Compute the remap table of the given cameras, with the same weights as image::Sampler2d<image::SamplerLinear>
+ * @param[in] cameras the split cameras
+ * @param[in] splitResolution the split images resolution
+ * @param[in] inWidth the equirectangular image width
+ * @param[in] inHeight the equirectangular image height
+ */
+std::shared_ptr<const EquirectangularRemap> buildEquirectangularRemap(const std::vector<PinholeCameraR>& cameras, int splitResolution,
+                                                                      int inWidth, int inHeight)
+{
+    auto remap = std::make_shared<EquirectangularRemap>();
+    const std::size_t splitSize = static_cast<std::size_t>(splitResolution) * splitResolution;
+    remap->indices.resize(cameras.size() * splitSize);
+    remap->weights.resize(cameras.size() * splitSize);
+
+    for (std::size_t c = 0; c < cameras.size(); ++c)
+    {
+        #pragma omp parallel for
+        for (int j = 0; j < splitResolution; ++j)
+        {
+            for (int i = 0; i < splitResolution; ++i)
+            {
+                const Vec2 x = SphericalMapping::toEquirectangular(cameras[c].getRay(i, j), inWidth, inHeight);
+                const float sx = static_cast<float>(x(0));
+                const float sy = static_cast<float>(x(1));
+                const int gridX = static_cast<int>(std::floor(sx));
+                const int gridY = static_cast<int>(std::floor(sy));
+                const double dx = static_cast<double>(sx) - gridX;
+                const double dy = static_cast<double>(sy) - gridY;
+                const double coefsX[2] = {1.0 - dx, dx};
+                const double coefsY[2] = {1.0 - dy, dy};
+
+                std::array<int, 4> indices = {0, 0, 0, 0};
+                std::array<double, 4> weights = {0.0, 0.0, 0.0, 0.0};
+                double totalWeight = 0.0;
+                for (int k = 0; k < 4; ++k)
+                {
+                    const int row = gridY + k / 2;
+                    const int col = gridX + k % 2;
+                    if (row < 0 || row >= inHeight || col < 0 || col >= inWidth)
+                        continue;
+                    indices[k] = row * inWidth + col;
+                    weights[k] = coefsY[k / 2] * coefsX[k % 2];
+                    totalWeight += weights[k];
+                }
+
+                const std::size_t index = c * splitSize + static_cast<std::size_t>(j) * splitResolution + i;
+                if (totalWeight <= 0.2)
+                {
+                    // too unstable, use the nearest pixel
+                    const int row = std::min(std::max(gridY, 0), inHeight - 1);
+                    const int col = std::min(std::max(gridX, 0), inWidth - 1);
+                    remap->indices[index] = {row * inWidth + col, 0, 0, 0};
+                    remap->weights[index] = {1.f, 0.f, 0.f, 0.f};
+                    continue;
+                }
+                remap->indices[index] = indices;
+                for (int k = 0; k < 4; ++k)
+                    remap->weights[index][k] = static_cast<float>(weights[k] / totalWeight);
+            }
+        }
+    }
+    return remap;
+}
+
+/**
+ * @brief Resample a split image from the equirectangular image with a precomputed remap table
+ * @param[in] imageSource the equirectangular image
+ * @param[in] remap the remap table of the equirectangular image resolution
+ * @param[in] splitIndex the index of the split image in the remap table
+ * @param[out] imageOut the split image, already allocated
+ */
+void remapEquirectangular(const image::Image<image::RGBColor>& imageSource, const EquirectangularRemap& remap, std::size_t splitIndex,
+                          image::Image<image::RGBColor>& imageOut)
+{
+    const std::size_t splitSize = static_cast<std::size_t>(imageOut.Width()) * imageOut.Height();
+    const image::RGBColor* source = imageSource.data();
+    const std::array<int, 4>* indices = remap.indices.data() + splitIndex * splitSize;
+    const std::array<float, 4>* weights = remap.weights.data() + splitIndex * splitSize;
+
+    #pragma omp parallel for
+    for (int j = 0; j < imageOut.Height(); ++j)
+    {
+        for (int i = 0; i < imageOut.Width(); ++i)
+        {
+            const std::size_t index = static_cast<std::size_t>(j) * imageOut.Width() + i;
+            const std::array<int, 4>& pixelIndices = indices[index];
+            const std::array<float, 4>& pixelWeights = weights[index];
+
+            float value[3] = {0.f, 0.f, 0.f};
+            for (int k = 0; k < 4; ++k)
+            {
+                const image::RGBColor& pixel = source[pixelIndices[k]];
+                for (int channel = 0; channel < 3; ++channel)
+                    value[channel] += pixelWeights[k] * pixel(channel);
+            }
+
+            image::RGBColor& outPixel = imageOut(j, i);
+            for (int channel = 0; channel < 3; ++channel)
+                outPixel(channel) = static_cast<unsigned char>(std::min(std::max(value[channel] + 0.5f, 0.f), 255.f));
+        }
+    }
+}
+
+/**
+ * @brief Get the remap table of an equirectangular image resolution, computed on the first request
+ */
+std::shared_ptr<const EquirectangularRemap> getEquirectangularRemap(const std::vector<PinholeCameraR>& cameras, int splitResolution,
+                                                                    int inWidth, int inHeight)
+{
+    static std::map<std::pair<int, int>, std::shared_ptr<const EquirectangularRemap>> remaps;
+
+    std::shared_ptr<const EquirectangularRemap> remap;
+    #pragma omp critical (split360Images_remap)
+    {
+        std::shared_ptr<const EquirectangularRemap>& cached = remaps[std::make_pair(inWidth, inHeight)];
+        if (!cached)
+        {
+            ALICEVISION_LOG_INFO("Compute the remap table for the " << inWidth << "x" << inHeight << " images.");
+            cached = buildEquirectangularRemap(cameras, splitResolution, inWidth, inHeight);
+        }
+        remap = cached;
+    }
+    return remap;
+}
+
 /**
  * @brief Compute a rectilinear camera focal from an angular FoV
  * @param h
@@ -211,43 +355,29 @@ bool splitEquirectangular(sfmData::SfMData& outSfmData,
         angle += alpha;
     }
 
-    const image::Sampler2d<image::SamplerLinear> sampler;
+    // Backward mapping, shared by all the images of the same size:
+    // - Find for each pixels of the pinhole images where it comes from the panoramic image
+    const std::shared_ptr<const EquirectangularRemap> remap = getEquirectangularRemap(cameras, splitResolution, inWidth, inHeight);
+
     image::Image<image::RGBColor> imaOut(splitResolution, splitResolution, image::BLACK);
 
+    // Retrieve image metadata, the same for all the split images
+    oiio::ImageSpec outMetadataSpec;
+    outMetadataSpec.extra_attribs = image::readImageMetadata(imagePath);
+
+    // Override make and model in order to force camera model in SfM
+    outMetadataSpec.attribute("Make",  "Custom");
+    outMetadataSpec.attribute("Model", "Pinhole");
+    const float focal_mm = focal_px * (36.0 / splitResolution); // muliplied by sensorWidth (36mm by default)
+    outMetadataSpec.attribute("Exif:FocalLength", focal_mm);
+
     // Make sure rig folder exists
     std::string rigFolder = outputFolder + "/rig";
     fs::create_directory(rigFolder);
 
-    size_t index = 0;
-    for(const PinholeCameraR& camera : cameras)
+    for(size_t index = 0; index < cameras.size(); ++index)
     {
-        imaOut.fill(image::BLACK);
-
-        // Backward mapping:
-        // - Find for each pixels of the pinhole image where it comes from the panoramic image
-        for(int j = 0; j < splitResolution; ++j)
-        {
-            for(int i = 0; i < splitResolution; ++i)
-            {
-                const Vec3 ray = camera.getRay(i, j);
-                const Vec2 x = SphericalMapping::toEquirectangular(ray, inWidth, inHeight);
-                imaOut(j,i) = sampler(imageSource, x(1), x(0));
-            }
-        }
-
-        // Retrieve image specs and metadata
-        oiio::ImageBuf bufferOut;
-        image::getBufferFromImage(imageSource, bufferOut);
-
-        oiio::ImageSpec& outMetadataSpec = bufferOut.specmod();
-
-        outMetadataSpec.extra_attribs = image::readImageMetadata(imagePath);
-
-        // Override make and model in order to force camera model in SfM
-        outMetadataSpec.attribute("Make",  "Custom");
-        outMetadataSpec.attribute("Model", "Pinhole");
-        const float focal_mm = focal_px * (36.0 / splitResolution); // muliplied by sensorWidth (36mm by default)
-        outMetadataSpec.attribute("Exif:FocalLength", focal_mm);
+        remapEquirectangular(imageSource, *remap, index, imaOut);
 
         // Make sure sub-folder exists for complete rig structure
         std::string subFolder = rigFolder + std::string("/") + std::to_string(index);
@@ -278,9 +408,6 @@ bool splitEquirectangular(sfmData::SfMData& outSfmData,
                 );
             views.emplace(viewId, view);
         }
-        
-        // Increment index
-        ++index;
     }
     ALICEVISION_LOG_INFO(imagePath + " successfully split");
     return true;
@@ -27,7 +27,7 @@
 // These constants define the current software version.
 // They must be updated when the command line is changed.
 #define ALICEVISION_SOFTWARE_VERSION_MAJOR 1
-#define ALICEVISION_SOFTWARE_VERSION_MINOR 0
+#define ALICEVISION_SOFTWARE_VERSION_MINOR 1
 
 static const int DIMENSION = 128;
 
@@ -51,6 +51,7 @@ int aliceVision_main(int argc, char** argv)
   std::vector<std::string> featuresFolders;
   std::uint32_t K = 10;
   std::uint32_t restart = 5;
+  std::size_t kmeansBatchSize = 0;
   std::uint32_t LEVELS = 6;
   bool sanityCheck = true;
 
@@ -67,6 +68,8 @@ int aliceVision_main(int argc, char** argv)
     (",k", po::value<uint32_t>(&K)->default_value(10), "The branching factor of the tree")
     ("restart,r", po::value<uint32_t>(&restart)->default_value(5), "Number of times that the kmean is launched for each cluster, the best solution is kept")
     (",L", po::value<uint32_t>(&LEVELS)->default_value(6), "Number of levels of the tree")
+    ("kmeansBatchSize", po::value<std::size_t>(&kmeansBatchSize)->default_value(kmeansBatchSize), "Number of descriptors drawn at each iteration of the kmean. "
+      "The clusters with more descriptors are computed with mini-batches, which is much faster on large sets. 0 always uses all the descriptors")
     ("sanitycheck,s", po::value<bool>(&sanityCheck)->default_value(sanityCheck), "Perform a sanity check at the end of the creation of the vocabulary tree. The sanity check is a query to the database with the same documents/images useed to train the vocabulary tree");
 
   CmdLine cmdline("This program is used to load the sift descriptors from a SfMData file and create a vocabulary tree.\n"
@@ -109,6 +112,7 @@ int aliceVision_main(int argc, char** argv)
   aliceVision::voctree::TreeBuilder<DescriptorFloat> builder(DescriptorFloat(0));
   builder.setVerbose(tbVerbosity);
   builder.kmeans().setRestarts(restart);
+  builder.kmeans().setMiniBatchSize(kmeansBatchSize);
   ALICEVISION_COUT("Building a tree of L=" << LEVELS << " levels with a branching factor of k=" << K);
   detect_start = std::chrono::steady_clock::now();
   builder.build(descriptors, K, LEVELS);
@@ -15,6 +15,7 @@
 #include <aliceVision/sfm/sfm.hpp>
 #include <aliceVision/graph/graph.hpp>
 #include <aliceVision/config.hpp>
+#include <aliceVision/alicevision_omp.hpp>
 #include <aliceVision/image/all.hpp>
 //load features per view
 #include <aliceVision/sfm/pipeline/regionsIO.hpp>
@@ -173,22 +174,24 @@ bool ColorHarmonizationEngineGlobal::Process()
   std::map<size_t, size_t> map_cameraIndexTocameraNode; // 0->Ncam correspondance to graph node Id
   std::set<size_t> set_indeximage;
 
-  for (size_t i = 0; i < _pairwiseMatches.size(); ++i)
-  {
-    matching::PairwiseMatches::const_iterator iter = _pairwiseMatches.begin();
-    std::advance(iter, i);
+  std::vector<matching::PairwiseMatches::const_iterator> pairs;
+  pairs.reserve(_pairwiseMatches.size());
+  for (matching::PairwiseMatches::const_iterator iter = _pairwiseMatches.begin(); iter != _pairwiseMatches.end(); ++iter)
+    pairs.push_back(iter);
 
+  for (const auto& iter : pairs)
+  {
     const size_t I = iter->first.first;
     const size_t J = iter->first.second;
     set_indeximage.insert(I);
     set_indeximage.insert(J);
   }
 
-  for (std::set<size_t>::const_iterator iterSet = set_indeximage.begin();
-    iterSet != set_indeximage.end(); ++iterSet)
+  const std::vector<size_t> vec_indeximage(set_indeximage.begin(), set_indeximage.end());
+  for (size_t nodeIndex = 0; nodeIndex < vec_indeximage.size(); ++nodeIndex)
   {
-    map_cameraIndexTocameraNode[std::distance(set_indeximage.begin(), iterSet)] = *iterSet;
-    map_cameraNodeToCameraIndex[*iterSet] = std::distance(set_indeximage.begin(), iterSet);
+    map_cameraIndexTocameraNode[nodeIndex] = vec_indeximage[nodeIndex];
+    map_cameraNodeToCameraIndex[vec_indeximage[nodeIndex]] = nodeIndex;
   }
 
   std::cout << "\nRemaining cameras after CC filter : \n"
@@ -198,16 +201,29 @@ bool ColorHarmonizationEngineGlobal::Process()
   double minvalue = 0.0;
   double maxvalue = 255.0;
 
+  if (_selectionMethod != EHistogramSelectionMethod::eHistogramHarmonizeFullFrame &&
+      _selectionMethod != EHistogramSelectionMethod::eHistogramHarmonizeMatchedPoints &&
+      _selectionMethod != EHistogramSelectionMethod::eHistogramHarmonizeVLDSegment)
+  {
+    std::cout << "Selection method unsupported" << std::endl;
+    return false;
+  }
+
   // For each edge computes the selection masks and histograms (for the RGB channels)
+  // The edges are independent and processed in parallel
   std::vector<relativeColorHistogramEdge> map_relativeHistograms[3];
-  map_relativeHistograms[0].resize(_pairwiseMatches.size());
-  map_relativeHistograms[1].resize(_pairwiseMatches.size());
-  map_relativeHistograms[2].resize(_pairwiseMatches.size());
+  map_relativeHistograms[0].resize(pairs.size());
+  map_relativeHistograms[1].resize(pairs.size());
+  map_relativeHistograms[2].resize(pairs.size());
+
+  // the pyramids of scale images of the VLD segments selection are built once per image for all its pairs:
+  // the pairs are sorted by first image, so the images of the pairs processed concurrently are kept
+  ImageScaleCache scaleCache(2 * omp_get_max_threads() + 2);
 
-  for (size_t i = 0; i < _pairwiseMatches.size(); ++i)
+  #pragma omp parallel for schedule(dynamic)
+  for (int i = 0; i < static_cast<int>(pairs.size()); ++i)
   {
-    matching::PairwiseMatches::const_iterator iter = _pairwiseMatches.begin();
-    std::advance(iter, i);
+    matching::PairwiseMatches::const_iterator iter = pairs[i];
 
     const size_t viewI = iter->first.first;
     const size_t viewJ = iter->first.second;
@@ -218,6 +234,7 @@ bool ColorHarmonizationEngineGlobal::Process()
     //-- Edges names:
     std::pair< std::string, std::string > p_imaNames;
     p_imaNames = make_pair( _fileNames[ viewI ], _fileNames[ viewJ ] );
+    #pragma omp critical(colorHarmonize_log)
     std::cout << "Current edge : "
       << fs::path(p_imaNames.first).filename().string() << "\t"
       << fs::path(p_imaNames.second).filename().string() << std::endl;
@@ -263,15 +280,15 @@ bool ColorHarmonizationEngineGlobal::Process()
             p_imaNames.second,
             matches,
             _regionsPerView.getRegions(viewI, descType).Features(),
-            _regionsPerView.getRegions(viewJ, descType).Features());
+            _regionsPerView.getRegions(viewJ, descType).Features(),
+            &scaleCache);
 
           dataSelector.computeMask( maskI, maskJ );
         }
       }
       break;
       default:
-        std::cout << "Selection method unsupported" << std::endl;
-        return false;
+      break;
     }
 
     //-- Export the masks
@@ -293,36 +310,22 @@ bool ColorHarmonizationEngineGlobal::Process()
       writeImage(out_filename_J, maskJ, image::ImageWriteOptions());
     }
 
-    //-- Compute the histograms
+    //-- Compute the histograms of the RGB channels, in one pass over each image
     Image< RGBColor > imageI, imageJ;
     readImage(p_imaNames.first, imageI, image::EImageColorSpace::LINEAR);
     readImage(p_imaNames.second, imageJ, image::EImageColorSpace::LINEAR);
 
-    utils::Histogram< double > histoI( minvalue, maxvalue, bin);
-    utils::Histogram< double > histoJ( minvalue, maxvalue, bin);
-
-    int channelIndex = 0; // RED channel
-    colorHarmonization::CommonDataByPair::computeHisto( histoI, maskI, channelIndex, imageI );
-    colorHarmonization::CommonDataByPair::computeHisto( histoJ, maskJ, channelIndex, imageJ );
-    relativeColorHistogramEdge & edgeR = map_relativeHistograms[channelIndex][i];
-    edgeR = relativeColorHistogramEdge(map_cameraNodeToCameraIndex[viewI], map_cameraNodeToCameraIndex[viewJ],
-      histoI.GetHist(), histoJ.GetHist());
-
-    histoI = histoJ = utils::Histogram<double>(minvalue, maxvalue, bin);
-    channelIndex = 1; // GREEN channel
-    colorHarmonization::CommonDataByPair::computeHisto( histoI, maskI, channelIndex, imageI );
-    colorHarmonization::CommonDataByPair::computeHisto( histoJ, maskJ, channelIndex, imageJ );
-    relativeColorHistogramEdge & edgeG = map_relativeHistograms[channelIndex][i];
-    edgeG = relativeColorHistogramEdge(map_cameraNodeToCameraIndex[viewI], map_cameraNodeToCameraIndex[viewJ],
-      histoI.GetHist(), histoJ.GetHist());
-
-    histoI = histoJ = utils::Histogram<double>(minvalue, maxvalue, bin);
-    channelIndex = 2; // BLUE channel
-    colorHarmonization::CommonDataByPair::computeHisto( histoI, maskI, channelIndex, imageI );
-    colorHarmonization::CommonDataByPair::computeHisto( histoJ, maskJ, channelIndex, imageJ );
-    relativeColorHistogramEdge & edgeB = map_relativeHistograms[channelIndex][i];
-    edgeB = relativeColorHistogramEdge(map_cameraNodeToCameraIndex[viewI], map_cameraNodeToCameraIndex[viewJ],
-      histoI.GetHist(), histoJ.GetHist());
+    std::vector<utils::Histogram<double>> histosI(3, utils::Histogram<double>(minvalue, maxvalue, bin));
+    std::vector<utils::Histogram<double>> histosJ(3, utils::Histogram<double>(minvalue, maxvalue, bin));
+    colorHarmonization::CommonDataByPair::computeHistos( histosI, maskI, imageI );
+    colorHarmonization::CommonDataByPair::computeHistos( histosJ, maskJ, imageJ );
+
+    for (int channelIndex = 0; channelIndex < 3; ++channelIndex) // RED, GREEN and BLUE channels
+    {
+      map_relativeHistograms[channelIndex][i] = relativeColorHistogramEdge(
+        map_cameraNodeToCameraIndex.at(viewI), map_cameraNodeToCameraIndex.at(viewJ),
+        histosI[channelIndex].GetHist(), histosJ[channelIndex].GetHist());
+    }
   }
 
   std::cout << "\n -- \n SOLVE for color consistency with linear programming\n --" << std::endl;
@@ -332,9 +335,7 @@ bool ColorHarmonizationEngineGlobal::Process()
 
   using namespace aliceVision::linearProgramming;
 
-  std::vector<double> vec_solution_r(_fileNames.size() * 2 + 1);
-  std::vector<double> vec_solution_g(_fileNames.size() * 2 + 1);
-  std::vector<double> vec_solution_b(_fileNames.size() * 2 + 1);
+  std::vector<double> vec_solutions[3];
 
   aliceVision::system::Timer timer;
 
@@ -343,39 +344,23 @@ bool ColorHarmonizationEngineGlobal::Process()
   #else
   typedef OSI_CISolverWrapper SOLVER_LP_T;
   #endif
-  // Red channel
+  // Red, green and blue channels are independent problems, solved at the same time
+  #pragma omp parallel for num_threads(3)
+  for (int channelIndex = 0; channelIndex < 3; ++channelIndex)
   {
-    SOLVER_LP_T lpSolver(vec_solution_r.size());
+    vec_solutions[channelIndex].resize(_fileNames.size() * 2 + 1);
+    SOLVER_LP_T lpSolver(vec_solutions[channelIndex].size());
 
-    GainOffsetConstraintBuilder cstBuilder(map_relativeHistograms[0], vec_indexToFix);
+    GainOffsetConstraintBuilder cstBuilder(map_relativeHistograms[channelIndex], vec_indexToFix);
     LPConstraintsSparse constraint;
     cstBuilder.Build(constraint);
     lpSolver.setup(constraint);
     lpSolver.solve();
-    lpSolver.getSolution(vec_solution_r);
-  }
-  // Green channel
-  {
-    SOLVER_LP_T lpSolver(vec_solution_g.size());
-
-    GainOffsetConstraintBuilder cstBuilder(map_relativeHistograms[1], vec_indexToFix);
-    LPConstraintsSparse constraint;
-    cstBuilder.Build(constraint);
-    lpSolver.setup(constraint);
-    lpSolver.solve();
-    lpSolver.getSolution(vec_solution_g);
-  }
-  // Blue channel
-  {
-    SOLVER_LP_T lpSolver(vec_solution_b.size());
-
-    GainOffsetConstraintBuilder cstBuilder(map_relativeHistograms[2], vec_indexToFix);
-    LPConstraintsSparse constraint;
-    cstBuilder.Build(constraint);
-    lpSolver.setup(constraint);
-    lpSolver.solve();
-    lpSolver.getSolution(vec_solution_b);
+    lpSolver.getSolution(vec_solutions[channelIndex]);
   }
+  const std::vector<double>& vec_solution_r = vec_solutions[0];
+  const std::vector<double>& vec_solution_g = vec_solutions[1];
+  const std::vector<double>& vec_solution_b = vec_solutions[2];
 
   std::cout << std::endl
     << " ColorHarmonization solving on a graph with: " << _pairwiseMatches.size() << " edges took (s): "
@@ -397,17 +382,20 @@ bool ColorHarmonizationEngineGlobal::Process()
 
   std::cout << "\n\nThere is :\n" << set_indeximage.size() << " images to transform." << std::endl;
 
+  const std::string out_folder = (fs::path(_outputDirectory) / (EHistogramSelectionMethod_enumToString(_selectionMethod) + "_" + vec_harmonizeMethod[ harmonizeMethod ])).string();
+  if(!fs::exists(out_folder))
+    fs::create_directory(out_folder);
+
   //-> convert solution to gain offset and creation of the LUT per image
-  auto progressDisplay = system::createConsoleProgressDisplay(set_indeximage.size(), std::cout);
-  for (std::set<size_t>::const_iterator iterSet = set_indeximage.begin();
-    iterSet != set_indeximage.end(); ++iterSet, ++progressDisplay)
+  // The images are transformed in parallel
+  auto progressDisplay = system::createConsoleProgressDisplay(vec_indeximage.size(), std::cout);
+  #pragma omp parallel for schedule(dynamic)
+  for (int nodeIndex = 0; nodeIndex < static_cast<int>(vec_indeximage.size()); ++nodeIndex)
   {
-    const size_t imaNum = *iterSet;
+    const size_t imaNum = vec_indeximage[nodeIndex];
     typedef Eigen::Matrix<double, 256, 1> Vec256;
     std::vector< Vec256 > vec_map_lut(3);
 
-    const size_t nodeIndex = std::distance(set_indeximage.begin(), iterSet);
-
     const  double g_r = vec_solution_r[nodeIndex*2];
     const  double offset_r = vec_solution_r[nodeIndex*2+1];
     const  double g_g = vec_solution_g[nodeIndex*2];
@@ -436,12 +424,10 @@ bool ColorHarmonizationEngineGlobal::Process()
       }
     }
 
-    const std::string out_folder = (fs::path(_outputDirectory) / (EHistogramSelectionMethod_enumToString(_selectionMethod) + "_" + vec_harmonizeMethod[ harmonizeMethod ])).string();
-    if(!fs::exists(out_folder))
-      fs::create_directory(out_folder);
     const std::string out_filename = (fs::path(out_folder) / fs::path(_fileNames[ imaNum ]).filename() ).string();
 
     writeImage(out_filename, image_c , image::ImageWriteOptions());
+    ++progressDisplay;
   }
   return true;
 }